@@ -657,6 +657,41 @@ gst_alsa_find_device_name (GstObject * obj, const gchar * device,
   return ret;
 }
 
+/* Looks up the device name, or the card name when @card_name is TRUE, like
+ * the functions above but remembers it in @cache while *@handle is open. The
+ * card can't be replaced while we have it open so the name stays valid until
+ * the element closes the device, sets *@handle to NULL and clears @cache, all
+ * with the object lock taken. Looking up the name opens the control device of
+ * the card, which is slow for some USB devices. */
+gchar *
+gst_alsa_find_name_cached (GstObject * obj, const gchar * device,
+    snd_pcm_t ** handle, snd_pcm_stream_t stream, gboolean card_name,
+    gchar ** cache)
+{
+  snd_pcm_t *h;
+  gchar *ret;
+
+  GST_OBJECT_LOCK (obj);
+  h = *handle;
+  ret = g_strdup (*cache);
+  GST_OBJECT_UNLOCK (obj);
+
+  if (ret != NULL)
+    return ret;
+
+  if (card_name)
+    ret = gst_alsa_find_card_name (obj, device, stream);
+  else
+    ret = gst_alsa_find_device_name (obj, device, h, stream);
+
+  GST_OBJECT_LOCK (obj);
+  if (h != NULL && *handle == h && *cache == NULL)
+    *cache = g_strdup (ret);
+  GST_OBJECT_UNLOCK (obj);
+
+  return ret;
+}
+
 /* ALSA channel positions */
 const GstAudioChannelPosition alsa_position[][8] = {
   {
@@ -67,6 +67,13 @@ gchar *   gst_alsa_find_card_name   (GstObject        * obj,
                                      const gchar      * devcard,
                                      snd_pcm_stream_t   stream);
 
+gchar *   gst_alsa_find_name_cached (GstObject        * obj,
+                                     const gchar      * device,
+                                     snd_pcm_t       ** handle,
+                                     snd_pcm_stream_t   stream,
+                                     gboolean           card_name,
+                                     gchar           ** cache);
+
 void      gst_alsa_add_channel_reorder_map (GstObject * obj,
                                             GstCaps   * caps);
 
@@ -59,6 +59,8 @@
 #define DEFAULT_DEVICE		"default"
 #define DEFAULT_DEVICE_NAME	""
 #define DEFAULT_CARD_NAME	""
+#define DEFAULT_USE_MMAP	FALSE
+#define DEFAULT_LINK_GROUP	NULL
 #define SPDIF_PERIOD_SIZE 1536
 #define SPDIF_BUFFER_SIZE 15360
 
@@ -68,6 +70,8 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_USE_MMAP,
+  PROP_LINK_GROUP,
   PROP_LAST
 };
 
@@ -102,6 +106,10 @@ static gint output_ref;         /* 0    */
 static snd_output_t *output;    /* NULL */
 static GMutex output_mutex;
 
+/* group name -> GList of the prepared sinks linked in the group */
+static GHashTable *link_groups;
+static GMutex link_mutex;
+
 static GstStaticPadTemplate alsasink_sink_factory =
     GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -119,6 +127,9 @@ gst_alsasink_finalise (GObject * object)
   GstAlsaSink *sink = GST_ALSA_SINK (object);
 
   g_free (sink->device);
+  g_free (sink->link_group);
+  g_free (sink->cached_device_name);
+  g_free (sink->cached_card_name);
   g_mutex_clear (&sink->alsa_lock);
   g_mutex_clear (&sink->delay_lock);
 
@@ -196,6 +207,37 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
       g_param_spec_string ("card-name", "Card name",
           "Human-readable name of the sound card", DEFAULT_CARD_NAME,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSink:use-mmap:
+   *
+   * Copy the samples directly into the memory mapped buffer of the device
+   * instead of using snd_pcm_writei(). Falls back to read/write access
+   * when the device does not support mmap.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Transfer samples through the memory mapped device buffer",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSink:link-group:
+   *
+   * The devices of all the sinks with the same link group are linked with
+   * snd_pcm_link() so that they start, stop and recover from errors at the
+   * same time, which keeps their output sample aligned. The sinks should be
+   * in the same pipeline and get their data from the same source. The first
+   * device that has filled its buffer starts all of them.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_LINK_GROUP,
+      g_param_spec_string ("link-group", "Link group",
+          "Name of the group of sinks whose devices are started together "
+          "(NULL = not linked)", DEFAULT_LINK_GROUP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -215,6 +257,15 @@ gst_alsasink_set_property (GObject * object, guint prop_id,
         sink->device = g_strdup (DEFAULT_DEVICE);
       }
       break;
+    case PROP_USE_MMAP:
+      sink->use_mmap = g_value_get_boolean (value);
+      break;
+    case PROP_LINK_GROUP:
+      GST_OBJECT_LOCK (sink);
+      g_free (sink->link_group);
+      sink->link_group = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -235,13 +286,23 @@ gst_alsasink_get_property (GObject * object, guint prop_id,
       break;
     case PROP_DEVICE_NAME:
       g_value_take_string (value,
-          gst_alsa_find_device_name (GST_OBJECT_CAST (sink),
-              sink->device, sink->handle, SND_PCM_STREAM_PLAYBACK));
+          gst_alsa_find_name_cached (GST_OBJECT_CAST (sink), sink->device,
+              &sink->handle, SND_PCM_STREAM_PLAYBACK, FALSE,
+              &sink->cached_device_name));
       break;
     case PROP_CARD_NAME:
       g_value_take_string (value,
-          gst_alsa_find_card_name (GST_OBJECT_CAST (sink),
-              sink->device, SND_PCM_STREAM_PLAYBACK));
+          gst_alsa_find_name_cached (GST_OBJECT_CAST (sink), sink->device,
+              &sink->handle, SND_PCM_STREAM_PLAYBACK, TRUE,
+              &sink->cached_card_name));
+      break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, sink->use_mmap);
+      break;
+    case PROP_LINK_GROUP:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_string (value, sink->link_group);
+      GST_OBJECT_UNLOCK (sink);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -257,6 +318,8 @@ gst_alsasink_init (GstAlsaSink * alsasink)
   alsasink->device = g_strdup (DEFAULT_DEVICE);
   alsasink->handle = NULL;
   alsasink->cached_caps = NULL;
+  alsasink->use_mmap = DEFAULT_USE_MMAP;
+  alsasink->link_group = g_strdup (DEFAULT_LINK_GROUP);
   g_mutex_init (&alsasink->alsa_lock);
   g_mutex_init (&alsasink->delay_lock);
 
@@ -441,6 +504,12 @@ set_hwparams (GstAlsaSink * alsa)
 retry:
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
+  /* not all devices (and plugins) can be mmapped, use read/write then */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_test_access (alsa->handle, params, alsa->access) < 0) {
+    GST_WARNING_OBJECT (alsa, "mmap access not supported, using read/write");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   /* set the interleaved read/write format */
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
@@ -817,7 +886,8 @@ alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED :
+      SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SINK
@@ -866,6 +936,71 @@ open_error:
   }
 }
 
+/* link the pcm to the pcms of the other prepared sinks of the group */
+static void
+gst_alsasink_link (GstAlsaSink * alsa)
+{
+  GList *members;
+  gchar *group;
+  gint err;
+
+  GST_OBJECT_LOCK (alsa);
+  group = g_strdup (alsa->link_group);
+  GST_OBJECT_UNLOCK (alsa);
+
+  if (group == NULL || *group == '\0') {
+    g_free (group);
+    return;
+  }
+
+  g_mutex_lock (&link_mutex);
+  if (link_groups == NULL)
+    link_groups = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        NULL);
+
+  members = g_hash_table_lookup (link_groups, group);
+  if (members) {
+    GstAlsaSink *first = members->data;
+
+    if ((err = snd_pcm_link (first->handle, alsa->handle)) < 0) {
+      GST_WARNING_OBJECT (alsa, "could not link to %s in group %s: %s",
+          first->device, group, snd_strerror (err));
+      g_mutex_unlock (&link_mutex);
+      g_free (group);
+      return;
+    }
+  }
+  GST_DEBUG_OBJECT (alsa, "linked in group %s with %u other devices", group,
+      g_list_length (members));
+  members = g_list_append (members, alsa);
+  g_hash_table_insert (link_groups, g_strdup (group), members);
+  alsa->linked_group = group;
+  g_mutex_unlock (&link_mutex);
+}
+
+static void
+gst_alsasink_unlink (GstAlsaSink * alsa)
+{
+  GList *members;
+
+  if (alsa->linked_group == NULL)
+    return;
+
+  g_mutex_lock (&link_mutex);
+  members = g_hash_table_lookup (link_groups, alsa->linked_group);
+  members = g_list_remove (members, alsa);
+  if (members)
+    g_hash_table_insert (link_groups, g_strdup (alsa->linked_group), members);
+  else
+    g_hash_table_remove (link_groups, alsa->linked_group);
+  snd_pcm_unlink (alsa->handle);
+  g_mutex_unlock (&link_mutex);
+
+  GST_DEBUG_OBJECT (alsa, "unlinked from group %s", alsa->linked_group);
+  g_free (alsa->linked_group);
+  alsa->linked_group = NULL;
+}
+
 static gboolean
 gst_alsasink_prepare (GstAudioSink * asink, GstAudioRingBufferSpec * spec)
 {
@@ -913,6 +1048,8 @@ gst_alsasink_prepare (GstAudioSink * asink, GstAudioRingBufferSpec * spec)
       alsa->channels, GST_AUDIO_BASE_SINK (alsa)->ringbuffer);
 #endif /* SND_CHMAP_API_VERSION */
 
+  gst_alsasink_link (alsa);
+
   return TRUE;
 
   /* ERRORS */
@@ -949,6 +1086,8 @@ gst_alsasink_unprepare (GstAudioSink * asink)
 
   alsa = GST_ALSA_SINK (asink);
 
+  /* don't stop the other devices of the group */
+  gst_alsasink_unlink (alsa);
   snd_pcm_drop (alsa->handle);
   snd_pcm_hw_free (alsa->handle);
 
@@ -965,6 +1104,10 @@ gst_alsasink_close (GstAudioSink * asink)
     snd_pcm_close (alsa->handle);
     alsa->handle = NULL;
   }
+  g_free (alsa->cached_device_name);
+  alsa->cached_device_name = NULL;
+  g_free (alsa->cached_card_name);
+  alsa->cached_card_name = NULL;
   gst_caps_replace (&alsa->cached_caps, NULL);
   GST_OBJECT_UNLOCK (asink);
 
@@ -1006,6 +1149,52 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
   return err;
 }
 
+/* copy the samples straight into the mmapped device buffer, this saves the
+ * intermediate copy snd_pcm_writei() does. Returns the number of frames
+ * written or a negative error like snd_pcm_writei() */
+static snd_pcm_sframes_t
+gst_alsasink_mmap_write (GstAlsaSink * alsa, const guint8 * ptr,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size;
+  snd_pcm_sframes_t avail, res;
+  gint err;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+  if (avail == 0)
+    return -EAGAIN;
+
+  size = MIN (frames, (snd_pcm_uframes_t) avail);
+  if ((err = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+    return err;
+
+  /* interleaved, all channels share the first area */
+  memcpy ((guint8 *) areas[0].addr + areas[0].first / 8 +
+      offset * (areas[0].step / 8), ptr, size * alsa->bpf);
+
+  res = snd_pcm_mmap_commit (alsa->handle, offset, size);
+  if (res < 0)
+    return res;
+  if ((snd_pcm_uframes_t) res != size)
+    return -EPIPE;
+
+  /* there is no implicit start with mmap, do what the start threshold in
+   * the swparams would do for snd_pcm_writei() */
+  if (snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    avail = snd_pcm_avail_update (alsa->handle);
+    if (avail >= 0 && alsa->buffer_size - (snd_pcm_uframes_t) avail >=
+        (alsa->buffer_size / alsa->period_size) * alsa->period_size) {
+      GST_DEBUG_OBJECT (alsa, "buffer filled, starting the device");
+      if ((err = snd_pcm_start (alsa->handle)) < 0)
+        return err;
+    }
+  }
+  return res;
+}
+
 static gint
 gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 {
@@ -1039,7 +1228,10 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
       GST_DEBUG_OBJECT (asink, "wait error, %d", err);
     } else {
       GST_DELAY_SINK_LOCK (asink);
-      err = snd_pcm_writei (alsa->handle, ptr, cptr);
+      if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        err = gst_alsasink_mmap_write (alsa, ptr, cptr);
+      else
+        err = snd_pcm_writei (alsa->handle, ptr, cptr);
       GST_DELAY_SINK_UNLOCK (asink);
     }
 
@@ -1146,30 +1338,8 @@ gst_alsasink_payload (GstAudioBaseSink * sink, GstBuffer * buf)
   alsa = GST_ALSA_SINK (sink);
 
   if (alsa->iec958) {
-    GstBuffer *out;
-    gint framesize;
-    GstMapInfo iinfo, oinfo;
-
-    framesize = gst_audio_iec61937_frame_size (&sink->ringbuffer->spec);
-    if (framesize <= 0)
-      return NULL;
-
-    out = gst_buffer_new_and_alloc (framesize);
-
-    gst_buffer_map (buf, &iinfo, GST_MAP_READ);
-    gst_buffer_map (out, &oinfo, GST_MAP_WRITE);
-
-    if (!gst_audio_iec61937_payload (iinfo.data, iinfo.size,
-            oinfo.data, oinfo.size, &sink->ringbuffer->spec, G_BIG_ENDIAN)) {
-      gst_buffer_unref (out);
-      return NULL;
-    }
-
-    gst_buffer_unmap (buf, &iinfo);
-    gst_buffer_unmap (out, &oinfo);
-
-    gst_buffer_copy_into (out, buf, GST_BUFFER_COPY_METADATA, 0, -1);
-    return out;
+    return gst_audio_iec61937_payload_buffer (buf, &sink->ringbuffer->spec,
+        G_BIG_ENDIAN);
   }
 
   return gst_buffer_ref (buf);
@@ -68,6 +68,9 @@ struct _GstAlsaSink {
   gint bpf;
   gboolean iec958;
   gboolean need_swap;
+  gboolean use_mmap;
+  gchar *link_group;
+  gchar *linked_group;          /* group the pcm is linked in, or NULL */
 
   guint buffer_time;
   guint period_time;
@@ -75,6 +78,8 @@ struct _GstAlsaSink {
   snd_pcm_uframes_t period_size;
 
   GstCaps *cached_caps;
+  gchar *cached_device_name;
+  gchar *cached_card_name;
 
   GMutex alsa_lock;
   GMutex delay_lock;
@@ -56,6 +56,8 @@
 #define DEFAULT_PROP_DEVICE		"default"
 #define DEFAULT_PROP_DEVICE_NAME	""
 #define DEFAULT_PROP_CARD_NAME	        ""
+#define DEFAULT_PROP_USE_MMAP		FALSE
+#define DEFAULT_PROP_USE_DRIVER_TIMESTAMPS	TRUE
 
 enum
 {
@@ -63,6 +65,8 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_USE_MMAP,
+  PROP_USE_DRIVER_TIMESTAMPS,
   PROP_LAST
 };
 
@@ -116,6 +120,8 @@ gst_alsasrc_finalize (GObject * object)
   GstAlsaSrc *src = GST_ALSA_SRC (object);
 
   g_free (src->device);
+  g_free (src->cached_device_name);
+  g_free (src->cached_card_name);
   g_mutex_clear (&src->alsa_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -170,6 +176,36 @@ gst_alsasrc_class_init (GstAlsaSrcClass * klass)
       g_param_spec_string ("card-name", "Card name",
           "Human-readable name of the sound card",
           DEFAULT_PROP_CARD_NAME, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSrc:use-mmap:
+   *
+   * Copy the samples directly from the memory mapped buffer of the device
+   * instead of using snd_pcm_readi(). Falls back to read/write access
+   * when the device does not support mmap.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Transfer samples through the memory mapped device buffer",
+          DEFAULT_PROP_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSrc:use-driver-timestamps:
+   *
+   * Timestamp the buffers with the high resolution capture time reported by
+   * the driver instead of the time the samples were read. This is only done
+   * when the pipeline runs on the monotonic system clock, which the driver
+   * timestamps are taken against.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_DRIVER_TIMESTAMPS,
+      g_param_spec_boolean ("use-driver-timestamps", "Use driver timestamps",
+          "Timestamp buffers with the capture time reported by the driver",
+          DEFAULT_PROP_USE_DRIVER_TIMESTAMPS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -188,6 +224,12 @@ gst_alsasrc_set_property (GObject * object, guint prop_id,
         src->device = g_strdup (DEFAULT_PROP_DEVICE);
       }
       break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
+    case PROP_USE_DRIVER_TIMESTAMPS:
+      src->use_driver_timestamps = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -208,13 +250,21 @@ gst_alsasrc_get_property (GObject * object, guint prop_id,
       break;
     case PROP_DEVICE_NAME:
       g_value_take_string (value,
-          gst_alsa_find_device_name (GST_OBJECT_CAST (src),
-              src->device, src->handle, SND_PCM_STREAM_CAPTURE));
+          gst_alsa_find_name_cached (GST_OBJECT_CAST (src), src->device,
+              &src->handle, SND_PCM_STREAM_CAPTURE, FALSE,
+              &src->cached_device_name));
       break;
     case PROP_CARD_NAME:
       g_value_take_string (value,
-          gst_alsa_find_card_name (GST_OBJECT_CAST (src),
-              src->device, SND_PCM_STREAM_CAPTURE));
+          gst_alsa_find_name_cached (GST_OBJECT_CAST (src), src->device,
+              &src->handle, SND_PCM_STREAM_CAPTURE, TRUE,
+              &src->cached_card_name));
+      break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
+    case PROP_USE_DRIVER_TIMESTAMPS:
+      g_value_set_boolean (value, src->use_driver_timestamps);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -243,7 +293,7 @@ gst_alsasrc_change_state (GstElement * element, GstStateChange transition)
 
       clk = gst_element_get_clock (element);
       if (clk != NULL) {
-        if (GST_IS_SYSTEM_CLOCK (clk)) {
+        if (alsa->use_driver_timestamps && GST_IS_SYSTEM_CLOCK (clk)) {
           gint clocktype;
           g_object_get (clk, "clock-type", &clocktype, NULL);
           if (clocktype == GST_CLOCK_TYPE_MONOTONIC) {
@@ -252,6 +302,7 @@ gst_alsasrc_change_state (GstElement * element, GstStateChange transition)
           }
         }
 
+
         gst_object_unref (clk);
       }
       break;
@@ -269,6 +320,8 @@ gst_alsasrc_init (GstAlsaSrc * alsasrc)
   alsasrc->device = g_strdup (DEFAULT_PROP_DEVICE);
   alsasrc->cached_caps = NULL;
   alsasrc->driver_timestamps = FALSE;
+  alsasrc->use_mmap = DEFAULT_PROP_USE_MMAP;
+  alsasrc->use_driver_timestamps = DEFAULT_PROP_USE_DRIVER_TIMESTAMPS;
 
   g_mutex_init (&alsasrc->alsa_lock);
 }
@@ -344,6 +397,12 @@ set_hwparams (GstAlsaSrc * alsa)
 
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
+  /* not all devices (and plugins) can be mmapped, use read/write then */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_test_access (alsa->handle, params, alsa->access) < 0) {
+    GST_WARNING_OBJECT (alsa, "mmap access not supported, using read/write");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   /* set the interleaved read/write format */
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
@@ -524,6 +583,12 @@ set_swparams (GstAlsaSrc * alsa)
   /* use monotonic timestamping */
   CHECK (snd_pcm_sw_params_set_tstamp_mode (alsa->handle, params,
           SND_PCM_TSTAMP_MMAP), tstamp_mode);
+#if GST_CHECK_ALSA_VERSION(1,0,29)
+  /* the driver timestamps are compared against the monotonic system clock,
+   * older versions always use it */
+  CHECK (snd_pcm_sw_params_set_tstamp_type (alsa->handle, params,
+          SND_PCM_TSTAMP_TYPE_MONOTONIC), tstamp_type);
+#endif
 
 #if GST_CHECK_ALSA_VERSION(1,0,16)
   /* snd_pcm_sw_params_set_xfer_align() is deprecated, alignment is always 1 */
@@ -569,6 +634,15 @@ tstamp_mode:
     snd_pcm_sw_params_free (params);
     return err;
   }
+#if GST_CHECK_ALSA_VERSION(1,0,29)
+tstamp_type:
+  {
+    GST_ELEMENT_ERROR (alsa, RESOURCE, SETTINGS, (NULL),
+        ("Unable to set tstamp type for playback: %s", snd_strerror (err)));
+    snd_pcm_sw_params_free (params);
+    return err;
+  }
+#endif
 #if !GST_CHECK_ALSA_VERSION(1,0,16)
 set_align:
   {
@@ -701,7 +775,8 @@ alsasrc_parse_spec (GstAlsaSrc * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED :
+      SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SRC
@@ -843,8 +918,14 @@ gst_alsasrc_close (GstAudioSrc * asrc)
 {
   GstAlsaSrc *alsa = GST_ALSA_SRC (asrc);
 
+  GST_OBJECT_LOCK (asrc);
   snd_pcm_close (alsa->handle);
   alsa->handle = NULL;
+  g_free (alsa->cached_device_name);
+  alsa->cached_device_name = NULL;
+  g_free (alsa->cached_card_name);
+  alsa->cached_card_name = NULL;
+  GST_OBJECT_UNLOCK (asrc);
 
   gst_caps_replace (&alsa->cached_caps, NULL);
 
@@ -887,7 +968,7 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
 {
   snd_pcm_status_t *status;
   snd_htimestamp_t tstamp;
-  GstClockTime timestamp;
+  GstClockTime timestamp, delay;
   snd_pcm_uframes_t avail;
   gint err = -EPIPE;
 
@@ -903,6 +984,7 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
 
   if (G_UNLIKELY (snd_pcm_status (asrc->handle, status) != 0)) {
     GST_ERROR_OBJECT (asrc, "snd_pcm_status failed");
+    snd_pcm_status_free (status);
     return GST_CLOCK_TIME_NONE;
   }
 
@@ -914,6 +996,8 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
     /* reload the status alsa status object, since recovery made it invalid */
     if (G_UNLIKELY (snd_pcm_status (asrc->handle, status) != 0)) {
       GST_ERROR_OBJECT (asrc, "snd_pcm_status failed");
+      snd_pcm_status_free (status);
+      return GST_CLOCK_TIME_NONE;
     }
   }
 
@@ -924,14 +1008,20 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
   /* max available frames sets the depth of the buffer */
   avail = snd_pcm_status_get_avail (status);
 
-  /* calculate the timestamp of the next sample to be read */
-  timestamp -= gst_util_uint64_scale_int (avail, GST_SECOND, asrc->rate);
+  snd_pcm_status_free (status);
 
-  /* compensate for the fact that we really need the timestamp of the
-   * previously read data segment */
-  timestamp -= asrc->period_time * 1000;
+  /* the driver did not update the timestamp yet */
+  if (G_UNLIKELY (timestamp == 0))
+    return GST_CLOCK_TIME_NONE;
 
-  snd_pcm_status_free (status);
+  /* calculate the timestamp of the next sample to be read and compensate
+   * for the fact that we really need the timestamp of the previously read
+   * data segment */
+  delay = gst_util_uint64_scale_int (avail, GST_SECOND, asrc->rate) +
+      asrc->period_time * 1000;
+  if (G_UNLIKELY (timestamp < delay))
+    return GST_CLOCK_TIME_NONE;
+  timestamp -= delay;
 
   GST_LOG_OBJECT (asrc, "ALSA timestamp : %" GST_TIME_FORMAT
       ", delay %lu", GST_TIME_ARGS (timestamp), avail);
@@ -939,6 +1029,54 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
   return timestamp;
 }
 
+/* copy the samples straight out of the mmapped device buffer. Returns the
+ * number of frames read or a negative error like snd_pcm_readi() */
+static snd_pcm_sframes_t
+gst_alsasrc_mmap_read (GstAlsaSrc * alsa, guint8 * ptr,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size;
+  snd_pcm_sframes_t avail, res;
+  gint err;
+
+  /* snd_pcm_readi() starts the capture implicitly, we have to do it */
+  if (snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    GST_DEBUG_OBJECT (alsa, "starting the device");
+    if ((err = snd_pcm_start (alsa->handle)) < 0)
+      return err;
+  }
+
+  /* block like snd_pcm_readi() until a period is available, the timeout
+   * is 4 times the period time */
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail >= 0 && (snd_pcm_uframes_t) avail < alsa->period_size) {
+    if ((err = snd_pcm_wait (alsa->handle, 4 * alsa->period_time / 1000)) < 0)
+      return err;
+    avail = snd_pcm_avail_update (alsa->handle);
+  }
+  if (avail < 0)
+    return avail;
+  if (avail == 0)
+    return -EAGAIN;
+
+  size = MIN (frames, (snd_pcm_uframes_t) avail);
+  if ((err = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+    return err;
+
+  /* interleaved, all channels share the first area */
+  memcpy (ptr, (const guint8 *) areas[0].addr + areas[0].first / 8 +
+      offset * (areas[0].step / 8), size * alsa->bpf);
+
+  res = snd_pcm_mmap_commit (alsa->handle, offset, size);
+  if (res < 0)
+    return res;
+  if ((snd_pcm_uframes_t) res != size)
+    return -EPIPE;
+
+  return res;
+}
+
 static guint
 gst_alsasrc_read (GstAudioSrc * asrc, gpointer data, guint length,
     GstClockTime * timestamp)
@@ -954,7 +1092,12 @@ gst_alsasrc_read (GstAudioSrc * asrc, gpointer data, guint length,
 
   GST_ALSA_SRC_LOCK (asrc);
   while (cptr > 0) {
-    if ((err = snd_pcm_readi (alsa->handle, ptr, cptr)) < 0) {
+    if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+      err = gst_alsasrc_mmap_read (alsa, ptr, cptr);
+    else
+      err = snd_pcm_readi (alsa->handle, ptr, cptr);
+
+    if (err < 0) {
       if (err == -EAGAIN) {
         GST_DEBUG_OBJECT (asrc, "Read error: %s", snd_strerror (err));
         continue;
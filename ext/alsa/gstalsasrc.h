@@ -57,6 +57,8 @@ struct _GstAlsaSrc {
   snd_pcm_sw_params_t   *swparams;
 
   GstCaps               *cached_caps;
+  gchar                 *cached_device_name;
+  gchar                 *cached_card_name;
 
   snd_pcm_access_t      access;
   snd_pcm_format_t      format;
@@ -64,6 +66,8 @@ struct _GstAlsaSrc {
   guint                 channels;
   gint                  bpf;
   gboolean              driver_timestamps;
+  gboolean              use_mmap;
+  gboolean              use_driver_timestamps;
 
   guint                 buffer_time;
   guint                 period_time;
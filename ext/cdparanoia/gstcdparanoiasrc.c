@@ -45,7 +45,8 @@ enum
   PROP_PARANOIA_MODE,
   PROP_SEARCH_OVERLAP,
   PROP_GENERIC_DEVICE,
-  PROP_CACHE_SIZE
+  PROP_CACHE_SIZE,
+  PROP_READ_AHEAD
 };
 
 #define DEFAULT_READ_SPEED              -1
@@ -53,6 +54,7 @@ enum
 #define DEFAULT_PARANOIA_MODE            PARANOIA_MODE_FRAGMENT
 #define DEFAULT_GENERIC_DEVICE           NULL
 #define DEFAULT_CACHE_SIZE              -1
+#define DEFAULT_READ_AHEAD               0
 
 GST_DEBUG_CATEGORY_STATIC (gst_cd_paranoia_src_debug);
 #define GST_CAT_DEFAULT gst_cd_paranoia_src_debug
@@ -70,13 +72,13 @@ static GstBuffer *gst_cd_paranoia_src_read_sector (GstAudioCdSrc * src,
 static gboolean gst_cd_paranoia_src_open (GstAudioCdSrc * src,
     const gchar * device);
 static void gst_cd_paranoia_src_close (GstAudioCdSrc * src);
+static void gst_cd_paranoia_src_stop_reader (GstCdParanoiaSrc * src);
 
-/* We use these to serialize calls to paranoia_read() among several
- * cdparanoiasrc instances. We do this because it's the only reasonably
- * easy way to find out the calling object from within the paranoia
- * callback, and we need the object instance in there to emit our signals */
-static GstCdParanoiaSrc *cur_cb_source;
-static GMutex cur_cb_mutex;
+/* The paranoia callback has no user data, so we remember the object that
+ * calls paranoia_read() per thread; we need the object instance in there to
+ * emit our signals. This way several cdparanoiasrc instances can read from
+ * their drives in parallel. */
+static GPrivate cur_cb_source;
 
 static gint cdpsrc_signals[NUM_SIGNALS];        /* all 0 */
 
@@ -115,6 +117,11 @@ gst_cd_paranoia_src_init (GstCdParanoiaSrc * src)
   src->read_speed = DEFAULT_READ_SPEED;
   src->generic_device = g_strdup (DEFAULT_GENERIC_DEVICE);
   src->cache_size = DEFAULT_CACHE_SIZE;
+  src->read_ahead = DEFAULT_READ_AHEAD;
+
+  g_mutex_init (&src->reader_lock);
+  g_cond_init (&src->reader_cond);
+  g_queue_init (&src->sectors);
 }
 
 static void
@@ -165,6 +172,19 @@ gst_cd_paranoia_src_class_init (GstCdParanoiaSrcClass * klass)
           "Set CD cache size to n sectors (-1 = auto)", -1,
           G_MAXINT, DEFAULT_CACHE_SIZE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCdParanoiaSrc:read-ahead:
+   *
+   * Read up to n sectors ahead in a separate thread so that the drive keeps
+   * reading while downstream is busy (0 = disabled)
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_READ_AHEAD,
+      g_param_spec_int ("read-ahead", "Read ahead",
+          "Read up to n sectors ahead in a separate thread (0 = disabled)", 0,
+          G_MAXINT, DEFAULT_READ_AHEAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   /* FIXME: we don't really want signals for this, but messages on the bus,
    * but then we can't check any longer whether anyone is interested in them */
@@ -266,6 +286,7 @@ gst_cd_paranoia_src_open (GstAudioCdSrc * audiocdsrc, const gchar * device)
   paranoia_cachemodel_size (src->p, cache_size);
   GST_INFO_OBJECT (src, "set cachemodel size to %u", cache_size);
 
+  src->last_sector = cdda_disc_lastsector (src->d);
   src->next_sector = -1;
 
   return TRUE;
@@ -298,6 +319,8 @@ gst_cd_paranoia_src_close (GstAudioCdSrc * audiocdsrc)
 {
   GstCdParanoiaSrc *src = GST_CD_PARANOIA_SRC (audiocdsrc);
 
+  gst_cd_paranoia_src_stop_reader (src);
+
   if (src->p) {
     paranoia_free (src->p);
     src->p = NULL;
@@ -320,7 +343,7 @@ gst_cd_paranoia_dummy_callback (long inpos, int function)
 static void
 gst_cd_paranoia_paranoia_callback (long inpos, int function)
 {
-  GstCdParanoiaSrc *src = cur_cb_source;
+  GstCdParanoiaSrc *src = g_private_get (&cur_cb_source);
   gint sector = (gint) (inpos / CD_FRAMEWORDS);
 
   switch (function) {
@@ -343,13 +366,110 @@ gst_cd_paranoia_src_signal_is_being_watched (GstCdParanoiaSrc * src, gint sig)
   return g_signal_has_handler_pending (src, cdpsrc_signals[sig], 0, FALSE);
 }
 
+/* reads the sector at the current paranoia position */
+static GstBuffer *
+gst_cd_paranoia_src_read_one (GstCdParanoiaSrc * src)
+{
+  GstBuffer *buf;
+  gint16 *cdda_buf;
+
+  if (gst_cd_paranoia_src_signal_is_being_watched (src, TRANSPORT_ERROR) ||
+      gst_cd_paranoia_src_signal_is_being_watched (src, UNCORRECTED_ERROR)) {
+    GST_LOG_OBJECT (src, "Signal handlers connected, using callback");
+    g_private_set (&cur_cb_source, src);
+    cdda_buf = paranoia_read (src->p, gst_cd_paranoia_paranoia_callback);
+    g_private_set (&cur_cb_source, NULL);
+  } else {
+    cdda_buf = paranoia_read (src->p, gst_cd_paranoia_dummy_callback);
+  }
+
+  if (cdda_buf == NULL)
+    return NULL;
+
+  buf = gst_buffer_new_and_alloc (CD_FRAMESIZE_RAW);
+  gst_buffer_fill (buf, 0, cdda_buf, CD_FRAMESIZE_RAW);
+
+  return buf;
+}
+
+static gpointer
+gst_cd_paranoia_src_reader_thread (GstCdParanoiaSrc * src)
+{
+  GstBuffer *buf;
+
+  GST_DEBUG_OBJECT (src, "reader started at sector %d", src->reader_sector);
+
+  g_mutex_lock (&src->reader_lock);
+  while (!src->reader_stop) {
+    /* wait for room in the queue, stop at the end of the disc or after an
+     * error, the streaming thread will ask to restart us after a seek */
+    if (src->reader_error || src->reader_sector > src->last_sector ||
+        g_queue_get_length (&src->sectors) >= src->reader_max) {
+      g_cond_wait (&src->reader_cond, &src->reader_lock);
+      continue;
+    }
+    g_mutex_unlock (&src->reader_lock);
+
+    buf = gst_cd_paranoia_src_read_one (src);
+
+    g_mutex_lock (&src->reader_lock);
+    if (buf) {
+      g_queue_push_tail (&src->sectors, buf);
+      src->reader_sector++;
+    } else {
+      GST_DEBUG_OBJECT (src, "read at sector %d failed", src->reader_sector);
+      src->reader_error = TRUE;
+    }
+    g_cond_broadcast (&src->reader_cond);
+  }
+  g_mutex_unlock (&src->reader_lock);
+
+  GST_DEBUG_OBJECT (src, "reader stopped at sector %d", src->reader_sector);
+
+  return NULL;
+}
+
+static void
+gst_cd_paranoia_src_stop_reader (GstCdParanoiaSrc * src)
+{
+  if (src->reader == NULL)
+    return;
+
+  g_mutex_lock (&src->reader_lock);
+  src->reader_stop = TRUE;
+  g_cond_broadcast (&src->reader_cond);
+  g_mutex_unlock (&src->reader_lock);
+
+  g_thread_join (src->reader);
+  src->reader = NULL;
+
+  g_queue_foreach (&src->sectors, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&src->sectors);
+
+  /* the paranoia position is where the reader stopped, force a seek */
+  src->next_sector = -1;
+}
+
+static void
+gst_cd_paranoia_src_start_reader (GstCdParanoiaSrc * src, gint sector)
+{
+  GST_OBJECT_LOCK (src);
+  src->reader_max = src->read_ahead;
+  GST_OBJECT_UNLOCK (src);
+
+  src->reader_sector = sector;
+  src->reader_stop = FALSE;
+  src->reader_error = FALSE;
+  src->reader = g_thread_new ("cdparanoia-reader",
+      (GThreadFunc) gst_cd_paranoia_src_reader_thread, src);
+}
+
 static GstBuffer *
 gst_cd_paranoia_src_read_sector (GstAudioCdSrc * audiocdsrc, gint sector)
 {
   GstCdParanoiaSrc *src = GST_CD_PARANOIA_SRC (audiocdsrc);
   GstBuffer *buf;
-  gboolean do_serialize;
-  gint16 *cdda_buf;
+  gint read_ahead;
 
 #if 0
   /* Do we really need to output this? (tpm) */
@@ -363,39 +483,43 @@ gst_cd_paranoia_src_read_sector (GstAudioCdSrc * audiocdsrc, gint sector)
   }
 #endif
 
-  if (src->next_sector == -1 || src->next_sector != sector) {
-    if (paranoia_seek (src->p, sector, SEEK_SET) == -1)
-      goto seek_failed;
+  /* the sectors read ahead are of no use after a seek */
+  if (src->reader && src->next_sector != sector)
+    gst_cd_paranoia_src_stop_reader (src);
 
-    GST_DEBUG_OBJECT (src, "successfully seeked to sector %d", sector);
-    src->next_sector = sector;
-  }
+  if (src->reader == NULL) {
+    if (src->next_sector == -1 || src->next_sector != sector) {
+      if (paranoia_seek (src->p, sector, SEEK_SET) == -1)
+        goto seek_failed;
 
-  do_serialize =
-      gst_cd_paranoia_src_signal_is_being_watched (src, TRANSPORT_ERROR) ||
-      gst_cd_paranoia_src_signal_is_being_watched (src, UNCORRECTED_ERROR);
+      GST_DEBUG_OBJECT (src, "successfully seeked to sector %d", sector);
+      src->next_sector = sector;
+    }
 
-  if (do_serialize) {
-    GST_LOG_OBJECT (src, "Signal handlers connected, serialising access");
-    g_mutex_lock (&cur_cb_mutex);
-    GST_LOG_OBJECT (src, "Got lock");
-    cur_cb_source = src;
+    GST_OBJECT_LOCK (src);
+    read_ahead = src->read_ahead;
+    GST_OBJECT_UNLOCK (src);
 
-    cdda_buf = paranoia_read (src->p, gst_cd_paranoia_paranoia_callback);
+    if (read_ahead > 0)
+      gst_cd_paranoia_src_start_reader (src, sector);
+  }
 
-    cur_cb_source = NULL;
-    GST_LOG_OBJECT (src, "Releasing lock");
-    g_mutex_unlock (&cur_cb_mutex);
+  if (src->reader) {
+    g_mutex_lock (&src->reader_lock);
+    while (g_queue_is_empty (&src->sectors) && !src->reader_error &&
+        src->reader_sector <= src->last_sector)
+      g_cond_wait (&src->reader_cond, &src->reader_lock);
+    buf = g_queue_pop_head (&src->sectors);
+    /* make room for the next sector */
+    g_cond_broadcast (&src->reader_cond);
+    g_mutex_unlock (&src->reader_lock);
   } else {
-    cdda_buf = paranoia_read (src->p, gst_cd_paranoia_dummy_callback);
+    buf = gst_cd_paranoia_src_read_one (src);
   }
 
-  if (cdda_buf == NULL)
+  if (buf == NULL)
     goto read_failed;
 
-  buf = gst_buffer_new_and_alloc (CD_FRAMESIZE_RAW);
-  gst_buffer_fill (buf, 0, cdda_buf, CD_FRAMESIZE_RAW);
-
   /* cdda base class will take care of timestamping etc. */
   ++src->next_sector;
 
@@ -427,6 +551,9 @@ gst_cd_paranoia_src_finalize (GObject * obj)
 
   g_free (src->generic_device);
 
+  g_mutex_clear (&src->reader_lock);
+  g_cond_clear (&src->reader_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
 
@@ -466,6 +593,10 @@ gst_cd_paranoia_src_set_property (GObject * object, guint prop_id,
       src->cache_size = g_value_get_int (value);
       break;
     }
+    case PROP_READ_AHEAD:{
+      src->read_ahead = g_value_get_int (value);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -498,6 +629,9 @@ gst_cd_paranoia_src_get_property (GObject * object, guint prop_id,
     case PROP_CACHE_SIZE:
       g_value_set_int (value, src->cache_size);
       break;
+    case PROP_READ_AHEAD:
+      g_value_set_int (value, src->read_ahead);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -66,8 +66,21 @@ struct _GstCdParanoiaSrc {
   gint             read_speed;
   gint             search_overlap;
   gint             cache_size;
+  gint             read_ahead;
 
   gchar           *generic_device;
+
+  gint             last_sector;  /* last sector of the disc */
+
+  /* read-ahead thread, the queue and flags are protected by reader_lock */
+  GThread         *reader;
+  GMutex           reader_lock;
+  GCond            reader_cond;
+  GQueue           sectors;      /* sectors read ahead, from next_sector */
+  guint            reader_max;   /* max sectors in the queue */
+  gint             reader_sector; /* sector the reader reads next */
+  gboolean         reader_stop;
+  gboolean         reader_error;
 };
 
 struct _GstCdParanoiaSrcClass {
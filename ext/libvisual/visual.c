@@ -30,6 +30,14 @@ GST_DEBUG_CATEGORY_EXTERN (libvisual_debug);
 /* amounf of samples before we can feed libvisual */
 #define VISUAL_SAMPLES  512
 
+#define DEFAULT_DOWNSCALE 1
+
+enum
+{
+  PROP_0,
+  PROP_DOWNSCALE
+};
+
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -54,6 +62,10 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
 
 static void gst_visual_init (GstVisual * visual);
 static void gst_visual_finalize (GObject * object);
+static void gst_visual_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_visual_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_visual_setup (GstAudioVisualizer * bscope);
 static gboolean gst_visual_render (GstAudioVisualizer * bscope,
@@ -98,6 +110,24 @@ gst_visual_class_init (gpointer g_class, gpointer class_data)
 
   if (class_data == NULL) {
     parent_class = g_type_class_peek_parent (g_class);
+
+    gobject_class->set_property = gst_visual_set_property;
+    gobject_class->get_property = gst_visual_get_property;
+
+    /**
+     * GstVisual:downscale:
+     *
+     * Render the actor at 1/downscale of the output width and height and
+     * scale the result up to the output size. This makes the visualisation
+     * a lot cheaper on slow machines. The RGB16 output format is always
+     * rendered at the output size.
+     *
+     * Since: 1.10
+     */
+    g_object_class_install_property (gobject_class, PROP_DOWNSCALE,
+        g_param_spec_uint ("downscale", "Downscale",
+            "Render at 1/downscale of the output size and scale up", 1, 16,
+            DEFAULT_DOWNSCALE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   } else {
     gchar *longname = g_strdup_printf ("libvisual %s plugin v.%s",
         klass->plugin->info->name, klass->plugin->info->version);
@@ -122,7 +152,44 @@ gst_visual_class_init (gpointer g_class, gpointer class_data)
 static void
 gst_visual_init (GstVisual * visual)
 {
-  /* do nothing */
+  visual->downscale = DEFAULT_DOWNSCALE;
+}
+
+static void
+gst_visual_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVisual *visual = GST_VISUAL (object);
+
+  switch (prop_id) {
+    case PROP_DOWNSCALE:
+      GST_OBJECT_LOCK (visual);
+      /* used from the next caps */
+      visual->downscale = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (visual);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_visual_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVisual *visual = GST_VISUAL (object);
+
+  switch (prop_id) {
+    case PROP_DOWNSCALE:
+      GST_OBJECT_LOCK (visual);
+      g_value_set_uint (value, visual->downscale);
+      GST_OBJECT_UNLOCK (visual);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static void
@@ -140,6 +207,16 @@ gst_visual_clear_actors (GstVisual * visual)
     visual_object_unref (VISUAL_OBJECT (visual->audio));
     visual->audio = NULL;
   }
+  if (visual->hscale) {
+    gst_video_scaler_free (visual->hscale);
+    visual->hscale = NULL;
+  }
+  if (visual->vscale) {
+    gst_video_scaler_free (visual->vscale);
+    visual->vscale = NULL;
+  }
+  g_free (visual->render_data);
+  visual->render_data = NULL;
 }
 
 static void
@@ -156,10 +233,22 @@ static gboolean
 gst_visual_setup (GstAudioVisualizer * bscope)
 {
   GstVisual *visual = GST_VISUAL (bscope);
-  gint depth;
+  gint depth, width, height;
+  guint downscale;
 
   gst_visual_clear_actors (visual);
 
+  width = GST_VIDEO_INFO_WIDTH (&bscope->vinfo);
+  height = GST_VIDEO_INFO_HEIGHT (&bscope->vinfo);
+
+  GST_OBJECT_LOCK (visual);
+  downscale = visual->downscale;
+  GST_OBJECT_UNLOCK (visual);
+
+  /* the video scaler can't do RGB16 */
+  if (GST_VIDEO_INFO_FORMAT (&bscope->vinfo) == GST_VIDEO_FORMAT_RGB16)
+    downscale = 1;
+
   /* FIXME: we need to know how many bits we actually have in memory */
   depth = bscope->vinfo.finfo->pixel_stride[0];
   if (bscope->vinfo.finfo->bits >= 8) {
@@ -181,14 +270,32 @@ gst_visual_setup (GstAudioVisualizer * bscope)
 
   visual_video_set_depth (visual->video,
       visual_video_depth_enum_from_value (depth));
-  visual_video_set_dimension (visual->video,
-      GST_VIDEO_INFO_WIDTH (&bscope->vinfo),
-      GST_VIDEO_INFO_HEIGHT (&bscope->vinfo));
+  if (downscale > 1) {
+    gint pstride = GST_VIDEO_INFO_COMP_PSTRIDE (&bscope->vinfo, 0);
+    gint render_width = MAX (width / downscale, 1);
+    gint render_height = MAX (height / downscale, 1);
+
+    /* the actor renders into our memory, the scalers fill the output frame */
+    visual->render_stride = GST_ROUND_UP_4 (render_width * pstride);
+    visual->render_data = g_malloc0 (visual->render_stride * render_height);
+    visual->hscale =
+        gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+        GST_VIDEO_SCALER_FLAG_NONE, 0, render_width, width, NULL);
+    visual->vscale =
+        gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+        GST_VIDEO_SCALER_FLAG_NONE, 0, render_height, height, NULL);
+
+    width = render_width;
+    height = render_height;
+  }
+
+  visual_video_set_dimension (visual->video, width, height);
   visual_actor_video_negotiate (visual->actor, 0, FALSE, FALSE);
 
-  GST_DEBUG_OBJECT (visual, "WxH: %dx%d, bpp: %d, depth: %d",
-      GST_VIDEO_INFO_WIDTH (&bscope->vinfo),
-      GST_VIDEO_INFO_HEIGHT (&bscope->vinfo), visual->video->bpp, depth);
+  GST_DEBUG_OBJECT (visual, "WxH: %dx%d, render WxH: %dx%d, bpp: %d, "
+      "depth: %d", GST_VIDEO_INFO_WIDTH (&bscope->vinfo),
+      GST_VIDEO_INFO_HEIGHT (&bscope->vinfo), width, height,
+      visual->video->bpp, depth);
 
   return TRUE;
   /* ERRORS */
@@ -221,10 +328,15 @@ gst_visual_render (GstAudioVisualizer * bscope, GstBuffer * audio,
   guint16 ldata[VISUAL_SAMPLES], rdata[VISUAL_SAMPLES];
   VisAudioSampleRateType vrate;
 
-  visual_video_set_buffer (visual->video, GST_VIDEO_FRAME_PLANE_DATA (video,
-          0));
-  visual_video_set_pitch (visual->video, GST_VIDEO_FRAME_PLANE_STRIDE (video,
-          0));
+  if (visual->render_data) {
+    visual_video_set_buffer (visual->video, visual->render_data);
+    visual_video_set_pitch (visual->video, visual->render_stride);
+  } else {
+    visual_video_set_buffer (visual->video, GST_VIDEO_FRAME_PLANE_DATA (video,
+            0));
+    visual_video_set_pitch (visual->video, GST_VIDEO_FRAME_PLANE_STRIDE (video,
+            0));
+  }
 
   channels = GST_AUDIO_INFO_CHANNELS (&bscope->ainfo);
 
@@ -292,6 +404,14 @@ gst_visual_render (GstAudioVisualizer * bscope, GstBuffer * audio,
   visual_actor_run (visual->actor, visual->audio);
   visual_video_set_buffer (visual->video, NULL);
 
+  if (visual->render_data) {
+    gst_video_scaler_2d (visual->hscale, visual->vscale,
+        GST_VIDEO_FRAME_FORMAT (video), visual->render_data,
+        visual->render_stride, GST_VIDEO_FRAME_PLANE_DATA (video, 0),
+        GST_VIDEO_FRAME_PLANE_STRIDE (video, 0), 0, 0,
+        GST_VIDEO_FRAME_WIDTH (video), GST_VIDEO_FRAME_HEIGHT (video));
+  }
+
   GST_DEBUG_OBJECT (visual, "rendered one frame");
 done:
   gst_buffer_unmap (audio, &amap);
@@ -50,6 +50,12 @@ struct _GstVisual
   VisAudio *audio;
   VisVideo *video;
   VisActor *actor;
+
+  /* render at a lower resolution and scale up */
+  guint downscale;
+  guint8 *render_data;
+  gint render_stride;
+  GstVideoScaler *hscale, *vscale;
 };
 
 struct _GstVisualClass
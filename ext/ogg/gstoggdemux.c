@@ -62,6 +62,9 @@
 
 #define SEEK_GIVE_UP_THRESHOLD (3*GST_SECOND)
 
+/* pages remembered per chain for narrowing the bisection of later seeks */
+#define MAX_SEEK_INDEX_ENTRIES 4096
+
 #define GST_CHAIN_LOCK(ogg)     g_mutex_lock(&(ogg)->chain_lock)
 #define GST_CHAIN_UNLOCK(ogg)   g_mutex_unlock(&(ogg)->chain_lock)
 
@@ -771,7 +774,28 @@ gst_ogg_demux_chain_peer (GstOggPad * pad, ogg_packet * packet,
   if (!pad->added)
     goto not_added;
 
-  buf = gst_buffer_new_and_alloc (packet->bytes - offset - trim);
+  /* in key units trick mode the decoder only wants the keyframes, don't
+   * bother copying and pushing the other video packets */
+  if (pad->map.is_video && delta_unit && !is_header
+      && (ogg->segment.flags & GST_SEGMENT_FLAG_TRICKMODE_KEY_UNITS)) {
+    GST_LOG_OBJECT (pad, "skipping delta unit in key units trick mode");
+    goto done;
+  }
+
+  if (pad->page_body && packet->packet >= pad->page_body &&
+      packet->packet + packet->bytes <= pad->page_body + pad->page_body_size) {
+    /* the packet is in the input buffer, share its memory */
+    buf = gst_buffer_copy_region (ogg->input_buffer, GST_BUFFER_COPY_MEMORY,
+        pad->page_offset + (packet->packet - pad->page_body) + offset,
+        packet->bytes - offset - trim);
+  } else {
+    buf = gst_buffer_new_and_alloc (packet->bytes - offset - trim);
+    if (packet->packet != NULL) {
+      /* copy packet in buffer */
+      gst_buffer_fill (buf, 0, packet->packet + offset,
+          packet->bytes - offset - trim);
+    }
+  }
 
   if (pad->map.audio_clipping && (clip_start || clip_end)) {
     GST_DEBUG_OBJECT (pad,
@@ -789,12 +813,6 @@ gst_ogg_demux_chain_peer (GstOggPad * pad, ogg_packet * packet,
   if (is_header)
     GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_HEADER);
 
-  if (packet->packet != NULL) {
-    /* copy packet in buffer */
-    gst_buffer_fill (buf, 0, packet->packet + offset,
-        packet->bytes - offset - trim);
-  }
-
   GST_BUFFER_TIMESTAMP (buf) = out_timestamp;
   GST_BUFFER_DURATION (buf) = out_duration;
   GST_BUFFER_OFFSET (buf) = out_offset;
@@ -1939,6 +1957,32 @@ gst_ogg_demux_query_duration_push (GstOggDemux * ogg)
   }
 }
 
+/* when @page is in the buffer we are parsing, remember where its body ended
+ * up in the stream buffer so that the packets of the page can be pushed as
+ * sub-buffers of the input instead of copies. @body_fill is the amount of
+ * data that was in the stream buffer before the page was added. */
+static void
+gst_ogg_pad_map_page (GstOggPad * pad, ogg_page * page, glong body_fill)
+{
+  GstOggDemux *ogg = pad->ogg;
+  ogg_stream_state *os = &pad->map.stream;
+  glong copied = os->body_fill - body_fill;
+
+  pad->page_body = NULL;
+
+  if (ogg->input_buffer == NULL || copied <= 0 || copied > page->body_len)
+    return;
+  if (page->body < ogg->input_data ||
+      page->body + page->body_len > ogg->input_data + ogg->input_size)
+    return;
+
+  /* libogg adds the end of the body, it skips the start of a continued
+   * packet when it doesn't have the beginning of it */
+  pad->page_body = os->body_data + os->body_fill - copied;
+  pad->page_body_size = copied;
+  pad->page_offset = page->body + page->body_len - copied - ogg->input_data;
+}
+
 /* submit a page to an oggpad, this function will then submit all
  * the packets in the page.
  */
@@ -1948,6 +1992,7 @@ gst_ogg_pad_submit_page (GstOggPad * pad, ogg_page * page)
   GstFlowReturn result = GST_FLOW_OK;
   GstOggDemux *ogg;
   gboolean continued = FALSE;
+  glong body_fill;
 
   ogg = pad->ogg;
 
@@ -1991,14 +2036,17 @@ gst_ogg_pad_submit_page (GstOggPad * pad, ogg_page * page)
   if (page->header_len + page->body_len > ogg->max_page_size)
     ogg->max_page_size = page->header_len + page->body_len;
 
+  body_fill = pad->map.stream.body_fill - pad->map.stream.body_returned;
   if (ogg_stream_pagein (&pad->map.stream, page) != 0)
     goto choked;
   if (pad->current_granule == -1)
     gst_ogg_demux_setup_first_granule (ogg, pad, page);
 
+  gst_ogg_pad_map_page (pad, page, body_fill);
   /* flush all packets in the stream layer, this might not give a packet if
    * the page had no packets finishing on the page (npackets == 0). */
   result = gst_ogg_pad_stream_out (pad, 0);
+  pad->page_body = NULL;
 
   if (pad->continued) {
     ogg_packet packet;
@@ -2065,6 +2113,7 @@ gst_ogg_chain_new (GstOggDemux * ogg)
   chain->segment_start = GST_CLOCK_TIME_NONE;
   chain->segment_stop = GST_CLOCK_TIME_NONE;
   chain->total_time = GST_CLOCK_TIME_NONE;
+  chain->seek_index = g_array_new (FALSE, FALSE, sizeof (GstOggSeekEntry));
 
   return chain;
 }
@@ -2080,9 +2129,73 @@ gst_ogg_chain_free (GstOggChain * chain)
     gst_object_unref (pad);
   }
   g_array_free (chain->streams, TRUE);
+  g_array_free (chain->seek_index, TRUE);
   g_slice_free (GstOggChain, chain);
 }
 
+/* remember where a page with a known time is, every bisection step is a
+ * read from upstream */
+static void
+gst_ogg_chain_add_seek_entry (GstOggChain * chain, gint64 offset,
+    GstClockTime time, guint32 serialno)
+{
+  GstOggSeekEntry entry;
+  guint lo = 0, hi = chain->seek_index->len;
+
+  if (hi >= MAX_SEEK_INDEX_ENTRIES)
+    return;
+
+  while (lo < hi) {
+    guint mid = (lo + hi) / 2;
+    gint64 o = g_array_index (chain->seek_index, GstOggSeekEntry, mid).offset;
+
+    if (o == offset)
+      return;
+    if (o < offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  entry.offset = offset;
+  entry.time = time;
+  entry.serialno = serialno;
+  g_array_insert_val (chain->seek_index, lo, entry);
+}
+
+/* narrow [begin, end) to the last page before @target and the first page at
+ * or after it that we know of. Pages of interleaved streams are not strictly
+ * ordered in time, so stop at the first page after @target to keep the range
+ * valid. */
+static void
+gst_ogg_chain_narrow_seek (GstOggChain * chain, gint64 target,
+    gboolean only_serial_no, gint serialno, gint64 * begin, gint64 * end,
+    gint64 * begintime, gint64 * endtime)
+{
+  guint i;
+
+  for (i = 0; i < chain->seek_index->len; i++) {
+    GstOggSeekEntry *entry;
+
+    entry = &g_array_index (chain->seek_index, GstOggSeekEntry, i);
+    if (entry->offset < *begin)
+      continue;
+    if (entry->offset >= *end)
+      break;
+    if (only_serial_no && entry->serialno != serialno)
+      continue;
+
+    if (entry->time < target) {
+      *begin = entry->offset;
+      *begintime = entry->time;
+    } else {
+      *end = entry->offset;
+      *endtime = entry->time;
+      break;
+    }
+  }
+}
+
 static void
 gst_ogg_pad_mark_discont (GstOggPad * pad)
 {
@@ -2477,6 +2590,12 @@ gst_ogg_demux_submit_buffer (GstOggDemux * ogg, GstBuffer * buffer)
     goto write_failed;
 
   if (!ogg->pullmode) {
+    /* the pages that are completely in this buffer can be pushed as
+     * sub-buffers of it, keep it until all its pages are handled */
+    gst_buffer_replace (&ogg->input_buffer, buffer);
+    ogg->input_data = (const guchar *) oggbuffer;
+    ogg->input_size = size;
+
     GST_PUSH_LOCK (ogg);
     ogg->push_byte_offset += size;
     GST_PUSH_UNLOCK (ogg);
@@ -3018,6 +3137,9 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
   GstFlowReturn ret;
   gint64 result = 0;
 
+  gst_ogg_chain_narrow_seek (chain, target, only_serial_no, serialno, &begin,
+      &end, &begintime, &endtime);
+
   best = begin;
 
   GST_DEBUG_OBJECT (ogg,
@@ -3113,6 +3235,9 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
             "found page with granule %" G_GINT64_FORMAT " and time %"
             GST_TIME_FORMAT, granulepos, GST_TIME_ARGS (granuletime));
 
+        gst_ogg_chain_add_seek_entry (chain, result, granuletime,
+            pad->map.serialno);
+
         if (granuletime < target) {
           best = result;        /* raw offset of packet with granulepos */
           begin = ogg->offset;  /* raw offset of next page */
@@ -3154,6 +3279,25 @@ seek_error:
   }
 }
 
+/* if all streams we would look for keyframes in have an index */
+static gboolean
+gst_ogg_chain_is_indexed (GstOggChain * chain)
+{
+  gboolean indexed = FALSE;
+  guint i;
+
+  for (i = 0; i < chain->streams->len; i++) {
+    GstOggPad *pad = g_array_index (chain->streams, GstOggPad *, i);
+
+    if (pad->map.is_skeleton || pad->map.is_sparse)
+      continue;
+    if (pad->map.index == NULL || pad->map.n_index == 0)
+      return FALSE;
+    indexed = TRUE;
+  }
+  return indexed;
+}
+
 static gboolean
 do_index_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
     gint64 end, gint64 begintime, gint64 endtime, gint64 target,
@@ -3235,6 +3379,27 @@ gst_ogg_demux_do_seek (GstOggDemux * ogg, GstSegment * segment,
   endtime = begintime + chain->total_time;
   target = position - total + begintime;
 
+  /* with a skeleton index for all streams we know where the keyframes
+   * are, no need to bisect */
+  if (segment->rate > 0.0 && gst_ogg_chain_is_indexed (chain)) {
+    gint64 index_time;
+
+    if (do_index_search (ogg, chain, begin, end, begintime, endtime, target,
+            &best, &index_time)) {
+      /* index offsets are relative to the start of the chain */
+      best += chain->offset;
+      if (best >= chain->offset && best < chain->end_offset) {
+        GST_DEBUG_OBJECT (ogg, "index gave offset %" G_GINT64_FORMAT
+            " for time %" GST_TIME_FORMAT, best, GST_TIME_ARGS (index_time));
+        gst_ogg_demux_seek (ogg, best);
+        keytarget = index_time + begintime;
+        goto done;
+      }
+      GST_WARNING_OBJECT (ogg, "index offset %" G_GINT64_FORMAT
+          " outside of the chain, bisecting", best);
+    }
+  }
+
   if (!do_binary_search (ogg, chain, begin, end, begintime, endtime, target,
           &best, FALSE, 0))
     goto seek_error;
@@ -4152,11 +4317,13 @@ gst_ogg_demux_read_chain (GstOggDemux * ogg, GstOggChain ** res_chain)
 }
 
 /* read the last pages from the ogg stream to get the final
- * page end_offsets.
+ * page end_offsets. We go back one chunk at a time and only look at the
+ * pages that start in that chunk, the pages after it were already checked.
  */
 static GstFlowReturn
 gst_ogg_demux_read_end_chain (GstOggDemux * ogg, GstOggChain * chain)
 {
+  gint64 start = MAX (chain->offset, 0);
   gint64 begin = chain->end_offset;
   gint64 end = begin;
   gint64 last_granule = -1;
@@ -4166,10 +4333,10 @@ gst_ogg_demux_read_end_chain (GstOggDemux * ogg, GstOggChain * chain)
   ogg_page og;
   gint i;
 
-  while (!done) {
-    begin -= ogg->chunk_size;
-    if (begin < 0)
-      begin = 0;
+  while (!done && end > start) {
+    begin = end - ogg->chunk_size;
+    if (begin < start)
+      begin = start;
 
     gst_ogg_demux_seek (ogg, begin);
 
@@ -4202,6 +4369,7 @@ gst_ogg_demux_read_end_chain (GstOggDemux * ogg, GstOggChain * chain)
         }
       }
     }
+    end = begin;
   }
 
   if (last_pad) {
@@ -4590,6 +4758,8 @@ gst_ogg_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       }
     }
   }
+  gst_buffer_replace (&ogg->input_buffer, NULL);
+
   if (ret == 0 || result == GST_FLOW_OK) {
     gst_ogg_demux_sync_streams (ogg);
   }
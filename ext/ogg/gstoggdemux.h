@@ -52,6 +52,15 @@ typedef struct _GstOggDemux GstOggDemux;
 typedef struct _GstOggDemuxClass GstOggDemuxClass;
 typedef struct _GstOggChain GstOggChain;
 
+/* a page seen while seeking, the time is the end time of the page in the
+ * chain */
+typedef struct
+{
+  gint64 offset;
+  GstClockTime time;
+  guint32 serialno;
+} GstOggSeekEntry;
+
 /* all information needed for one ogg chain (relevant for chained bitstreams) */
 struct _GstOggChain
 {
@@ -73,6 +82,9 @@ struct _GstOggChain
                                    the start times of all streams. */
   GstClockTime segment_stop;    /* the timestamp of the last page, this is the MAX of the
                                    streams. */
+
+  GArray *seek_index;           /* GstOggSeekEntry sorted on offset, used to narrow
+                                   the bisection of later seeks */
 };
 
 /* all information needed for one ogg stream */
@@ -111,6 +123,12 @@ struct _GstOggPad
   /* push mode seeking */
   GstClockTime push_kf_time;
   GstClockTime push_sync_time;
+
+  /* where the body of the current page is in the stream buffer and in the
+   * input buffer of the demuxer, NULL when it's not in the input buffer */
+  const guchar *page_body;
+  gsize page_body_size;
+  gsize page_offset;
 };
 
 struct _GstOggPadClass
@@ -203,6 +221,12 @@ struct _GstOggDemux
   ogg_sync_state sync;
   long chunk_size;
 
+  /* the buffer we are parsing in push mode and where its data was
+   * copied in the sync buffer */
+  GstBuffer *input_buffer;
+  const guchar *input_data;
+  gsize input_size;
+
   /* Seek events set up by the streaming thread in push mode */
   GstEvent *seek_event;
   GThread *seek_event_thread;
@@ -558,7 +558,7 @@ gst_ogg_mux_buffer_from_page (GstOggMux * mux, ogg_page * page, gboolean delta)
 
   /* Here we set granulepos as our OFFSET_END to give easy direct access to
    * this value later. Before we push it, we reset this to OFFSET + SIZE
-   * (see gst_ogg_mux_push_buffer). */
+   * (see gst_ogg_mux_prepare_buffer). */
   GST_BUFFER_OFFSET_END (buffer) = ogg_page_granulepos (page);
   if (delta)
     GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
@@ -570,9 +570,8 @@ gst_ogg_mux_buffer_from_page (GstOggMux * mux, ogg_page * page, gboolean delta)
   return buffer;
 }
 
-static GstFlowReturn
-gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
-    GstOggPadData * oggpad)
+static void
+gst_ogg_mux_prepare_buffer (GstOggMux * mux, GstBuffer * buffer)
 {
   /* fix up OFFSET and OFFSET_END again */
   GST_BUFFER_OFFSET (buffer) = mux->offset;
@@ -588,16 +587,29 @@ gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
       mux->last_ts = run_time;
   }
 
-  GST_LOG_OBJECT (mux->srcpad, "pushing %p, last_ts=%" GST_TIME_FORMAT,
+  GST_LOG_OBJECT (mux->srcpad, "queueing %p, last_ts=%" GST_TIME_FORMAT,
       buffer, GST_TIME_ARGS (mux->last_ts));
+}
+
+/* push the pages collected in @list in one go */
+static GstFlowReturn
+gst_ogg_mux_push_list (GstOggMux * mux, GstBufferList * list)
+{
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    return GST_FLOW_OK;
+  }
+
+  GST_LOG_OBJECT (mux->srcpad, "pushing %u pages",
+      gst_buffer_list_length (list));
 
-  return gst_pad_push (mux->srcpad, buffer);
+  return gst_pad_push_list (mux->srcpad, list);
 }
 
 /* if all queues have at least one page, dequeue the page with the lowest
- * timestamp */
+ * timestamp and add it to @list */
 static gboolean
-gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
+gst_ogg_mux_dequeue_page (GstOggMux * mux, GstBufferList * list)
 {
   GSList *walk;
   GstOggPadData *opad = NULL;   /* "oldest" pad */
@@ -605,8 +617,6 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
   GstBuffer *buf = NULL;
   gboolean ret = FALSE;
 
-  *flowret = GST_FLOW_OK;
-
   walk = mux->collect->data;
   while (walk) {
     GstOggPadData *pad = (GstOggPadData *) walk->data;
@@ -658,7 +668,8 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
     while (buf && GST_BUFFER_OFFSET_END (buf) == -1) {
       GST_LOG_OBJECT (pad->collect.pad, "[gp        -1] pushing page");
       g_queue_pop_head (pad->pagebuffers);
-      *flowret = gst_ogg_mux_push_buffer (mux, buf, pad);
+      gst_ogg_mux_prepare_buffer (mux, buf);
+      gst_buffer_list_add (list, buf);
       buf = g_queue_peek_head (pad->pagebuffers);
       ret = TRUE;
     }
@@ -692,7 +703,8 @@ gst_ogg_mux_dequeue_page (GstOggMux * mux, GstFlowReturn * flowret)
         GST_GP_FORMAT " pushing oldest page buffer %p (granulepos time %"
         GST_TIME_FORMAT ")", GST_BUFFER_OFFSET_END (buf), buf,
         GST_TIME_ARGS (GST_BUFFER_OFFSET (buf)));
-    *flowret = gst_ogg_mux_push_buffer (mux, buf, opad);
+    gst_ogg_mux_prepare_buffer (mux, buf);
+    gst_buffer_list_add (list, buf);
     ret = TRUE;
   }
 
@@ -716,7 +728,7 @@ static GstFlowReturn
 gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
     ogg_page * page, gboolean delta)
 {
-  GstFlowReturn ret;
+  GstBufferList *list;
   GstBuffer *buffer = gst_ogg_mux_buffer_from_page (mux, page, delta);
 
   /* take the timestamp of the first packet on this page */
@@ -737,12 +749,11 @@ gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)),
       g_queue_get_length (pad->pagebuffers));
 
-  while (gst_ogg_mux_dequeue_page (mux, &ret)) {
-    if (ret != GST_FLOW_OK)
-      break;
-  }
+  /* everything that can go out now is pushed downstream together */
+  list = gst_buffer_list_new ();
+  while (gst_ogg_mux_dequeue_page (mux, list));
 
-  return ret;
+  return gst_ogg_mux_push_list (mux, list);
 }
 
 /*
@@ -1401,13 +1412,12 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
 {
   GSList *walk;
   GList *hbufs, *hwalk;
+  GstBufferList *list;
   GstCaps *caps;
-  GstFlowReturn ret;
   ogg_page page;
   ogg_stream_state skeleton_stream;
 
   hbufs = NULL;
-  ret = GST_FLOW_OK;
 
   GST_LOG_OBJECT (mux, "collecting headers");
 
@@ -1626,19 +1636,17 @@ gst_ogg_mux_send_headers (GstOggMux * mux)
   }
 
   /* and send the buffers */
+  list = gst_buffer_list_new_sized (g_list_length (hbufs));
   while (hbufs != NULL) {
     GstBuffer *buf = GST_BUFFER (hbufs->data);
 
     hbufs = g_list_delete_link (hbufs, hbufs);
 
-    if ((ret = gst_ogg_mux_push_buffer (mux, buf, NULL)) != GST_FLOW_OK)
-      break;
+    gst_ogg_mux_prepare_buffer (mux, buf);
+    gst_buffer_list_add (list, buf);
   }
-  /* free any remaining nodes/buffers in case we couldn't push them */
-  g_list_foreach (hbufs, (GFunc) gst_mini_object_unref, NULL);
-  g_list_free (hbufs);
 
-  return ret;
+  return gst_ogg_mux_push_list (mux, list);
 }
 
 /* this function is called to process data on the best pending pad.
@@ -165,6 +165,7 @@ gst_opus_dec_reset (GstOpusDec * dec)
   dec->r128_gain = 0;
   dec->sample_rate = 0;
   dec->n_channels = 0;
+  dec->downmix_channels = 0;
   dec->leftover_plc_duration = 0;
 }
 
@@ -225,6 +226,72 @@ gst_opus_dec_get_r128_volume (gint16 r128_gain)
   return DB_TO_LINEAR (gst_opus_dec_get_r128_gain (r128_gain));
 }
 
+static const GstAudioChannelPosition gst_opus_dec_stereo_pos[2] = {
+  GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT, GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT
+};
+
+/* the stereo downmix of the channel mapping family 1 layouts with the
+ * weights of RFC 7845 section 5.1.1.5, normalized so that the output can't
+ * clip. The columns are the output channels after reordering. */
+static void
+gst_opus_dec_setup_downmix (GstOpusDec * dec)
+{
+  gint i, c;
+  gfloat sum[2] = { 0.0, 0.0 };
+
+  dec->downmix_channels = 0;
+
+  if (dec->channel_mapping_family != 1 || dec->n_channels <= 2
+      || dec->n_channels > 8)
+    return;
+
+  for (i = 0; i < dec->n_channels; i++) {
+    gfloat l, r;
+
+    switch (dec->info.position[i]) {
+      case GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT:
+        l = 1.0;
+        r = 0.0;
+        break;
+      case GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT:
+        l = 0.0;
+        r = 1.0;
+        break;
+      case GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER:
+      case GST_AUDIO_CHANNEL_POSITION_LFE1:
+        l = r = G_SQRT2 / 2.0;
+        break;
+      case GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT:
+      case GST_AUDIO_CHANNEL_POSITION_REAR_LEFT:
+        l = sqrt (3.0) / 2.0;
+        r = 0.5;
+        break;
+      case GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT:
+      case GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT:
+        l = 0.5;
+        r = sqrt (3.0) / 2.0;
+        break;
+      case GST_AUDIO_CHANNEL_POSITION_REAR_CENTER:
+        l = r = sqrt (3.0) / 2.0 * G_SQRT2 / 2.0;
+        break;
+      default:
+        GST_DEBUG_OBJECT (dec, "no downmix for position %d",
+            dec->info.position[i]);
+        return;
+    }
+    dec->downmix[0][i] = l;
+    dec->downmix[1][i] = r;
+    sum[0] += l;
+    sum[1] += r;
+  }
+
+  for (c = 0; c < 2; c++)
+    for (i = 0; i < dec->n_channels; i++)
+      dec->downmix[c][i] /= sum[c];
+
+  dec->downmix_channels = dec->n_channels;
+}
+
 static gboolean
 gst_opus_dec_negotiate (GstOpusDec * dec, const GstAudioChannelPosition * pos)
 {
@@ -320,6 +387,8 @@ gst_opus_dec_negotiate (GstOpusDec * dec, const GstAudioChannelPosition * pos)
 
   dec->info = info;
 
+  gst_opus_dec_setup_downmix (dec);
+
   return TRUE;
 }
 
@@ -529,9 +598,14 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
         GST_TIME_ARGS (aligned_missing_duration), samples,
         GST_TIME_ARGS (dec->leftover_plc_duration));
   } else {
-    /* use maximum size (120 ms) as the number of returned samples is
-       not constant over the stream. */
-    samples = 120 * dec->sample_rate / 1000;
+    /* the TOC of the (first stream of the) packet tells how many samples it
+     * decodes to, all streams have the same duration */
+    samples = opus_packet_get_nb_samples (data, size, dec->sample_rate);
+    if (samples <= 0 || samples > 120 * dec->sample_rate / 1000) {
+      /* use maximum size (120 ms) as the number of returned samples is
+         not constant over the stream. */
+      samples = 120 * dec->sample_rate / 1000;
+    }
   }
 
   packet_size = samples * dec->n_channels * 2;
@@ -620,6 +694,14 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
         dec->n_channels, dec->opus_pos, dec->info.position);
   }
 
+  /* downstream can mix to stereo the way the codec intends */
+  if (outbuf && dec->downmix_channels == dec->n_channels) {
+    const gfloat *matrix[2] = { dec->downmix[0], dec->downmix[1] };
+
+    gst_buffer_add_audio_downmix_meta (outbuf, dec->info.position,
+        dec->n_channels, gst_opus_dec_stereo_pos, 2, matrix);
+  }
+
   /* Apply gain */
   /* Would be better off leaving this to a volume element, as this is
      a naive conversion that does too many int/float conversions.
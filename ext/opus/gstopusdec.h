@@ -60,6 +60,11 @@ struct _GstOpusDec {
   GstAudioChannelPosition opus_pos[64];
   GstAudioInfo info;
 
+  /* the stereo downmix of the output channels for the GstAudioDownmixMeta,
+   * downmix_channels is 0 without one */
+  gint downmix_channels;
+  gfloat downmix[2][8];
+
   guint8 n_streams;
   guint8 n_stereo_streams;
   guint8 channel_mapping_family;
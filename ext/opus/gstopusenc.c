@@ -402,6 +402,9 @@ gst_opus_enc_stop (GstAudioEncoder * benc)
     opus_multistream_encoder_destroy (enc->state);
     enc->state = NULL;
   }
+  g_free (enc->packet);
+  enc->packet = NULL;
+  enc->packet_size = 0;
   gst_tag_setter_reset_tags (GST_TAG_SETTER (enc));
 
   return TRUE;
@@ -1018,30 +1021,21 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
 
   g_assert (size == bytes);
 
-  outbuf =
-      gst_audio_encoder_allocate_output_buffer (GST_AUDIO_ENCODER (enc),
-      max_payload_size * enc->n_channels);
-  if (!outbuf)
-    goto done;
+  /* encode into a scratch buffer and only allocate what the packet needs.
+   * With many channels the worst case size is large and allocating it for
+   * every frame is more expensive than copying the packet. */
+  if (enc->packet_size < max_payload_size * enc->n_channels) {
+    g_free (enc->packet);
+    enc->packet_size = max_payload_size * enc->n_channels;
+    enc->packet = g_malloc (enc->packet_size);
+  }
 
   GST_DEBUG_OBJECT (enc, "encoding %d samples (%d bytes)",
       frame_samples, (int) bytes);
 
-  if (trim_start || trim_end) {
-    GST_DEBUG_OBJECT (enc,
-        "Adding trim-start %" G_GUINT64_FORMAT " trim-end %" G_GUINT64_FORMAT,
-        trim_start, trim_end);
-    gst_buffer_add_audio_clipping_meta (outbuf, GST_FORMAT_DEFAULT, trim_start,
-        trim_end);
-  }
-
-  gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
-
   outsize =
       opus_multistream_encode (enc->state, (const gint16 *) data,
-      frame_samples, omap.data, max_payload_size * enc->n_channels);
-
-  gst_buffer_unmap (outbuf, &omap);
+      frame_samples, enc->packet, max_payload_size * enc->n_channels);
 
   if (outsize < 0) {
     GST_ERROR_OBJECT (enc, "Encoding failed: %d", outsize);
@@ -1056,7 +1050,24 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
   }
 
   GST_DEBUG_OBJECT (enc, "Output packet is %u bytes", outsize);
-  gst_buffer_set_size (outbuf, outsize);
+
+  outbuf =
+      gst_audio_encoder_allocate_output_buffer (GST_AUDIO_ENCODER (enc),
+      outsize);
+  if (!outbuf)
+    goto done;
+
+  gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
+  memcpy (omap.data, enc->packet, outsize);
+  gst_buffer_unmap (outbuf, &omap);
+
+  if (trim_start || trim_end) {
+    GST_DEBUG_OBJECT (enc,
+        "Adding trim-start %" G_GUINT64_FORMAT " trim-end %" G_GUINT64_FORMAT,
+        trim_start, trim_end);
+    gst_buffer_add_audio_clipping_meta (outbuf, GST_FORMAT_DEFAULT, trim_start,
+        trim_end);
+  }
 
 
   ret =
@@ -86,6 +86,9 @@ struct _GstOpusEnc {
   guint8                encoding_channel_mapping[256];
   guint8                decoding_channel_mapping[256];
   guint8                n_stereo_streams;
+
+  guint8               *packet;         /* scratch buffer for encoding */
+  gsize                 packet_size;
 };
 
 struct _GstOpusEncClass {
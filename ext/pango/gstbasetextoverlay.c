@@ -72,10 +72,35 @@ GST_DEBUG_CATEGORY (pango_debug);
 #define DEFAULT_PROP_TEXT_Y 0
 #define DEFAULT_PROP_TEXT_WIDTH 1
 #define DEFAULT_PROP_TEXT_HEIGHT 1
+#define DEFAULT_PROP_RENDER_SCALE 1.0
+#define DEFAULT_PROP_PRERENDER  FALSE
 
 #define MINIMUM_OUTLINE_OFFSET 1.0
 #define DEFAULT_SCALE_BASIS    640
 
+/* number of rendered texts to keep around, subtitles tend to repeat and
+ * come back after seeking */
+#define RENDER_CACHE_SIZE      8
+
+/* a rendered text and everything needed to place it again */
+typedef struct
+{
+  gchar *text;
+  gint width, height;
+  gdouble render_scale;
+
+  GstBuffer *text_image;
+  guint text_width, text_height;
+  PangoRectangle ink_rect, logical_rect;
+} GstBaseTextOverlayCacheEntry;
+
+/* extents of a cluster of the layout, in pango units */
+typedef struct
+{
+  gint index;
+  PangoRectangle ink_rect, logical_rect;
+} GstBaseTextOverlayCluster;
+
 enum
 {
   PROP_0,
@@ -107,6 +132,8 @@ enum
   PROP_TEXT_Y,
   PROP_TEXT_WIDTH,
   PROP_TEXT_HEIGHT,
+  PROP_RENDER_SCALE,
+  PROP_PRERENDER,
   PROP_LAST
 };
 
@@ -444,6 +471,35 @@ gst_base_text_overlay_class_init (GstBaseTextOverlayClass * klass)
           "Resulting height of font rendering", 0,
           G_MAXINT, DEFAULT_PROP_TEXT_HEIGHT, G_PARAM_READABLE));
 
+  /**
+   * GstBaseTextOverlay:render-scale:
+   *
+   * Resolution of the text image relative to the video or window size. With
+   * a smaller value the text is rendered in a smaller image that is scaled
+   * up when it is blended or by the sink.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_RENDER_SCALE,
+      g_param_spec_double ("render-scale", "Render scale",
+          "Resolution of the rendered text relative to the output size",
+          0.1, 1.0, DEFAULT_PROP_RENDER_SCALE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBaseTextOverlay:prerender:
+   *
+   * Render the text as soon as it arrives on the text pad, in the streaming
+   * thread of the text pad, so that the video streaming thread does not
+   * block on the text layout.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_PRERENDER,
+      g_param_spec_boolean ("prerender", "Prerender",
+          "Render new text in the streaming thread of the text pad",
+          DEFAULT_PROP_PRERENDER, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstBaseTextOverlay:xpos:
    *
@@ -602,6 +658,39 @@ gst_base_text_overlay_class_init (GstBaseTextOverlayClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
+static void
+gst_base_text_overlay_cache_entry_free (GstBaseTextOverlayCacheEntry * entry)
+{
+  g_free (entry->text);
+  gst_buffer_unref (entry->text_image);
+  g_slice_free (GstBaseTextOverlayCacheEntry, entry);
+}
+
+/* must be called with the pango lock when anything that changes the look of
+ * the text changes. The lock protects the cache because the internal text
+ * is rendered without the overlay lock */
+static void
+gst_base_text_overlay_clear_partial (GstBaseTextOverlay * overlay)
+{
+  g_free (overlay->partial_text);
+  overlay->partial_text = NULL;
+  if (overlay->partial_clusters) {
+    g_array_unref (overlay->partial_clusters);
+    overlay->partial_clusters = NULL;
+  }
+}
+
+static void
+gst_base_text_overlay_clear_render_cache (GstBaseTextOverlay * overlay)
+{
+  GstBaseTextOverlayCacheEntry *entry;
+
+  while ((entry = g_queue_pop_head (&overlay->render_cache)))
+    gst_base_text_overlay_cache_entry_free (entry);
+
+  gst_base_text_overlay_clear_partial (overlay);
+}
+
 static void
 gst_base_text_overlay_finalize (GObject * object)
 {
@@ -609,6 +698,8 @@ gst_base_text_overlay_finalize (GObject * object)
 
   g_free (overlay->default_text);
 
+  gst_base_text_overlay_clear_render_cache (overlay);
+
   if (overlay->composition) {
     gst_video_overlay_composition_unref (overlay->composition);
     overlay->composition = NULL;
@@ -716,6 +807,9 @@ gst_base_text_overlay_init (GstBaseTextOverlay * overlay,
   overlay->default_text = g_strdup (DEFAULT_PROP_TEXT);
   overlay->need_render = TRUE;
   overlay->text_image = NULL;
+  g_queue_init (&overlay->render_cache);
+  overlay->partial_text = NULL;
+  overlay->partial_clusters = NULL;
   overlay->use_vertical_render = DEFAULT_PROP_VERTICAL_RENDER;
 
   overlay->line_align = DEFAULT_PROP_LINE_ALIGNMENT;
@@ -736,6 +830,8 @@ gst_base_text_overlay_init (GstBaseTextOverlay * overlay,
 
   overlay->text_width = DEFAULT_PROP_TEXT_WIDTH;
   overlay->text_height = DEFAULT_PROP_TEXT_HEIGHT;
+  overlay->render_scale_factor = DEFAULT_PROP_RENDER_SCALE;
+  overlay->prerender = DEFAULT_PROP_PRERENDER;
 
   overlay->text_x = DEFAULT_PROP_TEXT_X;
   overlay->text_y = DEFAULT_PROP_TEXT_Y;
@@ -1098,11 +1194,24 @@ gst_base_text_overlay_set_property (GObject * object, guint prop_id,
     case PROP_SHADING_VALUE:
       overlay->shading_value = g_value_get_uint (value);
       break;
+    case PROP_RENDER_SCALE:
+      overlay->render_scale_factor = g_value_get_double (value);
+      break;
+    case PROP_PRERENDER:
+      overlay->prerender = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 
+  /* a new text renders differently, all other properties change the look */
+  if (prop_id != PROP_TEXT) {
+    g_mutex_lock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+    gst_base_text_overlay_clear_render_cache (overlay);
+    g_mutex_unlock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+  }
+
   overlay->need_render = TRUE;
   GST_BASE_TEXT_OVERLAY_UNLOCK (overlay);
 }
@@ -1210,6 +1319,12 @@ gst_base_text_overlay_get_property (GObject * object, guint prop_id,
     case PROP_TEXT_HEIGHT:
       g_value_set_uint (value, overlay->text_height);
       break;
+    case PROP_RENDER_SCALE:
+      g_value_set_double (value, overlay->render_scale_factor);
+      break;
+    case PROP_PRERENDER:
+      g_value_set_boolean (value, overlay->prerender);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1616,10 +1731,7 @@ gst_base_text_overlay_set_composition (GstBaseTextOverlay * overlay)
         overlay->text_width, overlay->text_height, render_width,
         render_height, xpos, ypos);
 
-    gst_buffer_add_video_meta (overlay->text_image, GST_VIDEO_FRAME_FLAG_NONE,
-        GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB,
-        overlay->text_width, overlay->text_height);
-
+    /* the images got their video meta when they were rendered */
     rectangle = gst_video_overlay_rectangle_new_raw (overlay->text_image,
         xpos, ypos, render_width, render_height,
         GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
@@ -1651,6 +1763,69 @@ gst_base_text_overlay_set_composition (GstBaseTextOverlay * overlay)
   }
 }
 
+/* must be called with the pango lock */
+static GstBaseTextOverlayCacheEntry *
+gst_base_text_overlay_cache_find (GstBaseTextOverlay * overlay,
+    const gchar * string)
+{
+  GList *l;
+
+  for (l = overlay->render_cache.head; l; l = l->next) {
+    GstBaseTextOverlayCacheEntry *entry = l->data;
+
+    if (entry->width == overlay->width && entry->height == overlay->height
+        && entry->render_scale == overlay->render_scale
+        && strcmp (entry->text, string) == 0) {
+      /* move to the front, the last entry is the one to be evicted */
+      g_queue_unlink (&overlay->render_cache, l);
+      g_queue_push_head_link (&overlay->render_cache, l);
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/* must be called with the pango lock, takes ownership of @entry */
+static void
+gst_base_text_overlay_cache_insert (GstBaseTextOverlay * overlay,
+    GstBaseTextOverlayCacheEntry * entry)
+{
+  if (g_queue_get_length (&overlay->render_cache) >= RENDER_CACHE_SIZE)
+    gst_base_text_overlay_cache_entry_free (g_queue_pop_tail
+        (&overlay->render_cache));
+
+  g_queue_push_head (&overlay->render_cache, entry);
+}
+
+/* must be called with the pango lock */
+static void
+gst_base_text_overlay_apply_entry (GstBaseTextOverlay * overlay,
+    GstBaseTextOverlayCacheEntry * entry)
+{
+  gst_buffer_replace (&overlay->text_image, entry->text_image);
+  overlay->text_width = entry->text_width;
+  overlay->text_height = entry->text_height;
+  overlay->ink_rect = entry->ink_rect;
+  overlay->logical_rect = entry->logical_rect;
+}
+
+static gboolean
+gst_base_text_overlay_cache_lookup (GstBaseTextOverlay * overlay,
+    const gchar * string)
+{
+  GstBaseTextOverlayCacheEntry *entry;
+
+  g_mutex_lock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+  if ((entry = gst_base_text_overlay_cache_find (overlay, string))) {
+    gst_base_text_overlay_apply_entry (overlay, entry);
+    /* the partial rendering state is for the previous image */
+    gst_base_text_overlay_clear_partial (overlay);
+  }
+  g_mutex_unlock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+
+  return entry != NULL;
+}
+
 static gboolean
 gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
 {
@@ -1661,13 +1836,125 @@ gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
   }
 }
 
-static void
-gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
-    const gchar * string, gint textlen)
+static GArray *
+gst_base_text_overlay_get_clusters (PangoLayout * layout)
 {
+  GArray *clusters;
+  PangoLayoutIter *iter;
+  GstBaseTextOverlayCluster cluster;
+
+  clusters = g_array_new (FALSE, FALSE, sizeof (GstBaseTextOverlayCluster));
+  iter = pango_layout_get_iter (layout);
+  do {
+    cluster.index = pango_layout_iter_get_index (iter);
+    pango_layout_iter_get_cluster_extents (iter, &cluster.ink_rect,
+        &cluster.logical_rect);
+    g_array_append_val (clusters, cluster);
+  } while (pango_layout_iter_next_cluster (iter));
+  pango_layout_iter_free (iter);
+
+  return clusters;
+}
+
+static inline void
+gst_base_text_overlay_union_x (const PangoRectangle * rect, gint * x0,
+    gint * x1)
+{
+  if (rect->width <= 0)
+    return;
+  *x0 = MIN (*x0, rect->x);
+  *x1 = MAX (*x1, rect->x + rect->width);
+}
+
+/* Check if the text in @clusters can be drawn over the previous image by
+ * only rendering the clusters that changed, all the other glyphs must stay
+ * at the same place. Returns the part of the image to render again in
+ * @clip. Must be called with the pango lock */
+static gboolean
+gst_base_text_overlay_get_partial_clip (GstBaseTextOverlay * overlay,
+    const gchar * string, GArray * clusters, const PangoRectangle * ink_rect,
+    const PangoRectangle * logical_rect, gint width, gint height,
+    gdouble scalef, const cairo_matrix_t * matrix, cairo_rectangle_int_t * clip)
+{
+  GstBaseTextOverlayCluster *c, *p;
+  gint textlen = strlen (string);
+  gint x0 = G_MAXINT, x1 = G_MININT;
+  gdouble margin, dx0, dx1, dy = 0.0;
+  guint i;
+
+  if (!overlay->partial_text || !overlay->text_image)
+    return FALSE;
+
+  if ((gint) strlen (overlay->partial_text) != textlen ||
+      overlay->partial_clusters->len != clusters->len ||
+      overlay->partial_width != width || overlay->partial_height != height ||
+      overlay->partial_scale != scalef ||
+      memcmp (&overlay->partial_ink_rect, ink_rect, sizeof (*ink_rect)) ||
+      memcmp (&overlay->partial_logical_rect, logical_rect,
+          sizeof (*logical_rect)))
+    return FALSE;
+
+  for (i = 0; i < clusters->len; i++) {
+    gint end;
+
+    c = &g_array_index (clusters, GstBaseTextOverlayCluster, i);
+    p = &g_array_index (overlay->partial_clusters, GstBaseTextOverlayCluster,
+        i);
+
+    if (c->index != p->index ||
+        memcmp (&c->logical_rect, &p->logical_rect, sizeof (PangoRectangle)))
+      return FALSE;
+
+    end = textlen;
+    if (i + 1 < clusters->len) {
+      end = g_array_index (clusters, GstBaseTextOverlayCluster, i + 1).index;
+      /* only left to right, logical order must be visual order */
+      if (end <= c->index)
+        return FALSE;
+    }
+
+    if (memcmp (string + c->index, overlay->partial_text + c->index,
+            end - c->index)) {
+      /* both the old and the new glyph */
+      gst_base_text_overlay_union_x (&c->ink_rect, &x0, &x1);
+      gst_base_text_overlay_union_x (&p->ink_rect, &x0, &x1);
+    }
+  }
+
+  if (x0 >= x1)
+    return FALSE;
+
+  /* the outline is drawn around the glyphs and the shadow is translated */
+  margin = ceil (overlay->outline_offset / 2.0) + 1;
+  dx0 = PANGO_PIXELS_FLOOR (x0) - margin;
+  dx1 = PANGO_PIXELS_CEIL (x1) + margin;
+  if (overlay->draw_shadow)
+    dx1 += ceil (overlay->shadow_offset);
+
+  cairo_matrix_transform_point (matrix, &dx0, &dy);
+  cairo_matrix_transform_point (matrix, &dx1, &dy);
+
+  clip->x = CLAMP ((gint) floor (dx0) - 1, 0, width);
+  clip->width = CLAMP ((gint) ceil (dx1) + 1, 0, width) - clip->x;
+  clip->y = 0;
+  clip->height = height;
+
+  return clip->width > 0;
+}
+
+/* Render @string into a new cache entry, returns NULL when there is nothing
+ * to render. @partial enables the partial rendering over text_image, the
+ * caller must then make the entry the current image. Must be called with
+ * the pango lock */
+static GstBaseTextOverlayCacheEntry *
+gst_base_text_overlay_render_entry (GstBaseTextOverlay * overlay,
+    const gchar * string, gint textlen, gboolean partial_ok)
+{
+  GstBaseTextOverlayCacheEntry *entry;
   cairo_t *cr;
   cairo_surface_t *surface;
   PangoRectangle ink_rect, logical_rect;
+  PangoRectangle text_ink_rect, text_logical_rect;
   cairo_matrix_t cairo_matrix;
   gint unscaled_width, unscaled_height;
   gint width, height;
@@ -1679,8 +1966,10 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   gint xpad = 0, ypad = 0;
   GstBuffer *buffer;
   GstMapInfo map;
-
-  g_mutex_lock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+  GArray *clusters = NULL;
+  gdouble render_scale;
+  cairo_rectangle_int_t clip;
+  gboolean partial = FALSE;
 
   if (overlay->auto_adjust_size) {
     /* 640 pixel is default */
@@ -1760,58 +2049,58 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
 
 
   /* Save and scale the rectangles so get_pos() can place the text */
-  overlay->ink_rect.x =
+  text_ink_rect.x =
       ceil ((ink_rect.x - ceil (outline_offset / 2.0l)) * scalef);
-  overlay->ink_rect.y =
+  text_ink_rect.y =
       ceil ((ink_rect.y - ceil (outline_offset / 2.0l)) * scalef);
-  overlay->ink_rect.width = width;
-  overlay->ink_rect.height = height;
+  text_ink_rect.width = width;
+  text_ink_rect.height = height;
 
-  overlay->logical_rect.x =
+  text_logical_rect.x =
       ceil ((logical_rect.x - ceil (outline_offset / 2.0l)) * scalef);
-  overlay->logical_rect.y =
+  text_logical_rect.y =
       ceil ((logical_rect.y - ceil (outline_offset / 2.0l)) * scalef);
-  overlay->logical_rect.width =
+  text_logical_rect.width =
       ceil ((logical_rect.width + shadow_offset + outline_offset) * scalef);
-  overlay->logical_rect.height =
+  text_logical_rect.height =
       ceil ((logical_rect.height + shadow_offset + outline_offset) * scalef);
 
   /* flip the rectangle if doing vertical render */
   if (overlay->use_vertical_render) {
-    PangoRectangle tmp = overlay->ink_rect;
+    PangoRectangle tmp = text_ink_rect;
 
-    overlay->ink_rect.x = tmp.y;
-    overlay->ink_rect.y = tmp.x;
-    overlay->ink_rect.width = tmp.height;
-    overlay->ink_rect.height = tmp.width;
+    text_ink_rect.x = tmp.y;
+    text_ink_rect.y = tmp.x;
+    text_ink_rect.width = tmp.height;
+    text_ink_rect.height = tmp.width;
     /* We want the top left corect, but we now have the top right */
-    overlay->ink_rect.x += overlay->ink_rect.width;
+    text_ink_rect.x += text_ink_rect.width;
 
-    tmp = overlay->logical_rect;
-    overlay->logical_rect.x = tmp.y;
-    overlay->logical_rect.y = tmp.x;
-    overlay->logical_rect.width = tmp.height;
-    overlay->logical_rect.height = tmp.width;
-    overlay->logical_rect.x += overlay->logical_rect.width;
+    tmp = text_logical_rect;
+    text_logical_rect.x = tmp.y;
+    text_logical_rect.y = tmp.x;
+    text_logical_rect.width = tmp.height;
+    text_logical_rect.height = tmp.width;
+    text_logical_rect.x += text_logical_rect.width;
   }
 
-  /* scale to reported window size */
-  width = ceil (width * overlay->render_scale);
-  height = ceil (height * overlay->render_scale);
-  scalef *= overlay->render_scale;
+  /* scale to reported window size and the requested resolution, the
+   * rectangle is scaled back up to the render size when blending */
+  render_scale = overlay->render_scale * overlay->render_scale_factor;
+  width = ceil (width * render_scale);
+  height = ceil (height * render_scale);
+  scalef *= render_scale;
 
   if (width <= 0 || height <= 0) {
-    g_mutex_unlock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
     GST_DEBUG_OBJECT (overlay,
         "Overlay is outside video frame. Skipping text rendering");
-    return;
+    return NULL;
   }
 
   if (unscaled_height <= 0 || unscaled_width <= 0) {
-    g_mutex_unlock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
     GST_DEBUG_OBJECT (overlay,
         "Overlay is outside video frame. Skipping text rendering");
-    return;
+    return NULL;
   }
   /* Prepare the transformation matrix. Note that the transformation happens
    * in reverse order. So for horizontal text, we will translate and then
@@ -1840,16 +2129,41 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
       ceil (outline_offset / 2.0l) - ink_rect.x,
       ceil (outline_offset / 2.0l) - ink_rect.y);
 
-  /* reallocate overlay buffer */
+  /* only plain text on a single line can be rendered partially, like the
+   * changing digits of the time and clock overlays */
+  if (partial_ok && !overlay->use_vertical_render && !full_width &&
+      strpbrk (string, "<&") == NULL &&
+      pango_layout_get_line_count (overlay->layout) == 1) {
+    clusters = gst_base_text_overlay_get_clusters (overlay->layout);
+    partial = gst_base_text_overlay_get_partial_clip (overlay, string,
+        clusters, &ink_rect, &logical_rect, width, height, scalef,
+        &cairo_matrix, &clip);
+  }
+
+  /* allocate a new overlay buffer, the previous image might still be in use.
+   * Add the meta now that the buffer is not shared yet */
   buffer = gst_buffer_new_and_alloc (4 * width * height);
-  gst_buffer_replace (&overlay->text_image, buffer);
-  gst_buffer_unref (buffer);
+  if (partial) {
+    GST_LOG_OBJECT (overlay, "rendering %dx%d at %d of the previous text",
+        clip.width, clip.height, clip.x);
+    gst_buffer_map (overlay->text_image, &map, GST_MAP_READ);
+    gst_buffer_fill (buffer, 0, map.data, map.size);
+    gst_buffer_unmap (overlay->text_image, &map);
+  }
+  gst_buffer_add_video_meta (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width, height);
 
   gst_buffer_map (buffer, &map, GST_MAP_READWRITE);
   surface = cairo_image_surface_create_for_data (map.data,
       CAIRO_FORMAT_ARGB32, width, height, width * 4);
   cr = cairo_create (surface);
 
+  /* everything outside of the clip is the same as before */
+  if (partial) {
+    cairo_rectangle (cr, clip.x, clip.y, clip.width, clip.height);
+    cairo_clip (cr);
+  }
+
   /* clear surface */
   cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
   cairo_paint (cr);
@@ -1926,13 +2240,50 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   cairo_destroy (cr);
   cairo_surface_destroy (surface);
   gst_buffer_unmap (buffer, &map);
-  if (width != 0)
-    overlay->text_width = width;
-  if (height != 0)
-    overlay->text_height = height;
+
+  if (partial_ok) {
+    gst_base_text_overlay_clear_partial (overlay);
+    if (clusters) {
+      overlay->partial_text = g_strdup (string);
+      overlay->partial_clusters = clusters;
+      overlay->partial_ink_rect = ink_rect;
+      overlay->partial_logical_rect = logical_rect;
+      overlay->partial_width = width;
+      overlay->partial_height = height;
+      overlay->partial_scale = scalef;
+    }
+  }
+
+  entry = g_slice_new (GstBaseTextOverlayCacheEntry);
+  entry->text = g_strdup (string);
+  entry->width = overlay->width;
+  entry->height = overlay->height;
+  entry->render_scale = overlay->render_scale;
+  entry->text_image = buffer;
+  entry->text_width = width;
+  entry->text_height = height;
+  entry->ink_rect = text_ink_rect;
+  entry->logical_rect = text_logical_rect;
+
+  return entry;
+}
+
+static void
+gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
+    const gchar * string, gint textlen)
+{
+  GstBaseTextOverlayCacheEntry *entry;
+
+  g_mutex_lock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+  entry = gst_base_text_overlay_render_entry (overlay, string, textlen, TRUE);
+  if (entry) {
+    gst_base_text_overlay_apply_entry (overlay, entry);
+    gst_base_text_overlay_cache_insert (overlay, entry);
+  }
   g_mutex_unlock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
 
-  gst_base_text_overlay_set_composition (overlay);
+  if (entry)
+    gst_base_text_overlay_set_composition (overlay);
 }
 
 static inline void
@@ -2094,17 +2445,11 @@ ARGB_SHADE_FUNCTION (ABGR, 1);
 ARGB_SHADE_FUNCTION (RGBA, 0);
 ARGB_SHADE_FUNCTION (BGRA, 0);
 
-static void
-gst_base_text_overlay_render_text (GstBaseTextOverlay * overlay,
-    const gchar * text, gint textlen)
+static gchar *
+gst_base_text_overlay_get_string (const gchar * text, gint textlen)
 {
   gchar *string;
 
-  if (!overlay->need_render) {
-    GST_DEBUG ("Using previously rendered text.");
-    return;
-  }
-
   /* -1 is the whole string */
   if (text != NULL && textlen < 0) {
     textlen = strlen (text);
@@ -2116,12 +2461,33 @@ gst_base_text_overlay_render_text (GstBaseTextOverlay * overlay,
     string = g_strdup (" ");
   }
   g_strdelimit (string, "\r\t", ' ');
+
+  return string;
+}
+
+static void
+gst_base_text_overlay_render_text (GstBaseTextOverlay * overlay,
+    const gchar * text, gint textlen)
+{
+  gchar *string;
+
+  if (!overlay->need_render) {
+    GST_DEBUG ("Using previously rendered text.");
+    return;
+  }
+
+  string = gst_base_text_overlay_get_string (text, textlen);
   textlen = strlen (string);
 
   /* FIXME: should we check for UTF-8 here? */
 
-  GST_DEBUG ("Rendering '%s'", string);
-  gst_base_text_overlay_render_pangocairo (overlay, string, textlen);
+  if (gst_base_text_overlay_cache_lookup (overlay, string)) {
+    GST_DEBUG ("Using cached rendering of '%s'", string);
+    gst_base_text_overlay_set_composition (overlay);
+  } else {
+    GST_DEBUG ("Rendering '%s'", string);
+    gst_base_text_overlay_render_pangocairo (overlay, string, textlen);
+  }
 
   g_free (string);
 
@@ -2518,12 +2884,95 @@ gst_base_text_overlay_pop_text (GstBaseTextOverlay * overlay)
 /* We receive text buffers here. If they are out of segment we just ignore them.
    If the buffer is in our segment we keep it internally except if another one
    is already waiting here, in that case we wait that it gets kicked out */
+/* Returns the markup for the text in @buffer without the trailing newlines,
+ * or NULL when the buffer is empty */
+static gchar *
+gst_base_text_overlay_get_buffer_text (GstBaseTextOverlay * overlay,
+    GstBuffer * buffer)
+{
+  GstMapInfo map;
+  gchar *in_text, *text = NULL;
+  gsize in_size;
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  in_text = (gchar *) map.data;
+  in_size = map.size;
+
+  if (in_size > 0) {
+    /* g_markup_escape_text() absolutely requires valid UTF8 input, it
+     * might crash otherwise. We don't fall back on GST_SUBTITLE_ENCODING
+     * here on purpose, this is something that needs fixing upstream */
+    if (!g_utf8_validate (in_text, in_size, NULL)) {
+      const gchar *end = NULL;
+
+      GST_WARNING_OBJECT (overlay, "received invalid UTF-8");
+      in_text = g_strndup (in_text, in_size);
+      while (!g_utf8_validate (in_text, in_size, &end) && end)
+        *((gchar *) end) = '*';
+    }
+
+    /* Get the string */
+    if (overlay->have_pango_markup) {
+      text = g_strndup (in_text, in_size);
+    } else {
+      text = g_markup_escape_text (in_text, in_size);
+    }
+
+    if (text != NULL && *text != '\0') {
+      gint text_len = strlen (text);
+
+      while (text_len > 0 && (text[text_len - 1] == '\n' ||
+              text[text_len - 1] == '\r')) {
+        --text_len;
+      }
+      text[text_len] = '\0';
+    } else {
+      g_free (text);
+      text = NULL;
+    }
+    if (in_text != (gchar *) map.data)
+      g_free (in_text);
+  }
+
+  gst_buffer_unmap (buffer, &map);
+
+  return text;
+}
+
+/* Render the text of a new text buffer into the render cache from the text
+ * streaming thread, the video thread then only has to find it in the cache.
+ * Called without the overlay lock so that the video keeps flowing */
+static void
+gst_base_text_overlay_prerender (GstBaseTextOverlay * overlay,
+    GstBuffer * buffer)
+{
+  GstBaseTextOverlayCacheEntry *entry;
+  gchar *text, *string;
+
+  text = gst_base_text_overlay_get_buffer_text (overlay, buffer);
+  string = gst_base_text_overlay_get_string (text ? text : " ", -1);
+  g_free (text);
+
+  g_mutex_lock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+  if (!gst_base_text_overlay_cache_find (overlay, string)) {
+    GST_LOG_OBJECT (overlay, "prerendering '%s'", string);
+    entry = gst_base_text_overlay_render_entry (overlay, string,
+        strlen (string), FALSE);
+    if (entry)
+      gst_base_text_overlay_cache_insert (overlay, entry);
+  }
+  g_mutex_unlock (GST_BASE_TEXT_OVERLAY_GET_CLASS (overlay)->pango_lock);
+
+  g_free (string);
+}
+
 static GstFlowReturn
 gst_base_text_overlay_text_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer)
 {
   GstFlowReturn ret = GST_FLOW_OK;
   GstBaseTextOverlay *overlay = NULL;
+  GstBuffer *prerender = NULL;
   gboolean in_seg = FALSE;
   guint64 clip_start = 0, clip_stop = 0;
 
@@ -2593,12 +3042,21 @@ gst_base_text_overlay_text_chain (GstPad * pad, GstObject * parent,
     /* That's a new text buffer we need to render */
     overlay->need_render = TRUE;
 
+    if (overlay->prerender && !overlay->silent &&
+        GST_VIDEO_INFO_FORMAT (&overlay->info) != GST_VIDEO_FORMAT_UNKNOWN)
+      prerender = gst_buffer_ref (overlay->text_buffer);
+
     /* in case the video chain is waiting for a text buffer, wake it up */
     GST_BASE_TEXT_OVERLAY_BROADCAST (overlay);
   }
 
   GST_BASE_TEXT_OVERLAY_UNLOCK (overlay);
 
+  if (prerender) {
+    gst_base_text_overlay_prerender (overlay, prerender);
+    gst_buffer_unref (prerender);
+  }
+
 beach:
   if (buffer)
     gst_buffer_unref (buffer);
@@ -2788,56 +3246,17 @@ wait_for_text_buf:
         /* Push the video frame */
         ret = gst_pad_push (overlay->srcpad, buffer);
       } else {
-        GstMapInfo map;
-        gchar *in_text;
-        gsize in_size;
-
-        gst_buffer_map (overlay->text_buffer, &map, GST_MAP_READ);
-        in_text = (gchar *) map.data;
-        in_size = map.size;
-
-        if (in_size > 0) {
-          /* g_markup_escape_text() absolutely requires valid UTF8 input, it
-           * might crash otherwise. We don't fall back on GST_SUBTITLE_ENCODING
-           * here on purpose, this is something that needs fixing upstream */
-          if (!g_utf8_validate (in_text, in_size, NULL)) {
-            const gchar *end = NULL;
-
-            GST_WARNING_OBJECT (overlay, "received invalid UTF-8");
-            in_text = g_strndup (in_text, in_size);
-            while (!g_utf8_validate (in_text, in_size, &end) && end)
-              *((gchar *) end) = '*';
-          }
-
-          /* Get the string */
-          if (overlay->have_pango_markup) {
-            text = g_strndup (in_text, in_size);
-          } else {
-            text = g_markup_escape_text (in_text, in_size);
-          }
-
-          if (text != NULL && *text != '\0') {
-            gint text_len = strlen (text);
-
-            while (text_len > 0 && (text[text_len - 1] == '\n' ||
-                    text[text_len - 1] == '\r')) {
-              --text_len;
-            }
-            GST_DEBUG_OBJECT (overlay, "Rendering text '%*s'", text_len, text);
-            gst_base_text_overlay_render_text (overlay, text, text_len);
-          } else {
-            GST_DEBUG_OBJECT (overlay, "No text to render (empty buffer)");
-            gst_base_text_overlay_render_text (overlay, " ", 1);
-          }
-          if (in_text != (gchar *) map.data)
-            g_free (in_text);
+        text = gst_base_text_overlay_get_buffer_text (overlay,
+            overlay->text_buffer);
+
+        if (text != NULL) {
+          GST_DEBUG_OBJECT (overlay, "Rendering text '%s'", text);
+          gst_base_text_overlay_render_text (overlay, text, -1);
         } else {
           GST_DEBUG_OBJECT (overlay, "No text to render (empty buffer)");
           gst_base_text_overlay_render_text (overlay, " ", 1);
         }
 
-        gst_buffer_unmap (overlay->text_buffer, &map);
-
         GST_BASE_TEXT_OVERLAY_UNLOCK (overlay);
         ret = gst_base_text_overlay_push_frame (overlay, buffer);
 
@@ -177,6 +177,17 @@ struct _GstBaseTextOverlay {
     /* rendering state */
     gboolean                 need_render;
     GstBuffer               *text_image;
+    GQueue                   render_cache;   /* most recently used first */
+
+    /* the plain text in text_image and its layout, when only some of the
+     * glyphs change only those are rendered again */
+    gchar                   *partial_text;
+    GArray                  *partial_clusters;
+    PangoRectangle           partial_ink_rect;
+    PangoRectangle           partial_logical_rect;
+    gint                     partial_width;
+    gint                     partial_height;
+    gdouble                  partial_scale;
 
     /* dimension relative to witch the render is done, this is the stream size
      * or a portion of the window_size (adapted to aspect ratio) */
@@ -184,6 +195,10 @@ struct _GstBaseTextOverlay {
     gint                     render_height;
     /* This is (render_width / width) uses to convert to stream scale */
     gdouble                  render_scale;
+    /* resolution of the text image relative to the render size */
+    gdouble                  render_scale_factor;
+    /* render new text in the text streaming thread */
+    gboolean                 prerender;
 
     /* dimension of text_image, the physical dimension */
     guint                    text_width;
@@ -252,6 +252,8 @@ theora_dec_stop (GstVideoDecoder * decoder)
     dec->output_state = NULL;
   }
   dec->can_crop = FALSE;
+  dec->have_dup_frames = FALSE;
+  gst_buffer_replace (&dec->last_output, NULL);
 
   return TRUE;
 }
@@ -262,6 +264,7 @@ theora_dec_flush (GstVideoDecoder * decoder)
   GstTheoraDec *dec = GST_THEORA_DEC (decoder);
 
   dec->need_keyframe = TRUE;
+  gst_buffer_replace (&dec->last_output, NULL);
 
   return TRUE;
 }
@@ -482,6 +485,9 @@ theora_handle_type_packet (GstTheoraDec * dec)
     GST_WARNING_OBJECT (dec, "Could not enable BITS mode visualisation");
   }
 
+  /* the last picture does not match the new output state */
+  gst_buffer_replace (&dec->last_output, NULL);
+
   /* Create the output state */
   dec->output_state = state =
       gst_video_decoder_set_output_state (GST_VIDEO_DECODER (dec), fmt,
@@ -772,6 +778,18 @@ theora_handle_data_packet (GstTheoraDec * dec, ogg_packet * packet,
               frame) < 0))
     goto dropping_qos;
 
+  /* a zero length packet repeats the previous picture, share the memory of
+   * the previous output buffer instead of copying the same picture again */
+  if (packet->bytes == 0 && frame) {
+    dec->have_dup_frames = TRUE;
+    if (dec->last_output) {
+      GST_LOG_OBJECT (dec, "repeating previous picture");
+      frame->output_buffer = gst_buffer_copy (dec->last_output);
+      GST_BUFFER_FLAG_UNSET (frame->output_buffer, GST_BUFFER_FLAG_DISCONT);
+      return GST_FLOW_OK;
+    }
+  }
+
   /* this does postprocessing and set up the decoded frame
    * pointers in our yuv variable */
   if (G_UNLIKELY (th_decode_ycbcr_out (dec->decoder, buf) < 0))
@@ -783,6 +801,11 @@ theora_handle_data_packet (GstTheoraDec * dec, ogg_packet * packet,
 
   result = theora_handle_image (dec, buf, frame);
 
+  /* only keep the picture around for streams that repeat pictures, holding
+   * a ref makes in place writes downstream copy the memory */
+  if (result == GST_FLOW_OK && dec->have_dup_frames)
+    gst_buffer_replace (&dec->last_output, frame->output_buffer);
+
   return result;
 
   /* ERRORS */
@@ -908,6 +931,7 @@ theora_dec_decide_allocation (GstVideoDecoder * decoder, GstQuery * query)
   gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
 
   dec->can_crop = FALSE;
+  gst_buffer_replace (&dec->last_output, NULL);
   config = gst_buffer_pool_get_config (pool);
   if (gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL)) {
     gst_buffer_pool_config_add_option (config,
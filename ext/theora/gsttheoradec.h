@@ -78,6 +78,9 @@ struct _GstTheoraDec
 
   gboolean can_crop;
   GstVideoInfo uncropped_info;
+
+  gboolean have_dup_frames;     /* the stream has zero length packets */
+  GstBuffer *last_output;       /* to repeat for the next zero length packet */
 };
 
 struct _GstTheoraDecClass
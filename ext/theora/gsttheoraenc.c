@@ -556,6 +556,34 @@ theora_enc_getcaps (GstVideoEncoder * encoder, GstCaps * filter)
   return ret;
 }
 
+/* the plane sizes of the frames, these only change with the caps */
+static void
+theora_enc_init_planes (GstTheoraEnc * enc, GstVideoInfo * info)
+{
+  GstVideoInfo vinfo;
+  guint i;
+
+  /* According to Theora developer Timothy Terriberry, the Theora 
+   * encoder will not use memory outside of pic_width/height, even when
+   * the frame size is bigger. The values outside this region will be encoded
+   * to default values.
+   * Due to this, setting the frame's width/height as the buffer width/height
+   * is perfectly ok, even though it does not strictly look ok.
+   */
+
+  gst_video_info_init (&vinfo);
+  gst_video_info_set_format (&vinfo, GST_VIDEO_INFO_FORMAT (info),
+      GST_ROUND_UP_16 (GST_VIDEO_INFO_WIDTH (info)),
+      GST_ROUND_UP_16 (GST_VIDEO_INFO_HEIGHT (info)));
+
+  for (i = 0; i < 3; i++) {
+    enc->planes[i].width = GST_VIDEO_INFO_COMP_WIDTH (&vinfo, i);
+    enc->planes[i].height = GST_VIDEO_INFO_COMP_HEIGHT (&vinfo, i);
+    enc->planes[i].data = NULL;
+    enc->planes[i].stride = 0;
+  }
+}
+
 static gboolean
 theora_enc_set_format (GstVideoEncoder * benc, GstVideoCodecState * state)
 {
@@ -598,6 +626,7 @@ theora_enc_set_format (GstVideoEncoder * benc, GstVideoCodecState * state)
   if (enc->input_state)
     gst_video_codec_state_unref (enc->input_state);
   enc->input_state = gst_video_codec_state_ref (state);
+  theora_enc_init_planes (enc, info);
 
   /* as done in theora */
   enc->info.keyframe_granule_shift = _ilog (enc->keyframe_force - 1);
@@ -698,27 +727,14 @@ theora_set_header_on_caps (GstCaps * caps, GList * buffers)
 }
 
 static void
-theora_enc_init_buffer (th_ycbcr_buffer buf, GstVideoFrame * frame)
+theora_enc_init_buffer (GstTheoraEnc * enc, th_ycbcr_buffer buf,
+    GstVideoFrame * frame)
 {
-  GstVideoInfo vinfo;
   guint i;
 
-  /* According to Theora developer Timothy Terriberry, the Theora 
-   * encoder will not use memory outside of pic_width/height, even when
-   * the frame size is bigger. The values outside this region will be encoded
-   * to default values.
-   * Due to this, setting the frame's width/height as the buffer width/height
-   * is perfectly ok, even though it does not strictly look ok.
-   */
-
-  gst_video_info_init (&vinfo);
-  gst_video_info_set_format (&vinfo, GST_VIDEO_FRAME_FORMAT (frame),
-      GST_ROUND_UP_16 (GST_VIDEO_FRAME_WIDTH (frame)),
-      GST_ROUND_UP_16 (GST_VIDEO_FRAME_HEIGHT (frame)));
-
   for (i = 0; i < 3; i++) {
-    buf[i].width = GST_VIDEO_INFO_COMP_WIDTH (&vinfo, i);
-    buf[i].height = GST_VIDEO_INFO_COMP_HEIGHT (&vinfo, i);
+    buf[i].width = enc->planes[i].width;
+    buf[i].height = enc->planes[i].height;
     buf[i].data = GST_VIDEO_FRAME_COMP_DATA (frame, i);
     buf[i].stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, i);
   }
@@ -988,7 +1004,7 @@ theora_enc_handle_frame (GstVideoEncoder * benc, GstVideoCodecFrame * frame)
 
     gst_video_frame_map (&vframe, &enc->input_state->info, frame->input_buffer,
         GST_MAP_READ);
-    theora_enc_init_buffer (ycbcr, &vframe);
+    theora_enc_init_buffer (enc, ycbcr, &vframe);
 
     res = th_encode_ycbcr_in (enc->encoder, ycbcr);
     gst_video_frame_unmap (&vframe);
@@ -83,6 +83,7 @@ struct _GstTheoraEnc
   gint keyframe_force;
 
   GstVideoCodecState *input_state;
+  th_img_plane planes[3];       /* sizes of the padded planes */
 
   gint width, height;
   gint fps_n, fps_d;
@@ -285,14 +285,16 @@ theora_parse_set_header_on_caps (GstTheoraParse * parse, GstCaps * caps)
 }
 
 /* two tasks to do here: set the streamheader on the caps, and use libtheora to
-   parse the headers */
+   parse the info header. The comment and setup headers are not needed for the
+   granulepos and setting up the tables from the setup header is expensive, so
+   we don't pass those to libtheora */
 static void
 theora_parse_set_streamheader (GstTheoraParse * parse)
 {
   GstCaps *caps;
-  gint i;
   guint32 bitstream_version;
   th_setup_info *setup = NULL;
+  GstBuffer *buf;
 
   g_assert (!parse->streamheader_received);
 
@@ -302,28 +304,23 @@ theora_parse_set_streamheader (GstTheoraParse * parse)
   gst_pad_set_caps (parse->srcpad, caps);
   gst_caps_unref (caps);
 
-  for (i = 0; i < 3; i++) {
+  if ((buf = parse->streamheader[0])) {
     ogg_packet packet;
-    GstBuffer *buf;
     int ret;
     GstMapInfo map;
 
-    buf = parse->streamheader[i];
-    if (buf == NULL)
-      continue;
-
     gst_buffer_map (buf, &map, GST_MAP_READ);
     packet.packet = map.data;
     packet.bytes = map.size;
     packet.granulepos = GST_BUFFER_OFFSET_END (buf);
-    packet.packetno = i + 1;
+    packet.packetno = 1;
     packet.e_o_s = 0;
-    packet.b_o_s = (i == 0);
+    packet.b_o_s = 1;
     ret = th_decode_headerin (&parse->info, &parse->comment, &setup, &packet);
     gst_buffer_unmap (buf, &map);
     if (ret < 0) {
-      GST_WARNING_OBJECT (parse, "Failed to decode Theora header %d: %d\n",
-          i + 1, ret);
+      GST_WARNING_OBJECT (parse, "Failed to decode Theora header 1: %d\n",
+          ret);
     }
   }
   if (setup) {
@@ -0,0 +1,121 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the stereo interleave. They give exactly the same
+ * results as the C loops and return the number of samples done, the caller
+ * does the remainder. */
+
+#ifndef TREMOR
+
+#if defined (__SSE2__)
+#define HAVE_VORBIS_SIMD_S
+#include <emmintrin.h>
+
+static guint
+interleave_s_simd (float *out, float *const *in, guint samples)
+{
+  guint j;
+
+  for (j = 0; j + 4 <= samples; j += 4) {
+    __m128 l = _mm_loadu_ps (in[0] + j);
+    __m128 r = _mm_loadu_ps (in[1] + j);
+
+    _mm_storeu_ps (out, _mm_unpacklo_ps (l, r));
+    _mm_storeu_ps (out + 4, _mm_unpackhi_ps (l, r));
+    out += 8;
+  }
+  return j;
+}
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define HAVE_VORBIS_SIMD_S
+#include <arm_neon.h>
+
+static guint
+interleave_s_simd (float *out, float *const *in, guint samples)
+{
+  guint j;
+
+  for (j = 0; j + 4 <= samples; j += 4) {
+    float32x4x2_t v;
+
+    v.val[0] = vld1q_f32 (in[0] + j);
+    v.val[1] = vld1q_f32 (in[1] + j);
+    vst2q_f32 (out, v);
+    out += 8;
+  }
+  return j;
+}
+#endif
+
+#else /* TREMOR */
+
+/* the saturating shifts and packs do the same as CLIP_TO_15 (x >> 9) */
+#if defined (__SSE2__)
+#define HAVE_VORBIS_SIMD_16_S
+#include <emmintrin.h>
+
+static inline __m128i
+load_16 (const ogg_int32_t * in)
+{
+  __m128i a = _mm_srai_epi32 (_mm_loadu_si128 ((const __m128i *) in), 9);
+  __m128i b = _mm_srai_epi32 (_mm_loadu_si128 ((const __m128i *) (in + 4)),
+      9);
+
+  return _mm_packs_epi32 (a, b);
+}
+
+static guint
+interleave_16_s_simd (gint16 * out, ogg_int32_t * const *in, guint samples)
+{
+  guint j;
+
+  for (j = 0; j + 8 <= samples; j += 8) {
+    __m128i l = load_16 (in[0] + j);
+    __m128i r = load_16 (in[1] + j);
+
+    _mm_storeu_si128 ((__m128i *) out, _mm_unpacklo_epi16 (l, r));
+    _mm_storeu_si128 ((__m128i *) (out + 8), _mm_unpackhi_epi16 (l, r));
+    out += 16;
+  }
+  return j;
+}
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define HAVE_VORBIS_SIMD_16_S
+#include <arm_neon.h>
+
+static guint
+interleave_16_s_simd (gint16 * out, ogg_int32_t * const *in, guint samples)
+{
+  guint j;
+
+  for (j = 0; j + 4 <= samples; j += 4) {
+    int16x4x2_t v;
+
+    v.val[0] = vqshrn_n_s32 (vld1q_s32 (in[0] + j), 9);
+    v.val[1] = vqshrn_n_s32 (vld1q_s32 (in[1] + j), 9);
+    vst2_s16 (out, v);
+    out += 8;
+  }
+  return j;
+}
+#endif
+
+#endif /* TREMOR */
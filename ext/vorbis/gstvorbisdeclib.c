@@ -29,6 +29,7 @@
 #include <string.h>
 #include "gstvorbisdeclib.h"
 #include "gstvorbiscommon.h"
+#include "gstvorbisdeclib-simd.h"
 
 #ifndef TREMOR
 /* These samples can be outside of the float -1.0 -- 1.0 range, this
@@ -49,9 +50,13 @@ copy_samples_s (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
   out += samples;
   memcpy (out, in[1], samples * sizeof (float));
 #else
-  gint j;
+  guint j = 0;
 
-  for (j = 0; j < samples; j++) {
+#ifdef HAVE_VORBIS_SIMD_S
+  j = interleave_s_simd (out, in, samples);
+  out += 2 * j;
+#endif
+  for (; j < samples; j++) {
     *out++ = in[0][j];
     *out++ = in[1][j];
   }
@@ -71,11 +76,16 @@ copy_samples (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
     out += samples;
   }
 #else
+  vorbis_sample_t *planes[8];
   gint i, j;
 
+  /* look up the reordering once instead of for every sample */
+  for (i = 0; i < channels; i++)
+    planes[i] = in[gst_vorbis_reorder_map[channels - 1][i]];
+
   for (j = 0; j < samples; j++) {
     for (i = 0; i < channels; i++) {
-      *out++ = in[gst_vorbis_reorder_map[channels - 1][i]][j];
+      *out++ = planes[i][j];
     }
   }
 #endif
@@ -179,9 +189,13 @@ copy_samples_16_s (vorbis_sample_t * _out, vorbis_sample_t ** _in,
 {
   gint16 *out = (gint16 *) _out;
   ogg_int32_t **in = (ogg_int32_t **) _in;
-  gint j;
+  guint j = 0;
 
-  for (j = 0; j < samples; j++) {
+#ifdef HAVE_VORBIS_SIMD_16_S
+  j = interleave_16_s_simd (out, in, samples);
+  out += 2 * j;
+#endif
+  for (; j < samples; j++) {
     *out++ = CLIP_TO_15 (in[0][j] >> 9);
     *out++ = CLIP_TO_15 (in[1][j] >> 9);
   }
@@ -193,11 +207,17 @@ copy_samples_16 (vorbis_sample_t * _out, vorbis_sample_t ** _in, guint samples,
 {
   gint16 *out = (gint16 *) _out;
   ogg_int32_t **in = (ogg_int32_t **) _in;
+  ogg_int32_t *planes[255];
   gint i, j;
 
+  /* look up the reordering once instead of for every sample, the map only
+   * covers up to 8 channels */
+  for (i = 0; i < channels; i++)
+    planes[i] = in[channels <= 8 ? gst_vorbis_reorder_map[channels - 1][i] : i];
+
   for (j = 0; j < samples; j++) {
     for (i = 0; i < channels; i++) {
-      *out++ = CLIP_TO_15 (in[gst_vorbis_reorder_map[channels - 1][i]][j] >> 9);
+      *out++ = CLIP_TO_15 (planes[i][j] >> 9);
     }
   }
 }
@@ -0,0 +1,64 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the stereo deinterleave. They give exactly the same
+ * results as the C loop and return the number of samples done, the caller
+ * does the remainder. */
+
+#if defined (__SSE2__)
+#define HAVE_VORBIS_ENC_SIMD_S
+#include <emmintrin.h>
+
+static gulong
+deinterleave_s_simd (float **out, const float *in, gulong samples)
+{
+  gulong j;
+
+  for (j = 0; j + 4 <= samples; j += 4) {
+    __m128 a = _mm_loadu_ps (in);
+    __m128 b = _mm_loadu_ps (in + 4);
+
+    _mm_storeu_ps (out[0] + j, _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2,
+                0)));
+    _mm_storeu_ps (out[1] + j, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3,
+                1)));
+    in += 8;
+  }
+  return j;
+}
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define HAVE_VORBIS_ENC_SIMD_S
+#include <arm_neon.h>
+
+static gulong
+deinterleave_s_simd (float **out, const float *in, gulong samples)
+{
+  gulong j;
+
+  for (j = 0; j + 4 <= samples; j += 4) {
+    float32x4x2_t v = vld2q_f32 (in);
+
+    vst1q_f32 (out[0] + j, v.val[0]);
+    vst1q_f32 (out[1] + j, v.val[1]);
+    in += 8;
+  }
+  return j;
+}
+#endif
@@ -52,6 +52,7 @@
 #include "gstvorbisenc.h"
 
 #include "gstvorbiscommon.h"
+#include "gstvorbisenc-simd.h"
 
 GST_DEBUG_CATEGORY_EXTERN (vorbisenc_debug);
 #define GST_CAT_DEFAULT vorbisenc_debug
@@ -725,22 +726,37 @@ gst_vorbis_enc_handle_frame (GstAudioEncoder * enc, GstBuffer * buffer)
   vorbis_buffer = vorbis_analysis_buffer (&vorbisenc->vd, size);
 
   /* deinterleave samples, write the buffer data */
-  if (vorbisenc->channels < 2 || vorbisenc->channels > 8) {
+  if (vorbisenc->channels == 1) {
+    memcpy (vorbis_buffer[0], ptr, size * sizeof (float));
+  } else if (vorbisenc->channels == 2) {
+    /* stereo needs no reordering */
+    i = 0;
+#ifdef HAVE_VORBIS_ENC_SIMD_S
+    i = deinterleave_s_simd (vorbis_buffer, ptr, size);
+    ptr += 2 * i;
+#endif
+    for (; i < size; i++) {
+      vorbis_buffer[0][i] = *ptr++;
+      vorbis_buffer[1][i] = *ptr++;
+    }
+  } else if (vorbisenc->channels > 8) {
     for (i = 0; i < size; i++) {
       for (j = 0; j < vorbisenc->channels; j++) {
         vorbis_buffer[j][i] = *ptr++;
       }
     }
   } else {
-    gint i, j;
+    float *planes[8];
+    gint channels = vorbisenc->channels;
+
+    /* Reorder, look up the plane of each channel only once */
+    for (j = 0; j < channels; j++)
+      planes[j] = vorbis_buffer[gst_vorbis_reorder_map[channels - 1][j]];
 
-    /* Reorder */
     for (i = 0; i < size; i++) {
-      for (j = 0; j < vorbisenc->channels; j++) {
-        vorbis_buffer[gst_vorbis_reorder_map[vorbisenc->channels - 1][j]][i] =
-            ptr[j];
-      }
-      ptr += vorbisenc->channels;
+      for (j = 0; j < channels; j++)
+        planes[j][i] = ptr[j];
+      ptr += channels;
     }
   }
 
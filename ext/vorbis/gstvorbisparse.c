@@ -53,6 +53,8 @@
 
 #include "gstvorbisparse.h"
 
+#include <string.h>
+
 GST_DEBUG_CATEGORY_EXTERN (vorbisparse_debug);
 #define GST_CAT_DEFAULT vorbisparse_debug
 
@@ -176,54 +178,159 @@ vorbis_parse_drain_event_queue (GstVorbisParse * parse)
   }
 }
 
+/* The identification header has everything needed for the caps and, with
+ * the blocksizes, for the granulepos of the audio packets */
+static gboolean
+vorbis_parse_read_id_header (GstVorbisParse * parse, GstBuffer * buf)
+{
+  GstMapInfo map;
+  guint bs0, bs1;
+  gboolean res = FALSE;
+
+  gst_buffer_map (buf, &map, GST_MAP_READ);
+  if (map.size < 30 || memcmp (map.data, "\001vorbis", 7) != 0)
+    goto done;
+
+  bs0 = map.data[28] & 0x0f;
+  bs1 = map.data[28] >> 4;
+  if (bs0 < 6 || bs1 > 13 || bs0 > bs1)
+    goto done;
+
+  parse->channels = map.data[11];
+  parse->sample_rate = GST_READ_UINT32_LE (map.data + 12);
+  parse->blocksize[0] = 1 << bs0;
+  parse->blocksize[1] = 1 << bs1;
+  res = parse->channels > 0 && parse->sample_rate > 0;
+
+done:
+  gst_buffer_unmap (buf, &map);
+  return res;
+}
+
+/* reads n bits going backwards from bit *pos of the LSB first packed data */
+static guint
+vorbis_parse_read_bits_back (const guint8 * data, gint64 * pos, guint n)
+{
+  guint val = 0;
+
+  while (n--) {
+    val = (val << 1) | ((data[*pos >> 3] >> (*pos & 7)) & 1);
+    (*pos)--;
+  }
+  return val;
+}
+
+/* The mode configurations are at the end of the setup header, after the
+ * codebooks, floors, residues and mappings that we would otherwise have to
+ * unpack. Read them backwards from the framing bit instead: every mode is a
+ * blockflag, two 16 bits fields that are 0 and a mapping number below 64,
+ * after the 6 bits mode count. The high bits of a small mapping number
+ * always look like a mode count of 1 so we take the largest count that fits,
+ * and give up when more than one count above 1 fits. */
+static gboolean
+vorbis_parse_read_setup_header (GstVorbisParse * parse, GstBuffer * buf)
+{
+  GstMapInfo map;
+  gint64 pos, modes_pos, min_pos = 7 * 8;
+  guint count = 0, mode_count = 0, n_found = 0;
+  gboolean res = FALSE;
+  gint i;
+
+  gst_buffer_map (buf, &map, GST_MAP_READ);
+  if (map.size < 8 || memcmp (map.data, "\005vorbis", 7) != 0)
+    goto done;
+
+  /* skip the padding up to and including the framing bit */
+  pos = (gint64) map.size * 8 - 1;
+  while (pos >= min_pos) {
+    if (vorbis_parse_read_bits_back (map.data, &pos, 1))
+      break;
+  }
+  modes_pos = pos;
+
+  while (pos - (41 + 6) + 1 >= min_pos && count < 64) {
+    gint64 count_pos;
+
+    if (vorbis_parse_read_bits_back (map.data, &pos, 8) > 63 ||
+        vorbis_parse_read_bits_back (map.data, &pos, 16) ||
+        vorbis_parse_read_bits_back (map.data, &pos, 16))
+      break;
+    vorbis_parse_read_bits_back (map.data, &pos, 1);
+    count++;
+
+    count_pos = pos;
+    if (vorbis_parse_read_bits_back (map.data, &count_pos, 6) + 1 == count) {
+      mode_count = count;
+      if (count > 1)
+        n_found++;
+    }
+  }
+
+  if (mode_count == 0 || n_found > 1) {
+    GST_DEBUG_OBJECT (parse, "no unique mode count in the setup header");
+    goto done;
+  }
+
+  pos = modes_pos;
+  for (i = mode_count - 1; i >= 0; i--) {
+    vorbis_parse_read_bits_back (map.data, &pos, 40);
+    parse->mode_blockflag[i] = vorbis_parse_read_bits_back (map.data, &pos, 1);
+  }
+  parse->mode_count = mode_count;
+  parse->mode_bits = mode_count > 1 ? g_bit_storage (mode_count - 1) : 0;
+  res = TRUE;
+
+done:
+  gst_buffer_unmap (buf, &map);
+  return res;
+}
+
+static void
+vorbis_parse_decode_headers (GstVorbisParse * parse)
+{
+  GList *walk;
+  gint i = 1;
+
+  for (walk = parse->streamheader; walk; walk = walk->next, i++) {
+    GstBuffer *outbuf = GST_BUFFER_CAST (walk->data);
+    ogg_packet packet;
+    GstMapInfo map;
+
+    gst_buffer_map (outbuf, &map, GST_MAP_READ);
+    packet.packet = map.data;
+    packet.bytes = map.size;
+    packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
+    packet.packetno = i;
+    packet.e_o_s = 0;
+    packet.b_o_s = (i == 1);
+    vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
+    gst_buffer_unmap (outbuf, &map);
+  }
+  parse->sample_rate = parse->vi.rate;
+  parse->channels = parse->vi.channels;
+}
+
 static void
 vorbis_parse_push_headers (GstVorbisParse * parse)
 {
   /* mark and put on caps */
   GstCaps *caps;
-  GstBuffer *outbuf, *outbuf1, *outbuf2, *outbuf3;
-  ogg_packet packet;
-  GstMapInfo map;
+  GstBuffer *outbuf1, *outbuf2, *outbuf3;
+
+  outbuf1 = GST_BUFFER_CAST (parse->streamheader->data);
+  outbuf2 = GST_BUFFER_CAST (parse->streamheader->next->data);
+  outbuf3 = GST_BUFFER_CAST (parse->streamheader->next->next->data);
+
+  /* we only need the rate, channels and the blocksize of each mode,
+   * only build the complete codec setup when we can't get those directly */
+  if (!vorbis_parse_read_id_header (parse, outbuf1) ||
+      !vorbis_parse_read_setup_header (parse, outbuf3)) {
+    GST_DEBUG_OBJECT (parse, "decoding the headers");
+    parse->mode_count = 0;
+    vorbis_parse_decode_headers (parse);
+  }
 
-  outbuf = GST_BUFFER_CAST (parse->streamheader->data);
-  gst_buffer_map (outbuf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
-  packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
-  packet.packetno = 1;
-  packet.e_o_s = 0;
-  packet.b_o_s = 1;
-  vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
-  gst_buffer_unmap (outbuf, &map);
-  parse->sample_rate = parse->vi.rate;
-  parse->channels = parse->vi.channels;
-  outbuf1 = outbuf;
-
-  outbuf = GST_BUFFER_CAST (parse->streamheader->next->data);
-  gst_buffer_map (outbuf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
-  packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
-  packet.packetno = 2;
-  packet.e_o_s = 0;
-  packet.b_o_s = 0;
-  vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
-  gst_buffer_unmap (outbuf, &map);
-  outbuf2 = outbuf;
-
-  outbuf = GST_BUFFER_CAST (parse->streamheader->next->next->data);
-  gst_buffer_map (outbuf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
-  packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
-  packet.packetno = 3;
-  packet.e_o_s = 0;
-  packet.b_o_s = 0;
-  vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
-  gst_buffer_unmap (outbuf, &map);
-  outbuf3 = outbuf;
-
-  /* get the headers into the caps, passing them to vorbis as we go */
+  /* get the headers into the caps */
   caps = gst_caps_new_simple ("audio/x-vorbis",
       "rate", G_TYPE_INT, parse->sample_rate,
       "channels", G_TYPE_INT, parse->channels, NULL);
@@ -351,20 +458,33 @@ vorbis_parse_queue_buffer (GstVorbisParse * parse, GstBuffer * buf)
 {
   GstFlowReturn ret = GST_FLOW_OK;
   long blocksize;
-  ogg_packet packet;
   GstMapInfo map;
 
   buf = gst_buffer_make_writable (buf);
 
   gst_buffer_map (buf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
   GST_DEBUG ("%p, %" G_GSIZE_FORMAT, map.data, map.size);
-  packet.granulepos = GST_BUFFER_OFFSET_END (buf);
-  packet.packetno = parse->packetno + parse->buffer_queue->length;
-  packet.e_o_s = 0;
+  if (parse->mode_count > 0) {
+    guint mode;
+
+    /* the mode number follows the packet type bit */
+    blocksize = -1;
+    if (map.size > 0 && !(map.data[0] & 1)) {
+      mode = (map.data[0] >> 1) & ((1 << parse->mode_bits) - 1);
+      if (mode < parse->mode_count)
+        blocksize = parse->blocksize[parse->mode_blockflag[mode]];
+    }
+  } else {
+    ogg_packet packet;
+
+    packet.packet = map.data;
+    packet.bytes = map.size;
+    packet.granulepos = GST_BUFFER_OFFSET_END (buf);
+    packet.packetno = parse->packetno + parse->buffer_queue->length;
+    packet.e_o_s = 0;
 
-  blocksize = vorbis_packet_blocksize (&parse->vi, &packet);
+    blocksize = vorbis_packet_blocksize (&parse->vi, &packet);
+  }
   gst_buffer_unmap (buf, &map);
 
   /* temporarily store the sample count in OFFSET -- we overwrite this later */
@@ -505,10 +625,10 @@ vorbis_parse_convert (GstPad * pad,
     case GST_FORMAT_TIME:
       switch (*dest_format) {
         case GST_FORMAT_BYTES:
-          scale = sizeof (float) * parse->vi.channels;
+          scale = sizeof (float) * parse->channels;
         case GST_FORMAT_DEFAULT:
           *dest_value =
-              scale * gst_util_uint64_scale_int (src_value, parse->vi.rate,
+              scale * gst_util_uint64_scale_int (src_value, parse->sample_rate,
               GST_SECOND);
           break;
         default:
@@ -518,11 +638,11 @@ vorbis_parse_convert (GstPad * pad,
     case GST_FORMAT_DEFAULT:
       switch (*dest_format) {
         case GST_FORMAT_BYTES:
-          *dest_value = src_value * sizeof (float) * parse->vi.channels;
+          *dest_value = src_value * sizeof (float) * parse->channels;
           break;
         case GST_FORMAT_TIME:
           *dest_value =
-              gst_util_uint64_scale_int (src_value, GST_SECOND, parse->vi.rate);
+              gst_util_uint64_scale_int (src_value, GST_SECOND, parse->sample_rate);
           break;
         default:
           res = FALSE;
@@ -531,11 +651,11 @@ vorbis_parse_convert (GstPad * pad,
     case GST_FORMAT_BYTES:
       switch (*dest_format) {
         case GST_FORMAT_DEFAULT:
-          *dest_value = src_value / (sizeof (float) * parse->vi.channels);
+          *dest_value = src_value / (sizeof (float) * parse->channels);
           break;
         case GST_FORMAT_TIME:
           *dest_value = gst_util_uint64_scale_int (src_value, GST_SECOND,
-              parse->vi.rate * sizeof (float) * parse->vi.channels);
+              parse->sample_rate * sizeof (float) * parse->channels);
           break;
         default:
           res = FALSE;
@@ -634,6 +754,7 @@ vorbis_parse_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       vorbis_info_init (&parse->vi);
       vorbis_comment_init (&parse->vc);
+      parse->mode_count = 0;
       parse->prev_granulepos = -1;
       parse->prev_blocksize = -1;
       parse->packetno = 0;
@@ -67,6 +67,12 @@ struct _GstVorbisParse {
   gint32		prev_blocksize;
   guint32		sample_rate;
   guint32               channels;
+
+  /* from the headers when we don't need libvorbis, mode_count is 0 otherwise */
+  gint                  blocksize[2];
+  guint8                mode_blockflag[64];
+  guint                 mode_count;
+  guint                 mode_bits;
 };
 
 struct _GstVorbisParseClass {
@@ -38,12 +38,22 @@
 #include <unistd.h>
 #endif
 
+#ifdef HAVE_LINUX_DMA_BUF_H
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <linux/dma-buf.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (dmabuf_debug);
 #define GST_CAT_DEFAULT dmabuf_debug
 
 typedef struct
 {
   GstFdAllocator parent;
+
+  /* the map functions of the fd allocator */
+  GstMemoryMapFunction fd_map;
+  GstMemoryUnmapFunction fd_unmap;
 } GstDmaBufAllocator;
 
 typedef struct
@@ -57,6 +67,59 @@ G_DEFINE_TYPE (GstDmaBufAllocator, dmabuf_mem_allocator, GST_TYPE_FD_ALLOCATOR);
 #define GST_TYPE_DMABUF_ALLOCATOR   (dmabuf_mem_allocator_get_type())
 #define GST_IS_DMABUF_ALLOCATOR(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_DMABUF_ALLOCATOR))
 
+#ifdef HAVE_LINUX_DMA_BUF_H
+/* tell the exporter that the CPU starts or stops accessing the buffer so
+ * that it can do the cache maintenance for the direction of the access
+ * only */
+static void
+dmabuf_mem_sync (GstMemory * gmem, GstMapFlags flags, guint64 start_end)
+{
+  struct dma_buf_sync sync = { 0, };
+  gint fd = gst_fd_memory_get_fd (gmem);
+
+  sync.flags = start_end;
+  sync.flags |= (flags & GST_MAP_READ) ? DMA_BUF_SYNC_READ : 0;
+  sync.flags |= (flags & GST_MAP_WRITE) ? DMA_BUF_SYNC_WRITE : 0;
+
+  while (ioctl (fd, DMA_BUF_IOCTL_SYNC, &sync) < 0) {
+    if (errno != EINTR && errno != EAGAIN) {
+      /* older kernels don't know about the ioctl, the mapping is still
+       * usable */
+      GST_LOG ("%p: fd %d: sync failed: %s", gmem, fd, g_strerror (errno));
+      break;
+    }
+  }
+}
+#endif
+
+static gpointer
+dmabuf_mem_map_full (GstMemory * gmem, GstMapInfo * info, gsize maxsize)
+{
+  GstDmaBufAllocator *self = (GstDmaBufAllocator *) gmem->allocator;
+  gpointer data;
+
+  data = self->fd_map (gmem, maxsize, info->flags);
+
+#ifdef HAVE_LINUX_DMA_BUF_H
+  if (data)
+    dmabuf_mem_sync (gmem, info->flags, DMA_BUF_SYNC_START);
+#endif
+
+  return data;
+}
+
+static void
+dmabuf_mem_unmap_full (GstMemory * gmem, GstMapInfo * info)
+{
+  GstDmaBufAllocator *self = (GstDmaBufAllocator *) gmem->allocator;
+
+#ifdef HAVE_LINUX_DMA_BUF_H
+  dmabuf_mem_sync (gmem, info->flags, DMA_BUF_SYNC_END);
+#endif
+
+  self->fd_unmap (gmem);
+}
+
 static void
 dmabuf_mem_allocator_class_init (GstDmaBufAllocatorClass * klass)
 {
@@ -68,6 +131,11 @@ dmabuf_mem_allocator_init (GstDmaBufAllocator * allocator)
   GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
 
   alloc->mem_type = GST_ALLOCATOR_DMABUF;
+
+  allocator->fd_map = alloc->mem_map;
+  allocator->fd_unmap = alloc->mem_unmap;
+  alloc->mem_map_full = dmabuf_mem_map_full;
+  alloc->mem_unmap_full = dmabuf_mem_unmap_full;
 }
 
 /**
@@ -99,7 +167,9 @@ gst_dmabuf_allocator_new (void)
  *
  * Returns: (transfer full): a GstMemory based on @allocator.
  * When the buffer will be released dmabuf allocator will close the @fd.
- * The memory is only mmapped on gst_buffer_mmap() request.
+ * The memory is only mmapped on gst_buffer_mmap() request and then stays
+ * mapped until the memory is freed. Each map and unmap synchronizes the CPU
+ * access with the device for the access mode of the map.
  *
  * Since: 1.2
  */
@@ -108,7 +178,8 @@ gst_dmabuf_allocator_alloc (GstAllocator * allocator, gint fd, gsize size)
 {
   g_return_val_if_fail (GST_IS_DMABUF_ALLOCATOR (allocator), NULL);
 
-  return gst_fd_allocator_alloc (allocator, fd, size, GST_FD_MEMORY_FLAG_NONE);
+  return gst_fd_allocator_alloc (allocator, fd, size,
+      GST_FD_MEMORY_FLAG_KEEP_MAPPED);
 }
 
 /**
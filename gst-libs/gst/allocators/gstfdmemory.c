@@ -95,9 +95,17 @@ gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
     if ((mem->mmapping_flags & prot) == prot) {
       ret = mem->data;
       mem->mmap_count++;
+      goto out;
     }
 
-    goto out;
+    /* a kept mapping that is not in use can be redone with more access */
+    if (!(mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED) || mem->mmap_count > 0)
+      goto out;
+
+    munmap ((void *) mem->data, gmem->maxsize);
+    mem->data = NULL;
+    prot |= mem->mmapping_flags;
+    mem->mmapping_flags = 0;
   }
 
   if (mem->fd != -1) {
@@ -107,7 +115,19 @@ gst_fd_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
         (mem->flags & GST_FD_MEMORY_FLAG_MAP_PRIVATE) ? MAP_PRIVATE :
         MAP_SHARED;
 
-    mem->data = mmap (0, gmem->maxsize, prot, flags, mem->fd, 0);
+    /* a kept mapping is made writable right away when the memory allows it
+     * so that it can be reused for all later maps */
+    if ((mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED) &&
+        !GST_MEMORY_IS_READONLY (gmem) && prot != (PROT_READ | PROT_WRITE)) {
+      mem->data = mmap (0, gmem->maxsize, PROT_READ | PROT_WRITE, flags,
+          mem->fd, 0);
+      if (mem->data != MAP_FAILED)
+        prot = PROT_READ | PROT_WRITE;
+      else
+        mem->data = mmap (0, gmem->maxsize, prot, flags, mem->fd, 0);
+    } else {
+      mem->data = mmap (0, gmem->maxsize, prot, flags, mem->fd, 0);
+    }
     if (mem->data == MAP_FAILED) {
       mem->data = NULL;
       GST_ERROR ("%p: fd %d: mmap failed: %s", mem, mem->fd,
@@ -141,11 +161,9 @@ gst_fd_mem_unmap (GstMemory * gmem)
   if (gmem->parent)
     return gst_fd_mem_unmap (gmem->parent);
 
-  if (mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED)
-    return;
-
   g_mutex_lock (&mem->lock);
-  if (mem->data && !(--mem->mmap_count)) {
+  if (mem->data && !(--mem->mmap_count) &&
+      !(mem->flags & GST_FD_MEMORY_FLAG_KEEP_MAPPED)) {
     munmap ((void *) mem->data, gmem->maxsize);
     mem->data = NULL;
     mem->mmapping_flags = 0;
@@ -0,0 +1,402 @@
+/* GStreamer shared memory allocator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstshmallocator
+ * @short_description: Allocator for fd-backed shared memory
+ * @see_also: #GstFdAllocator, #GstMemory
+ *
+ * #GstShmAllocator allocates memory that is backed by an anonymous shared
+ * memory file, using memfd_create() when available and an unlinked
+ * temporary file otherwise. The memory can be used like any system memory
+ * but its file descriptor can also be retrieved with gst_fd_memory_get_fd()
+ * and passed to other processes or to APIs that import fds.
+ *
+ * Unlike #GstFdAllocator and the dmabuf allocator, which only wrap existing
+ * file descriptors, this allocator implements gst_allocator_alloc() and can
+ * therefore be configured on buffer pools, for example a
+ * #GstVideoBufferPool, with gst_buffer_pool_config_set_allocator(). The
+ * alignment from the #GstAllocationParams is honoured, so stride alignments
+ * configured with gst_buffer_pool_config_set_video_alignment() are kept.
+ *
+ * gst_shm_allocator_new_full() can additionally seal the size of the memory,
+ * back it with huge pages and keep the file descriptors of freed memory
+ * around for reuse. When reuse is enabled, other processes the fd was passed
+ * to must be done with the memory before it is freed in this process, or
+ * they might see the contents of a later allocation.
+ *
+ * Since: 1.10
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef HAVE_MEMFD_CREATE
+#define _GNU_SOURCE
+#endif
+
+#include "gstshmallocator.h"
+
+#include <string.h>
+#include <glib/gstdio.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (gst_shm_allocator_debug);
+#define GST_CAT_DEFAULT gst_shm_allocator_debug
+
+/* hugetlbfs rejects sizes that are not a multiple of the huge page size, 2MB
+ * is the default huge page size on the common architectures */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+typedef struct
+{
+  gint fd;
+  gsize size;
+} GstShmCachedFd;
+
+struct _GstShmAllocatorPrivate
+{
+  GstShmAllocatorFlags flags;
+  guint max_cached;
+
+  GMutex lock;
+  GQueue cached;
+};
+
+#define gst_shm_allocator_parent_class parent_class
+G_DEFINE_TYPE (GstShmAllocator, gst_shm_allocator, GST_TYPE_FD_ALLOCATOR);
+
+#ifdef HAVE_MMAP
+static gint
+gst_shm_allocator_open_fd (GstShmAllocator * shm, gboolean * hugetlb)
+{
+  GstShmAllocatorPrivate *priv = shm->priv;
+  gint fd;
+  gchar *path = NULL;
+  GError *err = NULL;
+
+#ifdef HAVE_MEMFD_CREATE
+  {
+    guint mfd_flags = MFD_CLOEXEC;
+
+#ifdef MFD_ALLOW_SEALING
+    if (priv->flags & GST_SHM_ALLOCATOR_FLAG_SEAL)
+      mfd_flags |= MFD_ALLOW_SEALING;
+#endif
+
+#ifdef MFD_HUGETLB
+    if (*hugetlb) {
+      fd = memfd_create ("gst-shm", mfd_flags | MFD_HUGETLB);
+      if (fd >= 0)
+        return fd;
+      GST_DEBUG_OBJECT (shm, "no huge pages available: %s",
+          g_strerror (errno));
+    }
+#endif
+    *hugetlb = FALSE;
+
+    fd = memfd_create ("gst-shm", mfd_flags);
+    if (fd >= 0)
+      return fd;
+    GST_DEBUG_OBJECT (shm, "memfd_create failed, falling back to a "
+        "temporary file");
+  }
+#endif
+  *hugetlb = FALSE;
+
+  if (priv->flags & GST_SHM_ALLOCATOR_FLAG_SEAL)
+    GST_DEBUG_OBJECT (shm, "can't seal temporary files");
+
+  fd = g_file_open_tmp ("gst-shm-XXXXXX", &path, &err);
+  if (fd < 0) {
+    GST_WARNING_OBJECT (shm, "could not create temporary file: %s",
+        err->message);
+    g_error_free (err);
+    return -1;
+  }
+  /* we only need the fd */
+  g_unlink (path);
+  g_free (path);
+
+  return fd;
+}
+
+/* create an fd of exactly @size bytes, returns -1 on error */
+static gint
+gst_shm_allocator_create_fd (GstShmAllocator * shm, gsize size,
+    gboolean hugetlb)
+{
+  gint fd;
+
+  if ((fd = gst_shm_allocator_open_fd (shm, &hugetlb)) < 0)
+    return -1;
+
+  if (ftruncate (fd, size) < 0) {
+    GST_WARNING_OBJECT (shm, "could not resize fd %d to %" G_GSIZE_FORMAT
+        ": %s", fd, size, g_strerror (errno));
+    close (fd);
+    return -1;
+  }
+
+#if defined(HAVE_MEMFD_CREATE) && defined(MFD_HUGETLB)
+  /* huge pages are only reserved on fault, which would get us a SIGBUS when
+   * the pool is exhausted, so reserve them now and fall back if that fails */
+  if (hugetlb && fallocate (fd, 0, 0, size) < 0) {
+    GST_DEBUG_OBJECT (shm, "could not reserve huge pages: %s",
+        g_strerror (errno));
+    close (fd);
+    return gst_shm_allocator_create_fd (shm, size, FALSE);
+  }
+#endif
+
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+  if (shm->priv->flags & GST_SHM_ALLOCATOR_FLAG_SEAL) {
+    if (fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+      GST_DEBUG_OBJECT (shm, "could not seal fd %d: %s", fd,
+          g_strerror (errno));
+  }
+#endif
+
+  return fd;
+}
+
+/* take a cached fd of @size bytes, returns -1 if there is none */
+static gint
+gst_shm_allocator_take_cached (GstShmAllocator * shm, gsize size)
+{
+  GstShmAllocatorPrivate *priv = shm->priv;
+  GList *walk;
+  gint fd = -1;
+
+  g_mutex_lock (&priv->lock);
+  for (walk = priv->cached.head; walk; walk = walk->next) {
+    GstShmCachedFd *cached = walk->data;
+
+    if (cached->size == size) {
+      fd = cached->fd;
+      g_queue_delete_link (&priv->cached, walk);
+      g_slice_free (GstShmCachedFd, cached);
+      break;
+    }
+  }
+  g_mutex_unlock (&priv->lock);
+
+  return fd;
+}
+#endif
+
+static GstMemory *
+gst_shm_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+#ifdef HAVE_MMAP
+  GstShmAllocator *shm = GST_SHM_ALLOCATOR_CAST (allocator);
+  GstMemory *mem;
+  GstMapInfo map;
+  gsize maxsize, align, offset;
+  gboolean hugetlb, reused = FALSE;
+  gint fd;
+
+  align = params->align | gst_memory_alignment;
+  maxsize = size + params->prefix + params->padding + align;
+
+  hugetlb = (shm->priv->flags & GST_SHM_ALLOCATOR_FLAG_HUGETLB) != 0;
+  if (hugetlb)
+    maxsize = GST_ROUND_UP_N (maxsize, HUGE_PAGE_SIZE);
+
+  if ((fd = gst_shm_allocator_take_cached (shm, maxsize)) >= 0) {
+    GST_LOG_OBJECT (shm, "reusing fd %d", fd);
+    reused = TRUE;
+  } else if ((fd = gst_shm_allocator_create_fd (shm, maxsize, hugetlb)) < 0) {
+    return NULL;
+  }
+
+  /* the memory stays mapped so the alignment we compute here stays valid,
+   * map it read-write now as later mappings can only use a subset of the
+   * flags of the first one */
+  mem = gst_fd_allocator_alloc (allocator, fd, maxsize,
+      GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+  if (mem == NULL) {
+    close (fd);
+    return NULL;
+  }
+
+  if (!gst_memory_map (mem, &map, GST_MAP_READWRITE)) {
+    GST_WARNING_OBJECT (allocator, "could not map fd %d", fd);
+    gst_memory_unref (mem);
+    return NULL;
+  }
+  offset = params->prefix;
+  if (((guintptr) map.data + offset) & align)
+    offset += (align + 1) - (((guintptr) map.data + offset) & align);
+
+  /* ftruncate zero fills, only reused memory needs clearing */
+  if (reused) {
+    if (offset && (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED))
+      memset (map.data, 0, offset);
+    if (params->flags & GST_MEMORY_FLAG_ZERO_PADDED)
+      memset (map.data + offset + size, 0, maxsize - offset - size);
+  }
+  gst_memory_unmap (mem, &map);
+
+  gst_memory_resize (mem, offset, size);
+
+  GST_LOG_OBJECT (allocator, "%p: fd %d, size %" G_GSIZE_FORMAT ", offset %"
+      G_GSIZE_FORMAT, mem, fd, size, offset);
+
+  return mem;
+#else /* !HAVE_MMAP */
+  return NULL;
+#endif
+}
+
+static void
+gst_shm_allocator_free (GstAllocator * allocator, GstMemory * mem)
+{
+#ifdef HAVE_MMAP
+  GstShmAllocatorPrivate *priv = GST_SHM_ALLOCATOR_CAST (allocator)->priv;
+
+  /* keep a duplicate of the fd around, the parent closes the original one */
+  if (mem->parent == NULL && priv->max_cached > 0) {
+    g_mutex_lock (&priv->lock);
+    if (priv->cached.length < priv->max_cached) {
+      GstShmCachedFd *cached;
+      gint fd;
+
+      if ((fd = dup (gst_fd_memory_get_fd (mem))) >= 0) {
+        cached = g_slice_new (GstShmCachedFd);
+        cached->fd = fd;
+        cached->size = mem->maxsize;
+        g_queue_push_tail (&priv->cached, cached);
+        GST_LOG_OBJECT (allocator, "caching fd %d of size %" G_GSIZE_FORMAT,
+            fd, mem->maxsize);
+      }
+    }
+    g_mutex_unlock (&priv->lock);
+  }
+#endif
+
+  GST_ALLOCATOR_CLASS (parent_class)->free (allocator, mem);
+}
+
+static void
+gst_shm_allocator_finalize (GObject * object)
+{
+  GstShmAllocatorPrivate *priv = GST_SHM_ALLOCATOR_CAST (object)->priv;
+  GstShmCachedFd *cached;
+
+  while ((cached = g_queue_pop_head (&priv->cached))) {
+#ifdef HAVE_MMAP
+    close (cached->fd);
+#endif
+    g_slice_free (GstShmCachedFd, cached);
+  }
+  g_mutex_clear (&priv->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_shm_allocator_class_init (GstShmAllocatorClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  g_type_class_add_private (klass, sizeof (GstShmAllocatorPrivate));
+
+  gobject_class->finalize = gst_shm_allocator_finalize;
+
+  allocator_class->alloc = gst_shm_allocator_alloc;
+  allocator_class->free = gst_shm_allocator_free;
+
+  GST_DEBUG_CATEGORY_INIT (gst_shm_allocator_debug, "shmallocator", 0,
+      "GstShmAllocator");
+}
+
+static void
+gst_shm_allocator_init (GstShmAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  allocator->priv = G_TYPE_INSTANCE_GET_PRIVATE (allocator,
+      GST_TYPE_SHM_ALLOCATOR, GstShmAllocatorPrivate);
+  g_mutex_init (&allocator->priv->lock);
+  g_queue_init (&allocator->priv->cached);
+
+  alloc->mem_type = GST_ALLOCATOR_SHM;
+
+  /* unlike the fd allocator we can allocate memory ourselves */
+  GST_OBJECT_FLAG_UNSET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+/**
+ * gst_shm_allocator_new:
+ *
+ * Return a new shared memory allocator.
+ *
+ * Returns: (transfer full): a new shm allocator, or NULL if the allocator
+ *    isn't available. Use gst_object_unref() to release the allocator after
+ *    usage
+ *
+ * Since: 1.10
+ */
+GstAllocator *
+gst_shm_allocator_new (void)
+{
+  return gst_shm_allocator_new_full (GST_SHM_ALLOCATOR_FLAG_NONE, 0);
+}
+
+/**
+ * gst_shm_allocator_new_full:
+ * @flags: #GstShmAllocatorFlags for the created memory
+ * @max_cached: the maximum number of freed file descriptors to keep for
+ *     reuse, 0 disables reuse
+ *
+ * Return a new shared memory allocator. The file descriptors of up to
+ * @max_cached freed memories are kept and reused for later allocations of
+ * the same size, which avoids creating, resizing and faulting in a new
+ * region for every allocation.
+ *
+ * Returns: (transfer full): a new shm allocator, or NULL if the allocator
+ *    isn't available. Use gst_object_unref() to release the allocator after
+ *    usage
+ *
+ * Since: 1.10
+ */
+GstAllocator *
+gst_shm_allocator_new_full (GstShmAllocatorFlags flags, guint max_cached)
+{
+#ifdef HAVE_MMAP
+  GstShmAllocator *shm;
+
+  shm = g_object_new (GST_TYPE_SHM_ALLOCATOR, NULL);
+  shm->priv->flags = flags;
+  shm->priv->max_cached = max_cached;
+
+  return GST_ALLOCATOR_CAST (shm);
+#else
+  return NULL;
+#endif
+}
@@ -0,0 +1,92 @@
+/* GStreamer shared memory allocator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_SHM_ALLOCATOR_H__
+#define __GST_SHM_ALLOCATOR_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/gstfdmemory.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstShmAllocator GstShmAllocator;
+typedef struct _GstShmAllocatorClass GstShmAllocatorClass;
+typedef struct _GstShmAllocatorPrivate GstShmAllocatorPrivate;
+
+#define GST_ALLOCATOR_SHM "shm"
+
+#define GST_TYPE_SHM_ALLOCATOR              (gst_shm_allocator_get_type())
+#define GST_IS_SHM_ALLOCATOR(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_SHM_ALLOCATOR))
+#define GST_IS_SHM_ALLOCATOR_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_SHM_ALLOCATOR))
+#define GST_SHM_ALLOCATOR_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_SHM_ALLOCATOR, GstShmAllocatorClass))
+#define GST_SHM_ALLOCATOR(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_SHM_ALLOCATOR, GstShmAllocator))
+#define GST_SHM_ALLOCATOR_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_SHM_ALLOCATOR, GstShmAllocatorClass))
+#define GST_SHM_ALLOCATOR_CAST(obj)         ((GstShmAllocator *)(obj))
+
+/**
+ * GstShmAllocatorFlags:
+ * @GST_SHM_ALLOCATOR_FLAG_NONE: no flag
+ * @GST_SHM_ALLOCATOR_FLAG_SEAL: seal the size of the memory so that
+ *        processes it is shared with can't shrink or grow it. Only
+ *        available when the memory is created with memfd_create().
+ * @GST_SHM_ALLOCATOR_FLAG_HUGETLB: try to back the memory with huge pages.
+ *        Allocations are rounded up to the huge page size.
+ *
+ * Flags to control the memory created by a #GstShmAllocator.
+ *
+ * Since: 1.10
+ */
+typedef enum {
+  GST_SHM_ALLOCATOR_FLAG_NONE = 0,
+  GST_SHM_ALLOCATOR_FLAG_SEAL = (1 << 0),
+  GST_SHM_ALLOCATOR_FLAG_HUGETLB = (1 << 1),
+} GstShmAllocatorFlags;
+
+/**
+ * GstShmAllocator:
+ *
+ * Allocator for fd-backed shared memory
+ *
+ * Since: 1.10
+ */
+struct _GstShmAllocator
+{
+  GstFdAllocator parent;
+
+  /*< private >*/
+  GstShmAllocatorPrivate *priv;
+};
+
+struct _GstShmAllocatorClass
+{
+  GstFdAllocatorClass parent_class;
+};
+
+GType gst_shm_allocator_get_type (void);
+
+GstAllocator *  gst_shm_allocator_new      (void);
+GstAllocator *  gst_shm_allocator_new_full (GstShmAllocatorFlags flags,
+                                            guint max_cached);
+
+#ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstShmAllocator, gst_object_unref)
+#endif
+
+G_END_DECLS
+
+#endif /* __GST_SHM_ALLOCATOR_H__ */
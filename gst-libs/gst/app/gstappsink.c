@@ -80,6 +80,8 @@ struct _GstAppSinkPrivate
   guint max_buffers;
   gboolean drop;
   gboolean wait_on_eos;
+  guint wait_for_batch;
+  guint wake_batch;
 
   GCond cond;
   GMutex mutex;
@@ -97,6 +99,9 @@ struct _GstAppSinkPrivate
   GstAppSinkCallbacks callbacks;
   gpointer user_data;
   GDestroyNotify notify;
+
+  /* GSources from gst_app_sink_create_watch(), protected by mutex */
+  GList *watches;
 };
 
 GST_DEBUG_CATEGORY_STATIC (app_sink_debug);
@@ -112,6 +117,8 @@ enum
   /* actions */
   SIGNAL_PULL_PREROLL,
   SIGNAL_PULL_SAMPLE,
+  SIGNAL_TRY_PULL_PREROLL,
+  SIGNAL_TRY_PULL_SAMPLE,
 
   LAST_SIGNAL
 };
@@ -121,6 +128,7 @@ enum
 #define DEFAULT_PROP_MAX_BUFFERS	0
 #define DEFAULT_PROP_DROP		FALSE
 #define DEFAULT_PROP_WAIT_ON_EOS	TRUE
+#define DEFAULT_PROP_WAIT_FOR_BATCH	0
 
 enum
 {
@@ -131,6 +139,7 @@ enum
   PROP_MAX_BUFFERS,
   PROP_DROP,
   PROP_WAIT_ON_EOS,
+  PROP_WAIT_FOR_BATCH,
   PROP_LAST
 };
 
@@ -164,6 +173,8 @@ static GstFlowReturn gst_app_sink_render (GstBaseSink * psink,
 static gboolean gst_app_sink_setcaps (GstBaseSink * sink, GstCaps * caps);
 static GstCaps *gst_app_sink_getcaps (GstBaseSink * psink, GstCaps * filter);
 
+static void gst_app_sink_wakeup_watches (GstAppSink * appsink);
+
 static guint gst_app_sink_signals[LAST_SIGNAL] = { 0 };
 
 #define gst_app_sink_parent_class parent_class
@@ -229,6 +240,24 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
           DEFAULT_PROP_WAIT_ON_EOS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAppSink::wait-for-batch:
+   *
+   * Only emit the new-sample signal or callback once this many samples are
+   * queued in @appsink. This allows applications that process samples in
+   * batches with gst_app_sink_pull_samples() to be woken up once per batch
+   * instead of once per buffer. When the stream ends with an incomplete
+   * batch, the remaining samples can be pulled from the eos signal or
+   * callback. 0 emits new-sample for every buffer.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_WAIT_FOR_BATCH,
+      g_param_spec_uint ("wait-for-batch", "Wait for batch",
+          "Number of queued samples needed before new-sample is emitted "
+          "(0 = every sample)", 0, G_MAXUINT, DEFAULT_PROP_WAIT_FOR_BATCH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAppSink::eos:
    * @appsink: the appsink element that emitted the signal
@@ -337,6 +366,42 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
       G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstAppSinkClass,
           pull_sample), NULL, NULL, __gst_app_marshal_BOXED__VOID,
       GST_TYPE_SAMPLE, 0, G_TYPE_NONE);
+  /**
+   * GstAppSink::try-pull-preroll:
+   * @appsink: the appsink element to emit this signal on
+   * @timeout: the maximum amount of time to wait for the preroll sample
+   *
+   * Get the last preroll sample in @appsink, like the "pull-preroll" action
+   * signal, but wait at most @timeout nanoseconds for it.
+   *
+   * Returns: a #GstSample or NULL when the appsink is stopped or EOS or the
+   *          timeout expires.
+   *
+   * Since: 1.10
+   */
+  gst_app_sink_signals[SIGNAL_TRY_PULL_PREROLL] =
+      g_signal_new ("try-pull-preroll", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstAppSinkClass,
+          try_pull_preroll), NULL, NULL, __gst_app_marshal_BOXED__UINT64,
+      GST_TYPE_SAMPLE, 1, GST_TYPE_CLOCK_TIME);
+  /**
+   * GstAppSink::try-pull-sample:
+   * @appsink: the appsink element to emit this signal on
+   * @timeout: the maximum amount of time to wait for a sample
+   *
+   * Get the next sample from @appsink, like the "pull-sample" action signal,
+   * but wait at most @timeout nanoseconds for it.
+   *
+   * Returns: a #GstSample or NULL when the appsink is stopped or EOS or the
+   *          timeout expires.
+   *
+   * Since: 1.10
+   */
+  gst_app_sink_signals[SIGNAL_TRY_PULL_SAMPLE] =
+      g_signal_new ("try-pull-sample", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstAppSinkClass,
+          try_pull_sample), NULL, NULL, __gst_app_marshal_BOXED__UINT64,
+      GST_TYPE_SAMPLE, 1, GST_TYPE_CLOCK_TIME);
 
   gst_element_class_set_static_metadata (element_class, "AppSink",
       "Generic/Sink", "Allow the application to get access to raw buffer",
@@ -358,6 +423,8 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
 
   klass->pull_preroll = gst_app_sink_pull_preroll;
   klass->pull_sample = gst_app_sink_pull_sample;
+  klass->try_pull_preroll = gst_app_sink_try_pull_preroll;
+  klass->try_pull_sample = gst_app_sink_try_pull_sample;
 
   g_type_class_add_private (klass, sizeof (GstAppSinkPrivate));
 }
@@ -379,6 +446,8 @@ gst_app_sink_init (GstAppSink * appsink)
   priv->max_buffers = DEFAULT_PROP_MAX_BUFFERS;
   priv->drop = DEFAULT_PROP_DROP;
   priv->wait_on_eos = DEFAULT_PROP_WAIT_ON_EOS;
+  priv->wait_for_batch = DEFAULT_PROP_WAIT_FOR_BATCH;
+  priv->wake_batch = 1;
 }
 
 static void
@@ -447,6 +516,9 @@ gst_app_sink_set_property (GObject * object, guint prop_id,
     case PROP_WAIT_ON_EOS:
       gst_app_sink_set_wait_on_eos (appsink, g_value_get_boolean (value));
       break;
+    case PROP_WAIT_FOR_BATCH:
+      gst_app_sink_set_wait_for_batch (appsink, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -485,6 +557,9 @@ gst_app_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_WAIT_ON_EOS:
       g_value_set_boolean (value, gst_app_sink_get_wait_on_eos (appsink));
       break;
+    case PROP_WAIT_FOR_BATCH:
+      g_value_set_uint (value, gst_app_sink_get_wait_for_batch (appsink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -612,6 +687,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
       GST_DEBUG_OBJECT (appsink, "receiving EOS");
       priv->is_eos = TRUE;
       g_cond_signal (&priv->cond);
+      gst_app_sink_wakeup_watches (appsink);
       g_mutex_unlock (&priv->mutex);
 
       g_mutex_lock (&priv->mutex);
@@ -668,6 +744,7 @@ gst_app_sink_preroll (GstBaseSink * psink, GstBuffer * buffer)
   gst_buffer_replace (&priv->preroll, buffer);
 
   g_cond_signal (&priv->cond);
+  gst_app_sink_wakeup_watches (appsink);
   emit = priv->emit_signals;
   g_mutex_unlock (&priv->mutex);
 
@@ -740,7 +817,7 @@ gst_app_sink_render (GstBaseSink * psink, GstBuffer * buffer)
   GstFlowReturn ret;
   GstAppSink *appsink = GST_APP_SINK_CAST (psink);
   GstAppSinkPrivate *priv = appsink->priv;
-  gboolean emit;
+  gboolean emit, batch_ready;
 
 restart:
   g_mutex_lock (&priv->mutex);
@@ -791,16 +868,23 @@ restart:
   /* we need to ref the buffer when pushing it in the queue */
   g_queue_push_tail (priv->queue, gst_buffer_ref (buffer));
   priv->num_buffers++;
-  g_cond_signal (&priv->cond);
+  /* a batch puller only needs to be woken up once enough buffers are queued */
+  if (priv->num_buffers >= priv->wake_batch)
+    g_cond_signal (&priv->cond);
+  /* watches only need to know when the queue stops being empty */
+  if (priv->num_buffers == 1)
+    gst_app_sink_wakeup_watches (appsink);
   emit = priv->emit_signals;
+  batch_ready = priv->num_buffers >= priv->wait_for_batch;
   g_mutex_unlock (&priv->mutex);
 
-  if (priv->callbacks.new_sample) {
-    ret = priv->callbacks.new_sample (appsink, priv->user_data);
-  } else {
-    ret = GST_FLOW_OK;
-    if (emit)
+  ret = GST_FLOW_OK;
+  if (batch_ready) {
+    if (priv->callbacks.new_sample) {
+      ret = priv->callbacks.new_sample (appsink, priv->user_data);
+    } else if (emit) {
       g_signal_emit (appsink, gst_app_sink_signals[SIGNAL_NEW_SAMPLE], 0, &ret);
+    }
   }
   return ret;
 
@@ -1175,6 +1259,59 @@ gst_app_sink_get_wait_on_eos (GstAppSink * appsink)
   return result;
 }
 
+/**
+ * gst_app_sink_set_wait_for_batch:
+ * @appsink: a #GstAppSink
+ * @batch: the number of samples to wait for
+ *
+ * Only emit the new-sample signal or call the new_sample callback once
+ * @batch samples are queued in @appsink. Use 0 to be notified of every
+ * sample.
+ *
+ * Since: 1.10
+ */
+void
+gst_app_sink_set_wait_for_batch (GstAppSink * appsink, guint batch)
+{
+  GstAppSinkPrivate *priv;
+
+  g_return_if_fail (GST_IS_APP_SINK (appsink));
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  priv->wait_for_batch = batch;
+  g_mutex_unlock (&priv->mutex);
+}
+
+/**
+ * gst_app_sink_get_wait_for_batch:
+ * @appsink: a #GstAppSink
+ *
+ * Get the number of samples that need to be queued in @appsink before the
+ * new-sample signal is emitted.
+ *
+ * Returns: the batch size, or 0 when every sample is signalled.
+ *
+ * Since: 1.10
+ */
+guint
+gst_app_sink_get_wait_for_batch (GstAppSink * appsink)
+{
+  guint result;
+  GstAppSinkPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), 0);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  result = priv->wait_for_batch;
+  g_mutex_unlock (&priv->mutex);
+
+  return result;
+}
+
 /**
  * gst_app_sink_pull_preroll:
  * @appsink: a #GstAppSink
@@ -1201,14 +1338,82 @@ gst_app_sink_get_wait_on_eos (GstAppSink * appsink)
  */
 GstSample *
 gst_app_sink_pull_preroll (GstAppSink * appsink)
+{
+  return gst_app_sink_try_pull_preroll (appsink, GST_CLOCK_TIME_NONE);
+}
+
+/**
+ * gst_app_sink_pull_sample:
+ * @appsink: a #GstAppSink
+ *
+ * This function blocks until a sample or EOS becomes available or the appsink
+ * element is set to the READY/NULL state.
+ *
+ * This function will only return samples when the appsink is in the PLAYING
+ * state. All rendered buffers will be put in a queue so that the application
+ * can pull samples at its own rate. Note that when the application does not
+ * pull samples fast enough, the queued buffers could consume a lot of memory,
+ * especially when dealing with raw video frames.
+ *
+ * If an EOS event was received before any buffers, this function returns
+ * %NULL. Use gst_app_sink_is_eos () to check for the EOS condition.
+ *
+ * Returns: (transfer full): a #GstSample or NULL when the appsink is stopped or EOS.
+ *          Call gst_sample_unref() after usage.
+ */
+GstSample *
+gst_app_sink_pull_sample (GstAppSink * appsink)
+{
+  return gst_app_sink_try_pull_sample (appsink, GST_CLOCK_TIME_NONE);
+}
+
+/* wait on the condition until signalled or until end_time, returns FALSE when
+ * the timeout expired. end_time is ignored when timeout is
+ * GST_CLOCK_TIME_NONE. Must be called with the mutex held. */
+static gboolean
+gst_app_sink_wait (GstAppSink * appsink, GstClockTime timeout, gint64 end_time)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+
+  if (!GST_CLOCK_TIME_IS_VALID (timeout)) {
+    g_cond_wait (&priv->cond, &priv->mutex);
+    return TRUE;
+  }
+  return g_cond_wait_until (&priv->cond, &priv->mutex, end_time);
+}
+
+/**
+ * gst_app_sink_try_pull_preroll:
+ * @appsink: a #GstAppSink
+ * @timeout: the maximum amount of time to wait for the preroll sample
+ *
+ * Get the last preroll sample in @appsink. This was the sample that caused the
+ * appsink to preroll in the PAUSED state. This sample can be pulled many times
+ * and remains available to the application even after EOS.
+ *
+ * This function is the same as gst_app_sink_pull_preroll() but waits at most
+ * @timeout nanoseconds for the preroll sample. A @timeout of 0 does not
+ * block and %GST_CLOCK_TIME_NONE blocks until a sample is available.
+ *
+ * Returns: (transfer full): a #GstSample or NULL when the appsink is stopped
+ *          or EOS or the timeout expires. Call gst_sample_unref() after usage.
+ *
+ * Since: 1.10
+ */
+GstSample *
+gst_app_sink_try_pull_preroll (GstAppSink * appsink, GstClockTime timeout)
 {
   GstSample *sample = NULL;
   GstAppSinkPrivate *priv;
+  gint64 end_time = 0;
 
   g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
 
   priv = appsink->priv;
 
+  if (GST_CLOCK_TIME_IS_VALID (timeout))
+    end_time = g_get_monotonic_time () + timeout / GST_USECOND;
+
   g_mutex_lock (&priv->mutex);
 
   while (TRUE) {
@@ -1224,7 +1429,8 @@ gst_app_sink_pull_preroll (GstAppSink * appsink)
 
     /* nothing to return, wait */
     GST_DEBUG_OBJECT (appsink, "waiting for the preroll buffer");
-    g_cond_wait (&priv->cond, &priv->mutex);
+    if (!gst_app_sink_wait (appsink, timeout, end_time))
+      goto expired;
   }
   sample =
       gst_sample_new (priv->preroll, priv->preroll_caps, &priv->preroll_segment,
@@ -1235,6 +1441,12 @@ gst_app_sink_pull_preroll (GstAppSink * appsink)
   return sample;
 
   /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
 eos:
   {
     GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
@@ -1250,36 +1462,35 @@ not_started:
 }
 
 /**
- * gst_app_sink_pull_sample:
+ * gst_app_sink_try_pull_sample:
  * @appsink: a #GstAppSink
+ * @timeout: the maximum amount of time to wait for a sample
  *
- * This function blocks until a sample or EOS becomes available or the appsink
- * element is set to the READY/NULL state.
+ * This function is the same as gst_app_sink_pull_sample() but waits at most
+ * @timeout nanoseconds for a sample to become available. A @timeout of 0
+ * does not block and %GST_CLOCK_TIME_NONE blocks until a sample or EOS is
+ * available or the appsink element is set to the READY/NULL state.
  *
- * This function will only return samples when the appsink is in the PLAYING
- * state. All rendered buffers will be put in a queue so that the application
- * can pull samples at its own rate. Note that when the application does not
- * pull samples fast enough, the queued buffers could consume a lot of memory,
- * especially when dealing with raw video frames.
- *
- * If an EOS event was received before any buffers, this function returns
- * %NULL. Use gst_app_sink_is_eos () to check for the EOS condition.
+ * Returns: (transfer full): a #GstSample or NULL when the appsink is stopped
+ *          or EOS or the timeout expires. Call gst_sample_unref() after usage.
  *
- * Returns: (transfer full): a #GstSample or NULL when the appsink is stopped or EOS.
- *          Call gst_sample_unref() after usage.
+ * Since: 1.10
  */
-
 GstSample *
-gst_app_sink_pull_sample (GstAppSink * appsink)
+gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
 {
   GstSample *sample = NULL;
   GstBuffer *buffer;
   GstAppSinkPrivate *priv;
+  gint64 end_time = 0;
 
   g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
 
   priv = appsink->priv;
 
+  if (GST_CLOCK_TIME_IS_VALID (timeout))
+    end_time = g_get_monotonic_time () + timeout / GST_USECOND;
+
   g_mutex_lock (&priv->mutex);
 
   while (TRUE) {
@@ -1295,7 +1506,9 @@ gst_app_sink_pull_sample (GstAppSink * appsink)
 
     /* nothing to return, wait */
     GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
-    g_cond_wait (&priv->cond, &priv->mutex);
+    priv->wake_batch = 1;
+    if (!gst_app_sink_wait (appsink, timeout, end_time))
+      goto expired;
   }
   buffer = dequeue_buffer (appsink);
   GST_DEBUG_OBJECT (appsink, "we have a buffer %p", buffer);
@@ -1308,6 +1521,12 @@ gst_app_sink_pull_sample (GstAppSink * appsink)
   return sample;
 
   /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
 eos:
   {
     GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
@@ -1322,6 +1541,223 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_pull_samples:
+ * @appsink: a #GstAppSink
+ * @max_samples: the maximum number of samples to return
+ * @timeout: the maximum time to wait, or %GST_CLOCK_TIME_NONE
+ *
+ * Pull up to @max_samples samples from @appsink at once. This function
+ * blocks until @max_samples samples are queued, EOS is reached, @timeout
+ * expires or the appsink element is set to the READY/NULL state, and then
+ * returns all samples that are available, up to @max_samples.
+ *
+ * Compared to calling gst_app_sink_pull_sample() repeatedly, the queue is
+ * only locked once and the calling thread is only woken up when the batch
+ * is complete. When "max-buffers" is smaller than @max_samples, this
+ * function returns as soon as "max-buffers" samples are queued.
+ *
+ * Returns: (transfer full) (element-type GstSample): a list of #GstSample,
+ *     oldest first, or %NULL when no sample was available. Free with
+ *     g_list_free_full() and gst_sample_unref().
+ *
+ * Since: 1.10
+ */
+GList *
+gst_app_sink_pull_samples (GstAppSink * appsink, guint max_samples,
+    GstClockTime timeout)
+{
+  GList *samples = NULL;
+  GstBuffer *buffer;
+  GstAppSinkPrivate *priv;
+  gint64 end_time = 0;
+  guint target;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+  g_return_val_if_fail (max_samples > 0, NULL);
+
+  priv = appsink->priv;
+
+  if (GST_CLOCK_TIME_IS_VALID (timeout))
+    end_time = g_get_monotonic_time () + timeout / GST_USECOND;
+
+  g_mutex_lock (&priv->mutex);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab %u buffers", max_samples);
+    if (!priv->started)
+      goto not_started;
+
+    /* we would never get more than max-buffers queued */
+    target = max_samples;
+    if (priv->max_buffers > 0 && target > priv->max_buffers)
+      target = priv->max_buffers;
+
+    if (priv->num_buffers >= target)
+      break;
+
+    if (priv->is_eos)
+      break;
+
+    GST_DEBUG_OBJECT (appsink, "waiting for %u buffers, have %u", target,
+        priv->num_buffers);
+    priv->wake_batch = target;
+    if (!gst_app_sink_wait (appsink, timeout, end_time)) {
+      GST_DEBUG_OBJECT (appsink, "timeout, have %u buffers", priv->num_buffers);
+      break;
+    }
+  }
+  priv->wake_batch = 1;
+
+  while (priv->num_buffers > 0 && max_samples > 0) {
+    buffer = dequeue_buffer (appsink);
+    samples = g_list_prepend (samples, gst_sample_new (buffer,
+            priv->last_caps, &priv->last_segment, NULL));
+    gst_buffer_unref (buffer);
+    max_samples--;
+  }
+  GST_DEBUG_OBJECT (appsink, "we have %u samples", g_list_length (samples));
+
+  if (samples)
+    g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->mutex);
+
+  return g_list_reverse (samples);
+
+  /* special conditions */
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    priv->wake_batch = 1;
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+}
+
+typedef struct
+{
+  GSource source;
+  GstAppSink *appsink;
+} GstAppSinkSource;
+
+/* called with the mutex held */
+static void
+gst_app_sink_wakeup_watches (GstAppSink * appsink)
+{
+  GList *walk;
+
+  for (walk = appsink->priv->watches; walk; walk = walk->next) {
+    GSource *source = walk->data;
+    GMainContext *context;
+
+    if (g_source_is_destroyed (source))
+      continue;
+    if ((context = g_source_get_context (source)))
+      g_main_context_wakeup (context);
+  }
+}
+
+static gboolean
+gst_app_sink_source_ready (GstAppSinkSource * source)
+{
+  GstAppSinkPrivate *priv = source->appsink->priv;
+  gboolean ready;
+
+  g_mutex_lock (&priv->mutex);
+  ready = priv->num_buffers > 0 || priv->is_eos;
+  g_mutex_unlock (&priv->mutex);
+
+  return ready;
+}
+
+static gboolean
+gst_app_sink_source_prepare (GSource * source, gint * timeout)
+{
+  *timeout = -1;
+  return gst_app_sink_source_ready ((GstAppSinkSource *) source);
+}
+
+static gboolean
+gst_app_sink_source_check (GSource * source)
+{
+  return gst_app_sink_source_ready ((GstAppSinkSource *) source);
+}
+
+static gboolean
+gst_app_sink_source_dispatch (GSource * source, GSourceFunc callback,
+    gpointer user_data)
+{
+  if (!callback) {
+    GST_WARNING_OBJECT (((GstAppSinkSource *) source)->appsink,
+        "watch dispatched without callback; you must call "
+        "g_source_set_callback().");
+    return G_SOURCE_REMOVE;
+  }
+
+  return callback (user_data);
+}
+
+static void
+gst_app_sink_source_finalize (GSource * source)
+{
+  GstAppSink *appsink = ((GstAppSinkSource *) source)->appsink;
+  GstAppSinkPrivate *priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  priv->watches = g_list_remove (priv->watches, source);
+  g_mutex_unlock (&priv->mutex);
+
+  gst_object_unref (appsink);
+}
+
+static GSourceFuncs gst_app_sink_source_funcs = {
+  gst_app_sink_source_prepare,
+  gst_app_sink_source_check,
+  gst_app_sink_source_dispatch,
+  gst_app_sink_source_finalize
+};
+
+/**
+ * gst_app_sink_create_watch:
+ * @appsink: a #GstAppSink
+ *
+ * Create a watch for @appsink. The source is dispatched when a sample can be
+ * pulled from @appsink without blocking or when @appsink is EOS. This allows
+ * a single #GMainContext to service many appsinks with
+ * gst_app_sink_try_pull_sample() instead of polling them with timers.
+ *
+ * The source is dispatched as long as samples are queued, so the callback
+ * should pull all samples it wants to handle. Once @appsink is EOS the
+ * source stays ready and the callback should return %G_SOURCE_REMOVE.
+ *
+ * Use g_source_set_callback() with a #GSourceFunc to set the callback.
+ *
+ * Returns: (transfer full): a #GSource that can be added to a mainloop.
+ *
+ * Since: 1.10
+ */
+GSource *
+gst_app_sink_create_watch (GstAppSink * appsink)
+{
+  GstAppSinkSource *source;
+  GstAppSinkPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  priv = appsink->priv;
+
+  source = (GstAppSinkSource *) g_source_new (&gst_app_sink_source_funcs,
+      sizeof (GstAppSinkSource));
+  g_source_set_name ((GSource *) source, "GStreamer appsink watch");
+  source->appsink = gst_object_ref (appsink);
+
+  g_mutex_lock (&priv->mutex);
+  priv->watches = g_list_prepend (priv->watches, source);
+  g_mutex_unlock (&priv->mutex);
+
+  return (GSource *) source;
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
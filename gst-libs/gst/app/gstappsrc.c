@@ -87,6 +87,17 @@
  * gst_app_src_end_of_stream() or emit the end-of-stream action signal. After
  * this call, no more buffers can be pushed into appsrc until a flushing seek
  * occurs or the state of the appsrc has gone through READY.
+ *
+ * Applications pushing many small buffers at a high rate can set the
+ * "lock-free" property, in which case buffers are queued without taking
+ * the lock that is shared with the streaming thread, and use
+ * gst_app_src_push_buffer_list() to queue several buffers at once.
+ *
+ * When all the data of the stream is available in memory, such as in a
+ * memory-mapped file, it can be given to appsrc with gst_app_src_set_data().
+ * appsrc then operates in the "random-access" mode and produces buffers that
+ * share the memory of the data for every requested range, without emitting
+ * any signals.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -95,6 +106,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesrc.h>
+#include <gst/gstatomicqueue.h>
 
 #include <string.h>
 
@@ -132,6 +144,28 @@ struct _GstAppSrcPrivate
   GstAppSrcCallbacks callbacks;
   gpointer user_data;
   GDestroyNotify notify;
+
+  /* lock-free mode: objects are queued in lf_queue and accounted in
+   * lf_queued_bytes without taking the mutex. The waiting side sets its
+   * flag with the mutex held so that the other side only has to take the
+   * mutex when someone actually is waiting. */
+  gboolean lock_free;
+  GstAtomicQueue *lf_queue;
+  volatile gssize lf_queued_bytes;
+  volatile gint lf_wait_data;
+  volatile gint lf_wait_space;
+  /* caps retained over a flush in lock-free mode, they go out before
+   * anything in lf_queue */
+  GstCaps *lf_requeued_caps;
+
+  /* buffer list being pushed out and the index of its next buffer */
+  GstBufferList *pending_list;
+  guint pending_idx;
+
+  /* data of the stream set with gst_app_src_set_data() and the memory
+   * wrapping it, NULL when the data is empty */
+  GBytes *data;
+  GstMemory *data_mem;
 };
 
 GST_DEBUG_CATEGORY_STATIC (app_src_debug);
@@ -163,6 +197,7 @@ enum
 #define DEFAULT_PROP_EMIT_SIGNALS  TRUE
 #define DEFAULT_PROP_MIN_PERCENT   0
 #define DEFAULT_PROP_CURRENT_LEVEL_BYTES   0
+#define DEFAULT_PROP_LOCK_FREE     FALSE
 
 enum
 {
@@ -179,6 +214,7 @@ enum
   PROP_EMIT_SIGNALS,
   PROP_MIN_PERCENT,
   PROP_CURRENT_LEVEL_BYTES,
+  PROP_LOCK_FREE,
   PROP_LAST
 };
 
@@ -402,6 +438,28 @@ gst_app_src_class_init (GstAppSrcClass * klass)
           0, G_MAXUINT64, DEFAULT_PROP_CURRENT_LEVEL_BYTES,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAppSrc::lock-free:
+   *
+   * Queue buffers without taking the lock shared with the streaming thread.
+   * Pushing a buffer then only takes a lock when the queue is full and
+   * #GstAppSrc:block is set, or when the streaming thread is waiting for
+   * data on an empty queue.
+   *
+   * The max-bytes limit, #GstAppSrc:block and the enough-data and need-data
+   * signals behave as in the default mode. In this mode, setting %NULL caps
+   * with gst_app_src_set_caps() is not queued.
+   *
+   * Can only be changed when the element is not started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_LOCK_FREE,
+      g_param_spec_boolean ("lock-free", "Lock free",
+          "Queue buffers without taking the lock shared with the streaming "
+          "thread", DEFAULT_PROP_LOCK_FREE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
 
   /**
    * GstAppSrc::need-data:
@@ -549,6 +607,7 @@ gst_app_src_init (GstAppSrc * appsrc)
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
   priv->queue = g_queue_new ();
+  priv->lf_queue = gst_atomic_queue_new (16);
 
   priv->size = DEFAULT_PROP_SIZE;
   priv->stream_type = DEFAULT_PROP_STREAM_TYPE;
@@ -559,10 +618,40 @@ gst_app_src_init (GstAppSrc * appsrc)
   priv->max_latency = DEFAULT_PROP_MAX_LATENCY;
   priv->emit_signals = DEFAULT_PROP_EMIT_SIGNALS;
   priv->min_percent = DEFAULT_PROP_MIN_PERCENT;
+  priv->lock_free = DEFAULT_PROP_LOCK_FREE;
 
   gst_base_src_set_live (GST_BASE_SRC (appsrc), DEFAULT_PROP_IS_LIVE);
 }
 
+/* Returns the number of bytes accounted for a queued object */
+static gsize
+gst_app_src_queued_size (GstMiniObject * obj)
+{
+  gsize size = 0;
+  guint i, len;
+
+  if (GST_IS_BUFFER (obj))
+    return gst_buffer_get_size (GST_BUFFER_CAST (obj));
+
+  if (GST_IS_BUFFER_LIST (obj)) {
+    len = gst_buffer_list_length (GST_BUFFER_LIST_CAST (obj));
+    for (i = 0; i < len; i++)
+      size += gst_buffer_get_size (gst_buffer_list_get (GST_BUFFER_LIST_CAST
+              (obj), i));
+  }
+
+  return size;
+}
+
+static guint64
+gst_app_src_get_queued_bytes (GstAppSrcPrivate * priv)
+{
+  if (priv->lock_free)
+    return (guint64) g_atomic_pointer_get (&priv->lf_queued_bytes);
+
+  return priv->queued_bytes;
+}
+
 /* Must be called with priv->mutex */
 static void
 gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
@@ -571,6 +660,31 @@ gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
   GstAppSrcPrivate *priv = src->priv;
   GstCaps *requeue_caps = NULL;
 
+  /* caps retained by a previous flush come before everything else */
+  if (priv->lf_requeued_caps) {
+    if (retain_last_caps)
+      requeue_caps = priv->lf_requeued_caps;
+    else
+      gst_caps_unref (priv->lf_requeued_caps);
+    priv->lf_requeued_caps = NULL;
+  }
+
+  if (priv->pending_list) {
+    /* the buffers of the list that were not pushed yet are still accounted
+     * for, lock-free producers keep adding so we can't just reset it */
+    if (priv->lock_free) {
+      gsize size = 0;
+      guint i, len = gst_buffer_list_length (priv->pending_list);
+
+      for (i = priv->pending_idx; i < len; i++)
+        size += gst_buffer_get_size (gst_buffer_list_get (priv->pending_list,
+                i));
+      g_atomic_pointer_add (&priv->lf_queued_bytes, -(gssize) size);
+    }
+    gst_buffer_list_unref (priv->pending_list);
+    priv->pending_list = NULL;
+  }
+
   while (!g_queue_is_empty (priv->queue)) {
     obj = g_queue_pop_head (priv->queue);
     if (obj) {
@@ -581,13 +695,87 @@ gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
     }
   }
 
+  /* producers can still be adding, only account for what we remove */
+  while ((obj = gst_atomic_queue_pop (priv->lf_queue))) {
+    if (GST_IS_CAPS (obj) && retain_last_caps) {
+      gst_caps_replace (&requeue_caps, GST_CAPS_CAST (obj));
+    }
+    g_atomic_pointer_add (&priv->lf_queued_bytes,
+        -(gssize) gst_app_src_queued_size (obj));
+    gst_mini_object_unref (obj);
+  }
+
   if (requeue_caps) {
-    g_queue_push_tail (priv->queue, requeue_caps);
+    /* producers might have queued new data behind it already, so in
+     * lock-free mode keep the caps aside instead of queueing them */
+    if (priv->lock_free)
+      priv->lf_requeued_caps = requeue_caps;
+    else
+      g_queue_push_tail (priv->queue, requeue_caps);
   }
 
   priv->queued_bytes = 0;
 }
 
+/* Must be called with priv->mutex */
+static gboolean
+gst_app_src_queue_is_empty (GstAppSrc * src)
+{
+  GstAppSrcPrivate *priv = src->priv;
+
+  if (priv->pending_list || priv->lf_requeued_caps)
+    return FALSE;
+
+  if (priv->lock_free)
+    return gst_atomic_queue_length (priv->lf_queue) == 0;
+
+  return g_queue_is_empty (priv->queue);
+}
+
+/* Must be called with priv->mutex. Returns the next caps or buffer, taking
+ * the buffers out of queued buffer lists one by one, or NULL. */
+static GstMiniObject *
+gst_app_src_queue_pop (GstAppSrc * src)
+{
+  GstAppSrcPrivate *priv = src->priv;
+  GstMiniObject *obj;
+
+  if (priv->lf_requeued_caps) {
+    obj = GST_MINI_OBJECT_CAST (priv->lf_requeued_caps);
+    priv->lf_requeued_caps = NULL;
+    return obj;
+  }
+
+  while (TRUE) {
+    if (priv->pending_list) {
+      GstBuffer *buf;
+
+      buf = gst_buffer_list_get (priv->pending_list, priv->pending_idx++);
+      gst_buffer_ref (buf);
+      if (priv->pending_idx >= gst_buffer_list_length (priv->pending_list)) {
+        gst_buffer_list_unref (priv->pending_list);
+        priv->pending_list = NULL;
+      }
+      return GST_MINI_OBJECT_CAST (buf);
+    }
+
+    if (priv->lock_free)
+      obj = gst_atomic_queue_pop (priv->lf_queue);
+    else
+      obj = g_queue_pop_head (priv->queue);
+
+    if (obj == NULL || !GST_IS_BUFFER_LIST (obj))
+      return obj;
+
+    if (gst_buffer_list_length (GST_BUFFER_LIST_CAST (obj)) == 0) {
+      gst_buffer_list_unref (GST_BUFFER_LIST_CAST (obj));
+      continue;
+    }
+    priv->pending_list = GST_BUFFER_LIST_CAST (obj);
+    priv->pending_idx = 0;
+  }
+}
+
 static void
 gst_app_src_dispose (GObject * obj)
 {
@@ -613,6 +801,14 @@ gst_app_src_dispose (GObject * obj)
 
   g_mutex_lock (&priv->mutex);
   gst_app_src_flush_queued (appsrc, FALSE);
+  if (priv->data_mem) {
+    gst_memory_unref (priv->data_mem);
+    priv->data_mem = NULL;
+  }
+  if (priv->data) {
+    g_bytes_unref (priv->data);
+    priv->data = NULL;
+  }
   g_mutex_unlock (&priv->mutex);
 
   G_OBJECT_CLASS (parent_class)->dispose (obj);
@@ -627,6 +823,7 @@ gst_app_src_finalize (GObject * obj)
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
   g_queue_free (priv->queue);
+  gst_atomic_queue_unref (priv->lf_queue);
 
   g_free (priv->uri);
 
@@ -703,6 +900,20 @@ gst_app_src_set_property (GObject * object, guint prop_id,
     case PROP_MIN_PERCENT:
       priv->min_percent = g_value_get_uint (value);
       break;
+    case PROP_LOCK_FREE:
+    {
+      gboolean lock_free = g_value_get_boolean (value);
+
+      g_mutex_lock (&priv->mutex);
+      if (priv->started || !gst_app_src_queue_is_empty (appsrc)) {
+        GST_WARNING_OBJECT (appsrc, "can't change lock-free mode while "
+            "started or with queued data");
+      } else {
+        priv->lock_free = lock_free;
+      }
+      g_mutex_unlock (&priv->mutex);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -763,6 +974,9 @@ gst_app_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CURRENT_LEVEL_BYTES:
       g_value_set_uint64 (value, gst_app_src_get_current_level_bytes (appsrc));
       break;
+    case PROP_LOCK_FREE:
+      g_value_set_boolean (value, priv->lock_free);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -963,6 +1177,15 @@ gst_app_src_do_seek (GstBaseSrc * src, GstSegment * segment)
   if (priv->stream_type == GST_APP_STREAM_TYPE_STREAM)
     return TRUE;
 
+  /* we can produce any range of the data ourselves */
+  g_mutex_lock (&priv->mutex);
+  if (priv->data) {
+    priv->is_eos = FALSE;
+    g_mutex_unlock (&priv->mutex);
+    return TRUE;
+  }
+  g_mutex_unlock (&priv->mutex);
+
   GST_DEBUG_OBJECT (appsrc, "seeking to %" G_GINT64_FORMAT ", format %s",
       desired_position, gst_format_get_name (segment->format));
 
@@ -1081,6 +1304,33 @@ gst_app_src_negotiate (GstBaseSrc * basesrc)
   return result;
 }
 
+/* must be called with the appsrc mutex */
+static GstFlowReturn
+gst_app_src_create_from_data (GstAppSrc * appsrc, guint64 offset, guint size,
+    GstBuffer ** buf)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  gsize data_size = g_bytes_get_size (priv->data);
+
+  if (offset >= data_size) {
+    GST_DEBUG_OBJECT (appsrc, "offset %" G_GUINT64_FORMAT " past the end of "
+        "the data", offset);
+    return GST_FLOW_EOS;
+  }
+
+  size = MIN (size, data_size - offset);
+
+  *buf = gst_buffer_new ();
+  gst_buffer_append_memory (*buf, gst_memory_share (priv->data_mem, offset,
+          size));
+  priv->offset = offset + size;
+
+  GST_DEBUG_OBJECT (appsrc, "sharing %u bytes of the data at offset %"
+      G_GUINT64_FORMAT, size, offset);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
     GstBuffer ** buf)
@@ -1109,6 +1359,12 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
   if (G_UNLIKELY (priv->flushing))
     goto flushing;
 
+  if (priv->data) {
+    ret = gst_app_src_create_from_data (appsrc, offset, size, buf);
+    g_mutex_unlock (&priv->mutex);
+    return ret;
+  }
+
   if (priv->stream_type == GST_APP_STREAM_TYPE_RANDOM_ACCESS) {
     /* if we are dealing with a random-access stream, issue a seek if the offset
      * changed. */
@@ -1129,9 +1385,14 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
 
   while (TRUE) {
     /* return data as long as we have some */
-    if (!g_queue_is_empty (priv->queue)) {
+    if (!gst_app_src_queue_is_empty (appsrc)) {
       guint buf_size;
-      GstMiniObject *obj = g_queue_pop_head (priv->queue);
+      guint64 queued_bytes;
+      GstMiniObject *obj = gst_app_src_queue_pop (appsrc);
+
+      /* popped concurrently by a flush */
+      if (G_UNLIKELY (obj == NULL && priv->lock_free))
+        continue;
 
       if (!GST_IS_BUFFER (obj)) {
         GstCaps *next_caps = GST_CAPS (obj);
@@ -1167,18 +1428,26 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
 
       GST_DEBUG_OBJECT (appsrc, "we have buffer %p of size %u", *buf, buf_size);
 
-      priv->queued_bytes -= buf_size;
+      if (priv->lock_free) {
+        queued_bytes = g_atomic_pointer_add (&priv->lf_queued_bytes,
+            -(gssize) buf_size) - buf_size;
+      } else {
+        priv->queued_bytes -= buf_size;
+        queued_bytes = priv->queued_bytes;
+      }
 
       /* only update the offset when in random_access mode */
       if (priv->stream_type == GST_APP_STREAM_TYPE_RANDOM_ACCESS)
         priv->offset += buf_size;
 
-      /* signal that we removed an item */
-      g_cond_broadcast (&priv->cond);
+      /* signal that we removed an item, lock-free producers only wait
+       * when they said so */
+      if (!priv->lock_free || priv->lf_wait_space)
+        g_cond_broadcast (&priv->cond);
 
       /* see if we go lower than the empty-percent */
       if (priv->min_percent && priv->max_bytes) {
-        if (priv->queued_bytes * 100 / priv->max_bytes <= priv->min_percent)
+        if (queued_bytes * 100 / priv->max_bytes <= priv->min_percent)
           /* ignore flushing state, we got a buffer and we will return it now.
            * Errors will be handled in the next round */
           gst_app_src_emit_need_data (appsrc, size);
@@ -1197,7 +1466,7 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
        * signal) we can still be empty because the pushed buffer got flushed or
        * when the application pushes the requested buffer later, we support both
        * possibilities. */
-      if (!g_queue_is_empty (priv->queue))
+      if (!gst_app_src_queue_is_empty (appsrc))
         continue;
 
       /* no buffer yet, maybe we are EOS, if not, block for more data. */
@@ -1208,7 +1477,16 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
       goto eos;
 
     /* nothing to return, wait a while for new data or flushing. */
-    g_cond_wait (&priv->cond, &priv->mutex);
+    if (priv->lock_free) {
+      /* producers check the flag after queueing, so either we see their
+       * data here or they see that we wait and wake us up */
+      g_atomic_int_set (&priv->lf_wait_data, TRUE);
+      if (gst_app_src_queue_is_empty (appsrc))
+        g_cond_wait (&priv->cond, &priv->mutex);
+      g_atomic_int_set (&priv->lf_wait_data, FALSE);
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
   }
   g_mutex_unlock (&priv->mutex);
   return ret;
@@ -1269,11 +1547,24 @@ gst_app_src_set_caps (GstAppSrc * appsrc, const GstCaps * caps)
     GstCaps *new_caps;
     new_caps = caps ? gst_caps_copy (caps) : NULL;
     GST_DEBUG_OBJECT (appsrc, "setting caps to %" GST_PTR_FORMAT, caps);
-    if (priv->queue->tail != NULL && GST_IS_CAPS (priv->queue->tail->data)) {
-      gst_caps_unref (g_queue_pop_tail (priv->queue));
+    if (priv->lock_free) {
+      /* the queue can't hold NULL */
+      if (new_caps) {
+        gst_atomic_queue_push (priv->lf_queue, gst_caps_ref (new_caps));
+        if (priv->lf_wait_data)
+          g_cond_broadcast (&priv->cond);
+      }
+    } else {
+      if (priv->queue->tail != NULL
+          && GST_IS_CAPS (priv->queue->tail->data)) {
+        gst_caps_unref (g_queue_pop_tail (priv->queue));
+      }
+      g_queue_push_tail (priv->queue, new_caps ? gst_caps_ref (new_caps) :
+          NULL);
     }
-    g_queue_push_tail (priv->queue, new_caps);
     gst_caps_replace (&priv->last_caps, new_caps);
+    if (new_caps)
+      gst_caps_unref (new_caps);
   }
 
   GST_OBJECT_UNLOCK (appsrc);
@@ -1356,6 +1647,68 @@ gst_app_src_get_size (GstAppSrc * appsrc)
   return size;
 }
 
+/**
+ * gst_app_src_set_data:
+ * @appsrc: a #GstAppSrc
+ * @data: (transfer none) (allow-none): the data of the stream or %NULL
+ *
+ * Set the complete data of the stream. @appsrc will then operate in the
+ * random-access mode, with the size of @data as the size of the stream, and
+ * answer all requests for data by sharing the memory of @data, so the data is
+ * never copied and the need-data and seek-data signals are not emitted.
+ *
+ * Data in a file descriptor can be given to @appsrc by memory-mapping it,
+ * for example with g_mapped_file_new_from_fd() and
+ * g_mapped_file_get_bytes().
+ *
+ * Setting %NULL removes the data, after which @appsrc asks the application
+ * for the data again.
+ *
+ * Since: 1.10
+ */
+void
+gst_app_src_set_data (GstAppSrc * appsrc, GBytes * data)
+{
+  GstAppSrcPrivate *priv;
+  GstMemory *mem = NULL, *old_mem;
+  GBytes *old_data;
+
+  g_return_if_fail (GST_IS_APP_SRC (appsrc));
+
+  priv = appsrc->priv;
+
+  if (data && g_bytes_get_size (data) > 0) {
+    gsize size;
+    gconstpointer ptr = g_bytes_get_data (data, &size);
+
+    mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) ptr,
+        size, 0, size, g_bytes_ref (data), (GDestroyNotify) g_bytes_unref);
+  }
+
+  if (data) {
+    GST_OBJECT_LOCK (appsrc);
+    GST_DEBUG_OBJECT (appsrc, "setting data of size %" G_GSIZE_FORMAT,
+        g_bytes_get_size (data));
+    priv->size = g_bytes_get_size (data);
+    priv->stream_type = GST_APP_STREAM_TYPE_RANDOM_ACCESS;
+    GST_OBJECT_UNLOCK (appsrc);
+  }
+
+  g_mutex_lock (&priv->mutex);
+  old_data = priv->data;
+  old_mem = priv->data_mem;
+  priv->data = data ? g_bytes_ref (data) : NULL;
+  priv->data_mem = mem;
+  /* make sure the application is asked for the right position again */
+  priv->offset = -1;
+  g_mutex_unlock (&priv->mutex);
+
+  if (old_mem)
+    gst_memory_unref (old_mem);
+  if (old_data)
+    g_bytes_unref (old_data);
+}
+
 /**
  * gst_app_src_set_stream_type:
  * @appsrc: a #GstAppSrc
@@ -1483,7 +1836,7 @@ gst_app_src_get_current_level_bytes (GstAppSrc * appsrc)
   priv = appsrc->priv;
 
   GST_OBJECT_LOCK (appsrc);
-  queued = priv->queued_bytes;
+  queued = gst_app_src_get_queued_bytes (priv);
   GST_DEBUG_OBJECT (appsrc, "current level bytes is %" G_GUINT64_FORMAT,
       queued);
   GST_OBJECT_UNLOCK (appsrc);
@@ -1605,18 +1958,104 @@ gst_app_src_get_emit_signals (GstAppSrc * appsrc)
   return result;
 }
 
+static void
+gst_app_src_emit_enough_data (GstAppSrc * appsrc, gboolean emit)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+
+  if (priv->callbacks.enough_data)
+    priv->callbacks.enough_data (appsrc, priv->user_data);
+  else if (emit)
+    g_signal_emit (appsrc, gst_app_src_signals[SIGNAL_ENOUGH_DATA], 0, NULL);
+}
+
+/* queue @obj, a buffer or buffer list, in lock-free mode */
 static GstFlowReturn
-gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
-    gboolean steal_ref)
+gst_app_src_push_lock_free (GstAppSrc * appsrc, GstMiniObject * obj,
+    gsize size)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  guint64 max_bytes;
+
+  /* can't accept buffers when we are flushing or EOS */
+  if (g_atomic_int_get (&priv->flushing))
+    goto flushing;
+
+  if (g_atomic_int_get (&priv->is_eos))
+    goto eos;
+
+  max_bytes = priv->max_bytes;
+  if (max_bytes && gst_app_src_get_queued_bytes (priv) >= max_bytes) {
+    GST_DEBUG_OBJECT (appsrc,
+        "queue filled (%" G_GUINT64_FORMAT " >= %" G_GUINT64_FORMAT ")",
+        gst_app_src_get_queued_bytes (priv), max_bytes);
+
+    gst_app_src_emit_enough_data (appsrc, priv->emit_signals);
+
+    if (priv->block) {
+      g_mutex_lock (&priv->mutex);
+      priv->lf_wait_space = TRUE;
+      while (!priv->flushing && !priv->is_eos && priv->max_bytes &&
+          gst_app_src_get_queued_bytes (priv) >= priv->max_bytes) {
+        GST_DEBUG_OBJECT (appsrc, "waiting for free space");
+        g_cond_wait (&priv->cond, &priv->mutex);
+      }
+      priv->lf_wait_space = FALSE;
+      g_mutex_unlock (&priv->mutex);
+
+      if (g_atomic_int_get (&priv->flushing))
+        goto flushing;
+      if (g_atomic_int_get (&priv->is_eos))
+        goto eos;
+    }
+    /* else we just pump more data into the queue hoping that the caller
+     * reacts to the enough-data signal and stops pushing buffers. */
+  }
+
+  GST_DEBUG_OBJECT (appsrc, "queueing %" GST_PTR_FORMAT, obj);
+  g_atomic_pointer_add (&priv->lf_queued_bytes, size);
+  gst_atomic_queue_push (priv->lf_queue, obj);
+
+  /* only wake up the streaming thread when it waits on an empty queue */
+  if (g_atomic_int_get (&priv->lf_wait_data)) {
+    g_mutex_lock (&priv->mutex);
+    g_cond_broadcast (&priv->cond);
+    g_mutex_unlock (&priv->mutex);
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+flushing:
+  {
+    GST_DEBUG_OBJECT (appsrc, "refuse %" GST_PTR_FORMAT ", we are flushing",
+        obj);
+    gst_mini_object_unref (obj);
+    return GST_FLOW_FLUSHING;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (appsrc, "refuse %" GST_PTR_FORMAT ", we are EOS", obj);
+    gst_mini_object_unref (obj);
+    return GST_FLOW_EOS;
+  }
+}
+
+/* queue @obj, a buffer or buffer list, taking ownership of it */
+static GstFlowReturn
+gst_app_src_push_internal (GstAppSrc * appsrc, GstMiniObject * obj)
 {
   gboolean first = TRUE;
   GstAppSrcPrivate *priv;
-
-  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
-  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
+  gsize size;
 
   priv = appsrc->priv;
 
+  size = gst_app_src_queued_size (obj);
+
+  if (priv->lock_free)
+    return gst_app_src_push_lock_free (appsrc, obj, size);
+
   g_mutex_lock (&priv->mutex);
 
   while (TRUE) {
@@ -1639,11 +2078,7 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
         /* only signal on the first push */
         g_mutex_unlock (&priv->mutex);
 
-        if (priv->callbacks.enough_data)
-          priv->callbacks.enough_data (appsrc, priv->user_data);
-        else if (emit)
-          g_signal_emit (appsrc, gst_app_src_signals[SIGNAL_ENOUGH_DATA], 0,
-              NULL);
+        gst_app_src_emit_enough_data (appsrc, emit);
 
         g_mutex_lock (&priv->mutex);
         /* continue to check for flushing/eos after releasing the lock */
@@ -1665,11 +2100,9 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
       break;
   }
 
-  GST_DEBUG_OBJECT (appsrc, "queueing buffer %p", buffer);
-  if (!steal_ref)
-    gst_buffer_ref (buffer);
-  g_queue_push_tail (priv->queue, buffer);
-  priv->queued_bytes += gst_buffer_get_size (buffer);
+  GST_DEBUG_OBJECT (appsrc, "queueing %" GST_PTR_FORMAT, obj);
+  g_queue_push_tail (priv->queue, obj);
+  priv->queued_bytes += size;
   g_cond_broadcast (&priv->cond);
   g_mutex_unlock (&priv->mutex);
 
@@ -1678,22 +2111,34 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
   /* ERRORS */
 flushing:
   {
-    GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, we are flushing", buffer);
-    if (steal_ref)
-      gst_buffer_unref (buffer);
+    GST_DEBUG_OBJECT (appsrc, "refuse %" GST_PTR_FORMAT ", we are flushing",
+        obj);
+    gst_mini_object_unref (obj);
     g_mutex_unlock (&priv->mutex);
     return GST_FLOW_FLUSHING;
   }
 eos:
   {
-    GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, we are EOS", buffer);
-    if (steal_ref)
-      gst_buffer_unref (buffer);
+    GST_DEBUG_OBJECT (appsrc, "refuse %" GST_PTR_FORMAT ", we are EOS", obj);
+    gst_mini_object_unref (obj);
     g_mutex_unlock (&priv->mutex);
     return GST_FLOW_EOS;
   }
 }
 
+static GstFlowReturn
+gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
+    gboolean steal_ref)
+{
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
+
+  if (!steal_ref)
+    gst_buffer_ref (buffer);
+
+  return gst_app_src_push_internal (appsrc, GST_MINI_OBJECT_CAST (buffer));
+}
+
 static GstFlowReturn
 gst_app_src_push_sample_internal (GstAppSrc * appsrc, GstSample * sample)
 {
@@ -1739,6 +2184,37 @@ gst_app_src_push_buffer (GstAppSrc * appsrc, GstBuffer * buffer)
   return gst_app_src_push_buffer_full (appsrc, buffer, TRUE);
 }
 
+/**
+ * gst_app_src_push_buffer_list:
+ * @appsrc: a #GstAppSrc
+ * @buffer_list: (transfer full): a #GstBufferList to push
+ *
+ * Adds the buffers of @buffer_list to the queue of buffers that the appsrc
+ * element will push to its source pad, as a single entry. This function
+ * takes ownership of @buffer_list.
+ *
+ * The whole list counts towards max-bytes, and the buffers are pushed
+ * downstream one by one.
+ *
+ * When the block property is TRUE, this function can block until free
+ * space becomes available in the queue.
+ *
+ * Returns: #GST_FLOW_OK when the buffer list was successfuly queued.
+ * #GST_FLOW_FLUSHING when @appsrc is not PAUSED or PLAYING.
+ * #GST_FLOW_EOS when EOS occured.
+ *
+ * Since: 1.10
+ */
+GstFlowReturn
+gst_app_src_push_buffer_list (GstAppSrc * appsrc, GstBufferList * buffer_list)
+{
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (buffer_list), GST_FLOW_ERROR);
+
+  return gst_app_src_push_internal (appsrc,
+      GST_MINI_OBJECT_CAST (buffer_list));
+}
+
 /**
  * gst_app_src_push_sample:
  * @appsrc: a #GstAppSrc
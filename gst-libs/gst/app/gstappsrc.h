@@ -127,6 +127,8 @@ GstCaps*         gst_app_src_get_caps                (GstAppSrc *appsrc);
 void             gst_app_src_set_size                (GstAppSrc *appsrc, gint64 size);
 gint64           gst_app_src_get_size                (GstAppSrc *appsrc);
 
+void             gst_app_src_set_data                (GstAppSrc *appsrc, GBytes *data);
+
 void             gst_app_src_set_stream_type         (GstAppSrc *appsrc, GstAppStreamType type);
 GstAppStreamType gst_app_src_get_stream_type         (GstAppSrc *appsrc);
 
@@ -142,6 +144,7 @@ void             gst_app_src_set_emit_signals        (GstAppSrc *appsrc, gboolea
 gboolean         gst_app_src_get_emit_signals        (GstAppSrc *appsrc);
 
 GstFlowReturn    gst_app_src_push_buffer             (GstAppSrc *appsrc, GstBuffer *buffer);
+GstFlowReturn    gst_app_src_push_buffer_list        (GstAppSrc *appsrc, GstBufferList *buffer_list);
 GstFlowReturn    gst_app_src_end_of_stream           (GstAppSrc *appsrc);
 GstFlowReturn    gst_app_src_push_sample             (GstAppSrc *appsrc, GstSample *sample);
 
@@ -54,8 +54,18 @@ ensure_debug_category (void)
 
 #define PRECISION_INT 10
 
-typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src,
-    gpointer dst, gint samples);
+typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src[],
+    gpointer dst[], gint samples);
+
+typedef enum
+{
+  /* all coefficients are used */
+  MIXER_KIND_DENSE,
+  /* some coefficients are 0 */
+  MIXER_KIND_SPARSE,
+  /* each output channel is a copy of an input channel or silence */
+  MIXER_KIND_COPY
+} MixerKind;
 
 struct _GstAudioChannelMixer
 {
@@ -76,6 +86,24 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* the matrix was given instead of made from the positions */
+  gboolean custom;
+
+  /* what kind of kernel the matrix needs */
+  MixerKind kind;
+
+  /* for MIXER_KIND_SPARSE, per output channel the input channels with a
+   * non-zero coefficient, and their coefficients.
+   * m[out_channels][sparse_count[out]] */
+  gint *sparse_count;
+  gint *sparse_idx;
+  gint *sparse_coeff_int;
+  gfloat *sparse_coeff;
+
+  /* for MIXER_KIND_COPY, the input channel for each output channel, -1
+   * for silence */
+  gint copy_map[64];
+
   MixerFunc func;
 
   gpointer tmp;
@@ -103,6 +131,11 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->sparse_count);
+  g_free (mix->sparse_idx);
+  g_free (mix->sparse_coeff_int);
+  g_free (mix->sparse_coeff);
+
   g_free (mix->tmp);
   mix->tmp = NULL;
 
@@ -664,8 +697,66 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* find the non-zero coefficients of the matrix so that the kernels only
+ * do useful work. The integer formats use the integer matrix, where small
+ * coefficients can become 0 */
 static void
-gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixer * mix)
+gst_audio_channel_mixer_setup_sparse (GstAudioChannelMixer * mix)
+{
+  gboolean is_int, copy = TRUE;
+  gint i, o, nnz = 0;
+
+  is_int = mix->format == GST_AUDIO_FORMAT_S16 ||
+      mix->format == GST_AUDIO_FORMAT_S32;
+
+  mix->sparse_count = g_new0 (gint, mix->out_channels);
+  mix->sparse_idx = g_new (gint, mix->out_channels * mix->in_channels);
+  mix->sparse_coeff_int = g_new (gint, mix->out_channels * mix->in_channels);
+  mix->sparse_coeff = g_new (gfloat, mix->out_channels * mix->in_channels);
+
+  for (o = 0; o < mix->out_channels; o++) {
+    gint base = o * mix->in_channels, n = 0;
+
+    mix->copy_map[o] = -1;
+
+    for (i = 0; i < mix->in_channels; i++) {
+      if (is_int ? mix->matrix_int[i][o] == 0 : mix->matrix[i][o] == 0.0)
+        continue;
+
+      mix->sparse_idx[base + n] = i;
+      mix->sparse_coeff_int[base + n] = mix->matrix_int[i][o];
+      mix->sparse_coeff[base + n] = mix->matrix[i][o];
+      n++;
+
+      /* (x * 2^10 + 2^9) >> 10 == x so unity copies the sample for the
+       * integer formats too */
+      if (is_int ? mix->matrix_int[i][o] == (1 << PRECISION_INT) :
+          mix->matrix[i][o] == 1.0)
+        mix->copy_map[o] = i;
+    }
+    mix->sparse_count[o] = n;
+    nnz += n;
+
+    if (n > 1 || (n == 1 && mix->copy_map[o] == -1))
+      copy = FALSE;
+  }
+
+  if (copy)
+    mix->kind = MIXER_KIND_COPY;
+  else if (nnz < mix->in_channels * mix->out_channels)
+    mix->kind = MIXER_KIND_SPARSE;
+  else
+    mix->kind = MIXER_KIND_DENSE;
+
+  GST_DEBUG ("%d of %d coefficients used, kind %d", nnz,
+      mix->in_channels * mix->out_channels, mix->kind);
+}
+
+/* @custom is m[out_channels][in_channels] like in #GstAudioDownmixMeta, or
+ * %NULL to make the matrix from the channel positions */
+static void
+gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixer * mix,
+    const gfloat ** custom)
 {
   gint i, j;
 
@@ -680,10 +771,18 @@ gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixer * mix)
   }
 
   /* setup the matrix' internal values */
-  gst_audio_channel_mixer_fill_matrix (mix);
+  if (custom) {
+    for (i = 0; i < mix->in_channels; i++)
+      for (j = 0; j < mix->out_channels; j++)
+        mix->matrix[i][j] = custom[j][i];
+  } else {
+    gst_audio_channel_mixer_fill_matrix (mix);
+  }
 
   gst_audio_channel_mixer_setup_matrix_int (mix);
 
+  gst_audio_channel_mixer_setup_sparse (mix);
+
 #ifndef GST_DISABLE_GST_DEBUG
   /* debug */
   {
@@ -712,8 +811,10 @@ gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixer * mix)
 
 static void
 gst_audio_channel_mixer_mix_int16 (GstAudioChannelMixer * mix,
-    const gint16 * in_data, gint16 * out_data, gint samples)
+    const gint16 * src[], gint16 * dst[], gint samples)
 {
+  const gint16 *in_data = src[0];
+  gint16 *out_data = dst[0];
   gint in, out, n;
   gint32 res;
   gint inchannels, outchannels;
@@ -737,8 +838,10 @@ gst_audio_channel_mixer_mix_int16 (GstAudioChannelMixer * mix,
 
 static void
 gst_audio_channel_mixer_mix_int32 (GstAudioChannelMixer * mix,
-    const gint32 * in_data, gint32 * out_data, gint samples)
+    const gint32 * src[], gint32 * dst[], gint samples)
 {
+  const gint32 *in_data = src[0];
+  gint32 *out_data = dst[0];
   gint in, out, n;
   gint64 res;
   gint inchannels, outchannels;
@@ -762,8 +865,10 @@ gst_audio_channel_mixer_mix_int32 (GstAudioChannelMixer * mix,
 
 static void
 gst_audio_channel_mixer_mix_float (GstAudioChannelMixer * mix,
-    const gfloat * in_data, gfloat * out_data, gint samples)
+    const gfloat * src[], gfloat * dst[], gint samples)
 {
+  const gfloat *in_data = src[0];
+  gfloat *out_data = dst[0];
   gint in, out, n;
   gfloat res;
   gint inchannels, outchannels;
@@ -785,8 +890,10 @@ gst_audio_channel_mixer_mix_float (GstAudioChannelMixer * mix,
 
 static void
 gst_audio_channel_mixer_mix_double (GstAudioChannelMixer * mix,
-    const gdouble * in_data, gdouble * out_data, gint samples)
+    const gdouble * src[], gdouble * dst[], gint samples)
 {
+  const gdouble *in_data = src[0];
+  gdouble *out_data = dst[0];
   gint in, out, n;
   gdouble res;
   gint inchannels, outchannels;
@@ -806,6 +913,267 @@ gst_audio_channel_mixer_mix_double (GstAudioChannelMixer * mix,
   }
 }
 
+/* Kernels for non-interleaved samples. Output channels are computed in
+ * blocks so that an input channel is read once for the whole block and
+ * the inner loops run over contiguous samples, which the compiler can
+ * vectorize. The sums are made in the same order as the interleaved
+ * kernels so the results are the same. */
+#define MIX_BLOCK_CHANNELS 4
+#define MIX_BLOCK_SAMPLES 256
+
+#define MIX_COEFF_INT(mix,i,o) ((mix)->matrix_int[i][o])
+#define MIX_COEFF_FLOAT(mix,i,o) ((mix)->matrix[i][o])
+
+#define MIX_FINISH_INT16(res) \
+    CLAMP (((res) + (1 << (PRECISION_INT - 1))) >> PRECISION_INT, \
+        G_MININT16, G_MAXINT16)
+#define MIX_FINISH_INT32(res) \
+    CLAMP (((res) + (1 << (PRECISION_INT - 1))) >> PRECISION_INT, \
+        G_MININT32, G_MAXINT32)
+#define MIX_FINISH_FLOAT(res) (res)
+
+#define DEFINE_PLANAR_MIXER(name,type,acctype,COEFF,FINISH)                 \
+static void                                                                 \
+gst_audio_channel_mixer_mix_##name##_planar (GstAudioChannelMixer * mix,    \
+    const type * in[], type * out[], gint samples)                          \
+{                                                                           \
+  acctype acc[MIX_BLOCK_CHANNELS][MIX_BLOCK_SAMPLES];                       \
+  gint i, o, b, n, s, len, n_block;                                         \
+                                                                            \
+  for (s = 0; s < samples; s += MIX_BLOCK_SAMPLES) {                        \
+    len = MIN (samples - s, MIX_BLOCK_SAMPLES);                             \
+                                                                            \
+    for (o = 0; o < mix->out_channels; o += MIX_BLOCK_CHANNELS) {           \
+      n_block = MIN (mix->out_channels - o, MIX_BLOCK_CHANNELS);            \
+                                                                            \
+      for (b = 0; b < n_block; b++)                                         \
+        for (n = 0; n < len; n++)                                           \
+          acc[b][n] = 0;                                                    \
+                                                                            \
+      for (i = 0; i < mix->in_channels; i++) {                              \
+        const type *src = in[i] + s;                                        \
+                                                                            \
+        for (b = 0; b < n_block; b++) {                                     \
+          acctype m = COEFF (mix, i, o + b);                                \
+                                                                            \
+          if (m == 0)                                                       \
+            continue;                                                       \
+          for (n = 0; n < len; n++)                                         \
+            acc[b][n] += src[n] * m;                                        \
+        }                                                                   \
+      }                                                                     \
+                                                                            \
+      for (b = 0; b < n_block; b++) {                                       \
+        type *dst = out[o + b] + s;                                         \
+                                                                            \
+        for (n = 0; n < len; n++)                                           \
+          dst[n] = FINISH (acc[b][n]);                                      \
+      }                                                                     \
+    }                                                                       \
+  }                                                                         \
+}
+
+DEFINE_PLANAR_MIXER (int16, gint16, gint32, MIX_COEFF_INT, MIX_FINISH_INT16);
+DEFINE_PLANAR_MIXER (int32, gint32, gint64, MIX_COEFF_INT, MIX_FINISH_INT32);
+DEFINE_PLANAR_MIXER (float, gfloat, gfloat, MIX_COEFF_FLOAT,
+    MIX_FINISH_FLOAT);
+DEFINE_PLANAR_MIXER (double, gdouble, gdouble, MIX_COEFF_FLOAT,
+    MIX_FINISH_FLOAT);
+
+/* interleaved kernel that only uses the non-zero coefficients, the sums
+ * are made in the same order as the dense kernel */
+#define DEFINE_SPARSE_MIXER(name,type,acctype,coeffs,FINISH)                \
+static void                                                                 \
+gst_audio_channel_mixer_mix_##name##_sparse (GstAudioChannelMixer * mix,    \
+    const type * src[], type * dst[], gint samples)                         \
+{                                                                           \
+  gint inchannels = mix->in_channels, outchannels = mix->out_channels;      \
+  gint n, o, k;                                                             \
+  acctype res;                                                              \
+                                                                            \
+  for (n = 0; n < samples; n++) {                                           \
+    const type *in_data = src[0] + n * inchannels;                          \
+    type *out_data = dst[0] + n * outchannels;                              \
+                                                                            \
+    for (o = 0; o < outchannels; o++) {                                     \
+      const gint *idx = mix->sparse_idx + o * inchannels;                   \
+      const gint count = mix->sparse_count[o];                              \
+                                                                            \
+      res = 0;                                                              \
+      for (k = 0; k < count; k++)                                           \
+        res += in_data[idx[k]] *                                            \
+            (acctype) mix->coeffs[o * inchannels + k];                      \
+      out_data[o] = FINISH (res);                                           \
+    }                                                                       \
+  }                                                                         \
+}
+
+DEFINE_SPARSE_MIXER (int16, gint16, gint32, sparse_coeff_int,
+    MIX_FINISH_INT16);
+DEFINE_SPARSE_MIXER (int32, gint32, gint64, sparse_coeff_int,
+    MIX_FINISH_INT32);
+DEFINE_SPARSE_MIXER (float, gfloat, gfloat, sparse_coeff, MIX_FINISH_FLOAT);
+DEFINE_SPARSE_MIXER (double, gdouble, gdouble, sparse_coeff,
+    MIX_FINISH_FLOAT);
+
+/* each output channel is a copy of an input channel or silence */
+#define DEFINE_COPY_MIXER(name,type)                                        \
+static void                                                                 \
+gst_audio_channel_mixer_mix_##name##_copy (GstAudioChannelMixer * mix,      \
+    const type * src[], type * dst[], gint samples)                         \
+{                                                                           \
+  gint inchannels = mix->in_channels, outchannels = mix->out_channels;      \
+  gint n, o;                                                                \
+                                                                            \
+  for (n = 0; n < samples; n++) {                                           \
+    const type *in_data = src[0] + n * inchannels;                          \
+    type *out_data = dst[0] + n * outchannels;                              \
+                                                                            \
+    for (o = 0; o < outchannels; o++) {                                     \
+      gint i = mix->copy_map[o];                                            \
+                                                                            \
+      out_data[o] = i < 0 ? 0 : in_data[i];                                 \
+    }                                                                       \
+  }                                                                         \
+}                                                                           \
+                                                                            \
+static void                                                                 \
+gst_audio_channel_mixer_mix_##name##_copy_planar (GstAudioChannelMixer * mix, \
+    const type * src[], type * dst[], gint samples)                         \
+{                                                                           \
+  gint o;                                                                   \
+                                                                            \
+  for (o = 0; o < mix->out_channels; o++) {                                 \
+    gint i = mix->copy_map[o];                                              \
+                                                                            \
+    if (i < 0)                                                              \
+      memset (dst[o], 0, samples * sizeof (type));                          \
+    else                                                                    \
+      memcpy (dst[o], src[i], samples * sizeof (type));                     \
+  }                                                                         \
+}
+
+DEFINE_COPY_MIXER (int16, gint16);
+DEFINE_COPY_MIXER (int32, gint32);
+DEFINE_COPY_MIXER (float, gfloat);
+DEFINE_COPY_MIXER (double, gdouble);
+
+/* when only one side is non-interleaved, each channel is addressed with a
+ * pointer and a stride */
+#define DEFINE_STRIDED_MIXER(name,type,acctype,COEFF,FINISH)                \
+static void                                                                 \
+gst_audio_channel_mixer_mix_##name##_strided (GstAudioChannelMixer * mix,   \
+    const type * in[], type * out[], gint samples)                          \
+{                                                                           \
+  const type *src[64];                                                      \
+  type *dst[64];                                                            \
+  gint i, o, n, in_stride, out_stride;                                      \
+  acctype res;                                                              \
+                                                                            \
+  if (mix->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {      \
+    for (i = 0; i < mix->in_channels; i++)                                  \
+      src[i] = in[i];                                                       \
+    in_stride = 1;                                                          \
+  } else {                                                                  \
+    for (i = 0; i < mix->in_channels; i++)                                  \
+      src[i] = in[0] + i;                                                   \
+    in_stride = mix->in_channels;                                           \
+  }                                                                         \
+  if (mix->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {     \
+    for (o = 0; o < mix->out_channels; o++)                                 \
+      dst[o] = out[o];                                                      \
+    out_stride = 1;                                                         \
+  } else {                                                                  \
+    for (o = 0; o < mix->out_channels; o++)                                 \
+      dst[o] = out[0] + o;                                                  \
+    out_stride = mix->out_channels;                                         \
+  }                                                                         \
+                                                                            \
+  for (n = 0; n < samples; n++) {                                           \
+    for (o = 0; o < mix->out_channels; o++) {                               \
+      res = 0;                                                              \
+      for (i = 0; i < mix->in_channels; i++)                                \
+        res += src[i][n * in_stride] * (acctype) COEFF (mix, i, o);         \
+      dst[o][n * out_stride] = FINISH (res);                                \
+    }                                                                       \
+  }                                                                         \
+}
+
+DEFINE_STRIDED_MIXER (int16, gint16, gint32, MIX_COEFF_INT, MIX_FINISH_INT16);
+DEFINE_STRIDED_MIXER (int32, gint32, gint64, MIX_COEFF_INT, MIX_FINISH_INT32);
+DEFINE_STRIDED_MIXER (float, gfloat, gfloat, MIX_COEFF_FLOAT,
+    MIX_FINISH_FLOAT);
+DEFINE_STRIDED_MIXER (double, gdouble, gdouble, MIX_COEFF_FLOAT,
+    MIX_FINISH_FLOAT);
+
+#define SET_MIXER_FUNC(mix,name)                                            \
+G_STMT_START {                                                              \
+  gboolean ni_in, ni_out;                                                   \
+                                                                            \
+  ni_in = ! !((mix)->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN); \
+  ni_out = ! !((mix)->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT); \
+  if (ni_in && ni_out) {                                                    \
+    if ((mix)->kind == MIXER_KIND_COPY)                                     \
+      (mix)->func =                                                         \
+          (MixerFunc) gst_audio_channel_mixer_mix_##name##_copy_planar;     \
+    else                                                                    \
+      (mix)->func = (MixerFunc) gst_audio_channel_mixer_mix_##name##_planar; \
+  } else if (ni_in || ni_out) {                                             \
+    (mix)->func = (MixerFunc) gst_audio_channel_mixer_mix_##name##_strided; \
+  } else if ((mix)->kind == MIXER_KIND_COPY) {                              \
+    (mix)->func = (MixerFunc) gst_audio_channel_mixer_mix_##name##_copy;    \
+  } else if ((mix)->kind == MIXER_KIND_SPARSE) {                            \
+    (mix)->func = (MixerFunc) gst_audio_channel_mixer_mix_##name##_sparse;  \
+  } else {                                                                  \
+    (mix)->func = (MixerFunc) gst_audio_channel_mixer_mix_##name;           \
+  }                                                                         \
+} G_STMT_END
+
+static GstAudioChannelMixer *
+gst_audio_channel_mixer_new_internal (GstAudioChannelMixerFlags flags,
+    GstAudioFormat format, gint in_channels,
+    const GstAudioChannelPosition * in_position, gint out_channels,
+    const GstAudioChannelPosition * out_position, const gfloat ** matrix)
+{
+  GstAudioChannelMixer *mix;
+  gint i;
+
+  mix = g_slice_new0 (GstAudioChannelMixer);
+  mix->flags = flags;
+  mix->format = format;
+  mix->in_channels = in_channels;
+  mix->out_channels = out_channels;
+  mix->custom = matrix != NULL;
+
+  if (in_position)
+    for (i = 0; i < in_channels; i++)
+      mix->in_position[i] = in_position[i];
+  if (out_position)
+    for (i = 0; i < out_channels; i++)
+      mix->out_position[i] = out_position[i];
+
+  gst_audio_channel_mixer_setup_matrix (mix, matrix);
+
+  switch (mix->format) {
+    case GST_AUDIO_FORMAT_S16:
+      SET_MIXER_FUNC (mix, int16);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      SET_MIXER_FUNC (mix, int32);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      SET_MIXER_FUNC (mix, float);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      SET_MIXER_FUNC (mix, double);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+  return mix;
+}
+
 /**
  * gst_audio_channel_mixer_new: (skip):
  * @flags: #GstAudioChannelMixerFlags
@@ -826,9 +1194,6 @@ gst_audio_channel_mixer_new (GstAudioChannelMixerFlags flags,
     GstAudioChannelPosition * in_position,
     gint out_channels, GstAudioChannelPosition * out_position)
 {
-  GstAudioChannelMixer *mix;
-  gint i;
-
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S16
       || format == GST_AUDIO_FORMAT_S32
       || format == GST_AUDIO_FORMAT_F32
@@ -836,37 +1201,43 @@ gst_audio_channel_mixer_new (GstAudioChannelMixerFlags flags,
   g_return_val_if_fail (in_channels > 0 && in_channels < 64, NULL);
   g_return_val_if_fail (out_channels > 0 && out_channels < 64, NULL);
 
-  mix = g_slice_new0 (GstAudioChannelMixer);
-  mix->flags = flags;
-  mix->format = format;
-  mix->in_channels = in_channels;
-  mix->out_channels = out_channels;
-
-  for (i = 0; i < in_channels; i++)
-    mix->in_position[i] = in_position[i];
-  for (i = 0; i < out_channels; i++)
-    mix->out_position[i] = out_position[i];
+  return gst_audio_channel_mixer_new_internal (flags, format, in_channels,
+      in_position, out_channels, out_position, NULL);
+}
 
-  gst_audio_channel_mixer_setup_matrix (mix);
+/**
+ * gst_audio_channel_mixer_new_with_matrix: (skip):
+ * @flags: #GstAudioChannelMixerFlags
+ * @format: the format of the samples
+ * @in_channels: number of input channels
+ * @out_channels: number of output channels
+ * @matrix: the coefficients, @out_channels rows of @in_channels
+ *
+ * Create a new channel mixer object that mixes with the coefficients of
+ * @matrix instead of making them from channel positions. The i-th output
+ * channel is the sum of the input channels multiplied by the coefficients
+ * in @matrix[i], like the matrix of #GstAudioDownmixMeta. @matrix is copied.
+ *
+ * Returns: a new #GstAudioChannelMixer object. Free with gst_audio_channel_mixer_free()
+ * after usage.
+ *
+ * Since: 1.10
+ */
+GstAudioChannelMixer *
+gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
+    GstAudioFormat format, gint in_channels, gint out_channels,
+    const gfloat ** matrix)
+{
+  g_return_val_if_fail (format == GST_AUDIO_FORMAT_S16
+      || format == GST_AUDIO_FORMAT_S32
+      || format == GST_AUDIO_FORMAT_F32
+      || format == GST_AUDIO_FORMAT_F64, NULL);
+  g_return_val_if_fail (in_channels > 0 && in_channels < 64, NULL);
+  g_return_val_if_fail (out_channels > 0 && out_channels < 64, NULL);
+  g_return_val_if_fail (matrix != NULL, NULL);
 
-  switch (mix->format) {
-    case GST_AUDIO_FORMAT_S16:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int16;
-      break;
-    case GST_AUDIO_FORMAT_S32:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int32;
-      break;
-    case GST_AUDIO_FORMAT_F32:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_float;
-      break;
-    case GST_AUDIO_FORMAT_F64:
-      mix->func = (MixerFunc) gst_audio_channel_mixer_mix_double;
-      break;
-    default:
-      g_assert_not_reached ();
-      break;
-  }
-  return mix;
+  return gst_audio_channel_mixer_new_internal (flags, format, in_channels,
+      NULL, out_channels, NULL, matrix);
 }
 
 /**
@@ -880,13 +1251,21 @@ gst_audio_channel_mixer_new (GstAudioChannelMixerFlags flags,
 gboolean
 gst_audio_channel_mixer_is_passthrough (GstAudioChannelMixer * mix)
 {
-  gint i;
+  gint i, j;
   guint64 in_mask, out_mask;
 
   /* only NxN matrices can be identities */
   if (mix->in_channels != mix->out_channels)
     return FALSE;
 
+  if (mix->custom) {
+    for (i = 0; i < mix->in_channels; i++)
+      for (j = 0; j < mix->out_channels; j++)
+        if (mix->matrix[i][j] != (i == j ? 1.0 : 0.0))
+          return FALSE;
+    return TRUE;
+  }
+
   /* passthrough for 1->1 channels (MONO and NONE position are the same here) */
   if (mix->in_channels == 1 && mix->out_channels == 1)
     return TRUE;
@@ -923,5 +1302,5 @@ gst_audio_channel_mixer_samples (GstAudioChannelMixer * mix,
   g_return_if_fail (mix != NULL);
   g_return_if_fail (mix->matrix != NULL);
 
-  mix->func (mix, in[0], out[0], samples);
+  mix->func (mix, in, out, samples);
 }
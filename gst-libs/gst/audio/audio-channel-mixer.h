@@ -52,6 +52,13 @@ GstAudioChannelMixer * gst_audio_channel_mixer_new   (GstAudioChannelMixerFlags
                                                       GstAudioChannelPosition *in_position,
                                                       gint out_channels,
                                                       GstAudioChannelPosition *out_position);
+
+GstAudioChannelMixer * gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
+                                                                GstAudioFormat format,
+                                                                gint in_channels,
+                                                                gint out_channels,
+                                                                const gfloat **matrix);
+
 void                   gst_audio_channel_mixer_free  (GstAudioChannelMixer *mix);
 
 /*
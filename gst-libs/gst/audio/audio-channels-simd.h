@@ -0,0 +1,88 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD version of the channel reordering of gst_audio_reorder_channels().
+ * It works on blocks of up to 3 vectors of 16 bytes that contain a whole
+ * number of frames, like 1 frame of 8 channels of 16 bits, 2 frames of 8 or
+ * 6 channels of 32 bits or 4 frames of 6 channels of 16 bits. Each output
+ * vector is made by shuffling the bytes out of every input vector of the
+ * block. It returns the number of frames done, the caller does the
+ * remainder. */
+
+#if defined (__SSSE3__)
+#define HAVE_AUDIO_CHANNELS_SIMD
+#include <tmmintrin.h>
+
+#define REORDER_MAX_VECTORS 3
+
+static gint
+reorder_channels_simd (guint8 * ptr, gint n_frames, gint bps, gint channels,
+    const gint * reorder_map)
+{
+  guint8 shuf[REORDER_MAX_VECTORS][REORDER_MAX_VECTORS][16];
+  gboolean used[REORDER_MAX_VECTORS][REORDER_MAX_VECTORS] = { {FALSE,}, };
+  gint inv_map[64];
+  gint bpf = bps * channels;
+  gint nv, block, frames, i, ov, iv, b;
+
+  /* the smallest number of vectors with a whole number of frames */
+  for (nv = 1; nv <= REORDER_MAX_VECTORS; nv++)
+    if ((nv * 16) % bpf == 0)
+      break;
+  if (nv > REORDER_MAX_VECTORS)
+    return 0;
+
+  block = nv * 16;
+  frames = block / bpf;
+
+  /* the input channel for each output channel */
+  for (i = 0; i < channels; i++)
+    inv_map[reorder_map[i]] = i;
+
+  memset (shuf, 0x80, sizeof (shuf));
+  for (b = 0; b < block; b++) {
+    gint f = b / bpf;
+    gint oc = (b % bpf) / bps;
+    gint ib = f * bpf + inv_map[oc] * bps + (b % bps);
+
+    ov = b / 16;
+    iv = ib / 16;
+    shuf[ov][iv][b % 16] = ib % 16;
+    used[ov][iv] = TRUE;
+  }
+
+  for (i = 0; i + frames <= n_frames; i += frames, ptr += block) {
+    __m128i in[REORDER_MAX_VECTORS], out;
+
+    for (iv = 0; iv < nv; iv++)
+      in[iv] = _mm_loadu_si128 ((const __m128i *) (ptr + iv * 16));
+
+    for (ov = 0; ov < nv; ov++) {
+      out = _mm_setzero_si128 ();
+      for (iv = 0; iv < nv; iv++) {
+        if (used[ov][iv])
+          out = _mm_or_si128 (out, _mm_shuffle_epi8 (in[iv],
+                  _mm_loadu_si128 ((const __m128i *) shuf[ov][iv])));
+      }
+      _mm_storeu_si128 ((__m128i *) (ptr + ov * 16), out);
+    }
+  }
+  return i;
+}
+#endif
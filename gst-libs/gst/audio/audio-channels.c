@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include "audio-channels.h"
+#include "audio-channels-simd.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -222,7 +223,12 @@ gst_audio_reorder_channels (gpointer data, gsize size, GstAudioFormat format,
   ptr = data;
 
   n = size / bpf;
-  for (i = 0; i < n; i++) {
+  i = 0;
+#ifdef HAVE_AUDIO_CHANNELS_SIMD
+  i = reorder_channels_simd (ptr, n, bps, channels, reorder_map);
+  ptr += i * bpf;
+#endif
+  for (; i < n; i++) {
 
     memcpy (tmp, ptr, bpf);
     for (j = 0; j < channels; j++)
@@ -107,6 +107,12 @@ struct _GstAudioConverter
   GstAudioLayout current_layout;
   gint current_channels;
 
+  /* stats */
+  gboolean stats;
+  guint64 n_frames;
+  GstClockTime time;
+  GstClockTime pack_time;
+
   gboolean in_writable;
   gpointer *in_data;
   gsize in_frames;
@@ -174,6 +180,10 @@ struct _AudioChain
 
   gpointer *samples;
   gsize num_samples;
+
+  /* time spent in make_func, including the time of the previous chains */
+  gboolean measure;
+  GstClockTime time;
 };
 
 static AudioChain *
@@ -183,6 +193,7 @@ audio_chain_new (AudioChain * prev, GstAudioConverter * convert)
 
   chain = g_slice_new0 (AudioChain);
   chain->prev = prev;
+  chain->measure = convert->stats;
 
   if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
     chain->inc = 1;
@@ -237,8 +248,16 @@ audio_chain_get_samples (AudioChain * chain, gsize * avail)
 {
   gpointer *res;
 
-  while (!chain->samples)
-    chain->make_func (chain, chain->make_func_data);
+  if (G_UNLIKELY (chain->measure)) {
+    GstClockTime start = gst_util_get_timestamp ();
+
+    while (!chain->samples)
+      chain->make_func (chain, chain->make_func_data);
+    chain->time += gst_util_get_timestamp () - start;
+  } else {
+    while (!chain->samples)
+      chain->make_func (chain, chain->make_func_data);
+  }
 
   res = chain->samples;
   *avail = chain->num_samples;
@@ -258,6 +277,15 @@ get_opt_uint (GstAudioConverter * convert, const gchar * opt, guint def)
 }
 */
 
+static gboolean
+get_opt_bool (GstAudioConverter * convert, const gchar * opt, gboolean def)
+{
+  gboolean res;
+  if (!gst_structure_get_boolean (convert->config, opt, &res))
+    res = def;
+  return res;
+}
+
 static gint
 get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
     gint def)
@@ -268,10 +296,61 @@ get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
   return res;
 }
 
+/* the matrix of the mix-matrix option as m[out_channels][in_channels], or
+ * %NULL when it's not set or doesn't have the right size. Free with
+ * g_free (m[0]) and g_free (m). */
+static gfloat **
+get_opt_mix_matrix (GstAudioConverter * convert)
+{
+  const GValue *value, *row;
+  gint in_channels = convert->in.channels;
+  gint out_channels = convert->out.channels;
+  gfloat **matrix;
+  gint i, j;
+
+  value = gst_structure_get_value (convert->config,
+      GST_AUDIO_CONVERTER_OPT_MIX_MATRIX);
+  if (value == NULL)
+    return NULL;
+
+  if (!GST_VALUE_HOLDS_ARRAY (value)
+      || gst_value_array_get_size (value) != out_channels)
+    goto wrong_size;
+
+  matrix = g_new (gfloat *, out_channels);
+  matrix[0] = g_new (gfloat, out_channels * in_channels);
+  for (i = 0; i < out_channels; i++) {
+    matrix[i] = matrix[0] + i * in_channels;
+
+    row = gst_value_array_get_value (value, i);
+    if (!GST_VALUE_HOLDS_ARRAY (row)
+        || gst_value_array_get_size (row) != in_channels) {
+      g_free (matrix[0]);
+      g_free (matrix);
+      goto wrong_size;
+    }
+    for (j = 0; j < in_channels; j++) {
+      const GValue *coeff = gst_value_array_get_value (row, j);
+
+      matrix[i][j] = G_VALUE_HOLDS_FLOAT (coeff) ?
+          g_value_get_float (coeff) : 0.0;
+    }
+  }
+  return matrix;
+
+wrong_size:
+  {
+    GST_WARNING ("mix matrix is not %d rows of %d coefficients, ignoring",
+        out_channels, in_channels);
+    return NULL;
+  }
+}
+
 #define DEFAULT_OPT_RESAMPLER_METHOD GST_AUDIO_RESAMPLER_METHOD_BLACKMAN_NUTTALL
 #define DEFAULT_OPT_DITHER_METHOD GST_AUDIO_DITHER_NONE
 #define DEFAULT_OPT_NOISE_SHAPING_METHOD GST_AUDIO_NOISE_SHAPING_NONE
 #define DEFAULT_OPT_QUANTIZATION 1
+#define DEFAULT_OPT_STATS FALSE
 
 #define GET_OPT_RESAMPLER_METHOD(c) get_opt_enum(c, \
     GST_AUDIO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_AUDIO_RESAMPLER_METHOD, \
@@ -284,6 +363,8 @@ get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_NOISE_SHAPING_METHOD)
 #define GET_OPT_QUANTIZATION(c) get_opt_uint(c, \
     GST_AUDIO_CONVERTER_OPT_QUANTIZATION, DEFAULT_OPT_QUANTIZATION)
+#define GET_OPT_STATS(c) get_opt_bool(c, \
+    GST_AUDIO_CONVERTER_OPT_STATS, DEFAULT_OPT_STATS)
 
 static gboolean
 copy_config (GQuark field_id, const GValue * value, gpointer user_data)
@@ -636,6 +717,7 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
   GstAudioInfo *in = &convert->in;
   GstAudioInfo *out = &convert->out;
   GstAudioFormat format = convert->current_format;
+  gfloat **matrix;
 
   flags =
       GST_AUDIO_INFO_IS_UNPOSITIONED (in) ?
@@ -643,12 +725,26 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
   flags |=
       GST_AUDIO_INFO_IS_UNPOSITIONED (out) ?
       GST_AUDIO_CHANNEL_MIXER_FLAGS_UNPOSITIONED_OUT : 0;
+  if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    flags |= GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN;
+    flags |= GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
+  }
 
   convert->current_channels = out->channels;
 
-  convert->mix =
-      gst_audio_channel_mixer_new (flags, format, in->channels, in->position,
-      out->channels, out->position);
+  /* a matrix from the configuration, like the one of a downmix meta, takes
+   * the place of the one made from the positions */
+  if ((matrix = get_opt_mix_matrix (convert))) {
+    convert->mix =
+        gst_audio_channel_mixer_new_with_matrix (flags, format, in->channels,
+        out->channels, (const gfloat **) matrix);
+    g_free (matrix[0]);
+    g_free (matrix);
+  } else {
+    convert->mix =
+        gst_audio_channel_mixer_new (flags, format, in->channels, in->position,
+        out->channels, out->position);
+  }
   convert->mix_passthrough =
       gst_audio_channel_mixer_is_passthrough (convert->mix);
   GST_INFO ("mix format %s, passthrough %d, in_channels %d, out_channels %d",
@@ -764,9 +860,14 @@ chain_quantize (GstAudioConverter * convert, AudioChain * prev)
    * the rounding correct */
   if (out_int && out_depth < 32
       && convert->current_format == GST_AUDIO_FORMAT_S32) {
+    GstAudioQuantizeFlags flags = 0;
+
+    if (convert->current_layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+      flags |= GST_AUDIO_QUANTIZE_FLAG_NON_INTERLEAVED;
+
     GST_INFO ("quantize to %d bits, dither %d, ns %d", out_depth, dither, ns);
     convert->quant =
-        gst_audio_quantize_new (dither, ns, 0, convert->current_format,
+        gst_audio_quantize_new (dither, ns, flags, convert->current_format,
         out->channels, 1U << (32 - out_depth));
 
     prev = convert->quant_chain = audio_chain_new (prev, convert);
@@ -875,11 +976,17 @@ converter_generic (GstAudioConverter * convert,
   tmp = audio_chain_get_samples (chain, &produced);
 
   if (!convert->out_default) {
+    GstClockTime start = 0;
+
     GST_LOG ("pack %p, %p %" G_GSIZE_FORMAT, tmp, out, produced);
+    if (G_UNLIKELY (convert->stats))
+      start = gst_util_get_timestamp ();
     /* and pack if needed */
     for (i = 0; i < chain->blocks; i++)
       convert->out.finfo->pack_func (convert->out.finfo, 0, tmp[i], out[i],
           produced * chain->inc);
+    if (G_UNLIKELY (convert->stats))
+      convert->pack_time += gst_util_get_timestamp () - start;
   }
   return TRUE;
 }
@@ -908,6 +1015,10 @@ converter_resample (GstAudioConverter * convert,
  * @config contains extra configuration options, see #GST_VIDEO_CONVERTER_OPT_*
  * parameters for details about the options and values.
  *
+ * @in and @out must have the same layout. Since 1.10, this can also be
+ * #GST_AUDIO_LAYOUT_NON_INTERLEAVED, in which case all processing is done on
+ * the non-interleaved samples.
+ *
  * Returns: a #GstAudioConverter or %NULL if conversion is not possible.
  */
 GstAudioConverter *
@@ -919,7 +1030,6 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
 
   g_return_val_if_fail (in_info != NULL, FALSE);
   g_return_val_if_fail (out_info != NULL, FALSE);
-  g_return_val_if_fail (in_info->layout == GST_AUDIO_LAYOUT_INTERLEAVED, FALSE);
   g_return_val_if_fail (in_info->layout == out_info->layout, FALSE);
 
   if ((GST_AUDIO_INFO_CHANNELS (in_info) != GST_AUDIO_INFO_CHANNELS (out_info))
@@ -940,6 +1050,8 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
 
   GST_INFO ("unitsizes: %d -> %d", in_info->bpf, out_info->bpf);
 
+  convert->stats = GET_OPT_STATS (convert);
+
   /* step 1, unpack */
   prev = chain_unpack (convert);
   /* step 2, optional convert from S32 to F64 for channel mix */
@@ -995,6 +1107,13 @@ gst_audio_converter_free (GstAudioConverter * convert)
 {
   g_return_if_fail (convert != NULL);
 
+  if (convert->stats) {
+    GstStructure *stats = gst_audio_converter_get_stats (convert);
+
+    GST_DEBUG ("converter %p: %" GST_PTR_FORMAT, convert, stats);
+    gst_structure_free (stats);
+  }
+
   if (convert->unpack_chain)
     audio_chain_free (convert->unpack_chain);
   if (convert->convert_in_chain)
@@ -1136,5 +1255,63 @@ gst_audio_converter_samples (GstAudioConverter * convert,
     GST_LOG ("skipping empty buffer");
     return TRUE;
   }
+  if (G_UNLIKELY (convert->stats)) {
+    GstClockTime start = gst_util_get_timestamp ();
+    gboolean res;
+
+    res = convert->convert (convert, flags, in, in_frames, out, out_frames);
+    convert->time += gst_util_get_timestamp () - start;
+    convert->n_frames += in_frames;
+    return res;
+  }
   return convert->convert (convert, flags, in, in_frames, out, out_frames);
 }
+
+/* the time spent in @chain itself */
+static guint64
+chain_time (AudioChain * chain)
+{
+  if (chain == NULL)
+    return 0;
+
+  return chain->time - (chain->prev ? chain->prev->time : 0);
+}
+
+/**
+ * gst_audio_converter_get_stats:
+ * @convert: a #GstAudioConverter
+ *
+ * Get the time @convert spent in each conversion stage. The converter only
+ * measures this when it was made with #GST_AUDIO_CONVERTER_OPT_STATS set to
+ * %TRUE, otherwise all the values are 0.
+ *
+ * The structure has a "frames" field with the number of converted input
+ * frames, a "time" field with the total time spent converting them and the
+ * "unpack-time", "convert-in-time", "mix-time", "resample-time",
+ * "convert-out-time", "quantize-time" and "pack-time" fields with the time
+ * spent in each stage. All times are in nanoseconds as #G_TYPE_UINT64. When
+ * the converter only copies or only resamples the samples, just "frames" and
+ * "time" are updated.
+ *
+ * Returns: (transfer full): a new #GstStructure, free with
+ *     gst_structure_free()
+ *
+ * Since: 1.10
+ */
+GstStructure *
+gst_audio_converter_get_stats (GstAudioConverter * convert)
+{
+  g_return_val_if_fail (convert != NULL, NULL);
+
+  return gst_structure_new ("GstAudioConverterStats",
+      "frames", G_TYPE_UINT64, convert->n_frames,
+      "time", G_TYPE_UINT64, (guint64) convert->time,
+      "unpack-time", G_TYPE_UINT64, chain_time (convert->unpack_chain),
+      "convert-in-time", G_TYPE_UINT64, chain_time (convert->convert_in_chain),
+      "mix-time", G_TYPE_UINT64, chain_time (convert->mix_chain),
+      "resample-time", G_TYPE_UINT64, chain_time (convert->resample_chain),
+      "convert-out-time", G_TYPE_UINT64,
+      chain_time (convert->convert_out_chain),
+      "quantize-time", G_TYPE_UINT64, chain_time (convert->quant_chain),
+      "pack-time", G_TYPE_UINT64, (guint64) convert->pack_time, NULL);
+}
@@ -64,6 +64,29 @@ typedef struct _GstAudioConverter GstAudioConverter;
  */
 #define GST_AUDIO_CONVERTER_OPT_QUANTIZATION   "GstAudioConverter.quantization"
 
+/**
+ * GST_AUDIO_CONVERTER_OPT_MIX_MATRIX:
+ *
+ * #GST_TYPE_ARRAY, The channel mixing matrix to use instead of the one
+ * made from the channel positions. It has a #GST_TYPE_ARRAY of #G_TYPE_FLOAT
+ * coefficients for each output channel, with one coefficient per input
+ * channel, like the matrix of #GstAudioDownmixMeta.
+ * Default is unset.
+ *
+ * Since: 1.10
+ */
+#define GST_AUDIO_CONVERTER_OPT_MIX_MATRIX   "GstAudioConverter.mix-matrix"
+
+/**
+ * GST_AUDIO_CONVERTER_OPT_STATS:
+ *
+ * #G_TYPE_BOOLEAN, measure the time spent in each conversion stage, see
+ * gst_audio_converter_get_stats(). Default %FALSE.
+ *
+ * Since: 1.10
+ */
+#define GST_AUDIO_CONVERTER_OPT_STATS   "GstAudioConverter.stats"
+
 
 /**
  * GstAudioConverterFlags:
@@ -103,6 +126,8 @@ gsize                gst_audio_converter_get_in_frames   (GstAudioConverter *con
 
 gsize                gst_audio_converter_get_max_latency (GstAudioConverter *convert);
 
+GstStructure *       gst_audio_converter_get_stats       (GstAudioConverter *convert);
+
 gboolean             gst_audio_converter_samples         (GstAudioConverter * convert,
                                                           GstAudioConverterFlags flags,
                                                           gpointer in[], gsize in_frames,
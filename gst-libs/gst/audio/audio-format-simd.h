@@ -0,0 +1,132 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the pack and unpack functions of the formats with 3
+ * bytes per sample (24, 20 and 18 bits). They give exactly the same results
+ * as the C loops of MAKE_PACK_UNPACK and return the number of samples done,
+ * the caller does the remainder. */
+
+#if defined (__SSSE3__)
+#define HAVE_AUDIO_FORMAT_SIMD_24
+#include <tmmintrin.h>
+
+/* 16 bytes are loaded or stored for every 4 samples, so the last 2 samples
+ * are left to the caller */
+static gint
+unpack_24_simd (guint32 * d, const guint8 * s, gint length, gint scale,
+    guint32 sign, gboolean be)
+{
+  /* the 3 bytes of a sample in the top of a 32 bit word */
+  const __m128i shuf = be ?
+      _mm_setr_epi8 (-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9) :
+      _mm_setr_epi8 (-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  const __m128i shift = _mm_cvtsi32_si128 (scale - 8);
+  const __m128i flip = _mm_set1_epi32 (sign);
+  gint i;
+
+  for (i = 0; i + 6 <= length; i += 4) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + 3 * i));
+
+    v = _mm_sll_epi32 (_mm_shuffle_epi8 (v, shuf), shift);
+    _mm_storeu_si128 ((__m128i *) (d + i), _mm_xor_si128 (v, flip));
+  }
+  return i;
+}
+
+static gint
+pack_24_simd (guint8 * d, const guint32 * s, gint length, gint scale,
+    guint32 sign, gboolean be)
+{
+  const __m128i shuf = be ?
+      _mm_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+      _mm_setr_epi8 (0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const __m128i shift = _mm_cvtsi32_si128 (scale);
+  const __m128i flip = _mm_set1_epi32 (sign);
+  gint i;
+
+  /* the 4 extra bytes are overwritten by the next samples */
+  for (i = 0; i + 6 <= length; i += 4) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + i));
+
+    v = _mm_srl_epi32 (_mm_xor_si128 (v, flip), shift);
+    _mm_storeu_si128 ((__m128i *) (d + 3 * i), _mm_shuffle_epi8 (v, shuf));
+  }
+  return i;
+}
+
+#elif (defined (__ARM_NEON) || defined (__ARM_NEON__)) && \
+    G_BYTE_ORDER == G_LITTLE_ENDIAN
+#define HAVE_AUDIO_FORMAT_SIMD_24
+#include <arm_neon.h>
+
+static gint
+unpack_24_simd (guint32 * d, const guint8 * s, gint length, gint scale,
+    guint32 sign, gboolean be)
+{
+  const int32x4_t shift = vdupq_n_s32 (scale - 8);
+  const uint32x4_t flip = vdupq_n_u32 (sign);
+  const uint8x8_t zero = vdup_n_u8 (0);
+  gint i;
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    uint8x8x3_t v = vld3_u8 (s + 3 * i);
+    uint8x8_t b0 = v.val[be ? 2 : 0], b2 = v.val[be ? 0 : 2];
+    /* [0, b0] and [b1, b2] combined into [0, b0, b1, b2] */
+    uint16x4x2_t w = vzip_u16 (vreinterpret_u16_u8 (vzip_u8 (zero, b0).val[0]),
+        vreinterpret_u16_u8 (vzip_u8 (v.val[1], b2).val[0]));
+    uint16x4x2_t x = vzip_u16 (vreinterpret_u16_u8 (vzip_u8 (zero, b0).val[1]),
+        vreinterpret_u16_u8 (vzip_u8 (v.val[1], b2).val[1]));
+
+    vst1q_u32 (d + i + 0, veorq_u32 (vshlq_u32 (vreinterpretq_u32_u16
+                (vcombine_u16 (w.val[0], w.val[1])), shift), flip));
+    vst1q_u32 (d + i + 4, veorq_u32 (vshlq_u32 (vreinterpretq_u32_u16
+                (vcombine_u16 (x.val[0], x.val[1])), shift), flip));
+  }
+  return i;
+}
+
+/* the low byte of the 8 words of @a and @b */
+static inline uint8x8_t
+low_bytes_u32 (uint32x4_t a, uint32x4_t b)
+{
+  return vmovn_u16 (vcombine_u16 (vmovn_u32 (a), vmovn_u32 (b)));
+}
+
+static gint
+pack_24_simd (guint8 * d, const guint32 * s, gint length, gint scale,
+    guint32 sign, gboolean be)
+{
+  const int32x4_t shift = vdupq_n_s32 (-scale);
+  const uint32x4_t flip = vdupq_n_u32 (sign);
+  gint i;
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    uint32x4_t a = vshlq_u32 (veorq_u32 (vld1q_u32 (s + i), flip), shift);
+    uint32x4_t b = vshlq_u32 (veorq_u32 (vld1q_u32 (s + i + 4), flip), shift);
+    uint8x8x3_t v;
+
+    v.val[be ? 2 : 0] = low_bytes_u32 (a, b);
+    v.val[1] = low_bytes_u32 (vshrq_n_u32 (a, 8), vshrq_n_u32 (b, 8));
+    v.val[be ? 0 : 2] = low_bytes_u32 (vshrq_n_u32 (a, 16),
+        vshrq_n_u32 (b, 16));
+    vst3_u8 (d + 3 * i, v);
+  }
+  return i;
+}
+#endif
@@ -26,6 +26,7 @@
 #include "audio-format.h"
 
 #include "gstaudiopack.h"
+#include "audio-format-simd.h"
 
 #ifdef HAVE_ORC
 #include <orc/orcfunctions.h>
@@ -158,6 +159,27 @@ MAKE_ORC_PACK_UNPACK (s8, s8_trunc)
 #define WRITE24_TO_BE(p,v) p[2] = v & 0xff; p[1] = (v >> 8) & 0xff; p[0] = (v >> 16) & 0xff
 #define READ24_FROM_LE(p) (p[0] | (p[1] << 8) | (p[2] << 16))
 #define READ24_FROM_BE(p) (p[2] | (p[1] << 8) | (p[0] << 16))
+#define IS_BE(info) (GST_AUDIO_FORMAT_INFO_ENDIANNESS (info) == G_BIG_ENDIAN)
+#ifdef HAVE_AUDIO_FORMAT_SIMD_24
+/* all users of MAKE_PACK_UNPACK have 3 bytes per sample */
+#define UNPACK_SIMD(info, d, s, length, sign, scale)                    \
+G_STMT_START {                                                          \
+  gint n = unpack_24_simd (d, s, length, scale, sign, IS_BE (info));    \
+  d += n;                                                               \
+  s += n * 3;                                                           \
+  length -= n;                                                          \
+} G_STMT_END
+#define PACK_SIMD(info, d, s, length, sign, scale)                      \
+G_STMT_START {                                                          \
+  gint n = pack_24_simd (d, s, length, scale, sign, IS_BE (info));      \
+  d += n * 3;                                                           \
+  s += n;                                                               \
+  length -= n;                                                          \
+} G_STMT_END
+#else
+#define UNPACK_SIMD(info, d, s, length, sign, scale)
+#define PACK_SIMD(info, d, s, length, sign, scale)
+#endif
 #define MAKE_PACK_UNPACK(name, stride, sign, scale, READ_FUNC, WRITE_FUNC)     \
 static void unpack_ ##name (const GstAudioFormatInfo *info,             \
     GstAudioPackFlags flags, gpointer dest,                             \
@@ -165,6 +187,7 @@ static void unpack_ ##name (const GstAudioFormatInfo *info,             \
 {                                                                       \
   guint32 *d = dest;                                                    \
   guint8 *s = data;                                                     \
+  UNPACK_SIMD (info, d, s, length, sign, scale);                        \
   for (;length; length--) {                                             \
     *d++ = (((gint32) READ_FUNC (s)) << scale) ^ (sign);                \
     s += stride;                                                        \
@@ -177,6 +200,7 @@ static void pack_ ##name (const GstAudioFormatInfo *info,               \
   gint32 tmp;                                                           \
   guint32 *s = src;                                                     \
   guint8 *d = data;                                                     \
+  PACK_SIMD (info, d, s, length, sign, scale);                          \
   for (;length; length--) {                                             \
     tmp = (*s++ ^ (sign)) >> scale;                                     \
     WRITE_FUNC (d, tmp);                                                \
@@ -413,15 +437,30 @@ gst_audio_format_build_integer (gboolean sign, gint endianness,
 GstAudioFormat
 gst_audio_format_from_string (const gchar * format)
 {
-  guint i;
+  static gsize names_gonce = 0;
 
   g_return_val_if_fail (format != NULL, GST_AUDIO_FORMAT_UNKNOWN);
 
-  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
-    if (strcmp (GST_AUDIO_FORMAT_INFO_NAME (&formats[i]), format) == 0)
-      return GST_AUDIO_FORMAT_INFO_FORMAT (&formats[i]);
+  /* this is done for every caps that is parsed, use a hashtable instead of
+   * comparing against all the names */
+  if (g_once_init_enter (&names_gonce)) {
+    GHashTable *names;
+    guint i;
+
+    names = g_hash_table_new (g_str_hash, g_str_equal);
+    for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+      const gchar *name = GST_AUDIO_FORMAT_INFO_NAME (&formats[i]);
+
+      if (!g_hash_table_contains (names, name))
+        g_hash_table_insert (names, (gpointer) name,
+            GINT_TO_POINTER (GST_AUDIO_FORMAT_INFO_FORMAT (&formats[i])));
+    }
+    g_once_init_leave (&names_gonce, (gsize) names);
   }
-  return GST_AUDIO_FORMAT_UNKNOWN;
+
+  /* GST_AUDIO_FORMAT_UNKNOWN is 0 */
+  return GPOINTER_TO_INT (g_hash_table_lookup ((GHashTable *) names_gonce,
+          format));
 }
 
 const gchar *
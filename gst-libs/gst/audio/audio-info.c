@@ -49,6 +49,69 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
+/* the names of the caps fields, looking up the quark of a field name takes
+ * the global quark lock so we do this only once */
+static GQuark _quark_audio_x_raw;
+static GQuark _quark_format;
+static GQuark _quark_layout;
+static GQuark _quark_rate;
+static GQuark _quark_channels;
+static GQuark _quark_channel_mask;
+
+static void
+ensure_quarks (void)
+{
+  static gsize quarks_gonce = 0;
+
+  if (g_once_init_enter (&quarks_gonce)) {
+    _quark_audio_x_raw = g_quark_from_static_string ("audio/x-raw");
+    _quark_format = g_quark_from_static_string ("format");
+    _quark_layout = g_quark_from_static_string ("layout");
+    _quark_rate = g_quark_from_static_string ("rate");
+    _quark_channels = g_quark_from_static_string ("channels");
+    _quark_channel_mask = g_quark_from_static_string ("channel-mask");
+
+    g_once_init_leave (&quarks_gonce, 1);
+  }
+}
+
+/* like gst_structure_get_string() and friends but with the field quark */
+static const gchar *
+structure_id_get_string (const GstStructure * structure, GQuark field)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !G_VALUE_HOLDS_STRING (value))
+    return NULL;
+
+  return g_value_get_string (value);
+}
+
+static gboolean
+structure_id_get_int (const GstStructure * structure, GQuark field,
+    gint * result)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !G_VALUE_HOLDS_INT (value))
+    return FALSE;
+
+  *result = g_value_get_int (value);
+  return TRUE;
+}
+
+static gboolean
+structure_id_get_bitmask (const GstStructure * structure, GQuark field,
+    guint64 * result)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !GST_VALUE_HOLDS_BITMASK (value))
+    return FALSE;
+
+  *result = gst_value_get_bitmask (value);
+  return TRUE;
+}
 
 /**
  * gst_audio_info_copy:
@@ -209,19 +272,21 @@ gst_audio_info_from_caps (GstAudioInfo * info, const GstCaps * caps)
 
   flags = 0;
 
+  ensure_quarks ();
+
   str = gst_caps_get_structure (caps, 0);
 
-  if (!gst_structure_has_name (str, "audio/x-raw"))
+  if (gst_structure_get_name_id (str) != _quark_audio_x_raw)
     goto wrong_name;
 
-  if (!(s = gst_structure_get_string (str, "format")))
+  if (!(s = structure_id_get_string (str, _quark_format)))
     goto no_format;
 
   format = gst_audio_format_from_string (s);
   if (format == GST_AUDIO_FORMAT_UNKNOWN)
     goto unknown_format;
 
-  if (!(s = gst_structure_get_string (str, "layout")))
+  if (!(s = structure_id_get_string (str, _quark_layout)))
     goto no_layout;
   if (g_str_equal (s, "interleaved"))
     layout = GST_AUDIO_LAYOUT_INTERLEAVED;
@@ -230,13 +295,13 @@ gst_audio_info_from_caps (GstAudioInfo * info, const GstCaps * caps)
   else
     goto unknown_layout;
 
-  if (!gst_structure_get_int (str, "rate", &rate))
+  if (!structure_id_get_int (str, _quark_rate, &rate))
     goto no_rate;
-  if (!gst_structure_get_int (str, "channels", &channels))
+  if (!structure_id_get_int (str, _quark_channels, &channels))
     goto no_channels;
 
-  if (!gst_structure_get (str, "channel-mask", GST_TYPE_BITMASK, &channel_mask,
-          NULL) || (channel_mask == 0 && channels == 1)) {
+  if (!structure_id_get_bitmask (str, _quark_channel_mask, &channel_mask) ||
+      (channel_mask == 0 && channels == 1)) {
     if (channels == 1) {
       position[0] = GST_AUDIO_CHANNEL_POSITION_MONO;
     } else if (channels == 2) {
@@ -33,6 +33,20 @@
 #include "gstaudiopack.h"
 #include "audio-quantize.h"
 
+#ifndef restrict
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+/* restrict should be available */
+#elif defined(__GNUC__) && __GNUC__ >= 4
+#define restrict __restrict__
+#elif defined(_MSC_VER) &&  _MSC_VER >= 1500
+#define restrict __restrict
+#else
+#define restrict                /* no op */
+#endif
+#endif
+
+#define RANDOM_LANES 8
+
 typedef void (*QuantizeFunc) (GstAudioQuantize * quant, const gpointer src,
     gpointer dst, gint count);
 
@@ -57,6 +71,9 @@ struct _GstAudioQuantize
   /* buffer with dither values */
   guint dither_size;
   gpointer dither_buf;
+  /* scratch buffer for random values and the generator state */
+  gpointer random_buf;
+  guint32 random_state[RANDOM_LANES];
   /* noise shaping coefficients */
   gpointer coeffs;
   gint n_coeffs;
@@ -64,13 +81,13 @@ struct _GstAudioQuantize
   QuantizeFunc quantize;
 };
 
-#define ADDSS(res,val) \
-        if (val > 0 && res > 0 && G_MAXINT32 - res <= val){             \
-          res = G_MAXINT32;                                             \
-        } else if (val < 0 && res < 0 && G_MININT32 - res >= val){      \
-          res = G_MININT32;                                             \
-        } else                                                          \
-          res += val;
+/* saturating add without branches so that loops using it vectorize */
+static inline gint32
+adds32 (gint32 res, gint32 val)
+{
+  gint64 tmp = (gint64) res + val;
+  return (gint32) CLAMP (tmp, G_MININT32, G_MAXINT32);
+}
 
 static void
 gst_audio_quantize_quantize_memcpy (GstAudioQuantize * quant,
@@ -89,27 +106,65 @@ gst_audio_quantize_quantize_int_none_none (GstAudioQuantize * quant,
       samples * quant->stride);
 }
 
-/* This is the base function, implementing a linear congruential generator
- * and returning a pseudo random number between 0 and 2^32 - 1.
- */
+/* Dither noise comes from RANDOM_LANES independent xorshift32 generators
+ * that are stepped in lockstep, so that the inner loops have no dependency
+ * between consecutive samples and can be vectorized by the compiler. Every
+ * quantizer has its own state, seeded from RANDOM_SEED, which makes the
+ * output reproducible for the same input. */
+#define RANDOM_SEED 0xdeadbeef
+
+static void
+gst_audio_quantize_seed_random (GstAudioQuantize * quant)
+{
+  guint32 x = RANDOM_SEED;
+  gint l;
+
+  /* derive the lanes from the seed with a LCG, a zero state would make
+   * the xorshift generator stick at zero */
+  for (l = 0; l < RANDOM_LANES; l++) {
+    do {
+      x = x * 1103515245 + 12345;
+    } while (x == 0);
+    quant->random_state[l] = x;
+  }
+}
+
 static inline guint32
-gst_fast_random_uint32 (void)
+xorshift32 (guint32 x)
 {
-  static guint32 state = 0xdeadbeef;
-  return (state = state * 1103515245 + 12345);
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
 }
 
-static inline gint32
-gst_fast_random_int32 (void)
+/* Fill @r with @len random values */
+static void
+gst_audio_quantize_fill_random (GstAudioQuantize * quant, guint32 * r,
+    gint len)
 {
-  return (gint32) gst_fast_random_uint32 ();
+  guint32 state[RANDOM_LANES];
+  gint i, l;
+
+  memcpy (state, quant->random_state, sizeof (state));
+
+  for (i = 0; i + RANDOM_LANES <= len; i += RANDOM_LANES) {
+    for (l = 0; l < RANDOM_LANES; l++) {
+      state[l] = xorshift32 (state[l]);
+      r[i + l] = state[l];
+    }
+  }
+  for (l = 0; i < len; i++, l++) {
+    state[l] = xorshift32 (state[l]);
+    r[i] = state[l];
+  }
+  memcpy (quant->random_state, state, sizeof (state));
 }
 
-/* Assuming dither == 2^n,
- * returns one of 2^(n+1) possible random values:
- * -dither <= retval < dither */
-#define RANDOM_INT_DITHER(dither)                                       \
-  (- dither + (gst_fast_random_int32 () & ((dither << 1) - 1)))
+/* Assuming dither == 2^n, maps a random value to one of 2^(n+1) possible
+ * values: -dither <= retval < dither */
+#define RANDOM_INT_DITHER(r,dither)                                     \
+  (- dither + (gint32) ((r) & ((dither << 1) - 1)))
 
 static void
 setup_dither_buf (GstAudioQuantize * quant, gint samples)
@@ -118,17 +173,21 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
   gint stride = quant->stride;
   gint i, len = samples * stride;
   guint shift = quant->shift;
-  guint32 bias;
+  guint32 bias, *r;
   gint32 dither, *d;
 
   if (quant->dither_size < len) {
     quant->dither_size = len;
     quant->dither_buf = g_realloc (quant->dither_buf, len * sizeof (gint32));
+    if (quant->dither != GST_AUDIO_DITHER_NONE)
+      quant->random_buf =
+          g_realloc (quant->random_buf, len * sizeof (guint32));
     need_init = TRUE;
   }
 
   bias = quant->bias;
   d = quant->dither_buf;
+  r = quant->random_buf;
 
   switch (quant->dither) {
     case GST_AUDIO_DITHER_NONE:
@@ -140,26 +199,36 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
 
     case GST_AUDIO_DITHER_RPDF:
       dither = 1 << (shift);
+      gst_audio_quantize_fill_random (quant, r, len);
       for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (dither);
+        d[i] = bias + RANDOM_INT_DITHER (r[i], dither);
       break;
 
     case GST_AUDIO_DITHER_TPDF:
       dither = 1 << (shift - 1);
+      gst_audio_quantize_fill_random (quant, r, len);
+      for (i = 0; i < len; i++)
+        d[i] = bias + RANDOM_INT_DITHER (r[i], dither);
+      gst_audio_quantize_fill_random (quant, r, len);
       for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (dither) + RANDOM_INT_DITHER (dither);
+        d[i] += RANDOM_INT_DITHER (r[i], dither);
       break;
 
     case GST_AUDIO_DITHER_TPDF_HF:
     {
-      gint32 tmp, *last_random = quant->last_random;
+      gint32 *last_random = quant->last_random;
+      gint n = MIN (stride, len);
 
       dither = 1 << (shift - 1);
-      for (i = 0; i < len; i++) {
-        tmp = RANDOM_INT_DITHER (dither);
-        d[i] = bias + tmp - last_random[i % stride];
-        last_random[i % stride] = tmp;
-      }
+      gst_audio_quantize_fill_random (quant, r, len);
+      /* the new random values of the previous frame, per channel */
+      for (i = 0; i < n; i++)
+        d[i] = bias + RANDOM_INT_DITHER (r[i], dither) - last_random[i];
+      for (; i < len; i++)
+        d[i] = bias + RANDOM_INT_DITHER (r[i], dither) -
+            RANDOM_INT_DITHER (r[i - stride], dither);
+      for (i = 0; i < n; i++)
+        last_random[i] = RANDOM_INT_DITHER (r[len - n + i], dither);
       break;
     }
   }
@@ -189,38 +258,46 @@ setup_error_buf (GstAudioQuantize * quant, gint samples, gint extra)
   }
 }
 
+/* The error of a channel only depends on the previous errors of that same
+ * channel, the channels of a frame are independent and are processed
+ * together in the inner loops. */
 static void
 gst_audio_quantize_quantize_int_dither_feedback (GstAudioQuantize * quant,
     const gpointer src, gpointer dst, gint samples)
 {
   guint32 mask;
-  gint i, len, stride;
-  const gint32 *s = src;
-  gint32 *dith, *d = dst, v, o, *e, err;
+  gint i, j, stride;
+  const gint32 *s = src, *dith;
+  gint32 *d = dst, *e, v, o;
 
   setup_dither_buf (quant, samples);
   setup_error_buf (quant, samples, 1);
 
   stride = quant->stride;
-  len = samples * stride;
   dith = quant->dither_buf;
   e = quant->error_buf;
   mask = ~quant->mask;
 
-  for (i = 0; i < len; i++) {
-    o = v = s[i];
-    /* add dither */
-    err = dith[i];
-    /* remove error */
-    err -= e[i];
-    ADDSS (v, err);
-    v &= mask;
-    /* store new error */
-    e[i + stride] = e[i] + (v - o);
-    /* store result */
-    d[i] = v;
+  for (i = 0; i < samples; i++) {
+    const gint32 *restrict ep = e;
+    gint32 *restrict en = e + stride;
+
+    for (j = 0; j < stride; j++) {
+      o = s[j];
+      /* add dither and remove error */
+      v = adds32 (o, dith[j] - ep[j]);
+      v &= mask;
+      /* store new error */
+      en[j] = ep[j] + (v - o);
+      /* store result */
+      d[j] = v;
+    }
+    s += stride;
+    d += stride;
+    dith += stride;
+    e += stride;
   }
-  memmove (e, &e[len], sizeof (gint32) * stride);
+  memmove (quant->error_buf, e, sizeof (gint32) * stride);
 }
 
 #define SHIFT 10
@@ -234,9 +311,9 @@ gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
     const gpointer src, gpointer dst, gint samples)
 {
   guint32 mask;
-  gint i, j, k, len, stride, nc;
-  const gint32 *s = src;
-  gint32 *c, *dith, *d = dst, v, o, *e, err;
+  gint i, j, k, stride, nc;
+  const gint32 *s = src, *dith, *c;
+  gint32 *d = dst, *e, v, o, err;
 
   nc = quant->n_coeffs;
 
@@ -244,32 +321,35 @@ gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
   setup_error_buf (quant, samples, nc);
 
   stride = quant->stride;
-  len = samples * stride;
   dith = quant->dither_buf;
   e = quant->error_buf;
   c = quant->coeffs;
   mask = ~quant->mask;
 
-  for (i = 0; i < len; i++) {
-    v = s[i];
-    /* combine and remove error */
-    err = 0;
-    for (j = 0, k = i; j < nc; j++, k += stride)
-      err -= e[k] * c[j];
-    err = (err + SROUND) >> (SREDUCE);
-    ADDSS (v, err);
-    o = v;
-    /* add dither */
-    err = dith[i];
-    ADDSS (v, err);
-    /* quantize */
-    v &= mask;
-    /* store new error with reduced precision */
-    e[k] = (v - o + RROUND) >> REDUCE;
-    /* store result */
-    d[i] = v;
+  for (i = 0; i < samples; i++) {
+    const gint32 *restrict ep = e;
+    gint32 *restrict en = e + nc * stride;
+
+    for (j = 0; j < stride; j++) {
+      /* combine and remove error */
+      err = 0;
+      for (k = 0; k < nc; k++)
+        err -= ep[k * stride + j] * c[k];
+      err = (err + SROUND) >> (SREDUCE);
+      o = adds32 (s[j], err);
+      /* add dither and quantize */
+      v = adds32 (o, dith[j]) & mask;
+      /* store new error with reduced precision */
+      en[j] = (v - o + RROUND) >> REDUCE;
+      /* store result */
+      d[j] = v;
+    }
+    s += stride;
+    d += stride;
+    dith += stride;
+    e += stride;
   }
-  memmove (e, &e[len], sizeof (gint32) * stride * nc);
+  memmove (quant->error_buf, e, sizeof (gint32) * stride * nc);
 }
 
 #define MAKE_QUANTIZE_FUNC_NAME(name)                                   \
@@ -422,7 +502,10 @@ count_power (guint v)
  * performance is achieved when @quantizer is a power of 2.
  *
  * Dithering and noise-shaping can be performed during quantization with
- * the @dither and @ns parameters.
+ * the @dither and @ns parameters. The random generator used for dithering
+ * is private to the quantizer and always starts from the same seed, two
+ * quantizers created with the same parameters produce the same output for
+ * the same input.
  *
  * Returns: a new #GstAudioQuantize. Free with gst_audio_quantize_free().
  */
@@ -458,6 +541,7 @@ gst_audio_quantize_new (GstAudioDitherMethod dither,
   quant->mask = (1U << quant->shift) - 1;
 
   gst_audio_quantize_setup_dither (quant);
+  gst_audio_quantize_seed_random (quant);
   gst_audio_quantize_setup_noise_shaping (quant);
   gst_audio_quantize_setup_quantize_func (quant);
 
@@ -479,6 +563,7 @@ gst_audio_quantize_free (GstAudioQuantize * quant)
   g_free (quant->coeffs);
   g_free (quant->last_random);
   g_free (quant->dither_buf);
+  g_free (quant->random_buf);
 
   g_slice_free (GstAudioQuantize, quant);
 }
@@ -488,7 +573,8 @@ gst_audio_quantize_free (GstAudioQuantize * quant)
  * @quant: a #GstAudioQuantize
  *
  * Reset @quant to the state is was when created, clearing any
- * history it might have.
+ * history it might have. This also reseeds the random generator used
+ * for dithering.
  */
 void
 gst_audio_quantize_reset (GstAudioQuantize * quant)
@@ -496,6 +582,9 @@ gst_audio_quantize_reset (GstAudioQuantize * quant)
   g_free (quant->error_buf);
   quant->error_buf = NULL;
   quant->error_size = 0;
+  if (quant->last_random)
+    memset (quant->last_random, 0, quant->stride * sizeof (gint32));
+  gst_audio_quantize_seed_random (quant);
 }
 
 /**
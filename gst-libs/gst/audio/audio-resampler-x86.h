@@ -17,6 +17,8 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include "gst/gst-cpu-x86-private.h"
+
 #if defined (HAVE_XMMINTRIN_H) && defined(__SSE__)
 #include <xmmintrin.h>
 
@@ -637,6 +639,463 @@ MAKE_RESAMPLE_FUNC (gint32, linear, 1, sse41);
 MAKE_RESAMPLE_FUNC (gint32, cubic, 1, sse41);
 #endif
 
+#if defined (HAVE_IMMINTRIN_H) && defined (GST_CPU_X86_HAVE_TARGET)
+#define HAVE_AVX2_TARGET
+
+#pragma GCC push_options
+#pragma GCC target ("avx2,fma")
+#include <immintrin.h>
+
+static inline gfloat
+hsum_ps_avx2 (__m256 v)
+{
+  __m128 s;
+
+  s = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+  return _mm_cvtss_f32 (s);
+}
+
+static inline gdouble
+hsum_pd_avx2 (__m256d v)
+{
+  __m128d s;
+
+  s = _mm_add_pd (_mm256_castpd256_pd128 (v), _mm256_extractf128_pd (v, 1));
+  s = _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+  return _mm_cvtsd_f64 (s);
+}
+
+static inline gint32
+hsum_epi32_avx2 (__m256i v)
+{
+  __m128i s;
+
+  s = _mm_add_epi32 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (2, 3, 2, 3)));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (1, 1, 1, 1)));
+  return _mm_cvtsi128_si32 (s);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8)
+    sum = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        sum);
+
+  *o = hsum_ps_avx2 (sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2], t;
+  const gfloat *c[2] = {(gfloat*)((gint8*)b + 0*bstride),
+                        (gfloat*)((gint8*)b + 1*bstride)};
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_set1_ps (icoeff[0]), sum[1]);
+  *o = hsum_ps_avx2 (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[4], t;
+  const gfloat *c[4] = {(gfloat*)((gint8*)b + 0*bstride),
+                        (gfloat*)((gint8*)b + 1*bstride),
+                        (gfloat*)((gint8*)b + 2*bstride),
+                        (gfloat*)((gint8*)b + 3*bstride)};
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_set1_ps (icoeff[0]));
+  sum[0] = _mm256_fmadd_ps (sum[1], _mm256_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[2], _mm256_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[3], _mm256_set1_ps (icoeff[3]), sum[0]);
+  *o = hsum_ps_avx2 (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 8) {
+    sum[0] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 0),
+        _mm256_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), sum[1]);
+  }
+  *o = hsum_pd_avx2 (_mm256_add_pd (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2], t;
+  const gdouble *c[2] = {(gdouble*)((gint8*)b + 0*bstride),
+                         (gdouble*)((gint8*)b + 1*bstride)};
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_set1_pd (icoeff[0]), sum[1]);
+  *o = hsum_pd_avx2 (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[4], t;
+  const gdouble *c[4] = {(gdouble*)((gint8*)b + 0*bstride),
+                         (gdouble*)((gint8*)b + 1*bstride),
+                         (gdouble*)((gint8*)b + 2*bstride),
+                         (gdouble*)((gint8*)b + 3*bstride)};
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_set1_pd (icoeff[0]));
+  sum[0] = _mm256_fmadd_pd (sum[1], _mm256_set1_pd (icoeff[1]), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[2], _mm256_set1_pd (icoeff[2]), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[3], _mm256_set1_pd (icoeff[3]), sum[0]);
+  *o = hsum_pd_avx2 (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+/* the integer versions accumulate 16 taps per step and do the final
+ * scaling like the C versions so that the results are the same */
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16)
+    sum = _mm256_add_epi32 (sum,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+
+  res = hsum_epi32_avx2 (sum);
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, -(1 << 15), (1 << 15) - 1);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res, r0, r1;
+  __m256i sum[2], t;
+  const gint16 *c[2] = {(gint16*)((gint8*)b + 0*bstride),
+                        (gint16*)((gint8*)b + 1*bstride)};
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  r0 = (gint16) (hsum_epi32_avx2 (sum[0]) >> PRECISION_S16);
+  r1 = (gint16) (hsum_epi32_avx2 (sum[1]) >> PRECISION_S16);
+
+  res = (r0 - r1) * (gint32) icoeff[0] + (r1 << PRECISION_S16);
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, -(1 << 15), (1 << 15) - 1);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum[4], t;
+  const gint16 *c[4] = {(gint16*)((gint8*)b + 0*bstride),
+                        (gint16*)((gint8*)b + 1*bstride),
+                        (gint16*)((gint8*)b + 2*bstride),
+                        (gint16*)((gint8*)b + 3*bstride)};
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    sum[2] = _mm256_add_epi32 (sum[2], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    sum[3] = _mm256_add_epi32 (sum[3], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  res = (gint32) (gint16) (hsum_epi32_avx2 (sum[0]) >> PRECISION_S16) *
+      (gint32) icoeff[0] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[1]) >> PRECISION_S16) *
+      (gint32) icoeff[1] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[2]) >> PRECISION_S16) *
+      (gint32) icoeff[2] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[3]) >> PRECISION_S16) *
+      (gint32) icoeff[3];
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, -(1 << 15), (1 << 15) - 1);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+static void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2];
+  const gfloat *c[2] = {(gfloat*)((gint8*)a + 0*astride),
+                        (gfloat*)((gint8*)a + 1*astride)};
+
+  f[0] = _mm256_set1_ps (ic[0]);
+  f[1] = _mm256_set1_ps (ic[1]);
+
+  for (i = 0; i < len; i += 8) {
+    _mm256_storeu_ps (o + i, _mm256_fmadd_ps (_mm256_loadu_ps (c[0] + i), f[0],
+            _mm256_mul_ps (_mm256_loadu_ps (c[1] + i), f[1])));
+  }
+}
+
+static void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t[2];
+  const gfloat *c[4] = {(gfloat*)((gint8*)a + 0*astride),
+                        (gfloat*)((gint8*)a + 1*astride),
+                        (gfloat*)((gint8*)a + 2*astride),
+                        (gfloat*)((gint8*)a + 3*astride)};
+
+  f[0] = _mm256_set1_ps (ic[0]);
+  f[1] = _mm256_set1_ps (ic[1]);
+  f[2] = _mm256_set1_ps (ic[2]);
+  f[3] = _mm256_set1_ps (ic[3]);
+
+  for (i = 0; i < len; i += 8) {
+    t[0] = _mm256_fmadd_ps (_mm256_loadu_ps (c[0] + i), f[0],
+        _mm256_mul_ps (_mm256_loadu_ps (c[1] + i), f[1]));
+    t[1] = _mm256_fmadd_ps (_mm256_loadu_ps (c[2] + i), f[2],
+        _mm256_mul_ps (_mm256_loadu_ps (c[3] + i), f[3]));
+    _mm256_storeu_ps (o + i, _mm256_add_ps (t[0], t[1]));
+  }
+}
+
+static void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[2];
+  const gdouble *c[2] = {(gdouble*)((gint8*)a + 0*astride),
+                         (gdouble*)((gint8*)a + 1*astride)};
+
+  f[0] = _mm256_set1_pd (ic[0]);
+  f[1] = _mm256_set1_pd (ic[1]);
+
+  for (i = 0; i < len; i += 4) {
+    _mm256_storeu_pd (o + i, _mm256_fmadd_pd (_mm256_loadu_pd (c[0] + i), f[0],
+            _mm256_mul_pd (_mm256_loadu_pd (c[1] + i), f[1])));
+  }
+}
+
+static void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[4], t[2];
+  const gdouble *c[4] = {(gdouble*)((gint8*)a + 0*astride),
+                         (gdouble*)((gint8*)a + 1*astride),
+                         (gdouble*)((gint8*)a + 2*astride),
+                         (gdouble*)((gint8*)a + 3*astride)};
+
+  f[0] = _mm256_set1_pd (ic[0]);
+  f[1] = _mm256_set1_pd (ic[1]);
+  f[2] = _mm256_set1_pd (ic[2]);
+  f[3] = _mm256_set1_pd (ic[3]);
+
+  for (i = 0; i < len; i += 4) {
+    t[0] = _mm256_fmadd_pd (_mm256_loadu_pd (c[0] + i), f[0],
+        _mm256_mul_pd (_mm256_loadu_pd (c[1] + i), f[1]));
+    t[1] = _mm256_fmadd_pd (_mm256_loadu_pd (c[2] + i), f[2],
+        _mm256_mul_pd (_mm256_loadu_pd (c[3] + i), f[3]));
+    _mm256_storeu_pd (o + i, _mm256_add_pd (t[0], t[1]));
+  }
+}
+
+#pragma GCC pop_options
+
+#if __GNUC__ >= 7
+#define HAVE_AVX512_TARGET
+
+#pragma GCC push_options
+#pragma GCC target ("avx2,fma,avx512f")
+
+/* 16 taps per step, the taps are a multiple of 8 so finish with one
+ * AVX2 step to avoid reading past the end */
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512 sum = _mm512_setzero_ps ();
+  __m256 tail = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16)
+    sum = _mm512_fmadd_ps (_mm512_loadu_ps (a + i), _mm512_loadu_ps (b + i),
+        sum);
+  if (i < len)
+    tail = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        tail);
+
+  *o = _mm512_reduce_add_ps (sum) + hsum_ps_avx2 (tail);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  gfloat r0, r1;
+  __m512 sum[2], t;
+  __m256 tail[2], t2;
+  const gfloat *c[2] = {(gfloat*)((gint8*)b + 0*bstride),
+                        (gfloat*)((gint8*)b + 1*bstride)};
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+  tail[0] = tail[1] = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[1] + i), sum[1]);
+  }
+  if (i < len) {
+    t2 = _mm256_loadu_ps (a + i);
+    tail[0] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[0] + i), tail[0]);
+    tail[1] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[1] + i), tail[1]);
+  }
+  r0 = _mm512_reduce_add_ps (sum[0]) + hsum_ps_avx2 (tail[0]);
+  r1 = _mm512_reduce_add_ps (sum[1]) + hsum_ps_avx2 (tail[1]);
+
+  *o = (r0 - r1) * icoeff[0] + r1;
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0, j;
+  gfloat res = 0.0;
+  __m512 sum[4], t;
+  __m256 tail[4], t2;
+  const gfloat *c[4] = {(gfloat*)((gint8*)b + 0*bstride),
+                        (gfloat*)((gint8*)b + 1*bstride),
+                        (gfloat*)((gint8*)b + 2*bstride),
+                        (gfloat*)((gint8*)b + 3*bstride)};
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+  tail[0] = tail[1] = tail[2] = tail[3] = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[3] + i), sum[3]);
+  }
+  if (i < len) {
+    t2 = _mm256_loadu_ps (a + i);
+    tail[0] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[0] + i), tail[0]);
+    tail[1] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[1] + i), tail[1]);
+    tail[2] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[2] + i), tail[2]);
+    tail[3] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[3] + i), tail[3]);
+  }
+  for (j = 0; j < 4; j++)
+    res += (_mm512_reduce_add_ps (sum[j]) + hsum_ps_avx2 (tail[j])) *
+        icoeff[j];
+
+  *o = res;
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+#pragma GCC pop_options
+#endif /* __GNUC__ >= 7 */
+#endif /* HAVE_IMMINTRIN_H */
+
 static void
 audio_resampler_check_x86 (const gchar *option)
 {
@@ -679,6 +1138,49 @@ audio_resampler_check_x86 (const gchar *option)
     resample_gint32_cubic_1 = resample_gint32_cubic_1_sse41;
 #else
     GST_DEBUG ("SSE41 optimisations not enabled");
+#endif
+  } else if (!strcmp (option, "avx2")) {
+#if defined (HAVE_AVX2_TARGET)
+    GST_DEBUG ("enable AVX2 optimisations");
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+    interpolate_gfloat_linear = interpolate_gfloat_linear_avx2;
+    interpolate_gfloat_cubic = interpolate_gfloat_cubic_avx2;
+
+    resample_gint16_full_1 = resample_gint16_full_1_avx2;
+    resample_gint16_linear_1 = resample_gint16_linear_1_avx2;
+    resample_gint16_cubic_1 = resample_gint16_cubic_1_avx2;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+
+    interpolate_gdouble_linear = interpolate_gdouble_linear_avx2;
+    interpolate_gdouble_cubic = interpolate_gdouble_cubic_avx2;
+#else
+    GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+  } else if (!strcmp (option, "avx512")) {
+#if defined (HAVE_AVX512_TARGET)
+    GST_DEBUG ("enable AVX512 optimisations");
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx512;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx512;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx512;
+#else
+    GST_DEBUG ("AVX512 optimisations not enabled");
 #endif
   }
 }
+
+static void
+audio_resampler_check_x86_cpu (void)
+{
+  GstCpuX86Flags flags = gst_cpu_x86_get_flags ();
+
+  if ((flags & GST_CPU_X86_AVX2) && (flags & GST_CPU_X86_FMA))
+    audio_resampler_check_x86 ("avx2");
+  if (flags & GST_CPU_X86_AVX512F)
+    audio_resampler_check_x86 ("avx512");
+}
@@ -47,6 +47,7 @@
  *   - fixed filter table size with nearest neighbour phase, optionally
  *     using a precomputed tables
  *   - dynamic samplerate changes
+ *   - filter tables shared between resamplers with the same parameters
  *   - x86 and neon optimizations
  */
 typedef void (*ConvertTapsFunc) (gdouble * tmp_taps, gpointer taps,
@@ -58,6 +59,33 @@ typedef void (*ResampleFunc) (GstAudioResampler * resampler, gpointer in[],
 typedef void (*DeinterleaveFunc) (GstAudioResampler * resampler,
     gpointer * sbuf, gpointer in[], gsize in_frames);
 
+/* a read-only table of taps, shared between all resamplers that use the
+ * same parameters. With @phases, the table is a complete filter cache
+ * with one row per phase, else it is the oversampled filter used for
+ * interpolation. */
+typedef struct
+{
+  gint refcount;
+
+  /* key */
+  gboolean phases;
+  GstAudioResamplerMethod method;
+  gint format_index;
+  gint n_taps;
+  gint n_rows;
+  gint oversample;
+  GstAudioResamplerFilterInterpolation filter_interpolation;
+  gdouble cutoff;
+  gdouble kaiser_beta;
+  gdouble b, c;
+  gint lookahead;
+
+  /* data */
+  gpointer mem;
+  gpointer taps;
+  gsize stride;
+} SharedTaps;
+
 #define MEM_ALIGN(m,a) ((gint8 *)((guintptr)((gint8 *)(m) + ((a)-1)) & ~((a)-1)))
 #define ALIGN 16
 #define TAPS_OVERREAD 16
@@ -91,18 +119,20 @@ struct _GstAudioResampler
   /* oversampled main filter table */
   gint oversample;
   gint n_taps;
+  /* the samples of the filter before and after the center */
+  gint history;
+  gint lookahead;
   gpointer taps;
-  gpointer taps_mem;
   gsize taps_stride;
   gint n_phases;
-  gint alloc_taps;
-  gint alloc_phases;
+  SharedTaps *shared_taps;
 
   /* cached taps */
   gpointer *cached_phases;
   gpointer cached_taps;
   gpointer cached_taps_mem;
   gsize cached_taps_stride;
+  SharedTaps *shared_cache;
 
   ConvertTapsFunc convert_taps;
   InterpolateFunc interpolate;
@@ -133,6 +163,14 @@ GST_DEBUG_CATEGORY_STATIC (audio_resampler_debug);
  * #GstAudioResampler is a structure which holds the information
  * required to perform various kinds of resampling filtering.
  *
+ * The channels of a resampler are resampled independently with the same
+ * filter. Many mono streams with the same format and rates can be resampled
+ * in one call by making one resampler with a channel for each stream and
+ * #GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN and
+ * #GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT. The in and out arrays of
+ * gst_audio_resampler_resample() then contain a pointer to the samples of
+ * each stream. The filter is set up once and is shared by all the streams.
+ *
  */
 
 static const gint oversample_qualities[] = {
@@ -190,6 +228,7 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
+#define DEFAULT_OPT_FILTER_LATENCY -1
 
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
@@ -245,6 +284,8 @@ get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
     GST_AUDIO_RESAMPLER_OPT_FILTER_OVERSAMPLE, DEFAULT_OPT_FILTER_OVERSAMPLE)
 #define GET_OPT_MAX_PHASE_ERROR(options) get_opt_double(options, \
     GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR, DEFAULT_OPT_MAX_PHASE_ERROR)
+#define GET_OPT_FILTER_LATENCY(options) get_opt_int(options, \
+    GST_AUDIO_RESAMPLER_OPT_FILTER_LATENCY, DEFAULT_OPT_FILTER_LATENCY)
 
 #include "dbesi0.c"
 #define bessel dbesi0
@@ -376,6 +417,15 @@ static ConvertTapsFunc convert_taps_funcs[] = {
 #define convert_taps_gfloat   convert_taps_funcs[2]
 #define convert_taps_gdouble  convert_taps_funcs[3]
 
+/* the width of the window of the sinc filters around @x. The window covers
+ * the history before the center and the lookahead after it, for a linear
+ * phase filter both are half of the taps. */
+static inline gint
+get_window_width (GstAudioResampler * resampler, gdouble x)
+{
+  return 2 * (x < 0.0 ? resampler->history : resampler->lookahead);
+}
+
 static void
 make_taps (GstAudioResampler * resampler, gdouble * res, gdouble x, gint n_taps)
 {
@@ -401,13 +451,13 @@ make_taps (GstAudioResampler * resampler, gdouble * res, gdouble x, gint n_taps)
       for (i = 0; i < n_taps; i++)
         weight += tmp_taps[i] =
             get_blackman_nuttall_tap (x + i,
-            resampler->n_taps, resampler->cutoff);
+            get_window_width (resampler, x + i), resampler->cutoff);
       break;
 
     case GST_AUDIO_RESAMPLER_METHOD_KAISER:
       for (i = 0; i < n_taps; i++)
         weight += tmp_taps[i] =
-            get_kaiser_tap (x + i, resampler->n_taps,
+            get_kaiser_tap (x + i, get_window_width (resampler, x + i),
             resampler->cutoff, resampler->kaiser_beta);
       break;
   }
@@ -613,7 +663,7 @@ get_taps_##type##_full (GstAudioResampler * resampler,
         gdouble x;                                                              \
         gint n_taps = resampler->n_taps;                                        \
                                                                                 \
-        x = 1.0 - n_taps / 2 - (gdouble) phase / n_phases;                      \
+        x = 1.0 - resampler->history - (gdouble) phase / n_phases;              \
         make_taps (resampler, res, x, n_taps);                                  \
         break;                                                                  \
       }                                                                         \
@@ -658,6 +708,30 @@ GET_TAPS_FULL_FUNC (gint32);
 GET_TAPS_FULL_FUNC (gfloat);
 GET_TAPS_FULL_FUNC (gdouble);
 
+#define FILL_TAPS_CACHE_FUNC(type)                                              \
+static void                                                                     \
+fill_taps_cache_##type (GstAudioResampler * resampler)                          \
+{                                                                               \
+  gint i;                                                                       \
+  type icoeff[4];                                                               \
+                                                                                \
+  for (i = 0; i < resampler->n_phases; i++) {                                   \
+    gint samp_index = 0, samp_phase = i;                                        \
+    get_taps_##type##_full (resampler, &samp_index, &samp_phase, icoeff);       \
+  }                                                                             \
+}
+FILL_TAPS_CACHE_FUNC (gint16);
+FILL_TAPS_CACHE_FUNC (gint32);
+FILL_TAPS_CACHE_FUNC (gfloat);
+FILL_TAPS_CACHE_FUNC (gdouble);
+
+static void (*fill_taps_cache_funcs[]) (GstAudioResampler * resampler) = {
+  fill_taps_cache_gint16,
+  fill_taps_cache_gint32,
+  fill_taps_cache_gfloat,
+  fill_taps_cache_gdouble
+};
+
 #define GET_TAPS_INTERPOLATE_FUNC(type,inter)                   \
 static inline gpointer                                          \
 get_taps_##type##_##inter (GstAudioResampler * resampler,       \
@@ -852,6 +926,10 @@ inner_product_##type##_cubic_1_c (type * o, const type * a,     \
 INNER_PRODUCT_FLOAT_CUBIC_FUNC (gfloat);
 INNER_PRODUCT_FLOAT_CUBIC_FUNC (gdouble);
 
+/* The taps only depend on the position in the input, so we get them once
+ * for each output sample and use them for all channels. With many channels,
+ * like a batch of independent streams in a non-interleaved resampler, the
+ * taps stay in the cache while they are applied to every stream. */
 #define MAKE_RESAMPLE_FUNC(type,inter,channels,arch)                            \
 static void                                                                     \
 resample_ ##type## _ ##inter## _ ##channels## _ ##arch (GstAudioResampler * resampler,      \
@@ -863,30 +941,31 @@ resample_ ##type## _ ##inter## _ ##channels## _ ##arch (GstAudioResampler * resa
   gint blocks = resampler->blocks;                                              \
   gint ostride = resampler->ostride;                                            \
   gint taps_stride = resampler->taps_stride;                                    \
-  gint samp_index = 0;                                                          \
-  gint samp_phase = 0;                                                          \
+  gint samp_index = resampler->samp_index;                                      \
+  gint samp_phase = resampler->samp_phase;                                      \
                                                                                 \
-  for (c = 0; c < blocks; c++) {                                                \
-    type *ip = in[c];                                                           \
-    type *op = ostride == 1 ? out[c] : (type *)out[0] + c;                      \
+  for (di = 0; di < out_len; di++) {                                            \
+    type icoeff[4], *taps;                                                      \
+    gint index = samp_index;                                                    \
                                                                                 \
-    samp_index = resampler->samp_index;                                         \
-    samp_phase = resampler->samp_phase;                                         \
+    taps = get_taps_ ##type##_##inter                                           \
+            (resampler, &samp_index, &samp_phase, icoeff);                      \
                                                                                 \
-    for (di = 0; di < out_len; di++) {                                          \
-      type *ipp, icoeff[4], *taps;                                              \
+    for (c = 0; c < blocks; c++) {                                              \
+      type *ipp = (type *) in[c] + index * channels;                            \
+      type *op = ostride == 1 ? (type *) out[c] + di :                          \
+          (type *) out[0] + di * ostride + c;                                   \
                                                                                 \
-      ipp = &ip[samp_index * channels];                                         \
-                                                                                \
-      taps = get_taps_ ##type##_##inter                                         \
-              (resampler, &samp_index, &samp_phase, icoeff);                    \
       inner_product_ ##type##_##inter##_##channels##_##arch                     \
               (op, ipp, taps, n_taps, icoeff, taps_stride);                     \
-      op += ostride;                                                            \
     }                                                                           \
-    if (in_len > samp_index)                                                    \
+  }                                                                             \
+  if (in_len > samp_index) {                                                    \
+    for (c = 0; c < blocks; c++) {                                              \
+      type *ip = in[c];                                                         \
       memmove (ip, &ip[samp_index * channels],                                  \
           (in_len - samp_index) * sizeof(type) * channels);                     \
+    }                                                                           \
   }                                                                             \
   *consumed = samp_index - resampler->samp_index;                               \
                                                                                 \
@@ -967,6 +1046,15 @@ static ResampleFunc resample_funcs[] = {
 # endif
 #endif
 
+/* the C versions of the functions, before the optimised versions are
+ * selected */
+static ResampleFunc resample_funcs_c[G_N_ELEMENTS (resample_funcs)];
+static InterpolateFunc interpolate_funcs_c[G_N_ELEMENTS (interpolate_funcs)];
+
+/* private option for the unit tests, use the C versions of the functions to
+ * check the optimised versions against */
+#define OPT_C_REFERENCE "GstAudioResampler.c-reference"
+
 static void
 audio_resampler_init (void)
 {
@@ -977,6 +1065,9 @@ audio_resampler_init (void)
     GST_DEBUG_CATEGORY_INIT (audio_resampler_debug, "audio-resampler", 0,
         "audio-resampler object");
 
+    memcpy (resample_funcs_c, resample_funcs, sizeof (resample_funcs));
+    memcpy (interpolate_funcs_c, interpolate_funcs, sizeof (interpolate_funcs));
+
 #if defined HAVE_ORC && !defined DISABLE_ORC
     orc_init ();
     {
@@ -1008,6 +1099,9 @@ audio_resampler_init (void)
         }
       }
     }
+#ifdef CHECK_X86
+    audio_resampler_check_x86_cpu ();
+#endif
 #endif
     g_once_init_leave (&init_gonce, 1);
   }
@@ -1085,26 +1179,139 @@ calculate_kaiser_params (GstAudioResampler * resampler)
       resampler->n_taps, resampler->cutoff);
 }
 
+static GMutex shared_taps_lock;
+static GList *shared_taps_list;
+
+typedef void (*SharedTapsFillFunc) (GstAudioResampler * resampler,
+    SharedTaps * shared);
+
+static gboolean
+shared_taps_equal (const SharedTaps * a, const SharedTaps * b)
+{
+  return a->phases == b->phases && a->method == b->method &&
+      a->format_index == b->format_index && a->n_taps == b->n_taps &&
+      a->n_rows == b->n_rows && a->oversample == b->oversample &&
+      a->filter_interpolation == b->filter_interpolation &&
+      a->cutoff == b->cutoff && a->kaiser_beta == b->kaiser_beta &&
+      a->b == b->b && a->c == b->c && a->lookahead == b->lookahead;
+}
+
 static void
-alloc_taps_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
-    gint n_phases)
+shared_taps_apply (GstAudioResampler * resampler, SharedTaps * shared)
 {
-  if (resampler->alloc_taps >= n_taps && resampler->alloc_phases >= n_phases)
-    return;
+  if (shared->phases) {
+    resampler->cached_phases = shared->mem;
+    resampler->cached_taps = shared->taps;
+    resampler->cached_taps_stride = shared->stride;
+  } else {
+    resampler->taps = shared->taps;
+    resampler->taps_stride = shared->stride;
+  }
+}
 
-  GST_DEBUG ("allocate bps %d n_taps %d n_phases %d", bps, n_taps, n_phases);
+/* with shared_taps_lock, returns a new ref to a table with the same
+ * parameters as @key */
+static SharedTaps *
+shared_taps_find (const SharedTaps * key)
+{
+  GList *walk;
+
+  for (walk = shared_taps_list; walk; walk = g_list_next (walk)) {
+    SharedTaps *shared = walk->data;
+
+    if (shared_taps_equal (shared, key)) {
+      GST_DEBUG ("reuse shared taps %p, n_taps %d n_rows %d", shared,
+          key->n_taps, key->n_rows);
+      shared->refcount++;
+      return shared;
+    }
+  }
+  return NULL;
+}
+
+/* get a table of @n_rows taps for the current parameters of @resampler,
+ * when no other resampler uses the same table, it is allocated and
+ * filled by calling @fill */
+static SharedTaps *
+shared_taps_get (GstAudioResampler * resampler, gboolean phases, gint n_rows,
+    SharedTapsFillFunc fill)
+{
+  SharedTaps key = { 0, }, *shared, *other;
+  gsize phases_size;
+
+  key.phases = phases;
+  key.method = resampler->method;
+  key.format_index = resampler->format_index;
+  key.n_taps = resampler->n_taps;
+  key.n_rows = n_rows;
+  key.oversample = resampler->oversample;
+  key.filter_interpolation = resampler->filter_interpolation;
+  key.cutoff = resampler->cutoff;
+  key.kaiser_beta = resampler->kaiser_beta;
+  key.b = resampler->b;
+  key.c = resampler->c;
+  key.lookahead = resampler->lookahead;
+
+  g_mutex_lock (&shared_taps_lock);
+  shared = shared_taps_find (&key);
+  g_mutex_unlock (&shared_taps_lock);
+
+  if (shared)
+    goto done;
+
+  GST_DEBUG ("make shared taps, bps %d n_taps %d n_rows %d", resampler->bps,
+      key.n_taps, n_rows);
 
   resampler->tmp_taps =
-      g_realloc_n (resampler->tmp_taps, n_taps, sizeof (gdouble));
+      g_realloc_n (resampler->tmp_taps, key.n_taps, sizeof (gdouble));
+
+  shared = g_slice_dup (SharedTaps, &key);
+  shared->refcount = 1;
+  shared->stride =
+      GST_ROUND_UP_32 (resampler->bps * (key.n_taps + TAPS_OVERREAD));
+
+  phases_size = phases ? sizeof (gpointer) * n_rows : 0;
+  shared->mem = g_malloc0 (phases_size + n_rows * shared->stride + ALIGN - 1);
+  shared->taps = MEM_ALIGN ((gint8 *) shared->mem + phases_size, ALIGN);
+
+  /* the table is only ours until it is in the list, fill it without the
+   * lock so that resamplers with other parameters don't wait for it */
+  shared_taps_apply (resampler, shared);
+  fill (resampler, shared);
+
+  g_mutex_lock (&shared_taps_lock);
+  /* another resampler made the same table meanwhile, use that one */
+  if ((other = shared_taps_find (&key)) == NULL)
+    shared_taps_list = g_list_prepend (shared_taps_list, shared);
+  g_mutex_unlock (&shared_taps_lock);
+
+  if (other) {
+    GST_DEBUG ("drop shared taps %p for %p", shared, other);
+    g_free (shared->mem);
+    g_slice_free (SharedTaps, shared);
+    shared = other;
+  }
 
-  resampler->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
+done:
+  shared_taps_apply (resampler, shared);
+
+  return shared;
+}
+
+static void
+shared_taps_unref (SharedTaps * shared)
+{
+  if (shared == NULL)
+    return;
 
-  g_free (resampler->taps_mem);
-  resampler->taps_mem =
-      g_malloc0 (n_phases * resampler->taps_stride + ALIGN - 1);
-  resampler->taps = MEM_ALIGN ((gint8 *) resampler->taps_mem, ALIGN);
-  resampler->alloc_taps = n_taps;
-  resampler->alloc_phases = n_phases;
+  g_mutex_lock (&shared_taps_lock);
+  if (--shared->refcount == 0) {
+    GST_DEBUG ("free shared taps %p", shared);
+    shared_taps_list = g_list_remove (shared_taps_list, shared);
+    g_free (shared->mem);
+    g_slice_free (SharedTaps, shared);
+  }
+  g_mutex_unlock (&shared_taps_lock);
 }
 
 static void
@@ -1130,15 +1337,68 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
   resampler->cached_phases = resampler->cached_taps_mem;
 }
 
+static void
+fill_taps (GstAudioResampler * resampler, SharedTaps * shared)
+{
+  gint i, n_taps = resampler->n_taps, oversample = resampler->oversample;
+  gdouble x;
+  gpointer taps;
+
+  for (i = 0; i < shared->n_rows; i++) {
+    x = -resampler->history + i / (gdouble) oversample;
+    taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
+    make_taps (resampler, taps, x, n_taps);
+  }
+}
+
+static void
+fill_cache (GstAudioResampler * resampler, SharedTaps * shared)
+{
+  fill_taps_cache_funcs[resampler->format_index] (resampler);
+}
+
+static void
+setup_filter_cache (GstAudioResampler * resampler)
+{
+  GST_DEBUG ("setting up filter cache");
+  resampler->n_phases = resampler->out_rate;
+
+  shared_taps_unref (resampler->shared_cache);
+  resampler->shared_cache = NULL;
+
+  if (resampler->flags & GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE) {
+    /* the rate can change all the time, fill a private cache when the
+     * phases are needed */
+    alloc_cache_mem (resampler, resampler->bps, resampler->n_taps,
+        resampler->n_phases);
+  } else {
+    g_free (resampler->cached_taps_mem);
+    resampler->cached_taps_mem = NULL;
+    resampler->shared_cache =
+        shared_taps_get (resampler, TRUE, resampler->n_phases, fill_cache);
+  }
+}
+
 static void
 setup_functions (GstAudioResampler * resampler)
 {
   gint index, fidx;
+  gboolean c_reference = FALSE;
+  ResampleFunc *rfuncs = resample_funcs;
+  InterpolateFunc *ifuncs = interpolate_funcs;
+
+  if (resampler->options &&
+      gst_structure_get_boolean (resampler->options, OPT_C_REFERENCE,
+          &c_reference) && c_reference) {
+    GST_DEBUG ("using the C functions");
+    rfuncs = resample_funcs_c;
+    ifuncs = interpolate_funcs_c;
+  }
 
   index = resampler->format_index;
 
   if (resampler->in_rate == resampler->out_rate)
-    resampler->resample = resample_funcs[index];
+    resampler->resample = rfuncs[index];
   else {
     switch (resampler->filter_interpolation) {
       default:
@@ -1155,7 +1415,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using filter interpolate function %d", index + fidx);
-    resampler->interpolate = interpolate_funcs[index + fidx];
+    resampler->interpolate = ifuncs[index + fidx];
 
     switch (resampler->method) {
       case GST_AUDIO_RESAMPLER_METHOD_NEAREST:
@@ -1176,7 +1436,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using resample function %d", index);
-    resampler->resample = resample_funcs[index];
+    resampler->resample = rfuncs[index];
   }
 }
 
@@ -1225,8 +1485,22 @@ resampler_calculate_taps (GstAudioResampler * resampler)
         gst_util_uint64_scale_int (resampler->n_taps, in_rate, out_rate);
   }
 
+  /* the filter is centered in the taps unless it is asked to use fewer
+   * samples after the center */
+  resampler->history = resampler->lookahead = resampler->n_taps / 2;
+
   if (sinc_table) {
+    gint latency;
+
     resampler->n_taps = GST_ROUND_UP_8 (resampler->n_taps);
+    resampler->history = resampler->lookahead = resampler->n_taps / 2;
+
+    latency = GET_OPT_FILTER_LATENCY (resampler->options);
+    if (latency > 0 && latency < resampler->lookahead) {
+      resampler->lookahead = latency;
+      resampler->history = resampler->n_taps - latency;
+    }
+
     resampler->filter_mode = GET_OPT_FILTER_MODE (resampler->options);
     resampler->filter_threshold =
         GET_OPT_FILTER_MODE_THRESHOLD (resampler->options);
@@ -1265,8 +1539,8 @@ resampler_calculate_taps (GstAudioResampler * resampler)
   n_taps = resampler->n_taps;
   bps = resampler->bps;
 
-  GST_LOG ("using n_taps %d cutoff %f oversample %d", n_taps, resampler->cutoff,
-      oversample);
+  GST_LOG ("using n_taps %d cutoff %f oversample %d lookahead %d", n_taps,
+      resampler->cutoff, oversample, resampler->lookahead);
 
   if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_AUTO) {
     if (out_rate <= oversample
@@ -1293,18 +1567,12 @@ resampler_calculate_taps (GstAudioResampler * resampler)
 
   resampler->filter_interpolation = filter_interpolation;
 
-  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
-      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST) {
-    GST_DEBUG ("setting up filter cache");
-    resampler->n_phases = out_rate;
-    alloc_cache_mem (resampler, bps, n_taps, out_rate);
-  }
+  shared_taps_unref (resampler->shared_taps);
+  resampler->shared_taps = NULL;
 
   if (resampler->filter_interpolation !=
       GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE) {
-    gint i, isize;
-    gdouble x;
-    gpointer taps;
+    gint isize;
 
     switch (resampler->filter_interpolation) {
       default:
@@ -1318,13 +1586,8 @@ resampler_calculate_taps (GstAudioResampler * resampler)
         break;
     }
 
-    alloc_taps_mem (resampler, bps, n_taps, oversample + isize);
-
-    for (i = 0; i < oversample + isize; i++) {
-      x = -(n_taps / 2) + i / (gdouble) oversample;
-      taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
-      make_taps (resampler, taps, x, n_taps);
-    }
+    resampler->shared_taps =
+        shared_taps_get (resampler, FALSE, oversample + isize, fill_taps);
   }
 }
 
@@ -1589,15 +1852,15 @@ gst_audio_resampler_reset (GstAudioResampler * resampler)
     gint c, blocks, bpf;
 
     bpf = resampler->bps * resampler->inc;
-    bytes = (resampler->n_taps / 2) * bpf;
+    bytes = resampler->history * bpf;
     blocks = resampler->blocks;
 
     for (c = 0; c < blocks; c++)
       memset (resampler->sbuf[c], 0, bytes);
   }
-  /* half of the filter is filled with 0 */
+  /* the history of the filter is filled with 0 */
   resampler->samp_index = 0;
-  resampler->samples_avail = resampler->n_taps / 2 - 1;
+  resampler->samples_avail = resampler->history - 1;
 }
 
 /**
@@ -1620,7 +1883,7 @@ gboolean
 gst_audio_resampler_update (GstAudioResampler * resampler,
     gint in_rate, gint out_rate, GstStructure * options)
 {
-  gint gcd, samp_phase, old_n_taps;
+  gint gcd, samp_phase, old_n_taps, old_history;
   gdouble max_error;
 
   g_return_val_if_fail (resampler != NULL, FALSE);
@@ -1684,11 +1947,13 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
     resampler->options = gst_structure_copy (options);
 
     old_n_taps = resampler->n_taps;
+    old_history = resampler->history;
 
     resampler_calculate_taps (resampler);
     resampler_dump (resampler);
 
-    if (old_n_taps > 0 && old_n_taps != resampler->n_taps) {
+    if (old_n_taps > 0 && (old_n_taps != resampler->n_taps ||
+            old_history != resampler->history)) {
       gpointer *sbuf;
       gint i, bpf, bytes, soff, doff, diff;
 
@@ -1698,7 +1963,7 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
       bytes = resampler->samples_avail * bpf;
       soff = doff = resampler->samp_index * bpf;
 
-      diff = ((gint) resampler->n_taps - old_n_taps) / 2;
+      diff = resampler->history - old_history;
 
       GST_DEBUG ("taps %d->%d, %d", old_n_taps, resampler->n_taps, diff);
 
@@ -1719,14 +1984,14 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
 
       resampler->samples_avail += diff;
     }
-  } else if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL) {
-    GST_DEBUG ("setting up filter cache");
-    resampler->n_phases = resampler->out_rate;
-    alloc_cache_mem (resampler, resampler->bps, resampler->n_taps,
-        resampler->n_phases);
   }
   setup_functions (resampler);
 
+  /* the full cache is filled with the functions selected above */
+  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
+      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST)
+    setup_filter_cache (resampler);
+
   return TRUE;
 }
 
@@ -1743,8 +2008,9 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
 {
   g_return_if_fail (resampler != NULL);
 
+  shared_taps_unref (resampler->shared_cache);
+  shared_taps_unref (resampler->shared_taps);
   g_free (resampler->cached_taps_mem);
-  g_free (resampler->taps_mem);
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
@@ -1834,7 +2100,7 @@ gst_audio_resampler_get_max_latency (GstAudioResampler * resampler)
 {
   g_return_val_if_fail (resampler != NULL, 0);
 
-  return resampler->n_taps / 2;
+  return resampler->lookahead;
 }
 
 /**
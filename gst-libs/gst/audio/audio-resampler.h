@@ -153,6 +153,20 @@ typedef enum {
  */
 #define GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR "GstAudioResampler.max-phase-error"
 
+/**
+ * GST_AUDIO_RESAMPLER_OPT_FILTER_LATENCY:
+ *
+ * G_TYPE_INT: the maximum number of input samples after the current one
+ * that the windowed sinc filters use. Smaller values make a low-delay
+ * filter with a window that is longer before the center than after it,
+ * this lowers the latency of the resampler at the expense of a linear
+ * phase response. -1, the default, makes a linear phase filter with a
+ * latency of half the number of taps.
+ *
+ * Since: 1.10
+ */
+#define GST_AUDIO_RESAMPLER_OPT_FILTER_LATENCY "GstAudioResampler.filter-latency"
+
 /**
  * GstAudioResamplerMethod:
  * @GST_AUDIO_RESAMPLER_METHOD_NEAREST: Duplicates the samples when
@@ -34,6 +34,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudiobasesink.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_base_sink_debug);
 #define GST_CAT_DEFAULT gst_audio_base_sink_debug
@@ -74,6 +75,33 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkCustomSlavingCallback custom_slaving_callback;
   gpointer custom_slaving_cb_data;
   GDestroyNotify custom_slaving_cb_notify;
+
+  /* scheduling of the ringbuffer thread */
+  gint realtime_priority;
+  guint64 cpu_affinity;
+
+  /* automatic latency, the times in microseconds the ringbuffer is
+   * configured with or 0 to use the properties, the time of the last
+   * check of the ringbuffer statistics and if the times were made larger
+   * already */
+  gboolean auto_latency;
+  gint64 max_buffer_time;
+  guint64 auto_buffer_time;
+  guint64 auto_latency_time;
+  gint64 auto_last_check;
+  gboolean auto_grown;
+
+  /* adaptive slaving, the resampler and its configuration */
+  GstAudioResampler *adaptive;
+  GstAudioFormat adaptive_format;
+  gint adaptive_channels;
+  gint adaptive_rate;
+  gint adaptive_out_rate;
+  /* integral term of the rate controller, in seconds */
+  gdouble adaptive_integral;
+  /* the resampled samples */
+  gpointer adaptive_data;
+  gsize adaptive_size;
 };
 
 /* BaseAudioSink signals and args */
@@ -104,6 +132,30 @@ enum
  * fix itself, or is a permanent offset */
 #define DEFAULT_DISCONT_WAIT        (1 * GST_SECOND)
 
+/* adaptive slaving runs the resampler at a multiple of the sample rate so
+ * that the rate can be steered in steps of well below 1 ppm */
+#define ADAPTIVE_RATE_SCALE         1000
+/* the maximum rate correction, 0.5% is inaudible and more than any real
+ * clock drifts */
+#define ADAPTIVE_MAX_CORRECTION     0.005
+/* gains of the PI controller, they give a critically damped loop with a
+ * time constant of around 10 seconds so that clock jitter is filtered out */
+#define ADAPTIVE_KP                 0.1414
+#define ADAPTIVE_KI                 0.01
+
+/* don't change the scheduling of the ringbuffer thread */
+#define DEFAULT_REALTIME_PRIORITY   0
+#define DEFAULT_CPU_AFFINITY        0
+
+/* the configured buffer-time and latency-time are used as they are */
+#define DEFAULT_AUTO_LATENCY        FALSE
+#define DEFAULT_MAX_BUFFER_TIME     ((1000 * GST_MSECOND) / GST_USECOND)
+/* how often the ringbuffer statistics are checked in automatic latency mode,
+ * in microseconds */
+#define AUTO_LATENCY_INTERVAL       (500 * G_TIME_SPAN_MILLISECOND)
+/* the buffer time grows by at most this factor in automatic latency mode */
+#define AUTO_LATENCY_MAX_GROWTH     4
+
 enum
 {
   PROP_0,
@@ -116,6 +168,11 @@ enum
   PROP_ALIGNMENT_THRESHOLD,
   PROP_DRIFT_TOLERANCE,
   PROP_DISCONT_WAIT,
+  PROP_REALTIME_PRIORITY,
+  PROP_CPU_AFFINITY,
+  PROP_STATS,
+  PROP_AUTO_LATENCY,
+  PROP_MAX_BUFFER_TIME,
 
   PROP_LAST
 };
@@ -131,6 +188,8 @@ gst_audio_base_sink_slave_method_get_type (void)
     {GST_AUDIO_BASE_SINK_SLAVE_NONE, "GST_AUDIO_BASE_SINK_SLAVE_NONE", "none"},
     {GST_AUDIO_BASE_SINK_SLAVE_CUSTOM, "GST_AUDIO_BASE_SINK_SLAVE_CUSTOM",
         "custom"},
+    {GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE, "GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE",
+        "adaptive"},
     {0, NULL, NULL},
   };
 
@@ -163,6 +222,8 @@ static gboolean gst_audio_base_sink_activate_pull (GstBaseSink * basesink,
     gboolean active);
 static gboolean gst_audio_base_sink_query (GstElement * element, GstQuery *
     query);
+static gboolean gst_audio_base_sink_post_message (GstElement * element,
+    GstMessage * message);
 
 static GstClock *gst_audio_base_sink_provide_clock (GstElement * elem);
 static inline void gst_audio_base_sink_reset_sync (GstAudioBaseSink * sink);
@@ -272,11 +333,88 @@ gst_audio_base_sink_class_init (GstAudioBaseSinkClass * klass)
           G_MAXUINT64 - 1, DEFAULT_DISCONT_WAIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSink:realtime-priority:
+   *
+   * SCHED_FIFO priority for the thread that writes to the device, or 0 to
+   * keep the default scheduling. The priority is limited to RLIMIT_RTPRIO
+   * and only applied when the thread is started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_REALTIME_PRIORITY,
+      g_param_spec_int ("realtime-priority", "Realtime Priority",
+          "SCHED_FIFO priority of the device thread (0 = default scheduling)",
+          0, 99, DEFAULT_REALTIME_PRIORITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:cpu-affinity:
+   *
+   * Bitmask of the CPUs the thread that writes to the device may run on,
+   * or 0 to not pin the thread. Only applied when the thread is started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CPU_AFFINITY,
+      g_param_spec_uint64 ("cpu-affinity", "CPU Affinity",
+          "Mask of CPUs to run the device thread on (0 = any CPU)",
+          0, G_MAXUINT64, DEFAULT_CPU_AFFINITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:stats:
+   *
+   * Statistics of the ringbuffer as returned by
+   * gst_audio_ring_buffer_get_stats(): the number of missed segments and
+   * the latency of the wakeups of the streaming thread.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Ringbuffer statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:auto-latency:
+   *
+   * Start with the configured buffer-time and latency-time and make them
+   * larger once while playing when the device misses segments. The buffer
+   * time is made large enough for the worst wakeup latency of the streaming
+   * thread, at least doubled and at most 4 times larger, up to
+   * max-buffer-time. The latency time is doubled when the wakeups were late
+   * by more than half a segment. The ringbuffer is then configured again,
+   * which is a short glitch, and a latency message is posted. The times go
+   * back to the configured ones in the READY state.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_AUTO_LATENCY,
+      g_param_spec_boolean ("auto-latency", "Automatic Latency",
+          "Increase the buffer and latency time when the device misses data",
+          DEFAULT_AUTO_LATENCY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:max-buffer-time:
+   *
+   * The largest buffer time in microseconds that auto-latency can use.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BUFFER_TIME,
+      g_param_spec_int64 ("max-buffer-time", "Maximum Buffer Time",
+          "Largest buffer time in microseconds for auto-latency", 1,
+          G_MAXINT64, DEFAULT_MAX_BUFFER_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_sink_change_state);
   gstelement_class->provide_clock =
       GST_DEBUG_FUNCPTR (gst_audio_base_sink_provide_clock);
   gstelement_class->query = GST_DEBUG_FUNCPTR (gst_audio_base_sink_query);
+  gstelement_class->post_message =
+      GST_DEBUG_FUNCPTR (gst_audio_base_sink_post_message);
 
   gstbasesink_class->fixate = GST_DEBUG_FUNCPTR (gst_audio_base_sink_fixate);
   gstbasesink_class->set_caps = GST_DEBUG_FUNCPTR (gst_audio_base_sink_setcaps);
@@ -314,6 +452,10 @@ gst_audio_base_sink_init (GstAudioBaseSink * audiobasesink)
   audiobasesink->priv->custom_slaving_callback = NULL;
   audiobasesink->priv->custom_slaving_cb_data = NULL;
   audiobasesink->priv->custom_slaving_cb_notify = NULL;
+  audiobasesink->priv->realtime_priority = DEFAULT_REALTIME_PRIORITY;
+  audiobasesink->priv->cpu_affinity = DEFAULT_CPU_AFFINITY;
+  audiobasesink->priv->auto_latency = DEFAULT_AUTO_LATENCY;
+  audiobasesink->priv->max_buffer_time = DEFAULT_MAX_BUFFER_TIME;
 
   audiobasesink->provided_clock = gst_audio_clock_new ("GstAudioSinkClock",
       (GstAudioClockGetTimeFunc) gst_audio_base_sink_get_time, audiobasesink,
@@ -351,6 +493,14 @@ gst_audio_base_sink_dispose (GObject * object)
     sink->ringbuffer = NULL;
   }
 
+  if (sink->priv->adaptive) {
+    gst_audio_resampler_free (sink->priv->adaptive);
+    sink->priv->adaptive = NULL;
+  }
+  g_free (sink->priv->adaptive_data);
+  sink->priv->adaptive_data = NULL;
+  sink->priv->adaptive_size = 0;
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -548,6 +698,17 @@ gst_audio_base_sink_get_time (GstClock * clock, GstAudioBaseSink * sink)
   if ((rate = ringbuffer->spec.info.rate) == 0)
     return GST_CLOCK_TIME_NONE;
 
+  /* the position published by the device thread, when there is one, this
+   * doesn't need to call into the device */
+  if (gst_audio_ring_buffer_samples_played (ringbuffer, &samples)) {
+    result = gst_util_uint64_scale_int (samples, GST_SECOND, rate);
+
+    GST_DEBUG_OBJECT (sink, "played samples %" G_GUINT64_FORMAT ", time %"
+        GST_TIME_FORMAT, samples, GST_TIME_ARGS (result));
+
+    return result;
+  }
+
   /* our processed samples are always increasing */
   raw = samples = gst_audio_ring_buffer_samples_done (ringbuffer);
 
@@ -879,6 +1040,26 @@ gst_audio_base_sink_set_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       gst_audio_base_sink_set_discont_wait (sink, g_value_get_uint64 (value));
       break;
+    case PROP_REALTIME_PRIORITY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->realtime_priority = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->cpu_affinity = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_AUTO_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->auto_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_MAX_BUFFER_TIME:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->max_buffer_time = g_value_get_int64 (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -919,31 +1100,86 @@ gst_audio_base_sink_get_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       g_value_set_uint64 (value, gst_audio_base_sink_get_discont_wait (sink));
       break;
+    case PROP_REALTIME_PRIORITY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_int (value, sink->priv->realtime_priority);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_uint64 (value, sink->priv->cpu_affinity);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_AUTO_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_boolean (value, sink->priv->auto_latency);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_MAX_BUFFER_TIME:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_int64 (value, sink->priv->max_buffer_time);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_STATS:
+    {
+      GstAudioRingBuffer *ringbuffer = NULL;
+
+      GST_OBJECT_LOCK (sink);
+      if (sink->ringbuffer)
+        ringbuffer = gst_object_ref (sink->ringbuffer);
+      GST_OBJECT_UNLOCK (sink);
+
+      if (ringbuffer) {
+        g_value_take_boxed (value, gst_audio_ring_buffer_get_stats (ringbuffer));
+        gst_object_unref (ringbuffer);
+      } else {
+        g_value_set_boxed (value, NULL);
+      }
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+/* the ringbuffer thread posts its ENTER stream status from the thread
+ * itself, configure its scheduling here */
 static gboolean
-gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
+gst_audio_base_sink_post_message (GstElement * element, GstMessage * message)
 {
-  GstAudioBaseSink *sink = GST_AUDIO_BASE_SINK (bsink);
-  GstAudioRingBufferSpec *spec;
-  GstClockTime now, internal_time;
-  GstClockTime crate_num, crate_denom;
+  GstAudioBaseSink *sink = GST_AUDIO_BASE_SINK (element);
 
-  if (!sink->ringbuffer)
-    return FALSE;
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_STREAM_STATUS &&
+      GST_MESSAGE_SRC (message) == GST_OBJECT_CAST (sink->ringbuffer)) {
+    GstStreamStatusType type;
+    gint priority;
+    guint64 cpu_affinity;
 
-  spec = &sink->ringbuffer->spec;
+    gst_message_parse_stream_status (message, &type, NULL);
 
-  if (G_UNLIKELY (spec->caps && gst_caps_is_equal (spec->caps, caps))) {
-    GST_DEBUG_OBJECT (sink,
-        "Ringbuffer caps haven't changed, skipping reconfiguration");
-    return TRUE;
+    GST_OBJECT_LOCK (sink);
+    priority = sink->priv->realtime_priority;
+    cpu_affinity = sink->priv->cpu_affinity;
+    GST_OBJECT_UNLOCK (sink);
+
+    if (type == GST_STREAM_STATUS_TYPE_ENTER && (priority || cpu_affinity))
+      __gst_audio_set_thread_priority (GST_OBJECT_CAST (sink), priority,
+          cpu_affinity);
   }
 
+  return GST_ELEMENT_CLASS (parent_class)->post_message (element, message);
+}
+
+/* (re)configure the ringbuffer for @caps and the buffer and latency time */
+static gboolean
+gst_audio_base_sink_configure (GstAudioBaseSink * sink, GstCaps * caps)
+{
+  GstBaseSink *bsink = GST_BASE_SINK_CAST (sink);
+  GstAudioRingBufferSpec *spec = &sink->ringbuffer->spec;
+  GstClockTime now, internal_time;
+  GstClockTime crate_num, crate_denom;
+
   GST_DEBUG_OBJECT (sink, "release old ringbuffer");
 
   /* get current time, updates the last_time. When the subclass has a clock that
@@ -962,8 +1198,13 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
 
   GST_DEBUG_OBJECT (sink, "parse caps");
 
-  spec->buffer_time = sink->buffer_time;
-  spec->latency_time = sink->latency_time;
+  if (sink->priv->auto_buffer_time > 0) {
+    spec->buffer_time = sink->priv->auto_buffer_time;
+    spec->latency_time = sink->priv->auto_latency_time;
+  } else {
+    spec->buffer_time = sink->buffer_time;
+    spec->latency_time = sink->latency_time;
+  }
 
   /* parse new caps */
   if (!gst_audio_ring_buffer_parse_caps (spec, caps))
@@ -1026,6 +1267,105 @@ acquire_error:
   }
 }
 
+static gboolean
+gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
+{
+  GstAudioBaseSink *sink = GST_AUDIO_BASE_SINK (bsink);
+  GstAudioRingBufferSpec *spec;
+
+  if (!sink->ringbuffer)
+    return FALSE;
+
+  spec = &sink->ringbuffer->spec;
+
+  if (G_UNLIKELY (spec->caps && gst_caps_is_equal (spec->caps, caps))) {
+    GST_DEBUG_OBJECT (sink,
+        "Ringbuffer caps haven't changed, skipping reconfiguration");
+    return TRUE;
+  }
+
+  return gst_audio_base_sink_configure (sink, caps);
+}
+
+/* In automatic latency mode, check the statistics of the ringbuffer and make
+ * the buffer time larger when segments were missed since it was configured,
+ * and the latency time larger when the streaming thread is woken up too
+ * late for the size of the segments. Configuring the ringbuffer again drops
+ * the queued samples and can make the device miss segments itself, so this
+ * is done in one step, only once until the next READY to PAUSED. Called
+ * from the streaming thread. */
+static void
+gst_audio_base_sink_check_auto_latency (GstAudioBaseSink * sink)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  GstAudioRingBufferSpec *spec = &sink->ringbuffer->spec;
+  GstStructure *stats;
+  guint missed;
+  guint64 max_wake, buffer_time, latency_time;
+  gint64 now, max_buffer_time;
+  gboolean enabled;
+  GstCaps *caps;
+
+  GST_OBJECT_LOCK (sink);
+  enabled = priv->auto_latency;
+  max_buffer_time = priv->max_buffer_time;
+  GST_OBJECT_UNLOCK (sink);
+
+  if (!enabled || priv->auto_grown || spec->caps == NULL)
+    return;
+
+  now = g_get_monotonic_time ();
+  if (now - priv->auto_last_check < AUTO_LATENCY_INTERVAL)
+    return;
+  priv->auto_last_check = now;
+
+  /* the statistics are reset when the ringbuffer is acquired */
+  stats = gst_audio_ring_buffer_get_stats (sink->ringbuffer);
+  gst_structure_get (stats, "missed-segments", G_TYPE_UINT, &missed,
+      "max-wake-latency", G_TYPE_UINT64, &max_wake, NULL);
+  gst_structure_free (stats);
+
+  if (missed == 0)
+    return;
+
+  /* we don't check again, also when we are at the maximum already */
+  priv->auto_grown = TRUE;
+
+  latency_time = spec->latency_time;
+  if (max_wake > latency_time * GST_USECOND / 2)
+    latency_time *= 2;
+  /* the ringbuffer has to cover a wakeup with the worst latency and the
+   * segment that is written after it */
+  buffer_time = 2 * (max_wake / GST_USECOND) + latency_time;
+  buffer_time = CLAMP (buffer_time, spec->buffer_time * 2,
+      spec->buffer_time * AUTO_LATENCY_MAX_GROWTH);
+  buffer_time = MIN (buffer_time, (guint64) max_buffer_time);
+  /* keep at least 2 segments */
+  latency_time = MIN (latency_time, buffer_time / 2);
+
+  if (buffer_time <= spec->buffer_time && latency_time <= spec->latency_time) {
+    GST_DEBUG_OBJECT (sink, "%u missed segments, but already at the maximum "
+        "buffer time", missed);
+    return;
+  }
+
+  GST_INFO_OBJECT (sink, "%u missed segments, max wake latency %"
+      GST_TIME_FORMAT ", buffer time %" G_GUINT64_FORMAT " -> %"
+      G_GUINT64_FORMAT ", latency time %" G_GUINT64_FORMAT " -> %"
+      G_GUINT64_FORMAT, missed,
+      GST_TIME_ARGS (max_wake), spec->buffer_time, buffer_time,
+      spec->latency_time, latency_time);
+
+  priv->auto_buffer_time = buffer_time;
+  priv->auto_latency_time = latency_time;
+
+  /* releasing the ringbuffer clears the caps of the spec. This posts the
+   * latency message for the new times */
+  caps = gst_caps_ref (spec->caps);
+  gst_audio_base_sink_configure (sink, caps);
+  gst_caps_unref (caps);
+}
+
 static GstCaps *
 gst_audio_base_sink_fixate (GstBaseSink * bsink, GstCaps * caps)
 {
@@ -1545,6 +1885,194 @@ gst_audio_base_sink_skew_slaving (GstAudioBaseSink * sink,
   *srender_stop = render_stop;
 }
 
+/* check if we can do adaptive slaving for the current format and make sure
+ * we have a resampler for it */
+static gboolean
+gst_audio_base_sink_adaptive_prepare (GstAudioBaseSink * sink)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  GstAudioRingBufferSpec *spec = &sink->ringbuffer->spec;
+  GstAudioFormat format;
+  gint channels, rate;
+  GstStructure *options;
+
+  /* the resampler only knows about native raw samples and can't do reverse
+   * playback or trick modes */
+  if (spec->type != GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW ||
+      GST_BASE_SINK_CAST (sink)->segment.rate != 1.0 ||
+      GST_AUDIO_INFO_LAYOUT (&spec->info) != GST_AUDIO_LAYOUT_INTERLEAVED)
+    return FALSE;
+
+  format = GST_AUDIO_INFO_FORMAT (&spec->info);
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+    case GST_AUDIO_FORMAT_S32:
+    case GST_AUDIO_FORMAT_F32:
+    case GST_AUDIO_FORMAT_F64:
+      break;
+    default:
+      return FALSE;
+  }
+  channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
+  rate = GST_AUDIO_INFO_RATE (&spec->info);
+
+  if (priv->adaptive && priv->adaptive_format == format &&
+      priv->adaptive_channels == channels && priv->adaptive_rate == rate)
+    return TRUE;
+
+  if (priv->adaptive)
+    gst_audio_resampler_free (priv->adaptive);
+
+  GST_DEBUG_OBJECT (sink, "making adaptive resampler for %s, %d channels, "
+      "%d Hz", gst_audio_format_to_string (format), channels, rate);
+
+  /* always interpolate the filter, a full table would need a phase for each
+   * of the scaled output samples */
+  options = gst_structure_new_empty ("resampler");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, rate, rate, options);
+  gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED, NULL);
+
+  priv->adaptive_out_rate = rate * ADAPTIVE_RATE_SCALE;
+  priv->adaptive = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE, format, channels,
+      priv->adaptive_out_rate, priv->adaptive_out_rate, options);
+  gst_structure_free (options);
+
+  if (priv->adaptive == NULL)
+    return FALSE;
+
+  priv->adaptive_format = format;
+  priv->adaptive_channels = channels;
+  priv->adaptive_rate = rate;
+  priv->adaptive_integral = 0.0;
+
+  return TRUE;
+}
+
+/* start again at the nominal rate */
+static void
+gst_audio_base_sink_adaptive_reset (GstAudioBaseSink * sink)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  gint rate = priv->adaptive_rate * ADAPTIVE_RATE_SCALE;
+
+  GST_DEBUG_OBJECT (sink, "resetting adaptive resampler");
+
+  gst_audio_resampler_reset (priv->adaptive);
+  if (priv->adaptive_out_rate != rate) {
+    gst_audio_resampler_update (priv->adaptive, rate, rate, NULL);
+    priv->adaptive_out_rate = rate;
+  }
+  priv->adaptive_integral = 0.0;
+}
+
+/* feed the phase error between where the clocks want the samples and where
+ * we are writing them to the PI controller and steer the resampler with it.
+ * Returns FALSE when the error is too big to correct smoothly. */
+static gboolean
+gst_audio_base_sink_adaptive_update (GstAudioBaseSink * sink,
+    GstClockTime sample_offset, guint samples)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  gint64 error, max_error;
+  gdouble err, dt, correction;
+  gint in_rate, out_rate;
+
+  /* the resampler still holds back its latency worth of samples that
+   * belong before sample_offset */
+  error = (gint64) sample_offset - (gint64) sink->next_sample -
+      (gint64) gst_audio_resampler_get_max_latency (priv->adaptive);
+  max_error = gst_util_uint64_scale_int (priv->alignment_threshold,
+      priv->adaptive_rate, GST_SECOND);
+
+  if (ABS (error) > max_error) {
+    GST_WARNING_OBJECT (sink, "phase error of %" G_GINT64_FORMAT
+        " samples is too big, resyncing", error);
+    gst_audio_base_sink_custom_cb_report_discont (sink,
+        GST_AUDIO_BASE_SINK_DISCONT_REASON_ALIGNMENT);
+    return FALSE;
+  }
+
+  /* positive errors mean that we write too early and need to make more
+   * samples */
+  err = (gdouble) error / priv->adaptive_rate;
+  dt = (gdouble) samples / priv->adaptive_rate;
+
+  priv->adaptive_integral += err * dt;
+  /* don't wind up beyond what the controller can correct */
+  priv->adaptive_integral = CLAMP (priv->adaptive_integral,
+      -ADAPTIVE_MAX_CORRECTION / ADAPTIVE_KI,
+      ADAPTIVE_MAX_CORRECTION / ADAPTIVE_KI);
+
+  correction = ADAPTIVE_KP * err + ADAPTIVE_KI * priv->adaptive_integral;
+  correction = CLAMP (correction, -ADAPTIVE_MAX_CORRECTION,
+      ADAPTIVE_MAX_CORRECTION);
+
+  in_rate = priv->adaptive_rate * ADAPTIVE_RATE_SCALE;
+  out_rate = in_rate + (gint) (in_rate * correction);
+
+  GST_LOG_OBJECT (sink, "phase error %" G_GINT64_FORMAT " samples, "
+      "correction %f ppm", error, correction * 1000000.0);
+
+  if (out_rate != priv->adaptive_out_rate) {
+    gst_audio_resampler_update (priv->adaptive, in_rate, out_rate, NULL);
+    priv->adaptive_out_rate = out_rate;
+  }
+  return TRUE;
+}
+
+/* like skew slaving, convert the times to where the clocks currently want
+ * the samples but leave the actual corrections to the resampler */
+static void
+gst_audio_base_sink_adaptive_slaving (GstAudioBaseSink * sink,
+    GstClockTime render_start, GstClockTime render_stop,
+    GstClockTime * srender_start, GstClockTime * srender_stop)
+{
+  GstClockTime cinternal, cexternal, crate_num, crate_denom;
+  GstClockTime etime, itime;
+  GstClockTimeDiff skew;
+
+  /* get calibration parameters to compensate for offsets */
+  gst_clock_get_calibration (sink->provided_clock, &cinternal, &cexternal,
+      &crate_num, &crate_denom);
+
+  /* sample clocks and figure out clock skew */
+  etime = gst_clock_get_time (GST_ELEMENT_CLOCK (sink));
+  itime = gst_audio_clock_get_time (sink->provided_clock);
+  itime = gst_audio_clock_adjust (sink->provided_clock, itime);
+
+  /* make sure we never go below 0 */
+  etime = etime > cexternal ? etime - cexternal : 0;
+  itime = itime > cinternal ? itime - cinternal : 0;
+
+  /* positive value means external clock goes slower */
+  skew = GST_CLOCK_DIFF (etime, itime);
+
+  GST_DEBUG_OBJECT (sink, "internal %" GST_TIME_FORMAT " external %"
+      GST_TIME_FORMAT " skew %" GST_STIME_FORMAT, GST_TIME_ARGS (itime),
+      GST_TIME_ARGS (etime), GST_STIME_ARGS (skew));
+
+  /* convert, ignoring speed, and move to where the skewed clock is */
+  render_start = clock_convert_external (render_start, cinternal, cexternal,
+      crate_num, crate_denom);
+  render_stop = clock_convert_external (render_stop, cinternal, cexternal,
+      crate_num, crate_denom);
+
+  if (skew < 0) {
+    render_start = render_start > -skew ? render_start + skew : 0;
+    render_stop = render_stop > -skew ? render_stop + skew : 0;
+  } else {
+    render_start += skew;
+    render_stop += skew;
+  }
+
+  *srender_start = render_start;
+  *srender_stop = render_stop;
+}
+
 /* apply the clock offset but do no slaving otherwise */
 static void
 gst_audio_base_sink_none_slaving (GstAudioBaseSink * sink,
@@ -1590,6 +2118,15 @@ gst_audio_base_sink_handle_slaving (GstAudioBaseSink * sink,
       gst_audio_base_sink_custom_slaving (sink, render_start, render_stop,
           srender_start, srender_stop);
       break;
+    case GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE:
+      /* fall back to skewing when we can't resample the format */
+      if (gst_audio_base_sink_adaptive_prepare (sink))
+        gst_audio_base_sink_adaptive_slaving (sink, render_start, render_stop,
+            srender_start, srender_stop);
+      else
+        gst_audio_base_sink_skew_slaving (sink, render_start, render_stop,
+            srender_start, srender_stop);
+      break;
     default:
       g_warning ("unknown slaving method %d", sink->priv->slave_method);
       break;
@@ -1707,6 +2244,7 @@ gst_audio_base_sink_sync_latency (GstBaseSink * bsink, GstMiniObject * obj)
     case GST_AUDIO_BASE_SINK_SLAVE_SKEW:
     case GST_AUDIO_BASE_SINK_SLAVE_NONE:
     case GST_AUDIO_BASE_SINK_SLAVE_CUSTOM:
+    case GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE:
     default:
       break;
   }
@@ -1826,6 +2364,7 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   guint64 ctime, cstop;
   gsize offset;
   GstMapInfo info;
+  guint8 *data;
   gsize size;
   guint samples, written;
   gint bpf, rate;
@@ -1833,7 +2372,7 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   gint out_samples;
   GstClockTime base_time, render_delay, latency;
   GstClock *clock;
-  gboolean sync, slaved, align_next;
+  gboolean sync, slaved, align_next, adaptive = FALSE;
   GstFlowReturn ret;
   GstSegment clip_seg;
   gint64 time_offset;
@@ -1844,6 +2383,9 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 
   ringbuf = sink->ringbuffer;
 
+  /* this can configure the ringbuffer again */
+  gst_audio_base_sink_check_auto_latency (sink);
+
   /* can't do anything when we don't have the device */
   if (G_UNLIKELY (!gst_audio_ring_buffer_is_acquired (ringbuf)))
     goto wrong_state;
@@ -2113,6 +2655,48 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
       render_start = sample_offset + samples;
   }
 
+  /* with adaptive slaving the resampler makes the samples fit, we always
+   * continue after the previous samples unless we need to resync */
+  if (G_UNLIKELY (slaved
+          && sink->priv->slave_method == GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE
+          && gst_audio_base_sink_adaptive_prepare (sink))) {
+    gpointer in[1], outbuf[1];
+    gsize out_frames;
+
+    if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT) ||
+        GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_RESYNC) ||
+        sink->next_sample == -1 ||
+        !gst_audio_base_sink_adaptive_update (sink, sample_offset, samples)) {
+      gst_audio_base_sink_adaptive_reset (sink);
+    } else {
+      render_start = sink->next_sample;
+    }
+
+    out_frames =
+        gst_audio_resampler_get_out_frames (sink->priv->adaptive, samples);
+    if (out_frames * bpf > sink->priv->adaptive_size) {
+      sink->priv->adaptive_size = out_frames * bpf;
+      sink->priv->adaptive_data = g_realloc (sink->priv->adaptive_data,
+          sink->priv->adaptive_size);
+    }
+
+    gst_buffer_map (buf, &info, GST_MAP_READ);
+    in[0] = info.data + offset;
+    outbuf[0] = sink->priv->adaptive_data;
+    gst_audio_resampler_resample (sink->priv->adaptive, in, samples, outbuf,
+        out_frames);
+    gst_buffer_unmap (buf, &info);
+
+    GST_LOG_OBJECT (sink, "resampled %u to %" G_GSIZE_FORMAT " samples",
+        samples, out_frames);
+
+    samples = out_frames;
+    offset = 0;
+    render_stop = render_start + samples;
+    adaptive = TRUE;
+    goto no_align;
+  }
+
   /* always resync after a discont */
   if (G_UNLIKELY (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT) ||
           GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_RESYNC))) {
@@ -2157,11 +2741,16 @@ no_align:
   /* we need to accumulate over different runs for when we get interrupted */
   accum = 0;
   align_next = TRUE;
-  gst_buffer_map (buf, &info, GST_MAP_READ);
+  if (G_UNLIKELY (adaptive)) {
+    data = sink->priv->adaptive_data;
+  } else {
+    gst_buffer_map (buf, &info, GST_MAP_READ);
+    data = info.data;
+  }
   do {
     written =
         gst_audio_ring_buffer_commit (ringbuf, &sample_offset,
-        info.data + offset, samples, out_samples, &accum);
+        data + offset, samples, out_samples, &accum);
 
     GST_DEBUG_OBJECT (sink, "wrote %u of %u", written, samples);
     /* if we wrote all, we're done */
@@ -2187,7 +2776,8 @@ no_align:
     samples -= written;
     offset += written * bpf;
   } while (TRUE);
-  gst_buffer_unmap (buf, &info);
+  if (G_LIKELY (!adaptive))
+    gst_buffer_unmap (buf, &info);
 
   if (G_LIKELY (align_next))
     sink->next_sample = sample_offset;
@@ -2254,7 +2844,8 @@ stopping:
   {
     GST_DEBUG_OBJECT (sink, "preroll got interrupted: %d (%s)", ret,
         gst_flow_get_name (ret));
-    gst_buffer_unmap (buf, &info);
+    if (G_LIKELY (!adaptive))
+      gst_buffer_unmap (buf, &info);
     goto done;
   }
 sync_latency_failed:
@@ -2438,6 +3029,10 @@ gst_audio_base_sink_change_state (GstElement * element,
     }
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       gst_audio_base_sink_reset_sync (sink);
+      sink->priv->auto_buffer_time = 0;
+      sink->priv->auto_latency_time = 0;
+      sink->priv->auto_last_check = 0;
+      sink->priv->auto_grown = FALSE;
       gst_audio_ring_buffer_set_flushing (sink->ringbuffer, FALSE);
       gst_audio_ring_buffer_may_start (sink->ringbuffer, FALSE);
 
@@ -87,6 +87,9 @@ G_BEGIN_DECLS
  * drifts too much.
  * @GST_AUDIO_BASE_SINK_SLAVE_NONE: No adjustment is done.
  * @GST_AUDIO_BASE_SINK_SLAVE_CUSTOM: Use custom clock slaving algorithm (Since: 1.6)
+ * @GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE: Continuously resample with a
+ * #GstAudioResampler whose rate is steered by the measured clock drift
+ * (Since: 1.10)
  *
  * Different possible clock slaving algorithms used when the internal audio
  * clock is not selected as the pipeline master clock.
@@ -96,7 +99,8 @@ typedef enum
   GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE,
   GST_AUDIO_BASE_SINK_SLAVE_SKEW,
   GST_AUDIO_BASE_SINK_SLAVE_NONE,
-  GST_AUDIO_BASE_SINK_SLAVE_CUSTOM
+  GST_AUDIO_BASE_SINK_SLAVE_CUSTOM,
+  GST_AUDIO_BASE_SINK_SLAVE_ADAPTIVE
 } GstAudioBaseSinkSlaveMethod;
 
 #define GST_TYPE_AUDIO_BASE_SINK_SLAVE_METHOD (gst_audio_base_sink_slave_method_get_type ())
@@ -38,6 +38,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudiobasesrc.h"
+#include "gstaudioutilsprivate.h"
 
 #include "gst/gst-i18n-plugin.h"
 
@@ -74,6 +75,10 @@ struct _GstAudioBaseSrcPrivate
 {
   /* the clock slaving algorithm in use */
   GstAudioBaseSrcSlaveMethod slave_method;
+
+  /* scheduling of the ringbuffer thread */
+  gint realtime_priority;
+  guint64 cpu_affinity;
 };
 
 /* BaseAudioSrc signals and args */
@@ -90,6 +95,9 @@ enum
 #define DEFAULT_ACTUAL_LATENCY_TIME    -1
 #define DEFAULT_PROVIDE_CLOCK   TRUE
 #define DEFAULT_SLAVE_METHOD    GST_AUDIO_BASE_SRC_SLAVE_SKEW
+/* don't change the scheduling of the ringbuffer thread */
+#define DEFAULT_REALTIME_PRIORITY   0
+#define DEFAULT_CPU_AFFINITY        0
 
 enum
 {
@@ -100,6 +108,9 @@ enum
   PROP_ACTUAL_LATENCY_TIME,
   PROP_PROVIDE_CLOCK,
   PROP_SLAVE_METHOD,
+  PROP_REALTIME_PRIORITY,
+  PROP_CPU_AFFINITY,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -215,6 +226,49 @@ gst_audio_base_src_class_init (GstAudioBaseSrcClass * klass)
           GST_TYPE_AUDIO_BASE_SRC_SLAVE_METHOD, DEFAULT_SLAVE_METHOD,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSrc:realtime-priority:
+   *
+   * SCHED_FIFO priority for the thread that reads from the device, or 0 to
+   * keep the default scheduling. The priority is limited to RLIMIT_RTPRIO
+   * and only applied when the thread is started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_REALTIME_PRIORITY,
+      g_param_spec_int ("realtime-priority", "Realtime Priority",
+          "SCHED_FIFO priority of the device thread (0 = default scheduling)",
+          0, 99, DEFAULT_REALTIME_PRIORITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSrc:cpu-affinity:
+   *
+   * Bitmask of the CPUs the thread that reads from the device may run on,
+   * or 0 to not pin the thread. Only applied when the thread is started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CPU_AFFINITY,
+      g_param_spec_uint64 ("cpu-affinity", "CPU Affinity",
+          "Mask of CPUs to run the device thread on (0 = any CPU)",
+          0, G_MAXUINT64, DEFAULT_CPU_AFFINITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSrc:stats:
+   *
+   * Statistics of the ringbuffer as returned by
+   * gst_audio_ring_buffer_get_stats(): the number of missed segments and
+   * the latency of the wakeups of the streaming thread.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Ringbuffer statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_src_change_state);
   gstelement_class->provide_clock =
@@ -248,6 +302,8 @@ gst_audio_base_src_init (GstAudioBaseSrc * audiobasesrc)
   else
     GST_OBJECT_FLAG_UNSET (audiobasesrc, GST_ELEMENT_FLAG_PROVIDE_CLOCK);
   audiobasesrc->priv->slave_method = DEFAULT_SLAVE_METHOD;
+  audiobasesrc->priv->realtime_priority = DEFAULT_REALTIME_PRIORITY;
+  audiobasesrc->priv->cpu_affinity = DEFAULT_CPU_AFFINITY;
   /* reset blocksize we use latency time to calculate a more useful
    * value based on negotiated format. */
   GST_BASE_SRC (audiobasesrc)->blocksize = 0;
@@ -461,6 +517,16 @@ gst_audio_base_src_set_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       gst_audio_base_src_set_slave_method (src, g_value_get_enum (value));
       break;
+    case PROP_REALTIME_PRIORITY:
+      GST_OBJECT_LOCK (src);
+      src->priv->realtime_priority = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (src);
+      src->priv->cpu_affinity = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -504,6 +570,33 @@ gst_audio_base_src_get_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       g_value_set_enum (value, gst_audio_base_src_get_slave_method (src));
       break;
+    case PROP_REALTIME_PRIORITY:
+      GST_OBJECT_LOCK (src);
+      g_value_set_int (value, src->priv->realtime_priority);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (src);
+      g_value_set_uint64 (value, src->priv->cpu_affinity);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_STATS:
+    {
+      GstAudioRingBuffer *ringbuffer = NULL;
+
+      GST_OBJECT_LOCK (src);
+      if (src->ringbuffer)
+        ringbuffer = gst_object_ref (src->ringbuffer);
+      GST_OBJECT_UNLOCK (src);
+
+      if (ringbuffer) {
+        g_value_take_boxed (value, gst_audio_ring_buffer_get_stats (ringbuffer));
+        gst_object_unref (ringbuffer);
+      } else {
+        g_value_set_boxed (value, NULL);
+      }
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1250,6 +1343,26 @@ gst_audio_base_src_post_message (GstElement * element, GstMessage * message)
     g_atomic_int_set (&ringbuffer->state, GST_AUDIO_RING_BUFFER_STATE_ERROR);
     GST_AUDIO_RING_BUFFER_SIGNAL (ringbuffer);
     gst_object_unref (ringbuffer);
+  } else if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_STREAM_STATUS &&
+      GST_MESSAGE_SRC (message) == GST_OBJECT_CAST (src->ringbuffer)) {
+    GstStreamStatusType type;
+    gint priority;
+    guint64 cpu_affinity;
+
+    /* the ringbuffer thread posts its ENTER stream status from the thread
+     * itself, configure its scheduling here */
+    gst_message_parse_stream_status (message, &type, NULL);
+
+    GST_OBJECT_LOCK (src);
+    priority = src->priv->realtime_priority;
+    cpu_affinity = src->priv->cpu_affinity;
+    GST_OBJECT_UNLOCK (src);
+
+    if (type == GST_STREAM_STATUS_TYPE_ENTER && (priority || cpu_affinity))
+      __gst_audio_set_thread_priority (GST_OBJECT_CAST (src), priority,
+          cpu_affinity);
+
+    ret = GST_ELEMENT_CLASS (parent_class)->post_message (element, message);
   } else {
     ret = GST_ELEMENT_CLASS (parent_class)->post_message (element, message);
   }
@@ -171,12 +171,14 @@ enum
   PROP_0,
   PROP_LATENCY,
   PROP_TOLERANCE,
-  PROP_PLC
+  PROP_PLC,
+  PROP_OUTPUT_LIST_DURATION
 };
 
 #define DEFAULT_LATENCY    0
 #define DEFAULT_TOLERANCE  0
 #define DEFAULT_PLC        FALSE
+#define DEFAULT_OUTPUT_LIST_DURATION  0
 #define DEFAULT_DRAINABLE  TRUE
 #define DEFAULT_NEEDS_FORMAT  FALSE
 
@@ -266,6 +268,14 @@ struct _GstAudioDecoderPrivate
   /* whether circumstances allow output aggregation */
   gint agg;
 
+  /* output buffers collected for a single push */
+  GstBufferList *out_list;
+  GstClockTime out_list_dur;
+  /* monotonic time of the first buffer in out_list */
+  gint64 out_list_start;
+  /* whether upstream is live, -1 if not known yet */
+  gint out_list_live;
+
   /* reverse playback queues */
   /* collect input */
   GList *gather;
@@ -283,6 +293,7 @@ struct _GstAudioDecoderPrivate
   gboolean plc;
   gboolean drainable;
   gboolean needs_format;
+  GstClockTime output_list_duration;
 
   /* pending serialized sink events, will be sent from finish_frame() */
   GList *pending_events;
@@ -413,6 +424,22 @@ gst_audio_decoder_class_init (GstAudioDecoderClass * klass)
           "Perform packet loss concealment (if supported)",
           DEFAULT_PLC, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioDecoder:output-list-duration:
+   *
+   * Collect decoded buffers into a #GstBufferList until at least this
+   * much data is gathered and push them downstream together. Buffers
+   * keep their own timestamps and flags. Nothing is collected when
+   * upstream is live. 0 disables.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_LIST_DURATION,
+      g_param_spec_uint64 ("output-list-duration", "Output List Duration",
+          "Push output in buffer lists of at least this duration (ns), "
+          "0 = disabled", 0, G_MAXUINT64 - 1, DEFAULT_OUTPUT_LIST_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   audiodecoder_class->sink_event =
       GST_DEBUG_FUNCPTR (gst_audio_decoder_sink_eventfunc);
   audiodecoder_class->src_event =
@@ -480,6 +507,8 @@ gst_audio_decoder_init (GstAudioDecoder * dec, GstAudioDecoderClass * klass)
   dec->priv->plc = DEFAULT_PLC;
   dec->priv->drainable = DEFAULT_DRAINABLE;
   dec->priv->needs_format = DEFAULT_NEEDS_FORMAT;
+  dec->priv->output_list_duration = DEFAULT_OUTPUT_LIST_DURATION;
+  dec->priv->out_list_live = -1;
 
   /* init state */
   dec->priv->ctx.min_latency = 0;
@@ -599,9 +628,63 @@ gst_audio_decoder_create_merged_tags_event (GstAudioDecoder * dec)
   return gst_event_new_tag (merged_tags);
 }
 
+/* pushes out the collected output buffers, if any */
+static GstFlowReturn
+gst_audio_decoder_push_list (GstAudioDecoder * dec)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstBufferList *list;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  GST_AUDIO_DECODER_STREAM_LOCK (dec);
+  list = priv->out_list;
+  priv->out_list = NULL;
+  priv->out_list_dur = 0;
+
+  if (list) {
+    GST_LOG_OBJECT (dec, "pushing list of %u buffers",
+        gst_buffer_list_length (list));
+    ret = gst_pad_push_list (dec->srcpad, list);
+  }
+  GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+
+  return ret;
+}
+
+/* a live upstream can stop sending at any time, the output is never held
+ * back then */
+static gboolean
+gst_audio_decoder_upstream_is_live (GstAudioDecoder * dec)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+
+  if (priv->out_list_live == -1) {
+    GstQuery *query = gst_query_new_latency ();
+    gboolean live = FALSE;
+
+    if (gst_pad_peer_query (dec->sinkpad, query))
+      gst_query_parse_latency (query, &live, NULL, NULL);
+    gst_query_unref (query);
+
+    GST_DEBUG_OBJECT (dec, "upstream is %slive", live ? "" : "not ");
+    priv->out_list_live = live;
+  }
+
+  return priv->out_list_live;
+}
+
 static gboolean
 gst_audio_decoder_push_event (GstAudioDecoder * dec, GstEvent * event)
 {
+  /* collected output must not be overtaken by serialized events */
+  if (GST_EVENT_IS_SERIALIZED (event)) {
+    GstFlowReturn ret = gst_audio_decoder_push_list (dec);
+
+    if (ret != GST_FLOW_OK)
+      GST_DEBUG_OBJECT (dec, "pushing pending output list returned %s",
+          gst_flow_get_name (ret));
+  }
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_SEGMENT:{
       GstSegment seg;
@@ -727,6 +810,9 @@ gst_audio_decoder_negotiate_unlocked (GstAudioDecoder * dec)
   GstAudioDecoderClass *klass = GST_AUDIO_DECODER_GET_CLASS (dec);
   gboolean ret = TRUE;
 
+  /* data collected so far belongs to the old caps */
+  gst_audio_decoder_push_list (dec);
+
   if (G_LIKELY (klass->negotiate))
     ret = klass->negotiate (dec);
 
@@ -755,6 +841,7 @@ gst_audio_decoder_negotiate (GstAudioDecoder * dec)
 
   GST_AUDIO_DECODER_STREAM_LOCK (dec);
   gst_pad_check_reconfigure (dec->srcpad);
+  gst_audio_decoder_push_list (dec);
   if (klass->negotiate) {
     res = klass->negotiate (dec);
     if (!res)
@@ -975,7 +1062,32 @@ gst_audio_decoder_push_forward (GstAudioDecoder * dec, GstBuffer * buf)
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)),
       GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
 
-  ret = gst_pad_push (dec->srcpad, buf);
+  if (priv->output_list_duration > 0 &&
+      !gst_audio_decoder_upstream_is_live (dec)) {
+    if (!priv->out_list) {
+      priv->out_list = gst_buffer_list_new ();
+      priv->out_list_start = g_get_monotonic_time ();
+    }
+    if (GST_BUFFER_DURATION_IS_VALID (buf))
+      priv->out_list_dur += GST_BUFFER_DURATION (buf);
+    gst_buffer_list_add (priv->out_list, buf);
+
+    /* push when enough is collected, or when the first buffer was held back
+     * for that long already because the input is slow */
+    if (!GST_BUFFER_DURATION_IS_VALID (buf) ||
+        priv->out_list_dur >= priv->output_list_duration ||
+        (g_get_monotonic_time () - priv->out_list_start) * GST_USECOND >=
+        priv->output_list_duration)
+      ret = gst_audio_decoder_push_list (dec);
+  } else {
+    /* list collecting may have been disabled meanwhile */
+    if (G_UNLIKELY (priv->out_list))
+      ret = gst_audio_decoder_push_list (dec);
+    if (ret == GST_FLOW_OK)
+      ret = gst_pad_push (dec->srcpad, buf);
+    else
+      gst_buffer_unref (buf);
+  }
 
 exit:
   return ret;
@@ -1535,7 +1647,9 @@ gst_audio_decoder_push_buffers (GstAudioDecoder * dec, gboolean force)
         GST_LOG_OBJECT (dec, "ts == prev_ts; discarding");
         ts = GST_CLOCK_TIME_NONE;
       }
-      buffer = gst_adapter_take_buffer (priv->adapter, len);
+      /* a frame that straddles input buffers gets their memories instead
+       * of a merged copy, mapping it merges if the subclass needs that */
+      buffer = gst_adapter_take_buffer_fast (priv->adapter, len);
       buffer = gst_buffer_make_writable (buffer);
       GST_BUFFER_TIMESTAMP (buffer) = ts;
       flush += len;
@@ -1646,6 +1760,33 @@ gst_audio_decoder_flush (GstAudioDecoder * dec, gboolean hard)
   return ret;
 }
 
+/* hand @buffer to the subclass as one frame, like push_buffers does for
+ * the content of an empty adapter after pushing @buffer without parsing */
+static GstFlowReturn
+gst_audio_decoder_push_packet (GstAudioDecoder * dec, GstBuffer * buffer)
+{
+  GstAudioDecoderClass *klass = GST_AUDIO_DECODER_GET_CLASS (dec);
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstClockTime ts;
+
+  g_return_val_if_fail (klass->handle_frame != NULL, GST_FLOW_ERROR);
+
+  priv->ctx.eos = FALSE;
+
+  ts = GST_BUFFER_PTS (buffer);
+  priv->prev_ts = ts;
+  priv->prev_distance = 0;
+
+  buffer = gst_buffer_make_writable (buffer);
+  GST_BUFFER_TIMESTAMP (buffer) = ts;
+  priv->force = FALSE;
+
+  GST_LOG_OBJECT (dec, "packet of %" G_GSIZE_FORMAT " bytes",
+      gst_buffer_get_size (buffer));
+
+  return gst_audio_decoder_handle_frame (dec, klass, buffer);
+}
+
 static GstFlowReturn
 gst_audio_decoder_chain_forward (GstAudioDecoder * dec, GstBuffer * buffer)
 {
@@ -1658,11 +1799,20 @@ gst_audio_decoder_chain_forward (GstAudioDecoder * dec, GstBuffer * buffer)
     goto exit;
   }
 
+  /* new stuff, so we can push subclass again */
+  dec->priv->drained = FALSE;
+
+  /* without parsing every input buffer is a frame, let it bypass the
+   * adapter when there is nothing left in there */
+  if (GST_AUDIO_DECODER_GET_CLASS (dec)->parse == NULL &&
+      gst_adapter_available (dec->priv->adapter) == 0) {
+    ret = gst_audio_decoder_push_packet (dec, buffer);
+    goto exit;
+  }
+
   /* grab buffer */
   gst_adapter_push (dec->priv->adapter, buffer);
   buffer = NULL;
-  /* new stuff, so we can push subclass again */
-  dec->priv->drained = FALSE;
 
   /* hand to subclass */
   ret = gst_audio_decoder_push_buffers (dec, FALSE);
@@ -1686,6 +1836,12 @@ gst_audio_decoder_clear_queues (GstAudioDecoder * dec)
   g_list_foreach (priv->decode, (GFunc) gst_mini_object_unref, NULL);
   g_list_free (priv->decode);
   priv->decode = NULL;
+  if (priv->out_list) {
+    gst_buffer_list_unref (priv->out_list);
+    priv->out_list = NULL;
+  }
+  priv->out_list_dur = 0;
+  priv->out_list_live = -1;
 }
 
 /*
@@ -2094,6 +2250,8 @@ gst_audio_decoder_handle_gap (GstAudioDecoder * dec, GstEvent * event)
     GST_BUFFER_DURATION (buf) = duration;
     /* best effort, not much error handling */
     gst_audio_decoder_handle_frame (dec, klass, buf);
+    /* nothing might follow the gap for a while */
+    gst_audio_decoder_push_list (dec);
     ret = TRUE;
     gst_event_unref (event);
   } else {
@@ -2861,6 +3019,13 @@ gst_audio_decoder_src_query_default (GstAudioDecoder * dec, GstQuery * query)
           max_latency = -1;
         else
           max_latency += dec->priv->ctx.max_latency;
+        /* output is held back until a list is complete, except with a live
+         * upstream */
+        if (!live) {
+          min_latency += dec->priv->output_list_duration;
+          if (max_latency != -1)
+            max_latency += dec->priv->output_list_duration;
+        }
         GST_OBJECT_UNLOCK (dec);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -2957,6 +3122,10 @@ gst_audio_decoder_get_property (GObject * object, guint prop_id,
     case PROP_PLC:
       g_value_set_boolean (value, dec->priv->plc);
       break;
+    case PROP_OUTPUT_LIST_DURATION:
+      g_value_set_uint64 (value,
+          gst_audio_decoder_get_output_list_duration (dec));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2981,6 +3150,10 @@ gst_audio_decoder_set_property (GObject * object, guint prop_id,
     case PROP_PLC:
       dec->priv->plc = g_value_get_boolean (value);
       break;
+    case PROP_OUTPUT_LIST_DURATION:
+      gst_audio_decoder_set_output_list_duration (dec,
+          g_value_get_uint64 (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3422,6 +3595,61 @@ gst_audio_decoder_get_tolerance (GstAudioDecoder * dec)
   return result;
 }
 
+/**
+ * gst_audio_decoder_set_output_list_duration:
+ * @dec: a #GstAudioDecoder
+ * @duration: minimum duration of an output buffer list, or 0
+ *
+ * Configures the decoder to collect finished frames into a #GstBufferList
+ * and push them with gst_pad_push_list() once at least @duration of data
+ * is collected or the first of them was held back for @duration, or earlier
+ * when a serialized event or caps change needs to go downstream. This
+ * reduces per-buffer overhead for codecs with very small frames, at the
+ * expense of @duration additional latency. Nothing is collected when
+ * upstream is live.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+void
+gst_audio_decoder_set_output_list_duration (GstAudioDecoder * dec,
+    GstClockTime duration)
+{
+  g_return_if_fail (GST_IS_AUDIO_DECODER (dec));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (duration));
+
+  GST_OBJECT_LOCK (dec);
+  dec->priv->output_list_duration = duration;
+  GST_OBJECT_UNLOCK (dec);
+}
+
+/**
+ * gst_audio_decoder_get_output_list_duration:
+ * @dec: a #GstAudioDecoder
+ *
+ * Queries decoder output buffer list duration.
+ *
+ * Returns: minimum duration of output buffer lists, 0 if disabled.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+GstClockTime
+gst_audio_decoder_get_output_list_duration (GstAudioDecoder * dec)
+{
+  GstClockTime result;
+
+  g_return_val_if_fail (GST_IS_AUDIO_DECODER (dec), 0);
+
+  GST_OBJECT_LOCK (dec);
+  result = dec->priv->output_list_duration;
+  GST_OBJECT_UNLOCK (dec);
+
+  return result;
+}
+
 /**
  * gst_audio_decoder_set_drainable:
  * @dec: a #GstAudioDecoder
@@ -384,6 +384,11 @@ void              gst_audio_decoder_set_drainable (GstAudioDecoder * dec,
 
 gboolean          gst_audio_decoder_get_drainable (GstAudioDecoder * dec);
 
+void              gst_audio_decoder_set_output_list_duration (GstAudioDecoder * dec,
+                                                              GstClockTime      duration);
+
+GstClockTime      gst_audio_decoder_get_output_list_duration (GstAudioDecoder * dec);
+
 void              gst_audio_decoder_set_needs_format (GstAudioDecoder * dec,
                                                       gboolean enabled);
 
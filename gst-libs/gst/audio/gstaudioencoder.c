@@ -174,7 +174,8 @@ enum
   PROP_PERFECT_TS,
   PROP_GRANULE,
   PROP_HARD_RESYNC,
-  PROP_TOLERANCE
+  PROP_TOLERANCE,
+  PROP_OUTPUT_LIST_DURATION
 };
 
 #define DEFAULT_PERFECT_TS   FALSE
@@ -183,6 +184,7 @@ enum
 #define DEFAULT_TOLERANCE    40000000
 #define DEFAULT_HARD_MIN     FALSE
 #define DEFAULT_DRAINABLE    TRUE
+#define DEFAULT_OUTPUT_LIST_DURATION  0
 
 typedef struct _GstAudioEncoderContext
 {
@@ -208,6 +210,15 @@ typedef struct _GstAudioEncoderContext
 
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  /* pool for the encoded output, either from downstream or our own. It is
+   * sized to the biggest frame seen so far */
+  GstBufferPool *pool;
+  gboolean pool_downstream;
+  gboolean pool_failed;
+  guint pool_min, pool_max;
+  gsize pool_size;
+  gsize max_frame_size;
 } GstAudioEncoderContext;
 
 struct _GstAudioEncoderPrivate
@@ -248,6 +259,14 @@ struct _GstAudioEncoderPrivate
   /* global bytes sent out */
   guint64 bytes_out;
 
+  /* output buffers collected for a single push */
+  GstBufferList *out_list;
+  GstClockTime out_list_dur;
+  /* monotonic time of the first buffer in out_list */
+  gint64 out_list_start;
+  /* whether upstream is live, -1 if not known yet */
+  gint out_list_live;
+
   /* context storage */
   GstAudioEncoderContext ctx;
 
@@ -258,6 +277,7 @@ struct _GstAudioEncoderPrivate
   gboolean granule;
   gboolean hard_min;
   gboolean drainable;
+  GstClockTime output_list_duration;
 
   /* upstream stream tags (global tags are passed through as-is) */
   GstTagList *upstream_tags;
@@ -312,6 +332,7 @@ gst_audio_encoder_get_type (void)
 }
 
 static void gst_audio_encoder_finalize (GObject * object);
+static void gst_audio_encoder_clear_pool (GstAudioEncoder * enc);
 static void gst_audio_encoder_reset (GstAudioEncoder * enc, gboolean full);
 
 static void gst_audio_encoder_set_property (GObject * object,
@@ -398,6 +419,22 @@ gst_audio_encoder_class_init (GstAudioEncoderClass * klass)
           0, G_MAXINT64, DEFAULT_TOLERANCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioEncoder:output-list-duration:
+   *
+   * Collect encoded buffers into a #GstBufferList until at least this
+   * much data is gathered and push them downstream together. Buffers
+   * keep their own timestamps and flags. Nothing is collected when
+   * upstream is live. 0 disables.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_LIST_DURATION,
+      g_param_spec_uint64 ("output-list-duration", "Output List Duration",
+          "Push output in buffer lists of at least this duration (ns), "
+          "0 = disabled", 0, G_MAXUINT64 - 1, DEFAULT_OUTPUT_LIST_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_encoder_change_state);
 
@@ -462,6 +499,7 @@ gst_audio_encoder_init (GstAudioEncoder * enc, GstAudioEncoderClass * bclass)
   enc->priv->tolerance = DEFAULT_TOLERANCE;
   enc->priv->hard_min = DEFAULT_HARD_MIN;
   enc->priv->drainable = DEFAULT_DRAINABLE;
+  enc->priv->output_list_duration = DEFAULT_OUTPUT_LIST_DURATION;
 
   /* init state */
   enc->priv->ctx.min_latency = 0;
@@ -470,6 +508,17 @@ gst_audio_encoder_init (GstAudioEncoder * enc, GstAudioEncoderClass * bclass)
   GST_DEBUG_OBJECT (enc, "init ok");
 }
 
+static void
+gst_audio_encoder_clear_list (GstAudioEncoder * enc)
+{
+  if (enc->priv->out_list) {
+    gst_buffer_list_unref (enc->priv->out_list);
+    enc->priv->out_list = NULL;
+  }
+  enc->priv->out_list_dur = 0;
+  enc->priv->out_list_live = -1;
+}
+
 static void
 gst_audio_encoder_reset (GstAudioEncoder * enc, gboolean full)
 {
@@ -490,6 +539,7 @@ gst_audio_encoder_reset (GstAudioEncoder * enc, gboolean full)
     if (enc->priv->ctx.allocator)
       gst_object_unref (enc->priv->ctx.allocator);
     enc->priv->ctx.allocator = NULL;
+    gst_audio_encoder_clear_pool (enc);
 
     gst_caps_replace (&enc->priv->ctx.input_caps, NULL);
     gst_caps_replace (&enc->priv->ctx.caps, NULL);
@@ -511,6 +561,8 @@ gst_audio_encoder_reset (GstAudioEncoder * enc, gboolean full)
     g_list_foreach (enc->priv->pending_events, (GFunc) gst_event_unref, NULL);
     g_list_free (enc->priv->pending_events);
     enc->priv->pending_events = NULL;
+
+    gst_audio_encoder_clear_list (enc);
   }
 
   gst_segment_init (&enc->input_segment, GST_FORMAT_TIME);
@@ -534,6 +586,7 @@ gst_audio_encoder_finalize (GObject * object)
   GstAudioEncoder *enc = GST_AUDIO_ENCODER (object);
 
   g_object_unref (enc->priv->adapter);
+  gst_audio_encoder_clear_pool (enc);
 
   g_rec_mutex_clear (&enc->stream_lock);
 
@@ -583,9 +636,100 @@ close_failed:
   }
 }
 
+/* pushes out the collected output buffers, if any */
+static GstFlowReturn
+gst_audio_encoder_push_list (GstAudioEncoder * enc)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+  GstBufferList *list;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  GST_AUDIO_ENCODER_STREAM_LOCK (enc);
+  list = priv->out_list;
+  priv->out_list = NULL;
+  priv->out_list_dur = 0;
+
+  if (list) {
+    GST_LOG_OBJECT (enc, "pushing list of %u buffers",
+        gst_buffer_list_length (list));
+    ret = gst_pad_push_list (enc->srcpad, list);
+  }
+  GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
+
+  return ret;
+}
+
+/* a live upstream can stop sending at any time, the output is never held
+ * back then */
+static gboolean
+gst_audio_encoder_upstream_is_live (GstAudioEncoder * enc)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+
+  if (priv->out_list_live == -1) {
+    GstQuery *query = gst_query_new_latency ();
+    gboolean live = FALSE;
+
+    if (gst_pad_peer_query (enc->sinkpad, query))
+      gst_query_parse_latency (query, &live, NULL, NULL);
+    gst_query_unref (query);
+
+    GST_DEBUG_OBJECT (enc, "upstream is %slive", live ? "" : "not ");
+    priv->out_list_live = live;
+  }
+
+  return priv->out_list_live;
+}
+
+/* pushes @buf or adds it to the output list, with STREAM_LOCK */
+static GstFlowReturn
+gst_audio_encoder_push_output (GstAudioEncoder * enc, GstBuffer * buf)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (priv->output_list_duration > 0 &&
+      !gst_audio_encoder_upstream_is_live (enc)) {
+    if (!priv->out_list) {
+      priv->out_list = gst_buffer_list_new ();
+      priv->out_list_start = g_get_monotonic_time ();
+    }
+    if (GST_BUFFER_DURATION_IS_VALID (buf))
+      priv->out_list_dur += GST_BUFFER_DURATION (buf);
+    gst_buffer_list_add (priv->out_list, buf);
+
+    /* push when enough is collected, or when the first buffer was held back
+     * for that long already because the input is slow */
+    if (!GST_BUFFER_DURATION_IS_VALID (buf) ||
+        priv->out_list_dur >= priv->output_list_duration ||
+        (g_get_monotonic_time () - priv->out_list_start) * GST_USECOND >=
+        priv->output_list_duration)
+      ret = gst_audio_encoder_push_list (enc);
+  } else {
+    /* list collecting may have been disabled meanwhile */
+    if (G_UNLIKELY (priv->out_list))
+      ret = gst_audio_encoder_push_list (enc);
+    if (ret == GST_FLOW_OK)
+      ret = gst_pad_push (enc->srcpad, buf);
+    else
+      gst_buffer_unref (buf);
+  }
+
+  return ret;
+}
+
 static gboolean
 gst_audio_encoder_push_event (GstAudioEncoder * enc, GstEvent * event)
 {
+  /* collected output must not be overtaken by serialized events */
+  if (GST_EVENT_IS_SERIALIZED (event)) {
+    GstFlowReturn ret = gst_audio_encoder_push_list (enc);
+
+    if (ret != GST_FLOW_OK)
+      GST_DEBUG_OBJECT (enc, "pushing pending output list returned %s",
+          gst_flow_get_name (ret));
+  }
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_SEGMENT:{
       GstSegment seg;
@@ -913,7 +1057,7 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
 
         priv->bytes_out += size;
 
-        gst_pad_push (enc->srcpad, tmpbuf);
+        gst_audio_encoder_push_output (enc, tmpbuf);
       }
       priv->ctx.new_headers = FALSE;
     }
@@ -1000,7 +1144,7 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
         GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)),
         GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
 
-    ret = gst_pad_push (enc->srcpad, buf);
+    ret = gst_audio_encoder_push_output (enc, buf);
     GST_LOG_OBJECT (enc, "buffer pushed: %s", gst_flow_get_name (ret));
   } else {
     /* merely advance samples, most work for that already done above */
@@ -1561,6 +1705,7 @@ gst_audio_encoder_sink_event_default (GstAudioEncoder * enc, GstEvent * event)
       /* TODO route through drain ?? */
       if (!enc->priv->drained && klass->flush)
         klass->flush (enc);
+      gst_audio_encoder_clear_list (enc);
       /* and get (re)set for the sequel */
       gst_audio_encoder_reset (enc, FALSE);
 
@@ -1661,6 +1806,9 @@ gst_audio_encoder_sink_event_default (GstAudioEncoder * enc, GstEvent * event)
             gst_pad_event_default (enc->sinkpad, GST_OBJECT_CAST (enc), event);
       } else {
         GST_AUDIO_ENCODER_STREAM_LOCK (enc);
+        /* the collected output comes before the event, and nothing might
+         * follow a gap for a while */
+        gst_audio_encoder_push_list (enc);
         enc->priv->pending_events =
             g_list_append (enc->priv->pending_events, event);
         GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
@@ -2015,6 +2163,13 @@ gst_audio_encoder_src_query_default (GstAudioEncoder * enc, GstQuery * query)
           max_latency = -1;
         else
           max_latency += enc->priv->ctx.max_latency;
+        /* output is held back until a list is complete, except with a live
+         * upstream */
+        if (!live) {
+          min_latency += enc->priv->output_list_duration;
+          if (max_latency != -1)
+            max_latency += enc->priv->output_list_duration;
+        }
         GST_OBJECT_UNLOCK (enc);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -2071,6 +2226,10 @@ gst_audio_encoder_set_property (GObject * object, guint prop_id,
     case PROP_TOLERANCE:
       enc->priv->tolerance = g_value_get_int64 (value);
       break;
+    case PROP_OUTPUT_LIST_DURATION:
+      gst_audio_encoder_set_output_list_duration (enc,
+          g_value_get_uint64 (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2098,6 +2257,10 @@ gst_audio_encoder_get_property (GObject * object, guint prop_id,
     case PROP_TOLERANCE:
       g_value_set_int64 (value, enc->priv->tolerance);
       break;
+    case PROP_OUTPUT_LIST_DURATION:
+      g_value_set_uint64 (value,
+          gst_audio_encoder_get_output_list_duration (enc));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2636,6 +2799,61 @@ gst_audio_encoder_get_hard_min (GstAudioEncoder * enc)
   return result;
 }
 
+/**
+ * gst_audio_encoder_set_output_list_duration:
+ * @enc: a #GstAudioEncoder
+ * @duration: minimum duration of an output buffer list, or 0
+ *
+ * Configures the encoder to collect finished frames into a #GstBufferList
+ * and push them with gst_pad_push_list() once at least @duration of data
+ * is collected or the first of them was held back for @duration, or earlier
+ * when a serialized event or caps change needs to go downstream. This
+ * reduces per-buffer overhead for codecs with very small frames, at the
+ * expense of @duration additional latency. Nothing is collected when
+ * upstream is live.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+void
+gst_audio_encoder_set_output_list_duration (GstAudioEncoder * enc,
+    GstClockTime duration)
+{
+  g_return_if_fail (GST_IS_AUDIO_ENCODER (enc));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (duration));
+
+  GST_OBJECT_LOCK (enc);
+  enc->priv->output_list_duration = duration;
+  GST_OBJECT_UNLOCK (enc);
+}
+
+/**
+ * gst_audio_encoder_get_output_list_duration:
+ * @enc: a #GstAudioEncoder
+ *
+ * Queries encoder output buffer list duration.
+ *
+ * Returns: minimum duration of output buffer lists, 0 if disabled.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+GstClockTime
+gst_audio_encoder_get_output_list_duration (GstAudioEncoder * enc)
+{
+  GstClockTime result;
+
+  g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), 0);
+
+  GST_OBJECT_LOCK (enc);
+  result = enc->priv->output_list_duration;
+  GST_OBJECT_UNLOCK (enc);
+
+  return result;
+}
+
 /**
  * gst_audio_encoder_set_drainable:
  * @enc: a #GstAudioEncoder
@@ -2724,6 +2942,72 @@ gst_audio_encoder_merge_tags (GstAudioEncoder * enc,
   GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
 }
 
+static void
+gst_audio_encoder_clear_pool (GstAudioEncoder * enc)
+{
+  GstAudioEncoderContext *ctx = &enc->priv->ctx;
+
+  if (ctx->pool) {
+    gst_buffer_pool_set_active (ctx->pool, FALSE);
+    gst_object_unref (ctx->pool);
+    ctx->pool = NULL;
+  }
+  ctx->pool_downstream = FALSE;
+  ctx->pool_size = 0;
+}
+
+/* with STREAM_LOCK, makes sure the pool has buffers of at least @size */
+static gboolean
+gst_audio_encoder_ensure_pool (GstAudioEncoder * enc, gsize size)
+{
+  GstAudioEncoderContext *ctx = &enc->priv->ctx;
+  GstStructure *config;
+
+  if (ctx->pool && ctx->pool_size >= size)
+    return TRUE;
+  if (ctx->pool_failed)
+    return FALSE;
+
+  /* leave some room so that we don't reconfigure for every slightly bigger
+   * frame */
+  ctx->max_frame_size = MAX (ctx->max_frame_size, size);
+  size = ctx->max_frame_size + ctx->max_frame_size / 4;
+
+again:
+  if (ctx->pool == NULL) {
+    ctx->pool = gst_buffer_pool_new ();
+    ctx->pool_downstream = FALSE;
+    ctx->pool_min = ctx->pool_max = 0;
+  } else {
+    gst_buffer_pool_set_active (ctx->pool, FALSE);
+  }
+
+  config = gst_buffer_pool_get_config (ctx->pool);
+  gst_buffer_pool_config_set_params (config, ctx->caps, size, ctx->pool_min,
+      ctx->pool_max);
+  gst_buffer_pool_config_set_allocator (config, ctx->allocator, &ctx->params);
+
+  if (!gst_buffer_pool_set_config (ctx->pool, config) ||
+      !gst_buffer_pool_set_active (ctx->pool, TRUE)) {
+    gboolean downstream = ctx->pool_downstream;
+
+    GST_WARNING_OBJECT (enc, "failed to configure %s pool for size %"
+        G_GSIZE_FORMAT, downstream ? "downstream" : "our", size);
+    gst_audio_encoder_clear_pool (enc);
+    if (downstream)
+      goto again;
+
+    ctx->pool_failed = TRUE;
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (enc, "configured pool %" GST_PTR_FORMAT " for size %"
+      G_GSIZE_FORMAT, ctx->pool, size);
+  ctx->pool_size = size;
+
+  return TRUE;
+}
+
 static gboolean
 gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
 {
@@ -2732,6 +3016,8 @@ gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
   GstQuery *query = NULL;
   GstAllocator *allocator;
   GstAllocationParams params;
+  GstBufferPool *pool = NULL;
+  guint size = 0, min = 0, max = 0;
   GstCaps *caps, *prevcaps;
 
   g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), FALSE);
@@ -2804,6 +3090,20 @@ gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
   enc->priv->ctx.allocator = allocator;
   enc->priv->ctx.params = params;
 
+  /* the pool is configured lazily when we know the size of the frames */
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+
+  gst_audio_encoder_clear_pool (enc);
+  enc->priv->ctx.pool_failed = FALSE;
+  if (pool) {
+    enc->priv->ctx.pool = pool;
+    enc->priv->ctx.pool_downstream = TRUE;
+    enc->priv->ctx.pool_min = min;
+    enc->priv->ctx.pool_max = max;
+    enc->priv->ctx.max_frame_size = MAX (enc->priv->ctx.max_frame_size, size);
+  }
+
 done:
   if (query)
     gst_query_unref (query);
@@ -2824,6 +3124,9 @@ gst_audio_encoder_negotiate_unlocked (GstAudioEncoder * enc)
   GstAudioEncoderClass *klass = GST_AUDIO_ENCODER_GET_CLASS (enc);
   gboolean ret = TRUE;
 
+  /* data collected so far belongs to the old caps */
+  gst_audio_encoder_push_list (enc);
+
   if (G_LIKELY (klass->negotiate))
     ret = klass->negotiate (enc);
 
@@ -2852,6 +3155,7 @@ gst_audio_encoder_negotiate (GstAudioEncoder * enc)
 
   GST_AUDIO_ENCODER_STREAM_LOCK (enc);
   gst_pad_check_reconfigure (enc->srcpad);
+  gst_audio_encoder_push_list (enc);
   if (klass->negotiate) {
     ret = klass->negotiate (enc);
     if (!ret)
@@ -2940,6 +3244,20 @@ gst_audio_encoder_allocate_output_buffer (GstAudioEncoder * enc, gsize size)
     }
   }
 
+  if (gst_audio_encoder_ensure_pool (enc, size)) {
+    GstBufferPoolAcquireParams params = { 0, };
+
+    /* never block on a downstream pool, allocate a fresh buffer instead */
+    params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+    if (gst_buffer_pool_acquire_buffer (enc->priv->ctx.pool, &buffer,
+            &params) == GST_FLOW_OK) {
+      /* the pool puts the buffer back to its full size when released */
+      gst_buffer_resize (buffer, 0, size);
+      GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
+      return buffer;
+    }
+  }
+
   buffer =
       gst_buffer_new_allocate (enc->priv->ctx.allocator, size,
       &enc->priv->ctx.params);
@@ -330,6 +330,11 @@ void            gst_audio_encoder_set_drainable (GstAudioEncoder * enc,
 
 gboolean        gst_audio_encoder_get_drainable (GstAudioEncoder * enc);
 
+void            gst_audio_encoder_set_output_list_duration (GstAudioEncoder * enc,
+                                                            GstClockTime      duration);
+
+GstClockTime    gst_audio_encoder_get_output_list_duration (GstAudioEncoder * enc);
+
 void            gst_audio_encoder_get_allocator (GstAudioEncoder * enc,
                                                  GstAllocator ** allocator,
                                                  GstAllocationParams * params);
@@ -37,6 +37,10 @@
 #include <gst/audio/audio.h>
 #include "gstaudioiec61937.h"
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define IEC61937_HEADER_SIZE      8
 #define IEC61937_PAYLOAD_SIZE_AC3 (1536 * 4)
 #define IEC61937_PAYLOAD_SIZE_EAC3 (6144 * 4)
@@ -138,28 +142,12 @@ gst_audio_iec61937_frame_size (const GstAudioRingBufferSpec * spec)
   }
 }
 
-/**
- * gst_audio_iec61937_payload:
- * @src: (array length=src_n): a buffer containing the data to payload
- * @src_n: size of @src in bytes
- * @dst: (array length=dst_n): the destination buffer to store the
- *       payloaded contents in. Should not overlap with @src
- * @dst_n: size of @dst in bytes
- * @spec: the ringbufer spec for @src
- * @endianness: the expected byte order of the payloaded data
- *
- * Payloads @src in the form specified by IEC 61937 for the type from @spec and
- * stores the result in @dst. @src must contain exactly one frame of data and
- * the frame is not checked for errors.
- *
- * Returns: transfer-full: %TRUE if the payloading was successful, %FALSE
- * otherwise.
- */
-gboolean
-gst_audio_iec61937_payload (const guint8 * src, guint src_n, guint8 * dst,
-    guint dst_n, const GstAudioRingBufferSpec * spec, gint endianness)
+/* writes the 8 byte burst preamble for the frame in @src to @dst */
+static gboolean
+iec61937_write_header (const guint8 * src, guint src_n, guint8 * dst,
+    const GstAudioRingBufferSpec * spec)
 {
-  guint i, tmp;
+  guint tmp;
 #if G_BYTE_ORDER == G_BIG_ENDIAN
   guint8 zero = 0, one = 1, two = 2, three = 3, four = 4, five = 5, six = 6,
       seven = 7;
@@ -169,14 +157,6 @@ gst_audio_iec61937_payload (const guint8 * src, guint src_n, guint8 * dst,
       seven = 6;
 #endif
 
-  g_return_val_if_fail (src != NULL, FALSE);
-  g_return_val_if_fail (dst != NULL, FALSE);
-  g_return_val_if_fail (src != dst, FALSE);
-  g_return_val_if_fail (dst_n >= gst_audio_iec61937_frame_size (spec), FALSE);
-
-  if (dst_n < src_n + IEC61937_HEADER_SIZE)
-    return FALSE;
-
   /* Pa, Pb */
   dst[zero] = 0xF8;
   dst[one] = 0x72;
@@ -337,30 +317,201 @@ gst_audio_iec61937_payload (const guint8 * src, guint src_n, guint8 * dst,
       return FALSE;
   }
 
+  return TRUE;
+}
+
+/* copies @src_n bytes from @src to @dst with every 2 bytes swapped, an odd
+ * last byte is padded with 0 so that GST_ROUND_UP_2 (@src_n) bytes are
+ * written */
+static void
+iec61937_swap_16 (guint8 * dst, const guint8 * src, guint src_n)
+{
+  guint i = 0;
+
+#if defined (__SSE2__)
+  for (; i + 16 <= src_n; i += 16) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (src + i));
+
+    _mm_storeu_si128 ((__m128i *) (dst + i),
+        _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8)));
+  }
+#endif
+  for (; i + 1 < src_n; i += 2) {
+    dst[i] = src[i + 1];
+    dst[i + 1] = src[i];
+  }
+  /* Do we have 1 byte remaining? */
+  if (src_n % 2) {
+    dst[i] = 0;
+    dst[i + 1] = src[i];
+  }
+}
+
+/**
+ * gst_audio_iec61937_payload:
+ * @src: (array length=src_n): a buffer containing the data to payload
+ * @src_n: size of @src in bytes
+ * @dst: (array length=dst_n): the destination buffer to store the
+ *       payloaded contents in. Should not overlap with @src
+ * @dst_n: size of @dst in bytes
+ * @spec: the ringbufer spec for @src
+ * @endianness: the expected byte order of the payloaded data
+ *
+ * Payloads @src in the form specified by IEC 61937 for the type from @spec and
+ * stores the result in @dst. @src must contain exactly one frame of data and
+ * the frame is not checked for errors.
+ *
+ * Returns: transfer-full: %TRUE if the payloading was successful, %FALSE
+ * otherwise.
+ */
+gboolean
+gst_audio_iec61937_payload (const guint8 * src, guint src_n, guint8 * dst,
+    guint dst_n, const GstAudioRingBufferSpec * spec, gint endianness)
+{
+  guint i;
+
+  g_return_val_if_fail (src != NULL, FALSE);
+  g_return_val_if_fail (dst != NULL, FALSE);
+  g_return_val_if_fail (src != dst, FALSE);
+  g_return_val_if_fail (dst_n >= gst_audio_iec61937_frame_size (spec), FALSE);
+
+  if (dst_n < src_n + IEC61937_HEADER_SIZE)
+    return FALSE;
+
+  if (!iec61937_write_header (src, src_n, dst, spec))
+    return FALSE;
+
   /* Copy the payload */
-  i = 8;
+  i = IEC61937_HEADER_SIZE;
 
   if (G_BYTE_ORDER == endianness) {
     memcpy (dst + i, src, src_n);
+    i += src_n;
   } else {
     /* Byte-swapped again */
-    /* FIXME: orc-ify this */
-    for (tmp = 1; tmp < src_n; tmp += 2) {
-      dst[i + tmp - 1] = src[tmp];
-      dst[i + tmp] = src[tmp - 1];
-    }
-    /* Do we have 1 byte remaining? */
-    if (src_n % 2) {
-      dst[i + src_n - 1] = 0;
-      dst[i + src_n] = src[src_n - 1];
-      i++;
-    }
+    iec61937_swap_16 (dst + i, src, src_n);
+    i += GST_ROUND_UP_2 (src_n);
   }
 
-  i += src_n;
-
   /* Zero the rest */
   memset (dst + i, 0, dst_n - i);
 
   return TRUE;
 }
+
+/* the padding of the bursts is shared from one block of zeroes of the
+ * largest frame size */
+#define IEC61937_ZERO_SIZE IEC61937_PAYLOAD_SIZE_EAC3
+
+static GstMemory *
+iec61937_get_zero_memory (void)
+{
+  static gsize zero_mem = 0;
+
+  if (g_once_init_enter (&zero_mem)) {
+    GstMemory *mem;
+    GstMapInfo map;
+
+    mem = gst_allocator_alloc (NULL, IEC61937_ZERO_SIZE, NULL);
+    gst_memory_map (mem, &map, GST_MAP_WRITE);
+    memset (map.data, 0, map.size);
+    gst_memory_unmap (mem, &map);
+    GST_MINI_OBJECT_FLAG_SET (mem, GST_MEMORY_FLAG_READONLY |
+        GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+
+    g_once_init_leave (&zero_mem, (gsize) mem);
+  }
+  return (GstMemory *) zero_mem;
+}
+
+/**
+ * gst_audio_iec61937_payload_buffer:
+ * @buffer: a buffer containing exactly one frame to payload
+ * @spec: the ringbufer spec for @buffer
+ * @endianness: the expected byte order of the payloaded data
+ *
+ * Payloads @buffer in the form specified by IEC 61937 for the type from
+ * @spec, like gst_audio_iec61937_payload(), without copying the frame when
+ * possible.
+ *
+ * The returned buffer of gst_audio_iec61937_frame_size() bytes is made of
+ * a memory with the burst preamble, the memory of @buffer, or a byte-swapped
+ * copy of it when @endianness is not the native byte order, and shared
+ * read-only memory for the zero padding. The metadata of @buffer is copied.
+ *
+ * Returns: (transfer full) (nullable): the payloaded buffer or %NULL if the
+ * payloading failed.
+ *
+ * Since: 1.10
+ */
+GstBuffer *
+gst_audio_iec61937_payload_buffer (GstBuffer * buffer,
+    const GstAudioRingBufferSpec * spec, gint endianness)
+{
+  GstBuffer *outbuf;
+  GstMemory *header, *mem;
+  GstMapInfo map, hmap;
+  guint frame_size, payload_n, pad;
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), NULL);
+  g_return_val_if_fail (spec != NULL, NULL);
+
+  frame_size = gst_audio_iec61937_frame_size (spec);
+  if (frame_size == 0)
+    return NULL;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    return NULL;
+
+  if (frame_size < map.size + IEC61937_HEADER_SIZE)
+    goto failed;
+
+  header = gst_allocator_alloc (NULL, IEC61937_HEADER_SIZE, NULL);
+  gst_memory_map (header, &hmap, GST_MAP_WRITE);
+  res = iec61937_write_header (map.data, map.size, hmap.data, spec);
+  gst_memory_unmap (header, &hmap);
+
+  if (!res) {
+    gst_memory_unref (header);
+    goto failed;
+  }
+
+  outbuf = gst_buffer_new ();
+  gst_buffer_copy_into (outbuf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+  gst_buffer_append_memory (outbuf, header);
+
+  if (G_BYTE_ORDER == endianness) {
+    payload_n = map.size;
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_copy_into (outbuf, buffer, GST_BUFFER_COPY_MEMORY, 0, -1);
+  } else {
+    GstMapInfo smap;
+
+    payload_n = GST_ROUND_UP_2 (map.size);
+    mem = gst_allocator_alloc (NULL, payload_n, NULL);
+    gst_memory_map (mem, &smap, GST_MAP_WRITE);
+    iec61937_swap_16 (smap.data, map.data, map.size);
+    gst_memory_unmap (mem, &smap);
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_append_memory (outbuf, mem);
+  }
+
+  /* Zero the rest */
+  pad = frame_size - IEC61937_HEADER_SIZE - payload_n;
+  while (pad > 0) {
+    guint n = MIN (pad, IEC61937_ZERO_SIZE);
+
+    mem = gst_memory_share (iec61937_get_zero_memory (), 0, n);
+    gst_buffer_append_memory (outbuf, mem);
+    pad -= n;
+  }
+
+  return outbuf;
+
+failed:
+  {
+    gst_buffer_unmap (buffer, &map);
+    return NULL;
+  }
+}
@@ -29,5 +29,8 @@ gboolean    gst_audio_iec61937_payload     (const guint8 * src, guint src_n,
                                             guint8 * dst, guint dst_n,
                                             const GstAudioRingBufferSpec * spec,
                                             gint endianness);
+GstBuffer * gst_audio_iec61937_payload_buffer (GstBuffer * buffer,
+                                            const GstAudioRingBufferSpec * spec,
+                                            gint endianness);
 
 #endif /* __GST_AUDIO_IEC61937_H__ */
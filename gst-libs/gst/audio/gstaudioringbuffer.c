@@ -34,17 +34,108 @@
  * abstraction for DMA based ringbuffers as well as a pure software
  * implementations.
  * </para>
+ * <para>
+ * A thread waiting for a segment to become available is woken up by
+ * gst_audio_ring_buffer_advance(). On Linux this is done with a futex and
+ * without taking the object lock, elsewhere with the #GCond of the
+ * ringbuffer. The latency between the wakeup and the moment the waiting
+ * thread runs again can be retrieved with gst_audio_ring_buffer_get_stats().
+ * </para>
  * </refsect2>
  */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <string.h>
 
+#ifdef HAVE_LINUX_FUTEX_H
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#define USE_FUTEX
+#endif
+
 #include <gst/audio/audio.h>
 #include "gstaudioringbuffer.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_ring_buffer_debug);
 #define GST_CAT_DEFAULT gst_audio_ring_buffer_debug
 
+#define GST_AUDIO_RING_BUFFER_GET_PRIVATE(obj)  \
+   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_AUDIO_RING_BUFFER, GstAudioRingBufferPrivate))
+
+/* futex waits time out after this many microseconds so that state changes
+ * that are only signalled with the GCond are noticed as well */
+#define FUTEX_WAIT_TIMEOUT 100000
+
+struct _GstAudioRingBufferPrivate
+{
+  /* ATOMIC, incremented for each wakeup, futex word */
+  gint wake_seq;
+  /* monotonic time of the last wakeup of a waiter */
+  gint64 wake_time;
+
+  /* ATOMIC, segments the writer or reader was too late for */
+  gint segments_missed;
+
+  /* with LOCK */
+  guint64 wakeups;
+  gint64 last_wake_latency;
+  gint64 max_wake_latency;
+  gint64 total_wake_latency;
+
+  /* ATOMIC, incremented whenever the published position becomes invalid */
+  gint pos_gen;
+  /* position published by the device thread with a seqlock: pos_seq is odd
+   * while the other fields are written. */
+  gint pos_seq;
+  gint pos_valid_gen;
+  guint64 pos_played;
+  guint64 pos_written;
+  gint64 pos_time;
+};
+
+#ifdef USE_FUTEX
+static void
+futex_wait (gint * addr, gint val, gint64 timeout)
+{
+  struct timespec ts;
+
+  ts.tv_sec = timeout / G_USEC_PER_SEC;
+  ts.tv_nsec = (timeout % G_USEC_PER_SEC) * 1000;
+
+  syscall (SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, &ts, NULL, 0);
+}
+
+static void
+futex_wake (gint * addr)
+{
+  syscall (SYS_futex, addr, FUTEX_WAKE_PRIVATE, G_MAXINT, NULL, NULL, 0);
+}
+#endif
+
+/* make readers stop using the published position until the device thread
+ * publishes a new one */
+static void
+gst_audio_ring_buffer_invalidate_position (GstAudioRingBuffer * buf)
+{
+  g_atomic_int_inc (&buf->priv->pos_gen);
+}
+
+/* wake up a thread blocked in wait_segment(), call with LOCK */
+static void
+gst_audio_ring_buffer_wake_waiter (GstAudioRingBuffer * buf)
+{
+  GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+#ifdef USE_FUTEX
+  g_atomic_int_inc (&buf->priv->wake_seq);
+  futex_wake (&buf->priv->wake_seq);
+#endif
+}
+
 static void gst_audio_ring_buffer_dispose (GObject * object);
 static void gst_audio_ring_buffer_finalize (GObject * object);
 
@@ -66,6 +157,8 @@ gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
   gobject_class = (GObjectClass *) klass;
   gstaudioringbuffer_class = (GstAudioRingBufferClass *) klass;
 
+  g_type_class_add_private (klass, sizeof (GstAudioRingBufferPrivate));
+
   GST_DEBUG_CATEGORY_INIT (gst_audio_ring_buffer_debug, "ringbuffer", 0,
       "ringbuffer class");
 
@@ -79,6 +172,7 @@ gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
 static void
 gst_audio_ring_buffer_init (GstAudioRingBuffer * ringbuffer)
 {
+  ringbuffer->priv = GST_AUDIO_RING_BUFFER_GET_PRIVATE (ringbuffer);
   ringbuffer->open = FALSE;
   ringbuffer->acquired = FALSE;
   ringbuffer->state = GST_AUDIO_RING_BUFFER_STATE_STOPPED;
@@ -566,6 +660,13 @@ gst_audio_ring_buffer_acquire (GstAudioRingBuffer * buf,
   buf->acquired = TRUE;
   buf->need_reorder = FALSE;
 
+  buf->priv->wakeups = 0;
+  buf->priv->last_wake_latency = 0;
+  buf->priv->max_wake_latency = 0;
+  buf->priv->total_wake_latency = 0;
+  g_atomic_int_set (&buf->priv->segments_missed, 0);
+  gst_audio_ring_buffer_invalidate_position (buf);
+
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->acquire))
     res = rclass->acquire (buf, spec);
@@ -691,7 +792,7 @@ gst_audio_ring_buffer_release (GstAudioRingBuffer * buf)
 
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
-  GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  gst_audio_ring_buffer_wake_waiter (buf);
 
   if (G_UNLIKELY (!res))
     goto release_failed;
@@ -990,6 +1091,8 @@ gst_audio_ring_buffer_pause_unlocked (GstAudioRingBuffer * buf)
 
   GST_DEBUG_OBJECT (buf, "pausing ringbuffer");
 
+  gst_audio_ring_buffer_invalidate_position (buf);
+
   /* if started, set to paused */
   res = g_atomic_int_compare_and_exchange (&buf->state,
       GST_AUDIO_RING_BUFFER_STATE_STARTED, GST_AUDIO_RING_BUFFER_STATE_PAUSED);
@@ -999,7 +1102,7 @@ gst_audio_ring_buffer_pause_unlocked (GstAudioRingBuffer * buf)
 
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
-  GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  gst_audio_ring_buffer_wake_waiter (buf);
 
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->pause))
@@ -1086,6 +1189,8 @@ gst_audio_ring_buffer_stop (GstAudioRingBuffer * buf)
 
   GST_DEBUG_OBJECT (buf, "stopping");
 
+  gst_audio_ring_buffer_invalidate_position (buf);
+
   GST_OBJECT_LOCK (buf);
 
   /* if started, set to stopped */
@@ -1108,7 +1213,7 @@ gst_audio_ring_buffer_stop (GstAudioRingBuffer * buf)
 
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
-  GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  gst_audio_ring_buffer_wake_waiter (buf);
 
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->stop))
@@ -1201,6 +1306,109 @@ gst_audio_ring_buffer_samples_done (GstAudioRingBuffer * buf)
   return samples;
 }
 
+/**
+ * gst_audio_ring_buffer_publish_delay:
+ * @buf: the #GstAudioRingBuffer
+ * @delay: the number of samples queued in the device
+ *
+ * Publish the number of samples that are still queued in the device. This is
+ * used by subclasses in the thread that drives the device, usually right
+ * after gst_audio_ring_buffer_advance(), so that
+ * gst_audio_ring_buffer_samples_played() can be answered without calling
+ * into the device.
+ *
+ * Only one thread can publish the delay.
+ *
+ * Since: 1.10
+ */
+void
+gst_audio_ring_buffer_publish_delay (GstAudioRingBuffer * buf, guint delay)
+{
+  GstAudioRingBufferPrivate *priv;
+  guint64 written;
+
+  g_return_if_fail (GST_IS_AUDIO_RING_BUFFER (buf));
+
+  priv = buf->priv;
+  written = gst_audio_ring_buffer_samples_done (buf);
+
+  g_atomic_int_inc (&priv->pos_seq);
+  priv->pos_valid_gen = g_atomic_int_get (&priv->pos_gen);
+  priv->pos_written = written;
+  priv->pos_played = written > delay ? written - delay : 0;
+  priv->pos_time = g_get_monotonic_time ();
+  g_atomic_int_inc (&priv->pos_seq);
+}
+
+/**
+ * gst_audio_ring_buffer_samples_played:
+ * @buf: the #GstAudioRingBuffer
+ * @samples: (out): the number of samples played
+ *
+ * Get the number of samples that the device has processed, from the
+ * position that was last published with gst_audio_ring_buffer_publish_delay()
+ * and the time that passed since then. This never blocks and never calls
+ * into the device. The result is never more than the number of samples that
+ * were given to the device when the position was published.
+ *
+ * The position is extrapolated by at most one segment. The device thread
+ * publishes a new position for every segment, so a reader that is further
+ * away from the last publish sees a device that is stalled or underrunning
+ * and the position stops until the device thread publishes again, instead
+ * of running ahead of the device. The position can then lag the device by
+ * up to the time the device thread needs to notice, where
+ * gst_audio_ring_buffer_delay() would follow the device exactly.
+ *
+ * Returns: %TRUE when @samples was set, %FALSE when no valid position was
+ * published since the last start, pause or gst_audio_ring_buffer_set_sample()
+ * and gst_audio_ring_buffer_delay() should be used instead.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_audio_ring_buffer_samples_played (GstAudioRingBuffer * buf,
+    guint64 * samples)
+{
+  GstAudioRingBufferPrivate *priv;
+  guint64 played, written;
+  gint64 time, now;
+  guint64 elapsed;
+  gint seq, gen, rate;
+
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), FALSE);
+  g_return_val_if_fail (samples != NULL, FALSE);
+
+  priv = buf->priv;
+
+  do {
+    seq = g_atomic_int_get (&priv->pos_seq);
+    gen = priv->pos_valid_gen;
+    played = priv->pos_played;
+    written = priv->pos_written;
+    time = priv->pos_time;
+  } while ((seq & 1) || seq != g_atomic_int_get (&priv->pos_seq));
+
+  if (gen != g_atomic_int_get (&priv->pos_gen) || time == 0)
+    return FALSE;
+
+  if ((rate = buf->spec.info.rate) == 0)
+    return FALSE;
+
+  /* the device plays at its rate since the position was published, for at
+   * most the segment until the next publish */
+  now = g_get_monotonic_time ();
+  if (now > time) {
+    elapsed = gst_util_uint64_scale_int (now - time, rate, G_USEC_PER_SEC);
+    played += MIN (elapsed, (guint64) buf->samples_per_seg);
+  }
+
+  *samples = MIN (played, written);
+
+  return TRUE;
+}
+
 /**
  * gst_audio_ring_buffer_set_sample:
  * @buf: the #GstAudioRingBuffer to use
@@ -1230,6 +1438,7 @@ gst_audio_ring_buffer_set_sample (GstAudioRingBuffer * buf, guint64 sample)
    * position, round down to the beginning and keep track of
    * offset when calculating the processed samples. */
   buf->segbase = buf->segdone - sample / buf->samples_per_seg;
+  gst_audio_ring_buffer_invalidate_position (buf);
 
   gst_audio_ring_buffer_clear_all (buf);
 
@@ -1275,11 +1484,37 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
 }
 
 
+/* account the time between the wakeup and now, call with LOCK */
+static void
+update_wake_stats (GstAudioRingBuffer * buf, gint64 wait_start)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+  gint64 wake_time, latency;
+
+  wake_time = priv->wake_time;
+  /* timed out or woken up for another reason than an advance */
+  if (wake_time < wait_start)
+    return;
+
+  latency = g_get_monotonic_time () - wake_time;
+  priv->wakeups++;
+  priv->last_wake_latency = latency;
+  priv->max_wake_latency = MAX (priv->max_wake_latency, latency);
+  priv->total_wake_latency += latency;
+}
+
+/* wait until the segment counter moves away from @segdone, which is the
+ * value the caller checked, or until a state change. Returns FALSE when
+ * the ringbuffer is flushing or not started. */
 static gboolean
-wait_segment (GstAudioRingBuffer * buf)
+wait_segment (GstAudioRingBuffer * buf, gint segdone)
 {
   gint segments;
   gboolean wait = TRUE;
+  gint64 wait_start;
+#ifdef USE_FUTEX
+  gint seq;
+#endif
 
   /* buffer must be started now or we deadlock since nobody is reading */
   if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
@@ -1297,7 +1532,43 @@ wait_segment (GstAudioRingBuffer * buf)
     if (G_LIKELY (g_atomic_int_get (&buf->segdone) != segments))
       wait = FALSE;
   }
+#ifdef USE_FUTEX
+  /* read the wakeup counter before announcing that we wait, any wakeup
+   * after this point makes the futex wait return immediately */
+  seq = g_atomic_int_get (&buf->priv->wake_seq);
 
+  if (G_UNLIKELY (buf->flushing))
+    goto flushing_unlocked;
+
+  if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+          GST_AUDIO_RING_BUFFER_STATE_STARTED))
+    goto not_started_unlocked;
+
+  if (G_LIKELY (wait)) {
+    g_atomic_int_set (&buf->waiting, 1);
+
+    /* only sleep when nothing advanced since the caller checked */
+    if (G_LIKELY (g_atomic_int_get (&buf->segdone) == segdone)) {
+      GST_DEBUG_OBJECT (buf, "waiting..");
+      wait_start = g_get_monotonic_time ();
+      futex_wait (&buf->priv->wake_seq, seq, FUTEX_WAIT_TIMEOUT);
+
+      GST_OBJECT_LOCK (buf);
+      update_wake_stats (buf, wait_start);
+      GST_OBJECT_UNLOCK (buf);
+    }
+    g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+
+    if (G_UNLIKELY (buf->flushing))
+      goto flushing_unlocked;
+
+    if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+            GST_AUDIO_RING_BUFFER_STATE_STARTED))
+      goto not_started_unlocked;
+  }
+
+  return TRUE;
+#else
   /* take lock first, then update our waiting flag */
   GST_OBJECT_LOCK (buf);
   if (G_UNLIKELY (buf->flushing))
@@ -1309,8 +1580,16 @@ wait_segment (GstAudioRingBuffer * buf)
 
   if (G_LIKELY (wait)) {
     if (g_atomic_int_compare_and_exchange (&buf->waiting, 0, 1)) {
-      GST_DEBUG_OBJECT (buf, "waiting..");
-      GST_AUDIO_RING_BUFFER_WAIT (buf);
+      /* the segment may have advanced before we set the waiting flag, in
+       * which case nobody will signal us for it */
+      if (G_UNLIKELY (g_atomic_int_get (&buf->segdone) != segdone)) {
+        g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+      } else {
+        GST_DEBUG_OBJECT (buf, "waiting..");
+        wait_start = g_get_monotonic_time ();
+        GST_AUDIO_RING_BUFFER_WAIT (buf);
+        update_wake_stats (buf, wait_start);
+      }
 
       if (G_UNLIKELY (buf->flushing))
         goto flushing;
@@ -1323,8 +1602,23 @@ wait_segment (GstAudioRingBuffer * buf)
   GST_OBJECT_UNLOCK (buf);
 
   return TRUE;
+#endif
 
   /* ERROR */
+#ifdef USE_FUTEX
+not_started_unlocked:
+  {
+    g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+    GST_DEBUG_OBJECT (buf, "stopped processing");
+    return FALSE;
+  }
+flushing_unlocked:
+  {
+    g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+    GST_DEBUG_OBJECT (buf, "flushing");
+    return FALSE;
+  }
+#else
 not_started:
   {
     g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
@@ -1339,6 +1633,7 @@ flushing:
     GST_OBJECT_UNLOCK (buf);
     return FALSE;
   }
+#endif
 no_start:
   {
     GST_DEBUG_OBJECT (buf, "not allowed to start");
@@ -1525,6 +1820,7 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       /* segment too far ahead, writer too slow, we need to drop, hopefully UNLIKELY */
       if (G_UNLIKELY (diff < 0)) {
         /* we need to drop one segment at a time, pretend we wrote a segment. */
+        g_atomic_int_inc (&buf->priv->segments_missed);
         skip = TRUE;
         break;
       }
@@ -1537,7 +1833,7 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       }
 
       /* else we need to wait for the segment to become writable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segdone + buf->segbase))
         goto not_started;
     }
 
@@ -1742,6 +2038,7 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
       /* segment too far ahead, reader too slow */
       if (G_UNLIKELY (diff >= segtotal)) {
         /* pretend we read an empty segment. */
+        g_atomic_int_inc (&buf->priv->segments_missed);
         sampleslen = MIN (sps, to_read);
         memcpy (data, buf->empty_seg, sampleslen * bpf);
         goto next;
@@ -1753,7 +2050,7 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
         break;
 
       /* else we need to wait for the segment to become readable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segdone + buf->segbase))
         goto not_started;
     }
 
@@ -1875,17 +2172,86 @@ gst_audio_ring_buffer_advance (GstAudioRingBuffer * buf, guint advance)
   /* update counter */
   g_atomic_int_add (&buf->segdone, advance);
 
-  /* the lock is already taken when the waiting flag is set,
-   * we grab the lock as well to make sure the waiter is actually
-   * waiting for the signal */
   if (g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0)) {
+    buf->priv->wake_time = g_get_monotonic_time ();
+#ifdef USE_FUTEX
+    /* the waiter only sleeps when the wakeup counter did not change since
+     * it set the waiting flag, no lock is needed */
+    GST_DEBUG_OBJECT (buf, "wake waiter");
+    g_atomic_int_inc (&buf->priv->wake_seq);
+    futex_wake (&buf->priv->wake_seq);
+#else
+    /* the lock is already taken when the waiting flag is set,
+     * we grab the lock as well to make sure the waiter is actually
+     * waiting for the signal */
     GST_OBJECT_LOCK (buf);
     GST_DEBUG_OBJECT (buf, "signal waiter");
     GST_AUDIO_RING_BUFFER_SIGNAL (buf);
     GST_OBJECT_UNLOCK (buf);
+#endif
   }
 }
 
+/**
+ * gst_audio_ring_buffer_get_stats:
+ * @buf: the #GstAudioRingBuffer
+ *
+ * Get statistics about the wakeups of the thread that waits for free or
+ * filled segments in @buf. The returned structure contains:
+ *
+ * "wakeups" G_TYPE_UINT64: the number of times a waiting thread was woken
+ * up by gst_audio_ring_buffer_advance().
+ *
+ * "last-wake-latency" G_TYPE_UINT64: the time between the last wakeup and
+ * the moment the waiting thread was running again, as a #GstClockTime.
+ *
+ * "max-wake-latency" G_TYPE_UINT64: the worst wake latency.
+ *
+ * "average-wake-latency" G_TYPE_UINT64: the average wake latency.
+ *
+ * "missed-segments" G_TYPE_UINT: the number of segments that were skipped
+ * because the writer was too late to fill them or the reader too late to
+ * read them before they were overwritten.
+ *
+ * The statistics are reset when @buf is acquired.
+ *
+ * Returns: (transfer full): a new #GstStructure with the statistics.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+GstStructure *
+gst_audio_ring_buffer_get_stats (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv;
+  GstStructure *s;
+  guint64 wakeups;
+  gint64 last, max, total;
+
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), NULL);
+
+  priv = buf->priv;
+
+  GST_OBJECT_LOCK (buf);
+  wakeups = priv->wakeups;
+  last = priv->last_wake_latency;
+  max = priv->max_wake_latency;
+  total = priv->total_wake_latency;
+  GST_OBJECT_UNLOCK (buf);
+
+  s = gst_structure_new ("application/x-gst-audio-ring-buffer-stats",
+      "wakeups", G_TYPE_UINT64, wakeups,
+      "last-wake-latency", G_TYPE_UINT64, (guint64) last * GST_USECOND,
+      "max-wake-latency", G_TYPE_UINT64, (guint64) max * GST_USECOND,
+      "average-wake-latency", G_TYPE_UINT64,
+      wakeups ? (guint64) (total / wakeups) * GST_USECOND : 0,
+      "missed-segments", G_TYPE_UINT,
+      (guint) g_atomic_int_get (&priv->segments_missed), NULL);
+
+  return s;
+}
+
 /**
  * gst_audio_ring_buffer_clear:
  * @buf: the #GstAudioRingBuffer to clear
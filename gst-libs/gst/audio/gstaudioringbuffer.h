@@ -38,6 +38,7 @@ G_BEGIN_DECLS
 #define GST_IS_AUDIO_RING_BUFFER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_AUDIO_RING_BUFFER))
 
 typedef struct _GstAudioRingBuffer GstAudioRingBuffer;
+typedef struct _GstAudioRingBufferPrivate GstAudioRingBufferPrivate;
 typedef struct _GstAudioRingBufferClass GstAudioRingBufferClass;
 typedef struct _GstAudioRingBufferSpec GstAudioRingBufferSpec;
 
@@ -206,7 +207,9 @@ struct _GstAudioRingBuffer {
   gboolean                    active;
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  GstAudioRingBufferPrivate  *priv;
+
+  gpointer _gst_reserved[GST_PADDING - 1];
 };
 
 /**
@@ -304,6 +307,9 @@ gboolean        gst_audio_ring_buffer_stop            (GstAudioRingBuffer *buf);
 guint           gst_audio_ring_buffer_delay           (GstAudioRingBuffer *buf);
 guint64         gst_audio_ring_buffer_samples_done    (GstAudioRingBuffer *buf);
 
+void            gst_audio_ring_buffer_publish_delay   (GstAudioRingBuffer *buf, guint delay);
+gboolean        gst_audio_ring_buffer_samples_played  (GstAudioRingBuffer *buf, guint64 *samples);
+
 void            gst_audio_ring_buffer_set_sample      (GstAudioRingBuffer *buf, guint64 sample);
 
 /* clear all segments */
@@ -331,6 +337,9 @@ gboolean        gst_audio_ring_buffer_prepare_read    (GstAudioRingBuffer *buf,
 void            gst_audio_ring_buffer_clear           (GstAudioRingBuffer *buf, gint segment);
 void            gst_audio_ring_buffer_advance         (GstAudioRingBuffer *buf, guint advance);
 
+/* stats */
+GstStructure *  gst_audio_ring_buffer_get_stats       (GstAudioRingBuffer *buf);
+
 void            gst_audio_ring_buffer_may_start       (GstAudioRingBuffer *buf, gboolean allowed);
 
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
@@ -269,6 +269,11 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
 
       /* we wrote one segment */
       gst_audio_ring_buffer_advance (buf, 1);
+
+      /* we own the device here, let the clock know how far it is so that
+       * it doesn't have to ask */
+      gst_audio_ring_buffer_publish_delay (buf,
+          gst_audio_ring_buffer_delay (buf));
     } else {
       GST_OBJECT_LOCK (abuf);
       if (!abuf->running)
@@ -19,10 +19,27 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* for CPU_SET and pthread_setaffinity_np */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#include <string.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_SCHED_H
+#include <sched.h>
+#endif
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
 #include <gst/audio/audio.h>
 #include "gstaudioutilsprivate.h"
 
@@ -142,3 +159,89 @@ done:
 
   return fcaps;
 }
+
+/*
+ * Give the calling thread real-time priority @priority with SCHED_FIFO
+ * and pin it to the CPUs in @cpu_mask. A @priority or @cpu_mask of 0
+ * leaves the respective setting alone. The priority is lowered to the
+ * RLIMIT_RTPRIO limit when the process is not allowed to use it.
+ *
+ * Returns FALSE and logs a warning on @obj when one of the settings could
+ * not be applied.
+ */
+gboolean
+__gst_audio_set_thread_priority (GstObject * obj, gint priority,
+    guint64 cpu_mask)
+{
+  gboolean res = TRUE;
+
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_SCHED_H)
+  if (priority > 0) {
+    struct sched_param param;
+    gint max, err;
+
+    max = sched_get_priority_max (SCHED_FIFO);
+    priority = MIN (priority, max);
+#if defined (HAVE_SYS_RESOURCE_H) && defined (RLIMIT_RTPRIO)
+    {
+      struct rlimit rl;
+
+      /* unprivileged processes can only go up to the limit */
+      if (getrlimit (RLIMIT_RTPRIO, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY
+          && rl.rlim_cur > 0 && priority > (gint) rl.rlim_cur) {
+        GST_INFO_OBJECT (obj, "limiting priority %d to RLIMIT_RTPRIO %d",
+            priority, (gint) rl.rlim_cur);
+        priority = rl.rlim_cur;
+      }
+    }
+#endif
+    memset (&param, 0, sizeof (param));
+    param.sched_priority = priority;
+
+    err = pthread_setschedparam (pthread_self (), SCHED_FIFO, &param);
+    if (err != 0) {
+      GST_WARNING_OBJECT (obj, "could not set SCHED_FIFO priority %d: %s",
+          priority, g_strerror (err));
+      res = FALSE;
+    } else {
+      GST_DEBUG_OBJECT (obj, "thread running with SCHED_FIFO priority %d",
+          priority);
+    }
+  }
+#else
+  if (priority > 0) {
+    GST_WARNING_OBJECT (obj, "real-time scheduling is not supported");
+    res = FALSE;
+  }
+#endif
+
+#if defined (HAVE_PTHREAD_H) && defined (__linux__)
+  if (cpu_mask != 0) {
+    cpu_set_t set;
+    gint i, err;
+
+    CPU_ZERO (&set);
+    for (i = 0; i < 64; i++) {
+      if (cpu_mask & (G_GUINT64_CONSTANT (1) << i))
+        CPU_SET (i, &set);
+    }
+
+    err = pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+    if (err != 0) {
+      GST_WARNING_OBJECT (obj, "could not set CPU affinity 0x%"
+          G_GINT64_MODIFIER "x: %s", cpu_mask, g_strerror (err));
+      res = FALSE;
+    } else {
+      GST_DEBUG_OBJECT (obj, "thread pinned to CPU mask 0x%"
+          G_GINT64_MODIFIER "x", cpu_mask);
+    }
+  }
+#else
+  if (cpu_mask != 0) {
+    GST_WARNING_OBJECT (obj, "setting the CPU affinity is not supported");
+    res = FALSE;
+  }
+#endif
+
+  return res;
+}
@@ -36,6 +36,10 @@ GstCaps *__gst_audio_element_proxy_getcaps (GstElement * element, GstPad * sinkp
                                             GstPad * srcpad, GstCaps * initial_caps,
                                             GstCaps * filter);
 
+G_GNUC_INTERNAL
+gboolean  __gst_audio_set_thread_priority   (GstObject * obj, gint priority,
+                                             guint64 cpu_mask);
+
 G_END_DECLS
 
 #endif
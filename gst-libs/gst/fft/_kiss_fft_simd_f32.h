@@ -0,0 +1,166 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the radix 2 and 4 butterflies. They handle 2 complex
+ * samples per iteration and do exactly the same operations in the same
+ * order as the C macros so that the results are bit identical. They
+ * return the number of butterflies done, the caller does the remainder. */
+
+#if defined (__SSE2__)
+#define HAVE_KF_SIMD_F32
+#include <emmintrin.h>
+
+typedef __m128 kf_v4sf;
+
+#define V_LOAD(p)       _mm_loadu_ps ((const float *) (p))
+#define V_STORE(p,v)    _mm_storeu_ps ((float *) (p), v)
+#define V_ADD(a,b)      _mm_add_ps (a, b)
+#define V_SUB(a,b)      _mm_sub_ps (a, b)
+#define V_MUL(a,b)      _mm_mul_ps (a, b)
+/* (r0,i0,r1,i1) -> (i0,r0,i1,r1) */
+#define V_SWAP(a)       _mm_shuffle_ps (a, a, _MM_SHUFFLE (2, 3, 0, 1))
+#define V_DUP_RE(a)     _mm_shuffle_ps (a, a, _MM_SHUFFLE (2, 2, 0, 0))
+#define V_DUP_IM(a)     _mm_shuffle_ps (a, a, _MM_SHUFFLE (3, 3, 1, 1))
+#define V_SIGN_RE()     _mm_setr_ps (-1.0f, 1.0f, -1.0f, 1.0f)
+#define V_SIGN_IM()     _mm_setr_ps (1.0f, -1.0f, 1.0f, -1.0f)
+
+static inline kf_v4sf
+kf_load_tw2 (const kiss_fft_f32_cpx * a, const kiss_fft_f32_cpx * b)
+{
+  __m128 v = _mm_setzero_ps ();
+
+  v = _mm_loadl_pi (v, (const __m64 *) a);
+  return _mm_loadh_pi (v, (const __m64 *) b);
+}
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define HAVE_KF_SIMD_F32
+#include <arm_neon.h>
+
+typedef float32x4_t kf_v4sf;
+
+#define V_LOAD(p)       vld1q_f32 ((const float *) (p))
+#define V_STORE(p,v)    vst1q_f32 ((float *) (p), v)
+#define V_ADD(a,b)      vaddq_f32 (a, b)
+#define V_SUB(a,b)      vsubq_f32 (a, b)
+#define V_MUL(a,b)      vmulq_f32 (a, b)
+#define V_SWAP(a)       vrev64q_f32 (a)
+#define V_DUP_RE(a)     vtrnq_f32 (a, a).val[0]
+#define V_DUP_IM(a)     vtrnq_f32 (a, a).val[1]
+
+static inline kf_v4sf
+kf_sign (float a, float b)
+{
+  const float s[4] = { a, b, a, b };
+
+  return vld1q_f32 (s);
+}
+
+#define V_SIGN_RE()     kf_sign (-1.0f, 1.0f)
+#define V_SIGN_IM()     kf_sign (1.0f, -1.0f)
+
+static inline kf_v4sf
+kf_load_tw2 (const kiss_fft_f32_cpx * a, const kiss_fft_f32_cpx * b)
+{
+  return vcombine_f32 (vld1_f32 ((const float *) a),
+      vld1_f32 ((const float *) b));
+}
+#endif
+
+#ifdef HAVE_KF_SIMD_F32
+
+/* C_MUL: (a.r*b.r - a.i*b.i, a.r*b.i + a.i*b.r), written as an addition of
+ * the negated product, which is exact */
+static inline kf_v4sf
+kf_cmul (kf_v4sf a, kf_v4sf b, kf_v4sf sign)
+{
+  return V_ADD (V_MUL (V_DUP_RE (a), b),
+      V_MUL (sign, V_MUL (V_DUP_IM (a), V_SWAP (b))));
+}
+
+static size_t
+kf_bfly2_simd (kiss_fft_f32_cpx * Fout, const size_t fstride,
+    const kiss_fft_f32_cfg st, size_t m)
+{
+  const kiss_fft_f32_cpx *tw = st->twiddles;
+  const kf_v4sf sign = V_SIGN_RE ();
+  size_t k;
+
+  for (k = 0; k + 2 <= m; k += 2) {
+    kf_v4sf f0 = V_LOAD (Fout + k);
+    kf_v4sf t = kf_cmul (V_LOAD (Fout + k + m),
+        kf_load_tw2 (tw + k * fstride, tw + (k + 1) * fstride), sign);
+
+    V_STORE (Fout + k + m, V_SUB (f0, t));
+    V_STORE (Fout + k, V_ADD (f0, t));
+  }
+  return k;
+}
+
+static size_t
+kf_bfly4_simd (kiss_fft_f32_cpx * Fout, const size_t fstride,
+    const kiss_fft_f32_cfg st, const size_t m)
+{
+  const kiss_fft_f32_cpx *tw = st->twiddles;
+  const kf_v4sf sign = V_SIGN_RE ();
+  /* multiplies (i,r) into (i,-r) for the rotation by -j, or the other way
+   * around for the inverse */
+  const kf_v4sf rot = st->inverse ? V_SIGN_RE () : V_SIGN_IM ();
+  const size_t m2 = 2 * m;
+  const size_t m3 = 3 * m;
+  size_t k;
+
+  for (k = 0; k + 2 <= m; k += 2) {
+    kf_v4sf f0, s0, s1, s2, s3, s4, s5, t;
+
+    s0 = kf_cmul (V_LOAD (Fout + k + m),
+        kf_load_tw2 (tw + k * fstride, tw + (k + 1) * fstride), sign);
+    s1 = kf_cmul (V_LOAD (Fout + k + m2),
+        kf_load_tw2 (tw + 2 * k * fstride, tw + 2 * (k + 1) * fstride), sign);
+    s2 = kf_cmul (V_LOAD (Fout + k + m3),
+        kf_load_tw2 (tw + 3 * k * fstride, tw + 3 * (k + 1) * fstride), sign);
+
+    f0 = V_LOAD (Fout + k);
+    s5 = V_SUB (f0, s1);
+    f0 = V_ADD (f0, s1);
+    s3 = V_ADD (s0, s2);
+    s4 = V_SUB (s0, s2);
+    V_STORE (Fout + k + m2, V_SUB (f0, s3));
+    V_STORE (Fout + k, V_ADD (f0, s3));
+
+    /* forward: (s5.r + s4.i, s5.i - s4.r) and (s5.r - s4.i, s5.i + s4.r) */
+    t = V_MUL (V_SWAP (s4), rot);
+    V_STORE (Fout + k + m, V_ADD (s5, t));
+    V_STORE (Fout + k + m3, V_SUB (s5, t));
+  }
+  return k;
+}
+
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_SWAP
+#undef V_DUP_RE
+#undef V_DUP_IM
+#undef V_SIGN_RE
+#undef V_SIGN_IM
+
+#endif /* HAVE_KF_SIMD_F32 */
@@ -0,0 +1,233 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD version of the radix 4 butterfly. It handles 4 complex samples per
+ * iteration and rounds exactly like the fixed point C macros: the products
+ * are summed in 32 bits and rounded once with sround(). Returns the number
+ * of butterflies done, the caller does the remainder. */
+
+#if defined (__SSE2__)
+#define HAVE_KF_SIMD_S16
+#include <emmintrin.h>
+
+#define KF_ROUND (1 << (FRACBITS - 1))
+
+/* sround (smul (x, SAMP_MAX / 4)) */
+static inline __m128i
+kf_fixdiv4 (__m128i x)
+{
+  const __m128i k = _mm_set1_epi16 (SAMP_MAX / 4);
+  const __m128i r = _mm_set1_epi32 (KF_ROUND);
+  __m128i lo = _mm_mullo_epi16 (x, k);
+  __m128i hi = _mm_mulhi_epi16 (x, k);
+  __m128i p0 = _mm_unpacklo_epi16 (lo, hi);
+  __m128i p1 = _mm_unpackhi_epi16 (lo, hi);
+
+  p0 = _mm_srai_epi32 (_mm_add_epi32 (p0, r), FRACBITS);
+  p1 = _mm_srai_epi32 (_mm_add_epi32 (p1, r), FRACBITS);
+
+  return _mm_packs_epi32 (p0, p1);
+}
+
+/* (r,i) pairs -> (i,r) pairs */
+static inline __m128i
+kf_swap (__m128i a)
+{
+  a = _mm_shufflelo_epi16 (a, _MM_SHUFFLE (2, 3, 0, 1));
+  return _mm_shufflehi_epi16 (a, _MM_SHUFFLE (2, 3, 0, 1));
+}
+
+/* negate the real (mask 0x0000ffff) or imaginary (0xffff0000) parts */
+static inline __m128i
+kf_negate (__m128i a, __m128i mask)
+{
+  __m128i n = _mm_sub_epi16 (_mm_setzero_si128 (), a);
+
+  return _mm_or_si128 (_mm_and_si128 (mask, n), _mm_andnot_si128 (mask, a));
+}
+
+static inline __m128i
+kf_cmul (__m128i a, __m128i b)
+{
+  const __m128i imag = _mm_set1_epi32 ((gint32) 0xffff0000);
+  const __m128i r = _mm_set1_epi32 (KF_ROUND);
+  __m128i re, im;
+
+  /* a.r*b.r - a.i*b.i and a.r*b.i + a.i*b.r, in 32 bits */
+  re = _mm_madd_epi16 (a, kf_negate (b, imag));
+  im = _mm_madd_epi16 (a, kf_swap (b));
+
+  re = _mm_srai_epi32 (_mm_add_epi32 (re, r), FRACBITS);
+  im = _mm_srai_epi32 (_mm_add_epi32 (im, r), FRACBITS);
+
+  return _mm_packs_epi32 (_mm_unpacklo_epi32 (re, im),
+      _mm_unpackhi_epi32 (re, im));
+}
+
+static inline __m128i
+kf_load_tw4 (const kiss_fft_s16_cpx * tw, size_t stride)
+{
+  gint32 t[4];
+
+  memcpy (&t[0], tw, 4);
+  memcpy (&t[1], tw + stride, 4);
+  memcpy (&t[2], tw + 2 * stride, 4);
+  memcpy (&t[3], tw + 3 * stride, 4);
+
+  return _mm_loadu_si128 ((const __m128i *) t);
+}
+
+static size_t
+kf_bfly4_simd (kiss_fft_s16_cpx * Fout, const size_t fstride,
+    const kiss_fft_s16_cfg st, const size_t m)
+{
+  const kiss_fft_s16_cpx *tw = st->twiddles;
+  /* the rotation by -j negates the new imaginary part, the inverse
+   * rotation the new real part */
+  const __m128i rot = _mm_set1_epi32 (st->inverse ? 0x0000ffff :
+      (gint32) 0xffff0000);
+  const size_t m2 = 2 * m;
+  const size_t m3 = 3 * m;
+  size_t k;
+
+  for (k = 0; k + 4 <= m; k += 4) {
+    __m128i f0, f1, f2, f3, s0, s1, s2, s3, s4, s5, t;
+
+    f0 = kf_fixdiv4 (_mm_loadu_si128 ((const __m128i *) (Fout + k)));
+    f1 = kf_fixdiv4 (_mm_loadu_si128 ((const __m128i *) (Fout + k + m)));
+    f2 = kf_fixdiv4 (_mm_loadu_si128 ((const __m128i *) (Fout + k + m2)));
+    f3 = kf_fixdiv4 (_mm_loadu_si128 ((const __m128i *) (Fout + k + m3)));
+
+    s0 = kf_cmul (f1, kf_load_tw4 (tw + k * fstride, fstride));
+    s1 = kf_cmul (f2, kf_load_tw4 (tw + 2 * k * fstride, 2 * fstride));
+    s2 = kf_cmul (f3, kf_load_tw4 (tw + 3 * k * fstride, 3 * fstride));
+
+    s5 = _mm_sub_epi16 (f0, s1);
+    f0 = _mm_add_epi16 (f0, s1);
+    s3 = _mm_add_epi16 (s0, s2);
+    s4 = _mm_sub_epi16 (s0, s2);
+    _mm_storeu_si128 ((__m128i *) (Fout + k + m2), _mm_sub_epi16 (f0, s3));
+    _mm_storeu_si128 ((__m128i *) (Fout + k), _mm_add_epi16 (f0, s3));
+
+    t = kf_negate (kf_swap (s4), rot);
+    _mm_storeu_si128 ((__m128i *) (Fout + k + m), _mm_add_epi16 (s5, t));
+    _mm_storeu_si128 ((__m128i *) (Fout + k + m3), _mm_sub_epi16 (s5, t));
+  }
+  return k;
+}
+
+#undef KF_ROUND
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define HAVE_KF_SIMD_S16
+#include <arm_neon.h>
+
+static inline int16x4x2_t
+kf_load_tw4 (const kiss_fft_s16_cpx * tw, size_t stride)
+{
+  int16x4x2_t t = vld2_dup_s16 ((const int16_t *) tw);
+
+  t = vld2_lane_s16 ((const int16_t *) (tw + stride), t, 1);
+  t = vld2_lane_s16 ((const int16_t *) (tw + 2 * stride), t, 2);
+  t = vld2_lane_s16 ((const int16_t *) (tw + 3 * stride), t, 3);
+
+  return t;
+}
+
+/* the rounding doubling multiply is sround (smul (x, SAMP_MAX / 4)) */
+static inline int16x4x2_t
+kf_load_fixdiv4 (const kiss_fft_s16_cpx * p)
+{
+  int16x4x2_t v = vld2_s16 ((const int16_t *) p);
+
+  v.val[0] = vqrdmulh_n_s16 (v.val[0], SAMP_MAX / 4);
+  v.val[1] = vqrdmulh_n_s16 (v.val[1], SAMP_MAX / 4);
+
+  return v;
+}
+
+static inline int16x4x2_t
+kf_cmul (int16x4x2_t a, int16x4x2_t b)
+{
+  int16x4x2_t m;
+
+  m.val[0] = vrshrn_n_s32 (vmlsl_s16 (vmull_s16 (a.val[0], b.val[0]),
+          a.val[1], b.val[1]), FRACBITS);
+  m.val[1] = vrshrn_n_s32 (vmlal_s16 (vmull_s16 (a.val[0], b.val[1]),
+          a.val[1], b.val[0]), FRACBITS);
+
+  return m;
+}
+
+static size_t
+kf_bfly4_simd (kiss_fft_s16_cpx * Fout, const size_t fstride,
+    const kiss_fft_s16_cfg st, const size_t m)
+{
+  const kiss_fft_s16_cpx *tw = st->twiddles;
+  const size_t m2 = 2 * m;
+  const size_t m3 = 3 * m;
+  size_t k;
+
+  for (k = 0; k + 4 <= m; k += 4) {
+    int16x4x2_t f0, f1, f2, f3, s0, s1, s2, s3, s4, s5, o;
+
+    f0 = kf_load_fixdiv4 (Fout + k);
+    f1 = kf_load_fixdiv4 (Fout + k + m);
+    f2 = kf_load_fixdiv4 (Fout + k + m2);
+    f3 = kf_load_fixdiv4 (Fout + k + m3);
+
+    s0 = kf_cmul (f1, kf_load_tw4 (tw + k * fstride, fstride));
+    s1 = kf_cmul (f2, kf_load_tw4 (tw + 2 * k * fstride, 2 * fstride));
+    s2 = kf_cmul (f3, kf_load_tw4 (tw + 3 * k * fstride, 3 * fstride));
+
+    s5.val[0] = vsub_s16 (f0.val[0], s1.val[0]);
+    s5.val[1] = vsub_s16 (f0.val[1], s1.val[1]);
+    f0.val[0] = vadd_s16 (f0.val[0], s1.val[0]);
+    f0.val[1] = vadd_s16 (f0.val[1], s1.val[1]);
+    s3.val[0] = vadd_s16 (s0.val[0], s2.val[0]);
+    s3.val[1] = vadd_s16 (s0.val[1], s2.val[1]);
+    s4.val[0] = vsub_s16 (s0.val[0], s2.val[0]);
+    s4.val[1] = vsub_s16 (s0.val[1], s2.val[1]);
+
+    o.val[0] = vsub_s16 (f0.val[0], s3.val[0]);
+    o.val[1] = vsub_s16 (f0.val[1], s3.val[1]);
+    vst2_s16 ((int16_t *) (Fout + k + m2), o);
+    o.val[0] = vadd_s16 (f0.val[0], s3.val[0]);
+    o.val[1] = vadd_s16 (f0.val[1], s3.val[1]);
+    vst2_s16 ((int16_t *) (Fout + k), o);
+
+    if (st->inverse) {
+      o.val[0] = vsub_s16 (s5.val[0], s4.val[1]);
+      o.val[1] = vadd_s16 (s5.val[1], s4.val[0]);
+      vst2_s16 ((int16_t *) (Fout + k + m), o);
+      o.val[0] = vadd_s16 (s5.val[0], s4.val[1]);
+      o.val[1] = vsub_s16 (s5.val[1], s4.val[0]);
+      vst2_s16 ((int16_t *) (Fout + k + m3), o);
+    } else {
+      o.val[0] = vadd_s16 (s5.val[0], s4.val[1]);
+      o.val[1] = vsub_s16 (s5.val[1], s4.val[0]);
+      vst2_s16 ((int16_t *) (Fout + k + m), o);
+      o.val[0] = vsub_s16 (s5.val[0], s4.val[1]);
+      o.val[1] = vadd_s16 (s5.val[1], s4.val[0]);
+      vst2_s16 ((int16_t *) (Fout + k + m3), o);
+    }
+  }
+  return k;
+}
+#endif
@@ -53,6 +53,10 @@
  * to apply a window function to it. For this gst_fft_f32_window() can comfortably
  * be used.
  *
+ * To transform many, possibly overlapping, frames of a buffer at once use
+ * gst_fft_f32_fft_many(). It applies the window to each frame and reuses the
+ * precalculated window coefficients and twiddle factors for all frames.
+ *
  * Be aware, that you can't simply run gst_fft_f32_inverse_fft() on the
  * resulting frequency data of gst_fft_f32_fft() to get the original data back.
  * The relation between them is iFFT (FFT (x)) = x * nfft where nfft is the
@@ -66,6 +70,12 @@ struct _GstFFTF32
   void *cfg;
   gboolean inverse;
   gint len;
+
+  /* precalculated coefficients of the last used window */
+  GstFFTWindow window;
+  gdouble *window_coeffs;
+  /* a windowed frame for gst_fft_f32_fft_many() */
+  gfloat *frame;
 };
 
 /**
@@ -102,6 +112,7 @@ gst_fft_f32_new (gint len, gboolean inverse)
 
   self->inverse = inverse;
   self->len = len;
+  self->window = GST_FFT_WINDOW_RECTANGULAR;
 
   return self;
 }
@@ -169,51 +180,137 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
 void
 gst_fft_f32_free (GstFFTF32 * self)
 {
+  g_free (self->window_coeffs);
+  g_free (self->frame);
   g_free (self);
 }
 
-/**
- * gst_fft_f32_window:
- * @self: #GstFFTF32 instance for this call
- * @timedata: Time domain samples
- * @window: Window function to apply
- *
- * This calls the window function @window on the @timedata sample buffer.
- *
- */
-void
-gst_fft_f32_window (GstFFTF32 * self, gfloat * timedata, GstFFTWindow window)
+/* returns the coefficients of @window, calculating them only when the
+ * window changes. %NULL for the rectangular window. */
+static const gdouble *
+gst_fft_f32_get_window (GstFFTF32 * self, GstFFTWindow window)
 {
   gint i, len;
+  gdouble *coeffs;
 
-  g_return_if_fail (self);
-  g_return_if_fail (timedata);
+  if (window == GST_FFT_WINDOW_RECTANGULAR)
+    return NULL;
+
+  if (self->window_coeffs && self->window == window)
+    return self->window_coeffs;
 
   len = self->len;
+  if (self->window_coeffs == NULL)
+    self->window_coeffs = g_new (gdouble, len);
+  coeffs = self->window_coeffs;
 
   switch (window) {
-    case GST_FFT_WINDOW_RECTANGULAR:
-      /* do nothing */
-      break;
     case GST_FFT_WINDOW_HAMMING:
       for (i = 0; i < len; i++)
-        timedata[i] *= (0.53836 - 0.46164 * cos (2.0 * G_PI * i / len));
+        coeffs[i] = (0.53836 - 0.46164 * cos (2.0 * G_PI * i / len));
       break;
     case GST_FFT_WINDOW_HANN:
       for (i = 0; i < len; i++)
-        timedata[i] *= (0.5 - 0.5 * cos (2.0 * G_PI * i / len));
+        coeffs[i] = (0.5 - 0.5 * cos (2.0 * G_PI * i / len));
       break;
     case GST_FFT_WINDOW_BARTLETT:
       for (i = 0; i < len; i++)
-        timedata[i] *= (1.0 - fabs ((2.0 * i - len) / len));
+        coeffs[i] = (1.0 - fabs ((2.0 * i - len) / len));
       break;
     case GST_FFT_WINDOW_BLACKMAN:
       for (i = 0; i < len; i++)
-        timedata[i] *= (0.42 - 0.5 * cos ((2.0 * i) / len) +
+        coeffs[i] = (0.42 - 0.5 * cos ((2.0 * i) / len) +
             0.08 * cos ((4.0 * i) / len));
       break;
     default:
       g_assert_not_reached ();
       break;
   }
+  self->window = window;
+
+  return coeffs;
+}
+
+/**
+ * gst_fft_f32_window:
+ * @self: #GstFFTF32 instance for this call
+ * @timedata: Time domain samples
+ * @window: Window function to apply
+ *
+ * This calls the window function @window on the @timedata sample buffer.
+ *
+ */
+void
+gst_fft_f32_window (GstFFTF32 * self, gfloat * timedata, GstFFTWindow window)
+{
+  const gdouble *coeffs;
+  gint i, len;
+
+  g_return_if_fail (self);
+  g_return_if_fail (timedata);
+
+  /* rectangular, do nothing */
+  if (!(coeffs = gst_fft_f32_get_window (self, window)))
+    return;
+
+  len = self->len;
+  for (i = 0; i < len; i++)
+    timedata[i] *= coeffs[i];
+}
+
+/**
+ * gst_fft_f32_fft_many:
+ * @self: #GstFFTF32 instance for this call
+ * @timedata: Buffer of the samples in the time domain
+ * @hop: Number of samples between the start of two frames
+ * @n_frames: Number of frames to transform
+ * @window: Window function to apply to each frame
+ * @freqdata: Target buffer for the samples in the frequency domain
+ *
+ * This applies @window to @n_frames frames of @timedata, each starting @hop
+ * samples after the previous one, and performs the FFT on them. The result
+ * of frame n is put at offset n * (@len/2 + 1) in @freqdata. @timedata is
+ * not modified.
+ *
+ * The result is the same as calling gst_fft_f32_window() and
+ * gst_fft_f32_fft() on a copy of each frame.
+ *
+ * @timedata must have (@n_frames - 1) * @hop + @len samples and @freqdata
+ * must be large enough to hold @n_frames * (@len/2 + 1) #GstFFTF32Complex
+ * frequency domain samples.
+ *
+ * Since: 1.10
+ */
+void
+gst_fft_f32_fft_many (GstFFTF32 * self, const gfloat * timedata, gint hop,
+    gint n_frames, GstFFTWindow window, GstFFTF32Complex * freqdata)
+{
+  const gdouble *coeffs;
+  gint i, n, len, n_freq;
+
+  g_return_if_fail (self);
+  g_return_if_fail (!self->inverse);
+  g_return_if_fail (timedata);
+  g_return_if_fail (freqdata);
+  g_return_if_fail (hop > 0);
+  g_return_if_fail (n_frames >= 0);
+
+  len = self->len;
+  n_freq = len / 2 + 1;
+
+  coeffs = gst_fft_f32_get_window (self, window);
+  if (coeffs && self->frame == NULL)
+    self->frame = g_new (gfloat, len);
+
+  for (n = 0; n < n_frames; n++) {
+    const gfloat *in = timedata + (gsize) n * hop;
+
+    if (coeffs) {
+      for (i = 0; i < len; i++)
+        self->frame[i] = in[i] * coeffs[i];
+      in = self->frame;
+    }
+    kiss_fftr_f32 (self->cfg, in, (kiss_fft_f32_cpx *) freqdata);
+    freqdata += n_freq;
+  }
 }
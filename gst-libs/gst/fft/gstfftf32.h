@@ -53,6 +53,9 @@ void          gst_fft_f32_free          (GstFFTF32 *self);
 
 void          gst_fft_f32_fft           (GstFFTF32 *self, const gfloat *timedata,
                                          GstFFTF32Complex *freqdata);
+void          gst_fft_f32_fft_many      (GstFFTF32 *self, const gfloat *timedata,
+                                         gint hop, gint n_frames, GstFFTWindow window,
+                                         GstFFTF32Complex *freqdata);
 void          gst_fft_f32_inverse_fft   (GstFFTF32 *self, const GstFFTF32Complex *freqdata,
                                          gfloat *timedata);
 
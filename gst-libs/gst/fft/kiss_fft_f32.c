@@ -19,6 +19,7 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 /* The guts header contains all the multiplication and addition macros that are defined for
  fixed or floating point complex numbers.  It also delares the kf_ internal functions.
  */
+#include "_kiss_fft_simd_f32.h"
 
 static kiss_fft_f32_cpx *scratchbuf = NULL;
 static size_t nscratchbuf = 0;
@@ -44,6 +45,20 @@ kf_bfly2 (kiss_fft_f32_cpx * Fout,
   kiss_fft_f32_cpx t;
 
   Fout2 = Fout + m;
+
+#ifdef HAVE_KF_SIMD_F32
+  {
+    int done = kf_bfly2_simd (Fout, fstride, st, m);
+
+    if (done == m)
+      return;
+    Fout += done;
+    Fout2 += done;
+    tw1 += done * fstride;
+    m -= done;
+  }
+#endif
+
   do {
     C_FIXDIV (*Fout, 2);
     C_FIXDIV (*Fout2, 2);
@@ -69,6 +84,20 @@ kf_bfly4 (kiss_fft_f32_cpx * Fout,
 
   tw3 = tw2 = tw1 = st->twiddles;
 
+#ifdef HAVE_KF_SIMD_F32
+  {
+    size_t done = kf_bfly4_simd (Fout, fstride, st, m);
+
+    if (done == m)
+      return;
+    Fout += done;
+    tw1 += done * fstride;
+    tw2 += done * fstride * 2;
+    tw3 += done * fstride * 3;
+    k -= done;
+  }
+#endif
+
   do {
     C_FIXDIV (*Fout, 4);
     C_FIXDIV (Fout[m], 4);
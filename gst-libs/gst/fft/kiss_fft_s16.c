@@ -19,6 +19,7 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 /* The guts header contains all the multiplication and addition macros that are defined for
  fixed or floating point complex numbers.  It also delares the kf_ internal functions.
  */
+#include "_kiss_fft_simd_s16.h"
 
 static kiss_fft_s16_cpx *scratchbuf = NULL;
 static size_t nscratchbuf = 0;
@@ -69,6 +70,20 @@ kf_bfly4 (kiss_fft_s16_cpx * Fout,
 
   tw3 = tw2 = tw1 = st->twiddles;
 
+#ifdef HAVE_KF_SIMD_S16
+  {
+    size_t done = kf_bfly4_simd (Fout, fstride, st, m);
+
+    if (done == m)
+      return;
+    Fout += done;
+    tw1 += done * fstride;
+    tw2 += done * fstride * 2;
+    tw3 += done * fstride * 3;
+    k -= done;
+  }
+#endif
+
   do {
     C_FIXDIV (*Fout, 4);
     C_FIXDIV (Fout[m], 4);
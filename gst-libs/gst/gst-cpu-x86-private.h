@@ -0,0 +1,77 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_CPU_X86_PRIVATE_H__
+#define __GST_CPU_X86_PRIVATE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Orc doesn't know about all the x86 instruction sets, this asks the CPU
+ * directly. The default build doesn't require them, so the optimised
+ * functions are compiled for them with
+ *
+ *   #pragma GCC push_options
+ *   #pragma GCC target ("avx2")
+ *   ...
+ *   #pragma GCC pop_options
+ *
+ * when GST_CPU_X86_HAVE_TARGET is defined, and are only used after
+ * gst_cpu_x86_get_flags() reported the instruction set. */
+#if (defined (__i386__) || defined (__x86_64__)) && defined (__GNUC__) \
+    && !defined (__clang__) \
+    && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define GST_CPU_X86_HAVE_TARGET
+#endif
+
+typedef enum
+{
+  GST_CPU_X86_SSSE3   = (1 << 0),
+  GST_CPU_X86_AVX2    = (1 << 1),
+  GST_CPU_X86_FMA     = (1 << 2),
+  GST_CPU_X86_AVX512F = (1 << 3)
+} GstCpuX86Flags;
+
+static inline GstCpuX86Flags
+gst_cpu_x86_get_flags (void)
+{
+  guint flags = 0;
+
+#if defined (GST_CPU_X86_HAVE_TARGET)
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("ssse3"))
+    flags |= GST_CPU_X86_SSSE3;
+  if (__builtin_cpu_supports ("avx2"))
+    flags |= GST_CPU_X86_AVX2;
+  if (__builtin_cpu_supports ("fma"))
+    flags |= GST_CPU_X86_FMA;
+#if __GNUC__ >= 7
+  if (__builtin_cpu_supports ("avx512f"))
+    flags |= GST_CPU_X86_AVX512F;
+#endif
+#endif
+
+  return (GstCpuX86Flags) flags;
+}
+
+G_END_DECLS
+
+#endif /* __GST_CPU_X86_PRIVATE_H__ */
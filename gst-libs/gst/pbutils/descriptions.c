@@ -852,33 +852,87 @@ format_info_get_desc (const FormatInfo * info, const GstCaps * caps)
   return NULL;
 }
 
+/* 1 + index of the next record with the same media type, or 0 */
+static guint16 formats_next[G_N_ELEMENTS (formats)];
+
+/* maps the media type quark to 1 + index of its first record in formats,
+ * the other records of the media type follow via formats_next */
+static gpointer
+build_formats_index (gpointer data)
+{
+  GHashTable *ht;
+  gint i;
+
+  ht = g_hash_table_new (NULL, NULL);
+
+  /* backwards so that the first record of a media type ends up in ht */
+  for (i = G_N_ELEMENTS (formats) - 1; i >= 0; --i) {
+    gpointer key = GUINT_TO_POINTER (g_quark_from_static_string
+        (formats[i].type));
+
+    formats_next[i] = GPOINTER_TO_UINT (g_hash_table_lookup (ht, key));
+    g_hash_table_insert (ht, key, GUINT_TO_POINTER (i + 1));
+  }
+
+  return ht;
+}
+
 /* returns format info structure, will return NULL for dynamic media types! */
 static const FormatInfo *
 find_format_info (const GstCaps * caps)
 {
+  static GOnce index_once = G_ONCE_INIT;
   const GstStructure *s;
-  const gchar *media_type;
+  GHashTable *ht;
   guint i;
 
+  ht = g_once (&index_once, build_formats_index, NULL);
+
   s = gst_caps_get_structure (caps, 0);
-  media_type = gst_structure_get_name (s);
 
-  for (i = 0; i < G_N_ELEMENTS (formats); ++i) {
-    if (strcmp (media_type, formats[i].type) == 0) {
-      gboolean is_sys = FALSE;
+  i = GPOINTER_TO_UINT (g_hash_table_lookup (ht,
+          GUINT_TO_POINTER (gst_structure_get_name_id (s))));
 
-      if ((formats[i].flags & FLAG_SYSTEMSTREAM) == 0)
-        return &formats[i];
+  for (; i != 0; i = formats_next[i - 1]) {
+    gboolean is_sys = FALSE;
 
-      /* this record should only be matched if the systemstream field is set */
-      if (gst_structure_get_boolean (s, "systemstream", &is_sys) && is_sys)
-        return &formats[i];
-    }
+    if ((formats[i - 1].flags & FLAG_SYSTEMSTREAM) == 0)
+      return &formats[i - 1];
+
+    /* this record should only be matched if the systemstream field is set */
+    if (gst_structure_get_boolean (s, "systemstream", &is_sys) && is_sys)
+      return &formats[i - 1];
   }
 
   return NULL;
 }
 
+/* description of the format in the cleaned up, fixed @caps, with the
+ * result of find_format_info() for them */
+static gchar *
+format_get_codec_description (const FormatInfo * info, const GstCaps * caps)
+{
+  gchar *str, *comma;
+
+  if (info) {
+    str = format_info_get_desc (info, caps);
+  } else {
+    str = gst_caps_to_string (caps);
+
+    /* cut off everything after the media type, if there is anything */
+    if ((comma = strchr (str, ','))) {
+      *comma = '\0';
+      g_strchomp (str);
+      /* we could do something more elaborate here, like taking into account
+       * audio/, video/, image/ and application/ prefixes etc. */
+    }
+
+    GST_WARNING ("No description available for media type: %s", str);
+  }
+
+  return str;
+}
+
 static gboolean
 caps_are_rtp_caps (const GstCaps * caps, const gchar * media, gchar ** format)
 {
@@ -1031,8 +1085,8 @@ gst_pb_utils_get_decoder_description (const GstCaps * caps)
   } else {
     const FormatInfo *info;
 
-    str = gst_pb_utils_get_codec_description (tmp);
     info = find_format_info (tmp);
+    str = format_get_codec_description (info, tmp);
     if (info != NULL && (info->flags & FLAG_CONTAINER) != 0) {
       ret = g_strdup_printf (_("%s demuxer"), str);
     } else {
@@ -1082,8 +1136,8 @@ gst_pb_utils_get_encoder_description (const GstCaps * caps)
   } else {
     const FormatInfo *info;
 
-    str = gst_pb_utils_get_codec_description (tmp);
     info = find_format_info (tmp);
+    str = format_get_codec_description (info, tmp);
     if (info != NULL && (info->flags & FLAG_CONTAINER) != 0) {
       ret = g_strdup_printf (_("%s muxer"), str);
     } else {
@@ -1194,8 +1248,7 @@ gst_pb_utils_add_codec_description_to_tag_list (GstTagList * taglist,
 gchar *
 gst_pb_utils_get_codec_description (const GstCaps * caps)
 {
-  const FormatInfo *info;
-  gchar *str, *comma;
+  gchar *str;
   GstCaps *tmp;
 
   g_return_val_if_fail (caps != NULL, NULL);
@@ -1203,23 +1256,7 @@ gst_pb_utils_get_codec_description (const GstCaps * caps)
   tmp = copy_and_clean_caps (caps);
   g_return_val_if_fail (gst_caps_is_fixed (tmp), NULL);
 
-  info = find_format_info (tmp);
-
-  if (info) {
-    str = format_info_get_desc (info, tmp);
-  } else {
-    str = gst_caps_to_string (tmp);
-
-    /* cut off everything after the media type, if there is anything */
-    if ((comma = strchr (str, ','))) {
-      *comma = '\0';
-      g_strchomp (str);
-      /* we could do something more elaborate here, like taking into account
-       * audio/, video/, image/ and application/ prefixes etc. */
-    }
-
-    GST_WARNING ("No description available for media type: %s", str);
-  }
+  str = format_get_codec_description (find_format_info (tmp), tmp);
   gst_caps_unref (tmp);
 
   return str;
@@ -1229,27 +1266,25 @@ gst_pb_utils_get_codec_description (const GstCaps * caps)
 const gchar *pb_utils_get_file_extension_from_caps (const GstCaps * caps);
 gboolean pb_utils_is_tag (const GstCaps * caps);
 
+/* these only look at the media type and at fields that copy_and_clean_caps()
+ * keeps, so they don't need to copy the caps */
 const gchar *
 pb_utils_get_file_extension_from_caps (const GstCaps * caps)
 {
   const FormatInfo *info;
   const gchar *ext = NULL;
-  GstCaps *stripped_caps;
 
   g_assert (GST_IS_CAPS (caps));
+  g_assert (gst_caps_get_size (caps) > 0);
 
-  stripped_caps = copy_and_clean_caps (caps);
-
-  g_assert (gst_caps_is_fixed (stripped_caps));
-
-  info = find_format_info (stripped_caps);
+  info = find_format_info (caps);
 
   if (info && info->ext[0] != '\0') {
     ext = info->ext;
   } else if (info && info->desc == NULL) {
     const GstStructure *s;
 
-    s = gst_caps_get_structure (stripped_caps, 0);
+    s = gst_caps_get_structure (caps, 0);
 
     /* cases where we have to evaluate the caps more closely */
     if (strcmp (info->type, "audio/mpeg") == 0) {
@@ -1271,7 +1306,6 @@ pb_utils_get_file_extension_from_caps (const GstCaps * caps)
     }
   }
 
-  gst_caps_unref (stripped_caps);
   return ext;
 }
 
@@ -1279,21 +1313,16 @@ gboolean
 pb_utils_is_tag (const GstCaps * caps)
 {
   const FormatInfo *info;
-  GstCaps *stripped_caps;
   gboolean is_tag = FALSE;
 
   g_assert (GST_IS_CAPS (caps));
+  g_assert (gst_caps_get_size (caps) > 0);
 
-  stripped_caps = copy_and_clean_caps (caps);
-
-  g_assert (gst_caps_is_fixed (stripped_caps));
-
-  info = find_format_info (stripped_caps);
+  info = find_format_info (caps);
 
   if (info) {
     is_tag = (info->flags & FLAG_TAG) != 0;
   }
-  gst_caps_unref (stripped_caps);
 
   return is_tag;
 }
@@ -44,6 +44,13 @@
 #include "gstaudiovisualizer.h"
 #include "pbutils-enumtypes.h"
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#elif (defined (__ARM_NEON) || defined (__ARM_NEON__)) && \
+    G_BYTE_ORDER == G_LITTLE_ENDIAN
+#include <arm_neon.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (audio_visualizer_debug);
 #define GST_CAT_DEFAULT (audio_visualizer_debug)
 
@@ -161,14 +168,56 @@ G_STMT_START {                                            \
 
 #endif
 
+/* shade @width pixels of @s into @d. The pointers don't need to be aligned,
+ * the vertical move shaders use them with an offset of 1 byte. */
+static void
+shade_row (guint8 * d, const guint8 * s, gint width, guint32 shade_amount)
+{
+  guint r = (shade_amount >> 16) & 0xff;
+  guint g = (shade_amount >> 8) & 0xff;
+  guint b = (shade_amount >> 0) & 0xff;
+  gint i = 0;
+
+#if defined (__SSE2__)
+  {
+    /* a saturating subtract of 0x00rrggbb from every pixel and the x byte
+     * cleared is the same as SHADE */
+    const __m128i sub = _mm_set1_epi32 (shade_amount & 0xffffff);
+    const __m128i keep = _mm_set1_epi32 (0xffffff);
+
+    for (; i + 4 <= width; i += 4) {
+      __m128i v = _mm_loadu_si128 ((const __m128i *) (s + i * 4));
+
+      v = _mm_and_si128 (_mm_subs_epu8 (v, sub), keep);
+      _mm_storeu_si128 ((__m128i *) (d + i * 4), v);
+    }
+  }
+#elif (defined (__ARM_NEON) || defined (__ARM_NEON__)) && \
+    G_BYTE_ORDER == G_LITTLE_ENDIAN
+  {
+    const uint8x16_t sub =
+        vreinterpretq_u8_u32 (vdupq_n_u32 (shade_amount & 0xffffff));
+    const uint8x16_t keep = vreinterpretq_u8_u32 (vdupq_n_u32 (0xffffff));
+
+    for (; i + 4 <= width; i += 4) {
+      uint8x16_t v = vld1q_u8 (s + i * 4);
+
+      vst1q_u8 (d + i * 4, vandq_u8 (vqsubq_u8 (v, sub), keep));
+    }
+  }
+#endif
+
+  for (; i < width; i++) {
+    SHADE (d, s, i, r, g, b);
+  }
+}
+
 static void
 shader_fade (GstAudioVisualizer * scope, const GstVideoFrame * sframe,
     GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -181,9 +230,7 @@ shader_fade (GstAudioVisualizer * scope, const GstVideoFrame * sframe,
   height = GST_VIDEO_FRAME_HEIGHT (sframe);
 
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     s += ss;
     d += ds;
   }
@@ -193,10 +240,8 @@ static void
 shader_fade_and_move_up (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -210,9 +255,7 @@ shader_fade_and_move_up (GstAudioVisualizer * scope,
 
   for (j = 1; j < height; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     d += ds;
   }
 }
@@ -221,10 +264,8 @@ static void
 shader_fade_and_move_down (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -238,9 +279,7 @@ shader_fade_and_move_down (GstAudioVisualizer * scope,
 
   for (j = 1; j < height; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     s += ss;
   }
 }
@@ -249,10 +288,8 @@ static void
 shader_fade_and_move_left (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -269,9 +306,7 @@ shader_fade_and_move_left (GstAudioVisualizer * scope,
 
   /* move to the left */
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     d += ds;
     s += ss;
   }
@@ -281,10 +316,8 @@ static void
 shader_fade_and_move_right (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -301,9 +334,7 @@ shader_fade_and_move_right (GstAudioVisualizer * scope,
 
   /* move to the right */
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     d += ds;
     s += ss;
   }
@@ -313,10 +344,8 @@ static void
 shader_fade_and_move_horiz_out (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -331,17 +360,13 @@ shader_fade_and_move_horiz_out (GstAudioVisualizer * scope,
   /* move upper half up */
   for (j = 0; j < height / 2; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     d += ds;
   }
   /* move lower half down */
   for (j = 0; j < height / 2; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     s += ss;
   }
 }
@@ -350,10 +375,8 @@ static void
 shader_fade_and_move_horiz_in (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *d;
   gint ss, ds, width, height;
 
@@ -368,17 +391,13 @@ shader_fade_and_move_horiz_in (GstAudioVisualizer * scope,
   /* move upper half down */
   for (j = 0; j < height / 2; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     s += ss;
   }
   /* move lower half up */
   for (j = 0; j < height / 2; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    shade_row (d, s, width, shade);
     d += ds;
   }
 }
@@ -387,10 +406,8 @@ static void
 shader_fade_and_move_vert_out (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *s1, *d, *d1;
   gint ss, ds, width, height;
 
@@ -405,14 +422,11 @@ shader_fade_and_move_vert_out (GstAudioVisualizer * scope,
   for (j = 0; j < height; j++) {
     /* move left half to the left */
     s1 = s + 1;
-    for (i = 0; i < width / 2; i++) {
-      SHADE (d, s1, i, r, g, b);
-    }
+    shade_row (d, s1, width / 2, shade);
     /* move right half to the right */
     d1 = d + 1;
-    for (; i < width - 1; i++) {
-      SHADE (d1, s, i, r, g, b);
-    }
+    shade_row (d1 + (width / 2) * 4, s + (width / 2) * 4,
+        width - 1 - width / 2, shade);
     s += ss;
     d += ds;
   }
@@ -422,10 +436,8 @@ static void
 shader_fade_and_move_vert_in (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
+  guint32 shade = scope->priv->shade_amount;
+  guint j;
   guint8 *s, *s1, *d, *d1;
   gint ss, ds, width, height;
 
@@ -440,14 +452,11 @@ shader_fade_and_move_vert_in (GstAudioVisualizer * scope,
   for (j = 0; j < height; j++) {
     /* move left half to the right */
     d1 = d + 1;
-    for (i = 0; i < width / 2; i++) {
-      SHADE (d1, s, i, r, g, b);
-    }
+    shade_row (d1, s, width / 2, shade);
     /* move right half to the left */
     s1 = s + 1;
-    for (; i < width - 1; i++) {
-      SHADE (d, s1, i, r, g, b);
-    }
+    shade_row (d + (width / 2) * 4, s1 + (width / 2) * 4,
+        width - 1 - width / 2, shade);
     s += ss;
     d += ds;
   }
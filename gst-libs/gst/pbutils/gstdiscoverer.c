@@ -38,12 +38,21 @@
  * set a custom context using g_main_context_push_thread_default().
  *
  * All the information is returned in a #GstDiscovererInfo structure.
+ *
+ * When #GstDiscoverer:use-cache is set, the results for local files are
+ * stored in the user cache directory and served from there the next time
+ * the same, unmodified, file is discovered.
+ *
+ * When only the stream topology, the codecs, the tags and the duration are
+ * needed, #GstDiscoverer:parse-only avoids the cost of decoding.
  */
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#include <glib/gstdio.h>
+
 #include <gst/video/video.h>
 #include <gst/audio/audio.h>
 
@@ -62,9 +71,11 @@ static GQuark _STREAM_TOPOLOGY_QUARK;
 static GQuark _TOPOLOGY_PAD_QUARK;
 
 
+typedef struct _DiscovererPipeline DiscovererPipeline;
+
 typedef struct
 {
-  GstDiscoverer *dc;
+  DiscovererPipeline *dp;
   GstPad *pad;
   GstElement *queue;
   GstElement *sink;
@@ -73,24 +84,15 @@ typedef struct
   gchar *stream_id;
 } PrivateStream;
 
-struct _GstDiscovererPrivate
+/* A pipeline discovering one URI at a time. Pipelines are kept around and
+ * reused for the next pending URI once they are done. */
+struct _DiscovererPipeline
 {
-  gboolean async;
-
-  /* allowed time to discover each uri in nanoseconds */
-  GstClockTime timeout;
-
-  /* list of pending URI to process (current excluded) */
-  GList *pending_uris;
-
-  GMutex lock;
+  GstDiscoverer *dc;
 
   /* TRUE if processing a URI */
   gboolean processing;
 
-  /* TRUE if discoverer has been started */
-  gboolean running;
-
   /* TRUE if ASYNC_DONE has been received (need to check for subtitle tags) */
   gboolean async_done;
 
@@ -99,21 +101,25 @@ struct _GstDiscovererPrivate
   GError *current_error;
   GstStructure *current_topology;
 
+  /* cache file for the current uri and whether the info was loaded from it */
+  gchar *cachefile;
+  gboolean from_cache;
+
+  /* TRUE if autoplugging stops before the decoders for the current uri */
+  gboolean parse_only;
+
   /* List of private streams */
   GList *streams;
 
   /* List of these sinks and their handler IDs (to remove the probe) */
   guint pending_subtitle_pads;
 
-  /* Global elements */
+  /* Elements */
   GstBin *pipeline;
   GstElement *uridecodebin;
   GstBus *bus;
 
-  GType decodebin_type;
-
   /* Custom main context variables */
-  GMainContext *ctx;
   guint sourceid;
   guint timeoutid;
 
@@ -125,9 +131,45 @@ struct _GstDiscovererPrivate
   gulong pad_remove_id;
   gulong source_chg_id;
   gulong element_added_id;
+  gulong autoplug_continue_id;
   gulong bus_cb_id;
 };
 
+struct _GstDiscovererPrivate
+{
+  gboolean async;
+
+  /* allowed time to discover each uri in nanoseconds */
+  GstClockTime timeout;
+
+  /* maximum number of uris to discover at the same time */
+  guint max_parallel;
+
+  /* TRUE if results are stored in and loaded from the on-disk cache */
+  gboolean use_cache;
+
+  /* TRUE if no decoders are plugged, with the demuxers, parsers and
+   * depayloaders that are plugged instead */
+  gboolean parse_only;
+  GList *parse_factories;
+
+  /* list of pending URI to process (current excluded) */
+  GList *pending_uris;
+
+  GMutex lock;
+
+  /* TRUE if discoverer has been started */
+  gboolean running;
+
+  /* DiscovererPipeline, the first one is also used in synchronous mode */
+  GPtrArray *pipelines;
+
+  GType decodebin_type;
+
+  /* Custom main context variables */
+  GMainContext *ctx;
+};
+
 #define DISCO_LOCK(dc) g_mutex_lock (&dc->priv->lock);
 #define DISCO_UNLOCK(dc) g_mutex_unlock (&dc->priv->lock);
 
@@ -158,27 +200,34 @@ enum
 };
 
 #define DEFAULT_PROP_TIMEOUT 15 * GST_SECOND
+#define DEFAULT_PROP_MAX_PARALLEL 1
+#define DEFAULT_PROP_USE_CACHE FALSE
+#define DEFAULT_PROP_PARSE_ONLY FALSE
 
 enum
 {
   PROP_0,
-  PROP_TIMEOUT
+  PROP_TIMEOUT,
+  PROP_MAX_PARALLEL,
+  PROP_USE_CACHE,
+  PROP_PARSE_ONLY
 };
 
 static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
 
 static void gst_discoverer_set_timeout (GstDiscoverer * dc,
     GstClockTime timeout);
-static gboolean async_timeout_cb (GstDiscoverer * dc);
+static gboolean async_timeout_cb (DiscovererPipeline * dp);
+static gboolean async_cached_cb (DiscovererPipeline * dp);
 
 static void discoverer_bus_cb (GstBus * bus, GstMessage * msg,
-    GstDiscoverer * dc);
+    DiscovererPipeline * dp);
 static void uridecodebin_pad_added_cb (GstElement * uridecodebin, GstPad * pad,
-    GstDiscoverer * dc);
+    DiscovererPipeline * dp);
 static void uridecodebin_pad_removed_cb (GstElement * uridecodebin,
-    GstPad * pad, GstDiscoverer * dc);
+    GstPad * pad, DiscovererPipeline * dp);
 static void uridecodebin_source_changed_cb (GstElement * uridecodebin,
-    GParamSpec * pspec, GstDiscoverer * dc);
+    GParamSpec * pspec, DiscovererPipeline * dp);
 
 static void gst_discoverer_dispose (GObject * dc);
 static void gst_discoverer_finalize (GObject * dc);
@@ -215,6 +264,66 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
           GST_SECOND, 3600 * GST_SECOND, DEFAULT_PROP_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDiscoverer:max-parallel:
+   *
+   * The maximum number of URIs that are discovered at the same time in
+   * asynchronous mode. Each of them uses its own pipeline, which is kept
+   * and reused for the next pending URI once it is done.
+   *
+   * The #GstDiscoverer::discovered signal is still emitted once per URI from
+   * the main context, but with more than one URI in flight the order of the
+   * signals no longer follows the order in which the URIs were added.
+   *
+   * Synchronous discovery always uses a single pipeline.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PARALLEL,
+      g_param_spec_uint ("max-parallel", "Max parallel",
+          "Maximum number of URIs to discover at the same time",
+          1, G_MAXINT, DEFAULT_PROP_MAX_PARALLEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:use-cache:
+   *
+   * Whether to store the results of the discovery of local files in the
+   * user cache directory, and to use those instead of building a pipeline
+   * when the same file is discovered again.
+   *
+   * Entries are keyed on the URI, the size and the modification time of the
+   * file, so a modified file is discovered again. Only successful results
+   * are stored, and a #GstDiscovererInfo loaded from the cache contains what
+   * gst_discoverer_info_to_variant() serializes with
+   * %GST_DISCOVERER_SERIALIZE_ALL.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_CACHE,
+      g_param_spec_boolean ("use-cache", "Use cache",
+          "Use the on-disk cache of discovery results for local files",
+          DEFAULT_PROP_USE_CACHE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:parse-only:
+   *
+   * Whether to stop autoplugging at the output of the parsers instead of
+   * decoding the streams. No decoder is created, the caps of the streams are
+   * the parsed caps and the tags and the duration come from the demuxers and
+   * the parsers. This makes discovery a lot cheaper when only the topology,
+   * the codecs, the tags and the duration are needed.
+   *
+   * Information that is only known after decoding, like the sample depth of
+   * compressed audio, is not available in this mode.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PARSE_ONLY,
+      g_param_spec_boolean ("parse-only", "Parse only",
+          "Discover from the parsed streams without decoding them",
+          DEFAULT_PROP_PARSE_ONLY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDiscoverer::finished:
@@ -250,6 +359,9 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
    * Will be emitted in async mode when all information on a URI could be
    * discovered, or an error occurred.
    *
+   * With #GstDiscoverer:max-parallel larger than 1, URIs can be reported in
+   * a different order than they were added in.
+   *
    * When an error occurs, @info might still contain some partial information,
    * depending on the circumstances of the error.
    */
@@ -281,81 +393,182 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
 
 static void
 uridecodebin_element_added_cb (GstElement * uridecodebin,
-    GstElement * child, GstDiscoverer * dc)
+    GstElement * child, DiscovererPipeline * dp)
 {
   GST_DEBUG ("New element added to uridecodebin : %s",
       GST_ELEMENT_NAME (child));
 
-  if (G_OBJECT_TYPE (child) == dc->priv->decodebin_type) {
+  if (G_OBJECT_TYPE (child) == dp->dc->priv->decodebin_type) {
     g_object_set (child, "post-stream-topology", TRUE, NULL);
   }
 }
 
-static void
-gst_discoverer_init (GstDiscoverer * dc)
+/* In parse-only mode, keep plugging demuxers, parsers and depayloaders until
+ * the stream is parsed and stop before a decoder would be plugged */
+static gboolean
+uridecodebin_autoplug_continue_cb (GstElement * uridecodebin, GstPad * pad,
+    GstCaps * caps, DiscovererPipeline * dp)
 {
-  GstElement *tmp;
-  GstFormat format = GST_FORMAT_TIME;
+  const GstStructure *s;
+  gboolean parsed = FALSE;
+  GList *factories;
 
-  dc->priv = G_TYPE_INSTANCE_GET_PRIVATE (dc, GST_TYPE_DISCOVERER,
-      GstDiscovererPrivate);
+  if (!dp->parse_only || gst_caps_is_empty (caps) || gst_caps_is_any (caps))
+    return TRUE;
 
-  dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
-  dc->priv->async = FALSE;
-  dc->priv->async_done = FALSE;
+  s = gst_caps_get_structure (caps, 0);
+  if ((gst_structure_get_boolean (s, "parsed", &parsed) && parsed) ||
+      (gst_structure_get_boolean (s, "framed", &parsed) && parsed)) {
+    GST_DEBUG ("stopping at parsed caps %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
 
-  g_mutex_init (&dc->priv->lock);
+  /* the list is made before the pipeline is started and not changed */
+  factories = gst_element_factory_list_filter (dp->dc->priv->parse_factories,
+      caps, GST_PAD_SINK, FALSE);
+  if (factories == NULL) {
+    GST_DEBUG ("no parser for caps %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
+  gst_plugin_feature_list_free (factories);
 
-  dc->priv->pending_subtitle_pads = 0;
+  return TRUE;
+}
+
+static DiscovererPipeline *
+discoverer_pipeline_new (GstDiscoverer * dc)
+{
+  DiscovererPipeline *dp;
+  GstFormat format = GST_FORMAT_TIME;
+
+  dp = g_slice_new0 (DiscovererPipeline);
+  dp->dc = dc;
 
   GST_LOG ("Creating pipeline");
-  dc->priv->pipeline = (GstBin *) gst_pipeline_new ("Discoverer");
+  dp->pipeline = (GstBin *) gst_pipeline_new ("Discoverer");
   GST_LOG_OBJECT (dc, "Creating uridecodebin");
-  dc->priv->uridecodebin =
-      gst_element_factory_make ("uridecodebin", "discoverer-uri");
-  if (G_UNLIKELY (dc->priv->uridecodebin == NULL)) {
+  dp->uridecodebin = gst_element_factory_make ("uridecodebin", "discoverer-uri");
+  if (G_UNLIKELY (dp->uridecodebin == NULL)) {
     GST_ERROR ("Can't create uridecodebin");
-    return;
+    gst_object_unref (dp->pipeline);
+    g_slice_free (DiscovererPipeline, dp);
+    return NULL;
   }
   GST_LOG_OBJECT (dc, "Adding uridecodebin to pipeline");
-  gst_bin_add (dc->priv->pipeline, dc->priv->uridecodebin);
-
-  dc->priv->pad_added_id =
-      g_signal_connect_object (dc->priv->uridecodebin, "pad-added",
-      G_CALLBACK (uridecodebin_pad_added_cb), dc, 0);
-  dc->priv->pad_remove_id =
-      g_signal_connect_object (dc->priv->uridecodebin, "pad-removed",
-      G_CALLBACK (uridecodebin_pad_removed_cb), dc, 0);
-  dc->priv->source_chg_id =
-      g_signal_connect_object (dc->priv->uridecodebin, "notify::source",
-      G_CALLBACK (uridecodebin_source_changed_cb), dc, 0);
+  gst_bin_add (dp->pipeline, dp->uridecodebin);
+
+  dp->pad_added_id =
+      g_signal_connect (dp->uridecodebin, "pad-added",
+      G_CALLBACK (uridecodebin_pad_added_cb), dp);
+  dp->pad_remove_id =
+      g_signal_connect (dp->uridecodebin, "pad-removed",
+      G_CALLBACK (uridecodebin_pad_removed_cb), dp);
+  dp->source_chg_id =
+      g_signal_connect (dp->uridecodebin, "notify::source",
+      G_CALLBACK (uridecodebin_source_changed_cb), dp);
 
   GST_LOG_OBJECT (dc, "Getting pipeline bus");
-  dc->priv->bus = gst_pipeline_get_bus ((GstPipeline *) dc->priv->pipeline);
-
-  dc->priv->bus_cb_id =
-      g_signal_connect_object (dc->priv->bus, "message",
-      G_CALLBACK (discoverer_bus_cb), dc, 0);
+  dp->bus = gst_pipeline_get_bus ((GstPipeline *) dp->pipeline);
 
-  GST_DEBUG_OBJECT (dc, "Done initializing Discoverer");
+  dp->bus_cb_id =
+      g_signal_connect (dp->bus, "message",
+      G_CALLBACK (discoverer_bus_cb), dp);
 
   /* This is ugly. We get the GType of decodebin so we can quickly detect
    * when a decodebin is added to uridecodebin so we can set the
    * post-stream-topology setting to TRUE */
-  dc->priv->element_added_id =
-      g_signal_connect_object (dc->priv->uridecodebin, "element-added",
-      G_CALLBACK (uridecodebin_element_added_cb), dc, 0);
-  tmp = gst_element_factory_make ("decodebin", NULL);
-  dc->priv->decodebin_type = G_OBJECT_TYPE (tmp);
-  gst_object_unref (tmp);
+  dp->element_added_id =
+      g_signal_connect (dp->uridecodebin, "element-added",
+      G_CALLBACK (uridecodebin_element_added_cb), dp);
+
+  dp->autoplug_continue_id =
+      g_signal_connect (dp->uridecodebin, "autoplug-continue",
+      G_CALLBACK (uridecodebin_autoplug_continue_cb), dp);
 
   /* create queries */
-  dc->priv->seeking_query = gst_query_new_seeking (format);
+  dp->seeking_query = gst_query_new_seeking (format);
+
+  return dp;
+}
+
+#define DISCONNECT_SIGNAL(o,i) G_STMT_START{           \
+  if ((i) && g_signal_handler_is_connected ((o), (i))) \
+    g_signal_handler_disconnect ((o), (i));            \
+  (i) = 0;                                             \
+}G_STMT_END
+
+static void
+discoverer_pipeline_free (DiscovererPipeline * dp)
+{
+  /* Workaround for bug #118536 */
+  DISCONNECT_SIGNAL (dp->uridecodebin, dp->pad_added_id);
+  DISCONNECT_SIGNAL (dp->uridecodebin, dp->pad_remove_id);
+  DISCONNECT_SIGNAL (dp->uridecodebin, dp->source_chg_id);
+  DISCONNECT_SIGNAL (dp->uridecodebin, dp->element_added_id);
+  DISCONNECT_SIGNAL (dp->uridecodebin, dp->autoplug_continue_id);
+  DISCONNECT_SIGNAL (dp->bus, dp->bus_cb_id);
+
+  /* pipeline was set to NULL in _reset */
+  gst_object_unref (dp->pipeline);
+  gst_object_unref (dp->bus);
+
+  if (dp->seeking_query)
+    gst_query_unref (dp->seeking_query);
+
+  g_slice_free (DiscovererPipeline, dp);
+}
+
+/* attach the bus watch of the pipeline to the main context */
+static void
+discoverer_pipeline_start (DiscovererPipeline * dp)
+{
+  GSource *source;
+
+  source = gst_bus_create_watch (dp->bus);
+  g_source_set_callback (source, (GSourceFunc) gst_bus_async_signal_func,
+      NULL, NULL);
+  dp->sourceid = g_source_attach (source, dp->dc->priv->ctx);
+  g_source_unref (source);
+}
+
+static void
+gst_discoverer_init (GstDiscoverer * dc)
+{
+  GstElement *tmp;
+  DiscovererPipeline *dp;
+
+  dc->priv = G_TYPE_INSTANCE_GET_PRIVATE (dc, GST_TYPE_DISCOVERER,
+      GstDiscovererPrivate);
+
+  dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
+  dc->priv->max_parallel = DEFAULT_PROP_MAX_PARALLEL;
+  dc->priv->use_cache = DEFAULT_PROP_USE_CACHE;
+  dc->priv->parse_only = DEFAULT_PROP_PARSE_ONLY;
+  dc->priv->async = FALSE;
+
+  g_mutex_init (&dc->priv->lock);
+
+  dc->priv->pipelines = g_ptr_array_new ();
+
+  tmp = gst_element_factory_make ("decodebin", NULL);
+  if (tmp) {
+    dc->priv->decodebin_type = G_OBJECT_TYPE (tmp);
+    gst_object_unref (tmp);
+  }
+
+  dp = discoverer_pipeline_new (dc);
+  if (dp == NULL)
+    return;
+  g_ptr_array_add (dc->priv->pipelines, dp);
+
+  GST_DEBUG_OBJECT (dc, "Done initializing Discoverer");
 }
 
 static void
 discoverer_reset (GstDiscoverer * dc)
 {
+  guint i;
+
   GST_DEBUG_OBJECT (dc, "Resetting");
 
   if (dc->priv->pending_uris) {
@@ -364,15 +577,12 @@ discoverer_reset (GstDiscoverer * dc)
     dc->priv->pending_uris = NULL;
   }
 
-  if (dc->priv->pipeline)
-    gst_element_set_state ((GstElement *) dc->priv->pipeline, GST_STATE_NULL);
-}
+  for (i = 0; dc->priv->pipelines && i < dc->priv->pipelines->len; i++) {
+    DiscovererPipeline *dp = g_ptr_array_index (dc->priv->pipelines, i);
 
-#define DISCONNECT_SIGNAL(o,i) G_STMT_START{           \
-  if ((i) && g_signal_handler_is_connected ((o), (i))) \
-    g_signal_handler_disconnect ((o), (i));            \
-  (i) = 0;                                             \
-}G_STMT_END
+    gst_element_set_state ((GstElement *) dp->pipeline, GST_STATE_NULL);
+  }
+}
 
 static void
 gst_discoverer_dispose (GObject * obj)
@@ -383,28 +593,13 @@ gst_discoverer_dispose (GObject * obj)
 
   discoverer_reset (dc);
 
-  if (G_LIKELY (dc->priv->pipeline)) {
-    /* Workaround for bug #118536 */
-    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->pad_added_id);
-    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->pad_remove_id);
-    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->source_chg_id);
-    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->element_added_id);
-    DISCONNECT_SIGNAL (dc->priv->bus, dc->priv->bus_cb_id);
-
-    /* pipeline was set to NULL in _reset */
-    gst_object_unref (dc->priv->pipeline);
-    gst_object_unref (dc->priv->bus);
-
-    dc->priv->pipeline = NULL;
-    dc->priv->uridecodebin = NULL;
-    dc->priv->bus = NULL;
-  }
-
   gst_discoverer_stop (dc);
 
-  if (dc->priv->seeking_query) {
-    gst_query_unref (dc->priv->seeking_query);
-    dc->priv->seeking_query = NULL;
+  if (dc->priv->pipelines) {
+    g_ptr_array_foreach (dc->priv->pipelines,
+        (GFunc) discoverer_pipeline_free, NULL);
+    g_ptr_array_free (dc->priv->pipelines, TRUE);
+    dc->priv->pipelines = NULL;
   }
 
   G_OBJECT_CLASS (gst_discoverer_parent_class)->dispose (obj);
@@ -415,6 +610,7 @@ gst_discoverer_finalize (GObject * obj)
 {
   GstDiscoverer *dc = (GstDiscoverer *) obj;
 
+  gst_plugin_feature_list_free (dc->priv->parse_factories);
   g_mutex_clear (&dc->priv->lock);
 
   G_OBJECT_CLASS (gst_discoverer_parent_class)->finalize (obj);
@@ -430,6 +626,21 @@ gst_discoverer_set_property (GObject * object, guint prop_id,
     case PROP_TIMEOUT:
       gst_discoverer_set_timeout (dc, g_value_get_uint64 (value));
       break;
+    case PROP_MAX_PARALLEL:
+      DISCO_LOCK (dc);
+      dc->priv->max_parallel = g_value_get_uint (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_USE_CACHE:
+      DISCO_LOCK (dc);
+      dc->priv->use_cache = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_PARSE_ONLY:
+      DISCO_LOCK (dc);
+      dc->priv->parse_only = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -448,6 +659,21 @@ gst_discoverer_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, dc->priv->timeout);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_MAX_PARALLEL:
+      DISCO_LOCK (dc);
+      g_value_set_uint (value, dc->priv->max_parallel);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_USE_CACHE:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->use_cache);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_PARSE_ONLY:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->parse_only);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -476,10 +702,10 @@ _event_probe (GstPad * pad, GstPadProbeInfo * info, PrivateStream * ps)
 
       gst_event_parse_tag (event, &tl);
       GST_DEBUG_OBJECT (pad, "tags %" GST_PTR_FORMAT, tl);
-      DISCO_LOCK (ps->dc);
+      DISCO_LOCK (ps->dp->dc);
       /* If preroll is complete, drop these tags - the collected information is
        * possibly already being processed and adding more tags would be racy */
-      if (G_LIKELY (ps->dc->priv->processing)) {
+      if (G_LIKELY (ps->dp->processing)) {
         GST_DEBUG_OBJECT (pad, "private stream %p old tags %" GST_PTR_FORMAT,
             ps, ps->tags);
         tmp = gst_tag_list_merge (ps->tags, tl, GST_TAG_MERGE_APPEND);
@@ -490,7 +716,7 @@ _event_probe (GstPad * pad, GstPadProbeInfo * info, PrivateStream * ps)
             ps, tmp);
       } else
         GST_DEBUG_OBJECT (pad, "Dropping tags since preroll is done");
-      DISCO_UNLOCK (ps->dc);
+      DISCO_UNLOCK (ps->dp->dc);
       break;
     }
     case GST_EVENT_TOC:{
@@ -498,14 +724,14 @@ _event_probe (GstPad * pad, GstPadProbeInfo * info, PrivateStream * ps)
 
       gst_event_parse_toc (event, &tmp, NULL);
       GST_DEBUG_OBJECT (pad, "toc %" GST_PTR_FORMAT, tmp);
-      DISCO_LOCK (ps->dc);
+      DISCO_LOCK (ps->dp->dc);
       ps->toc = tmp;
-      if (G_LIKELY (ps->dc->priv->processing)) {
+      if (G_LIKELY (ps->dp->processing)) {
         GST_DEBUG_OBJECT (pad, "private stream %p toc %" GST_PTR_FORMAT, ps,
             tmp);
       } else
         GST_DEBUG_OBJECT (pad, "Dropping toc since preroll is done");
-      DISCO_UNLOCK (ps->dc);
+      DISCO_UNLOCK (ps->dp->dc);
       break;
     }
     case GST_EVENT_STREAM_START:{
@@ -543,8 +769,10 @@ is_subtitle_caps (const GstCaps * caps)
 }
 
 static GstPadProbeReturn
-got_subtitle_data (GstPad * pad, GstPadProbeInfo * info, GstDiscoverer * dc)
+got_subtitle_data (GstPad * pad, GstPadProbeInfo * info,
+    DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
 
   if (!(GST_IS_BUFFER (info->data) || (GST_IS_EVENT (info->data)
               && GST_EVENT_TYPE ((GstEvent *) info->data) == GST_EVENT_GAP)))
@@ -553,12 +781,12 @@ got_subtitle_data (GstPad * pad, GstPadProbeInfo * info, GstDiscoverer * dc)
 
   DISCO_LOCK (dc);
 
-  dc->priv->pending_subtitle_pads--;
+  dp->pending_subtitle_pads--;
 
-  if (dc->priv->pending_subtitle_pads == 0) {
+  if (dp->pending_subtitle_pads == 0) {
     GstMessage *msg = gst_message_new_application (NULL,
         gst_structure_new_empty ("DiscovererDone"));
-    gst_element_post_message ((GstElement *) dc->priv->pipeline, msg);
+    gst_element_post_message ((GstElement *) dp->pipeline, msg);
   }
   DISCO_UNLOCK (dc);
 
@@ -568,8 +796,9 @@ got_subtitle_data (GstPad * pad, GstPadProbeInfo * info, GstDiscoverer * dc)
 
 static void
 uridecodebin_source_changed_cb (GstElement * uridecodebin,
-    GParamSpec * pspec, GstDiscoverer * dc)
+    GParamSpec * pspec, DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
   GstElement *src;
   /* get a handle to the source */
   g_object_get (uridecodebin, pspec->name, &src, NULL);
@@ -582,8 +811,9 @@ uridecodebin_source_changed_cb (GstElement * uridecodebin,
 
 static void
 uridecodebin_pad_added_cb (GstElement * uridecodebin, GstPad * pad,
-    GstDiscoverer * dc)
+    DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
   PrivateStream *ps;
   GstPad *sinkpad = NULL;
   GstCaps *caps;
@@ -592,7 +822,7 @@ uridecodebin_pad_added_cb (GstElement * uridecodebin, GstPad * pad,
 
   ps = g_slice_new0 (PrivateStream);
 
-  ps->dc = dc;
+  ps->dp = dp;
   ps->pad = pad;
   ps->queue = gst_element_factory_make ("queue", NULL);
   ps->sink = gst_element_factory_make ("fakesink", NULL);
@@ -613,16 +843,16 @@ uridecodebin_pad_added_cb (GstElement * uridecodebin, GstPad * pad,
     /* Subtitle streams are sparse and may not provide any information - don't
      * wait for data to preroll */
     gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM,
-        (GstPadProbeCallback) got_subtitle_data, dc, NULL);
+        (GstPadProbeCallback) got_subtitle_data, dp, NULL);
     g_object_set (ps->sink, "async", FALSE, NULL);
     DISCO_LOCK (dc);
-    dc->priv->pending_subtitle_pads++;
+    dp->pending_subtitle_pads++;
     DISCO_UNLOCK (dc);
   }
 
   gst_caps_unref (caps);
 
-  gst_bin_add_many (dc->priv->pipeline, ps->queue, ps->sink, NULL);
+  gst_bin_add_many (dp->pipeline, ps->queue, ps->sink, NULL);
 
   if (!gst_element_link_pads_full (ps->queue, "src", ps->sink, "sink",
           GST_PAD_LINK_CHECK_NOTHING))
@@ -642,7 +872,7 @@ uridecodebin_pad_added_cb (GstElement * uridecodebin, GstPad * pad,
       (GstPadProbeCallback) _event_probe, ps, NULL);
 
   DISCO_LOCK (dc);
-  dc->priv->streams = g_list_append (dc->priv->streams, ps);
+  dp->streams = g_list_append (dp->streams, ps);
   DISCO_UNLOCK (dc);
 
   GST_DEBUG_OBJECT (dc, "Done handling pad");
@@ -663,8 +893,9 @@ error:
 
 static void
 uridecodebin_pad_removed_cb (GstElement * uridecodebin, GstPad * pad,
-    GstDiscoverer * dc)
+    DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
   GList *tmp;
   PrivateStream *ps;
   GstPad *sinkpad;
@@ -673,7 +904,7 @@ uridecodebin_pad_removed_cb (GstElement * uridecodebin, GstPad * pad,
 
   /* Find the PrivateStream */
   DISCO_LOCK (dc);
-  for (tmp = dc->priv->streams; tmp; tmp = tmp->next) {
+  for (tmp = dp->streams; tmp; tmp = tmp->next) {
     ps = (PrivateStream *) tmp->data;
     if (ps->pad == pad)
       break;
@@ -685,7 +916,7 @@ uridecodebin_pad_removed_cb (GstElement * uridecodebin, GstPad * pad,
     return;
   }
 
-  dc->priv->streams = g_list_delete_link (dc->priv->streams, tmp);
+  dp->streams = g_list_delete_link (dp->streams, tmp);
   DISCO_UNLOCK (dc);
 
   gst_element_set_state (ps->sink, GST_STATE_NULL);
@@ -697,7 +928,7 @@ uridecodebin_pad_removed_cb (GstElement * uridecodebin, GstPad * pad,
   gst_object_unref (sinkpad);
 
   /* references removed here */
-  gst_bin_remove_many (dc->priv->pipeline, ps->sink, ps->queue, NULL);
+  gst_bin_remove_many (dp->pipeline, ps->sink, ps->queue, NULL);
 
   if (ps->tags) {
     gst_tag_list_unref (ps->tags);
@@ -888,6 +1119,33 @@ collect_information (GstDiscoverer * dc, const GstStructure * st,
 
       info->interlaced =
           vinfo.interlace_mode != GST_VIDEO_INTERLACE_MODE_PROGRESSIVE;
+    } else {
+      const gchar *interlace_mode;
+      gint num, denom;
+
+      /* encoded caps from a parser or a stream without decoder */
+      if (gst_structure_get_int (caps_st, "width", &tmp))
+        info->width = (guint) tmp;
+      if (gst_structure_get_int (caps_st, "height", &tmp))
+        info->height = (guint) tmp;
+
+      info->par_num = info->par_denom = 1;
+      if (gst_structure_get_fraction (caps_st, "pixel-aspect-ratio", &num,
+              &denom) && num > 0 && denom > 0) {
+        info->par_num = (guint) num;
+        info->par_denom = (guint) denom;
+      }
+
+      if (gst_structure_get_fraction (caps_st, "framerate", &num, &denom) &&
+          num >= 0 && denom > 0) {
+        info->framerate_num = (guint) num;
+        info->framerate_denom = (guint) denom;
+      }
+
+      interlace_mode = gst_structure_get_string (caps_st, "interlace-mode");
+      info->interlaced = interlace_mode != NULL &&
+          gst_video_interlace_mode_from_string (interlace_mode) !=
+          GST_VIDEO_INTERLACE_MODE_PROGRESSIVE;
     }
 
     if (gst_structure_id_has_field (st, _TAGS_QUARK)) {
@@ -960,7 +1218,7 @@ collect_information (GstDiscoverer * dc, const GstStructure * st,
 }
 
 static GstStructure *
-find_stream_for_node (GstDiscoverer * dc, const GstStructure * topology)
+find_stream_for_node (DiscovererPipeline * dp, const GstStructure * topology)
 {
   GstPad *pad;
   GstPad *target_pad = NULL;
@@ -969,7 +1227,7 @@ find_stream_for_node (GstDiscoverer * dc, const GstStructure * topology)
   guint i;
   GList *tmp;
 
-  if (!dc->priv->streams) {
+  if (!dp->streams) {
     return NULL;
   }
 
@@ -981,7 +1239,7 @@ find_stream_for_node (GstDiscoverer * dc, const GstStructure * topology)
   gst_structure_id_get (topology, _TOPOLOGY_PAD_QUARK,
       GST_TYPE_PAD, &pad, NULL);
 
-  for (i = 0, tmp = dc->priv->streams; tmp; tmp = tmp->next, i++) {
+  for (i = 0, tmp = dp->streams; tmp; tmp = tmp->next, i++) {
     ps = (PrivateStream *) tmp->data;
 
     target_pad = gst_ghost_pad_get_target (GST_GHOST_PAD (ps->pad));
@@ -992,7 +1250,7 @@ find_stream_for_node (GstDiscoverer * dc, const GstStructure * topology)
   }
 
   if (tmp)
-    st = collect_stream_information (dc, ps, i);
+    st = collect_stream_information (dp->dc, ps, i);
 
   gst_object_unref (pad);
 
@@ -1048,9 +1306,10 @@ child_is_raw_stream (const GstCaps * parent, const GstCaps * child)
  * (and where the information exists, it will be overriden)
  */
 static GstDiscovererStreamInfo *
-parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
+parse_stream_topology (DiscovererPipeline * dp, const GstStructure * topology,
     GstDiscovererStreamInfo * parent)
 {
+  GstDiscoverer *dc = dp->dc;
   GstDiscovererStreamInfo *res = NULL;
   GstCaps *caps = NULL;
   const GValue *nval = NULL;
@@ -1060,7 +1319,7 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
   nval = gst_structure_get_value (topology, "next");
 
   if (nval == NULL || GST_VALUE_HOLDS_STRUCTURE (nval)) {
-    GstStructure *st = find_stream_for_node (dc, topology);
+    GstStructure *st = find_stream_for_node (dp, topology);
     gboolean add_to_list = TRUE;
 
     if (st) {
@@ -1089,15 +1348,15 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
            * since they might contain more information */
           gst_caps_replace (&parent->caps, caps);
 
-          parse_stream_topology (dc, st, parent);
+          parse_stream_topology (dp, st, parent);
           add_to_list = FALSE;
         } else if (child_is_raw_stream (parent->caps, caps)) {
           /* This is the "raw" stream corresponding to the parent. This
            * contains more information than the parent, tags etc. */
-          parse_stream_topology (dc, st, parent);
+          parse_stream_topology (dp, st, parent);
           add_to_list = FALSE;
         } else {
-          GstDiscovererStreamInfo *next = parse_stream_topology (dc, st, NULL);
+          GstDiscovererStreamInfo *next = parse_stream_topology (dp, st, NULL);
           res->next = next;
           next->previous = res;
         }
@@ -1106,8 +1365,8 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
     }
 
     if (add_to_list) {
-      dc->priv->current_info->stream_list =
-          g_list_append (dc->priv->current_info->stream_list, res);
+      dp->current_info->stream_list =
+          g_list_append (dp->current_info->stream_list, res);
     } else {
       gst_discoverer_stream_info_unref (res);
     }
@@ -1154,7 +1413,7 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
 
       GST_DEBUG ("%d %" GST_PTR_FORMAT, i, subst);
 
-      substream = parse_stream_topology (dc, subst, NULL);
+      substream = parse_stream_topology (dp, subst, NULL);
 
       substream->previous = res;
       cont->streams =
@@ -1166,29 +1425,131 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
   return res;
 }
 
+/* Cache code */
+
+/* Returns the cache file for @uri, or NULL if @uri can't be cached */
+static gchar *
+discoverer_cache_get_path (GstDiscoverer * dc, const gchar * uri)
+{
+  GStatBuf file_status;
+  gchar *location, *checksum, *filename, *res = NULL;
+
+  if (!gst_uri_has_protocol (uri, "file")) {
+    GST_LOG_OBJECT (dc, "Not caching non-file uri %s", uri);
+    return NULL;
+  }
+
+  location = g_filename_from_uri (uri, NULL, NULL);
+  if (location == NULL || !g_file_test (location, G_FILE_TEST_IS_REGULAR)) {
+    GST_LOG_OBJECT (dc, "Not caching %s, not a regular file", uri);
+    goto done;
+  }
+
+  if (g_stat (location, &file_status) < 0) {
+    GST_DEBUG_OBJECT (dc, "Could not stat %s", uri);
+    goto done;
+  }
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, uri, -1);
+  /* parse-only results have less information, keep them apart */
+  filename = g_strdup_printf ("%s-%" G_GINT64_FORMAT "-%" G_GINT64_FORMAT "%s",
+      checksum, (gint64) file_status.st_size, (gint64) file_status.st_mtime,
+      dc->priv->parse_only ? "-parsed" : "");
+  res = g_build_filename (g_get_user_cache_dir (), "gstreamer-"
+      GST_API_VERSION, "discoverer", filename, NULL);
+  g_free (filename);
+  g_free (checksum);
+
+done:
+  g_free (location);
+  return res;
+}
+
+static GstDiscovererInfo *
+discoverer_cache_load (GstDiscoverer * dc, const gchar * cachefile)
+{
+  GstDiscovererInfo *info = NULL;
+  GVariant *variant, *wrapped;
+  gchar *data;
+  gsize length;
+
+  if (!g_file_get_contents (cachefile, &data, &length, NULL))
+    return NULL;
+
+  variant = g_variant_new_from_data (G_VARIANT_TYPE_VARIANT, data, length,
+      FALSE, g_free, data);
+  g_variant_ref_sink (variant);
+
+  /* don't trust files that don't look like something we wrote */
+  wrapped = g_variant_get_variant (variant);
+  if (g_variant_is_of_type (wrapped, G_VARIANT_TYPE ("(vv)"))) {
+    GST_DEBUG_OBJECT (dc, "Using cached info from %s", cachefile);
+    info = gst_discoverer_info_from_variant (variant);
+  } else {
+    GST_WARNING_OBJECT (dc, "Invalid cache file %s", cachefile);
+  }
+  g_variant_unref (wrapped);
+  g_variant_unref (variant);
+
+  return info;
+}
+
+static void
+discoverer_cache_store (GstDiscoverer * dc, GstDiscovererInfo * info,
+    const gchar * cachefile)
+{
+  GVariant *variant;
+  gchar *dirname;
+  GError *err = NULL;
+
+  dirname = g_path_get_dirname (cachefile);
+  if (g_mkdir_with_parents (dirname, 0755) < 0) {
+    GST_WARNING_OBJECT (dc, "Could not create cache directory %s", dirname);
+    g_free (dirname);
+    return;
+  }
+  g_free (dirname);
+
+  variant = gst_discoverer_info_to_variant (info, GST_DISCOVERER_SERIALIZE_ALL);
+  g_variant_ref_sink (variant);
+
+  if (!g_file_set_contents (cachefile, g_variant_get_data (variant),
+          g_variant_get_size (variant), &err)) {
+    GST_WARNING_OBJECT (dc, "Could not write cache file %s: %s", cachefile,
+        err->message);
+    g_error_free (err);
+  } else {
+    GST_DEBUG_OBJECT (dc, "Stored info in %s", cachefile);
+  }
+
+  g_variant_unref (variant);
+}
+
 /* Called when pipeline is pre-rolled */
 static void
-discoverer_collect (GstDiscoverer * dc)
+discoverer_collect (DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
+
   GST_DEBUG ("Collecting information");
 
   /* Stop the timeout handler if present */
-  if (dc->priv->timeoutid) {
-    g_source_remove (dc->priv->timeoutid);
-    dc->priv->timeoutid = 0;
+  if (dp->timeoutid) {
+    g_source_remove (dp->timeoutid);
+    dp->timeoutid = 0;
   }
 
-  if (dc->priv->streams) {
+  if (dp->streams) {
     /* FIXME : Make this querying optional */
     if (TRUE) {
-      GstElement *pipeline = (GstElement *) dc->priv->pipeline;
+      GstElement *pipeline = (GstElement *) dp->pipeline;
       gint64 dur;
 
       GST_DEBUG ("Attempting to query duration");
 
       if (gst_element_query_duration (pipeline, GST_FORMAT_TIME, &dur)) {
         GST_DEBUG ("Got duration %" GST_TIME_FORMAT, GST_TIME_ARGS (dur));
-        dc->priv->current_info->duration = (guint64) dur;
+        dp->current_info->duration = (guint64) dur;
       } else {
         GstStateChangeReturn sret;
 
@@ -1208,7 +1569,7 @@ discoverer_collect (GstDiscoverer * dc)
             if (gst_element_query_duration (pipeline, GST_FORMAT_TIME, &dur)
                 && dur > 0) {
               GST_DEBUG ("Got duration %" GST_TIME_FORMAT, GST_TIME_ARGS (dur));
-              dc->priv->current_info->duration = (guint64) dur;
+              dp->current_info->duration = (guint64) dur;
               break;
             }
           }
@@ -1216,24 +1577,24 @@ discoverer_collect (GstDiscoverer * dc)
         }
       }
 
-      if (dc->priv->seeking_query) {
-        if (gst_element_query (pipeline, dc->priv->seeking_query)) {
+      if (dp->seeking_query) {
+        if (gst_element_query (pipeline, dp->seeking_query)) {
           GstFormat format;
           gboolean seekable;
 
-          gst_query_parse_seeking (dc->priv->seeking_query, &format,
+          gst_query_parse_seeking (dp->seeking_query, &format,
               &seekable, NULL, NULL);
           if (format == GST_FORMAT_TIME) {
             GST_DEBUG ("Got seekable %d", seekable);
-            dc->priv->current_info->seekable = seekable;
+            dp->current_info->seekable = seekable;
           }
         }
       }
     }
 
-    if (dc->priv->current_topology)
-      dc->priv->current_info->stream_info = parse_stream_topology (dc,
-          dc->priv->current_topology, NULL);
+    if (dp->current_topology)
+      dp->current_info->stream_info = parse_stream_topology (dp,
+          dp->current_topology, NULL);
 
     /*
      * Images need some special handling. They do not have a duration, have
@@ -1245,13 +1606,13 @@ discoverer_collect (GstDiscoverer * dc)
      * parsers in the chain, and if there's more than one decoder, or any
      * parser at all, we should not mark this as an image.
      */
-    if (dc->priv->current_info->duration == 0 &&
-        dc->priv->current_info->stream_info != NULL &&
-        dc->priv->current_info->stream_info->next == NULL) {
+    if (dp->current_info->duration == 0 &&
+        dp->current_info->stream_info != NULL &&
+        dp->current_info->stream_info->next == NULL) {
       GstDiscovererStreamInfo *stream_info;
       GstStructure *st;
 
-      stream_info = dc->priv->current_info->stream_info;
+      stream_info = dp->current_info->stream_info;
       st = gst_caps_get_structure (stream_info->caps, 0);
 
       if (g_str_has_prefix (gst_structure_get_name (st), "image/"))
@@ -1259,13 +1620,17 @@ discoverer_collect (GstDiscoverer * dc)
     }
   }
 
+  if (dp->cachefile && !dp->from_cache &&
+      dp->current_info->result == GST_DISCOVERER_OK)
+    discoverer_cache_store (dc, dp->current_info, dp->cachefile);
+
   if (dc->priv->async) {
     GST_DEBUG ("Emitting 'discoverered'");
     g_signal_emit (dc, gst_discoverer_signals[SIGNAL_DISCOVERED], 0,
-        dc->priv->current_info, dc->priv->current_error);
+        dp->current_info, dp->current_error);
     /* Clients get a copy of current_info since it is a boxed type */
-    gst_discoverer_info_unref (dc->priv->current_info);
-    dc->priv->current_info = NULL;
+    gst_discoverer_info_unref (dp->current_info);
+    dp->current_info = NULL;
   }
 }
 
@@ -1277,35 +1642,67 @@ get_async_cb (gpointer cb_data, GSource * source, GSourceFunc * func,
   *data = cb_data;
 }
 
-/* Wrapper since GSourceCallbackFuncs don't expect a return value from ref() */
 static void
-_void_g_object_ref (gpointer object)
+get_cached_cb (gpointer cb_data, GSource * source, GSourceFunc * func,
+    gpointer * data)
 {
-  g_object_ref (G_OBJECT (object));
+  *func = (GSourceFunc) async_cached_cb;
+  *data = cb_data;
 }
 
+/* The timeout keeps the discoverer, and with it the pipeline, alive */
 static void
-handle_current_async (GstDiscoverer * dc)
+_discoverer_pipeline_ref (gpointer data)
 {
+  g_object_ref (((DiscovererPipeline *) data)->dc);
+}
+
+static void
+_discoverer_pipeline_unref (gpointer data)
+{
+  g_object_unref (((DiscovererPipeline *) data)->dc);
+}
+
+static void
+handle_current_async (DiscovererPipeline * dp)
+{
+  GstDiscoverer *dc = dp->dc;
   GSource *source;
   static GSourceCallbackFuncs cb_funcs = {
-    _void_g_object_ref,
-    g_object_unref,
+    _discoverer_pipeline_ref,
+    _discoverer_pipeline_unref,
     get_async_cb,
   };
+  static GSourceCallbackFuncs cached_cb_funcs = {
+    _discoverer_pipeline_ref,
+    _discoverer_pipeline_unref,
+    get_cached_cb,
+  };
+
+  if (dp->from_cache) {
+    /* Nothing to wait for, report the cached info from the main context */
+    source = g_idle_source_new ();
+    _discoverer_pipeline_ref (dp);
+    g_source_set_callback_indirect (source, dp, &cached_cb_funcs);
+    dp->timeoutid = g_source_attach (source, dc->priv->ctx);
+    g_source_unref (source);
+    return;
+  }
 
   /* Attach a timeout to the main context */
   source = g_timeout_source_new (dc->priv->timeout / GST_MSECOND);
-  g_source_set_callback_indirect (source, g_object_ref (dc), &cb_funcs);
-  dc->priv->timeoutid = g_source_attach (source, dc->priv->ctx);
+  _discoverer_pipeline_ref (dp);
+  g_source_set_callback_indirect (source, dp, &cb_funcs);
+  dp->timeoutid = g_source_attach (source, dc->priv->ctx);
   g_source_unref (source);
 }
 
 
 /* Returns TRUE if processing should stop */
 static gboolean
-handle_message (GstDiscoverer * dc, GstMessage * msg)
+handle_message (DiscovererPipeline * dp, GstMessage * msg)
 {
+  GstDiscoverer *dc = dp->dc;
   gboolean done = FALSE;
 
   GST_DEBUG_OBJECT (GST_MESSAGE_SRC (msg), "got a %s message",
@@ -1319,20 +1716,20 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
       gst_message_parse_error (msg, &gerr, &debug);
       GST_WARNING_OBJECT (GST_MESSAGE_SRC (msg),
           "Got an error [debug:%s], [message:%s]", debug, gerr->message);
-      dc->priv->current_error = gerr;
+      dp->current_error = gerr;
       g_free (debug);
 
       /* We need to stop */
       done = TRUE;
 
       /* Don't override missing plugin result code for missing plugin errors */
-      if (dc->priv->current_info->result != GST_DISCOVERER_MISSING_PLUGINS ||
+      if (dp->current_info->result != GST_DISCOVERER_MISSING_PLUGINS ||
           (!g_error_matches (gerr, GST_CORE_ERROR,
                   GST_CORE_ERROR_MISSING_PLUGIN) &&
               !g_error_matches (gerr, GST_STREAM_ERROR,
                   GST_STREAM_ERROR_CODEC_NOT_FOUND))) {
         GST_DEBUG ("Setting result to ERROR");
-        dc->priv->current_info->result = GST_DISCOVERER_ERROR;
+        dp->current_info->result = GST_DISCOVERER_ERROR;
       }
     }
       break;
@@ -1348,7 +1745,7 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
       name = gst_structure_get_name (gst_message_get_structure (msg));
       /* Maybe ASYNC_DONE is received & we're just waiting for subtitle tags */
       DISCO_LOCK (dc);
-      async_done = dc->priv->async_done;
+      async_done = dp->async_done;
       DISCO_UNLOCK (dc);
       if (g_str_equal (name, "DiscovererDone") && async_done)
         return TRUE;
@@ -1356,14 +1753,14 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
     }
 
     case GST_MESSAGE_ASYNC_DONE:
-      if (GST_MESSAGE_SRC (msg) == (GstObject *) dc->priv->pipeline) {
+      if (GST_MESSAGE_SRC (msg) == (GstObject *) dp->pipeline) {
         GST_DEBUG ("Finished changing state asynchronously");
         DISCO_LOCK (dc);
-        if (dc->priv->pending_subtitle_pads == 0) {
+        if (dp->pending_subtitle_pads == 0) {
           done = TRUE;
         } else {
           /* Remember that ASYNC_DONE has been received, wait for subtitles */
-          dc->priv->async_done = TRUE;
+          dp->async_done = TRUE;
         }
         DISCO_UNLOCK (dc);
 
@@ -1382,18 +1779,18 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
       if (sttype == _MISSING_PLUGIN_QUARK) {
         GST_DEBUG_OBJECT (GST_MESSAGE_SRC (msg),
             "Setting result to MISSING_PLUGINS");
-        dc->priv->current_info->result = GST_DISCOVERER_MISSING_PLUGINS;
+        dp->current_info->result = GST_DISCOVERER_MISSING_PLUGINS;
         /* FIXME 2.0 Remove completely the ->misc
          * Keep the old behaviour for now.
          */
-        if (dc->priv->current_info->misc)
-          gst_structure_free (dc->priv->current_info->misc);
-        g_ptr_array_add (dc->priv->current_info->missing_elements_details,
+        if (dp->current_info->misc)
+          gst_structure_free (dp->current_info->misc);
+        g_ptr_array_add (dp->current_info->missing_elements_details,
             gst_missing_plugin_message_get_installer_detail (msg));
       } else if (sttype == _STREAM_TOPOLOGY_QUARK) {
-        if (dc->priv->current_topology)
-          gst_structure_free (dc->priv->current_topology);
-        dc->priv->current_topology = gst_structure_copy (structure);
+        if (dp->current_topology)
+          gst_structure_free (dp->current_topology);
+        dp->current_topology = gst_structure_copy (structure);
       }
     }
       break;
@@ -1406,14 +1803,14 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
       GST_DEBUG_OBJECT (GST_MESSAGE_SRC (msg), "Got tags %" GST_PTR_FORMAT, tl);
       /* Merge with current tags */
       tmp =
-          gst_tag_list_merge (dc->priv->current_info->tags, tl,
+          gst_tag_list_merge (dp->current_info->tags, tl,
           GST_TAG_MERGE_APPEND);
       gst_tag_list_unref (tl);
-      if (dc->priv->current_info->tags)
-        gst_tag_list_unref (dc->priv->current_info->tags);
-      dc->priv->current_info->tags = tmp;
+      if (dp->current_info->tags)
+        gst_tag_list_unref (dp->current_info->tags);
+      dp->current_info->tags = tmp;
       GST_DEBUG_OBJECT (GST_MESSAGE_SRC (msg), "Current info %p, tags %"
-          GST_PTR_FORMAT, dc->priv->current_info, tmp);
+          GST_PTR_FORMAT, dp->current_info, tmp);
     }
       break;
 
@@ -1423,11 +1820,11 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
 
       gst_message_parse_toc (msg, &tmp, NULL);
       GST_DEBUG_OBJECT (GST_MESSAGE_SRC (msg), "Got toc %" GST_PTR_FORMAT, tmp);
-      if (dc->priv->current_info->toc)
-        gst_toc_unref (dc->priv->current_info->toc);
-      dc->priv->current_info->toc = tmp;        /* transfer ownership */
+      if (dp->current_info->toc)
+        gst_toc_unref (dp->current_info->toc);
+      dp->current_info->toc = tmp;        /* transfer ownership */
       GST_DEBUG_OBJECT (GST_MESSAGE_SRC (msg), "Current info %p, toc %"
-          GST_PTR_FORMAT, dc->priv->current_info, tmp);
+          GST_PTR_FORMAT, dp->current_info, tmp);
     }
       break;
 
@@ -1439,8 +1836,9 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
 }
 
 static void
-handle_current_sync (GstDiscoverer * dc)
+handle_current_sync (DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
   GTimer *timer;
   gdouble deadline = ((gdouble) dc->priv->timeout) / GST_SECOND;
   GstMessage *msg;
@@ -1452,8 +1850,8 @@ handle_current_sync (GstDiscoverer * dc)
   do {
     /* poll bus with timeout */
     /* FIXME : make the timeout more fine-tuned */
-    if ((msg = gst_bus_timed_pop (dc->priv->bus, GST_SECOND / 2))) {
-      done = handle_message (dc, msg);
+    if ((msg = gst_bus_timed_pop (dp->bus, GST_SECOND / 2))) {
+      done = handle_message (dp, msg);
       gst_message_unref (msg);
     }
   } while (!done && (g_timer_elapsed (timer, NULL) < deadline));
@@ -1461,11 +1859,11 @@ handle_current_sync (GstDiscoverer * dc)
   /* return result */
   if (!done) {
     GST_DEBUG ("we timed out! Setting result to TIMEOUT");
-    dc->priv->current_info->result = GST_DISCOVERER_TIMEOUT;
+    dp->current_info->result = GST_DISCOVERER_TIMEOUT;
   }
 
   DISCO_LOCK (dc);
-  dc->priv->processing = FALSE;
+  dp->processing = FALSE;
   DISCO_UNLOCK (dc);
 
 
@@ -1475,88 +1873,170 @@ handle_current_sync (GstDiscoverer * dc)
   g_timer_destroy (timer);
 }
 
-static void
-_setup_locked (GstDiscoverer * dc)
+/* Returns TRUE if the info was loaded from the cache, in which case the
+ * pipeline is not started */
+static gboolean
+_setup_locked (DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
   GstStateChangeReturn ret;
+  gchar *uri;
 
   GST_DEBUG ("Setting up");
 
   /* Pop URI off the pending URI list */
-  dc->priv->current_info =
-      (GstDiscovererInfo *) g_object_new (GST_TYPE_DISCOVERER_INFO, NULL);
-  dc->priv->current_info->uri = (gchar *) dc->priv->pending_uris->data;
+  uri = (gchar *) dc->priv->pending_uris->data;
   dc->priv->pending_uris =
       g_list_delete_link (dc->priv->pending_uris, dc->priv->pending_uris);
 
+  if (dc->priv->use_cache) {
+    dp->cachefile = discoverer_cache_get_path (dc, uri);
+    if (dp->cachefile)
+      dp->current_info = discoverer_cache_load (dc, dp->cachefile);
+    if (dp->current_info) {
+      g_free (dp->current_info->uri);
+      dp->current_info->uri = uri;
+      dp->from_cache = TRUE;
+      return TRUE;
+    }
+  }
+
+  dp->current_info =
+      (GstDiscovererInfo *) g_object_new (GST_TYPE_DISCOVERER_INFO, NULL);
+  dp->current_info->uri = uri;
+
+  dp->parse_only = dc->priv->parse_only;
+  if (dp->parse_only && dc->priv->parse_factories == NULL)
+    dc->priv->parse_factories =
+        gst_element_factory_list_get_elements
+        (GST_ELEMENT_FACTORY_TYPE_DEMUXER | GST_ELEMENT_FACTORY_TYPE_PARSER |
+        GST_ELEMENT_FACTORY_TYPE_DEPAYLOADER, GST_RANK_MARGINAL);
+
   /* set uri on uridecodebin */
-  g_object_set (dc->priv->uridecodebin, "uri", dc->priv->current_info->uri,
-      NULL);
+  g_object_set (dp->uridecodebin, "uri", dp->current_info->uri, NULL);
 
-  GST_DEBUG ("Current is now %s", dc->priv->current_info->uri);
+  GST_DEBUG ("Current is now %s", dp->current_info->uri);
 
-  dc->priv->processing = TRUE;
+  dp->processing = TRUE;
 
   /* set pipeline to PAUSED */
   DISCO_UNLOCK (dc);
   GST_DEBUG ("Setting pipeline to PAUSED");
-  ret =
-      gst_element_set_state ((GstElement *) dc->priv->pipeline,
-      GST_STATE_PAUSED);
+  ret = gst_element_set_state ((GstElement *) dp->pipeline, GST_STATE_PAUSED);
   if (ret == GST_STATE_CHANGE_NO_PREROLL) {
     GST_DEBUG ("Source is live, switching to PLAYING");
     ret =
-        gst_element_set_state ((GstElement *) dc->priv->pipeline,
-        GST_STATE_PLAYING);
+        gst_element_set_state ((GstElement *) dp->pipeline, GST_STATE_PLAYING);
   }
   DISCO_LOCK (dc);
 
   GST_DEBUG_OBJECT (dc, "Pipeline going to PAUSED : %s",
       gst_element_state_change_return_get_name (ret));
+
+  return FALSE;
+}
+
+/* Returns the number of pipelines that are discovering a URI */
+static guint
+discoverer_n_busy_locked (GstDiscoverer * dc)
+{
+  guint i, n_busy = 0;
+
+  for (i = 0; i < dc->priv->pipelines->len; i++) {
+    DiscovererPipeline *dp = g_ptr_array_index (dc->priv->pipelines, i);
+
+    if (dp->current_info != NULL)
+      n_busy++;
+  }
+  return n_busy;
+}
+
+/* Returns a pipeline that can discover the next URI, creating a new one
+ * when all are busy and max-parallel allows it, or NULL. */
+static DiscovererPipeline *
+discoverer_get_idle_pipeline_locked (GstDiscoverer * dc)
+{
+  DiscovererPipeline *dp;
+  guint i;
+
+  /* synchronous discovery only uses the first pipeline */
+  if (!dc->priv->async) {
+    dp = g_ptr_array_index (dc->priv->pipelines, 0);
+    return dp->current_info == NULL ? dp : NULL;
+  }
+
+  if (discoverer_n_busy_locked (dc) >= dc->priv->max_parallel)
+    return NULL;
+
+  for (i = 0; i < dc->priv->pipelines->len; i++) {
+    dp = g_ptr_array_index (dc->priv->pipelines, i);
+    if (dp->current_info == NULL)
+      return dp;
+  }
+
+  GST_DEBUG_OBJECT (dc, "Adding pipeline %u", dc->priv->pipelines->len);
+  dp = discoverer_pipeline_new (dc);
+  if (dp == NULL)
+    return NULL;
+  g_ptr_array_add (dc->priv->pipelines, dp);
+  discoverer_pipeline_start (dp);
+
+  return dp;
 }
 
 static void
-discoverer_cleanup (GstDiscoverer * dc)
+discoverer_cleanup (DiscovererPipeline * dp)
 {
+  GstDiscoverer *dc = dp->dc;
+
   GST_DEBUG ("Cleaning up");
 
-  gst_bus_set_flushing (dc->priv->bus, TRUE);
+  gst_bus_set_flushing (dp->bus, TRUE);
 
   DISCO_LOCK (dc);
-  if (dc->priv->current_error) {
-    g_error_free (dc->priv->current_error);
+  if (dp->current_error) {
+    g_error_free (dp->current_error);
     DISCO_UNLOCK (dc);
-    gst_element_set_state ((GstElement *) dc->priv->pipeline, GST_STATE_NULL);
+    gst_element_set_state ((GstElement *) dp->pipeline, GST_STATE_NULL);
   } else {
     DISCO_UNLOCK (dc);
   }
 
-  gst_element_set_state ((GstElement *) dc->priv->pipeline, GST_STATE_READY);
-  gst_bus_set_flushing (dc->priv->bus, FALSE);
+  gst_element_set_state ((GstElement *) dp->pipeline, GST_STATE_READY);
+  gst_bus_set_flushing (dp->bus, FALSE);
 
   DISCO_LOCK (dc);
-  dc->priv->current_error = NULL;
-  if (dc->priv->current_topology) {
-    gst_structure_free (dc->priv->current_topology);
-    dc->priv->current_topology = NULL;
+  dp->current_error = NULL;
+  if (dp->current_topology) {
+    gst_structure_free (dp->current_topology);
+    dp->current_topology = NULL;
   }
 
-  dc->priv->current_info = NULL;
+  dp->current_info = NULL;
+
+  g_free (dp->cachefile);
+  dp->cachefile = NULL;
+  dp->from_cache = FALSE;
 
-  dc->priv->pending_subtitle_pads = 0;
-  dc->priv->async_done = FALSE;
+  dp->pending_subtitle_pads = 0;
+  dp->async_done = FALSE;
 
-  /* Try popping the next uri */
+  /* Try popping the next uri, reusing this pipeline */
   if (dc->priv->async) {
-    if (dc->priv->pending_uris != NULL) {
-      _setup_locked (dc);
+    if (dc->priv->pending_uris != NULL &&
+        discoverer_n_busy_locked (dc) < dc->priv->max_parallel) {
+      _setup_locked (dp);
       DISCO_UNLOCK (dc);
       /* Start timeout */
-      handle_current_async (dc);
-    } else {
+      handle_current_async (dp);
+    } else if (dc->priv->pending_uris == NULL &&
+        discoverer_n_busy_locked (dc) == 0) {
       /* We're done ! */
       DISCO_UNLOCK (dc);
       g_signal_emit (dc, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+    } else {
+      /* other pipelines are still busy */
+      DISCO_UNLOCK (dc);
     }
   } else
     DISCO_UNLOCK (dc);
@@ -1565,37 +2045,51 @@ discoverer_cleanup (GstDiscoverer * dc)
 }
 
 static void
-discoverer_bus_cb (GstBus * bus, GstMessage * msg, GstDiscoverer * dc)
+discoverer_bus_cb (GstBus * bus, GstMessage * msg, DiscovererPipeline * dp)
 {
-  if (dc->priv->processing) {
-    if (handle_message (dc, msg)) {
+  GstDiscoverer *dc = dp->dc;
+
+  if (dp->processing) {
+    if (handle_message (dp, msg)) {
       GST_DEBUG ("Stopping asynchronously");
       /* Serialise with _event_probe() */
       DISCO_LOCK (dc);
-      dc->priv->processing = FALSE;
+      dp->processing = FALSE;
       DISCO_UNLOCK (dc);
-      discoverer_collect (dc);
-      discoverer_cleanup (dc);
+      discoverer_collect (dp);
+      discoverer_cleanup (dp);
     }
   }
 }
 
 static gboolean
-async_timeout_cb (GstDiscoverer * dc)
+async_timeout_cb (DiscovererPipeline * dp)
 {
   if (!g_source_is_destroyed (g_main_current_source ())) {
-    dc->priv->timeoutid = 0;
+    dp->timeoutid = 0;
     GST_DEBUG ("Setting result to TIMEOUT");
-    dc->priv->current_info->result = GST_DISCOVERER_TIMEOUT;
-    dc->priv->processing = FALSE;
-    discoverer_collect (dc);
-    discoverer_cleanup (dc);
+    dp->current_info->result = GST_DISCOVERER_TIMEOUT;
+    dp->processing = FALSE;
+    discoverer_collect (dp);
+    discoverer_cleanup (dp);
+  }
+  return FALSE;
+}
+
+static gboolean
+async_cached_cb (DiscovererPipeline * dp)
+{
+  if (!g_source_is_destroyed (g_main_current_source ())) {
+    dp->timeoutid = 0;
+    discoverer_collect (dp);
+    discoverer_cleanup (dp);
   }
   return FALSE;
 }
 
 /* If there is a pending URI, it will pop it from the list of pending
- * URIs and start the discovery on it.
+ * URIs and start the discovery on it. In asynchronous mode this starts
+ * as many pending URIs as max-parallel allows.
  *
  * Returns GST_DISCOVERER_OK if the next URI was popped and is processing,
  * else a error flag.
@@ -1604,6 +2098,8 @@ static GstDiscovererResult
 start_discovering (GstDiscoverer * dc)
 {
   GstDiscovererResult res = GST_DISCOVERER_OK;
+  DiscovererPipeline *dp;
+  gboolean starting;
 
   GST_DEBUG ("Starting");
 
@@ -1615,24 +2111,38 @@ start_discovering (GstDiscoverer * dc)
     goto beach;
   }
 
-  if (dc->priv->current_info != NULL) {
+  starting = discoverer_n_busy_locked (dc) == 0;
+
+  dp = discoverer_get_idle_pipeline_locked (dc);
+  if (dp == NULL) {
     GST_WARNING ("Already processing a file");
     res = GST_DISCOVERER_BUSY;
     DISCO_UNLOCK (dc);
     goto beach;
   }
 
-  g_signal_emit (dc, gst_discoverer_signals[SIGNAL_STARTING], 0);
+  if (starting)
+    g_signal_emit (dc, gst_discoverer_signals[SIGNAL_STARTING], 0);
 
-  _setup_locked (dc);
+  if (!dc->priv->async) {
+    if (_setup_locked (dp)) {
+      DISCO_UNLOCK (dc);
+      goto beach;
+    }
+    DISCO_UNLOCK (dc);
+    handle_current_sync (dp);
+    goto beach;
+  }
 
+  do {
+    _setup_locked (dp);
+    DISCO_UNLOCK (dc);
+    handle_current_async (dp);
+    DISCO_LOCK (dc);
+  } while (dc->priv->pending_uris != NULL &&
+      (dp = discoverer_get_idle_pipeline_locked (dc)) != NULL);
   DISCO_UNLOCK (dc);
 
-  if (dc->priv->async)
-    handle_current_async (dc);
-  else
-    handle_current_sync (dc);
-
 beach:
   return res;
 }
@@ -1959,8 +2469,8 @@ out:
 void
 gst_discoverer_start (GstDiscoverer * discoverer)
 {
-  GSource *source;
   GMainContext *ctx = NULL;
+  guint i;
 
   g_return_if_fail (GST_IS_DISCOVERER (discoverer));
 
@@ -1980,12 +2490,10 @@ gst_discoverer_start (GstDiscoverer * discoverer)
   if (ctx == NULL)
     ctx = g_main_context_default ();
 
-  source = gst_bus_create_watch (discoverer->priv->bus);
-  g_source_set_callback (source, (GSourceFunc) gst_bus_async_signal_func,
-      NULL, NULL);
-  discoverer->priv->sourceid = g_source_attach (source, ctx);
-  g_source_unref (source);
   discoverer->priv->ctx = g_main_context_ref (ctx);
+  for (i = 0; i < discoverer->priv->pipelines->len; i++)
+    discoverer_pipeline_start (g_ptr_array_index (discoverer->priv->pipelines,
+            i));
 
   start_discovering (discoverer);
   GST_DEBUG_OBJECT (discoverer, "Started");
@@ -2001,6 +2509,8 @@ gst_discoverer_start (GstDiscoverer * discoverer)
 void
 gst_discoverer_stop (GstDiscoverer * discoverer)
 {
+  guint i;
+
   g_return_if_fail (GST_IS_DISCOVERER (discoverer));
 
   GST_DEBUG_OBJECT (discoverer, "Stopping...");
@@ -2012,28 +2522,33 @@ gst_discoverer_stop (GstDiscoverer * discoverer)
   }
 
   DISCO_LOCK (discoverer);
-  if (discoverer->priv->processing) {
-    /* We prevent any further processing by setting the bus to
-     * flushing and setting the pipeline to READY.
-     * _reset() will take care of the rest of the cleanup */
-    if (discoverer->priv->bus)
-      gst_bus_set_flushing (discoverer->priv->bus, TRUE);
-    if (discoverer->priv->pipeline)
-      gst_element_set_state ((GstElement *) discoverer->priv->pipeline,
-          GST_STATE_READY);
+  for (i = 0; i < discoverer->priv->pipelines->len; i++) {
+    DiscovererPipeline *dp = g_ptr_array_index (discoverer->priv->pipelines, i);
+
+    if (dp->processing) {
+      /* We prevent any further processing by setting the bus to
+       * flushing and setting the pipeline to READY.
+       * _reset() will take care of the rest of the cleanup */
+      gst_bus_set_flushing (dp->bus, TRUE);
+      gst_element_set_state ((GstElement *) dp->pipeline, GST_STATE_READY);
+    }
   }
   discoverer->priv->running = FALSE;
   DISCO_UNLOCK (discoverer);
 
-  /* Remove timeout handler */
-  if (discoverer->priv->timeoutid) {
-    g_source_remove (discoverer->priv->timeoutid);
-    discoverer->priv->timeoutid = 0;
-  }
-  /* Remove signal watch */
-  if (discoverer->priv->sourceid) {
-    g_source_remove (discoverer->priv->sourceid);
-    discoverer->priv->sourceid = 0;
+  for (i = 0; i < discoverer->priv->pipelines->len; i++) {
+    DiscovererPipeline *dp = g_ptr_array_index (discoverer->priv->pipelines, i);
+
+    /* Remove timeout handler */
+    if (dp->timeoutid) {
+      g_source_remove (dp->timeoutid);
+      dp->timeoutid = 0;
+    }
+    /* Remove signal watch */
+    if (dp->sourceid) {
+      g_source_remove (dp->sourceid);
+      dp->sourceid = 0;
+    }
   }
   /* Unref main context */
   if (discoverer->priv->ctx) {
@@ -2106,14 +2621,17 @@ gst_discoverer_discover_uri (GstDiscoverer * discoverer, const gchar * uri,
 {
   GstDiscovererResult res = 0;
   GstDiscovererInfo *info;
+  DiscovererPipeline *dp;
 
   g_return_val_if_fail (GST_IS_DISCOVERER (discoverer), NULL);
   g_return_val_if_fail (uri, NULL);
 
   GST_DEBUG_OBJECT (discoverer, "uri:%s", uri);
 
+  dp = g_ptr_array_index (discoverer->priv->pipelines, 0);
+
   DISCO_LOCK (discoverer);
-  if (G_UNLIKELY (discoverer->priv->current_info)) {
+  if (G_UNLIKELY (dp->current_info)) {
     DISCO_UNLOCK (discoverer);
     GST_WARNING_OBJECT (discoverer, "Already handling a uri");
     if (err)
@@ -2127,23 +2645,22 @@ gst_discoverer_discover_uri (GstDiscoverer * discoverer, const gchar * uri,
   DISCO_UNLOCK (discoverer);
 
   res = start_discovering (discoverer);
-  discoverer_collect (discoverer);
+  discoverer_collect (dp);
 
   /* Get results */
   if (err) {
-    if (discoverer->priv->current_error)
-      *err = g_error_copy (discoverer->priv->current_error);
+    if (dp->current_error)
+      *err = g_error_copy (dp->current_error);
     else
       *err = NULL;
   }
   if (res != GST_DISCOVERER_OK) {
-    GST_DEBUG ("Setting result to %d (was %d)", res,
-        discoverer->priv->current_info->result);
-    discoverer->priv->current_info->result = res;
+    GST_DEBUG ("Setting result to %d (was %d)", res, dp->current_info->result);
+    dp->current_info->result = res;
   }
-  info = discoverer->priv->current_info;
+  info = dp->current_info;
 
-  discoverer_cleanup (discoverer);
+  discoverer_cleanup (dp);
 
   return info;
 }
@@ -2167,7 +2684,7 @@ gst_discoverer_new (GstClockTime timeout, GError ** err)
   GstDiscoverer *res;
 
   res = g_object_new (GST_TYPE_DISCOVERER, "timeout", timeout, NULL);
-  if (res->priv->uridecodebin == NULL) {
+  if (res->priv->pipelines->len == 0) {
     if (err)
       *err = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
           "Couldn't create 'uridecodebin' element");
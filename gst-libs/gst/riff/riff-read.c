@@ -32,6 +32,10 @@
 GST_DEBUG_CATEGORY_EXTERN (riff_debug);
 #define GST_CAT_DEFAULT riff_debug
 
+/* read this much after a chunk header, most chunks in the headers are
+ * smaller and are then read with the same pull as their header */
+#define RIFF_READ_AHEAD 4096
+
 /**
  * gst_riff_read_chunk:
  * @element: caller element (used for debugging).
@@ -54,6 +58,7 @@ gst_riff_read_chunk (GstElement * element,
   GstFlowReturn res;
   GstMapInfo info;
   guint size;
+  gsize bsize;
   guint64 offset = *_offset;
 
   g_return_val_if_fail (element != NULL, GST_FLOW_ERROR);
@@ -65,22 +70,23 @@ gst_riff_read_chunk (GstElement * element,
 skip_junk:
   size = 8;
   buf = NULL;
-  if ((res = gst_pad_pull_range (pad, offset, size, &buf)) != GST_FLOW_OK)
+  if ((res = gst_pad_pull_range (pad, offset, size + RIFF_READ_AHEAD,
+              &buf)) != GST_FLOW_OK)
     return res;
-  else if (gst_buffer_get_size (buf) < size)
+  else if ((bsize = gst_buffer_get_size (buf)) < size)
     goto too_small;
 
   gst_buffer_map (buf, &info, GST_MAP_READ);
   *tag = GST_READ_UINT32_LE (info.data);
   size = GST_READ_UINT32_LE (info.data + 4);
   gst_buffer_unmap (buf, &info);
-  gst_buffer_unref (buf);
 
   GST_DEBUG_OBJECT (element, "fourcc=%" GST_FOURCC_FORMAT ", size=%u",
       GST_FOURCC_ARGS (*tag), size);
 
   /* skip 'JUNK' chunks */
   if (*tag == GST_RIFF_TAG_JUNK || *tag == GST_RIFF_TAG_JUNQ) {
+    gst_buffer_unref (buf);
     size = GST_ROUND_UP_2 (size);
     *_offset += 8 + size;
     offset += 8 + size;
@@ -88,11 +94,23 @@ skip_junk:
     goto skip_junk;
   }
 
-  buf = NULL;
-  if ((res = gst_pad_pull_range (pad, offset + 8, size, &buf)) != GST_FLOW_OK)
-    return res;
-  else if (gst_buffer_get_size (buf) < size)
-    goto too_small;
+  if (size <= bsize - 8) {
+    GstBuffer *chunk;
+
+    /* we already have the data */
+    chunk = gst_buffer_copy_region (buf, GST_BUFFER_COPY_ALL, 8, size);
+    GST_BUFFER_OFFSET (chunk) = offset + 8;
+    gst_buffer_unref (buf);
+    buf = chunk;
+  } else {
+    gst_buffer_unref (buf);
+    buf = NULL;
+    if ((res = gst_pad_pull_range (pad, offset + 8, size,
+                &buf)) != GST_FLOW_OK)
+      return res;
+    else if (gst_buffer_get_size (buf) < size)
+      goto too_small;
+  }
 
   *_chunk_data = buf;
   *_offset += 8 + GST_ROUND_UP_2 (size);
@@ -518,9 +518,12 @@ gst_rtcp_buffer_add_packet (GstRTCPBuffer * rtcp, GstRTCPType type,
   g_return_val_if_fail (packet != NULL, FALSE);
   g_return_val_if_fail (rtcp->map.flags & GST_MAP_WRITE, FALSE);
 
-  /* find free space */
-  if (gst_rtcp_buffer_get_first_packet (rtcp, packet))
-    while (gst_rtcp_packet_move_to_next (packet));
+  /* find free space. All the functions that add to a packet keep the size of
+   * the map at the end of the last packet so we don't need to walk over all
+   * the packets we added before */
+  packet->rtcp = rtcp;
+  packet->offset = rtcp->map.size;
+  packet->type = GST_RTCP_TYPE_INVALID;
 
   maxsize = rtcp->map.maxsize;
 
@@ -508,56 +508,90 @@ foreach_metadata (GstBuffer * inbuf, GstMeta ** meta, gpointer user_data)
   return TRUE;
 }
 
-static GstFlowReturn
-gst_rtp_base_audio_payload_push_buffer (GstRTPBaseAudioPayload *
+/* makes an RTP packet around the memory of @buffer, takes ownership of
+ * @buffer */
+static GstBuffer *
+gst_rtp_base_audio_payload_make_packet (GstRTPBaseAudioPayload *
     baseaudiopayload, GstBuffer * buffer, GstClockTime timestamp)
 {
-  GstRTPBasePayload *basepayload;
-  GstRTPBaseAudioPayloadPrivate *priv;
   GstBuffer *outbuf;
   guint payload_len;
-  GstFlowReturn ret;
-
-  priv = baseaudiopayload->priv;
-  basepayload = GST_RTP_BASE_PAYLOAD (baseaudiopayload);
+  CopyMetaData data;
 
   payload_len = gst_buffer_get_size (buffer);
 
   GST_DEBUG_OBJECT (baseaudiopayload, "Pushing %d bytes ts %" GST_TIME_FORMAT,
       payload_len, GST_TIME_ARGS (timestamp));
 
-  /* create just the RTP header buffer */
-  outbuf = gst_rtp_buffer_new_allocate (0, 0, 0);
+  /* the packet refers to the memory of the payload, nothing is copied */
+  outbuf = gst_rtp_buffer_new_with_payload (buffer, 0, -1, 0, 0);
 
   /* set metadata */
   gst_rtp_base_audio_payload_set_meta (baseaudiopayload, outbuf, payload_len,
       timestamp);
 
-  if (priv->buffer_list) {
-    GstBufferList *list;
-    guint i, len;
+  data.pay = baseaudiopayload;
+  data.outbuf = outbuf;
+  gst_buffer_foreach_meta (buffer, foreach_metadata, &data);
+  gst_buffer_unref (buffer);
+
+  return outbuf;
+}
 
-    list = gst_buffer_list_new ();
-    len = gst_buffer_list_length (list);
+/* takes @payload_len bytes out of the adapter and makes a packet with them.
+ * The packet refers to the memory of the input buffers, also when the
+ * packet spans several of them. */
+static GstBuffer *
+gst_rtp_base_audio_payload_take_packet (GstRTPBaseAudioPayload *
+    baseaudiopayload, guint payload_len, GstClockTime timestamp)
+{
+  GstRTPBaseAudioPayloadPrivate *priv;
+  GstAdapter *adapter;
+  GstBuffer *paybuf;
+  guint64 distance;
+
+  priv = baseaudiopayload->priv;
+  adapter = priv->adapter;
+
+  if (timestamp == -1) {
+    /* calculate the timestamp */
+    timestamp = gst_adapter_prev_pts (adapter, &distance);
+
+    GST_LOG_OBJECT (baseaudiopayload,
+        "last timestamp %" GST_TIME_FORMAT ", distance %" G_GUINT64_FORMAT,
+        GST_TIME_ARGS (timestamp), distance);
 
-    for (i = 0; i < len; i++) {
-      /* FIXME */
-      g_warning ("bufferlist not implemented");
-      gst_buffer_list_add (list, outbuf);
-      gst_buffer_list_add (list, buffer);
+    if (GST_CLOCK_TIME_IS_VALID (timestamp) && distance > 0) {
+      /* convert the number of bytes since the last timestamp to time and add to
+       * the last seen timestamp */
+      timestamp += priv->bytes_to_time (baseaudiopayload, distance);
     }
+  }
+
+  paybuf = gst_adapter_take_buffer_fast (adapter, payload_len);
+
+  return gst_rtp_base_audio_payload_make_packet (baseaudiopayload, paybuf,
+      timestamp);
+}
+
+static GstFlowReturn
+gst_rtp_base_audio_payload_push_packet (GstRTPBaseAudioPayload *
+    baseaudiopayload, GstBuffer * outbuf)
+{
+  GstRTPBasePayload *basepayload;
+  GstFlowReturn ret;
+
+  basepayload = GST_RTP_BASE_PAYLOAD (baseaudiopayload);
+
+  if (baseaudiopayload->priv->buffer_list) {
+    GstBufferList *list;
+
+    list = gst_buffer_list_new_sized (1);
+    gst_buffer_list_add (list, outbuf);
 
     GST_DEBUG_OBJECT (baseaudiopayload, "Pushing list %p", list);
     ret = gst_rtp_base_payload_push_list (basepayload, list);
   } else {
-    CopyMetaData data;
-
-    /* copy payload */
-    data.pay = baseaudiopayload;
-    data.outbuf = outbuf;
-    gst_buffer_foreach_meta (buffer, foreach_metadata, &data);
-    outbuf = gst_buffer_append (outbuf, buffer);
-
     GST_DEBUG_OBJECT (baseaudiopayload, "Pushing buffer %p", outbuf);
     ret = gst_rtp_base_payload_push (basepayload, outbuf);
   }
@@ -565,6 +599,18 @@ gst_rtp_base_audio_payload_push_buffer (GstRTPBaseAudioPayload *
   return ret;
 }
 
+static GstFlowReturn
+gst_rtp_base_audio_payload_push_buffer (GstRTPBaseAudioPayload *
+    baseaudiopayload, GstBuffer * buffer, GstClockTime timestamp)
+{
+  GstBuffer *outbuf;
+
+  outbuf = gst_rtp_base_audio_payload_make_packet (baseaudiopayload, buffer,
+      timestamp);
+
+  return gst_rtp_base_audio_payload_push_packet (baseaudiopayload, outbuf);
+}
+
 /**
  * gst_rtp_base_audio_payload_flush:
  * @baseaudiopayload: a #GstRTPBasePayload
@@ -584,75 +630,19 @@ GstFlowReturn
 gst_rtp_base_audio_payload_flush (GstRTPBaseAudioPayload * baseaudiopayload,
     guint payload_len, GstClockTime timestamp)
 {
-  GstRTPBasePayload *basepayload;
-  GstRTPBaseAudioPayloadPrivate *priv;
   GstBuffer *outbuf;
-  GstFlowReturn ret;
-  GstAdapter *adapter;
-  guint64 distance;
-
-  priv = baseaudiopayload->priv;
-  adapter = priv->adapter;
-
-  basepayload = GST_RTP_BASE_PAYLOAD (baseaudiopayload);
 
   if (payload_len == -1)
-    payload_len = gst_adapter_available (adapter);
+    payload_len = gst_adapter_available (baseaudiopayload->priv->adapter);
 
   /* nothing to do, just return */
   if (payload_len == 0)
     return GST_FLOW_OK;
 
-  if (timestamp == -1) {
-    /* calculate the timestamp */
-    timestamp = gst_adapter_prev_pts (adapter, &distance);
-
-    GST_LOG_OBJECT (baseaudiopayload,
-        "last timestamp %" GST_TIME_FORMAT ", distance %" G_GUINT64_FORMAT,
-        GST_TIME_ARGS (timestamp), distance);
-
-    if (GST_CLOCK_TIME_IS_VALID (timestamp) && distance > 0) {
-      /* convert the number of bytes since the last timestamp to time and add to
-       * the last seen timestamp */
-      timestamp += priv->bytes_to_time (baseaudiopayload, distance);
-    }
-  }
-
-  GST_DEBUG_OBJECT (baseaudiopayload, "Pushing %d bytes ts %" GST_TIME_FORMAT,
-      payload_len, GST_TIME_ARGS (timestamp));
-
-  if (priv->buffer_list && gst_adapter_available_fast (adapter) >= payload_len) {
-    GstBuffer *buffer;
-    /* we can quickly take a buffer out of the adapter without having to copy
-     * anything. */
-    buffer = gst_adapter_take_buffer (adapter, payload_len);
-
-    ret =
-        gst_rtp_base_audio_payload_push_buffer (baseaudiopayload, buffer,
-        timestamp);
-  } else {
-    GstBuffer *paybuf;
-    CopyMetaData data;
-
+  outbuf = gst_rtp_base_audio_payload_take_packet (baseaudiopayload,
+      payload_len, timestamp);
 
-    /* create buffer to hold the payload */
-    outbuf = gst_rtp_buffer_new_allocate (0, 0, 0);
-
-    paybuf = gst_adapter_take_buffer_fast (adapter, payload_len);
-
-    data.pay = baseaudiopayload;
-    data.outbuf = outbuf;
-    gst_buffer_foreach_meta (paybuf, foreach_metadata, &data);
-    outbuf = gst_buffer_append (outbuf, paybuf);
-
-    /* set metadata */
-    gst_rtp_base_audio_payload_set_meta (baseaudiopayload, outbuf, payload_len,
-        timestamp);
-
-    ret = gst_rtp_base_payload_push (basepayload, outbuf);
-  }
-
-  return ret;
+  return gst_rtp_base_audio_payload_push_packet (baseaudiopayload, outbuf);
 }
 
 #define ALIGN_DOWN(val,len) ((val) - ((val) % (len)))
@@ -843,6 +833,7 @@ gst_rtp_base_audio_payload_handle_buffer (GstRTPBasePayload *
   guint size;
   gboolean discont;
   GstClockTime timestamp;
+  GstBufferList *list = NULL;
 
   ret = GST_FLOW_OK;
 
@@ -913,8 +904,11 @@ gst_rtp_base_audio_payload_handle_buffer (GstRTPBasePayload *
 
     GST_DEBUG_OBJECT (payload, "available now %u", available);
 
+    /* all the packets made from this buffer go out in one list */
+    if (priv->buffer_list)
+      list = gst_buffer_list_new ();
+
     /* as long as we have full frames */
-    /* TODO: Use buffer lists here */
     while (available >= min_payload_len) {
       /* get multiple of alignment */
       payload_len = MIN (max_payload_len, available);
@@ -922,11 +916,24 @@ gst_rtp_base_audio_payload_handle_buffer (GstRTPBasePayload *
 
       /* and flush out the bytes from the adapter, automatically set the
        * timestamp. */
-      ret = gst_rtp_base_audio_payload_flush (payload, payload_len, -1);
+      if (list)
+        gst_buffer_list_add (list,
+            gst_rtp_base_audio_payload_take_packet (payload, payload_len, -1));
+      else
+        ret = gst_rtp_base_audio_payload_flush (payload, payload_len, -1);
 
       available -= payload_len;
       GST_DEBUG_OBJECT (payload, "available after push %u", available);
     }
+
+    if (list) {
+      if (gst_buffer_list_length (list) > 0) {
+        GST_DEBUG_OBJECT (payload, "Pushing list %p", list);
+        ret = gst_rtp_base_payload_push_list (basepayload, list);
+      } else {
+        gst_buffer_list_unref (list);
+      }
+    }
   }
   return ret;
 
@@ -55,6 +55,9 @@ struct _GstRTPBaseDepayloadPrivate
 
   GstCaps *last_caps;
   GstEvent *segment_event;
+
+  /* the mapped packets of the list being processed */
+  GArray *packets;
 };
 
 /* Filter signals and args */
@@ -251,6 +254,7 @@ gst_rtp_base_depayload_init (GstRTPBaseDepayload * filter,
   priv->dts = -1;
   priv->pts = -1;
   priv->duration = -1;
+  priv->packets = g_array_new (FALSE, TRUE, sizeof (GstRTPBuffer));
 
   gst_segment_init (&filter->segment, GST_FORMAT_UNDEFINED);
 }
@@ -258,6 +262,10 @@ gst_rtp_base_depayload_init (GstRTPBaseDepayload * filter,
 static void
 gst_rtp_base_depayload_finalize (GObject * object)
 {
+  GstRTPBaseDepayload *filter = GST_RTP_BASE_DEPAYLOAD_CAST (object);
+
+  g_array_free (filter->priv->packets, TRUE);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -346,45 +354,31 @@ caps_not_changed:
   }
 }
 
-/* takes ownership of the input buffer */
-static GstFlowReturn
-gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
-    GstRTPBaseDepayloadClass * bclass, GstBuffer * in)
+/* maps @in in @rtp and checks its seqnum and ssrc against the previous
+ * packets. Marks @in as DISCONT when needed and prepares the segment event.
+ * Takes ownership of @in, returns FALSE when the packet must be dropped. On
+ * success the (possibly new) input buffer is in @rtp->buffer. */
+static gboolean
+gst_rtp_base_depayload_check_packet (GstRTPBaseDepayload * filter,
+    GstBuffer * in, GstRTPBuffer * rtp)
 {
-  GstBuffer *(*process_rtp_packet_func) (GstRTPBaseDepayload * base,
-      GstRTPBuffer * rtp_buffer);
-  GstBuffer *(*process_func) (GstRTPBaseDepayload * base, GstBuffer * in);
   GstRTPBaseDepayloadPrivate *priv;
-  GstFlowReturn ret = GST_FLOW_OK;
-  GstBuffer *out_buf;
   guint32 ssrc;
   guint16 seqnum;
   guint32 rtptime;
   gboolean discont, buf_discont;
   gint gap;
-  GstRTPBuffer rtp = { NULL };
 
   priv = filter->priv;
 
-  process_func = bclass->process;
-  process_rtp_packet_func = bclass->process_rtp_packet;
-
-  /* we must have a setcaps first */
-  if (G_UNLIKELY (!priv->negotiated))
-    goto not_negotiated;
-
-  if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
+  if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, rtp)))
     goto invalid_buffer;
 
   buf_discont = GST_BUFFER_IS_DISCONT (in);
 
-  priv->pts = GST_BUFFER_PTS (in);
-  priv->dts = GST_BUFFER_DTS (in);
-  priv->duration = GST_BUFFER_DURATION (in);
-
-  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
-  seqnum = gst_rtp_buffer_get_seq (&rtp);
-  rtptime = gst_rtp_buffer_get_timestamp (&rtp);
+  ssrc = gst_rtp_buffer_get_ssrc (rtp);
+  seqnum = gst_rtp_buffer_get_seq (rtp);
+  rtptime = gst_rtp_buffer_get_timestamp (rtp);
 
   priv->last_seqnum = seqnum;
   priv->last_rtptime = rtptime;
@@ -393,7 +387,7 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
 
   GST_LOG_OBJECT (filter, "discont %d, seqnum %u, rtptime %u, pts %"
       GST_TIME_FORMAT ", dts %" GST_TIME_FORMAT, buf_discont, seqnum, rtptime,
-      GST_TIME_ARGS (priv->pts), GST_TIME_ARGS (priv->dts));
+      GST_TIME_ARGS (GST_BUFFER_PTS (in)), GST_TIME_ARGS (GST_BUFFER_DTS (in)));
 
   /* Check seqnum. This is a very simple check that makes sure that the seqnums
    * are strictly increasing, dropping anything that is out of the ordinary. We
@@ -448,8 +442,8 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
        * buffer was not writable already we need to remap to make our
        * newly-flagged buffer current on the rtpbuffer */
       if (in != old_inbuf) {
-        gst_rtp_buffer_unmap (&rtp);
-        if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
+        gst_rtp_buffer_unmap (rtp);
+        if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, rtp)))
           goto invalid_buffer;
       }
     }
@@ -462,6 +456,74 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
     filter->need_newsegment = FALSE;
   }
 
+  return TRUE;
+
+  /* ERRORS */
+invalid_buffer:
+  {
+    /* this is not fatal but should be filtered earlier */
+    GST_ELEMENT_WARNING (filter, STREAM, DECODE, (NULL),
+        ("Received invalid RTP payload, dropping"));
+    gst_buffer_unref (in);
+    return FALSE;
+  }
+dropping:
+  {
+    gst_rtp_buffer_unmap (rtp);
+    GST_WARNING_OBJECT (filter, "%d <= 100, dropping old packet", gap);
+    gst_buffer_unref (in);
+    return FALSE;
+  }
+}
+
+static GstFlowReturn
+gst_rtp_base_depayload_not_negotiated (GstRTPBaseDepayload * filter)
+{
+  /* this is not fatal but should be filtered earlier */
+  GST_ELEMENT_ERROR (filter, CORE, NEGOTIATION,
+      ("No RTP format was negotiated."),
+      ("Input buffers need to have RTP caps set on them. This is usually "
+          "achieved by setting the 'caps' property of the upstream source "
+          "element (often udpsrc or appsrc), or by putting a capsfilter "
+          "element before the depayloader and setting the 'caps' property "
+          "on that. Also see http://cgit.freedesktop.org/gstreamer/"
+          "gst-plugins-good/tree/gst/rtp/README"));
+  return GST_FLOW_NOT_NEGOTIATED;
+}
+
+/* takes ownership of the input buffer */
+static GstFlowReturn
+gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
+    GstRTPBaseDepayloadClass * bclass, GstBuffer * in)
+{
+  GstBuffer *(*process_rtp_packet_func) (GstRTPBaseDepayload * base,
+      GstRTPBuffer * rtp_buffer);
+  GstBuffer *(*process_func) (GstRTPBaseDepayload * base, GstBuffer * in);
+  GstRTPBaseDepayloadPrivate *priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *out_buf;
+  GstRTPBuffer rtp = { NULL };
+
+  priv = filter->priv;
+
+  process_func = bclass->process;
+  process_rtp_packet_func = bclass->process_rtp_packet;
+
+  /* we must have a setcaps first */
+  if (G_UNLIKELY (!priv->negotiated)) {
+    gst_buffer_unref (in);
+    return gst_rtp_base_depayload_not_negotiated (filter);
+  }
+
+  if (!gst_rtp_base_depayload_check_packet (filter, in, &rtp))
+    return GST_FLOW_OK;
+
+  in = rtp.buffer;
+
+  priv->pts = GST_BUFFER_PTS (in);
+  priv->dts = GST_BUFFER_DTS (in);
+  priv->duration = GST_BUFFER_DURATION (in);
+
   if (process_rtp_packet_func != NULL) {
     out_buf = process_rtp_packet_func (filter, &rtp);
     gst_rtp_buffer_unmap (&rtp);
@@ -482,35 +544,6 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
   return ret;
 
   /* ERRORS */
-not_negotiated:
-  {
-    /* this is not fatal but should be filtered earlier */
-    GST_ELEMENT_ERROR (filter, CORE, NEGOTIATION,
-        ("No RTP format was negotiated."),
-        ("Input buffers need to have RTP caps set on them. This is usually "
-            "achieved by setting the 'caps' property of the upstream source "
-            "element (often udpsrc or appsrc), or by putting a capsfilter "
-            "element before the depayloader and setting the 'caps' property "
-            "on that. Also see http://cgit.freedesktop.org/gstreamer/"
-            "gst-plugins-good/tree/gst/rtp/README"));
-    gst_buffer_unref (in);
-    return GST_FLOW_NOT_NEGOTIATED;
-  }
-invalid_buffer:
-  {
-    /* this is not fatal but should be filtered earlier */
-    GST_ELEMENT_WARNING (filter, STREAM, DECODE, (NULL),
-        ("Received invalid RTP payload, dropping"));
-    gst_buffer_unref (in);
-    return GST_FLOW_OK;
-  }
-dropping:
-  {
-    gst_rtp_buffer_unmap (&rtp);
-    GST_WARNING_OBJECT (filter, "%d <= 100, dropping old packet", gap);
-    gst_buffer_unref (in);
-    return GST_FLOW_OK;
-  }
 no_process:
   {
     gst_rtp_buffer_unmap (&rtp);
@@ -522,6 +555,69 @@ no_process:
   }
 }
 
+/* checks all packets of @list in one go and passes the ones that are not
+ * dropped, already mapped, to the process_list vmethod */
+static GstFlowReturn
+gst_rtp_base_depayload_handle_list (GstRTPBaseDepayload * filter,
+    GstRTPBaseDepayloadClass * bclass, GstBufferList * list)
+{
+  GstRTPBaseDepayloadPrivate *priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBufferList *out_list;
+  GstRTPBuffer *packets;
+  GstBuffer *in;
+  guint i, len, n_packets;
+
+  priv = filter->priv;
+
+  if (G_UNLIKELY (!priv->negotiated))
+    return gst_rtp_base_depayload_not_negotiated (filter);
+
+  len = gst_buffer_list_length (list);
+  g_array_set_size (priv->packets, len);
+  packets = (GstRTPBuffer *) priv->packets->data;
+
+  for (i = 0, n_packets = 0; i < len; i++) {
+    GstRTPBuffer *rtp = &packets[n_packets];
+
+    in = gst_buffer_ref (gst_buffer_list_get (list, i));
+
+    if (!gst_rtp_base_depayload_check_packet (filter, in, rtp))
+      continue;
+
+    /* like for the single packets, the timestamps of the first packet are
+     * applied to the first output buffer when it has none */
+    if (n_packets == 0) {
+      priv->pts = GST_BUFFER_PTS (rtp->buffer);
+      priv->dts = GST_BUFFER_DTS (rtp->buffer);
+      priv->duration = GST_BUFFER_DURATION (rtp->buffer);
+    }
+    n_packets++;
+  }
+
+  GST_LOG_OBJECT (filter, "processing %u of %u packets", n_packets, len);
+
+  if (n_packets > 0) {
+    out_list = bclass->process_list (filter, packets, n_packets);
+
+    for (i = 0; i < n_packets; i++) {
+      in = packets[i].buffer;
+      gst_rtp_buffer_unmap (&packets[i]);
+      gst_buffer_unref (in);
+    }
+
+    if (out_list) {
+      if (gst_buffer_list_length (out_list) > 0)
+        ret = gst_rtp_base_depayload_push_list (filter, out_list);
+      else
+        gst_buffer_list_unref (out_list);
+    }
+  }
+  g_array_set_size (priv->packets, 0);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_base_depayload_chain (GstPad * pad, GstObject * parent, GstBuffer * in)
 {
@@ -560,6 +656,11 @@ gst_rtp_base_depayload_chain_list (GstPad * pad, GstObject * parent,
   if (len == 0)
     goto done;
 
+  if (bclass->process_list != NULL) {
+    flow_ret = gst_rtp_base_depayload_handle_list (basedepay, bclass, list);
+    goto done;
+  }
+
   for (i = 0; i < len; i++) {
     buffer = gst_buffer_list_get (list, i);
 
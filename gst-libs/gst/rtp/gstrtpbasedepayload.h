@@ -110,8 +110,22 @@ struct _GstRTPBaseDepayloadClass
    */
   GstBuffer * (*process_rtp_packet) (GstRTPBaseDepayload *base, GstRTPBuffer * rtp_buffer);
 
+  /* Optional. Called instead of the process virtual functions for the buffer
+   * lists received by the base class. The @n_packets packets in @packets are
+   * already mapped and checked by the base class: duplicates are dropped and
+   * packets after a gap or ssrc change have the DISCONT flag set. This allows
+   * the subclass to depayload all packets of the list in one pass. The
+   * packets are unmapped by the base class after this function returns. The
+   * returned list is pushed out, the first buffer in it gets the timestamp of
+   * the first packet when it has none. If this function returns %NULL,
+   * nothing is pushed out.
+   *
+   * Since: 1.10
+   */
+  GstBufferList * (*process_list) (GstRTPBaseDepayload *base, GstRTPBuffer * packets, guint n_packets);
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING - 1];
+  gpointer _gst_reserved[GST_PADDING - 2];
 };
 
 GType gst_rtp_base_depayload_get_type (void);
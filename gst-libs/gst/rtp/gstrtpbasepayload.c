@@ -61,6 +61,10 @@ struct _GstRTPBasePayloadPrivate
 
   GstCaps *subclass_srccaps;
   GstCaps *sinkcaps;
+
+  gboolean buffer_list;
+  /* packets collected while the subclass handles an input buffer */
+  GstBufferList *pending_list;
 };
 
 /* RTPBasePayload signals and args */
@@ -86,6 +90,7 @@ enum
 #define DEFAULT_PERFECT_RTPTIME         TRUE
 #define DEFAULT_PTIME_MULTIPLE          0
 #define DEFAULT_RUNNING_TIME            GST_CLOCK_TIME_NONE
+#define DEFAULT_BUFFER_LIST             FALSE
 
 enum
 {
@@ -102,6 +107,7 @@ enum
   PROP_PERFECT_RTPTIME,
   PROP_PTIME_MULTIPLE,
   PROP_STATS,
+  PROP_BUFFER_LIST,
   PROP_LAST
 };
 
@@ -322,6 +328,21 @@ gst_rtp_base_payload_class_init (GstRTPBasePayloadClass * klass)
       g_param_spec_boxed ("stats", "Statistics", "Various statistics",
           GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTPBasePayload:buffer-list:
+   *
+   * Collect all packets that are made from one input buffer and push them
+   * downstream in one #GstBufferList once the subclass has handled the
+   * buffer. This saves a push per packet, and sinks like udpsink can send
+   * the whole list at once.
+   *
+   * Since: 1.10
+   **/
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_BUFFER_LIST,
+      g_param_spec_boolean ("buffer-list", "Buffer List",
+          "Push the packets of one input buffer in one buffer list",
+          DEFAULT_BUFFER_LIST, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state = gst_rtp_base_payload_change_state;
 
   klass->get_caps = gst_rtp_base_payload_getcaps_default;
@@ -389,6 +410,7 @@ gst_rtp_base_payload_init (GstRTPBasePayload * rtpbasepayload, gpointer g_class)
 
   rtpbasepayload->priv->caps_max_ptime = DEFAULT_MAX_PTIME;
   rtpbasepayload->priv->prop_max_ptime = DEFAULT_MAX_PTIME;
+  rtpbasepayload->priv->buffer_list = DEFAULT_BUFFER_LIST;
 }
 
 static void
@@ -639,13 +661,16 @@ gst_rtp_base_payload_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return res;
 }
 
+static GstFlowReturn gst_rtp_base_payload_push_pending_list (GstRTPBasePayload
+    * payload);
+
 static GstFlowReturn
 gst_rtp_base_payload_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer)
 {
   GstRTPBasePayload *rtpbasepayload;
   GstRTPBasePayloadClass *rtpbasepayload_class;
-  GstFlowReturn ret;
+  GstFlowReturn ret, list_ret;
 
   rtpbasepayload = GST_RTP_BASE_PAYLOAD (parent);
   rtpbasepayload_class = GST_RTP_BASE_PAYLOAD_GET_CLASS (rtpbasepayload);
@@ -659,8 +684,19 @@ gst_rtp_base_payload_chain (GstPad * pad, GstObject * parent,
   if (gst_pad_check_reconfigure (GST_RTP_BASE_PAYLOAD_SRCPAD (rtpbasepayload)))
     gst_rtp_base_payload_negotiate (rtpbasepayload);
 
+  if (rtpbasepayload->priv->buffer_list)
+    rtpbasepayload->priv->pending_list = gst_buffer_list_new ();
+
   ret = rtpbasepayload_class->handle_buffer (rtpbasepayload, buffer);
 
+  /* the packets already have their seqnum, push them even on errors so that
+   * there is no gap */
+  if (rtpbasepayload->priv->pending_list) {
+    list_ret = gst_rtp_base_payload_push_pending_list (rtpbasepayload);
+    if (ret == GST_FLOW_OK)
+      ret = list_ret;
+  }
+
   return ret;
 
   /* ERRORS */
@@ -1281,6 +1317,37 @@ no_rate:
   }
 }
 
+static inline void
+gst_rtp_base_payload_push_pending_segment (GstRTPBasePayload * payload)
+{
+  if (G_UNLIKELY (payload->priv->pending_segment)) {
+    gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
+    payload->priv->pending_segment = FALSE;
+    payload->priv->delay_segment = FALSE;
+  }
+}
+
+/* pushes the packets collected while handling the last input buffer */
+static GstFlowReturn
+gst_rtp_base_payload_push_pending_list (GstRTPBasePayload * payload)
+{
+  GstBufferList *list = payload->priv->pending_list;
+
+  payload->priv->pending_list = NULL;
+
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    return GST_FLOW_OK;
+  }
+
+  GST_LOG_OBJECT (payload, "pushing list of %u packets",
+      gst_buffer_list_length (list));
+
+  gst_rtp_base_payload_push_pending_segment (payload);
+
+  return gst_pad_push_list (payload->srcpad, list);
+}
+
 /**
  * gst_rtp_base_payload_push_list:
  * @payload: a #GstRTPBasePayload
@@ -1291,6 +1358,9 @@ no_rate:
  *
  * This function takes ownership of @list.
  *
+ * With #GstRTPBasePayload:buffer-list enabled, @list is only collected while
+ * the subclass handles an input buffer and this returns %GST_FLOW_OK.
+ *
  * Returns: a #GstFlowReturn.
  */
 GstFlowReturn
@@ -1302,11 +1372,17 @@ gst_rtp_base_payload_push_list (GstRTPBasePayload * payload,
   res = gst_rtp_base_payload_prepare_push (payload, list, TRUE);
 
   if (G_LIKELY (res == GST_FLOW_OK)) {
-    if (G_UNLIKELY (payload->priv->pending_segment)) {
-      gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
-      payload->priv->pending_segment = FALSE;
-      payload->priv->delay_segment = FALSE;
+    if (payload->priv->pending_list) {
+      guint i, len = gst_buffer_list_length (list);
+
+      for (i = 0; i < len; i++)
+        gst_buffer_list_add (payload->priv->pending_list,
+            gst_buffer_ref (gst_buffer_list_get (list, i)));
+      gst_buffer_list_unref (list);
+
+      return GST_FLOW_OK;
     }
+    gst_rtp_base_payload_push_pending_segment (payload);
     res = gst_pad_push_list (payload->srcpad, list);
   } else {
     gst_buffer_list_unref (list);
@@ -1325,6 +1401,9 @@ gst_rtp_base_payload_push_list (GstRTPBasePayload * payload,
  *
  * This function takes ownership of @buffer.
  *
+ * With #GstRTPBasePayload:buffer-list enabled, @buffer is only collected while
+ * the subclass handles an input buffer and this returns %GST_FLOW_OK.
+ *
  * Returns: a #GstFlowReturn.
  */
 GstFlowReturn
@@ -1335,11 +1414,11 @@ gst_rtp_base_payload_push (GstRTPBasePayload * payload, GstBuffer * buffer)
   res = gst_rtp_base_payload_prepare_push (payload, buffer, FALSE);
 
   if (G_LIKELY (res == GST_FLOW_OK)) {
-    if (G_UNLIKELY (payload->priv->pending_segment)) {
-      gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
-      payload->priv->pending_segment = FALSE;
-      payload->priv->delay_segment = FALSE;
+    if (payload->priv->pending_list) {
+      gst_buffer_list_add (payload->priv->pending_list, buffer);
+      return GST_FLOW_OK;
     }
+    gst_rtp_base_payload_push_pending_segment (payload);
     res = gst_pad_push (payload->srcpad, buffer);
   } else {
     gst_buffer_unref (buffer);
@@ -1418,6 +1497,9 @@ gst_rtp_base_payload_set_property (GObject * object, guint prop_id,
     case PROP_PTIME_MULTIPLE:
       rtpbasepayload->ptime_multiple = g_value_get_int64 (value);
       break;
+    case PROP_BUFFER_LIST:
+      priv->buffer_list = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1481,6 +1563,9 @@ gst_rtp_base_payload_get_property (GObject * object, guint prop_id,
       g_value_take_boxed (value,
           gst_rtp_base_payload_create_stats (rtpbasepayload));
       break;
+    case PROP_BUFFER_LIST:
+      g_value_set_boolean (value, priv->buffer_list);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
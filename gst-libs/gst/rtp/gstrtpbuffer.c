@@ -239,6 +239,64 @@ gst_rtp_buffer_new_allocate_len (guint packet_len, guint8 pad_len,
   return gst_rtp_buffer_new_allocate (len, pad_len, csrc_count);
 }
 
+/**
+ * gst_rtp_buffer_new_with_payload:
+ * @payload: a #GstBuffer with the payload
+ * @offset: the offset of the payload in @payload
+ * @size: the size of the payload or -1 for everything after @offset
+ * @pad_len: the amount of padding
+ * @csrc_count: the number of CSRC entries
+ *
+ * Create a new #GstBuffer with an RTP packet with @csrc_count CSRCs and
+ * padding of @pad_len, with @size bytes of @payload starting at @offset as
+ * the payload. Only the header and padding are allocated, the packet refers
+ * to the memory of @payload, so payloading and fragmenting don't copy any
+ * data. The header is in its own memory and header extensions can be added
+ * to it without touching the payload.
+ *
+ * All RTP header fields will be set to 0/FALSE.
+ *
+ * Returns: (transfer full): A newly allocated buffer with an RTP packet that
+ * contains the requested part of @payload.
+ *
+ * Since: 1.10
+ */
+GstBuffer *
+gst_rtp_buffer_new_with_payload (GstBuffer * payload, gsize offset,
+    gssize size, guint8 pad_len, guint8 csrc_count)
+{
+  GstBuffer *result, *sub;
+  GstMemory *mem;
+  GstMapInfo map;
+
+  g_return_val_if_fail (GST_IS_BUFFER (payload), NULL);
+  g_return_val_if_fail (csrc_count <= 15, NULL);
+  g_return_val_if_fail (size == -1
+      || offset + size <= gst_buffer_get_size (payload), NULL);
+
+  result = gst_rtp_buffer_new_allocate (0, 0, csrc_count);
+
+  sub = gst_buffer_copy_region (payload, GST_BUFFER_COPY_MEMORY, offset, size);
+  result = gst_buffer_append (result, sub);
+
+  if (pad_len) {
+    mem = gst_buffer_peek_memory (result, 0);
+    gst_memory_map (mem, &map, GST_MAP_WRITE);
+    GST_RTP_HEADER_PADDING (map.data) = TRUE;
+    gst_memory_unmap (mem, &map);
+
+    mem = gst_allocator_alloc (NULL, pad_len, NULL);
+    gst_memory_map (mem, &map, GST_MAP_WRITE);
+    memset (map.data, 0, pad_len - 1);
+    map.data[pad_len - 1] = pad_len;
+    gst_memory_unmap (mem, &map);
+
+    gst_buffer_append_memory (result, mem);
+  }
+
+  return result;
+}
+
 /**
  * gst_rtp_buffer_calc_header_len:
  * @csrc_count: the number of CSRC entries
@@ -363,6 +421,48 @@ gst_rtp_buffer_map (GstBuffer * buffer, GstMapFlags flags, GstRTPBuffer * rtp)
 
   rtp->size[0] = header_len;
 
+  if (n_mem == 1) {
+    /* the common case of a packet in one memory, everything is in the first
+     * map and we don't need to find and map the other parts again */
+    bufsize = size;
+
+    if (data[0] & 0x10) {
+      guint16 extlen;
+
+      if (G_UNLIKELY (size < header_len + 4))
+        goto wrong_length;
+
+      rtp->data[1] = data + header_len;
+      extlen = GST_READ_UINT16_BE (data + header_len + 2);
+      extlen *= sizeof (guint32);
+      extlen += 4;
+
+      if (G_UNLIKELY (size - header_len < extlen))
+        goto wrong_length;
+
+      rtp->size[1] = extlen;
+      header_len += extlen;
+    } else {
+      rtp->data[1] = NULL;
+      rtp->size[1] = 0;
+    }
+
+    if ((data[0] & 0x20) != 0 &&
+        (flags & GST_RTP_BUFFER_MAP_FLAG_SKIP_PADDING) == 0) {
+      padding = data[size - 1];
+      if (G_UNLIKELY (size < padding))
+        goto wrong_length;
+
+      rtp->data[3] = data + size - padding;
+      rtp->size[3] = padding;
+    } else {
+      rtp->data[3] = NULL;
+      rtp->size[3] = 0;
+      padding = 0;
+    }
+    goto check_padding;
+  }
+
   bufsize = gst_buffer_get_size (buffer);
 
   /* calc extension length when present. */
@@ -421,6 +521,7 @@ gst_rtp_buffer_map (GstBuffer * buffer, GstMapFlags flags, GstRTPBuffer * rtp)
     padding = 0;
   }
 
+check_padding:
   /* check if padding and header not bigger than packet length */
   if (G_UNLIKELY (bufsize < padding + header_len))
     goto wrong_padding;
@@ -835,8 +936,10 @@ gst_rtp_buffer_set_extension_data (GstRTPBuffer * rtp, guint16 bits,
       memcpy (map.data, rtp->data[1], rtp->size[1]);
       gst_memory_unmap (mem, &map);
 
-      /* unmap old */
-      gst_buffer_unmap (rtp->buffer, &rtp->map[1]);
+      /* unmap old, it was not mapped separately when the buffer was mapped
+       * from a single memory */
+      if (rtp->map[1].memory)
+        gst_buffer_unmap (rtp->buffer, &rtp->map[1]);
       gst_buffer_replace_memory (rtp->buffer, 1, mem);
     } else {
       /* we didn't have extension data, add */
@@ -1284,83 +1387,192 @@ gst_rtp_buffer_ext_timestamp (guint64 * exttimestamp, guint32 timestamp)
 }
 
 /**
- * gst_rtp_buffer_get_extension_onebyte_header:
+ * gst_rtp_buffer_extension_iter_init:
  * @rtp: the RTP packet
- * @id: The ID of the header extension to be read (between 1 and 14).
- * @nth: Read the nth extension packet with the requested ID
- * @data: (out) (array length=size) (element-type guint8) (transfer none):
- *   location for data
- * @size: (out): the size of the data in bytes
+ * @iter: (out caller-allocates): a #GstRTPBufferExtensionIter to initialize
+ * @appbits: (out) (allow-none): Application specific bits of a two bytes
+ *   header extension, 0 for a one byte header extension
  *
- * Parses RFC 5285 style header extensions with a one byte header. It will
- * return the nth extension with the requested id.
+ * Initializes @iter to go over the RFC 5285 style header extensions of @rtp
+ * with gst_rtp_buffer_extension_iter_next(). This parses the extension block
+ * only once, also when several extensions are read. @iter is valid as long as
+ * @rtp is mapped and its extension data is not changed.
  *
- * Returns: TRUE if @buffer had the requested header extension
+ * Returns: %TRUE if @rtp has RFC 5285 style header extensions with a one byte
+ * or a two bytes header
+ *
+ * Since: 1.10
  */
-
 gboolean
-gst_rtp_buffer_get_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
-    guint nth, gpointer * data, guint * size)
+gst_rtp_buffer_extension_iter_init (GstRTPBuffer * rtp,
+    GstRTPBufferExtensionIter * iter, guint8 * appbits)
 {
   guint16 bits;
   guint8 *pdata;
   guint wordlen;
-  gulong offset = 0;
-  guint count = 0;
 
-  g_return_val_if_fail (id > 0 && id < 15, FALSE);
+  g_return_val_if_fail (iter != NULL, FALSE);
+
+  memset (iter, 0, sizeof (GstRTPBufferExtensionIter));
 
   if (!gst_rtp_buffer_get_extension_data (rtp, &bits, (gpointer) & pdata,
           &wordlen))
     return FALSE;
 
-  if (bits != 0xBEDE)
+  if (bits == 0xBEDE) {
+    iter->twobytes = FALSE;
+  } else if (bits >> 4 == 0x100) {
+    iter->twobytes = TRUE;
+  } else {
     return FALSE;
+  }
+
+  iter->data = pdata;
+  iter->size = wordlen * 4;
+  iter->offset = 0;
+
+  if (appbits)
+    *appbits = iter->twobytes ? bits & 0x0F : 0;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtp_buffer_extension_iter_next:
+ * @iter: a #GstRTPBufferExtensionIter
+ * @id: (out) (allow-none): the ID of the header extension
+ * @data: (out) (array length=size) (element-type guint8) (transfer none)
+ *   (allow-none): location for data
+ * @size: (out) (allow-none): the size of the data in bytes
+ *
+ * Gets the next header extension of @iter. Padding is skipped and parsing
+ * stops at an extension that does not fit in the extension block or, with a
+ * one byte header, at the reserved ID 15.
+ *
+ * Returns: %TRUE if there was another header extension
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_rtp_buffer_extension_iter_next (GstRTPBufferExtensionIter * iter,
+    guint8 * id, gpointer * data, guint * size)
+{
+  g_return_val_if_fail (iter != NULL, FALSE);
 
   for (;;) {
     guint8 read_id, read_len;
 
-    if (offset + 1 >= wordlen * 4)
+    if (iter->offset + (iter->twobytes ? 2 : 1) >= iter->size)
       break;
 
-    read_id = GST_READ_UINT8 (pdata + offset) >> 4;
-    read_len = (GST_READ_UINT8 (pdata + offset) & 0x0F) + 1;
-    offset += 1;
+    if (iter->twobytes) {
+      read_id = GST_READ_UINT8 (iter->data + iter->offset);
+      iter->offset += 1;
 
-    /* ID 0 means its padding, skip */
-    if (read_id == 0)
-      continue;
+      /* ID 0 means its padding, skip */
+      if (read_id == 0)
+        continue;
 
-    /* ID 15 is special and means we should stop parsing */
-    if (read_id == 15)
-      break;
+      read_len = GST_READ_UINT8 (iter->data + iter->offset);
+      iter->offset += 1;
+    } else {
+      read_id = GST_READ_UINT8 (iter->data + iter->offset) >> 4;
+      read_len = (GST_READ_UINT8 (iter->data + iter->offset) & 0x0F) + 1;
+      iter->offset += 1;
+
+      /* ID 0 means its padding, skip */
+      if (read_id == 0)
+        continue;
+
+      /* ID 15 is special and means we should stop parsing */
+      if (read_id == 15)
+        break;
+    }
 
     /* Ignore extension headers where the size does not fit */
-    if (offset + read_len > wordlen * 4)
+    if (iter->offset + read_len > iter->size)
       break;
 
+    if (id)
+      *id = read_id;
+    if (data)
+      *data = iter->data + iter->offset;
+    if (size)
+      *size = read_len;
+
+    iter->offset += read_len;
+
+    return TRUE;
+  }
+
+  /* don't parse again on the next call */
+  iter->offset = iter->size;
+
+  return FALSE;
+}
+
+/* the @nth extension with @id found with @iter */
+static gboolean
+extension_iter_find (GstRTPBufferExtensionIter * iter, guint8 id, guint nth,
+    gpointer * data, guint * size)
+{
+  guint8 read_id;
+  gpointer read_data;
+  guint read_size;
+  guint count = 0;
+
+  while (gst_rtp_buffer_extension_iter_next (iter, &read_id, &read_data,
+          &read_size)) {
     /* If we have the right one */
     if (id == read_id) {
       if (nth == count) {
         if (data)
-          *data = pdata + offset;
+          *data = read_data;
         if (size)
-          *size = read_len;
+          *size = read_size;
 
         return TRUE;
       }
 
       count++;
     }
-    offset += read_len;
-
-    if (offset >= wordlen * 4)
-      break;
   }
 
   return FALSE;
 }
 
+/**
+ * gst_rtp_buffer_get_extension_onebyte_header:
+ * @rtp: the RTP packet
+ * @id: The ID of the header extension to be read (between 1 and 14).
+ * @nth: Read the nth extension packet with the requested ID
+ * @data: (out) (array length=size) (element-type guint8) (transfer none):
+ *   location for data
+ * @size: (out): the size of the data in bytes
+ *
+ * Parses RFC 5285 style header extensions with a one byte header. It will
+ * return the nth extension with the requested id.
+ *
+ * To read several extensions of a packet, use a #GstRTPBufferExtensionIter
+ * instead, this function parses the extensions from the start on every call.
+ *
+ * Returns: TRUE if @buffer had the requested header extension
+ */
+
+gboolean
+gst_rtp_buffer_get_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
+    guint nth, gpointer * data, guint * size)
+{
+  GstRTPBufferExtensionIter iter;
+
+  g_return_val_if_fail (id > 0 && id < 15, FALSE);
+
+  if (!gst_rtp_buffer_extension_iter_init (rtp, &iter, NULL) || iter.twobytes)
+    return FALSE;
+
+  return extension_iter_find (&iter, id, nth, data, size);
+}
+
 /**
  * gst_rtp_buffer_get_extension_twobytes_header:
  * @rtp: the RTP packet
@@ -1374,6 +1586,9 @@ gst_rtp_buffer_get_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
  * Parses RFC 5285 style header extensions with a two bytes header. It will
  * return the nth extension with the requested id.
  *
+ * To read several extensions of a packet, use a #GstRTPBufferExtensionIter
+ * instead, this function parses the extensions from the start on every call.
+ *
  * Returns: TRUE if @buffer had the requested header extension
  */
 
@@ -1381,60 +1596,20 @@ gboolean
 gst_rtp_buffer_get_extension_twobytes_header (GstRTPBuffer * rtp,
     guint8 * appbits, guint8 id, guint nth, gpointer * data, guint * size)
 {
-  guint16 bits;
-  guint8 *pdata = NULL;
-  guint wordlen;
-  guint bytelen;
-  gulong offset = 0;
-  guint count = 0;
+  GstRTPBufferExtensionIter iter;
+  guint8 bits;
 
-  if (!gst_rtp_buffer_get_extension_data (rtp, &bits, (gpointer *) & pdata,
-          &wordlen))
+  if (!gst_rtp_buffer_extension_iter_init (rtp, &iter, &bits) ||
+      !iter.twobytes)
     return FALSE;
 
-  if (bits >> 4 != 0x100)
+  if (!extension_iter_find (&iter, id, nth, data, size))
     return FALSE;
 
-  bytelen = wordlen * 4;
-
-  for (;;) {
-    guint8 read_id, read_len;
-
-    if (offset + 2 >= bytelen)
-      break;
-
-    read_id = GST_READ_UINT8 (pdata + offset);
-    offset += 1;
-
-    if (read_id == 0)
-      continue;
-
-    read_len = GST_READ_UINT8 (pdata + offset);
-    offset += 1;
-
-    /* Ignore extension headers where the size does not fit */
-    if (offset + read_len > bytelen)
-      break;
-
-    /* If we have the right one, return it */
-    if (id == read_id) {
-      if (nth == count) {
-        if (data)
-          *data = pdata + offset;
-        if (size)
-          *size = read_len;
-        if (appbits)
-          *appbits = bits;
-
-        return TRUE;
-      }
-
-      count++;
-    }
-    offset += read_len;
-  }
+  if (appbits)
+    *appbits = bits;
 
-  return FALSE;
+  return TRUE;
 }
 
 static guint
@@ -1495,17 +1670,52 @@ get_onebyte_header_end_offset (guint8 * pdata, guint wordlen)
 gboolean
 gst_rtp_buffer_add_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
     gpointer data, guint size)
+{
+  GstRTPBufferExtension extension;
+
+  extension.id = id;
+  extension.data = data;
+  extension.size = size;
+
+  return gst_rtp_buffer_add_extension_onebyte_headers (rtp, &extension, 1);
+}
+
+/**
+ * gst_rtp_buffer_add_extension_onebyte_headers:
+ * @rtp: the RTP packet
+ * @extensions: (array length=n_extensions): the header extensions to add
+ * @n_extensions: the number of header extensions in @extensions
+ *
+ * Adds several RFC 5285 header extensions with a one byte header, like
+ * gst_rtp_buffer_add_extension_onebyte_header() does for one. The packet is
+ * resized and padded only once for all of them.
+ *
+ * Nothing is added when one of @extensions has an invalid ID or size.
+ *
+ * Returns: %TRUE if the header extensions could be added
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_rtp_buffer_add_extension_onebyte_headers (GstRTPBuffer * rtp,
+    const GstRTPBufferExtension * extensions, guint n_extensions)
 {
   guint16 bits;
   guint8 *pdata = 0;
   guint wordlen;
   gboolean has_bit;
   guint extlen, offset = 0;
+  guint i;
 
-  g_return_val_if_fail (id > 0 && id < 15, FALSE);
-  g_return_val_if_fail (size >= 1 && size <= 16, FALSE);
+  g_return_val_if_fail (extensions != NULL && n_extensions > 0, FALSE);
   g_return_val_if_fail (gst_buffer_is_writable (rtp->buffer), FALSE);
 
+  for (i = 0; i < n_extensions; i++) {
+    g_return_val_if_fail (extensions[i].id > 0 && extensions[i].id < 15, FALSE);
+    g_return_val_if_fail (extensions[i].size >= 1 && extensions[i].size <= 16,
+        FALSE);
+  }
+
   has_bit = gst_rtp_buffer_get_extension_data (rtp, &bits,
       (gpointer) & pdata, &wordlen);
 
@@ -1519,7 +1729,9 @@ gst_rtp_buffer_add_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
   }
 
   /* the required size of the new extension data */
-  extlen = offset + size + 1;
+  extlen = offset;
+  for (i = 0; i < n_extensions; i++)
+    extlen += extensions[i].size + 1;
   /* calculate amount of words */
   wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
 
@@ -1528,11 +1740,14 @@ gst_rtp_buffer_add_extension_onebyte_header (GstRTPBuffer * rtp, guint8 id,
 
   pdata += offset;
 
-  pdata[0] = (id << 4) | (0x0F & (size - 1));
-  memcpy (pdata + 1, data, size);
+  for (i = 0; i < n_extensions; i++) {
+    pdata[0] = (extensions[i].id << 4) | (0x0F & (extensions[i].size - 1));
+    memcpy (pdata + 1, extensions[i].data, extensions[i].size);
+    pdata += extensions[i].size + 1;
+  }
 
   if (extlen % 4)
-    memset (pdata + 1 + size, 0, 4 - (extlen % 4));
+    memset (pdata, 0, 4 - (extlen % 4));
 
   return TRUE;
 }
@@ -1594,6 +1809,38 @@ get_twobytes_header_end_offset (const guint8 * pdata, guint wordlen)
 gboolean
 gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
     guint8 appbits, guint8 id, gpointer data, guint size)
+{
+  GstRTPBufferExtension extension;
+
+  extension.id = id;
+  extension.data = data;
+  extension.size = size;
+
+  return gst_rtp_buffer_add_extension_twobytes_headers (rtp, appbits,
+      &extension, 1);
+}
+
+/**
+ * gst_rtp_buffer_add_extension_twobytes_headers:
+ * @rtp: the RTP packet
+ * @appbits: Application specific bits
+ * @extensions: (array length=n_extensions): the header extensions to add
+ * @n_extensions: the number of header extensions in @extensions
+ *
+ * Adds several RFC 5285 header extensions with a two bytes header, like
+ * gst_rtp_buffer_add_extension_twobytes_header() does for one. The packet is
+ * resized and padded only once for all of them.
+ *
+ * Nothing is added when one of @extensions has an invalid size.
+ *
+ * Returns: %TRUE if the header extensions could be added
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_rtp_buffer_add_extension_twobytes_headers (GstRTPBuffer * rtp,
+    guint8 appbits, const GstRTPBufferExtension * extensions,
+    guint n_extensions)
 {
   guint16 bits;
   guint8 *pdata = 0;
@@ -1601,11 +1848,15 @@ gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
   gboolean has_bit;
   gulong offset = 0;
   guint extlen;
+  guint i;
 
   g_return_val_if_fail ((appbits & 0xF0) == 0, FALSE);
-  g_return_val_if_fail (size < 256, FALSE);
+  g_return_val_if_fail (extensions != NULL && n_extensions > 0, FALSE);
   g_return_val_if_fail (gst_buffer_is_writable (rtp->buffer), FALSE);
 
+  for (i = 0; i < n_extensions; i++)
+    g_return_val_if_fail (extensions[i].size < 256, FALSE);
+
   has_bit = gst_rtp_buffer_get_extension_data (rtp, &bits,
       (gpointer) & pdata, &wordlen);
 
@@ -1619,7 +1870,9 @@ gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
   }
 
   /* the required size of the new extension data */
-  extlen = offset + size + 2;
+  extlen = offset;
+  for (i = 0; i < n_extensions; i++)
+    extlen += extensions[i].size + 2;
   /* calculate amount of words */
   wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
 
@@ -1629,11 +1882,15 @@ gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer * rtp,
 
   pdata += offset;
 
-  pdata[0] = id;
-  pdata[1] = size;
-  memcpy (pdata + 2, data, size);
+  for (i = 0; i < n_extensions; i++) {
+    pdata[0] = extensions[i].id;
+    pdata[1] = extensions[i].size;
+    memcpy (pdata + 2, extensions[i].data, extensions[i].size);
+    pdata += extensions[i].size + 2;
+  }
+
   if (extlen % 4)
-    memset (pdata + 2 + size, 0, 4 - (extlen % 4));
+    memset (pdata, 0, 4 - (extlen % 4));
 
   return TRUE;
 }
@@ -62,6 +62,43 @@ struct _GstRTPBuffer
 #define GST_RTP_BUFFER_INIT { NULL, 0, { NULL, NULL, NULL, NULL}, { 0, 0, 0, 0 }, \
   { GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT} }
 
+/**
+ * GstRTPBufferExtensionIter:
+ *
+ * Iterator over the RFC 5285 style header extensions of a mapped
+ * #GstRTPBuffer. The structure is public to allow stack allocations.
+ *
+ * Since: 1.10
+ */
+typedef struct {
+  /*< private >*/
+  guint8      *data;
+  guint        size;
+  guint        offset;
+  gboolean     twobytes;
+
+  gpointer _gst_reserved[GST_PADDING];
+} GstRTPBufferExtensionIter;
+
+/**
+ * GstRTPBufferExtension:
+ * @id: the ID of the header extension
+ * @data: (array length=size) (element-type guint8): the data of the header
+ *   extension
+ * @size: the size of @data in bytes
+ *
+ * A RFC 5285 style header extension to add with
+ * gst_rtp_buffer_add_extension_onebyte_headers() or
+ * gst_rtp_buffer_add_extension_twobytes_headers().
+ *
+ * Since: 1.10
+ */
+typedef struct {
+  guint8         id;
+  gconstpointer  data;
+  guint          size;
+} GstRTPBufferExtension;
+
 /* creating buffers */
 void            gst_rtp_buffer_allocate_data         (GstBuffer *buffer, guint payload_len,
                                                       guint8 pad_len, guint8 csrc_count);
@@ -70,6 +107,8 @@ GstBuffer*      gst_rtp_buffer_new_take_data         (gpointer data, gsize len);
 GstBuffer*      gst_rtp_buffer_new_copy_data         (gpointer data, gsize len);
 GstBuffer*      gst_rtp_buffer_new_allocate          (guint payload_len, guint8 pad_len, guint8 csrc_count);
 GstBuffer*      gst_rtp_buffer_new_allocate_len      (guint packet_len, guint8 pad_len, guint8 csrc_count);
+GstBuffer*      gst_rtp_buffer_new_with_payload      (GstBuffer *payload, gsize offset, gssize size,
+                                                      guint8 pad_len, guint8 csrc_count);
 
 guint           gst_rtp_buffer_calc_header_len       (guint8 csrc_count);
 guint           gst_rtp_buffer_calc_packet_len       (guint payload_len, guint8 pad_len, guint8 csrc_count);
@@ -150,6 +189,22 @@ gboolean       gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer *rtp,
                                                              gpointer data,
                                                              guint size);
 
+gboolean       gst_rtp_buffer_extension_iter_init           (GstRTPBuffer *rtp,
+                                                             GstRTPBufferExtensionIter *iter,
+                                                             guint8 *appbits);
+gboolean       gst_rtp_buffer_extension_iter_next           (GstRTPBufferExtensionIter *iter,
+                                                             guint8 *id,
+                                                             gpointer *data,
+                                                             guint *size);
+
+gboolean       gst_rtp_buffer_add_extension_onebyte_headers (GstRTPBuffer *rtp,
+                                                             const GstRTPBufferExtension *extensions,
+                                                             guint n_extensions);
+gboolean       gst_rtp_buffer_add_extension_twobytes_headers (GstRTPBuffer *rtp,
+                                                              guint8 appbits,
+                                                              const GstRTPBufferExtension *extensions,
+                                                              guint n_extensions);
+
 /**
  * GstRTPBufferMapFlags:
  * @GST_RTP_BUFFER_MAP_FLAG_SKIP_PADDING: Skip mapping and validation of RTP
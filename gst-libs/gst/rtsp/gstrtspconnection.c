@@ -68,6 +68,8 @@
 
 #include "gstrtspconnection.h"
 
+#include "gst/gst-cpu-x86-private.h"
+
 #ifdef IP_TOS
 union gst_sockaddr
 {
@@ -82,11 +84,173 @@ typedef struct
 {
   gint state;
   guint save;
-  guchar out[3];                /* the size must be evenly divisible by 3 */
+  guchar out[768];              /* the size must be evenly divisible by 3 */
   guint cout;
   guint coutl;
 } DecodeCtx;
 
+/* Decoding of the base64 of tunnelled connections. Runs of 16 (64 with NEON)
+ * characters of the base64 alphabet are decoded with SIMD and the rest, with
+ * the padding and the characters that are skipped, by GLib. The result is the
+ * same as with g_base64_decode_step() alone. The SSSE3 version is only used
+ * when the CPU has it. */
+#if defined (HAVE_IMMINTRIN_H) && defined (GST_CPU_X86_HAVE_TARGET)
+#define HAVE_BASE64_DECODE_SIMD
+#define HAVE_BASE64_DECODE_SSSE3
+#pragma GCC push_options
+#pragma GCC target ("ssse3")
+#include <tmmintrin.h>
+
+#define RANGE_SSE(c,lo,hi) \
+  _mm_and_si128 (_mm_cmpgt_epi8 (c, _mm_set1_epi8 ((lo) - 1)), \
+      _mm_cmplt_epi8 (c, _mm_set1_epi8 ((hi) + 1)))
+
+static gsize
+base64_decode_simd (const guint8 * in, gsize len, guint8 * out, gsize * done)
+{
+  /* the 3 bytes of every 32 bit word in stream order */
+  const __m128i shuf =
+      _mm_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  gsize i, n = 0;
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    __m128i c = _mm_loadu_si128 ((const __m128i *) (in + i));
+    __m128i upper = RANGE_SSE (c, 'A', 'Z');
+    __m128i lower = RANGE_SSE (c, 'a', 'z');
+    __m128i digit = RANGE_SSE (c, '0', '9');
+    __m128i plus = _mm_cmpeq_epi8 (c, _mm_set1_epi8 ('+'));
+    __m128i slash = _mm_cmpeq_epi8 (c, _mm_set1_epi8 ('/'));
+    __m128i off, v;
+    guint32 last;
+
+    if (_mm_movemask_epi8 (_mm_or_si128 (_mm_or_si128 (upper, lower),
+                _mm_or_si128 (_mm_or_si128 (digit, plus), slash))) != 0xffff)
+      break;
+
+    /* add the offset of the range to get the 6 bit values */
+    off = _mm_or_si128 (_mm_or_si128 (_mm_and_si128 (upper,
+                _mm_set1_epi8 (-'A')), _mm_and_si128 (lower,
+                _mm_set1_epi8 (26 - 'a'))), _mm_or_si128 (_mm_and_si128 (digit,
+                _mm_set1_epi8 (52 - '0')), _mm_or_si128 (_mm_and_si128 (plus,
+                    _mm_set1_epi8 (62 - '+')), _mm_and_si128 (slash,
+                    _mm_set1_epi8 (63 - '/')))));
+    v = _mm_add_epi8 (c, off);
+
+    /* 4 values of 6 bits into 24 bits */
+    v = _mm_maddubs_epi16 (v, _mm_set1_epi32 (0x01400140));
+    v = _mm_madd_epi16 (v, _mm_set1_epi32 (0x00011000));
+    v = _mm_shuffle_epi8 (v, shuf);
+
+    _mm_storel_epi64 ((__m128i *) (out + n), v);
+    last = _mm_cvtsi128_si32 (_mm_srli_si128 (v, 8));
+    memcpy (out + n + 8, &last, 4);
+    n += 12;
+  }
+  *done = i;
+  return n;
+}
+
+#pragma GCC pop_options
+
+static gboolean
+base64_decode_simd_supported (void)
+{
+  static gsize supported = 0;
+
+  if (g_once_init_enter (&supported)) {
+    gboolean ssse3 = (gst_cpu_x86_get_flags () & GST_CPU_X86_SSSE3) != 0;
+
+    GST_DEBUG ("SSSE3 base64 decoding %s", ssse3 ? "enabled" : "disabled");
+    g_once_init_leave (&supported, ssse3 ? 2 : 1);
+  }
+  return supported == 2;
+}
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define HAVE_BASE64_DECODE_SIMD
+#include <arm_neon.h>
+
+#define RANGE_NEON(c,lo,hi) \
+  vandq_u8 (vcgeq_u8 (c, vdupq_n_u8 (lo)), vcleq_u8 (c, vdupq_n_u8 (hi)))
+
+/* the 6 bit values of @c, @bad gets the bits of the characters that are not
+ * in the alphabet */
+static inline uint8x16_t
+base64_values_neon (uint8x16_t c, uint8x16_t * bad)
+{
+  uint8x16_t upper = RANGE_NEON (c, 'A', 'Z');
+  uint8x16_t lower = RANGE_NEON (c, 'a', 'z');
+  uint8x16_t digit = RANGE_NEON (c, '0', '9');
+  uint8x16_t plus = vceqq_u8 (c, vdupq_n_u8 ('+'));
+  uint8x16_t slash = vceqq_u8 (c, vdupq_n_u8 ('/'));
+  uint8x16_t off;
+
+  *bad = vorrq_u8 (*bad, vmvnq_u8 (vorrq_u8 (vorrq_u8 (upper, lower),
+              vorrq_u8 (vorrq_u8 (digit, plus), slash))));
+
+  off = vorrq_u8 (vorrq_u8 (vandq_u8 (upper, vdupq_n_u8 ((guint8) (-'A'))),
+          vandq_u8 (lower, vdupq_n_u8 ((guint8) (26 - 'a')))),
+      vorrq_u8 (vandq_u8 (digit, vdupq_n_u8 ((guint8) (52 - '0'))),
+          vorrq_u8 (vandq_u8 (plus, vdupq_n_u8 (62 - '+')),
+              vandq_u8 (slash, vdupq_n_u8 (63 - '/')))));
+
+  return vaddq_u8 (c, off);
+}
+
+static gsize
+base64_decode_simd (const guint8 * in, gsize len, guint8 * out, gsize * done)
+{
+  gsize i, n = 0;
+
+  for (i = 0; i + 64 <= len; i += 64) {
+    uint8x16x4_t c = vld4q_u8 (in + i);
+    uint8x16_t a, b, d, e, bad = vdupq_n_u8 (0);
+    uint8x8_t bad8;
+    uint8x16x3_t o;
+
+    a = base64_values_neon (c.val[0], &bad);
+    b = base64_values_neon (c.val[1], &bad);
+    d = base64_values_neon (c.val[2], &bad);
+    e = base64_values_neon (c.val[3], &bad);
+
+    bad8 = vorr_u8 (vget_low_u8 (bad), vget_high_u8 (bad));
+    if (vget_lane_u64 (vreinterpret_u64_u8 (bad8), 0) != 0)
+      break;
+
+    o.val[0] = vorrq_u8 (vshlq_n_u8 (a, 2), vshrq_n_u8 (b, 4));
+    o.val[1] = vorrq_u8 (vshlq_n_u8 (b, 4), vshrq_n_u8 (d, 2));
+    o.val[2] = vorrq_u8 (vshlq_n_u8 (d, 6), e);
+    vst3q_u8 (out + n, o);
+    n += 48;
+  }
+  *done = i;
+  return n;
+}
+
+#define base64_decode_simd_supported() TRUE
+#endif
+
+static gsize
+base64_decode_step (const guint8 * in, gsize len, guint8 * out, gint * state,
+    guint * save)
+{
+  gsize n = 0;
+
+#ifdef HAVE_BASE64_DECODE_SIMD
+  /* only between groups of 4 characters and without pending padding */
+  if (*state == 0 && base64_decode_simd_supported ()) {
+    gsize done;
+
+    n = base64_decode_simd (in, len, out, &done);
+    in += done;
+    len -= done;
+  }
+#endif
+
+  return n + g_base64_decode_step ((const gchar *) in, len, out + n, state,
+      save);
+}
+
 #ifdef MSG_NOSIGNAL
 #define SEND_FLAGS MSG_NOSIGNAL
 #else
@@ -103,6 +267,10 @@ typedef enum
 
 #define TUNNELID_LEN   24
 
+/* reads smaller than this are done through the read buffer of the
+ * connection */
+#define READ_BUFFER_SIZE 4096
+
 struct _GstRTSPConnection
 {
   /*< private > */
@@ -141,6 +309,12 @@ struct _GstRTSPConnection
   gchar *initial_buffer;
   gsize initial_buffer_offset;
 
+  /* the data we read ahead from the input stream, the headers are read a
+   * few bytes at a time and we don't want to do a read for each of them */
+  guint8 read_buffer[READ_BUFFER_SIZE];
+  guint read_buffer_offset;
+  guint read_buffer_len;
+
   gboolean remember_session_id; /* remember the session id or not */
 
   /* Session state */
@@ -1230,17 +1404,50 @@ fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
       conn->initial_buffer_offset += out;
   }
 
+  if (conn->read_buffer_len > 0 && size > (guint) out) {
+    guint left = conn->read_buffer_len - conn->read_buffer_offset;
+    guint n = MIN (left, size - out);
+
+    memcpy (&buffer[out], &conn->read_buffer[conn->read_buffer_offset], n);
+    out += n;
+
+    if (left == n)
+      conn->read_buffer_offset = conn->read_buffer_len = 0;
+    else
+      conn->read_buffer_offset += n;
+  }
+
   if (G_LIKELY (size > (guint) out)) {
     gssize r;
     gsize count = size - out;
+    gboolean buffered;
+
+    /* for small reads, read as much as is available into the read buffer.
+     * Bigger reads, like the bodies of most messages, are done directly into
+     * the destination */
+    buffered = out == 0 && count < READ_BUFFER_SIZE;
+
     if (block)
-      r = g_input_stream_read (conn->input_stream, (gchar *) & buffer[out],
-          count, conn->may_cancel ? conn->cancellable : NULL, err);
+      r = g_input_stream_read (conn->input_stream,
+          buffered ? (gchar *) conn->read_buffer : (gchar *) & buffer[out],
+          buffered ? READ_BUFFER_SIZE : count,
+          conn->may_cancel ? conn->cancellable : NULL, err);
     else
       r = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
-          (conn->input_stream), (gchar *) & buffer[out], count,
+          (conn->input_stream),
+          buffered ? (gchar *) conn->read_buffer : (gchar *) & buffer[out],
+          buffered ? READ_BUFFER_SIZE : count,
           conn->may_cancel ? conn->cancellable : NULL, err);
 
+    if (buffered && r > 0) {
+      if ((gsize) r > count) {
+        conn->read_buffer_offset = count;
+        conn->read_buffer_len = r;
+        r = count;
+      }
+      memcpy (buffer, conn->read_buffer, r);
+    }
+
     if (G_UNLIKELY (r < 0)) {
       if (out == 0) {
         /* propagate the error */
@@ -1266,31 +1473,49 @@ fill_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
   if (ctx) {
     while (size > 0) {
       guint8 in[sizeof (ctx->out) * 4 / 3];
+      guint avail, len;
+      gsize n;
       gint r;
 
-      while (size > 0 && ctx->cout < ctx->coutl) {
+      if (ctx->cout < ctx->coutl) {
         /* we have some leftover bytes */
-        *buffer++ = ctx->out[ctx->cout++];
-        size--;
-        out++;
+        avail = MIN (size, ctx->coutl - ctx->cout);
+        memcpy (buffer, &ctx->out[ctx->cout], avail);
+        ctx->cout += avail;
+        buffer += avail;
+        size -= avail;
+        out += avail;
       }
 
       /* got what we needed? */
       if (size == 0)
         break;
 
+      /* 4 characters decode to at most 3 bytes, also with the characters
+       * that are pending in the state, so this much can be decoded into
+       * @buffer directly */
+      len = MIN (sizeof (in), size / 3 * 4);
+      if (len == 0)
+        len = sizeof (in);
+
       /* try to read more bytes */
-      r = fill_raw_bytes (conn, in, sizeof (in), block, err);
+      r = fill_raw_bytes (conn, in, len, block, err);
       if (r <= 0) {
         if (out == 0)
           out = r;
         break;
       }
 
-      ctx->cout = 0;
-      ctx->coutl =
-          g_base64_decode_step ((gchar *) in, r, ctx->out, &ctx->state,
-          &ctx->save);
+      if (size >= 3) {
+        n = base64_decode_step (in, r, buffer, &ctx->state, &ctx->save);
+        buffer += n;
+        size -= n;
+        out += n;
+      } else {
+        ctx->cout = 0;
+        ctx->coutl =
+            base64_decode_step (in, r, ctx->out, &ctx->state, &ctx->save);
+      }
     }
   } else {
     out = fill_raw_bytes (conn, buffer, size, block, err);
@@ -2379,6 +2604,8 @@ gst_rtsp_connection_close (GstRTSPConnection * conn)
   conn->initial_buffer = NULL;
   conn->initial_buffer_offset = 0;
 
+  conn->read_buffer_offset = conn->read_buffer_len = 0;
+
   conn->write_socket = NULL;
   conn->read_socket = NULL;
   conn->tunneled = FALSE;
@@ -2462,6 +2689,39 @@ gst_rtsp_connection_poll (GstRTSPConnection * conn, GstRTSPEvent events,
   g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
   g_return_val_if_fail (conn->write_socket != NULL, GST_RTSP_EINVAL);
 
+  /* data that we already read can be read without waiting */
+  if ((events & GST_RTSP_EV_READ) && conn->read_buffer_len > 0) {
+    *revents = GST_RTSP_EV_READ;
+    if (events & GST_RTSP_EV_WRITE) {
+      condition = g_socket_condition_check (conn->write_socket, G_IO_OUT);
+      if ((condition & G_IO_OUT))
+        *revents |= GST_RTSP_EV_WRITE;
+    }
+    return GST_RTSP_OK;
+  }
+
+  if (events == GST_RTSP_EV_READ || events == GST_RTSP_EV_WRITE) {
+    /* waiting on one socket doesn't need a main context */
+    GSocket *socket;
+    gint64 timeout_us = -1;
+
+    if (events == GST_RTSP_EV_READ) {
+      socket = conn->read_socket;
+      condition = G_IO_IN | G_IO_PRI;
+    } else {
+      socket = conn->write_socket;
+      condition = G_IO_OUT;
+    }
+
+    if (timeout)
+      timeout_us = GST_TIMEVAL_TO_TIME (*timeout) / GST_USECOND;
+
+    /* errors, timeouts and cancellation are handled by the check below */
+    g_socket_condition_timed_wait (socket, condition, timeout_us,
+        conn->cancellable, NULL);
+    goto check;
+  }
+
   ctx = g_main_context_new ();
 
   /* configure timeout if any */
@@ -2493,6 +2753,7 @@ gst_rtsp_connection_poll (GstRTSPConnection * conn, GstRTSPEvent events,
 
   g_main_context_unref (ctx);
 
+check:
   *revents = 0;
   if (events & GST_RTSP_EV_READ) {
     condition = g_socket_condition_check (conn->read_socket,
@@ -3078,6 +3339,12 @@ gst_rtsp_connection_do_tunnel (GstRTSPConnection * conn,
     conn->initial_buffer = conn2->initial_buffer;
     conn2->initial_buffer = NULL;
     conn->initial_buffer_offset = conn2->initial_buffer_offset;
+
+    /* and what conn2 read after the POST request */
+    memcpy (conn->read_buffer, conn2->read_buffer, conn2->read_buffer_len);
+    conn->read_buffer_offset = conn2->read_buffer_offset;
+    conn->read_buffer_len = conn2->read_buffer_len;
+    conn2->read_buffer_offset = conn2->read_buffer_len = 0;
   }
 
   /* we need base64 decoding for the readfd */
@@ -3162,6 +3429,7 @@ struct _GstRTSPWatch
   guint write_off;
   guint write_size;
   guint write_id;
+  GArray *write_ids;            /* of all the messages in write_data */
   gsize max_bytes;
   guint max_messages;
   GCond queue_not_full;
@@ -3173,6 +3441,10 @@ struct _GstRTSPWatch
   GDestroyNotify notify;
 };
 
+/* small queued messages are copied together up to this size and sent with
+ * one write */
+#define WRITE_BATCH_SIZE (16 * 1024)
+
 #define IS_BACKLOG_FULL(w) (((w)->max_bytes != 0 && (w)->messages_bytes >= (w)->max_bytes) || \
       ((w)->max_messages != 0 && (w)->messages->length >= (w)->max_messages))
 
@@ -3181,7 +3453,8 @@ gst_rtsp_source_prepare (GSource * source, gint * timeout)
 {
   GstRTSPWatch *watch = (GstRTSPWatch *) source;
 
-  if (watch->conn->initial_buffer != NULL)
+  if (watch->conn->initial_buffer != NULL ||
+      watch->conn->read_buffer_len > 0)
     return TRUE;
 
   *timeout = (watch->conn->timeout * 1000);
@@ -3405,19 +3678,23 @@ gst_rtsp_source_dispatch (GSource * source, GSourceFunc callback G_GNUC_UNUSED,
   GstRTSPWatch *watch = (GstRTSPWatch *) source;
   GstRTSPConnection *conn = watch->conn;
 
-  if (conn->initial_buffer != NULL) {
+  if ((conn->initial_buffer != NULL || conn->read_buffer_len > 0) &&
+      conn->input_stream != NULL) {
     gst_rtsp_source_dispatch_read (G_POLLABLE_INPUT_STREAM (conn->input_stream),
         watch);
   }
   return watch->keep_running;
 }
 
+static void gst_rtsp_rec_free (gpointer data);
+
 static gboolean
 gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
     GstRTSPWatch * watch)
 {
   GstRTSPResult res = GST_RTSP_ERROR;
   GstRTSPConnection *conn = watch->conn;
+  GstRTSPRec *next;
 
   /* if this connection was already closed, stop now */
   if (G_POLLABLE_OUTPUT_STREAM (conn->output_stream) != stream)
@@ -3460,11 +3737,48 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
       watch->messages_bytes -= rec->size;
 
       watch->write_off = 0;
-      watch->write_data = rec->data;
-      watch->write_size = rec->size;
       watch->write_id = rec->id;
+      g_array_set_size (watch->write_ids, 0);
+      g_array_append_val (watch->write_ids, rec->id);
+
+      next = g_queue_peek_tail (watch->messages);
+      if (next != NULL && rec->size + next->size <= WRITE_BATCH_SIZE) {
+        guint8 *data;
+        guint size;
+        GList *walk;
+
+        /* with interleaved data there are usually many small messages
+         * queued, send them together instead of doing a write for each */
+        size = rec->size;
+        for (walk = watch->messages->tail; walk; walk = walk->prev) {
+          next = walk->data;
+          if (size + next->size > WRITE_BATCH_SIZE)
+            break;
+          size += next->size;
+        }
+
+        data = g_malloc (size);
+        memcpy (data, rec->data, rec->size);
+        watch->write_size = rec->size;
+        gst_rtsp_rec_free (rec);
+
+        while (watch->write_size < size) {
+          rec = g_queue_pop_tail (watch->messages);
+          watch->messages_bytes -= rec->size;
+          memcpy (data + watch->write_size, rec->data, rec->size);
+          watch->write_size += rec->size;
+          g_array_append_val (watch->write_ids, rec->id);
+          gst_rtsp_rec_free (rec);
+        }
+        watch->write_data = data;
 
-      g_slice_free (GstRTSPRec, rec);
+        GST_LOG ("sending %u messages of %u bytes together",
+            watch->write_ids->len, size);
+      } else {
+        watch->write_data = rec->data;
+        watch->write_size = rec->size;
+        g_slice_free (GstRTSPRec, rec);
+      }
     }
 
     res = write_bytes (conn->output_stream, watch->write_data,
@@ -3477,8 +3791,13 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
     if (res == GST_RTSP_EINTR)
       goto write_blocked;
     else if (G_LIKELY (res == GST_RTSP_OK)) {
-      if (watch->funcs.message_sent)
-        watch->funcs.message_sent (watch, watch->write_id, watch->user_data);
+      if (watch->funcs.message_sent) {
+        guint i;
+
+        for (i = 0; i < watch->write_ids->len; i++)
+          watch->funcs.message_sent (watch,
+              g_array_index (watch->write_ids, guint, i), watch->user_data);
+      }
     } else {
       goto write_error;
     }
@@ -3535,6 +3854,7 @@ gst_rtsp_source_finalize (GSource * source)
   watch->messages_bytes = 0;
 
   g_free (watch->write_data);
+  g_array_free (watch->write_ids, TRUE);
   g_cond_clear (&watch->queue_not_full);
 
   if (watch->readsrc)
@@ -3593,6 +3913,7 @@ gst_rtsp_watch_new (GstRTSPConnection * conn,
 
   g_mutex_init (&result->mutex);
   result->messages = g_queue_new ();
+  result->write_ids = g_array_new (FALSE, FALSE, sizeof (guint));
   g_cond_init (&result->queue_not_full);
 
   gst_rtsp_watch_reset (result);
@@ -3750,6 +4071,32 @@ gst_rtsp_watch_get_send_backlog (GstRTSPWatch * watch,
   g_mutex_unlock (&watch->mutex);
 }
 
+/**
+ * gst_rtsp_watch_get_send_backlog_level:
+ * @watch: a #GstRTSPWatch
+ * @bytes: (out) (allow-none): queued bytes
+ * @messages: (out) (allow-none): queued messages
+ *
+ * Get the amount of bytes and messages that are currently queued in @watch
+ * and waiting to be sent. This can be compared to the limits set with
+ * gst_rtsp_watch_set_send_backlog().
+ *
+ * Since: 1.10
+ */
+void
+gst_rtsp_watch_get_send_backlog_level (GstRTSPWatch * watch,
+    gsize * bytes, guint * messages)
+{
+  g_return_if_fail (watch != NULL);
+
+  g_mutex_lock (&watch->mutex);
+  if (bytes)
+    *bytes = watch->messages_bytes;
+  if (messages)
+    *messages = watch->messages->length;
+  g_mutex_unlock (&watch->mutex);
+}
+
 /**
  * gst_rtsp_watch_write_data:
  * @watch: a #GstRTSPWatch
@@ -211,6 +211,8 @@ void               gst_rtsp_watch_set_send_backlog  (GstRTSPWatch *watch,
                                                      gsize bytes, guint messages);
 void               gst_rtsp_watch_get_send_backlog  (GstRTSPWatch *watch,
                                                      gsize *bytes, guint *messages);
+void               gst_rtsp_watch_get_send_backlog_level (GstRTSPWatch *watch,
+                                                     gsize *bytes, guint *messages);
 
 GstRTSPResult      gst_rtsp_watch_write_data         (GstRTSPWatch *watch,
                                                       const guint8 *data,
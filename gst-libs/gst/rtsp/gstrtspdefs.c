@@ -382,17 +382,49 @@ gst_rtsp_status_as_text (GstRTSPStatusCode code)
  * Returns: a #GstRTSPHeaderField for @header or #GST_RTSP_HDR_INVALID if the
  * header field is unknown.
  */
+static guint
+header_name_hash (gconstpointer key)
+{
+  const gchar *p;
+  guint32 h = 5381;
+
+  for (p = key; *p != '\0'; p++)
+    h = (h << 5) + h + g_ascii_tolower (*p);
+
+  return h;
+}
+
+static gboolean
+header_name_equal (gconstpointer a, gconstpointer b)
+{
+  return g_ascii_strcasecmp (a, b) == 0;
+}
+
+/* maps the header names, in any case, to their field */
+static GHashTable *
+rtsp_init_headers (void)
+{
+  GHashTable *headers = g_hash_table_new (header_name_hash, header_name_equal);
+  gint idx;
+
+  for (idx = 0; rtsp_headers[idx].name; idx++)
+    g_hash_table_insert (headers, (gpointer) rtsp_headers[idx].name,
+        GINT_TO_POINTER (idx + 1));
+
+  return headers;
+}
+
 GstRTSPHeaderField
 gst_rtsp_find_header_field (const gchar * header)
 {
-  gint idx;
+  static GHashTable *headers;
 
-  for (idx = 0; rtsp_headers[idx].name; idx++) {
-    if (g_ascii_strcasecmp (rtsp_headers[idx].name, header) == 0) {
-      return idx + 1;
-    }
-  }
-  return GST_RTSP_HDR_INVALID;
+  /* this is called for every header that is parsed, so don't compare with
+   * all the names */
+  if (g_once_init_enter (&headers))
+    g_once_init_leave (&headers, rtsp_init_headers ());
+
+  return GPOINTER_TO_INT (g_hash_table_lookup (headers, header));
 }
 
 /**
@@ -62,6 +62,40 @@ typedef struct _RTSPKeyValue
   gchar *custom_key;            /* custom header string (field is INVALID then) */
 } RTSPKeyValue;
 
+/* the known header fields that are in a message have their bit set in the
+ * mask so that looking up a header that is not there is cheap */
+G_STATIC_ASSERT (GST_RTSP_HDR_LAST <= 128);
+
+#define HDR_IN_MASK(field) \
+  ((field) > GST_RTSP_HDR_INVALID && (field) < GST_RTSP_HDR_LAST)
+#define HDR_MASK_WORD(msg,field) ((msg)->ABI.hdr_mask[(field) >> 5])
+#define HDR_MASK_BIT(field) (1u << ((field) & 31))
+
+/* FALSE when @msg has no header with @field */
+static inline gboolean
+hdr_mask_check (const GstRTSPMessage * msg, GstRTSPHeaderField field)
+{
+  if (!HDR_IN_MASK (field))
+    return TRUE;
+  return (HDR_MASK_WORD (msg, field) & HDR_MASK_BIT (field)) != 0;
+}
+
+/* update the bit of @field after headers were removed */
+static void
+hdr_mask_update (GstRTSPMessage * msg, GstRTSPHeaderField field)
+{
+  guint i;
+
+  if (!HDR_IN_MASK (field))
+    return;
+
+  for (i = 0; i < msg->hdr_fields->len; i++) {
+    if (g_array_index (msg->hdr_fields, RTSPKeyValue, i).field == field)
+      return;
+  }
+  HDR_MASK_WORD (msg, field) &= ~HDR_MASK_BIT (field);
+}
+
 static void
 key_value_foreach (GArray * array, GFunc func, gpointer user_data)
 {
@@ -522,6 +556,8 @@ gst_rtsp_message_take_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
   key_value.custom_key = NULL;
 
   g_array_append_val (msg->hdr_fields, key_value);
+  if (HDR_IN_MASK (field))
+    HDR_MASK_WORD (msg, field) |= HDR_MASK_BIT (field);
 
   return GST_RTSP_OK;
 }
@@ -565,6 +601,9 @@ gst_rtsp_message_remove_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
 
   g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
 
+  if (!hdr_mask_check (msg, field))
+    return res;
+
   while (i < msg->hdr_fields->len) {
     RTSPKeyValue *key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
 
@@ -578,6 +617,9 @@ gst_rtsp_message_remove_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
       i++;
     }
   }
+  if (res == GST_RTSP_OK)
+    hdr_mask_update (msg, field);
+
   return res;
 }
 
@@ -604,7 +646,7 @@ gst_rtsp_message_get_header (const GstRTSPMessage * msg,
   g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
 
   /* no header initialized, there are no headers */
-  if (msg->hdr_fields == NULL)
+  if (msg->hdr_fields == NULL || !hdr_mask_check (msg, field))
     return GST_RTSP_ENOTIMPL;
 
   for (i = 0; i < msg->hdr_fields->len; i++) {
@@ -696,6 +738,9 @@ gst_rtsp_message_find_header_by_name (GstRTSPMessage * msg,
     return -1;
 
   field = gst_rtsp_find_header_field (header);
+  if (!hdr_mask_check (msg, field))
+    return -1;
+
   for (i = 0; i < msg->hdr_fields->len; i++) {
     RTSPKeyValue *key_val;
 
@@ -733,6 +778,7 @@ gst_rtsp_message_remove_header_by_name (GstRTSPMessage * msg,
     const gchar * header, gint index)
 {
   GstRTSPResult res = GST_RTSP_ENOTIMPL;
+  GstRTSPHeaderField field = GST_RTSP_HDR_INVALID;
   RTSPKeyValue *kv;
   gint pos;
 
@@ -746,12 +792,16 @@ gst_rtsp_message_remove_header_by_name (GstRTSPMessage * msg,
       break;
 
     kv = &g_array_index (msg->hdr_fields, RTSPKeyValue, pos);
+    field = kv->field;
     g_free (kv->value);
     g_free (kv->custom_key);
     g_array_remove_index (msg->hdr_fields, pos);
     res = GST_RTSP_OK;
   } while (index < 0);
 
+  if (res == GST_RTSP_OK)
+    hdr_mask_update (msg, field);
+
   return res;
 }
 
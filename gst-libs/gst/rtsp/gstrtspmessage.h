@@ -104,7 +104,12 @@ struct _GstRTSPMessage
   guint8        *body;
   guint          body_size;
 
-  gpointer _gst_reserved[GST_PADDING];
+  /* Union preserves padded struct size for backwards compat */
+  union {
+    /* a bit for every known header field in hdr_fields */
+    guint32      hdr_mask[4];
+    gpointer _gst_reserved[GST_PADDING];
+  } ABI;
 };
 
 /* memory management */
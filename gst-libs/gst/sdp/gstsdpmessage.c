@@ -163,6 +163,7 @@ GstSDPResult gst_sdp_message_add_##method (GstSDPMessage *msg, const type val) {
 
 static GstSDPMessage *gst_sdp_message_boxed_copy (GstSDPMessage * orig);
 static void gst_sdp_message_boxed_free (GstSDPMessage * msg);
+static void media_append_text (const GstSDPMedia * media, GString * lines);
 
 G_DEFINE_BOXED_TYPE (GstSDPMessage, gst_sdp_message, gst_sdp_message_boxed_copy,
     gst_sdp_message_boxed_free);
@@ -463,7 +464,7 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
 
   g_return_val_if_fail (msg != NULL, NULL);
 
-  lines = g_string_new ("");
+  lines = g_string_sized_new (1024);
 
   if (msg->version)
     g_string_append_printf (lines, "v=%s\r\n", msg->version);
@@ -557,21 +558,19 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
     const GstSDPAttribute *attr = gst_sdp_message_get_attribute (msg, i);
 
     if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value)
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
+      g_string_append (lines, "a=");
+      g_string_append (lines, attr->key);
+      if (attr->value) {
+        g_string_append_c (lines, ':');
+        g_string_append (lines, attr->value);
+      }
+      g_string_append (lines, "\r\n");
     }
   }
 
-  for (i = 0; i < gst_sdp_message_medias_len (msg); i++) {
-    const GstSDPMedia *media = gst_sdp_message_get_media (msg, i);
-    gchar *sdp_media_str;
-
-    sdp_media_str = gst_sdp_media_as_text (media);
-    g_string_append_printf (lines, "%s", sdp_media_str);
-    g_free (sdp_media_str);
-  }
+  /* append the medias directly, a large message can have many of them */
+  for (i = 0; i < gst_sdp_message_medias_len (msg); i++)
+    media_append_text (gst_sdp_message_get_media (msg, i), lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -1879,24 +1878,11 @@ gst_sdp_media_copy (const GstSDPMedia * media, GstSDPMedia ** copy)
   return GST_SDP_OK;
 }
 
-/**
- * gst_sdp_media_as_text:
- * @media: a #GstSDPMedia
- *
- * Convert the contents of @media to a text string.
- *
- * Returns: A dynamically allocated string representing the media.
- */
-gchar *
-gst_sdp_media_as_text (const GstSDPMedia * media)
+static void
+media_append_text (const GstSDPMedia * media, GString * lines)
 {
-  GString *lines;
   guint i;
 
-  g_return_val_if_fail (media != NULL, NULL);
-
-  lines = g_string_new ("");
-
   if (media->media)
     g_string_append_printf (lines, "m=%s", media->media);
 
@@ -1907,9 +1893,11 @@ gst_sdp_media_as_text (const GstSDPMedia * media)
 
   g_string_append_printf (lines, " %s", media->proto);
 
-  for (i = 0; i < gst_sdp_media_formats_len (media); i++)
-    g_string_append_printf (lines, " %s", gst_sdp_media_get_format (media, i));
-  g_string_append_printf (lines, "\r\n");
+  for (i = 0; i < gst_sdp_media_formats_len (media); i++) {
+    g_string_append_c (lines, ' ');
+    g_string_append (lines, gst_sdp_media_get_format (media, i));
+  }
+  g_string_append (lines, "\r\n");
 
   if (media->information)
     g_string_append_printf (lines, "i=%s", media->information);
@@ -1950,12 +1938,34 @@ gst_sdp_media_as_text (const GstSDPMedia * media)
     const GstSDPAttribute *attr = gst_sdp_media_get_attribute (media, i);
 
     if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
+      g_string_append (lines, "a=");
+      g_string_append (lines, attr->key);
+      if (attr->value && attr->value[0] != '\0') {
+        g_string_append_c (lines, ':');
+        g_string_append (lines, attr->value);
+      }
+      g_string_append (lines, "\r\n");
     }
   }
+}
+
+/**
+ * gst_sdp_media_as_text:
+ * @media: a #GstSDPMedia
+ *
+ * Convert the contents of @media to a text string.
+ *
+ * Returns: A dynamically allocated string representing the media.
+ */
+gchar *
+gst_sdp_media_as_text (const GstSDPMedia * media)
+{
+  GString *lines;
+
+  g_return_val_if_fail (media != NULL, NULL);
+
+  lines = g_string_sized_new (256);
+  media_append_text (media, lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -2888,14 +2898,25 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
         gst_sdp_media_set_key (c->media, str, p);
       break;
     case 'a':
-      read_string_del (str, sizeof (str), ':', &p);
-      if (*p != '\0')
+    {
+      gchar *key;
+
+      /* attributes are by far the most common lines, split them in the line
+       * buffer instead of copying the key first */
+      while (g_ascii_isspace (*p))
         p++;
+      key = p;
+      if ((p = strchr (key, ':')))
+        *p++ = '\0';
+      else
+        p = key + strlen (key);
+
       if (c->state == SDP_SESSION)
-        gst_sdp_message_add_attribute (c->msg, str, p);
+        gst_sdp_message_add_attribute (c->msg, key, p);
       else
-        gst_sdp_media_add_attribute (c->media, str, p);
+        gst_sdp_media_add_attribute (c->media, key, p);
       break;
+    }
     case 'm':
     {
       gchar *slash;
@@ -3174,22 +3195,42 @@ gst_sdp_get_attribute_for_pt (const GstSDPMedia * media, const gchar * name,
 {
   guint i;
 
-  for (i = 0;; i++) {
-    const gchar *attr;
-    gint val;
+  /* one pass over the attributes, this is called for every stream of every
+   * DESCRIBE and SETUP on a server */
+  for (i = 0; i < media->attributes->len; i++) {
+    const GstSDPAttribute *attr;
+    gchar *end;
+    glong val;
 
-    if ((attr = gst_sdp_media_get_attribute_val_n (media, name, i)) == NULL)
-      break;
+    attr = &g_array_index (media->attributes, GstSDPAttribute, i);
+    if (attr->value == NULL || strcmp (attr->key, name))
+      continue;
 
-    if (sscanf (attr, "%d ", &val) != 1)
+    val = strtol (attr->value, &end, 10);
+    if (end == attr->value)
       continue;
 
     if (val == pt)
-      return attr;
+      return attr->value;
   }
   return NULL;
 }
 
+/* parses the leading <payload> of @val, which must be followed by a space.
+ * Returns the position after the space or %NULL. */
+static const gchar *
+gst_sdp_parse_payload (const gchar * val, gint * payload)
+{
+  const gchar *p;
+
+  if ((p = strchr (val, ' ')) == NULL)
+    return NULL;
+
+  *payload = atoi (val);
+
+  return p + 1;
+}
+
 #define PARSE_INT(p, del, res)          \
 G_STMT_START {                          \
   gchar *t = p;                         \
@@ -3294,6 +3335,7 @@ gst_sdp_media_get_caps_from_media (const GstSDPMedia * media, gint pt)
   const gchar *rtpmap;
   const gchar *fmtp;
   const gchar *framesize;
+  gchar *rtpmap_copy = NULL;
   gchar *name = NULL;
   gint rate = -1;
   gchar *params = NULL;
@@ -3302,11 +3344,13 @@ gst_sdp_media_get_caps_from_media (const GstSDPMedia * media, gint pt)
   gint payload = 0;
   gboolean ret;
 
-  /* get and parse rtpmap */
+  /* get and parse rtpmap. The parser splits the string in place, so work on
+   * a copy and leave @media as it was for the next call. */
   rtpmap = gst_sdp_get_attribute_for_pt (media, "rtpmap", pt);
 
   if (rtpmap) {
-    ret = gst_sdp_parse_rtpmap (rtpmap, &payload, &name, &rate, &params);
+    rtpmap_copy = g_strdup (rtpmap);
+    ret = gst_sdp_parse_rtpmap (rtpmap_copy, &payload, &name, &rate, &params);
     if (!ret) {
       GST_ERROR ("error parsing rtpmap, ignoring");
       rtpmap = NULL;
@@ -3361,17 +3405,16 @@ gst_sdp_media_get_caps_from_media (const GstSDPMedia * media, gint pt)
     gst_structure_set (s, "encoding-params", G_TYPE_STRING, tmp, NULL);
     g_free (tmp);
   }
+  g_free (rtpmap_copy);
 
   /* parse optional fmtp: field */
   if ((fmtp = gst_sdp_get_attribute_for_pt (media, "fmtp", pt))) {
-    gchar *p;
-    gint payload = 0;
-
-    p = (gchar *) fmtp;
+    const gchar *p;
+    gint payload = -1;
 
-    /* p is now of the format <payload> <param>[=<value>];... */
-    PARSE_INT (p, " ", payload);
-    if (payload != -1 && payload == pt) {
+    /* fmtp is of the format <payload> <param>[=<value>];... */
+    p = gst_sdp_parse_payload (fmtp, &payload);
+    if (p != NULL && payload == pt) {
       gchar **pairs;
       gint i;
 
@@ -3428,13 +3471,13 @@ gst_sdp_media_get_caps_from_media (const GstSDPMedia * media, gint pt)
 
   /* parse framesize: field */
   if ((framesize = gst_sdp_media_get_attribute_val (media, "framesize"))) {
-    gchar *p;
+    const gchar *p;
 
-    /* p is now of the format <payload> <width>-<height> */
-    p = (gchar *) framesize;
+    payload = -1;
 
-    PARSE_INT (p, " ", payload);
-    if (payload != -1 && payload == pt) {
+    /* framesize is of the format <payload> <width>-<height> */
+    p = gst_sdp_parse_payload (framesize, &payload);
+    if (p != NULL && payload == pt) {
       gst_structure_set (s, "a-framesize", G_TYPE_STRING, p, NULL);
     }
   }
@@ -3445,11 +3488,13 @@ gst_sdp_media_get_caps_from_media (const GstSDPMedia * media, gint pt)
 no_rtpmap:
   {
     GST_ERROR ("rtpmap type not given for dynamic payload %d", pt);
+    g_free (rtpmap_copy);
     return NULL;
   }
 no_rate:
   {
     GST_ERROR ("rate unknown for payload type %d", pt);
+    g_free (rtpmap_copy);
     return NULL;
   }
 }
@@ -553,26 +553,63 @@ gst_exif_writer_reset_and_get_buffer (GstExifWriter * writer)
   return gst_buffer_append (header, data);
 }
 
+/*
+ * Tables from exif tag id and complementary tag id to the map index + 1,
+ * one for each tag map, built once
+ */
+static const GstExifTagMatch *const tag_maps[] = {
+  tag_map_ifd0, tag_map_exif, tag_map_gps
+};
+
+static GHashTable *tag_map_reverse[G_N_ELEMENTS (tag_maps)];
+
+static gpointer
+exif_tag_map_build_reverse (gpointer user_data)
+{
+  guint i;
+  gint j;
+
+  for (i = 0; i < G_N_ELEMENTS (tag_maps); i++) {
+    const GstExifTagMatch *tag_map = tag_maps[i];
+    GHashTable *table = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    /* the first entry wins when an id is used twice, like when searching */
+    for (j = 0; tag_map[j].exif_tag != 0; j++) {
+      gpointer idx = GINT_TO_POINTER (j + 1);
+
+      if (!g_hash_table_contains (table, GUINT_TO_POINTER (tag_map[j].exif_tag)))
+        g_hash_table_insert (table, GUINT_TO_POINTER (tag_map[j].exif_tag),
+            idx);
+      if (tag_map[j].complementary_tag != 0 && !g_hash_table_contains (table,
+              GUINT_TO_POINTER (tag_map[j].complementary_tag)))
+        g_hash_table_insert (table,
+            GUINT_TO_POINTER (tag_map[j].complementary_tag), idx);
+    }
+    tag_map_reverse[i] = table;
+  }
+  return NULL;
+}
+
 /*
  * Given the exif tag with the passed id, returns the map index of the tag
- * corresponding to it. If use_complementary is true, then the complementary
- * are also used in the search.
+ * corresponding to it. The complementary tags are also used in the search.
  *
  * Returns -1 if not found
  */
 static gint
-exif_tag_map_find_reverse (guint16 exif_tag, const GstExifTagMatch * tag_map,
-    gboolean use_complementary)
+exif_tag_map_find_reverse (guint16 exif_tag, const GstExifTagMatch * tag_map)
 {
-  gint i;
+  static GOnce once = G_ONCE_INIT;
+  guint i;
 
-  for (i = 0; tag_map[i].exif_tag != 0; i++) {
-    if (exif_tag == tag_map[i].exif_tag || (use_complementary &&
-            exif_tag == tag_map[i].complementary_tag)) {
-      return i;
-    }
+  g_once (&once, exif_tag_map_build_reverse, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (tag_maps); i++) {
+    if (tag_maps[i] == tag_map)
+      return GPOINTER_TO_INT (g_hash_table_lookup (tag_map_reverse[i],
+              GUINT_TO_POINTER (exif_tag))) - 1;
   }
-  return -1;
+  g_return_val_if_reached (-1);
 }
 
 static gboolean
@@ -1540,6 +1577,10 @@ write_exif_ifd (const GstTagList * taglist, guint byte_order,
 
   gst_exif_writer_init (&writer, byte_order);
 
+  /* there is at most one tag header per map entry, allocate them at once */
+  for (i = 0; tag_map[i].exif_tag != 0; i++);
+  gst_byte_writer_ensure_free_space (&writer.tagwriter, 2 + 12 * i + 4);
+
   /* write tag number as 0 */
   handled &= gst_byte_writer_put_uint16_le (&writer.tagwriter, 0);
 
@@ -1707,7 +1748,7 @@ parse_exif_ifd (GstExifReader * exif_reader, gint buf_offset,
         ", buf size: %u", tagdata.tag, tagdata.tag_type, tagdata.count,
         tagdata.offset, tagdata.offset, gst_byte_reader_get_size (&reader));
 
-    map_index = exif_tag_map_find_reverse (tagdata.tag, tag_map, TRUE);
+    map_index = exif_tag_map_find_reverse (tagdata.tag, tag_map);
     if (map_index == -1) {
       GST_WARNING ("Unmapped exif tag: 0x%x", tagdata.tag);
       continue;
@@ -505,7 +505,9 @@ update_collected (GstTagDemux * demux)
   if (avail == 0)
     return;
 
-  buf = gst_adapter_take_buffer (demux->priv->adapter, avail);
+  /* the tag can be big, keep the memory of the incoming buffers instead of
+   * merging them here, parsing will map it once */
+  buf = gst_adapter_take_buffer_fast (demux->priv->adapter, avail);
 
   if (demux->priv->collect == NULL) {
     demux->priv->collect = buf;
@@ -1235,20 +1237,21 @@ gst_tag_demux_pull_start_tag (GstTagDemux * demux, GstTagList ** tags)
 
     demux->priv->strip_start = tagsize;
 
-    /* Now pull the entire tag */
+    /* Now pull the rest of the tag */
     g_assert (tagsize >= klass->min_start_size);
 
     if (bsize < tagsize) {
-      gst_buffer_unref (buffer);
-      buffer = NULL;
+      GstBuffer *rest = NULL;
 
-      flow_ret = gst_pad_pull_range (demux->priv->sinkpad, 0, tagsize, &buffer);
+      flow_ret = gst_pad_pull_range (demux->priv->sinkpad, bsize,
+          tagsize - bsize, &rest);
       if (flow_ret != GST_FLOW_OK) {
         GST_DEBUG_OBJECT (demux, "Could not read data from start of file, "
             "ret = %s", gst_flow_get_name (flow_ret));
         goto done;
       }
 
+      buffer = gst_buffer_append (buffer, rest);
       bsize = gst_buffer_get_size (buffer);
 
       if (bsize < tagsize) {
@@ -466,3 +466,34 @@ __exif_tag_capturing_source_from_exif_value (gint value)
       return NULL;
   }
 }
+
+/* a NULL list of wanted tags means that all tags are wanted */
+gboolean
+__gst_tag_is_wanted (const gchar ** wanted, const gchar * tag)
+{
+  if (wanted == NULL)
+    return TRUE;
+
+  for (; *wanted; wanted++) {
+    if (strcmp (*wanted, tag) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+void
+__gst_tag_list_filter (GstTagList * list, const gchar ** wanted)
+{
+  gint i;
+
+  if (wanted == NULL)
+    return;
+
+  /* backwards so that removing a tag doesn't move the ones still to check */
+  for (i = gst_tag_list_n_tags (list) - 1; i >= 0; i--) {
+    const gchar *tag = gst_tag_list_nth_tag_name (list, i);
+
+    if (!__gst_tag_is_wanted (wanted, tag))
+      gst_tag_list_remove_tag (list, tag);
+  }
+}
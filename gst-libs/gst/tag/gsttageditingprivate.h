@@ -70,6 +70,9 @@ const gchar * __exif_tag_capturing_source_from_exif_value (gint value);
 
 #define ensure_exif_tags gst_tag_register_musicbrainz_tags
 
+gboolean __gst_tag_is_wanted (const gchar ** wanted, const gchar * tag);
+void __gst_tag_list_filter (GstTagList * list, const gchar ** wanted);
+
 G_END_DECLS
 
 #endif /* __GST_TAG_EDIT_PRIVATE_H__ */
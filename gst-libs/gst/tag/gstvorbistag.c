@@ -421,6 +421,35 @@ decode_failed:
 GstTagList *
 gst_tag_list_from_vorbiscomment (const guint8 * data, gsize size,
     const guint8 * id_data, const guint id_data_length, gchar ** vendor_string)
+{
+  return gst_tag_list_from_vorbiscomment_filtered (data, size, id_data,
+      id_data_length, vendor_string, NULL);
+}
+
+/**
+ * gst_tag_list_from_vorbiscomment_filtered:
+ * @data: data to convert
+ * @size: size of @data
+ * @id_data: identification data at start of stream
+ * @id_data_length: length of identification data
+ * @vendor_string: pointer to a string that should take the vendor string
+ *                 of this vorbis comment or NULL if you don't need it.
+ * @tags: (array zero-terminated=1) (allow-none): the tags to extract, or
+ *        %NULL for all tags
+ *
+ * Creates a new tag list that contains the tags from @tags that could be
+ * parsed out of a vorbiscomment packet. Embedded pictures are not decoded
+ * when neither #GST_TAG_IMAGE nor #GST_TAG_PREVIEW_IMAGE is wanted.
+ *
+ * Returns: A new #GstTagList with the wanted tags that could be extracted
+ *          from the given vorbiscomment buffer or NULL on error.
+ *
+ * Since: 1.10
+ */
+GstTagList *
+gst_tag_list_from_vorbiscomment_filtered (const guint8 * data, gsize size,
+    const guint8 * id_data, const guint id_data_length, gchar ** vendor_string,
+    const gchar ** tags)
 {
 #define ADVANCE(x) G_STMT_START{                                                \
   data += x;                                                                    \
@@ -437,12 +466,16 @@ gst_tag_list_from_vorbiscomment (const guint8 * data, gsize size,
   guint iterations;
   guint value_len;
   GstTagList *list;
+  gboolean want_images;
 
   g_return_val_if_fail (data != NULL, NULL);
   g_return_val_if_fail (id_data != NULL || id_data_length == 0, NULL);
 
   list = gst_tag_list_new_empty ();
 
+  want_images = __gst_tag_is_wanted (tags, GST_TAG_IMAGE) ||
+      __gst_tag_is_wanted (tags, GST_TAG_PREVIEW_IMAGE);
+
   if (size < 11 || size <= id_data_length + 4)
     goto error;
 
@@ -461,6 +494,12 @@ gst_tag_list_from_vorbiscomment (const guint8 * data, gsize size,
   while (iterations) {
     ADVANCE (cur_size);
     iterations--;
+    /* the pictures are big, don't even copy them when not needed */
+    if (!want_images && cur_size > 9 &&
+        (g_ascii_strncasecmp (cur, "COVERART=", 9) == 0 ||
+            (cur_size > 23 &&
+                g_ascii_strncasecmp (cur, "METADATA_BLOCK_PICTURE=", 23) == 0)))
+      continue;
     cur = g_strndup (cur, cur_size);
     value = strchr (cur, '=');
     if (value == NULL) {
@@ -488,6 +527,8 @@ gst_tag_list_from_vorbiscomment (const guint8 * data, gsize size,
     g_free (cur);
   }
 
+  __gst_tag_list_filter (list, tags);
+
   return list;
 
 error:
@@ -222,6 +222,12 @@ gst_xmp_schema_new ()
  */
 static GHashTable *__xmp_schemas;
 
+/*
+ * Mappings from xmp tag names of all schemas to their XmpTag, built once
+ * after all schemas are added
+ */
+static GHashTable *__xmp_tags_reverse;
+
 static GstXmpSchema *
 _gst_xmp_get_schema (const gchar * name)
 {
@@ -350,60 +356,58 @@ _xmp_tag_get_mapping (const gchar * gst_tag, XmpSerializationData * serdata)
 }
 #endif
 
-/* finds the gst tag that maps to this xmp tag in this schema */
-static const gchar *
-_gst_xmp_schema_get_mapping_reverse (GstXmpSchema * schema,
-    const gchar * xmp_tag, XmpTag ** _xmp_tag)
+static void
+_gst_xmp_add_reverse_mapping (XmpTag * xmptag)
 {
-  GHashTableIter iter;
+  if (g_hash_table_lookup (__xmp_tags_reverse, xmptag->tag_name)) {
+    GST_WARNING ("Tag %s already present", xmptag->tag_name);
+    return;
+  }
+  g_hash_table_insert (__xmp_tags_reverse, (gpointer) xmptag->tag_name,
+      xmptag);
+}
+
+static void
+_gst_xmp_build_reverse_mappings (void)
+{
+  GHashTableIter iter, schema_iter;
   gpointer key, value;
-  const gchar *ret = NULL;
-
-  /* Iterate over the hashtable */
-  g_hash_table_iter_init (&iter, schema);
-  while (!ret && g_hash_table_iter_next (&iter, &key, &value)) {
-    XmpTag *xmpinfo = (XmpTag *) value;
-
-    if (xmpinfo->tag_name) {
-      if (strcmp (xmpinfo->tag_name, xmp_tag) == 0) {
-        *_xmp_tag = xmpinfo;
-        ret = g_quark_to_string (GPOINTER_TO_UINT (key));
-        goto out;
-      }
-    } else if (xmpinfo->children) {
-      GSList *iter;
-      for (iter = xmpinfo->children; iter; iter = g_slist_next (iter)) {
-        XmpTag *child = iter->data;
-        if (strcmp (child->tag_name, xmp_tag) == 0) {
-          *_xmp_tag = child;
-          ret = g_quark_to_string (GPOINTER_TO_UINT (key));
-          goto out;
-        }
+
+  __xmp_tags_reverse = g_hash_table_new (g_str_hash, g_str_equal);
+
+  g_hash_table_iter_init (&iter, __xmp_schemas);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    g_hash_table_iter_init (&schema_iter, (GstXmpSchema *) value);
+    while (g_hash_table_iter_next (&schema_iter, &key, &value)) {
+      XmpTag *xmpinfo = (XmpTag *) value;
+
+      /* the children of structs are only looked up inside their struct */
+      if (xmpinfo->tag_name) {
+        _gst_xmp_add_reverse_mapping (xmpinfo);
+      } else if (xmpinfo->children) {
+        GSList *walk;
+
+        for (walk = xmpinfo->children; walk; walk = g_slist_next (walk))
+          _gst_xmp_add_reverse_mapping (walk->data);
+      } else {
+        g_assert_not_reached ();
       }
-    } else {
-      g_assert_not_reached ();
     }
   }
-
-out:
-  return ret;
 }
 
 /* finds the gst tag that maps to this xmp tag (searches on all schemas) */
 static const gchar *
 _gst_xmp_tag_get_mapping_reverse (const gchar * xmp_tag, XmpTag ** _xmp_tag)
 {
-  GHashTableIter iter;
-  gpointer key, value;
-  const gchar *ret = NULL;
+  XmpTag *xmpinfo;
 
-  /* Iterate over the hashtable */
-  g_hash_table_iter_init (&iter, __xmp_schemas);
-  while (!ret && g_hash_table_iter_next (&iter, &key, &value)) {
-    ret = _gst_xmp_schema_get_mapping_reverse ((GstXmpSchema *) value, xmp_tag,
-        _xmp_tag);
-  }
-  return ret;
+  xmpinfo = g_hash_table_lookup (__xmp_tags_reverse, xmp_tag);
+  if (xmpinfo == NULL)
+    return NULL;
+
+  *_xmp_tag = xmpinfo;
+  return xmpinfo->gst_tag;
 }
 
 /* utility functions/macros */
@@ -1058,6 +1062,8 @@ _init_xmp_tag_map (gpointer user_data)
   _gst_xmp_schema_add_mapping (schema, xmpinfo);
   _gst_xmp_add_schema ("Iptc4xmpExt", schema);
 
+  _gst_xmp_build_reverse_mappings ();
+
   return NULL;
 }
 
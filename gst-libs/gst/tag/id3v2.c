@@ -26,6 +26,7 @@
 #include <gst/tag/tag.h>
 
 #include "id3v2.h"
+#include "gsttageditingprivate.h"
 
 #define HANDLE_INVALID_SYNCSAFE
 
@@ -187,6 +188,29 @@ id3v2_ununsync_data (const guint8 * unsync_data, guint32 * size)
  */
 GstTagList *
 gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
+{
+  return gst_tag_list_from_id3v2_tag_filtered (buffer, NULL);
+}
+
+/**
+ * gst_tag_list_from_id3v2_tag_filtered:
+ * @buffer: buffer to convert
+ * @tags: (array zero-terminated=1) (allow-none): the tags to extract, or
+ *        %NULL for all tags
+ *
+ * Creates a new tag list that contains the tags from @tags that could be
+ * parsed out of a ID3 tag. Frames that can only result in other tags, such
+ * as the attached pictures when neither #GST_TAG_IMAGE nor
+ * #GST_TAG_PREVIEW_IMAGE is wanted, are skipped without being decoded.
+ *
+ * Returns: A new #GstTagList with the wanted tags that could be extracted
+ *          from the given ID3 tag buffer or NULL on error or when none of
+ *          them were found.
+ *
+ * Since: 1.10
+ */
+GstTagList *
+gst_tag_list_from_id3v2_tag_filtered (GstBuffer * buffer, const gchar ** tags)
 {
   GstMapInfo info;
   guint8 *uu_data = NULL;
@@ -232,6 +256,7 @@ gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
 
   memset (&work, 0, sizeof (ID3TagsWorking));
   work.buffer = buffer;
+  work.wanted = tags;
   work.hdr.version = version;
   work.hdr.size = read_size;
   work.hdr.flags = flags;
@@ -254,6 +279,14 @@ gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
 
   id3v2_frames_to_tag_list (&work, work.hdr.frame_data_size);
 
+  if (work.tags != NULL && tags != NULL) {
+    __gst_tag_list_filter (work.tags, tags);
+    if (gst_tag_list_is_empty (work.tags)) {
+      gst_tag_list_unref (work.tags);
+      work.tags = NULL;
+    }
+  }
+
   g_free (uu_data);
 
   gst_buffer_unmap (buffer, &info);
@@ -450,6 +483,29 @@ id3v2_add_id3v2_frame_blob_to_taglist (ID3TagsWorking * work, guint size)
   gst_sample_unref (sample);
 }
 
+/* Frames that can give other tags than the mapped one, or that don't have
+ * a mapping, are parsed anyway and the unwanted tags removed later */
+static gboolean
+id3v2_frame_is_wanted (ID3TagsWorking * work, const gchar * frame_id)
+{
+  const gchar *tag;
+
+  if (work->wanted == NULL)
+    return TRUE;
+
+  if (strcmp (frame_id, "APIC") == 0)
+    return __gst_tag_is_wanted (work->wanted, GST_TAG_IMAGE) ||
+        __gst_tag_is_wanted (work->wanted, GST_TAG_PREVIEW_IMAGE);
+  if (strcmp (frame_id, "PRIV") == 0)
+    return __gst_tag_is_wanted (work->wanted, GST_TAG_PRIVATE_DATA);
+  if (strcmp (frame_id, "TRCK") == 0 || strcmp (frame_id, "TPOS") == 0 ||
+      strcmp (frame_id, "COMM") == 0)
+    return TRUE;
+
+  tag = gst_tag_from_id3_tag (frame_id);
+  return tag == NULL || __gst_tag_is_wanted (work->wanted, tag);
+}
+
 static gboolean
 id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
 {
@@ -578,7 +634,9 @@ id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
 #undef flag_str
 #endif
 
-    if (!obsolete_id) {
+    if (!obsolete_id && !id3v2_frame_is_wanted (work, frame_id)) {
+      GST_LOG ("Skipping unwanted frame with id %s", frame_id);
+    } else if (!obsolete_id) {
       /* Now, read, decompress etc the contents of the frame
        * into a TagList entry */
       work->cur_frame_size = frame_size;
@@ -589,7 +647,8 @@ id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
         GST_LOG ("Extracted frame with id %s", frame_id);
       } else {
         GST_LOG ("Failed to extract frame with id %s", frame_id);
-        id3v2_add_id3v2_frame_blob_to_taglist (work, frame_size);
+        if (__gst_tag_is_wanted (work->wanted, GST_TAG_ID3V2_FRAME))
+          id3v2_add_id3v2_frame_blob_to_taglist (work, frame_size);
       }
     }
     work->hdr.frame_data += frame_size;
@@ -52,6 +52,7 @@ typedef struct {
   
   GstBuffer *buffer;
   GstTagList *tags;
+  const gchar **wanted;
 
   /* Current frame decoding */
   guint cur_frame_size;
@@ -337,6 +337,49 @@ gst_tag_get_language_name (const gchar * language_code)
   return lang_name;
 }
 
+/* iso_639_codes is sorted by ISO-639-1 code and iso_639_2_index lists its
+ * rows sorted by ISO-639-2 code, so both kinds of codes are found with a
+ * binary search. Returns the first row with the code or -1. */
+static gint
+gst_tag_find_iso_639_code (const gchar * lang_code)
+{
+  gint lo, hi, mid, cmp;
+
+  if (lang_code[0] == '\0' || lang_code[1] == '\0')
+    return -1;
+
+  if (lang_code[2] == '\0') {
+    lo = 0;
+    hi = G_N_ELEMENTS (iso_639_codes);
+    /* the 639-2T and 639-2B rows share the 639-1 code, find the first */
+    while (lo < hi) {
+      mid = (lo + hi) / 2;
+      if (strcmp (iso_639_codes[mid].iso_639_1, lang_code) < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo < G_N_ELEMENTS (iso_639_codes) &&
+        strcmp (iso_639_codes[lo].iso_639_1, lang_code) == 0)
+      return lo;
+  } else if (lang_code[3] == '\0') {
+    lo = 0;
+    hi = G_N_ELEMENTS (iso_639_2_index) - 1;
+    while (lo <= hi) {
+      mid = (lo + hi) / 2;
+      cmp = strcmp (iso_639_codes[iso_639_2_index[mid]].iso_639_2, lang_code);
+      if (cmp == 0)
+        return iso_639_2_index[mid];
+      else if (cmp < 0)
+        lo = mid + 1;
+      else
+        hi = mid - 1;
+    }
+  }
+
+  return -1;
+}
+
 /**
  * gst_tag_get_language_code_iso_639_1:
  * @lang_code: ISO-639 language code (e.g. "deu" or "ger" or "de")
@@ -365,16 +408,13 @@ gst_tag_get_language_code_iso_639_1 (const gchar * lang_code)
    * map the language codes from our static table. Theoretically the iso-codes
    * XML file might have had additional codes that are now in the hash table.
    * We keep it simple for now and don't waste memory on additional tables. */
-  for (i = 0; i < G_N_ELEMENTS (iso_639_codes); ++i) {
-    /* we check both codes here, so function can be used in a more versatile
-     * way, to convert a language tag to a two-letter language code and/or
-     * verify an existing code */
-    if (strcmp (lang_code, iso_639_codes[i].iso_639_1) == 0 ||
-        strcmp (lang_code, iso_639_codes[i].iso_639_2) == 0) {
-      c = iso_639_codes[i].iso_639_1;
-      break;
-    }
-  }
+
+  /* we check both codes here, so function can be used in a more versatile
+   * way, to convert a language tag to a two-letter language code and/or
+   * verify an existing code */
+  i = gst_tag_find_iso_639_code (lang_code);
+  if (i >= 0)
+    c = iso_639_codes[i].iso_639_1;
 
   GST_LOG ("%s -> %s", lang_code, GST_STR_NULL (c));
 
@@ -392,23 +432,23 @@ gst_tag_get_language_code_iso_639_2X (const gchar * lang_code, guint8 flags)
    * We keep it simple for now and don't waste memory on additional tables.
    * Also, we currently only parse the iso_639.xml file if language names or
    * a list of all codes is requested, and it'd be nice to keep it like that. */
-  for (i = 0; i < G_N_ELEMENTS (iso_639_codes); ++i) {
-    /* we check both codes here, so function can be used in a more versatile
-     * way, to convert a language tag to a three-letter language code and/or
-     * verify an existing code */
-    if (strcmp (lang_code, iso_639_codes[i].iso_639_1) == 0 ||
-        strcmp (lang_code, iso_639_codes[i].iso_639_2) == 0) {
-      if ((iso_639_codes[i].flags & flags) == flags) {
-        return iso_639_codes[i].iso_639_2;
-      } else if (i > 0 && (iso_639_codes[i - 1].flags & flags) == flags &&
-          iso_639_codes[i].name_offset == iso_639_codes[i - 1].name_offset) {
-        return iso_639_codes[i - 1].iso_639_2;
-      } else if ((i + 1) < G_N_ELEMENTS (iso_639_codes) &&
-          (iso_639_codes[i + 1].flags & flags) == flags &&
-          iso_639_codes[i].name_offset == iso_639_codes[i + 1].name_offset) {
-        return iso_639_codes[i + 1].iso_639_2;
-      }
-    }
+
+  /* we check both codes here, so function can be used in a more versatile
+   * way, to convert a language tag to a three-letter language code and/or
+   * verify an existing code */
+  i = gst_tag_find_iso_639_code (lang_code);
+  if (i < 0)
+    return NULL;
+
+  if ((iso_639_codes[i].flags & flags) == flags) {
+    return iso_639_codes[i].iso_639_2;
+  } else if (i > 0 && (iso_639_codes[i - 1].flags & flags) == flags &&
+      iso_639_codes[i].name_offset == iso_639_codes[i - 1].name_offset) {
+    return iso_639_codes[i - 1].iso_639_2;
+  } else if ((i + 1) < G_N_ELEMENTS (iso_639_codes) &&
+      (iso_639_codes[i + 1].flags & flags) == flags &&
+      iso_639_codes[i].name_offset == iso_639_codes[i + 1].name_offset) {
+    return iso_639_codes[i + 1].iso_639_2;
   }
   return NULL;
 }
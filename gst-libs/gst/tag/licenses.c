@@ -247,8 +247,9 @@ gst_tag_get_licenses (void)
 static gint
 gst_tag_get_license_idx (const gchar * license_ref, const gchar ** jurisdiction)
 {
-  const gchar *ref, *jur_suffix;
-  int i;
+  const gchar *ref, *jur_suffix, *slash;
+  gsize name_len;
+  int i, lo, hi;
 
   GST_TRACE ("Looking up '%s'", license_ref);
 
@@ -261,11 +262,34 @@ gst_tag_get_license_idx (const gchar * license_ref, const gchar ** jurisdiction)
     *jurisdiction = NULL;
 
   ref = license_ref + sizeof (CC_LICENSE_REF_PREFIX) - 1;
-  for (i = 0; i < G_N_ELEMENTS (licenses); ++i) {
+
+  /* every ref in the table that can match starts with the first path
+   * component of @ref, and the table is sorted by ref, so they are all
+   * in one block that starts where a binary search puts that component */
+  slash = strchr (ref, '/');
+  name_len = (slash != NULL) ? slash - ref : strlen (ref);
+  lo = 0;
+  hi = G_N_ELEMENTS (licenses);
+  while (lo < hi) {
+    gint mid = (lo + hi) / 2;
+    gint cmp = strncmp (licenses[mid].ref, ref, name_len);
+
+    if (cmp == 0 && licenses[mid].ref[name_len] != '/')
+      cmp = ((guchar) licenses[mid].ref[name_len] < '/') ? -1 : 1;
+    if (cmp < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  for (i = lo; i < G_N_ELEMENTS (licenses); ++i) {
     guint64 jbits = licenses[i].jurisdictions;
     const gchar *jurs, *lref = licenses[i].ref;
     gsize lref_len = strlen (lref);
 
+    if (strncmp (lref, ref, name_len) != 0 || lref[name_len] != '/')
+      break;
+
     /* table should have "foo/bar/" with trailing slash */
     g_assert (lref[lref_len - 1] == '/');
 
@@ -43,9 +43,43 @@ typedef struct
 
 static GArray *languages = NULL;
 
+static gint
+code_2_index_cmp (gconstpointer p1, gconstpointer p2, gpointer codes)
+{
+  const gchar **c = codes;
+
+  return strcmp (c[*(const guint *) p1], c[*(const guint *) p2]);
+}
+
+/* rows of iso_639_codes sorted by ISO-639-2 code, the table itself is sorted
+ * by ISO-639-1 code, so that both can be looked up with a binary search */
+static void
+dump_iso_639_2_index (GPtrArray * codes_2)
+{
+  guint *idx;
+  guint i;
+
+  g_assert (codes_2->len <= 256);
+
+  idx = g_new (guint, codes_2->len);
+  for (i = 0; i < codes_2->len; ++i)
+    idx[i] = i;
+  g_qsort_with_data (idx, codes_2->len, sizeof (guint), code_2_index_cmp,
+      codes_2->pdata);
+
+  g_print ("static const guint8 iso_639_2_index[] = {");
+  for (i = 0; i < codes_2->len; ++i)
+    g_print ("%s%3u,", (i % 12) == 0 ? "\n  " : " ", idx[i]);
+  g_print ("\n};\n");
+  g_print ("\n");
+
+  g_free (idx);
+}
+
 static void
 dump_languages (void)
 {
+  GPtrArray *codes_2;
   GString *names;
   const char *s;
   int i, num_escaped;
@@ -53,6 +87,7 @@ dump_languages (void)
   g_assert (languages != NULL);
 
   names = g_string_new ("");
+  codes_2 = g_ptr_array_new ();
 
   g_print ("/* generated by " __FILE__ " iso-codes " ISO_CODES_VERSION " */\n");
   g_print ("\n");
@@ -100,12 +135,15 @@ dump_languages (void)
     if (strcmp (lang->code_2b, lang->code_2t) == 0) {
       g_print ("  { \"%s\", \"%s\", ISO_639_FLAG_2T | ISO_639_FLAG_2B, %u },\n",
           lang->code_1, lang->code_2t, lang->name_offset);
+      g_ptr_array_add (codes_2, lang->code_2t);
     } else {
       /* if 639-2T and 639-2B differ, put 639-2T first */
       g_print ("  { \"%s\", \"%s\", ISO_639_FLAG_2T, %u },\n",
           lang->code_1, lang->code_2t, lang->name_offset);
       g_print ("  { \"%s\", \"%s\", ISO_639_FLAG_2B, %u },\n",
           lang->code_1, lang->code_2b, lang->name_offset);
+      g_ptr_array_add (codes_2, lang->code_2t);
+      g_ptr_array_add (codes_2, lang->code_2b);
     }
   }
 
@@ -132,8 +170,10 @@ dump_languages (void)
   }
   g_print (";\n");
   g_print ("\n");
+  dump_iso_639_2_index (codes_2);
   g_print ("/* *INDENT-ON* */\n");
 
+  g_ptr_array_free (codes_2, TRUE);
   g_string_free (names, TRUE);
 }
 
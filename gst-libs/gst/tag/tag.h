@@ -431,6 +431,12 @@ GstTagList *            gst_tag_list_from_vorbiscomment         (const guint8 *
                                                                  const guint8 *         id_data,
                                                                  const guint            id_data_length,
                                                                  gchar **               vendor_string);
+GstTagList *            gst_tag_list_from_vorbiscomment_filtered (const guint8 *        data,
+                                                                 gsize                  size,
+                                                                 const guint8 *         id_data,
+                                                                 const guint            id_data_length,
+                                                                 gchar **               vendor_string,
+                                                                 const gchar **         tags);
 GstTagList *            gst_tag_list_from_vorbiscomment_buffer  (GstBuffer *            buffer,
                                                                  const guint8 *         id_data,
                                                                  const guint            id_data_length,
@@ -462,6 +468,9 @@ gboolean                gst_tag_list_add_id3_image (GstTagList   * tag_list,
 
 GstTagList *            gst_tag_list_from_id3v2_tag (GstBuffer * buffer);
 
+GstTagList *            gst_tag_list_from_id3v2_tag_filtered (GstBuffer    * buffer,
+                                                              const gchar ** tags);
+
 guint                   gst_tag_get_id3v2_tag_size  (GstBuffer * buffer);
 
 /* functions to  convert GstBuffers with xmp packets contents to GstTagLists and back */
@@ -277,6 +277,260 @@ link_failed:
   }
 }
 
+/* Raw to raw conversions that don't need borders are done with a
+ * #GstVideoConverter directly, that's a lot cheaper than building and
+ * prerolling a pipeline for each frame. Returns %NULL when the conversion
+ * can't be done this way, the caller should then fall back to the
+ * pipeline. */
+static GstSample *
+convert_sample_direct (GstSample * sample, GstVideoCropMeta * cmeta,
+    const GstCaps * to_caps)
+{
+  GstBuffer *buf, *outbuf;
+  GstCaps *from_caps, *tmp, *out_caps;
+  GstStructure *s;
+  GstVideoInfo in_info, out_info;
+  GstVideoFrame in_frame, out_frame;
+  GstVideoConverter *convert;
+  const gchar *format;
+  gint in_w, in_h, out_w, out_h, par_n, par_d, dar_n, dar_d;
+
+  from_caps = gst_sample_get_caps (sample);
+  if (!caps_are_raw (from_caps) || !caps_are_raw (to_caps) ||
+      gst_caps_get_size (to_caps) != 1)
+    return NULL;
+
+  if (!gst_video_info_from_caps (&in_info, from_caps))
+    return NULL;
+
+  s = gst_caps_get_structure (to_caps, 0);
+  if (!(format = gst_structure_get_string (s, "format")) ||
+      gst_video_format_from_string (format) == GST_VIDEO_FORMAT_UNKNOWN ||
+      !gst_structure_get_int (s, "width", &out_w) ||
+      !gst_structure_get_int (s, "height", &out_h))
+    return NULL;
+
+  if (cmeta) {
+    in_w = cmeta->width;
+    in_h = cmeta->height;
+  } else {
+    in_w = GST_VIDEO_INFO_WIDTH (&in_info);
+    in_h = GST_VIDEO_INFO_HEIGHT (&in_info);
+  }
+  if (in_w <= 0 || in_h <= 0 || out_w <= 0 || out_h <= 0)
+    return NULL;
+
+  if (!gst_util_fraction_multiply (in_w, in_h,
+          GST_VIDEO_INFO_PAR_N (&in_info), GST_VIDEO_INFO_PAR_D (&in_info),
+          &dar_n, &dar_d))
+    return NULL;
+
+  s = gst_structure_copy (s);
+  if (gst_structure_has_field (s, "pixel-aspect-ratio")) {
+    /* a different DAR needs the borders from videoscale */
+    if (!gst_structure_get_fraction (s, "pixel-aspect-ratio", &par_n, &par_d)
+        || (guint64) out_w * par_n * dar_d != (guint64) out_h * par_d * dar_n)
+      goto not_direct;
+  } else {
+    /* pick the PAR that keeps the DAR, like videoscale does */
+    if (!gst_util_fraction_multiply (dar_n, dar_d, out_h, out_w, &par_n,
+            &par_d))
+      goto not_direct;
+    gst_structure_set (s, "pixel-aspect-ratio", GST_TYPE_FRACTION, par_n,
+        par_d, NULL);
+  }
+
+  tmp = gst_caps_new_full (gst_structure_copy (s), NULL);
+  tmp = gst_caps_fixate (tmp);
+  if (!gst_video_info_from_caps (&out_info, tmp)) {
+    gst_caps_unref (tmp);
+    goto not_direct;
+  }
+  gst_caps_unref (tmp);
+
+  /* fields that are not in the target caps are passed through from the
+   * input, like videoconvert and videoscale would */
+  out_info.fps_n = in_info.fps_n;
+  out_info.fps_d = in_info.fps_d;
+  if (!gst_structure_has_field (s, "interlace-mode"))
+    out_info.interlace_mode = in_info.interlace_mode;
+  if (!gst_structure_has_field (s, "colorimetry") &&
+      !GST_VIDEO_INFO_IS_RGB (&in_info) == !GST_VIDEO_INFO_IS_RGB (&out_info))
+    out_info.colorimetry = in_info.colorimetry;
+  if (!gst_structure_has_field (s, "chroma-site") &&
+      GST_VIDEO_INFO_IS_YUV (&in_info) && GST_VIDEO_INFO_IS_YUV (&out_info))
+    out_info.chroma_site = in_info.chroma_site;
+  gst_structure_free (s);
+
+  buf = gst_sample_get_buffer (sample);
+  if (!gst_video_frame_map (&in_frame, &in_info, buf, GST_MAP_READ))
+    return NULL;
+
+  outbuf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&out_info),
+      NULL);
+  if (!gst_video_frame_map (&out_frame, &out_info, outbuf, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&in_frame);
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+
+  GST_DEBUG ("converting directly to %" GST_PTR_FORMAT, to_caps);
+
+  convert = gst_video_converter_new (&in_info, &out_info,
+      gst_structure_new ("GstVideoConvertConfig",
+          GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, cmeta ? cmeta->x : 0,
+          GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, cmeta ? cmeta->y : 0,
+          GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, in_w,
+          GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, in_h, NULL));
+  if (convert) {
+    gst_video_converter_frame (convert, &in_frame, &out_frame);
+    gst_video_converter_free (convert);
+  }
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  if (!convert) {
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+
+  gst_buffer_copy_into (outbuf, buf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+  out_caps = gst_video_info_to_caps (&out_info);
+  sample = gst_sample_new (outbuf, out_caps, NULL, NULL);
+  gst_buffer_unref (outbuf);
+  gst_caps_unref (out_caps);
+
+  return sample;
+
+not_direct:
+  {
+    gst_structure_free (s);
+    return NULL;
+  }
+}
+
+/* Pipelines for the synchronous conversion are kept around in a small pool
+ * after use so that repeated conversions with the same caps, such as
+ * thumbnailing, only pay for building and linking the pipeline once */
+#define CONVERT_PIPELINE_POOL_SIZE 4
+
+typedef struct
+{
+  GstElement *pipeline;
+  GstElement *src;
+  GstElement *sink;
+  GstCaps *from_caps;
+  GstCaps *to_caps;
+  gboolean crop;
+  gint crop_x, crop_y, crop_width, crop_height;
+} ConvertFramePipeline;
+
+static GMutex convert_pipelines_lock;
+static GQueue convert_pipelines = G_QUEUE_INIT;
+
+static void
+convert_frame_pipeline_free (ConvertFramePipeline * cp)
+{
+  gst_element_set_state (cp->pipeline, GST_STATE_NULL);
+  gst_object_unref (cp->pipeline);
+  gst_caps_unref (cp->from_caps);
+  gst_caps_unref (cp->to_caps);
+  g_slice_free (ConvertFramePipeline, cp);
+}
+
+static gboolean
+convert_frame_pipeline_matches (ConvertFramePipeline * cp,
+    const GstCaps * from_caps, GstVideoCropMeta * cmeta,
+    const GstCaps * to_caps)
+{
+  if (cp->crop != (cmeta != NULL))
+    return FALSE;
+  if (cmeta && (cp->crop_x != cmeta->x || cp->crop_y != cmeta->y ||
+          cp->crop_width != cmeta->width || cp->crop_height != cmeta->height))
+    return FALSE;
+
+  return gst_caps_is_equal (cp->from_caps, from_caps) &&
+      gst_caps_is_equal (cp->to_caps, to_caps);
+}
+
+static ConvertFramePipeline *
+convert_frame_pipeline_acquire (GstCaps * from_caps,
+    GstVideoCropMeta * cmeta, GstCaps * to_caps, GError ** err)
+{
+  ConvertFramePipeline *cp = NULL;
+  GstElement *pipeline, *src, *sink;
+  GList *walk;
+
+  g_mutex_lock (&convert_pipelines_lock);
+  for (walk = convert_pipelines.head; walk; walk = walk->next) {
+    if (convert_frame_pipeline_matches (walk->data, from_caps, cmeta,
+            to_caps)) {
+      cp = walk->data;
+      g_queue_delete_link (&convert_pipelines, walk);
+      break;
+    }
+  }
+  g_mutex_unlock (&convert_pipelines_lock);
+
+  if (cp) {
+    GST_DEBUG ("reusing conversion pipeline %p", cp->pipeline);
+    return cp;
+  }
+
+  pipeline =
+      build_convert_frame_pipeline (&src, &sink, from_caps, cmeta, to_caps,
+      err);
+  if (!pipeline)
+    return NULL;
+
+  cp = g_slice_new0 (ConvertFramePipeline);
+  cp->pipeline = pipeline;
+  cp->src = src;
+  cp->sink = sink;
+  cp->from_caps = gst_caps_ref (from_caps);
+  cp->to_caps = gst_caps_ref (to_caps);
+  if (cmeta) {
+    cp->crop = TRUE;
+    cp->crop_x = cmeta->x;
+    cp->crop_y = cmeta->y;
+    cp->crop_width = cmeta->width;
+    cp->crop_height = cmeta->height;
+  }
+
+  return cp;
+}
+
+static void
+convert_frame_pipeline_release (ConvertFramePipeline * cp)
+{
+  GstBus *bus;
+
+  if (gst_element_set_state (cp->pipeline,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+    convert_frame_pipeline_free (cp);
+    return;
+  }
+
+  /* drop the messages of this run */
+  bus = gst_element_get_bus (cp->pipeline);
+  gst_bus_set_flushing (bus, TRUE);
+  gst_bus_set_flushing (bus, FALSE);
+  gst_object_unref (bus);
+
+  g_mutex_lock (&convert_pipelines_lock);
+  g_queue_push_head (&convert_pipelines, cp);
+  if (g_queue_get_length (&convert_pipelines) > CONVERT_PIPELINE_POOL_SIZE)
+    cp = g_queue_pop_tail (&convert_pipelines);
+  else
+    cp = NULL;
+  g_mutex_unlock (&convert_pipelines_lock);
+
+  if (cp)
+    convert_frame_pipeline_free (cp);
+}
+
 /**
  * gst_video_convert_sample:
  * @sample: a #GstSample
@@ -290,6 +544,11 @@ link_failed:
  *
  * The width, height and pixel-aspect-ratio can also be specified in the output caps.
  *
+ * Since 1.10, conversions between fixed raw caps that don't need borders are
+ * done without a pipeline, and the pipelines used for other conversions are
+ * kept and reused for later calls with the same caps, which makes repeated
+ * calls cheap.
+ *
  * Returns: The converted #GstSample, or %NULL if an error happened (in which case @err
  * will point to the #GError).
  */
@@ -305,6 +564,8 @@ gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
   GstCaps *from_caps, *to_caps_copy = NULL;
   GstFlowReturn ret;
   GstElement *pipeline, *src, *sink;
+  GstVideoCropMeta *cmeta;
+  ConvertFramePipeline *cp;
   guint i, n;
 
   g_return_val_if_fail (sample != NULL, NULL);
@@ -327,12 +588,23 @@ gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
     gst_caps_append_structure (to_caps_copy, s);
   }
 
-  pipeline =
-      build_convert_frame_pipeline (&src, &sink, from_caps,
-      gst_buffer_get_video_crop_meta (buf), to_caps_copy, &err);
-  if (!pipeline)
+  cmeta = gst_buffer_get_video_crop_meta (buf);
+
+  result = convert_sample_direct (sample, cmeta, to_caps_copy);
+  if (result) {
+    GST_DEBUG ("direct conversion successful: result = %p", result);
+    gst_caps_unref (to_caps_copy);
+    return result;
+  }
+
+  cp = convert_frame_pipeline_acquire (from_caps, cmeta, to_caps_copy, &err);
+  if (!cp)
     goto no_pipeline;
 
+  pipeline = cp->pipeline;
+  src = cp->src;
+  sink = cp->sink;
+
   /* now set the pipeline to the paused state, after we push the buffer into
    * appsrc, this should preroll the converted buffer in appsink */
   GST_DEBUG ("running conversion pipeline to caps %" GST_PTR_FORMAT,
@@ -391,9 +663,13 @@ gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
           "Could not convert video frame: timeout during conversion");
   }
 
-  gst_element_set_state (pipeline, GST_STATE_NULL);
   gst_object_unref (bus);
-  gst_object_unref (pipeline);
+  /* only pipelines that worked are kept, a timeout or error could leave
+   * the pipeline in a state we don't want to reuse */
+  if (result)
+    convert_frame_pipeline_release (cp);
+  else
+    convert_frame_pipeline_free (cp);
   gst_caps_unref (to_caps_copy);
 
   return result;
@@ -628,6 +904,30 @@ done:
   return GST_FLOW_OK;
 }
 
+/* calls @callback from @context without a pipeline context */
+static void
+convert_frame_dispatch (GMainContext * context, GstSample * sample,
+    GError * error, GstVideoConvertSampleCallback callback,
+    gpointer user_data, GDestroyNotify destroy_notify)
+{
+  GstVideoConvertSampleCallbackContext *ctx;
+  GSource *source;
+
+  ctx = g_slice_new0 (GstVideoConvertSampleCallbackContext);
+  ctx->callback = callback;
+  ctx->user_data = user_data;
+  ctx->destroy_notify = destroy_notify;
+  ctx->sample = sample;
+  ctx->error = error;
+
+  source = g_timeout_source_new (0);
+  g_source_set_callback (source,
+      (GSourceFunc) convert_frame_dispatch_callback, ctx,
+      (GDestroyNotify) gst_video_convert_frame_callback_context_free);
+  g_source_attach (source, context);
+  g_source_unref (source);
+}
+
 /**
  * gst_video_convert_sample_async:
  * @sample: a #GstSample
@@ -663,6 +963,8 @@ gst_video_convert_sample_async (GstSample * sample,
   GstBuffer *buf;
   GstCaps *from_caps, *to_caps_copy = NULL;
   GstElement *pipeline, *src, *sink;
+  GstVideoCropMeta *cmeta;
+  GstSample *result;
   guint i, n;
   GSource *source;
   GstVideoConvertSampleContext *ctx;
@@ -692,9 +994,20 @@ gst_video_convert_sample_async (GstSample * sample,
     gst_caps_append_structure (to_caps_copy, s);
   }
 
+  cmeta = gst_buffer_get_video_crop_meta (buf);
+
+  result = convert_sample_direct (sample, cmeta, to_caps_copy);
+  if (result) {
+    GST_DEBUG ("direct conversion successful: result = %p", result);
+    gst_caps_unref (to_caps_copy);
+    convert_frame_dispatch (context, result, NULL, callback, user_data,
+        destroy_notify);
+    return;
+  }
+
   pipeline =
-      build_convert_frame_pipeline (&src, &sink, from_caps,
-      gst_buffer_get_video_crop_meta (buf), to_caps_copy, &error);
+      build_convert_frame_pipeline (&src, &sink, from_caps, cmeta,
+      to_caps_copy, &error);
   if (!pipeline)
     goto no_pipeline;
 
@@ -739,23 +1052,9 @@ gst_video_convert_sample_async (GstSample * sample,
   /* ERRORS */
 no_pipeline:
   {
-    GstVideoConvertSampleCallbackContext *ctx;
-    GSource *source;
-
     gst_caps_unref (to_caps_copy);
 
-    ctx = g_slice_new0 (GstVideoConvertSampleCallbackContext);
-    ctx->callback = callback;
-    ctx->user_data = user_data;
-    ctx->destroy_notify = destroy_notify;
-    ctx->sample = NULL;
-    ctx->error = error;
-
-    source = g_timeout_source_new (0);
-    g_source_set_callback (source,
-        (GSourceFunc) convert_frame_dispatch_callback, ctx,
-        (GDestroyNotify) gst_video_convert_frame_callback_context_free);
-    g_source_attach (source, context);
-    g_source_unref (source);
+    convert_frame_dispatch (context, NULL, error, callback, user_data,
+        destroy_notify);
   }
 }
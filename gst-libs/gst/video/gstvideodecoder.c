@@ -153,7 +153,9 @@
  *      Parse input data, if it is not considered packetized from upstream
  *      Data will be provided to @parse which should invoke
  *      @gst_video_decoder_add_to_frame and @gst_video_decoder_have_frame to
- *      separate the data belonging to each video frame.
+ *      separate the data belonging to each video frame. The input buffer of
+ *      a frame that straddles input buffers is made of their memories, it
+ *      is only merged into one when it is mapped.
  *   </para></listitem>
  *   <listitem><para>
  *      Accept data in @handle_frame and provide decoded results to
@@ -317,6 +319,40 @@
 GST_DEBUG_CATEGORY (videodecoder_debug);
 #define GST_CAT_DEFAULT videodecoder_debug
 
+enum
+{
+  PROP_0,
+  PROP_STATS
+};
+
+/* what a subclass did with a frame from a frame thread */
+typedef enum
+{
+  FRAME_THREAD_FINISH,
+  FRAME_THREAD_DROP,
+  FRAME_THREAD_RELEASE
+} FrameThreadAction;
+
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  FrameThreadAction action;
+  /* system_frame_number of the frame that was being decoded and the order
+   * of the call in its handle_frame() */
+  guint32 producer;
+  guint seq;
+} FrameThreadResult;
+
+/* set while a frame thread runs handle_frame() */
+typedef struct
+{
+  GstVideoDecoder *decoder;
+  guint32 producer;
+  guint seq;
+} FrameThreadContext;
+
+static GPrivate frame_thread_context;
+
 #define GST_VIDEO_DECODER_GET_PRIVATE(obj)  \
     (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_VIDEO_DECODER, \
         GstVideoDecoderPrivate))
@@ -365,7 +401,7 @@ struct _GstVideoDecoderPrivate
   /* relative offset of frame */
   guint64 frame_offset;
   /* tracking ts and offsets */
-  GList *timestamps;
+  GQueue timestamps;
 
   /* last outgoing ts */
   GstClockTime last_timestamp_out;
@@ -398,7 +434,8 @@ struct _GstVideoDecoderPrivate
   guint32 system_frame_number;
   guint32 decode_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GstVideoCodecFrameQueue frames;       /* Protected with STREAM_LOCK */
+  GstVideoCodecStats stats;             /* atomic */
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;     /* OBJECT_LOCK and STREAM_LOCK */
   gboolean output_state_changed;
@@ -407,6 +444,8 @@ struct _GstVideoDecoderPrivate
   gdouble proportion;           /* OBJECT_LOCK */
   GstClockTime earliest_time;   /* OBJECT_LOCK */
   GstClockTime qos_frame_duration;      /* OBJECT_LOCK */
+  /* downstream uses one frame per interval */
+  GstClockTime frame_interval;  /* OBJECT_LOCK */
   gboolean discont;
   /* qos messages: frames dropped/processed */
   guint dropped;
@@ -430,6 +469,20 @@ struct _GstVideoDecoderPrivate
 
   /* flags */
   gboolean use_default_pad_acceptcaps;
+
+  /* frame threading */
+  guint frame_threads;
+  GThreadPool *frame_pool;
+  GMutex frame_lock;
+  GCond frame_cond;
+  /* system_frame_numbers of frames in handle_frame(), protected with
+   * frame_lock */
+  GList *frames_in_flight;
+  /* FrameThreadResult sorted by producer, protected with frame_lock */
+  GList *frames_done;
+  /* flow return to report from the streaming thread, protected with
+   * frame_lock */
+  GstFlowReturn frame_ret;
 };
 
 static GstElementClass *parent_class = NULL;
@@ -438,6 +491,8 @@ static void gst_video_decoder_init (GstVideoDecoder * dec,
     GstVideoDecoderClass * klass);
 
 static void gst_video_decoder_finalize (GObject * object);
+static void gst_video_decoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_video_decoder_setcaps (GstVideoDecoder * dec,
     GstCaps * caps);
@@ -456,6 +511,15 @@ static gboolean gst_video_decoder_src_query (GstPad * pad, GstObject * parent,
 static void gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     gboolean flush_hard);
 
+static void frame_thread_result_free (FrameThreadResult * result);
+static gboolean gst_video_decoder_defer_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, FrameThreadAction action);
+static GstFlowReturn gst_video_decoder_get_frame_ret (GstVideoDecoder *
+    decoder);
+static void gst_video_decoder_wait_frames_in_flight (GstVideoDecoder *
+    decoder, guint max_in_flight);
+static GstFlowReturn gst_video_decoder_wait_frame_threads (GstVideoDecoder *
+    decoder, guint max_in_flight);
 static GstFlowReturn gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame);
 
@@ -537,6 +601,19 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
   g_type_class_add_private (klass, sizeof (GstVideoDecoderPrivate));
 
   gobject_class->finalize = gst_video_decoder_finalize;
+  gobject_class->get_property = gst_video_decoder_get_property;
+
+  /**
+   * GstVideoDecoder:stats:
+   *
+   * Frame statistics, see gst_video_decoder_get_stats().
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Frame latency and timing statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_video_decoder_change_state);
@@ -593,12 +670,19 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
 
   decoder->priv->input_adapter = gst_adapter_new ();
   decoder->priv->output_adapter = gst_adapter_new ();
+  __gst_video_codec_frame_queue_init (&decoder->priv->frames);
+  g_queue_init (&decoder->priv->timestamps);
   decoder->priv->packetized = TRUE;
   decoder->priv->needs_format = FALSE;
 
   decoder->priv->min_latency = 0;
   decoder->priv->max_latency = 0;
 
+  decoder->priv->frame_threads = 1;
+  g_mutex_init (&decoder->priv->frame_lock);
+  g_cond_init (&decoder->priv->frame_cond);
+  decoder->priv->frame_ret = GST_FLOW_OK;
+
   gst_video_decoder_reset (decoder, TRUE, TRUE);
 }
 
@@ -868,6 +952,17 @@ gst_video_decoder_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (object, "finalize");
 
+  if (decoder->priv->frame_pool) {
+    g_thread_pool_free (decoder->priv->frame_pool, FALSE, TRUE);
+    decoder->priv->frame_pool = NULL;
+  }
+  g_mutex_clear (&decoder->priv->frame_lock);
+  g_cond_clear (&decoder->priv->frame_cond);
+
+  __gst_video_codec_frame_queue_free (&decoder->priv->frames);
+  g_queue_foreach (&decoder->priv->timestamps, (GFunc) timestamp_free, NULL);
+  g_queue_clear (&decoder->priv->timestamps);
+
   g_rec_mutex_clear (&decoder->stream_lock);
 
   if (decoder->priv->input_adapter) {
@@ -1047,6 +1142,18 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
       ret = gst_video_decoder_parse_available (dec, TRUE, FALSE);
     }
 
+    /* the final parse might have handed more frames to the frame threads,
+     * they all need to be finished before finish() or drain() */
+    if (priv->frame_pool) {
+      GstFlowReturn res;
+
+      GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+      res = gst_video_decoder_wait_frame_threads (dec, 0);
+      GST_VIDEO_DECODER_STREAM_LOCK (dec);
+      if (ret == GST_FLOW_OK)
+        ret = res;
+    }
+
     if (at_eos) {
       if (decoder_class->finish)
         ret = decoder_class->finish (dec);
@@ -1064,6 +1171,15 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
 
   GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
 
+  /* finish(), drain() or the reverse playback flush can decode more frames
+   * in the frame threads, push them before the event that drained us */
+  if (priv->frame_pool) {
+    GstFlowReturn res = gst_video_decoder_wait_frame_threads (dec, 0);
+
+    if (ret == GST_FLOW_OK)
+      ret = res;
+  }
+
   return ret;
 }
 
@@ -1399,7 +1515,7 @@ gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
       GList *l;
 
       GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-      for (l = priv->frames; l; l = l->next) {
+      for (l = priv->frames.queue.head; l; l = l->next) {
         GstVideoCodecFrame *frame = l->data;
 
         frame->events = _flush_events (decoder->srcpad, frame->events);
@@ -1485,6 +1601,10 @@ gst_video_decoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (decoder, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* serialized events apply after all frames before them */
+  if (decoder->priv->frame_pool && GST_EVENT_IS_SERIALIZED (event))
+    gst_video_decoder_wait_frame_threads (decoder, 0);
+
   if (decoder_class->sink_event)
     ret = decoder_class->sink_event (decoder, event);
 
@@ -1645,6 +1765,25 @@ gst_video_decoder_src_event_default (GstVideoDecoder * decoder,
       res = gst_pad_push_event (decoder->sinkpad, event);
       break;
     }
+    case GST_EVENT_CUSTOM_UPSTREAM:
+    {
+      GstClockTime interval;
+
+      if (gst_video_event_parse_frame_interval (event, &interval)) {
+        GST_DEBUG_OBJECT (decoder, "downstream uses one frame per %"
+            GST_TIME_FORMAT, GST_TIME_ARGS (interval));
+
+        GST_OBJECT_LOCK (decoder);
+        priv->frame_interval = interval;
+        GST_OBJECT_UNLOCK (decoder);
+
+        gst_event_unref (event);
+        res = TRUE;
+        break;
+      }
+      res = gst_pad_push_event (decoder->sinkpad, event);
+      break;
+    }
     default:
       res = gst_pad_push_event (decoder->sinkpad, event);
       break;
@@ -2002,7 +2141,7 @@ gst_video_decoder_add_timestamp (GstVideoDecoder * decoder, GstBuffer * buffer)
   ts->dts = GST_BUFFER_DTS (buffer);
   ts->duration = GST_BUFFER_DURATION (buffer);
 
-  priv->timestamps = g_list_append (priv->timestamps, ts);
+  g_queue_push_tail (&priv->timestamps, ts);
 }
 
 static void
@@ -2013,29 +2152,22 @@ gst_video_decoder_get_timestamp_at_offset (GstVideoDecoder *
 #ifndef GST_DISABLE_GST_DEBUG
   guint64 got_offset = 0;
 #endif
+  GQueue *timestamps = &decoder->priv->timestamps;
   Timestamp *ts;
-  GList *g;
 
   *pts = GST_CLOCK_TIME_NONE;
   *dts = GST_CLOCK_TIME_NONE;
   *duration = GST_CLOCK_TIME_NONE;
 
-  g = decoder->priv->timestamps;
-  while (g) {
-    ts = g->data;
-    if (ts->offset <= offset) {
+  while ((ts = g_queue_peek_head (timestamps)) && ts->offset <= offset) {
 #ifndef GST_DISABLE_GST_DEBUG
-      got_offset = ts->offset;
+    got_offset = ts->offset;
 #endif
-      *pts = ts->pts;
-      *dts = ts->dts;
-      *duration = ts->duration;
-      g = g->next;
-      decoder->priv->timestamps = g_list_remove (decoder->priv->timestamps, ts);
-      timestamp_free (ts);
-    } else {
-      break;
-    }
+    *pts = ts->pts;
+    *dts = ts->dts;
+    *duration = ts->duration;
+    g_queue_pop_head (timestamps);
+    timestamp_free (ts);
   }
 
   GST_LOG_OBJECT (decoder,
@@ -2062,8 +2194,14 @@ gst_video_decoder_clear_queues (GstVideoDecoder * dec)
   g_list_free_full (priv->parse_gather,
       (GDestroyNotify) gst_video_codec_frame_unref);
   priv->parse_gather = NULL;
-  g_list_free_full (priv->frames, (GDestroyNotify) gst_video_codec_frame_unref);
-  priv->frames = NULL;
+  __gst_video_codec_frame_queue_clear (&priv->frames);
+
+  g_mutex_lock (&priv->frame_lock);
+  g_list_free_full (priv->frames_done,
+      (GDestroyNotify) frame_thread_result_free);
+  priv->frames_done = NULL;
+  priv->frame_ret = GST_FLOW_OK;
+  g_mutex_unlock (&priv->frame_lock);
 }
 
 static void
@@ -2114,6 +2252,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     priv->output_state = NULL;
 
     priv->qos_frame_duration = 0;
+    priv->frame_interval = GST_CLOCK_TIME_NONE;
     GST_OBJECT_UNLOCK (decoder);
 
     if (priv->tags)
@@ -2129,6 +2268,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
 
     priv->dropped = 0;
     priv->processed = 0;
+    __gst_video_codec_stats_reset (&priv->stats);
 
     priv->decode_frame_number = 0;
     priv->base_picture_number = 0;
@@ -2157,8 +2297,8 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   priv->frame_offset = 0;
   gst_adapter_clear (priv->input_adapter);
   gst_adapter_clear (priv->output_adapter);
-  g_list_free_full (priv->timestamps, (GDestroyNotify) timestamp_free);
-  priv->timestamps = NULL;
+  g_queue_foreach (&priv->timestamps, (GFunc) timestamp_free, NULL);
+  g_queue_clear (&priv->timestamps);
 
   priv->bytes_out = 0;
   priv->time = 0;
@@ -2505,6 +2645,13 @@ gst_video_decoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
     ret = gst_video_decoder_chain_reverse (decoder, buf);
 
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  /* wait for a free frame thread for the next frame, this also pushes
+   * the frames that were finished in the meantime */
+  if (decoder->priv->frame_pool && ret == GST_FLOW_OK)
+    ret = gst_video_decoder_wait_frame_threads (decoder,
+        decoder->priv->frame_threads - 1);
+
   return ret;
 
   /* ERRORS */
@@ -2552,6 +2699,9 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      if (decoder->priv->frame_pool)
+        gst_video_decoder_wait_frames_in_flight (decoder, 0);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -2658,7 +2808,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
 
 #ifndef GST_DISABLE_GST_DEBUG
   GST_LOG_OBJECT (decoder, "n %d in %" G_GSIZE_FORMAT " out %" G_GSIZE_FORMAT,
-      g_list_length (priv->frames),
+      priv->frames.queue.length,
       gst_adapter_available (priv->input_adapter),
       gst_adapter_available (priv->output_adapter));
 #endif
@@ -2672,7 +2822,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
       sync, GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->dts));
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.queue.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2732,7 +2882,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.queue.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2766,7 +2916,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     /* some more maintenance, ts2 holds PTS */
     min_ts = GST_CLOCK_TIME_NONE;
     seen_none = FALSE;
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.queue.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts2)) {
@@ -2858,14 +3008,14 @@ void
 gst_video_decoder_release_frame (GstVideoDecoder * dec,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
+  if (gst_video_decoder_defer_frame (dec, frame, FRAME_THREAD_RELEASE))
+    return;
 
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
-  link = g_list_find (dec->priv->frames, frame);
-  if (link) {
+  if (__gst_video_codec_frame_queue_remove (&dec->priv->frames, frame)) {
+    __gst_video_codec_stats_frame_out (&dec->priv->stats, frame);
     gst_video_codec_frame_unref (frame);
-    dec->priv->frames = g_list_delete_link (dec->priv->frames, link);
   }
   if (frame->events) {
     dec->priv->pending_events =
@@ -2899,8 +3049,13 @@ gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
 
   GST_LOG_OBJECT (dec, "drop frame %p", frame);
 
+  if (gst_video_decoder_defer_frame (dec, frame, FRAME_THREAD_DROP))
+    return gst_video_decoder_get_frame_ret (dec);
+
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
 
+  g_atomic_int_inc (&dec->priv->stats.frames_dropped);
+
   gst_video_decoder_prepare_finish_frame (dec, frame, TRUE);
 
   GST_DEBUG_OBJECT (dec, "dropping frame %" GST_TIME_FORMAT,
@@ -3022,6 +3177,9 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
 
   GST_LOG_OBJECT (decoder, "finish frame %p", frame);
 
+  if (gst_video_decoder_defer_frame (decoder, frame, FRAME_THREAD_FINISH))
+    return gst_video_decoder_get_frame_ret (decoder);
+
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
 
   needs_reconfigure = gst_pad_check_reconfigure (decoder->srcpad);
@@ -3241,7 +3399,9 @@ gst_video_decoder_add_to_frame (GstVideoDecoder * decoder, int n_bytes)
     priv->frame_offset =
         priv->input_offset - gst_adapter_available (priv->input_adapter);
   }
-  buf = gst_adapter_take_buffer (priv->input_adapter, n_bytes);
+  /* no need to merge the memories that straddle input buffers, that's
+   * left to the subclass mapping the frame */
+  buf = gst_adapter_take_buffer_fast (priv->input_adapter, n_bytes);
 
   gst_adapter_push (priv->output_adapter, buf);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
@@ -3321,7 +3481,7 @@ gst_video_decoder_have_frame (GstVideoDecoder * decoder)
 
   n_available = gst_adapter_available (priv->output_adapter);
   if (n_available) {
-    buffer = gst_adapter_take_buffer (priv->output_adapter, n_available);
+    buffer = gst_adapter_take_buffer_fast (priv->output_adapter, n_available);
   } else {
     buffer = gst_buffer_new_and_alloc (0);
   }
@@ -3366,6 +3526,7 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoDecoderClass *decoder_class;
   GstFlowReturn ret = GST_FLOW_OK;
+  gint64 start;
 
   decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
 
@@ -3402,19 +3563,47 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
   GST_LOG_OBJECT (decoder, "dist %d", frame->distance_from_sync);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  __gst_video_codec_frame_queue_push (&priv->frames, frame);
+  __gst_video_codec_stats_frame_in (&priv->stats, frame,
+      priv->frames.queue.length);
 
-  if (g_list_length (priv->frames) > 10) {
+  if (priv->frames.queue.length > 10) {
     GST_DEBUG_OBJECT (decoder, "decoder frame list getting long: %d frames,"
-        "possible internal leaking?", g_list_length (priv->frames));
+        "possible internal leaking?", priv->frames.queue.length);
+  }
+
+  /* in key units trick mode only the keyframes are decoded, the other frames
+   * are released without ever going to the subclass */
+  if ((decoder->input_segment.flags & GST_SEGMENT_FLAG_TRICKMODE_KEY_UNITS)
+      && !GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame)) {
+    GST_LOG_OBJECT (decoder, "skipping delta frame %d in trick mode",
+        frame->system_frame_number);
+    gst_video_decoder_release_frame (decoder, frame);
+    return GST_FLOW_OK;
   }
 
   frame->deadline =
       gst_segment_to_running_time (&decoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  if (priv->frame_pool && decoder->input_segment.rate > 0.0) {
+    GST_LOG_OBJECT (decoder, "decode frame %d in a frame thread",
+        frame->system_frame_number);
+
+    g_mutex_lock (&priv->frame_lock);
+    priv->frames_in_flight = g_list_append (priv->frames_in_flight,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    g_mutex_unlock (&priv->frame_lock);
+
+    g_thread_pool_push (priv->frame_pool, frame, NULL);
+
+    return GST_FLOW_OK;
+  }
+
   /* do something with frame */
+  start = g_get_monotonic_time ();
   ret = decoder_class->handle_frame (decoder, frame);
+  __gst_video_codec_stats_add_time (&priv->stats.handle_frame, start);
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
 
@@ -3424,6 +3613,306 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
 }
 
 
+/* frame threading
+ *
+ * handle_frame() runs in a thread from frame_pool. The frames that the
+ * subclass finishes, drops or releases from there are collected in
+ * frames_done and pushed later from the streaming thread, in the order of
+ * the handle_frame() calls that produced them. Results of a handle_frame()
+ * call are only pushed when it and all previous calls returned, which
+ * gives the same output as decoding with a single thread. */
+static void
+frame_thread_result_free (FrameThreadResult * result)
+{
+  gst_video_codec_frame_unref (result->frame);
+  g_slice_free (FrameThreadResult, result);
+}
+
+static gint
+frame_thread_result_compare (const FrameThreadResult * a,
+    const FrameThreadResult * b)
+{
+  if (a->producer != b->producer)
+    return a->producer < b->producer ? -1 : 1;
+  if (a->seq != b->seq)
+    return a->seq < b->seq ? -1 : 1;
+  return 0;
+}
+
+/* when called from handle_frame() in a frame thread, takes ownership of
+ * @frame and queues @action for the streaming thread */
+static gboolean
+gst_video_decoder_defer_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, FrameThreadAction action)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameThreadContext *ctx;
+  FrameThreadResult *result;
+
+  ctx = g_private_get (&frame_thread_context);
+  if (ctx == NULL || ctx->decoder != decoder)
+    return FALSE;
+
+  GST_LOG_OBJECT (decoder, "queue action %d for frame %d from frame %d",
+      action, frame->system_frame_number, ctx->producer);
+
+  result = g_slice_new (FrameThreadResult);
+  result->frame = frame;
+  result->action = action;
+  result->producer = ctx->producer;
+  result->seq = ctx->seq++;
+
+  g_mutex_lock (&priv->frame_lock);
+  priv->frames_done = g_list_insert_sorted (priv->frames_done, result,
+      (GCompareFunc) frame_thread_result_compare);
+  g_mutex_unlock (&priv->frame_lock);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_video_decoder_get_frame_ret (GstVideoDecoder * decoder)
+{
+  GstFlowReturn ret;
+
+  g_mutex_lock (&decoder->priv->frame_lock);
+  ret = decoder->priv->frame_ret;
+  g_mutex_unlock (&decoder->priv->frame_lock);
+
+  return ret;
+}
+
+static void
+gst_video_decoder_frame_thread_func (GstVideoCodecFrame * frame,
+    GstVideoDecoder * decoder)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameThreadContext ctx;
+  GstFlowReturn ret;
+  gint64 start;
+
+  ctx.decoder = decoder;
+  ctx.producer = frame->system_frame_number;
+  ctx.seq = 0;
+
+  g_private_set (&frame_thread_context, &ctx);
+  start = g_get_monotonic_time ();
+  ret = decoder_class->handle_frame (decoder, frame);
+  __gst_video_codec_stats_add_time (&priv->stats.handle_frame, start);
+  g_private_set (&frame_thread_context, NULL);
+
+  g_mutex_lock (&priv->frame_lock);
+  priv->frames_in_flight = g_list_remove (priv->frames_in_flight,
+      GUINT_TO_POINTER (ctx.producer));
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (decoder, "frame %d flow error %s", ctx.producer,
+        gst_flow_get_name (ret));
+    if (priv->frame_ret == GST_FLOW_OK)
+      priv->frame_ret = ret;
+  }
+  g_cond_broadcast (&priv->frame_cond);
+  g_mutex_unlock (&priv->frame_lock);
+}
+
+/* must be called without the STREAM_LOCK, handle_frame() might need it */
+static void
+gst_video_decoder_wait_frames_in_flight (GstVideoDecoder * decoder,
+    guint max_in_flight)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  g_mutex_lock (&priv->frame_lock);
+  while (g_list_length (priv->frames_in_flight) > max_in_flight)
+    g_cond_wait (&priv->frame_cond, &priv->frame_lock);
+  g_mutex_unlock (&priv->frame_lock);
+}
+
+/* with STREAM_LOCK */
+static GstFlowReturn
+gst_video_decoder_push_frames_done (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK, res;
+
+  while (TRUE) {
+    FrameThreadResult *result = NULL;
+
+    g_mutex_lock (&priv->frame_lock);
+    if (priv->frames_done) {
+      result = priv->frames_done->data;
+      /* the frames in flight are sorted, wait until the handle_frame()
+       * calls up to the producer of this result returned */
+      if (priv->frames_in_flight &&
+          GPOINTER_TO_UINT (priv->frames_in_flight->data) <= result->producer)
+        result = NULL;
+      else
+        priv->frames_done = g_list_delete_link (priv->frames_done,
+            priv->frames_done);
+    }
+    g_mutex_unlock (&priv->frame_lock);
+
+    if (result == NULL)
+      break;
+
+    switch (result->action) {
+      case FRAME_THREAD_FINISH:
+        res = gst_video_decoder_finish_frame (decoder, result->frame);
+        break;
+      case FRAME_THREAD_DROP:
+        res = gst_video_decoder_drop_frame (decoder, result->frame);
+        break;
+      case FRAME_THREAD_RELEASE:
+      default:
+        gst_video_decoder_release_frame (decoder, result->frame);
+        res = GST_FLOW_OK;
+        break;
+    }
+    g_slice_free (FrameThreadResult, result);
+
+    if (res != GST_FLOW_OK && ret == GST_FLOW_OK)
+      ret = res;
+  }
+
+  return ret;
+}
+
+/* must be called without the STREAM_LOCK. Waits until at most
+ * @max_in_flight frames are being decoded and pushes the finished frames.
+ * Returns the first error of handle_frame() or downstream since the last
+ * call. */
+static GstFlowReturn
+gst_video_decoder_wait_frame_threads (GstVideoDecoder * decoder,
+    guint max_in_flight)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+
+  gst_video_decoder_wait_frames_in_flight (decoder, max_in_flight);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  ret = gst_video_decoder_push_frames_done (decoder);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  g_mutex_lock (&priv->frame_lock);
+  if (ret == GST_FLOW_OK)
+    ret = priv->frame_ret;
+  /* let the frame threads know about downstream errors */
+  priv->frame_ret = (ret == GST_FLOW_FLUSHING || ret == GST_FLOW_EOS ||
+      ret == GST_FLOW_NOT_LINKED) ? ret : GST_FLOW_OK;
+  g_mutex_unlock (&priv->frame_lock);
+
+  return ret;
+}
+
+/**
+ * gst_video_decoder_set_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ * @n_threads: maximum number of frames to decode at the same time
+ *
+ * Lets #GstVideoDecoder call #GstVideoDecoderClass.handle_frame() from a
+ * pool of @n_threads threads, with up to @n_threads frames being decoded
+ * at the same time. 0 uses the number of CPU cores and 1, the default,
+ * calls handle_frame() from the streaming thread.
+ *
+ * The frames that the subclass passes to gst_video_decoder_finish_frame(),
+ * gst_video_decoder_drop_frame() or gst_video_decoder_release_frame()
+ * from handle_frame() are collected and pushed from the streaming thread
+ * in the same order as they would be with a single thread.
+ *
+ * Only enable this when handle_frame() can decode multiple frames at the
+ * same time. Before using a previous frame as a reference, handle_frame()
+ * should wait for it with gst_video_decoder_wait_frame_decoded().
+ *
+ * This function must be called when the decoder is not processing data,
+ * usually from the instance init or the start vmethod. Reverse playback
+ * always calls handle_frame() from the streaming thread.
+ *
+ * Since: 1.10
+ */
+void
+gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+    guint n_threads)
+{
+  GstVideoDecoderPrivate *priv;
+
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+
+  priv = decoder->priv;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  if (priv->frame_pool) {
+    g_thread_pool_free (priv->frame_pool, FALSE, TRUE);
+    priv->frame_pool = NULL;
+  }
+
+  GST_DEBUG_OBJECT (decoder, "using %u frame threads", n_threads);
+
+  priv->frame_threads = n_threads;
+  if (n_threads > 1)
+    priv->frame_pool =
+        g_thread_pool_new ((GFunc) gst_video_decoder_frame_thread_func,
+        decoder, n_threads, FALSE, NULL);
+}
+
+/**
+ * gst_video_decoder_get_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Returns: the number of frames that can be decoded at the same time, see
+ *     gst_video_decoder_set_frame_threads().
+ *
+ * Since: 1.10
+ */
+guint
+gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), 1);
+
+  return decoder->priv->frame_threads;
+}
+
+/**
+ * gst_video_decoder_wait_frame_decoded:
+ * @decoder: a #GstVideoDecoder
+ * @frame: a #GstVideoCodecFrame
+ *
+ * Waits until #GstVideoDecoderClass.handle_frame() returned for @frame.
+ * With frame threading enabled, handle_frame() calls this before using
+ * @frame as a reference picture. @frame must have been passed to
+ * handle_frame() before the frame that is being decoded.
+ *
+ * Returns immediately when frame threading is not enabled.
+ *
+ * Since: 1.10
+ */
+void
+gst_video_decoder_wait_frame_decoded (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv;
+  gpointer number;
+
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+  g_return_if_fail (frame != NULL);
+
+  priv = decoder->priv;
+  if (priv->frame_pool == NULL)
+    return;
+
+  number = GUINT_TO_POINTER (frame->system_frame_number);
+
+  g_mutex_lock (&priv->frame_lock);
+  while (g_list_find (priv->frames_in_flight, number)) {
+    GST_LOG_OBJECT (decoder, "waiting for frame %d",
+        frame->system_frame_number);
+    g_cond_wait (&priv->frame_cond, &priv->frame_lock);
+  }
+  g_mutex_unlock (&priv->frame_lock);
+}
+
 /**
  * gst_video_decoder_get_output_state:
  * @decoder: a #GstVideoDecoder
@@ -3522,8 +4011,8 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  if (decoder->priv->frames)
-    frame = gst_video_codec_frame_ref (decoder->priv->frames->data);
+  if (decoder->priv->frames.queue.head)
+    frame = gst_video_codec_frame_ref (decoder->priv->frames.queue.head->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -3541,20 +4030,15 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
 GstVideoCodecFrame *
 gst_video_decoder_get_frame (GstVideoDecoder * decoder, int frame_number)
 {
-  GList *g;
-  GstVideoCodecFrame *frame = NULL;
+  GstVideoCodecFrame *frame;
 
   GST_DEBUG_OBJECT (decoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  for (g = decoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  frame = __gst_video_codec_frame_queue_lookup (&decoder->priv->frames,
+      frame_number);
+  if (frame)
+    gst_video_codec_frame_ref (frame);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return frame;
@@ -3574,7 +4058,7 @@ gst_video_decoder_get_frames (GstVideoDecoder * decoder)
   GList *frames;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  frames = g_list_copy (decoder->priv->frames);
+  frames = g_list_copy (decoder->priv->frames.queue.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
@@ -3804,7 +4288,7 @@ gst_video_decoder_negotiate_default (GstVideoDecoder * decoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = decoder->priv->frames ? decoder->priv->frames->data : NULL;
+  frame = g_queue_peek_head (&decoder->priv->frames.queue);
   if (frame || decoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -3916,6 +4400,7 @@ gst_video_decoder_allocate_output_buffer (GstVideoDecoder * decoder)
   GstFlowReturn flow;
   GstBuffer *buffer = NULL;
   gboolean needs_reconfigure = FALSE;
+  gint64 start;
 
   GST_DEBUG ("alloc src buffer");
 
@@ -3935,7 +4420,9 @@ gst_video_decoder_allocate_output_buffer (GstVideoDecoder * decoder)
     }
   }
 
+  start = g_get_monotonic_time ();
   flow = gst_buffer_pool_acquire_buffer (decoder->priv->pool, &buffer, NULL);
+  __gst_video_codec_stats_add_time (&decoder->priv->stats.alloc, start);
 
   if (flow != GST_FLOW_OK) {
     GST_INFO_OBJECT (decoder, "couldn't allocate output buffer, flow %s",
@@ -3985,6 +4472,7 @@ gst_video_decoder_allocate_output_frame (GstVideoDecoder *
   GstVideoCodecState *state;
   int num_bytes;
   gboolean needs_reconfigure = FALSE;
+  gint64 start;
 
   g_return_val_if_fail (decoder->priv->output_state, GST_FLOW_NOT_NEGOTIATED);
   g_return_val_if_fail (frame->output_buffer == NULL, GST_FLOW_ERROR);
@@ -4012,8 +4500,10 @@ gst_video_decoder_allocate_output_frame (GstVideoDecoder *
 
   GST_LOG_OBJECT (decoder, "alloc buffer size %d", num_bytes);
 
+  start = g_get_monotonic_time ();
   flow_ret = gst_buffer_pool_acquire_buffer (decoder->priv->pool,
       &frame->output_buffer, NULL);
+  __gst_video_codec_stats_add_time (&decoder->priv->stats.alloc, start);
 
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
@@ -4034,23 +4524,45 @@ error:
  * In particular, a negative result means decoding in time is no longer possible
  * and should therefore occur as soon/skippy as possible.
  *
+ * The result is also negative for frames that downstream will drop anyway
+ * because it uses fewer frames than the stream has, as announced with
+ * gst_video_event_new_frame_interval().
+ *
  * Returns: max decoding time.
  */
 GstClockTimeDiff
 gst_video_decoder_get_max_decode_time (GstVideoDecoder *
     decoder, GstVideoCodecFrame * frame)
 {
+  GstVideoDecoderPrivate *priv = decoder->priv;
   GstClockTimeDiff deadline;
-  GstClockTime earliest_time;
+  GstClockTime earliest_time, interval, duration;
 
   GST_OBJECT_LOCK (decoder);
-  earliest_time = decoder->priv->earliest_time;
+  earliest_time = priv->earliest_time;
   if (GST_CLOCK_TIME_IS_VALID (earliest_time)
       && GST_CLOCK_TIME_IS_VALID (frame->deadline))
     deadline = GST_CLOCK_DIFF (earliest_time, frame->deadline);
   else
     deadline = G_MAXINT64;
 
+  /* only the frame closest to the start of every interval is used
+   * downstream, the others don't need to be decoded */
+  interval = priv->frame_interval;
+  duration = priv->qos_frame_duration;
+  if (duration == 0 && GST_CLOCK_TIME_IS_VALID (frame->duration))
+    duration = frame->duration;
+  if (GST_CLOCK_TIME_IS_VALID (interval) && interval > duration
+      && duration > 0 && GST_CLOCK_TIME_IS_VALID (frame->deadline)
+      && frame->deadline >= duration / 2) {
+    GstClockTime t = frame->deadline + duration / 2;
+
+    if (t / interval == (t - duration) / interval) {
+      GST_LOG_OBJECT (decoder, "frame not used downstream");
+      deadline = MIN (deadline, -1);
+    }
+  }
+
   GST_LOG_OBJECT (decoder, "earliest %" GST_TIME_FORMAT
       ", frame deadline %" GST_TIME_FORMAT ", deadline %" GST_STIME_FORMAT,
       GST_TIME_ARGS (earliest_time), GST_TIME_ARGS (frame->deadline),
@@ -4084,6 +4596,64 @@ gst_video_decoder_get_qos_proportion (GstVideoDecoder * decoder)
   return proportion;
 }
 
+/**
+ * gst_video_decoder_get_stats:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Get the frame statistics of @decoder since it was started. The structure
+ * contains:
+ *
+ * "frames-in", "frames-out" and "frames-dropped" (#guint): the number of
+ * frames passed to the subclass, released and dropped.
+ *
+ * "queue-depth" and "max-queue-depth" (#guint): the current and maximum
+ * number of pending frames.
+ *
+ * "latency-average" and "latency-max" (#guint64): the time in nanoseconds
+ * between receiving the input for a frame and releasing the frame.
+ *
+ * "latency-histogram" (#GstValueArray of #guint): the number of frames per
+ * latency range. Entry i counts the latencies below 2^i milliseconds, the
+ * last entry all the longer ones.
+ *
+ * "handle-frame-average" and "handle-frame-max" (#guint64): the time in
+ * nanoseconds spent in the handle_frame() vmethod.
+ *
+ * "allocation-average" and "allocation-max" (#guint64): the time in
+ * nanoseconds spent acquiring output buffers.
+ *
+ * The counters are updated without taking any lock so the values of a
+ * running decoder are not necessarily consistent with each other.
+ *
+ * Returns: (transfer full): a #GstStructure, free with gst_structure_free().
+ *
+ * Since: 1.10
+ */
+GstStructure *
+gst_video_decoder_get_stats (GstVideoDecoder * decoder)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), NULL);
+
+  return __gst_video_codec_stats_to_structure (&decoder->priv->stats,
+      "GstVideoDecoderStats", decoder->priv->frames.queue.length);
+}
+
+static void
+gst_video_decoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoDecoder *decoder = GST_VIDEO_DECODER (object);
+
+  switch (prop_id) {
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_video_decoder_get_stats (decoder));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 GstFlowReturn
 _gst_video_decoder_error (GstVideoDecoder * dec, gint weight,
     GQuark domain, gint code, gchar * txt, gchar * dbg, const gchar * file,
@@ -427,6 +427,16 @@ GstCaps *        gst_video_decoder_proxy_getcaps (GstVideoDecoder * decoder,
 void             gst_video_decoder_set_use_default_pad_acceptcaps (GstVideoDecoder * decoder,
                                                                    gboolean use);
 
+void             gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+                                                      guint n_threads);
+
+guint            gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder);
+
+GstStructure *   gst_video_decoder_get_stats (GstVideoDecoder * decoder);
+
+void             gst_video_decoder_wait_frame_decoded (GstVideoDecoder * decoder,
+                                                       GstVideoCodecFrame * frame);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoDecoder, gst_object_unref)
 #endif
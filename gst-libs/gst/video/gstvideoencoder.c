@@ -127,6 +127,32 @@
 GST_DEBUG_CATEGORY (videoencoder_debug);
 #define GST_CAT_DEFAULT videoencoder_debug
 
+enum
+{
+  PROP_0,
+  PROP_STATS
+};
+
+/* a frame finished from a frame thread */
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  /* system_frame_number of the frame that was being encoded and the order
+   * of the call in its handle_frame() */
+  guint32 producer;
+  guint seq;
+} FrameThreadResult;
+
+/* set while a frame thread runs handle_frame() */
+typedef struct
+{
+  GstVideoEncoder *encoder;
+  guint32 producer;
+  guint seq;
+} FrameThreadContext;
+
+static GPrivate frame_thread_context;
+
 #define GST_VIDEO_ENCODER_GET_PRIVATE(obj)  \
     (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_VIDEO_ENCODER, \
         GstVideoEncoderPrivate))
@@ -151,7 +177,8 @@ struct _GstVideoEncoderPrivate
 
   guint32 system_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GstVideoCodecFrameQueue frames;       /* Protected with STREAM_LOCK */
+  GstVideoCodecStats stats;             /* atomic */
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;
   gboolean output_state_changed;
@@ -162,6 +189,15 @@ struct _GstVideoEncoderPrivate
   GstAllocator *allocator;
   GstAllocationParams params;
 
+  /* pool for the encoded output, either from downstream or our own. It is
+   * sized to the biggest frame seen so far */
+  GstBufferPool *pool;
+  gboolean pool_downstream;
+  gboolean pool_failed;
+  guint pool_min, pool_max;
+  gsize pool_size;
+  gsize max_frame_size;
+
   /* upstream stream tags (global tags are passed through as-is) */
   GstTagList *upstream_tags;
 
@@ -175,6 +211,20 @@ struct _GstVideoEncoderPrivate
   /* adjustment needed on pts, dts, segment start and stop to accomodate
    * min_pts */
   GstClockTime time_adjustment;
+
+  /* frame threading */
+  guint frame_threads;
+  GThreadPool *frame_pool;
+  GMutex frame_lock;
+  GCond frame_cond;
+  /* system_frame_numbers of frames in handle_frame(), protected with
+   * frame_lock */
+  GList *frames_in_flight;
+  /* FrameThreadResult sorted by producer, protected with frame_lock */
+  GList *frames_done;
+  /* flow return to report from the streaming thread, protected with
+   * frame_lock */
+  GstFlowReturn frame_ret;
 };
 
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
@@ -212,6 +262,9 @@ static void gst_video_encoder_init (GstVideoEncoder * enc,
     GstVideoEncoderClass * klass);
 
 static void gst_video_encoder_finalize (GObject * object);
+static void gst_video_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+static void gst_video_encoder_clear_pool (GstVideoEncoder * encoder);
 
 static gboolean gst_video_encoder_setcaps (GstVideoEncoder * enc,
     GstCaps * caps);
@@ -305,6 +358,19 @@ gst_video_encoder_class_init (GstVideoEncoderClass * klass)
   g_type_class_add_private (klass, sizeof (GstVideoEncoderPrivate));
 
   gobject_class->finalize = gst_video_encoder_finalize;
+  gobject_class->get_property = gst_video_encoder_get_property;
+
+  /**
+   * GstVideoEncoder:stats:
+   *
+   * Frame statistics, see gst_video_encoder_get_stats().
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Frame latency and timing statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_video_encoder_change_state);
@@ -337,6 +403,16 @@ _flush_events (GstPad * pad, GList * events)
   return NULL;
 }
 
+static void frame_thread_result_free (FrameThreadResult * result);
+static gboolean gst_video_encoder_defer_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame);
+static GstFlowReturn gst_video_encoder_get_frame_ret (GstVideoEncoder *
+    encoder);
+static void gst_video_encoder_wait_frames_in_flight (GstVideoEncoder *
+    encoder, guint max_in_flight);
+static GstFlowReturn gst_video_encoder_wait_frame_threads (GstVideoEncoder *
+    encoder, guint max_in_flight);
+
 static gboolean
 gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
 {
@@ -390,6 +466,11 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
       gst_object_unref (priv->allocator);
       priv->allocator = NULL;
     }
+    gst_video_encoder_clear_pool (encoder);
+    priv->pool_failed = FALSE;
+    priv->max_frame_size = 0;
+
+    __gst_video_codec_stats_reset (&priv->stats);
 
     g_list_foreach (priv->current_frame_events, (GFunc) gst_event_unref, NULL);
     g_list_free (priv->current_frame_events);
@@ -398,7 +479,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   } else {
     GList *l;
 
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.queue.head; l; l = l->next) {
       GstVideoCodecFrame *frame = l->data;
 
       frame->events = _flush_events (encoder->srcpad, frame->events);
@@ -407,9 +488,14 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
         encoder->priv->current_frame_events);
   }
 
-  g_list_foreach (priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
-  g_list_free (priv->frames);
-  priv->frames = NULL;
+  __gst_video_codec_frame_queue_clear (&priv->frames);
+
+  g_mutex_lock (&priv->frame_lock);
+  g_list_free_full (priv->frames_done,
+      (GDestroyNotify) frame_thread_result_free);
+  priv->frames_done = NULL;
+  priv->frame_ret = GST_FLOW_OK;
+  g_mutex_unlock (&priv->frame_lock);
 
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -472,6 +558,8 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
 
   g_rec_mutex_init (&encoder->stream_lock);
 
+  __gst_video_codec_frame_queue_init (&priv->frames);
+
   priv->headers = NULL;
   priv->new_headers = FALSE;
 
@@ -480,6 +568,11 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->min_pts = GST_CLOCK_TIME_NONE;
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
 
+  priv->frame_threads = 1;
+  g_mutex_init (&priv->frame_lock);
+  g_cond_init (&priv->frame_cond);
+  priv->frame_ret = GST_FLOW_OK;
+
   gst_video_encoder_reset (encoder, TRUE);
 }
 
@@ -879,12 +972,23 @@ gst_video_encoder_finalize (GObject * object)
   GST_DEBUG_OBJECT (object, "finalize");
 
   encoder = GST_VIDEO_ENCODER (object);
+
+  if (encoder->priv->frame_pool) {
+    g_thread_pool_free (encoder->priv->frame_pool, FALSE, TRUE);
+    encoder->priv->frame_pool = NULL;
+  }
+  g_mutex_clear (&encoder->priv->frame_lock);
+  g_cond_clear (&encoder->priv->frame_cond);
+
   g_rec_mutex_clear (&encoder->stream_lock);
 
+  __gst_video_codec_frame_queue_free (&encoder->priv->frames);
+
   if (encoder->priv->allocator) {
     gst_object_unref (encoder->priv->allocator);
     encoder->priv->allocator = NULL;
   }
+  gst_video_encoder_clear_pool (encoder);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1177,6 +1281,10 @@ gst_video_encoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (enc, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* serialized events apply after all frames before them */
+  if (enc->priv->frame_pool && GST_EVENT_IS_SERIALIZED (event))
+    gst_video_encoder_wait_frame_threads (enc, 0);
+
   if (klass->sink_event)
     ret = klass->sink_event (enc, event);
 
@@ -1469,7 +1577,9 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_OBJECT_UNLOCK (encoder);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  __gst_video_codec_frame_queue_push (&priv->frames, frame);
+  __gst_video_codec_stats_frame_in (&priv->stats, frame,
+      priv->frames.queue.length);
 
   /* new data, more finish needed */
   priv->drained = FALSE;
@@ -1477,11 +1587,33 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_LOG_OBJECT (encoder, "passing frame pfn %d to subclass",
       frame->presentation_frame_number);
 
-  ret = klass->handle_frame (encoder, frame);
+  if (priv->frame_pool) {
+    GST_LOG_OBJECT (encoder, "encode frame %d in a frame thread",
+        frame->system_frame_number);
+
+    g_mutex_lock (&priv->frame_lock);
+    priv->frames_in_flight = g_list_append (priv->frames_in_flight,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    g_mutex_unlock (&priv->frame_lock);
+
+    g_thread_pool_push (priv->frame_pool, frame, NULL);
+  } else {
+    gint64 handle_start = g_get_monotonic_time ();
+
+    ret = klass->handle_frame (encoder, frame);
+    __gst_video_codec_stats_add_time (&priv->stats.handle_frame,
+        handle_start);
+  }
 
 done:
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
+  /* wait for a free frame thread for the next frame, this also pushes
+   * the frames that were finished in the meantime */
+  if (priv->frame_pool && ret == GST_FLOW_OK)
+    ret = gst_video_encoder_wait_frame_threads (encoder,
+        priv->frame_threads - 1);
+
   return ret;
 
   /* ERRORS */
@@ -1529,6 +1661,9 @@ gst_video_encoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      if (encoder->priv->frame_pool)
+        gst_video_encoder_wait_frames_in_flight (encoder, 0);
+
       if (encoder_class->stop)
         stopped = encoder_class->stop (encoder);
 
@@ -1582,12 +1717,109 @@ close_failed:
   }
 }
 
+static void
+gst_video_encoder_clear_pool (GstVideoEncoder * encoder)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+
+  if (priv->pool) {
+    gst_buffer_pool_set_active (priv->pool, FALSE);
+    gst_object_unref (priv->pool);
+    priv->pool = NULL;
+  }
+  priv->pool_downstream = FALSE;
+  priv->pool_size = 0;
+}
+
+/* with STREAM_LOCK, makes sure the pool has buffers of at least @size */
+static gboolean
+gst_video_encoder_ensure_pool (GstVideoEncoder * encoder, gsize size)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstStructure *config;
+  GstCaps *caps;
+
+  if (priv->pool && priv->pool_size >= size)
+    return TRUE;
+  if (priv->pool_failed)
+    return FALSE;
+
+  /* leave some room so that we don't reconfigure for every slightly bigger
+   * frame */
+  priv->max_frame_size = MAX (priv->max_frame_size, size);
+  size = priv->max_frame_size + priv->max_frame_size / 4;
+
+again:
+  if (priv->pool == NULL) {
+    priv->pool = gst_buffer_pool_new ();
+    priv->pool_downstream = FALSE;
+    priv->pool_min = priv->pool_max = 0;
+  } else {
+    gst_buffer_pool_set_active (priv->pool, FALSE);
+  }
+
+  caps = priv->output_state ? priv->output_state->caps : NULL;
+
+  config = gst_buffer_pool_get_config (priv->pool);
+  gst_buffer_pool_config_set_params (config, caps, size, priv->pool_min,
+      priv->pool_max);
+  gst_buffer_pool_config_set_allocator (config, priv->allocator,
+      &priv->params);
+
+  if (!gst_buffer_pool_set_config (priv->pool, config) ||
+      !gst_buffer_pool_set_active (priv->pool, TRUE)) {
+    gboolean downstream = priv->pool_downstream;
+
+    GST_WARNING_OBJECT (encoder, "failed to configure %s pool for size %"
+        G_GSIZE_FORMAT, downstream ? "downstream" : "our", size);
+    gst_video_encoder_clear_pool (encoder);
+    if (downstream)
+      goto again;
+
+    priv->pool_failed = TRUE;
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (encoder, "configured pool %" GST_PTR_FORMAT " for size %"
+      G_GSIZE_FORMAT, priv->pool, size);
+  priv->pool_size = size;
+
+  return TRUE;
+}
+
+/* with STREAM_LOCK */
+static GstBuffer *
+gst_video_encoder_alloc_buffer (GstVideoEncoder * encoder, gsize size)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstBufferPoolAcquireParams params = { 0, };
+  GstBuffer *buffer = NULL;
+  gint64 start = g_get_monotonic_time ();
+
+  /* never block on a downstream pool, allocate a fresh buffer instead */
+  params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+
+  if (gst_video_encoder_ensure_pool (encoder, size) &&
+      gst_buffer_pool_acquire_buffer (priv->pool, &buffer,
+          &params) == GST_FLOW_OK) {
+    /* the pool puts the buffer back to its full size when released */
+    gst_buffer_resize (buffer, 0, size);
+  } else {
+    buffer = gst_buffer_new_allocate (priv->allocator, size, &priv->params);
+  }
+  __gst_video_codec_stats_add_time (&priv->stats.alloc, start);
+
+  return buffer;
+}
+
 static gboolean
 gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
 {
   GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
   GstAllocator *allocator;
   GstAllocationParams params;
+  GstBufferPool *pool = NULL;
+  guint size = 0, min = 0, max = 0;
   gboolean ret = TRUE;
   GstVideoCodecState *state = encoder->priv->output_state;
   GstVideoInfo *info = &state->info;
@@ -1635,7 +1867,7 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = encoder->priv->frames ? encoder->priv->frames->data : NULL;
+  frame = g_queue_peek_head (&encoder->priv->frames.queue);
   if (frame || encoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -1699,6 +1931,21 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
   encoder->priv->allocator = allocator;
   encoder->priv->params = params;
 
+  /* the pool is configured lazily when we know the size of the frames */
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+
+  gst_video_encoder_clear_pool (encoder);
+  encoder->priv->pool_failed = FALSE;
+  if (pool) {
+    encoder->priv->pool = pool;
+    encoder->priv->pool_downstream = TRUE;
+    encoder->priv->pool_min = min;
+    encoder->priv->pool_max = max;
+    encoder->priv->max_frame_size =
+        MAX (encoder->priv->max_frame_size, size);
+  }
+
 done:
   if (query)
     gst_query_unref (query);
@@ -1789,9 +2036,7 @@ gst_video_encoder_allocate_output_buffer (GstVideoEncoder * encoder, gsize size)
     }
   }
 
-  buffer =
-      gst_buffer_new_allocate (encoder->priv->allocator, size,
-      &encoder->priv->params);
+  buffer = gst_video_encoder_alloc_buffer (encoder, size);
   if (!buffer) {
     GST_INFO_OBJECT (encoder, "couldn't allocate output buffer");
     goto fallback;
@@ -1844,9 +2089,7 @@ gst_video_encoder_allocate_output_frame (GstVideoEncoder *
 
   GST_LOG_OBJECT (encoder, "alloc buffer size %" G_GSIZE_FORMAT, size);
 
-  frame->output_buffer =
-      gst_buffer_new_allocate (encoder->priv->allocator, size,
-      &encoder->priv->params);
+  frame->output_buffer = gst_video_encoder_alloc_buffer (encoder, size);
 
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -1857,13 +2100,10 @@ static void
 gst_video_encoder_release_frame (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
-  link = g_list_find (enc->priv->frames, frame);
-  if (link) {
+  if (__gst_video_codec_frame_queue_remove (&enc->priv->frames, frame)) {
+    __gst_video_codec_stats_frame_out (&enc->priv->stats, frame);
     gst_video_codec_frame_unref (frame);
-    enc->priv->frames = g_list_delete_link (enc->priv->frames, link);
   }
   /* unref because this function takes ownership */
   gst_video_codec_frame_unref (frame);
@@ -1960,6 +2200,9 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
   GST_LOG_OBJECT (encoder,
       "finish frame fpn %d", frame->presentation_frame_number);
 
+  if (gst_video_encoder_defer_frame (encoder, frame))
+    return gst_video_encoder_get_frame_ret (encoder);
+
   GST_LOG_OBJECT (encoder, "frame PTS %" GST_TIME_FORMAT
       ", DTS %" GST_TIME_FORMAT, GST_TIME_ARGS (frame->pts),
       GST_TIME_ARGS (frame->dts));
@@ -1983,7 +2226,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     goto no_output_state;
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.queue.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2005,6 +2248,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
   if (!frame->output_buffer) {
     GST_DEBUG_OBJECT (encoder, "skipping frame %" GST_TIME_FORMAT,
         GST_TIME_ARGS (frame->pts));
+    g_atomic_int_inc (&priv->stats.frames_dropped);
     goto done;
   }
 
@@ -2091,7 +2335,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.queue.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2218,6 +2462,289 @@ no_output_state:
   }
 }
 
+/* frame threading
+ *
+ * handle_frame() runs in a thread from frame_pool. The frames that the
+ * subclass finishes from there are collected in frames_done and pushed
+ * later from the streaming thread, in the order of the handle_frame()
+ * calls that produced them. Results of a handle_frame() call are only
+ * pushed when it and all previous calls returned, which gives the same
+ * output as encoding with a single thread. */
+static void
+frame_thread_result_free (FrameThreadResult * result)
+{
+  gst_video_codec_frame_unref (result->frame);
+  g_slice_free (FrameThreadResult, result);
+}
+
+static gint
+frame_thread_result_compare (const FrameThreadResult * a,
+    const FrameThreadResult * b)
+{
+  if (a->producer != b->producer)
+    return a->producer < b->producer ? -1 : 1;
+  if (a->seq != b->seq)
+    return a->seq < b->seq ? -1 : 1;
+  return 0;
+}
+
+/* when called from handle_frame() in a frame thread, takes ownership of
+ * @frame and queues it for the streaming thread */
+static gboolean
+gst_video_encoder_defer_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameThreadContext *ctx;
+  FrameThreadResult *result;
+
+  ctx = g_private_get (&frame_thread_context);
+  if (ctx == NULL || ctx->encoder != encoder)
+    return FALSE;
+
+  GST_LOG_OBJECT (encoder, "queue frame %d from frame %d",
+      frame->system_frame_number, ctx->producer);
+
+  result = g_slice_new (FrameThreadResult);
+  result->frame = frame;
+  result->producer = ctx->producer;
+  result->seq = ctx->seq++;
+
+  g_mutex_lock (&priv->frame_lock);
+  priv->frames_done = g_list_insert_sorted (priv->frames_done, result,
+      (GCompareFunc) frame_thread_result_compare);
+  g_mutex_unlock (&priv->frame_lock);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_video_encoder_get_frame_ret (GstVideoEncoder * encoder)
+{
+  GstFlowReturn ret;
+
+  g_mutex_lock (&encoder->priv->frame_lock);
+  ret = encoder->priv->frame_ret;
+  g_mutex_unlock (&encoder->priv->frame_lock);
+
+  return ret;
+}
+
+static void
+gst_video_encoder_frame_thread_func (GstVideoCodecFrame * frame,
+    GstVideoEncoder * encoder)
+{
+  GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameThreadContext ctx;
+  GstFlowReturn ret;
+  gint64 start;
+
+  ctx.encoder = encoder;
+  ctx.producer = frame->system_frame_number;
+  ctx.seq = 0;
+
+  g_private_set (&frame_thread_context, &ctx);
+  start = g_get_monotonic_time ();
+  ret = klass->handle_frame (encoder, frame);
+  __gst_video_codec_stats_add_time (&priv->stats.handle_frame, start);
+  g_private_set (&frame_thread_context, NULL);
+
+  g_mutex_lock (&priv->frame_lock);
+  priv->frames_in_flight = g_list_remove (priv->frames_in_flight,
+      GUINT_TO_POINTER (ctx.producer));
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (encoder, "frame %d flow error %s", ctx.producer,
+        gst_flow_get_name (ret));
+    if (priv->frame_ret == GST_FLOW_OK)
+      priv->frame_ret = ret;
+  }
+  g_cond_broadcast (&priv->frame_cond);
+  g_mutex_unlock (&priv->frame_lock);
+}
+
+/* must be called without the STREAM_LOCK, handle_frame() might need it */
+static void
+gst_video_encoder_wait_frames_in_flight (GstVideoEncoder * encoder,
+    guint max_in_flight)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+
+  g_mutex_lock (&priv->frame_lock);
+  while (g_list_length (priv->frames_in_flight) > max_in_flight)
+    g_cond_wait (&priv->frame_cond, &priv->frame_lock);
+  g_mutex_unlock (&priv->frame_lock);
+}
+
+/* with STREAM_LOCK */
+static GstFlowReturn
+gst_video_encoder_push_frames_done (GstVideoEncoder * encoder)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK, res;
+
+  while (TRUE) {
+    FrameThreadResult *result = NULL;
+
+    g_mutex_lock (&priv->frame_lock);
+    if (priv->frames_done) {
+      result = priv->frames_done->data;
+      /* the frames in flight are sorted, wait until the handle_frame()
+       * calls up to the producer of this result returned */
+      if (priv->frames_in_flight &&
+          GPOINTER_TO_UINT (priv->frames_in_flight->data) <= result->producer)
+        result = NULL;
+      else
+        priv->frames_done = g_list_delete_link (priv->frames_done,
+            priv->frames_done);
+    }
+    g_mutex_unlock (&priv->frame_lock);
+
+    if (result == NULL)
+      break;
+
+    res = gst_video_encoder_finish_frame (encoder, result->frame);
+    g_slice_free (FrameThreadResult, result);
+
+    if (res != GST_FLOW_OK && ret == GST_FLOW_OK)
+      ret = res;
+  }
+
+  return ret;
+}
+
+/* must be called without the STREAM_LOCK. Waits until at most
+ * @max_in_flight frames are being encoded and pushes the finished frames.
+ * Returns the first error of handle_frame() or downstream since the last
+ * call. */
+static GstFlowReturn
+gst_video_encoder_wait_frame_threads (GstVideoEncoder * encoder,
+    guint max_in_flight)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+
+  gst_video_encoder_wait_frames_in_flight (encoder, max_in_flight);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  ret = gst_video_encoder_push_frames_done (encoder);
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+  g_mutex_lock (&priv->frame_lock);
+  if (ret == GST_FLOW_OK)
+    ret = priv->frame_ret;
+  /* let the frame threads know about downstream errors */
+  priv->frame_ret = (ret == GST_FLOW_FLUSHING || ret == GST_FLOW_EOS ||
+      ret == GST_FLOW_NOT_LINKED) ? ret : GST_FLOW_OK;
+  g_mutex_unlock (&priv->frame_lock);
+
+  return ret;
+}
+
+/**
+ * gst_video_encoder_set_frame_threads:
+ * @encoder: a #GstVideoEncoder
+ * @n_threads: maximum number of frames to encode at the same time
+ *
+ * Lets #GstVideoEncoder call #GstVideoEncoderClass.handle_frame() from a
+ * pool of @n_threads threads, with up to @n_threads frames being encoded
+ * at the same time. 0 uses the number of CPU cores and 1, the default,
+ * calls handle_frame() from the streaming thread.
+ *
+ * The frames that the subclass passes to gst_video_encoder_finish_frame()
+ * from handle_frame() are collected and pushed from the streaming thread
+ * in the same order as they would be with a single thread.
+ *
+ * Only enable this when handle_frame() can encode independent frames at
+ * the same time, for example for intra-only formats, with a separate
+ * encoder context per thread where needed.
+ *
+ * This function must be called when the encoder is not processing data,
+ * usually from the instance init or the start vmethod.
+ *
+ * Since: 1.10
+ */
+void
+gst_video_encoder_set_frame_threads (GstVideoEncoder * encoder,
+    guint n_threads)
+{
+  GstVideoEncoderPrivate *priv;
+
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+
+  priv = encoder->priv;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  if (priv->frame_pool) {
+    g_thread_pool_free (priv->frame_pool, FALSE, TRUE);
+    priv->frame_pool = NULL;
+  }
+
+  GST_DEBUG_OBJECT (encoder, "using %u frame threads", n_threads);
+
+  priv->frame_threads = n_threads;
+  if (n_threads > 1)
+    priv->frame_pool =
+        g_thread_pool_new ((GFunc) gst_video_encoder_frame_thread_func,
+        encoder, n_threads, FALSE, NULL);
+}
+
+/**
+ * gst_video_encoder_get_frame_threads:
+ * @encoder: a #GstVideoEncoder
+ *
+ * Returns: the number of frames that can be encoded at the same time, see
+ *     gst_video_encoder_set_frame_threads().
+ *
+ * Since: 1.10
+ */
+guint
+gst_video_encoder_get_frame_threads (GstVideoEncoder * encoder)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), 1);
+
+  return encoder->priv->frame_threads;
+}
+
+/**
+ * gst_video_encoder_get_stats:
+ * @encoder: a #GstVideoEncoder
+ *
+ * Get the frame statistics of @encoder since it was started. The structure
+ * has the same fields as the one of gst_video_decoder_get_stats(), frames
+ * finished without output buffer are counted as dropped.
+ *
+ * Returns: (transfer full): a #GstStructure, free with gst_structure_free().
+ *
+ * Since: 1.10
+ */
+GstStructure *
+gst_video_encoder_get_stats (GstVideoEncoder * encoder)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), NULL);
+
+  return __gst_video_codec_stats_to_structure (&encoder->priv->stats,
+      "GstVideoEncoderStats", encoder->priv->frames.queue.length);
+}
+
+static void
+gst_video_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoEncoder *encoder = GST_VIDEO_ENCODER (object);
+
+  switch (prop_id) {
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_video_encoder_get_stats (encoder));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 /**
  * gst_video_encoder_get_output_state:
  * @encoder: a #GstVideoEncoder
@@ -2348,8 +2875,8 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  if (encoder->priv->frames)
-    frame = gst_video_codec_frame_ref (encoder->priv->frames->data);
+  if (encoder->priv->frames.queue.head)
+    frame = gst_video_codec_frame_ref (encoder->priv->frames.queue.head->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -2367,20 +2894,15 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
 GstVideoCodecFrame *
 gst_video_encoder_get_frame (GstVideoEncoder * encoder, int frame_number)
 {
-  GList *g;
-  GstVideoCodecFrame *frame = NULL;
+  GstVideoCodecFrame *frame;
 
   GST_DEBUG_OBJECT (encoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  for (g = encoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  frame = __gst_video_codec_frame_queue_lookup (&encoder->priv->frames,
+      frame_number);
+  if (frame)
+    gst_video_codec_frame_ref (frame);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return frame;
@@ -2400,7 +2922,7 @@ gst_video_encoder_get_frames (GstVideoEncoder * encoder)
   GList *frames;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  frames = g_list_copy (encoder->priv->frames);
+  frames = g_list_copy (encoder->priv->frames.queue.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -349,6 +349,13 @@ void                 gst_video_encoder_get_allocator (GstVideoEncoder *encoder,
 
 void                 gst_video_encoder_set_min_pts(GstVideoEncoder *encoder, GstClockTime min_pts);
 
+void                 gst_video_encoder_set_frame_threads (GstVideoEncoder *encoder,
+                                                          guint n_threads);
+
+guint                gst_video_encoder_get_frame_threads (GstVideoEncoder *encoder);
+
+GstStructure *       gst_video_encoder_get_stats (GstVideoEncoder *encoder);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoEncoder, gst_object_unref)
 #endif
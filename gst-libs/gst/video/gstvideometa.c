@@ -18,6 +18,7 @@
  */
 
 #include "gstvideometa.h"
+#include "gstvideoutilsprivate.h"
 
 #include <string.h>
 
@@ -246,6 +247,14 @@ default_unmap (GstVideoMeta * meta, guint plane, GstMapInfo * info)
   return TRUE;
 }
 
+/* TRUE when the planes of @meta are mapped with gst_buffer_map_range() so
+ * that the frame can map a single memory buffer once for all planes */
+gboolean
+__gst_video_meta_has_default_map (GstVideoMeta * meta)
+{
+  return meta->map == default_map && meta->unmap == default_unmap;
+}
+
 /**
  * gst_buffer_add_video_meta:
  * @buffer: a #GstBuffer
@@ -17,9 +17,17 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include "gst/video/gstvideometa.h"
 #include "gst/video/gstvideopool.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
 #define GST_CAT_DEFAULT gst_video_pool_debug
@@ -34,6 +42,13 @@ GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
  * Allows configuration of video-specific requirements such as
  * stride alignments or pixel padding, and can also be configured
  * to automatically add #GstVideoMeta to the buffers.
+ *
+ * Memory is allocated from the allocator set in the configuration with
+ * gst_buffer_pool_config_set_allocator(), or from the default system memory
+ * allocator when none is set. Setting an fd-backed allocator that can
+ * allocate memory, such as the shm allocator from the allocators library,
+ * makes the pool produce buffers that can be shared with other processes or
+ * imported by fd-capable consumers without a copy.
  */
 
 /**
@@ -100,8 +115,25 @@ struct _GstVideoBufferPoolPrivate
   gboolean need_alignment;
   GstAllocator *allocator;
   GstAllocationParams params;
+  gboolean huge_pages;
+  gboolean first_touch;
+  guint max_buffers;
+
+  /* buffers allocated by the prefill option, with the object lock */
+  gboolean prefill;
+  GQueue prefilled;
+
+  /* statistics, hits and misses are atomic, the rest with the object lock */
+  gint acquired;
+  gint misses;
+  guint waits;
+  GstClockTime wait_time;
 };
 
+/* the pool that is acquiring a buffer in this thread, so that alloc can
+ * count the misses */
+static GPrivate acquiring_pool;
+
 static void gst_video_buffer_pool_finalize (GObject * object);
 
 #define GST_VIDEO_BUFFER_POOL_GET_PRIVATE(obj)  \
@@ -114,11 +146,48 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    GST_BUFFER_POOL_OPTION_VIDEO_FIRST_TOUCH,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFILL, NULL
   };
   return options;
 }
 
+static void
+video_buffer_pool_clear_prefilled (GstVideoBufferPool * vpool)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  GstBuffer *buffer;
+
+  GST_OBJECT_LOCK (vpool);
+  while ((buffer = g_queue_pop_head (&priv->prefilled)))
+    gst_buffer_unref (buffer);
+  GST_OBJECT_UNLOCK (vpool);
+}
+
+static GstBuffer *video_buffer_pool_new_buffer (GstVideoBufferPool * vpool);
+
+static void
+video_buffer_pool_prefill (GstVideoBufferPool * vpool, guint n_buffers)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  GstBuffer *buffer;
+  guint i;
+
+  GST_DEBUG_OBJECT (vpool, "prefilling %u buffers", n_buffers);
+
+  for (i = 0; i < n_buffers; i++) {
+    if (!(buffer = video_buffer_pool_new_buffer (vpool))) {
+      GST_WARNING_OBJECT (vpool, "prefill stopped after %u buffers", i);
+      break;
+    }
+    GST_OBJECT_LOCK (vpool);
+    g_queue_push_tail (&priv->prefilled, buffer);
+    GST_OBJECT_UNLOCK (vpool);
+  }
+}
+
 static gboolean
 video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
 {
@@ -131,6 +200,9 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   GstAllocator *allocator;
   GstAllocationParams params;
 
+  /* the old buffers don't match the new config */
+  video_buffer_pool_clear_prefilled (vpool);
+
   if (!gst_buffer_pool_config_get_params (config, &caps, &size, &min_buffers,
           &max_buffers))
     goto wrong_config;
@@ -148,6 +220,11 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   if (!gst_buffer_pool_config_get_allocator (config, &allocator, &params))
     goto wrong_config;
 
+  /* allocators that only wrap existing memory can't be used to allocate */
+  if (allocator && GST_OBJECT_FLAG_IS_SET (allocator,
+          GST_ALLOCATOR_FLAG_CUSTOM_ALLOC))
+    goto wrong_allocator;
+
   width = info.width;
   height = info.height;
 
@@ -168,6 +245,21 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
       gst_buffer_pool_config_has_option (config,
       GST_BUFFER_POOL_OPTION_VIDEO_META);
 
+  /* huge pages only make sense when we allocate the system memory */
+  priv->huge_pages = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  if (priv->huge_pages && allocator
+      && g_strcmp0 (allocator->mem_type, GST_ALLOCATOR_SYSMEM) != 0) {
+    GST_DEBUG_OBJECT (pool, "ignoring huge pages for allocator %"
+        GST_PTR_FORMAT, allocator);
+    priv->huge_pages = FALSE;
+  }
+  priv->first_touch = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_FIRST_TOUCH);
+  priv->prefill = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFILL);
+  priv->max_buffers = max_buffers;
+
   /* parse extra alignment info */
   priv->need_alignment = gst_buffer_pool_config_has_option (config,
       GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
@@ -203,7 +295,20 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   gst_buffer_pool_config_set_params (config, caps, info.size, min_buffers,
       max_buffers);
 
-  return GST_BUFFER_POOL_CLASS (parent_class)->set_config (pool, config);
+  if (!GST_BUFFER_POOL_CLASS (parent_class)->set_config (pool, config))
+    return FALSE;
+
+  GST_OBJECT_LOCK (pool);
+  g_atomic_int_set (&priv->acquired, 0);
+  g_atomic_int_set (&priv->misses, 0);
+  priv->waits = 0;
+  priv->wait_time = 0;
+  GST_OBJECT_UNLOCK (pool);
+
+  if (priv->prefill)
+    video_buffer_pool_prefill (vpool, max_buffers ? max_buffers : min_buffers);
+
+  return TRUE;
 
   /* ERRORS */
 wrong_config:
@@ -229,33 +334,155 @@ wrong_size:
     return FALSE;
 
   }
+wrong_allocator:
+  {
+    GST_WARNING_OBJECT (pool, "allocator %" GST_PTR_FORMAT " can't allocate "
+        "memory", allocator);
+    return FALSE;
+  }
 }
 
-static GstFlowReturn
-video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
-    GstBufferPoolAcquireParams * params)
+#if defined(HAVE_MMAP) && defined(MADV_HUGEPAGE)
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+typedef struct
+{
+  gpointer data;
+  gsize size;
+} HugePageMapping;
+
+static void
+huge_page_mapping_free (HugePageMapping * mapping)
+{
+  munmap (mapping->data, mapping->size);
+  g_slice_free (HugePageMapping, mapping);
+}
+
+/* allocate memory aligned to and sized in huge pages so that the kernel can
+ * back it with transparent huge pages */
+static GstMemory *
+video_buffer_pool_alloc_huge_pages (gsize size, GstAllocationParams * params)
+{
+  HugePageMapping *mapping;
+  guint8 *base, *data;
+  gsize align, maxsize, mapsize, head, tail, offset;
+
+  align = params->align | gst_memory_alignment;
+  maxsize = GST_ROUND_UP_N (size + params->prefix + params->padding + align,
+      HUGE_PAGE_SIZE);
+
+  /* map an extra huge page so we can cut out an aligned region */
+  mapsize = maxsize + HUGE_PAGE_SIZE;
+  base = mmap (NULL, mapsize, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED)
+    return NULL;
+
+  data = (guint8 *) GST_ROUND_UP_N ((guintptr) base, HUGE_PAGE_SIZE);
+  head = data - base;
+  tail = mapsize - head - maxsize;
+  if (head)
+    munmap (base, head);
+  if (tail)
+    munmap (data + maxsize, tail);
+
+  if (madvise (data, maxsize, MADV_HUGEPAGE) < 0)
+    GST_DEBUG ("transparent huge pages not available");
+
+  mapping = g_slice_new (HugePageMapping);
+  mapping->data = data;
+  mapping->size = maxsize;
+
+  /* data is page aligned, so aligning the prefix aligns the memory. Anonymous
+   * mappings are zero filled, prefix and padding are zeroed */
+  offset = (params->prefix + align) & ~align;
+
+  return gst_memory_new_wrapped (0, data, maxsize, offset, size, mapping,
+      (GDestroyNotify) huge_page_mapping_free);
+}
+#endif
+
+/* write to every page of the buffer so that it gets placed on the NUMA
+ * node of the current thread */
+static void
+video_buffer_pool_touch (GstBuffer * buffer)
+{
+  GstMapInfo map;
+  gsize i;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_WRITE))
+    return;
+
+  for (i = 0; i < map.size; i += 4096)
+    map.data[i] = 0;
+  if (map.size)
+    map.data[map.size - 1] = 0;
+
+  gst_buffer_unmap (buffer, &map);
+}
+
+static GstBuffer *
+video_buffer_pool_new_buffer (GstVideoBufferPool * vpool)
 {
-  GstVideoBufferPool *vpool = GST_VIDEO_BUFFER_POOL_CAST (pool);
   GstVideoBufferPoolPrivate *priv = vpool->priv;
   GstVideoInfo *info;
+  GstBuffer *buffer = NULL;
 
   info = &priv->info;
 
-  GST_DEBUG_OBJECT (pool, "alloc %" G_GSIZE_FORMAT, info->size);
+  GST_DEBUG_OBJECT (vpool, "alloc %" G_GSIZE_FORMAT, info->size);
+
+#if defined(HAVE_MMAP) && defined(MADV_HUGEPAGE)
+  if (priv->huge_pages) {
+    GstMemory *mem;
 
-  *buffer =
-      gst_buffer_new_allocate (priv->allocator, info->size, &priv->params);
-  if (*buffer == NULL)
-    goto no_memory;
+    if ((mem = video_buffer_pool_alloc_huge_pages (info->size, &priv->params))) {
+      buffer = gst_buffer_new ();
+      gst_buffer_append_memory (buffer, mem);
+    } else {
+      GST_DEBUG_OBJECT (vpool, "huge page allocation failed");
+    }
+  }
+#endif
+  if (buffer == NULL)
+    buffer = gst_buffer_new_allocate (priv->allocator, info->size,
+        &priv->params);
+  if (buffer == NULL)
+    return NULL;
+
+  if (priv->first_touch)
+    video_buffer_pool_touch (buffer);
 
   if (priv->add_videometa) {
-    GST_DEBUG_OBJECT (pool, "adding GstVideoMeta");
+    GST_DEBUG_OBJECT (vpool, "adding GstVideoMeta");
 
-    gst_buffer_add_video_meta_full (*buffer, GST_VIDEO_FRAME_FLAG_NONE,
+    gst_buffer_add_video_meta_full (buffer, GST_VIDEO_FRAME_FLAG_NONE,
         GST_VIDEO_INFO_FORMAT (info),
         GST_VIDEO_INFO_WIDTH (info), GST_VIDEO_INFO_HEIGHT (info),
         GST_VIDEO_INFO_N_PLANES (info), info->offset, info->stride);
   }
+  return buffer;
+}
+
+static GstFlowReturn
+video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
+    GstBufferPoolAcquireParams * params)
+{
+  GstVideoBufferPool *vpool = GST_VIDEO_BUFFER_POOL_CAST (pool);
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+
+  GST_OBJECT_LOCK (pool);
+  *buffer = g_queue_pop_head (&priv->prefilled);
+  GST_OBJECT_UNLOCK (pool);
+
+  if (*buffer == NULL) {
+    /* only real allocations while acquiring are misses */
+    if (g_private_get (&acquiring_pool) == pool)
+      g_atomic_int_inc (&priv->misses);
+
+    if (!(*buffer = video_buffer_pool_new_buffer (vpool)))
+      goto no_memory;
+  }
 
   return GST_FLOW_OK;
 
@@ -267,6 +494,98 @@ no_memory:
   }
 }
 
+static GstFlowReturn
+video_buffer_pool_acquire (GstBufferPool * pool, GstBuffer ** buffer,
+    GstBufferPoolAcquireParams * params)
+{
+  GstVideoBufferPool *vpool = GST_VIDEO_BUFFER_POOL_CAST (pool);
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  GstBufferPoolAcquireParams try_params = { 0, };
+  GstFlowReturn ret;
+  gpointer old;
+
+  if (params)
+    try_params = *params;
+
+  old = g_private_get (&acquiring_pool);
+  g_private_set (&acquiring_pool, pool);
+
+  /* first try without waiting so that we know when we have to wait */
+  try_params.flags |= GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+  ret = GST_BUFFER_POOL_CLASS (parent_class)->acquire_buffer (pool, buffer,
+      &try_params);
+
+  if (ret == GST_FLOW_EOS && priv->max_buffers > 0 &&
+      !(params && (params->flags & GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT))) {
+    GstClockTime start = gst_util_get_timestamp ();
+
+    GST_LOG_OBJECT (pool, "pool is exhausted, waiting for a buffer");
+
+    try_params.flags &= ~GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+    ret = GST_BUFFER_POOL_CLASS (parent_class)->acquire_buffer (pool, buffer,
+        &try_params);
+
+    GST_OBJECT_LOCK (pool);
+    priv->waits++;
+    priv->wait_time += gst_util_get_timestamp () - start;
+    GST_OBJECT_UNLOCK (pool);
+  }
+  g_private_set (&acquiring_pool, old);
+
+  if (ret == GST_FLOW_OK)
+    g_atomic_int_inc (&priv->acquired);
+
+  return ret;
+}
+
+/**
+ * gst_video_buffer_pool_get_stats:
+ * @pool: a #GstVideoBufferPool
+ *
+ * Get the statistics of @pool since its config was last set, to help sizing
+ * the pool. The structure has the following fields:
+ *
+ * "hits" G_TYPE_UINT: the number of acquired buffers that were already
+ * allocated, by the pool or with #GST_BUFFER_POOL_OPTION_VIDEO_PREFILL.
+ *
+ * "misses" G_TYPE_UINT: the number of acquired buffers that had to be
+ * allocated.
+ *
+ * "waits" G_TYPE_UINT: the number of times an acquire had to wait for a
+ * buffer to be released because the pool had max-buffers buffers out.
+ *
+ * "wait-time" G_TYPE_UINT64: the total time spent waiting in those
+ * acquires, in nanoseconds.
+ *
+ * Returns: (transfer full): a new #GstStructure, free with
+ *     gst_structure_free()
+ *
+ * Since: 1.10
+ */
+GstStructure *
+gst_video_buffer_pool_get_stats (GstVideoBufferPool * pool)
+{
+  GstVideoBufferPoolPrivate *priv;
+  GstStructure *stats;
+  guint acquired, misses;
+
+  g_return_val_if_fail (GST_IS_VIDEO_BUFFER_POOL (pool), NULL);
+
+  priv = pool->priv;
+
+  GST_OBJECT_LOCK (pool);
+  acquired = g_atomic_int_get (&priv->acquired);
+  misses = g_atomic_int_get (&priv->misses);
+  stats = gst_structure_new ("GstVideoBufferPoolStats",
+      "hits", G_TYPE_UINT, acquired > misses ? acquired - misses : 0,
+      "misses", G_TYPE_UINT, misses,
+      "waits", G_TYPE_UINT, priv->waits,
+      "wait-time", G_TYPE_UINT64, (guint64) priv->wait_time, NULL);
+  GST_OBJECT_UNLOCK (pool);
+
+  return stats;
+}
+
 /**
  * gst_video_buffer_pool_new:
  *
@@ -300,6 +619,7 @@ gst_video_buffer_pool_class_init (GstVideoBufferPoolClass * klass)
   gstbufferpool_class->get_options = video_buffer_pool_get_options;
   gstbufferpool_class->set_config = video_buffer_pool_set_config;
   gstbufferpool_class->alloc_buffer = video_buffer_pool_alloc;
+  gstbufferpool_class->acquire_buffer = video_buffer_pool_acquire;
 
   GST_DEBUG_CATEGORY_INIT (gst_video_pool_debug, "videopool", 0,
       "videopool object");
@@ -309,6 +629,7 @@ static void
 gst_video_buffer_pool_init (GstVideoBufferPool * pool)
 {
   pool->priv = GST_VIDEO_BUFFER_POOL_GET_PRIVATE (pool);
+  g_queue_init (&pool->priv->prefilled);
 }
 
 static void
@@ -319,6 +640,8 @@ gst_video_buffer_pool_finalize (GObject * object)
 
   GST_LOG_OBJECT (pool, "finalize video buffer pool %p", pool);
 
+  video_buffer_pool_clear_prefilled (pool);
+
   if (priv->caps)
     gst_caps_unref (priv->caps);
 
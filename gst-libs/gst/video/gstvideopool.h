@@ -45,6 +45,43 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES:
+ *
+ * A bufferpool option to allocate frames from 2MB aligned memory that is
+ * eligible for transparent huge pages. This reduces TLB pressure for large
+ * frames. The option is only used when the pool allocates system memory.
+ * For explicit huge pages, configure a shm allocator created with
+ * %GST_SHM_ALLOCATOR_FLAG_HUGETLB instead.
+ *
+ * Since: 1.10
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES "GstBufferPoolOptionVideoHugePages"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_FIRST_TOUCH:
+ *
+ * A bufferpool option to write to every page of newly allocated frames
+ * from the allocating thread. With the default first-touch NUMA policy
+ * this places the memory on the node of the thread that allocates the
+ * buffers, which should be the thread that processes them, instead of on
+ * the node of the first thread that happens to write to the frame.
+ *
+ * Since: 1.10
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_FIRST_TOUCH "GstBufferPoolOptionVideoFirstTouch"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_PREFILL:
+ *
+ * A bufferpool option to allocate all the frames of the pool when the
+ * config is set, max-buffers frames or min-buffers frames when there is no
+ * maximum. The pool then doesn't need to allocate memory while streaming.
+ *
+ * Since: 1.10
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_PREFILL "GstBufferPoolOptionVideoPrefill"
+
 /* setting a bufferpool config */
 void             gst_buffer_pool_config_set_video_alignment  (GstStructure *config, GstVideoAlignment *align);
 gboolean         gst_buffer_pool_config_get_video_alignment  (GstStructure *config, GstVideoAlignment *align);
@@ -75,6 +112,8 @@ GType             gst_video_buffer_pool_get_type      (void);
 
 GstBufferPool *   gst_video_buffer_pool_new           (void);
 
+GstStructure *    gst_video_buffer_pool_get_stats     (GstVideoBufferPool *pool);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoBufferPool, gst_object_unref)
 #endif
@@ -23,6 +23,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <gst/video/video.h>
 #include "gstvideoutilsprivate.h"
 
@@ -144,3 +146,188 @@ done:
 
   return fcaps;
 }
+
+void
+__gst_video_codec_frame_queue_init (GstVideoCodecFrameQueue * queue)
+{
+  g_queue_init (&queue->queue);
+  queue->index = g_hash_table_new (NULL, NULL);
+}
+
+void
+__gst_video_codec_frame_queue_free (GstVideoCodecFrameQueue * queue)
+{
+  __gst_video_codec_frame_queue_clear (queue);
+  g_hash_table_unref (queue->index);
+  queue->index = NULL;
+}
+
+/* unrefs all frames */
+void
+__gst_video_codec_frame_queue_clear (GstVideoCodecFrameQueue * queue)
+{
+  g_queue_foreach (&queue->queue, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&queue->queue);
+  g_hash_table_remove_all (queue->index);
+}
+
+/* takes ownership of @frame */
+void
+__gst_video_codec_frame_queue_push (GstVideoCodecFrameQueue * queue,
+    GstVideoCodecFrame * frame)
+{
+  g_queue_push_tail (&queue->queue, frame);
+  g_hash_table_insert (queue->index,
+      GUINT_TO_POINTER (frame->system_frame_number), queue->queue.tail);
+}
+
+/* removes @frame without unreffing it, returns %FALSE when @frame is
+ * not in @queue */
+gboolean
+__gst_video_codec_frame_queue_remove (GstVideoCodecFrameQueue * queue,
+    GstVideoCodecFrame * frame)
+{
+  gpointer key = GUINT_TO_POINTER (frame->system_frame_number);
+  GList *link;
+
+  link = g_hash_table_lookup (queue->index, key);
+  if (link && link->data == frame) {
+    g_hash_table_remove (queue->index, key);
+  } else {
+    /* not indexed, the subclass reused a frame number */
+    link = g_queue_find (&queue->queue, frame);
+    if (link == NULL)
+      return FALSE;
+  }
+  g_queue_delete_link (&queue->queue, link);
+
+  return TRUE;
+}
+
+/* returns a borrowed frame */
+GstVideoCodecFrame *
+__gst_video_codec_frame_queue_lookup (GstVideoCodecFrameQueue * queue,
+    guint32 frame_number)
+{
+  GList *link;
+
+  link = g_hash_table_lookup (queue->index, GUINT_TO_POINTER (frame_number));
+
+  return link ? link->data : NULL;
+}
+
+void
+__gst_video_codec_stats_reset (GstVideoCodecStats * stats)
+{
+  memset (stats, 0, sizeof (GstVideoCodecStats));
+}
+
+static void
+stats_update_max (volatile gint * max, gint val)
+{
+  gint old;
+
+  do {
+    old = g_atomic_int_get (max);
+    if (val <= old)
+      break;
+  } while (!g_atomic_int_compare_and_exchange (max, old, val));
+}
+
+static void
+stats_time_add (GstVideoCodecStatsTime * time, gint64 elapsed)
+{
+  gint val = MIN (elapsed, G_MAXINT);
+
+  g_atomic_int_inc (&time->count);
+  g_atomic_pointer_add (&time->total, (gssize) elapsed);
+  stats_update_max (&time->max, val);
+}
+
+void
+__gst_video_codec_stats_frame_in (GstVideoCodecStats * stats,
+    GstVideoCodecFrame * frame, guint queue_depth)
+{
+  frame->abidata.ABI.in_time = g_get_monotonic_time ();
+
+  g_atomic_int_inc (&stats->frames_in);
+  stats_update_max (&stats->max_queue_depth, MIN (queue_depth, G_MAXINT));
+}
+
+void
+__gst_video_codec_stats_frame_out (GstVideoCodecStats * stats,
+    GstVideoCodecFrame * frame)
+{
+  gint64 elapsed;
+  guint i;
+
+  /* not counted when it entered, or already counted */
+  if (frame->abidata.ABI.in_time <= 0)
+    return;
+
+  elapsed = g_get_monotonic_time () - frame->abidata.ABI.in_time;
+  frame->abidata.ABI.in_time = 0;
+
+  g_atomic_int_inc (&stats->frames_out);
+  stats_time_add (&stats->latency, elapsed);
+
+  for (i = 0; i < GST_VIDEO_CODEC_STATS_BUCKETS - 1; i++)
+    if (elapsed < (G_GINT64_CONSTANT (1000) << i))
+      break;
+  g_atomic_int_inc (&stats->histogram[i]);
+}
+
+void
+__gst_video_codec_stats_add_time (GstVideoCodecStatsTime * time, gint64 start)
+{
+  stats_time_add (time, g_get_monotonic_time () - start);
+}
+
+static void
+stats_time_set (GstStructure * s, const gchar * avg_name,
+    const gchar * max_name, GstVideoCodecStatsTime * time)
+{
+  gint count = g_atomic_int_get (&time->count);
+  gssize total = (gssize) g_atomic_pointer_get (&time->total);
+  guint64 avg = count ? (guint64) total * GST_USECOND / count : 0;
+
+  gst_structure_set (s, avg_name, G_TYPE_UINT64, avg,
+      max_name, G_TYPE_UINT64,
+      (guint64) g_atomic_int_get (&time->max) * GST_USECOND, NULL);
+}
+
+/* times are converted to nanoseconds */
+GstStructure *
+__gst_video_codec_stats_to_structure (GstVideoCodecStats * stats,
+    const gchar * name, guint queue_depth)
+{
+  GValue histogram = G_VALUE_INIT;
+  GValue v = G_VALUE_INIT;
+  GstStructure *s;
+  guint i;
+
+  s = gst_structure_new (name,
+      "frames-in", G_TYPE_UINT, (guint) g_atomic_int_get (&stats->frames_in),
+      "frames-out", G_TYPE_UINT, (guint) g_atomic_int_get (&stats->frames_out),
+      "frames-dropped", G_TYPE_UINT,
+      (guint) g_atomic_int_get (&stats->frames_dropped),
+      "queue-depth", G_TYPE_UINT, queue_depth,
+      "max-queue-depth", G_TYPE_UINT,
+      (guint) g_atomic_int_get (&stats->max_queue_depth), NULL);
+
+  stats_time_set (s, "latency-average", "latency-max", &stats->latency);
+  stats_time_set (s, "handle-frame-average", "handle-frame-max",
+      &stats->handle_frame);
+  stats_time_set (s, "allocation-average", "allocation-max", &stats->alloc);
+
+  g_value_init (&histogram, GST_TYPE_ARRAY);
+  g_value_init (&v, G_TYPE_UINT);
+  for (i = 0; i < GST_VIDEO_CODEC_STATS_BUCKETS; i++) {
+    g_value_set_uint (&v, g_atomic_int_get (&stats->histogram[i]));
+    gst_value_array_append_value (&histogram, &v);
+  }
+  gst_structure_take_value (s, "latency-histogram", &histogram);
+  g_value_unset (&v);
+
+  return s;
+}
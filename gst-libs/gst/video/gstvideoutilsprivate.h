@@ -36,6 +36,87 @@ GstCaps *__gst_video_element_proxy_getcaps (GstElement * element, GstPad * sinkp
                                             GstPad * srcpad, GstCaps * initial_caps,
                                             GstCaps * filter);
 
+/* Pending codec frames in decoding order, indexed by system_frame_number */
+typedef struct
+{
+  GQueue queue;
+  GHashTable *index;
+} GstVideoCodecFrameQueue;
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_queue_init (GstVideoCodecFrameQueue * queue);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_queue_free (GstVideoCodecFrameQueue * queue);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_queue_clear (GstVideoCodecFrameQueue * queue);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_queue_push (GstVideoCodecFrameQueue * queue,
+                                         GstVideoCodecFrame * frame);
+
+G_GNUC_INTERNAL
+gboolean __gst_video_codec_frame_queue_remove (GstVideoCodecFrameQueue * queue,
+                                               GstVideoCodecFrame * frame);
+
+G_GNUC_INTERNAL
+GstVideoCodecFrame *__gst_video_codec_frame_queue_lookup (GstVideoCodecFrameQueue * queue,
+                                                          guint32 frame_number);
+
+/* Frame timing statistics of the codec base classes. Everything is updated
+ * with atomic operations so that the streaming and frame threads don't need
+ * a lock, times are in microseconds */
+#define GST_VIDEO_CODEC_STATS_BUCKETS 12
+
+typedef struct
+{
+  volatile gint count;
+  volatile gssize total;
+  volatile gint max;
+} GstVideoCodecStatsTime;
+
+typedef struct
+{
+  volatile gint frames_in;
+  volatile gint frames_out;
+  volatile gint frames_dropped;
+  volatile gint max_queue_depth;
+
+  /* from entering the base class until the frame is released */
+  GstVideoCodecStatsTime latency;
+  /* bucket i counts latencies below 2^i ms, the last one all the others */
+  volatile gint histogram[GST_VIDEO_CODEC_STATS_BUCKETS];
+
+  GstVideoCodecStatsTime handle_frame;
+  GstVideoCodecStatsTime alloc;
+} GstVideoCodecStats;
+
+G_GNUC_INTERNAL
+void __gst_video_codec_stats_reset (GstVideoCodecStats * stats);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_stats_frame_in (GstVideoCodecStats * stats,
+                                       GstVideoCodecFrame * frame,
+                                       guint queue_depth);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_stats_frame_out (GstVideoCodecStats * stats,
+                                        GstVideoCodecFrame * frame);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_stats_add_time (GstVideoCodecStatsTime * time,
+                                       gint64 start);
+
+G_GNUC_INTERNAL
+GstStructure *__gst_video_codec_stats_to_structure (GstVideoCodecStats * stats,
+                                                    const gchar * name,
+                                                    guint queue_depth);
+
+/* Video meta utility functions */
+G_GNUC_INTERNAL
+gboolean __gst_video_meta_has_default_map (GstVideoMeta * meta);
+
 G_END_DECLS
 
 #endif
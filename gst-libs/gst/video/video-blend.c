@@ -273,6 +273,183 @@ G_STMT_START { \
 } G_STMT_END
 
 
+/* x / 255 for x in 0..65025 */
+#define DIV255(x) (((x) + 1 + ((x) >> 8)) >> 8)
+
+/* blend non-premultiplied AYUV directly into the planes of 8 bits 4:2:0
+ * formats. This gives the same result as unpacking, blending and packing
+ * the destination lines: the destination is opaque and the chroma of a
+ * 2x2 block is blended with the top-left source pixel. The loops are
+ * kept free of branches so that the compiler can vectorize them. */
+static void
+blend_line_luma (guint8 * d, const guint8 * s, gint width, gint alpha)
+{
+  gint j;
+
+  for (j = 0; j < width; j++) {
+    gint a = DIV255 (s[j * 4] * alpha);
+
+    d[j] = DIV255 (s[j * 4 + 1] * a + d[j] * (255 - a));
+  }
+}
+
+static void
+blend_line_chroma (guint8 * du, guint8 * dv, gint pstride, const guint8 * s,
+    gint width, gint alpha)
+{
+  gint j;
+
+  for (j = 0; j < width; j++) {
+    gint a = DIV255 (s[j * 8] * alpha);
+
+    du[j * pstride] = DIV255 (s[j * 8 + 2] * a + du[j * pstride] * (255 - a));
+    dv[j * pstride] = DIV255 (s[j * 8 + 3] * a + dv[j * pstride] * (255 - a));
+  }
+}
+
+typedef struct _BlendBands BlendBands;
+
+typedef struct
+{
+  BlendBands *bands;
+  GstVideoFrame *dest;
+  GstVideoFrame *src;
+  gint x, y;
+  gint src_xoff, src_yoff;
+  gint width;
+  gint y_start, y_end;
+  gint alpha;
+} BlendTask;
+
+static void
+blend_ayuv_420 (BlendTask * task)
+{
+  GstVideoFrame *dest = task->dest, *src = task->src;
+  gint i, cx, cwidth, pstride;
+
+  /* first chroma sample that is covered by the source */
+  cx = GST_ROUND_UP_2 (task->x);
+  cwidth = (task->x + task->width - cx + 1) / 2;
+  pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (dest, 1);
+
+  for (i = task->y_start; i < task->y_end; i++) {
+    const guint8 *s;
+    guint8 *d;
+
+    s = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (src, 0) +
+        (task->src_yoff + i - task->y) * GST_VIDEO_FRAME_PLANE_STRIDE (src, 0)
+        + task->src_xoff * 4;
+    d = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 0) +
+        i * GST_VIDEO_FRAME_COMP_STRIDE (dest, 0) + task->x;
+
+    blend_line_luma (d, s, task->width, task->alpha);
+
+    if ((i & 1) == 0 && cwidth > 0) {
+      guint8 *du, *dv;
+
+      du = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 1) +
+          (i >> 1) * GST_VIDEO_FRAME_COMP_STRIDE (dest, 1) +
+          (cx >> 1) * pstride;
+      dv = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 2) +
+          (i >> 1) * GST_VIDEO_FRAME_COMP_STRIDE (dest, 2) +
+          (cx >> 1) * pstride;
+
+      blend_line_chroma (du, dv, pstride, s + (cx - task->x) * 4, cwidth,
+          task->alpha);
+    }
+  }
+}
+
+/* split big rectangles in bands of rows over some threads, a band always
+ * starts on an even line so that the chroma lines are not shared */
+#define BLEND_THREAD_MIN_PIXELS (256 * 1024)
+#define BLEND_BAND_MIN_LINES 16
+
+struct _BlendBands
+{
+  GMutex lock;
+  GCond cond;
+  gint pending;
+};
+
+static void
+blend_band_func (BlendTask * task, gpointer user_data)
+{
+  BlendBands *bands = task->bands;
+
+  blend_ayuv_420 (task);
+
+  g_mutex_lock (&bands->lock);
+  if (--bands->pending == 0)
+    g_cond_signal (&bands->cond);
+  g_mutex_unlock (&bands->lock);
+}
+
+static GThreadPool *
+get_blend_pool (void)
+{
+  static volatile gsize pool = 0;
+
+  if (g_once_init_enter (&pool)) {
+    GThreadPool *p;
+
+    p = g_thread_pool_new ((GFunc) blend_band_func, NULL,
+        g_get_num_processors (), FALSE, NULL);
+    g_once_init_leave (&pool, (gsize) p);
+  }
+  return (GThreadPool *) pool;
+}
+
+static void
+blend_ayuv_420_bands (BlendTask * task)
+{
+  BlendTask *tasks;
+  BlendBands bands;
+  gint i, n_bands, band_height, n_threads;
+
+  n_threads = g_get_num_processors ();
+  if (n_threads < 2 || task->width * (task->y_end - task->y_start) <
+      BLEND_THREAD_MIN_PIXELS) {
+    blend_ayuv_420 (task);
+    return;
+  }
+
+  band_height = (task->y_end - task->y_start + n_threads - 1) / n_threads;
+  band_height = GST_ROUND_UP_2 (MAX (band_height, BLEND_BAND_MIN_LINES));
+
+  tasks = g_newa (BlendTask, n_threads + 1);
+  n_bands = 0;
+  for (i = task->y_start; i < task->y_end; n_bands++) {
+    gint end = MIN (GST_ROUND_DOWN_2 (i + band_height), task->y_end);
+
+    tasks[n_bands] = *task;
+    tasks[n_bands].bands = &bands;
+    tasks[n_bands].y_start = i;
+    tasks[n_bands].y_end = end;
+    i = end;
+  }
+
+  GST_LOG ("blend in %d bands", n_bands);
+
+  g_mutex_init (&bands.lock);
+  g_cond_init (&bands.cond);
+  bands.pending = n_bands - 1;
+
+  /* the first band runs in this thread */
+  for (i = 1; i < n_bands; i++)
+    g_thread_pool_push (get_blend_pool (), &tasks[i], NULL);
+
+  blend_ayuv_420 (&tasks[0]);
+
+  g_mutex_lock (&bands.lock);
+  while (bands.pending > 0)
+    g_cond_wait (&bands.cond, &bands.lock);
+  g_mutex_unlock (&bands.lock);
+
+  g_mutex_clear (&bands.lock);
+  g_cond_clear (&bands.cond);
+}
+
 /**
  * gst_video_blend:
  * @dest: The #GstVideoFrame where to blend @src in
@@ -380,6 +557,28 @@ gst_video_blend (GstVideoFrame * dest,
   if (y + src_height > dest_height)
     src_height = dest_height - y;
 
+  if (GST_VIDEO_FRAME_FORMAT (src) == GST_VIDEO_FORMAT_AYUV &&
+      !src_premultiplied_alpha && !dest_premultiplied_alpha) {
+    switch (GST_VIDEO_FRAME_FORMAT (dest)) {
+      case GST_VIDEO_FORMAT_I420:
+      case GST_VIDEO_FORMAT_YV12:
+      case GST_VIDEO_FORMAT_NV12:
+      case GST_VIDEO_FORMAT_NV21:
+      {
+        BlendTask task = { NULL, dest, src, x, y, src_xoff, src_yoff,
+          src_width, y, y + src_height, global_alpha_val
+        };
+
+        GST_LOG ("blend AYUV directly into %s",
+            gst_video_format_to_string (GST_VIDEO_FRAME_FORMAT (dest)));
+        blend_ayuv_420_bands (&task);
+        goto done;
+      }
+      default:
+        break;
+    }
+  }
+
   /* Mainloop doing the needed conversions, and blending */
   for (i = y; i < y + src_height; i++, src_yoff++) {
 
@@ -454,6 +653,7 @@ gst_video_blend (GstVideoFrame * dest,
         dest->data, dest->info.stride, dest->info.chroma_site, i, dest_width);
   }
 
+done:
   g_free (tmpdestline);
   g_free (tmpsrcline);
 
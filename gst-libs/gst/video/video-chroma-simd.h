@@ -0,0 +1,209 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the 2x horizontal chroma filters that are not done with
+ * orc. They work on a vector of 4 AYUV or 2 AYUV64 pixels at a time and only
+ * replace the chroma components of the pixels the C loop would write. They
+ * give exactly the same results as the C loops and return the index of the
+ * first pixel they did not do, the caller does the remainder.
+ *
+ * The filters with rounding are made from averages, which round up, and a
+ * correction of the lowest bit:
+ *
+ *   (3*a + b + 2) >> 2      = avg (a, x) - ((a ^ b) & (a ^ x) & 1)
+ *   (a + 2*b + c + 2) >> 2  = avg (b, y) - ((a ^ c) & (b ^ y) & 1)
+ *
+ * with x = avg (a, b) and y = avg (a, c), so that all the math is done with
+ * the width of the components. */
+
+#if defined (__SSE2__)
+#define HAVE_VIDEO_CHROMA_SIMD
+#include <emmintrin.h>
+
+/* the chroma components of all the pixels */
+#define CHROMA_MASK_U8     _mm_set1_epi32 (0xffff0000)
+#define CHROMA_MASK_U16    _mm_set_epi32 (-1, 0, -1, 0)
+/* the chroma components of the even pixels */
+#define CHROMA_MASK_U8_0   _mm_set_epi32 (0, 0xffff0000, 0, 0xffff0000)
+#define CHROMA_MASK_U16_0  _mm_set_epi32 (0, 0, -1, 0)
+
+/* pixels have 4 components */
+#define LOAD_PIXELS(p,i) \
+    _mm_loadu_si128 ((const __m128i *) ((p) + (i) * 4))
+#define STORE_PIXELS(p,i,v) \
+    _mm_storeu_si128 ((__m128i *) ((p) + (i) * 4), v)
+
+static inline __m128i
+blend_chroma (__m128i orig, __m128i v, __m128i mask)
+{
+  return _mm_or_si128 (_mm_and_si128 (mask, v), _mm_andnot_si128 (mask, orig));
+}
+
+#define MAKE_FILT_SIMD(name,avg,sub,one)                                \
+static inline __m128i                                                   \
+filt_3_1_##name (__m128i a, __m128i b)                                  \
+{                                                                       \
+  __m128i x = avg (a, b);                                               \
+  __m128i c = _mm_and_si128 (_mm_and_si128 (_mm_xor_si128 (a, b),       \
+          _mm_xor_si128 (a, x)), one);                                  \
+  return sub (avg (a, x), c);                                           \
+}                                                                       \
+static inline __m128i                                                   \
+filt_1_2_1_##name (__m128i a, __m128i b, __m128i c)                     \
+{                                                                       \
+  __m128i y = avg (a, c);                                               \
+  __m128i d = _mm_and_si128 (_mm_and_si128 (_mm_xor_si128 (a, c),       \
+          _mm_xor_si128 (b, y)), one);                                  \
+  return sub (avg (b, y), d);                                           \
+}
+
+MAKE_FILT_SIMD (u8, _mm_avg_epu8, _mm_sub_epi8, _mm_set1_epi8 (1))
+MAKE_FILT_SIMD (u16, _mm_avg_epu16, _mm_sub_epi16, _mm_set1_epi16 (1))
+
+/* the odd pixels i are made from the original even pixels e0 = i - 1 and
+ * e1 = i + 1, the even pixels that are written are needed for the next
+ * pixel so the last one is kept in e0v. On return, tr and tb have the chroma
+ * of this pixel. */
+static gint
+video_chroma_up_h2_u8_simd (guint8 * p, gint width, guint8 * tr, guint8 * tb)
+{
+  __m128i e0v = _mm_cvtsi32_si128 (GST_READ_UINT32_LE (p));
+  gint i, e0;
+
+  for (i = 1; i + 4 < width; i += 4) {
+    /* e1 x e2 x */
+    __m128i m = LOAD_PIXELS (p, i + 1);
+    /* e0 e1 ? e2 */
+    __m128i t = _mm_unpacklo_epi32 (e0v,
+        _mm_shuffle_epi32 (m, _MM_SHUFFLE (2, 2, 2, 0)));
+    __m128i u = _mm_shuffle_epi32 (t, _MM_SHUFFLE (3, 1, 1, 0));
+    __m128i v = _mm_shuffle_epi32 (t, _MM_SHUFFLE (1, 3, 0, 1));
+
+    STORE_PIXELS (p, i, blend_chroma (LOAD_PIXELS (p, i),
+            filt_3_1_u8 (u, v), CHROMA_MASK_U8));
+    e0v = _mm_srli_si128 (m, 8);
+  }
+  e0 = _mm_cvtsi128_si32 (e0v);
+  *tr = e0 >> 16;
+  *tb = e0 >> 24;
+
+  return i;
+}
+
+static gint
+video_chroma_up_h2_u16_simd (guint16 * p, gint width, guint16 * tr,
+    guint16 * tb)
+{
+  __m128i e0v = _mm_loadl_epi64 ((const __m128i *) p);
+  gint i;
+
+  for (i = 1; i + 2 < width; i += 2) {
+    /* e1 x */
+    __m128i m = LOAD_PIXELS (p, i + 1);
+    __m128i u = _mm_unpacklo_epi64 (e0v, m);
+    __m128i v = _mm_unpacklo_epi64 (m, e0v);
+
+    STORE_PIXELS (p, i, blend_chroma (LOAD_PIXELS (p, i),
+            filt_3_1_u16 (u, v), CHROMA_MASK_U16));
+    e0v = m;
+  }
+  *tr = _mm_extract_epi16 (e0v, 2);
+  *tb = _mm_extract_epi16 (e0v, 3);
+
+  return i;
+}
+
+/* the odd pixels are the average of the even pixels around them, which are
+ * not written */
+static gint
+video_chroma_up_h2_cs_u8_simd (guint8 * p, gint width)
+{
+  gint i;
+
+  for (i = 1; i + 4 < width; i += 4) {
+    __m128i v = _mm_avg_epu8 (LOAD_PIXELS (p, i - 1),
+        LOAD_PIXELS (p, i + 1));
+
+    STORE_PIXELS (p, i, blend_chroma (LOAD_PIXELS (p, i), v,
+            CHROMA_MASK_U8_0));
+  }
+  return i;
+}
+
+static gint
+video_chroma_up_h2_cs_u16_simd (guint16 * p, gint width)
+{
+  gint i;
+
+  for (i = 1; i + 2 < width; i += 2) {
+    __m128i v = _mm_avg_epu16 (LOAD_PIXELS (p, i - 1),
+        LOAD_PIXELS (p, i + 1));
+
+    STORE_PIXELS (p, i, blend_chroma (LOAD_PIXELS (p, i), v,
+            CHROMA_MASK_U16_0));
+  }
+  return i;
+}
+
+/* the even pixels are made from the odd pixels next to them, which are not
+ * written */
+static gint
+video_chroma_down_h2_u16_simd (guint16 * p, gint width)
+{
+  gint i;
+
+  for (i = 0; i + 2 < width; i += 2) {
+    __m128i o = LOAD_PIXELS (p, i);
+    __m128i v = _mm_avg_epu16 (o, LOAD_PIXELS (p, i + 1));
+
+    STORE_PIXELS (p, i, blend_chroma (o, v, CHROMA_MASK_U16_0));
+  }
+  return i;
+}
+
+static gint
+video_chroma_down_h2_cs_u8_simd (guint8 * p, gint width)
+{
+  gint i;
+
+  for (i = 2; i + 4 < width; i += 4) {
+    __m128i o = LOAD_PIXELS (p, i);
+    __m128i v = filt_1_2_1_u8 (LOAD_PIXELS (p, i - 1), o,
+        LOAD_PIXELS (p, i + 1));
+
+    STORE_PIXELS (p, i, blend_chroma (o, v, CHROMA_MASK_U8_0));
+  }
+  return i;
+}
+
+static gint
+video_chroma_down_h2_cs_u16_simd (guint16 * p, gint width)
+{
+  gint i;
+
+  for (i = 2; i + 2 < width; i += 2) {
+    __m128i o = LOAD_PIXELS (p, i);
+    __m128i v = filt_1_2_1_u16 (LOAD_PIXELS (p, i - 1), o,
+        LOAD_PIXELS (p, i + 1));
+
+    STORE_PIXELS (p, i, blend_chroma (o, v, CHROMA_MASK_U16_0));
+  }
+  return i;
+}
+#endif
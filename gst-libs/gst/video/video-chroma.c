@@ -26,6 +26,7 @@
 
 #include "video-orc.h"
 #include "video-format.h"
+#include "video-chroma-simd.h"
 
 
 /**
@@ -157,6 +158,23 @@ struct _GstVideoChromaResample
 #define FILT_1_2_3_10(a,b,c,d)      ((a) + 2*(b) + 3*(c) + 10*(d) + 8) >> 16
 #define FILT_1_2_3_4_3_2_1(a,b,c,d,e,f,g) ((a) + 2*((b)+(f)) + 3*((c)+(e)) + 4*(d) + (g) + 8) >> 16
 
+#ifdef HAVE_VIDEO_CHROMA_SIMD
+/* the SIMD horizontal filters do the first pixels, the C loops the rest */
+#define SIMD_UP_H2(name)                                                \
+  i = video_chroma_up_h2_##name##_simd (p, width, &tr1, &tb1);
+#define SIMD_UP_H2_CS(name)                                             \
+  i = video_chroma_up_h2_cs_##name##_simd (p, width);
+#define SIMD_DOWN_H2(name)                                              \
+  i = video_chroma_down_h2_##name##_simd (p, width);
+#define SIMD_DOWN_H2_CS(name)                                           \
+  i = video_chroma_down_h2_cs_##name##_simd (p, width);
+#else
+#define SIMD_UP_H2(name)
+#define SIMD_UP_H2_CS(name)
+#define SIMD_DOWN_H2(name)
+#define SIMD_DOWN_H2_CS(name)
+#endif
+
 /* 2x horizontal upsampling without cositing
  *
  * +----------    a
@@ -179,7 +197,9 @@ video_chroma_up_h2_##name (GstVideoChromaResample *resample,            \
                                                                         \
   tr1 = PR(0);                                                          \
   tb1 = PB(0);                                                          \
-  for (i = 1; i < width - 1; i += 2) {                                  \
+  i = 1;                                                                \
+  SIMD_UP_H2 (name)                                                     \
+  for (; i < width - 1; i += 2) {                                       \
     tr0 = tr1, tr1 = PR(i+1);                                           \
     tb0 = tb1, tb1 = PB(i+1);                                           \
                                                                         \
@@ -300,9 +320,10 @@ video_chroma_down_h2_##name (GstVideoChromaResample *resample,          \
     gpointer pixels, gint width)                                        \
 {                                                                       \
   type *p = pixels;                                                     \
-  gint i;                                                               \
+  gint i = 0;                                                           \
                                                                         \
-  for (i = 0; i < width - 1; i += 2) {                                  \
+  SIMD_DOWN_H2 (name)                                                   \
+  for (; i < width - 1; i += 2) {                                       \
     type tr0 = PR(i), tr1 = PR(i+1);                                    \
     type tb0 = PB(i), tb1 = PB(i+1);                                    \
                                                                         \
@@ -577,9 +598,10 @@ video_chroma_up_h2_cs_##name (GstVideoChromaResample *resample,         \
     gpointer pixels, gint width)                                        \
 {                                                                       \
   type *p = pixels;                                                     \
-  gint i;                                                               \
+  gint i = 1;                                                           \
                                                                         \
-  for (i = 1; i < width - 1; i += 2) {                                  \
+  SIMD_UP_H2_CS (name)                                                  \
+  for (; i < width - 1; i += 2) {                                       \
     PR(i) = FILT_1_1 (PR(i-1), PR(i+1));                                \
     PB(i) = FILT_1_1 (PB(i-1), PB(i+1));                                \
   }                                                                     \
@@ -638,7 +660,9 @@ video_chroma_down_h2_cs_##name (GstVideoChromaResample *resample,       \
   PR(0) = FILT_3_1 (PR(0), PR(1));                                      \
   PB(0) = FILT_3_1 (PB(0), PB(1));                                      \
                                                                         \
-  for (i = 2; i < width - 2; i += 2) {                                  \
+  i = 2;                                                                \
+  SIMD_DOWN_H2_CS (name)                                                \
+  for (; i < width - 2; i += 2) {                                       \
     PR(i) = FILT_1_2_1 (PR(i-1), PR(i), PR(i+1));                       \
     PB(i) = FILT_1_2_1 (PB(i-1), PB(i), PB(i+1));                       \
   }                                                                     \
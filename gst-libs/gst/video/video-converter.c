@@ -29,6 +29,7 @@
 #include <math.h>
 
 #include "video-orc.h"
+#include "video-tile-simd.h"
 
 /**
  * SECTION:videoconverter
@@ -141,10 +142,22 @@ struct _MatrixData
   void (*matrix_func) (MatrixData * data, gpointer pixels);
 };
 
+typedef struct _SharedTable SharedTable;
+
+/* lookup tables that only depend on the colorimetry, they are shared
+ * between all converters */
+struct _SharedTable
+{
+  gint refcount;
+  guint key[5];
+  gpointer data;
+};
+
 typedef struct _GammaData GammaData;
 
 struct _GammaData
 {
+  SharedTable *table;
   gpointer gamma_table;
   gint width;
   void (*gamma_func) (GammaData * data, gpointer dest, gpointer src);
@@ -171,6 +184,13 @@ typedef struct
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
 
+typedef struct
+{
+  GstVideoConverter *convert;
+  gint start;
+  gint end;
+} ConverterBand;
+
 struct _GstVideoConverter
 {
   gint flags;
@@ -199,6 +219,12 @@ struct _GstVideoConverter
 
   GstStructure *config;
 
+  /* what the converter was created with, used to find it again in the
+   * converter cache. key_config is NULL when the converter can't be reused */
+  GstVideoInfo key_in_info;
+  GstVideoInfo key_out_info;
+  GstStructure *key_config;
+
   guint16 *tmpline;
 
   gboolean fill_border;
@@ -208,9 +234,22 @@ struct _GstVideoConverter
   guint32 alpha_value;
   AlphaMode alpha_mode;
 
+  /* color balance, folded into the color matrix */
+  gboolean balance;
+  gdouble brightness;
+  gdouble contrast;
+  gdouble hue;
+  gdouble saturation;
+
   void (*convert) (GstVideoConverter * convert, const GstVideoFrame * src,
       GstVideoFrame * dest);
 
+  /* stats */
+  gboolean stats;
+  guint64 n_frames;
+  GstClockTime time;
+  GstClockTime pack_time;
+
   /* data for unpack */
   GstLineCache *unpack_lines;
   GstVideoFormat unpack_format;
@@ -232,6 +271,8 @@ struct _GstVideoConverter
   MatrixData to_RGB_matrix;
   /* gamma decode */
   GammaData gamma_dec;
+  /* gamma decode, primaries and gamma encode in one 3D LUT */
+  gboolean gamma_lut;
 
   /* scaling */
   GstLineCache *hscale_lines;
@@ -283,6 +324,16 @@ struct _GstVideoConverter
   gconstpointer pack_pal;
   gsize pack_palsize;
 
+  /* orientation, when transposing the out_* fields describe the transposed
+   * image that the chain makes and orient_frame keeps it for the final pack */
+  GstVideoOrientationMethod orientation;
+  gboolean transpose;
+  gboolean flip_h;
+  gboolean flip_v;
+  guint8 *orient_line;
+  guint8 *orient_frame;
+  gint *orient_map;
+
   const GstVideoFrame *src;
   GstVideoFrame *dest;
 
@@ -299,6 +350,15 @@ struct _GstVideoConverter
   GstVideoScaler *fh_scaler[4];
   GstVideoScaler *fv_scaler[4];
   FastConvertFunc fconvert[4];
+
+  /* threads */
+  guint n_threads;
+  GstVideoConverter **band_convert;
+  ConverterBand *bands;
+  GThreadPool *pool;
+  GMutex bands_lock;
+  GCond bands_cond;
+  guint bands_pending;
 };
 
 typedef gpointer (*GstLineCacheAllocLineFunc) (GstLineCache * cache, gint idx,
@@ -326,6 +386,10 @@ struct _GstLineCache
   GstLineCacheAllocLineFunc alloc_line;
   gpointer alloc_line_data;
   GDestroyNotify alloc_line_notify;
+
+  /* time spent in need_line, including the time of the previous caches */
+  gboolean measure;
+  GstClockTime time;
 };
 
 static GstLineCache *
@@ -415,8 +479,17 @@ gst_line_cache_get_lines (GstLineCache * cache, gint out_line, gint in_line,
 
     oline = out_line + cache->first + cache->lines->len - in_line;
 
-    if (!cache->need_line (cache, oline, cache->first + cache->lines->len,
-            cache->need_line_data))
+    if (G_UNLIKELY (cache->measure)) {
+      GstClockTime start = gst_util_get_timestamp ();
+      gboolean res;
+
+      res = cache->need_line (cache, oline, cache->first + cache->lines->len,
+          cache->need_line_data);
+      cache->time += gst_util_get_timestamp () - start;
+      if (!res)
+        break;
+    } else if (!cache->need_line (cache, oline,
+            cache->first + cache->lines->len, cache->need_line_data))
       break;
   }
   GST_DEBUG ("no lines");
@@ -607,6 +680,13 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_RESAMPLER_TAPS 0
 #define DEFAULT_OPT_DITHER_METHOD GST_VIDEO_DITHER_BAYER
 #define DEFAULT_OPT_DITHER_QUANTIZATION 1
+#define DEFAULT_OPT_THREADS 1
+#define DEFAULT_OPT_ORIENTATION_METHOD GST_VIDEO_ORIENTATION_IDENTITY
+#define DEFAULT_OPT_STATS FALSE
+#define DEFAULT_OPT_BRIGHTNESS 0.0
+#define DEFAULT_OPT_CONTRAST 1.0
+#define DEFAULT_OPT_HUE 0.0
+#define DEFAULT_OPT_SATURATION 1.0
 
 #define GET_OPT_FILL_BORDER(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_FILL_BORDER, DEFAULT_OPT_FILL_BORDER)
@@ -637,6 +717,21 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_DITHER_METHOD)
 #define GET_OPT_DITHER_QUANTIZATION(c) get_opt_uint(c, \
     GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, DEFAULT_OPT_DITHER_QUANTIZATION)
+#define GET_OPT_THREADS(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_THREADS, DEFAULT_OPT_THREADS)
+#define GET_OPT_STATS(c) get_opt_bool(c, \
+    GST_VIDEO_CONVERTER_OPT_STATS, DEFAULT_OPT_STATS)
+#define GET_OPT_BRIGHTNESS(c) get_opt_double(c, \
+    GST_VIDEO_CONVERTER_OPT_BRIGHTNESS, DEFAULT_OPT_BRIGHTNESS)
+#define GET_OPT_CONTRAST(c) get_opt_double(c, \
+    GST_VIDEO_CONVERTER_OPT_CONTRAST, DEFAULT_OPT_CONTRAST)
+#define GET_OPT_HUE(c) get_opt_double(c, \
+    GST_VIDEO_CONVERTER_OPT_HUE, DEFAULT_OPT_HUE)
+#define GET_OPT_SATURATION(c) get_opt_double(c, \
+    GST_VIDEO_CONVERTER_OPT_SATURATION, DEFAULT_OPT_SATURATION)
+#define GET_OPT_ORIENTATION_METHOD(c) get_opt_enum(c, \
+    GST_VIDEO_CONVERTER_OPT_ORIENTATION_METHOD, GST_TYPE_VIDEO_ORIENTATION_METHOD, \
+    DEFAULT_OPT_ORIENTATION_METHOD)
 
 #define CHECK_ALPHA_COPY(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_COPY)
 #define CHECK_ALPHA_SET(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_SET)
@@ -1181,11 +1276,45 @@ prepare_matrix (GstVideoConverter * convert, MatrixData * data)
   }
 }
 
+/* brightness and contrast are applied to Y' in [0..1] range, hue rotates and
+ * saturation scales the Cb and Cr components in [-0.5..0.5] range. When
+ * @data produces R'G'B', the balance is done on the Y'CbCr of @Kr and @Kb. */
+static void
+compute_matrix_balance (GstVideoConverter * convert, MatrixData * data,
+    gboolean rgb, gdouble Kr, gdouble Kb)
+{
+  MatrixData b;
+  gdouble hc, hs;
+
+  if (rgb)
+    color_matrix_RGB_to_YCbCr (data, Kr, Kb);
+
+  hc = convert->saturation * cos (G_PI * convert->hue);
+  hs = convert->saturation * sin (G_PI * convert->hue);
+
+  color_matrix_set_identity (&b);
+  b.dm[0][0] = convert->contrast;
+  b.dm[0][3] = convert->brightness;
+  b.dm[1][1] = hc;
+  b.dm[1][2] = hs;
+  b.dm[2][1] = -hs;
+  b.dm[2][2] = hc;
+  color_matrix_multiply (data, &b, data);
+
+  if (rgb)
+    color_matrix_YCbCr_to_RGB (data, Kr, Kb);
+
+  GST_DEBUG ("balance brightness %f, contrast %f, hue %f, saturation %f",
+      convert->brightness, convert->contrast, convert->hue,
+      convert->saturation);
+}
+
 static void
 compute_matrix_to_RGB (GstVideoConverter * convert, MatrixData * data)
 {
   GstVideoInfo *info;
   gdouble Kr = 0, Kb = 0;
+  gboolean rgb = convert->unpack_rgb;
 
   info = &convert->in_info;
 
@@ -1209,8 +1338,20 @@ compute_matrix_to_RGB (GstVideoConverter * convert, MatrixData * data)
       info = &convert->out_info;
 
     /* bring components to R'G'B' space */
-    if (gst_video_color_matrix_get_Kr_Kb (info->colorimetry.matrix, &Kr, &Kb))
+    if (gst_video_color_matrix_get_Kr_Kb (info->colorimetry.matrix, &Kr, &Kb)) {
       color_matrix_YCbCr_to_RGB (data, Kr, Kb);
+      rgb = TRUE;
+    }
+  }
+
+  if (convert->balance) {
+    /* RGB input, balance in the Y'CbCr space of the output */
+    if (rgb && Kr == 0 &&
+        !gst_video_color_matrix_get_Kr_Kb (convert->out_info.colorimetry.
+            matrix, &Kr, &Kb))
+      gst_video_color_matrix_get_Kr_Kb (GST_VIDEO_COLOR_MATRIX_BT709, &Kr,
+          &Kb);
+    compute_matrix_balance (convert, data, rgb, Kr, Kb);
   }
   color_matrix_debug (data);
 }
@@ -1305,66 +1446,346 @@ gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src)
   }
 }
 
+typedef enum
+{
+  TABLE_GAMMA_DECODE_8,
+  TABLE_GAMMA_DECODE_16,
+  TABLE_GAMMA_ENCODE_8,
+  TABLE_GAMMA_ENCODE_16,
+  TABLE_GAMMA_LUT
+} SharedTableKind;
+
+typedef void (*SharedTableFill) (GstVideoConverter * convert,
+    const guint * key, gpointer data);
+
+static GMutex shared_tables_lock;
+static GList *shared_tables;
+
+static SharedTable *
+shared_table_get (GstVideoConverter * convert, const guint key[5], gsize size,
+    SharedTableFill fill)
+{
+  SharedTable *table = NULL;
+  GList *walk;
+
+  g_mutex_lock (&shared_tables_lock);
+  for (walk = shared_tables; walk; walk = walk->next) {
+    SharedTable *t = walk->data;
+
+    if (memcmp (t->key, key, sizeof (t->key)) == 0) {
+      GST_DEBUG ("reuse table %p kind %u", t, key[0]);
+      table = t;
+      table->refcount++;
+      break;
+    }
+  }
+  if (table == NULL) {
+    table = g_slice_new (SharedTable);
+    table->refcount = 1;
+    memcpy (table->key, key, sizeof (table->key));
+    table->data = g_malloc (size);
+    fill (convert, key, table->data);
+    GST_DEBUG ("made table %p kind %u", table, key[0]);
+    shared_tables = g_list_prepend (shared_tables, table);
+  }
+  g_mutex_unlock (&shared_tables_lock);
+
+  return table;
+}
+
+static void
+shared_table_unref (SharedTable * table)
+{
+  if (table == NULL)
+    return;
+
+  g_mutex_lock (&shared_tables_lock);
+  if (--table->refcount == 0)
+    shared_tables = g_list_remove (shared_tables, table);
+  else
+    table = NULL;
+  g_mutex_unlock (&shared_tables_lock);
+
+  if (table) {
+    g_free (table->data);
+    g_slice_free (SharedTable, table);
+  }
+}
+
+static void
+fill_gamma_table (GstVideoConverter * convert, const guint * key,
+    gpointer data)
+{
+  GstVideoTransferFunction func = key[1];
+  gint i;
+
+  switch (key[0]) {
+    case TABLE_GAMMA_DECODE_8:
+    {
+      guint16 *t = data;
+
+      for (i = 0; i < 256; i++)
+        t[i] =
+            rint (gst_video_color_transfer_decode (func, i / 255.0) * 65535.0);
+      break;
+    }
+    case TABLE_GAMMA_DECODE_16:
+    {
+      guint16 *t = data;
+
+      for (i = 0; i < 65536; i++)
+        t[i] =
+            rint (gst_video_color_transfer_decode (func,
+                i / 65535.0) * 65535.0);
+      break;
+    }
+    case TABLE_GAMMA_ENCODE_8:
+    {
+      guint8 *t = data;
+
+      for (i = 0; i < 65536; i++)
+        t[i] =
+            rint (gst_video_color_transfer_encode (func, i / 65535.0) * 255.0);
+      break;
+    }
+    case TABLE_GAMMA_ENCODE_16:
+    {
+      guint16 *t = data;
+
+      for (i = 0; i < 65536; i++)
+        t[i] =
+            rint (gst_video_color_transfer_encode (func,
+                i / 65535.0) * 65535.0);
+      break;
+    }
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* 3D LUT with 33 points per component, the input is in 16 bits so the
+ * grid points are 2048 apart */
+#define GAMMA_LUT_SIZE  33
+#define GAMMA_LUT_SHIFT 11
+#define GAMMA_LUT_MASK  ((1 << GAMMA_LUT_SHIFT) - 1)
+#define GAMMA_LUT_ROUND (1 << (GAMMA_LUT_SHIFT - 1))
+#define GAMMA_LUT_R     (GAMMA_LUT_SIZE * GAMMA_LUT_SIZE * 3)
+#define GAMMA_LUT_G     (GAMMA_LUT_SIZE * 3)
+#define GAMMA_LUT_B     3
+
+/* decode the R'G'B' grid points, apply the primaries matrix in linear light
+ * and encode again */
+static void
+fill_gamma_lut (GstVideoConverter * convert, const guint * key, gpointer data)
+{
+  GstVideoTransferFunction in_func = key[1], out_func = key[3];
+  MatrixData *m = &convert->convert_matrix;
+  gdouble grid[GAMMA_LUT_SIZE];
+  guint16 *t = data;
+  gint r, g, b, i;
+
+  for (i = 0; i < GAMMA_LUT_SIZE; i++)
+    grid[i] = gst_video_color_transfer_decode (in_func,
+        MIN ((i << GAMMA_LUT_SHIFT) / 65535.0, 1.0));
+
+  for (r = 0; r < GAMMA_LUT_SIZE; r++) {
+    for (g = 0; g < GAMMA_LUT_SIZE; g++) {
+      for (b = 0; b < GAMMA_LUT_SIZE; b++) {
+        for (i = 0; i < 3; i++) {
+          gdouble v;
+
+          v = m->dm[i][0] * grid[r] + m->dm[i][1] * grid[g] +
+              m->dm[i][2] * grid[b];
+          v = gst_video_color_transfer_encode (out_func, CLAMP (v, 0.0, 1.0));
+          *t++ = rint (v * 65535.0);
+        }
+      }
+    }
+  }
+}
+
+/* tetrahedral interpolation, walk from the lower to the upper corner of the
+ * cube along the components with the biggest fraction first */
+static inline void
+gamma_lut_lookup (const guint16 * lut, guint r, guint g, guint b, guint out[3])
+{
+  const guint16 *c0, *c1, *c2, *c3;
+  gint fr, fg, fb, f1, f2, f3, i;
+
+  fr = r & GAMMA_LUT_MASK;
+  fg = g & GAMMA_LUT_MASK;
+  fb = b & GAMMA_LUT_MASK;
+
+  c0 = lut + (r >> GAMMA_LUT_SHIFT) * GAMMA_LUT_R +
+      (g >> GAMMA_LUT_SHIFT) * GAMMA_LUT_G +
+      (b >> GAMMA_LUT_SHIFT) * GAMMA_LUT_B;
+  c3 = c0 + GAMMA_LUT_R + GAMMA_LUT_G + GAMMA_LUT_B;
+
+  if (fr >= fg) {
+    if (fg >= fb) {
+      c1 = c0 + GAMMA_LUT_R, c2 = c1 + GAMMA_LUT_G;
+      f1 = fr, f2 = fg, f3 = fb;
+    } else if (fr >= fb) {
+      c1 = c0 + GAMMA_LUT_R, c2 = c1 + GAMMA_LUT_B;
+      f1 = fr, f2 = fb, f3 = fg;
+    } else {
+      c1 = c0 + GAMMA_LUT_B, c2 = c1 + GAMMA_LUT_R;
+      f1 = fb, f2 = fr, f3 = fg;
+    }
+  } else {
+    if (fb >= fg) {
+      c1 = c0 + GAMMA_LUT_B, c2 = c1 + GAMMA_LUT_G;
+      f1 = fb, f2 = fg, f3 = fr;
+    } else if (fb >= fr) {
+      c1 = c0 + GAMMA_LUT_G, c2 = c1 + GAMMA_LUT_B;
+      f1 = fg, f2 = fb, f3 = fr;
+    } else {
+      c1 = c0 + GAMMA_LUT_G, c2 = c1 + GAMMA_LUT_R;
+      f1 = fg, f2 = fr, f3 = fb;
+    }
+  }
+  for (i = 0; i < 3; i++)
+    out[i] = c0[i] + ((f1 * (c1[i] - c0[i]) + f2 * (c2[i] - c1[i]) +
+            f3 * (c3[i] - c2[i]) + GAMMA_LUT_ROUND) >> GAMMA_LUT_SHIFT);
+}
+
+#define EXPAND_U8(v)  (((v) << 8) | (v))
+#define EXPAND_U16(v) (v)
+#define ALPHA_U8(v)   ((v) >> 8)
+#define ALPHA_U16(v)  (v)
+#define ROUND_U8(v)   (((v) * 255 + 32767) / 65535)
+#define ROUND_U16(v)  (v)
+
+#define MAKE_GAMMA_LUT_FUNC(sbits,dbits)                                    \
+static void                                                                 \
+gamma_lut_u##sbits##_u##dbits (GammaData * data, gpointer dest, gpointer src) \
+{                                                                           \
+  gint i;                                                                   \
+  guint##sbits *s = src;                                                    \
+  guint##dbits *d = dest;                                                   \
+  const guint16 *lut = data->gamma_table;                                   \
+  gint width = data->width * 4;                                             \
+  guint c[3];                                                               \
+                                                                            \
+  for (i = 0; i < width; i += 4) {                                          \
+    gamma_lut_lookup (lut, EXPAND_U##sbits (s[i + 1]),                      \
+        EXPAND_U##sbits (s[i + 2]), EXPAND_U##sbits (s[i + 3]), c);         \
+    d[i + 0] = ALPHA_U##dbits (EXPAND_U##sbits (s[i]));                     \
+    d[i + 1] = ROUND_U##dbits (c[0]);                                       \
+    d[i + 2] = ROUND_U##dbits (c[1]);                                       \
+    d[i + 3] = ROUND_U##dbits (c[2]);                                       \
+  }                                                                         \
+}
+
+MAKE_GAMMA_LUT_FUNC (8, 8)
+MAKE_GAMMA_LUT_FUNC (8, 16)
+MAKE_GAMMA_LUT_FUNC (16, 8)
+MAKE_GAMMA_LUT_FUNC (16, 16)
+
+/* without scaling, nothing happens in linear light between the gamma decode
+ * and encode except the primaries conversion, we can then do all of them
+ * with one 3D LUT */
+static gboolean
+can_use_gamma_lut (GstVideoConverter * convert)
+{
+  if (CHECK_PRIMARIES_NONE (convert))
+    return FALSE;
+  if (convert->in_info.colorimetry.primaries ==
+      convert->out_info.colorimetry.primaries)
+    return FALSE;
+  if (convert->in_width != convert->out_width ||
+      convert->in_height != convert->out_height)
+    return FALSE;
+
+  return TRUE;
+}
+
 static void
 setup_gamma_decode (GstVideoConverter * convert)
 {
   GstVideoTransferFunction func;
-  guint16 *t;
-  gint i;
+  guint key[5] = { 0, };
 
   func = convert->in_info.colorimetry.transfer;
+  key[1] = func;
 
   convert->gamma_dec.width = convert->current_width;
   if (convert->current_bits == 8) {
     GST_DEBUG ("gamma decode 8->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 256);
-
-    for (i = 0; i < 256; i++)
-      t[i] = rint (gst_video_color_transfer_decode (func, i / 255.0) * 65535.0);
+    key[0] = TABLE_GAMMA_DECODE_8;
+    convert->gamma_dec.table = shared_table_get (convert, key,
+        sizeof (guint16) * 256, fill_gamma_table);
   } else {
     GST_DEBUG ("gamma decode 16->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 65536);
-
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_color_transfer_decode (func, i / 65535.0) * 65535.0);
+    key[0] = TABLE_GAMMA_DECODE_16;
+    convert->gamma_dec.table = shared_table_get (convert, key,
+        sizeof (guint16) * 65536, fill_gamma_table);
   }
+  convert->gamma_dec.gamma_table = convert->gamma_dec.table->data;
+
   convert->current_bits = 16;
   convert->current_pstride = 8;
   convert->current_format = GST_VIDEO_FORMAT_ARGB64;
 }
 
+static void
+setup_gamma_lut (GstVideoConverter * convert, gint target_bits)
+{
+  guint key[5];
+
+  key[0] = TABLE_GAMMA_LUT;
+  key[1] = convert->in_info.colorimetry.transfer;
+  key[2] = convert->in_info.colorimetry.primaries;
+  key[3] = convert->out_info.colorimetry.transfer;
+  key[4] = convert->out_info.colorimetry.primaries;
+
+  GST_DEBUG ("gamma LUT %d->%d: %d/%d -> %d/%d", convert->current_bits,
+      target_bits, key[1], key[2], key[3], key[4]);
+
+  if (convert->current_bits == 8)
+    convert->gamma_enc.gamma_func =
+        target_bits == 8 ? gamma_lut_u8_u8 : gamma_lut_u8_u16;
+  else
+    convert->gamma_enc.gamma_func =
+        target_bits == 8 ? gamma_lut_u16_u8 : gamma_lut_u16_u16;
+
+  convert->gamma_enc.table = shared_table_get (convert, key,
+      sizeof (guint16) * GAMMA_LUT_R * GAMMA_LUT_SIZE, fill_gamma_lut);
+  convert->gamma_enc.gamma_table = convert->gamma_enc.table->data;
+}
+
 static void
 setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
 {
   GstVideoTransferFunction func;
-  gint i;
+  guint key[5] = { 0, };
+
+  convert->gamma_enc.width = convert->current_width;
+  if (convert->gamma_lut) {
+    setup_gamma_lut (convert, target_bits);
+    return;
+  }
 
   func = convert->out_info.colorimetry.transfer;
+  key[1] = func;
 
-  convert->gamma_enc.width = convert->current_width;
   if (target_bits == 8) {
-    guint8 *t;
-
     GST_DEBUG ("gamma encode 16->8: %d", func);
     convert->gamma_enc.gamma_func = gamma_convert_u16_u8;
-    t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint8) * 65536);
-
-    for (i = 0; i < 65536; i++)
-      t[i] = rint (gst_video_color_transfer_encode (func, i / 65535.0) * 255.0);
+    key[0] = TABLE_GAMMA_ENCODE_8;
+    convert->gamma_enc.table = shared_table_get (convert, key,
+        sizeof (guint8) * 65536, fill_gamma_table);
   } else {
-    guint16 *t;
-
     GST_DEBUG ("gamma encode 16->16: %d", func);
     convert->gamma_enc.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint16) * 65536);
-
-    for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_color_transfer_encode (func, i / 65535.0) * 65535.0);
+    key[0] = TABLE_GAMMA_ENCODE_16;
+    convert->gamma_enc.table = shared_table_get (convert, key,
+        sizeof (guint16) * 65536, fill_gamma_table);
   }
+  convert->gamma_enc.gamma_table = convert->gamma_enc.table->data;
 }
 
 static GstLineCache *
@@ -1377,7 +1798,9 @@ chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev)
   if (do_gamma) {
     gint scale;
 
-    if (!convert->unpack_rgb) {
+    convert->gamma_lut = can_use_gamma_lut (convert);
+
+    if (!convert->unpack_rgb || convert->balance) {
       color_matrix_set_identity (&convert->to_RGB_matrix);
       compute_matrix_to_RGB (convert, &convert->to_RGB_matrix);
 
@@ -1403,8 +1826,12 @@ chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev)
     gst_line_cache_set_need_line_func (convert->to_RGB_lines,
         do_convert_to_RGB_lines, convert, NULL);
 
-    GST_DEBUG ("chain gamma decode");
-    setup_gamma_decode (convert);
+    if (convert->gamma_lut) {
+      GST_DEBUG ("gamma decode done with gamma LUT");
+    } else {
+      GST_DEBUG ("chain gamma decode");
+      setup_gamma_decode (convert);
+    }
   }
   return prev;
 }
@@ -1525,7 +1952,10 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev)
   MatrixData p1, p2;
 
   same_bits = convert->unpack_bits == convert->pack_bits;
-  if (CHECK_MATRIX_NONE (convert)) {
+  if (convert->balance && !CHECK_GAMMA_REMAP (convert)) {
+    /* the color balance is done with the matrix */
+    same_matrix = FALSE;
+  } else if (CHECK_MATRIX_NONE (convert)) {
     same_matrix = TRUE;
   } else {
     same_matrix =
@@ -1621,6 +2051,9 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev)
     /* we did gamma, just do colorspace conversion if needed */
     if (same_primaries) {
       do_conversion = FALSE;
+    } else if (convert->gamma_lut) {
+      /* the matrix is applied when making the gamma LUT */
+      do_conversion = FALSE;
     } else {
       prepare_matrix (convert, &convert->convert_matrix);
       convert->in_bits = convert->out_bits = 16;
@@ -1853,9 +2286,12 @@ chain_pack (GstVideoConverter * convert, GstLineCache * prev)
 {
   convert->pack_nlines = convert->out_info.finfo->pack_lines;
   convert->pack_pstride = convert->current_pstride;
+  /* when running in bands, the caches can ask for lines outside of the
+   * band, never let them write into lines that another band owns */
   convert->identity_pack =
       (convert->out_info.finfo->format ==
-      convert->out_info.finfo->unpack_format);
+      convert->out_info.finfo->unpack_format) && convert->n_threads <= 1 &&
+      convert->orientation == GST_VIDEO_ORIENTATION_IDENTITY;
   GST_DEBUG ("chain pack line format %s, pstride %d, identity_pack %d (%d %d)",
       gst_video_format_to_string (convert->current_format),
       convert->current_pstride, convert->identity_pack,
@@ -1864,6 +2300,21 @@ chain_pack (GstVideoConverter * convert, GstLineCache * prev)
   return prev;
 }
 
+/* the width of the temp lines and the border line, a transposed image is
+ * packed from lines as wide as the real output */
+static gint
+converter_line_width (GstVideoConverter * convert)
+{
+  gint width;
+
+  width = MAX (convert->in_maxwidth, convert->out_maxwidth);
+  width += convert->out_x;
+  if (convert->transpose)
+    width = MAX (width, convert->out_maxheight);
+
+  return width;
+}
+
 static void
 setup_allocators (GstVideoConverter * convert)
 {
@@ -1874,8 +2325,7 @@ setup_allocators (GstVideoConverter * convert)
   GDestroyNotify notify;
   gint width, n_lines;
 
-  width = MAX (convert->in_maxwidth, convert->out_maxwidth);
-  width += convert->out_x;
+  width = converter_line_width (convert);
 
   n_lines = 1;
 
@@ -1931,8 +2381,7 @@ setup_borderline (GstVideoConverter * convert)
 {
   gint width;
 
-  width = MAX (convert->in_maxwidth, convert->out_maxwidth);
-  width += convert->out_x;
+  width = converter_line_width (convert);
 
   if (convert->fill_border && (convert->out_height < convert->out_maxheight ||
           convert->out_width < convert->out_maxwidth)) {
@@ -2002,6 +2451,111 @@ setup_borderline (GstVideoConverter * convert)
   }
 }
 
+static void video_converter_band_func (ConverterBand * band,
+    GstVideoConverter * convert);
+static GstVideoConverter *video_converter_new_internal (GstVideoInfo *
+    in_info, GstVideoInfo * out_info, GstStructure * config,
+    GstVideoConverter * parent);
+static GstVideoConverter *video_converter_new_band (GstVideoInfo * in_info,
+    GstVideoInfo * out_info, GstVideoConverter * parent);
+
+static void
+setup_threads (GstVideoConverter * convert, GstVideoInfo * in_info,
+    GstVideoInfo * out_info)
+{
+  guint i, band_height;
+
+  convert->band_convert = g_new0 (GstVideoConverter *, convert->n_threads);
+  convert->bands = g_new0 (ConverterBand, convert->n_threads);
+
+  /* the first band is done by ourselves, the other bands get their own
+   * converter with private line caches, scalers and temp lines */
+  convert->band_convert[0] = convert;
+  for (i = 1; i < convert->n_threads; i++)
+    convert->band_convert[i] =
+        video_converter_new_band (in_info, out_info, convert);
+
+  band_height = GST_ROUND_UP_4 ((convert->out_height + convert->n_threads -
+          1) / convert->n_threads);
+  for (i = 0; i < convert->n_threads; i++) {
+    convert->bands[i].convert = convert->band_convert[i];
+    convert->bands[i].start = MIN (i * band_height, convert->out_height);
+    convert->bands[i].end =
+        MIN ((i + 1) * band_height, convert->out_height);
+  }
+
+  g_mutex_init (&convert->bands_lock);
+  g_cond_init (&convert->bands_cond);
+  /* not exclusive, the threads are shared with all other pools */
+  convert->pool = g_thread_pool_new ((GFunc) video_converter_band_func,
+      convert, convert->n_threads - 1, FALSE, NULL);
+
+  GST_DEBUG ("using %u threads, band height %u", convert->n_threads,
+      band_height);
+}
+
+/* output lines that are packed together from a transposed image */
+#define ORIENT_BLOCK 16
+
+static void
+setup_orientation (GstVideoConverter * convert)
+{
+  gint tmp;
+
+  convert->orientation = GET_OPT_ORIENTATION_METHOD (convert);
+  if (convert->orientation == GST_VIDEO_ORIENTATION_IDENTITY)
+    return;
+
+  if (GST_VIDEO_INFO_IS_INTERLACED (&convert->in_info) ||
+      convert->out_info.finfo->pack_lines > 1) {
+    GST_WARNING ("can't change the orientation of interlaced or tiled video");
+    convert->orientation = GST_VIDEO_ORIENTATION_IDENTITY;
+    return;
+  }
+
+  switch (convert->orientation) {
+    case GST_VIDEO_ORIENTATION_180:
+      convert->flip_h = convert->flip_v = TRUE;
+      break;
+    case GST_VIDEO_ORIENTATION_HORIZ:
+      convert->flip_h = TRUE;
+      break;
+    case GST_VIDEO_ORIENTATION_VERT:
+      convert->flip_v = TRUE;
+      break;
+    case GST_VIDEO_ORIENTATION_90R:
+      convert->transpose = convert->flip_h = TRUE;
+      break;
+    case GST_VIDEO_ORIENTATION_90L:
+      convert->transpose = convert->flip_v = TRUE;
+      break;
+    case GST_VIDEO_ORIENTATION_UR_LL:
+      convert->transpose = convert->flip_h = convert->flip_v = TRUE;
+      break;
+    case GST_VIDEO_ORIENTATION_UL_LR:
+    default:
+      convert->transpose = TRUE;
+      break;
+  }
+
+  if (convert->transpose) {
+    /* the chain makes the image as it is before the transpose, the flips
+     * are done while transposing. */
+    tmp = convert->out_x;
+    convert->out_x = convert->out_y;
+    convert->out_y = tmp;
+    tmp = convert->out_width;
+    convert->out_width = convert->out_height;
+    convert->out_height = tmp;
+    tmp = convert->out_maxwidth;
+    convert->out_maxwidth = convert->out_maxheight;
+    convert->out_maxheight = tmp;
+  }
+  GST_DEBUG ("orientation %d, transpose %d, flip h %d v %d",
+      convert->orientation, convert->transpose, convert->flip_h,
+      convert->flip_v);
+}
+
 static AlphaMode
 convert_get_alpha_mode (GstVideoConverter * convert)
 {
@@ -2047,25 +2601,115 @@ convert_get_alpha_mode (GstVideoConverter * convert)
  *
  * Since: 1.6
  */
+/* Creating a converter computes the conversion matrices, the scaler taps and
+ * the line chain, which is expensive for large frames. Freed converters are
+ * kept in a small LRU cache so that switching back and forth between a few
+ * formats or sizes, as adaptive streams do, reuses them. */
+#define CONVERTER_CACHE_SIZE 4
+
+static GMutex converter_cache_lock;
+static GQueue converter_cache = G_QUEUE_INIT;
+
+static void video_converter_free_internal (GstVideoConverter * convert);
+
+static GstVideoConverter *
+video_converter_cache_take (GstVideoInfo * in_info, GstVideoInfo * out_info,
+    const GstStructure * config)
+{
+  GstVideoConverter *result = NULL;
+  GList *walk;
+
+  g_mutex_lock (&converter_cache_lock);
+  for (walk = converter_cache.head; walk; walk = walk->next) {
+    GstVideoConverter *convert = walk->data;
+
+    if (gst_video_info_is_equal (&convert->key_in_info, in_info) &&
+        gst_video_info_is_equal (&convert->key_out_info, out_info) &&
+        gst_structure_is_equal (convert->key_config, config)) {
+      g_queue_delete_link (&converter_cache, walk);
+      result = convert;
+      break;
+    }
+  }
+  g_mutex_unlock (&converter_cache_lock);
+
+  if (result)
+    GST_DEBUG ("reusing cached converter %p", result);
+
+  return result;
+}
+
+/* returns FALSE when @convert can't be cached and should be freed */
+static gboolean
+video_converter_cache_put (GstVideoConverter * convert)
+{
+  GstVideoConverter *old = NULL;
+
+  if (convert->key_config == NULL)
+    return FALSE;
+
+  g_mutex_lock (&converter_cache_lock);
+  g_queue_push_head (&converter_cache, convert);
+  if (converter_cache.length > CONVERTER_CACHE_SIZE)
+    old = g_queue_pop_tail (&converter_cache);
+  g_mutex_unlock (&converter_cache_lock);
+
+  if (old)
+    video_converter_free_internal (old);
+
+  return TRUE;
+}
+
 GstVideoConverter *
 gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
     GstStructure * config)
 {
   GstVideoConverter *convert;
-  GstLineCache *prev;
-  const GstVideoFormatInfo *fin, *fout, *finfo;
-  gdouble alpha_value;
+  GstStructure *key;
 
   g_return_val_if_fail (in_info != NULL, NULL);
   g_return_val_if_fail (out_info != NULL, NULL);
-  /* we won't ever do framerate conversion */
-  g_return_val_if_fail (in_info->fps_n == out_info->fps_n, NULL);
-  g_return_val_if_fail (in_info->fps_d == out_info->fps_d, NULL);
-  /* we won't ever do deinterlace */
-  g_return_val_if_fail (in_info->interlace_mode == out_info->interlace_mode,
-      NULL);
 
-  convert = g_slice_new0 (GstVideoConverter);
+  if (config)
+    key = gst_structure_copy (config);
+  else
+    key = gst_structure_new_empty ("GstVideoConverter");
+
+  if ((convert = video_converter_cache_take (in_info, out_info, key))) {
+    gst_structure_free (key);
+    if (config)
+      gst_structure_free (config);
+    return convert;
+  }
+
+  convert = video_converter_new_internal (in_info, out_info, config, NULL);
+  if (convert) {
+    convert->key_in_info = *in_info;
+    convert->key_out_info = *out_info;
+    convert->key_config = key;
+  } else {
+    gst_structure_free (key);
+  }
+  return convert;
+}
+
+static GstVideoConverter *
+video_converter_new_band (GstVideoInfo * in_info, GstVideoInfo * out_info,
+    GstVideoConverter * parent)
+{
+  return video_converter_new_internal (in_info, out_info,
+      gst_structure_copy (parent->config), parent);
+}
+
+/* sets up the zeroed @convert, on error the caller frees it */
+static gboolean
+video_converter_init_internal (GstVideoConverter * convert,
+    GstVideoInfo * in_info, GstVideoInfo * out_info, GstStructure * config,
+    GstVideoConverter * parent)
+{
+  GstLineCache *prev;
+  const GstVideoFormatInfo *fin, *fout, *finfo;
+  gdouble alpha_value;
 
   fin = in_info->finfo;
   fout = out_info->finfo;
@@ -2116,6 +2760,44 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   convert->out_height =
       MIN (convert->out_height, convert->out_maxheight - convert->out_y);
 
+  setup_orientation (convert);
+
+  if (parent) {
+    convert->n_threads = parent->n_threads;
+  } else {
+    guint band_height;
+
+    convert->n_threads = GET_OPT_THREADS (convert);
+    if (convert->n_threads == 0)
+      convert->n_threads = g_get_num_processors ();
+
+    /* bands are a multiple of 4 lines so that chroma subsampling and
+     * interlacing stay aligned, drop the bands that would be empty */
+    band_height = GST_ROUND_UP_4 ((convert->out_height + convert->n_threads -
+            1) / convert->n_threads);
+    if (band_height > 0)
+      convert->n_threads = (convert->out_height + band_height - 1) /
+          band_height;
+    convert->n_threads = MAX (convert->n_threads, 1);
+
+    /* the bands dither with the line numbers of the whole frame, which is
+     * enough for the ordered dither. Error diffusion carries the errors of a
+     * line into the next one and a band can't start with the errors of the
+     * band above it, don't split the frame then */
+    switch (GET_OPT_DITHER_METHOD (convert)) {
+      case GST_VIDEO_DITHER_VERTERR:
+      case GST_VIDEO_DITHER_FLOYD_STEINBERG:
+      case GST_VIDEO_DITHER_SIERRA_LITE:
+        if (convert->n_threads > 1)
+          GST_DEBUG ("error diffusion dither, not using threads");
+        convert->n_threads = 1;
+        break;
+      default:
+        break;
+    }
+  }
+
+  convert->stats = GET_OPT_STATS (convert);
   convert->fill_border = GET_OPT_FILL_BORDER (convert);
   convert->border_argb = get_opt_uint (convert,
       GST_VIDEO_CONVERTER_OPT_BORDER_ARGB, DEFAULT_OPT_BORDER_ARGB);
@@ -2124,6 +2806,15 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   convert->alpha_value = 255 * alpha_value;
   convert->alpha_mode = convert_get_alpha_mode (convert);
 
+  convert->brightness = GET_OPT_BRIGHTNESS (convert);
+  convert->contrast = GET_OPT_CONTRAST (convert);
+  convert->hue = GET_OPT_HUE (convert);
+  convert->saturation = GET_OPT_SATURATION (convert);
+  convert->balance = convert->brightness != DEFAULT_OPT_BRIGHTNESS ||
+      convert->contrast != DEFAULT_OPT_CONTRAST ||
+      convert->hue != DEFAULT_OPT_HUE ||
+      convert->saturation != DEFAULT_OPT_SATURATION;
+
   convert->unpack_format = in_info->finfo->unpack_format;
   finfo = gst_video_format_get_info (convert->unpack_format);
   convert->unpack_bits = GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0);
@@ -2151,8 +2842,12 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
     convert->out_info.colorimetry.matrix = GST_VIDEO_COLOR_MATRIX_RGB;
   }
 
-  if (video_converter_lookup_fastpath (convert))
+  /* the fastpaths don't rotate */
+  if (convert->orientation == GST_VIDEO_ORIENTATION_IDENTITY &&
+      video_converter_lookup_fastpath (convert)) {
+    convert->n_threads = 1;
     goto done;
+  }
 
   if (in_info->finfo->unpack_func == NULL)
     goto no_unpack_func;
@@ -2193,24 +2888,72 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   /* now figure out allocators */
   setup_allocators (convert);
 
+  if (convert->stats) {
+    for (prev = convert->pack_lines; prev; prev = prev->prev)
+      prev->measure = TRUE;
+  }
+
+  if (convert->transpose) {
+    /* the bands fill in the transposed image of the parent, which does the
+     * final pack by itself */
+    if (parent == NULL) {
+      convert->orient_frame = g_malloc0 (convert->pack_pstride *
+          convert->out_maxwidth * convert->out_maxheight);
+      convert->orient_line = g_malloc (convert->pack_pstride *
+          convert->out_maxheight * ORIENT_BLOCK);
+      convert->orient_map = g_new (gint, convert->out_maxheight);
+    } else {
+      convert->orient_frame = parent->orient_frame;
+    }
+  } else if (convert->flip_h) {
+    convert->orient_line = g_malloc (convert->pack_pstride *
+        converter_line_width (convert));
+  }
+
+  if (parent == NULL && convert->n_threads > 1)
+    setup_threads (convert, in_info, out_info);
+
 done:
-  return convert;
+  return TRUE;
 
   /* ERRORS */
 no_unpack_func:
   {
     GST_ERROR ("no unpack_func for format %s",
         gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (in_info)));
-    gst_video_converter_free (convert);
-    return NULL;
+    return FALSE;
   }
 no_pack_func:
   {
     GST_ERROR ("no pack_func for format %s",
         gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (out_info)));
-    gst_video_converter_free (convert);
+    return FALSE;
+  }
+}
+
+static GstVideoConverter *
+video_converter_new_internal (GstVideoInfo * in_info,
+    GstVideoInfo * out_info, GstStructure * config, GstVideoConverter * parent)
+{
+  GstVideoConverter *convert;
+
+  g_return_val_if_fail (in_info != NULL, NULL);
+  g_return_val_if_fail (out_info != NULL, NULL);
+  /* we won't ever do framerate conversion */
+  g_return_val_if_fail (in_info->fps_n == out_info->fps_n, NULL);
+  g_return_val_if_fail (in_info->fps_d == out_info->fps_d, NULL);
+  /* we won't ever do deinterlace */
+  g_return_val_if_fail (in_info->interlace_mode == out_info->interlace_mode,
+      NULL);
+
+  convert = g_slice_new0 (GstVideoConverter);
+
+  if (!video_converter_init_internal (convert, in_info, out_info, config,
+          parent)) {
+    video_converter_free_internal (convert);
     return NULL;
   }
+  return convert;
 }
 
 static void
@@ -2221,6 +2964,24 @@ clear_matrix_data (MatrixData * data)
   g_free (data->t_b);
 }
 
+static void
+video_converter_reset_stats (GstVideoConverter * convert)
+{
+  GstLineCache *cache;
+  gint i;
+
+  for (i = 0; i < convert->n_threads; i++) {
+    GstVideoConverter *band =
+        convert->band_convert ? convert->band_convert[i] : convert;
+
+    for (cache = band->pack_lines; cache; cache = cache->prev)
+      cache->time = 0;
+    band->pack_time = 0;
+  }
+  convert->n_frames = 0;
+  convert->time = 0;
+}
+
 /**
  * gst_video_converter_free:
  * @convert: a #GstVideoConverter
@@ -2231,10 +2992,43 @@ clear_matrix_data (MatrixData * data)
  */
 void
 gst_video_converter_free (GstVideoConverter * convert)
+{
+  g_return_if_fail (convert != NULL);
+
+  if (convert->stats) {
+    GstStructure *stats = gst_video_converter_get_stats (convert);
+
+    GST_DEBUG ("converter %p: %" GST_PTR_FORMAT, convert, stats);
+    gst_structure_free (stats);
+    /* a cached converter starts counting again when it is reused */
+    video_converter_reset_stats (convert);
+  }
+
+  if (!video_converter_cache_put (convert))
+    video_converter_free_internal (convert);
+}
+
+static void
+video_converter_clear_internal (GstVideoConverter * convert)
 {
   gint i;
 
-  g_return_if_fail (convert != NULL);
+  if (convert->pool) {
+    g_thread_pool_free (convert->pool, FALSE, TRUE);
+    g_mutex_clear (&convert->bands_lock);
+    g_cond_clear (&convert->bands_cond);
+  }
+  if (convert->band_convert) {
+    for (i = 1; i < convert->n_threads; i++) {
+      if (convert->band_convert[i]) {
+        /* owned by us */
+        convert->band_convert[i]->orient_frame = NULL;
+        video_converter_free_internal (convert->band_convert[i]);
+      }
+    }
+    g_free (convert->band_convert);
+  }
+  g_free (convert->bands);
 
   if (convert->upsample_p)
     gst_video_chroma_resample_free (convert->upsample_p);
@@ -2275,14 +3069,19 @@ gst_video_converter_free (GstVideoConverter * convert)
   if (convert->dither)
     gst_video_dither_free (convert->dither);
 
-  g_free (convert->gamma_dec.gamma_table);
-  g_free (convert->gamma_enc.gamma_table);
+  shared_table_unref (convert->gamma_dec.table);
+  shared_table_unref (convert->gamma_enc.table);
 
   g_free (convert->tmpline);
   g_free (convert->borderline);
+  g_free (convert->orient_line);
+  g_free (convert->orient_frame);
+  g_free (convert->orient_map);
 
   if (convert->config)
     gst_structure_free (convert->config);
+  if (convert->key_config)
+    gst_structure_free (convert->key_config);
 
   for (i = 0; i < 4; i++) {
     if (convert->fv_scaler[i])
@@ -2293,7 +3092,12 @@ gst_video_converter_free (GstVideoConverter * convert)
   clear_matrix_data (&convert->to_RGB_matrix);
   clear_matrix_data (&convert->convert_matrix);
   clear_matrix_data (&convert->to_YUV_matrix);
+}
 
+static void
+video_converter_free_internal (GstVideoConverter * convert)
+{
+  video_converter_clear_internal (convert);
   g_slice_free (GstVideoConverter, convert);
 }
 
@@ -2321,20 +3125,82 @@ copy_config (GQuark field_id, const GValue * value, gpointer user_data)
  * Look at the #GST_VIDEO_CONVERTER_OPT_* fields to check valid configuration
  * option and values.
  *
+ * Changing the dither options or the number of threads sets up @convert
+ * again, which is as expensive as creating a new converter.
+ *
  * Returns: %TRUE when @config could be set.
  *
  * Since: 1.6
  */
+/* the dither options shape the line chain and, with the threads option,
+ * decide how the frame is split in bands. Rebuild @convert in place when they
+ * change after it was set up, the line caches and the thread pool point to
+ * it */
+static gboolean
+video_converter_rebuild (GstVideoConverter * convert)
+{
+  GstVideoInfo in_info, out_info;
+  GstStructure *config;
+
+  GST_DEBUG ("converter %p: dither or threads changed, rebuilding", convert);
+
+  in_info = convert->in_info;
+  out_info = convert->out_info;
+  config = convert->config;
+  convert->config = NULL;
+
+  video_converter_clear_internal (convert);
+  memset (convert, 0, sizeof (GstVideoConverter));
+
+  return video_converter_init_internal (convert, &in_info, &out_info, config,
+      NULL);
+}
+
 gboolean
 gst_video_converter_set_config (GstVideoConverter * convert,
     GstStructure * config)
 {
+  GstVideoDitherMethod method = 0;
+  guint quantization = 0, threads = 0;
+  gboolean rebuild = FALSE;
+
   g_return_val_if_fail (convert != NULL, FALSE);
   g_return_val_if_fail (config != NULL, FALSE);
 
+  /* only set up converters need a rebuild, the constructor and the bands
+   * get here before that */
+  if (convert->convert) {
+    method = GET_OPT_DITHER_METHOD (convert);
+    quantization = GET_OPT_DITHER_QUANTIZATION (convert);
+    threads = GET_OPT_THREADS (convert);
+  }
+
   gst_structure_foreach (config, copy_config, convert);
+
+  if (convert->convert) {
+    rebuild = method != GET_OPT_DITHER_METHOD (convert) ||
+        quantization != GET_OPT_DITHER_QUANTIZATION (convert) ||
+        threads != GET_OPT_THREADS (convert);
+  }
+
+  /* the converter no longer matches what it was created with */
+  if (convert->key_config) {
+    gst_structure_free (convert->key_config);
+    convert->key_config = NULL;
+  }
+
+  /* the bands run with their own copy of the config */
+  if (convert->band_convert) {
+    guint i;
+
+    for (i = 1; i < convert->n_threads; i++)
+      gst_structure_foreach (config, copy_config, convert->band_convert[i]);
+  }
   gst_structure_free (config);
 
+  if (rebuild)
+    return video_converter_rebuild (convert);
+
   return TRUE;
 }
 
@@ -2373,7 +3239,102 @@ gst_video_converter_frame (GstVideoConverter * convert,
   g_return_if_fail (src != NULL);
   g_return_if_fail (dest != NULL);
 
-  convert->convert (convert, src, dest);
+  if (G_UNLIKELY (convert->stats)) {
+    GstClockTime start = gst_util_get_timestamp ();
+
+    convert->convert (convert, src, dest);
+    convert->time += gst_util_get_timestamp () - start;
+    convert->n_frames++;
+  } else {
+    convert->convert (convert, src, dest);
+  }
+}
+
+static const struct
+{
+  GstLineCacheNeedLineFunc need_line;
+  const gchar *name;
+} stage_names[] = {
+  {do_unpack_lines, "unpack-time"},
+  {do_upsample_lines, "upsample-time"},
+  {do_convert_to_RGB_lines, "to-rgb-time"},
+  {do_hscale_lines, "hscale-time"},
+  {do_vscale_lines, "vscale-time"},
+  {do_convert_lines, "convert-time"},
+  {do_alpha_lines, "alpha-time"},
+  {do_convert_to_YUV_lines, "to-yuv-time"},
+  {do_downsample_lines, "downsample-time"},
+  {do_dither_lines, "dither-time"},
+};
+
+static void
+add_stage_times (GstVideoConverter * convert, GstClockTime * times,
+    GstClockTime * pack_time)
+{
+  GstLineCache *cache;
+  gint i;
+
+  for (cache = convert->pack_lines; cache; cache = cache->prev) {
+    /* take away the time spent in the previous caches */
+    GstClockTime time = cache->time - (cache->prev ? cache->prev->time : 0);
+
+    for (i = 0; i < G_N_ELEMENTS (stage_names); i++) {
+      if (cache->need_line == stage_names[i].need_line) {
+        times[i] += time;
+        break;
+      }
+    }
+  }
+  *pack_time += convert->pack_time;
+}
+
+/**
+ * gst_video_converter_get_stats:
+ * @convert: a #GstVideoConverter
+ *
+ * Get the time @convert spent in each conversion stage. The converter only
+ * measures this when it was made with #GST_VIDEO_CONVERTER_OPT_STATS set to
+ * %TRUE, otherwise all the values are 0.
+ *
+ * The structure has a "frames" field with the number of converted frames, a
+ * "time" field with the total time spent converting them and a field for
+ * each stage of the generic conversion, such as "unpack-time",
+ * "hscale-time", "convert-time" and "pack-time". All times are in
+ * nanoseconds as #G_TYPE_UINT64. The stage times are summed over all the
+ * threads. When a fastpath is used, only "frames" and "time" are updated.
+ *
+ * Returns: (transfer full): a new #GstStructure, free with
+ *     gst_structure_free()
+ *
+ * Since: 1.10
+ */
+GstStructure *
+gst_video_converter_get_stats (GstVideoConverter * convert)
+{
+  GstClockTime times[G_N_ELEMENTS (stage_names)] = { 0, };
+  GstClockTime pack_time = 0;
+  GstStructure *stats;
+  gint i;
+
+  g_return_val_if_fail (convert != NULL, NULL);
+
+  if (convert->band_convert) {
+    for (i = 0; i < convert->n_threads; i++)
+      add_stage_times (convert->band_convert[i], times, &pack_time);
+  } else {
+    add_stage_times (convert, times, &pack_time);
+  }
+
+  stats = gst_structure_new ("GstVideoConverterStats",
+      "frames", G_TYPE_UINT64, convert->n_frames,
+      "time", G_TYPE_UINT64, (guint64) convert->time, NULL);
+  for (i = 0; i < G_N_ELEMENTS (stage_names); i++)
+    gst_structure_set (stats, stage_names[i].name, G_TYPE_UINT64,
+        (guint64) times[i], NULL);
+  gst_structure_set (stats, "pack-time", G_TYPE_UINT64, (guint64) pack_time,
+      NULL);
+
+  return stats;
 }
 
 static void
@@ -2394,6 +3355,7 @@ video_converter_compute_resample (GstVideoConverter * convert)
 {
   GstVideoInfo *in_info, *out_info;
   const GstVideoFormatInfo *sfinfo, *dfinfo;
+  gint out_w_sub, out_h_sub;
 
   if (CHECK_CHROMA_NONE (convert))
     return;
@@ -2404,12 +3366,20 @@ video_converter_compute_resample (GstVideoConverter * convert)
   sfinfo = in_info->finfo;
   dfinfo = out_info->finfo;
 
+  /* the lines of a transposed image are columns of the output */
+  if (convert->transpose) {
+    out_w_sub = dfinfo->h_sub[2];
+    out_h_sub = dfinfo->w_sub[2];
+  } else {
+    out_w_sub = dfinfo->w_sub[2];
+    out_h_sub = dfinfo->h_sub[2];
+  }
+
   GST_DEBUG ("site: %d->%d, w_sub: %d->%d, h_sub: %d->%d", in_info->chroma_site,
       out_info->chroma_site, sfinfo->w_sub[2], dfinfo->w_sub[2],
       sfinfo->h_sub[2], dfinfo->h_sub[2]);
 
-  if (sfinfo->w_sub[2] != dfinfo->w_sub[2] ||
-      sfinfo->h_sub[2] != dfinfo->h_sub[2] ||
+  if (sfinfo->w_sub[2] != out_w_sub || sfinfo->h_sub[2] != out_h_sub ||
       in_info->chroma_site != out_info->chroma_site ||
       in_info->width != out_info->width ||
       in_info->height != out_info->height) {
@@ -2422,7 +3392,7 @@ video_converter_compute_resample (GstVideoConverter * convert)
         convert->downsample_i =
             gst_video_chroma_resample_new (0, out_info->chroma_site,
             GST_VIDEO_CHROMA_FLAG_INTERLACED, dfinfo->unpack_format,
-            -dfinfo->w_sub[2], -dfinfo->h_sub[2]);
+            -out_w_sub, -out_h_sub);
     }
     if (!CHECK_CHROMA_DOWNSAMPLE (convert))
       convert->upsample_p = gst_video_chroma_resample_new (0,
@@ -2430,8 +3400,8 @@ video_converter_compute_resample (GstVideoConverter * convert)
           sfinfo->h_sub[2]);
     if (!CHECK_CHROMA_UPSAMPLE (convert))
       convert->downsample_p = gst_video_chroma_resample_new (0,
-          out_info->chroma_site, 0, dfinfo->unpack_format, -dfinfo->w_sub[2],
-          -dfinfo->h_sub[2]);
+          out_info->chroma_site, 0, dfinfo->unpack_format, -out_w_sub,
+          -out_h_sub);
   }
 }
 
@@ -2503,6 +3473,124 @@ get_dest_line (GstLineCache * cache, gint idx, gpointer user_data)
   return line;
 }
 
+/* the row of @y after a vertical flip of the destination window */
+static inline gint
+flip_row (GstVideoConverter * convert, gint y)
+{
+  if (convert->flip_v && y >= convert->out_y &&
+      y < convert->out_y + convert->out_height)
+    y = 2 * convert->out_y + convert->out_height - 1 - y;
+  return y;
+}
+
+#define REVERSE_PIXELS(type,d,s,n) G_STMT_START {       \
+  type *_d = (type *) (d);                              \
+  const type *_s = (const type *) (s);                  \
+  gint _i;                                              \
+  for (_i = 0; _i < (n); _i++)                          \
+    _d[_i] = _s[(n) - 1 - _i];                          \
+} G_STMT_END
+
+/* pack the full width @line, which starts with the left border, into row
+ * @y of the destination. A transposed image is kept until the whole frame is
+ * done */
+static void
+pack_line (GstVideoConverter * convert, GstVideoFrame * dest, gpointer line,
+    gint y)
+{
+  gint pstride = convert->pack_pstride;
+  gint out_maxwidth = convert->out_maxwidth;
+
+  if (convert->transpose) {
+    memcpy (convert->orient_frame + y * out_maxwidth * pstride, line,
+        out_maxwidth * pstride);
+    return;
+  }
+
+  if (convert->flip_h) {
+    guint8 *s = line, *d = convert->orient_line;
+    gint l = convert->out_x * pstride;
+    gint r = (convert->out_x + convert->out_width) * pstride;
+
+    memcpy (d, s, l);
+    if (pstride == 4)
+      REVERSE_PIXELS (guint32, d + l, s + l, convert->out_width);
+    else
+      REVERSE_PIXELS (guint64, d + l, s + l, convert->out_width);
+    memcpy (d + r, s + r, out_maxwidth * pstride - r);
+    line = d;
+  }
+  PACK_FRAME (dest, line, flip_row (convert, y), out_maxwidth);
+}
+
+#define TRANSPOSE_PIXELS(type,d,dstride,s,sstride,rows,cols,width,n) \
+G_STMT_START {                                                      \
+  gint _x, _k;                                                      \
+  for (_x = 0; _x < (width); _x++) {                                \
+    const type *_s = (const type *) ((s) + (rows)[_x] * (sstride)); \
+    for (_k = 0; _k < (n); _k++)                                    \
+      ((type *) ((d) + _k * (dstride)))[_x] = _s[(cols)[_k]];       \
+  }                                                                 \
+} G_STMT_END
+
+/* pack the transposed image into the destination, ORIENT_BLOCK lines at a
+ * time so that every row of the transposed image is read in one cache line
+ * for all of them */
+static void
+pack_transposed_frame (GstVideoConverter * convert, GstVideoFrame * dest)
+{
+  gint pstride = convert->pack_pstride;
+  /* in the geometry of the destination */
+  gint dest_x = convert->out_y, dest_y = convert->out_x;
+  gint dest_width = convert->out_height, dest_height = convert->out_width;
+  gint dest_maxwidth = convert->out_maxheight;
+  gint dest_maxheight = convert->out_maxwidth;
+  gint sstride = convert->out_maxwidth * pstride;
+  gint stride = dest_maxwidth * pstride;
+  gint x, y, start, end, k, n;
+  gint *row_map = convert->orient_map;
+  gint col_map[ORIENT_BLOCK];
+
+  /* without a border, only the lines of the window are written */
+  if (convert->borderline) {
+    start = 0;
+    end = dest_maxheight;
+  } else {
+    start = dest_y;
+    end = dest_y + dest_height;
+  }
+
+  /* destination column x comes from row row_map[x] of the transposed image
+   * and destination row y from its column y, both mirrored inside the
+   * window when flipping */
+  for (x = 0; x < dest_maxwidth; x++) {
+    row_map[x] = x;
+    if (convert->flip_h && x >= dest_x && x < dest_x + dest_width)
+      row_map[x] = 2 * dest_x + dest_width - 1 - x;
+  }
+
+  for (y = start; y < end; y += n) {
+    n = MIN (ORIENT_BLOCK, end - y);
+
+    for (k = 0; k < n; k++) {
+      col_map[k] = y + k;
+      if (convert->flip_v && y + k >= dest_y && y + k < dest_y + dest_height)
+        col_map[k] = 2 * dest_y + dest_height - 1 - (y + k);
+    }
+
+    if (pstride == 4)
+      TRANSPOSE_PIXELS (guint32, convert->orient_line, stride,
+          convert->orient_frame, sstride, row_map, col_map, dest_maxwidth, n);
+    else
+      TRANSPOSE_PIXELS (guint64, convert->orient_line, stride,
+          convert->orient_frame, sstride, row_map, col_map, dest_maxwidth, n);
+
+    for (k = 0; k < n; k++)
+      PACK_FRAME (dest, convert->orient_line + k * stride, y + k,
+          dest_maxwidth);
+  }
+}
+
 static gboolean
 do_unpack_lines (GstLineCache * cache, gint out_line, gint in_line,
     gpointer user_data)
@@ -2777,22 +3865,9 @@ do_dither_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static void
-video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+video_converter_generic_setup (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
 {
-  gint i;
-  gint out_maxwidth, out_maxheight;
-  gint out_x, out_y, out_height;
-  gint pack_lines, pstride;
-  gint lb_width;
-
-  out_height = convert->out_height;
-  out_maxwidth = convert->out_maxwidth;
-  out_maxheight = convert->out_maxheight;
-
-  out_x = convert->out_x;
-  out_y = convert->out_y;
-
   convert->src = src;
   convert->dest = dest;
 
@@ -2821,19 +3896,33 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     convert->down_n_lines = 1;
     convert->down_offset = 0;
   }
+}
+
+/* convert output lines @start to @end, relative to out_y */
+static void
+video_converter_generic_lines (GstVideoConverter * convert, gint start,
+    gint end)
+{
+  GstLineCache *cache;
+  GstVideoFrame *dest = convert->dest;
+  gint i;
+  gint out_y;
+  gint pack_lines, pstride;
+  gint lb_width;
+
+  out_y = convert->out_y;
 
   pack_lines = convert->pack_nlines;    /* only 1 for now */
   pstride = convert->pack_pstride;
 
-  lb_width = out_x * pstride;
+  lb_width = convert->out_x * pstride;
 
-  if (convert->borderline) {
-    /* FIXME we should try to avoid PACK_FRAME */
-    for (i = 0; i < out_y; i++)
-      PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
-  }
+  /* don't let lines of a previous frame be used when a band does not
+   * start at the top */
+  for (cache = convert->pack_lines; cache; cache = cache->prev)
+    gst_line_cache_clear (cache);
 
-  for (i = 0; i < out_height; i += pack_lines) {
+  for (i = start; i < end; i += pack_lines) {
     gpointer *lines;
 
     /* load the lines needed to pack */
@@ -2845,14 +3934,77 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       guint8 *l = ((guint8 *) lines[0]) - lb_width;
       /* and pack into destination */
       GST_DEBUG ("pack line %d %p (%p)", i + out_y, lines[0], l);
-      PACK_FRAME (dest, l, i + out_y, out_maxwidth);
+      if (G_UNLIKELY (convert->stats)) {
+        GstClockTime start = gst_util_get_timestamp ();
+
+        pack_line (convert, dest, l, i + out_y);
+        convert->pack_time += gst_util_get_timestamp () - start;
+      } else {
+        pack_line (convert, dest, l, i + out_y);
+      }
     }
   }
+}
+
+static void
+video_converter_band_func (ConverterBand * band, GstVideoConverter * convert)
+{
+  video_converter_generic_lines (band->convert, band->start, band->end);
+
+  g_mutex_lock (&convert->bands_lock);
+  if (--convert->bands_pending == 0)
+    g_cond_signal (&convert->bands_cond);
+  g_mutex_unlock (&convert->bands_lock);
+}
+
+static void
+video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  gint i;
+  gint out_maxheight;
+  gint out_y, out_height;
+
+  out_height = convert->out_height;
+  out_maxheight = convert->out_maxheight;
+
+  out_y = convert->out_y;
+
+  if (convert->borderline) {
+    /* FIXME we should try to avoid PACK_FRAME */
+    for (i = 0; i < out_y; i++)
+      pack_line (convert, dest, convert->borderline, i);
+  }
+
+  if (convert->n_threads > 1) {
+    guint n;
+
+    for (n = 0; n < convert->n_threads; n++)
+      video_converter_generic_setup (convert->band_convert[n], src, dest);
+
+    convert->bands_pending = convert->n_threads - 1;
+    for (n = 1; n < convert->n_threads; n++)
+      g_thread_pool_push (convert->pool, &convert->bands[n], NULL);
+
+    /* do the first band ourselves while the pool does the others */
+    video_converter_generic_lines (convert, convert->bands[0].start,
+        convert->bands[0].end);
+
+    g_mutex_lock (&convert->bands_lock);
+    while (convert->bands_pending > 0)
+      g_cond_wait (&convert->bands_cond, &convert->bands_lock);
+    g_mutex_unlock (&convert->bands_lock);
+  } else {
+    video_converter_generic_setup (convert, src, dest);
+    video_converter_generic_lines (convert, 0, out_height);
+  }
 
   if (convert->borderline) {
     for (i = out_y + out_height; i < out_maxheight; i++)
-      PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
+      pack_line (convert, dest, convert->borderline, i);
   }
+  if (convert->transpose)
+    pack_transposed_frame (convert, dest);
   if (convert->pack_pal) {
     memcpy (GST_VIDEO_FRAME_PLANE_DATA (dest, 1), convert->pack_pal,
         convert->pack_palsize);
@@ -3651,6 +4803,81 @@ memset_u32_16 (guint8 * data, guint8 col[4], unsigned int n)
         for (i = out_y + out_height; i < out_maxheight; i++)                    \
           func (FRAME_GET_PLANE_LINE (dest, k, i), col, out_maxwidth);          \
 
+/* detiles NV12_64Z32 to NV12 or to I420/YV12 when @split_uv. A tile of
+ * luma has the first or the second half of a tile of interleaved chroma. */
+static void
+convert_NV12_64Z32 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest, gboolean split_uv)
+{
+  const GstVideoFormatInfo *finfo = src->info.finfo;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  gint ws, hs, ts, tile_width, tile_height;
+  gint sstride0, sstride1, tx, ty;
+  const guint8 *sy, *suv;
+
+  ws = GST_VIDEO_FORMAT_INFO_TILE_WS (finfo);
+  hs = GST_VIDEO_FORMAT_INFO_TILE_HS (finfo);
+  ts = ws + hs;
+  tile_width = 1 << ws;
+  tile_height = 1 << hs;
+
+  sy = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
+  suv = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
+  sstride0 = GST_VIDEO_FRAME_PLANE_STRIDE (src, 0);
+  sstride1 = GST_VIDEO_FRAME_PLANE_STRIDE (src, 1);
+
+  for (ty = 0; ty << hs < height; ty++) {
+    gint y = ty << hs;
+    gint rows = MIN (tile_height, height - y);
+    gint crows = MIN (tile_height / 2, ((height + 1) >> 1) - (y >> 1));
+
+    for (tx = 0; tx << ws < width; tx++) {
+      gint x = tx << ws;
+      gint w = MIN (tile_width, width - x);
+      gsize offset;
+
+      offset = gst_video_tile_get_index (GST_VIDEO_TILE_MODE_ZFLIPZ_2X2,
+          tx, ty, GST_VIDEO_TILE_X_TILES (sstride0),
+          GST_VIDEO_TILE_Y_TILES (sstride0)) << ts;
+      tile_copy_rows ((guint8 *) FRAME_GET_Y_LINE (dest, y) + x,
+          FRAME_GET_Y_STRIDE (dest), sy + offset, tile_width, w, rows);
+
+      offset = gst_video_tile_get_index (GST_VIDEO_TILE_MODE_ZFLIPZ_2X2,
+          tx, ty >> 1, GST_VIDEO_TILE_X_TILES (sstride1),
+          GST_VIDEO_TILE_Y_TILES (sstride1)) << ts;
+      offset |= (ty & 1) << (ts - 1);
+
+      if (split_uv) {
+        tile_split_rows ((guint8 *) FRAME_GET_U_LINE (dest, y >> 1) + x / 2,
+            FRAME_GET_U_STRIDE (dest),
+            (guint8 *) FRAME_GET_V_LINE (dest, y >> 1) + x / 2,
+            FRAME_GET_V_STRIDE (dest), suv + offset, tile_width, (w + 1) / 2,
+            crows);
+      } else {
+        tile_copy_rows ((guint8 *) FRAME_GET_PLANE_LINE (dest, 1, y >> 1) + x,
+            FRAME_GET_PLANE_STRIDE (dest, 1), suv + offset, tile_width,
+            GST_ROUND_UP_2 (w), crows);
+      }
+    }
+  }
+  tile_copy_finish ();
+}
+
+static void
+convert_NV12_64Z32_NV12 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_NV12_64Z32 (convert, src, dest, FALSE);
+}
+
+static void
+convert_NV12_64Z32_I420 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_NV12_64Z32 (convert, src, dest, TRUE);
+}
+
 static void
 convert_fill_border (GstVideoConverter * convert, GstVideoFrame * dest)
 {
@@ -3917,6 +5144,170 @@ convert_plane_hv (GstVideoConverter * convert,
       d, FRAME_GET_PLANE_STRIDE (dest, plane), 0, 0, out_width, out_height);
 }
 
+/* YUV -> YUV matrix conversion at the native chroma subsampling. The luma
+ * of each pixel is converted with the chroma of its block and the chroma
+ * with the average luma of the block. This avoids the round trip through
+ * 4:4:4 of the generic path. */
+static void
+convert_YUV_planes_matrix (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  MatrixData *data = &convert->convert_matrix;
+  const GstVideoFormatInfo *finfo = src->info.finfo;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  gint w_sub, h_sub, cw, ch, bw, bh, x, y, i, j;
+  gint s_ups, s_vps, d_ups, d_vps;
+  gint m[3][4];
+
+  if (data->matrix_func) {
+    memcpy (m, data->im, sizeof (m));
+  } else {
+    /* identity, prepare_matrix() didn't make the integer version */
+    memset (m, 0, sizeof (m));
+    m[0][0] = m[1][1] = m[2][2] = 1 << SCALE;
+  }
+
+  w_sub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, GST_VIDEO_COMP_U);
+  h_sub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, GST_VIDEO_COMP_U);
+  cw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, GST_VIDEO_COMP_U, width);
+  ch = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, GST_VIDEO_COMP_U, height);
+  bw = 1 << w_sub;
+  bh = 1 << h_sub;
+
+  s_ups = GST_VIDEO_FRAME_COMP_PSTRIDE (src, GST_VIDEO_COMP_U);
+  s_vps = GST_VIDEO_FRAME_COMP_PSTRIDE (src, GST_VIDEO_COMP_V);
+  d_ups = GST_VIDEO_FRAME_COMP_PSTRIDE (dest, GST_VIDEO_COMP_U);
+  d_vps = GST_VIDEO_FRAME_COMP_PSTRIDE (dest, GST_VIDEO_COMP_V);
+
+  for (y = 0; y < ch; y++) {
+    const guint8 *sy[2], *su, *sv;
+    guint8 *dy[2], *du, *dv;
+    gint n_lines = MIN (bh, height - y * bh);
+
+    for (j = 0; j < n_lines; j++) {
+      sy[j] = FRAME_GET_Y_LINE (src, y * bh + j);
+      dy[j] = FRAME_GET_Y_LINE (dest, y * bh + j);
+    }
+    su = FRAME_GET_U_LINE (src, y);
+    sv = FRAME_GET_V_LINE (src, y);
+    du = FRAME_GET_U_LINE (dest, y);
+    dv = FRAME_GET_V_LINE (dest, y);
+
+    for (x = 0; x < cw; x++) {
+      gint u, v, ysum, n, yc, uc, vc, val;
+      gint n_pixels = MIN (bw, width - x * bw);
+
+      u = su[x * s_ups];
+      v = sv[x * s_vps];
+
+      /* the chroma part of the luma is the same for the whole block */
+      yc = m[0][1] * u + m[0][2] * v + m[0][3];
+
+      ysum = 0;
+      for (j = 0; j < n_lines; j++) {
+        for (i = 0; i < n_pixels; i++) {
+          gint Y = sy[j][x * bw + i];
+
+          ysum += Y;
+          val = (m[0][0] * Y + yc) >> SCALE;
+          dy[j][x * bw + i] = CLAMP (val, 0, 255);
+        }
+      }
+      n = n_lines * n_pixels;
+      ysum = (ysum + (n >> 1)) / n;
+
+      uc = (m[1][0] * ysum + m[1][1] * u + m[1][2] * v + m[1][3]) >> SCALE;
+      vc = (m[2][0] * ysum + m[2][1] * u + m[2][2] * v + m[2][3]) >> SCALE;
+      du[x * d_ups] = CLAMP (uc, 0, 255);
+      dv[x * d_vps] = CLAMP (vc, 0, 255);
+    }
+  }
+}
+
+/* converts between the 8 and 10 bits variants of the same 4:2:0 layout
+ * (I420, NV12, I420_10LE and P010_10LE) in one pass. Samples are expanded
+ * and truncated exactly like the unpack/pack functions do so that the
+ * result is the same as the generic path without dithering. */
+static void
+convert_planes_depth (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  gint i, j, k;
+  const GstVideoFormatInfo *in_finfo = src->info.finfo;
+  const GstVideoFormatInfo *out_finfo = dest->info.finfo;
+
+  for (i = 0; i < 3; i++) {
+    gint in_depth, in_shift, out_depth, out_shift, lshift, rshift, oshift;
+    guint mask;
+    gint width, height, in_x, in_y, out_x, out_y, in_ps, out_ps, in_n, out_n;
+    gboolean in_16, out_16;
+
+    in_depth = GST_VIDEO_FORMAT_INFO_DEPTH (in_finfo, i);
+    in_shift = GST_VIDEO_FORMAT_INFO_SHIFT (in_finfo, i);
+    out_depth = GST_VIDEO_FORMAT_INFO_DEPTH (out_finfo, i);
+    out_shift = GST_VIDEO_FORMAT_INFO_SHIFT (out_finfo, i);
+    in_16 = in_depth > 8;
+    out_16 = out_depth > 8;
+
+    /* expand to 16 bits by replicating the high bits in the low bits and
+     * then keep the out_depth high bits */
+    lshift = 16 - in_depth;
+    rshift = 2 * in_depth - 16;
+    oshift = 16 - out_depth;
+    mask = (1 << in_depth) - 1;
+
+    width = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, i, convert->in_width);
+    height =
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (in_finfo, i, convert->in_height);
+    in_x = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, i, convert->in_x);
+    in_y = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (in_finfo, i, convert->in_y);
+    out_x = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo, i, convert->out_x);
+    out_y = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (out_finfo, i, convert->out_y);
+    in_ps = GST_VIDEO_FRAME_COMP_PSTRIDE (src, i);
+    out_ps = GST_VIDEO_FRAME_COMP_PSTRIDE (dest, i);
+    /* pixel strides in samples */
+    in_n = in_16 ? in_ps / 2 : in_ps;
+    out_n = out_16 ? out_ps / 2 : out_ps;
+
+    for (j = 0; j < height; j++) {
+      const guint8 *s;
+      guint8 *d;
+
+      s = FRAME_GET_COMP_LINE (src, i, in_y + j);
+      s += in_x * in_ps;
+      d = FRAME_GET_COMP_LINE (dest, i, out_y + j);
+      d += out_x * out_ps;
+
+      if (in_16 && out_16) {
+        const guint16 *s16 = (const guint16 *) s;
+        guint16 *d16 = (guint16 *) d;
+
+        for (k = 0; k < width; k++) {
+          guint v = (GUINT16_FROM_LE (s16[k * in_n]) >> in_shift) & mask;
+          v = (v << lshift) | (v >> rshift);
+          d16[k * out_n] = GUINT16_TO_LE ((v >> oshift) << out_shift);
+        }
+      } else if (in_16) {
+        const guint16 *s16 = (const guint16 *) s;
+
+        for (k = 0; k < width; k++) {
+          guint v = (GUINT16_FROM_LE (s16[k * in_n]) >> in_shift) & mask;
+          d[k * out_n] = v >> (in_depth - 8);
+        }
+      } else {
+        guint16 *d16 = (guint16 *) d;
+
+        for (k = 0; k < width; k++) {
+          guint v = s[k * in_n];
+          v = (v << 8) | v;
+          d16[k * out_n] = GUINT16_TO_LE ((v >> oshift) << out_shift);
+        }
+      }
+    }
+  }
+}
+
 static void
 convert_scale_planes (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest)
@@ -3951,6 +5342,12 @@ get_scale_format (GstVideoFormat format, gint plane)
       break;
     case GST_VIDEO_FORMAT_GRAY16_BE:
     case GST_VIDEO_FORMAT_GRAY16_LE:
+    case GST_VIDEO_FORMAT_I420_10BE:
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I422_10BE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_Y444_10BE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
       res = GST_VIDEO_FORMAT_GRAY16_BE;
       break;
     case GST_VIDEO_FORMAT_YUY2:
@@ -3993,12 +5390,6 @@ get_scale_format (GstVideoFormat format, gint plane)
     case GST_VIDEO_FORMAT_RGB8P:
     case GST_VIDEO_FORMAT_IYU1:
     case GST_VIDEO_FORMAT_r210:
-    case GST_VIDEO_FORMAT_I420_10BE:
-    case GST_VIDEO_FORMAT_I420_10LE:
-    case GST_VIDEO_FORMAT_I422_10BE:
-    case GST_VIDEO_FORMAT_I422_10LE:
-    case GST_VIDEO_FORMAT_Y444_10BE:
-    case GST_VIDEO_FORMAT_Y444_10LE:
     case GST_VIDEO_FORMAT_GBR_10BE:
     case GST_VIDEO_FORMAT_GBR_10LE:
     case GST_VIDEO_FORMAT_NV12_64Z32:
@@ -4065,8 +5456,14 @@ setup_scale (GstVideoConverter * convert)
     case GST_VIDEO_FORMAT_BGR16:
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
     case GST_VIDEO_FORMAT_GRAY16_BE:
+    case GST_VIDEO_FORMAT_I420_10BE:
+    case GST_VIDEO_FORMAT_I422_10BE:
+    case GST_VIDEO_FORMAT_Y444_10BE:
 #else
     case GST_VIDEO_FORMAT_GRAY16_LE:
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
 #endif
       if (method != GST_VIDEO_RESAMPLER_METHOD_NEAREST) {
         GST_DEBUG ("%s only with nearest resampling",
@@ -4074,6 +5471,24 @@ setup_scale (GstVideoConverter * convert)
         return FALSE;
       }
       break;
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+#else
+    case GST_VIDEO_FORMAT_I420_10BE:
+    case GST_VIDEO_FORMAT_I422_10BE:
+    case GST_VIDEO_FORMAT_Y444_10BE:
+#endif
+      /* the 16 bits scalers only clamp to 16 bits, filters with negative
+       * lobes would overshoot the 10 bits range */
+      if (method > GST_VIDEO_RESAMPLER_METHOD_LINEAR ||
+          cr_method > GST_VIDEO_RESAMPLER_METHOD_LINEAR) {
+        GST_DEBUG ("%s only with nearest or linear resampling",
+            gst_video_format_to_string (in_format));
+        return FALSE;
+      }
+      break;
     default:
       break;
   }
@@ -4622,6 +6037,14 @@ static const VideoTransform transforms[] = {
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_BGRA},
 #endif
 
+  /* detiling */
+  {GST_VIDEO_FORMAT_NV12_64Z32, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_64Z32_NV12},
+  {GST_VIDEO_FORMAT_NV12_64Z32, GST_VIDEO_FORMAT_I420, FALSE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_64Z32_I420},
+  {GST_VIDEO_FORMAT_NV12_64Z32, GST_VIDEO_FORMAT_YV12, FALSE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_64Z32_I420},
+
   /* scalers */
   {GST_VIDEO_FORMAT_GBR, GST_VIDEO_FORMAT_GBR, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -4671,6 +6094,62 @@ static const VideoTransform transforms[] = {
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
   {GST_VIDEO_FORMAT_GRAY16_BE, GST_VIDEO_FORMAT_GRAY16_BE, TRUE, FALSE, FALSE,
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+
+  /* matrix conversion at native subsampling */
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420, FALSE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_YV12, FALSE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_Y42B, GST_VIDEO_FORMAT_Y42B, TRUE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_Y444, GST_VIDEO_FORMAT_Y444, TRUE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV12, FALSE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_NV21, FALSE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_NV16, GST_VIDEO_FORMAT_NV16, TRUE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_NV61, GST_VIDEO_FORMAT_NV61, TRUE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+  {GST_VIDEO_FORMAT_NV24, GST_VIDEO_FORMAT_NV24, TRUE, TRUE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_YUV_planes_matrix},
+
+  /* 8 <-> 10 bits */
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_planes_depth},
+
+  /* scalers, 10 bits */
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, FALSE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+  {GST_VIDEO_FORMAT_I420_10BE, GST_VIDEO_FORMAT_I420_10BE, TRUE, FALSE, FALSE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+  {GST_VIDEO_FORMAT_I422_10LE, GST_VIDEO_FORMAT_I422_10LE, TRUE, FALSE, FALSE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+  {GST_VIDEO_FORMAT_I422_10BE, GST_VIDEO_FORMAT_I422_10BE, TRUE, FALSE, FALSE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+  {GST_VIDEO_FORMAT_Y444_10LE, GST_VIDEO_FORMAT_Y444_10LE, TRUE, FALSE, FALSE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
+  {GST_VIDEO_FORMAT_Y444_10BE, GST_VIDEO_FORMAT_Y444_10BE, TRUE, FALSE, FALSE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 };
 
 static gboolean
@@ -4699,6 +6178,12 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
   if (CHECK_GAMMA_REMAP (convert) && (!same_size || in_transf != out_transf))
     return FALSE;
 
+  /* fastpaths don't dither */
+  if (GET_OPT_DITHER_METHOD (convert) != GST_VIDEO_DITHER_NONE &&
+      GST_VIDEO_INFO_COMP_DEPTH (&convert->out_info, 0) <
+      GST_VIDEO_INFO_COMP_DEPTH (&convert->in_info, 0))
+    return FALSE;
+
   need_copy = (convert->alpha_mode & ALPHA_MODE_COPY) == ALPHA_MODE_COPY;
   need_set = (convert->alpha_mode & ALPHA_MODE_SET) == ALPHA_MODE_SET;
   need_mult = (convert->alpha_mode & ALPHA_MODE_MULT) == ALPHA_MODE_MULT;
@@ -4707,7 +6192,10 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
   in_format = GST_VIDEO_INFO_FORMAT (&convert->in_info);
   out_format = GST_VIDEO_INFO_FORMAT (&convert->out_info);
 
-  if (CHECK_MATRIX_NONE (convert)) {
+  if (convert->balance) {
+    /* only the fastpaths with a matrix can do the color balance */
+    same_matrix = FALSE;
+  } else if (CHECK_MATRIX_NONE (convert)) {
     same_matrix = TRUE;
   } else {
     GstVideoColorMatrix in_matrix, out_matrix;
@@ -4743,6 +6231,8 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
         (transforms[i].keeps_interlaced || !interlaced) &&
         (transforms[i].needs_color_matrix || (same_matrix && same_primaries))
         && (!transforms[i].keeps_size || same_size)
+        /* scaling fastpaths can't be split in bands */
+        && (transforms[i].keeps_size || convert->n_threads <= 1)
         && (transforms[i].width_align & width) == 0
         && (transforms[i].height_align & height) == 0
         && (transforms[i].do_crop || !crop)
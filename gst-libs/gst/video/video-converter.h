@@ -265,6 +265,108 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE   "GstVideoConverter.primaries-mode"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_THREADS:
+ *
+ * #G_TYPE_UINT, maximum number of threads to use. The output frame is
+ * split into horizontal bands that are converted in parallel. Default 1,
+ * 0 for the number of cores. Error diffusion dither methods always use one
+ * thread.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_THREADS   "GstVideoConverter.threads"
+
+/**
+ * GstVideoOrientationMethod:
+ * @GST_VIDEO_ORIENTATION_IDENTITY: Identity (no rotation)
+ * @GST_VIDEO_ORIENTATION_90R: Rotate clockwise 90 degrees
+ * @GST_VIDEO_ORIENTATION_180: Rotate 180 degrees
+ * @GST_VIDEO_ORIENTATION_90L: Rotate counter-clockwise 90 degrees
+ * @GST_VIDEO_ORIENTATION_HORIZ: Flip horizontally
+ * @GST_VIDEO_ORIENTATION_VERT: Flip vertically
+ * @GST_VIDEO_ORIENTATION_UL_LR: Flip across upper left/lower right diagonal
+ * @GST_VIDEO_ORIENTATION_UR_LL: Flip across upper right/lower left diagonal
+ *
+ * The different video orientation methods.
+ *
+ * Since: 1.10
+ */
+typedef enum {
+  GST_VIDEO_ORIENTATION_IDENTITY,
+  GST_VIDEO_ORIENTATION_90R,
+  GST_VIDEO_ORIENTATION_180,
+  GST_VIDEO_ORIENTATION_90L,
+  GST_VIDEO_ORIENTATION_HORIZ,
+  GST_VIDEO_ORIENTATION_VERT,
+  GST_VIDEO_ORIENTATION_UL_LR,
+  GST_VIDEO_ORIENTATION_UR_LL
+} GstVideoOrientationMethod;
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_ORIENTATION_METHOD:
+ *
+ * #GST_TYPE_VIDEO_ORIENTATION_METHOD, rotate or flip the image while it
+ * is packed. The output info and the destination window describe the
+ * image after the rotation, so the output is usually as wide as the input
+ * is high for the rotations by 90 degrees. Ignored for interlaced video.
+ * Default is #GST_VIDEO_ORIENTATION_IDENTITY.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_ORIENTATION_METHOD   "GstVideoConverter.orientation-method"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_STATS:
+ *
+ * #G_TYPE_BOOLEAN, measure the time spent in each conversion stage, see
+ * gst_video_converter_get_stats(). Default %FALSE.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_STATS   "GstVideoConverter.stats"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_BRIGHTNESS:
+ *
+ * #G_TYPE_DOUBLE, the value added to the luma, normalized to [0..1], in the
+ * range [-1.0..1.0]. The color balance options are folded into the color
+ * conversion matrix. Default 0.0.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_BRIGHTNESS   "GstVideoConverter.brightness"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_CONTRAST:
+ *
+ * #G_TYPE_DOUBLE, the factor for the luma, in the range [0.0..2.0].
+ * Default 1.0.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_CONTRAST   "GstVideoConverter.contrast"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_HUE:
+ *
+ * #G_TYPE_DOUBLE, rotate the chroma by this value times pi, in the range
+ * [-1.0..1.0]. Default 0.0.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_HUE   "GstVideoConverter.hue"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_SATURATION:
+ *
+ * #G_TYPE_DOUBLE, the factor for the chroma, in the range [0.0..2.0].
+ * Default 1.0.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_SATURATION   "GstVideoConverter.saturation"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
 GstVideoConverter *  gst_video_converter_new            (GstVideoInfo *in_info,
@@ -275,6 +377,8 @@ void                 gst_video_converter_free           (GstVideoConverter * con
 gboolean             gst_video_converter_set_config     (GstVideoConverter * convert, GstStructure *config);
 const GstStructure * gst_video_converter_get_config     (GstVideoConverter * convert);
 
+GstStructure *       gst_video_converter_get_stats      (GstVideoConverter * convert);
+
 void                 gst_video_converter_frame          (GstVideoConverter * convert,
                                                          const GstVideoFrame *src, GstVideoFrame *dest);
 
@@ -0,0 +1,199 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the dither loops that are not done with orc. They give
+ * exactly the same results as the C loops and return the index of the first
+ * component they did not do, the caller does the remainder.
+ *
+ * The error diffusion methods carry the error of a pixel to the next one,
+ * so they can't do more than one pixel at a time. They do the 4 components
+ * of a pixel together and keep the error of the previous pixel in a
+ * register instead. */
+
+#if defined (__SSE2__)
+#define HAVE_VIDEO_DITHER_SIMD
+#include <emmintrin.h>
+
+/* 4 components in 32 bits */
+static inline __m128i
+load_4u16_u32 (const guint16 * p)
+{
+  return _mm_unpacklo_epi16 (_mm_loadl_epi64 ((const __m128i *) p),
+      _mm_setzero_si128 ());
+}
+
+/* store 4 components of 32 bits, clamped to [0, 65535] */
+static inline void
+store_4u32_u16 (guint16 * p, __m128i v)
+{
+  /* the pack saturates to signed values */
+  v = _mm_packs_epi32 (_mm_sub_epi32 (v, _mm_set1_epi32 (0x8000)),
+      _mm_setzero_si128 ());
+  v = _mm_xor_si128 (v, _mm_set1_epi16 ((gint16) 0x8000));
+  _mm_storel_epi64 ((__m128i *) p, v);
+}
+
+static inline __m128i
+load_4u8_u16 (const guint8 * p)
+{
+  return _mm_unpacklo_epi8 (_mm_cvtsi32_si128 (GST_READ_UINT32_LE (p)),
+      _mm_setzero_si128 ());
+}
+
+static inline void
+store_4u16_u8 (guint8 * p, __m128i v)
+{
+  GST_WRITE_UINT32_LE (p, _mm_cvtsi128_si32 (_mm_packus_epi16 (v, v)));
+}
+
+static gint
+dither_verterr_u16_simd (guint16 * p, guint16 * e, const guint16 * mask,
+    gint i, gint end)
+{
+  const __m128i m = _mm_setr_epi16 (mask[0], mask[1], mask[2], mask[3],
+      mask[0], mask[1], mask[2], mask[3]);
+  const __m128i ones = _mm_set1_epi16 (-1);
+
+  for (; i + 8 <= end; i += 8) {
+    __m128i pv = _mm_loadu_si128 ((__m128i *) (p + i));
+    __m128i ev = _mm_loadu_si128 ((__m128i *) (e + i));
+    __m128i v = _mm_add_epi16 (pv, ev);
+    /* all bits set where the sum doesn't fit in 16 bits */
+    __m128i over = _mm_xor_si128 (_mm_cmpeq_epi16 (v,
+            _mm_adds_epu16 (pv, ev)), ones);
+
+    _mm_storeu_si128 ((__m128i *) (e + i), _mm_and_si128 (v, m));
+    _mm_storeu_si128 ((__m128i *) (p + i),
+        _mm_or_si128 (_mm_andnot_si128 (m, v), over));
+  }
+  return i;
+}
+
+/* the errors of the line above were already added to e with the
+ * 5 and 3 weights by video_orc_dither_fs_muladd_u8 */
+static gint
+dither_floyd_steinberg_u8_simd (guint8 * p, guint16 * e,
+    const guint16 * mask, gint i, gint end)
+{
+  const __m128i m = _mm_setr_epi16 (mask[0], mask[1], mask[2], mask[3],
+      0, 0, 0, 0);
+  __m128i el;
+
+  if (i >= end)
+    return i;
+
+  el = _mm_loadl_epi64 ((const __m128i *) (e + i));
+  for (; i < end; i += 4) {
+    __m128i t, v;
+
+    t = _mm_mullo_epi16 (el, _mm_set1_epi16 (7));
+    t = _mm_add_epi16 (t, _mm_loadl_epi64 ((const __m128i *) (e + i + 4)));
+    v = _mm_add_epi16 (load_4u8_u16 (p + i), _mm_srli_epi16 (t, 4));
+
+    el = _mm_and_si128 (v, m);
+    _mm_storel_epi64 ((__m128i *) (e + i + 4), el);
+    store_4u16_u8 (p + i, _mm_andnot_si128 (m, v));
+  }
+  return i;
+}
+
+static gint
+dither_floyd_steinberg_u16_simd (guint16 * p, guint16 * e,
+    const guint16 * mask, gint i, gint end)
+{
+  const __m128i m = _mm_setr_epi32 (mask[0], mask[1], mask[2], mask[3]);
+  __m128i el;
+
+  if (i >= end)
+    return i;
+
+  el = load_4u16_u32 (e + i);
+  for (; i < end; i += 4) {
+    __m128i e1, e2, e3, t, v;
+
+    /* 7 * left + below-left + 5 * below + 3 * below-right */
+    e1 = load_4u16_u32 (e + i + 4);
+    e2 = load_4u16_u32 (e + i + 8);
+    e3 = load_4u16_u32 (e + i + 12);
+    t = _mm_sub_epi32 (_mm_slli_epi32 (el, 3), el);
+    t = _mm_add_epi32 (t, e1);
+    t = _mm_add_epi32 (t, _mm_add_epi32 (_mm_slli_epi32 (e2, 2), e2));
+    t = _mm_add_epi32 (t, _mm_add_epi32 (_mm_slli_epi32 (e3, 1), e3));
+    v = _mm_add_epi32 (load_4u16_u32 (p + i), _mm_srli_epi32 (t, 4));
+
+    el = _mm_and_si128 (v, m);
+    store_4u32_u16 (e + i + 4, el);
+    store_4u32_u16 (p + i, _mm_andnot_si128 (m, v));
+  }
+  return i;
+}
+
+static gint
+dither_sierra_lite_u8_simd (guint8 * p, guint16 * e, const guint16 * mask,
+    gint i, gint end)
+{
+  const __m128i m = _mm_setr_epi16 (mask[0], mask[1], mask[2], mask[3],
+      0, 0, 0, 0);
+  __m128i el;
+
+  if (i >= end)
+    return i;
+
+  el = _mm_loadl_epi64 ((const __m128i *) (e + i));
+  for (; i < end; i += 4) {
+    __m128i t, v;
+
+    t = _mm_add_epi16 (el, el);
+    t = _mm_add_epi16 (t, _mm_loadl_epi64 ((const __m128i *) (e + i + 8)));
+    t = _mm_add_epi16 (t, _mm_loadl_epi64 ((const __m128i *) (e + i + 12)));
+    v = _mm_add_epi16 (load_4u8_u16 (p + i), _mm_srli_epi16 (t, 2));
+
+    el = _mm_and_si128 (v, m);
+    _mm_storel_epi64 ((__m128i *) (e + i + 4), el);
+    store_4u16_u8 (p + i, _mm_andnot_si128 (m, v));
+  }
+  return i;
+}
+
+static gint
+dither_sierra_lite_u16_simd (guint16 * p, guint16 * e, const guint16 * mask,
+    gint i, gint end)
+{
+  const __m128i m = _mm_setr_epi32 (mask[0], mask[1], mask[2], mask[3]);
+  __m128i el;
+
+  if (i >= end)
+    return i;
+
+  el = load_4u16_u32 (e + i);
+  for (; i < end; i += 4) {
+    __m128i t, v;
+
+    t = _mm_add_epi32 (el, el);
+    t = _mm_add_epi32 (t, load_4u16_u32 (e + i + 8));
+    t = _mm_add_epi32 (t, load_4u16_u32 (e + i + 12));
+    v = _mm_add_epi32 (load_4u16_u32 (p + i), _mm_srli_epi32 (t, 2));
+
+    el = _mm_and_si128 (v, m);
+    store_4u32_u16 (e + i + 4, el);
+    store_4u32_u16 (p + i, _mm_andnot_si128 (m, v));
+  }
+  return i;
+}
+#endif
@@ -21,6 +21,7 @@
 
 #include "video-dither.h"
 #include "video-orc.h"
+#include "video-dither-simd.h"
 
 /**
  * SECTION:gstvideodither
@@ -98,14 +99,18 @@ dither_verterr_u16 (GstVideoDither * dither, gpointer pixels, guint x, guint y,
     guint32 v, mp;
 
     end = (width + x) * 4;
-    for (i = x * 4; i < end; i++) {
+    i = x * 4;
+#ifdef HAVE_VIDEO_DITHER_SIMD
+    i = dither_verterr_u16_simd (p, e, m, i, end);
+#endif
+    for (; i < end; i++) {
       mp = m[i & 3];
       v = p[i] + e[i];
       /* take new error and store */
       e[i] = v & mp;
       /* quantize and store */
       v &= ~mp;
-      p[i] = MIN (v, 65535);
+      p[i] = MIN (v & ~mp, 65535);
     }
   }
 }
@@ -129,8 +134,11 @@ dither_floyd_steinberg_u8 (GstVideoDither * dither, gpointer pixels, guint x,
     guint16 v;
 
     end = (width + x) * 4;
-
-    for (i = x * 4; i < end; i++) {
+    i = x * 4;
+#ifdef HAVE_VIDEO_DITHER_SIMD
+    i = dither_floyd_steinberg_u8_simd (p, e, m, i, end);
+#endif
+    for (; i < end; i++) {
       mp = m[i & 3];
       v = p[i] + ((7 * e[i] + e[i + 4]) >> 4);
       /* take new error and store */
@@ -162,7 +170,11 @@ dither_floyd_steinberg_u16 (GstVideoDither * dither, gpointer pixels, guint x,
     guint32 v;
 
     end = (width + x) * 4;
-    for (i = x * 4; i < end; i++) {
+    i = x * 4;
+#ifdef HAVE_VIDEO_DITHER_SIMD
+    i = dither_floyd_steinberg_u16_simd (p, e, m, i, end);
+#endif
+    for (; i < end; i++) {
       mp = m[i & 3];
       /* apply previous errors to pixel */
       v = p[i] + ((7 * e[i] + e[i + 4] + 5 * e[i + 8] + 3 * e[i + 12]) >> 4);
@@ -170,7 +182,7 @@ dither_floyd_steinberg_u16 (GstVideoDither * dither, gpointer pixels, guint x,
       e[i + 4] = v & mp;
       /* quantize and store */
       v &= ~mp;
-      p[i] = MIN (v, 65535);
+      p[i] = MIN (v & ~mp, 65535);
     }
   }
 }
@@ -189,7 +201,11 @@ dither_sierra_lite_u8 (GstVideoDither * dither, gpointer pixels, guint x,
     memset (e + (x * 4), 0, (width + 4) * 8);
 
   end = (width + x) * 4;
-  for (i = x; i < end; i++) {
+  i = x * 4;
+#ifdef HAVE_VIDEO_DITHER_SIMD
+  i = dither_sierra_lite_u8_simd (p, e, m, i, end);
+#endif
+  for (; i < end; i++) {
     mp = m[i & 3];
     /* apply previous errors to pixel */
     v = p[i] + ((2 * e[i] + e[i + 8] + e[i + 12]) >> 2);
@@ -215,7 +231,11 @@ dither_sierra_lite_u16 (GstVideoDither * dither, gpointer pixels, guint x,
     memset (e + (x * 4), 0, (width + 4) * 8);
 
   end = (width + x) * 4;
-  for (i = x; i < end; i++) {
+  i = x * 4;
+#ifdef HAVE_VIDEO_DITHER_SIMD
+  i = dither_sierra_lite_u16_simd (p, e, m, i, end);
+#endif
+  for (; i < end; i++) {
     mp = m[i & 3];
     /* apply previous errors to pixel */
     v = p[i] + ((2 * e[i] + e[i + 8] + e[i + 12]) >> 2);
@@ -87,6 +87,73 @@ gst_video_event_parse_still_frame (GstEvent * event, gboolean * in_still)
   return TRUE;
 }
 
+#define GST_VIDEO_EVENT_FRAME_INTERVAL_NAME "GstEventVideoFrameInterval"
+
+/**
+ * gst_video_event_new_frame_interval:
+ * @interval: the minimum time between the frames used downstream, or
+ *     %GST_CLOCK_TIME_NONE
+ *
+ * Creates a new upstream frame interval event. It tells upstream that only
+ * one frame per @interval of running time is used downstream and that the
+ * other frames will be dropped, for example by a rate converter that
+ * reduces the framerate. A decoder can then skip the decoding of frames
+ * nobody else depends on. %GST_CLOCK_TIME_NONE cancels a previous event.
+ *
+ * To parse an event created by gst_video_event_new_frame_interval() use
+ * gst_video_event_parse_frame_interval().
+ *
+ * Returns: The new GstEvent
+ *
+ * Since: 1.10
+ */
+GstEvent *
+gst_video_event_new_frame_interval (GstClockTime interval)
+{
+  GstStructure *s;
+
+  s = gst_structure_new (GST_VIDEO_EVENT_FRAME_INTERVAL_NAME,
+      "interval", GST_TYPE_CLOCK_TIME, interval, NULL);
+
+  return gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM, s);
+}
+
+/**
+ * gst_video_event_parse_frame_interval:
+ * @event: A #GstEvent to parse
+ * @interval: (out) (allow-none): the frame interval, or %NULL
+ *
+ * Parse a #GstEvent, identify if it is a frame interval event, and
+ * return the interval from the event if it is.
+ *
+ * Create a frame interval event using gst_video_event_new_frame_interval()
+ *
+ * Returns: %TRUE if the event is a valid frame interval event. %FALSE if not
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_video_event_parse_frame_interval (GstEvent * event, GstClockTime * interval)
+{
+  const GstStructure *s;
+  GstClockTime ev_interval;
+
+  g_return_val_if_fail (event != NULL, FALSE);
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_CUSTOM_UPSTREAM)
+    return FALSE;
+
+  s = gst_event_get_structure (event);
+  if (s == NULL
+      || !gst_structure_has_name (s, GST_VIDEO_EVENT_FRAME_INTERVAL_NAME))
+    return FALSE;
+  if (!gst_structure_get_clock_time (s, "interval", &ev_interval))
+    return FALSE;
+  if (interval)
+    *interval = ev_interval;
+  return TRUE;
+}
+
 #define GST_VIDEO_EVENT_FORCE_KEY_UNIT_NAME "GstForceKeyUnit"
 
 /**
@@ -30,6 +30,12 @@ GstEvent *     gst_video_event_new_still_frame   (gboolean in_still);
 
 gboolean       gst_video_event_parse_still_frame (GstEvent * event, gboolean * in_still);
 
+/* video frame interval event creation and parsing */
+
+GstEvent *     gst_video_event_new_frame_interval   (GstClockTime interval);
+
+gboolean       gst_video_event_parse_frame_interval (GstEvent * event, GstClockTime * interval);
+
 /* video force key unit event creation and parsing */
 
 GstEvent * gst_video_event_new_downstream_force_key_unit (GstClockTime timestamp,
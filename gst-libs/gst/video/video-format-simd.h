@@ -0,0 +1,660 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* SIMD versions of the pack and unpack functions of some of the formats
+ * that are converted most often. They give exactly the same results as the
+ * C loops in video-format.c and return the number of pixels done, the
+ * caller does the remainder. The unpack functions write AYUV, ARGB or
+ * AYUV64 in the native layout, so the NEON versions are only used on little
+ * endian. */
+
+#if defined (__SSE2__)
+#define HAVE_VIDEO_FORMAT_SIMD
+#include <emmintrin.h>
+
+/* move lane @n of @v to lane 0 */
+#define LANE(v,n) _mm_shuffle_epi32 (v, n)
+
+/* combine lane 0 of @a, @b, @c and @d */
+static inline __m128i
+gather_epi32 (__m128i a, __m128i b, __m128i c, __m128i d)
+{
+  return _mm_unpacklo_epi64 (_mm_unpacklo_epi32 (a, b),
+      _mm_unpacklo_epi32 (c, d));
+}
+
+/* the even 16 bit lanes of @v in the low 64 bits */
+static inline __m128i
+even_epi16 (__m128i v)
+{
+  v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (3, 1, 2, 0));
+  v = _mm_shufflehi_epi16 (v, _MM_SHUFFLE (3, 1, 2, 0));
+  return _mm_shuffle_epi32 (v, _MM_SHUFFLE (3, 1, 2, 0));
+}
+
+static inline __m128i
+scale_10_epi32 (__m128i c, gboolean truncate)
+{
+  __m128i r = _mm_slli_epi32 (c, 6);
+
+  if (!truncate)
+    r = _mm_or_si128 (r, _mm_srli_epi32 (c, 4));
+  return r;
+}
+
+/* every 16 bytes of v210 contain 6 pixels: [u0,y1,v2,y4] in bits 0-9,
+ * [y0,u2,y3,v4] in bits 10-19 and [v0,y2,u4,y5] in bits 20-29 */
+static gint
+unpack_v210_simd (guint16 * d, const guint8 * s, gint width,
+    gboolean truncate)
+{
+  const __m128i mask = _mm_set1_epi32 (0x3ff);
+  const __m128i alpha = _mm_set1_epi32 (0xffff);
+  gint i;
+
+  for (i = 0; i + 6 <= width; i += 6) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + (i / 6) * 16));
+    __m128i c0, c1, c2, y0123, y45, u, w, uv;
+
+    c0 = scale_10_epi32 (_mm_and_si128 (v, mask), truncate);
+    c1 = scale_10_epi32 (_mm_and_si128 (_mm_srli_epi32 (v, 10), mask),
+        truncate);
+    c2 = scale_10_epi32 (_mm_and_si128 (_mm_srli_epi32 (v, 20), mask),
+        truncate);
+
+    y0123 = gather_epi32 (c1, LANE (c0, 1), LANE (c2, 1), LANE (c1, 2));
+    y45 = _mm_unpacklo_epi32 (LANE (c0, 3), LANE (c2, 3));
+    u = gather_epi32 (c0, LANE (c1, 1), LANE (c2, 2), c0);
+    w = gather_epi32 (c2, LANE (c0, 2), LANE (c1, 3), c2);
+
+    y0123 = _mm_or_si128 (_mm_slli_epi32 (y0123, 16), alpha);
+    y45 = _mm_or_si128 (_mm_slli_epi32 (y45, 16), alpha);
+    uv = _mm_or_si128 (u, _mm_slli_epi32 (w, 16));
+
+    w = _mm_unpacklo_epi32 (uv, uv);
+    _mm_storeu_si128 ((__m128i *) (d + 4 * i + 0),
+        _mm_unpacklo_epi32 (y0123, w));
+    _mm_storeu_si128 ((__m128i *) (d + 4 * i + 8),
+        _mm_unpackhi_epi32 (y0123, w));
+    _mm_storeu_si128 ((__m128i *) (d + 4 * i + 16),
+        _mm_unpacklo_epi32 (y45, _mm_unpackhi_epi32 (uv, uv)));
+  }
+  return i;
+}
+
+static gint
+pack_v210_simd (guint8 * d, const guint16 * s, gint width)
+{
+  gint i;
+
+  for (i = 0; i + 6 <= width; i += 6) {
+    __m128i r0 = _mm_loadu_si128 ((const __m128i *) (s + 4 * i + 0));
+    __m128i r1 = _mm_loadu_si128 ((const __m128i *) (s + 4 * i + 8));
+    __m128i r2 = _mm_loadu_si128 ((const __m128i *) (s + 4 * i + 16));
+    /* [y, v, y, v] and [x, u, x, u] of 2 pixels, 10 bits */
+    __m128i t0 = _mm_srli_epi32 (r0, 22);
+    __m128i t1 = _mm_srli_epi32 (r1, 22);
+    __m128i t2 = _mm_srli_epi32 (r2, 22);
+    __m128i u0 = _mm_srli_epi32 (_mm_slli_epi32 (r0, 16), 22);
+    __m128i u1 = _mm_srli_epi32 (_mm_slli_epi32 (r1, 16), 22);
+    __m128i u2 = _mm_srli_epi32 (_mm_slli_epi32 (r2, 16), 22);
+    __m128i lo, mid, hi;
+
+    lo = gather_epi32 (LANE (u0, 1), LANE (t0, 2), LANE (t1, 1), t2);
+    mid = gather_epi32 (t0, LANE (u1, 1), LANE (t1, 2), LANE (t2, 1));
+    hi = gather_epi32 (LANE (t0, 1), t1, LANE (u2, 1), LANE (t2, 2));
+
+    _mm_storeu_si128 ((__m128i *) (d + (i / 6) * 16),
+        _mm_or_si128 (lo, _mm_or_si128 (_mm_slli_epi32 (mid, 10),
+                _mm_slli_epi32 (hi, 20))));
+  }
+  return i;
+}
+
+#undef LANE
+
+/* YUY2 and UYVY, @pairs is the number of macropixels */
+static gint
+unpack_422_simd (guint8 * d, const guint8 * s, gint pairs, gboolean uyvy)
+{
+  const __m128i mask = _mm_set1_epi16 (0xff);
+  gint i;
+
+  for (i = 0; i + 4 <= pairs; i += 4) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + 4 * i));
+    __m128i y, c, ay, uv;
+
+    if (uyvy) {
+      y = _mm_srli_epi16 (v, 8);
+      c = _mm_and_si128 (v, mask);
+    } else {
+      y = _mm_and_si128 (v, mask);
+      c = _mm_srli_epi16 (v, 8);
+    }
+    ay = _mm_or_si128 (_mm_slli_epi16 (y, 8), mask);
+    uv = _mm_packus_epi16 (c, c);
+    uv = _mm_unpacklo_epi16 (uv, uv);
+
+    _mm_storeu_si128 ((__m128i *) (d + 8 * i), _mm_unpacklo_epi16 (ay, uv));
+    _mm_storeu_si128 ((__m128i *) (d + 8 * i + 16),
+        _mm_unpackhi_epi16 (ay, uv));
+  }
+  return i;
+}
+
+static gint
+pack_422_simd (guint8 * d, const guint8 * s, gint pairs, gboolean uyvy)
+{
+  const __m128i mask = _mm_set1_epi32 (0xff);
+  gint i;
+
+  for (i = 0; i + 4 <= pairs; i += 4) {
+    __m128i p0 = _mm_loadu_si128 ((const __m128i *) (s + 8 * i));
+    __m128i p1 = _mm_loadu_si128 ((const __m128i *) (s + 8 * i + 16));
+    __m128i y, c;
+
+    y = _mm_packs_epi32 (_mm_and_si128 (_mm_srli_epi32 (p0, 8), mask),
+        _mm_and_si128 (_mm_srli_epi32 (p1, 8), mask));
+    /* the u and v bytes of the even pixels */
+    c = _mm_unpacklo_epi64 (_mm_shuffle_epi32 (p0, _MM_SHUFFLE (3, 1, 2, 0)),
+        _mm_shuffle_epi32 (p1, _MM_SHUFFLE (3, 1, 2, 0)));
+    c = even_epi16 (_mm_srli_epi32 (c, 16));
+    c = _mm_unpacklo_epi8 (c, _mm_setzero_si128 ());
+
+    if (uyvy)
+      c = _mm_or_si128 (c, _mm_slli_epi16 (y, 8));
+    else
+      c = _mm_or_si128 (y, _mm_slli_epi16 (c, 8));
+    _mm_storeu_si128 ((__m128i *) (d + 4 * i), c);
+  }
+  return i;
+}
+
+/* 8 pixels of AYUV64 from 8 luma and 4 interleaved chroma values */
+static inline void
+store_ayuv64_8 (guint16 * d, __m128i y, __m128i uv)
+{
+  const __m128i alpha = _mm_set1_epi16 (-1);
+  __m128i ay, uv2;
+
+  ay = _mm_unpacklo_epi16 (alpha, y);
+  uv2 = _mm_unpacklo_epi32 (uv, uv);
+  _mm_storeu_si128 ((__m128i *) (d + 0), _mm_unpacklo_epi32 (ay, uv2));
+  _mm_storeu_si128 ((__m128i *) (d + 8), _mm_unpackhi_epi32 (ay, uv2));
+  ay = _mm_unpackhi_epi16 (alpha, y);
+  uv2 = _mm_unpackhi_epi32 (uv, uv);
+  _mm_storeu_si128 ((__m128i *) (d + 16), _mm_unpacklo_epi32 (ay, uv2));
+  _mm_storeu_si128 ((__m128i *) (d + 24), _mm_unpackhi_epi32 (ay, uv2));
+}
+
+/* 8 pixels of AYUV64 to 8 luma and 8 chroma values */
+static inline void
+load_ayuv64_8 (const guint16 * s, __m128i * y, __m128i * u, __m128i * v)
+{
+  __m128i r0 = _mm_loadu_si128 ((const __m128i *) (s + 0));
+  __m128i r1 = _mm_loadu_si128 ((const __m128i *) (s + 8));
+  __m128i r2 = _mm_loadu_si128 ((const __m128i *) (s + 16));
+  __m128i r3 = _mm_loadu_si128 ((const __m128i *) (s + 24));
+  __m128i a, b, ay0, uv0, ay1, uv1;
+
+  a = _mm_unpacklo_epi16 (r0, r1);
+  b = _mm_unpackhi_epi16 (r0, r1);
+  ay0 = _mm_unpacklo_epi16 (a, b);
+  uv0 = _mm_unpackhi_epi16 (a, b);
+  a = _mm_unpacklo_epi16 (r2, r3);
+  b = _mm_unpackhi_epi16 (r2, r3);
+  ay1 = _mm_unpacklo_epi16 (a, b);
+  uv1 = _mm_unpackhi_epi16 (a, b);
+
+  *y = _mm_unpackhi_epi64 (ay0, ay1);
+  *u = _mm_unpacklo_epi64 (uv0, uv1);
+  *v = _mm_unpackhi_epi64 (uv0, uv1);
+}
+
+static gint
+unpack_I420_10LE_simd (guint16 * d, const guint16 * sy, const guint16 * su,
+    const guint16 * sv, gint width, gboolean truncate)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    __m128i y = _mm_slli_epi16 (_mm_loadu_si128 ((const __m128i *) (sy + i)),
+        6);
+    __m128i uv = _mm_unpacklo_epi16 (_mm_loadl_epi64 ((const __m128i *) (su +
+                i / 2)), _mm_loadl_epi64 ((const __m128i *) (sv + i / 2)));
+
+    uv = _mm_slli_epi16 (uv, 6);
+    if (!truncate) {
+      y = _mm_or_si128 (y, _mm_srli_epi16 (y, 10));
+      uv = _mm_or_si128 (uv, _mm_srli_epi16 (uv, 10));
+    }
+    store_ayuv64_8 (d + 4 * i, y, uv);
+  }
+  return i;
+}
+
+static gint
+pack_I420_10LE_simd (guint16 * dy, guint16 * du, guint16 * dv,
+    const guint16 * s, gint width, gboolean chroma)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    __m128i y, u, v;
+
+    load_ayuv64_8 (s + 4 * i, &y, &u, &v);
+    _mm_storeu_si128 ((__m128i *) (dy + i), _mm_srli_epi16 (y, 6));
+    if (chroma) {
+      _mm_storel_epi64 ((__m128i *) (du + i / 2),
+          even_epi16 (_mm_srli_epi16 (u, 6)));
+      _mm_storel_epi64 ((__m128i *) (dv + i / 2),
+          even_epi16 (_mm_srli_epi16 (v, 6)));
+    }
+  }
+  return i;
+}
+
+static gint
+unpack_P010_10LE_simd (guint16 * d, const guint16 * sy, const guint16 * suv,
+    gint width, gboolean truncate)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    __m128i y = _mm_loadu_si128 ((const __m128i *) (sy + i));
+    __m128i uv = _mm_loadu_si128 ((const __m128i *) (suv + i));
+
+    if (!truncate) {
+      y = _mm_or_si128 (y, _mm_srli_epi16 (y, 10));
+      uv = _mm_or_si128 (uv, _mm_srli_epi16 (uv, 10));
+    }
+    store_ayuv64_8 (d + 4 * i, y, uv);
+  }
+  return i;
+}
+
+static gint
+pack_P010_10LE_simd (guint16 * dy, guint16 * duv, const guint16 * s,
+    gint width, gboolean chroma)
+{
+  const __m128i mask = _mm_set1_epi16 ((gint16) 0xffc0);
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    __m128i y, u, v;
+
+    load_ayuv64_8 (s + 4 * i, &y, &u, &v);
+    _mm_storeu_si128 ((__m128i *) (dy + i), _mm_and_si128 (y, mask));
+    if (chroma) {
+      u = even_epi16 (_mm_and_si128 (u, mask));
+      v = even_epi16 (_mm_and_si128 (v, mask));
+      _mm_storeu_si128 ((__m128i *) (duv + i), _mm_unpacklo_epi16 (u, v));
+    }
+  }
+  return i;
+}
+
+#if defined (__SSSE3__)
+#define HAVE_VIDEO_FORMAT_SIMD_RGB
+#include <tmmintrin.h>
+
+/* 16 bytes are loaded and stored for every 4 pixels, so the last 2 pixels
+ * are left to the caller */
+static gint
+unpack_RGB_simd (guint8 * d, const guint8 * s, gint width, gboolean bgr)
+{
+  const __m128i alpha = _mm_set1_epi32 (0xff);
+  const __m128i shuf = bgr ?
+      _mm_setr_epi8 (-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9) :
+      _mm_setr_epi8 (-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  gint i;
+
+  for (i = 0; i + 6 <= width; i += 4) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + 3 * i));
+
+    _mm_storeu_si128 ((__m128i *) (d + 4 * i),
+        _mm_or_si128 (_mm_shuffle_epi8 (v, shuf), alpha));
+  }
+  return i;
+}
+
+static gint
+pack_RGB_simd (guint8 * d, const guint8 * s, gint width, gboolean bgr)
+{
+  const __m128i shuf = bgr ?
+      _mm_setr_epi8 (3, 2, 1, 7, 6, 5, 11, 10, 9, 15, 14, 13, -1, -1, -1, -1) :
+      _mm_setr_epi8 (1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1);
+  gint i;
+
+  /* the 4 extra bytes are overwritten by the next pixels */
+  for (i = 0; i + 6 <= width; i += 4) {
+    __m128i v = _mm_loadu_si128 ((const __m128i *) (s + 4 * i));
+
+    _mm_storeu_si128 ((__m128i *) (d + 3 * i), _mm_shuffle_epi8 (v, shuf));
+  }
+  return i;
+}
+#endif /* __SSSE3__ */
+
+#elif (defined (__ARM_NEON) || defined (__ARM_NEON__)) && \
+    G_BYTE_ORDER == G_LITTLE_ENDIAN
+#define HAVE_VIDEO_FORMAT_SIMD
+#define HAVE_VIDEO_FORMAT_SIMD_RGB
+#include <arm_neon.h>
+
+/* byte offsets of the 16 bit lanes in the tables of the v210 functions */
+static const guint8 v210_unpack_idx[6][8] = {
+  {8, 9, 2, 3, 18, 19, 12, 13}, /* y0 y1 y2 y3 */
+  {0, 1, 0, 1, 10, 11, 10, 11}, /* u0 u0 u2 u2 */
+  {16, 17, 16, 17, 4, 5, 4, 5}, /* v0 v0 v2 v2 */
+  {6, 7, 22, 23, 6, 7, 22, 23}, /* y4 y5 */
+  {20, 21, 20, 21, 20, 21, 20, 21},     /* u4 u4 */
+  {14, 15, 14, 15, 14, 15, 14, 15},     /* v4 v4 */
+};
+
+static const guint8 v210_pack_idx[3][8] = {
+  {2, 3, 12, 13, 18, 19, 24, 25},
+  {0, 1, 10, 11, 20, 21, 26, 27},
+  {2, 3, 8, 9, 18, 19, 28, 29},
+};
+
+static inline uint16x4_t
+scale_10_u16 (uint32x4_t c, gboolean truncate)
+{
+  uint16x4_t r = vmovn_u32 (c);
+
+  if (truncate)
+    return vshl_n_u16 (r, 6);
+  return vorr_u16 (vshl_n_u16 (r, 6), vshr_n_u16 (r, 4));
+}
+
+/* every 16 bytes of v210 contain 6 pixels: [u0,y1,v2,y4] in bits 0-9,
+ * [y0,u2,y3,v4] in bits 10-19 and [v0,y2,u4,y5] in bits 20-29 */
+static gint
+unpack_v210_simd (guint16 * d, const guint8 * s, gint width,
+    gboolean truncate)
+{
+  const uint32x4_t mask = vdupq_n_u32 (0x3ff);
+  gint i;
+
+  for (i = 0; i + 6 <= width; i += 6) {
+    uint32x4_t v = vreinterpretq_u32_u8 (vld1q_u8 (s + (i / 6) * 16));
+    uint8x8x3_t t;
+    uint16x4x4_t p;
+
+    t.val[0] = vreinterpret_u8_u16 (scale_10_u16 (vandq_u32 (v, mask),
+            truncate));
+    t.val[1] = vreinterpret_u8_u16 (scale_10_u16 (vandq_u32 (vshrq_n_u32 (v,
+                    10), mask), truncate));
+    t.val[2] = vreinterpret_u8_u16 (scale_10_u16 (vandq_u32 (vshrq_n_u32 (v,
+                    20), mask), truncate));
+
+    p.val[0] = vdup_n_u16 (0xffff);
+    p.val[1] = vreinterpret_u16_u8 (vtbl3_u8 (t, vld1_u8 (v210_unpack_idx[0])));
+    p.val[2] = vreinterpret_u16_u8 (vtbl3_u8 (t, vld1_u8 (v210_unpack_idx[1])));
+    p.val[3] = vreinterpret_u16_u8 (vtbl3_u8 (t, vld1_u8 (v210_unpack_idx[2])));
+    vst4_u16 (d + 4 * i, p);
+
+    p.val[1] = vreinterpret_u16_u8 (vtbl3_u8 (t, vld1_u8 (v210_unpack_idx[3])));
+    p.val[2] = vreinterpret_u16_u8 (vtbl3_u8 (t, vld1_u8 (v210_unpack_idx[4])));
+    p.val[3] = vreinterpret_u16_u8 (vtbl3_u8 (t, vld1_u8 (v210_unpack_idx[5])));
+    vst4_lane_u16 (d + 4 * i + 16, p, 0);
+    vst4_lane_u16 (d + 4 * i + 20, p, 1);
+  }
+  return i;
+}
+
+static gint
+pack_v210_simd (guint8 * d, const guint16 * s, gint width)
+{
+  gint i;
+
+  for (i = 0; i + 6 <= width; i += 6) {
+    uint32x4_t r0 = vreinterpretq_u32_u16 (vld1q_u16 (s + 4 * i + 0));
+    uint32x4_t r1 = vreinterpretq_u32_u16 (vld1q_u16 (s + 4 * i + 8));
+    uint32x4_t r2 = vreinterpretq_u32_u16 (vld1q_u16 (s + 4 * i + 16));
+    /* [y, v, y, v] and [x, u, x, u] of 2 pixels, 10 bits */
+    uint8x8_t t0 = vreinterpret_u8_u16 (vmovn_u32 (vshrq_n_u32 (r0, 22)));
+    uint8x8_t t1 = vreinterpret_u8_u16 (vmovn_u32 (vshrq_n_u32 (r1, 22)));
+    uint8x8_t t2 = vreinterpret_u8_u16 (vmovn_u32 (vshrq_n_u32 (r2, 22)));
+    uint8x8_t u0 = vreinterpret_u8_u16 (vmovn_u32 (vshrq_n_u32 (vshlq_n_u32
+                (r0, 16), 22)));
+    uint8x8_t u1 = vreinterpret_u8_u16 (vmovn_u32 (vshrq_n_u32 (vshlq_n_u32
+                (r1, 16), 22)));
+    uint8x8_t u2 = vreinterpret_u8_u16 (vmovn_u32 (vshrq_n_u32 (vshlq_n_u32
+                (r2, 16), 22)));
+    uint8x8x4_t t;
+    uint32x4_t lo, mid, hi;
+
+    t.val[0] = u0;
+    t.val[1] = t0;
+    t.val[2] = t1;
+    t.val[3] = t2;
+    lo = vmovl_u16 (vreinterpret_u16_u8 (vtbl4_u8 (t,
+                vld1_u8 (v210_pack_idx[0]))));
+    t.val[0] = t0;
+    t.val[1] = u1;
+    mid = vmovl_u16 (vreinterpret_u16_u8 (vtbl4_u8 (t,
+                vld1_u8 (v210_pack_idx[1]))));
+    t.val[1] = t1;
+    t.val[2] = u2;
+    hi = vmovl_u16 (vreinterpret_u16_u8 (vtbl4_u8 (t,
+                vld1_u8 (v210_pack_idx[2]))));
+
+    vst1q_u8 (d + (i / 6) * 16, vreinterpretq_u8_u32 (vorrq_u32 (lo,
+                vorrq_u32 (vshlq_n_u32 (mid, 10), vshlq_n_u32 (hi, 20)))));
+  }
+  return i;
+}
+
+/* YUY2 and UYVY, @pairs is the number of macropixels */
+static gint
+unpack_422_simd (guint8 * d, const guint8 * s, gint pairs, gboolean uyvy)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= pairs; i += 8) {
+    uint8x8x4_t v = vld4_u8 (s + 4 * i);
+    uint8x8x2_t y, u, w;
+    uint8x8x4_t p;
+
+    if (uyvy) {
+      y = vzip_u8 (v.val[1], v.val[3]);
+      u = vzip_u8 (v.val[0], v.val[0]);
+      w = vzip_u8 (v.val[2], v.val[2]);
+    } else {
+      y = vzip_u8 (v.val[0], v.val[2]);
+      u = vzip_u8 (v.val[1], v.val[1]);
+      w = vzip_u8 (v.val[3], v.val[3]);
+    }
+    p.val[0] = vdup_n_u8 (0xff);
+    p.val[1] = y.val[0];
+    p.val[2] = u.val[0];
+    p.val[3] = w.val[0];
+    vst4_u8 (d + 8 * i, p);
+    p.val[1] = y.val[1];
+    p.val[2] = u.val[1];
+    p.val[3] = w.val[1];
+    vst4_u8 (d + 8 * i + 32, p);
+  }
+  return i;
+}
+
+static gint
+pack_422_simd (guint8 * d, const guint8 * s, gint pairs, gboolean uyvy)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= pairs; i += 8) {
+    uint8x16x4_t v = vld4q_u8 (s + 8 * i);
+    uint8x16x2_t y = vuzpq_u8 (v.val[1], v.val[1]);
+    uint8x8_t u = vget_low_u8 (vuzpq_u8 (v.val[2], v.val[2]).val[0]);
+    uint8x8_t w = vget_low_u8 (vuzpq_u8 (v.val[3], v.val[3]).val[0]);
+    uint8x8x4_t p;
+
+    if (uyvy) {
+      p.val[0] = u;
+      p.val[1] = vget_low_u8 (y.val[0]);
+      p.val[2] = w;
+      p.val[3] = vget_low_u8 (y.val[1]);
+    } else {
+      p.val[0] = vget_low_u8 (y.val[0]);
+      p.val[1] = u;
+      p.val[2] = vget_low_u8 (y.val[1]);
+      p.val[3] = w;
+    }
+    vst4_u8 (d + 4 * i, p);
+  }
+  return i;
+}
+
+static gint
+unpack_I420_10LE_simd (guint16 * d, const guint16 * sy, const guint16 * su,
+    const guint16 * sv, gint width, gboolean truncate)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    uint16x8_t y = vshlq_n_u16 (vld1q_u16 (sy + i), 6);
+    uint16x4x2_t u = vzip_u16 (vld1_u16 (su + i / 2), vld1_u16 (su + i / 2));
+    uint16x4x2_t v = vzip_u16 (vld1_u16 (sv + i / 2), vld1_u16 (sv + i / 2));
+    uint16x8x4_t p;
+
+    p.val[0] = vdupq_n_u16 (0xffff);
+    p.val[1] = y;
+    p.val[2] = vshlq_n_u16 (vcombine_u16 (u.val[0], u.val[1]), 6);
+    p.val[3] = vshlq_n_u16 (vcombine_u16 (v.val[0], v.val[1]), 6);
+    if (!truncate) {
+      p.val[1] = vorrq_u16 (y, vshrq_n_u16 (y, 10));
+      p.val[2] = vorrq_u16 (p.val[2], vshrq_n_u16 (p.val[2], 10));
+      p.val[3] = vorrq_u16 (p.val[3], vshrq_n_u16 (p.val[3], 10));
+    }
+    vst4q_u16 (d + 4 * i, p);
+  }
+  return i;
+}
+
+static gint
+pack_I420_10LE_simd (guint16 * dy, guint16 * du, guint16 * dv,
+    const guint16 * s, gint width, gboolean chroma)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    uint16x8x4_t p = vld4q_u16 (s + 4 * i);
+
+    vst1q_u16 (dy + i, vshrq_n_u16 (p.val[1], 6));
+    if (chroma) {
+      vst1_u16 (du + i / 2,
+          vshr_n_u16 (vget_low_u16 (vuzpq_u16 (p.val[2], p.val[2]).val[0]),
+              6));
+      vst1_u16 (dv + i / 2,
+          vshr_n_u16 (vget_low_u16 (vuzpq_u16 (p.val[3], p.val[3]).val[0]),
+              6));
+    }
+  }
+  return i;
+}
+
+static gint
+unpack_P010_10LE_simd (guint16 * d, const guint16 * sy, const guint16 * suv,
+    gint width, gboolean truncate)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    uint16x8_t y = vld1q_u16 (sy + i);
+    uint16x4x2_t uv = vld2_u16 (suv + i);
+    uint16x4x2_t u = vzip_u16 (uv.val[0], uv.val[0]);
+    uint16x4x2_t v = vzip_u16 (uv.val[1], uv.val[1]);
+    uint16x8x4_t p;
+
+    p.val[0] = vdupq_n_u16 (0xffff);
+    p.val[1] = y;
+    p.val[2] = vcombine_u16 (u.val[0], u.val[1]);
+    p.val[3] = vcombine_u16 (v.val[0], v.val[1]);
+    if (!truncate) {
+      p.val[1] = vorrq_u16 (y, vshrq_n_u16 (y, 10));
+      p.val[2] = vorrq_u16 (p.val[2], vshrq_n_u16 (p.val[2], 10));
+      p.val[3] = vorrq_u16 (p.val[3], vshrq_n_u16 (p.val[3], 10));
+    }
+    vst4q_u16 (d + 4 * i, p);
+  }
+  return i;
+}
+
+static gint
+pack_P010_10LE_simd (guint16 * dy, guint16 * duv, const guint16 * s,
+    gint width, gboolean chroma)
+{
+  const uint16x8_t mask = vdupq_n_u16 (0xffc0);
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    uint16x8x4_t p = vld4q_u16 (s + 4 * i);
+
+    vst1q_u16 (dy + i, vandq_u16 (p.val[1], mask));
+    if (chroma) {
+      uint16x4x2_t uv;
+
+      uv.val[0] = vand_u16 (vget_low_u16 (vuzpq_u16 (p.val[2],
+                  p.val[2]).val[0]), vget_low_u16 (mask));
+      uv.val[1] = vand_u16 (vget_low_u16 (vuzpq_u16 (p.val[3],
+                  p.val[3]).val[0]), vget_low_u16 (mask));
+      vst2_u16 (duv + i, uv);
+    }
+  }
+  return i;
+}
+
+static gint
+unpack_RGB_simd (guint8 * d, const guint8 * s, gint width, gboolean bgr)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    uint8x8x3_t v = vld3_u8 (s + 3 * i);
+    uint8x8x4_t p;
+
+    p.val[0] = vdup_n_u8 (0xff);
+    p.val[1] = v.val[bgr ? 2 : 0];
+    p.val[2] = v.val[1];
+    p.val[3] = v.val[bgr ? 0 : 2];
+    vst4_u8 (d + 4 * i, p);
+  }
+  return i;
+}
+
+static gint
+pack_RGB_simd (guint8 * d, const guint8 * s, gint width, gboolean bgr)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    uint8x8x4_t v = vld4_u8 (s + 4 * i);
+    uint8x8x3_t p;
+
+    p.val[0] = v.val[bgr ? 3 : 1];
+    p.val[1] = v.val[2];
+    p.val[2] = v.val[bgr ? 1 : 3];
+    vst3_u8 (d + 3 * i, p);
+  }
+  return i;
+}
+#endif
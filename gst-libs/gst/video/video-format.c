@@ -28,6 +28,7 @@
 
 #include "video-format.h"
 #include "video-orc.h"
+#include "video-format-simd.h"
 
 #ifndef restrict
 #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
@@ -169,6 +170,16 @@ unpack_YUY2 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     width--;
   }
 
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  {
+    gint n = unpack_422_simd (d, s, width / 2, FALSE);
+
+    s += n * 4;
+    d += n * 8;
+    width -= n * 2;
+  }
+#endif
+
   if (IS_ALIGNED (d, 8))
     video_orc_unpack_YUY2 (d, s, width / 2);
   else {
@@ -205,6 +216,16 @@ pack_YUY2 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint8 *restrict d = GET_LINE (y);
   const guint8 *restrict s = src;
 
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  {
+    gint n = pack_422_simd (d, s, width / 2, FALSE);
+
+    s += n * 8;
+    d += n * 4;
+    width -= n * 2;
+  }
+#endif
+
   if (IS_ALIGNED (s, 8))
     video_orc_pack_YUY2 (d, s, width / 2);
   else {
@@ -246,6 +267,16 @@ unpack_UYVY (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     width--;
   }
 
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  {
+    gint n = unpack_422_simd (d, s, width / 2, TRUE);
+
+    s += n * 4;
+    d += n * 8;
+    width -= n * 2;
+  }
+#endif
+
   if (IS_ALIGNED (d, 8))
     video_orc_unpack_UYVY (d, s, width / 2);
   else {
@@ -282,6 +313,16 @@ pack_UYVY (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint8 *restrict d = GET_LINE (y);
   const guint8 *restrict s = src;
 
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  {
+    gint n = pack_422_simd (d, s, width / 2, TRUE);
+
+    s += n * 8;
+    d += n * 4;
+    width -= n * 2;
+  }
+#endif
+
   if (IS_ALIGNED (s, 8))
     video_orc_pack_UYVY (d, s, width / 2);
   else {
@@ -458,7 +499,13 @@ unpack_v210 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   /* FIXME */
   s += x * 2;
 
-  for (i = 0; i < width; i += 6) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  i = unpack_v210_simd (d, s, width,
+      flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE);
+#endif
+
+  for (; i < width; i += 6) {
     a0 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 0);
     a1 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 4);
     a2 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 8);
@@ -548,7 +595,12 @@ pack_v210 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 u0, u1, u2;
   guint16 v0, v1, v2;
 
-  for (i = 0; i < width - 5; i += 6) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  i = pack_v210_simd (d, s, width);
+#endif
+
+  for (; i < width - 5; i += 6) {
     y0 = s[4 * (i + 0) + 1] >> 6;
     y1 = s[4 * (i + 1) + 1] >> 6;
     y2 = s[4 * (i + 2) + 1] >> 6;
@@ -1207,7 +1259,12 @@ unpack_RGB (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
 
   s += x * 3;
 
-  for (i = 0; i < width; i++) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD_RGB
+  i = unpack_RGB_simd (d, s, width, FALSE);
+#endif
+
+  for (; i < width; i++) {
     d[i * 4 + 0] = 0xff;
     d[i * 4 + 1] = s[i * 3 + 0];
     d[i * 4 + 2] = s[i * 3 + 1];
@@ -1225,7 +1282,12 @@ pack_RGB (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint8 *restrict d = GET_LINE (y);
   const guint8 *restrict s = src;
 
-  for (i = 0; i < width; i++) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD_RGB
+  i = pack_RGB_simd (d, s, width, FALSE);
+#endif
+
+  for (; i < width; i++) {
     d[i * 3 + 0] = s[i * 4 + 1];
     d[i * 3 + 1] = s[i * 4 + 2];
     d[i * 3 + 2] = s[i * 4 + 3];
@@ -1244,7 +1306,12 @@ unpack_BGR (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
 
   s += x * 3;
 
-  for (i = 0; i < width; i++) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD_RGB
+  i = unpack_RGB_simd (d, s, width, TRUE);
+#endif
+
+  for (; i < width; i++) {
     d[i * 4 + 0] = 0xff;
     d[i * 4 + 1] = s[i * 3 + 2];
     d[i * 4 + 2] = s[i * 3 + 1];
@@ -1262,7 +1329,12 @@ pack_BGR (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint8 *restrict d = GET_LINE (y);
   const guint8 *restrict s = src;
 
-  for (i = 0; i < width; i++) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD_RGB
+  i = pack_RGB_simd (d, s, width, TRUE);
+#endif
+
+  for (; i < width; i++) {
     d[i * 3 + 0] = s[i * 4 + 3];
     d[i * 3 + 1] = s[i * 4 + 2];
     d[i * 3 + 2] = s[i * 4 + 1];
@@ -2375,7 +2447,14 @@ unpack_I420_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   su += x >> 1;
   sv += x >> 1;
 
-  for (i = 0; i < width; i++) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  if (!(x & 1))
+    i = unpack_I420_10LE_simd (d, sy, su, sv, width,
+        flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE);
+#endif
+
+  for (; i < width; i++) {
     Y = GST_READ_UINT16_LE (sy + i) << 6;
     U = GST_READ_UINT16_LE (su + (i >> 1)) << 6;
     V = GST_READ_UINT16_LE (sv + (i >> 1)) << 6;
@@ -2413,8 +2492,14 @@ pack_I420_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 Y0, Y1, U, V;
   const guint16 *restrict s = src;
 
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  i = pack_I420_10LE_simd (dy, du, dv, s, width,
+      IS_CHROMA_LINE_420 (y, flags));
+#endif
+
   if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width - 1; i += 2) {
+    for (; i < width - 1; i += 2) {
       Y0 = s[i * 4 + 1] >> 6;
       Y1 = s[i * 4 + 5] >> 6;
       U = s[i * 4 + 2] >> 6;
@@ -2435,7 +2520,7 @@ pack_I420_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
       GST_WRITE_UINT16_LE (dv + (i >> 1), V);
     }
   } else {
-    for (i = 0; i < width; i++) {
+    for (; i < width; i++) {
       Y0 = s[i * 4 + 1] >> 6;
       GST_WRITE_UINT16_LE (dy + i, Y0);
     }
@@ -3465,7 +3550,13 @@ unpack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     suv += 2;
   }
 
-  for (i = 0; i < width / 2; i++) {
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  i = unpack_P010_10LE_simd (d, sy, suv, width,
+      flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) / 2;
+#endif
+
+  for (; i < width / 2; i++) {
     Y0 = GST_READ_UINT16_LE (sy + 2 * i);
     Y1 = GST_READ_UINT16_LE (sy + 2 * i + 1);
     U = GST_READ_UINT16_LE (suv + 2 * i);
@@ -3521,8 +3612,13 @@ pack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 Y0, Y1, U, V;
   const guint16 *restrict s = src;
 
+  i = 0;
+#ifdef HAVE_VIDEO_FORMAT_SIMD
+  i = pack_P010_10LE_simd (dy, duv, s, width, IS_CHROMA_LINE_420 (y, flags));
+#endif
+
   if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
+    for (i /= 2; i < width / 2; i++) {
       Y0 = s[i * 8 + 1] & 0xffc0;
       Y1 = s[i * 8 + 5] & 0xffc0;
       U = s[i * 8 + 2] & 0xffc0;
@@ -3545,7 +3641,7 @@ pack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
       GST_WRITE_UINT16_LE (duv + i + 1, V);
     }
   } else {
-    for (i = 0; i < width; i++) {
+    for (; i < width; i++) {
       Y0 = s[i * 4 + 1] & 0xffc0;
       GST_WRITE_UINT16_LE (dy + i, Y0);
     }
@@ -4070,15 +4166,30 @@ gst_video_format_from_fourcc (guint32 fourcc)
 GstVideoFormat
 gst_video_format_from_string (const gchar * format)
 {
-  guint i;
+  static gsize names_gonce = 0;
 
   g_return_val_if_fail (format != NULL, GST_VIDEO_FORMAT_UNKNOWN);
 
-  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
-    if (strcmp (GST_VIDEO_FORMAT_INFO_NAME (&formats[i].info), format) == 0)
-      return GST_VIDEO_FORMAT_INFO_FORMAT (&formats[i].info);
+  /* this is done for every caps that is parsed, use a hashtable instead of
+   * comparing against all the names */
+  if (g_once_init_enter (&names_gonce)) {
+    GHashTable *names;
+    guint i;
+
+    names = g_hash_table_new (g_str_hash, g_str_equal);
+    for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+      const gchar *name = GST_VIDEO_FORMAT_INFO_NAME (&formats[i].info);
+
+      if (!g_hash_table_contains (names, name))
+        g_hash_table_insert (names, (gpointer) name,
+            GINT_TO_POINTER (GST_VIDEO_FORMAT_INFO_FORMAT (&formats[i].info)));
+    }
+    g_once_init_leave (&names_gonce, (gsize) names);
   }
-  return GST_VIDEO_FORMAT_UNKNOWN;
+
+  /* GST_VIDEO_FORMAT_UNKNOWN is 0 */
+  return GPOINTER_TO_INT (g_hash_table_lookup ((GHashTable *) names_gonce,
+          format));
 }
 
 
@@ -4166,3 +4277,124 @@ gst_video_format_get_palette (GstVideoFormat format, gsize * size)
       return NULL;
   }
 }
+
+/* bytes per pixel when the unpack and pack functions are plain copies */
+static gint
+get_copy_pstride (const GstVideoFormatInfo * info)
+{
+  if (info->unpack_func == unpack_copy4)
+    return 4;
+  if (info->unpack_func == unpack_copy8)
+    return 8;
+  return 0;
+}
+
+static void
+copy_rect (guint8 * d, gint dstride, const guint8 * s, gint sstride,
+    gint size, gint height)
+{
+  gint i;
+
+  if (dstride == sstride && size == sstride) {
+    memcpy (d, s, (gsize) size * height);
+  } else {
+    for (i = 0; i < height; i++) {
+      memcpy (d, s, size);
+      d += dstride;
+      s += sstride;
+    }
+  }
+}
+
+/**
+ * gst_video_format_info_unpack_rect:
+ * @info: a #GstVideoFormatInfo
+ * @flags: flags to control the unpacking
+ * @dest: a destination array
+ * @dstride: the stride of the lines in @dest
+ * @data: pointers to the data planes
+ * @stride: strides of the planes
+ * @x: the x position in the image to start from
+ * @y: the y position in the image to start from
+ * @width: the number of pixels to unpack per line
+ * @height: the number of lines to unpack
+ *
+ * Unpack @height lines of @width pixels, starting at @x and @y, into @dest
+ * in the format of the unpack_format of @info. This does the same as calling
+ * the unpack_func of @info for each line but avoids the per line overhead
+ * where possible.
+ *
+ * Since: 1.10
+ */
+void
+gst_video_format_info_unpack_rect (const GstVideoFormatInfo * info,
+    GstVideoPackFlags flags, gpointer dest, gint dstride,
+    const gpointer data[GST_VIDEO_MAX_PLANES],
+    const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width,
+    gint height)
+{
+  guint8 *d = dest;
+  gint i, pstride;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (info->unpack_func != NULL);
+
+  if ((pstride = get_copy_pstride (info))) {
+    copy_rect (d, dstride, (guint8 *) data[0] + stride[0] * y + x * pstride,
+        stride[0], width * pstride, height);
+    return;
+  }
+
+  for (i = 0; i < height; i++) {
+    info->unpack_func (info, flags, d, data, stride, x, y + i, width);
+    d += dstride;
+  }
+}
+
+/**
+ * gst_video_format_info_pack_rect:
+ * @info: a #GstVideoFormatInfo
+ * @flags: flags to control the packing
+ * @src: a source array
+ * @sstride: the stride of the lines in @src
+ * @data: pointers to the destination data planes
+ * @stride: strides of the destination planes
+ * @chroma_site: the chroma siting of the target when subsampled (not used)
+ * @y: the y position in the image to pack to
+ * @width: the number of pixels to pack per line
+ * @height: the number of lines to pack
+ *
+ * Pack @height lines of @width pixels from @src, in the format of the
+ * unpack_format of @info, to the planes starting at line @y. @y and @height
+ * should be multiples of the pack_lines of @info. This does the same as
+ * calling the pack_func of @info for each group of pack_lines but avoids
+ * the per line overhead where possible.
+ *
+ * Since: 1.10
+ */
+void
+gst_video_format_info_pack_rect (const GstVideoFormatInfo * info,
+    GstVideoPackFlags flags, const gpointer src, gint sstride,
+    gpointer data[GST_VIDEO_MAX_PLANES],
+    const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
+    gint y, gint width, gint height)
+{
+  const guint8 *s = src;
+  gint i, pstride;
+
+  g_return_if_fail (info != NULL);
+  g_return_if_fail (info->pack_func != NULL);
+  g_return_if_fail (info->pack_lines > 0);
+
+  if ((pstride = get_copy_pstride (info))) {
+    copy_rect ((guint8 *) data[0] + stride[0] * y, stride[0], s, sstride,
+        width * pstride, height);
+    return;
+  }
+
+  for (i = 0; i < height; i += info->pack_lines) {
+    info->pack_func (info, flags, s, sstride, data, stride, chroma_site,
+        y + i, width);
+    s += sstride * info->pack_lines;
+  }
+}
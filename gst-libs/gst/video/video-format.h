@@ -483,6 +483,20 @@ const GstVideoFormatInfo *
 
 gconstpointer  gst_video_format_get_palette          (GstVideoFormat format, gsize *size);
 
+void           gst_video_format_info_unpack_rect     (const GstVideoFormatInfo *info,
+                                                      GstVideoPackFlags flags,
+                                                      gpointer dest, gint dstride,
+                                                      const gpointer data[GST_VIDEO_MAX_PLANES],
+                                                      const gint stride[GST_VIDEO_MAX_PLANES],
+                                                      gint x, gint y, gint width, gint height);
+void           gst_video_format_info_pack_rect       (const GstVideoFormatInfo *info,
+                                                      GstVideoPackFlags flags,
+                                                      const gpointer src, gint sstride,
+                                                      gpointer data[GST_VIDEO_MAX_PLANES],
+                                                      const gint stride[GST_VIDEO_MAX_PLANES],
+                                                      GstVideoChromaSite chroma_site,
+                                                      gint y, gint width, gint height);
+
 #define GST_VIDEO_SIZE_RANGE "(int) [ 1, max ]"
 #define GST_VIDEO_FPS_RANGE "(fraction) [ 0, max ]"
 
@@ -51,6 +51,99 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
+/* the names of the caps fields, looking up the quark of a field name takes
+ * the global quark lock so we do this only once */
+static GQuark _quark_video_x_raw;
+static GQuark _quark_format;
+static GQuark _quark_width;
+static GQuark _quark_height;
+static GQuark _quark_framerate;
+static GQuark _quark_max_framerate;
+static GQuark _quark_pixel_aspect_ratio;
+static GQuark _quark_interlace_mode;
+static GQuark _quark_multiview_mode;
+static GQuark _quark_multiview_flags;
+static GQuark _quark_views;
+static GQuark _quark_chroma_site;
+static GQuark _quark_colorimetry;
+
+static void
+ensure_quarks (void)
+{
+  static gsize quarks_gonce = 0;
+
+  if (g_once_init_enter (&quarks_gonce)) {
+    _quark_video_x_raw = g_quark_from_static_string ("video/x-raw");
+    _quark_format = g_quark_from_static_string ("format");
+    _quark_width = g_quark_from_static_string ("width");
+    _quark_height = g_quark_from_static_string ("height");
+    _quark_framerate = g_quark_from_static_string ("framerate");
+    _quark_max_framerate = g_quark_from_static_string ("max-framerate");
+    _quark_pixel_aspect_ratio =
+        g_quark_from_static_string ("pixel-aspect-ratio");
+    _quark_interlace_mode = g_quark_from_static_string ("interlace-mode");
+    _quark_multiview_mode = g_quark_from_static_string ("multiview-mode");
+    _quark_multiview_flags = g_quark_from_static_string ("multiview-flags");
+    _quark_views = g_quark_from_static_string ("views");
+    _quark_chroma_site = g_quark_from_static_string ("chroma-site");
+    _quark_colorimetry = g_quark_from_static_string ("colorimetry");
+
+    g_once_init_leave (&quarks_gonce, 1);
+  }
+}
+
+/* like gst_structure_get_string() and friends but with the field quark */
+static const gchar *
+structure_id_get_string (const GstStructure * structure, GQuark field)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !G_VALUE_HOLDS_STRING (value))
+    return NULL;
+
+  return g_value_get_string (value);
+}
+
+static gboolean
+structure_id_get_int (const GstStructure * structure, GQuark field,
+    gint * result)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !G_VALUE_HOLDS_INT (value))
+    return FALSE;
+
+  *result = g_value_get_int (value);
+  return TRUE;
+}
+
+static gboolean
+structure_id_get_fraction (const GstStructure * structure, GQuark field,
+    gint * num, gint * denom)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !GST_VALUE_HOLDS_FRACTION (value))
+    return FALSE;
+
+  *num = gst_value_get_fraction_numerator (value);
+  *denom = gst_value_get_fraction_denominator (value);
+  return TRUE;
+}
+
+static gboolean
+structure_id_get_flagset (const GstStructure * structure, GQuark field,
+    guint * flags)
+{
+  const GValue *value = gst_structure_id_get_value (structure, field);
+
+  if (value == NULL || !GST_VALUE_HOLDS_FLAG_SET (value))
+    return FALSE;
+
+  *flags = gst_value_get_flagset_flags (value);
+  return TRUE;
+}
+
 /**
  * gst_video_info_copy:
  * @info: a #GstVideoInfo
@@ -299,10 +392,12 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
 
   GST_DEBUG ("parsing caps %" GST_PTR_FORMAT, caps);
 
+  ensure_quarks ();
+
   structure = gst_caps_get_structure (caps, 0);
 
-  if (gst_structure_has_name (structure, "video/x-raw")) {
-    if (!(s = gst_structure_get_string (structure, "format")))
+  if (gst_structure_get_name_id (structure) == _quark_video_x_raw) {
+    if (!(s = structure_id_get_string (structure, _quark_format)))
       goto no_format;
 
     format = gst_video_format_from_string (s);
@@ -317,10 +412,10 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
   }
 
   /* width and height are mandatory, except for non-raw-formats */
-  if (!gst_structure_get_int (structure, "width", &width) &&
+  if (!structure_id_get_int (structure, _quark_width, &width) &&
       format != GST_VIDEO_FORMAT_ENCODED)
     goto no_width;
-  if (!gst_structure_get_int (structure, "height", &height) &&
+  if (!structure_id_get_int (structure, _quark_height, &height) &&
       format != GST_VIDEO_FORMAT_ENCODED)
     goto no_height;
 
@@ -330,12 +425,14 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
   info->width = width;
   info->height = height;
 
-  if (gst_structure_get_fraction (structure, "framerate", &fps_n, &fps_d)) {
+  if (structure_id_get_fraction (structure, _quark_framerate, &fps_n,
+          &fps_d)) {
     if (fps_n == 0) {
       /* variable framerate */
       info->flags |= GST_VIDEO_FLAG_VARIABLE_FPS;
       /* see if we have a max-framerate */
-      gst_structure_get_fraction (structure, "max-framerate", &fps_n, &fps_d);
+      structure_id_get_fraction (structure, _quark_max_framerate, &fps_n,
+          &fps_d);
     }
     info->fps_n = fps_n;
     info->fps_d = fps_d;
@@ -345,7 +442,7 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
     info->fps_d = 1;
   }
 
-  if (gst_structure_get_fraction (structure, "pixel-aspect-ratio",
+  if (structure_id_get_fraction (structure, _quark_pixel_aspect_ratio,
           &par_n, &par_d)) {
     info->par_n = par_n;
     info->par_d = par_d;
@@ -354,22 +451,22 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
     info->par_d = 1;
   }
 
-  if ((s = gst_structure_get_string (structure, "interlace-mode")))
+  if ((s = structure_id_get_string (structure, _quark_interlace_mode)))
     info->interlace_mode = gst_video_interlace_mode_from_string (s);
   else
     info->interlace_mode = GST_VIDEO_INTERLACE_MODE_PROGRESSIVE;
 
   {
-    if ((s = gst_structure_get_string (structure, "multiview-mode")))
+    if ((s = structure_id_get_string (structure, _quark_multiview_mode)))
       GST_VIDEO_INFO_MULTIVIEW_MODE (info) =
           gst_video_multiview_mode_from_caps_string (s);
     else
       GST_VIDEO_INFO_MULTIVIEW_MODE (info) = GST_VIDEO_MULTIVIEW_MODE_NONE;
 
-    gst_structure_get_flagset (structure, "multiview-flags",
-        &GST_VIDEO_INFO_MULTIVIEW_FLAGS (info), NULL);
+    structure_id_get_flagset (structure, _quark_multiview_flags,
+        &GST_VIDEO_INFO_MULTIVIEW_FLAGS (info));
 
-    if (!gst_structure_get_int (structure, "views", &info->views))
+    if (!structure_id_get_int (structure, _quark_views, &info->views))
       info->views = 1;
 
     /* At one point, I tried normalising the half-aspect flag here,
@@ -378,12 +475,12 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
      * PAR to be doubled/halved too many times */
   }
 
-  if ((s = gst_structure_get_string (structure, "chroma-site")))
+  if ((s = structure_id_get_string (structure, _quark_chroma_site)))
     info->chroma_site = gst_video_chroma_from_string (s);
   else
     info->chroma_site = GST_VIDEO_CHROMA_SITE_UNKNOWN;
 
-  if ((s = gst_structure_get_string (structure, "colorimetry"))) {
+  if ((s = structure_id_get_string (structure, _quark_colorimetry))) {
     if (!gst_video_colorimetry_from_string (&info->colorimetry, s)) {
       GST_WARNING ("unparsable colorimetry, using default");
       set_default_colorimetry (info);
@@ -401,6 +401,129 @@ gst_video_multiview_guess_half_aspect (GstVideoMultiviewMode mv_mode,
   return FALSE;
 }
 
+/**
+ * gst_video_multiview_buffer_get_view:
+ * @info: the #GstVideoInfo of the frame-packed @buffer
+ * @buffer: a frame-packed #GstBuffer
+ * @view: the view to get, 0 for the left view and 1 for the right view
+ *
+ * Make a buffer with one view of the frame-packed @buffer without copying
+ * the pixels. The new buffer shares the memory of @buffer and has a
+ * #GstVideoMeta with the offsets and strides of the view in it, so it can
+ * only be handled by elements that support #GstVideoMeta. The size of the
+ * view is the one of gst_video_multiview_video_info_change_mode() with
+ * #GST_VIDEO_MULTIVIEW_MODE_SEPARATED.
+ *
+ * This only works for the side-by-side, top-bottom and row-interleaved
+ * modes and where the views start at a multiple of the chroma subsampling,
+ * row-interleaved views can't have vertically subsampled chroma. Flipped
+ * and flopped views are returned as they are.
+ *
+ * Returns: (transfer full) (nullable): a new #GstBuffer with @view or
+ *     %NULL when @view can't be extracted without copying.
+ *
+ * Since: 1.10
+ */
+GstBuffer *
+gst_video_multiview_buffer_get_view (const GstVideoInfo * info,
+    GstBuffer * buffer, guint view)
+{
+  const GstVideoFormatInfo *finfo;
+  GstVideoInfo vinfo;
+  GstVideoMeta *meta;
+  GstVideoFrameFlags flags = GST_VIDEO_FRAME_FLAG_NONE;
+  GstBuffer *res;
+  gsize offset[GST_VIDEO_MAX_PLANES];
+  gint stride[GST_VIDEO_MAX_PLANES];
+  gint i, x = 0, y = 0, split_x = 0, split_y = 0, rows = 1;
+  guint pos;
+
+  g_return_val_if_fail (info != NULL, NULL);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), NULL);
+  g_return_val_if_fail (view < 2, NULL);
+
+  finfo = info->finfo;
+  if (GST_VIDEO_FORMAT_INFO_IS_COMPLEX (finfo) ||
+      GST_VIDEO_FORMAT_INFO_IS_TILED (finfo))
+    return NULL;
+
+  vinfo = *info;
+  gst_video_multiview_separated_video_info_from_packed (&vinfo);
+
+  /* the left view comes first unless the flags say otherwise */
+  pos = view;
+  if (GST_VIDEO_INFO_MULTIVIEW_FLAGS (info) &
+      GST_VIDEO_MULTIVIEW_FLAGS_RIGHT_VIEW_FIRST)
+    pos ^= 1;
+
+  switch (GST_VIDEO_INFO_MULTIVIEW_MODE (info)) {
+    case GST_VIDEO_MULTIVIEW_MODE_SIDE_BY_SIDE:
+      split_x = GST_VIDEO_INFO_WIDTH (&vinfo);
+      x = pos * split_x;
+      break;
+    case GST_VIDEO_MULTIVIEW_MODE_TOP_BOTTOM:
+      split_y = GST_VIDEO_INFO_HEIGHT (&vinfo);
+      y = pos * split_y;
+      break;
+    case GST_VIDEO_MULTIVIEW_MODE_ROW_INTERLEAVED:
+      /* every other line, make sure chroma lines are not shared */
+      split_y = 1;
+      y = pos;
+      rows = 2;
+      break;
+    default:
+      return NULL;
+  }
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    if (GST_VIDEO_SUB_SCALE (finfo->w_sub[i], split_x) << finfo->w_sub[i] !=
+        split_x)
+      return NULL;
+    if (GST_VIDEO_SUB_SCALE (finfo->h_sub[i], split_y) << finfo->h_sub[i] !=
+        split_y)
+      return NULL;
+  }
+
+  if ((meta = gst_buffer_get_video_meta (buffer))) {
+    flags = meta->flags;
+    for (i = 0; i < meta->n_planes; i++) {
+      offset[i] = meta->offset[i];
+      stride[i] = meta->stride[i];
+    }
+  } else {
+    for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+      offset[i] = GST_VIDEO_INFO_PLANE_OFFSET (info, i);
+      stride[i] = GST_VIDEO_INFO_PLANE_STRIDE (info, i);
+    }
+  }
+
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+    gint comp;
+
+    /* a component of the plane to know its subsampling and pixel stride,
+     * planes without components (the palette) stay as they are */
+    for (comp = 0; comp < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); comp++)
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp) == i)
+        break;
+    if (comp == GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo))
+      continue;
+
+    offset[i] += GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp, y) *
+        stride[i];
+    offset[i] += GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comp, x) *
+        GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, comp);
+    stride[i] *= rows;
+  }
+
+  res = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_FLAGS |
+      GST_BUFFER_COPY_TIMESTAMPS | GST_BUFFER_COPY_MEMORY, 0, -1);
+  gst_buffer_add_video_meta_full (res, flags, GST_VIDEO_INFO_FORMAT (info),
+      GST_VIDEO_INFO_WIDTH (&vinfo), GST_VIDEO_INFO_HEIGHT (&vinfo),
+      GST_VIDEO_INFO_N_PLANES (info), offset, stride);
+
+  return res;
+}
+
 #if 0                           /* Multiview meta disabled for now */
 GType
 gst_video_multiview_meta_api_get_type (void)
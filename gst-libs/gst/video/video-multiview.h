@@ -41,6 +41,9 @@ void gst_video_multiview_video_info_change_mode (GstVideoInfo *info,
 gboolean gst_video_multiview_guess_half_aspect (GstVideoMultiviewMode mv_mode,
     guint width, guint height, guint par_n, guint par_d);
 
+GstBuffer * gst_video_multiview_buffer_get_view (const GstVideoInfo *info,
+    GstBuffer *buffer, guint view);
+
 
 #if 0 /* Place-holder for later MVC support */
 #define GST_VIDEO_MULTIVIEW_META_API_TYPE (gst_video_multiview_meta_api_get_type())
@@ -87,6 +87,24 @@ struct _GstVideoOverlayComposition
   guint seq_num;
 };
 
+/* converted, scaled and (un)premultiplied variants of the pixels of a
+ * rectangle, shared with the copies of the rectangle because they have the
+ * same pixels. The variants never have global alpha applied so they stay
+ * valid when it changes. */
+typedef struct
+{
+  gint refcount;
+  GMutex lock;
+  /* GstVideoOverlayRectangle, most recently used first */
+  GList *variants;
+  guint hits;
+  guint misses;
+} GstVideoOverlayRectangleCache;
+
+/* number of variants to keep around before evicting the least recently
+ * used ones */
+#define RECTANGLE_CACHE_SIZE 8
+
 struct _GstVideoOverlayRectangle
 {
   GstMiniObject parent;
@@ -139,10 +157,11 @@ struct _GstVideoOverlayRectangle
   /* store initial per-pixel alpha values: */
   guint8 *initial_alpha;
 
-  /* FIXME: we may also need a (private) way to cache converted/scaled
-   * pixel blobs */
   GMutex lock;
 
+  /* cached variants of the pixels, allocated when needed */
+  GstVideoOverlayRectangleCache *cache;
+  /* variants with our global alpha applied */
   GList *scaled_rectangles;
 };
 
@@ -451,6 +470,26 @@ gst_video_overlay_rectangle_needs_scaling (GstVideoOverlayRectangle * r)
       GST_VIDEO_INFO_HEIGHT (&r->info) != r->render_height);
 }
 
+static GstBuffer *
+gst_video_overlay_rectangle_get_pixels_raw_internal (GstVideoOverlayRectangle *
+    rectangle, GstVideoOverlayFormatFlags flags, gboolean unscaled,
+    GstVideoFormat wanted_format);
+
+/* formats that gst_video_blend() can blend AYUV into without unpacking */
+static gboolean
+gst_video_overlay_format_blends_ayuv (GstVideoFormat format)
+{
+  switch (format) {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
 /**
  * gst_video_overlay_composition_blend:
  * @comp: a #GstVideoOverlayComposition
@@ -499,7 +538,17 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
         GST_VIDEO_INFO_FORMAT (&rect->info));
 
     needs_scaling = gst_video_overlay_rectangle_needs_scaling (rect);
-    if (needs_scaling) {
+    if (gst_video_overlay_format_blends_ayuv (fmt)) {
+      /* use the scaled, non-premultiplied AYUV pixels cached in the
+       * rectangle, global alpha is applied while blending */
+      pixels = gst_video_overlay_rectangle_get_pixels_raw_internal (rect,
+          GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA, FALSE,
+          GST_VIDEO_FORMAT_AYUV);
+      gst_buffer_ref (pixels);
+      gst_video_info_set_format (&scaled_info, GST_VIDEO_FORMAT_AYUV,
+          rect->render_width, rect->render_height);
+      vinfo = &scaled_info;
+    } else if (needs_scaling) {
       gst_video_blend_scale_linear_RGBA (&rect->info, rect->pixels,
           rect->render_height, rect->render_width, &scaled_info, &pixels);
       vinfo = &scaled_info;
@@ -624,6 +673,43 @@ gst_video_overlay_composition_get_seqnum (GstVideoOverlayComposition * comp)
 GST_DEFINE_MINI_OBJECT_TYPE (GstVideoOverlayRectangle,
     gst_video_overlay_rectangle);
 
+static GstVideoOverlayRectangleCache *
+gst_video_overlay_rectangle_cache_new (void)
+{
+  GstVideoOverlayRectangleCache *cache;
+
+  cache = g_slice_new0 (GstVideoOverlayRectangleCache);
+  cache->refcount = 1;
+  g_mutex_init (&cache->lock);
+
+  GST_LOG ("new rectangle cache %p", cache);
+
+  return cache;
+}
+
+static GstVideoOverlayRectangleCache *
+gst_video_overlay_rectangle_cache_ref (GstVideoOverlayRectangleCache * cache)
+{
+  g_atomic_int_inc (&cache->refcount);
+  return cache;
+}
+
+static void
+gst_video_overlay_rectangle_cache_unref (GstVideoOverlayRectangleCache *
+    cache)
+{
+  if (!g_atomic_int_dec_and_test (&cache->refcount))
+    return;
+
+  GST_DEBUG ("free rectangle cache %p: %u hits, %u misses", cache,
+      cache->hits, cache->misses);
+
+  g_list_free_full (cache->variants,
+      (GDestroyNotify) gst_video_overlay_rectangle_unref);
+  g_mutex_clear (&cache->lock);
+  g_slice_free (GstVideoOverlayRectangleCache, cache);
+}
+
 static void
 gst_video_overlay_rectangle_free (GstMiniObject * mini_obj)
 {
@@ -640,6 +726,9 @@ gst_video_overlay_rectangle_free (GstMiniObject * mini_obj)
         g_list_delete_link (rect->scaled_rectangles, rect->scaled_rectangles);
   }
 
+  if (rect->cache)
+    gst_video_overlay_rectangle_cache_unref (rect->cache);
+
   g_free (rect->initial_alpha);
   g_mutex_clear (&rect->lock);
 
@@ -1000,7 +1089,7 @@ gst_video_overlay_rectangle_apply_global_alpha (GstVideoOverlayRectangle * rect,
   src = rect->initial_alpha;
   rect->pixels = gst_buffer_make_writable (rect->pixels);
 
-  gst_video_frame_map (&frame, &rect->info, rect->pixels, GST_MAP_READ);
+  gst_video_frame_map (&frame, &rect->info, rect->pixels, GST_MAP_READWRITE);
   dst = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
   w = GST_VIDEO_INFO_WIDTH (&rect->info);
   h = GST_VIDEO_INFO_HEIGHT (&rect->info);
@@ -1131,16 +1220,164 @@ gst_video_overlay_rectangle_convert (GstVideoInfo * src, GstBuffer * src_buffer,
   gst_video_frame_unmap (&dest_frame);
 }
 
-static GstBuffer *
-gst_video_overlay_rectangle_get_pixels_raw_internal (GstVideoOverlayRectangle *
-    rectangle, GstVideoOverlayFormatFlags flags, gboolean unscaled,
-    GstVideoFormat wanted_format)
+static gboolean
+gst_video_overlay_rectangle_cache_evictable (GstVideoOverlayRectangle * r)
+{
+  /* only drop variants that nobody else holds on to */
+  return GST_MINI_OBJECT_REFCOUNT_VALUE (r) == 1 &&
+      GST_MINI_OBJECT_REFCOUNT_VALUE (r->pixels) == 1;
+}
+
+/* called with the cache lock */
+static void
+gst_video_overlay_rectangle_cache_add (GstVideoOverlayRectangleCache * cache,
+    GstVideoOverlayRectangle * variant)
+{
+  GList *l, *prev;
+  guint n_variants;
+
+  cache->variants = g_list_prepend (cache->variants, variant);
+
+  n_variants = g_list_length (cache->variants);
+  for (l = g_list_last (cache->variants);
+      l != cache->variants && n_variants > RECTANGLE_CACHE_SIZE; l = prev) {
+    GstVideoOverlayRectangle *r = l->data;
+
+    prev = l->prev;
+    if (!gst_video_overlay_rectangle_cache_evictable (r))
+      continue;
+
+    GST_LOG ("cache %p: evict %ux%u format %u", cache,
+        GST_VIDEO_INFO_WIDTH (&r->info), GST_VIDEO_INFO_HEIGHT (&r->info),
+        GST_VIDEO_INFO_FORMAT (&r->info));
+    cache->variants = g_list_delete_link (cache->variants, l);
+    gst_video_overlay_rectangle_unref (r);
+    n_variants--;
+  }
+}
+
+/* called with the cache lock */
+static GstVideoOverlayRectangle *
+gst_video_overlay_rectangle_cache_find (GstVideoOverlayRectangleCache * cache,
+    guint width, guint height, GstVideoFormat format,
+    GstVideoOverlayFormatFlags flags)
+{
+  GList *l;
+
+  for (l = cache->variants; l != NULL; l = l->next) {
+    GstVideoOverlayRectangle *r = l->data;
+
+    if (GST_VIDEO_INFO_WIDTH (&r->info) == width &&
+        GST_VIDEO_INFO_HEIGHT (&r->info) == height &&
+        GST_VIDEO_INFO_FORMAT (&r->info) == format &&
+        gst_video_overlay_rectangle_is_same_alpha_type (r->flags, flags)) {
+      /* move to the front */
+      cache->variants = g_list_remove_link (cache->variants, l);
+      cache->variants = g_list_concat (l, cache->variants);
+      cache->hits++;
+      GST_LOG ("cache %p: hit %ux%u format %u (%u hits, %u misses)", cache,
+          width, height, format, cache->hits, cache->misses);
+      return r;
+    }
+  }
+  cache->misses++;
+  GST_LOG ("cache %p: miss %ux%u format %u (%u hits, %u misses)", cache,
+      width, height, format, cache->hits, cache->misses);
+
+  return NULL;
+}
+
+/* get the pixels of @rectangle in the wanted size, format and alpha type,
+ * without global alpha. Called with the cache lock. */
+static GstVideoOverlayRectangle *
+gst_video_overlay_rectangle_get_variant (GstVideoOverlayRectangle * rectangle,
+    GstVideoOverlayRectangleCache * cache, guint wanted_width,
+    guint wanted_height, GstVideoFormat wanted_format,
+    GstVideoOverlayFormatFlags flags)
 {
+  GstVideoOverlayRectangle *src, *variant;
   GstVideoOverlayFormatFlags new_flags;
-  GstVideoOverlayRectangle *scaled_rect = NULL, *conv_rect = NULL;
   GstVideoInfo info;
   GstVideoFrame frame;
   GstBuffer *buf;
+  guint width, height;
+  GstVideoFormat format;
+
+  width = GST_VIDEO_INFO_WIDTH (&rectangle->info);
+  height = GST_VIDEO_INFO_HEIGHT (&rectangle->info);
+  format = GST_VIDEO_INFO_FORMAT (&rectangle->info);
+
+  if (wanted_width == width && wanted_height == height &&
+      wanted_format == format &&
+      gst_video_overlay_rectangle_is_same_alpha_type (rectangle->flags, flags))
+    return rectangle;
+
+  variant = gst_video_overlay_rectangle_cache_find (cache, wanted_width,
+      wanted_height, wanted_format, flags);
+  if (variant != NULL)
+    return variant;
+
+  src = rectangle;
+  if (format != wanted_format) {
+    if (wanted_width != width || wanted_height != height ||
+        !gst_video_overlay_rectangle_is_same_alpha_type (rectangle->flags,
+            flags)) {
+      /* convert first, this one is worth keeping around as well */
+      src = gst_video_overlay_rectangle_get_variant (rectangle, cache, width,
+          height, wanted_format, rectangle->flags);
+    } else {
+      gst_video_overlay_rectangle_convert (&rectangle->info,
+          rectangle->pixels, wanted_format, &info, &buf);
+      gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
+          wanted_format, width, height);
+      new_flags = rectangle->flags;
+      goto done;
+    }
+  }
+
+  if (wanted_width != width || wanted_height != height) {
+    gst_video_blend_scale_linear_RGBA (&src->info, src->pixels,
+        wanted_height, wanted_width, &info, &buf);
+    gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
+        GST_VIDEO_INFO_FORMAT (&src->info), wanted_width, wanted_height);
+  } else {
+    /* we have to modify the alpha values, so we need to make a copy of the
+     * pixel memory (and we take ownership below) */
+    buf = gst_buffer_copy (src->pixels);
+    info = src->info;
+  }
+
+  new_flags = src->flags;
+  if (!gst_video_overlay_rectangle_is_same_alpha_type (src->flags, flags)) {
+    gst_video_frame_map (&frame, &info, buf, GST_MAP_READWRITE);
+    if (src->flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA) {
+      gst_video_overlay_rectangle_unpremultiply (&frame);
+      new_flags &= ~GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA;
+    } else {
+      gst_video_overlay_rectangle_premultiply (&frame);
+      new_flags |= GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA;
+    }
+    gst_video_frame_unmap (&frame);
+  }
+
+done:
+  new_flags &= ~GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA;
+  variant = gst_video_overlay_rectangle_new_raw (buf, 0, 0, wanted_width,
+      wanted_height, new_flags);
+  gst_buffer_unref (buf);
+
+  gst_video_overlay_rectangle_cache_add (cache, variant);
+
+  return variant;
+}
+
+static GstBuffer *
+gst_video_overlay_rectangle_get_pixels_raw_internal (GstVideoOverlayRectangle *
+    rectangle, GstVideoOverlayFormatFlags flags, gboolean unscaled,
+    GstVideoFormat wanted_format)
+{
+  GstVideoOverlayRectangleCache *cache;
+  GstVideoOverlayRectangle *variant, *alpha_rect = NULL;
   GList *l;
   guint width, height;
   guint wanted_width;
@@ -1171,19 +1408,37 @@ gst_video_overlay_rectangle_get_pixels_raw_internal (GstVideoOverlayRectangle *
       wanted_format == format &&
       gst_video_overlay_rectangle_is_same_alpha_type (rectangle->flags,
           flags)) {
-    /* don't need to apply/revert global-alpha either: */
-    if ((!apply_global_alpha
-            || rectangle->applied_global_alpha == rectangle->global_alpha)
-        && (!revert_global_alpha || rectangle->applied_global_alpha == 1.0)) {
-      return rectangle->pixels;
-    } else {
-      /* only apply/revert global-alpha */
-      scaled_rect = rectangle;
-      goto done;
+    GST_RECTANGLE_LOCK (rectangle);
+    /* only apply/revert global-alpha if needed */
+    if (apply_global_alpha
+        && rectangle->applied_global_alpha != rectangle->global_alpha) {
+      gst_video_overlay_rectangle_apply_global_alpha (rectangle,
+          rectangle->global_alpha);
+    } else if (revert_global_alpha && rectangle->applied_global_alpha != 1.0) {
+      gst_video_overlay_rectangle_apply_global_alpha (rectangle, 1.0);
     }
+    GST_RECTANGLE_UNLOCK (rectangle);
+    return rectangle->pixels;
   }
 
-  /* see if we've got one cached already */
+  GST_RECTANGLE_LOCK (rectangle);
+  /* the variants are made from the pixels without global alpha */
+  if (rectangle->applied_global_alpha != 1.0)
+    gst_video_overlay_rectangle_apply_global_alpha (rectangle, 1.0);
+  if (rectangle->cache == NULL)
+    rectangle->cache = gst_video_overlay_rectangle_cache_new ();
+  cache = rectangle->cache;
+  GST_RECTANGLE_UNLOCK (rectangle);
+
+  g_mutex_lock (&cache->lock);
+  variant = gst_video_overlay_rectangle_get_variant (rectangle, cache,
+      wanted_width, wanted_height, wanted_format, flags);
+  /* copies of the rectangle might evict it while we use it */
+  gst_video_overlay_rectangle_ref (variant);
+  g_mutex_unlock (&cache->lock);
+
+  /* global alpha is applied on our own copy of the variant, the cached one
+   * is shared and must stay untouched */
   GST_RECTANGLE_LOCK (rectangle);
   for (l = rectangle->scaled_rectangles; l != NULL; l = l->next) {
     GstVideoOverlayRectangle *r = l->data;
@@ -1192,123 +1447,33 @@ gst_video_overlay_rectangle_get_pixels_raw_internal (GstVideoOverlayRectangle *
         GST_VIDEO_INFO_HEIGHT (&r->info) == wanted_height &&
         GST_VIDEO_INFO_FORMAT (&r->info) == wanted_format &&
         gst_video_overlay_rectangle_is_same_alpha_type (r->flags, flags)) {
-      /* we'll keep these rectangles around until finalize, so it's ok not
-       * to take our own ref here */
-      scaled_rect = r;
+      alpha_rect = r;
       break;
     }
   }
-  GST_RECTANGLE_UNLOCK (rectangle);
-
-  if (scaled_rect != NULL)
-    goto done;
+  if (alpha_rect == NULL) {
+    GstBuffer *buf = gst_buffer_copy_deep (variant->pixels);
 
-  /* maybe have one in the right format though */
-  if (format != wanted_format) {
-    GST_RECTANGLE_LOCK (rectangle);
-    for (l = rectangle->scaled_rectangles; l != NULL; l = l->next) {
-      GstVideoOverlayRectangle *r = l->data;
-
-      if (GST_VIDEO_INFO_FORMAT (&r->info) == wanted_format &&
-          gst_video_overlay_rectangle_is_same_alpha_type (r->flags, flags)) {
-        /* we'll keep these rectangles around until finalize, so it's ok not
-         * to take our own ref here */
-        conv_rect = r;
-        break;
-      }
-    }
-    GST_RECTANGLE_UNLOCK (rectangle);
-  } else {
-    conv_rect = rectangle;
-  }
-
-  if (conv_rect == NULL) {
-    GstVideoInfo conv_info;
-
-    gst_video_overlay_rectangle_convert (&rectangle->info, rectangle->pixels,
-        wanted_format, &conv_info, &buf);
-    gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
-        GST_VIDEO_INFO_FORMAT (&conv_info), width, height);
-    conv_rect = gst_video_overlay_rectangle_new_raw (buf,
-        0, 0, width, height, rectangle->flags);
-    if (rectangle->global_alpha != 1.0)
-      gst_video_overlay_rectangle_set_global_alpha (scaled_rect,
-          rectangle->global_alpha);
+    alpha_rect = gst_video_overlay_rectangle_new_raw (buf, 0, 0,
+        wanted_width, wanted_height, variant->flags);
     gst_buffer_unref (buf);
-    /* keep this converted one around as well in any case */
-    GST_RECTANGLE_LOCK (rectangle);
     rectangle->scaled_rectangles =
-        g_list_prepend (rectangle->scaled_rectangles, conv_rect);
-    GST_RECTANGLE_UNLOCK (rectangle);
-  }
-
-  /* now we continue from conv_rect */
-  width = GST_VIDEO_INFO_WIDTH (&conv_rect->info);
-  height = GST_VIDEO_INFO_HEIGHT (&conv_rect->info);
-  format = GST_VIDEO_INFO_FORMAT (&conv_rect->info);
-
-  /* not cached yet, do the preprocessing and put the result into our cache */
-  if (wanted_width != width || wanted_height != height) {
-    GstVideoInfo scaled_info;
-
-    /* we could check the cache for a scaled rect with global_alpha == 1 here */
-    gst_video_blend_scale_linear_RGBA (&conv_rect->info, conv_rect->pixels,
-        wanted_height, wanted_width, &scaled_info, &buf);
-    info = scaled_info;
-    gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
-        GST_VIDEO_INFO_FORMAT (&conv_rect->info), wanted_width, wanted_height);
-  } else if (!gst_video_overlay_rectangle_is_same_alpha_type (conv_rect->flags,
-          flags)) {
-    /* if we don't have to scale, we have to modify the alpha values, so we
-     * need to make a copy of the pixel memory (and we take ownership below) */
-    buf = gst_buffer_copy (conv_rect->pixels);
-    info = conv_rect->info;
-  } else {
-    /* do not need to scale or modify alpha values, almost done then */
-    scaled_rect = conv_rect;
-    goto done;
+        g_list_prepend (rectangle->scaled_rectangles, alpha_rect);
   }
-
-  new_flags = conv_rect->flags;
-  gst_video_frame_map (&frame, &info, buf, GST_MAP_READWRITE);
-  if (!gst_video_overlay_rectangle_is_same_alpha_type (conv_rect->flags, flags)) {
-    if (rectangle->flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA) {
-      gst_video_overlay_rectangle_unpremultiply (&frame);
-      new_flags &= ~GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA;
-    } else {
-      gst_video_overlay_rectangle_premultiply (&frame);
-      new_flags |= GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA;
-    }
-  }
-  gst_video_frame_unmap (&frame);
-
-  scaled_rect = gst_video_overlay_rectangle_new_raw (buf,
-      0, 0, wanted_width, wanted_height, new_flags);
-  if (conv_rect->global_alpha != 1.0)
-    gst_video_overlay_rectangle_set_global_alpha (scaled_rect,
-        conv_rect->global_alpha);
-  gst_buffer_unref (buf);
-
-  GST_RECTANGLE_LOCK (rectangle);
-  rectangle->scaled_rectangles =
-      g_list_prepend (rectangle->scaled_rectangles, scaled_rect);
-  GST_RECTANGLE_UNLOCK (rectangle);
-
-done:
-
-  GST_RECTANGLE_LOCK (rectangle);
   if (apply_global_alpha
-      && scaled_rect->applied_global_alpha != rectangle->global_alpha) {
-    gst_video_overlay_rectangle_apply_global_alpha (scaled_rect,
+      && alpha_rect->applied_global_alpha != rectangle->global_alpha) {
+    gst_video_overlay_rectangle_apply_global_alpha (alpha_rect,
         rectangle->global_alpha);
-    gst_video_overlay_rectangle_set_global_alpha (scaled_rect,
+    gst_video_overlay_rectangle_set_global_alpha (alpha_rect,
         rectangle->global_alpha);
-  } else if (revert_global_alpha && scaled_rect->applied_global_alpha != 1.0) {
-    gst_video_overlay_rectangle_apply_global_alpha (scaled_rect, 1.0);
+  } else if (revert_global_alpha && alpha_rect->applied_global_alpha != 1.0) {
+    gst_video_overlay_rectangle_apply_global_alpha (alpha_rect, 1.0);
   }
   GST_RECTANGLE_UNLOCK (rectangle);
 
-  return scaled_rect->pixels;
+  gst_video_overlay_rectangle_unref (variant);
+
+  return alpha_rect->pixels;
 }
 
 
@@ -1565,6 +1730,16 @@ gst_video_overlay_rectangle_copy (GstVideoOverlayRectangle * rectangle)
     gst_video_overlay_rectangle_set_global_alpha (copy,
         rectangle->global_alpha);
 
+  /* the copy has the same pixels, share the cached variants unless our
+   * pixels have global alpha applied */
+  GST_RECTANGLE_LOCK (rectangle);
+  if (rectangle->applied_global_alpha == 1.0) {
+    if (rectangle->cache == NULL)
+      rectangle->cache = gst_video_overlay_rectangle_cache_new ();
+    copy->cache = gst_video_overlay_rectangle_cache_ref (rectangle->cache);
+  }
+  GST_RECTANGLE_UNLOCK (rectangle);
+
   return copy;
 }
 
@@ -91,6 +91,115 @@ struct _ResamplerParams
   GstVideoResampler *resampler;
 };
 
+/* Computed taps are kept in a small LRU cache, the same resamplers are
+ * typically created over and over when converters are recreated after caps
+ * changes. The key contains everything the taps are computed from. */
+#define RESAMPLER_CACHE_SIZE 16
+
+typedef struct
+{
+  GstVideoResamplerMethod method;
+  GstVideoResamplerFlags flags;
+  gint in_size;
+  gint out_size;
+  guint max_taps;
+  gdouble shift;
+  gdouble b, c;
+  gdouble ex, fx, dx;
+  gdouble envelope;
+  gdouble sharpness;
+  gdouble sharpen;
+} ResamplerKey;
+
+typedef struct
+{
+  ResamplerKey key;
+  GstVideoResampler resampler;
+} ResamplerCacheEntry;
+
+static GMutex resampler_cache_lock;
+static GQueue resampler_cache = G_QUEUE_INIT;
+
+static void
+resampler_make_key (ResamplerKey * key, ResamplerParams * params)
+{
+  GstVideoResampler *resampler = params->resampler;
+
+  /* clear the padding too, keys are compared with memcmp */
+  memset (key, 0, sizeof (ResamplerKey));
+  key->method = params->method;
+  key->flags = params->flags;
+  key->in_size = resampler->in_size;
+  key->out_size = resampler->out_size;
+  key->max_taps = resampler->max_taps;
+  key->shift = params->shift;
+  key->b = params->b;
+  key->c = params->c;
+  key->ex = params->ex;
+  key->fx = params->fx;
+  key->dx = params->dx;
+  key->envelope = params->envelope;
+  key->sharpness = params->sharpness;
+  key->sharpen = params->sharpen;
+}
+
+static void
+resampler_copy_tables (GstVideoResampler * dest, const GstVideoResampler * src)
+{
+  dest->taps = g_memdup (src->taps,
+      sizeof (gdouble) * src->max_taps * src->out_size);
+  dest->n_taps = g_memdup (src->n_taps, sizeof (guint32) * src->out_size);
+  dest->offset = g_memdup (src->offset, sizeof (guint32) * src->out_size);
+  dest->phase = g_memdup (src->phase, sizeof (guint32) * src->out_size);
+}
+
+static gboolean
+resampler_cache_lookup (const ResamplerKey * key, GstVideoResampler * resampler)
+{
+  GList *walk;
+  gboolean res = FALSE;
+
+  g_mutex_lock (&resampler_cache_lock);
+  for (walk = resampler_cache.head; walk; walk = walk->next) {
+    ResamplerCacheEntry *entry = walk->data;
+
+    if (memcmp (&entry->key, key, sizeof (ResamplerKey)) == 0) {
+      resampler_copy_tables (resampler, &entry->resampler);
+      /* move to the front */
+      g_queue_unlink (&resampler_cache, walk);
+      g_queue_push_head_link (&resampler_cache, walk);
+      res = TRUE;
+      break;
+    }
+  }
+  g_mutex_unlock (&resampler_cache_lock);
+
+  return res;
+}
+
+static void
+resampler_cache_insert (const ResamplerKey * key,
+    const GstVideoResampler * resampler)
+{
+  ResamplerCacheEntry *entry, *old = NULL;
+
+  entry = g_slice_new0 (ResamplerCacheEntry);
+  entry->key = *key;
+  entry->resampler = *resampler;
+  resampler_copy_tables (&entry->resampler, resampler);
+
+  g_mutex_lock (&resampler_cache_lock);
+  g_queue_push_head (&resampler_cache, entry);
+  if (resampler_cache.length > RESAMPLER_CACHE_SIZE)
+    old = g_queue_pop_tail (&resampler_cache);
+  g_mutex_unlock (&resampler_cache_lock);
+
+  if (old) {
+    gst_video_resampler_clear (&old->resampler);
+    g_slice_free (ResamplerCacheEntry, old);
+  }
+}
+
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
 {
@@ -345,7 +454,8 @@ gst_video_resampler_init (GstVideoResampler * resampler,
     guint n_phases, guint n_taps, gdouble shift, guint in_size, guint out_size,
     GstStructure * options)
 {
-  ResamplerParams params;
+  ResamplerParams params = { 0, };
+  ResamplerKey key;
   gint max_taps;
   gdouble scale_factor;
 
@@ -418,7 +528,13 @@ gst_video_resampler_init (GstVideoResampler * resampler,
 
   resampler->max_taps = n_taps;
 
-  resampler_calculate_taps (&params);
+  resampler_make_key (&key, &params);
+  if (resampler_cache_lookup (&key, resampler)) {
+    GST_DEBUG ("reusing cached taps");
+  } else {
+    resampler_calculate_taps (&params);
+    resampler_cache_insert (&key, resampler);
+  }
 
   resampler_dump (resampler);
 
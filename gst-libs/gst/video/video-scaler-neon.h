@@ -0,0 +1,126 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <arm_neon.h>
+
+/* 8 pixels, the taps are in 16 bits and wrap like the orc code */
+static inline uint8x8_t
+scale_u8_lq_neon (int16x8_t sum)
+{
+  sum = vaddq_s16 (sum, vdupq_n_s16 (SCALE_U8_LQ_ROUND));
+  return vqmovun_s16 (vshrq_n_s16 (sum, SCALE_U8_LQ));
+}
+
+/* 4 pixels with 32 bits sums */
+static inline uint16x4_t
+scale_u16_neon (int32x4_t sum)
+{
+  sum = vaddq_s32 (sum, vdupq_n_s32 (SCALE_U16_ROUND_ORC));
+  return vqmovun_s32 (vshrq_n_s32 (sum, SCALE_U16));
+}
+
+static inline void
+resample_v_ntap_u8_neon (guint8 * d, guint8 ** srcs, gint src_inc,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    int16x8_t sum = vdupq_n_s16 (0);
+
+    for (j = 0; j < n_taps; j++) {
+      int16x8_t s =
+          vreinterpretq_s16_u16 (vmovl_u8 (vld1_u8 (srcs[j * src_inc] + i)));
+      sum = vmlaq_n_s16 (sum, s, taps[j]);
+    }
+    vst1_u8 (d + i, scale_u8_lq_neon (sum));
+  }
+  resample_v_ntap_u8_c (d, srcs, src_inc, taps, n_taps, i, count);
+}
+
+static inline void
+resample_h_ntap_u8_neon (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    int16x8_t sum = vdupq_n_s16 (0);
+
+    for (j = 0; j < n_taps; j++) {
+      int16x8_t s =
+          vreinterpretq_s16_u16 (vmovl_u8 (vld1_u8 (pixels + j * count + i)));
+      sum = vmlaq_s16 (sum, s, vld1q_s16 (taps + j * count + i));
+    }
+    vst1_u8 (d + i, scale_u8_lq_neon (sum));
+  }
+  resample_h_ntap_u8_c (d, pixels, taps, n_taps, i, count);
+}
+
+static inline void
+resample_v_ntap_u16_neon (guint16 * d, guint16 ** srcs, gint src_inc,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 4 <= count; i += 4) {
+    int32x4_t sum = vdupq_n_s32 (0);
+
+    for (j = 0; j < n_taps; j++) {
+      int32x4_t s =
+          vreinterpretq_s32_u32 (vmovl_u16 (vld1_u16 (srcs[j * src_inc] + i)));
+      sum = vmlaq_n_s32 (sum, s, taps[j]);
+    }
+    vst1_u16 (d + i, scale_u16_neon (sum));
+  }
+  resample_v_ntap_u16_c (d, srcs, src_inc, taps, n_taps, i, count);
+}
+
+static inline void
+resample_h_ntap_u16_neon (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 4 <= count; i += 4) {
+    int32x4_t sum = vdupq_n_s32 (0);
+
+    for (j = 0; j < n_taps; j++) {
+      int32x4_t s =
+          vreinterpretq_s32_u32 (vmovl_u16 (vld1_u16 (pixels + j * count + i)));
+      int32x4_t t = vmovl_s16 (vld1_s16 (taps + j * count + i));
+      sum = vmlaq_s32 (sum, s, t);
+    }
+    vst1_u16 (d + i, scale_u16_neon (sum));
+  }
+  resample_h_ntap_u16_c (d, pixels, taps, n_taps, i, count);
+}
+
+MAKE_RESAMPLE_FUNCS (4, neon);
+MAKE_RESAMPLE_FUNCS (8, neon);
+
+static void
+video_scaler_check_neon (const gchar * option)
+{
+  if (!strcmp (option, "neon")) {
+    GST_DEBUG ("enable NEON optimisations");
+    SET_RESAMPLE_FUNCS (4, neon);
+    SET_RESAMPLE_FUNCS (8, neon);
+  }
+}
@@ -0,0 +1,157 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "gst/gst-cpu-x86-private.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (GST_CPU_X86_HAVE_TARGET)
+#define HAVE_AVX2_TARGET
+
+#pragma GCC push_options
+#pragma GCC target ("avx2")
+#include <immintrin.h>
+
+/* 16 pixels, the taps are in 16 bits and wrap like the orc code */
+static inline __m128i
+scale_u8_lq_avx2 (__m256i sum)
+{
+  sum = _mm256_add_epi16 (sum, _mm256_set1_epi16 (SCALE_U8_LQ_ROUND));
+  sum = _mm256_srai_epi16 (sum, SCALE_U8_LQ);
+  sum = _mm256_packus_epi16 (sum, sum);
+  sum = _mm256_permute4x64_epi64 (sum, _MM_SHUFFLE (3, 1, 2, 0));
+  return _mm256_castsi256_si128 (sum);
+}
+
+/* 8 pixels with 32 bits sums */
+static inline __m128i
+scale_u16_avx2 (__m256i sum)
+{
+  sum = _mm256_add_epi32 (sum, _mm256_set1_epi32 (SCALE_U16_ROUND_ORC));
+  sum = _mm256_srai_epi32 (sum, SCALE_U16);
+  sum = _mm256_packus_epi32 (sum, sum);
+  sum = _mm256_permute4x64_epi64 (sum, _MM_SHUFFLE (3, 1, 2, 0));
+  return _mm256_castsi256_si128 (sum);
+}
+
+static inline void
+resample_v_ntap_u8_avx2 (guint8 * d, guint8 ** srcs, gint src_inc,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i sum = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i s = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *)
+              (srcs[j * src_inc] + i)));
+      sum = _mm256_add_epi16 (sum,
+          _mm256_mullo_epi16 (s, _mm256_set1_epi16 (taps[j])));
+    }
+    _mm_storeu_si128 ((__m128i *) (d + i), scale_u8_lq_avx2 (sum));
+  }
+  resample_v_ntap_u8_c (d, srcs, src_inc, taps, n_taps, i, count);
+}
+
+static inline void
+resample_h_ntap_u8_avx2 (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i sum = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i s = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *)
+              (pixels + j * count + i)));
+      __m256i t = _mm256_loadu_si256 ((const __m256i *) (taps + j * count + i));
+      sum = _mm256_add_epi16 (sum, _mm256_mullo_epi16 (s, t));
+    }
+    _mm_storeu_si128 ((__m128i *) (d + i), scale_u8_lq_avx2 (sum));
+  }
+  resample_h_ntap_u8_c (d, pixels, taps, n_taps, i, count);
+}
+
+static inline void
+resample_v_ntap_u16_avx2 (guint16 * d, guint16 ** srcs, gint src_inc,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    __m256i sum = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i s = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *)
+              (srcs[j * src_inc] + i)));
+      sum = _mm256_add_epi32 (sum,
+          _mm256_mullo_epi32 (s, _mm256_set1_epi32 (taps[j])));
+    }
+    _mm_storeu_si128 ((__m128i *) (d + i), scale_u16_avx2 (sum));
+  }
+  resample_v_ntap_u16_c (d, srcs, src_inc, taps, n_taps, i, count);
+}
+
+static inline void
+resample_h_ntap_u16_avx2 (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i, j;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    __m256i sum = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i s = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *)
+              (pixels + j * count + i)));
+      __m256i t = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *)
+              (taps + j * count + i)));
+      sum = _mm256_add_epi32 (sum, _mm256_mullo_epi32 (s, t));
+    }
+    _mm_storeu_si128 ((__m128i *) (d + i), scale_u16_avx2 (sum));
+  }
+  resample_h_ntap_u16_c (d, pixels, taps, n_taps, i, count);
+}
+
+MAKE_RESAMPLE_FUNCS (4, avx2);
+MAKE_RESAMPLE_FUNCS (8, avx2);
+
+#pragma GCC pop_options
+#endif /* HAVE_IMMINTRIN_H */
+
+static void
+video_scaler_check_x86 (const gchar * option)
+{
+  if (!strcmp (option, "avx2")) {
+#if defined (HAVE_AVX2_TARGET)
+    GST_DEBUG ("enable AVX2 optimisations");
+    SET_RESAMPLE_FUNCS (4, avx2);
+    SET_RESAMPLE_FUNCS (8, avx2);
+#else
+    GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+  }
+}
+
+static void
+video_scaler_check_x86_cpu (void)
+{
+  if (gst_cpu_x86_get_flags () & GST_CPU_X86_AVX2)
+    video_scaler_check_x86 ("avx2");
+}
@@ -25,6 +25,10 @@
 #include <stdio.h>
 #include <math.h>
 
+#ifdef HAVE_ORC
+#include <orc/orc.h>
+#endif
+
 /**
  * SECTION:gstvideoscaler
  * @short_description: Utility object for rescaling video frames
@@ -72,6 +76,8 @@ ensure_debug_category (void)
 #define SCALE_U8_LQ_ROUND (1 << (SCALE_U8_LQ -1))
 #define SCALE_U16         12
 #define SCALE_U16_ROUND   (1 << (SCALE_U16 -1))
+/* what video_orc_resample_scaletaps_u16 adds before shifting */
+#define SCALE_U16_ROUND_ORC ((1 << SCALE_U16) - 1)
 
 #define LQ
 
@@ -104,6 +110,176 @@ struct _GstVideoScaler
   gpointer tmpline2;
 };
 
+/* 4 and 8 taps versions of the LQ u8 and the u16 resample loops. They are
+ * NULL unless a SIMD version was selected at runtime, the orc functions are
+ * used then. */
+typedef void (*ResampleVFunc) (gpointer d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint count);
+typedef void (*ResampleHFunc) (gpointer d, gconstpointer pixels,
+    const gint16 * taps, gint count);
+
+static ResampleVFunc resample_v_4tap_u8;
+static ResampleVFunc resample_v_8tap_u8;
+static ResampleVFunc resample_v_4tap_u16;
+static ResampleVFunc resample_v_8tap_u16;
+static ResampleHFunc resample_h_4tap_u8;
+static ResampleHFunc resample_h_8tap_u8;
+static ResampleHFunc resample_h_4tap_u16;
+static ResampleHFunc resample_h_8tap_u16;
+
+/* C versions, used for the pixels left over by the SIMD loops */
+static inline void
+resample_v_ntap_u8_c (guint8 * d, guint8 ** srcs, gint src_inc,
+    const gint16 * taps, gint n_taps, gint start, gint count)
+{
+  gint i, j;
+
+  for (i = start; i < count; i++) {
+    guint16 sum = SCALE_U8_LQ_ROUND;
+
+    for (j = 0; j < n_taps; j++)
+      sum += srcs[j * src_inc][i] * taps[j];
+    d[i] = CLAMP ((gint16) sum >> SCALE_U8_LQ, 0, 255);
+  }
+}
+
+static inline void
+resample_h_ntap_u8_c (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint n_taps, gint start, gint count)
+{
+  gint i, j;
+
+  for (i = start; i < count; i++) {
+    guint16 sum = SCALE_U8_LQ_ROUND;
+
+    for (j = 0; j < n_taps; j++)
+      sum += pixels[j * count + i] * taps[j * count + i];
+    d[i] = CLAMP ((gint16) sum >> SCALE_U8_LQ, 0, 255);
+  }
+}
+
+static inline void
+resample_v_ntap_u16_c (guint16 * d, guint16 ** srcs, gint src_inc,
+    const gint16 * taps, gint n_taps, gint start, gint count)
+{
+  gint i, j;
+
+  for (i = start; i < count; i++) {
+    guint32 sum = SCALE_U16_ROUND_ORC;
+
+    for (j = 0; j < n_taps; j++)
+      sum += srcs[j * src_inc][i] * taps[j];
+    d[i] = CLAMP ((gint32) sum >> SCALE_U16, 0, 65535);
+  }
+}
+
+static inline void
+resample_h_ntap_u16_c (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint n_taps, gint start, gint count)
+{
+  gint i, j;
+
+  for (i = start; i < count; i++) {
+    guint32 sum = SCALE_U16_ROUND_ORC;
+
+    for (j = 0; j < n_taps; j++)
+      sum += pixels[j * count + i] * taps[j * count + i];
+    d[i] = CLAMP ((gint32) sum >> SCALE_U16, 0, 65535);
+  }
+}
+
+#define MAKE_RESAMPLE_FUNCS(taps,arch)                                 \
+static void                                                            \
+resample_v_##taps##tap_u8_##arch (gpointer d, gpointer srcs[],         \
+    gint src_inc, const gint16 * t, gint count)                        \
+{                                                                      \
+  resample_v_ntap_u8_##arch (d, (guint8 **) srcs, src_inc, t, taps,    \
+      count);                                                          \
+}                                                                      \
+static void                                                            \
+resample_h_##taps##tap_u8_##arch (gpointer d, gconstpointer pixels,    \
+    const gint16 * t, gint count)                                      \
+{                                                                      \
+  resample_h_ntap_u8_##arch (d, pixels, t, taps, count);               \
+}                                                                      \
+static void                                                            \
+resample_v_##taps##tap_u16_##arch (gpointer d, gpointer srcs[],        \
+    gint src_inc, const gint16 * t, gint count)                        \
+{                                                                      \
+  resample_v_ntap_u16_##arch (d, (guint16 **) srcs, src_inc, t, taps,  \
+      count);                                                          \
+}                                                                      \
+static void                                                            \
+resample_h_##taps##tap_u16_##arch (gpointer d, gconstpointer pixels,   \
+    const gint16 * t, gint count)                                      \
+{                                                                      \
+  resample_h_ntap_u16_##arch (d, pixels, t, taps, count);              \
+}
+
+#define SET_RESAMPLE_FUNCS(taps,arch)                                  \
+G_STMT_START {                                                         \
+  resample_v_##taps##tap_u8 = resample_v_##taps##tap_u8_##arch;        \
+  resample_h_##taps##tap_u8 = resample_h_##taps##tap_u8_##arch;        \
+  resample_v_##taps##tap_u16 = resample_v_##taps##tap_u16_##arch;      \
+  resample_h_##taps##tap_u16 = resample_h_##taps##tap_u16_##arch;      \
+} G_STMT_END
+
+#if defined HAVE_ORC && !defined DISABLE_ORC
+# if defined (HAVE_ARM_NEON)
+#  define CHECK_NEON
+#  include "video-scaler-neon.h"
+# endif
+# if defined (__i386__) || defined (__x86_64__)
+#  define CHECK_X86
+#  include "video-scaler-x86.h"
+# endif
+#endif
+
+static void
+video_scaler_init (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#if defined HAVE_ORC && !defined DISABLE_ORC
+    orc_init ();
+    {
+      OrcTarget *target = orc_target_get_default ();
+      gint i;
+
+      if (target) {
+        const gchar *name;
+        unsigned int flags = orc_target_get_default_flags (target);
+
+        for (i = -1; i < 32; ++i) {
+          if (i == -1) {
+            name = orc_target_get_name (target);
+            GST_DEBUG ("target %s, default flags %08x", name, flags);
+          } else if (flags & (1U << i)) {
+            name = orc_target_get_flag_name (target, i);
+            GST_DEBUG ("target flag %s", name);
+          } else
+            name = NULL;
+
+          if (name) {
+#ifdef CHECK_X86
+            video_scaler_check_x86 (name);
+#endif
+#ifdef CHECK_NEON
+            video_scaler_check_neon (name);
+#endif
+          }
+        }
+      }
+    }
+#ifdef CHECK_X86
+    video_scaler_check_x86_cpu ();
+#endif
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
 static void
 resampler_zip (GstVideoResampler * resampler, const GstVideoResampler * r1,
     const GstVideoResampler * r2)
@@ -212,6 +388,8 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   g_return_val_if_fail (in_size != 0, NULL);
   g_return_val_if_fail (out_size != 0, NULL);
 
+  video_scaler_init ();
+
   scale = g_slice_new0 (GstVideoScaler);
 
   GST_DEBUG ("%d %u  %u->%u", method, n_taps, in_size, out_size);
@@ -690,6 +868,10 @@ video_scale_h_ntap_u8 (GstVideoScaler * scale,
   if (max_taps == 2) {
     video_orc_resample_h_2tap_u8_lq (d, pixels, pixels + count, taps,
         taps + count, count);
+  } else if (max_taps == 4 && resample_h_4tap_u8) {
+    resample_h_4tap_u8 (d, pixels, taps, count);
+  } else if (max_taps == 8 && resample_h_8tap_u8) {
+    resample_h_8tap_u8 (d, pixels, taps, count);
   } else {
     /* first pixels with first tap to temp */
     if (max_taps >= 3) {
@@ -803,6 +985,10 @@ video_scale_h_ntap_u16 (GstVideoScaler * scale,
   if (max_taps == 2) {
     video_orc_resample_h_2tap_u16 (d, pixels, pixels + count, taps,
         taps + count, count);
+  } else if (max_taps == 4 && resample_h_4tap_u16) {
+    resample_h_4tap_u16 (d, pixels, taps, count);
+  } else if (max_taps == 8 && resample_h_8tap_u16) {
+    resample_h_8tap_u16 (d, pixels, taps, count);
   } else {
     /* first pixels with first tap to t4 */
     video_orc_resample_h_multaps_u16 (temp, pixels, taps, count);
@@ -964,8 +1150,11 @@ video_scale_v_4tap_u8 (GstVideoScaler * scale,
   p4 = taps[3];
 
 #ifdef LQ
-  video_orc_resample_v_4tap_u8_lq (d, s1, s2, s3, s4, p1, p2, p3, p4,
-      width * n_elems);
+  if (resample_v_4tap_u8)
+    resample_v_4tap_u8 (d, srcs, src_inc, taps, width * n_elems);
+  else
+    video_orc_resample_v_4tap_u8_lq (d, s1, s2, s3, s4, p1, p2, p3, p4,
+        width * n_elems);
 #else
   video_orc_resample_v_4tap_u8 (d, s1, s2, s3, s4, p1, p2, p3, p4,
       width * n_elems);
@@ -1003,6 +1192,11 @@ video_scale_v_ntap_u8 (GstVideoScaler * scale,
   count = width * n_elems;
 
 #ifdef LQ
+  if (max_taps == 8 && resample_v_8tap_u8) {
+    resample_v_8tap_u8 (d, srcs, src_inc, taps, count);
+    return;
+  }
+
   if (max_taps >= 4) {
     video_orc_resample_v_multaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
         srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
@@ -1086,6 +1280,14 @@ video_scale_v_ntap_u16 (GstVideoScaler * scale,
   temp = (gint32 *) scale->tmpline2;
   count = width * n_elems;
 
+  if (max_taps == 4 && resample_v_4tap_u16) {
+    resample_v_4tap_u16 (d, srcs, src_inc, taps, count);
+    return;
+  } else if (max_taps == 8 && resample_v_8tap_u16) {
+    resample_v_8tap_u16 (d, srcs, src_inc, taps, count);
+    return;
+  }
+
   video_orc_resample_v_multaps_u16 (temp, srcs[0], taps[0], count);
   for (i = 1; i < max_taps; i++) {
     video_orc_resample_v_muladdtaps_u16 (temp, srcs[i * src_inc], taps[i],
@@ -1191,7 +1393,7 @@ static gboolean
 get_functions (GstVideoScaler * hscale, GstVideoScaler * vscale,
     GstVideoFormat format,
     GstVideoScalerHFunc * hfunc, GstVideoScalerVFunc * vfunc,
-    gint * n_elems, guint * width)
+    gint * n_elems, guint * width, gint * pstride)
 {
   gint bits;
   gboolean mono = FALSE;
@@ -1249,6 +1451,9 @@ get_functions (GstVideoScaler * hscale, GstVideoScaler * vscale,
     default:
       return FALSE;
   }
+  if (pstride)
+    *pstride = *n_elems * (bits / 8);
+
   if (bits == 8) {
     switch (hscale ? hscale->resampler.max_taps : 0) {
       case 0:
@@ -1346,7 +1551,8 @@ gst_video_scaler_horizontal (GstVideoScaler * scale, GstVideoFormat format,
   g_return_if_fail (dest != NULL);
   g_return_if_fail (dest_offset + width <= scale->resampler.out_size);
 
-  if (!get_functions (scale, NULL, format, &func, NULL, &n_elems, &width)
+  if (!get_functions (scale, NULL, format, &func, NULL, &n_elems, &width,
+          NULL)
       || func == NULL)
     goto no_func;
 
@@ -1388,7 +1594,8 @@ gst_video_scaler_vertical (GstVideoScaler * scale, GstVideoFormat format,
   g_return_if_fail (dest != NULL);
   g_return_if_fail (dest_offset < scale->resampler.out_size);
 
-  if (!get_functions (NULL, scale, format, NULL, &func, &n_elems, &width)
+  if (!get_functions (NULL, scale, format, NULL, &func, &n_elems, &width,
+          NULL)
       || func == NULL)
     goto no_func;
 
@@ -1405,6 +1612,28 @@ no_func:
   }
 }
 
+/* the amount of source pixels that the vertical scaler reads for one
+ * output line in a column strip. Strips are kept around the size of the L2
+ * cache so that the source lines can be reused for the next output lines. */
+#define TILE_SIZE (128 * 1024)
+
+/* returns the width in pixels of the column strips for vertically scaling
+ * @width pixels or 0 when the lines are small enough to be done at once */
+static guint
+get_tile_width (GstVideoScaler * vscale, gint pstride, guint width)
+{
+  guint v_taps, tile;
+
+  v_taps = vscale->resampler.max_taps;
+  if (v_taps * width * pstride <= TILE_SIZE)
+    return 0;
+
+  /* multiple of 16 pixels to keep the SIMD loops busy */
+  tile = GST_ROUND_DOWN_16 (TILE_SIZE / (v_taps * pstride));
+  tile = MAX (tile, 16);
+
+  return tile < width ? tile : 0;
+}
 
 /**
  * gst_video_scaler_2d:
@@ -1435,7 +1664,7 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
     gpointer dest, gint dest_stride, guint x, guint y,
     guint width, guint height)
 {
-  gint n_elems;
+  gint n_elems, pstride;
   GstVideoScalerHFunc hfunc = NULL;
   GstVideoScalerVFunc vfunc = NULL;
   gint i;
@@ -1443,7 +1672,8 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
   g_return_if_fail (src != NULL);
   g_return_if_fail (dest != NULL);
 
-  if (!get_functions (hscale, vscale, format, &hfunc, &vfunc, &n_elems, &width))
+  if (!get_functions (hscale, vscale, format, &hfunc, &vfunc, &n_elems, &width,
+          &pstride))
     goto no_func;
 
 #define LINE(s,ss,i)  ((guint8 *)(s) + ((i) * (ss)))
@@ -1487,15 +1717,27 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
     lines = g_alloca (v_taps * sizeof (gpointer));
 
     if (hscale == NULL) {
-      /* only vertical scaling */
-      for (i = y; i < height; i++) {
-        guint in, j;
+      guint tile, tx, tw;
+
+      /* only vertical scaling, in column strips when the lines are too
+       * big to stay in the cache */
+      tile = get_tile_width (vscale, pstride, width);
+      if (tile == 0)
+        tile = width;
 
-        in = vscale->resampler.offset[i];
-        for (j = 0; j < v_taps; j++)
-          lines[j] = LINE (src, src_stride, in + j);
+      for (tx = 0; tx < width; tx += tile) {
+        tw = MIN (tile, width - tx);
 
-        vfunc (vscale, lines, LINE (dest, dest_stride, i), i, width, n_elems);
+        for (i = y; i < height; i++) {
+          guint in, j;
+
+          in = vscale->resampler.offset[i];
+          for (j = 0; j < v_taps; j++)
+            lines[j] = LINE (src, src_stride, in + j) + tx * pstride;
+
+          vfunc (vscale, lines, LINE (dest, dest_stride, i) + tx * pstride, i,
+              tw, n_elems);
+        }
       }
     } else {
       gint tmp_in = y;
@@ -1526,7 +1768,7 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
         }
       } else {
         guint vx, vw, w1, ws;
-        guint h_taps;
+        guint h_taps, tile;
 
         h_taps = hscale->resampler.max_taps;
         w1 = x + width - 1;
@@ -1553,18 +1795,50 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
         if (vscale->tmpwidth < vw)
           realloc_tmplines (vscale, n_elems, vw);
 
-        for (i = y; i < height; i++) {
-          guint in, j;
+        tile = get_tile_width (vscale, pstride, vw - vx);
 
-          in = vscale->resampler.offset[i];
-          for (j = 0; j < v_taps; j++)
-            lines[j] = LINE (src, src_stride, in + j) + vx * n_elems;
+        if (tile == 0) {
+          for (i = y; i < height; i++) {
+            guint in, j;
 
-          vfunc (vscale, lines, TMP_LINE (vscale, 0, v_taps) + vx * n_elems, i,
-              vw - vx, n_elems);
+            in = vscale->resampler.offset[i];
+            for (j = 0; j < v_taps; j++)
+              lines[j] = LINE (src, src_stride, in + j) + vx * n_elems;
 
-          hfunc (hscale, TMP_LINE (vscale, 0, v_taps), LINE (dest, dest_stride,
-                  i), x, width, n_elems);
+            vfunc (vscale, lines, TMP_LINE (vscale, 0, v_taps) + vx * n_elems,
+                i, vw - vx, n_elems);
+
+            hfunc (hscale, TMP_LINE (vscale, 0, v_taps), LINE (dest,
+                    dest_stride, i), x, width, n_elems);
+          }
+        } else {
+          gsize tmp_stride = sizeof (gint32) * vw * n_elems;
+
+          /* vertically scale up to v_taps lines in column strips into the
+           * temp lines, then scale those horizontally */
+          for (i = y; i < height; i += v_taps) {
+            guint n_lines, tx, tw, k;
+
+            n_lines = MIN (v_taps, height - i);
+
+            for (tx = vx; tx < vw; tx += tile) {
+              tw = MIN (tile, vw - tx);
+
+              for (k = 0; k < n_lines; k++) {
+                guint in, j;
+
+                in = vscale->resampler.offset[i + k];
+                for (j = 0; j < v_taps; j++)
+                  lines[j] = LINE (src, src_stride, in + j) + tx * pstride;
+
+                vfunc (vscale, lines, LINE (vscale->tmpline1, tmp_stride,
+                        k) + tx * pstride, i + k, tw, n_elems);
+              }
+            }
+            for (k = 0; k < n_lines; k++)
+              hfunc (hscale, LINE (vscale->tmpline1, tmp_stride, k),
+                  LINE (dest, dest_stride, i + k), x, width, n_elems);
+          }
         }
       }
     }
@@ -0,0 +1,166 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Copy the rows of a tile to a linear plane and split the interleaved
+ * chroma of a tile into two planes. The tiles are read once and the linear
+ * output is not read again by the conversion, so it is written with
+ * non-temporal stores where possible. tile_copy_finish() must be called
+ * after the last copy. */
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+
+static inline void
+tile_copy_rows (guint8 * d, gint dstride, const guint8 * s, gint sstride,
+    gint width, gint rows)
+{
+  gint i, j;
+
+  for (i = 0; i < rows; i++) {
+    j = 0;
+    if (((guintptr) d & 15) == 0) {
+      for (; j + 16 <= width; j += 16)
+        _mm_stream_si128 ((__m128i *) (d + j),
+            _mm_loadu_si128 ((const __m128i *) (s + j)));
+    }
+    if (j < width)
+      memcpy (d + j, s + j, width - j);
+    d += dstride;
+    s += sstride;
+  }
+}
+
+static inline void
+tile_split_rows (guint8 * du, gint ustride, guint8 * dv, gint vstride,
+    const guint8 * s, gint sstride, gint pairs, gint rows)
+{
+  const __m128i mask = _mm_set1_epi16 (0xff);
+  gint i, j;
+
+  for (i = 0; i < rows; i++) {
+    for (j = 0; j + 16 <= pairs; j += 16) {
+      __m128i a = _mm_loadu_si128 ((const __m128i *) (s + 2 * j));
+      __m128i b = _mm_loadu_si128 ((const __m128i *) (s + 2 * j + 16));
+
+      _mm_storeu_si128 ((__m128i *) (du + j),
+          _mm_packus_epi16 (_mm_and_si128 (a, mask), _mm_and_si128 (b,
+                  mask)));
+      _mm_storeu_si128 ((__m128i *) (dv + j),
+          _mm_packus_epi16 (_mm_srli_epi16 (a, 8), _mm_srli_epi16 (b, 8)));
+    }
+    for (; j < pairs; j++) {
+      du[j] = s[2 * j];
+      dv[j] = s[2 * j + 1];
+    }
+    du += ustride;
+    dv += vstride;
+    s += sstride;
+  }
+}
+
+static inline void
+tile_copy_finish (void)
+{
+  _mm_sfence ();
+}
+
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#include <arm_neon.h>
+
+static inline void
+tile_copy_rows (guint8 * d, gint dstride, const guint8 * s, gint sstride,
+    gint width, gint rows)
+{
+  gint i, j;
+
+  for (i = 0; i < rows; i++) {
+    for (j = 0; j + 16 <= width; j += 16)
+      vst1q_u8 (d + j, vld1q_u8 (s + j));
+    if (j < width)
+      memcpy (d + j, s + j, width - j);
+    d += dstride;
+    s += sstride;
+  }
+}
+
+static inline void
+tile_split_rows (guint8 * du, gint ustride, guint8 * dv, gint vstride,
+    const guint8 * s, gint sstride, gint pairs, gint rows)
+{
+  gint i, j;
+
+  for (i = 0; i < rows; i++) {
+    for (j = 0; j + 16 <= pairs; j += 16) {
+      uint8x16x2_t uv = vld2q_u8 (s + 2 * j);
+
+      vst1q_u8 (du + j, uv.val[0]);
+      vst1q_u8 (dv + j, uv.val[1]);
+    }
+    for (; j < pairs; j++) {
+      du[j] = s[2 * j];
+      dv[j] = s[2 * j + 1];
+    }
+    du += ustride;
+    dv += vstride;
+    s += sstride;
+  }
+}
+
+static inline void
+tile_copy_finish (void)
+{
+}
+
+#else
+
+static inline void
+tile_copy_rows (guint8 * d, gint dstride, const guint8 * s, gint sstride,
+    gint width, gint rows)
+{
+  gint i;
+
+  for (i = 0; i < rows; i++) {
+    memcpy (d, s, width);
+    d += dstride;
+    s += sstride;
+  }
+}
+
+static inline void
+tile_split_rows (guint8 * du, gint ustride, guint8 * dv, gint vstride,
+    const guint8 * s, gint sstride, gint pairs, gint rows)
+{
+  gint i, j;
+
+  for (i = 0; i < rows; i++) {
+    for (j = 0; j < pairs; j++) {
+      du[j] = s[2 * j];
+      dv[j] = s[2 * j + 1];
+    }
+    du += ustride;
+    dv += vstride;
+    s += sstride;
+  }
+}
+
+static inline void
+tile_copy_finish (void)
+{
+}
+#endif
@@ -29,6 +29,11 @@
  * The adder currently mixes all data received on the sinkpads as soon as
  * possible without trying to synchronize the streams.
  *
+ * By default the adder waits for data on all sinkpads. For live mixing, the
+ * #GstAdder:timeout property makes it mix the pads that have data when
+ * another pad stalled. With many sinkpads, the mixing is split over
+ * multiple threads.
+ *
  * Check out the audiomixer element in gst-plugins-bad for a better-behaving
  * audio mixing element: It will sync input streams correctly and also handle
  * live inputs properly.
@@ -149,10 +154,25 @@ gst_adder_pad_init (GstAdderPad * pad)
   pad->mute = DEFAULT_PAD_MUTE;
 }
 
+/* an input buffer that is added to the output buffer, the volume is copied
+ * from the pad so that it doesn't change while mixing */
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  gdouble volume;
+  gint volume_i8;
+  gint volume_i16;
+  gint volume_i32;
+} GstAdderInput;
+
+#define DEFAULT_TIMEOUT 0
+
 enum
 {
   PROP_0,
-  PROP_FILTER_CAPS
+  PROP_FILTER_CAPS,
+  PROP_TIMEOUT
 };
 
 /* elementfactory information */
@@ -188,6 +208,7 @@ G_DEFINE_TYPE_WITH_CODE (GstAdder, gst_adder, GST_TYPE_ELEMENT,
     G_IMPLEMENT_INTERFACE (GST_TYPE_CHILD_PROXY, gst_adder_child_proxy_init));
 
 static void gst_adder_dispose (GObject * object);
+static void gst_adder_finalize (GObject * object);
 static void gst_adder_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_adder_get_property (GObject * object, guint prop_id,
@@ -848,6 +869,7 @@ gst_adder_class_init (GstAdderClass * klass)
   gobject_class->set_property = gst_adder_set_property;
   gobject_class->get_property = gst_adder_get_property;
   gobject_class->dispose = gst_adder_dispose;
+  gobject_class->finalize = gst_adder_finalize;
 
   g_object_class_install_property (gobject_class, PROP_FILTER_CAPS,
       g_param_spec_boxed ("caps", "Target caps",
@@ -856,6 +878,23 @@ gst_adder_class_init (GstAdderClass * klass)
           "object.", GST_TYPE_CAPS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAdder:timeout:
+   *
+   * When no output was produced for this amount of time, the pads that
+   * have data are mixed without waiting for the other pads. This makes it
+   * possible to mix live sources where one input can stall. Data that
+   * arrives after it was mixed without it is dropped.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_TIMEOUT,
+      g_param_spec_uint64 ("timeout", "Timeout",
+          "Time to wait for data on all pads before mixing the pads that "
+          "have data, in nanoseconds (0 = always wait)", 0, G_MAXUINT64,
+          DEFAULT_TIMEOUT, G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_adder_src_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -892,6 +931,11 @@ gst_adder_init (GstAdder * adder)
 
   adder->filter_caps = NULL;
 
+  adder->timeout = DEFAULT_TIMEOUT;
+  g_mutex_init (&adder->live_lock);
+  g_cond_init (&adder->live_cond);
+  adder->inputs = g_array_new (FALSE, FALSE, sizeof (GstAdderInput));
+
   /* keep track of the sinkpads requested */
   adder->collect = gst_collect_pads_new ();
   gst_collect_pads_set_function (adder->collect,
@@ -925,6 +969,18 @@ gst_adder_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static void
+gst_adder_finalize (GObject * object)
+{
+  GstAdder *adder = GST_ADDER (object);
+
+  g_mutex_clear (&adder->live_lock);
+  g_cond_clear (&adder->live_cond);
+  g_array_free (adder->inputs, TRUE);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_adder_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -953,6 +1009,11 @@ gst_adder_set_property (GObject * object, guint prop_id,
       GST_DEBUG_OBJECT (adder, "set new caps %" GST_PTR_FORMAT, new_caps);
       break;
     }
+    case PROP_TIMEOUT:
+      g_mutex_lock (&adder->live_lock);
+      adder->timeout = g_value_get_uint64 (value);
+      g_mutex_unlock (&adder->live_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -971,6 +1032,11 @@ gst_adder_get_property (GObject * object, guint prop_id, GValue * value,
       gst_value_set_caps (value, adder->filter_caps);
       GST_OBJECT_UNLOCK (adder);
       break;
+    case PROP_TIMEOUT:
+      g_mutex_lock (&adder->live_lock);
+      g_value_set_uint64 (value, adder->timeout);
+      g_mutex_unlock (&adder->live_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1056,10 +1122,361 @@ gst_adder_do_clip (GstCollectPads * pads, GstCollectData * data,
 
   buffer = gst_audio_buffer_clip (buffer, &data->segment, rate, bpf);
 
+  if (buffer && adder->timeout > 0) {
+    GstClockTime end = GST_BUFFER_PTS (buffer);
+
+    /* in live mode, drop what arrives after we mixed without it */
+    if (GST_CLOCK_TIME_IS_VALID (end) && GST_BUFFER_DURATION_IS_VALID (buffer)) {
+      end += GST_BUFFER_DURATION (buffer);
+
+      if (gst_segment_to_running_time (&data->segment, GST_FORMAT_TIME,
+              end) <= gst_segment_to_running_time (&adder->segment,
+              GST_FORMAT_TIME, adder->segment.position)) {
+        GST_DEBUG_OBJECT (adder, "pad %s:%s: dropping late buffer",
+            GST_DEBUG_PAD_NAME (data->pad));
+        gst_buffer_unref (buffer);
+        buffer = NULL;
+      }
+    }
+
+    /* the pad has data again, wait for it */
+    if (buffer && !GST_COLLECT_PADS_STATE_IS_SET (data,
+            GST_COLLECT_PADS_STATE_WAITING))
+      gst_collect_pads_set_waiting (pads, data, TRUE);
+  }
+
   *out = buffer;
   return GST_FLOW_OK;
 }
 
+static void
+gst_adder_mix_input (GstAdder * adder, const GstAdderInput * input,
+    guint8 * out, const guint8 * in, guint n_samples)
+{
+  if (input->volume == 1.0) {
+    switch (adder->info.finfo->format) {
+      case GST_AUDIO_FORMAT_U8:
+        adder_orc_add_u8 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_S8:
+        adder_orc_add_s8 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_U16:
+        adder_orc_add_u16 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_S16:
+        adder_orc_add_s16 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_U32:
+        adder_orc_add_u32 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        adder_orc_add_s32 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        adder_orc_add_f32 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        adder_orc_add_f64 ((gpointer) out, (gpointer) in, n_samples);
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  } else {
+    switch (adder->info.finfo->format) {
+      case GST_AUDIO_FORMAT_U8:
+        adder_orc_add_volume_u8 ((gpointer) out, (gpointer) in,
+            input->volume_i8, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_S8:
+        adder_orc_add_volume_s8 ((gpointer) out, (gpointer) in,
+            input->volume_i8, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_U16:
+        adder_orc_add_volume_u16 ((gpointer) out, (gpointer) in,
+            input->volume_i16, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_S16:
+        adder_orc_add_volume_s16 ((gpointer) out, (gpointer) in,
+            input->volume_i16, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_U32:
+        adder_orc_add_volume_u32 ((gpointer) out, (gpointer) in,
+            input->volume_i32, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        adder_orc_add_volume_s32 ((gpointer) out, (gpointer) in,
+            input->volume_i32, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        adder_orc_add_volume_f32 ((gpointer) out, (gpointer) in,
+            input->volume, n_samples);
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        adder_orc_add_volume_f64 ((gpointer) out, (gpointer) in,
+            input->volume, n_samples);
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+}
+
+/* add samples [offset, offset + n_samples) of all inputs to @out, in pad
+ * order so that the result, including clipping, is the same for any split
+ * of the samples */
+static void
+gst_adder_mix_inputs (GstAdder * adder, guint8 * out, guint offset,
+    guint n_samples)
+{
+  gint bps = GST_AUDIO_INFO_BPS (&adder->info);
+  guint i;
+
+  for (i = 0; i < adder->inputs->len; i++) {
+    const GstAdderInput *input =
+        &g_array_index (adder->inputs, GstAdderInput, i);
+
+    gst_adder_mix_input (adder, input, out + offset * bps,
+        input->map.data + offset * bps, n_samples);
+  }
+}
+
+/* with many inputs, the samples are split in slices that are mixed on
+ * different threads */
+#define ADDER_PARALLEL_MIN_INPUTS 8
+#define ADDER_SLICE_MIN_SAMPLES 1024
+
+typedef struct _GstAdderSlices GstAdderSlices;
+
+typedef struct
+{
+  GstAdderSlices *slices;
+  GstAdder *adder;
+  guint8 *out;
+  guint offset;
+  guint n_samples;
+} GstAdderSlice;
+
+struct _GstAdderSlices
+{
+  GMutex lock;
+  GCond cond;
+  gint pending;
+};
+
+static void
+gst_adder_slice_func (GstAdderSlice * slice, gpointer user_data)
+{
+  GstAdderSlices *slices = slice->slices;
+
+  gst_adder_mix_inputs (slice->adder, slice->out, slice->offset,
+      slice->n_samples);
+
+  g_mutex_lock (&slices->lock);
+  if (--slices->pending == 0)
+    g_cond_signal (&slices->cond);
+  g_mutex_unlock (&slices->lock);
+}
+
+static GThreadPool *
+gst_adder_get_pool (void)
+{
+  static volatile gsize pool = 0;
+
+  if (g_once_init_enter (&pool)) {
+    GThreadPool *p;
+
+    p = g_thread_pool_new ((GFunc) gst_adder_slice_func, NULL,
+        g_get_num_processors (), FALSE, NULL);
+    g_once_init_leave (&pool, (gsize) p);
+  }
+  return (GThreadPool *) pool;
+}
+
+static void
+gst_adder_mix (GstAdder * adder, guint8 * out, guint n_samples)
+{
+  GstAdderSlice *slice;
+  GstAdderSlices slices;
+  guint i, n_slices, slice_samples, offset;
+  gint n_threads;
+
+  n_threads = g_get_num_processors ();
+  if (n_threads < 2 || adder->inputs->len < ADDER_PARALLEL_MIN_INPUTS ||
+      n_samples < 2 * ADDER_SLICE_MIN_SAMPLES) {
+    gst_adder_mix_inputs (adder, out, 0, n_samples);
+    return;
+  }
+
+  n_slices = MIN (n_threads, n_samples / ADDER_SLICE_MIN_SAMPLES);
+  slice_samples = (n_samples + n_slices - 1) / n_slices;
+
+  slice = g_newa (GstAdderSlice, n_slices);
+  for (i = 0, offset = 0; offset < n_samples; i++) {
+    slice[i].slices = &slices;
+    slice[i].adder = adder;
+    slice[i].out = out;
+    slice[i].offset = offset;
+    slice[i].n_samples = MIN (slice_samples, n_samples - offset);
+    offset += slice[i].n_samples;
+  }
+  n_slices = i;
+
+  GST_LOG_OBJECT (adder, "mixing %u inputs in %u slices", adder->inputs->len,
+      n_slices);
+
+  g_mutex_init (&slices.lock);
+  g_cond_init (&slices.cond);
+  slices.pending = n_slices - 1;
+
+  /* the first slice is mixed in this thread */
+  for (i = 1; i < n_slices; i++)
+    g_thread_pool_push (gst_adder_get_pool (), &slice[i], NULL);
+
+  gst_adder_mix_inputs (adder, out, slice[0].offset, slice[0].n_samples);
+
+  g_mutex_lock (&slices.lock);
+  while (slices.pending > 0)
+    g_cond_wait (&slices.cond, &slices.lock);
+  g_mutex_unlock (&slices.lock);
+
+  g_mutex_clear (&slices.lock);
+  g_cond_clear (&slices.cond);
+}
+
+/* like gst_collect_pads_available() but in live mode, pads that stalled
+ * and are not waited for don't count. @have_data is set when a pad has
+ * data and @all_eos when all pads are EOS */
+static guint
+gst_adder_available (GstAdder * adder, GstCollectPads * pads,
+    gboolean * have_data, gboolean * all_eos)
+{
+  GSList *walk;
+  guint result = G_MAXUINT;
+
+  *have_data = FALSE;
+  *all_eos = TRUE;
+
+  if (adder->timeout == 0) {
+    result = gst_collect_pads_available (pads);
+    *have_data = TRUE;
+    *all_eos = FALSE;
+    return result;
+  }
+
+  for (walk = pads->data; walk; walk = g_slist_next (walk)) {
+    GstCollectData *data = walk->data;
+    guint size;
+
+    if (!GST_COLLECT_PADS_STATE_IS_SET (data, GST_COLLECT_PADS_STATE_EOS))
+      *all_eos = FALSE;
+
+    if (data->buffer == NULL)
+      continue;
+
+    size = gst_buffer_get_size (data->buffer) - data->pos;
+    result = MIN (result, size);
+    *have_data = TRUE;
+  }
+
+  return *have_data ? result : 0;
+}
+
+/* called from the watchdog when no output was produced for the timeout,
+ * stop waiting for the pads without data so that the pads with data can be
+ * mixed. The pads are waited for again when they receive data. */
+static void
+gst_adder_release_stalled_pads (GstAdder * adder)
+{
+  GstCollectPads *pads = adder->collect;
+  GSList *walk;
+  gboolean have_data = FALSE;
+
+  GST_COLLECT_PADS_STREAM_LOCK (pads);
+  for (walk = pads->data; walk; walk = g_slist_next (walk)) {
+    GstCollectData *data = walk->data;
+
+    if (data->buffer)
+      have_data = TRUE;
+  }
+
+  /* nothing is blocked when no pad has data */
+  if (have_data) {
+    for (walk = pads->data; walk; walk = g_slist_next (walk)) {
+      GstCollectData *data = walk->data;
+
+      if (data->buffer == NULL &&
+          !GST_COLLECT_PADS_STATE_IS_SET (data, GST_COLLECT_PADS_STATE_EOS) &&
+          GST_COLLECT_PADS_STATE_IS_SET (data,
+              GST_COLLECT_PADS_STATE_WAITING)) {
+        GST_DEBUG_OBJECT (adder, "pad %s:%s stalled, not waiting for it",
+            GST_DEBUG_PAD_NAME (data->pad));
+        gst_collect_pads_set_waiting (pads, data, FALSE);
+      }
+    }
+  }
+  GST_COLLECT_PADS_STREAM_UNLOCK (pads);
+}
+
+static gpointer
+gst_adder_watchdog_func (GstAdder * adder)
+{
+  g_mutex_lock (&adder->live_lock);
+  while (adder->watchdog_running) {
+    gint64 deadline, now;
+
+    deadline = adder->last_collected + adder->timeout / GST_USECOND;
+    now = g_get_monotonic_time ();
+    if (now < deadline) {
+      g_cond_wait_until (&adder->live_cond, &adder->live_lock, deadline);
+      continue;
+    }
+
+    g_mutex_unlock (&adder->live_lock);
+    gst_adder_release_stalled_pads (adder);
+    g_mutex_lock (&adder->live_lock);
+
+    /* give the released pads a full timeout again */
+    adder->last_collected = now;
+  }
+  g_mutex_unlock (&adder->live_lock);
+
+  return NULL;
+}
+
+static void
+gst_adder_start_watchdog (GstAdder * adder)
+{
+  g_mutex_lock (&adder->live_lock);
+  if (adder->timeout > 0 && adder->watchdog == NULL) {
+    GST_DEBUG_OBJECT (adder, "starting watchdog, timeout %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (adder->timeout));
+    adder->watchdog_running = TRUE;
+    adder->last_collected = g_get_monotonic_time ();
+    adder->watchdog = g_thread_new ("adder-watchdog",
+        (GThreadFunc) gst_adder_watchdog_func, adder);
+  }
+  g_mutex_unlock (&adder->live_lock);
+}
+
+static void
+gst_adder_stop_watchdog (GstAdder * adder)
+{
+  GThread *watchdog;
+
+  g_mutex_lock (&adder->live_lock);
+  adder->watchdog_running = FALSE;
+  g_cond_signal (&adder->live_cond);
+  watchdog = adder->watchdog;
+  adder->watchdog = NULL;
+  g_mutex_unlock (&adder->live_lock);
+
+  if (watchdog)
+    g_thread_join (watchdog);
+}
+
 static GstFlowReturn
 gst_adder_collected (GstCollectPads * pads, gpointer user_data)
 {
@@ -1090,6 +1507,7 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
   gint rate, bps, bpf;
   gboolean had_mute = FALSE;
   gboolean is_eos = TRUE;
+  gboolean have_data, all_eos;
 
   adder = GST_ADDER (user_data);
 
@@ -1173,7 +1591,19 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
 
   /* get available bytes for reading, this can be 0 which could mean empty
    * buffers or EOS, which we will catch when we loop over the pads. */
-  outsize = gst_collect_pads_available (pads);
+  outsize = gst_adder_available (adder, pads, &have_data, &all_eos);
+
+  /* in live mode, we can get here with only stalled pads */
+  if (!have_data && !all_eos) {
+    GST_LOG_OBJECT (adder, "no pad has data");
+    return GST_FLOW_OK;
+  }
+
+  if (adder->timeout > 0) {
+    g_mutex_lock (&adder->live_lock);
+    adder->last_collected = g_get_monotonic_time ();
+    g_mutex_unlock (&adder->live_lock);
+  }
 
   GST_LOG_OBJECT (adder,
       "starting to cycle through channels, %d bytes available (bps = %d, bpf = %d)",
@@ -1294,108 +1724,51 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
       }
     } else {
       if (!is_gap) {
-        /* we had a previous output buffer, mix this non-GAP buffer */
-        GstMapInfo inmap;
+        /* we had a previous output buffer, keep this non-GAP buffer for
+         * mixing after we collected all of them */
+        GstAdderInput input;
 
-        gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+        input.buffer = inbuf;
+        gst_buffer_map (inbuf, &input.map, GST_MAP_READ);
+        input.volume = pad->volume;
+        input.volume_i8 = pad->volume_i8;
+        input.volume_i16 = pad->volume_i16;
+        input.volume_i32 = pad->volume_i32;
 
         /* all buffers should have outsize, there are no short buffers because we
          * asked for the max size above */
-        g_assert (inmap.size == outmap.size);
+        g_assert (input.map.size == outmap.size);
 
         GST_LOG_OBJECT (adder, "channel %p: mixing %" G_GSIZE_FORMAT " bytes"
-            " from data %p", collect_data, inmap.size, inmap.data);
-
-        /* further buffers, need to add them */
-        if (pad->volume == 1.0) {
-          switch (adder->info.finfo->format) {
-            case GST_AUDIO_FORMAT_U8:
-              adder_orc_add_u8 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_S8:
-              adder_orc_add_s8 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_U16:
-              adder_orc_add_u16 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_S16:
-              adder_orc_add_s16 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_U32:
-              adder_orc_add_u32 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_S32:
-              adder_orc_add_s32 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_F32:
-              adder_orc_add_f32 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_F64:
-              adder_orc_add_f64 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, inmap.size / bps);
-              break;
-            default:
-              g_assert_not_reached ();
-              break;
-          }
-        } else {
-          switch (adder->info.finfo->format) {
-            case GST_AUDIO_FORMAT_U8:
-              adder_orc_add_volume_u8 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume_i8, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_S8:
-              adder_orc_add_volume_s8 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume_i8, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_U16:
-              adder_orc_add_volume_u16 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume_i16, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_S16:
-              adder_orc_add_volume_s16 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume_i16, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_U32:
-              adder_orc_add_volume_u32 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume_i32, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_S32:
-              adder_orc_add_volume_s32 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume_i32, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_F32:
-              adder_orc_add_volume_f32 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume, inmap.size / bps);
-              break;
-            case GST_AUDIO_FORMAT_F64:
-              adder_orc_add_volume_f64 ((gpointer) outmap.data,
-                  (gpointer) inmap.data, pad->volume, inmap.size / bps);
-              break;
-            default:
-              g_assert_not_reached ();
-              break;
-          }
-        }
-        gst_buffer_unmap (inbuf, &inmap);
+            " from data %p", collect_data, input.map.size, input.map.data);
+
+        g_array_append_val (adder->inputs, input);
       } else {
         /* skip gap buffer */
         GST_LOG_OBJECT (adder, "channel %p: skipping GAP buffer", collect_data);
+        gst_buffer_unref (inbuf);
       }
-      gst_buffer_unref (inbuf);
     }
     GST_OBJECT_UNLOCK (pad);
   }
 
-  if (outbuf)
+  if (outbuf) {
+    guint i;
+
+    /* further buffers, need to add them */
+    if (adder->inputs->len > 0)
+      gst_adder_mix (adder, outmap.data, outmap.size / bps);
+
+    for (i = 0; i < adder->inputs->len; i++) {
+      GstAdderInput *input = &g_array_index (adder->inputs, GstAdderInput, i);
+
+      gst_buffer_unmap (input->buffer, &input->map);
+      gst_buffer_unref (input->buffer);
+    }
+    g_array_set_size (adder->inputs, 0);
+
     gst_buffer_unmap (outbuf, &outmap);
+  }
 
   if (is_eos)
     goto eos;
@@ -1509,6 +1882,7 @@ gst_adder_change_state (GstElement * element, GstStateChange transition)
       gst_caps_replace (&adder->current_caps, NULL);
       gst_segment_init (&adder->segment, GST_FORMAT_TIME);
       gst_collect_pads_start (adder->collect);
+      gst_adder_start_watchdog (adder);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
@@ -1516,6 +1890,7 @@ gst_adder_change_state (GstElement * element, GstStateChange transition)
       /* need to unblock the collectpads before calling the
        * parent change_state so that streaming can finish */
       gst_collect_pads_stop (adder->collect);
+      gst_adder_stop_watchdog (adder);
       break;
     default:
       break;
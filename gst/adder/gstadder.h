@@ -76,6 +76,17 @@ struct _GstAdder {
   
   gboolean send_stream_start;
   gboolean send_caps;
+
+  /* live mixing, protected by live_lock */
+  GstClockTime timeout;
+  GMutex live_lock;
+  GCond live_cond;
+  GThread *watchdog;
+  gboolean watchdog_running;
+  gint64 last_collected;
+
+  /* inputs to mix into the output buffer */
+  GArray *inputs;
 };
 
 struct _GstAdderClass {
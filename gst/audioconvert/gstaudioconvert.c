@@ -83,6 +83,8 @@ static GstCaps *gst_audio_convert_fixate_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps, GstCaps * othercaps);
 static gboolean gst_audio_convert_set_caps (GstBaseTransform * base,
     GstCaps * incaps, GstCaps * outcaps);
+static GstFlowReturn gst_audio_convert_transform_ip (GstBaseTransform * base,
+    GstBuffer * buf);
 static GstFlowReturn gst_audio_convert_transform (GstBaseTransform * base,
     GstBuffer * inbuf, GstBuffer * outbuf);
 static gboolean gst_audio_convert_transform_meta (GstBaseTransform * trans,
@@ -176,12 +178,15 @@ gst_audio_convert_class_init (GstAudioConvertClass * klass)
       GST_DEBUG_FUNCPTR (gst_audio_convert_set_caps);
   basetransform_class->transform =
       GST_DEBUG_FUNCPTR (gst_audio_convert_transform);
+  basetransform_class->transform_ip =
+      GST_DEBUG_FUNCPTR (gst_audio_convert_transform_ip);
   basetransform_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_audio_convert_transform_meta);
   basetransform_class->submit_input_buffer =
       GST_DEBUG_FUNCPTR (gst_audio_convert_submit_input_buffer);
 
   basetransform_class->passthrough_on_same_caps = TRUE;
+  basetransform_class->transform_ip_on_passthrough = FALSE;
 }
 
 static void
@@ -202,6 +207,8 @@ gst_audio_convert_dispose (GObject * obj)
     gst_audio_converter_free (this->convert);
     this->convert = NULL;
   }
+  g_free (this->downmix);
+  this->downmix = NULL;
 
   G_OBJECT_CLASS (parent_class)->dispose (obj);
 }
@@ -639,6 +646,219 @@ gst_audio_convert_fixate_caps (GstBaseTransform * base,
   return result;
 }
 
+/* check if the samples can be converted in place, this is when the formats
+ * only differ in signedness and byte order and the converter would not
+ * change the values otherwise */
+static gboolean
+gst_audio_convert_setup_in_place (GstAudioConvert * this,
+    const GstAudioInfo * in_info, const GstAudioInfo * out_info)
+{
+  const GstAudioFormatInfo *in_finfo = in_info->finfo;
+  const GstAudioFormatInfo *out_finfo = out_info->finfo;
+  gint width = GST_AUDIO_FORMAT_INFO_WIDTH (in_finfo);
+
+  if (GST_AUDIO_INFO_CHANNELS (in_info) != GST_AUDIO_INFO_CHANNELS (out_info)
+      || GST_AUDIO_INFO_LAYOUT (in_info) != GST_AUDIO_INFO_LAYOUT (out_info)
+      || GST_AUDIO_INFO_FLAGS (in_info) != GST_AUDIO_INFO_FLAGS (out_info))
+    return FALSE;
+
+  if (memcmp (in_info->position, out_info->position,
+          GST_AUDIO_INFO_CHANNELS (in_info) * sizeof (in_info->position[0])))
+    return FALSE;
+
+  /* padding bits and bit depth changes are left to the converter */
+  if (width != GST_AUDIO_FORMAT_INFO_WIDTH (out_finfo) ||
+      width != GST_AUDIO_FORMAT_INFO_DEPTH (in_finfo) ||
+      width != GST_AUDIO_FORMAT_INFO_DEPTH (out_finfo))
+    return FALSE;
+
+  if (GST_AUDIO_FORMAT_INFO_IS_FLOAT (in_finfo) !=
+      GST_AUDIO_FORMAT_INFO_IS_FLOAT (out_finfo))
+    return FALSE;
+
+  this->swap = width > 8 && GST_AUDIO_FORMAT_INFO_ENDIANNESS (in_finfo) !=
+      GST_AUDIO_FORMAT_INFO_ENDIANNESS (out_finfo);
+
+  this->flip = 0;
+  if (GST_AUDIO_FORMAT_INFO_IS_INTEGER (in_finfo) &&
+      GST_AUDIO_FORMAT_INFO_IS_SIGNED (in_finfo) !=
+      GST_AUDIO_FORMAT_INFO_IS_SIGNED (out_finfo)) {
+    /* the sign bit as it is read from memory */
+    if (GST_AUDIO_FORMAT_INFO_ENDIANNESS (in_finfo) == G_BYTE_ORDER
+        || width == 8 || width == 24)
+      this->flip = G_GUINT64_CONSTANT (1) << (width - 1);
+    else if (width == 16)
+      this->flip = GUINT16_SWAP_LE_BE (1 << 15);
+    else if (width == 32)
+      this->flip = GUINT32_SWAP_LE_BE (1U << 31);
+  }
+
+  return TRUE;
+}
+
+static void
+gst_audio_convert_samples_in_place (GstAudioConvert * this, gpointer data,
+    gsize samples)
+{
+  gsize i;
+
+  switch (GST_AUDIO_INFO_WIDTH (&this->in_info)) {
+    case 8:
+    {
+      guint8 *p = data;
+
+      for (i = 0; i < samples; i++)
+        p[i] ^= this->flip;
+      break;
+    }
+    case 16:
+    {
+      guint16 *p = data, flip = this->flip;
+
+      if (this->swap) {
+        for (i = 0; i < samples; i++)
+          p[i] = GUINT16_SWAP_LE_BE (p[i] ^ flip);
+      } else {
+        for (i = 0; i < samples; i++)
+          p[i] ^= flip;
+      }
+      break;
+    }
+    case 24:
+    {
+      guint8 *p = data, t;
+      /* the byte with the sign bit */
+      gint msb = GST_AUDIO_INFO_ENDIANNESS (&this->in_info) ==
+          G_LITTLE_ENDIAN ? 2 : 0;
+
+      for (i = 0; i < samples; i++, p += 3) {
+        if (this->flip)
+          p[msb] ^= 0x80;
+        if (this->swap) {
+          t = p[0];
+          p[0] = p[2];
+          p[2] = t;
+        }
+      }
+      break;
+    }
+    case 32:
+    {
+      guint32 *p = data, flip = this->flip;
+
+      if (this->swap) {
+        for (i = 0; i < samples; i++)
+          p[i] = GUINT32_SWAP_LE_BE (p[i] ^ flip);
+      } else {
+        for (i = 0; i < samples; i++)
+          p[i] ^= flip;
+      }
+      break;
+    }
+    case 64:
+    {
+      /* only doubles, they don't have a sign to flip */
+      guint64 *p = data;
+
+      for (i = 0; i < samples; i++)
+        p[i] = GUINT64_SWAP_LE_BE (p[i]);
+      break;
+    }
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* make the converter for the current formats, mixing with the matrix of
+ * the downmix meta when there is one */
+static gboolean
+gst_audio_convert_make_converter (GstAudioConvert * this)
+{
+  GstStructure *config;
+
+  if (this->convert) {
+    gst_audio_converter_free (this->convert);
+    this->convert = NULL;
+  }
+
+  config = gst_structure_new ("GstAudioConverterConfig",
+      GST_AUDIO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_AUDIO_DITHER_METHOD,
+      this->dither,
+      GST_AUDIO_CONVERTER_OPT_NOISE_SHAPING_METHOD,
+      GST_TYPE_AUDIO_NOISE_SHAPING_METHOD, this->ns, NULL);
+
+  if (this->downmix) {
+    GValue matrix = G_VALUE_INIT, row = G_VALUE_INIT, coeff = G_VALUE_INIT;
+    gint i, j, in_channels = this->in_info.channels;
+
+    g_value_init (&matrix, GST_TYPE_ARRAY);
+    g_value_init (&coeff, G_TYPE_FLOAT);
+    for (i = 0; i < this->out_info.channels; i++) {
+      g_value_init (&row, GST_TYPE_ARRAY);
+      for (j = 0; j < in_channels; j++) {
+        g_value_set_float (&coeff, this->downmix[i * in_channels + j]);
+        gst_value_array_append_value (&row, &coeff);
+      }
+      gst_value_array_append_and_take_value (&matrix, &row);
+    }
+    gst_structure_take_value (config, GST_AUDIO_CONVERTER_OPT_MIX_MATRIX,
+        &matrix);
+    g_value_unset (&coeff);
+  }
+
+  this->convert = gst_audio_converter_new (0, &this->in_info,
+      &this->out_info, config);
+
+  return this->convert != NULL;
+}
+
+/* use the downmix matrix that came with @buf for the output channels, or go
+ * back to the one of the converter when there is none */
+static gboolean
+gst_audio_convert_update_downmix (GstAudioConvert * this, GstBuffer * buf)
+{
+  GstAudioDownmixMeta *meta = NULL;
+  gint i, in_channels = this->in_info.channels;
+  gint out_channels = this->out_info.channels;
+
+  if (in_channels != out_channels && gst_buffer_get_audio_downmix_meta (buf))
+    meta = gst_buffer_get_audio_downmix_meta_for_channels (buf,
+        this->out_info.position, out_channels);
+
+  if (meta && (meta->from_channels != in_channels ||
+          memcmp (meta->from_position, this->in_info.position,
+              in_channels * sizeof (meta->from_position[0])) != 0))
+    meta = NULL;
+
+  if (meta == NULL) {
+    if (this->downmix == NULL)
+      return TRUE;
+    GST_DEBUG_OBJECT (this, "no downmix meta anymore");
+    g_free (this->downmix);
+    this->downmix = NULL;
+    return gst_audio_convert_make_converter (this);
+  }
+
+  if (this->downmix) {
+    for (i = 0; i < out_channels; i++)
+      if (memcmp (this->downmix + i * in_channels, meta->matrix[i],
+              in_channels * sizeof (gfloat)) != 0)
+        break;
+    if (i == out_channels)
+      return TRUE;
+  } else {
+    this->downmix = g_new (gfloat, out_channels * in_channels);
+  }
+
+  GST_DEBUG_OBJECT (this, "mixing with the matrix of the downmix meta");
+  for (i = 0; i < out_channels; i++)
+    memcpy (this->downmix + i * in_channels, meta->matrix[i],
+        in_channels * sizeof (gfloat));
+
+  return gst_audio_convert_make_converter (this);
+}
+
 static gboolean
 gst_audio_convert_set_caps (GstBaseTransform * base, GstCaps * incaps,
     GstCaps * outcaps)
@@ -660,18 +880,21 @@ gst_audio_convert_set_caps (GstBaseTransform * base, GstCaps * incaps,
   if (!gst_audio_info_from_caps (&out_info, outcaps))
     goto invalid_out;
 
-  this->convert = gst_audio_converter_new (0, &in_info, &out_info,
-      gst_structure_new ("GstAudioConverterConfig",
-          GST_AUDIO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_AUDIO_DITHER_METHOD,
-          this->dither,
-          GST_AUDIO_CONVERTER_OPT_NOISE_SHAPING_METHOD,
-          GST_TYPE_AUDIO_NOISE_SHAPING_METHOD, this->ns, NULL));
+  this->in_info = in_info;
+  this->out_info = out_info;
 
-  if (this->convert == NULL)
+  /* the downmix meta of the next buffer sets it again */
+  g_free (this->downmix);
+  this->downmix = NULL;
+
+  if (!gst_audio_convert_make_converter (this))
     goto no_converter;
 
-  this->in_info = in_info;
-  this->out_info = out_info;
+  this->in_place = gst_audio_convert_setup_in_place (this, &in_info,
+      &out_info);
+  GST_DEBUG_OBJECT (base, "in place %d, flip 0x%" G_GINT64_MODIFIER "x, "
+      "swap %d", this->in_place, this->flip, this->swap);
+  gst_base_transform_set_in_place (base, this->in_place);
 
   return TRUE;
 
@@ -716,6 +939,9 @@ gst_audio_convert_transform (GstBaseTransform * base, GstBuffer * inbuf,
   if (insize == 0 || outsize == 0)
     return GST_FLOW_OK;
 
+  if (!gst_audio_convert_update_downmix (this, inbuf))
+    goto no_converter;
+
   inbuf_writable = gst_buffer_is_writable (inbuf)
       && gst_buffer_n_memory (inbuf) == 1
       && gst_memory_is_writable (gst_buffer_peek_memory (inbuf, 0));
@@ -773,6 +999,42 @@ convert_error:
     ret = GST_FLOW_ERROR;
     goto done;
   }
+no_converter:
+  {
+    GST_ELEMENT_ERROR (this, STREAM, FORMAT,
+        (NULL), ("could not make converter for the downmix matrix"));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+}
+
+static GstFlowReturn
+gst_audio_convert_transform_ip (GstBaseTransform * base, GstBuffer * buf)
+{
+  GstAudioConvert *this = GST_AUDIO_CONVERT (base);
+  GstMapInfo map;
+  gsize samples;
+
+  if (!gst_buffer_map (buf, &map, GST_MAP_READWRITE))
+    goto map_failed;
+
+  samples = (map.size / this->in_info.bpf) * this->in_info.channels;
+
+  if (!GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP))
+    gst_audio_convert_samples_in_place (this, map.data, samples);
+  else
+    gst_audio_format_fill_silence (this->out_info.finfo, map.data,
+        samples * (this->out_info.finfo->width / 8));
+
+  gst_buffer_unmap (buf, &map);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ELEMENT_ERROR (this, STREAM, FORMAT, (NULL), ("failed to map buffer"));
+    return GST_FLOW_ERROR;
+  }
 }
 
 static gboolean
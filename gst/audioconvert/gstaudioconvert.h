@@ -51,6 +51,16 @@ struct _GstAudioConvert
   GstAudioInfo in_info;
   GstAudioInfo out_info;
   GstAudioConverter *convert;
+
+  /* the matrix of the GstAudioDownmixMeta the converter was made for, as
+   * out_info.channels rows of in_info.channels, or NULL */
+  gfloat *downmix;
+
+  /* in place conversion, the sign bit of the samples in input byte order
+   * to flip and if the bytes need to be swapped */
+  gboolean in_place;
+  guint64 flip;
+  gboolean swap;
 };
 
 struct _GstAudioConvertClass
@@ -220,6 +220,9 @@ gst_audio_rate_setcaps (GstAudioRate * audiorate, GstCaps * caps)
 
   audiorate->info = info;
 
+  /* silence depends on the format */
+  gst_buffer_replace (&audiorate->silence, NULL);
+
   return TRUE;
 
   /* ERRORS */
@@ -533,19 +536,26 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
        audio */
     fillsamples = in_offset - audiorate->next_offset;
 
+    /* the fill buffers share the memory of one second of silence that we
+     * make once */
+    if (audiorate->silence == NULL) {
+      GstMapInfo fillmap;
+
+      audiorate->silence = gst_buffer_new_and_alloc (rate * bpf);
+      gst_buffer_map (audiorate->silence, &fillmap, GST_MAP_WRITE);
+      gst_audio_format_fill_silence (audiorate->info.finfo, fillmap.data,
+          fillmap.size);
+      gst_buffer_unmap (audiorate->silence, &fillmap);
+    }
+
     while (fillsamples > 0) {
       guint64 cursamples = MIN (fillsamples, rate);
-      GstMapInfo fillmap;
 
       fillsamples -= cursamples;
       fillsize = cursamples * bpf;
 
-      fill = gst_buffer_new_and_alloc (fillsize);
-
-      gst_buffer_map (fill, &fillmap, GST_MAP_WRITE);
-      gst_audio_format_fill_silence (audiorate->info.finfo, fillmap.data,
-          fillmap.size);
-      gst_buffer_unmap (fill, &fillmap);
+      fill = gst_buffer_copy_region (audiorate->silence, GST_BUFFER_COPY_MEMORY,
+          0, fillsize);
 
       GST_DEBUG_OBJECT (audiorate, "inserting %" G_GUINT64_FORMAT " samples",
           cursamples);
@@ -748,6 +758,7 @@ static GstStateChangeReturn
 gst_audio_rate_change_state (GstElement * element, GstStateChange transition)
 {
   GstAudioRate *audiorate = GST_AUDIO_RATE (element);
+  GstStateChangeReturn ret;
 
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
@@ -764,7 +775,17 @@ gst_audio_rate_change_state (GstElement * element, GstStateChange transition)
       break;
   }
 
-  return GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_buffer_replace (&audiorate->silence, NULL);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
 }
 
 static gboolean
@@ -65,6 +65,9 @@ struct _GstAudioRate
 
   gboolean discont;
 
+  /* one second of silence, shared by the fill buffers */
+  GstBuffer *silence;
+
   gboolean new_segment;
   /* we accept all formats on the sink */
   GstSegment sink_segment;
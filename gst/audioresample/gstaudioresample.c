@@ -72,6 +72,7 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_PERFORMANCE);
 #define DEFAULT_SINC_FILTER_MODE GST_AUDIO_RESAMPLER_FILTER_MODE_AUTO
 #define DEFAULT_SINC_FILTER_AUTO_THRESHOLD (1*1048576)
 #define DEFAULT_SINC_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
+#define DEFAULT_SINC_FILTER_LATENCY -1
 
 enum
 {
@@ -80,7 +81,8 @@ enum
   PROP_RESAMPLE_METHOD,
   PROP_SINC_FILTER_MODE,
   PROP_SINC_FILTER_AUTO_THRESHOLD,
-  PROP_SINC_FILTER_INTERPOLATION
+  PROP_SINC_FILTER_INTERPOLATION,
+  PROP_SINC_FILTER_LATENCY
 };
 
 #define SUPPORTED_CAPS \
@@ -176,6 +178,25 @@ gst_audio_resample_class_init (GstAudioResampleClass * klass)
           DEFAULT_SINC_FILTER_INTERPOLATION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioResample:sinc-filter-latency:
+   *
+   * The maximum number of input samples after the current one that the sinc
+   * filter uses. Lower values reduce the latency of the element but the
+   * filter is no longer linear phase. -1 uses a linear phase filter with a
+   * latency of half its length.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_SINC_FILTER_LATENCY,
+      g_param_spec_int ("sinc-filter-latency",
+          "Sinc filter latency",
+          "Maximum number of samples the sinc filter looks ahead "
+          "(-1 = linear phase filter)",
+          -1, G_MAXINT, DEFAULT_SINC_FILTER_LATENCY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_audio_resample_src_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -221,6 +242,7 @@ gst_audio_resample_init (GstAudioResample * resample)
   resample->sinc_filter_mode = DEFAULT_SINC_FILTER_MODE;
   resample->sinc_filter_auto_threshold = DEFAULT_SINC_FILTER_AUTO_THRESHOLD;
   resample->sinc_filter_interpolation = DEFAULT_SINC_FILTER_INTERPOLATION;
+  resample->sinc_filter_latency = DEFAULT_SINC_FILTER_LATENCY;
 
   gst_base_transform_set_gap_aware (trans, TRUE);
   gst_pad_set_query_function (trans->srcpad, gst_audio_resample_query);
@@ -372,7 +394,9 @@ make_options (GstAudioResample * resample, GstAudioInfo * in,
       G_TYPE_UINT, resample->sinc_filter_auto_threshold,
       GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
       GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION,
-      resample->sinc_filter_interpolation, NULL);
+      resample->sinc_filter_interpolation,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_LATENCY, G_TYPE_INT,
+      resample->sinc_filter_latency, NULL);
 
   return options;
 }
@@ -1033,6 +1057,11 @@ gst_audio_resample_set_property (GObject * object, guint prop_id,
       resample->sinc_filter_interpolation = g_value_get_enum (value);
       gst_audio_resample_update_state (resample, NULL, NULL);
       break;
+    case PROP_SINC_FILTER_LATENCY:
+      /* FIXME locking! */
+      resample->sinc_filter_latency = g_value_get_int (value);
+      gst_audio_resample_update_state (resample, NULL, NULL);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1063,6 +1092,9 @@ gst_audio_resample_get_property (GObject * object, guint prop_id,
     case PROP_SINC_FILTER_INTERPOLATION:
       g_value_set_enum (value, resample->sinc_filter_interpolation);
       break;
+    case PROP_SINC_FILTER_LATENCY:
+      g_value_set_int (value, resample->sinc_filter_latency);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
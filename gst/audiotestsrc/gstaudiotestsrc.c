@@ -393,6 +393,7 @@ gst_audio_test_src_create_sine_##type (GstAudioTestSrc * src, g##type * samples)
 { \
   gint i, c, channels; \
   gdouble step, amp; \
+  g##type val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   step = M_PI_M2 * src->freq / GST_AUDIO_INFO_RATE (&src->info); \
@@ -404,9 +405,10 @@ gst_audio_test_src_create_sine_##type (GstAudioTestSrc * src, g##type * samples)
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
-    for (c = 0; c < channels; ++c) { \
-      samples[i++] = (g##type) (sin (src->accumulator) * amp); \
-    } \
+    /* compute once and copy to all channels */ \
+    val = (g##type) (sin (src->accumulator) * amp); \
+    for (c = 0; c < channels; ++c) \
+      samples[i++] = val; \
   } \
 }
 
@@ -428,6 +430,7 @@ gst_audio_test_src_create_square_##type (GstAudioTestSrc * src, g##type * sample
 { \
   gint i, c, channels; \
   gdouble step, amp; \
+  g##type val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   step = M_PI_M2 * src->freq / GST_AUDIO_INFO_RATE (&src->info); \
@@ -439,9 +442,9 @@ gst_audio_test_src_create_square_##type (GstAudioTestSrc * src, g##type * sample
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
-    for (c = 0; c < channels; ++c) { \
-      samples[i++] = (g##type) ((src->accumulator < G_PI) ? amp : -amp); \
-    } \
+    val = (g##type) ((src->accumulator < G_PI) ? amp : -amp); \
+    for (c = 0; c < channels; ++c) \
+      samples[i++] = val; \
   } \
 }
 
@@ -463,6 +466,7 @@ gst_audio_test_src_create_saw_##type (GstAudioTestSrc * src, g##type * samples)
 { \
   gint i, c, channels; \
   gdouble step, amp; \
+  g##type val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   step = M_PI_M2 * src->freq / GST_AUDIO_INFO_RATE (&src->info); \
@@ -474,13 +478,12 @@ gst_audio_test_src_create_saw_##type (GstAudioTestSrc * src, g##type * samples)
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
-    if (src->accumulator < G_PI) { \
-      for (c = 0; c < channels; ++c) \
-        samples[i++] = (g##type) (src->accumulator * amp); \
-    } else { \
-      for (c = 0; c < channels; ++c) \
-        samples[i++] = (g##type) ((M_PI_M2 - src->accumulator) * -amp); \
-    } \
+    if (src->accumulator < G_PI) \
+      val = (g##type) (src->accumulator * amp); \
+    else \
+      val = (g##type) ((M_PI_M2 - src->accumulator) * -amp); \
+    for (c = 0; c < channels; ++c) \
+      samples[i++] = val; \
   } \
 }
 
@@ -502,6 +505,7 @@ gst_audio_test_src_create_triangle_##type (GstAudioTestSrc * src, g##type * samp
 { \
   gint i, c, channels; \
   gdouble step, amp; \
+  g##type val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   step = M_PI_M2 * src->freq / GST_AUDIO_INFO_RATE (&src->info); \
@@ -513,16 +517,14 @@ gst_audio_test_src_create_triangle_##type (GstAudioTestSrc * src, g##type * samp
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
-    if (src->accumulator < (G_PI_2)) { \
-      for (c = 0; c < channels; ++c) \
-        samples[i++] = (g##type) (src->accumulator * amp); \
-    } else if (src->accumulator < (G_PI * 1.5)) { \
-      for (c = 0; c < channels; ++c) \
-        samples[i++] = (g##type) ((src->accumulator - G_PI) * -amp); \
-    } else { \
-      for (c = 0; c < channels; ++c) \
-        samples[i++] = (g##type) ((M_PI_M2 - src->accumulator) * -amp); \
-    } \
+    if (src->accumulator < (G_PI_2)) \
+      val = (g##type) (src->accumulator * amp); \
+    else if (src->accumulator < (G_PI * 1.5)) \
+      val = (g##type) ((src->accumulator - G_PI) * -amp); \
+    else \
+      val = (g##type) ((M_PI_M2 - src->accumulator) * -amp); \
+    for (c = 0; c < channels; ++c) \
+      samples[i++] = val; \
   } \
 }
 
@@ -703,6 +705,7 @@ gst_audio_test_src_create_sine_table_##type (GstAudioTestSrc * src, g##type * sa
 { \
   gint i, c, channels; \
   gdouble step, scl; \
+  g##type val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   step = M_PI_M2 * src->freq / GST_AUDIO_INFO_RATE (&src->info); \
@@ -714,8 +717,9 @@ gst_audio_test_src_create_sine_table_##type (GstAudioTestSrc * src, g##type * sa
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
+    val = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
     for (c = 0; c < channels; ++c) \
-      samples[i++] = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
+      samples[i++] = val; \
   } \
 }
 
@@ -737,6 +741,7 @@ gst_audio_test_src_create_tick_##type (GstAudioTestSrc * src, g##type * samples)
 { \
   gint i, c, channels, samplerate; \
   gdouble step, scl; \
+  g##type val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   samplerate = GST_AUDIO_INFO_RATE (&src->info); \
@@ -748,13 +753,12 @@ gst_audio_test_src_create_tick_##type (GstAudioTestSrc * src, g##type * samples)
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
-    if ((src->next_sample + i)%samplerate < 1600) { \
-      for (c = 0; c < channels; ++c) \
-        samples[(i * channels) + c] = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
-    } else { \
-      for (c = 0; c < channels; ++c) \
-        samples[(i * channels) + c] = 0; \
-    } \
+    if ((src->next_sample + i)%samplerate < 1600) \
+      val = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
+    else \
+      val = 0; \
+    for (c = 0; c < channels; ++c) \
+      samples[(i * channels) + c] = val; \
   } \
 }
 
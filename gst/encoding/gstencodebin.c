@@ -187,6 +187,8 @@ struct _GstEncodeBin
   guint queue_bytes_max;
   guint64 queue_time_max;
 
+  guint conversion_threads;
+
   guint64 tolerance;
   gboolean avoid_reencoding;
 
@@ -230,6 +232,7 @@ struct _StreamGroup
 #define DEFAULT_QUEUE_BUFFERS_MAX  200
 #define DEFAULT_QUEUE_BYTES_MAX    10 * 1024 * 1024
 #define DEFAULT_QUEUE_TIME_MAX     GST_SECOND
+#define DEFAULT_CONVERSION_THREADS 1
 #define DEFAULT_AUDIO_JITTER_TOLERANCE 20 * GST_MSECOND
 #define DEFAULT_AVOID_REENCODING   FALSE
 #define DEFAULT_FLAGS              0
@@ -251,7 +254,8 @@ enum
   PROP_QUEUE_TIME_MAX,
   PROP_AUDIO_JITTER_TOLERANCE,
   PROP_AVOID_REENCODING,
-  PROP_FLAGS
+  PROP_FLAGS,
+  PROP_CONVERSION_THREADS
 };
 
 /* Signals */
@@ -391,6 +395,21 @@ gst_encode_bin_class_init (GstEncodeBinClass * klass)
           GST_TYPE_ENCODEBIN_FLAGS, DEFAULT_FLAGS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstEncodeBin:conversion-threads
+   *
+   * Maximum number of threads the video converters and scalers of each
+   * stream use, 0 for the number of cores. Every stream already runs in its
+   * own thread after its input queue.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_CONVERSION_THREADS,
+      g_param_spec_uint ("conversion-threads", "Conversion threads",
+          "Maximum number of threads for the video conversion of each stream "
+          "(0 = number of cores)", 0, G_MAXUINT, DEFAULT_CONVERSION_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* Signals */
   /**
    * GstEncodeBin::request-pad
@@ -490,26 +509,64 @@ gst_encode_bin_dispose (GObject * object)
   G_OBJECT_CLASS (gst_encode_bin_parent_class)->dispose (object);
 }
 
+/* The factory lists are the same for all encodebins, we only get them
+ * from the registry again when it changed */
+G_LOCK_DEFINE_STATIC (factories);
+static gboolean factories_valid = FALSE;
+static guint32 factories_cookie;
+static GList *cached_muxers;
+static GList *cached_formatters;
+static GList *cached_encoders;
+static GList *cached_parsers;
+
 static void
-gst_encode_bin_init (GstEncodeBin * encode_bin)
+gst_encode_bin_get_factories (GstEncodeBin * ebin)
 {
-  GstPadTemplate *tmpl;
+  guint32 cookie;
+
+  G_LOCK (factories);
+  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
+  if (!factories_valid || cookie != factories_cookie) {
+    GST_DEBUG ("registry changed, updating the factory lists");
+
+    gst_plugin_feature_list_free (cached_muxers);
+    gst_plugin_feature_list_free (cached_formatters);
+    gst_plugin_feature_list_free (cached_encoders);
+    gst_plugin_feature_list_free (cached_parsers);
+
+    cached_muxers =
+        gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_MUXER,
+        GST_RANK_MARGINAL);
 
-  encode_bin->muxers =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_MUXER,
-      GST_RANK_MARGINAL);
+    cached_formatters =
+        gst_element_factory_list_get_elements
+        (GST_ELEMENT_FACTORY_TYPE_FORMATTER, GST_RANK_SECONDARY);
 
-  encode_bin->formatters =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_FORMATTER,
-      GST_RANK_SECONDARY);
+    cached_encoders =
+        gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_ENCODER,
+        GST_RANK_MARGINAL);
 
-  encode_bin->encoders =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_ENCODER,
-      GST_RANK_MARGINAL);
+    cached_parsers =
+        gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_PARSER,
+        GST_RANK_MARGINAL);
 
-  encode_bin->parsers =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_PARSER,
-      GST_RANK_MARGINAL);
+    factories_cookie = cookie;
+    factories_valid = TRUE;
+  }
+
+  ebin->muxers = gst_plugin_feature_list_copy (cached_muxers);
+  ebin->formatters = gst_plugin_feature_list_copy (cached_formatters);
+  ebin->encoders = gst_plugin_feature_list_copy (cached_encoders);
+  ebin->parsers = gst_plugin_feature_list_copy (cached_parsers);
+  G_UNLOCK (factories);
+}
+
+static void
+gst_encode_bin_init (GstEncodeBin * encode_bin)
+{
+  GstPadTemplate *tmpl;
+
+  gst_encode_bin_get_factories (encode_bin);
 
   encode_bin->raw_video_caps = gst_caps_from_string ("video/x-raw");
   encode_bin->raw_audio_caps = gst_caps_from_string ("audio/x-raw");
@@ -519,6 +576,7 @@ gst_encode_bin_init (GstEncodeBin * encode_bin)
   encode_bin->queue_buffers_max = DEFAULT_QUEUE_BUFFERS_MAX;
   encode_bin->queue_bytes_max = DEFAULT_QUEUE_BYTES_MAX;
   encode_bin->queue_time_max = DEFAULT_QUEUE_TIME_MAX;
+  encode_bin->conversion_threads = DEFAULT_CONVERSION_THREADS;
   encode_bin->tolerance = DEFAULT_AUDIO_JITTER_TOLERANCE;
   encode_bin->avoid_reencoding = DEFAULT_AVOID_REENCODING;
   encode_bin->flags = DEFAULT_FLAGS;
@@ -559,6 +617,9 @@ gst_encode_bin_set_property (GObject * object, guint prop_id,
     case PROP_FLAGS:
       ebin->flags = g_value_get_flags (value);
       break;
+    case PROP_CONVERSION_THREADS:
+      ebin->conversion_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -593,6 +654,9 @@ gst_encode_bin_get_property (GObject * object, guint prop_id,
     case PROP_FLAGS:
       g_value_set_flags (value, ebin->flags);
       break;
+    case PROP_CONVERSION_THREADS:
+      g_value_set_uint (value, ebin->conversion_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1454,6 +1518,12 @@ _create_stream_group (GstEncodeBin * ebin, GstEncodingProfile * sprof,
         goto missing_element;
       }
 
+      if (ebin->conversion_threads != DEFAULT_CONVERSION_THREADS) {
+        g_object_set (cspace, "n-threads", ebin->conversion_threads, NULL);
+        g_object_set (scale, "n-threads", ebin->conversion_threads, NULL);
+        g_object_set (cspace2, "n-threads", ebin->conversion_threads, NULL);
+      }
+
       gst_bin_add_many ((GstBin *) ebin, cspace, scale, cspace2, NULL);
       tosync = g_list_append (tosync, cspace);
       tosync = g_list_append (tosync, scale);
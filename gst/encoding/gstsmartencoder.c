@@ -52,6 +52,9 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
 
 static GQuark INTERNAL_ELEMENT;
 
+/* passthrough GOPs we keep while a GOP before them is re-encoded */
+#define MAX_QUEUED_GOPS 8
+
 /* GstSmartEncoder signals and args */
 enum
 {
@@ -77,6 +80,8 @@ G_DEFINE_TYPE_EXTENDED (GstSmartEncoder, gst_smart_encoder, GST_TYPE_ELEMENT, 0,
 static void gst_smart_encoder_dispose (GObject * object);
 
 static gboolean setup_recoder_pipeline (GstSmartEncoder * smart_encoder);
+static GstFlowReturn gst_smart_encoder_finish_reencode (GstSmartEncoder *
+    smart_encoder, gboolean drain);
 
 static GstFlowReturn gst_smart_encoder_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf);
@@ -118,6 +123,8 @@ gst_smart_encoder_class_init (GstSmartEncoderClass * klass)
 static void
 smart_encoder_reset (GstSmartEncoder * smart_encoder)
 {
+  gst_smart_encoder_finish_reencode (smart_encoder, FALSE);
+
   gst_segment_init (smart_encoder->segment, GST_FORMAT_UNDEFINED);
 
   if (smart_encoder->encoder) {
@@ -162,6 +169,7 @@ gst_smart_encoder_init (GstSmartEncoder * smart_encoder)
   gst_element_add_pad (GST_ELEMENT (smart_encoder), smart_encoder->srcpad);
 
   smart_encoder->segment = gst_segment_new ();
+  g_queue_init (&smart_encoder->queued_gops);
 
   smart_encoder_reset (smart_encoder);
 }
@@ -180,15 +188,43 @@ gst_smart_encoder_dispose (GObject * object)
   G_OBJECT_CLASS (gst_smart_encoder_parent_class)->dispose (object);
 }
 
+/* push the buffers of @gop, which is freed */
 static GstFlowReturn
-gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder)
+gst_smart_encoder_push_gop (GstSmartEncoder * smart_encoder, GstPad * pad,
+    GList * gop)
 {
   GstFlowReturn res = GST_FLOW_OK;
   GList *tmp;
 
+  for (tmp = gop; tmp; tmp = tmp->next) {
+    GstBuffer *buf = (GstBuffer *) tmp->data;
+
+    if (G_LIKELY (res == GST_FLOW_OK))
+      res = gst_pad_push (pad, buf);
+    else
+      gst_buffer_unref (buf);
+  }
+  g_list_free (gop);
+
+  return res;
+}
+
+static void
+gst_smart_encoder_free_gop (GList * gop)
+{
+  g_list_free_full (gop, (GDestroyNotify) gst_buffer_unref);
+}
+
+static GstFlowReturn
+gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder, GList * gop)
+{
+  GstFlowReturn res = GST_FLOW_OK;
+
   if (smart_encoder->encoder == NULL) {
-    if (!setup_recoder_pipeline (smart_encoder))
+    if (!setup_recoder_pipeline (smart_encoder)) {
+      gst_smart_encoder_free_gop (gop);
       return GST_FLOW_ERROR;
+    }
   }
 
   /* Activate elements */
@@ -210,20 +246,11 @@ gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder)
   /* Push buffers through our pads */
   GST_DEBUG ("Pushing pending buffers");
 
-  for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
-    GstBuffer *buf = (GstBuffer *) tmp->data;
-
-    res = gst_pad_push (smart_encoder->internal_srcpad, buf);
-    if (G_UNLIKELY (res != GST_FLOW_OK))
-      break;
-  }
+  res = gst_smart_encoder_push_gop (smart_encoder,
+      smart_encoder->internal_srcpad, gop);
 
   if (G_UNLIKELY (res != GST_FLOW_OK)) {
     GST_WARNING ("Error pushing pending buffers : %s", gst_flow_get_name (res));
-    /* Remove pending bfufers */
-    for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
-      gst_buffer_unref ((GstBuffer *) tmp->data);
-    }
   } else {
     GST_INFO ("Pushing out EOS to flush out decoder/encoder");
     gst_pad_push_event (smart_encoder->internal_srcpad, gst_event_new_eos ());
@@ -234,8 +261,48 @@ gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder)
   gst_element_set_state (smart_encoder->encoder, GST_STATE_NULL);
   gst_element_set_state (smart_encoder->decoder, GST_STATE_NULL);
 
-  g_list_free (smart_encoder->pending_gop);
-  smart_encoder->pending_gop = NULL;
+  return res;
+}
+
+static gpointer
+gst_smart_encoder_reencode_thread (GstSmartEncoder * smart_encoder)
+{
+  GList *gop = smart_encoder->reencode_gop;
+
+  smart_encoder->reencode_gop = NULL;
+  smart_encoder->reencode_ret =
+      gst_smart_encoder_reencode_gop (smart_encoder, gop);
+  g_atomic_int_set (&smart_encoder->reencode_done, TRUE);
+
+  return NULL;
+}
+
+/* Wait for the GOP that is being re-encoded, then push the GOPs that were
+ * queued after it when @drain is %TRUE or drop them */
+static GstFlowReturn
+gst_smart_encoder_finish_reencode (GstSmartEncoder * smart_encoder,
+    gboolean drain)
+{
+  GstFlowReturn res = GST_FLOW_OK;
+  GList *gop;
+
+  if (smart_encoder->reencode_thread == NULL)
+    return GST_FLOW_OK;
+
+  g_thread_join (smart_encoder->reencode_thread);
+  smart_encoder->reencode_thread = NULL;
+  res = smart_encoder->reencode_ret;
+
+  GST_DEBUG ("re-encoding done: %s, %u GOPs queued", gst_flow_get_name (res),
+      g_queue_get_length (&smart_encoder->queued_gops));
+
+  while ((gop = g_queue_pop_head (&smart_encoder->queued_gops))) {
+    if (drain && res == GST_FLOW_OK)
+      res = gst_smart_encoder_push_gop (smart_encoder, smart_encoder->srcpad,
+          gop);
+    else
+      gst_smart_encoder_free_gop (gop);
+  }
 
   return res;
 }
@@ -244,13 +311,16 @@ static GstFlowReturn
 gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
 {
   guint64 cstart, cstop;
-  GList *tmp;
+  GList *gop;
   GstFlowReturn res = GST_FLOW_OK;
 
   GST_DEBUG ("Pushing pending GOP (%" GST_TIME_FORMAT " -- %" GST_TIME_FORMAT
       ")", GST_TIME_ARGS (smart_encoder->gop_start),
       GST_TIME_ARGS (smart_encoder->gop_stop));
 
+  gop = smart_encoder->pending_gop;
+  smart_encoder->pending_gop = NULL;
+
   /* If GOP is entirely within segment, just push downstream */
   if (gst_segment_clip (smart_encoder->segment, GST_FORMAT_TIME,
           smart_encoder->gop_start, smart_encoder->gop_stop, &cstart, &cstop)) {
@@ -258,31 +328,42 @@ gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
         || (cstop != smart_encoder->gop_stop)) {
       GST_DEBUG ("GOP needs to be re-encoded from %" GST_TIME_FORMAT " to %"
           GST_TIME_FORMAT, GST_TIME_ARGS (cstart), GST_TIME_ARGS (cstop));
-      res = gst_smart_encoder_reencode_gop (smart_encoder);
+      /* we have one re-encoder, wait for the previous GOP */
+      res = gst_smart_encoder_finish_reencode (smart_encoder, TRUE);
+      if (res == GST_FLOW_OK) {
+        /* re-encode while we receive the next GOPs */
+        smart_encoder->reencode_gop = gop;
+        smart_encoder->reencode_done = FALSE;
+        smart_encoder->reencode_thread = g_thread_new ("smartencoder",
+            (GThreadFunc) gst_smart_encoder_reencode_thread, smart_encoder);
+      } else {
+        gst_smart_encoder_free_gop (gop);
+      }
+    } else if (smart_encoder->reencode_thread
+        && !g_atomic_int_get (&smart_encoder->reencode_done)
+        && g_queue_get_length (&smart_encoder->queued_gops) <
+        MAX_QUEUED_GOPS) {
+      /* keep the order, passed through after the re-encoded GOP */
+      GST_DEBUG ("GOP doesn't need to be modified, queueing");
+      g_queue_push_tail (&smart_encoder->queued_gops, gop);
     } else {
       /* The whole GOP is within the segment, push all pending buffers downstream */
       GST_DEBUG ("GOP doesn't need to be modified, pushing downstream");
-      for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
-        GstBuffer *buf = (GstBuffer *) tmp->data;
-        res = gst_pad_push (smart_encoder->srcpad, buf);
-        if (G_UNLIKELY (res != GST_FLOW_OK))
-          break;
-      }
+      res = gst_smart_encoder_finish_reencode (smart_encoder, TRUE);
+      if (res == GST_FLOW_OK)
+        res = gst_smart_encoder_push_gop (smart_encoder, smart_encoder->srcpad,
+            gop);
+      else
+        gst_smart_encoder_free_gop (gop);
     }
   } else {
     /* The whole GOP is outside the segment, there's most likely
      * a bug somewhere. */
     GST_WARNING
         ("GOP is entirely outside of the segment, upstream gave us too much data");
-    for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
-      gst_buffer_unref ((GstBuffer *) tmp->data);
-    }
+    gst_smart_encoder_free_gop (gop);
   }
 
-  if (smart_encoder->pending_gop) {
-    g_list_free (smart_encoder->pending_gop);
-    smart_encoder->pending_gop = NULL;
-  }
   smart_encoder->gop_start = GST_CLOCK_TIME_NONE;
   smart_encoder->gop_stop = GST_CLOCK_TIME_NONE;
 
@@ -305,6 +386,16 @@ gst_smart_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       discont ? "discont" : "",
       keyframe ? "keyframe" : "", GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)));
 
+  /* stream out the queued GOPs as soon as the re-encoded one is done */
+  if (smart_encoder->reencode_thread
+      && g_atomic_int_get (&smart_encoder->reencode_done)) {
+    res = gst_smart_encoder_finish_reencode (smart_encoder, TRUE);
+    if (G_UNLIKELY (res != GST_FLOW_OK)) {
+      gst_buffer_unref (buf);
+      goto beach;
+    }
+  }
+
   if (keyframe) {
     GST_DEBUG ("Got a keyframe");
 
@@ -346,6 +437,12 @@ smart_encoder_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
   gboolean res = TRUE;
   GstSmartEncoder *smart_encoder = GST_SMART_ENCODER (parent);
 
+  /* serialized events go out after the GOP that is being re-encoded */
+  if (GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP
+      && GST_EVENT_TYPE (event) != GST_EVENT_EOS)
+    gst_smart_encoder_finish_reencode (smart_encoder, TRUE);
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_STOP:
       smart_encoder_reset (smart_encoder);
@@ -368,7 +465,9 @@ smart_encoder_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       break;
     case GST_EVENT_EOS:
       GST_DEBUG ("Eos, flushing remaining data");
-      gst_smart_encoder_push_pending_gop (smart_encoder);
+      if (smart_encoder->pending_gop)
+        gst_smart_encoder_push_pending_gop (smart_encoder);
+      gst_smart_encoder_finish_reencode (smart_encoder, TRUE);
       break;
     default:
       break;
@@ -50,6 +50,14 @@ struct _GstSmartEncoder {
   guint64 gop_start;		/* GOP start in running time */
   guint64 gop_stop;		/* GOP end in running time */
 
+  /* GOP being re-encoded in a separate thread, and the GOPs after it that
+   * are passed through once it is done */
+  GThread *reencode_thread;
+  GList *reencode_gop;
+  GstFlowReturn reencode_ret;
+  volatile gint reencode_done;
+  GQueue queued_gops;
+
   /* Internal recoding elements */
   GstPad *internal_sinkpad;
   GstPad *internal_srcpad;
@@ -96,6 +96,7 @@ gst_stream_combiner_finalize (GObject * object)
 {
   GstStreamCombiner *stream_combiner = (GstStreamCombiner *) object;
 
+  gst_object_replace ((GstObject **) & stream_combiner->current, NULL);
   g_mutex_clear (&stream_combiner->lock);
 
   G_OBJECT_CLASS (gst_stream_combiner_parent_class)->finalize (object);
@@ -124,6 +125,22 @@ _all_sink_pads_eos (GstStreamCombiner * combiner)
   return TRUE;
 }
 
+/* the pad upstream events and queries go to, with a ref */
+static GstPad *
+gst_stream_combiner_get_current (GstStreamCombiner * combiner)
+{
+  GstPad *sinkpad = NULL;
+
+  STREAMS_LOCK (combiner);
+  if (combiner->current)
+    sinkpad = gst_object_ref (combiner->current);
+  else if (combiner->sinkpads)
+    sinkpad = gst_object_ref (combiner->sinkpads->data);
+  STREAMS_UNLOCK (combiner);
+
+  return sinkpad;
+}
+
 static gboolean
 gst_stream_combiner_sink_event (GstPad * pad, GstObject * parent,
     GstEvent * event)
@@ -135,6 +152,18 @@ gst_stream_combiner_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (pad, "Got event %s", GST_EVENT_TYPE_NAME (event));
 
   switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+      /* the stream that got caps last is the one that is being combined,
+       * route upstream events and queries there from now on */
+      STREAMS_LOCK (stream_combiner);
+      if (stream_combiner->current != pad &&
+          g_list_find (stream_combiner->sinkpads, pad)) {
+        GST_DEBUG_OBJECT (pad, "Making this pad the current one");
+        gst_object_replace ((GstObject **) & stream_combiner->current,
+            GST_OBJECT_CAST (pad));
+      }
+      STREAMS_UNLOCK (stream_combiner);
+      break;
     case GST_EVENT_EOS:
       STREAMS_LOCK (stream_combiner);
       combiner_pad->is_eos = TRUE;
@@ -173,20 +202,20 @@ gst_stream_combiner_src_event (GstPad * pad, GstObject * parent,
     GstEvent * event)
 {
   GstStreamCombiner *stream_combiner = (GstStreamCombiner *) parent;
-  GstPad *sinkpad = NULL;
+  GstPad *sinkpad;
+  gboolean ret;
 
-  STREAMS_LOCK (stream_combiner);
-  if (stream_combiner->current)
-    sinkpad = stream_combiner->current;
-  else if (stream_combiner->sinkpads)
-    sinkpad = (GstPad *) stream_combiner->sinkpads->data;
-  STREAMS_UNLOCK (stream_combiner);
+  sinkpad = gst_stream_combiner_get_current (stream_combiner);
+  if (sinkpad == NULL) {
+    gst_event_unref (event);
+    return FALSE;
+  }
 
-  if (sinkpad)
-    /* Forward upstream as is */
-    return gst_pad_push_event (sinkpad, event);
+  /* Forward upstream as is */
+  ret = gst_pad_push_event (sinkpad, event);
+  gst_object_unref (sinkpad);
 
-  return FALSE;
+  return ret;
 }
 
 static gboolean
@@ -202,16 +231,12 @@ gst_stream_combiner_src_query (GstPad * pad, GstObject * parent,
       ret = gst_pad_query_default (pad, parent, query);
       break;
     default:
-      STREAMS_LOCK (stream_combiner);
-      if (stream_combiner->current)
-        sinkpad = stream_combiner->current;
-      else if (stream_combiner->sinkpads)
-        sinkpad = (GstPad *) stream_combiner->sinkpads->data;
-      STREAMS_UNLOCK (stream_combiner);
-
-      if (sinkpad)
+      sinkpad = gst_stream_combiner_get_current (stream_combiner);
+      if (sinkpad) {
         /* Forward upstream as is */
         ret = gst_pad_peer_query (sinkpad, query);
+        gst_object_unref (sinkpad);
+      }
       break;
   }
   return ret;
@@ -285,7 +310,7 @@ gst_stream_combiner_release_pad (GstElement * element, GstPad * pad)
     if (pad == stream_combiner->current) {
       /* Deactivate current flow */
       GST_DEBUG_OBJECT (element, "Removed pad was the current one");
-      stream_combiner->current = NULL;
+      gst_object_replace ((GstObject **) & stream_combiner->current, NULL);
     }
     GST_DEBUG_OBJECT (element, "Removing pad from ourself");
     gst_element_remove_pad (element, pad);
@@ -42,7 +42,8 @@ struct _GstStreamCombiner {
    * * the list of srcpads
    */
   GMutex lock;
-  /* Currently activated srcpad */
+  /* Currently activated sinkpad, the last one that received caps. We own
+   * a ref */
   GstPad *current;
   GList *sinkpads;
   guint32 cookie;
@@ -45,6 +45,7 @@ static void gst_stream_splitter_dispose (GObject * object);
 static void gst_stream_splitter_finalize (GObject * object);
 
 static gboolean gst_stream_splitter_sink_setcaps (GstPad * pad, GstCaps * caps);
+static void gst_stream_splitter_free_released (GstStreamSplitter * splitter);
 
 static GstPad *gst_stream_splitter_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
@@ -90,6 +91,12 @@ gst_stream_splitter_dispose (GObject * object)
   g_list_free (stream_splitter->pending_events);
   stream_splitter->pending_events = NULL;
 
+  if (stream_splitter->current) {
+    gst_object_unref (stream_splitter->current);
+    stream_splitter->current = NULL;
+  }
+  gst_stream_splitter_free_released (stream_splitter);
+
   G_OBJECT_CLASS (gst_stream_splitter_parent_class)->dispose (object);
 }
 
@@ -103,6 +110,21 @@ gst_stream_splitter_finalize (GObject * object)
   G_OBJECT_CLASS (gst_stream_splitter_parent_class)->finalize (object);
 }
 
+/* drop the refs of released pads that were current, called from the
+ * streaming thread so that the chain function can't be using the pad */
+static void
+gst_stream_splitter_free_released (GstStreamSplitter * splitter)
+{
+  GList *released;
+
+  STREAMS_LOCK (splitter);
+  released = splitter->released;
+  g_atomic_pointer_set (&splitter->released, NULL);
+  STREAMS_UNLOCK (splitter);
+
+  g_list_free_full (released, (GDestroyNotify) gst_object_unref);
+}
+
 static void
 gst_stream_splitter_push_pending_events (GstStreamSplitter * splitter,
     GstPad * srcpad)
@@ -123,16 +145,19 @@ gst_stream_splitter_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
   GstStreamSplitter *stream_splitter = (GstStreamSplitter *) parent;
   GstFlowReturn res;
-  GstPad *srcpad = NULL;
+  GstPad *srcpad;
 
-  STREAMS_LOCK (stream_splitter);
-  if (stream_splitter->current)
-    srcpad = gst_object_ref (stream_splitter->current);
-  STREAMS_UNLOCK (stream_splitter);
+  if (G_UNLIKELY (g_atomic_pointer_get (&stream_splitter->released)))
+    gst_stream_splitter_free_released (stream_splitter);
 
+  /* The current pad is only replaced from this thread and released pads are
+   * kept alive until we get here again, so no need to take the lock */
+  srcpad = g_atomic_pointer_get (&stream_splitter->current);
   if (G_UNLIKELY (srcpad == NULL))
     goto nopad;
 
+  gst_object_ref (srcpad);
+
   if (G_UNLIKELY (stream_splitter->pending_events))
     gst_stream_splitter_push_pending_events (stream_splitter, srcpad);
 
@@ -263,10 +288,13 @@ gst_stream_splitter_sink_event (GstPad * pad, GstObject * parent,
 
     STREAMS_LOCK (stream_splitter);
     pad = stream_splitter->current;
-    STREAMS_UNLOCK (stream_splitter);
     if (pad)
+      gst_object_ref (pad);
+    STREAMS_UNLOCK (stream_splitter);
+    if (pad) {
       res = gst_pad_push_event (pad, event);
-    else {
+      gst_object_unref (pad);
+    } else {
       gst_event_unref (event);
       res = FALSE;
     }
@@ -416,6 +444,7 @@ gst_stream_splitter_sink_setcaps (GstPad * pad, GstCaps * caps)
 {
   GstStreamSplitter *stream_splitter =
       (GstStreamSplitter *) GST_PAD_PARENT (pad);
+  GstPad *old = NULL;
   guint32 cookie;
   GList *tmp;
   gboolean res;
@@ -453,7 +482,9 @@ resync:
     if (res) {
       /* FIXME : we need to switch properly */
       GST_DEBUG_OBJECT (srcpad, "Setting caps on this pad was successful");
-      stream_splitter->current = srcpad;
+      old = stream_splitter->current;
+      g_atomic_pointer_set (&stream_splitter->current,
+          gst_object_ref (srcpad));
       goto beach;
     }
     tmp = tmp->next;
@@ -461,6 +492,11 @@ resync:
 
 beach:
   STREAMS_UNLOCK (stream_splitter);
+
+  /* we are the streaming thread, the chain function is not using it */
+  if (old)
+    gst_object_unref (old);
+
   return res;
 }
 
@@ -515,9 +551,12 @@ gst_stream_splitter_release_pad (GstElement * element, GstPad * pad)
     stream_splitter->cookie++;
 
     if (pad == stream_splitter->current) {
-      /* Deactivate current flow */
+      /* Deactivate current flow. The chain function might still be pushing
+       * on the pad, so keep our ref until the streaming thread drops it */
       GST_DEBUG_OBJECT (element, "Removed pad was the current one");
-      stream_splitter->current = NULL;
+      g_atomic_pointer_set (&stream_splitter->current, NULL);
+      g_atomic_pointer_set (&stream_splitter->released,
+          g_list_prepend (stream_splitter->released, pad));
     }
 
     gst_element_remove_pad (element, pad);
@@ -38,15 +38,20 @@ struct _GstStreamSplitter {
   GstPad *sinkpad;
 
   /* lock protects:
-   * * the current pad
+   * * changes of the current pad
    * * the list of srcpads
+   * * the list of released pads
    */
   GMutex lock;
-  /* Currently activated srcpad */
+  /* Currently activated srcpad, we own a ref. Only replaced from the
+   * streaming thread and read without the lock in the chain function */
   GstPad *current;
   GList *srcpads;
   guint32 cookie;
 
+  /* Released pads that were current, unreffed from the streaming thread */
+  GList *released;
+
   /* List of pending in-band events */
   GList *pending_events;
 };
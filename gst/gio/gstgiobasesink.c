@@ -33,10 +33,22 @@ static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+#define DEFAULT_BUFFER_SIZE 0
+
+enum
+{
+  PROP_0,
+  PROP_BUFFER_SIZE
+};
+
 #define gst_gio_base_sink_parent_class parent_class
 G_DEFINE_TYPE (GstGioBaseSink, gst_gio_base_sink, GST_TYPE_BASE_SINK);
 
 static void gst_gio_base_sink_finalize (GObject * object);
+static void gst_gio_base_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_gio_base_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 static gboolean gst_gio_base_sink_start (GstBaseSink * base_sink);
 static gboolean gst_gio_base_sink_stop (GstBaseSink * base_sink);
 static gboolean gst_gio_base_sink_unlock (GstBaseSink * base_sink);
@@ -58,6 +70,23 @@ gst_gio_base_sink_class_init (GstGioBaseSinkClass * klass)
       "GIO base sink");
 
   gobject_class->finalize = gst_gio_base_sink_finalize;
+  gobject_class->set_property = gst_gio_base_sink_set_property;
+  gobject_class->get_property = gst_gio_base_sink_get_property;
+
+  /**
+   * GstGioBaseSink:buffer-size:
+   *
+   * Collect buffers until this many bytes are queued and write them with
+   * one call. This saves a round trip per buffer on slow or remote
+   * locations. 0 writes every buffer when it is received.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_BUFFER_SIZE,
+      g_param_spec_uint ("buffer-size", "Buffer size",
+          "Size in bytes of the data to collect before writing it "
+          "(0 = write every buffer)", 0, G_MAXINT, DEFAULT_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class, &sink_factory);
 
@@ -77,6 +106,8 @@ gst_gio_base_sink_init (GstGioBaseSink * sink)
   gst_base_sink_set_sync (GST_BASE_SINK (sink), FALSE);
 
   sink->cancel = g_cancellable_new ();
+  sink->buffer_size = DEFAULT_BUFFER_SIZE;
+  sink->pending = gst_adapter_new ();
 }
 
 static void
@@ -94,9 +125,115 @@ gst_gio_base_sink_finalize (GObject * object)
     sink->stream = NULL;
   }
 
+  g_object_unref (sink->pending);
+
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
 }
 
+static void
+gst_gio_base_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSink *sink = GST_GIO_BASE_SINK (object);
+
+  switch (prop_id) {
+    case PROP_BUFFER_SIZE:
+      GST_OBJECT_LOCK (sink);
+      sink->buffer_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gio_base_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSink *sink = GST_GIO_BASE_SINK (object);
+
+  switch (prop_id) {
+    case PROP_BUFFER_SIZE:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_uint (value, sink->buffer_size);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static GstFlowReturn
+gst_gio_base_sink_write (GstGioBaseSink * sink, const guint8 * data,
+    gsize size)
+{
+  gssize written;
+  gboolean success;
+  GError *err = NULL;
+
+  GST_LOG_OBJECT (sink,
+      "writing %" G_GSIZE_FORMAT " bytes to offset %" G_GUINT64_FORMAT,
+      size, sink->position);
+
+  written =
+      g_output_stream_write (sink->stream, data, size, sink->cancel, &err);
+
+  success = (written >= 0);
+
+  if (G_UNLIKELY (success && written < size)) {
+    /* FIXME: Can this happen?  Should we handle it gracefully?  gnomevfssink
+     * doesn't... */
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+        ("Could not write to stream: (short write, only %"
+            G_GSSIZE_FORMAT " bytes of %" G_GSIZE_FORMAT " bytes written)",
+            written, size));
+    return GST_FLOW_ERROR;
+  }
+
+  if (success) {
+    sink->position += written;
+    return GST_FLOW_OK;
+
+  } else {
+    GstFlowReturn ret;
+
+    if (!gst_gio_error (sink, "g_output_stream_write", &err, &ret)) {
+      if (GST_GIO_ERROR_MATCHES (err, NO_SPACE)) {
+        GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL),
+            ("Could not write to stream: %s", err->message));
+      } else {
+        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+            ("Could not write to stream: %s", err->message));
+      }
+      g_clear_error (&err);
+    }
+
+    return ret;
+  }
+}
+
+/* write all the collected buffers with one call */
+static GstFlowReturn
+gst_gio_base_sink_write_pending (GstGioBaseSink * sink)
+{
+  GstFlowReturn ret;
+  gsize avail;
+
+  avail = gst_adapter_available (sink->pending);
+  if (avail == 0)
+    return GST_FLOW_OK;
+
+  ret = gst_gio_base_sink_write (sink, gst_adapter_map (sink->pending, avail),
+      avail);
+  gst_adapter_unmap (sink->pending);
+  gst_adapter_flush (sink->pending, avail);
+
+  return ret;
+}
+
 static gboolean
 gst_gio_base_sink_start (GstBaseSink * base_sink)
 {
@@ -130,6 +267,11 @@ gst_gio_base_sink_stop (GstBaseSink * base_sink)
   gboolean success;
   GError *err = NULL;
 
+  if (G_IS_OUTPUT_STREAM (sink->stream) &&
+      gst_gio_base_sink_write_pending (sink) != GST_FLOW_OK)
+    GST_WARNING_OBJECT (sink, "could not write the collected data");
+  gst_adapter_clear (sink->pending);
+
   if (klass->close_on_stop && G_IS_OUTPUT_STREAM (sink->stream)) {
     GST_DEBUG_OBJECT (sink, "closing stream");
 
@@ -218,6 +360,10 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
           break;
         }
 
+        /* the collected data goes before the new position */
+        if ((ret = gst_gio_base_sink_write_pending (sink)) != GST_FLOW_OK)
+          break;
+
         if (GST_GIO_STREAM_IS_SEEKABLE (sink->stream)) {
           ret = gst_gio_seek (sink, G_SEEKABLE (sink->stream), segment->start,
               sink->cancel);
@@ -229,12 +375,23 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
       }
       break;
 
+    case GST_EVENT_FLUSH_STOP:
+      if (G_IS_OUTPUT_STREAM (sink->stream))
+        ret = gst_gio_base_sink_write_pending (sink);
+      break;
+
     case GST_EVENT_EOS:
     case GST_EVENT_FLUSH_START:
       if (G_IS_OUTPUT_STREAM (sink->stream)) {
         gboolean success;
         GError *err = NULL;
 
+        /* FLUSH_START is not serialized, the collected data is written on
+         * FLUSH_STOP */
+        if (GST_EVENT_TYPE (event) == GST_EVENT_EOS &&
+            (ret = gst_gio_base_sink_write_pending (sink)) != GST_FLOW_OK)
+          break;
+
         success = g_output_stream_flush (sink->stream, sink->cancel, &err);
 
         if (!success && !gst_gio_error (sink, "g_output_stream_flush", &err,
@@ -261,56 +418,29 @@ static GstFlowReturn
 gst_gio_base_sink_render (GstBaseSink * base_sink, GstBuffer * buffer)
 {
   GstGioBaseSink *sink = GST_GIO_BASE_SINK (base_sink);
-  gssize written;
+  GstFlowReturn ret;
   GstMapInfo map;
-  gboolean success;
-  GError *err = NULL;
+  guint buffer_size;
 
   g_return_val_if_fail (G_IS_OUTPUT_STREAM (sink->stream), GST_FLOW_ERROR);
 
-  gst_buffer_map (buffer, &map, GST_MAP_READ);
-
-  GST_LOG_OBJECT (sink,
-      "writing %" G_GSIZE_FORMAT " bytes to offset %" G_GUINT64_FORMAT,
-      map.size, sink->position);
-
-  written =
-      g_output_stream_write (sink->stream, map.data, map.size, sink->cancel,
-      &err);
-  gst_buffer_unmap (buffer, &map);
+  GST_OBJECT_LOCK (sink);
+  buffer_size = sink->buffer_size;
+  GST_OBJECT_UNLOCK (sink);
 
-  success = (written >= 0);
+  if (buffer_size > 0 || gst_adapter_available (sink->pending) > 0) {
+    gst_adapter_push (sink->pending, gst_buffer_ref (buffer));
+    if (gst_adapter_available (sink->pending) < buffer_size)
+      return GST_FLOW_OK;
 
-  if (G_UNLIKELY (success && written < map.size)) {
-    /* FIXME: Can this happen?  Should we handle it gracefully?  gnomevfssink
-     * doesn't... */
-    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
-        ("Could not write to stream: (short write, only %"
-            G_GSSIZE_FORMAT " bytes of %" G_GSIZE_FORMAT " bytes written)",
-            written, map.size));
-    return GST_FLOW_ERROR;
+    return gst_gio_base_sink_write_pending (sink);
   }
 
-  if (success) {
-    sink->position += written;
-    return GST_FLOW_OK;
-
-  } else {
-    GstFlowReturn ret;
-
-    if (!gst_gio_error (sink, "g_output_stream_write", &err, &ret)) {
-      if (GST_GIO_ERROR_MATCHES (err, NO_SPACE)) {
-        GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL),
-            ("Could not write to stream: %s", err->message));
-      } else {
-        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
-            ("Could not write to stream: %s", err->message));
-      }
-      g_clear_error (&err);
-    }
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  ret = gst_gio_base_sink_write (sink, map.data, map.size);
+  gst_buffer_unmap (buffer, &map);
 
-    return ret;
-  }
+  return ret;
 }
 
 static gboolean
@@ -325,7 +455,8 @@ gst_gio_base_sink_query (GstBaseSink * bsink, GstQuery * query)
       switch (format) {
         case GST_FORMAT_BYTES:
         case GST_FORMAT_DEFAULT:
-          gst_query_set_position (query, format, sink->position);
+          gst_query_set_position (query, format, sink->position +
+              gst_adapter_available (sink->pending));
           return TRUE;
         default:
           return FALSE;
@@ -25,6 +25,7 @@
 #include "gstgio.h"
 
 #include <gst/base/gstbasesink.h>
+#include <gst/base/gstadapter.h>
 
 G_BEGIN_DECLS
 
@@ -54,6 +55,8 @@ struct _GstGioBaseSink
 
   /* < private > */
   GOutputStream *stream;
+  guint buffer_size;
+  GstAdapter *pending;          /* data not written yet */
 };
 
 struct _GstGioBaseSinkClass 
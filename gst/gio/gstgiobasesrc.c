@@ -30,6 +30,11 @@
 GST_DEBUG_CATEGORY_STATIC (gst_gio_base_src_debug);
 #define GST_CAT_DEFAULT gst_gio_base_src_debug
 
+/* the cache is filled with at least this much and grows up to the maximum
+ * while the reads are sequential */
+#define MIN_READAHEAD 4096
+#define MAX_READAHEAD (1024 * 1024)
+
 static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -114,6 +119,7 @@ gst_gio_base_src_start (GstBaseSrc * base_src)
   GstGioBaseSrcClass *gbsrc_class = GST_GIO_BASE_SRC_GET_CLASS (src);
 
   src->position = 0;
+  src->readahead = MIN_READAHEAD;
 
   /* FIXME: This will likely block */
   src->stream = gbsrc_class->get_stream (src);
@@ -168,6 +174,11 @@ gst_gio_base_src_stop (GstBaseSrc * base_src)
     src->stream = NULL;
   }
 
+  if (src->cache) {
+    gst_buffer_unref (src->cache);
+    src->cache = NULL;
+  }
+
   return TRUE;
 }
 
@@ -303,7 +314,10 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
 
   /* If we have the requested part in our cache take a subbuffer of that,
    * otherwise fill the cache again with at least 4096 bytes from the
-   * requested offset and return a subbuffer of that.
+   * requested offset and return a subbuffer of that. The amount is doubled
+   * every time the reads continue where the cache ends, so that sequential
+   * reads need fewer and fewer round trips, and goes back to the minimum
+   * on random access.
    *
    * We need caching because every read/seek operation will need to go
    * over DBus if our backend is GVfs and this is painfully slow. */
@@ -318,7 +332,7 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
     GST_BUFFER_OFFSET (buf) = offset;
     GST_BUFFER_OFFSET_END (buf) = offset + size;
   } else {
-    guint cachesize = MAX (4096, size);
+    guint cachesize;
     GstMapInfo map;
     gssize read, streamread, res;
     guint64 readoffset;
@@ -327,6 +341,13 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
     GstBuffer *newbuffer;
     GstMemory *mem;
 
+    if (src->cache && offset >= GST_BUFFER_OFFSET (src->cache) &&
+        offset <= GST_BUFFER_OFFSET_END (src->cache))
+      src->readahead = MIN (src->readahead * 2, MAX_READAHEAD);
+    else
+      src->readahead = MIN_READAHEAD;
+    cachesize = MAX (src->readahead, size);
+
     newbuffer = gst_buffer_new ();
 
     /* copy any overlapping data from the cached buffer */
@@ -388,6 +409,8 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
       src->position += res;
     }
     gst_memory_unmap (mem, &map);
+    /* don't keep the part of a big readahead that was not filled */
+    gst_memory_resize (mem, 0, streamread);
     gst_buffer_append_memory (src->cache, mem);
 
     success = (read >= 0);
@@ -55,6 +55,7 @@ struct _GstGioBaseSrc
   /* < private > */
   GInputStream *stream;
   GstBuffer *cache;
+  guint readahead;              /* size of the next cache fill */
 };
 
 struct _GstGioBaseSrcClass 
@@ -166,6 +166,10 @@ struct _GstDecodeBin
   GMutex factories_lock;
   guint32 factories_cookie;     /* Cookie from last time when factories was updated */
   GList *factories;             /* factories we can use for selecting elements */
+  GHashTable *factories_index;  /* media type quark -> GList of factories from
+                                 * above list that can sink it, not reffed */
+  GHashTable *factories_cache;  /* caps string -> GList of filtered factories,
+                                 * valid for the current cookie */
 
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
@@ -180,6 +184,16 @@ struct _GstDecodeBin
   gboolean shutdown;            /* if we are shutting down */
   GList *blocked_pads;          /* pads that have set to block */
 
+  gboolean parallel_autoplug;   /* connect demuxer pads from the pool */
+  GThreadPool *connect_pool;    /* pool for connecting demuxer pads */
+  gint pending_connects;        /* pads queued in the pool, ATOMIC, changed
+                                 * with dyn_lock */
+  GCond connect_cond;           /* signaled when pending_connects drops to 0 */
+
+  gboolean reuse_decoders;      /* keep decoders of freed chains */
+  GList *reusable_decoders;     /* GstReusableDecoder, protected by the
+                                 * object lock */
+
   gboolean expose_allstreams;   /* Whether to expose unknow type streams or not */
 
   GList *filtered;              /* elements for which error messages are filtered */
@@ -255,6 +269,11 @@ enum
 #define DEFAULT_POST_STREAM_TOPOLOGY FALSE
 #define DEFAULT_EXPOSE_ALL_STREAMS  TRUE
 #define DEFAULT_CONNECTION_SPEED    0
+#define DEFAULT_PARALLEL_AUTOPLUG   FALSE
+#define DEFAULT_REUSE_DECODERS      FALSE
+
+/* max number of decoders kept with reuse-decoders */
+#define REUSABLE_DECODERS_MAX       8
 
 /* Properties */
 enum
@@ -271,7 +290,9 @@ enum
   PROP_MAX_SIZE_TIME,
   PROP_POST_STREAM_TOPOLOGY,
   PROP_EXPOSE_ALL_STREAMS,
-  PROP_CONNECTION_SPEED
+  PROP_CONNECTION_SPEED,
+  PROP_PARALLEL_AUTOPLUG,
+  PROP_REUSE_DECODERS
 };
 
 static GstBinClass *parent_class;
@@ -314,6 +335,9 @@ static void caps_notify_cb (GstPad * pad, GParamSpec * unused,
 static void flush_chain (GstDecodeChain * chain, gboolean flushing);
 static void flush_group (GstDecodeGroup * group, gboolean flushing);
 static GstPad *find_sink_pad (GstElement * element);
+static GstElement *gst_decode_bin_take_reusable_decoder (GstDecodeBin * dbin,
+    GstElementFactory * factory, GstCaps * caps);
+static void gst_decode_bin_clear_reusable_decoders (GstDecodeBin * dbin);
 static GstStateChangeReturn gst_decode_bin_change_state (GstElement * element,
     GstStateChange transition);
 static void gst_decode_bin_handle_message (GstBin * bin, GstMessage * message);
@@ -989,6 +1013,40 @@ gst_decode_bin_class_init (GstDecodeBinClass * klass)
           0, G_MAXUINT64 / 1000, DEFAULT_CONNECTION_SPEED,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDecodeBin2::parallel-autoplug
+   *
+   * Connect the streams of a demuxer from a pool of threads instead of
+   * one after the other from the streaming thread of the demuxer. This
+   * makes the time until all streams are exposed the time of the slowest
+   * stream instead of the sum of all of them when opening the elements is
+   * slow, like for some hardware decoders. The demuxer pads are blocked
+   * until their stream is connected.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_PARALLEL_AUTOPLUG,
+      g_param_spec_boolean ("parallel-autoplug", "Parallel Autoplug",
+          "Connect the streams of demuxers in parallel",
+          DEFAULT_PARALLEL_AUTOPLUG,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDecodeBin2::reuse-decoders
+   *
+   * Don't destroy the decoders when their chain is removed, for example
+   * when going back to READY to play another uri, but reset them to READY
+   * and keep them. When the same decoder is needed again for exactly the
+   * same caps, the kept instance is used instead of creating and opening
+   * a new one.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_REUSE_DECODERS,
+      g_param_spec_boolean ("reuse-decoders", "Reuse Decoders",
+          "Keep decoders and reuse them for streams with the same caps",
+          DEFAULT_REUSE_DECODERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
 
   klass->autoplug_continue =
@@ -1065,14 +1123,130 @@ gst_decode_bin_update_factories_list (GstDecodeBin * dbin)
     dbin->factories =
         g_list_sort (dbin->factories, _decode_bin_compare_factories_func);
     dbin->factories_cookie = cookie;
+    /* both point into the old list */
+    g_hash_table_remove_all (dbin->factories_index);
+    g_hash_table_remove_all (dbin->factories_cache);
   }
 }
 
+static gboolean
+factory_can_sink_media_type (GstElementFactory * factory, GQuark media_type)
+{
+  const GList *templs;
+  gboolean res = FALSE;
+
+  templs = gst_element_factory_get_static_pad_templates (factory);
+  for (; templs && !res; templs = templs->next) {
+    GstStaticPadTemplate *templ = templs->data;
+    GstCaps *tcaps;
+    guint i, n;
+
+    if (templ->direction != GST_PAD_SINK)
+      continue;
+
+    tcaps = gst_static_caps_get (&templ->static_caps);
+    if (gst_caps_is_any (tcaps)) {
+      res = TRUE;
+    } else {
+      n = gst_caps_get_size (tcaps);
+      for (i = 0; i < n && !res; i++) {
+        GstStructure *s = gst_caps_get_structure (tcaps, i);
+
+        res = gst_structure_get_name_id (s) == media_type;
+      }
+    }
+    gst_caps_unref (tcaps);
+  }
+  return res;
+}
+
+/* Must be called with factories lock! Returns the factories that have a sink
+ * template with the media type of @caps, in the same order as the factories
+ * list. Caps can only intersect with or be a subset of a template that has a
+ * structure with the same name, so this is a cheap prefilter before the
+ * caps operations done by gst_element_factory_list_filter(). The list is
+ * owned by decodebin. */
+static GList *
+gst_decode_bin_get_candidate_factories (GstDecodeBin * dbin, GstCaps * caps)
+{
+  GQuark media_type;
+  GList *list = NULL, *tmp;
+  gpointer value;
+
+  if (gst_caps_is_any (caps) || gst_caps_get_size (caps) != 1)
+    return dbin->factories;
+
+  media_type = gst_structure_get_name_id (gst_caps_get_structure (caps, 0));
+  if (g_hash_table_lookup_extended (dbin->factories_index,
+          GUINT_TO_POINTER (media_type), NULL, &value))
+    return value;
+
+  for (tmp = dbin->factories; tmp; tmp = tmp->next) {
+    GstElementFactory *factory = GST_ELEMENT_FACTORY_CAST (tmp->data);
+
+    if (factory_can_sink_media_type (factory, media_type))
+      list = g_list_prepend (list, factory);
+  }
+  list = g_list_reverse (list);
+
+  GST_DEBUG_OBJECT (dbin, "%u of %u factories can sink %s",
+      g_list_length (list), g_list_length (dbin->factories),
+      g_quark_to_string (media_type));
+
+  g_hash_table_insert (dbin->factories_index, GUINT_TO_POINTER (media_type),
+      list);
+
+  return list;
+}
+
+/* don't let the cache grow without bounds when the caps contain things like
+ * codec_data that are different for every stream */
+#define FACTORIES_CACHE_MAX 64
+
+/* Must be called with factories lock! Returns a new list of the factories
+ * that can handle @caps */
+static GList *
+gst_decode_bin_filter_factories (GstDecodeBin * dbin, GstCaps * caps)
+{
+  GList *list;
+  gchar *key;
+
+  key = gst_caps_to_string (caps);
+  list = g_hash_table_lookup (dbin->factories_cache, key);
+  if (list) {
+    GST_LOG_OBJECT (dbin, "using cached factories for %s", key);
+    g_free (key);
+    return gst_plugin_feature_list_copy (list);
+  }
+
+  list =
+      gst_element_factory_list_filter (gst_decode_bin_get_candidate_factories
+      (dbin, caps), caps, GST_PAD_SINK, gst_caps_is_fixed (caps));
+
+  /* empty results are not cached, NULL can't be told apart from a miss and
+   * they are rare anyway */
+  if (list) {
+    if (g_hash_table_size (dbin->factories_cache) >= FACTORIES_CACHE_MAX)
+      g_hash_table_remove_all (dbin->factories_cache);
+    g_hash_table_insert (dbin->factories_cache, key,
+        gst_plugin_feature_list_copy (list));
+  } else {
+    g_free (key);
+  }
+
+  return list;
+}
+
 static void
 gst_decode_bin_init (GstDecodeBin * decode_bin)
 {
   /* first filter out the interesting element factories */
   g_mutex_init (&decode_bin->factories_lock);
+  decode_bin->factories_index =
+      g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_list_free);
+  decode_bin->factories_cache =
+      g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      (GDestroyNotify) gst_plugin_feature_list_free);
 
   /* we create the typefind element only once */
   decode_bin->typefind = gst_element_factory_make ("typefind", "typefind");
@@ -1109,6 +1283,7 @@ gst_decode_bin_init (GstDecodeBin * decode_bin)
   decode_bin->decode_chain = NULL;
 
   g_mutex_init (&decode_bin->dyn_lock);
+  g_cond_init (&decode_bin->connect_cond);
   decode_bin->shutdown = FALSE;
   decode_bin->blocked_pads = NULL;
 
@@ -1128,6 +1303,8 @@ gst_decode_bin_init (GstDecodeBin * decode_bin)
 
   decode_bin->expose_allstreams = DEFAULT_EXPOSE_ALL_STREAMS;
   decode_bin->connection_speed = DEFAULT_CONNECTION_SPEED;
+  decode_bin->parallel_autoplug = DEFAULT_PARALLEL_AUTOPLUG;
+  decode_bin->reuse_decoders = DEFAULT_REUSE_DECODERS;
 }
 
 static void
@@ -1137,6 +1314,8 @@ gst_decode_bin_dispose (GObject * object)
 
   decode_bin = GST_DECODE_BIN (object);
 
+  g_hash_table_remove_all (decode_bin->factories_index);
+  g_hash_table_remove_all (decode_bin->factories_cache);
   if (decode_bin->factories)
     gst_plugin_feature_list_free (decode_bin->factories);
   decode_bin->factories = NULL;
@@ -1145,6 +1324,8 @@ gst_decode_bin_dispose (GObject * object)
     gst_decode_chain_free (decode_bin->decode_chain);
   decode_bin->decode_chain = NULL;
 
+  gst_decode_bin_clear_reusable_decoders (decode_bin);
+
   if (decode_bin->caps)
     gst_caps_unref (decode_bin->caps);
   decode_bin->caps = NULL;
@@ -1166,11 +1347,16 @@ gst_decode_bin_finalize (GObject * object)
   decode_bin = GST_DECODE_BIN (object);
 
   g_mutex_clear (&decode_bin->expose_lock);
+  if (decode_bin->connect_pool)
+    g_thread_pool_free (decode_bin->connect_pool, FALSE, TRUE);
   g_mutex_clear (&decode_bin->dyn_lock);
+  g_cond_clear (&decode_bin->connect_cond);
   g_mutex_clear (&decode_bin->subtitle_lock);
   g_mutex_clear (&decode_bin->buffering_lock);
   g_mutex_clear (&decode_bin->buffering_post_lock);
   g_mutex_clear (&decode_bin->factories_lock);
+  g_hash_table_unref (decode_bin->factories_index);
+  g_hash_table_unref (decode_bin->factories_cache);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1315,6 +1501,14 @@ gst_decode_bin_set_property (GObject * object, guint prop_id,
       dbin->connection_speed = g_value_get_uint64 (value) * 1000;
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_PARALLEL_AUTOPLUG:
+      dbin->parallel_autoplug = g_value_get_boolean (value);
+      break;
+    case PROP_REUSE_DECODERS:
+      GST_OBJECT_LOCK (dbin);
+      dbin->reuse_decoders = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1367,6 +1561,14 @@ gst_decode_bin_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, dbin->connection_speed / 1000);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_PARALLEL_AUTOPLUG:
+      g_value_set_boolean (value, dbin->parallel_autoplug);
+      break;
+    case PROP_REUSE_DECODERS:
+      GST_OBJECT_LOCK (dbin);
+      g_value_set_boolean (value, dbin->reuse_decoders);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1400,9 +1602,7 @@ gst_decode_bin_autoplug_factories (GstElement * element, GstPad * pad,
   /* return all compatible factories for caps */
   g_mutex_lock (&dbin->factories_lock);
   gst_decode_bin_update_factories_list (dbin);
-  list =
-      gst_element_factory_list_filter (dbin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
+  list = gst_decode_bin_filter_factories (dbin, caps);
   g_mutex_unlock (&dbin->factories_lock);
 
   result = g_value_array_new (g_list_length (list));
@@ -1552,13 +1752,14 @@ analyze_new_pad (GstDecodeBin * dbin, GstElement * src, GstPad * pad,
     GstDecodeChain *oldchain = chain;
     GstDecodeElement *demux = (chain->elements ? chain->elements->data : NULL);
 
+    /* we are adding a new pad for a demuxer (see is_demuxer_element(),
+     * start a new chain for it. With parallel-autoplug this can happen
+     * from several threads at once */
+    CHAIN_MUTEX_LOCK (oldchain);
     if (chain->current_pad)
       gst_object_unref (chain->current_pad);
     chain->current_pad = NULL;
 
-    /* we are adding a new pad for a demuxer (see is_demuxer_element(),
-     * start a new chain for it */
-    CHAIN_MUTEX_LOCK (oldchain);
     group = gst_decode_chain_get_current_group (chain);
     if (group && !g_list_find (group->children, chain)) {
       g_assert (new_chain != NULL);
@@ -2261,8 +2462,11 @@ connect_pad (GstDecodeBin * dbin, GstElement * src, GstDecodePad * dpad,
     /* 2.0. Unlink pad */
     decode_pad_set_target (dpad, NULL);
 
-    /* 2.1. Try to create an element */
-    if ((element = gst_element_factory_create (factory, NULL)) == NULL) {
+    /* 2.1. Try to create an element, or take one we kept */
+    if ((element = gst_decode_bin_take_reusable_decoder (dbin, factory,
+                caps))) {
+      GST_DEBUG_OBJECT (dbin, "reusing decoder %s", GST_ELEMENT_NAME (element));
+    } else if ((element = gst_element_factory_create (factory, NULL)) == NULL) {
       GST_WARNING_OBJECT (dbin, "Could not create an element from %s",
           gst_plugin_feature_get_name (GST_PLUGIN_FEATURE (factory)));
       g_string_append_printf (error_details,
@@ -2924,6 +3128,131 @@ pad_event_cb (GstPad * pad, GstPadProbeInfo * info, gpointer data)
   return GST_PAD_PROBE_OK;
 }
 
+typedef struct
+{
+  GstElement *element;
+  GstPad *pad;
+  GstDecodeChain *chain;
+  gulong block_id;
+} GstPendingConnect;
+
+static GstPadProbeReturn
+pending_connect_block_cb (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  GST_LOG_OBJECT (pad, "blocked until the stream is connected");
+  return GST_PAD_PROBE_OK;
+}
+
+/* runs in the connect pool, does the same as pad_added_cb() */
+static void
+pending_connect_func (GstPendingConnect * pc, GstDecodeBin * dbin)
+{
+  GstCaps *caps;
+  GstDecodeChain *new_chain;
+  gboolean shutdown, last;
+
+  GST_DEBUG_OBJECT (pc->pad, "connecting, chain:%p", pc->chain);
+
+  GST_PAD_STREAM_LOCK (pc->pad);
+  DYN_LOCK (dbin);
+  shutdown = dbin->shutdown;
+  DYN_UNLOCK (dbin);
+
+  if (!shutdown && gst_pad_is_active (pc->pad)) {
+    caps = get_pad_caps (pc->pad);
+    if (analyze_new_pad (dbin, pc->element, pc->pad, caps, pc->chain,
+            &new_chain))
+      expose_pad (dbin, pc->element, new_chain->current_pad, pc->pad, caps,
+          new_chain);
+    if (caps)
+      gst_caps_unref (caps);
+  } else {
+    GST_DEBUG_OBJECT (pc->pad, "shutting down or pad deactivated");
+  }
+  GST_PAD_STREAM_UNLOCK (pc->pad);
+
+  gst_pad_remove_probe (pc->pad, pc->block_id);
+
+  gst_decode_chain_unref (pc->chain);
+  gst_object_unref (pc->pad);
+  gst_object_unref (pc->element);
+  g_slice_free (GstPendingConnect, pc);
+
+  DYN_LOCK (dbin);
+  last = g_atomic_int_dec_and_test (&dbin->pending_connects);
+  if (last)
+    g_cond_broadcast (&dbin->connect_cond);
+  shutdown = dbin->shutdown;
+  DYN_UNLOCK (dbin);
+
+  /* exposing is delayed while pads are pending, check again when the
+   * last one is done */
+  if (last && !shutdown) {
+    EXPOSE_LOCK (dbin);
+    if (dbin->decode_chain)
+      if (gst_decode_chain_is_complete (dbin->decode_chain))
+        gst_decode_bin_expose (dbin);
+    EXPOSE_UNLOCK (dbin);
+  }
+}
+
+/* Hand the pad to the connect pool, returns FALSE when it has to be
+ * connected from the calling thread */
+static gboolean
+queue_pending_connect (GstDecodeBin * dbin, GstElement * element,
+    GstPad * pad, GstDecodeChain * chain)
+{
+  GstPendingConnect *pc;
+
+  /* only the streams of a demuxer are independent. Pads with a task hold
+   * their stream lock while blocked, we can't take it from another thread
+   * then. */
+  if (!dbin->parallel_autoplug || !chain->demuxer || GST_PAD_TASK (pad))
+    return FALSE;
+
+  pc = g_slice_new0 (GstPendingConnect);
+  pc->element = gst_object_ref (element);
+  pc->pad = gst_object_ref (pad);
+  pc->chain = gst_decode_chain_ref (chain);
+
+  DYN_LOCK (dbin);
+  if (G_UNLIKELY (dbin->shutdown)) {
+    DYN_UNLOCK (dbin);
+    gst_decode_chain_unref (pc->chain);
+    gst_object_unref (pc->pad);
+    gst_object_unref (pc->element);
+    g_slice_free (GstPendingConnect, pc);
+    return TRUE;
+  }
+  if (!dbin->connect_pool)
+    dbin->connect_pool =
+        g_thread_pool_new ((GFunc) pending_connect_func, dbin, -1, FALSE,
+        NULL);
+  /* keep data from reaching the pad before it is connected */
+  pc->block_id =
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      pending_connect_block_cb, NULL, NULL);
+  g_atomic_int_inc (&dbin->pending_connects);
+  DYN_UNLOCK (dbin);
+
+  GST_DEBUG_OBJECT (pad, "queued for connecting, chain:%p", chain);
+  g_thread_pool_push (dbin->connect_pool, pc, NULL);
+
+  return TRUE;
+}
+
+/* call with dyn_lock held */
+static void
+wait_pending_connects (GstDecodeBin * dbin)
+{
+  while (g_atomic_int_get (&dbin->pending_connects) > 0) {
+    GST_DEBUG_OBJECT (dbin, "waiting for %d pending pads",
+        g_atomic_int_get (&dbin->pending_connects));
+    g_cond_wait (&dbin->connect_cond, &dbin->dyn_lock);
+  }
+}
+
 static void
 pad_added_cb (GstElement * element, GstPad * pad, GstDecodeChain * chain)
 {
@@ -2941,6 +3270,11 @@ pad_added_cb (GstElement * element, GstPad * pad, GstDecodeChain * chain)
     return;
   }
 
+  if (queue_pending_connect (dbin, element, pad, chain)) {
+    GST_PAD_STREAM_UNLOCK (pad);
+    return;
+  }
+
   caps = get_pad_caps (pad);
   if (analyze_new_pad (dbin, element, pad, caps, chain, &new_chain))
     expose_pad (dbin, element, new_chain->current_pad, pad, caps, new_chain);
@@ -3340,6 +3674,130 @@ gst_decode_chain_ref (GstDecodeChain * chain)
   return chain;
 }
 
+typedef struct
+{
+  GstElement *element;
+  GstCaps *caps;                /* the caps the decoder had */
+} GstReusableDecoder;
+
+static void
+gst_reusable_decoder_free (GstReusableDecoder * reusable)
+{
+  gst_element_set_state (reusable->element, GST_STATE_NULL);
+  gst_object_unref (reusable->element);
+  gst_caps_unref (reusable->caps);
+  g_slice_free (GstReusableDecoder, reusable);
+}
+
+/* Called with an element of a chain that was freed, it was removed from the
+ * bin already. When reuse-decoders is set and it is a decoder, reset it to
+ * READY and keep it. Returns FALSE when the element is not kept and should
+ * be shut down. */
+static gboolean
+gst_decode_bin_keep_reusable_decoder (GstDecodeBin * dbin, GstElement * element)
+{
+  GstReusableDecoder *reusable, *evicted = NULL;
+  GstElementFactory *factory;
+  const gchar *klass;
+  GstPad *sinkpad;
+  GstCaps *caps = NULL;
+  gboolean reuse;
+
+  GST_OBJECT_LOCK (dbin);
+  reuse = dbin->reuse_decoders;
+  GST_OBJECT_UNLOCK (dbin);
+
+  if (!reuse || !(factory = gst_element_get_factory (element)))
+    return FALSE;
+
+  klass = gst_element_factory_get_metadata (factory,
+      GST_ELEMENT_METADATA_KLASS);
+  if (!klass || !strstr (klass, "Decoder"))
+    return FALSE;
+
+  /* the sticky caps are gone after deactivating the pads, get them first */
+  if ((sinkpad = find_sink_pad (element))) {
+    caps = gst_pad_get_current_caps (sinkpad);
+    gst_object_unref (sinkpad);
+  }
+  if (!caps)
+    return FALSE;
+
+  /* this flushes and resets the decoder but keeps it open */
+  if (gst_element_set_state (element, GST_STATE_READY) ==
+      GST_STATE_CHANGE_FAILURE) {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (dbin, "keeping decoder %s for %" GST_PTR_FORMAT,
+      GST_ELEMENT_NAME (element), caps);
+
+  reusable = g_slice_new (GstReusableDecoder);
+  reusable->element = gst_object_ref (element);
+  reusable->caps = caps;
+
+  GST_OBJECT_LOCK (dbin);
+  dbin->reusable_decoders = g_list_prepend (dbin->reusable_decoders, reusable);
+  if (g_list_length (dbin->reusable_decoders) > REUSABLE_DECODERS_MAX) {
+    GList *last = g_list_last (dbin->reusable_decoders);
+
+    evicted = last->data;
+    dbin->reusable_decoders =
+        g_list_delete_link (dbin->reusable_decoders, last);
+  }
+  GST_OBJECT_UNLOCK (dbin);
+
+  if (evicted)
+    gst_reusable_decoder_free (evicted);
+
+  return TRUE;
+}
+
+/* Returns a kept decoder from @factory that was used for the same @caps, or
+ * NULL. The element is at READY and floating like a new one. */
+static GstElement *
+gst_decode_bin_take_reusable_decoder (GstDecodeBin * dbin,
+    GstElementFactory * factory, GstCaps * caps)
+{
+  GstElement *element = NULL;
+  GList *l;
+
+  GST_OBJECT_LOCK (dbin);
+  for (l = dbin->reusable_decoders; l; l = l->next) {
+    GstReusableDecoder *reusable = l->data;
+
+    if (gst_element_get_factory (reusable->element) == factory
+        && gst_caps_is_equal (reusable->caps, caps)) {
+      element = reusable->element;
+      gst_caps_unref (reusable->caps);
+      g_slice_free (GstReusableDecoder, reusable);
+      dbin->reusable_decoders =
+          g_list_delete_link (dbin->reusable_decoders, l);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (dbin);
+
+  if (element)
+    g_object_force_floating (G_OBJECT (element));
+
+  return element;
+}
+
+static void
+gst_decode_bin_clear_reusable_decoders (GstDecodeBin * dbin)
+{
+  GList *reusable;
+
+  GST_OBJECT_LOCK (dbin);
+  reusable = dbin->reusable_decoders;
+  dbin->reusable_decoders = NULL;
+  GST_OBJECT_UNLOCK (dbin);
+
+  g_list_free_full (reusable, (GDestroyNotify) gst_reusable_decoder_free);
+}
+
 static void
 gst_decode_chain_free_internal (GstDecodeChain * chain, gboolean hide)
 {
@@ -3474,7 +3932,8 @@ gst_decode_chain_free_internal (GstDecodeChain * chain, gboolean hide)
   while (set_to_null) {
     GstElement *element = set_to_null->data;
     set_to_null = g_list_delete_link (set_to_null, set_to_null);
-    gst_element_set_state (element, GST_STATE_NULL);
+    if (!gst_decode_bin_keep_reusable_decoder (chain->dbin, element))
+      gst_element_set_state (element, GST_STATE_NULL);
     gst_object_unref (element);
   }
 
@@ -3935,6 +4394,11 @@ gst_decode_chain_is_complete (GstDecodeChain * chain)
   if (chain->dbin->shutdown)
     goto out;
 
+  /* streams that are still being connected in the pool are not in the
+   * groups yet */
+  if (g_atomic_int_get (&chain->dbin->pending_connects) > 0)
+    goto out;
+
   if (chain->deadend) {
     complete = TRUE;
     goto out;
@@ -5321,6 +5785,11 @@ gst_decode_bin_change_state (GstElement * element, GstStateChange transition)
   }
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* the pads are deactivated now, wait for the pool to let go of the
+       * chains before we free them */
+      DYN_LOCK (dbin);
+      wait_pending_connects (dbin);
+      DYN_UNLOCK (dbin);
       do_async_done (dbin);
       EXPOSE_LOCK (dbin);
       if (dbin->decode_chain) {
@@ -5337,6 +5806,8 @@ gst_decode_bin_change_state (GstElement * element, GstStateChange transition)
       dbin->buffering_status = NULL;
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
+      gst_decode_bin_clear_reusable_decoders (dbin);
+      break;
     default:
       break;
   }
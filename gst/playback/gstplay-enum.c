@@ -69,6 +69,10 @@ gst_play_flags_get_type (void)
         "soft-colorbalance"},
     {C_FLAGS (GST_PLAY_FLAG_FORCE_FILTERS),
         "Force audio/video filter(s) to be applied", "force-filters"},
+    {C_FLAGS (GST_PLAY_FLAG_FAST_START),
+        "Start without waiting for the video to preroll", "fast-start"},
+    {C_FLAGS (GST_PLAY_FLAG_REUSE_DECODERS),
+        "Reuse decoders for streams with the same caps", "reuse-decoders"},
     {0, NULL, NULL}
   };
   static volatile GType id = 0;
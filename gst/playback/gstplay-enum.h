@@ -60,6 +60,11 @@ GType gst_autoplug_select_result_get_type (void);
  * @GST_PLAY_FLAG_SOFT_COLORBALANCE: Use a software filter for colour balance
  * @GST_PLAY_FLAG_FORCE_FILTERS: force audio/video filters to be applied if
  *   set.
+ * @GST_PLAY_FLAG_FAST_START: don't wait for the video to preroll when there
+ *   is audio, start as soon as the audio is ready and show the video when it
+ *   is decoded. Late streams are dropped until they caught up.
+ * @GST_PLAY_FLAG_REUSE_DECODERS: keep the decoders when changing the uri
+ *   and reuse them when the new uri has streams with the same caps.
  *
  * Extra flags to configure the behaviour of the sinks.
  */
@@ -76,6 +81,8 @@ typedef enum {
   GST_PLAY_FLAG_DEINTERLACE   = (1 << 9),
   GST_PLAY_FLAG_SOFT_COLORBALANCE = (1 << 10),
   GST_PLAY_FLAG_FORCE_FILTERS = (1 << 11),
+  GST_PLAY_FLAG_FAST_START    = (1 << 12),
+  GST_PLAY_FLAG_REUSE_DECODERS = (1 << 13),
 } GstPlayFlags;
 
 #define GST_TYPE_PLAY_FLAGS (gst_play_flags_get_type())
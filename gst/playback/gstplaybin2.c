@@ -376,6 +376,13 @@ struct _GstSourceGroup
   /* buffering message stored for after switching */
   GstMessage *pending_buffering_msg;
 
+  /* lookahead: activated while the current group is still playing, the
+   * sinks are linked when it becomes the current group */
+  gboolean prebuffering;
+  gint about_to_finish_emitted;  /* ATOMIC, emitted before drained */
+  gint64 lookahead_duration;
+  GstClockTime lookahead_next_query;
+
   /* combiners for different streams */
   GstSourceCombine combiner[PLAYBIN_STREAM_LAST];
 };
@@ -428,6 +435,9 @@ struct _GstPlayBin
 
   guint64 buffer_duration;      /* When buffering, the max buffer duration (ns) */
   guint buffer_size;            /* When buffering, the max buffer size (bytes) */
+  guint64 lookahead;            /* prepare the next group this long before EOS */
+  gint64 lookahead_buffer_duration;     /* buffer-duration for the next group */
+  gint lookahead_buffer_size;   /* buffer-size for the next group */
   gboolean force_aspect_ratio;
 
   /* Multiview/stereoscopic overrides */
@@ -517,6 +527,11 @@ struct _GstPlayBinClass
   GstPad *(*get_video_pad) (GstPlayBin * playbin, gint stream);
   GstPad *(*get_audio_pad) (GstPlayBin * playbin, gint stream);
   GstPad *(*get_text_pad) (GstPlayBin * playbin, gint stream);
+
+  /* share the decoded video with extra sinks */
+  gboolean (*add_extra_video_sink) (GstPlayBin * playbin, GstElement * sink);
+  gboolean (*remove_extra_video_sink) (GstPlayBin * playbin,
+      GstElement * sink);
 };
 
 /* props */
@@ -545,6 +560,9 @@ struct _GstPlayBinClass
 #define DEFAULT_BUFFER_DURATION   -1
 #define DEFAULT_BUFFER_SIZE       -1
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+#define DEFAULT_LOOKAHEAD         0
+#define DEFAULT_LOOKAHEAD_BUFFER_DURATION -1
+#define DEFAULT_LOOKAHEAD_BUFFER_SIZE -1
 
 enum
 {
@@ -582,7 +600,12 @@ enum
   PROP_AUDIO_FILTER,
   PROP_VIDEO_FILTER,
   PROP_MULTIVIEW_MODE,
-  PROP_MULTIVIEW_FLAGS
+  PROP_MULTIVIEW_FLAGS,
+  PROP_LOOKAHEAD,
+  PROP_LOOKAHEAD_BUFFER_SIZE,
+  PROP_LOOKAHEAD_BUFFER_DURATION,
+  PROP_VIDEO_CACHE_FRAMES,
+  PROP_VIDEO_CACHE_BYTES
 };
 
 /* signals */
@@ -602,6 +625,8 @@ enum
   SIGNAL_GET_VIDEO_PAD,
   SIGNAL_GET_AUDIO_PAD,
   SIGNAL_GET_TEXT_PAD,
+  SIGNAL_ADD_EXTRA_VIDEO_SINK,
+  SIGNAL_REMOVE_EXTRA_VIDEO_SINK,
   SIGNAL_SOURCE_SETUP,
   LAST_SIGNAL
 };
@@ -641,11 +666,19 @@ static GstSample *gst_play_bin_convert_sample (GstPlayBin * playbin,
 static GstPad *gst_play_bin_get_video_pad (GstPlayBin * playbin, gint stream);
 static GstPad *gst_play_bin_get_audio_pad (GstPlayBin * playbin, gint stream);
 static GstPad *gst_play_bin_get_text_pad (GstPlayBin * playbin, gint stream);
+static gboolean gst_play_bin_add_extra_video_sink (GstPlayBin * playbin,
+    GstElement * sink);
+static gboolean gst_play_bin_remove_extra_video_sink (GstPlayBin * playbin,
+    GstElement * sink);
 
 static GstStateChangeReturn setup_next_source (GstPlayBin * playbin,
     GstState target);
 
 static void no_more_pads_cb (GstElement * decodebin, GstSourceGroup * group);
+static GstPadProbeReturn lookahead_probe_cb (GstPad * pad,
+    GstPadProbeInfo * info, GstSourceGroup * group);
+static GstStateChangeReturn activate_group (GstPlayBin * playbin,
+    GstSourceGroup * group, GstState target);
 static void pad_removed_cb (GstElement * decodebin, GstPad * pad,
     GstSourceGroup * group);
 
@@ -981,6 +1014,10 @@ gst_play_bin_class_init (GstPlayBinClass * klass)
    *
    * The maximum size of the ring buffer in bytes. If set to 0, the ring
    * buffer is disabled. Default 0.
+   *
+   * With #GST_PLAY_FLAG_DOWNLOAD this limits the size of the temporary file
+   * of the download buffering, seeks outside of the downloaded window are
+   * then done upstream.
    */
   g_object_class_install_property (gobject_klass, PROP_RING_BUFFER_MAX_SIZE,
       g_param_spec_uint64 ("ring-buffer-max-size",
@@ -1034,6 +1071,89 @@ gst_play_bin_class_init (GstPlayBinClass * klass)
           GST_TYPE_VIDEO_MULTIVIEW_FLAGS, GST_VIDEO_MULTIVIEW_FLAGS_NONE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPlayBin:lookahead:
+   *
+   * When not 0, #GstPlayBin::about-to-finish is emitted this long (in
+   * nanoseconds) before the end of the current uri instead of when it is
+   * drained. The next uri set from the signal is then set up and prerolled
+   * in parallel, so that its source, typefinding and decoders are ready and
+   * data is buffered when the current uri ends.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_LOOKAHEAD,
+      g_param_spec_uint64 ("lookahead", "Lookahead (ns)",
+          "Prepare the next uri this long before the end of the current one "
+          "(0 = when the current uri is drained)", 0, G_MAXUINT64,
+          DEFAULT_LOOKAHEAD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPlayBin:lookahead-buffer-size:
+   *
+   * The buffer size used for the next uri while it is prepared with
+   * #GstPlayBin:lookahead, -1 to use #GstPlayBin:buffer-size.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_LOOKAHEAD_BUFFER_SIZE,
+      g_param_spec_int ("lookahead-buffer-size", "Lookahead buffer size (bytes)",
+          "Buffer size for preparing the next uri (-1 = buffer-size)",
+          -1, G_MAXINT, DEFAULT_LOOKAHEAD_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPlayBin:lookahead-buffer-duration:
+   *
+   * The buffer duration used for the next uri while it is prepared with
+   * #GstPlayBin:lookahead, -1 to use #GstPlayBin:buffer-duration.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass,
+      PROP_LOOKAHEAD_BUFFER_DURATION,
+      g_param_spec_int64 ("lookahead-buffer-duration",
+          "Lookahead buffer duration (ns)",
+          "Buffer duration for preparing the next uri (-1 = buffer-duration)",
+          -1, G_MAXINT64, DEFAULT_LOOKAHEAD_BUFFER_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPlayBin:video-cache-frames:
+   *
+   * When not 0, this many recently decoded video frames are kept. A flushing
+   * accurate seek in the PAUSED state to one of them shows the frame without
+   * seeking and decoding again, which makes scrubbing back and forth fast.
+   * The decoders are seeked to the position when going to PLAYING or with
+   * the next seek that is not served from the cache.
+   *
+   * The cache is used when this or #GstPlayBin:video-cache-bytes is not 0, a
+   * limit of 0 is not applied. Only decoded video in system memory is cached,
+   * frames that come from a buffer pool are copied. Enabling or disabling
+   * the cache takes effect when the video output is set up the next time.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_VIDEO_CACHE_FRAMES,
+      g_param_spec_uint ("video-cache-frames", "Video cache frames",
+          "Maximum number of decoded video frames to keep for seeks "
+          "(0 = no limit)", 0, G_MAXUINT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPlayBin:video-cache-bytes:
+   *
+   * The maximum size in bytes of the decoded video frames to keep for
+   * seeks. See #GstPlayBin:video-cache-frames.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass, PROP_VIDEO_CACHE_BYTES,
+      g_param_spec_uint64 ("video-cache-bytes", "Video cache bytes",
+          "Maximum size of the decoded video frames to keep for seeks "
+          "(0 = no limit)", 0, G_MAXUINT64, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstPlayBin::about-to-finish
    * @playbin: a #GstPlayBin
@@ -1298,6 +1418,48 @@ gst_play_bin_class_init (GstPlayBinClass * klass)
       G_STRUCT_OFFSET (GstPlayBinClass, get_text_pad), NULL, NULL,
       g_cclosure_marshal_generic, GST_TYPE_PAD, 1, G_TYPE_INT);
 
+  /**
+   * GstPlayBin::add-extra-video-sink
+   * @playbin: a #GstPlayBin
+   * @sink: a video sink
+   *
+   * Action signal to add an extra sink for the decoded video, for example an
+   * appsink for analysis next to the video sink. The buffers are shared
+   * with the video sink. The extra sinks are grouped by the caps they
+   * accept and the video is converted once for each group, or not at all
+   * when they accept the format of the video sink.
+   *
+   * The sink is used when the video output is set up the next time, this
+   * should be done in the NULL or READY state. Extra sinks are not used for
+   * video that is not decoded.
+   *
+   * Returns: %TRUE when the sink was added.
+   *
+   * Since: 1.10
+   */
+  gst_play_bin_signals[SIGNAL_ADD_EXTRA_VIDEO_SINK] =
+      g_signal_new ("add-extra-video-sink", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstPlayBinClass, add_extra_video_sink), NULL, NULL,
+      g_cclosure_marshal_generic, G_TYPE_BOOLEAN, 1, GST_TYPE_ELEMENT);
+  /**
+   * GstPlayBin::remove-extra-video-sink
+   * @playbin: a #GstPlayBin
+   * @sink: a video sink
+   *
+   * Action signal to remove a sink that was added with
+   * #GstPlayBin::add-extra-video-sink.
+   *
+   * Returns: %TRUE when the sink was removed.
+   *
+   * Since: 1.10
+   */
+  gst_play_bin_signals[SIGNAL_REMOVE_EXTRA_VIDEO_SINK] =
+      g_signal_new ("remove-extra-video-sink", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstPlayBinClass, remove_extra_video_sink), NULL, NULL,
+      g_cclosure_marshal_generic, G_TYPE_BOOLEAN, 1, GST_TYPE_ELEMENT);
+
   klass->get_video_tags = gst_play_bin_get_video_tags;
   klass->get_audio_tags = gst_play_bin_get_audio_tags;
   klass->get_text_tags = gst_play_bin_get_text_tags;
@@ -1308,6 +1470,9 @@ gst_play_bin_class_init (GstPlayBinClass * klass)
   klass->get_audio_pad = gst_play_bin_get_audio_pad;
   klass->get_text_pad = gst_play_bin_get_text_pad;
 
+  klass->add_extra_video_sink = gst_play_bin_add_extra_video_sink;
+  klass->remove_extra_video_sink = gst_play_bin_remove_extra_video_sink;
+
   gst_element_class_set_static_metadata (gstelement_klass,
       "Player Bin 2", "Generic/Bin/Player",
       "Autoplug and play media from an uri",
@@ -1558,6 +1723,9 @@ gst_play_bin_init (GstPlayBin * playbin)
   playbin->buffer_duration = DEFAULT_BUFFER_DURATION;
   playbin->buffer_size = DEFAULT_BUFFER_SIZE;
   playbin->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
+  playbin->lookahead = DEFAULT_LOOKAHEAD;
+  playbin->lookahead_buffer_size = DEFAULT_LOOKAHEAD_BUFFER_SIZE;
+  playbin->lookahead_buffer_duration = DEFAULT_LOOKAHEAD_BUFFER_DURATION;
 
   playbin->force_aspect_ratio = TRUE;
 
@@ -1873,6 +2041,22 @@ gst_play_bin_convert_sample (GstPlayBin * playbin, GstCaps * caps)
   return gst_play_sink_convert_sample (playbin->playsink, caps);
 }
 
+static gboolean
+gst_play_bin_add_extra_video_sink (GstPlayBin * playbin, GstElement * sink)
+{
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
+
+  return gst_play_sink_add_extra_video_sink (playbin->playsink, sink);
+}
+
+static gboolean
+gst_play_bin_remove_extra_video_sink (GstPlayBin * playbin, GstElement * sink)
+{
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
+
+  return gst_play_sink_remove_extra_video_sink (playbin->playsink, sink);
+}
+
 /* Returns current stream number, or -1 if none has been selected yet */
 static int
 get_current_stream_number (GstPlayBin * playbin, GstSourceCombine * combine,
@@ -2488,6 +2672,37 @@ gst_play_bin_set_property (GObject * object, guint prop_id,
       playbin->multiview_flags = g_value_get_flags (value);
       GST_PLAY_BIN_UNLOCK (playbin);
       break;
+    case PROP_LOOKAHEAD:
+      GST_OBJECT_LOCK (playbin);
+      playbin->lookahead = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
+    case PROP_LOOKAHEAD_BUFFER_SIZE:
+      GST_OBJECT_LOCK (playbin);
+      playbin->lookahead_buffer_size = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
+    case PROP_LOOKAHEAD_BUFFER_DURATION:
+      GST_OBJECT_LOCK (playbin);
+      playbin->lookahead_buffer_duration = g_value_get_int64 (value);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
+    case PROP_VIDEO_CACHE_FRAMES:{
+      guint64 max_bytes;
+
+      gst_play_sink_get_video_cache (playbin->playsink, NULL, &max_bytes);
+      gst_play_sink_set_video_cache (playbin->playsink,
+          g_value_get_uint (value), max_bytes);
+      break;
+    }
+    case PROP_VIDEO_CACHE_BYTES:{
+      guint max_frames;
+
+      gst_play_sink_get_video_cache (playbin->playsink, &max_frames, NULL);
+      gst_play_sink_set_video_cache (playbin->playsink, max_frames,
+          g_value_get_uint64 (value));
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2741,6 +2956,35 @@ gst_play_bin_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_flags (value, playbin->multiview_flags);
       GST_OBJECT_UNLOCK (playbin);
       break;
+    case PROP_LOOKAHEAD:
+      GST_OBJECT_LOCK (playbin);
+      g_value_set_uint64 (value, playbin->lookahead);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
+    case PROP_LOOKAHEAD_BUFFER_SIZE:
+      GST_OBJECT_LOCK (playbin);
+      g_value_set_int (value, playbin->lookahead_buffer_size);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
+    case PROP_LOOKAHEAD_BUFFER_DURATION:
+      GST_OBJECT_LOCK (playbin);
+      g_value_set_int64 (value, playbin->lookahead_buffer_duration);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
+    case PROP_VIDEO_CACHE_FRAMES:{
+      guint max_frames;
+
+      gst_play_sink_get_video_cache (playbin->playsink, &max_frames, NULL);
+      g_value_set_uint (value, max_frames);
+      break;
+    }
+    case PROP_VIDEO_CACHE_BYTES:{
+      guint64 max_bytes;
+
+      gst_play_sink_get_video_cache (playbin->playsink, NULL, &max_bytes);
+      g_value_set_uint64 (value, max_bytes);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3275,6 +3519,114 @@ notify_tags_cb (GObject * object, GParamSpec * pspec, gpointer user_data)
         ntdata->stream_id);
 }
 
+/* The combiner only forwards the active stream, decoding the others is
+ * wasted. For audio and subtitles their buffers are dropped in front of the
+ * decoder while their combiner pad isn't the active one, headers and events
+ * still pass so the decoder stays configured. When the stream becomes active
+ * the decoder restarts at the next keyframe with a discont. */
+typedef struct
+{
+  GstPad *sinkpad;              /* the combiner sinkpad of the stream */
+  gboolean dropping;
+} InactiveStreamData;
+
+static void
+inactive_stream_data_free (InactiveStreamData * data)
+{
+  gst_object_unref (data->sinkpad);
+  g_slice_free (InactiveStreamData, data);
+}
+
+static GstPadProbeReturn
+inactive_stream_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    InactiveStreamData * data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstObject *combiner;
+  GstPad *active = NULL;
+
+  if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_HEADER))
+    return GST_PAD_PROBE_OK;
+
+  /* no parent when the pad was released */
+  if ((combiner = gst_pad_get_parent (data->sinkpad))) {
+    g_object_get (combiner, "active-pad", &active, NULL);
+    gst_object_unref (combiner);
+  }
+
+  /* without an active pad the combiner will pick one of the streams */
+  if (active != NULL && active != data->sinkpad) {
+    gst_object_unref (active);
+    if (!data->dropping)
+      GST_DEBUG_OBJECT (pad, "stream inactive, not decoding");
+    data->dropping = TRUE;
+    return GST_PAD_PROBE_DROP;
+  }
+  if (active)
+    gst_object_unref (active);
+
+  if (data->dropping) {
+    if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+      return GST_PAD_PROBE_DROP;
+
+    GST_DEBUG_OBJECT (pad, "stream active again, decoding from %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_PTS (buffer)));
+    data->dropping = FALSE;
+    buffer = gst_buffer_make_writable (buffer);
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+    GST_PAD_PROBE_INFO_DATA (info) = buffer;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* find the decoder that feeds the decodebin @pad and drop its input while
+ * @sinkpad isn't the active pad of the combiner */
+static void
+add_inactive_stream_probe (GstPlayBin * playbin, GstPad * pad,
+    GstPad * sinkpad)
+{
+  GstElement *element;
+  GstElementFactory *factory;
+  GstPad *target, *decpad;
+  InactiveStreamData *data;
+
+  target = gst_object_ref (pad);
+  while (GST_IS_GHOST_PAD (target)) {
+    GstPad *next = gst_ghost_pad_get_target (GST_GHOST_PAD_CAST (target));
+
+    gst_object_unref (target);
+    if (next == NULL)
+      return;
+    target = next;
+  }
+
+  element = gst_pad_get_parent_element (target);
+  gst_object_unref (target);
+  if (element == NULL)
+    return;
+
+  factory = gst_element_get_factory (element);
+  if (factory == NULL || !gst_element_factory_list_is_type (factory,
+          GST_ELEMENT_FACTORY_TYPE_DECODER) ||
+      !(decpad = gst_element_get_static_pad (element, "sink"))) {
+    gst_object_unref (element);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (playbin, "not decoding inactive input of %s",
+      GST_ELEMENT_NAME (element));
+
+  data = g_slice_new0 (InactiveStreamData);
+  data->sinkpad = gst_object_ref (sinkpad);
+  gst_pad_add_probe (decpad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) inactive_stream_probe_cb, data,
+      (GDestroyNotify) inactive_stream_data_free);
+
+  gst_object_unref (decpad);
+  gst_object_unref (element);
+}
+
 /* this function is called when a new pad is added to decodebin. We check the
  * type of the pad and add it to the combiner element of the group.
  */
@@ -3480,6 +3832,12 @@ pad_added_cb (GstElement * decodebin, GstPad * pad, GstSourceGroup * group)
   g_object_set_data (G_OBJECT (pad), "playbin.event_probe_id",
       ULONG_TO_POINTER (group_id_probe_handler));
 
+  GST_OBJECT_LOCK (playbin);
+  if (playbin->lookahead > 0 && decodebin == group->uridecodebin)
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) lookahead_probe_cb, group, NULL);
+  GST_OBJECT_UNLOCK (playbin);
+
   if (changed) {
     int signal;
 
@@ -3509,6 +3867,9 @@ pad_added_cb (GstElement * decodebin, GstPad * pad, GstSourceGroup * group)
         gboolean always_ok = (decodebin == group->suburidecodebin);
         g_object_set (sinkpad, "always-ok", always_ok, NULL);
       }
+      if (signal != SIGNAL_VIDEO_CHANGED && combine->has_active_pad &&
+          decodebin == group->uridecodebin)
+        add_inactive_stream_probe (playbin, pad, sinkpad);
       g_signal_emit (G_OBJECT (playbin), gst_play_bin_signals[signal], 0, NULL);
     }
   }
@@ -3679,6 +4040,19 @@ no_more_pads_cb (GstElement * decodebin, GstSourceGroup * group)
   GST_PLAY_BIN_SHUTDOWN_LOCK (playbin, shutdown);
 
   GST_SOURCE_GROUP_LOCK (group);
+  if (group->prebuffering) {
+    /* the sinks are still used by the current group, keep the combiners
+     * blocked and link them in setup_next_source() */
+    GST_DEBUG_OBJECT (playbin, "group %p is prebuffering, not linking yet",
+        group);
+    if (group->pending > 0)
+      group->pending--;
+    if (group->suburidecodebin == decodebin)
+      group->sub_pending = FALSE;
+    GST_SOURCE_GROUP_UNLOCK (group);
+    GST_PLAY_BIN_SHUTDOWN_UNLOCK (playbin);
+    return;
+  }
   for (i = 0; i < PLAYBIN_STREAM_LAST; i++) {
     GstSourceCombine *combine = &group->combiner[i];
 
@@ -3821,6 +4195,99 @@ shutdown:
   }
 }
 
+/* emit about-to-finish for @group and activate the next group while @group
+ * is still playing */
+static void
+prebuffer_next_group (GstPlayBin * playbin, GstSourceGroup * group)
+{
+  GstSourceGroup *next_group;
+
+  GST_DEBUG_OBJECT (playbin, "about to finish in group %p (lookahead)", group);
+
+  g_signal_emit (G_OBJECT (playbin),
+      gst_play_bin_signals[SIGNAL_ABOUT_TO_FINISH], 0, NULL);
+
+  if (g_atomic_int_get (&playbin->shutdown))
+    return;
+
+  GST_PLAY_BIN_LOCK (playbin);
+  next_group = playbin->next_group;
+  if (playbin->curr_group == group && next_group && next_group->valid
+      && !next_group->active) {
+    GST_DEBUG_OBJECT (playbin, "prebuffering group %p", next_group);
+    next_group->prebuffering = TRUE;
+    if (activate_group (playbin, next_group,
+            GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+      /* try again the normal way when drained */
+      GST_DEBUG_OBJECT (playbin, "failed to prebuffer group %p", next_group);
+      next_group->prebuffering = FALSE;
+    }
+  }
+  GST_PLAY_BIN_UNLOCK (playbin);
+}
+
+static GstPadProbeReturn
+lookahead_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    GstSourceGroup * group)
+{
+  GstPlayBin *playbin = group->playbin;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstEvent *event;
+  const GstSegment *segment;
+  GstClockTime position, lookahead;
+
+  if (g_atomic_int_get (&group->about_to_finish_emitted))
+    return GST_PAD_PROBE_REMOVE;
+
+  if (group->prebuffering || !GST_BUFFER_PTS_IS_VALID (buffer))
+    return GST_PAD_PROBE_OK;
+
+  event = gst_pad_get_sticky_event (pad, GST_EVENT_SEGMENT, 0);
+  if (!event)
+    return GST_PAD_PROBE_OK;
+  gst_event_parse_segment (event, &segment);
+  if (segment->format == GST_FORMAT_TIME && segment->rate > 0.0)
+    position =
+        gst_segment_to_stream_time (segment, GST_FORMAT_TIME,
+        GST_BUFFER_PTS (buffer));
+  else
+    position = GST_CLOCK_TIME_NONE;
+  gst_event_unref (event);
+
+  if (!GST_CLOCK_TIME_IS_VALID (position))
+    return GST_PAD_PROBE_OK;
+
+  /* don't query the duration for every buffer, once per second is enough */
+  if (position >= group->lookahead_next_query) {
+    if (!gst_element_query_duration (group->uridecodebin, GST_FORMAT_TIME,
+            &group->lookahead_duration))
+      group->lookahead_duration = -1;
+    group->lookahead_next_query = position + GST_SECOND;
+  }
+
+  GST_OBJECT_LOCK (playbin);
+  lookahead = playbin->lookahead;
+  GST_OBJECT_UNLOCK (playbin);
+
+  if (lookahead == 0 || group->lookahead_duration <= 0
+      || position + lookahead < group->lookahead_duration)
+    return GST_PAD_PROBE_OK;
+
+  /* only one of the pads does it */
+  if (!g_atomic_int_compare_and_exchange (&group->about_to_finish_emitted,
+          FALSE, TRUE))
+    return GST_PAD_PROBE_REMOVE;
+
+  GST_DEBUG_OBJECT (pad, "position %" GST_TIME_FORMAT " is within %"
+      GST_TIME_FORMAT " of the duration %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (position), GST_TIME_ARGS (lookahead),
+      GST_TIME_ARGS (group->lookahead_duration));
+
+  prebuffer_next_group (playbin, group);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
 static void
 drained_cb (GstElement * decodebin, GstSourceGroup * group)
 {
@@ -3828,11 +4295,20 @@ drained_cb (GstElement * decodebin, GstSourceGroup * group)
 
   playbin = group->playbin;
 
+  if (group->prebuffering) {
+    GST_DEBUG_OBJECT (playbin, "ignoring drained of prebuffering group %p",
+        group);
+    return;
+  }
+
   GST_DEBUG_OBJECT (playbin, "about to finish in group %p", group);
 
-  /* after this call, we should have a next group to activate or we EOS */
-  g_signal_emit (G_OBJECT (playbin),
-      gst_play_bin_signals[SIGNAL_ABOUT_TO_FINISH], 0, NULL);
+  /* after this call, we should have a next group to activate or we EOS. With
+   * a lookahead this was already done before */
+  if (!g_atomic_int_compare_and_exchange (&group->about_to_finish_emitted,
+          TRUE, FALSE))
+    g_signal_emit (G_OBJECT (playbin),
+        gst_play_bin_signals[SIGNAL_ABOUT_TO_FINISH], 0, NULL);
 
   /* now activate the next group. If the app did not set a uri, this will
    * fail and we can do EOS */
@@ -5168,6 +5644,8 @@ activate_group (GstPlayBin * playbin, GstSourceGroup * group, GstState target)
   gboolean video_sink_activated = FALSE;
   gboolean text_sink_activated = FALSE;
   GstStateChangeReturn state_ret;
+  gint64 buffer_duration;
+  gint buffer_size;
 
   g_return_val_if_fail (group->valid, GST_STATE_CHANGE_FAILURE);
   g_return_val_if_fail (!group->active, GST_STATE_CHANGE_FAILURE);
@@ -5252,6 +5730,21 @@ activate_group (GstPlayBin * playbin, GstSourceGroup * group, GstState target)
 
   flags = gst_play_sink_get_flags (playbin->playsink);
 
+  group->about_to_finish_emitted = FALSE;
+  group->lookahead_duration = -1;
+  group->lookahead_next_query = 0;
+
+  GST_OBJECT_LOCK (playbin);
+  buffer_duration = playbin->buffer_duration;
+  buffer_size = playbin->buffer_size;
+  if (group->prebuffering) {
+    if (playbin->lookahead_buffer_duration != -1)
+      buffer_duration = playbin->lookahead_buffer_duration;
+    if (playbin->lookahead_buffer_size != -1)
+      buffer_size = playbin->lookahead_buffer_size;
+  }
+  GST_OBJECT_UNLOCK (playbin);
+
   g_object_set (uridecodebin,
       /* configure connection speed */
       "connection-speed", playbin->connection_speed / 1000,
@@ -5261,9 +5754,11 @@ activate_group (GstPlayBin * playbin, GstSourceGroup * group, GstState target)
       "download", ((flags & GST_PLAY_FLAG_DOWNLOAD) != 0),
       /* configure buffering of demuxed/parsed data */
       "use-buffering", ((flags & GST_PLAY_FLAG_BUFFERING) != 0),
+      /* keep the decoders for the next uri */
+      "reuse-decoders", ((flags & GST_PLAY_FLAG_REUSE_DECODERS) != 0),
       /* configure buffering parameters */
-      "buffer-duration", playbin->buffer_duration,
-      "buffer-size", playbin->buffer_size,
+      "buffer-duration", buffer_duration,
+      "buffer-size", buffer_size,
       "ring-buffer-max-size", playbin->ring_buffer_max_size, NULL);
 
   /* connect pads and other things */
@@ -5601,11 +6096,34 @@ setup_next_source (GstPlayBin * playbin, GstState target)
   playbin->curr_group = new_group;
   playbin->next_group = old_group;
 
-  /* activate the new group */
-  if ((state_ret =
+  if (new_group->active) {
+    gboolean complete;
+
+    /* prebuffered with the lookahead, link it to the sinks now or when the
+     * last no-more-pads arrives */
+    GST_DEBUG_OBJECT (playbin, "switching to prebuffered group %p", new_group);
+    GST_SOURCE_GROUP_LOCK (new_group);
+    new_group->prebuffering = FALSE;
+    complete = (new_group->pending == 0);
+    if (complete)
+      new_group->pending = 1;
+    GST_SOURCE_GROUP_UNLOCK (new_group);
+
+    if (complete)
+      no_more_pads_cb (new_group->uridecodebin, new_group);
+
+    /* it was only prerolled */
+    if (new_group->suburidecodebin)
+      gst_element_set_state (new_group->suburidecodebin, target);
+    state_ret = gst_element_set_state (new_group->uridecodebin, target);
+    if (state_ret == GST_STATE_CHANGE_FAILURE)
+      goto activate_failed;
+  } else if ((state_ret =
           activate_group (playbin, new_group,
-              target)) == GST_STATE_CHANGE_FAILURE)
+              target)) == GST_STATE_CHANGE_FAILURE) {
+    /* activate the new group */
     goto activate_failed;
+  }
 
   GST_PLAY_BIN_UNLOCK (playbin);
 
@@ -5636,7 +6154,7 @@ activate_failed:
 static gboolean
 save_current_group (GstPlayBin * playbin)
 {
-  GstSourceGroup *curr_group;
+  GstSourceGroup *curr_group, *next_group;
 
   GST_DEBUG_OBJECT (playbin, "save current group");
 
@@ -5647,6 +6165,18 @@ save_current_group (GstPlayBin * playbin)
     /* unlink our pads with the sink */
     deactivate_group (playbin, curr_group);
   }
+  /* a group that was prebuffered with the lookahead is set up again when
+   * it is needed */
+  next_group = playbin->next_group;
+  if (next_group && next_group->valid && next_group->active) {
+    GST_DEBUG_OBJECT (playbin, "dropping prebuffered group %p", next_group);
+    next_group->prebuffering = FALSE;
+    deactivate_group (playbin, next_group);
+    if (next_group->uridecodebin)
+      gst_element_set_state (next_group->uridecodebin, GST_STATE_READY);
+    if (next_group->suburidecodebin)
+      gst_element_set_state (next_group->suburidecodebin, GST_STATE_READY);
+  }
   /* swap old and new */
   playbin->curr_group = playbin->next_group;
   playbin->next_group = curr_group;
@@ -36,6 +36,8 @@
 #include "gstplaysink.h"
 #include "gststreamsynchronizer.h"
 #include "gstplaysinkvideoconvert.h"
+#include "gstplaysinkvideofanout.h"
+#include "gstplaysinkvideocache.h"
 #include "gstplaysinkaudioconvert.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_play_sink_debug);
@@ -125,7 +127,10 @@ typedef struct
   GstElement *queue;
   GstElement *filter_conv;
   GstElement *filter;
+  GstElement *cache;            /* decoded frames to show on seeks */
   GstElement *conv;
+  GstElement *fanout;           /* for the extra video sinks */
+  guint extra_sinks_cookie;
   GstElement *sink;
   gboolean async;
   GstElement *ts_offset;
@@ -246,6 +251,8 @@ struct _GstPlaySink
   GstElement *video_filter;
   GstElement *visualisation;
   GstElement *text_sink;
+  GList *extra_video_sinks;     /* share the decoded video with these */
+  guint extra_video_sinks_cookie;
   gdouble volume;
   gboolean mute;
   gchar *font_desc;             /* font description */
@@ -257,6 +264,16 @@ struct _GstPlaySink
   gint64 av_offset;
   GstPlaySinkSendEventMode send_event_mode;
   gboolean force_aspect_ratio;
+  guint video_cache_frames;     /* the video cache is used when one of */
+  guint64 video_cache_bytes;    /* these is not 0 */
+
+  /* the seek that was last shown from the video cache while upstream stays
+   * where it was, protected with the object LOCK */
+  GstEvent *scrub_seek;
+  GstClockTime scrub_position;
+  /* does the seek to the cached position after going to PLAYING, only used
+   * from the state change */
+  GThreadPool *scrub_pool;
 
   /* videooverlay proxy interface */
   GstVideoOverlay *overlay_element;     /* protected with LOCK */
@@ -346,7 +363,9 @@ enum
   PROP_SEND_EVENT_MODE,
   PROP_FORCE_ASPECT_RATIO,
   PROP_VIDEO_FILTER,
-  PROP_AUDIO_FILTER
+  PROP_AUDIO_FILTER,
+  PROP_VIDEO_CACHE_FRAMES,
+  PROP_VIDEO_CACHE_BYTES
 };
 
 /* signals */
@@ -366,6 +385,7 @@ static GstPad *gst_play_sink_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
 static void gst_play_sink_release_request_pad (GstElement * element,
     GstPad * pad);
+static gboolean gst_play_sink_query (GstElement * element, GstQuery * query);
 static gboolean gst_play_sink_send_event (GstElement * element,
     GstEvent * event);
 static GstStateChangeReturn gst_play_sink_change_state (GstElement * element,
@@ -396,6 +416,7 @@ static void notify_mute_cb (GObject * object, GParamSpec * pspec,
 static void update_av_offset (GstPlaySink * playsink);
 
 static gboolean gst_play_sink_do_reconfigure (GstPlaySink * playsink);
+static void gst_play_sink_stop_scrub (GstPlaySink * playsink);
 
 static GQuark _playsink_reset_segment_event_marker_id = 0;
 
@@ -596,6 +617,31 @@ gst_play_sink_class_init (GstPlaySinkClass * klass)
           "When enabled, scaling will respect original aspect ratio", TRUE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPlaySink:video-cache-frames:
+   *
+   * The maximum number of decoded video frames to keep so that accurate
+   * flushing seeks to them in the PAUSED state are shown without decoding.
+   * The cache is used when this or #GstPlaySink:video-cache-bytes is not 0,
+   * a limit of 0 is not applied.
+   */
+  g_object_class_install_property (gobject_klass, PROP_VIDEO_CACHE_FRAMES,
+      g_param_spec_uint ("video-cache-frames", "Video cache frames",
+          "Maximum number of decoded video frames to keep for seeks "
+          "(0 = no limit)", 0, G_MAXUINT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstPlaySink:video-cache-bytes:
+   *
+   * The maximum size in bytes of the decoded video frames to keep for
+   * seeks. See #GstPlaySink:video-cache-frames.
+   */
+  g_object_class_install_property (gobject_klass, PROP_VIDEO_CACHE_BYTES,
+      g_param_spec_uint64 ("video-cache-bytes", "Video cache bytes",
+          "Maximum size of the decoded video frames to keep for seeks "
+          "(0 = no limit)", 0, G_MAXUINT64, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   g_signal_new ("reconfigure", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstPlaySinkClass,
           reconfigure), NULL, NULL, g_cclosure_marshal_generic, G_TYPE_BOOLEAN,
@@ -635,6 +681,7 @@ gst_play_sink_class_init (GstPlaySinkClass * klass)
   gstelement_klass->change_state =
       GST_DEBUG_FUNCPTR (gst_play_sink_change_state);
   gstelement_klass->send_event = GST_DEBUG_FUNCPTR (gst_play_sink_send_event);
+  gstelement_klass->query = GST_DEBUG_FUNCPTR (gst_play_sink_query);
   gstelement_klass->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_play_sink_request_new_pad);
   gstelement_klass->release_pad =
@@ -669,6 +716,7 @@ gst_play_sink_init (GstPlaySink * playsink)
   playsink->flags = DEFAULT_FLAGS;
   playsink->send_event_mode = MODE_DEFAULT;
   playsink->force_aspect_ratio = TRUE;
+  playsink->scrub_position = GST_CLOCK_TIME_NONE;
 
   playsink->stream_synchronizer =
       g_object_new (GST_TYPE_STREAM_SYNCHRONIZER, NULL);
@@ -760,6 +808,8 @@ gst_play_sink_dispose (GObject * object)
 
   playsink = GST_PLAY_SINK (object);
 
+  gst_play_sink_stop_scrub (playsink);
+
   if (playsink->audio_filter != NULL) {
     gst_element_set_state (playsink->audio_filter, GST_STATE_NULL);
     gst_object_unref (playsink->audio_filter);
@@ -780,6 +830,15 @@ gst_play_sink_dispose (GObject * object)
     gst_object_unref (playsink->video_sink);
     playsink->video_sink = NULL;
   }
+  while (playsink->extra_video_sinks) {
+    GstElement *sink = playsink->extra_video_sinks->data;
+
+    gst_element_set_state (sink, GST_STATE_NULL);
+    gst_object_unref (sink);
+    playsink->extra_video_sinks =
+        g_list_delete_link (playsink->extra_video_sinks,
+        playsink->extra_video_sinks);
+  }
   if (playsink->visualisation != NULL) {
     gst_element_set_state (playsink->visualisation, GST_STATE_NULL);
     gst_object_unref (playsink->visualisation);
@@ -938,6 +997,55 @@ gst_play_sink_get_sink (GstPlaySink * playsink, GstPlaySinkType type)
   return result;
 }
 
+/* Add @sink as an extra video sink. The decoded video is shared with it, it
+ * is used when the video chain is created the next time. */
+gboolean
+gst_play_sink_add_extra_video_sink (GstPlaySink * playsink, GstElement * sink)
+{
+  gboolean res = FALSE;
+
+  GST_LOG_OBJECT (playsink, "Adding extra video sink %" GST_PTR_FORMAT, sink);
+
+  GST_PLAY_SINK_LOCK (playsink);
+  if (!g_list_find (playsink->extra_video_sinks, sink)) {
+    playsink->extra_video_sinks =
+        g_list_append (playsink->extra_video_sinks, gst_object_ref_sink (sink));
+    playsink->extra_video_sinks_cookie++;
+    res = TRUE;
+  }
+  GST_PLAY_SINK_UNLOCK (playsink);
+
+  return res;
+}
+
+gboolean
+gst_play_sink_remove_extra_video_sink (GstPlaySink * playsink,
+    GstElement * sink)
+{
+  GList *link;
+
+  GST_LOG_OBJECT (playsink, "Removing extra video sink %" GST_PTR_FORMAT,
+      sink);
+
+  GST_PLAY_SINK_LOCK (playsink);
+  if ((link = g_list_find (playsink->extra_video_sinks, sink))) {
+    playsink->extra_video_sinks =
+        g_list_delete_link (playsink->extra_video_sinks, link);
+    playsink->extra_video_sinks_cookie++;
+  }
+  GST_PLAY_SINK_UNLOCK (playsink);
+
+  if (!link)
+    return FALSE;
+
+  /* Set it to NULL if it is not used any longer */
+  if (!GST_OBJECT_PARENT (sink))
+    gst_element_set_state (sink, GST_STATE_NULL);
+  gst_object_unref (sink);
+
+  return TRUE;
+}
+
 void
 gst_play_sink_set_filter (GstPlaySink * playsink, GstPlaySinkType type,
     GstElement * filter)
@@ -1864,6 +1972,27 @@ gen_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
   } else {
     g_object_set (G_OBJECT (chain->queue), "max-size-buffers", 3,
         "max-size-bytes", 0, "max-size-time", (gint64) 0, "silent", TRUE, NULL);
+
+    /* the cache shows frames again by pushing them into the queue, which
+     * doesn't block like the sink */
+    if (raw && (playsink->video_cache_frames || playsink->video_cache_bytes)) {
+      GST_DEBUG_OBJECT (playsink, "creating video cache");
+      chain->cache = g_object_new (GST_TYPE_PLAY_SINK_VIDEO_CACHE,
+          "name", "vcache", NULL);
+      gst_play_sink_video_cache_set_limits (GST_PLAY_SINK_VIDEO_CACHE
+          (chain->cache), playsink->video_cache_frames,
+          playsink->video_cache_bytes);
+      gst_bin_add (bin, chain->cache);
+      if (prev) {
+        if (!gst_element_link_pads_full (prev, "src", chain->cache, "sink",
+                GST_PAD_LINK_CHECK_TEMPLATE_CAPS))
+          goto link_failed;
+      } else {
+        head = chain->cache;
+      }
+      prev = chain->cache;
+    }
+
     gst_bin_add (bin, chain->queue);
     if (prev) {
       if (!gst_element_link_pads_full (prev, "src", chain->queue, "sink",
@@ -1926,6 +2055,45 @@ gen_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
 
   update_colorbalance (playsink);
 
+  /* the extra sinks get the same buffers as the video sink, converted once per
+   * distinct format they need */
+  chain->extra_sinks_cookie = playsink->extra_video_sinks_cookie;
+  if (playsink->extra_video_sinks && raw) {
+    GList *l;
+
+    GST_DEBUG_OBJECT (playsink, "creating video fanout");
+    chain->fanout = g_object_new (GST_TYPE_PLAY_SINK_VIDEO_FANOUT,
+        "name", "vfanout", NULL);
+    gst_bin_add (bin, chain->fanout);
+
+    for (l = playsink->extra_video_sinks; l; l = l->next) {
+      GstElement *sink = l->data;
+
+      /* still in the old chain, will be picked up at the next rebuild */
+      if (GST_OBJECT_PARENT (sink))
+        continue;
+
+      if (!gst_play_sink_video_fanout_add_sink (GST_PLAY_SINK_VIDEO_FANOUT
+              (chain->fanout), sink))
+        GST_ELEMENT_WARNING (playsink, CORE, PAD, (NULL),
+            ("Failed to add extra video sink %s", GST_ELEMENT_NAME (sink)));
+    }
+    if (!gst_play_sink_video_fanout_finish (GST_PLAY_SINK_VIDEO_FANOUT
+            (chain->fanout)))
+      goto link_failed;
+
+    if (prev) {
+      if (!gst_element_link_pads_full (prev, "src", chain->fanout, "sink",
+              GST_PAD_LINK_CHECK_TEMPLATE_CAPS))
+        goto link_failed;
+    } else {
+      head = chain->fanout;
+    }
+    prev = chain->fanout;
+  } else if (playsink->extra_video_sinks) {
+    GST_DEBUG_OBJECT (playsink, "not using extra video sinks for non-raw video");
+  }
+
   if (prev) {
     GST_DEBUG_OBJECT (playsink, "linking to sink");
     if (!gst_element_link_pads_full (prev, "src", chain->sink, NULL,
@@ -2016,6 +2184,16 @@ setup_video_chain (GstPlaySink * playsink, gboolean raw, gboolean async)
   if (chain->filter && chain->chain.raw != raw)
     return FALSE;
 
+  /* same for the extra video sinks, also when they changed */
+  if ((chain->fanout && chain->chain.raw != raw) ||
+      chain->extra_sinks_cookie != playsink->extra_video_sinks_cookie)
+    return FALSE;
+
+  /* and for the video cache when it was enabled or disabled */
+  if ((chain->cache != NULL) != (raw && chain->queue &&
+          (playsink->video_cache_frames || playsink->video_cache_bytes)))
+    return FALSE;
+
   chain->chain.raw = raw;
 
   /* if the chain was active we don't do anything */
@@ -3242,8 +3420,9 @@ gst_play_sink_do_reconfigure (GstPlaySink * playsink)
     /* we need a raw sink when we do vis or when we have a raw pad */
     raw = need_vis ? TRUE : playsink->video_pad_raw;
     /* we try to set the sink async=FALSE when we need vis, this way we can
-     * avoid a queue in the audio chain. */
-    async = !need_vis;
+     * avoid a queue in the audio chain. With fast-start we only wait for the
+     * audio to preroll and show the video as soon as it is decoded. */
+    async = !need_vis && !(need_audio && (flags & GST_PLAY_FLAG_FAST_START));
 
     GST_DEBUG_OBJECT (playsink, "adding video, raw %d",
         playsink->video_pad_raw);
@@ -3855,6 +4034,9 @@ gst_play_sink_set_flags (GstPlaySink * playsink, GstPlayFlags flags)
   playsink->flags = flags;
   GST_OBJECT_UNLOCK (playsink);
 
+  g_object_set (playsink->stream_synchronizer, "fast-start",
+      ! !(flags & GST_PLAY_FLAG_FAST_START), NULL);
+
   return TRUE;
 }
 
@@ -3992,6 +4174,33 @@ gst_play_sink_get_av_offset (GstPlaySink * playsink)
   return result;
 }
 
+void
+gst_play_sink_set_video_cache (GstPlaySink * playsink, guint max_frames,
+    guint64 max_bytes)
+{
+  GST_PLAY_SINK_LOCK (playsink);
+  playsink->video_cache_frames = max_frames;
+  playsink->video_cache_bytes = max_bytes;
+  /* enabling or disabling the cache is done when the video chain is set up
+   * the next time */
+  if (playsink->videochain && playsink->videochain->cache)
+    gst_play_sink_video_cache_set_limits (GST_PLAY_SINK_VIDEO_CACHE
+        (playsink->videochain->cache), max_frames, max_bytes);
+  GST_PLAY_SINK_UNLOCK (playsink);
+}
+
+void
+gst_play_sink_get_video_cache (GstPlaySink * playsink, guint * max_frames,
+    guint64 * max_bytes)
+{
+  GST_PLAY_SINK_LOCK (playsink);
+  if (max_frames)
+    *max_frames = playsink->video_cache_frames;
+  if (max_bytes)
+    *max_bytes = playsink->video_cache_bytes;
+  GST_PLAY_SINK_UNLOCK (playsink);
+}
+
 /**
  * gst_play_sink_get_last_sample:
  * @playsink: a #GstPlaySink
@@ -4743,6 +4952,170 @@ done:
   return res;
 }
 
+/* Show the frame at the position of the seek from the video cache, only when
+ * paused as upstream doesn't move. Takes ownership of @event when the seek was
+ * served. */
+static gboolean
+gst_play_sink_seek_video_cache (GstPlaySink * playsink, GstEvent * event)
+{
+  GstElement *cache = NULL;
+  gboolean paused, res;
+  gint64 start;
+
+  GST_OBJECT_LOCK (playsink);
+  paused = GST_STATE (playsink) == GST_STATE_PAUSED &&
+      GST_STATE_TARGET (playsink) == GST_STATE_PAUSED;
+  GST_OBJECT_UNLOCK (playsink);
+  if (!paused)
+    return FALSE;
+
+  GST_PLAY_SINK_LOCK (playsink);
+  if (playsink->videochain && playsink->videochain->cache &&
+      playsink->videochain->chain.activated)
+    cache = gst_object_ref (playsink->videochain->cache);
+  GST_PLAY_SINK_UNLOCK (playsink);
+  if (!cache)
+    return FALSE;
+
+  res = gst_play_sink_video_cache_seek (GST_PLAY_SINK_VIDEO_CACHE (cache),
+      event);
+  gst_object_unref (cache);
+
+  if (res) {
+    GST_DEBUG_OBJECT (playsink, "seek was served from the video cache");
+    gst_event_parse_seek (event, NULL, NULL, NULL, NULL, &start, NULL, NULL);
+    GST_OBJECT_LOCK (playsink);
+    gst_event_replace (&playsink->scrub_seek, event);
+    playsink->scrub_position = start;
+    GST_OBJECT_UNLOCK (playsink);
+    gst_event_unref (event);
+  }
+
+  return res;
+}
+
+/* Send a seek upstream. After seeks served from the video cache upstream is
+ * still at the old position, waiting to be flushed. */
+static gboolean
+gst_play_sink_send_seek (GstPlaySink * playsink, GstEvent * event)
+{
+  gboolean scrubbing, res;
+
+  GST_OBJECT_LOCK (playsink);
+  scrubbing = playsink->scrub_seek != NULL;
+  GST_OBJECT_UNLOCK (playsink);
+
+  if (scrubbing) {
+    GstSeekFlags flags;
+    GstSeekType start_type, stop_type;
+    GstFormat format;
+    gdouble rate;
+    gint64 start, stop;
+
+    gst_event_parse_seek (event, &rate, &format, &flags, &start_type, &start,
+        &stop_type, &stop);
+    if (!(flags & GST_SEEK_FLAG_FLUSH)) {
+      GstEvent *seek;
+
+      GST_DEBUG_OBJECT (playsink, "making seek flushing");
+      seek = gst_event_new_seek (rate, format, flags | GST_SEEK_FLAG_FLUSH,
+          start_type, start, stop_type, stop);
+      gst_event_set_seqnum (seek, gst_event_get_seqnum (event));
+      gst_event_unref (event);
+      event = seek;
+    }
+  }
+
+  res = gst_play_sink_send_event_to_sink (playsink, event);
+
+  if (res && scrubbing) {
+    GST_OBJECT_LOCK (playsink);
+    gst_event_replace (&playsink->scrub_seek, NULL);
+    playsink->scrub_position = GST_CLOCK_TIME_NONE;
+    GST_OBJECT_UNLOCK (playsink);
+  }
+
+  return res;
+}
+
+static void
+gst_play_sink_scrub_func (GstEvent * event, GstPlaySink * playsink)
+{
+  GST_DEBUG_OBJECT (playsink, "seeking upstream to the cached position");
+  if (!gst_play_sink_send_event_to_sink (playsink, event))
+    GST_WARNING_OBJECT (playsink, "seek to the cached position failed");
+
+  GST_OBJECT_LOCK (playsink);
+  if (playsink->scrub_seek == NULL)
+    playsink->scrub_position = GST_CLOCK_TIME_NONE;
+  GST_OBJECT_UNLOCK (playsink);
+}
+
+/* Really seek to the position that was last shown from the video cache. The
+ * seek flushes the sinks, so it is not done from the state change but like
+ * an application seek in PLAYING, from another thread. The position is
+ * reported until the seek is done */
+static void
+gst_play_sink_finish_scrub (GstPlaySink * playsink)
+{
+  GstEvent *event;
+
+  GST_OBJECT_LOCK (playsink);
+  event = playsink->scrub_seek;
+  playsink->scrub_seek = NULL;
+  GST_OBJECT_UNLOCK (playsink);
+
+  if (event == NULL)
+    return;
+
+  if (!playsink->scrub_pool)
+    playsink->scrub_pool =
+        g_thread_pool_new ((GFunc) gst_play_sink_scrub_func, playsink, 1,
+        FALSE, NULL);
+  g_thread_pool_push (playsink->scrub_pool, event, NULL);
+}
+
+/* with the state lock, wait until the seek to the cached position is done */
+static void
+gst_play_sink_stop_scrub (GstPlaySink * playsink)
+{
+  if (playsink->scrub_pool) {
+    g_thread_pool_free (playsink->scrub_pool, FALSE, TRUE);
+    playsink->scrub_pool = NULL;
+  }
+
+  GST_OBJECT_LOCK (playsink);
+  gst_event_replace (&playsink->scrub_seek, NULL);
+  playsink->scrub_position = GST_CLOCK_TIME_NONE;
+  GST_OBJECT_UNLOCK (playsink);
+}
+
+static gboolean
+gst_play_sink_query (GstElement * element, GstQuery * query)
+{
+  GstPlaySink *playsink = GST_PLAY_SINK_CAST (element);
+
+  /* the audio sink is still at the position before the cached frame */
+  if (GST_QUERY_TYPE (query) == GST_QUERY_POSITION) {
+    GstClockTime position;
+    GstFormat format;
+
+    gst_query_parse_position (query, &format, NULL);
+
+    GST_OBJECT_LOCK (playsink);
+    position = playsink->scrub_position;
+    GST_OBJECT_UNLOCK (playsink);
+
+    if (format == GST_FORMAT_TIME && GST_CLOCK_TIME_IS_VALID (position)) {
+      gst_query_set_position (query, format, position);
+      return TRUE;
+    }
+  }
+
+  return GST_ELEMENT_CLASS (gst_play_sink_parent_class)->query (element,
+      query);
+}
+
 /* We only want to send the event to a single sink (overriding GstBin's
  * behaviour), but we want to keep GstPipeline's behaviour - wrapping seek
  * events appropriately. So, this is a messy duplication of code. */
@@ -4755,8 +5128,12 @@ gst_play_sink_send_event (GstElement * element, GstEvent * event)
   playsink = GST_PLAY_SINK_CAST (element);
   switch (event_type) {
     case GST_EVENT_SEEK:
+      if (gst_play_sink_seek_video_cache (playsink, event)) {
+        res = TRUE;
+        break;
+      }
       GST_DEBUG_OBJECT (element, "Sending event to a sink");
-      res = gst_play_sink_send_event_to_sink (playsink, event);
+      res = gst_play_sink_send_seek (playsink, event);
       break;
     case GST_EVENT_STEP:
     {
@@ -4808,6 +5185,7 @@ gst_play_sink_change_state (GstElement * element, GstStateChange transition)
       }
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_play_sink_stop_scrub (playsink);
       /* unblock all pads here */
       GST_PLAY_SINK_LOCK (playsink);
       video_set_blocked (playsink, FALSE);
@@ -4890,6 +5268,10 @@ gst_play_sink_change_state (GstElement * element, GstStateChange transition)
   switch (transition) {
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       break;
+    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
+      /* upstream is still held at the position before the cached frame */
+      gst_play_sink_finish_scrub (playsink);
+      break;
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       /* FIXME Release audio device when we implement that */
       playsink->need_async_start = TRUE;
@@ -5048,6 +5430,22 @@ gst_play_sink_set_property (GObject * object, guint prop_id,
       gst_play_sink_set_filter (playsink, GST_PLAY_SINK_TYPE_AUDIO,
           g_value_get_object (value));
       break;
+    case PROP_VIDEO_CACHE_FRAMES:{
+      guint64 max_bytes;
+
+      gst_play_sink_get_video_cache (playsink, NULL, &max_bytes);
+      gst_play_sink_set_video_cache (playsink, g_value_get_uint (value),
+          max_bytes);
+      break;
+    }
+    case PROP_VIDEO_CACHE_BYTES:{
+      guint max_frames;
+
+      gst_play_sink_get_video_cache (playsink, &max_frames, NULL);
+      gst_play_sink_set_video_cache (playsink, max_frames,
+          g_value_get_uint64 (value));
+      break;
+    }
     case PROP_VIDEO_SINK:
       gst_play_sink_set_sink (playsink, GST_PLAY_SINK_TYPE_VIDEO,
           g_value_get_object (value));
@@ -5131,6 +5529,20 @@ gst_play_sink_get_property (GObject * object, guint prop_id,
       g_value_take_object (value, gst_play_sink_get_filter (playsink,
               GST_PLAY_SINK_TYPE_AUDIO));
       break;
+    case PROP_VIDEO_CACHE_FRAMES:{
+      guint max_frames;
+
+      gst_play_sink_get_video_cache (playsink, &max_frames, NULL);
+      g_value_set_uint (value, max_frames);
+      break;
+    }
+    case PROP_VIDEO_CACHE_BYTES:{
+      guint64 max_bytes;
+
+      gst_play_sink_get_video_cache (playsink, NULL, &max_bytes);
+      g_value_set_uint64 (value, max_bytes);
+      break;
+    }
     case PROP_VIDEO_SINK:
       g_value_take_object (value, gst_play_sink_get_sink (playsink,
               GST_PLAY_SINK_TYPE_VIDEO));
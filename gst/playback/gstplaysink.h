@@ -78,6 +78,9 @@ GstElement *     gst_play_sink_get_filter     (GstPlaySink * playsink, GstPlaySi
 void             gst_play_sink_set_sink       (GstPlaySink * playsink, GstPlaySinkType type, GstElement * sink);
 GstElement *     gst_play_sink_get_sink       (GstPlaySink * playsink, GstPlaySinkType type);
 
+gboolean         gst_play_sink_add_extra_video_sink    (GstPlaySink * playsink, GstElement * sink);
+gboolean         gst_play_sink_remove_extra_video_sink (GstPlaySink * playsink, GstElement * sink);
+
 void             gst_play_sink_set_vis_plugin (GstPlaySink * playsink, GstElement * vis);
 GstElement *     gst_play_sink_get_vis_plugin (GstPlaySink * playsink);
 
@@ -98,6 +101,9 @@ gchar *          gst_play_sink_get_subtitle_encoding  (GstPlaySink *playsink);
 void             gst_play_sink_set_av_offset  (GstPlaySink *playsink, gint64 av_offset);
 gint64           gst_play_sink_get_av_offset  (GstPlaySink *playsink);
 
+void             gst_play_sink_set_video_cache (GstPlaySink * playsink, guint max_frames, guint64 max_bytes);
+void             gst_play_sink_get_video_cache (GstPlaySink * playsink, guint * max_frames, guint64 * max_bytes);
+
 GstSample *      gst_play_sink_get_last_sample (GstPlaySink * playsink);
 GstSample *      gst_play_sink_convert_sample  (GstPlaySink * playsink, GstCaps * caps);
 
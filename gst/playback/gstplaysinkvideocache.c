@@ -0,0 +1,753 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Keeps the most recently decoded video frames, sorted by timestamp, so that
+ * accurate seeks to a frame that was decoded before can be shown without
+ * seeking and decoding upstream.
+ *
+ * It is placed in front of the queue of the video chain. A seek that can be
+ * served flushes only the elements after the cache and pushes a new segment
+ * and the cached frame into the queue, which never blocks. The streaming
+ * thread is held in the cache from then on: upstream is still at the old
+ * position and its data must not reach the sink. It is released by the
+ * flush of the next seek that goes upstream, playsink does that seek when
+ * going to PLAYING.
+ *
+ * The flush-stop, segment and frame of a served seek are pushed by the held
+ * streaming thread, or with the stream lock of the sinkpad when upstream is
+ * not pushing, so they are serialized with the data flow like any other
+ * data.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstplaysinkvideocache.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_play_sink_video_cache_debug);
+#define GST_CAT_DEFAULT gst_play_sink_video_cache_debug
+
+#define parent_class gst_play_sink_video_cache_parent_class
+
+G_DEFINE_TYPE (GstPlaySinkVideoCache, gst_play_sink_video_cache,
+    GST_TYPE_ELEMENT);
+
+typedef struct
+{
+  GstClockTime pts;
+  GstClockTime duration;
+  GstBuffer *buffer;
+  gsize size;
+  GSequenceIter *iter;          /* position in frames */
+  GList lru_link;               /* position in lru */
+} GstPlaySinkVideoCacheFrame;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstPlaySinkVideoCacheFrame *
+frame_new (GstBuffer * buffer, GstClockTime duration)
+{
+  GstPlaySinkVideoCacheFrame *frame;
+
+  frame = g_slice_new (GstPlaySinkVideoCacheFrame);
+  frame->pts = GST_BUFFER_PTS (buffer);
+  frame->duration = duration;
+  /* buffers of a pool are copied, the decoder would run out of them */
+  if (buffer->pool)
+    frame->buffer = gst_buffer_copy_deep (buffer);
+  else
+    frame->buffer = gst_buffer_ref (buffer);
+  frame->size = gst_buffer_get_size (buffer);
+  frame->iter = NULL;
+  frame->lru_link.data = frame;
+  frame->lru_link.prev = frame->lru_link.next = NULL;
+
+  return frame;
+}
+
+static void
+frame_free (GstPlaySinkVideoCacheFrame * frame)
+{
+  gst_buffer_unref (frame->buffer);
+  g_slice_free (GstPlaySinkVideoCacheFrame, frame);
+}
+
+static gint
+compare_frames (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const GstPlaySinkVideoCacheFrame *fa = a, *fb = b;
+
+  if (fa->pts < fb->pts)
+    return -1;
+  if (fa->pts > fb->pts)
+    return 1;
+  return 0;
+}
+
+/* with the object lock */
+static void
+clear_frames (GstPlaySinkVideoCache * self)
+{
+  if (g_sequence_get_length (self->frames) > 0)
+    GST_DEBUG_OBJECT (self, "clearing the cache");
+
+  g_sequence_remove_range (g_sequence_get_begin_iter (self->frames),
+      g_sequence_get_end_iter (self->frames));
+  /* the links were part of the frames */
+  g_queue_init (&self->lru);
+  self->bytes = 0;
+}
+
+/* with the object lock */
+static gboolean
+over_budget (GstPlaySinkVideoCache * self)
+{
+  guint n_frames = g_sequence_get_length (self->frames);
+
+  if (n_frames == 0)
+    return FALSE;
+  if (self->max_frames == 0 && self->max_bytes == 0)
+    return TRUE;
+
+  return (self->max_frames > 0 && n_frames > self->max_frames) ||
+      (self->max_bytes > 0 && self->bytes > self->max_bytes);
+}
+
+/* with the object lock, the head of lru is the least recently used frame */
+static void
+touch_frame (GstPlaySinkVideoCache * self, GstPlaySinkVideoCacheFrame * frame)
+{
+  g_queue_unlink (&self->lru, &frame->lru_link);
+  g_queue_push_tail_link (&self->lru, &frame->lru_link);
+}
+
+/* with the object lock, drop the least recently used frames until the cache
+ * is within its limits */
+static void
+evict_frames (GstPlaySinkVideoCache * self)
+{
+  while (over_budget (self)) {
+    GstPlaySinkVideoCacheFrame *frame;
+
+    frame = g_queue_pop_head_link (&self->lru)->data;
+    GST_LOG_OBJECT (self, "evicting frame %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (frame->pts));
+    self->bytes -= frame->size;
+    g_sequence_remove (frame->iter);
+  }
+}
+
+/* with the object lock */
+static void
+insert_frame (GstPlaySinkVideoCache * self, GstPlaySinkVideoCacheFrame * frame)
+{
+  GSequenceIter *iter;
+
+  iter = g_sequence_lookup (self->frames, frame, compare_frames, NULL);
+  if (iter) {
+    GstPlaySinkVideoCacheFrame *old = g_sequence_get (iter);
+
+    self->bytes -= old->size;
+    g_queue_unlink (&self->lru, &old->lru_link);
+    /* frees the old frame */
+    g_sequence_set (iter, frame);
+  } else {
+    iter = g_sequence_insert_sorted (self->frames, frame, compare_frames, NULL);
+  }
+  frame->iter = iter;
+  g_queue_push_tail_link (&self->lru, &frame->lru_link);
+  self->bytes += frame->size;
+
+  evict_frames (self);
+}
+
+/* with the object lock, the frame that is shown at @ts */
+static GstPlaySinkVideoCacheFrame *
+find_frame (GstPlaySinkVideoCache * self, GstClockTime ts)
+{
+  GstPlaySinkVideoCacheFrame key, *frame;
+  GSequenceIter *iter;
+
+  key.pts = ts;
+  iter = g_sequence_search (self->frames, &key, compare_frames, NULL);
+
+  /* a frame at exactly ts can be on either side of the insert position */
+  if (!g_sequence_iter_is_end (iter)) {
+    frame = g_sequence_get (iter);
+    if (frame->pts == ts)
+      return frame;
+  }
+  if (g_sequence_iter_is_begin (iter))
+    return NULL;
+
+  frame = g_sequence_get (g_sequence_iter_prev (iter));
+  if (frame->pts <= ts && ts < frame->pts + frame->duration)
+    return frame;
+
+  return NULL;
+}
+
+/* with the object lock, how long @buffer is shown or NONE if it is not
+ * cached */
+static GstClockTime
+get_cache_duration (GstPlaySinkVideoCache * self, GstBuffer * buffer)
+{
+  if (!self->cacheable || (self->max_frames == 0 && self->max_bytes == 0))
+    return GST_CLOCK_TIME_NONE;
+
+  if (self->segment.format != GST_FORMAT_TIME || self->segment.rate != 1.0)
+    return GST_CLOCK_TIME_NONE;
+
+  if (!GST_BUFFER_PTS_IS_VALID (buffer) ||
+      GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP) ||
+      GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DECODE_ONLY))
+    return GST_CLOCK_TIME_NONE;
+
+  if (self->max_bytes > 0 && gst_buffer_get_size (buffer) > self->max_bytes)
+    return GST_CLOCK_TIME_NONE;
+
+  if (GST_BUFFER_DURATION_IS_VALID (buffer) && GST_BUFFER_DURATION (buffer) > 0)
+    return GST_BUFFER_DURATION (buffer);
+
+  return self->frame_duration;
+}
+
+/* with the object lock */
+static void
+set_caps (GstPlaySinkVideoCache * self, GstCaps * caps)
+{
+  GstStructure *s;
+  GstCapsFeatures *features;
+  gint fps_n, fps_d;
+
+  if (self->caps && gst_caps_is_equal (self->caps, caps))
+    return;
+
+  gst_caps_replace (&self->caps, caps);
+  clear_frames (self);
+
+  s = gst_caps_get_structure (caps, 0);
+  features = gst_caps_get_features (caps, 0);
+
+  /* other memory might not be copyable */
+  self->cacheable = gst_structure_has_name (s, "video/x-raw") &&
+      (features == NULL || gst_caps_features_is_equal (features,
+              GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY));
+
+  if (gst_structure_get_fraction (s, "framerate", &fps_n, &fps_d) &&
+      fps_n > 0 && fps_d > 0)
+    self->frame_duration = gst_util_uint64_scale_int (GST_SECOND, fps_d, fps_n);
+  else
+    self->frame_duration = GST_CLOCK_TIME_NONE;
+}
+
+/* with the object lock */
+static void
+set_segment (GstPlaySinkVideoCache * self, const GstSegment * segment)
+{
+  /* the frames are found again by timestamp, which only works as long as the
+   * timestamps map to the same stream time */
+  if (segment->format != GST_FORMAT_TIME || segment->applied_rate != 1.0 ||
+      (self->segment.format == GST_FORMAT_TIME &&
+          (gint64) (segment->time - segment->start) !=
+          (gint64) (self->segment.time - self->segment.start)))
+    clear_frames (self);
+
+  gst_segment_copy_into (segment, &self->segment);
+}
+
+/* with the object lock, push the flush-stop, segment and frame of the last
+ * served seek. Must be called from the streaming thread or with the stream
+ * lock of the sinkpad */
+static void
+push_served (GstPlaySinkVideoCache * self)
+{
+  GstBuffer *buffer;
+  GstEvent *segment, *ev;
+
+  buffer = self->serve_buffer;
+  segment = self->serve_segment;
+  self->serve_buffer = NULL;
+  self->serve_segment = NULL;
+  self->pushing = TRUE;
+  GST_OBJECT_UNLOCK (self);
+
+  ev = gst_event_new_flush_stop (TRUE);
+  gst_event_set_seqnum (ev, gst_event_get_seqnum (segment));
+  gst_pad_push_event (self->srcpad, ev);
+  gst_pad_push_event (self->srcpad, segment);
+  /* goes into the queue, which was just flushed */
+  gst_pad_push (self->srcpad, buffer);
+
+  GST_OBJECT_LOCK (self);
+  self->pushing = FALSE;
+  g_cond_broadcast (&self->cond);
+}
+
+/* with the object lock, hold the streaming thread while a cached frame is
+ * shown and push the frames of the seeks in the meantime. Returns FALSE when
+ * flushing */
+static gboolean
+wait_serving (GstPlaySinkVideoCache * self)
+{
+  while (self->serving && !self->flushing) {
+    if (self->serve_buffer) {
+      push_served (self);
+      continue;
+    }
+    self->waiting = TRUE;
+    g_cond_broadcast (&self->cond);
+    g_cond_wait (&self->cond, GST_OBJECT_GET_LOCK (self));
+    self->waiting = FALSE;
+  }
+
+  return !self->flushing;
+}
+
+/* with the object lock */
+static void
+clear_served (GstPlaySinkVideoCache * self)
+{
+  gst_buffer_replace (&self->serve_buffer, NULL);
+  gst_event_replace (&self->serve_segment, NULL);
+}
+
+/* with the object lock, before the streaming thread pushes downstream */
+static gboolean
+start_push (GstPlaySinkVideoCache * self)
+{
+  if (!wait_serving (self))
+    return FALSE;
+
+  self->pushing = TRUE;
+
+  return TRUE;
+}
+
+/* with the object lock, after the streaming thread pushed downstream. When
+ * the push was interrupted to show a cached frame, this holds the streaming
+ * thread until upstream is flushed too. Returns FALSE when flushing */
+static gboolean
+finish_push (GstPlaySinkVideoCache * self)
+{
+  self->pushing = FALSE;
+  g_cond_broadcast (&self->cond);
+
+  return wait_serving (self);
+}
+
+static GstFlowReturn
+gst_play_sink_video_cache_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstPlaySinkVideoCache *self = GST_PLAY_SINK_VIDEO_CACHE_CAST (parent);
+  GstPlaySinkVideoCacheFrame *frame = NULL;
+  GstClockTime duration;
+  GstFlowReturn ret;
+
+  GST_OBJECT_LOCK (self);
+  duration = get_cache_duration (self, buffer);
+  GST_OBJECT_UNLOCK (self);
+
+  /* copy outside of the lock */
+  if (GST_CLOCK_TIME_IS_VALID (duration))
+    frame = frame_new (buffer, duration);
+
+  GST_OBJECT_LOCK (self);
+  if (!start_push (self))
+    goto flushing;
+  if (frame)
+    insert_frame (self, frame);
+  GST_OBJECT_UNLOCK (self);
+
+  ret = gst_pad_push (self->srcpad, buffer);
+
+  GST_OBJECT_LOCK (self);
+  if (!finish_push (self))
+    ret = GST_FLOW_FLUSHING;
+  GST_OBJECT_UNLOCK (self);
+
+  return ret;
+
+  /* ERRORS */
+flushing:
+  {
+    GST_OBJECT_UNLOCK (self);
+    GST_DEBUG_OBJECT (self, "flushing");
+    if (frame)
+      frame_free (frame);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_FLUSHING;
+  }
+}
+
+static gboolean
+gst_play_sink_video_cache_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstPlaySinkVideoCache *self = GST_PLAY_SINK_VIDEO_CACHE_CAST (parent);
+  gboolean res;
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      /* upstream seeks, the streaming thread can go on */
+      GST_OBJECT_LOCK (self);
+      self->flushing = TRUE;
+      self->serving = FALSE;
+      clear_served (self);
+      g_cond_broadcast (&self->cond);
+      GST_OBJECT_UNLOCK (self);
+      return gst_pad_push_event (self->srcpad, event);
+    case GST_EVENT_FLUSH_STOP:
+      GST_OBJECT_LOCK (self);
+      self->flushing = FALSE;
+      GST_OBJECT_UNLOCK (self);
+      return gst_pad_push_event (self->srcpad, event);
+    default:
+      break;
+  }
+
+  if (!GST_EVENT_IS_SERIALIZED (event))
+    return gst_pad_event_default (pad, parent, event);
+
+  GST_OBJECT_LOCK (self);
+  if (!start_push (self)) {
+    GST_OBJECT_UNLOCK (self);
+    gst_event_unref (event);
+    return FALSE;
+  }
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+
+      gst_event_parse_caps (event, &caps);
+      set_caps (self, caps);
+      break;
+    }
+    case GST_EVENT_SEGMENT:
+    {
+      const GstSegment *segment;
+
+      gst_event_parse_segment (event, &segment);
+      set_segment (self, segment);
+      break;
+    }
+    default:
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  res = gst_pad_push_event (self->srcpad, event);
+
+  GST_OBJECT_LOCK (self);
+  finish_push (self);
+  GST_OBJECT_UNLOCK (self);
+
+  return res;
+}
+
+/**
+ * gst_play_sink_video_cache_set_limits:
+ * @self: a #GstPlaySinkVideoCache
+ * @max_frames: maximum number of frames to keep, 0 for no limit
+ * @max_bytes: maximum size of the frames to keep, 0 for no limit
+ *
+ * Set the size of the cache. Nothing is cached when both limits are 0.
+ */
+void
+gst_play_sink_video_cache_set_limits (GstPlaySinkVideoCache * self,
+    guint max_frames, guint64 max_bytes)
+{
+  g_return_if_fail (GST_IS_PLAY_SINK_VIDEO_CACHE (self));
+
+  GST_OBJECT_LOCK (self);
+  self->max_frames = max_frames;
+  self->max_bytes = max_bytes;
+  evict_frames (self);
+  GST_OBJECT_UNLOCK (self);
+}
+
+/**
+ * gst_play_sink_video_cache_seek:
+ * @self: a #GstPlaySinkVideoCache
+ * @event: (transfer none): a seek event
+ *
+ * Show the cached frame at the position of @event. Only flushing accurate
+ * seeks in time at rate 1.0 are handled.
+ *
+ * Upstream is not seeked and can't push until it is flushed, so a later
+ * seek has to be done upstream before playing.
+ *
+ * Returns: %TRUE when the frame was in the cache and was pushed downstream.
+ */
+gboolean
+gst_play_sink_video_cache_seek (GstPlaySinkVideoCache * self, GstEvent * event)
+{
+  GstPlaySinkVideoCacheFrame *frame;
+  GstSeekFlags flags;
+  GstSeekType start_type, stop_type;
+  GstFormat format;
+  gdouble rate;
+  gint64 start, stop;
+  GstSegment segment;
+  GstClockTime ts;
+  GstBuffer *buffer;
+  GstEvent *ev;
+  guint32 seqnum;
+
+  g_return_val_if_fail (GST_IS_PLAY_SINK_VIDEO_CACHE (self), FALSE);
+  g_return_val_if_fail (GST_EVENT_TYPE (event) == GST_EVENT_SEEK, FALSE);
+
+  gst_event_parse_seek (event, &rate, &format, &flags, &start_type, &start,
+      &stop_type, &stop);
+
+  if (format != GST_FORMAT_TIME || rate != 1.0 ||
+      !(flags & GST_SEEK_FLAG_FLUSH) || !(flags & GST_SEEK_FLAG_ACCURATE) ||
+      (flags & (GST_SEEK_FLAG_SEGMENT | GST_SEEK_FLAG_KEY_UNIT |
+              GST_SEEK_FLAG_TRICKMODE)) ||
+      start_type != GST_SEEK_TYPE_SET || start < 0 ||
+      (stop_type != GST_SEEK_TYPE_NONE && stop_type != GST_SEEK_TYPE_SET) ||
+      (stop_type == GST_SEEK_TYPE_SET && stop != -1 && stop <= start))
+    return FALSE;
+
+  GST_OBJECT_LOCK (self);
+  if (self->flushing || self->segment.format != GST_FORMAT_TIME ||
+      (guint64) start < self->segment.time)
+    goto not_cached;
+
+  /* the new segment, like upstream would make it for the seek */
+  gst_segment_copy_into (&self->segment, &segment);
+  ts = start - segment.time + segment.start;
+  if (stop_type == GST_SEEK_TYPE_SET)
+    segment.stop = stop == -1 ? -1 : stop - segment.time + segment.start;
+  if (GST_CLOCK_TIME_IS_VALID (segment.stop) && segment.stop <= ts)
+    goto not_cached;
+
+  segment.flags = GST_SEGMENT_FLAG_RESET;
+  segment.rate = 1.0;
+  segment.base = 0;
+  segment.offset = 0;
+  segment.start = ts;
+  segment.time = start;
+  segment.position = ts;
+
+  if (!(frame = find_frame (self, ts)))
+    goto not_cached;
+
+  GST_DEBUG_OBJECT (self, "showing cached frame %" GST_TIME_FORMAT
+      " for %" GST_TIME_FORMAT, GST_TIME_ARGS (frame->pts),
+      GST_TIME_ARGS (start));
+
+  touch_frame (self, frame);
+  buffer = gst_buffer_copy (frame->buffer);
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+
+  /* from now on the streaming thread waits in the cache */
+  self->serving = TRUE;
+  GST_OBJECT_UNLOCK (self);
+
+  seqnum = gst_event_get_seqnum (event);
+
+  ev = gst_event_new_flush_start ();
+  gst_event_set_seqnum (ev, seqnum);
+  gst_pad_push_event (self->srcpad, ev);
+
+  /* wait until the streaming thread got out of the downstream elements */
+  GST_OBJECT_LOCK (self);
+  while (self->serving && self->pushing)
+    g_cond_wait (&self->cond, GST_OBJECT_GET_LOCK (self));
+  if (!self->serving) {
+    gst_buffer_unref (buffer);
+    goto aborted;
+  }
+
+  /* replaces the frame of a seek that was not shown yet */
+  clear_served (self);
+  self->serve_buffer = buffer;
+  self->serve_segment = gst_event_new_segment (&segment);
+  gst_event_set_seqnum (self->serve_segment, seqnum);
+
+  /* the rest is pushed in the streaming thread. When it is not in the cache
+   * and can't come in because we have its stream lock, push from here */
+  while (self->serving && (self->serve_buffer || self->pushing)) {
+    if (self->waiting || self->pushing) {
+      g_cond_broadcast (&self->cond);
+      g_cond_wait (&self->cond, GST_OBJECT_GET_LOCK (self));
+      continue;
+    }
+    GST_OBJECT_UNLOCK (self);
+
+    if (GST_PAD_STREAM_TRYLOCK (self->sinkpad)) {
+      GST_OBJECT_LOCK (self);
+      if (self->serving && self->serve_buffer)
+        push_served (self);
+      GST_OBJECT_UNLOCK (self);
+      GST_PAD_STREAM_UNLOCK (self->sinkpad);
+      GST_OBJECT_LOCK (self);
+      continue;
+    }
+
+    /* the streaming thread is coming in, it will wait or push */
+    GST_OBJECT_LOCK (self);
+    if (self->serving && self->serve_buffer && !self->waiting &&
+        !self->pushing)
+      g_cond_wait (&self->cond, GST_OBJECT_GET_LOCK (self));
+  }
+  if (!self->serving)
+    goto aborted;
+  GST_OBJECT_UNLOCK (self);
+
+  return TRUE;
+
+not_cached:
+  {
+    GST_OBJECT_UNLOCK (self);
+    GST_DEBUG_OBJECT (self, "%" GST_TIME_FORMAT " is not cached",
+        GST_TIME_ARGS (start));
+    return FALSE;
+  }
+aborted:
+  {
+    /* upstream was flushed in the meantime */
+    clear_served (self);
+    GST_OBJECT_UNLOCK (self);
+    GST_DEBUG_OBJECT (self, "seek upstream while showing cached frame");
+    return FALSE;
+  }
+}
+
+static GstStateChangeReturn
+gst_play_sink_video_cache_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstPlaySinkVideoCache *self = GST_PLAY_SINK_VIDEO_CACHE_CAST (element);
+  GstStateChangeReturn ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      GST_OBJECT_LOCK (self);
+      self->flushing = FALSE;
+      self->serving = FALSE;
+      gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* release the streaming thread so that the pads can be deactivated */
+      GST_OBJECT_LOCK (self);
+      self->flushing = TRUE;
+      self->serving = FALSE;
+      clear_served (self);
+      g_cond_broadcast (&self->cond);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_OBJECT_LOCK (self);
+      clear_frames (self);
+      gst_caps_replace (&self->caps, NULL);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static void
+gst_play_sink_video_cache_finalize (GObject * object)
+{
+  GstPlaySinkVideoCache *self = GST_PLAY_SINK_VIDEO_CACHE_CAST (object);
+
+  g_sequence_free (self->frames);
+  clear_served (self);
+  gst_caps_replace (&self->caps, NULL);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_play_sink_video_cache_class_init (GstPlaySinkVideoCacheClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstElementClass *gstelement_class;
+
+  GST_DEBUG_CATEGORY_INIT (gst_play_sink_video_cache_debug,
+      "playsinkvideocache", 0, "play bin");
+
+  gobject_class = (GObjectClass *) klass;
+  gstelement_class = (GstElementClass *) klass;
+
+  gobject_class->finalize = gst_play_sink_video_cache_finalize;
+
+  gstelement_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_play_sink_video_cache_change_state);
+
+  gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
+  gst_element_class_add_static_pad_template (gstelement_class, &sinktemplate);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "Player Sink Video Cache", "Generic",
+      "Shows recently decoded video frames again on seeks",
+      "Tobias Lindqvist <tobias.lindqvist@gmail.com>");
+}
+
+static void
+gst_play_sink_video_cache_init (GstPlaySinkVideoCache * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_play_sink_video_cache_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_play_sink_video_cache_sink_event));
+  GST_PAD_SET_PROXY_CAPS (self->sinkpad);
+  GST_PAD_SET_PROXY_ALLOCATION (self->sinkpad);
+  GST_PAD_SET_PROXY_SCHEDULING (self->sinkpad);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&srctemplate, "src");
+  GST_PAD_SET_PROXY_CAPS (self->srcpad);
+  GST_PAD_SET_PROXY_ALLOCATION (self->srcpad);
+  GST_PAD_SET_PROXY_SCHEDULING (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->srcpad);
+
+  g_cond_init (&self->cond);
+  self->frames = g_sequence_new ((GDestroyNotify) frame_free);
+  g_queue_init (&self->lru);
+  self->frame_duration = GST_CLOCK_TIME_NONE;
+  gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+}
@@ -0,0 +1,83 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/gst.h>
+
+#ifndef __GST_PLAY_SINK_VIDEO_CACHE_H__
+#define __GST_PLAY_SINK_VIDEO_CACHE_H__
+
+G_BEGIN_DECLS
+#define GST_TYPE_PLAY_SINK_VIDEO_CACHE \
+  (gst_play_sink_video_cache_get_type())
+#define GST_PLAY_SINK_VIDEO_CACHE(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_PLAY_SINK_VIDEO_CACHE, GstPlaySinkVideoCache))
+#define GST_PLAY_SINK_VIDEO_CACHE_CAST(obj) \
+  ((GstPlaySinkVideoCache *) obj)
+#define GST_PLAY_SINK_VIDEO_CACHE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_PLAY_SINK_VIDEO_CACHE, GstPlaySinkVideoCacheClass))
+#define GST_IS_PLAY_SINK_VIDEO_CACHE(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_PLAY_SINK_VIDEO_CACHE))
+#define GST_IS_PLAY_SINK_VIDEO_CACHE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_PLAY_SINK_VIDEO_CACHE))
+typedef struct _GstPlaySinkVideoCache GstPlaySinkVideoCache;
+typedef struct _GstPlaySinkVideoCacheClass GstPlaySinkVideoCacheClass;
+
+struct _GstPlaySinkVideoCache
+{
+  GstElement parent;
+
+  /* < private > */
+  GstPad *sinkpad, *srcpad;
+
+  /* all protected with the object lock */
+  GCond cond;
+  guint max_frames;             /* 0 = no limit */
+  guint64 max_bytes;            /* 0 = no limit */
+  GSequence *frames;            /* sorted by pts */
+  GQueue lru;                   /* the same frames, least recently used first */
+  guint64 bytes;
+
+  GstCaps *caps;
+  gboolean cacheable;           /* raw video in system memory */
+  GstClockTime frame_duration;  /* from the framerate */
+  GstSegment segment;
+
+  gboolean flushing;
+  gboolean serving;             /* showing a cached frame, upstream waits */
+  gboolean pushing;             /* pushing downstream */
+  gboolean waiting;             /* the streaming thread waits in the cache */
+  /* the segment and frame of the last seek, until pushed */
+  GstEvent *serve_segment;
+  GstBuffer *serve_buffer;
+};
+
+struct _GstPlaySinkVideoCacheClass
+{
+  GstElementClass parent;
+};
+
+GType gst_play_sink_video_cache_get_type (void);
+
+void gst_play_sink_video_cache_set_limits (GstPlaySinkVideoCache * self,
+    guint max_frames, guint64 max_bytes);
+gboolean gst_play_sink_video_cache_seek (GstPlaySinkVideoCache * self,
+    GstEvent * event);
+
+G_END_DECLS
+#endif /* __GST_PLAY_SINK_VIDEO_CACHE_H__ */
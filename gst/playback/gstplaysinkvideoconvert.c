@@ -54,12 +54,20 @@ gst_play_sink_video_convert_add_conversion_elements (GstPlaySinkVideoConvert *
       "Building video conversion with use-converters %d, use-balance %d",
       self->use_converters, self->use_balance);
 
-  if (self->use_converters) {
+  if (self->use_balance && self->balance) {
+    /* the color balance is done by the colorspace converter as part of the
+     * conversion */
+    el = self->balance;
+    gst_play_sink_convert_bin_add_conversion_element (cbin, el);
+    prev = el;
+  } else if (self->use_converters) {
     el = gst_play_sink_convert_bin_add_conversion_element_factory (cbin,
         COLORSPACE, "conv");
     if (el)
       prev = el;
+  }
 
+  if (self->use_converters) {
     el = gst_play_sink_convert_bin_add_conversion_element_factory (cbin,
         "videoscale", "scale");
     if (el) {
@@ -74,27 +82,6 @@ gst_play_sink_video_convert_add_conversion_elements (GstPlaySinkVideoConvert *
     }
   }
 
-  if (self->use_balance && self->balance) {
-    el = self->balance;
-    gst_play_sink_convert_bin_add_conversion_element (cbin, el);
-    if (prev) {
-      if (!gst_element_link_pads_full (prev, "src", el, "sink",
-              GST_PAD_LINK_CHECK_TEMPLATE_CAPS))
-        goto link_failed;
-    }
-    prev = el;
-
-    el = gst_play_sink_convert_bin_add_conversion_element_factory (cbin,
-        COLORSPACE, "conv2");
-    if (prev) {
-      if (!gst_element_link_pads_full (prev, "src", el, "sink",
-              GST_PAD_LINK_CHECK_TEMPLATE_CAPS))
-        goto link_failed;
-    }
-    if (el)
-      prev = el;
-  }
-
   return TRUE;
 
 link_failed:
@@ -193,7 +180,7 @@ gst_play_sink_video_convert_class_init (GstPlaySinkVideoConvertClass * klass)
 
   g_object_class_install_property (gobject_class, PROP_USE_BALANCE,
       g_param_spec_boolean ("use-balance", "Use balance",
-          "Whether to use a videobalance element", FALSE,
+          "Whether to use the color balance of the converter", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -212,7 +199,7 @@ gst_play_sink_video_convert_init (GstPlaySinkVideoConvert * self)
    * it to always exist because of playsink's color balance
    * proxying logic.
    */
-  self->balance = gst_element_factory_make ("videobalance", "videobalance");
+  self->balance = gst_element_factory_make (COLORSPACE, "conv");
   if (self->balance)
     gst_object_ref_sink (self->balance);
 
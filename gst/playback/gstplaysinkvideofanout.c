@@ -0,0 +1,283 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Sends the decoded video to the video sink of playsink and to any number of
+ * extra sinks.
+ *
+ * The buffers are shared between all outputs. The main output is on the
+ * source pad and negotiates the format with the upstream converter. The
+ * extra sinks are grouped by the caps they accept and every group gets one
+ * converter, which is in passthrough when it accepts the format of the main
+ * output:
+ *
+ *   sink -> tee -+-> convert -> tee -+-> queue -> extra sink
+ *                |                  +-> queue -> extra sink
+ *                +-> convert -> tee ---> queue -> extra sink
+ *                +-> src
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstplaysinkvideofanout.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_play_sink_video_fanout_debug);
+#define GST_CAT_DEFAULT gst_play_sink_video_fanout_debug
+
+#define parent_class gst_play_sink_video_fanout_parent_class
+
+G_DEFINE_TYPE (GstPlaySinkVideoFanout, gst_play_sink_video_fanout,
+    GST_TYPE_BIN);
+
+typedef struct
+{
+  GstCaps *caps;                /* caps of the sinks of this branch */
+  GstElement *tee;              /* after the converter */
+} GstPlaySinkVideoFanoutBranch;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstElement *
+make_tee (GstPlaySinkVideoFanout * self)
+{
+  GstElement *tee;
+
+  if (!(tee = gst_element_factory_make ("tee", NULL)))
+    return NULL;
+
+  /* one failing extra sink should not stop the others */
+  g_object_set (tee, "allow-not-linked", TRUE, NULL);
+  gst_bin_add (GST_BIN_CAST (self), tee);
+
+  return tee;
+}
+
+static GstPlaySinkVideoFanoutBranch *
+get_branch (GstPlaySinkVideoFanout * self, GstCaps * caps)
+{
+  GstPlaySinkVideoFanoutBranch *branch;
+  GstElement *convert, *tee;
+  GList *l;
+
+  for (l = self->branches; l; l = l->next) {
+    branch = l->data;
+    if (gst_caps_is_equal (branch->caps, caps))
+      return branch;
+  }
+
+  if (!(convert = gst_element_factory_make (COLORSPACE, NULL))) {
+    GST_WARNING_OBJECT (self, "no %s element", COLORSPACE);
+    return NULL;
+  }
+  gst_bin_add (GST_BIN_CAST (self), convert);
+
+  if (!(tee = make_tee (self)))
+    goto no_tee;
+
+  if (!gst_element_link_many (self->tee, convert, tee, NULL))
+    goto link_failed;
+
+  GST_DEBUG_OBJECT (self, "new branch for %" GST_PTR_FORMAT, caps);
+
+  branch = g_slice_new (GstPlaySinkVideoFanoutBranch);
+  branch->caps = gst_caps_ref (caps);
+  branch->tee = tee;
+  self->branches = g_list_append (self->branches, branch);
+
+  return branch;
+
+no_tee:
+  {
+    GST_WARNING_OBJECT (self, "no tee element");
+    gst_bin_remove (GST_BIN_CAST (self), convert);
+    return NULL;
+  }
+link_failed:
+  {
+    GST_WARNING_OBJECT (self, "failed to link the converter");
+    gst_bin_remove (GST_BIN_CAST (self), tee);
+    gst_bin_remove (GST_BIN_CAST (self), convert);
+    return NULL;
+  }
+}
+
+/**
+ * gst_play_sink_video_fanout_add_sink:
+ * @self: a #GstPlaySinkVideoFanout
+ * @sink: an extra video sink
+ *
+ * Add @sink as an extra output. It shares the converter with the other extra
+ * sinks that accept the same caps. Must be called before
+ * gst_play_sink_video_fanout_finish().
+ *
+ * Returns: %TRUE when @sink was added.
+ */
+gboolean
+gst_play_sink_video_fanout_add_sink (GstPlaySinkVideoFanout * self,
+    GstElement * sink)
+{
+  GstPlaySinkVideoFanoutBranch *branch;
+  GstElement *queue;
+  GstPad *sinkpad;
+  GstCaps *caps;
+
+  g_return_val_if_fail (GST_IS_PLAY_SINK_VIDEO_FANOUT (self), FALSE);
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
+  g_return_val_if_fail (!self->finished, FALSE);
+
+  if (!self->tee)
+    return FALSE;
+
+  if (!(sinkpad = gst_element_get_static_pad (sink, "sink"))) {
+    GST_WARNING_OBJECT (self, "%s has no sink pad", GST_ELEMENT_NAME (sink));
+    return FALSE;
+  }
+  caps = gst_pad_query_caps (sinkpad, NULL);
+  gst_object_unref (sinkpad);
+
+  branch = get_branch (self, caps);
+  gst_caps_unref (caps);
+  if (!branch)
+    return FALSE;
+
+  /* the extra sinks preroll and wait for their clock in their own thread */
+  if (!(queue = gst_element_factory_make ("queue", NULL))) {
+    GST_WARNING_OBJECT (self, "no queue element");
+    return FALSE;
+  }
+  g_object_set (queue, "max-size-buffers", 3, "max-size-bytes", 0,
+      "max-size-time", (gint64) 0, "silent", TRUE, NULL);
+
+  gst_bin_add_many (GST_BIN_CAST (self), queue, sink, NULL);
+  if (!gst_element_link_many (branch->tee, queue, sink, NULL)) {
+    GST_WARNING_OBJECT (self, "failed to link %s", GST_ELEMENT_NAME (sink));
+    gst_bin_remove (GST_BIN_CAST (self), sink);
+    gst_bin_remove (GST_BIN_CAST (self), queue);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (self, "added sink %s", GST_ELEMENT_NAME (sink));
+
+  return TRUE;
+}
+
+/**
+ * gst_play_sink_video_fanout_finish:
+ * @self: a #GstPlaySinkVideoFanout
+ *
+ * Set up the main output on the source pad, after all extra sinks are added.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+gst_play_sink_video_fanout_finish (GstPlaySinkVideoFanout * self)
+{
+  GstPad *pad;
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_PLAY_SINK_VIDEO_FANOUT (self), FALSE);
+  g_return_val_if_fail (!self->finished, FALSE);
+
+  if (!self->tee)
+    return FALSE;
+
+  /* requested last so that tee pushes to the queues of the extra sinks
+   * before the main sink, which blocks while prerolling */
+  pad = gst_element_get_request_pad (self->tee, "src_%u");
+  res = gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->srcpad), pad);
+  gst_object_unref (pad);
+
+  self->finished = TRUE;
+
+  return res;
+}
+
+static void
+gst_play_sink_video_fanout_finalize (GObject * object)
+{
+  GstPlaySinkVideoFanout *self = GST_PLAY_SINK_VIDEO_FANOUT_CAST (object);
+  GList *l;
+
+  for (l = self->branches; l; l = l->next) {
+    GstPlaySinkVideoFanoutBranch *branch = l->data;
+
+    gst_caps_unref (branch->caps);
+    g_slice_free (GstPlaySinkVideoFanoutBranch, branch);
+  }
+  g_list_free (self->branches);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_play_sink_video_fanout_class_init (GstPlaySinkVideoFanoutClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstElementClass *gstelement_class;
+
+  GST_DEBUG_CATEGORY_INIT (gst_play_sink_video_fanout_debug,
+      "playsinkvideofanout", 0, "play bin");
+
+  gobject_class = (GObjectClass *) klass;
+  gstelement_class = (GstElementClass *) klass;
+
+  gobject_class->finalize = gst_play_sink_video_fanout_finalize;
+
+  gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
+  gst_element_class_add_static_pad_template (gstelement_class, &sinktemplate);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "Player Sink Video Fanout", "Video/Bin",
+      "Shares the decoded video with extra video sinks",
+      "Tobias Lindqvist <tobias.lindqvist@gmail.com>");
+}
+
+static void
+gst_play_sink_video_fanout_init (GstPlaySinkVideoFanout * self)
+{
+  GstPadTemplate *templ;
+  GstPad *pad;
+
+  templ = gst_static_pad_template_get (&sinktemplate);
+  self->sinkpad = gst_ghost_pad_new_no_target_from_template ("sink", templ);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->sinkpad);
+  gst_object_unref (templ);
+
+  templ = gst_static_pad_template_get (&srctemplate);
+  self->srcpad = gst_ghost_pad_new_no_target_from_template ("src", templ);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->srcpad);
+  gst_object_unref (templ);
+
+  if ((self->tee = make_tee (self))) {
+    pad = gst_element_get_static_pad (self->tee, "sink");
+    gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->sinkpad), pad);
+    gst_object_unref (pad);
+  } else {
+    GST_WARNING_OBJECT (self, "no tee element");
+  }
+}
@@ -0,0 +1,64 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/gst.h>
+
+#ifndef __GST_PLAY_SINK_VIDEO_FANOUT_H__
+#define __GST_PLAY_SINK_VIDEO_FANOUT_H__
+
+G_BEGIN_DECLS
+#define GST_TYPE_PLAY_SINK_VIDEO_FANOUT \
+  (gst_play_sink_video_fanout_get_type())
+#define GST_PLAY_SINK_VIDEO_FANOUT(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_PLAY_SINK_VIDEO_FANOUT, GstPlaySinkVideoFanout))
+#define GST_PLAY_SINK_VIDEO_FANOUT_CAST(obj) \
+  ((GstPlaySinkVideoFanout *) obj)
+#define GST_PLAY_SINK_VIDEO_FANOUT_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_PLAY_SINK_VIDEO_FANOUT, GstPlaySinkVideoFanoutClass))
+#define GST_IS_PLAY_SINK_VIDEO_FANOUT(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_PLAY_SINK_VIDEO_FANOUT))
+#define GST_IS_PLAY_SINK_VIDEO_FANOUT_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_PLAY_SINK_VIDEO_FANOUT))
+typedef struct _GstPlaySinkVideoFanout GstPlaySinkVideoFanout;
+typedef struct _GstPlaySinkVideoFanoutClass GstPlaySinkVideoFanoutClass;
+
+struct _GstPlaySinkVideoFanout
+{
+  GstBin parent;
+
+  /* < private > */
+  GstPad *sinkpad, *srcpad;
+  GstElement *tee;
+  GList *branches;              /* one per distinct sink caps */
+  gboolean finished;            /* the main output is linked */
+};
+
+struct _GstPlaySinkVideoFanoutClass
+{
+  GstBinClass parent;
+};
+
+GType gst_play_sink_video_fanout_get_type (void);
+
+gboolean gst_play_sink_video_fanout_add_sink (GstPlaySinkVideoFanout * self,
+    GstElement * sink);
+gboolean gst_play_sink_video_fanout_finish (GstPlaySinkVideoFanout * self);
+
+G_END_DECLS
+#endif /* __GST_PLAY_SINK_VIDEO_FANOUT_H__ */
@@ -43,6 +43,24 @@ GST_DEBUG_CATEGORY_STATIC (stream_synchronizer_debug);
     g_mutex_unlock (&GST_STREAM_SYNCHRONIZER_CAST(obj)->lock);              \
 } G_STMT_END
 
+/* protects the position and seen_data of a stream, which are updated for
+ * every buffer without taking the synchronizer lock. Lock order is the
+ * synchronizer lock first, then the stream lock */
+#define GST_SYNC_STREAM_LOCK(stream) g_mutex_lock (&(stream)->lock)
+#define GST_SYNC_STREAM_UNLOCK(stream) g_mutex_unlock (&(stream)->lock)
+
+/* how late a buffer can be before it is dropped in fast-start mode, the
+ * same as the default max-lateness of the video sinks */
+#define FAST_START_MAX_LATENESS (20 * GST_MSECOND)
+
+#define DEFAULT_FAST_START FALSE
+
+enum
+{
+  PROP_0,
+  PROP_FAST_START
+};
+
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src_%u",
     GST_PAD_SRC,
     GST_PAD_SOMETIMES,
@@ -71,9 +89,14 @@ typedef struct
   gboolean seen_data;
   GstClockTime gap_duration;
 
+  gboolean is_raw;              /* TRUE if the caps are raw audio or video */
+  gboolean first_pushed;        /* fast-start: first buffer was pushed */
+  gboolean in_sync;             /* fast-start: caught up with the clock */
+
   GstStreamFlags flags;
 
   GCond stream_finish_cond;
+  GMutex lock;
 
   /* seqnum of the previously received STREAM_START
    * default: G_MAXUINT32 */
@@ -116,6 +139,23 @@ out:
   return opad;
 }
 
+/* Must be called with lock! Keeps the number of EOS streams up to date so
+ * that the streaming threads only need the lock when there are EOS streams
+ * to advance */
+static void
+gst_sync_stream_set_eos (GstStreamSynchronizer * self, GstSyncStream * stream,
+    gboolean is_eos)
+{
+  if (stream->is_eos == is_eos)
+    return;
+
+  stream->is_eos = is_eos;
+  if (is_eos)
+    g_atomic_int_inc (&self->n_eos);
+  else
+    g_atomic_int_add (&self->n_eos, -1);
+}
+
 /* Generic pad functions */
 static GstIterator *
 gst_stream_synchronizer_iterate_internal_links (GstPad * pad,
@@ -196,6 +236,15 @@ gst_stream_synchronizer_src_event (GstPad * pad, GstObject * parent,
           timestamp);
       break;
     }
+    case GST_EVENT_LATENCY:{
+      GstClockTime latency;
+
+      gst_event_parse_latency (event, &latency);
+      GST_OBJECT_LOCK (self);
+      self->latency = latency;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    }
     default:
       break;
   }
@@ -304,9 +353,11 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
 
       if ((have_group_id && stream->group_id != group_id) || (!have_group_id
               && stream->stream_start_seqnum != seqnum)) {
-        stream->is_eos = FALSE;
+        gst_sync_stream_set_eos (self, stream, FALSE);
         stream->eos_sent = FALSE;
         stream->flushing = FALSE;
+        stream->first_pushed = FALSE;
+        stream->in_sync = FALSE;
         stream->stream_start_seqnum = seqnum;
         stream->group_id = group_id;
 
@@ -369,16 +420,21 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
             GstSyncStream *ostream = l->data;
             gint64 stop_running_time;
             gint64 position_running_time;
+            guint64 ostream_position;
 
             ostream->wait = FALSE;
 
             if (ostream->segment.format == GST_FORMAT_TIME) {
+              GST_SYNC_STREAM_LOCK (ostream);
+              ostream_position = ostream->segment.position;
+              GST_SYNC_STREAM_UNLOCK (ostream);
+
               stop_running_time =
                   gst_segment_to_running_time (&ostream->segment,
                   GST_FORMAT_TIME, ostream->segment.stop);
               position_running_time =
                   gst_segment_to_running_time (&ostream->segment,
-                  GST_FORMAT_TIME, ostream->segment.position);
+                  GST_FORMAT_TIME, ostream_position);
 
               position_running_time =
                   MAX (position_running_time, stop_running_time);
@@ -456,6 +512,22 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
       GST_STREAM_SYNCHRONIZER_UNLOCK (self);
       break;
     }
+    case GST_EVENT_CAPS:{
+      GstSyncStream *stream;
+      GstCaps *caps;
+      const gchar *name;
+
+      gst_event_parse_caps (event, &caps);
+      name = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+
+      GST_STREAM_SYNCHRONIZER_LOCK (self);
+      stream = gst_pad_get_element_private (pad);
+      if (stream)
+        stream->is_raw = g_str_equal (name, "audio/x-raw")
+            || g_str_equal (name, "video/x-raw");
+      GST_STREAM_SYNCHRONIZER_UNLOCK (self);
+      break;
+    }
     case GST_EVENT_FLUSH_START:{
       GstSyncStream *stream;
 
@@ -482,10 +554,12 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
             stream->stream_number);
         gst_segment_init (&stream->segment, GST_FORMAT_UNDEFINED);
 
-        stream->is_eos = FALSE;
+        gst_sync_stream_set_eos (self, stream, FALSE);
         stream->eos_sent = FALSE;
         stream->flushing = FALSE;
         stream->wait = FALSE;
+        stream->first_pushed = FALSE;
+        stream->in_sync = FALSE;
         g_cond_broadcast (&stream->stream_finish_cond);
       }
 
@@ -523,7 +597,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         GST_STREAM_SYNCHRONIZER_LOCK (self);
         stream = gst_pad_get_element_private (pad);
         if (stream) {
-          stream->is_eos = FALSE;
+          gst_sync_stream_set_eos (self, stream, FALSE);
           stream->eos_sent = FALSE;
           stream->wait = FALSE;
           g_cond_broadcast (&stream->stream_finish_cond);
@@ -550,11 +624,12 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
       }
 
       GST_DEBUG_OBJECT (pad, "Have EOS for stream %d", stream->stream_number);
-      stream->is_eos = TRUE;
+      gst_sync_stream_set_eos (self, stream, TRUE);
 
-      seen_data = stream->seen_data;
       srcpad = gst_object_ref (stream->srcpad);
 
+      GST_SYNC_STREAM_LOCK (stream);
+      seen_data = stream->seen_data;
       if (seen_data && stream->segment.position != -1)
         timestamp = stream->segment.position;
       else if (stream->segment.rate < 0.0 || stream->segment.stop == -1)
@@ -563,6 +638,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         timestamp = stream->segment.stop;
 
       stream->segment.position = timestamp;
+      GST_SYNC_STREAM_UNLOCK (stream);
 
       for (l = self->streams; l; l = l->next) {
         GstSyncStream *ostream = l->data;
@@ -643,6 +719,64 @@ done:
   return ret;
 }
 
+/* must be called from the streaming thread of @stream. In fast-start mode the
+ * sinks don't wait for all streams to preroll, a stream that is ready later
+ * starts behind the clock. Its first buffer is always let through so that
+ * something is rendered, after that we drop what the sink would drop
+ * anyway until the stream has caught up. */
+static gboolean
+gst_stream_synchronizer_is_late (GstStreamSynchronizer * self,
+    GstSyncStream * stream, GstClockTime timestamp_end)
+{
+  GstClock *clock;
+  GstClockTime base_time, now, running_time, latency;
+
+  if (!self->fast_start || stream->in_sync || !stream->is_raw
+      || (stream->flags & GST_STREAM_FLAG_SPARSE)
+      || stream->segment.format != GST_FORMAT_TIME
+      || stream->segment.rate < 0.0 || !GST_CLOCK_TIME_IS_VALID (timestamp_end))
+    return FALSE;
+
+  if (!stream->first_pushed) {
+    stream->first_pushed = TRUE;
+    return FALSE;
+  }
+
+  if (GST_STATE (self) != GST_STATE_PLAYING)
+    return FALSE;
+
+  running_time =
+      gst_segment_to_running_time (&stream->segment, GST_FORMAT_TIME,
+      timestamp_end);
+  if (!GST_CLOCK_TIME_IS_VALID (running_time))
+    return FALSE;
+
+  GST_OBJECT_LOCK (self);
+  clock = GST_ELEMENT_CLOCK (self);
+  if (!clock) {
+    GST_OBJECT_UNLOCK (self);
+    return FALSE;
+  }
+  gst_object_ref (clock);
+  base_time = GST_ELEMENT_CAST (self)->base_time;
+  latency = self->latency;
+  GST_OBJECT_UNLOCK (self);
+
+  now = gst_clock_get_time (clock);
+  gst_object_unref (clock);
+
+  if (now < base_time ||
+      running_time + latency + FAST_START_MAX_LATENESS >=
+      now - base_time) {
+    GST_DEBUG_OBJECT (stream->sinkpad, "Stream %d is in sync now",
+        stream->stream_number);
+    stream->in_sync = TRUE;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer)
@@ -654,6 +788,7 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
   GstClockTime duration = GST_CLOCK_TIME_NONE;
   GstClockTime timestamp = GST_CLOCK_TIME_NONE;
   GstClockTime timestamp_end = GST_CLOCK_TIME_NONE;
+  gboolean late = FALSE;
 
   GST_LOG_OBJECT (pad, "Handling buffer %p: size=%" G_GSIZE_FORMAT
       ", timestamp=%" GST_TIME_FORMAT " duration=%" GST_TIME_FORMAT
@@ -669,26 +804,37 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       && GST_CLOCK_TIME_IS_VALID (duration))
     timestamp_end = timestamp + duration;
 
-  GST_STREAM_SYNCHRONIZER_LOCK (self);
+  /* the stream is only freed after the sinkpad is deactivated, which waits
+   * for us to return, so we can use it without the synchronizer lock */
   stream = gst_pad_get_element_private (pad);
+  if (!stream) {
+    GST_WARNING_OBJECT (pad, "Trying to get other pad after releasing");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
 
-  if (stream) {
-    stream->seen_data = TRUE;
-    if (stream->segment.format == GST_FORMAT_TIME
-        && GST_CLOCK_TIME_IS_VALID (timestamp)) {
-      GST_LOG_OBJECT (pad,
-          "Updating position from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (stream->segment.position), GST_TIME_ARGS (timestamp));
-      if (stream->segment.rate > 0.0)
-        stream->segment.position = timestamp;
-      else
-        stream->segment.position = timestamp_end;
-    }
+  GST_SYNC_STREAM_LOCK (stream);
+  stream->seen_data = TRUE;
+  if (stream->segment.format == GST_FORMAT_TIME
+      && GST_CLOCK_TIME_IS_VALID (timestamp)) {
+    GST_LOG_OBJECT (pad,
+        "Updating position from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (stream->segment.position), GST_TIME_ARGS (timestamp));
+    if (stream->segment.rate > 0.0)
+      stream->segment.position = timestamp;
+    else
+      stream->segment.position = timestamp_end;
   }
-  GST_STREAM_SYNCHRONIZER_UNLOCK (self);
+  GST_SYNC_STREAM_UNLOCK (stream);
 
-  opad = gst_stream_get_other_pad_from_pad (self, pad);
-  if (opad) {
+  late = gst_stream_synchronizer_is_late (self, stream, timestamp_end);
+
+  if (late) {
+    GST_LOG_OBJECT (pad, "Dropping late buffer for fast start");
+    gst_buffer_unref (buffer);
+    ret = GST_FLOW_OK;
+  } else {
+    opad = gst_object_ref (stream->srcpad);
     ret = gst_pad_push (opad, buffer);
     gst_object_unref (opad);
   }
@@ -697,9 +843,7 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
   if (ret == GST_FLOW_OK) {
     GList *l;
 
-    GST_STREAM_SYNCHRONIZER_LOCK (self);
-    stream = gst_pad_get_element_private (pad);
-    if (stream && stream->segment.format == GST_FORMAT_TIME) {
+    if (stream->segment.format == GST_FORMAT_TIME) {
       GstClockTime position;
 
       if (stream->segment.rate > 0.0)
@@ -708,13 +852,19 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
         position = timestamp;
 
       if (GST_CLOCK_TIME_IS_VALID (position)) {
+        GST_SYNC_STREAM_LOCK (stream);
         GST_LOG_OBJECT (pad,
             "Updating position from %" GST_TIME_FORMAT " to %" GST_TIME_FORMAT,
             GST_TIME_ARGS (stream->segment.position), GST_TIME_ARGS (position));
         stream->segment.position = position;
+        GST_SYNC_STREAM_UNLOCK (stream);
       }
     }
 
+    /* nothing to advance, don't bother the other streams */
+    if (g_atomic_int_get (&self->n_eos) == 0)
+      return ret;
+
     /* Advance EOS streams if necessary. For non-EOS
      * streams the demuxers should already do this! */
     if (!GST_CLOCK_TIME_IS_VALID (timestamp_end) &&
@@ -722,6 +872,7 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       timestamp_end = timestamp + GST_SECOND;
     }
 
+    GST_STREAM_SYNCHRONIZER_LOCK (self);
     for (l = self->streams; l; l = l->next) {
       GstSyncStream *ostream = l->data;
       gint64 position;
@@ -730,6 +881,7 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
           ostream->segment.format != GST_FORMAT_TIME)
         continue;
 
+      GST_SYNC_STREAM_LOCK (ostream);
       if (ostream->segment.position != -1)
         position = ostream->segment.position;
       else
@@ -748,10 +900,13 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
             GST_TIME_ARGS (new_start));
 
         ostream->segment.position = new_start;
+        GST_SYNC_STREAM_UNLOCK (ostream);
 
         self->send_gap_event = TRUE;
         ostream->gap_duration = new_start - position;
         g_cond_broadcast (&ostream->stream_finish_cond);
+      } else {
+        GST_SYNC_STREAM_UNLOCK (ostream);
       }
     }
     GST_STREAM_SYNCHRONIZER_UNLOCK (self);
@@ -777,6 +932,7 @@ gst_stream_synchronizer_request_new_pad (GstElement * element,
   stream->transform = self;
   stream->stream_number = self->current_stream_number;
   g_cond_init (&stream->stream_finish_cond);
+  g_mutex_init (&stream->lock);
   stream->stream_start_seqnum = G_MAXUINT32;
   stream->segment_seqnum = G_MAXUINT32;
   stream->group_id = G_MAXUINT;
@@ -843,6 +999,7 @@ gst_stream_synchronizer_release_stream (GstStreamSynchronizer * self,
     }
   }
   g_assert (l != NULL);
+  gst_sync_stream_set_eos (self, stream, FALSE);
   if (self->streams == NULL) {
     self->have_group_id = TRUE;
     self->group_id = G_MAXUINT;
@@ -861,6 +1018,7 @@ gst_stream_synchronizer_release_stream (GstStreamSynchronizer * self,
   gst_element_remove_pad (GST_ELEMENT_CAST (self), stream->sinkpad);
 
   g_cond_clear (&stream->stream_finish_cond);
+  g_mutex_clear (&stream->lock);
   g_slice_free (GstSyncStream, stream);
 
   /* NOTE: In theory we have to check here if all streams
@@ -972,7 +1130,7 @@ gst_stream_synchronizer_change_state (GstElement * element,
         gst_segment_init (&stream->segment, GST_FORMAT_UNDEFINED);
         stream->gap_duration = GST_CLOCK_TIME_NONE;
         stream->wait = FALSE;
-        stream->is_eos = FALSE;
+        gst_sync_stream_set_eos (self, stream, FALSE);
         stream->eos_sent = FALSE;
         stream->flushing = FALSE;
       }
@@ -1005,11 +1163,48 @@ gst_stream_synchronizer_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_stream_synchronizer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstStreamSynchronizer *self = GST_STREAM_SYNCHRONIZER (object);
+
+  switch (prop_id) {
+    case PROP_FAST_START:
+      GST_STREAM_SYNCHRONIZER_LOCK (self);
+      self->fast_start = g_value_get_boolean (value);
+      GST_STREAM_SYNCHRONIZER_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_stream_synchronizer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstStreamSynchronizer *self = GST_STREAM_SYNCHRONIZER (object);
+
+  switch (prop_id) {
+    case PROP_FAST_START:
+      GST_STREAM_SYNCHRONIZER_LOCK (self);
+      g_value_set_boolean (value, self->fast_start);
+      GST_STREAM_SYNCHRONIZER_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 /* GObject type initialization */
 static void
 gst_stream_synchronizer_init (GstStreamSynchronizer * self)
 {
   g_mutex_init (&self->lock);
+  self->fast_start = DEFAULT_FAST_START;
 }
 
 static void
@@ -1019,6 +1214,14 @@ gst_stream_synchronizer_class_init (GstStreamSynchronizerClass * klass)
   GstElementClass *element_class = (GstElementClass *) klass;
 
   gobject_class->finalize = gst_stream_synchronizer_finalize;
+  gobject_class->set_property = gst_stream_synchronizer_set_property;
+  gobject_class->get_property = gst_stream_synchronizer_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_FAST_START,
+      g_param_spec_boolean ("fast-start", "Fast start",
+          "Drop buffers of streams that start behind the clock until they "
+          "caught up", DEFAULT_FAST_START,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (element_class, &srctemplate);
   gst_element_class_add_static_pad_template (element_class, &sinktemplate);
@@ -53,11 +53,15 @@ struct _GstStreamSynchronizer
 
   GList *streams;
   guint current_stream_number;
+  gint n_eos;                   /* atomic, number of streams with is_eos */
 
   GstClockTime group_start_time;
 
   gboolean have_group_id;
   guint group_id;
+
+  gboolean fast_start;
+  GstClockTime latency;
 };
 
 struct _GstStreamSynchronizerClass
@@ -117,6 +117,17 @@ struct _GstURIDecodeBin
   gboolean expose_allstreams;   /* Whether to expose unknow type streams or not */
 
   guint64 ring_buffer_max_size; /* 0 means disabled */
+
+  gboolean parallel_autoplug;   /* propagated to decodebin */
+  gboolean reuse_decoders;      /* propagated to decodebin */
+
+  /* bandwidth estimation from the queue statistics, protected by the
+   * object lock */
+  gboolean adaptive_buffering;
+  gdouble bandwidth;            /* EWMA of the download rate, bits/s */
+  guint64 posted_bandwidth;     /* last posted estimate */
+  guint64 adaptive_time;        /* last configured max-size-time */
+  gint adaptive_high_percent;   /* last configured high-percent */
 };
 
 struct _GstURIDecodeBinClass
@@ -183,6 +194,19 @@ enum
 #define DEFAULT_USE_BUFFERING       FALSE
 #define DEFAULT_EXPOSE_ALL_STREAMS  TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+#define DEFAULT_PARALLEL_AUTOPLUG   FALSE
+#define DEFAULT_REUSE_DECODERS      FALSE
+#define DEFAULT_ADAPTIVE_BUFFERING  FALSE
+
+/* weight of a new rate measurement in the bandwidth estimate */
+#define BANDWIDTH_EWMA_WEIGHT       0.2
+/* post a new estimate when it changed this much */
+#define BANDWIDTH_POST_THRESHOLD    0.1
+/* buffer duration when buffer-duration is not set, the queue2 default */
+#define ADAPTIVE_BASE_TIME          (2 * GST_SECOND)
+#define ADAPTIVE_MIN_HIGH_PERCENT   20
+#define ADAPTIVE_MAX_HIGH_PERCENT   99
+#define ADAPTIVE_LOW_PERCENT        10
 
 enum
 {
@@ -197,7 +221,11 @@ enum
   PROP_DOWNLOAD,
   PROP_USE_BUFFERING,
   PROP_EXPOSE_ALL_STREAMS,
-  PROP_RING_BUFFER_MAX_SIZE
+  PROP_RING_BUFFER_MAX_SIZE,
+  PROP_PARALLEL_AUTOPLUG,
+  PROP_REUSE_DECODERS,
+  PROP_ADAPTIVE_BUFFERING,
+  PROP_ESTIMATED_BANDWIDTH
 };
 
 static guint gst_uri_decode_bin_signals[LAST_SIGNAL] = { 0 };
@@ -485,9 +513,14 @@ gst_uri_decode_bin_class_init (GstURIDecodeBinClass * klass)
   /**
    * GstURIDecodeBin::ring-buffer-max-size
    *
-   * The maximum size of the ring buffer in kilobytes. If set to 0, the ring
+   * The maximum size of the ring buffer in bytes. If set to 0, the ring
    * buffer is disabled. Default is 0.
    *
+   * With #GstURIDecodeBin:download the ring buffer is kept in the temporary
+   * file, which then never grows beyond this size. Seeks within the data in
+   * the ring buffer are handled locally, other seeks are done upstream. When
+   * upstream can't seek the whole media is downloaded instead.
+   *
    * Since: 0.10.31
    */
   g_object_class_install_property (gobject_class, PROP_RING_BUFFER_MAX_SIZE,
@@ -497,6 +530,68 @@ gst_uri_decode_bin_class_init (GstURIDecodeBinClass * klass)
           0, G_MAXUINT, DEFAULT_RING_BUFFER_MAX_SIZE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstURIDecodeBin::parallel-autoplug
+   *
+   * Connect the streams of demuxers in parallel, see the property of the
+   * same name on decodebin.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL_AUTOPLUG,
+      g_param_spec_boolean ("parallel-autoplug", "Parallel Autoplug",
+          "Connect the streams of demuxers in parallel",
+          DEFAULT_PARALLEL_AUTOPLUG,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstURIDecodeBin::reuse-decoders
+   *
+   * Keep the decoders when switching to another uri and reuse them for
+   * streams with the same caps, see the property of the same name on
+   * decodebin.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_REUSE_DECODERS,
+      g_param_spec_boolean ("reuse-decoders", "Reuse Decoders",
+          "Keep decoders and reuse them for streams with the same caps",
+          DEFAULT_REUSE_DECODERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstURIDecodeBin::adaptive-buffering
+   *
+   * Tune the max-size-time and the high and low percentages of the
+   * buffering queue with the ratio between the estimated bandwidth and the
+   * bitrate of the stream. When the bandwidth is close to or below the
+   * bitrate, more is buffered before playback starts; when it is much
+   * higher, less is buffered.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ADAPTIVE_BUFFERING,
+      g_param_spec_boolean ("adaptive-buffering", "Adaptive Buffering",
+          "Tune the buffering limits with the estimated bandwidth",
+          DEFAULT_ADAPTIVE_BUFFERING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstURIDecodeBin::estimated-bandwidth
+   *
+   * The download rate in bits per second, averaged over the statistics of
+   * the buffering messages of the queue, or 0 when unknown. Whenever it
+   * changes significantly, an element message named "bandwidth-estimate" is
+   * posted with the "bandwidth" (guint64, bits per second) and the "bitrate"
+   * (gint, bits per second or -1 when unknown) of the stream.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ESTIMATED_BANDWIDTH,
+      g_param_spec_uint64 ("estimated-bandwidth", "Estimated Bandwidth",
+          "Estimated download rate in bits per second (0 = unknown)",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstURIDecodeBin::unknown-type:
    * @bin: The uridecodebin.
@@ -740,6 +835,9 @@ gst_uri_decode_bin_init (GstURIDecodeBin * dec)
   dec->use_buffering = DEFAULT_USE_BUFFERING;
   dec->expose_allstreams = DEFAULT_EXPOSE_ALL_STREAMS;
   dec->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
+  dec->parallel_autoplug = DEFAULT_PARALLEL_AUTOPLUG;
+  dec->reuse_decoders = DEFAULT_REUSE_DECODERS;
+  dec->adaptive_buffering = DEFAULT_ADAPTIVE_BUFFERING;
 
   GST_OBJECT_FLAG_SET (dec, GST_ELEMENT_FLAG_SOURCE);
 }
@@ -830,6 +928,17 @@ gst_uri_decode_bin_set_property (GObject * object, guint prop_id,
     case PROP_RING_BUFFER_MAX_SIZE:
       dec->ring_buffer_max_size = g_value_get_uint64 (value);
       break;
+    case PROP_PARALLEL_AUTOPLUG:
+      dec->parallel_autoplug = g_value_get_boolean (value);
+      break;
+    case PROP_REUSE_DECODERS:
+      dec->reuse_decoders = g_value_get_boolean (value);
+      break;
+    case PROP_ADAPTIVE_BUFFERING:
+      GST_OBJECT_LOCK (dec);
+      dec->adaptive_buffering = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -890,6 +999,22 @@ gst_uri_decode_bin_get_property (GObject * object, guint prop_id,
     case PROP_RING_BUFFER_MAX_SIZE:
       g_value_set_uint64 (value, dec->ring_buffer_max_size);
       break;
+    case PROP_PARALLEL_AUTOPLUG:
+      g_value_set_boolean (value, dec->parallel_autoplug);
+      break;
+    case PROP_REUSE_DECODERS:
+      g_value_set_boolean (value, dec->reuse_decoders);
+      break;
+    case PROP_ADAPTIVE_BUFFERING:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_boolean (value, dec->adaptive_buffering);
+      GST_OBJECT_UNLOCK (dec);
+      break;
+    case PROP_ESTIMATED_BANDWIDTH:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint64 (value, (guint64) dec->bandwidth);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1037,21 +1162,17 @@ source_no_more_pads (GstElement * element, GstURIDecodeBin * bin)
   no_more_pads_full (element, FALSE, bin);
 }
 
-static void
-configure_stream_buffering (GstURIDecodeBin * decoder)
+/* the combined bitrate of all streams, -1 when not all streams have one.
+ * Call with the uridecodebin lock */
+static gint
+get_stream_bitrate (GstURIDecodeBin * decoder)
 {
-  GstElement *queue = NULL;
   GHashTableIter iter;
   gpointer key, value;
   gint bitrate = 0;
 
-  /* automatic configuration enabled ? */
-  if (decoder->buffer_size != -1)
-    return;
-
-  GST_URI_DECODE_BIN_LOCK (decoder);
-  if (decoder->queue)
-    queue = gst_object_ref (decoder->queue);
+  if (!decoder->streams)
+    return -1;
 
   g_hash_table_iter_init (&iter, decoder->streams);
   while (g_hash_table_iter_next (&iter, &key, &value)) {
@@ -1062,6 +1183,23 @@ configure_stream_buffering (GstURIDecodeBin * decoder)
     else
       bitrate = -1;
   }
+  return bitrate;
+}
+
+static void
+configure_stream_buffering (GstURIDecodeBin * decoder)
+{
+  GstElement *queue = NULL;
+  gint bitrate;
+
+  /* automatic configuration enabled ? */
+  if (decoder->buffer_size != -1)
+    return;
+
+  GST_URI_DECODE_BIN_LOCK (decoder);
+  if (decoder->queue)
+    queue = gst_object_ref (decoder->queue);
+  bitrate = get_stream_bitrate (decoder);
   GST_URI_DECODE_BIN_UNLOCK (decoder);
 
   GST_DEBUG_OBJECT (decoder, "overall bitrate %d", bitrate);
@@ -1838,9 +1976,12 @@ make_decoder (GstURIDecodeBin * decoder)
   if (decoder->caps)
     g_object_set (decodebin, "caps", decoder->caps, NULL);
 
-  /* Propagate expose-all-streams and connection-speed properties */
+  /* Propagate expose-all-streams, connection-speed, parallel-autoplug and
+   * reuse-decoders properties */
   g_object_set (decodebin, "expose-all-streams", decoder->expose_allstreams,
-      "connection-speed", decoder->connection_speed / 1000, NULL);
+      "connection-speed", decoder->connection_speed / 1000,
+      "parallel-autoplug", decoder->parallel_autoplug,
+      "reuse-decoders", decoder->reuse_decoders, NULL);
 
   if (!decoder->is_stream || decoder->is_adaptive) {
     /* propagate the use-buffering property but only when we are not already
@@ -1903,7 +2044,7 @@ type_found (GstElement * typefind, guint probability,
   GstElement *src_elem, *dec_elem, *queue = NULL;
   GstStructure *s;
   const gchar *media_type, *elem_name;
-  gboolean do_download = FALSE;
+  gboolean do_download = FALSE, ring_buffer = FALSE;
 
   GST_DEBUG_OBJECT (decoder, "typefind found caps %" GST_PTR_FORMAT, caps);
 
@@ -1918,6 +2059,19 @@ type_found (GstElement * typefind, guint probability,
 
     do_download = (gst_element_query_duration (typefind, GST_FORMAT_BYTES, &dur)
         && dur != -1);
+
+    /* data that fell out of a ring buffer can only be read again when
+     * upstream can seek, otherwise keep all of it */
+    if (do_download && decoder->ring_buffer_max_size > 0) {
+      GstQuery *query = gst_query_new_seeking (GST_FORMAT_BYTES);
+
+      if (gst_element_query (typefind, query))
+        gst_query_parse_seeking (query, NULL, &ring_buffer, NULL, NULL);
+      gst_query_unref (query);
+
+      if (!ring_buffer)
+        GST_INFO_OBJECT (decoder, "upstream not seekable, downloading all");
+    }
   }
 
   dec_elem = make_decoder (decoder);
@@ -1927,7 +2081,7 @@ type_found (GstElement * typefind, guint probability,
   if (decoder->is_adaptive) {
     src_elem = typefind;
   } else {
-    if (do_download) {
+    if (do_download && !ring_buffer) {
       elem_name = "downloadbuffer";
     } else {
       elem_name = "queue2";
@@ -1961,6 +2115,14 @@ type_found (GstElement * typefind, guint probability,
       /* configure progressive download for selected media types */
       g_object_set (queue, "temp-template", temp_template, NULL);
 
+      /* queue2 keeps its ring buffer in the temp file then */
+      if (ring_buffer) {
+        GST_DEBUG_OBJECT (decoder, "limit download to %" G_GUINT64_FORMAT
+            " bytes", decoder->ring_buffer_max_size);
+        g_object_set (queue, "use-buffering", TRUE, "ring-buffer-max-size",
+            decoder->ring_buffer_max_size, "max-size-buffers", 0, NULL);
+      }
+
       g_free (filename);
       g_free (temp_template);
     } else {
@@ -2406,6 +2568,122 @@ handle_redirect_message (GstURIDecodeBin * dec, GstMessage * msg)
   return new_msg;
 }
 
+/* Configure the limits of @queue for a stream of @bitrate that is received
+ * at @bandwidth, both in bits per second. The less the bandwidth exceeds the
+ * bitrate, the more we buffer and the fuller the queue must be before
+ * playback starts. */
+static void
+configure_adaptive_buffering (GstURIDecodeBin * dec, GstElement * queue,
+    guint64 bandwidth, gint bitrate)
+{
+  guint64 base_time, time;
+  gint high, low;
+  gdouble ratio;
+
+  GST_OBJECT_LOCK (dec);
+  base_time = dec->buffer_duration != -1 ? dec->buffer_duration :
+      ADAPTIVE_BASE_TIME;
+  GST_OBJECT_UNLOCK (dec);
+
+  ratio = (gdouble) bandwidth / bitrate;
+  if (ratio <= 1.0) {
+    /* we can't keep up, buffer as much as we can */
+    time = 4 * base_time;
+    high = ADAPTIVE_MAX_HIGH_PERCENT;
+  } else {
+    time = CLAMP ((guint64) (2 * base_time / ratio), base_time / 2,
+        4 * base_time);
+    high = CLAMP ((gint) (100.0 / ratio), ADAPTIVE_MIN_HIGH_PERCENT,
+        ADAPTIVE_MAX_HIGH_PERCENT);
+  }
+  low = MIN (ADAPTIVE_LOW_PERCENT, high / 2);
+
+  GST_OBJECT_LOCK (dec);
+  if (time == dec->adaptive_time && high == dec->adaptive_high_percent) {
+    GST_OBJECT_UNLOCK (dec);
+    return;
+  }
+  dec->adaptive_time = time;
+  dec->adaptive_high_percent = high;
+  GST_OBJECT_UNLOCK (dec);
+
+  GST_DEBUG_OBJECT (dec, "bandwidth %" G_GUINT64_FORMAT ", bitrate %d: "
+      "max-size-time %" GST_TIME_FORMAT ", high %d%%, low %d%%", bandwidth,
+      bitrate, GST_TIME_ARGS (time), high, low);
+
+  g_object_set (queue, "max-size-time", time, "high-percent", high,
+      "low-percent", low, NULL);
+  if (dec->buffer_size == -1)
+    g_object_set (queue, "max-size-bytes",
+        (guint) gst_util_uint64_scale (time, bitrate, 8 * GST_SECOND), NULL);
+}
+
+/* update the bandwidth estimate with the statistics of a buffering message
+ * of our queue */
+static void
+update_bandwidth_estimate (GstURIDecodeBin * dec, GstMessage * msg)
+{
+  GstElement *queue = NULL;
+  gint avg_in, avg_out, bitrate;
+  gdouble rate, change;
+  guint64 bandwidth;
+  gboolean post, adaptive;
+
+  gst_message_parse_buffering_stats (msg, NULL, &avg_in, &avg_out, NULL);
+  if (avg_in <= 0)
+    return;
+
+  GST_URI_DECODE_BIN_LOCK (dec);
+  if (dec->queue && GST_MESSAGE_SRC (msg) == GST_OBJECT_CAST (dec->queue))
+    queue = gst_object_ref (dec->queue);
+  bitrate = get_stream_bitrate (dec);
+  GST_URI_DECODE_BIN_UNLOCK (dec);
+
+  if (!queue)
+    return;
+
+  rate = avg_in * 8.0;
+
+  GST_OBJECT_LOCK (dec);
+  if (dec->bandwidth == 0.0)
+    dec->bandwidth = rate;
+  else
+    dec->bandwidth = BANDWIDTH_EWMA_WEIGHT * rate +
+        (1.0 - BANDWIDTH_EWMA_WEIGHT) * dec->bandwidth;
+  bandwidth = (guint64) dec->bandwidth;
+
+  change = dec->posted_bandwidth ?
+      ABS ((gdouble) bandwidth - dec->posted_bandwidth) /
+      dec->posted_bandwidth : 1.0;
+  post = change >= BANDWIDTH_POST_THRESHOLD;
+  if (post)
+    dec->posted_bandwidth = bandwidth;
+  adaptive = dec->adaptive_buffering;
+  GST_OBJECT_UNLOCK (dec);
+
+  GST_LOG_OBJECT (dec, "rate in %d, out %d bytes/s, estimate %"
+      G_GUINT64_FORMAT " bits/s", avg_in, avg_out, bandwidth);
+
+  if (post) {
+    g_object_notify (G_OBJECT (dec), "estimated-bandwidth");
+    gst_element_post_message (GST_ELEMENT_CAST (dec),
+        gst_message_new_element (GST_OBJECT_CAST (dec),
+            gst_structure_new ("bandwidth-estimate",
+                "bandwidth", G_TYPE_UINT64, bandwidth,
+                "bitrate", G_TYPE_INT, bitrate, NULL)));
+  }
+
+  /* without bitrate tags, the rate at which the data is consumed is the
+   * best guess */
+  if (bitrate <= 0 && avg_out > 0)
+    bitrate = avg_out * 8;
+
+  if (adaptive && bitrate > 0)
+    configure_adaptive_buffering (dec, queue, bandwidth, bitrate);
+
+  gst_object_unref (queue);
+}
+
 static void
 handle_message (GstBin * bin, GstMessage * msg)
 {
@@ -2422,6 +2700,9 @@ handle_message (GstBin * bin, GstMessage * msg)
       }
       break;
     }
+    case GST_MESSAGE_BUFFERING:
+      update_bandwidth_estimate (dec, msg);
+      break;
     case GST_MESSAGE_ERROR:{
       GError *err = NULL;
 
@@ -2787,6 +3068,11 @@ gst_uri_decode_bin_change_state (GstElement * element,
       g_list_free_full (decoder->missing_plugin_errors,
           (GDestroyNotify) gst_message_unref);
       decoder->missing_plugin_errors = NULL;
+      /* keep the bandwidth estimate for the next uri, the queue is new */
+      GST_OBJECT_LOCK (decoder);
+      decoder->adaptive_time = 0;
+      decoder->adaptive_high_percent = 0;
+      GST_OBJECT_UNLOCK (decoder);
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       GST_DEBUG ("ready to null");
@@ -120,6 +120,11 @@ gst_sub_parse_dispose (GObject * object)
     subparse->textbuf = NULL;
   }
 
+  if (subparse->index) {
+    g_array_free (subparse->index, TRUE);
+    subparse->index = NULL;
+  }
+
   GST_CALL_PARENT (G_OBJECT_CLASS, dispose, (object));
 }
 
@@ -185,6 +190,10 @@ gst_sub_parse_init (GstSubParse * subparse)
   subparse->encoding = g_strdup (DEFAULT_ENCODING);
   subparse->detected_encoding = NULL;
   subparse->adapter = gst_adapter_new ();
+  subparse->index = g_array_new (FALSE, FALSE, sizeof (GstSubParseIndexEntry));
+  subparse->index_track = TRUE;
+  subparse->index_at_cue = TRUE;
+  subparse->index_max_end = 0;
 
   subparse->fps_n = 24000;
   subparse->fps_d = 1001;
@@ -243,6 +252,90 @@ gst_sub_parse_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return ret;
 }
 
+/* The index maps the cues to the byte offsets in the input, it is built while
+ * parsing. Parsing from an entry gives the same cues as parsing from the
+ * start, except for the ones that ended before max_end. */
+static void
+gst_sub_parse_index_add (GstSubParse * self, guint64 offset)
+{
+  GstSubParseIndexEntry entry;
+  guint len;
+
+  GST_OBJECT_LOCK (self);
+  len = self->index->len;
+  /* we only extend the index, lines before the last entry are known */
+  if (len == 0 || offset > g_array_index (self->index,
+          GstSubParseIndexEntry, len - 1).offset) {
+    entry.offset = offset;
+    entry.max_end = self->index_max_end;
+    g_array_append_val (self->index, entry);
+    GST_LOG_OBJECT (self, "index entry %u at offset %" G_GUINT64_FORMAT
+        ", max end %" GST_TIME_FORMAT, len, offset,
+        GST_TIME_ARGS (entry.max_end));
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* called after a discont at @offset, we can only add to the index when we
+ * resume parsing at the start or at an entry */
+static void
+gst_sub_parse_index_resume (GstSubParse * self, guint64 offset)
+{
+  guint lo = 0, hi;
+
+  self->index_track = (offset == 0);
+  self->index_at_cue = TRUE;
+  self->index_max_end = 0;
+
+  GST_OBJECT_LOCK (self);
+  hi = self->index->len;
+  while (lo < hi) {
+    guint mid = (lo + hi) / 2;
+    GstSubParseIndexEntry *entry =
+        &g_array_index (self->index, GstSubParseIndexEntry, mid);
+
+    if (entry->offset == offset) {
+      self->index_track = TRUE;
+      self->index_max_end = entry->max_end;
+      break;
+    } else if (entry->offset < offset) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "resume at offset %" G_GUINT64_FORMAT
+      ", tracking index %d", offset, self->index_track);
+}
+
+/* byte offset of the last entry where all the previous cues ended before
+ * @time */
+static guint64
+gst_sub_parse_index_find (GstSubParse * self, GstClockTime time)
+{
+  guint64 offset = 0;
+  guint lo = 0, hi;
+
+  GST_OBJECT_LOCK (self);
+  hi = self->index->len;
+  while (lo < hi) {
+    guint mid = (lo + hi) / 2;
+
+    if (g_array_index (self->index, GstSubParseIndexEntry, mid).max_end <=
+        time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo > 0)
+    offset = g_array_index (self->index, GstSubParseIndexEntry, lo - 1).offset;
+  GST_OBJECT_UNLOCK (self);
+
+  return offset;
+}
+
 static gboolean
 gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -260,6 +353,8 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       gint64 start, stop;
       gdouble rate;
       gboolean update;
+      GstSegment seeksegment;
+      guint64 byte_offset = 0;
 
       gst_event_parse_seek (event, &rate, &format, &flags,
           &start_type, &start, &stop_type, &stop);
@@ -270,23 +365,33 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         goto beach;
       }
 
-      /* Convert that seek to a seeking in bytes at position 0,
-         FIXME: could use an index */
+      seeksegment = self->segment;
+      gst_segment_do_seek (&seeksegment, rate, format, flags,
+          start_type, start, stop_type, stop, &update);
+
+      /* Convert that seek to a seeking in bytes at the last cue in the index
+       * before the new start position, or at position 0 */
+      if (rate > 0.0)
+        byte_offset = gst_sub_parse_index_find (self, seeksegment.start);
+
+      GST_DEBUG_OBJECT (self, "seeking to byte offset %" G_GUINT64_FORMAT,
+          byte_offset);
+
       ret = gst_pad_push_event (self->sinkpad,
           gst_event_new_seek (rate, GST_FORMAT_BYTES, flags,
-              GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_NONE, 0));
+              GST_SEEK_TYPE_SET, byte_offset, GST_SEEK_TYPE_NONE, 0));
 
       if (ret) {
         /* Apply the seek to our segment */
-        gst_segment_do_seek (&self->segment, rate, format, flags,
-            start_type, start, stop_type, stop, &update);
+        self->segment = seeksegment;
 
         GST_DEBUG_OBJECT (self, "segment after seek: %" GST_SEGMENT_FORMAT,
             &self->segment);
 
         self->need_segment = TRUE;
       } else {
-        GST_WARNING_OBJECT (self, "seek to 0 bytes failed");
+        GST_WARNING_OBJECT (self, "seek to %" G_GUINT64_FORMAT " bytes failed",
+            byte_offset);
       }
 
       gst_event_unref (event);
@@ -503,15 +608,17 @@ convert_encoding (GstSubParse * self, const gchar * str, gsize len,
   return ret;
 }
 
-static gchar *
-get_next_line (GstSubParse * self)
+/* Returns the next line in textbuf after *pos, terminated in place, and moves
+ * *pos past it. The caller erases the consumed text once it is done with all
+ * the lines so that a large buffer is not moved around for every line. */
+static const gchar *
+get_next_line (GstSubParse * self, gsize * pos)
 {
-  char *line = NULL;
-  const char *line_end;
-  int line_len;
-  gboolean have_r = FALSE;
+  gchar *line, *line_end;
+  gsize skip = 1;
 
-  line_end = strchr (self->textbuf->str, '\n');
+  line = self->textbuf->str + *pos;
+  line_end = memchr (line, '\n', self->textbuf->len - *pos);
 
   if (!line_end) {
     /* end-of-line not found; return for more data */
@@ -519,15 +626,14 @@ get_next_line (GstSubParse * self)
   }
 
   /* get rid of '\r' */
-  if (line_end != self->textbuf->str && *(line_end - 1) == '\r') {
+  if (line_end != line && *(line_end - 1) == '\r') {
     line_end--;
-    have_r = TRUE;
+    skip = 2;
   }
 
-  line_len = line_end - self->textbuf->str;
-  line = g_strndup (self->textbuf->str, line_len);
-  self->textbuf = g_string_erase (self->textbuf, 0,
-      line_len + (have_r ? 2 : 1));
+  *line_end = '\0';
+  *pos += line_end - line + skip;
+
   return line;
 }
 
@@ -1658,6 +1764,10 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
     GST_INFO ("discontinuity");
     /* flush the parser state */
     parser_state_init (&self->state);
+    if (GST_BUFFER_OFFSET_IS_VALID (buf))
+      gst_sub_parse_index_resume (self, self->offset);
+    else
+      self->index_track = FALSE;
     g_string_truncate (self->textbuf, 0);
     gst_adapter_clear (self->adapter);
     if (self->parser_type == GST_SUB_PARSE_FORMAT_SAMI)
@@ -1691,7 +1801,10 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
 {
   GstFlowReturn ret = GST_FLOW_OK;
   GstCaps *caps = NULL;
-  gchar *line, *subtitle;
+  const gchar *line;
+  gchar *subtitle;
+  gsize pos = 0;
+  gint64 text_offset = -1;
   gboolean need_tags = FALSE;
 
   if (self->first_buffer) {
@@ -1740,8 +1853,27 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     }
   }
 
-  while (!self->flushing && (line = get_next_line (self))) {
+  /* we can only index the cues of subrip, the other formats keep state
+   * between the cues. The input offset of the text is only known when it
+   * did not need conversion */
+  if (self->index_track && self->parser_type == GST_SUB_PARSE_FORMAT_SUBRIP) {
+    if (self->detected_encoding ?
+        strcmp (self->detected_encoding, "UTF-8") == 0 : self->valid_utf8) {
+      text_offset = self->offset - gst_adapter_available (self->adapter) -
+          self->textbuf->len;
+    } else {
+      self->index_track = FALSE;
+    }
+  }
+
+  while (!self->flushing && (line = get_next_line (self, &pos))) {
     guint offset = 0;
+    gint prev_state = self->state.state;
+
+    if (text_offset >= 0 && self->index_at_cue && prev_state == 0) {
+      gst_sub_parse_index_add (self, text_offset + (line - self->textbuf->str));
+      self->index_at_cue = FALSE;
+    }
 
     /* Set segment on our parser state machine */
     self->state.segment = &self->segment;
@@ -1749,7 +1881,14 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     GST_LOG_OBJECT (self, "State %d. Parsing line '%s'", self->state.state,
         line + offset);
     subtitle = self->parse_line (&self->state, line + offset);
-    g_free (line);
+
+    if (text_offset >= 0) {
+      if (prev_state == 1 && self->state.state == 2)
+        self->index_max_end = MAX (self->index_max_end,
+            self->state.start_time + self->state.duration);
+      else if (prev_state != 0 && self->state.state == 0)
+        self->index_at_cue = TRUE;
+    }
 
     if (subtitle) {
       guint subtitle_len = strlen (subtitle);
@@ -1798,6 +1937,9 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     }
   }
 
+  /* drop all the lines we parsed at once */
+  g_string_erase (self->textbuf, 0, pos);
+
   return ret;
 }
 
@@ -1904,6 +2046,10 @@ gst_sub_parse_change_state (GstElement * element, GstStateChange transition)
       self->detected_encoding = NULL;
       g_string_truncate (self->textbuf, 0);
       gst_adapter_clear (self->adapter);
+      GST_OBJECT_LOCK (self);
+      g_array_set_size (self->index, 0);
+      GST_OBJECT_UNLOCK (self);
+      gst_sub_parse_index_resume (self, 0);
       break;
     default:
       break;
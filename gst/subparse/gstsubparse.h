@@ -82,6 +82,11 @@ typedef struct {
 
 typedef gchar* (*Parser) (ParserState *state, const gchar *line);
 
+typedef struct {
+  guint64      offset;  /* input byte offset of the first line of a cue */
+  GstClockTime max_end; /* end time of all the cues before offset */
+} GstSubParseIndexEntry;
+
 struct _GstSubParse {
   GstElement element;
 
@@ -101,6 +106,10 @@ struct _GstSubParse {
 
   /* seek */
   guint64 offset;
+  GArray *index;              /* GstSubParseIndexEntry, sorted by offset */
+  gboolean index_track;       /* started parsing at an index entry */
+  gboolean index_at_cue;      /* the next line starts a cue */
+  GstClockTime index_max_end;
   
   /* Segment */
   GstSegment    segment;
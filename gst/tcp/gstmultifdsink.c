@@ -122,6 +122,10 @@
 #include <sys/filio.h>
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
 #include "gstmultifdsink.h"
 
 #define NOT_IMPLEMENTED 0
@@ -150,6 +154,12 @@ enum
 /* this is really arbitrarily chosen */
 #define DEFAULT_HANDLE_READ             TRUE
 
+/* max number of events to collect per epoll_wait() */
+#define EPOLL_MAX_EVENTS                256
+
+#define CLIENT_WORKER(sink,client) \
+  (&(sink)->workers[((GstMultiHandleClient *) (client))->worker])
+
 enum
 {
   PROP_0,
@@ -159,7 +169,8 @@ enum
 static void gst_multi_fd_sink_stop_pre (GstMultiHandleSink * mhsink);
 static void gst_multi_fd_sink_stop_post (GstMultiHandleSink * mhsink);
 static gboolean gst_multi_fd_sink_start_pre (GstMultiHandleSink * mhsink);
-static gpointer gst_multi_fd_sink_thread (GstMultiHandleSink * mhsink);
+static gpointer gst_multi_fd_sink_thread (GstMultiHandleSink * mhsink,
+    GstMultiHandleSinkWorker * worker);
 
 static void gst_multi_fd_sink_add (GstMultiFdSink * sink, int fd);
 static void gst_multi_fd_sink_add_full (GstMultiFdSink * sink, int fd,
@@ -487,6 +498,58 @@ gst_multi_fd_sink_get_stats (GstMultiFdSink * sink, int fd)
       handle);
 }
 
+/* enable or disable write notification for @client */
+static void
+gst_multi_fd_sink_client_ctl_write (GstMultiFdSink * sink,
+    GstTCPClient * client, gboolean active)
+{
+  GstMultiFdSinkWorker *worker = CLIENT_WORKER (sink, client);
+
+  if (worker->epoll_fd < 0) {
+    gst_poll_fd_ctl_write (worker->fdset, &client->gfd, active);
+    return;
+  }
+
+  /* writability is only signalled on change, so a client that is already
+   * writable has to be handled without waiting for an event */
+  client->want_write = active;
+  if (active && client->can_write && !client->pending) {
+    client->pending = TRUE;
+    g_queue_push_tail (&worker->pending, GINT_TO_POINTER (client->gfd.fd));
+  }
+}
+
+static void
+gst_multi_fd_sink_epoll_add (GstMultiFdSink * sink, GstTCPClient * client)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiFdSinkWorker *worker = CLIENT_WORKER (sink, client);
+  struct epoll_event ev = { 0, };
+
+  ev.events = EPOLLOUT | EPOLLET;
+  ev.data.fd = client->gfd.fd;
+
+  /* we don't try to read from write only fds */
+  if (sink->handle_read) {
+    gint flags;
+
+    flags = fcntl (client->gfd.fd, F_GETFL, 0);
+    if ((flags & O_ACCMODE) != O_WRONLY)
+      ev.events |= EPOLLIN;
+  }
+
+  if (epoll_ctl (worker->epoll_fd, EPOLL_CTL_ADD, client->gfd.fd, &ev) < 0) {
+    GST_WARNING_OBJECT (sink, "%s could not add to epoll set: %s",
+        mhclient->debug, g_strerror (errno));
+    /* make the epoll loop look at it, it will be removed there */
+    mhclient->status = GST_CLIENT_STATUS_ERROR;
+    client->pending = TRUE;
+    g_queue_push_tail (&worker->pending, GINT_TO_POINTER (client->gfd.fd));
+  }
+#endif
+}
+
 /* vfuncs */
 
 static GstMultiHandleClient *
@@ -509,7 +572,7 @@ gst_multi_fd_sink_new_client (GstMultiHandleSink * mhsink,
   gst_poll_fd_init (&client->gfd);
   client->gfd.fd = mhclient->handle.fd;
 
-  gst_multi_handle_sink_client_init (mhclient, sync_method);
+  gst_multi_handle_sink_client_init (mhsink, mhclient, sync_method);
   mhsinkclass->handle_debug (handle, mhclient->debug);
 
   /* set the socket to non blocking */
@@ -518,16 +581,22 @@ gst_multi_fd_sink_new_client (GstMultiHandleSink * mhsink,
         mhclient->debug, g_strerror (errno));
   }
 
-  /* we always read from a client */
-  gst_poll_add_fd (sink->fdset, &client->gfd);
+  if (CLIENT_WORKER (sink, client)->epoll_fd >= 0) {
+    gst_multi_fd_sink_epoll_add (sink, client);
+  } else {
+    GstPoll *fdset = CLIENT_WORKER (sink, client)->fdset;
 
-  /* we don't try to read from write only fds */
-  if (sink->handle_read) {
-    gint flags;
+    /* we always read from a client */
+    gst_poll_add_fd (fdset, &client->gfd);
+
+    /* we don't try to read from write only fds */
+    if (sink->handle_read) {
+      gint flags;
 
-    flags = fcntl (handle.fd, F_GETFL, 0);
-    if ((flags & O_ACCMODE) != O_WRONLY) {
-      gst_poll_fd_ctl_read (sink->fdset, &client->gfd, TRUE);
+      flags = fcntl (handle.fd, F_GETFL, 0);
+      if ((flags & O_ACCMODE) != O_WRONLY) {
+        gst_poll_fd_ctl_read (fdset, &client->gfd, TRUE);
+      }
     }
   }
   /* figure out the mode, can't use send() for non sockets */
@@ -563,8 +632,10 @@ static void
 gst_multi_fd_sink_hash_changed (GstMultiHandleSink * mhsink)
 {
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
+  guint i;
 
-  gst_poll_restart (sink->fdset);
+  for (i = 0; i < mhsink->n_workers; i++)
+    gst_poll_restart (sink->workers[i].fdset);
 }
 
 /* handle a read on a client fd,
@@ -689,11 +760,11 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
 
     if (!mhclient->sending) {
       /* client is not working on a buffer */
-      if (mhclient->bufpos == -1) {
+      if (GST_MULTI_HANDLE_CLIENT_BUFPOS (mhsink, mhclient) == -1 &&
+          g_queue_is_empty (&mhclient->spill)) {
         /* client is too fast, remove from write queue until new buffer is
          * available */
-        /* FIXME: specific */
-        gst_poll_fd_ctl_write (sink->fdset, &client->gfd, FALSE);
+        gst_multi_fd_sink_client_ctl_write (sink, client, FALSE);
 
         /* if we flushed out all of the client buffers, we can stop */
         if (mhclient->flushcount == 0)
@@ -714,11 +785,11 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           if (position >= 0) {
             /* we got a valid spot in the queue */
             mhclient->new_connection = FALSE;
-            mhclient->bufpos = position;
+            gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient,
+                position);
           } else {
             /* cannot send data to this client yet */
-            /* FIXME: specific */
-            gst_poll_fd_ctl_write (sink->fdset, &client->gfd, FALSE);
+            gst_multi_fd_sink_client_ctl_write (sink, client, FALSE);
             return TRUE;
           }
         }
@@ -728,8 +799,7 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           goto flushed;
 
         /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
+        buf = gst_multi_handle_sink_client_next_buffer (mhsink, mhclient);
 
         /* update stats */
         timestamp = GST_BUFFER_TIMESTAMP (buf);
@@ -743,10 +813,12 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           mhclient->flushcount--;
 
         GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
+            mhclient->debug, client,
+            GST_MULTI_HANDLE_CLIENT_BUFPOS (mhsink, mhclient));
 
         /* queueing a buffer will ref it */
         mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+        gst_buffer_unref (buf);
 
         /* need to start from the first byte for this new buffer */
         mhclient->bufoffset = 0;
@@ -788,6 +860,8 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
         if (errno == EAGAIN) {
           /* nothing serious, resource was unavailable, try again later */
           more = FALSE;
+          /* wait for the next writable edge */
+          client->can_write = FALSE;
         } else if (errno == ECONNRESET) {
           goto connection_reset;
         } else {
@@ -801,7 +875,9 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
               "partial write on %s of %" G_GSSIZE_FORMAT " bytes",
               mhclient->debug, wrote);
           mhclient->bufoffset += wrote;
-          more = FALSE;
+          /* with edge-triggered epoll we need to write until EAGAIN, it
+           * is the only way to be sure that we get another event */
+          more = CLIENT_WORKER (sink, client)->epoll_fd >= 0;
         } else {
           /* complete buffer was written, we can proceed to the next one */
           mhclient->sending = g_slist_remove (mhclient->sending, head);
@@ -811,8 +887,9 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
-        mhclient->last_activity_time = now;
-        mhsink->bytes_served += wrote;
+        gst_multi_handle_sink_client_activity (mhsink, mhclient, now);
+        GST_MULTI_HANDLE_SINK_CLIENT_WORKER (mhsink,
+            mhclient)->bytes_served += wrote;
       }
     }
   } while (more);
@@ -850,7 +927,7 @@ gst_multi_fd_sink_hash_adding (GstMultiHandleSink * mhsink,
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
   GstTCPClient *client = (GstTCPClient *) mhclient;
 
-  gst_poll_fd_ctl_write (sink->fdset, &client->gfd, TRUE);
+  gst_multi_fd_sink_client_ctl_write (sink, client, TRUE);
 }
 
 static void
@@ -859,10 +936,120 @@ gst_multi_fd_sink_hash_removing (GstMultiHandleSink * mhsink,
 {
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
   GstTCPClient *client = (GstTCPClient *) mhclient;
+  GstMultiFdSinkWorker *worker = CLIENT_WORKER (sink, client);
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (worker->epoll_fd >= 0) {
+    /* can fail when the fd was closed already, it is gone from the set
+     * then anyway */
+    epoll_ctl (worker->epoll_fd, EPOLL_CTL_DEL, client->gfd.fd, NULL);
+    return;
+  }
+#endif
 
-  gst_poll_remove_fd (sink->fdset, &client->gfd);
+  gst_poll_remove_fd (worker->fdset, &client->gfd);
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+/* handle @events for the client in @clink, with the WORKER_LOCK.
+ * Returns FALSE when the client was removed. */
+static gboolean
+gst_multi_fd_sink_handle_client_events (GstMultiFdSink * sink,
+    GstMultiHandleSinkWorker * worker, GList * clink, guint32 events)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstTCPClient *client = clink->data;
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+
+  if (mhclient->status != GST_CLIENT_STATUS_FLUSHING
+      && mhclient->status != GST_CLIENT_STATUS_OK)
+    goto remove;
+
+  if (events & EPOLLHUP) {
+    mhclient->status = GST_CLIENT_STATUS_CLOSED;
+    goto remove;
+  }
+  if (events & EPOLLERR) {
+    GST_WARNING_OBJECT (sink, "epoll error for %d", client->gfd.fd);
+    mhclient->status = GST_CLIENT_STATUS_ERROR;
+    goto remove;
+  }
+  if (events & EPOLLIN) {
+    /* handle client read */
+    if (!gst_multi_fd_sink_handle_client_read (sink, client))
+      goto remove;
+  }
+  if (events & EPOLLOUT)
+    client->can_write = TRUE;
+
+  if (client->can_write && client->want_write) {
+    /* handle client write */
+    if (!gst_multi_fd_sink_handle_client_write (sink, client))
+      goto remove;
+  }
+  return TRUE;
+
+remove:
+  gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clink);
+  return FALSE;
+}
+
+/* Only look at the clients that reported events since the last round and
+ * the writable clients that got new data in the meantime, the others don't
+ * need any attention. */
+static void
+gst_multi_fd_sink_handle_clients_epoll (GstMultiFdSink * sink,
+    GstMultiHandleSinkWorker * worker)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  GstMultiFdSinkWorker *fworker = &sink->workers[worker->index];
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  GList *clink;
+  gint i, n;
+
+  WORKER_LOCK (mhsink, worker);
+  do {
+    n = epoll_wait (fworker->epoll_fd, events, EPOLL_MAX_EVENTS, 0);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      GST_WARNING_OBJECT (sink, "epoll_wait failed: %s", g_strerror (errno));
+      break;
+    }
+    GST_LOG_OBJECT (sink, "%d clients with events", n);
+
+    for (i = 0; i < n; i++) {
+      GstMultiSinkHandle handle;
+
+      handle.fd = events[i].data.fd;
+      clink = g_hash_table_lookup (mhsink->handle_hash,
+          mhsinkclass->handle_hash_key (handle));
+      if (clink == NULL)
+        continue;
+
+      gst_multi_fd_sink_handle_client_events (sink, worker, clink,
+          events[i].events);
+    }
+  } while (n == EPOLL_MAX_EVENTS);
+
+  while (!g_queue_is_empty (&fworker->pending)) {
+    GstMultiSinkHandle handle;
+
+    handle.fd = GPOINTER_TO_INT (g_queue_pop_head (&fworker->pending));
+    clink = g_hash_table_lookup (mhsink->handle_hash,
+        mhsinkclass->handle_hash_key (handle));
+    if (clink == NULL)
+      continue;
+
+    ((GstTCPClient *) clink->data)->pending = FALSE;
+    gst_multi_fd_sink_handle_client_events (sink, worker, clink, 0);
+  }
+  WORKER_UNLOCK (mhsink, worker);
+}
+#endif
+
 
 /* Handle the clients. Basically does a blocking select for one
  * of the client fds to become read or writable. We also have a
@@ -873,7 +1060,8 @@ gst_multi_fd_sink_hash_removing (GstMultiHandleSink * mhsink,
  * garbage list and removed.
  */
 static void
-gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
+gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink,
+    GstMultiHandleSinkWorker * worker)
 {
   int result;
   GList *clients, *next;
@@ -881,23 +1069,38 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
   GstMultiFdSinkClass *fclass;
   guint cookie;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiFdSinkWorker *fworker = &sink->workers[worker->index];
   int fd;
 
 
   fclass = GST_MULTI_FD_SINK_GET_CLASS (sink);
 
   do {
+    GstClockTime deadline, wait = GST_CLOCK_TIME_NONE;
+
     try_again = FALSE;
 
+    /* wake up when the least recently active client times out */
+    WORKER_LOCK (mhsink, worker);
+    deadline = gst_multi_handle_sink_worker_next_timeout (mhsink, worker);
+    WORKER_UNLOCK (mhsink, worker);
+
+    if (GST_CLOCK_TIME_IS_VALID (deadline)) {
+      GstClockTime now;
+      GTimeVal nowtv;
+
+      g_get_current_time (&nowtv);
+      now = GST_TIMEVAL_TO_TIME (nowtv);
+      wait = deadline > now ? deadline - now : 0;
+    }
+
     /* check for:
      * - server socket input (ie, new client connections)
      * - client socket input (ie, clients saying goodbye)
      * - client socket output (ie, client reads)          */
     GST_LOG_OBJECT (sink, "waiting on action on fdset");
 
-    result =
-        gst_poll_wait (sink->fdset,
-        mhsink->timeout != 0 ? mhsink->timeout : GST_CLOCK_TIME_NONE);
+    result = gst_poll_wait (fworker->fdset, wait);
 
     /* Handle the special case in which the sink is not receiving more buffers
      * and will not disconnect inactive client in the streaming thread. */
@@ -909,19 +1112,7 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
       now = GST_TIMEVAL_TO_TIME (nowtv);
 
       CLIENTS_LOCK (mhsink);
-      for (clients = mhsink->clients; clients; clients = next) {
-        GstTCPClient *client;
-        GstMultiHandleClient *mhclient;
-
-        client = (GstTCPClient *) clients->data;
-        mhclient = (GstMultiHandleClient *) client;
-        next = g_list_next (clients);
-        if (mhsink->timeout > 0
-            && now - mhclient->last_activity_time > mhsink->timeout) {
-          mhclient->status = GST_CLIENT_STATUS_SLOW;
-          gst_multi_handle_sink_remove_client_link (mhsink, clients);
-        }
-      }
+      gst_multi_handle_sink_worker_remove_timed_out (mhsink, worker, now);
       CLIENTS_UNLOCK (mhsink);
       return;
     } else if (result < 0) {
@@ -947,6 +1138,8 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
           client = (GstTCPClient *) clients->data;
           mhclient = (GstMultiHandleClient *) client;
           next = g_list_next (clients);
+          if (mhclient->worker != worker->index)
+            continue;
 
           fd = client->gfd.fd;
 
@@ -984,10 +1177,18 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
 
   /* subclasses can check fdset with this virtual function */
   if (fclass->wait)
-    fclass->wait (sink, sink->fdset);
+    fclass->wait (sink, fworker->fdset);
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (fworker->epoll_fd >= 0) {
+    gst_multi_fd_sink_handle_clients_epoll (sink, worker);
+    return;
+  }
+#endif
 
-  /* Check the clients */
-  CLIENTS_LOCK (mhsink);
+  /* Check the clients of this thread, the list only changes with more than
+   * one service thread after we release the lock */
+  WORKER_LOCK (mhsink, worker);
 
 restart2:
   cookie = mhsink->clients_cookie;
@@ -1004,50 +1205,56 @@ restart2:
     mhclient = (GstMultiHandleClient *) client;
     next = g_list_next (clients);
 
+    if (mhclient->worker != worker->index)
+      continue;
+
     if (mhclient->status != GST_CLIENT_STATUS_FLUSHING
         && mhclient->status != GST_CLIENT_STATUS_OK) {
-      gst_multi_handle_sink_remove_client_link (mhsink, clients);
+      gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clients);
       continue;
     }
 
-    if (gst_poll_fd_has_closed (sink->fdset, &client->gfd)) {
+    if (gst_poll_fd_has_closed (fworker->fdset, &client->gfd)) {
       mhclient->status = GST_CLIENT_STATUS_CLOSED;
-      gst_multi_handle_sink_remove_client_link (mhsink, clients);
+      gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clients);
       continue;
     }
-    if (gst_poll_fd_has_error (sink->fdset, &client->gfd)) {
+    if (gst_poll_fd_has_error (fworker->fdset, &client->gfd)) {
       GST_WARNING_OBJECT (sink, "gst_poll_fd_has_error for %d", client->gfd.fd);
       mhclient->status = GST_CLIENT_STATUS_ERROR;
-      gst_multi_handle_sink_remove_client_link (mhsink, clients);
+      gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clients);
       continue;
     }
-    if (gst_poll_fd_can_read (sink->fdset, &client->gfd)) {
+    if (gst_poll_fd_can_read (fworker->fdset, &client->gfd)) {
       /* handle client read */
       if (!gst_multi_fd_sink_handle_client_read (sink, client)) {
-        gst_multi_handle_sink_remove_client_link (mhsink, clients);
+        gst_multi_handle_sink_worker_remove_client_link (mhsink, worker,
+            clients);
         continue;
       }
     }
-    if (gst_poll_fd_can_write (sink->fdset, &client->gfd)) {
+    if (gst_poll_fd_can_write (fworker->fdset, &client->gfd)) {
       /* handle client write */
       if (!gst_multi_fd_sink_handle_client_write (sink, client)) {
-        gst_multi_handle_sink_remove_client_link (mhsink, clients);
+        gst_multi_handle_sink_worker_remove_client_link (mhsink, worker,
+            clients);
         continue;
       }
     }
   }
-  CLIENTS_UNLOCK (mhsink);
+  WORKER_UNLOCK (mhsink, worker);
 }
 
 /* we handle the client communication in another thread so that we do not block
  * the gstreamer thread while we select() on the client fds */
 static gpointer
-gst_multi_fd_sink_thread (GstMultiHandleSink * mhsink)
+gst_multi_fd_sink_thread (GstMultiHandleSink * mhsink,
+    GstMultiHandleSinkWorker * worker)
 {
   GstMultiFdSink *sink = GST_MULTI_FD_SINK (mhsink);
 
   while (mhsink->running) {
-    gst_multi_fd_sink_handle_clients (sink);
+    gst_multi_fd_sink_handle_clients (sink, worker);
   }
   return NULL;
 }
@@ -1090,14 +1297,69 @@ gst_multi_fd_sink_get_property (GObject * object, guint prop_id, GValue * value,
   }
 }
 
+static gboolean
+gst_multi_fd_sink_worker_start (GstMultiFdSink * mfsink,
+    GstMultiFdSinkWorker * worker)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (mfsink);
+
+  worker->epoll_fd = -1;
+  g_queue_init (&worker->pending);
+
+  if ((worker->fdset = gst_poll_new (TRUE)) == NULL)
+    return FALSE;
+
+  if (mhsink->backend == GST_MULTI_HANDLE_SINK_BACKEND_EPOLL) {
+#ifdef HAVE_SYS_EPOLL_H
+    /* the client fds go into the epoll set, the fdset only waits for the
+     * epoll fd to become readable and for control messages */
+    worker->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (worker->epoll_fd >= 0) {
+      gst_poll_fd_init (&worker->epoll_gfd);
+      worker->epoll_gfd.fd = worker->epoll_fd;
+      gst_poll_add_fd (worker->fdset, &worker->epoll_gfd);
+      gst_poll_fd_ctl_read (worker->fdset, &worker->epoll_gfd, TRUE);
+    } else {
+      GST_WARNING_OBJECT (mfsink, "could not create epoll fd, using poll: %s",
+          g_strerror (errno));
+    }
+#else
+    GST_WARNING_OBJECT (mfsink, "epoll backend not available, using poll");
+#endif
+  }
+
+  return TRUE;
+}
+
+static void
+gst_multi_fd_sink_worker_stop (GstMultiFdSink * mfsink,
+    GstMultiFdSinkWorker * worker)
+{
+  if (worker->fdset) {
+    gst_poll_free (worker->fdset);
+    worker->fdset = NULL;
+  }
+  if (worker->epoll_fd >= 0) {
+    close (worker->epoll_fd);
+    worker->epoll_fd = -1;
+  }
+  g_queue_clear (&worker->pending);
+}
+
 static gboolean
 gst_multi_fd_sink_start_pre (GstMultiHandleSink * mhsink)
 {
   GstMultiFdSink *mfsink = GST_MULTI_FD_SINK (mhsink);
+  guint i;
 
   GST_INFO_OBJECT (mfsink, "starting");
-  if ((mfsink->fdset = gst_poll_new (TRUE)) == NULL)
-    goto socket_pair;
+
+  mfsink->workers = g_new0 (GstMultiFdSinkWorker, mhsink->n_workers);
+  for (i = 0; i < mhsink->n_workers; i++) {
+    if (!gst_multi_fd_sink_worker_start (mfsink, &mfsink->workers[i]))
+      goto socket_pair;
+  }
+  mfsink->fdset = mfsink->workers[0].fdset;
 
   return TRUE;
 
@@ -1106,6 +1368,10 @@ socket_pair:
   {
     GST_ELEMENT_ERROR (mfsink, RESOURCE, OPEN_READ_WRITE, (NULL),
         GST_ERROR_SYSTEM);
+    while (i > 0)
+      gst_multi_fd_sink_worker_stop (mfsink, &mfsink->workers[--i]);
+    g_free (mfsink->workers);
+    mfsink->workers = NULL;
     return FALSE;
   }
 }
@@ -1120,19 +1386,25 @@ static void
 gst_multi_fd_sink_stop_pre (GstMultiHandleSink * mhsink)
 {
   GstMultiFdSink *mfsink = GST_MULTI_FD_SINK (mhsink);
+  guint i;
 
-  gst_poll_set_flushing (mfsink->fdset, TRUE);
+  for (i = 0; i < mhsink->n_workers; i++)
+    gst_poll_set_flushing (mfsink->workers[i].fdset, TRUE);
 }
 
 static void
 gst_multi_fd_sink_stop_post (GstMultiHandleSink * mhsink)
 {
   GstMultiFdSink *mfsink = GST_MULTI_FD_SINK (mhsink);
+  guint i;
 
-  if (mfsink->fdset) {
-    gst_poll_free (mfsink->fdset);
-    mfsink->fdset = NULL;
+  if (mfsink->workers) {
+    for (i = 0; i < mhsink->n_workers; i++)
+      gst_multi_fd_sink_worker_stop (mfsink, &mfsink->workers[i]);
+    g_free (mfsink->workers);
+    mfsink->workers = NULL;
   }
+  mfsink->fdset = NULL;
   g_hash_table_foreach_remove (mhsink->handle_hash, multifdsink_hash_remove,
       mfsink);
 }
@@ -55,8 +55,24 @@ typedef struct {
   GstPollFD gfd;
 
   gboolean is_socket;
+
+  /* epoll backend, writability is edge-triggered */
+  gboolean can_write;   /* fd reported writable, until write gets EAGAIN */
+  gboolean want_write;  /* client has data to send */
+  gboolean pending;     /* in the pending queue of the sink */
 } GstTCPClient;
 
+/* state of a service thread */
+typedef struct {
+  GstPoll *fdset;
+
+  /* epoll backend, -1 when not used */
+  gint epoll_fd;
+  GstPollFD epoll_gfd;
+  /* fds of writable clients that got new data */
+  GQueue pending;
+} GstMultiFdSinkWorker;
+
 /**
  * GstMultiFdSink:
  *
@@ -66,7 +82,8 @@ struct _GstMultiFdSink {
   GstMultiHandleSink element;
 
   /*< private >*/
-  GstPoll *fdset;
+  GstPoll *fdset;        /* fdset of the first service thread */
+  GstMultiFdSinkWorker *workers;
 
   gboolean handle_read;
 };
@@ -156,6 +156,8 @@ enum
 #define DEFAULT_UNITS_SOFT_MAX          -1
 #define DEFAULT_RECOVER_POLICY          GST_RECOVER_POLICY_NONE
 #define DEFAULT_TIMEOUT                 0
+#define DEFAULT_UNITS_SPILL             -1
+#define DEFAULT_SPILL_BYTES_MAX         0
 #define DEFAULT_SYNC_METHOD             GST_SYNC_METHOD_LATEST
 
 #define DEFAULT_BURST_FORMAT            GST_FORMAT_UNDEFINED
@@ -165,6 +167,14 @@ enum
 
 #define DEFAULT_RESEND_STREAMHEADER      TRUE
 
+#define DEFAULT_BACKEND                 GST_MULTI_HANDLE_SINK_BACKEND_POLL
+#define DEFAULT_SERVICE_THREADS         1
+#define MAX_SERVICE_THREADS             256
+
+/* how often all clients are checked to release the buffers they don't need
+ * anymore */
+#define SWEEP_INTERVAL                  (100 * GST_MSECOND)
+
 enum
 {
   PROP_0,
@@ -196,7 +206,13 @@ enum
 
   PROP_RESEND_STREAMHEADER,
 
-  PROP_NUM_HANDLES
+  PROP_NUM_HANDLES,
+
+  PROP_BACKEND,
+  PROP_SERVICE_THREADS,
+
+  PROP_UNITS_SPILL,
+  PROP_SPILL_BYTES_MAX
 };
 
 GType
@@ -223,6 +239,25 @@ gst_multi_handle_sink_recover_policy_get_type (void)
   return recover_policy_type;
 }
 
+GType
+gst_multi_handle_sink_backend_get_type (void)
+{
+  static GType backend_type = 0;
+  static const GEnumValue backend[] = {
+    {GST_MULTI_HANDLE_SINK_BACKEND_POLL,
+        "Wait on all clients with poll()", "poll"},
+    {GST_MULTI_HANDLE_SINK_BACKEND_EPOLL,
+        "Wait on clients with edge-triggered epoll (Linux only)", "epoll"},
+    {0, NULL, NULL},
+  };
+
+  if (!backend_type) {
+    backend_type =
+        g_enum_register_static ("GstMultiHandleSinkBackend", backend);
+  }
+  return backend_type;
+}
+
 GType
 gst_multi_handle_sink_sync_method_get_type (void)
 {
@@ -297,6 +332,14 @@ G_DEFINE_TYPE (GstMultiHandleSink, gst_multi_handle_sink, GST_TYPE_BASE_SINK);
 
 static guint gst_multi_handle_sink_signals[LAST_SIGNAL] = { 0 };
 
+/* entry of the timestamp index */
+typedef struct
+{
+  guint64 seq;
+  GstClockTime timestamp;
+  gboolean backwards;           /* lower than the timestamp before it */
+} GstMultiHandleSinkTimestamp;
+
 static gint
 find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction);
 #define find_next_syncframe(s,i) 	find_syncframe(s,i,1)
@@ -442,6 +485,70 @@ gst_multi_handle_sink_class_init (GstMultiHandleSinkClass * klass)
           "The current number of client handles",
           0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiHandleSink::backend
+   *
+   * The mechanism used to wait for clients to become readable or writable.
+   * The epoll backend scales to many thousands of clients as it never scans
+   * idle clients. It is only available on Linux, elsewhere the poll backend
+   * is used. Changes take effect the next time the sink is started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_BACKEND,
+      g_param_spec_enum ("backend", "Backend",
+          "How to wait for client readiness",
+          GST_TYPE_MULTI_HANDLE_SINK_BACKEND, DEFAULT_BACKEND,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiHandleSink::service-threads
+   *
+   * The number of threads used to serve the clients. Every client is
+   * assigned to the thread with the least clients when it is added, and the
+   * threads write to their clients in parallel, sharing the queued buffers.
+   * Changes take effect the next time the sink is started.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SERVICE_THREADS,
+      g_param_spec_uint ("service-threads", "Service threads",
+          "The number of threads serving the clients",
+          1, MAX_SERVICE_THREADS, DEFAULT_SERVICE_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiHandleSink::units-spill
+   *
+   * When a client lags more than this many units behind, the buffers it
+   * still has to send are moved out of the global queue into a queue of
+   * the client. A slow client then no longer makes the global queue keep
+   * its old buffers for all the other clients. The units-max and
+   * units-soft-max limits only see the part of the client in the global
+   * queue, use spill-bytes-max to limit the queue of the client.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_UNITS_SPILL,
+      g_param_spec_int64 ("units-spill", "Units spill",
+          "Move the older buffers of a client that lags more than this number "
+          "of units to a queue of the client (-1 = never)", -1, G_MAXINT64,
+          DEFAULT_UNITS_SPILL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiHandleSink::spill-bytes-max
+   *
+   * The maximum number of bytes in the queue of a client that lags more
+   * than units-spill. Clients with more are removed as too slow.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SPILL_BYTES_MAX,
+      g_param_spec_uint64 ("spill-bytes-max", "Spill bytes max",
+          "Max number of bytes in the queue of a client (0 = no limit)", 0,
+          G_MAXUINT64, DEFAULT_SPILL_BYTES_MAX,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstMultiHandleSink::clear:
    * @gstmultihandlesink: the multihandlesink element to emit this signal on
@@ -493,7 +600,15 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   CLIENTS_LOCK_INIT (this);
   this->clients = NULL;
 
+  g_mutex_init (&this->waiting_lock);
+  g_queue_init (&this->waiting);
+  this->oldest_seq = G_MAXUINT64;
+
   this->bufqueue = g_array_new (FALSE, TRUE, sizeof (GstBuffer *));
+  this->bufoffsets = g_array_new (FALSE, FALSE, sizeof (guint64));
+  this->syncframes = g_array_new (FALSE, FALSE, sizeof (guint64));
+  this->timestamps =
+      g_array_new (FALSE, FALSE, sizeof (GstMultiHandleSinkTimestamp));
   this->unit_format = DEFAULT_UNIT_FORMAT;
   this->units_max = DEFAULT_UNITS_MAX;
   this->units_soft_max = DEFAULT_UNITS_SOFT_MAX;
@@ -503,6 +618,8 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   this->recover_policy = DEFAULT_RECOVER_POLICY;
 
   this->timeout = DEFAULT_TIMEOUT;
+  this->units_spill = DEFAULT_UNITS_SPILL;
+  this->spill_bytes_max = DEFAULT_SPILL_BYTES_MAX;
   this->def_sync_method = DEFAULT_SYNC_METHOD;
 
   this->def_burst_format = DEFAULT_BURST_FORMAT;
@@ -511,6 +628,9 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   this->qos_dscp = DEFAULT_QOS_DSCP;
 
   this->resend_streamheader = DEFAULT_RESEND_STREAMHEADER;
+
+  this->backend = DEFAULT_BACKEND;
+  this->service_threads = DEFAULT_SERVICE_THREADS;
 }
 
 static void
@@ -521,8 +641,14 @@ gst_multi_handle_sink_finalize (GObject * object)
   this = GST_MULTI_HANDLE_SINK (object);
 
   CLIENTS_LOCK_CLEAR (this);
+  g_mutex_clear (&this->waiting_lock);
   g_array_free (this->bufqueue, TRUE);
+  g_array_free (this->bufoffsets, TRUE);
+  g_array_free (this->syncframes, TRUE);
+  g_array_free (this->timestamps, TRUE);
   g_hash_table_destroy (this->handle_hash);
+  gst_caps_replace (&this->sh_caps, NULL);
+  gst_buffer_replace (&this->sh_buffer, NULL);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -594,17 +720,217 @@ gst_multi_handle_sink_setup_dscp_client (GstMultiHandleSink * sink,
 #endif
 }
 
+/* With one service thread the clients lock protects everything. With more
+ * threads, each of them has its own lock for its clients and the clients
+ * lock takes all of them. The list of clients, the hash and the buffer queue
+ * are only changed with the clients lock, so the service threads can read
+ * them while holding only their own lock. */
+void
+gst_multi_handle_sink_clients_lock (GstMultiHandleSink * sink)
+{
+  guint i;
+
+  g_rec_mutex_lock (&sink->clientslock);
+  if (sink->n_workers > 1) {
+    for (i = 0; i < sink->n_workers; i++)
+      g_rec_mutex_lock (&sink->workers[i].lock);
+  }
+}
+
+void
+gst_multi_handle_sink_clients_unlock (GstMultiHandleSink * sink)
+{
+  guint i;
+
+  if (sink->n_workers > 1) {
+    for (i = sink->n_workers; i > 0; i--)
+      g_rec_mutex_unlock (&sink->workers[i - 1].lock);
+  }
+  g_rec_mutex_unlock (&sink->clientslock);
+}
+
+void
+gst_multi_handle_sink_worker_lock (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker)
+{
+  if (sink->n_workers > 1)
+    g_rec_mutex_lock (&worker->lock);
+  else
+    CLIENTS_LOCK (sink);
+}
+
+/* also removes the clients that were removed by the service thread while it
+ * had only its own lock */
+void
+gst_multi_handle_sink_worker_unlock (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker)
+{
+  GstMultiHandleSinkClass *mhsinkclass = GST_MULTI_HANDLE_SINK_GET_CLASS (sink);
+  GSList *removed, *walk;
+
+  if (sink->n_workers <= 1) {
+    CLIENTS_UNLOCK (sink);
+    return;
+  }
+
+  removed = worker->removed;
+  worker->removed = NULL;
+  g_rec_mutex_unlock (&worker->lock);
+
+  if (removed == NULL)
+    return;
+
+  CLIENTS_LOCK (sink);
+  for (walk = removed; walk; walk = walk->next) {
+    GList *clink;
+
+    /* the client could be gone already */
+    clink = g_hash_table_lookup (sink->handle_hash, walk->data);
+    if (clink != NULL)
+      gst_multi_handle_sink_remove_client_link (sink, clink);
+  }
+  if (mhsinkclass->hash_changed)
+    mhsinkclass->hash_changed (sink);
+  CLIENTS_UNLOCK (sink);
+
+  g_slist_free (removed);
+}
+
+/* should be called from a service thread with its worker lock held. Removing
+ * a client needs the clients lock so it is delayed until the service thread
+ * releases its lock when there is more than one. */
 void
-gst_multi_handle_sink_client_init (GstMultiHandleClient * client,
-    GstSyncMethod sync_method)
+gst_multi_handle_sink_worker_remove_client_link (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker, GList * link)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) link->data;
+  GstMultiHandleSinkClass *mhsinkclass = GST_MULTI_HANDLE_SINK_GET_CLASS (sink);
+
+  if (sink->n_workers <= 1) {
+    gst_multi_handle_sink_remove_client_link (sink, link);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (sink, "%s removing client later, status %d",
+      mhclient->debug, mhclient->status);
+  worker->removed = g_slist_prepend (worker->removed,
+      mhsinkclass->handle_hash_key (mhclient->handle));
+}
+
+static guint64
+gst_multi_handle_sink_get_bytes_served (GstMultiHandleSink * sink)
+{
+  guint64 bytes_served;
+  guint i;
+
+  CLIENTS_LOCK (sink);
+  bytes_served = sink->bytes_served;
+  for (i = 0; i < sink->n_workers; i++)
+    bytes_served += sink->workers[i].bytes_served;
+  CLIENTS_UNLOCK (sink);
+
+  return bytes_served;
+}
+
+static gboolean
+gst_multi_handle_sink_is_worker_thread (GstMultiHandleSink * sink)
+{
+  GThread *self = g_thread_self ();
+  gboolean res = FALSE;
+  guint i;
+
+  g_rec_mutex_lock (&sink->clientslock);
+  for (i = 0; i < sink->n_workers; i++) {
+    if (sink->workers[i].thread == self) {
+      res = TRUE;
+      break;
+    }
+  }
+  g_rec_mutex_unlock (&sink->clientslock);
+
+  return res;
+}
+
+static void
+gst_multi_handle_sink_client_clear_spill (GstMultiHandleClient * client)
+{
+  GstBuffer *buf;
+
+  while ((buf = g_queue_pop_head (&client->spill)))
+    gst_buffer_unref (buf);
+  client->spill_bytes = 0;
+}
+
+/* Get the next buffer to send to @client, from its own queue first and then
+ * from the global queue. The client must have a buffer to send, that is have
+ * a position or a non empty own queue. Should be called with the lock of the
+ * client held.
+ *
+ * Returns: a new ref to the buffer */
+GstBuffer *
+gst_multi_handle_sink_client_next_buffer (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client)
+{
+  GstBuffer *buf;
+
+  if ((buf = g_queue_pop_head (&client->spill))) {
+    client->spill_bytes -= gst_buffer_get_size (buf);
+  } else {
+    gint bufpos = GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client);
+
+    buf = g_array_index (sink->bufqueue, GstBuffer *, bufpos);
+    gst_buffer_ref (buf);
+    gst_multi_handle_sink_client_set_bufpos (sink, client, bufpos - 1);
+  }
+  return buf;
+}
+
+/* Move @client to @bufpos in the global queue, -1 means after the last
+ * buffer. Clients at -1 and new connections are put in the waiting queue so
+ * that queueing a buffer only needs to wake them up. Should be called with
+ * the lock of the client held. */
+void
+gst_multi_handle_sink_client_set_bufpos (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, gint bufpos)
+{
+  guint64 bufseq = sink->bufqueue_seq - 1 - bufpos;
+  gboolean back = bufseq < client->bufseq;
+
+  client->bufseq = bufseq;
+
+  /* moving forward in the queue doesn't change anything for the sink */
+  if (!back && bufpos >= 0 && (client->waiting == NULL
+          || client->new_connection))
+    return;
+
+  g_mutex_lock (&sink->waiting_lock);
+  sink->oldest_seq = MIN (sink->oldest_seq, bufseq);
+  if (bufpos == -1 && client->waiting == NULL) {
+    g_queue_push_tail (&sink->waiting, client);
+    client->waiting = sink->waiting.tail;
+  } else if (bufpos >= 0 && client->waiting && !client->new_connection) {
+    g_queue_delete_link (&sink->waiting, client->waiting);
+    client->waiting = NULL;
+  }
+  g_mutex_unlock (&sink->waiting_lock);
+}
+
+/* should be called with the clientslock held */
+void
+gst_multi_handle_sink_client_init (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, GstSyncMethod sync_method)
 {
   GTimeVal now;
+  guint i;
 
   client->status = GST_CLIENT_STATUS_OK;
-  client->bufpos = -1;
+  client->waiting = NULL;
+  gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
   client->flushcount = -1;
   client->bufoffset = 0;
   client->sending = NULL;
+  g_queue_init (&client->spill);
+  client->spill_bytes = 0;
   client->bytes_sent = 0;
   client->dropped_buffers = 0;
   client->avg_queue_size = 0;
@@ -614,12 +940,101 @@ gst_multi_handle_sink_client_init (GstMultiHandleClient * client,
   client->sync_method = sync_method;
   client->currently_removing = FALSE;
 
+  /* serve the client from the thread with the least clients */
+  client->worker = 0;
+  for (i = 1; i < sink->n_workers; i++) {
+    if (sink->workers[i].n_clients < sink->workers[client->worker].n_clients)
+      client->worker = i;
+  }
+  if (sink->n_workers > 0)
+    sink->workers[client->worker].n_clients++;
+
   /* update start time */
   g_get_current_time (&now);
   client->connect_time = GST_TIMEVAL_TO_TIME (now);
   client->disconnect_time = 0;
   /* set last activity time to connect time */
   client->last_activity_time = client->connect_time;
+  client->activity_link.data = client;
+  if (client->worker < sink->n_workers)
+    g_queue_push_tail_link (&sink->workers[client->worker].active,
+        &client->activity_link);
+}
+
+/* Mark @client as active at @now. The clients of a service thread are kept
+ * in the order of their last activity so that the ones that timed out are
+ * at the start. Should be called with the lock of the client held. */
+void
+gst_multi_handle_sink_client_activity (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, GstClockTime now)
+{
+  GQueue *active;
+
+  client->last_activity_time = now;
+
+  if (client->worker >= sink->n_workers)
+    return;
+
+  active = &sink->workers[client->worker].active;
+  if (active->tail != &client->activity_link) {
+    g_queue_unlink (active, &client->activity_link);
+    g_queue_push_tail_link (active, &client->activity_link);
+  }
+}
+
+/* Returns: the time when the least recently active client of @worker times
+ * out or GST_CLOCK_TIME_NONE. Should be called with the lock of the worker
+ * held. */
+GstClockTime
+gst_multi_handle_sink_worker_next_timeout (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker)
+{
+  GstMultiHandleClient *mhclient;
+
+  if (sink->timeout == 0 || worker->active.head == NULL)
+    return GST_CLOCK_TIME_NONE;
+
+  mhclient = worker->active.head->data;
+
+  return mhclient->last_activity_time + sink->timeout;
+}
+
+/* Remove the clients of @worker that were not active for longer than the
+ * timeout, only these clients are looked at. Should be called with the
+ * clientslock held.
+ *
+ * Returns: %TRUE when clients were removed */
+gboolean
+gst_multi_handle_sink_worker_remove_timed_out (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker, GstClockTime now)
+{
+  GstMultiHandleSinkClass *mhsinkclass = GST_MULTI_HANDLE_SINK_GET_CLASS (sink);
+  gboolean removed = FALSE;
+  GList *link;
+
+  if (sink->timeout == 0)
+    return FALSE;
+
+  /* removing the client takes it out of the queue */
+  while ((link = worker->active.head)) {
+    GstMultiHandleClient *mhclient = link->data;
+    GList *clink;
+
+    if (now - mhclient->last_activity_time <= sink->timeout)
+      break;
+
+    clink = g_hash_table_lookup (sink->handle_hash,
+        mhsinkclass->handle_hash_key (mhclient->handle));
+    if (G_UNLIKELY (clink == NULL))
+      break;
+
+    GST_WARNING_OBJECT (sink, "%s client %p timed out, removing",
+        mhclient->debug, mhclient);
+    mhclient->status = GST_CLIENT_STATUS_SLOW;
+    gst_multi_handle_sink_remove_client_link (sink, clink);
+    removed = TRUE;
+  }
+  return removed;
 }
 
 static void
@@ -803,7 +1218,8 @@ gst_multi_handle_sink_remove_flush (GstMultiHandleSink * sink,
     /* take the position of the client as the number of buffers left to flush.
      * If the client was at position -1, we flush 0 buffers, 0 == flush 1
      * buffer, etc... */
-    mhclient->flushcount = mhclient->bufpos + 1;
+    mhclient->flushcount = GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, mhclient) + 1 +
+        mhclient->spill.length;
     /* mark client as flushing. We can not remove the client right away because
      * it might have some buffers to flush in the ->sending queue. */
     mhclient->status = GST_CLIENT_STATUS_FLUSHING;
@@ -899,7 +1315,14 @@ gst_multi_handle_sink_get_stats (GstMultiHandleSink * sink,
         "last-activitity-time", G_TYPE_UINT64, mhclient->last_activity_time,
         "buffers-dropped", G_TYPE_UINT64, mhclient->dropped_buffers,
         "first-buffer-ts", G_TYPE_UINT64, mhclient->first_buffer_ts,
-        "last-buffer-ts", G_TYPE_UINT64, mhclient->last_buffer_ts, NULL);
+        "last-buffer-ts", G_TYPE_UINT64, mhclient->last_buffer_ts,
+        "buffers-queued", G_TYPE_UINT64,
+        (guint64) (GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, mhclient) + 1 +
+            mhclient->spill.length),
+        "spill-bytes", G_TYPE_UINT64, mhclient->spill_bytes,
+        "bitrate", G_TYPE_UINT64, interval > 0 ?
+        gst_util_uint64_scale (mhclient->bytes_sent * 8, GST_SECOND,
+            interval) : (guint64) 0, NULL);
   }
 
 noclient:
@@ -969,6 +1392,19 @@ gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
 
   mhsinkclass->hash_removing (sink, mhclient);
 
+  g_mutex_lock (&sink->waiting_lock);
+  if (mhclient->waiting) {
+    g_queue_delete_link (&sink->waiting, mhclient->waiting);
+    mhclient->waiting = NULL;
+  }
+  g_mutex_unlock (&sink->waiting_lock);
+
+  if (mhclient->worker < sink->n_workers) {
+    sink->workers[mhclient->worker].n_clients--;
+    g_queue_unlink (&sink->workers[mhclient->worker].active,
+        &mhclient->activity_link);
+  }
+
   g_get_current_time (&now);
   mhclient->disconnect_time = GST_TIMEVAL_TO_TIME (now);
 
@@ -976,6 +1412,7 @@ gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
   g_slist_foreach (mhclient->sending, (GFunc) gst_mini_object_unref, NULL);
   g_slist_free (mhclient->sending);
   mhclient->sending = NULL;
+  gst_multi_handle_sink_client_clear_spill (mhclient);
 
   if (mhclient->caps)
     gst_caps_unref (mhclient->caps);
@@ -1021,6 +1458,66 @@ gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
   CLIENTS_LOCK (sink);
 }
 
+/* Get the streamheader of @caps in one buffer. It is made once for all
+ * clients, when they reconnect they only need a ref to it.
+ *
+ * Returns: a new ref to the buffer or %NULL when @caps have no streamheader */
+static GstBuffer *
+gst_multi_handle_sink_get_streamheader (GstMultiHandleSink * sink,
+    GstCaps * caps)
+{
+  GstBuffer *result = NULL;
+
+  GST_OBJECT_LOCK (sink);
+  if (sink->sh_caps != caps) {
+    const GValue *sh;
+    GstStructure *s;
+
+    gst_caps_replace (&sink->sh_caps, caps);
+    gst_buffer_replace (&sink->sh_buffer, NULL);
+
+    s = gst_caps_get_structure (caps, 0);
+    if ((sh = gst_structure_get_value (s, "streamheader"))) {
+      GArray *buffers;
+      gsize size = 0, offset = 0;
+      guint i;
+
+      g_assert (G_VALUE_TYPE (sh) == GST_TYPE_ARRAY);
+      buffers = g_value_peek_pointer (sh);
+      for (i = 0; i < buffers->len; i++) {
+        GValue *bufval = &g_array_index (buffers, GValue, i);
+
+        g_assert (G_VALUE_TYPE (bufval) == GST_TYPE_BUFFER);
+        size += gst_buffer_get_size (g_value_peek_pointer (bufval));
+      }
+
+      GST_DEBUG_OBJECT (sink, "%d streamheader buffers of %" G_GSIZE_FORMAT
+          " bytes", buffers->len, size);
+
+      /* one memory so that it can be written with one call */
+      if (size > 0)
+        sink->sh_buffer = gst_buffer_new_allocate (NULL, size, NULL);
+      for (i = 0; sink->sh_buffer && i < buffers->len; i++) {
+        GstBuffer *buffer =
+            g_value_peek_pointer (&g_array_index (buffers, GValue, i));
+        GstMapInfo map;
+
+        gst_buffer_map (buffer, &map, GST_MAP_READ);
+        gst_buffer_fill (sink->sh_buffer, offset, map.data, map.size);
+        offset += map.size;
+        gst_buffer_unmap (buffer, &map);
+      }
+      if (sink->sh_buffer)
+        GST_BUFFER_FLAG_SET (sink->sh_buffer, GST_BUFFER_FLAG_HEADER);
+    }
+  }
+  if (sink->sh_buffer)
+    result = gst_buffer_ref (sink->sh_buffer);
+  GST_OBJECT_UNLOCK (sink);
+
+  return result;
+}
+
 static gboolean
 gst_multi_handle_sink_client_queue_buffer (GstMultiHandleSink * mhsink,
     GstMultiHandleClient * mhclient, GstBuffer * buffer)
@@ -1044,7 +1541,7 @@ gst_multi_handle_sink_client_queue_buffer (GstMultiHandleSink * mhsink,
     mhclient->caps = gst_caps_ref (caps);
   } else {
     /* there were previous caps recorded, so compare */
-    if (!gst_caps_is_equal (caps, mhclient->caps)) {
+    if (caps != mhclient->caps && !gst_caps_is_equal (caps, mhclient->caps)) {
       const GValue *sh1, *sh2;
 
       /* caps are not equal, but could still have the same streamheader */
@@ -1090,39 +1587,16 @@ gst_multi_handle_sink_client_queue_buffer (GstMultiHandleSink * mhsink,
   }
 
   if (G_UNLIKELY (send_streamheader)) {
-    const GValue *sh;
-    GArray *buffers;
-    int i;
+    GstBuffer *header;
 
-    GST_LOG_OBJECT (sink,
-        "%s sending streamheader from caps %" GST_PTR_FORMAT,
-        mhclient->debug, caps);
-    s = gst_caps_get_structure (caps, 0);
-    if (!gst_structure_has_field (s, "streamheader")) {
+    if ((header = gst_multi_handle_sink_get_streamheader (sink, caps))) {
       GST_DEBUG_OBJECT (sink,
-          "%s no new streamheader, so nothing to send", mhclient->debug);
+          "%s queueing streamheader buffer of length %" G_GSIZE_FORMAT,
+          mhclient->debug, gst_buffer_get_size (header));
+      mhclient->sending = g_slist_append (mhclient->sending, header);
     } else {
-      GST_LOG_OBJECT (sink,
-          "%s sending streamheader from caps %" GST_PTR_FORMAT,
-          mhclient->debug, caps);
-      sh = gst_structure_get_value (s, "streamheader");
-      g_assert (G_VALUE_TYPE (sh) == GST_TYPE_ARRAY);
-      buffers = g_value_peek_pointer (sh);
-      GST_DEBUG_OBJECT (sink, "%d streamheader buffers", buffers->len);
-      for (i = 0; i < buffers->len; ++i) {
-        GValue *bufval;
-        GstBuffer *buffer;
-
-        bufval = &g_array_index (buffers, GValue, i);
-        g_assert (G_VALUE_TYPE (bufval) == GST_TYPE_BUFFER);
-        buffer = g_value_peek_pointer (bufval);
-        GST_DEBUG_OBJECT (sink,
-            "%s queueing streamheader buffer of length %" G_GSIZE_FORMAT,
-            mhclient->debug, gst_buffer_get_size (buffer));
-        gst_buffer_ref (buffer);
-
-        mhclient->sending = g_slist_append (mhclient->sending, buffer);
-      }
+      GST_DEBUG_OBJECT (sink,
+          "%s no new streamheader, so nothing to send", mhclient->debug);
     }
   }
 
@@ -1146,6 +1620,169 @@ is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer)
   return TRUE;
 }
 
+/* sequence number of the buffer at @idx in the buffer queue and back */
+#define INDEX_SEQ(s,idx) ((s)->bufqueue_seq - 1 - (idx))
+#define INDEX_POS(s,seq) ((gint) ((s)->bufqueue_seq - 1 - (seq)))
+
+/* add the buffer that was just prepended to the buffer queue to the index */
+static void
+gst_multi_handle_sink_index_add (GstMultiHandleSink * sink, GstBuffer * buffer)
+{
+  guint64 seq = sink->bufqueue_seq++;
+
+  g_array_append_val (sink->bufoffsets, sink->bufqueue_bytes);
+  sink->bufqueue_bytes += gst_buffer_get_size (buffer);
+
+  if (is_sync_frame (sink, buffer))
+    g_array_append_val (sink->syncframes, seq);
+
+  if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer)) {
+    GstMultiHandleSinkTimestamp ts;
+
+    ts.seq = seq;
+    ts.timestamp = GST_BUFFER_TIMESTAMP (buffer);
+    ts.backwards = sink->timestamps->len > 0 &&
+        ts.timestamp < g_array_index (sink->timestamps,
+        GstMultiHandleSinkTimestamp, sink->timestamps->len - 1).timestamp;
+    if (ts.backwards)
+      sink->ts_backwards++;
+    g_array_append_val (sink->timestamps, ts);
+  }
+}
+
+/* remove the @n oldest buffers from the index */
+static void
+gst_multi_handle_sink_index_remove (GstMultiHandleSink * sink, guint n)
+{
+  guint64 oldest;
+  guint i;
+
+  if (n == 0)
+    return;
+
+  g_array_remove_range (sink->bufoffsets, 0, n);
+  oldest = sink->bufqueue_seq - sink->bufoffsets->len;
+
+  for (i = 0; i < sink->syncframes->len; i++) {
+    if (g_array_index (sink->syncframes, guint64, i) >= oldest)
+      break;
+  }
+  g_array_remove_range (sink->syncframes, 0, i);
+
+  for (i = 0; i < sink->timestamps->len; i++) {
+    GstMultiHandleSinkTimestamp *ts = &g_array_index (sink->timestamps,
+        GstMultiHandleSinkTimestamp, i);
+
+    if (ts->seq >= oldest)
+      break;
+    if (ts->backwards)
+      sink->ts_backwards--;
+  }
+  g_array_remove_range (sink->timestamps, 0, i);
+
+  /* the first timestamp has nothing before it to go back from */
+  if (sink->timestamps->len > 0) {
+    GstMultiHandleSinkTimestamp *ts = &g_array_index (sink->timestamps,
+        GstMultiHandleSinkTimestamp, 0);
+
+    if (ts->backwards) {
+      ts->backwards = FALSE;
+      sink->ts_backwards--;
+    }
+  }
+}
+
+static void
+gst_multi_handle_sink_index_clear (GstMultiHandleSink * sink)
+{
+  g_array_set_size (sink->bufoffsets, 0);
+  g_array_set_size (sink->syncframes, 0);
+  g_array_set_size (sink->timestamps, 0);
+  sink->ts_backwards = 0;
+}
+
+/* Returns: the index of the first buffer in the buffer queue where the
+ * buffers from the start of the queue contain at least @bytes bytes or
+ * the length of the queue when there is not enough data. */
+static gint
+find_bytes_pos (GstMultiHandleSink * sink, guint64 bytes)
+{
+  GArray *offsets = sink->bufoffsets;
+  guint64 limit;
+  gint lo, hi;
+
+  if (bytes > sink->bufqueue_bytes || offsets->len == 0)
+    return sink->bufqueue->len;
+
+  /* find the last buffer with an offset of at most limit, offsets
+   * are increasing */
+  limit = sink->bufqueue_bytes - bytes;
+  lo = 0;
+  hi = offsets->len - 1;
+  if (g_array_index (offsets, guint64, lo) > limit)
+    return sink->bufqueue->len;
+  while (lo < hi) {
+    gint mid = lo + (hi - lo + 1) / 2;
+
+    if (g_array_index (offsets, guint64, mid) <= limit)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return offsets->len - 1 - lo;
+}
+
+/* Returns: the index of the first buffer in the buffer queue with a
+ * timestamp at least @diff before the first timestamp in the queue or
+ * the length of the queue when there is no such buffer. */
+static gint
+find_time_pos (GstMultiHandleSink * sink, GstClockTime diff)
+{
+  GArray *timestamps = sink->timestamps;
+  GstClockTime first;
+  gint lo, hi;
+
+  if (timestamps->len == 0)
+    return sink->bufqueue->len;
+
+  first = g_array_index (timestamps, GstMultiHandleSinkTimestamp,
+      timestamps->len - 1).timestamp;
+
+  if (sink->ts_backwards > 0) {
+    gint i;
+
+    /* timestamps are not sorted, check them all */
+    for (i = timestamps->len - 1; i >= 0; i--) {
+      GstMultiHandleSinkTimestamp *ts =
+          &g_array_index (timestamps, GstMultiHandleSinkTimestamp, i);
+
+      if (first - ts->timestamp >= diff)
+        return INDEX_POS (sink, ts->seq);
+    }
+    return sink->bufqueue->len;
+  }
+
+  if (diff > first ||
+      g_array_index (timestamps, GstMultiHandleSinkTimestamp,
+          0).timestamp > first - diff)
+    return sink->bufqueue->len;
+
+  /* find the last timestamp of at most first - diff */
+  lo = 0;
+  hi = timestamps->len - 1;
+  while (lo < hi) {
+    gint mid = lo + (hi - lo + 1) / 2;
+
+    if (g_array_index (timestamps, GstMultiHandleSinkTimestamp,
+            mid).timestamp <= first - diff)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return INDEX_POS (sink, g_array_index (timestamps,
+          GstMultiHandleSinkTimestamp, lo).seq);
+}
+
 /* find the keyframe in the list of buffers starting the
  * search from @idx. @direction as -1 will search backwards, 
  * 1 will search forwards.
@@ -1154,27 +1791,50 @@ is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer)
 gint
 find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction)
 {
-  gint i, len, result;
-
-  /* take length of queued buffers */
-  len = sink->bufqueue->len;
-
-  /* assume we don't find a keyframe */
-  result = -1;
-
-  /* then loop over all buffers to find the first keyframe */
-  for (i = idx; i >= 0 && i < len; i += direction) {
-    GstBuffer *buf;
-
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-    if (is_sync_frame (sink, buf)) {
-      GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
-          i, idx, direction);
-      result = i;
-      break;
+  GArray *syncframes = sink->syncframes;
+  guint64 seq, found;
+  gint lo, hi;
+
+  if (idx < 0 || idx >= (gint) sink->bufqueue->len || syncframes->len == 0)
+    return -1;
+
+  seq = INDEX_SEQ (sink, idx);
+  lo = 0;
+  hi = syncframes->len - 1;
+
+  if (direction > 0) {
+    /* searching to older buffers, find the last sync frame at or before
+     * seq */
+    if (g_array_index (syncframes, guint64, lo) > seq)
+      return -1;
+    while (lo < hi) {
+      gint mid = lo + (hi - lo + 1) / 2;
+
+      if (g_array_index (syncframes, guint64, mid) <= seq)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+  } else {
+    /* searching to newer buffers, find the first sync frame at or after
+     * seq */
+    if (g_array_index (syncframes, guint64, hi) < seq)
+      return -1;
+    while (lo < hi) {
+      gint mid = lo + (hi - lo) / 2;
+
+      if (g_array_index (syncframes, guint64, mid) >= seq)
+        hi = mid;
+      else
+        lo = mid + 1;
     }
   }
-  return result;
+  found = g_array_index (syncframes, guint64, lo);
+
+  GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
+      INDEX_POS (sink, found), idx, direction);
+
+  return INDEX_POS (sink, found);
 }
 
 /* Get the number of buffers from the buffer queue needed to satisfy
@@ -1188,47 +1848,11 @@ get_buffers_max (GstMultiHandleSink * sink, gint64 max)
     case GST_FORMAT_BUFFERS:
       return max;
     case GST_FORMAT_TIME:
-    {
-      GstBuffer *buf;
-      int i;
-      int len;
-      gint64 diff;
-      GstClockTime first = GST_CLOCK_TIME_NONE;
-
-      len = sink->bufqueue->len;
-
-      for (i = 0; i < len; i++) {
-        buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-        if (GST_BUFFER_TIMESTAMP_IS_VALID (buf)) {
-          if (first == -1)
-            first = GST_BUFFER_TIMESTAMP (buf);
-
-          diff = first - GST_BUFFER_TIMESTAMP (buf);
-
-          if (diff > max)
-            return i + 1;
-        }
-      }
-      return len + 1;
-    }
+      /* first buffer that is more than max before the first timestamp */
+      return find_time_pos (sink, max < 0 ? 0 : max + 1) + 1;
     case GST_FORMAT_BYTES:
-    {
-      GstBuffer *buf;
-      int i;
-      int len;
-      gint acc = 0;
-
-      len = sink->bufqueue->len;
-
-      for (i = 0; i < len; i++) {
-        buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-        acc += gst_buffer_get_size (buf);
-
-        if (acc > max)
-          return i + 1;
-      }
-      return len + 1;
-    }
+      /* first buffer where we have more than max bytes */
+      return find_bytes_pos (sink, max < 0 ? 0 : max + 1) + 1;
     default:
       return max;
   }
@@ -1251,9 +1875,7 @@ find_limits (GstMultiHandleSink * sink,
     gint * min_idx, gint bytes_min, gint buffers_min, gint64 time_min,
     gint * max_idx, gint bytes_max, gint buffers_max, gint64 time_max)
 {
-  GstClockTime first, time;
-  gint i, len, bytes;
-  gboolean result, max_hit;
+  gint len, min_pos, max_pos;
 
   /* take length of queue */
   len = sink->bufqueue->len;
@@ -1274,78 +1896,37 @@ find_limits (GstMultiHandleSink * sink,
     return FALSE;
   }
 
-  result = FALSE;
-  /* else count bytes and time */
-  first = -1;
-  bytes = 0;
-  /* unset limits */
-  *min_idx = -1;
-  *max_idx = -1;
-  max_hit = FALSE;
-
-  i = 0;
-  /* loop through the buffers, when a limit is ok, mark it 
-   * as -1, we have at least one buffer in the queue. */
-  do {
-    GstBuffer *buf;
-
-    /* if we checked all min limits, update result */
-    if (bytes_min == -1 && time_min == -1 && *min_idx == -1) {
-      /* don't go below 0 */
-      *min_idx = MAX (i - 1, 0);
+  /* position where all min limits are satisfied, -1 when there are none */
+  min_pos = -1;
+  if (bytes_min != -1)
+    min_pos = MAX (min_pos, find_bytes_pos (sink, MAX (bytes_min, 0)));
+  if (time_min != -1)
+    min_pos = MAX (min_pos, find_time_pos (sink, time_min));
+
+  /* position where the first max limit is hit, len when none is */
+  max_pos = len;
+  if (bytes_max != -1)
+    max_pos = MIN (max_pos, find_bytes_pos (sink, MAX (bytes_max, 0)));
+  if (time_max != -1)
+    max_pos = MIN (max_pos, find_time_pos (sink, time_max));
+
+  /* a max limit hit on the last buffer still leaves the result unset */
+  if (max_pos < len - 1) {
+    *max_idx = max_pos;
+    if (min_pos <= max_pos) {
+      *min_idx = MAX (min_pos, 0);
+      return TRUE;
     }
-    /* if we reached one max limit break out */
-    if (max_hit) {
-      /* i > 0 when we get here, we subtract one to get the position
-       * of the previous buffer. */
-      *max_idx = i - 1;
-      /* we have valid complete result if we found a min_idx too */
-      result = *min_idx != -1;
-      break;
-    }
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-
-    bytes += gst_buffer_get_size (buf);
-
-    /* take timestamp and save for the base first timestamp */
-    if ((time = GST_BUFFER_TIMESTAMP (buf)) != -1) {
-      GST_LOG_OBJECT (sink, "Ts %" GST_TIME_FORMAT " on buffer",
-          GST_TIME_ARGS (time));
-      if (first == -1)
-        first = time;
-
-      /* increase max usage if we did not fill enough. Note that
-       * buffers are sorted from new to old, so the first timestamp is
-       * bigger than the next one. */
-      if (time_min != -1 && first - time >= time_min)
-        time_min = -1;
-      if (time_max != -1 && first - time >= time_max)
-        max_hit = TRUE;
-    } else {
-      GST_LOG_OBJECT (sink, "No timestamp on buffer");
-    }
-    /* time is OK or unknown, check and increase if not enough bytes */
-    if (bytes_min != -1) {
-      if (bytes >= bytes_min)
-        bytes_min = -1;
-    }
-    if (bytes_max != -1) {
-      if (bytes >= bytes_max) {
-        max_hit = TRUE;
-      }
-    }
-    i++;
+    /* make sure min does not exceed max */
+    *min_idx = max_pos;
+    return FALSE;
   }
-  while (i < len);
 
   /* if we did not hit the max or min limit, set to buffer size */
-  if (*max_idx == -1)
-    *max_idx = len - 1;
-  /* make sure min does not exceed max */
-  if (*min_idx == -1)
-    *min_idx = *max_idx;
+  *max_idx = len - 1;
+  *min_idx = min_pos < len ? MAX (min_pos, 0) : len - 1;
 
-  return result;
+  return FALSE;
 }
 
 /* parse the unit/value pair and assign it to the result value of the
@@ -1423,7 +2004,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
   switch (client->sync_method) {
     case GST_SYNC_METHOD_LATEST:
       /* no syncing, we are happy with whatever the client is going to get */
-      result = client->bufpos;
+      result = GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client);
       GST_DEBUG_OBJECT (sink,
           "%s SYNC_METHOD_LATEST, position %d", client->debug, result);
       break;
@@ -1433,9 +2014,10 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
        * is a sync point, we can proceed, otherwise we need to keep waiting */
       GST_LOG_OBJECT (sink,
           "%s new client, bufpos %d, waiting for keyframe",
-          client->debug, client->bufpos);
+          client->debug, GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client));
 
-      result = find_prev_syncframe (sink, client->bufpos);
+      result = find_prev_syncframe (sink,
+          GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client));
       if (result != -1) {
         GST_DEBUG_OBJECT (sink,
             "%s SYNC_METHOD_NEXT_KEYFRAME: result %d", client->debug, result);
@@ -1447,7 +2029,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
       GST_LOG_OBJECT (sink,
           "%s new client, skipping buffer(s), no syncpoint found",
           client->debug);
-      client->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
       break;
     }
     case GST_SYNC_METHOD_LATEST_KEYFRAME:
@@ -1470,7 +2052,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
           "%s SYNC_METHOD_LATEST_KEYFRAME: no keyframe found, "
           "switching to SYNC_METHOD_NEXT_KEYFRAME", client->debug);
       /* throw client to the waiting state */
-      client->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
       /* and make client sync to next keyframe */
       client->sync_method = GST_SYNC_METHOD_NEXT_KEYFRAME;
       break;
@@ -1545,7 +2127,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
           "no prev keyframe found in BURST_KEYFRAME sync mode, waiting for next");
 
       /* throw client to the waiting state */
-      client->bufpos = -1;
+      gst_multi_handle_sink_client_set_bufpos (sink, client, -1);
       /* and make client sync to next keyframe */
       client->sync_method = GST_SYNC_METHOD_NEXT_KEYFRAME;
       result = -1;
@@ -1592,7 +2174,7 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     }
     default:
       g_warning ("unknown sync method %d", client->sync_method);
-      result = client->bufpos;
+      result = GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client);
       break;
   }
   return result;
@@ -1610,13 +2192,14 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
 
   GST_WARNING_OBJECT (sink,
       "%s client %p is lagging at %d, recover using policy %d",
-      client->debug, client, client->bufpos, sink->recover_policy);
+      client->debug, client, GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client),
+      sink->recover_policy);
 
   switch (sink->recover_policy) {
     case GST_RECOVER_POLICY_NONE:
       /* do nothing, client will catch up or get kicked out when it reaches
        * the hard max */
-      newbufpos = client->bufpos;
+      newbufpos = GST_MULTI_HANDLE_CLIENT_BUFPOS (sink, client);
       break;
     case GST_RECOVER_POLICY_RESYNC_LATEST:
       /* move to beginning of queue */
@@ -1631,17 +2214,7 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
        * closest keyframe relative to what this client already received. */
       newbufpos = MIN (sink->bufqueue->len - 1,
           get_buffers_max (sink, sink->units_soft_max) - 1);
-
-      while (newbufpos >= 0) {
-        GstBuffer *buf;
-
-        buf = g_array_index (sink->bufqueue, GstBuffer *, newbufpos);
-        if (is_sync_frame (sink, buf)) {
-          /* found a buffer that is not a delta unit */
-          break;
-        }
-        newbufpos--;
-      }
+      newbufpos = find_prev_syncframe (sink, newbufpos);
       break;
     default:
       /* unknown recovery procedure */
@@ -1651,6 +2224,121 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
   return newbufpos;
 }
 
+/* The highest position of all clients. The clients that moved forward since
+ * the last sweep are still counted at their old position, which only makes
+ * us keep some buffers longer. */
+static gint
+gst_multi_handle_sink_max_usage (GstMultiHandleSink * sink)
+{
+  guint64 oldest_seq;
+
+  g_mutex_lock (&sink->waiting_lock);
+  oldest_seq = sink->oldest_seq;
+  g_mutex_unlock (&sink->waiting_lock);
+
+  if (oldest_seq >= sink->bufqueue_seq)
+    return 0;
+
+  return sink->bufqueue_seq - 1 - oldest_seq;
+}
+
+/* Check all clients against the limits. If a client moves over the soft max,
+ * we start the recovery procedure for this slow client. If it goes over the
+ * hard max, it is put into the slow list and removed. This also finds the
+ * oldest buffer that is still needed by a client.
+ *
+ * Returns: %TRUE when the handle set changed. */
+static gboolean
+gst_multi_handle_sink_sweep_clients (GstMultiHandleSink * mhsink,
+    gint max_buffers, gint soft_max_buffers, gint spill_buffers)
+{
+  GList *clients, *next;
+  gboolean hash_changed = FALSE;
+  guint64 oldest_seq = G_MAXUINT64;
+  guint cookie;
+
+  /* positions set while the lock is released to remove a client lower it
+   * again */
+  g_mutex_lock (&mhsink->waiting_lock);
+  mhsink->oldest_seq = G_MAXUINT64;
+  g_mutex_unlock (&mhsink->waiting_lock);
+
+restart:
+  cookie = mhsink->clients_cookie;
+  for (clients = mhsink->clients; clients; clients = next) {
+    GstMultiHandleClient *mhclient = clients->data;
+    gint bufpos;
+
+    if (cookie != mhsink->clients_cookie) {
+      GST_DEBUG_OBJECT (mhsink, "Clients cookie outdated, restarting");
+      goto restart;
+    }
+
+    next = g_list_next (clients);
+
+    bufpos = GST_MULTI_HANDLE_CLIENT_BUFPOS (mhsink, mhclient);
+    GST_LOG_OBJECT (mhsink, "%s client %p at position %d",
+        mhclient->debug, mhclient, bufpos);
+    /* move the oldest buffers of a lagging client to its own queue so that
+     * the global queue does not need to keep them. We go down to half the
+     * limit so that this is not needed again for the next buffer. */
+    if (spill_buffers > 0 && !mhclient->new_connection &&
+        bufpos >= spill_buffers) {
+      while (bufpos >= (spill_buffers + 1) / 2) {
+        GstBuffer *old;
+
+        old = g_array_index (mhsink->bufqueue, GstBuffer *, bufpos);
+        g_queue_push_tail (&mhclient->spill, gst_buffer_ref (old));
+        mhclient->spill_bytes += gst_buffer_get_size (old);
+        bufpos--;
+      }
+      gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient, bufpos);
+    }
+    /* check soft max if needed, recover client */
+    if (soft_max_buffers > 0 && bufpos >= soft_max_buffers) {
+      gint newpos;
+
+      newpos = gst_multi_handle_sink_recover_client (mhsink, mhclient);
+      if (newpos != bufpos) {
+        mhclient->dropped_buffers +=
+            bufpos - newpos + mhclient->spill.length;
+        gst_multi_handle_sink_client_clear_spill (mhclient);
+        gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient, newpos);
+        bufpos = newpos;
+        mhclient->discont = TRUE;
+        GST_INFO_OBJECT (mhsink, "%s client %p position reset to %d",
+            mhclient->debug, mhclient, bufpos);
+      } else {
+        GST_INFO_OBJECT (mhsink,
+            "%s client %p not recovering position", mhclient->debug, mhclient);
+      }
+    }
+    /* check hard max, remove client */
+    if ((max_buffers > 0 && bufpos >= max_buffers) ||
+        (mhsink->spill_bytes_max > 0 &&
+            mhclient->spill_bytes > mhsink->spill_bytes_max)) {
+      /* remove client */
+      GST_WARNING_OBJECT (mhsink, "%s client %p is too slow, removing",
+          mhclient->debug, mhclient);
+      /* remove the client, the handle set will be cleared and the select thread
+       * will be signaled */
+      mhclient->status = GST_CLIENT_STATUS_SLOW;
+      /* set client to invalid position while being removed */
+      gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient, -1);
+      gst_multi_handle_sink_remove_client_link (mhsink, clients);
+      hash_changed = TRUE;
+      continue;
+    }
+    oldest_seq = MIN (oldest_seq, mhclient->bufseq);
+  }
+
+  g_mutex_lock (&mhsink->waiting_lock);
+  mhsink->oldest_seq = MIN (mhsink->oldest_seq, oldest_seq);
+  g_mutex_unlock (&mhsink->waiting_lock);
+
+  return hash_changed;
+}
+
 /* Queue a buffer on the global queue.
  *
  * This function adds the buffer to the front of a GArray. It removes the
@@ -1659,29 +2347,32 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
  * started writing out this buffer will still have a reference to it in the
  * mhclient->sending queue.
  *
- * After adding the buffer, we update all client positions in the queue. If
- * a client moves over the soft max, we start the recovery procedure for this
- * slow client. If it goes over the hard max, it is put into the slow list
- * and removed.
+ * The clients keep the sequence number of their next buffer so their
+ * positions move along without touching them. The clients are only all
+ * checked against the limits when the oldest position could be over one of
+ * them and from time to time to release the buffers they don't need
+ * anymore. The clients that timed out are found at the start of the activity
+ * queues of the service threads.
  *
  * Special care is taken of clients that were waiting for a new buffer (they
  * had a position of -1) because they can proceed after adding this new buffer.
  * This is done by adding the client back into the write fd_set and signaling
- * the select thread that the fd_set changed.
+ * the select thread that the fd_set changed. These clients are kept in the
+ * waiting queue so that we don't need to look at the others.
  */
 static void
 gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
     GstBuffer * buffer)
 {
-  GList *clients, *next;
+  GList *walk, *next;
   gint queuelen;
   gboolean hash_changed = FALSE;
   gint max_buffer_usage;
   gint i;
+  guint w;
   GTimeVal nowtv;
   GstClockTime now;
-  gint max_buffers, soft_max_buffers;
-  guint cookie;
+  gint max_buffers, soft_max_buffers, spill_buffers;
   GstMultiHandleSink *sink = GST_MULTI_HANDLE_SINK (mhsink);
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
@@ -1689,6 +2380,7 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   CLIENTS_LOCK (mhsink);
   /* add buffer to queue */
   g_array_prepend_val (mhsink->bufqueue, buffer);
+  gst_multi_handle_sink_index_add (mhsink, buffer);
   queuelen = mhsink->bufqueue->len;
 
   if (mhsink->units_max > 0)
@@ -1700,72 +2392,59 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
     soft_max_buffers = get_buffers_max (mhsink, mhsink->units_soft_max);
   else
     soft_max_buffers = -1;
-  GST_LOG_OBJECT (sink, "Using max %d, softmax %d", max_buffers,
-      soft_max_buffers);
-
-  /* then loop over the clients and update the positions */
-  max_buffer_usage = 0;
+  if (mhsink->units_spill > 0)
+    spill_buffers = get_buffers_max (mhsink, mhsink->units_spill);
+  else
+    spill_buffers = -1;
+  GST_LOG_OBJECT (sink, "Using max %d, softmax %d, spill %d", max_buffers,
+      soft_max_buffers, spill_buffers);
 
-restart:
-  cookie = mhsink->clients_cookie;
-  for (clients = mhsink->clients; clients; clients = next) {
-    GstMultiHandleClient *mhclient = clients->data;
+  g_get_current_time (&nowtv);
+  now = GST_TIMEVAL_TO_TIME (nowtv);
 
-    g_get_current_time (&nowtv);
-    now = GST_TIMEVAL_TO_TIME (nowtv);
+  for (w = 0; w < mhsink->n_workers; w++) {
+    if (gst_multi_handle_sink_worker_remove_timed_out (mhsink,
+            &mhsink->workers[w], now))
+      hash_changed = TRUE;
+  }
 
-    if (cookie != mhsink->clients_cookie) {
-      GST_DEBUG_OBJECT (sink, "Clients cookie outdated, restarting");
-      goto restart;
-    }
+  /* no client can be over a limit when the oldest position is not, soft max
+   * doesn't do anything without a recover policy */
+  max_buffer_usage = gst_multi_handle_sink_max_usage (mhsink);
+  if ((max_buffers > 0 && max_buffer_usage >= max_buffers) ||
+      (soft_max_buffers > 0 && max_buffer_usage >= soft_max_buffers &&
+          mhsink->recover_policy != GST_RECOVER_POLICY_NONE) ||
+      (spill_buffers > 0 && max_buffer_usage >= spill_buffers) ||
+      now - mhsink->last_sweep >= SWEEP_INTERVAL) {
+    if (gst_multi_handle_sink_sweep_clients (mhsink, max_buffers,
+            soft_max_buffers, spill_buffers))
+      hash_changed = TRUE;
+    mhsink->last_sweep = now;
+    max_buffer_usage = gst_multi_handle_sink_max_usage (mhsink);
+  }
 
-    next = g_list_next (clients);
+  /* wake up the clients that were waiting for this buffer */
+  g_mutex_lock (&mhsink->waiting_lock);
+  for (walk = mhsink->waiting.head; walk; walk = next) {
+    GstMultiHandleClient *mhclient = walk->data;
 
-    mhclient->bufpos++;
-    GST_LOG_OBJECT (sink, "%s client %p at position %d",
-        mhclient->debug, mhclient, mhclient->bufpos);
-    /* check soft max if needed, recover client */
-    if (soft_max_buffers > 0 && mhclient->bufpos >= soft_max_buffers) {
-      gint newpos;
+    next = walk->next;
 
-      newpos = gst_multi_handle_sink_recover_client (mhsink, mhclient);
-      if (newpos != mhclient->bufpos) {
-        mhclient->dropped_buffers += mhclient->bufpos - newpos;
-        mhclient->bufpos = newpos;
-        mhclient->discont = TRUE;
-        GST_INFO_OBJECT (sink, "%s client %p position reset to %d",
-            mhclient->debug, mhclient, mhclient->bufpos);
-      } else {
-        GST_INFO_OBJECT (sink,
-            "%s client %p not recovering position", mhclient->debug, mhclient);
-      }
-    }
-    /* check hard max and timeout, remove client */
-    if ((max_buffers > 0 && mhclient->bufpos >= max_buffers) ||
-        (mhsink->timeout > 0
-            && now - mhclient->last_activity_time > mhsink->timeout)) {
-      /* remove client */
-      GST_WARNING_OBJECT (sink, "%s client %p is too slow, removing",
-          mhclient->debug, mhclient);
-      /* remove the client, the handle set will be cleared and the select thread
-       * will be signaled */
-      mhclient->status = GST_CLIENT_STATUS_SLOW;
-      /* set client to invalid position while being removed */
-      mhclient->bufpos = -1;
-      gst_multi_handle_sink_remove_client_link (mhsink, clients);
-      hash_changed = TRUE;
-      continue;
-    } else if (mhclient->bufpos == 0 || mhclient->new_connection) {
-      /* can send data to this client now. need to signal the select thread that
-       * the handle_set changed */
-      mhsinkclass->hash_adding (mhsink, mhclient);
-      hash_changed = TRUE;
-    }
-    /* keep track of maximum buffer usage */
-    if (mhclient->bufpos > max_buffer_usage) {
-      max_buffer_usage = mhclient->bufpos;
+    /* new connections stay until they were given a position, the others
+     * leave when they have a buffer to send now. Clients that were moved
+     * to -1 while checking the limits wait for the next buffer. */
+    if (!mhclient->new_connection) {
+      if (GST_MULTI_HANDLE_CLIENT_BUFPOS (mhsink, mhclient) < 0)
+        continue;
+      g_queue_delete_link (&mhsink->waiting, walk);
+      mhclient->waiting = NULL;
     }
+    /* can send data to this client now. need to signal the select thread that
+     * the handle_set changed */
+    mhsinkclass->hash_adding (mhsink, mhclient);
+    hash_changed = TRUE;
   }
+  g_mutex_unlock (&mhsink->waiting_lock);
 
   /* make sure we respect bytes-min, buffers-min and time-min when they are set */
   {
@@ -1794,7 +2473,6 @@ restart:
       mhsink->def_sync_method == GST_SYNC_METHOD_BURST_KEYFRAME) {
     /* no point in searching beyond the queue length */
     gint limit = queuelen;
-    GstBuffer *buf;
 
     /* no point in searching beyond the soft-max if any. */
     if (soft_max_buffers > 0) {
@@ -1803,14 +2481,11 @@ restart:
     GST_LOG_OBJECT (sink,
         "extending queue to include sync point, now at %d, limit is %d",
         max_buffer_usage, limit);
-    for (i = 0; i < limit; i++) {
-      buf = g_array_index (mhsink->bufqueue, GstBuffer *, i);
-      if (is_sync_frame (mhsink, buf)) {
-        /* found a sync frame, now extend the buffer usage to
-         * include at least this frame. */
-        max_buffer_usage = MAX (max_buffer_usage, i);
-        break;
-      }
+    i = find_next_syncframe (mhsink, 0);
+    if (i != -1 && i < limit) {
+      /* found a sync frame, now extend the buffer usage to
+       * include at least this frame. */
+      max_buffer_usage = MAX (max_buffer_usage, i);
     }
     GST_LOG_OBJECT (sink, "max buffer usage is now %d", max_buffer_usage);
   }
@@ -1820,6 +2495,9 @@ restart:
   /* nobody is referencing units after max_buffer_usage so we can
    * remove them from the queue. We remove them in reverse order as
    * this is the most optimal for GArray. */
+  if (queuelen - 1 > max_buffer_usage)
+    gst_multi_handle_sink_index_remove (mhsink,
+        queuelen - 1 - max_buffer_usage);
   for (i = queuelen - 1; i > max_buffer_usage; i--) {
     GstBuffer *old;
 
@@ -2042,6 +2720,18 @@ gst_multi_handle_sink_set_property (GObject * object, guint prop_id,
     case PROP_RESEND_STREAMHEADER:
       multihandlesink->resend_streamheader = g_value_get_boolean (value);
       break;
+    case PROP_BACKEND:
+      multihandlesink->backend = g_value_get_enum (value);
+      break;
+    case PROP_SERVICE_THREADS:
+      multihandlesink->service_threads = g_value_get_uint (value);
+      break;
+    case PROP_UNITS_SPILL:
+      multihandlesink->units_spill = g_value_get_int64 (value);
+      break;
+    case PROP_SPILL_BYTES_MAX:
+      multihandlesink->spill_bytes_max = g_value_get_uint64 (value);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -2104,7 +2794,8 @@ gst_multi_handle_sink_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, multihandlesink->bytes_to_serve);
       break;
     case PROP_BYTES_SERVED:
-      g_value_set_uint64 (value, multihandlesink->bytes_served);
+      g_value_set_uint64 (value,
+          gst_multi_handle_sink_get_bytes_served (multihandlesink));
       break;
     case PROP_BURST_FORMAT:
       g_value_set_enum (value, multihandlesink->def_burst_format);
@@ -2118,6 +2809,18 @@ gst_multi_handle_sink_get_property (GObject * object, guint prop_id,
     case PROP_RESEND_STREAMHEADER:
       g_value_set_boolean (value, multihandlesink->resend_streamheader);
       break;
+    case PROP_BACKEND:
+      g_value_set_enum (value, multihandlesink->backend);
+      break;
+    case PROP_SERVICE_THREADS:
+      g_value_set_uint (value, multihandlesink->service_threads);
+      break;
+    case PROP_UNITS_SPILL:
+      g_value_set_int64 (value, multihandlesink->units_spill);
+      break;
+    case PROP_SPILL_BYTES_MAX:
+      g_value_set_uint64 (value, multihandlesink->spill_bytes_max);
+      break;
     case PROP_NUM_HANDLES:
       g_value_set_uint (value,
           g_hash_table_size (multihandlesink->handle_hash));
@@ -2128,12 +2831,54 @@ gst_multi_handle_sink_get_property (GObject * object, guint prop_id,
   }
 }
 
+static gpointer
+gst_multi_handle_sink_worker_thread (GstMultiHandleSinkWorker * worker)
+{
+  GstMultiHandleSink *mhsink = worker->sink;
+
+  return GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink)->thread (mhsink, worker);
+}
+
+static void
+gst_multi_handle_sink_set_workers (GstMultiHandleSink * mhsink,
+    GstMultiHandleSinkWorker * workers, guint n_workers)
+{
+  /* only the clientslock, the service thread locks are taken by
+   * CLIENTS_LOCK depending on the number of workers */
+  g_rec_mutex_lock (&mhsink->clientslock);
+  mhsink->workers = workers;
+  mhsink->n_workers = n_workers;
+  g_rec_mutex_unlock (&mhsink->clientslock);
+}
+
+/* should be called when the service threads are not running */
+static void
+gst_multi_handle_sink_free_workers (GstMultiHandleSink * mhsink)
+{
+  GstMultiHandleSinkWorker *workers = mhsink->workers;
+  guint i, n_workers = mhsink->n_workers;
+
+  /* keep the served bytes for the property */
+  for (i = 0; i < n_workers; i++)
+    mhsink->bytes_served += workers[i].bytes_served;
+
+  gst_multi_handle_sink_set_workers (mhsink, NULL, 0);
+
+  for (i = 0; i < n_workers; i++) {
+    g_slist_free (workers[i].removed);
+    g_rec_mutex_clear (&workers[i].lock);
+  }
+  g_free (workers);
+}
+
 /* create a socket for sending to remote machine */
 static gboolean
 gst_multi_handle_sink_start (GstBaseSink * bsink)
 {
   GstMultiHandleSinkClass *mhsclass;
   GstMultiHandleSink *mhsink;
+  GstMultiHandleSinkWorker *workers;
+  guint i, n_workers;
 
   if (GST_OBJECT_FLAG_IS_SET (bsink, GST_MULTI_HANDLE_SINK_OPEN))
     return TRUE;
@@ -2141,8 +2886,19 @@ gst_multi_handle_sink_start (GstBaseSink * bsink)
   mhsink = GST_MULTI_HANDLE_SINK (bsink);
   mhsclass = GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
 
-  if (!mhsclass->start_pre (mhsink))
+  n_workers = MAX (mhsink->service_threads, 1);
+  workers = g_new0 (GstMultiHandleSinkWorker, n_workers);
+  for (i = 0; i < n_workers; i++) {
+    workers[i].sink = mhsink;
+    workers[i].index = i;
+    g_rec_mutex_init (&workers[i].lock);
+  }
+  gst_multi_handle_sink_set_workers (mhsink, workers, n_workers);
+
+  if (!mhsclass->start_pre (mhsink)) {
+    gst_multi_handle_sink_free_workers (mhsink);
     return FALSE;
+  }
 
   mhsink->bytes_to_serve = 0;
   mhsink->bytes_served = 0;
@@ -2153,8 +2909,11 @@ gst_multi_handle_sink_start (GstBaseSink * bsink)
 
   mhsink->running = TRUE;
 
-  mhsink->thread = g_thread_new ("multihandlesink",
-      (GThreadFunc) mhsclass->thread, mhsink);
+  GST_DEBUG_OBJECT (mhsink, "starting %u service threads", n_workers);
+  for (i = 0; i < n_workers; i++) {
+    workers[i].thread = g_thread_new ("multihandlesink",
+        (GThreadFunc) gst_multi_handle_sink_worker_thread, &workers[i]);
+  }
 
   GST_OBJECT_FLAG_SET (bsink, GST_MULTI_HANDLE_SINK_OPEN);
 
@@ -2167,6 +2926,7 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
   GstMultiHandleSinkClass *mhclass;
   GstBuffer *buf;
   gint i;
+  guint j;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (bsink);
 
   mhclass = GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
@@ -2178,11 +2938,13 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
 
   mhclass->stop_pre (mhsink);
 
-  if (mhsink->thread) {
-    GST_DEBUG_OBJECT (mhsink, "joining thread");
-    g_thread_join (mhsink->thread);
-    GST_DEBUG_OBJECT (mhsink, "joined thread");
-    mhsink->thread = NULL;
+  for (j = 0; j < mhsink->n_workers; j++) {
+    if (mhsink->workers[j].thread) {
+      GST_DEBUG_OBJECT (mhsink, "joining thread %u", j);
+      g_thread_join (mhsink->workers[j].thread);
+      GST_DEBUG_OBJECT (mhsink, "joined thread %u", j);
+      mhsink->workers[j].thread = NULL;
+    }
   }
 
   /* free the clients */
@@ -2193,6 +2955,8 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
 
   mhclass->stop_post (mhsink);
 
+  gst_multi_handle_sink_free_workers (mhsink);
+
   /* remove all queued buffers */
   if (mhsink->bufqueue) {
     GST_DEBUG_OBJECT (mhsink, "Emptying bufqueue with %d buffers",
@@ -2204,6 +2968,7 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
       gst_buffer_unref (buf);
       mhsink->bufqueue = g_array_remove_index (mhsink->bufqueue, i);
     }
+    gst_multi_handle_sink_index_clear (mhsink);
     /* freeing the array is done in _finalize */
   }
   GST_OBJECT_FLAG_UNSET (mhsink, GST_MULTI_HANDLE_SINK_OPEN);
@@ -2221,7 +2986,7 @@ gst_multi_handle_sink_change_state (GstElement * element,
   sink = GST_MULTI_HANDLE_SINK (element);
 
   /* we disallow changing the state from the streaming thread */
-  if (g_thread_self () == sink->thread)
+  if (gst_multi_handle_sink_is_worker_thread (sink))
     return GST_STATE_CHANGE_FAILURE;
 
 
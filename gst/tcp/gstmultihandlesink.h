@@ -121,6 +121,22 @@ typedef enum
   GST_CLIENT_STATUS_FLUSHING    = 6
 } GstClientStatus;
 
+/**
+ * GstMultiHandleSinkBackend:
+ * @GST_MULTI_HANDLE_SINK_BACKEND_POLL  : wait on all client handles with
+ *                                        poll() or per client sources
+ * @GST_MULTI_HANDLE_SINK_BACKEND_EPOLL : keep the client handles in an
+ *                                        epoll set and only handle the
+ *                                        clients that have events
+ *
+ * The mechanism used to wait for client readiness.
+ */
+typedef enum
+{
+  GST_MULTI_HANDLE_SINK_BACKEND_POLL,
+  GST_MULTI_HANDLE_SINK_BACKEND_EPOLL
+} GstMultiHandleSinkBackend;
+
 // FIXME: is it better to use GSocket * or a gpointer here ?
 typedef union
 {
@@ -136,7 +152,11 @@ typedef struct {
 
   gchar debug[30];              /* a debug string used in debug calls to
                                    identify the client */
-  gint bufpos;                  /* position of this client in the global queue */
+  guint64 bufseq;               /* sequence number of the next buffer of the
+                                   global queue to send, the position in the
+                                   queue follows from it, see
+                                   GST_MULTI_HANDLE_CLIENT_BUFPOS */
+  GList *waiting;               /* link in the waiting clients of the sink */
   gint flushcount;              /* the remaining number of buffers to flush out or -1 if the 
                                    client is not flushing. */
 
@@ -145,11 +165,21 @@ typedef struct {
   GSList *sending;              /* the buffers we need to send */
   gint bufoffset;               /* offset in the first buffer */
 
+  GQueue spill;                 /* buffers this client still has to send that
+                                   were moved out of the global queue, oldest
+                                   first */
+  guint64 spill_bytes;          /* size of the buffers in spill */
+
   gboolean discont;
 
   gboolean new_connection;
   gboolean currently_removing;
 
+  guint worker;                 /* index of the service thread serving
+                                   this client */
+  GList activity_link;          /* link in the activity queue of the
+                                   service thread */
+
 
   /* method to sync client when connecting */
   GstSyncMethod sync_method;
@@ -171,15 +201,59 @@ typedef struct {
   guint64 last_buffer_ts;
 } GstMultiHandleClient;
 
+/* a service thread, serving a part of the clients */
+typedef struct {
+  GstMultiHandleSink *sink;
+  guint index;
+
+  GRecMutex lock;       /* protects the clients of this thread, only used
+                           with more than one service thread */
+  GThread *thread;
+
+  guint n_clients;      /* number of clients served by this thread */
+  GQueue active;        /* the clients of this thread, the least recently
+                           active first, for the timeout */
+  guint64 bytes_served; /* bytes served by this thread */
+  GSList *removed;      /* hash keys of clients to remove */
+} GstMultiHandleSinkWorker;
+
 #define CLIENTS_LOCK_INIT(mhsink)       (g_rec_mutex_init(&(mhsink)->clientslock))
 #define CLIENTS_LOCK_CLEAR(mhsink)      (g_rec_mutex_clear(&(mhsink)->clientslock))
-#define CLIENTS_LOCK(mhsink)            (g_rec_mutex_lock(&(mhsink)->clientslock))
-#define CLIENTS_UNLOCK(mhsink)          (g_rec_mutex_unlock(&(mhsink)->clientslock))
+#define CLIENTS_LOCK(mhsink)            (gst_multi_handle_sink_clients_lock(mhsink))
+#define CLIENTS_UNLOCK(mhsink)          (gst_multi_handle_sink_clients_unlock(mhsink))
+
+/* used by the service threads to access their own clients */
+#define WORKER_LOCK(mhsink,worker)      (gst_multi_handle_sink_worker_lock(mhsink,worker))
+#define WORKER_UNLOCK(mhsink,worker)    (gst_multi_handle_sink_worker_unlock(mhsink,worker))
+
+#define GST_MULTI_HANDLE_SINK_CLIENT_WORKER(mhsink,client) \
+  (&(mhsink)->workers[((GstMultiHandleClient *) (client))->worker])
+
+/* position of the client in the global queue, -1 when it has sent all the
+ * buffers. It grows by itself when a buffer is queued. */
+#define GST_MULTI_HANDLE_CLIENT_BUFPOS(mhsink,client) \
+  ((gint) ((mhsink)->bufqueue_seq - 1 - \
+      ((GstMultiHandleClient *) (client))->bufseq))
 
 gint gst_multi_handle_sink_setup_dscp_client (GstMultiHandleSink * sink, GstMultiHandleClient * client);
 gint
 gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     GstMultiHandleClient * client);
+GstBuffer *
+gst_multi_handle_sink_client_next_buffer (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client);
+void
+gst_multi_handle_sink_client_set_bufpos (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, gint bufpos);
+void
+gst_multi_handle_sink_client_activity (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, GstClockTime now);
+GstClockTime
+gst_multi_handle_sink_worker_next_timeout (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker);
+gboolean
+gst_multi_handle_sink_worker_remove_timed_out (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker, GstClockTime now);
 
 /**
  * GstMultiHandleSink:
@@ -193,7 +267,8 @@ struct _GstMultiHandleSink {
   guint64 bytes_to_serve; /* how much bytes we must serve */
   guint64 bytes_served; /* how much bytes have we served */
 
-  GRecMutex clientslock;  /* lock to protect the clients list */
+  GRecMutex clientslock;  /* lock to protect the clients list, together with
+                             the locks of the service threads */
   GList *clients;       /* list of clients we are serving */
   guint clients_cookie; /* Cookie to detect changes to the clients list */
 
@@ -206,8 +281,26 @@ struct _GstMultiHandleSink {
 
   GArray *bufqueue;     /* global queue of buffers */
 
+  /* index of the buffer queue, kept in queue order from old to new so that
+   * new clients can be positioned with a binary search */
+  guint64 bufqueue_seq;   /* number of buffers queued so far */
+  guint64 bufqueue_bytes; /* number of bytes queued so far */
+  GArray *bufoffsets;     /* guint64 byte offset of each queued buffer */
+  GArray *syncframes;     /* guint64 sequence number of the queued sync frames */
+  GArray *timestamps;     /* sequence number and timestamp of each queued
+                           * buffer with a valid timestamp */
+  guint ts_backwards;     /* number of queued timestamps going backwards */
+
+  /* the clients are only all checked for their limits from time to time,
+   * queueing a buffer only handles the clients that were waiting for it */
+  GMutex waiting_lock;    /* protects waiting and oldest_seq */
+  GQueue waiting;         /* clients at position -1 and new connections */
+  guint64 oldest_seq;     /* no client is at an older buffer than this */
+  GstClockTime last_sweep; /* last time all clients were checked */
+
   gboolean running;     /* the thread state */
-  GThread *thread;      /* the sender thread */
+  GstMultiHandleSinkWorker *workers; /* the sender threads */
+  guint n_workers;
 
   /* these values are used to check if a client is reading fast
    * enough and to control receovery */
@@ -216,6 +309,9 @@ struct _GstMultiHandleSink {
   gint64 units_soft_max;  /* max units a client can lag before recovery starts */
   GstRecoverPolicy recover_policy;
   GstClockTime timeout; /* max amount of nanoseconds to remain idle */
+  gint64 units_spill;     /* position in units after which a client gets
+                             its own queue */
+  guint64 spill_bytes_max; /* max bytes in the queue of a client */
 
   GstSyncMethod def_sync_method;    /* what method to use for connecting clients */
   GstFormat     def_burst_format;
@@ -229,6 +325,13 @@ struct _GstMultiHandleSink {
   gint   buffers_min;   /* min number of buffers to queue */
 
   gboolean resend_streamheader; /* resend streamheader if it changes */
+  GstCaps *sh_caps;             /* caps of sh_buffer */
+  GstBuffer *sh_buffer;         /* the streamheader of sh_caps in one buffer,
+                                   shared by all clients. Protected with the
+                                   object lock */
+
+  GstMultiHandleSinkBackend backend; /* used from the next start */
+  guint service_threads;             /* used from the next start */
 
   /* stats */
   gint buffers_queued;  /* number of queued buffers */
@@ -244,7 +347,8 @@ struct _GstMultiHandleSinkClass {
   void          (*stop_pre)     (GstMultiHandleSink *sink);
   void          (*stop_post)    (GstMultiHandleSink *sink);
   gboolean      (*start_pre)    (GstMultiHandleSink *sink);
-  gpointer      (*thread)       (GstMultiHandleSink *sink);
+  gpointer      (*thread)       (GstMultiHandleSink *sink,
+                                 GstMultiHandleSinkWorker *worker);
   /* called by subclass when it has a new buffer to queue for a client */
   gboolean      (*client_queue_buffer)
                                 (GstMultiHandleSink *sink,
@@ -285,7 +389,17 @@ GstStructure*  gst_multi_handle_sink_get_stats    (GstMultiHandleSink *sink, Gst
 void gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
     GList * link);
 
-void gst_multi_handle_sink_client_init (GstMultiHandleClient * client, GstSyncMethod sync_method);
+void gst_multi_handle_sink_client_init (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, GstSyncMethod sync_method);
+
+void gst_multi_handle_sink_clients_lock (GstMultiHandleSink * sink);
+void gst_multi_handle_sink_clients_unlock (GstMultiHandleSink * sink);
+void gst_multi_handle_sink_worker_lock (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker);
+void gst_multi_handle_sink_worker_unlock (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker);
+void gst_multi_handle_sink_worker_remove_client_link (GstMultiHandleSink * sink,
+    GstMultiHandleSinkWorker * worker, GList * link);
 
 #define GST_TYPE_RECOVER_POLICY (gst_multi_handle_sink_recover_policy_get_type())
 GType gst_multi_handle_sink_recover_policy_get_type (void);
@@ -293,6 +407,8 @@ GType gst_multi_handle_sink_recover_policy_get_type (void);
 GType gst_multi_handle_sink_sync_method_get_type (void);
 #define GST_TYPE_CLIENT_STATUS (gst_multi_handle_sink_client_status_get_type())
 GType gst_multi_handle_sink_client_status_get_type (void);
+#define GST_TYPE_MULTI_HANDLE_SINK_BACKEND (gst_multi_handle_sink_backend_get_type())
+GType gst_multi_handle_sink_backend_get_type (void);
 
 
 G_END_DECLS
@@ -96,6 +96,11 @@
  * buffers to the clients. This behaviour can be disabled by setting the sync 
  * property to FALSE. Multisocketsink will by default not do QoS and will never
  * drop late buffers.
+ *
+ * On Linux, TLS can be served without a proxy: the application does the TLS
+ * handshake, configures kernel TLS (TLS_TX) on the socket with the resulting
+ * keys and then adds the socket. Multisocketsink sends the plain data and the
+ * kernel, or the network card, makes the encrypted records.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -104,6 +109,7 @@
 
 #include <gst/gst-i18n-plugin.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
+#include <gst/allocators/gstfdmemory.h>
 
 #include <string.h>
 
@@ -111,10 +117,55 @@
 
 #ifndef G_OS_WIN32
 #include <netinet/in.h>
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <errno.h>
+#ifdef HAVE_LINUX_SOCKIOS_H
+#include <linux/sockios.h>
+#endif
+/* we need SIOCOUTQ to know when the peer acked the data */
+#ifdef SIOCOUTQ
+#define HAVE_SENDFILE 1
+#endif
+#endif
+
+#ifdef HAVE_LINUX_ERRQUEUE_H
+#include <sys/socket.h>
+#include <linux/errqueue.h>
+#include <errno.h>
+#if defined (MSG_ZEROCOPY) && defined (SO_ZEROCOPY) && defined (SO_EE_ORIGIN_ZEROCOPY)
+#define HAVE_MSG_ZEROCOPY 1
+#endif
+#endif
+
+#ifdef HAVE_LINUX_TLS_H
+#include <sys/socket.h>
+#include <linux/tls.h>
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifdef TLS_TX
+#define HAVE_KTLS 1
+#endif
+#endif
 #endif
 
+/* smaller sends are cheaper to copy than to pin and track */
+#define ZEROCOPY_MIN_SIZE (16 * 1024)
+
 #define NOT_IMPLEMENTED 0
 
+#define CLIENT_WORKER(sink,client) \
+  (&(sink)->workers[((GstMultiHandleClient *) (client))->worker])
+
 GST_DEBUG_CATEGORY_STATIC (multisocketsink_debug);
 #define GST_CAT_DEFAULT (multisocketsink_debug)
 
@@ -138,12 +189,14 @@ enum
 
 #define DEFAULT_SEND_DISPATCHED FALSE
 #define DEFAULT_SEND_MESSAGES   FALSE
+#define DEFAULT_ZERO_COPY       FALSE
 
 enum
 {
   PROP_0,
   PROP_SEND_DISPATCHED,
   PROP_SEND_MESSAGES,
+  PROP_ZERO_COPY,
   PROP_LAST
 };
 
@@ -169,7 +222,8 @@ static void gst_multi_socket_sink_emit_client_removed (GstMultiHandleSink * mhs,
 static void gst_multi_socket_sink_stop_pre (GstMultiHandleSink * mhsink);
 static void gst_multi_socket_sink_stop_post (GstMultiHandleSink * mhsink);
 static gboolean gst_multi_socket_sink_start_pre (GstMultiHandleSink * mhsink);
-static gpointer gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink);
+static gpointer gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink,
+    GstMultiHandleSinkWorker * worker);
 static GstMultiHandleClient
     * gst_multi_socket_sink_new_client (GstMultiHandleSink * mhsink,
     GstMultiSinkHandle handle, GstSyncMethod sync_method);
@@ -189,7 +243,7 @@ static void gst_multi_socket_sink_stop_sending (GstMultiSocketSink * sink,
     GstSocketClient * client);
 
 static gboolean gst_multi_socket_sink_socket_condition (GstMultiSinkHandle
-    handle, GIOCondition condition, GstMultiSocketSink * sink);
+    handle, GIOCondition condition, GstMultiHandleSinkWorker * worker);
 
 static gboolean gst_multi_socket_sink_unlock (GstBaseSink * bsink);
 static gboolean gst_multi_socket_sink_unlock_stop (GstBaseSink * bsink);
@@ -259,6 +313,26 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
       g_param_spec_boolean ("send-messages", "Send Messages",
           "If GstNetworkMessage events should be pushed", DEFAULT_SEND_MESSAGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMultiSocketSink:zero-copy:
+   *
+   * Avoid copying the data into the kernel when sending to clients.
+   * Memory backed by a file descriptor is sent with sendfile() and large
+   * payloads are sent with MSG_ZEROCOPY on sockets that support it. In both
+   * cases the buffer is kept alive until the kernel is done with it, which
+   * increases the amount of memory in use per client.
+   *
+   * Falls back to a normal copying send when the platform, the socket or
+   * the memory does not support it. Sockets on which the application
+   * configured kernel TLS (TLS_TX) are never sent to with MSG_ZEROCOPY,
+   * sendfile() is still used for them.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero Copy",
+          "Send without copying the data into the kernel when possible",
+          DEFAULT_ZERO_COPY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   /**
    * GstMultiSocketSink::add:
@@ -450,6 +524,7 @@ gst_multi_socket_sink_init (GstMultiSocketSink * this)
   this->cancellable = g_cancellable_new ();
   this->send_dispatched = DEFAULT_SEND_DISPATCHED;
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->zero_copy = DEFAULT_ZERO_COPY;
 }
 
 static void
@@ -535,6 +610,45 @@ gst_multi_socket_sink_get_stats (GstMultiSocketSink * sink, GSocket * socket)
       handle);
 }
 
+/* a buffer the kernel might still reference after it was sent */
+typedef struct
+{
+  /* MSG_ZEROCOPY send id or, for sendfile, the stream offset
+   * after the last byte that was sent from the buffer */
+  guint64 id;
+  GstBuffer *buffer;
+} GstSocketClientPending;
+
+#if defined (HAVE_SENDFILE) || defined (HAVE_MSG_ZEROCOPY)
+static void
+gst_multi_socket_sink_hold_pending (GQueue * queue, guint64 id,
+    GstBuffer * buffer)
+{
+  GstSocketClientPending *pending = g_queue_peek_tail (queue);
+
+  /* consecutive sends of the same buffer only need one ref */
+  if (pending == NULL || pending->buffer != buffer) {
+    pending = g_slice_new (GstSocketClientPending);
+    pending->buffer = gst_buffer_ref (buffer);
+    g_queue_push_tail (queue, pending);
+  }
+  pending->id = id;
+}
+#endif
+
+/* releases all buffers up to and including @id */
+static void
+gst_multi_socket_sink_release_pending (GQueue * queue, guint64 id)
+{
+  GstSocketClientPending *pending;
+
+  while ((pending = g_queue_peek_head (queue)) && pending->id <= id) {
+    g_queue_pop_head (queue);
+    gst_buffer_unref (pending->buffer);
+    g_slice_free (GstSocketClientPending, pending);
+  }
+}
+
 static GstMultiHandleClient *
 gst_multi_socket_sink_new_client (GstMultiHandleSink * mhsink,
     GstMultiSinkHandle handle, GstSyncMethod sync_method)
@@ -551,12 +665,46 @@ gst_multi_socket_sink_new_client (GstMultiHandleSink * mhsink,
 
   mhclient->handle.socket = G_SOCKET (g_object_ref (handle.socket));
 
-  gst_multi_handle_sink_client_init (mhclient, sync_method);
+  gst_multi_handle_sink_client_init (mhsink, mhclient, sync_method);
   mhsinkclass->handle_debug (handle, mhclient->debug);
 
   /* set the socket to non blocking */
   g_socket_set_blocking (handle.socket, FALSE);
 
+  g_queue_init (&client->zc_pending);
+  g_queue_init (&client->sf_pending);
+#ifdef HAVE_KTLS
+  {
+    struct tls_crypto_info info;
+    socklen_t len = sizeof (info);
+
+    /* the application did the handshake and handed the keys to the kernel,
+     * we then send plain data and the kernel makes the TLS records */
+    if (getsockopt (g_socket_get_fd (handle.socket), SOL_TLS, TLS_TX, &info,
+            &len) == 0) {
+      GST_DEBUG_OBJECT (mhsink, "%s kernel TLS version 0x%04x cipher %u",
+          mhclient->debug, info.version, info.cipher_type);
+      client->ktls = TRUE;
+    }
+  }
+#endif
+#ifdef HAVE_MSG_ZEROCOPY
+  /* kernel TLS rejects MSG_ZEROCOPY sends */
+  if (GST_MULTI_SOCKET_SINK (mhsink)->zero_copy && !client->ktls) {
+    GError *err = NULL;
+
+    /* fails on kernels and socket families without zerocopy support, we
+     * then simply do copying sends */
+    if (g_socket_set_option (handle.socket, SOL_SOCKET, SO_ZEROCOPY, 1, &err)) {
+      client->zerocopy = TRUE;
+    } else {
+      GST_DEBUG_OBJECT (mhsink, "%s no MSG_ZEROCOPY support: %s",
+          mhclient->debug, err->message);
+      g_clear_error (&err);
+    }
+  }
+#endif
+
   /* we always read from a client */
   mhsinkclass->hash_adding (mhsink, mhclient);
 
@@ -575,12 +723,19 @@ static void
 gst_multi_socket_sink_client_free (GstMultiHandleSink * mhsink,
     GstMultiHandleClient * client)
 {
+  GstSocketClient *sclient = (GstSocketClient *) client;
+
   g_assert (G_IS_SOCKET (client->handle.socket));
 
   g_signal_emit (mhsink,
       gst_multi_socket_sink_signals[SIGNAL_CLIENT_SOCKET_REMOVED], 0,
       client->handle.socket);
 
+  /* the kernel might still reference the memory of these when the socket
+   * lingers, there is nothing we can wait on anymore though */
+  gst_multi_socket_sink_release_pending (&sclient->zc_pending, G_MAXUINT64);
+  gst_multi_socket_sink_release_pending (&sclient->sf_pending, G_MAXUINT64);
+
   g_object_unref (client->handle.socket);
 }
 
@@ -771,13 +926,142 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
   return msg_count;
 }
 
+#ifdef HAVE_SENDFILE
+/* the pages given to sendfile() are referenced by the socket until the peer
+ * acked them, release the buffers of all data that left the send queue */
+static void
+gst_multi_socket_sink_sendfile_complete (GstSocketClient * client)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  gint outq;
+
+  if (g_queue_is_empty (&client->sf_pending))
+    return;
+
+  if (ioctl (g_socket_get_fd (mhclient->handle.socket), SIOCOUTQ, &outq) < 0
+      || outq > mhclient->bytes_sent)
+    return;
+
+  gst_multi_socket_sink_release_pending (&client->sf_pending,
+      mhclient->bytes_sent - outq);
+}
+
+/* sends the fd backed memory at @bufoffset with sendfile(). Returns FALSE
+ * when that is not possible and a normal send should be done instead. */
+static gboolean
+gst_multi_socket_sink_sendfile (GstMultiSocketSink * sink,
+    GstSocketClient * client, GstBuffer * buffer, gsize bufoffset,
+    gssize * wrote, GError ** err)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMemory *mem;
+  guint idx;
+  gsize len, skip;
+  off_t offset;
+  gssize res;
+
+  if (!gst_buffer_find_memory (buffer, bufoffset, 1, &idx, &len, &skip))
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (buffer, idx);
+  if (!gst_is_fd_memory (mem))
+    return FALSE;
+
+  offset = mem->offset + skip;
+  do {
+    res = sendfile (g_socket_get_fd (mhclient->handle.socket),
+        gst_fd_memory_get_fd (mem), &offset, mem->size - skip);
+  } while (res < 0 && errno == EINTR);
+
+  if (res < 0) {
+    gint errsv = errno;
+
+    /* fd type not supported by sendfile, send a copy */
+    if (errsv == EINVAL || errsv == ENOSYS || errsv == EOPNOTSUPP) {
+      GST_LOG_OBJECT (sink, "%s can't sendfile: %s", mhclient->debug,
+          g_strerror (errsv));
+      return FALSE;
+    }
+    g_set_error (err, G_IO_ERROR, g_io_error_from_errno (errsv),
+        "Error sending data: %s", g_strerror (errsv));
+  } else {
+    gst_multi_socket_sink_hold_pending (&client->sf_pending,
+        mhclient->bytes_sent + res, buffer);
+  }
+  *wrote = res;
+
+  return TRUE;
+}
+#endif
+
+#ifdef HAVE_MSG_ZEROCOPY
+/* reads the MSG_ZEROCOPY completions from the error queue of the socket and
+ * releases the buffers the kernel is done with. Returns TRUE when the
+ * queue only contained completions. */
+static gboolean
+gst_multi_socket_sink_zerocopy_complete (GstMultiSocketSink * sink,
+    GstSocketClient * client)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  gint fd = g_socket_get_fd (mhclient->handle.socket);
+  gchar control[128];
+  struct msghdr msg;
+  struct cmsghdr *cm;
+  struct sock_extended_err *serr;
+  GstSocketClientPending *pending;
+  gboolean ret = FALSE;
+
+  for (;;) {
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof (control);
+
+    if (recvmsg (fd, &msg, MSG_ERRQUEUE) < 0) {
+      if (errno == EINTR)
+        continue;
+      /* EAGAIN, the queue is empty */
+      break;
+    }
+
+    for (cm = CMSG_FIRSTHDR (&msg); cm; cm = CMSG_NXTHDR (&msg, cm)) {
+      if (!(cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVERR) &&
+          !(cm->cmsg_level == IPPROTO_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+        continue;
+
+      serr = (struct sock_extended_err *) CMSG_DATA (cm);
+      if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY || serr->ee_errno != 0)
+        return FALSE;
+
+      if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        /* the kernel had to copy anyway, stop paying for the tracking */
+        GST_DEBUG_OBJECT (sink, "%s zerocopy sends were copied, disabling",
+            mhclient->debug);
+        client->zerocopy = FALSE;
+      }
+
+      /* ee_info..ee_data is the range of completed sends, ids wrap around */
+      while ((pending = g_queue_peek_head (&client->zc_pending)) &&
+          (gint32) ((guint32) pending->id - serr->ee_data) <= 0) {
+        g_queue_pop_head (&client->zc_pending);
+        gst_buffer_unref (pending->buffer);
+        g_slice_free (GstSocketClientPending, pending);
+      }
+      ret = TRUE;
+    }
+  }
+
+  return ret;
+}
+#endif
+
 #define CMSG_MAX 255
 
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
-    GSocket * sock, GstBuffer * buffer, gsize bufoffset,
+    GstSocketClient * client, GstBuffer * buffer, gsize bufoffset,
     GCancellable * cancellable, GError ** err)
 {
+  GSocket *sock = ((GstMultiHandleClient *) client)->handle.socket;
   GstMapInfo maps[8];
   GOutputVector vec[8];
   guint mems_mapped;
@@ -785,13 +1069,50 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
 
+  msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
+
+#ifdef HAVE_SENDFILE
+  gst_multi_socket_sink_sendfile_complete (client);
+
+  /* sendfile can't carry control messages */
+  if (sink->zero_copy && msg_count == 0 &&
+      gst_multi_socket_sink_sendfile (sink, client, buffer, bufoffset, &wrote,
+          err))
+    return wrote;
+#endif
+
   mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
 
-  msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
+#ifdef HAVE_MSG_ZEROCOPY
+  if (client->zerocopy &&
+      gst_buffer_get_size (buffer) - bufoffset >= ZEROCOPY_MIN_SIZE) {
+    wrote =
+        g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count,
+        MSG_ZEROCOPY, cancellable, err);
+    if (wrote >= 0) {
+      /* every successful zerocopy send gets the next id */
+      gst_multi_socket_sink_hold_pending (&client->zc_pending,
+          client->zc_next++, buffer);
+      goto done;
+    }
+    if (g_error_matches (*err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK) ||
+        g_error_matches (*err, G_IO_ERROR, G_IO_ERROR_CLOSED))
+      goto done;
+
+    /* ENOBUFS when the pinned memory exceeds the socket optmem limit */
+    GST_LOG_OBJECT (sink, "zerocopy send failed, copying: %s",
+        (*err)->message);
+    g_clear_error (err);
+  }
+#endif
 
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
       cancellable, err);
+
+#ifdef HAVE_MSG_ZEROCOPY
+done:
+#endif
   unmap_n_memorys (maps, mems_mapped);
   return wrote;
 }
@@ -842,7 +1163,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   do {
     if (!mhclient->sending) {
       /* client is not working on a buffer */
-      if (mhclient->bufpos == -1) {
+      if (GST_MULTI_HANDLE_CLIENT_BUFPOS (mhsink, mhclient) == -1 &&
+          g_queue_is_empty (&mhclient->spill)) {
         /* client is too fast, remove from write queue until new buffer is
          * available */
         gst_multi_socket_sink_stop_sending (sink, client);
@@ -866,7 +1188,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           if (position >= 0) {
             /* we got a valid spot in the queue */
             mhclient->new_connection = FALSE;
-            mhclient->bufpos = position;
+            gst_multi_handle_sink_client_set_bufpos (mhsink, mhclient,
+                position);
           } else {
             /* cannot send data to this client yet */
             gst_multi_socket_sink_stop_sending (sink, client);
@@ -879,8 +1202,7 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto flushed;
 
         /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
+        buf = gst_multi_handle_sink_client_next_buffer (mhsink, mhclient);
 
         /* update stats */
         timestamp = GST_BUFFER_TIMESTAMP (buf);
@@ -894,10 +1216,12 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           mhclient->flushcount--;
 
         GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
+            mhclient->debug, client,
+            GST_MULTI_HANDLE_CLIENT_BUFPOS (mhsink, mhclient));
 
         /* queueing a buffer will ref it */
         mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+        gst_buffer_unref (buf);
 
         /* need to start from the first byte for this new buffer */
         mhclient->bufoffset = 0;
@@ -912,7 +1236,7 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
       /* pick first buffer from list */
       head = GST_BUFFER (mhclient->sending->data);
 
-      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
+      wrote = gst_multi_socket_sink_write (sink, client, head,
           mhclient->bufoffset, sink->cancellable, &err);
 
       if (wrote < 0) {
@@ -924,6 +1248,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           GST_LOG_OBJECT (sink, "write would block %p",
               mhclient->handle.socket);
           more = FALSE;
+          /* wait for the next writable edge */
+          client->can_write = FALSE;
           g_clear_error (&err);
         } else {
           goto write_error;
@@ -951,8 +1277,9 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
-        mhclient->last_activity_time = now;
-        mhsink->bytes_served += wrote;
+        gst_multi_handle_sink_client_activity (mhsink, mhclient, now);
+        GST_MULTI_HANDLE_SINK_CLIENT_WORKER (mhsink,
+            mhclient)->bytes_served += wrote;
       }
     }
   } while (more);
@@ -985,11 +1312,72 @@ write_error:
   }
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+/* With epoll the socket is registered once for all events, edge-triggered.
+ * The condition only tells us if the client wants to write. */
+static void
+ensure_condition_epoll (GstMultiSocketSink * sink, GstSocketClient * client,
+    GIOCondition condition)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiSocketSinkWorker *worker = CLIENT_WORKER (sink, client);
+  gint fd = g_socket_get_fd (mhclient->handle.socket);
+
+  if (condition == 0) {
+    if (client->registered) {
+      epoll_ctl (worker->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+      client->registered = FALSE;
+    }
+    client->condition = 0;
+    return;
+  }
+
+  if (!client->registered) {
+    struct epoll_event ev = { 0, };
+
+    ev.events = EPOLLIN | EPOLLPRI | EPOLLOUT | EPOLLET;
+    ev.data.ptr = mhclient->handle.socket;
+
+    if (epoll_ctl (worker->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      GST_WARNING_OBJECT (sink, "%s could not add to epoll set: %s",
+          mhclient->debug, g_strerror (errno));
+      /* make the epoll source look at it, it will be removed there */
+      mhclient->status = GST_CLIENT_STATUS_ERROR;
+      condition |= G_IO_OUT;
+      client->can_write = TRUE;
+    } else {
+      client->registered = TRUE;
+    }
+  }
+  client->condition = condition;
+
+  /* writability is only signalled on change, so a client that is already
+   * writable has to be handled without waiting for an event */
+  if ((condition & G_IO_OUT) && client->can_write && !client->pending) {
+    client->pending = TRUE;
+    g_queue_push_tail (&worker->pending, mhclient->handle.socket);
+    g_main_context_wakeup (worker->main_context);
+  }
+}
+#endif
+
 static void
 ensure_condition (GstMultiSocketSink * sink, GstSocketClient * client,
     GIOCondition condition)
 {
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiSocketSinkWorker *worker = NULL;
+
+  if (sink->workers)
+    worker = CLIENT_WORKER (sink, client);
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (worker && worker->epoll_fd >= 0) {
+    ensure_condition_epoll (sink, client, condition);
+    return;
+  }
+#endif
 
   if (client->condition == condition)
     return;
@@ -998,13 +1386,15 @@ ensure_condition (GstMultiSocketSink * sink, GstSocketClient * client,
     g_source_destroy (client->source);
     g_source_unref (client->source);
   }
-  if (condition && sink->main_context) {
+  if (condition && worker && worker->main_context) {
     client->source = g_socket_create_source (mhclient->handle.socket,
         condition, sink->cancellable);
+    /* the source is only dispatched from the service thread, which stops
+     * before the worker is freed */
     g_source_set_callback (client->source,
         (GSourceFunc) gst_multi_socket_sink_socket_condition,
-        gst_object_ref (sink), (GDestroyNotify) gst_object_unref);
-    g_source_attach (client->source, sink->main_context);
+        GST_MULTI_HANDLE_SINK_CLIENT_WORKER (mhsink, client), NULL);
+    g_source_attach (client->source, worker->main_context);
   } else {
     client->source = NULL;
     condition = 0;
@@ -1045,51 +1435,49 @@ gst_multi_socket_sink_stop_sending (GstMultiSocketSink * sink,
  * garbage list and removed.
  */
 static gboolean
-gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
-    GIOCondition condition, GstMultiSocketSink * sink)
+gst_multi_socket_sink_handle_client_condition (GstMultiSocketSink * sink,
+    GstMultiHandleSinkWorker * worker, GList * clink, GIOCondition condition)
 {
-  GList *clink;
   GstSocketClient *client;
   gboolean ret = TRUE;
   GstMultiHandleClient *mhclient;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
-
-  CLIENTS_LOCK (mhsink);
-  clink = g_hash_table_lookup (mhsink->handle_hash,
-      mhsinkclass->handle_hash_key (handle));
-  if (clink == NULL) {
-    ret = FALSE;
-    goto done;
-  }
 
   client = clink->data;
   mhclient = (GstMultiHandleClient *) client;
 
   if (mhclient->status != GST_CLIENT_STATUS_FLUSHING
       && mhclient->status != GST_CLIENT_STATUS_OK) {
-    gst_multi_handle_sink_remove_client_link (mhsink, clink);
+    gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clink);
     ret = FALSE;
     goto done;
   }
 
+#ifdef HAVE_MSG_ZEROCOPY
+  /* zerocopy completions are reported on the error queue */
+  if ((condition & G_IO_ERR) && (client->zerocopy
+          || !g_queue_is_empty (&client->zc_pending))) {
+    if (gst_multi_socket_sink_zerocopy_complete (sink, client))
+      condition &= ~G_IO_ERR;
+  }
+#endif
+
   if ((condition & G_IO_ERR)) {
     GST_WARNING_OBJECT (sink, "%s has error", mhclient->debug);
     mhclient->status = GST_CLIENT_STATUS_ERROR;
-    gst_multi_handle_sink_remove_client_link (mhsink, clink);
+    gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clink);
     ret = FALSE;
     goto done;
   } else if ((condition & G_IO_HUP)) {
     mhclient->status = GST_CLIENT_STATUS_CLOSED;
-    gst_multi_handle_sink_remove_client_link (mhsink, clink);
+    gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clink);
     ret = FALSE;
     goto done;
   }
   if ((condition & G_IO_IN) || (condition & G_IO_PRI)) {
     /* handle client read */
     if (!gst_multi_socket_sink_handle_client_read (sink, client)) {
-      gst_multi_handle_sink_remove_client_link (mhsink, clink);
+      gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clink);
       ret = FALSE;
       goto done;
     }
@@ -1097,42 +1485,190 @@ gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
   if ((condition & G_IO_OUT)) {
     /* handle client write */
     if (!gst_multi_socket_sink_handle_client_write (sink, client)) {
-      gst_multi_handle_sink_remove_client_link (mhsink, clink);
+      gst_multi_handle_sink_worker_remove_client_link (mhsink, worker, clink);
       ret = FALSE;
       goto done;
     }
   }
 
 done:
-  CLIENTS_UNLOCK (mhsink);
+  return ret;
+}
+
+static gboolean
+gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
+    GIOCondition condition, GstMultiHandleSinkWorker * worker)
+{
+  GList *clink;
+  gboolean ret = FALSE;
+  GstMultiHandleSink *mhsink = worker->sink;
+  GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+
+  WORKER_LOCK (mhsink, worker);
+  clink = g_hash_table_lookup (mhsink->handle_hash,
+      mhsinkclass->handle_hash_key (handle));
+  if (clink != NULL)
+    ret = gst_multi_socket_sink_handle_client_condition (sink, worker, clink,
+        condition);
+  WORKER_UNLOCK (mhsink, worker);
 
   return ret;
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+#define EPOLL_MAX_EVENTS 256
+
+typedef struct
+{
+  GSource source;
+  GstMultiHandleSinkWorker *worker;
+  gpointer tag;
+} GstMultiSocketSinkEpollSource;
+
+static GList *
+gst_multi_socket_sink_epoll_find (GstMultiSocketSink * sink, gpointer socket)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  GstMultiSinkHandle handle;
+
+  handle.socket = socket;
+
+  return g_hash_table_lookup (mhsink->handle_hash,
+      mhsinkclass->handle_hash_key (handle));
+}
+
+static void
+gst_multi_socket_sink_epoll_handle (GstMultiSocketSink * sink,
+    GstMultiHandleSinkWorker * worker, GList * clink, guint32 events)
+{
+  GstSocketClient *client = clink->data;
+  GIOCondition condition = 0;
+
+  if (events & EPOLLIN)
+    condition |= G_IO_IN;
+  if (events & EPOLLPRI)
+    condition |= G_IO_PRI;
+  if (events & EPOLLERR)
+    condition |= G_IO_ERR;
+  if (events & EPOLLHUP)
+    condition |= G_IO_HUP;
+  if (events & EPOLLOUT)
+    client->can_write = TRUE;
+  if (client->can_write && (client->condition & G_IO_OUT))
+    condition |= G_IO_OUT;
+
+  gst_multi_socket_sink_handle_client_condition (sink, worker, clink,
+      condition);
+}
+
+/* Only look at the clients that reported events since the last round and
+ * the writable clients that got new data in the meantime, the others don't
+ * need any attention. */
 static gboolean
-gst_multi_socket_sink_timeout (GstMultiSocketSink * sink)
+gst_multi_socket_sink_epoll_dispatch (GSource * source, GSourceFunc callback,
+    gpointer user_data)
+{
+  GstMultiSocketSinkEpollSource *esource =
+      (GstMultiSocketSinkEpollSource *) source;
+  GstMultiHandleSinkWorker *worker = esource->worker;
+  GstMultiHandleSink *mhsink = worker->sink;
+  GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
+  GstMultiSocketSinkWorker *sworker = &sink->workers[worker->index];
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  GList *clink;
+  gint i, n;
+
+  WORKER_LOCK (mhsink, worker);
+  do {
+    n = epoll_wait (sworker->epoll_fd, events, EPOLL_MAX_EVENTS, 0);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      GST_WARNING_OBJECT (sink, "epoll_wait failed: %s", g_strerror (errno));
+      break;
+    }
+    GST_LOG_OBJECT (sink, "%d clients with events", n);
+
+    for (i = 0; i < n; i++) {
+      clink = gst_multi_socket_sink_epoll_find (sink, events[i].data.ptr);
+      if (clink == NULL)
+        continue;
+
+      gst_multi_socket_sink_epoll_handle (sink, worker, clink,
+          events[i].events);
+    }
+  } while (n == EPOLL_MAX_EVENTS);
+
+  while (!g_queue_is_empty (&sworker->pending)) {
+    clink = gst_multi_socket_sink_epoll_find (sink,
+        g_queue_pop_head (&sworker->pending));
+    if (clink == NULL)
+      continue;
+
+    ((GstSocketClient *) clink->data)->pending = FALSE;
+    gst_multi_socket_sink_epoll_handle (sink, worker, clink, 0);
+  }
+  WORKER_UNLOCK (mhsink, worker);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+gst_multi_socket_sink_epoll_prepare (GSource * source, gint * timeout)
+{
+  GstMultiSocketSinkEpollSource *esource =
+      (GstMultiSocketSinkEpollSource *) source;
+  GstMultiHandleSinkWorker *worker = esource->worker;
+  GstMultiHandleSink *mhsink = worker->sink;
+  GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
+  gboolean ret;
+
+  *timeout = -1;
+
+  WORKER_LOCK (mhsink, worker);
+  ret = !g_queue_is_empty (&sink->workers[worker->index].pending);
+  WORKER_UNLOCK (mhsink, worker);
+
+  return ret;
+}
+
+static gboolean
+gst_multi_socket_sink_epoll_check (GSource * source)
+{
+  GstMultiSocketSinkEpollSource *esource =
+      (GstMultiSocketSinkEpollSource *) source;
+  gint timeout;
+
+  if (g_source_query_unix_fd (source, esource->tag) & G_IO_IN)
+    return TRUE;
+
+  return gst_multi_socket_sink_epoll_prepare (source, &timeout);
+}
+
+static GSourceFuncs gst_multi_socket_sink_epoll_funcs = {
+  gst_multi_socket_sink_epoll_prepare,
+  gst_multi_socket_sink_epoll_check,
+  gst_multi_socket_sink_epoll_dispatch,
+  NULL
+};
+#endif
+
+static gboolean
+gst_multi_socket_sink_timeout (GstMultiHandleSinkWorker * worker)
 {
   GstClockTime now;
   GTimeVal nowtv;
-  GList *clients;
-  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSink *mhsink = worker->sink;
 
   g_get_current_time (&nowtv);
   now = GST_TIMEVAL_TO_TIME (nowtv);
 
   CLIENTS_LOCK (mhsink);
-  for (clients = mhsink->clients; clients; clients = clients->next) {
-    GstSocketClient *client;
-    GstMultiHandleClient *mhclient;
-
-    client = clients->data;
-    mhclient = (GstMultiHandleClient *) client;
-    if (mhsink->timeout > 0
-        && now - mhclient->last_activity_time > mhsink->timeout) {
-      mhclient->status = GST_CLIENT_STATUS_SLOW;
-      gst_multi_handle_sink_remove_client_link (mhsink, clients);
-    }
-  }
+  gst_multi_handle_sink_worker_remove_timed_out (mhsink, worker, now);
   CLIENTS_UNLOCK (mhsink);
 
   return FALSE;
@@ -1141,30 +1677,48 @@ gst_multi_socket_sink_timeout (GstMultiSocketSink * sink)
 /* we handle the client communication in another thread so that we do not block
  * the gstreamer thread while we select() on the client fds */
 static gpointer
-gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
+gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink,
+    GstMultiHandleSinkWorker * worker)
 {
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
+  GMainContext *context = sink->workers[worker->index].main_context;
   GSource *timeout = NULL;
 
   while (mhsink->running) {
-    if (mhsink->timeout > 0) {
-      timeout = g_timeout_source_new (mhsink->timeout / GST_MSECOND);
+    GstClockTime deadline;
+
+    /* wake up when the least recently active client times out */
+    WORKER_LOCK (mhsink, worker);
+    deadline = gst_multi_handle_sink_worker_next_timeout (mhsink, worker);
+    WORKER_UNLOCK (mhsink, worker);
+
+    if (GST_CLOCK_TIME_IS_VALID (deadline)) {
+      GstClockTime now;
+      GTimeVal nowtv;
+      guint interval = 0;
+
+      g_get_current_time (&nowtv);
+      now = GST_TIMEVAL_TO_TIME (nowtv);
+      if (deadline > now)
+        interval = (deadline - now + GST_MSECOND - 1) / GST_MSECOND;
+
+      timeout = g_timeout_source_new (interval);
 
       g_source_set_callback (timeout,
-          (GSourceFunc) gst_multi_socket_sink_timeout, gst_object_ref (sink),
-          (GDestroyNotify) gst_object_unref);
-      g_source_attach (timeout, sink->main_context);
+          (GSourceFunc) gst_multi_socket_sink_timeout, worker, NULL);
+      g_source_attach (timeout, context);
     }
 
     /* Returns after handling all pending events or when
      * _wakeup() was called. In any case we have to add
      * a new timeout because something happened.
      */
-    g_main_context_iteration (sink->main_context, TRUE);
+    g_main_context_iteration (context, TRUE);
 
     if (timeout) {
       g_source_destroy (timeout);
       g_source_unref (timeout);
+      timeout = NULL;
     }
   }
 
@@ -1184,6 +1738,9 @@ gst_multi_socket_sink_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       sink->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_ZERO_COPY:
+      sink->zero_copy = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1203,12 +1760,72 @@ gst_multi_socket_sink_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, sink->send_messages);
       break;
+    case PROP_ZERO_COPY:
+      g_value_set_boolean (value, sink->zero_copy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+static void
+gst_multi_socket_sink_worker_start (GstMultiSocketSink * mssink,
+    GstMultiHandleSinkWorker * worker)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (mssink);
+  GstMultiSocketSinkWorker *sworker = &mssink->workers[worker->index];
+
+  sworker->main_context = g_main_context_new ();
+  sworker->epoll_fd = -1;
+  g_queue_init (&sworker->pending);
+
+  if (mhsink->backend == GST_MULTI_HANDLE_SINK_BACKEND_EPOLL) {
+#ifdef HAVE_SYS_EPOLL_H
+    sworker->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (sworker->epoll_fd >= 0) {
+      GstMultiSocketSinkEpollSource *esource;
+
+      sworker->epoll_source = g_source_new (&gst_multi_socket_sink_epoll_funcs,
+          sizeof (GstMultiSocketSinkEpollSource));
+      esource = (GstMultiSocketSinkEpollSource *) sworker->epoll_source;
+      esource->worker = worker;
+      esource->tag = g_source_add_unix_fd (sworker->epoll_source,
+          sworker->epoll_fd, G_IO_IN);
+      g_source_attach (sworker->epoll_source, sworker->main_context);
+    } else {
+      GST_WARNING_OBJECT (mssink, "could not create epoll fd, using poll: %s",
+          g_strerror (errno));
+    }
+#else
+    GST_WARNING_OBJECT (mssink, "epoll backend not available, using poll");
+#endif
+  }
+}
+
+static void
+gst_multi_socket_sink_worker_stop (GstMultiSocketSink * mssink,
+    GstMultiSocketSinkWorker * sworker)
+{
+  if (sworker->epoll_source) {
+    g_source_destroy (sworker->epoll_source);
+    g_source_unref (sworker->epoll_source);
+    sworker->epoll_source = NULL;
+  }
+#ifdef HAVE_SYS_EPOLL_H
+  if (sworker->epoll_fd >= 0) {
+    close (sworker->epoll_fd);
+    sworker->epoll_fd = -1;
+  }
+#endif
+  g_queue_clear (&sworker->pending);
+
+  if (sworker->main_context) {
+    g_main_context_unref (sworker->main_context);
+    sworker->main_context = NULL;
+  }
+}
+
 static gboolean
 gst_multi_socket_sink_start_pre (GstMultiHandleSink * mhsink)
 {
@@ -1216,10 +1833,14 @@ gst_multi_socket_sink_start_pre (GstMultiHandleSink * mhsink)
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
   GList *clients;
+  guint i;
 
   GST_INFO_OBJECT (mssink, "starting");
 
-  mssink->main_context = g_main_context_new ();
+  mssink->workers = g_new0 (GstMultiSocketSinkWorker, mhsink->n_workers);
+  for (i = 0; i < mhsink->n_workers; i++)
+    gst_multi_socket_sink_worker_start (mssink, &mhsink->workers[i]);
+  mssink->main_context = mssink->workers[0].main_context;
 
   CLIENTS_LOCK (mhsink);
   for (clients = mhsink->clients; clients; clients = clients->next) {
@@ -1241,24 +1862,40 @@ multisocketsink_hash_remove (gpointer key, gpointer value, gpointer data)
   return TRUE;
 }
 
+static void
+gst_multi_socket_sink_wakeup (GstMultiSocketSink * mssink)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (mssink);
+  guint i;
+
+  if (mssink->workers == NULL)
+    return;
+
+  for (i = 0; i < mhsink->n_workers; i++)
+    g_main_context_wakeup (mssink->workers[i].main_context);
+}
+
 static void
 gst_multi_socket_sink_stop_pre (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
 
-  if (mssink->main_context)
-    g_main_context_wakeup (mssink->main_context);
+  gst_multi_socket_sink_wakeup (mssink);
 }
 
 static void
 gst_multi_socket_sink_stop_post (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
+  guint i;
 
-  if (mssink->main_context) {
-    g_main_context_unref (mssink->main_context);
-    mssink->main_context = NULL;
+  if (mssink->workers) {
+    for (i = 0; i < mhsink->n_workers; i++)
+      gst_multi_socket_sink_worker_stop (mssink, &mssink->workers[i]);
+    g_free (mssink->workers);
+    mssink->workers = NULL;
   }
+  mssink->main_context = NULL;
 
   g_hash_table_foreach_remove (mhsink->handle_hash, multisocketsink_hash_remove,
       mssink);
@@ -1273,8 +1910,7 @@ gst_multi_socket_sink_unlock (GstBaseSink * bsink)
 
   GST_DEBUG_OBJECT (sink, "set to flushing");
   g_cancellable_cancel (sink->cancellable);
-  if (sink->main_context)
-    g_main_context_wakeup (sink->main_context);
+  gst_multi_socket_sink_wakeup (sink);
 
   return TRUE;
 }
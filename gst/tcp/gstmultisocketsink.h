@@ -55,8 +55,32 @@ typedef struct {
 
   GSource *source;
   GIOCondition condition;
+
+  /* epoll backend, writability is edge-triggered */
+  gboolean registered;  /* socket is in the epoll set */
+  gboolean can_write;   /* socket reported writable, until a write blocks */
+  gboolean pending;     /* in the pending queue of the sink */
+
+  gboolean ktls;        /* the kernel encrypts the data with TLS */
+
+  /* zero-copy send mode */
+  gboolean zerocopy;    /* SO_ZEROCOPY is enabled on the socket */
+  guint32 zc_next;      /* id of the next MSG_ZEROCOPY send */
+  GQueue zc_pending;    /* buffers waiting for a zerocopy completion */
+  GQueue sf_pending;    /* buffers sent with sendfile, waiting for the ack */
 } GstSocketClient;
 
+/* state of a service thread */
+typedef struct {
+  GMainContext *main_context;
+
+  /* epoll backend, -1 when not used */
+  gint epoll_fd;
+  GSource *epoll_source;
+  /* sockets of writable clients that got new data */
+  GQueue pending;
+} GstMultiSocketSinkWorker;
+
 /**
  * GstMultiSocketSink:
  *
@@ -66,10 +90,12 @@ struct _GstMultiSocketSink {
   GstMultiHandleSink element;
 
   /*< private >*/
-  GMainContext *main_context;
+  GMainContext *main_context;  /* context of the first service thread */
   GCancellable *cancellable;
+  GstMultiSocketSinkWorker *workers;
   gboolean send_messages;
   gboolean send_dispatched;
+  gboolean zero_copy;
 };
 
 struct _GstMultiSocketSinkClass {
@@ -95,6 +95,8 @@ static GstFlowReturn gst_socket_src_fill (GstPushSrc * psrc,
     GstBuffer * outbuf);
 static gboolean gst_socket_src_unlock (GstBaseSrc * bsrc);
 static gboolean gst_socket_src_unlock_stop (GstBaseSrc * bsrc);
+static gboolean gst_socket_src_decide_allocation (GstBaseSrc * bsrc,
+    GstQuery * query);
 
 static void gst_socket_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -165,6 +167,7 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
   gstbasesrc_class->get_caps = gst_socketsrc_getcaps;
   gstbasesrc_class->unlock = gst_socket_src_unlock;
   gstbasesrc_class->unlock_stop = gst_socket_src_unlock_stop;
+  gstbasesrc_class->decide_allocation = gst_socket_src_decide_allocation;
 
   gstpush_src_class->fill = gst_socket_src_fill;
 
@@ -271,6 +274,14 @@ gst_socketsrc_getcaps (GstBaseSrc * src, GstCaps * filter)
   return result;
 }
 
+static gboolean
+gst_socket_src_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
+{
+  gst_tcp_src_ensure_allocation_pool (bsrc, query);
+
+  return GST_BASE_SRC_CLASS (parent_class)->decide_allocation (bsrc, query);
+}
+
 static GstFlowReturn
 gst_socket_src_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
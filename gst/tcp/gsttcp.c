@@ -0,0 +1,80 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * gsttcp.c: helper functions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gio/gnetworking.h>
+
+#include "gsttcp.h"
+
+/* Apply the receive options of the TCP sources to @socket, 0 keeps the
+ * system default. This is done before connecting or listening so that the
+ * buffer size is used for the window scaling, accepted sockets inherit the
+ * options of the listening socket. Failures only give a warning. */
+void
+gst_tcp_set_receive_options (GstObject * element, GSocket * socket,
+    gint buffer_size, gint busy_poll)
+{
+  GError *err = NULL;
+
+  if (buffer_size > 0) {
+    GST_DEBUG_OBJECT (element, "setting receive buffer size to %d",
+        buffer_size);
+    if (!g_socket_set_option (socket, SOL_SOCKET, SO_RCVBUF, buffer_size,
+            &err)) {
+      GST_WARNING_OBJECT (element, "could not set receive buffer size: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+  }
+
+  if (busy_poll > 0) {
+#ifdef SO_BUSY_POLL
+    GST_DEBUG_OBJECT (element, "busy polling for %d microseconds", busy_poll);
+    if (!g_socket_set_option (socket, SOL_SOCKET, SO_BUSY_POLL, busy_poll,
+            &err)) {
+      GST_WARNING_OBJECT (element, "could not enable busy polling: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+#else
+    GST_WARNING_OBJECT (element, "busy polling is not supported");
+#endif
+  }
+}
+
+/* Receive into the buffers of a pool, also when downstream has none. Called
+ * from the decide_allocation of the TCP sources before chaining up, which
+ * then configures the pool. */
+void
+gst_tcp_src_ensure_allocation_pool (GstBaseSrc * src, GstQuery * query)
+{
+  if (gst_query_get_n_allocation_pools (query) == 0) {
+    GstBufferPool *pool = gst_buffer_pool_new ();
+
+    GST_DEBUG_OBJECT (src, "no pool from downstream, making our own");
+    gst_query_add_allocation_pool (query, pool,
+        gst_base_src_get_blocksize (src), 0, 0);
+    gst_object_unref (pool);
+  }
+}
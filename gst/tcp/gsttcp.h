@@ -24,9 +24,19 @@
 #define __GST_TCP_HELP_H__
 
 #include <gst/gst.h>
+#include <gst/base/gstbasesrc.h>
+#include <gio/gio.h>
 
 #define TCP_HIGHEST_PORT        65535
 #define TCP_DEFAULT_HOST        "localhost"
 #define TCP_DEFAULT_PORT        4953
 
+#define TCP_DEFAULT_RECEIVE_BUFFER_SIZE 0
+#define TCP_DEFAULT_BUSY_POLL   0
+
+void gst_tcp_set_receive_options (GstObject * element, GSocket * socket,
+    gint buffer_size, gint busy_poll);
+
+void gst_tcp_src_ensure_allocation_pool (GstBaseSrc * src, GstQuery * query);
+
 #endif /* __GST_TCP_HELP_H__ */
@@ -46,8 +46,6 @@
 GST_DEBUG_CATEGORY_STATIC (tcpclientsrc_debug);
 #define GST_CAT_DEFAULT tcpclientsrc_debug
 
-#define MAX_READ_SIZE                   4 * 1024
-
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -59,7 +57,9 @@ enum
 {
   PROP_0,
   PROP_HOST,
-  PROP_PORT
+  PROP_PORT,
+  PROP_RECEIVE_BUFFER_SIZE,
+  PROP_BUSY_POLL
 };
 
 #define gst_tcp_client_src_parent_class parent_class
@@ -77,6 +77,8 @@ static gboolean gst_tcp_client_src_stop (GstBaseSrc * bsrc);
 static gboolean gst_tcp_client_src_start (GstBaseSrc * bsrc);
 static gboolean gst_tcp_client_src_unlock (GstBaseSrc * bsrc);
 static gboolean gst_tcp_client_src_unlock_stop (GstBaseSrc * bsrc);
+static gboolean gst_tcp_client_src_decide_allocation (GstBaseSrc * bsrc,
+    GstQuery * query);
 
 static void gst_tcp_client_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -109,6 +111,36 @@ gst_tcp_client_src_class_init (GstTCPClientSrcClass * klass)
           TCP_HIGHEST_PORT, TCP_DEFAULT_PORT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTCPClientSrc:receive-buffer-size:
+   *
+   * Size of the kernel receive buffer of the socket. Bigger buffers allow
+   * bigger TCP windows on links with a high round trip time. 0 uses the
+   * system default.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_RECEIVE_BUFFER_SIZE,
+      g_param_spec_int ("receive-buffer-size", "Receive buffer size",
+          "Size of the kernel receive buffer in bytes (0 = default)", 0,
+          G_MAXINT, TCP_DEFAULT_RECEIVE_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTCPClientSrc:busy-poll:
+   *
+   * Time in microseconds to busy poll the device queue for new data when
+   * the socket is empty, this reduces the receive latency at the cost of
+   * CPU. Only supported on Linux. 0 disables busy polling.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_BUSY_POLL,
+      g_param_spec_int ("busy-poll", "Busy poll",
+          "Time in microseconds to busy poll for new data (0 = disabled)", 0,
+          G_MAXINT, TCP_DEFAULT_BUSY_POLL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -121,6 +153,7 @@ gst_tcp_client_src_class_init (GstTCPClientSrcClass * klass)
   gstbasesrc_class->stop = gst_tcp_client_src_stop;
   gstbasesrc_class->unlock = gst_tcp_client_src_unlock;
   gstbasesrc_class->unlock_stop = gst_tcp_client_src_unlock_stop;
+  gstbasesrc_class->decide_allocation = gst_tcp_client_src_decide_allocation;
 
   gstpush_src_class->create = gst_tcp_client_src_create;
 
@@ -133,6 +166,8 @@ gst_tcp_client_src_init (GstTCPClientSrc * this)
 {
   this->port = TCP_DEFAULT_PORT;
   this->host = g_strdup (TCP_DEFAULT_HOST);
+  this->receive_buffer_size = TCP_DEFAULT_RECEIVE_BUFFER_SIZE;
+  this->busy_poll = TCP_DEFAULT_BUSY_POLL;
   this->socket = NULL;
   this->cancellable = g_cancellable_new ();
 
@@ -171,6 +206,14 @@ gst_tcp_client_src_getcaps (GstBaseSrc * bsrc, GstCaps * filter)
   return caps;
 }
 
+static gboolean
+gst_tcp_client_src_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
+{
+  gst_tcp_src_ensure_allocation_pool (bsrc, query);
+
+  return GST_BASE_SRC_CLASS (parent_class)->decide_allocation (bsrc, query);
+}
+
 static GstFlowReturn
 gst_tcp_client_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 {
@@ -221,9 +264,14 @@ gst_tcp_client_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   }
 
   if (avail > 0) {
-    read = MIN (avail, MAX_READ_SIZE);
-    *outbuf = gst_buffer_new_and_alloc (read);
+    ret = GST_BASE_SRC_GET_CLASS (src)->alloc (GST_BASE_SRC_CAST (src), -1,
+        gst_base_src_get_blocksize (GST_BASE_SRC_CAST (src)), outbuf);
+    if (ret != GST_FLOW_OK) {
+      *outbuf = NULL;
+      goto done;
+    }
     gst_buffer_map (*outbuf, &map, GST_MAP_READWRITE);
+    read = MIN ((gsize) avail, map.size);
     rret =
         g_socket_receive (src->socket, (gchar *) map.data, read,
         src->cancellable, &err);
@@ -317,6 +365,12 @@ gst_tcp_client_src_set_property (GObject * object, guint prop_id,
     case PROP_PORT:
       tcpclientsrc->port = g_value_get_int (value);
       break;
+    case PROP_RECEIVE_BUFFER_SIZE:
+      tcpclientsrc->receive_buffer_size = g_value_get_int (value);
+      break;
+    case PROP_BUSY_POLL:
+      tcpclientsrc->busy_poll = g_value_get_int (value);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -337,6 +391,12 @@ gst_tcp_client_src_get_property (GObject * object, guint prop_id,
     case PROP_PORT:
       g_value_set_int (value, tcpclientsrc->port);
       break;
+    case PROP_RECEIVE_BUFFER_SIZE:
+      g_value_set_int (value, tcpclientsrc->receive_buffer_size);
+      break;
+    case PROP_BUSY_POLL:
+      g_value_set_int (value, tcpclientsrc->busy_poll);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -392,6 +452,8 @@ gst_tcp_client_src_start (GstBaseSrc * bsrc)
     goto no_socket;
 
   GST_DEBUG_OBJECT (src, "opened receiving client socket");
+  gst_tcp_set_receive_options (GST_OBJECT_CAST (src), src->socket,
+      src->receive_buffer_size, src->busy_poll);
   GST_OBJECT_FLAG_SET (src, GST_TCP_CLIENT_SRC_OPEN);
 
   /* connect to server */
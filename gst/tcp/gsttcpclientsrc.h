@@ -55,6 +55,8 @@ struct _GstTCPClientSrc {
   /* server information */
   int port;
   gchar *host;
+  gint receive_buffer_size;
+  gint busy_poll;
 
   /* socket */
   GSocket *socket;
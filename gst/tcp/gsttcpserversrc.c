@@ -49,8 +49,6 @@ GST_DEBUG_CATEGORY_STATIC (tcpserversrc_debug);
 #define TCP_DEFAULT_LISTEN_HOST         NULL    /* listen on all interfaces */
 #define TCP_BACKLOG                     1       /* client connection queue */
 
-#define MAX_READ_SIZE                   4 * 1024
-
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -61,7 +59,9 @@ enum
   PROP_0,
   PROP_HOST,
   PROP_PORT,
-  PROP_CURRENT_PORT
+  PROP_CURRENT_PORT,
+  PROP_RECEIVE_BUFFER_SIZE,
+  PROP_BUSY_POLL
 };
 
 #define gst_tcp_server_src_parent_class parent_class
@@ -73,6 +73,8 @@ static gboolean gst_tcp_server_src_start (GstBaseSrc * bsrc);
 static gboolean gst_tcp_server_src_stop (GstBaseSrc * bsrc);
 static gboolean gst_tcp_server_src_unlock (GstBaseSrc * bsrc);
 static gboolean gst_tcp_server_src_unlock_stop (GstBaseSrc * bsrc);
+static gboolean gst_tcp_server_src_decide_allocation (GstBaseSrc * bsrc,
+    GstQuery * query);
 static GstFlowReturn gst_tcp_server_src_create (GstPushSrc * psrc,
     GstBuffer ** buf);
 
@@ -122,6 +124,36 @@ gst_tcp_server_src_class_init (GstTCPServerSrcClass * klass)
           "The port number the socket is currently bound to", 0,
           TCP_HIGHEST_PORT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTCPServerSrc:receive-buffer-size:
+   *
+   * Size of the kernel receive buffer of the socket. Bigger buffers allow
+   * bigger TCP windows on links with a high round trip time. 0 uses the
+   * system default.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_RECEIVE_BUFFER_SIZE,
+      g_param_spec_int ("receive-buffer-size", "Receive buffer size",
+          "Size of the kernel receive buffer in bytes (0 = default)", 0,
+          G_MAXINT, TCP_DEFAULT_RECEIVE_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTCPServerSrc:busy-poll:
+   *
+   * Time in microseconds to busy poll the device queue for new data when
+   * the socket is empty, this reduces the receive latency at the cost of
+   * CPU. Only supported on Linux. 0 disables busy polling.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_BUSY_POLL,
+      g_param_spec_int ("busy-poll", "Busy poll",
+          "Time in microseconds to busy poll for new data (0 = disabled)", 0,
+          G_MAXINT, TCP_DEFAULT_BUSY_POLL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -133,6 +165,7 @@ gst_tcp_server_src_class_init (GstTCPServerSrcClass * klass)
   gstbasesrc_class->stop = gst_tcp_server_src_stop;
   gstbasesrc_class->unlock = gst_tcp_server_src_unlock;
   gstbasesrc_class->unlock_stop = gst_tcp_server_src_unlock_stop;
+  gstbasesrc_class->decide_allocation = gst_tcp_server_src_decide_allocation;
 
   gstpush_src_class->create = gst_tcp_server_src_create;
 
@@ -145,6 +178,8 @@ gst_tcp_server_src_init (GstTCPServerSrc * src)
 {
   src->server_port = TCP_DEFAULT_PORT;
   src->host = g_strdup (TCP_DEFAULT_HOST);
+  src->receive_buffer_size = TCP_DEFAULT_RECEIVE_BUFFER_SIZE;
+  src->busy_poll = TCP_DEFAULT_BUSY_POLL;
   src->server_socket = NULL;
   src->client_socket = NULL;
   src->cancellable = g_cancellable_new ();
@@ -173,6 +208,14 @@ gst_tcp_server_src_finalize (GObject * gobject)
   G_OBJECT_CLASS (parent_class)->finalize (gobject);
 }
 
+static gboolean
+gst_tcp_server_src_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
+{
+  gst_tcp_src_ensure_allocation_pool (bsrc, query);
+
+  return GST_BASE_SRC_CLASS (parent_class)->decide_allocation (bsrc, query);
+}
+
 static GstFlowReturn
 gst_tcp_server_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 {
@@ -239,9 +282,14 @@ gst_tcp_server_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   }
 
   if (avail > 0) {
-    read = MIN (avail, MAX_READ_SIZE);
-    *outbuf = gst_buffer_new_and_alloc (read);
+    ret = GST_BASE_SRC_GET_CLASS (src)->alloc (GST_BASE_SRC_CAST (src), -1,
+        gst_base_src_get_blocksize (GST_BASE_SRC_CAST (src)), outbuf);
+    if (ret != GST_FLOW_OK) {
+      *outbuf = NULL;
+      goto done;
+    }
     gst_buffer_map (*outbuf, &map, GST_MAP_READWRITE);
+    read = MIN ((gsize) avail, map.size);
     rret =
         g_socket_receive (src->client_socket, (gchar *) map.data, read,
         src->cancellable, &err);
@@ -348,6 +396,12 @@ gst_tcp_server_src_set_property (GObject * object, guint prop_id,
     case PROP_PORT:
       tcpserversrc->server_port = g_value_get_int (value);
       break;
+    case PROP_RECEIVE_BUFFER_SIZE:
+      tcpserversrc->receive_buffer_size = g_value_get_int (value);
+      break;
+    case PROP_BUSY_POLL:
+      tcpserversrc->busy_poll = g_value_get_int (value);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -371,6 +425,12 @@ gst_tcp_server_src_get_property (GObject * object, guint prop_id,
     case PROP_CURRENT_PORT:
       g_value_set_int (value, g_atomic_int_get (&tcpserversrc->current_port));
       break;
+    case PROP_RECEIVE_BUFFER_SIZE:
+      g_value_set_int (value, tcpserversrc->receive_buffer_size);
+      break;
+    case PROP_BUSY_POLL:
+      g_value_set_int (value, tcpserversrc->busy_poll);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -424,6 +484,8 @@ gst_tcp_server_src_start (GstBaseSrc * bsrc)
     goto no_socket;
 
   GST_DEBUG_OBJECT (src, "opened receiving server socket");
+  gst_tcp_set_receive_options (GST_OBJECT_CAST (src), src->server_socket,
+      src->receive_buffer_size, src->busy_poll);
 
   /* bind it */
   GST_DEBUG_OBJECT (src, "binding server socket to address");
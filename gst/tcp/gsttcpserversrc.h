@@ -57,6 +57,8 @@ struct _GstTCPServerSrc {
   int current_port;        /* currently bound-to port, or 0 */ /* ATOMIC */
   int server_port;         /* port property */
   gchar *host;             /* host property */
+  gint receive_buffer_size;
+  gint busy_poll;
 
   GCancellable *cancellable;
   GSocket *server_socket;
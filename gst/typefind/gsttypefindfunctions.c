@@ -43,6 +43,10 @@
 #include <gst/pbutils/pbutils.h>
 #include <gst/base/gstbytereader.h>
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (type_find_debug);
 #define GST_CAT_DEFAULT type_find_debug
 
@@ -108,6 +112,76 @@ data_scan_ctx_ensure_data (GstTypeFind * tf, DataScanCtx * c, gint min_len)
   return FALSE;
 }
 
+/* Returns the offset of the first byte in @data that is one of @sync_bytes,
+ * or @size. A single sync byte goes through memchr(), which the C library
+ * implements with vector instructions where available. With SSE2, up to 4
+ * sync bytes are compared against 16 bytes at once and the matches ORed
+ * together, the C loop does the rest. */
+static inline guint
+scan_for_sync_byte (const guint8 * data, guint size, const guint8 * sync_bytes,
+    guint n_sync_bytes)
+{
+  const guint8 *p = data;
+  guint i;
+
+  if (n_sync_bytes == 1) {
+    p = memchr (data, sync_bytes[0], size);
+    return p ? p - data : size;
+  }
+#if defined (__SSE2__)
+  if (n_sync_bytes <= 4) {
+    __m128i sync[4];
+
+    for (i = 0; i < n_sync_bytes; i++)
+      sync[i] = _mm_set1_epi8 (sync_bytes[i]);
+
+    for (; p + 16 <= data + size; p += 16) {
+      __m128i v = _mm_loadu_si128 ((const __m128i *) p);
+      __m128i match = _mm_cmpeq_epi8 (v, sync[0]);
+      gint mask;
+
+      for (i = 1; i < n_sync_bytes; i++)
+        match = _mm_or_si128 (match, _mm_cmpeq_epi8 (v, sync[i]));
+
+      mask = _mm_movemask_epi8 (match);
+      if (mask != 0)
+        return p - data + g_bit_nth_lsf (mask, -1);
+    }
+  }
+#endif
+
+  for (; p < data + size; p++) {
+    for (i = 0; i < n_sync_bytes; i++) {
+      if (*p == sync_bytes[i])
+        return p - data;
+    }
+  }
+  return size;
+}
+
+/* Skips ahead to the next offset that starts with one of @sync_bytes and
+ * still has @min_len bytes of the current chunk after it, so scanning
+ * typefinders don't have to check every offset for a sync word. Returns
+ * FALSE if the current offset is such a candidate already, in which case
+ * nothing is skipped. */
+static inline gboolean
+data_scan_ctx_skip_to_sync (GstTypeFind * tf, DataScanCtx * c,
+    const guint8 * sync_bytes, guint n_sync_bytes, gint min_len)
+{
+  guint skip;
+
+  if (c->size < min_len)
+    return FALSE;
+
+  skip = scan_for_sync_byte (c->data, c->size - min_len + 1, sync_bytes,
+      n_sync_bytes);
+  if (skip == 0)
+    return FALSE;
+
+  data_scan_ctx_advance (tf, c, skip);
+  return TRUE;
+}
+
 static inline gboolean
 data_scan_ctx_memcmp (GstTypeFind * tf, DataScanCtx * c, guint offset,
     const gchar * data, guint len)
@@ -1022,6 +1096,8 @@ static GstStaticCaps aac_caps = GST_STATIC_CAPS ("audio/mpeg, "
 static void
 aac_type_find (GstTypeFind * tf, gpointer unused)
 {
+  /* first bytes of the ADTS, LOAS and ADIF sync words */
+  static const guint8 sync_bytes[] = { 0xff, 0x56, 0x4d, 'A' };
   DataScanCtx c = { 0, NULL, 0 };
   GstTypeFindProbability best_probability = GST_TYPE_FIND_NONE;
   GstCaps *best_caps = NULL;
@@ -1042,6 +1118,10 @@ aac_type_find (GstTypeFind * tf, gpointer unused)
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 6)))
       break;
 
+    if (data_scan_ctx_skip_to_sync (tf, &c, sync_bytes,
+            G_N_ELEMENTS (sync_bytes), 6))
+      continue;
+
     snc = GST_READ_UINT16_BE (c.data);
     if (G_UNLIKELY ((snc & 0xfff6) == 0xfff0)) {
       /* ADTS header - find frame length */
@@ -1349,6 +1429,8 @@ mp3_type_find_at_offset (GstTypeFind * tf, guint64 start_off,
   gint last_free_offset = -1;
   gint last_free_framelen = -1;
   gboolean headerstart = TRUE;
+  static const guint8 sync_byte = 0xFF;
+  guint skip;
 
   *found_layer = 0;
   *found_prob = 0;
@@ -1475,9 +1557,11 @@ mp3_type_find_at_offset (GstTypeFind * tf, guint64 start_off,
         return;
       }
     }
-    data++;
-    skipped++;
-    size--;
+    /* jump to the next possible frame sync */
+    skip = 1 + scan_for_sync_byte (data + 1, size - 1, &sync_byte, 1);
+    data += skip;
+    skipped += skip;
+    size -= skip;
   }
 }
 
@@ -1645,9 +1729,14 @@ ac3_type_find (GstTypeFind * tf, gpointer unused)
    * frame is followed by a second frame at the expected offset.
    * We could also check the two ac3 CRCs, but we don't do that right now */
   while (c.offset < 1024) {
+    static const guint8 sync_byte = 0x0b;
+
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 5)))
       break;
 
+    if (data_scan_ctx_skip_to_sync (tf, &c, &sync_byte, 1, 5))
+      continue;
+
     if (c.data[0] == 0x0b && c.data[1] == 0x77) {
       guint bsid = c.data[5] >> 3;
 
@@ -1805,6 +1894,8 @@ dts_parse_frame_header (DataScanCtx * c, guint * frame_size,
 static void
 dts_type_find (GstTypeFind * tf, gpointer unused)
 {
+  /* first bytes of the big/little endian 16 and 14 bit sync markers */
+  static const guint8 sync_bytes[] = { 0x7f, 0x1f, 0xfe, 0xff };
   DataScanCtx c = { 0, NULL, 0 };
 
   /* Search for an dts frame; not necessarily right at the start, but give it
@@ -1816,6 +1907,10 @@ dts_type_find (GstTypeFind * tf, gpointer unused)
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, DTS_MIN_FRAMESIZE)))
       return;
 
+    if (data_scan_ctx_skip_to_sync (tf, &c, sync_bytes,
+            G_N_ELEMENTS (sync_bytes), DTS_MIN_FRAMESIZE))
+      continue;
+
     if (G_UNLIKELY (dts_parse_frame_header (&c, &frame_size, &rate, &chans,
                 &depth, &endianness))) {
       GstTypeFindProbability prob;
@@ -5504,28 +5599,6 @@ start_with_type_find (GstTypeFind * tf, gpointer private)
   }
 }
 
-static void
-sw_data_destroy (GstTypeFindData * sw_data)
-{
-  if (G_LIKELY (sw_data->caps != NULL))
-    gst_caps_unref (sw_data->caps);
-  g_slice_free (GstTypeFindData, sw_data);
-}
-
-#define TYPE_FIND_REGISTER_START_WITH(plugin,name,rank,ext,_data,_size,_probability)\
-G_BEGIN_DECLS{                                                          \
-  GstTypeFindData *sw_data = g_slice_new (GstTypeFindData);             \
-  sw_data->data = (const guint8 *)_data;                                \
-  sw_data->size = _size;                                                \
-  sw_data->probability = _probability;                                  \
-  sw_data->caps = gst_caps_new_empty_simple (name);                     \
-  if (!gst_type_find_register (plugin, name, rank, start_with_type_find,\
-                     ext, sw_data->caps, sw_data,                       \
-                     (GDestroyNotify) (sw_data_destroy))) {             \
-    sw_data_destroy (sw_data);                                          \
-  }                                                                     \
-}G_END_DECLS
-
 /*** same for riff types ***/
 
 static void
@@ -5541,19 +5614,299 @@ riff_type_find (GstTypeFind * tf, gpointer private)
   }
 }
 
-#define TYPE_FIND_REGISTER_RIFF(plugin,name,rank,ext,_data)             \
-G_BEGIN_DECLS{                                                          \
-  GstTypeFindData *sw_data = g_slice_new (GstTypeFindData);             \
-  sw_data->data = (gpointer)_data;                                      \
-  sw_data->size = 4;                                                    \
-  sw_data->probability = GST_TYPE_FIND_MAXIMUM;                         \
-  sw_data->caps = gst_caps_new_empty_simple (name);                     \
-  if (!gst_type_find_register (plugin, name, rank, riff_type_find,      \
-                      ext, sw_data->caps, sw_data,                      \
-                      (GDestroyNotify) (sw_data_destroy))) {            \
-    sw_data_destroy (sw_data);                                          \
-  }                                                                     \
-}G_END_DECLS
+/* The typefinders above only differ in their data, so they are described
+ * by static tables instead of being set up one by one in plugin_init(). The
+ * data is used as is and only the caps are made at registration, just like
+ * the static caps of the other typefinders. */
+typedef struct
+{
+  const gchar *name;
+  GstRank rank;
+  const gchar *ext;
+  GstTypeFindData data;
+} GstTypeFindTableEntry;
+
+static GstTypeFindTableEntry start_with_table[] = {
+  /* note: asx/wax/wmx are XML files, asf doesn't handle them */
+  {"video/x-ms-asf", GST_RANK_SECONDARY, "asf,wm,wma,wmv",
+      {(const guint8 *) "\060\046\262\165\216\146\317\021"
+              "\246\331\000\252\000\142\316\154", 16,
+          GST_TYPE_FIND_MAXIMUM}},
+  {"video/x-vcd", GST_RANK_PRIMARY, "dat",
+      {(const guint8 *) "\000\377\377\377\377\377\377\377\377\377\377\000",
+          12, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-imelody", GST_RANK_PRIMARY, "imy,ime,imelody",
+      {(const guint8 *) "BEGIN:IMELODY", 13, GST_TYPE_FIND_MAXIMUM}},
+#if 0
+  {"video/x-smoke", GST_RANK_PRIMARY, NULL,
+      {(const guint8 *) "\x80smoke\x00\x01\x00", 6, GST_TYPE_FIND_MAXIMUM}},
+#endif
+  {"application/vnd.rn-realmedia", GST_RANK_SECONDARY, "ra,ram,rm,rmvb",
+      {(const guint8 *) ".RMF", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"application/x-pn-realaudio", GST_RANK_SECONDARY, "ra,ram,rm,rmvb",
+      {(const guint8 *) ".ra\375", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"video/x-flv", GST_RANK_SECONDARY, "flv",
+      {(const guint8 *) "FLV", 3, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-nist", GST_RANK_SECONDARY, "nist",
+      {(const guint8 *) "NIST", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-voc", GST_RANK_SECONDARY, "voc",
+      {(const guint8 *) "Creative", 8, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-w64", GST_RANK_SECONDARY, "w64",
+      {(const guint8 *) "riff", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-rf64", GST_RANK_PRIMARY, "rf64",
+      {(const guint8 *) "RF64", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"image/gif", GST_RANK_PRIMARY, "gif",
+      {(const guint8 *) "GIF8", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"image/png", GST_RANK_PRIMARY + 14, "png",
+      {(const guint8 *) "\211PNG\015\012\032\012", 8, GST_TYPE_FIND_MAXIMUM}},
+  {"video/x-mve", GST_RANK_SECONDARY, "mve",
+      {(const guint8 *) "Interplay MVE File\032\000\032\000\000\001\063\021",
+          26, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-amr-nb-sh", GST_RANK_PRIMARY, "amr",
+      {(const guint8 *) "#!AMR", 5, GST_TYPE_FIND_LIKELY}},
+  {"audio/x-amr-wb-sh", GST_RANK_PRIMARY, "amr",
+      {(const guint8 *) "#!AMR-WB", 7, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-sid", GST_RANK_MARGINAL, "sid",
+      {(const guint8 *) "PSID", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"image/x-xcf", GST_RANK_SECONDARY, "xcf",
+      {(const guint8 *) "gimp xcf", 8, GST_TYPE_FIND_MAXIMUM}},
+  {"video/x-mng", GST_RANK_SECONDARY, "mng",
+      {(const guint8 *) "\212MNG\015\012\032\012", 8, GST_TYPE_FIND_MAXIMUM}},
+  {"image/x-jng", GST_RANK_SECONDARY, "jng",
+      {(const guint8 *) "\213JNG\015\012\032\012", 8, GST_TYPE_FIND_MAXIMUM}},
+  {"image/x-xpixmap", GST_RANK_SECONDARY, "xpm",
+      {(const guint8 *) "/* XPM */", 9, GST_TYPE_FIND_MAXIMUM}},
+  {"image/x-sun-raster", GST_RANK_SECONDARY, "ras",
+      {(const guint8 *) "\131\246\152\225", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"application/x-bzip", GST_RANK_SECONDARY, "bz2",
+      {(const guint8 *) "BZh", 3, GST_TYPE_FIND_LIKELY}},
+  {"application/x-gzip", GST_RANK_SECONDARY, "gz",
+      {(const guint8 *) "\037\213", 2, GST_TYPE_FIND_LIKELY}},
+  {"application/zip", GST_RANK_SECONDARY, "zip",
+      {(const guint8 *) "PK\003\004", 4, GST_TYPE_FIND_LIKELY}},
+  {"application/x-compress", GST_RANK_SECONDARY, "Z",
+      {(const guint8 *) "\037\235", 2, GST_TYPE_FIND_LIKELY}},
+  {"application/x-executable", GST_RANK_MARGINAL, NULL,
+      {(const guint8 *) "\177ELF", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-spc", GST_RANK_SECONDARY, "spc",
+      {(const guint8 *) "SNES-SPC700 Sound File Data",
+          27, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-caf", GST_RANK_SECONDARY, "caf",
+      {(const guint8 *) "caff\000\001", 6, GST_TYPE_FIND_MAXIMUM}},
+  {"application/x-rar", GST_RANK_SECONDARY, "rar",
+      {(const guint8 *) "Rar!", 4, GST_TYPE_FIND_LIKELY}},
+  {"audio/x-nsf", GST_RANK_SECONDARY, "nsf",
+      {(const guint8 *) "NESM\x1a", 5, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-gym", GST_RANK_SECONDARY, "gym",
+      {(const guint8 *) "GYMX", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-ay", GST_RANK_SECONDARY, "ay",
+      {(const guint8 *) "ZXAYEMUL", 8, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-gbs", GST_RANK_SECONDARY, "gbs",
+      {(const guint8 *) "GBS\x01", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-vgm", GST_RANK_SECONDARY, "vgm",
+      {(const guint8 *) "Vgm\x20", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-sap", GST_RANK_SECONDARY, "sap",
+      {(const guint8 *) "SAP\x0d\x0a" "AUTHOR\x20", 12, GST_TYPE_FIND_MAXIMUM}},
+  {"video/x-ivf", GST_RANK_SECONDARY, "ivf",
+      {(const guint8 *) "DKIF", 4, GST_TYPE_FIND_NEARLY_CERTAIN}},
+  {"audio/x-kss", GST_RANK_SECONDARY, "kss",
+      {(const guint8 *) "KSSX\0", 5, GST_TYPE_FIND_MAXIMUM}},
+  {"application/pdf", GST_RANK_SECONDARY, "pdf",
+      {(const guint8 *) "%PDF-", 5, GST_TYPE_FIND_LIKELY}},
+  {"application/msword", GST_RANK_SECONDARY, "doc",
+      {(const guint8 *) "\320\317\021\340\241\261\032\341",
+          8, GST_TYPE_FIND_LIKELY}},
+  /* Mac OS X .DS_Store files tend to be taken for video/mpeg */
+  {"application/octet-stream", GST_RANK_SECONDARY, "DS_Store",
+      {(const guint8 *) "\000\000\000\001Bud1", 8, GST_TYPE_FIND_LIKELY}},
+  {"image/vnd.adobe.photoshop", GST_RANK_SECONDARY, "psd",
+      {(const guint8 *) "8BPS\000\001\000\000\000\000",
+          10, GST_TYPE_FIND_LIKELY}},
+  {"audio/x-xi", GST_RANK_SECONDARY, "xi",
+      {(const guint8 *) "Extended Instrument: ", 21, GST_TYPE_FIND_MAXIMUM}},
+};
+
+/* the data is the RIFF form type */
+static GstTypeFindTableEntry riff_table[] = {
+  {"video/x-msvideo", GST_RANK_PRIMARY, "avi",
+      {(const guint8 *) "AVI ", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/qcelp", GST_RANK_PRIMARY, "qcp",
+      {(const guint8 *) "QLCM", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"video/x-cdxa", GST_RANK_PRIMARY, "dat",
+      {(const guint8 *) "CDXA", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/riff-midi", GST_RANK_PRIMARY, "mid,midi",
+      {(const guint8 *) "RMID", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"audio/x-wav", GST_RANK_PRIMARY, "wav",
+      {(const guint8 *) "WAVE", 4, GST_TYPE_FIND_MAXIMUM}},
+  {"image/webp", GST_RANK_PRIMARY, "webp",
+      {(const guint8 *) "WEBP", 4, GST_TYPE_FIND_MAXIMUM}},
+};
+
+static void
+register_type_find_table (GstPlugin * plugin, GstTypeFindFunction func,
+    GstTypeFindTableEntry * table, guint n_entries)
+{
+  guint i;
+
+  for (i = 0; i < n_entries; i++) {
+    GstTypeFindData *data = &table[i].data;
+
+    if (data->caps == NULL) {
+      data->caps = gst_caps_new_empty_simple (table[i].name);
+      GST_MINI_OBJECT_FLAG_SET (data->caps,
+          GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+    }
+    gst_type_find_register (plugin, table[i].name, table[i].rank, func,
+        table[i].ext, data->caps, data, NULL);
+  }
+}
+
+
+/*** fast path for common containers ***/
+
+/* Most streams are one of a small number of containers that can be told
+ * apart by a fixed magic near the start. The fast path typefinder is
+ * registered above all others and maps those leading bytes to the few
+ * typefinders that can claim them, in the order core would run them, so a
+ * common file is identified without going through the full list.
+ *
+ * Only certain (maximum probability) results are passed on. In every other
+ * case the fast path suggests nothing and core runs the full list as if it
+ * wasn't there, so the outcome never depends on it. */
+
+typedef struct
+{
+  GstTypeFind *tf;
+  gboolean found;
+} FastPathTypeFind;
+
+static const guint8 *
+fast_path_peek (gpointer data, gint64 offset, guint size)
+{
+  return gst_type_find_peek (((FastPathTypeFind *) data)->tf, offset, size);
+}
+
+static void
+fast_path_suggest (gpointer data, guint probability, GstCaps * caps)
+{
+  FastPathTypeFind *fp = (FastPathTypeFind *) data;
+
+  if (probability < GST_TYPE_FIND_MAXIMUM)
+    return;
+
+  gst_type_find_suggest (fp->tf, probability, caps);
+  fp->found = TRUE;
+}
+
+static guint64
+fast_path_get_length (gpointer data)
+{
+  return gst_type_find_get_length (((FastPathTypeFind *) data)->tf);
+}
+
+/* keep in sync with riff_table */
+static void
+fast_path_riff_type_find (GstTypeFind * tf, gpointer unused)
+{
+  static const struct
+  {
+    const gchar fourcc[5];
+    const gchar *media_type;
+  } riff_types[] = {
+    {
+    "WAVE", "audio/x-wav"}, {
+    "AVI ", "video/x-msvideo"}, {
+    "WEBP", "image/webp"}, {
+    "QLCM", "audio/qcelp"}, {
+    "CDXA", "video/x-cdxa"}, {
+    "RMID", "audio/riff-midi"}
+  };
+  const guint8 *data = gst_type_find_peek (tf, 8, 4);
+  guint i;
+
+  if (data == NULL)
+    return;
+
+  for (i = 0; i < G_N_ELEMENTS (riff_types); i++) {
+    if (memcmp (data, riff_types[i].fourcc, 4) == 0) {
+      gst_type_find_suggest_simple (tf, GST_TYPE_FIND_MAXIMUM,
+          riff_types[i].media_type, NULL);
+      return;
+    }
+  }
+}
+
+/* only worth scanning if there's a second sync byte one packet later, for
+ * any of the packet sizes with the sync byte first */
+static void
+fast_path_mpeg_ts_type_find (GstTypeFind * tf, gpointer unused)
+{
+  const guint8 *data = gst_type_find_peek (tf, 0, 208 + 1);
+
+  if (data && (data[188] == 0x47 || data[204] == 0x47 || data[208] == 0x47))
+    mpeg_ts_type_find (tf, unused);
+}
+
+/* the tag typefinders rank above everything else and look at the end of
+ * the stream, so they go first for anything but ID3v2 which ranks higher */
+#define FAST_PATH_TAGS apetag_type_find, id3v1_type_find
+
+static const struct
+{
+  guint offset;
+  const gchar magic[5];
+  guint magic_size;
+  GstTypeFindFunction funcs[5];
+} fast_path_table[] = {
+  {
+  0, "ID3", 3, {
+  id3v2_type_find}}, {
+  0, "\032\105\337\243", 4, {
+  FAST_PATH_TAGS, matroska_type_find}}, {
+  0, "OggS", 4, {
+  FAST_PATH_TAGS, ogganx_type_find}}, {
+  0, "RIFF", 4, {
+  FAST_PATH_TAGS, fast_path_riff_type_find}}, {
+  0, "AVF0", 4, {
+  FAST_PATH_TAGS, fast_path_riff_type_find}}, {
+  0, "fLaC", 4, {
+  FAST_PATH_TAGS, flac_type_find}}, {
+  4, "ftyp", 4, {
+  FAST_PATH_TAGS, q3gp_type_find, m4a_type_find, qt_type_find}}, {
+  0, "\107", 1, {
+  FAST_PATH_TAGS, fast_path_mpeg_ts_type_find}}
+};
+
+static void
+fast_path_type_find (GstTypeFind * tf, gpointer unused)
+{
+  FastPathTypeFind fp = { tf, FALSE };
+  GstTypeFind proxy = { fast_path_peek, fast_path_suggest, &fp,
+    fast_path_get_length,
+  };
+  const guint8 *data;
+  guint i, j;
+
+  if ((data = gst_type_find_peek (tf, 0, 8)) == NULL)
+    return;
+
+  for (i = 0; i < G_N_ELEMENTS (fast_path_table); i++) {
+    if (memcmp (data + fast_path_table[i].offset, fast_path_table[i].magic,
+            fast_path_table[i].magic_size) != 0)
+      continue;
+
+    GST_LOG ("fast path candidate: %s", fast_path_table[i].magic);
+    for (j = 0; j < G_N_ELEMENTS (fast_path_table[i].funcs); j++) {
+      if (fast_path_table[i].funcs[j] == NULL)
+        break;
+      fast_path_table[i].funcs[j] (&proxy, NULL);
+      if (fp.found)
+        return;
+    }
+    /* the magics don't overlap */
+    return;
+  }
+}
 
 
 /*** plugin initialization ***/
@@ -5568,40 +5921,24 @@ G_BEGIN_DECLS{\
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
-  /* can't initialize this via a struct as caps can't be statically initialized */
-
   GST_DEBUG_CATEGORY_INIT (type_find_debug, "typefindfunctions",
       GST_DEBUG_FG_GREEN | GST_DEBUG_BG_RED, "generic type find functions");
 
-  /* note: asx/wax/wmx are XML files, asf doesn't handle them */
-  /* must use strings, macros don't accept initializers */
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-ms-asf", GST_RANK_SECONDARY,
-      "asf,wm,wma,wmv",
-      "\060\046\262\165\216\146\317\021\246\331\000\252\000\142\316\154", 16,
-      GST_TYPE_FIND_MAXIMUM);
+  /* must rank above every other typefinder, see fast_path_type_find() */
+  TYPE_FIND_REGISTER (plugin, "fast-path", GST_RANK_PRIMARY + 200,
+      fast_path_type_find, NULL, NULL, NULL, NULL);
+
+  register_type_find_table (plugin, start_with_type_find, start_with_table,
+      G_N_ELEMENTS (start_with_table));
+  register_type_find_table (plugin, riff_type_find, riff_table,
+      G_N_ELEMENTS (riff_table));
+
   TYPE_FIND_REGISTER (plugin, "audio/x-musepack", GST_RANK_PRIMARY,
       musepack_type_find, "mpc,mpp,mp+", MUSEPACK_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "audio/x-au", GST_RANK_MARGINAL,
       au_type_find, "au,snd", AU_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_RIFF (plugin, "video/x-msvideo", GST_RANK_PRIMARY,
-      "avi", "AVI ");
-  TYPE_FIND_REGISTER_RIFF (plugin, "audio/qcelp", GST_RANK_PRIMARY,
-      "qcp", "QLCM");
-  TYPE_FIND_REGISTER_RIFF (plugin, "video/x-cdxa", GST_RANK_PRIMARY,
-      "dat", "CDXA");
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-vcd", GST_RANK_PRIMARY,
-      "dat", "\000\377\377\377\377\377\377\377\377\377\377\000", 12,
-      GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-imelody", GST_RANK_PRIMARY,
-      "imy,ime,imelody", "BEGIN:IMELODY", 13, GST_TYPE_FIND_MAXIMUM);
-#if 0
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-smoke", GST_RANK_PRIMARY,
-      NULL, "\x80smoke\x00\x01\x00", 6, GST_TYPE_FIND_MAXIMUM);
-#endif
   TYPE_FIND_REGISTER (plugin, "audio/midi", GST_RANK_PRIMARY, mid_type_find,
       "mid,midi", MID_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_RIFF (plugin, "audio/riff-midi", GST_RANK_PRIMARY,
-      "mid,midi", "RMID");
   TYPE_FIND_REGISTER (plugin, "audio/mobile-xmf", GST_RANK_PRIMARY,
       mxmf_type_find, "mxmf", MXMF_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "video/x-fli", GST_RANK_MARGINAL, flx_type_find,
@@ -5661,11 +5998,6 @@ plugin_init (GstPlugin * plugin)
 
   TYPE_FIND_REGISTER (plugin, "text/html", GST_RANK_SECONDARY, html_type_find,
       "htm,html", HTML_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/vnd.rn-realmedia",
-      GST_RANK_SECONDARY, "ra,ram,rm,rmvb", ".RMF", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/x-pn-realaudio",
-      GST_RANK_SECONDARY, "ra,ram,rm,rmvb", ".ra\375", 4,
-      GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "application/x-shockwave-flash",
       GST_RANK_SECONDARY, swf_type_find, "swf,swfl", SWF_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/dash+xml",
@@ -5673,8 +6005,6 @@ plugin_init (GstPlugin * plugin)
   TYPE_FIND_REGISTER (plugin, "application/vnd.ms-sstr+xml",
       GST_RANK_PRIMARY, mss_manifest_type_find, NULL, MSS_MANIFEST_CAPS, NULL,
       NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-flv", GST_RANK_SECONDARY,
-      "flv", "FLV", 3, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "text/plain", GST_RANK_MARGINAL, utf8_type_find,
       "txt", UTF8_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "text/utf-16", GST_RANK_MARGINAL, utf16_type_find,
@@ -5693,42 +6023,26 @@ plugin_init (GstPlugin * plugin)
       ttml_xml_type_find, "ttml+xml", TTML_XML_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/xml", GST_RANK_MARGINAL,
       xml_type_find, "xml", GENERIC_XML_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_RIFF (plugin, "audio/x-wav", GST_RANK_PRIMARY, "wav",
-      "WAVE");
   TYPE_FIND_REGISTER (plugin, "audio/x-aiff", GST_RANK_SECONDARY,
       aiff_type_find, "aiff,aif,aifc", AIFF_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "audio/x-svx", GST_RANK_SECONDARY, svx_type_find,
       "iff,svx", SVX_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "audio/x-paris", GST_RANK_SECONDARY,
       paris_type_find, "paf", PARIS_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-nist", GST_RANK_SECONDARY,
-      "nist", "NIST", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-voc", GST_RANK_SECONDARY,
-      "voc", "Creative", 8, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "audio/x-sds", GST_RANK_SECONDARY, sds_type_find,
       "sds", SDS_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "audio/x-ircam", GST_RANK_SECONDARY,
       ircam_type_find, "sf", IRCAM_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-w64", GST_RANK_SECONDARY,
-      "w64", "riff", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-rf64", GST_RANK_PRIMARY,
-      "rf64", "RF64", 4, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "audio/x-shorten", GST_RANK_SECONDARY,
       shn_type_find, "shn", SHN_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/x-ape", GST_RANK_SECONDARY,
       ape_type_find, "ape", APE_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "image/jpeg", GST_RANK_PRIMARY + 15,
       jpeg_type_find, "jpg,jpe,jpeg", JPEG_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/gif", GST_RANK_PRIMARY, "gif",
-      "GIF8", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/png", GST_RANK_PRIMARY + 14,
-      "png", "\211PNG\015\012\032\012", 8, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "image/bmp", GST_RANK_PRIMARY, bmp_type_find,
       "bmp", BMP_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "image/tiff", GST_RANK_PRIMARY, tiff_type_find,
       "tif,tiff", TIFF_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_RIFF (plugin, "image/webp", GST_RANK_PRIMARY,
-      "webp", "WEBP");
   TYPE_FIND_REGISTER (plugin, "image/x-exr", GST_RANK_PRIMARY, exr_type_find,
       "exr", EXR_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "image/x-portable-pixmap", GST_RANK_SECONDARY,
@@ -5737,39 +6051,12 @@ plugin_init (GstPlugin * plugin)
       matroska_type_find, "mkv,mka,mk3d,webm", MATROSKA_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/mxf", GST_RANK_PRIMARY,
       mxf_type_find, "mxf", MXF_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-mve", GST_RANK_SECONDARY,
-      "mve", "Interplay MVE File\032\000\032\000\000\001\063\021", 26,
-      GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "video/x-dv", GST_RANK_SECONDARY, dv_type_find,
       "dv,dif", DV_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-amr-nb-sh", GST_RANK_PRIMARY,
-      "amr", "#!AMR", 5, GST_TYPE_FIND_LIKELY);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-amr-wb-sh", GST_RANK_PRIMARY,
-      "amr", "#!AMR-WB", 7, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "audio/iLBC-sh", GST_RANK_PRIMARY, ilbc_type_find,
       "ilbc", ILBC_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "audio/x-sbc", GST_RANK_MARGINAL, sbc_type_find,
       "sbc", SBC_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-sid", GST_RANK_MARGINAL,
-      "sid", "PSID", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/x-xcf", GST_RANK_SECONDARY,
-      "xcf", "gimp xcf", 8, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-mng", GST_RANK_SECONDARY,
-      "mng", "\212MNG\015\012\032\012", 8, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/x-jng", GST_RANK_SECONDARY,
-      "jng", "\213JNG\015\012\032\012", 8, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/x-xpixmap", GST_RANK_SECONDARY,
-      "xpm", "/* XPM */", 9, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/x-sun-raster",
-      GST_RANK_SECONDARY, "ras", "\131\246\152\225", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/x-bzip",
-      GST_RANK_SECONDARY, "bz2", "BZh", 3, GST_TYPE_FIND_LIKELY);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/x-gzip",
-      GST_RANK_SECONDARY, "gz", "\037\213", 2, GST_TYPE_FIND_LIKELY);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/zip", GST_RANK_SECONDARY,
-      "zip", "PK\003\004", 4, GST_TYPE_FIND_LIKELY);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/x-compress",
-      GST_RANK_SECONDARY, "Z", "\037\235", 2, GST_TYPE_FIND_LIKELY);
   TYPE_FIND_REGISTER (plugin, "subtitle/x-kate", GST_RANK_MARGINAL,
       kate_type_find, NULL, NULL, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/x-subtitle-vtt", GST_RANK_MARGINAL,
@@ -5794,24 +6081,16 @@ plugin_init (GstPlugin * plugin)
       oggskel_type_find, NULL, OGG_SKELETON_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "text/x-cmml", GST_RANK_PRIMARY, cmml_type_find,
       NULL, CMML_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/x-executable",
-      GST_RANK_MARGINAL, NULL, "\177ELF", 4, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "audio/aac", GST_RANK_SECONDARY, aac_type_find,
       "aac,adts,adif,loas", AAC_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-spc", GST_RANK_SECONDARY,
-      "spc", "SNES-SPC700 Sound File Data", 27, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "audio/x-wavpack", GST_RANK_SECONDARY,
       wavpack_type_find, "wv,wvp", WAVPACK_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "audio/x-wavpack-correction", GST_RANK_SECONDARY,
       wavpack_type_find, "wvc", WAVPACK_CORRECTION_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-caf", GST_RANK_SECONDARY,
-      "caf", "caff\000\001", 6, GST_TYPE_FIND_MAXIMUM);
   TYPE_FIND_REGISTER (plugin, "application/postscript", GST_RANK_SECONDARY,
       postscript_type_find, "ps", POSTSCRIPT_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "image/svg+xml", GST_RANK_SECONDARY,
       svg_type_find, "svg", SVG_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/x-rar",
-      GST_RANK_SECONDARY, "rar", "Rar!", 4, GST_TYPE_FIND_LIKELY);
   TYPE_FIND_REGISTER (plugin, "application/x-tar", GST_RANK_SECONDARY,
       tar_type_find, "tar", TAR_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/x-ar", GST_RANK_SECONDARY,
@@ -5827,34 +6106,6 @@ plugin_init (GstPlugin * plugin)
       mmsh_type_find, NULL, MMSH_CAPS, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "video/vivo", GST_RANK_SECONDARY, vivo_type_find,
       "viv", VIVO_CAPS, NULL, NULL);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-nsf", GST_RANK_SECONDARY,
-      "nsf", "NESM\x1a", 5, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-gym", GST_RANK_SECONDARY,
-      "gym", "GYMX", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-ay", GST_RANK_SECONDARY, "ay",
-      "ZXAYEMUL", 8, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-gbs", GST_RANK_SECONDARY,
-      "gbs", "GBS\x01", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-vgm", GST_RANK_SECONDARY,
-      "vgm", "Vgm\x20", 4, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-sap", GST_RANK_SECONDARY,
-      "sap", "SAP\x0d\x0a" "AUTHOR\x20", 12, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "video/x-ivf", GST_RANK_SECONDARY,
-      "ivf", "DKIF", 4, GST_TYPE_FIND_NEARLY_CERTAIN);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-kss", GST_RANK_SECONDARY,
-      "kss", "KSSX\0", 5, GST_TYPE_FIND_MAXIMUM);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/pdf", GST_RANK_SECONDARY,
-      "pdf", "%PDF-", 5, GST_TYPE_FIND_LIKELY);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/msword",
-      GST_RANK_SECONDARY, "doc", "\320\317\021\340\241\261\032\341", 8,
-      GST_TYPE_FIND_LIKELY);
-  /* Mac OS X .DS_Store files tend to be taken for video/mpeg */
-  TYPE_FIND_REGISTER_START_WITH (plugin, "application/octet-stream",
-      GST_RANK_SECONDARY, "DS_Store", "\000\000\000\001Bud1", 8,
-      GST_TYPE_FIND_LIKELY);
-  TYPE_FIND_REGISTER_START_WITH (plugin, "image/vnd.adobe.photoshop",
-      GST_RANK_SECONDARY, "psd", "8BPS\000\001\000\000\000\000", 10,
-      GST_TYPE_FIND_LIKELY);
   TYPE_FIND_REGISTER (plugin, "image/vnd.wap.wbmp", GST_RANK_MARGINAL,
       wbmp_typefind, NULL, NULL, NULL, NULL);
   TYPE_FIND_REGISTER (plugin, "application/x-yuv4mpeg", GST_RANK_SECONDARY,
@@ -5878,8 +6129,6 @@ plugin_init (GstPlugin * plugin)
   TYPE_FIND_REGISTER (plugin, "video/x-pva", GST_RANK_SECONDARY,
       pva_type_find, "pva", PVA_CAPS, NULL, NULL);
 
-  TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-xi", GST_RANK_SECONDARY,
-      "xi", "Extended Instrument: ", 21, GST_TYPE_FIND_MAXIMUM);
 
   TYPE_FIND_REGISTER (plugin, "audio/audible", GST_RANK_MARGINAL,
       aa_type_find, "aa,aax", AA_CAPS, NULL, NULL);
@@ -33,6 +33,11 @@
  * window. If the video sink selected does not support YUY2 videoconvert will
  * automatically convert the video to a format understood by the video sink.
  * </refsect2>
+ *
+ * The brightness, contrast, hue and saturation can be changed with the
+ * properties or the #GstColorBalance interface. They are folded into the
+ * color conversion of the frames, so they cost nothing extra when the frames
+ * are converted anyway.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -44,6 +49,7 @@
 #include <gst/video/video.h>
 #include <gst/video/gstvideometa.h>
 #include <gst/video/gstvideopool.h>
+#include <gst/video/colorbalance.h>
 
 #include <string.h>
 
@@ -55,8 +61,13 @@ GType gst_video_convert_get_type (void);
 
 static GQuark _colorspace_quark;
 
+static void gst_video_convert_colorbalance_init (GstColorBalanceInterface *
+    iface);
+
 #define gst_video_convert_parent_class parent_class
-G_DEFINE_TYPE (GstVideoConvert, gst_video_convert, GST_TYPE_VIDEO_FILTER);
+G_DEFINE_TYPE_WITH_CODE (GstVideoConvert, gst_video_convert,
+    GST_TYPE_VIDEO_FILTER, G_IMPLEMENT_INTERFACE (GST_TYPE_COLOR_BALANCE,
+        gst_video_convert_colorbalance_init));
 
 #define DEFAULT_PROP_DITHER      GST_VIDEO_DITHER_BAYER
 #define DEFAULT_PROP_DITHER_QUANTIZATION 1
@@ -67,6 +78,11 @@ G_DEFINE_TYPE (GstVideoConvert, gst_video_convert, GST_TYPE_VIDEO_FILTER);
 #define DEFAULT_PROP_MATRIX_MODE GST_VIDEO_MATRIX_MODE_FULL
 #define DEFAULT_PROP_GAMMA_MODE GST_VIDEO_GAMMA_MODE_NONE
 #define DEFAULT_PROP_PRIMARIES_MODE GST_VIDEO_PRIMARIES_MODE_NONE
+#define DEFAULT_PROP_N_THREADS 1
+#define DEFAULT_PROP_CONTRAST 1.0
+#define DEFAULT_PROP_BRIGHTNESS 0.0
+#define DEFAULT_PROP_HUE 0.0
+#define DEFAULT_PROP_SATURATION 1.0
 
 enum
 {
@@ -79,7 +95,12 @@ enum
   PROP_CHROMA_MODE,
   PROP_MATRIX_MODE,
   PROP_GAMMA_MODE,
-  PROP_PRIMARIES_MODE
+  PROP_PRIMARIES_MODE,
+  PROP_N_THREADS,
+  PROP_CONTRAST,
+  PROP_BRIGHTNESS,
+  PROP_HUE,
+  PROP_SATURATION
 };
 
 #define CSP_VIDEO_CAPS GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL) ";" \
@@ -109,6 +130,8 @@ static gboolean gst_video_convert_set_info (GstVideoFilter * filter,
     GstVideoInfo * out_info);
 static GstFlowReturn gst_video_convert_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static GstFlowReturn gst_video_convert_transform_frame_ip (GstVideoFilter *
+    filter, GstVideoFrame * frame);
 
 /* copies the given caps */
 static GstCaps *
@@ -406,7 +429,10 @@ gst_video_convert_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
   const GstMetaInfo *info = meta->info;
   gboolean ret;
 
-  if (gst_meta_api_type_has_tag (info->api, _colorspace_quark)) {
+  if (info->api == GST_VIDEO_CROP_META_API_TYPE) {
+    /* the output is cropped already */
+    ret = FALSE;
+  } else if (gst_meta_api_type_has_tag (info->api, _colorspace_quark)) {
     /* don't copy colorspace specific metadata, FIXME, we need a MetaTransform
      * for the colorspace metadata. */
     ret = FALSE;
@@ -417,19 +443,313 @@ gst_video_convert_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
   return ret;
 }
 
+/* the pixels are changed by the color balance, call with the object lock */
 static gboolean
-gst_video_convert_set_info (GstVideoFilter * filter,
-    GstCaps * incaps, GstVideoInfo * in_info, GstCaps * outcaps,
-    GstVideoInfo * out_info)
+gst_video_convert_has_balance (GstVideoConvert * space)
 {
-  GstVideoConvert *space;
+  return space->contrast != DEFAULT_PROP_CONTRAST ||
+      space->brightness != DEFAULT_PROP_BRIGHTNESS ||
+      space->hue != DEFAULT_PROP_HUE ||
+      space->saturation != DEFAULT_PROP_SATURATION;
+}
 
-  space = GST_VIDEO_CONVERT_CAST (filter);
+/* check if converting from @in_info to @out_info with the current settings
+ * would leave the pixels untouched. The caps can still differ in fields that
+ * the converter is configured to ignore, or the buffers only in their
+ * strides, which GstVideoMeta takes care of. */
+static gboolean
+gst_video_convert_is_identity (GstVideoConvert * space,
+    const GstVideoInfo * in_info, const GstVideoInfo * out_info)
+{
+  const GstVideoColorimetry *in_cinfo = &in_info->colorimetry;
+  const GstVideoColorimetry *out_cinfo = &out_info->colorimetry;
+
+  if (GST_VIDEO_INFO_FORMAT (in_info) != GST_VIDEO_INFO_FORMAT (out_info))
+    return FALSE;
+
+  if (gst_video_convert_has_balance (space))
+    return FALSE;
+
+  if (in_cinfo->range != out_cinfo->range)
+    return FALSE;
+
+  if (GST_VIDEO_INFO_IS_YUV (in_info) && in_cinfo->matrix != out_cinfo->matrix
+      && space->matrix_mode != GST_VIDEO_MATRIX_MODE_NONE)
+    return FALSE;
+
+  if (in_cinfo->transfer != out_cinfo->transfer
+      && space->gamma_mode != GST_VIDEO_GAMMA_MODE_NONE)
+    return FALSE;
+
+  if (in_cinfo->primaries != out_cinfo->primaries
+      && space->primaries_mode != GST_VIDEO_PRIMARIES_MODE_NONE)
+    return FALSE;
+
+  if (in_info->chroma_site != out_info->chroma_site
+      && space->chroma_mode != GST_VIDEO_CHROMA_MODE_NONE)
+    return FALSE;
+
+  if (GST_VIDEO_INFO_HAS_ALPHA (in_info)
+      && space->alpha_mode != GST_VIDEO_ALPHA_MODE_COPY)
+    return FALSE;
+
+  return TRUE;
+}
+
+static gboolean
+gst_video_convert_is_rgb32 (GstVideoFormat format)
+{
+  switch (format) {
+    case GST_VIDEO_FORMAT_RGBx:
+    case GST_VIDEO_FORMAT_BGRx:
+    case GST_VIDEO_FORMAT_xRGB:
+    case GST_VIDEO_FORMAT_xBGR:
+    case GST_VIDEO_FORMAT_RGBA:
+    case GST_VIDEO_FORMAT_BGRA:
+    case GST_VIDEO_FORMAT_ARGB:
+    case GST_VIDEO_FORMAT_ABGR:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* byte offset of the alpha or padding component of a 32 bits RGB format */
+static guint
+gst_video_convert_alpha_offset (const GstVideoFormatInfo * finfo)
+{
+  if (GST_VIDEO_FORMAT_INFO_HAS_ALPHA (finfo))
+    return GST_VIDEO_FORMAT_INFO_POFFSET (finfo, GST_VIDEO_COMP_A);
+
+  /* the one that is not used by R, G and B */
+  return 6 - GST_VIDEO_FORMAT_INFO_POFFSET (finfo, GST_VIDEO_COMP_R) -
+      GST_VIDEO_FORMAT_INFO_POFFSET (finfo, GST_VIDEO_COMP_G) -
+      GST_VIDEO_FORMAT_INFO_POFFSET (finfo, GST_VIDEO_COMP_B);
+}
+
+/* check if converting from @in_info to @out_info only reorders the bytes of
+ * the pixels, like the converter would do when unpacking to and packing from
+ * ARGB, and make the map of the bytes in @map. The padding byte of the x
+ * formats is unpacked as alpha. */
+static gboolean
+gst_video_convert_get_swizzle (GstVideoConvert * space,
+    const GstVideoInfo * in_info, const GstVideoInfo * out_info, guint8 map[4])
+{
+  const GstVideoColorimetry *in_cinfo = &in_info->colorimetry;
+  const GstVideoColorimetry *out_cinfo = &out_info->colorimetry;
+  const GstVideoFormatInfo *in_finfo = in_info->finfo;
+  const GstVideoFormatInfo *out_finfo = out_info->finfo;
+  gint i;
+
+  if (!gst_video_convert_is_rgb32 (GST_VIDEO_INFO_FORMAT (in_info)) ||
+      !gst_video_convert_is_rgb32 (GST_VIDEO_INFO_FORMAT (out_info)))
+    return FALSE;
+
+  if (gst_video_convert_has_balance (space))
+    return FALSE;
+
+  if (in_cinfo->range != out_cinfo->range)
+    return FALSE;
+
+  if (in_cinfo->transfer != out_cinfo->transfer
+      && space->gamma_mode != GST_VIDEO_GAMMA_MODE_NONE)
+    return FALSE;
+
+  if (in_cinfo->primaries != out_cinfo->primaries
+      && space->primaries_mode != GST_VIDEO_PRIMARIES_MODE_NONE)
+    return FALSE;
+
+  /* the alpha would be changed, see convert_get_alpha_mode() of the
+   * converter */
+  if (GST_VIDEO_INFO_HAS_ALPHA (out_info) && space->alpha_value != 1.0 &&
+      !(GST_VIDEO_INFO_HAS_ALPHA (in_info)
+          && space->alpha_mode == GST_VIDEO_ALPHA_MODE_COPY))
+    return FALSE;
+
+  for (i = 0; i < 3; i++)
+    map[GST_VIDEO_FORMAT_INFO_POFFSET (out_finfo, i)] =
+        GST_VIDEO_FORMAT_INFO_POFFSET (in_finfo, i);
+  map[gst_video_convert_alpha_offset (out_finfo)] =
+      gst_video_convert_alpha_offset (in_finfo);
+
+  return TRUE;
+}
+
+/* the input can be cropped while converting, so upstream need not copy the
+ * frames of a decoder with padding */
+static gboolean
+gst_video_convert_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* the frame keeps its size when converted in place */
+  if (decide_query != NULL && !GST_VIDEO_CONVERT_CAST (trans)->swizzle &&
+      !gst_query_find_allocation_meta (query,
+          GST_VIDEO_CROP_META_API_TYPE, NULL))
+    gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+
+  return TRUE;
+}
+
+static void
+gst_video_convert_clear_crop (GstVideoConvert * space)
+{
+  if (space->crop_convert) {
+    gst_video_converter_free (space->crop_convert);
+    space->crop_convert = NULL;
+  }
+}
+
+/* a converter that reads the @crop rectangle of @in_frame. It's kept while
+ * the buffers have the same crop rectangle and size, and converters for
+ * rectangles seen before come from the converter cache. */
+static GstVideoConverter *
+gst_video_convert_get_crop_converter (GstVideoConvert * space,
+    GstVideoFrame * in_frame, GstVideoCropMeta * crop)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (space);
+  GstVideoInfo in_info = in_frame->info;
+  GstStructure *config;
+
+  if (space->crop_convert && space->crop_x == crop->x &&
+      space->crop_y == crop->y && space->crop_width == crop->width &&
+      space->crop_height == crop->height &&
+      space->crop_in_width == in_info.width &&
+      space->crop_in_height == in_info.height)
+    return space->crop_convert;
+
+  gst_video_convert_clear_crop (space);
+
+  GST_DEBUG_OBJECT (space, "crop %ux%u at %u,%u of %dx%d", crop->width,
+      crop->height, crop->x, crop->y, in_info.width, in_info.height);
+
+  config = gst_structure_copy (space->config);
+  gst_structure_set (config,
+      GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, (gint) crop->x,
+      GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, (gint) crop->y,
+      GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, (gint) crop->width,
+      GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, (gint) crop->height,
+      NULL);
+
+  space->crop_convert = gst_video_converter_new (&in_info, &filter->out_info,
+      config);
+  if (space->crop_convert) {
+    space->crop_x = crop->x;
+    space->crop_y = crop->y;
+    space->crop_width = crop->width;
+    space->crop_height = crop->height;
+    space->crop_in_width = in_info.width;
+    space->crop_in_height = in_info.height;
+  }
+  return space->crop_convert;
+}
+
+/* make the converter from @in_info to @out_info for the current settings,
+ * also when only the color balance changed */
+static gboolean
+gst_video_convert_setup (GstVideoConvert * space, GstVideoInfo * in_info,
+    GstVideoInfo * out_info)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (space);
+  gboolean identity;
 
   if (space->convert) {
     gst_video_converter_free (space->convert);
     space->convert = NULL;
   }
+  gst_video_convert_clear_crop (space);
+  if (space->config) {
+    gst_structure_free (space->config);
+    space->config = NULL;
+  }
+  space->swizzle = FALSE;
+
+  GST_OBJECT_LOCK (space);
+  space->balance_changed = FALSE;
+  /* also used for the converters of cropped input */
+  space->config = gst_structure_new ("GstVideoConvertConfig",
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      space->dither,
+      GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT,
+      space->dither_quantization,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_RESAMPLER_METHOD,
+      GST_TYPE_VIDEO_RESAMPLER_METHOD, space->chroma_resampler,
+      GST_VIDEO_CONVERTER_OPT_ALPHA_MODE,
+      GST_TYPE_VIDEO_ALPHA_MODE, space->alpha_mode,
+      GST_VIDEO_CONVERTER_OPT_ALPHA_VALUE,
+      G_TYPE_DOUBLE, space->alpha_value,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_MODE,
+      GST_TYPE_VIDEO_CHROMA_MODE, space->chroma_mode,
+      GST_VIDEO_CONVERTER_OPT_MATRIX_MODE,
+      GST_TYPE_VIDEO_MATRIX_MODE, space->matrix_mode,
+      GST_VIDEO_CONVERTER_OPT_GAMMA_MODE,
+      GST_TYPE_VIDEO_GAMMA_MODE, space->gamma_mode,
+      GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
+      GST_TYPE_VIDEO_PRIMARIES_MODE, space->primaries_mode,
+      GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
+      space->n_threads,
+      GST_VIDEO_CONVERTER_OPT_CONTRAST, G_TYPE_DOUBLE, space->contrast,
+      GST_VIDEO_CONVERTER_OPT_BRIGHTNESS, G_TYPE_DOUBLE, space->brightness,
+      GST_VIDEO_CONVERTER_OPT_HUE, G_TYPE_DOUBLE, space->hue,
+      GST_VIDEO_CONVERTER_OPT_SATURATION, G_TYPE_DOUBLE, space->saturation,
+      NULL);
+  identity = gst_video_convert_is_identity (space, in_info, out_info);
+  if (!identity)
+    space->swizzle = gst_video_convert_get_swizzle (space, in_info,
+        out_info, space->swizzle_map);
+  GST_OBJECT_UNLOCK (space);
+
+  /* nothing to convert, let the buffers pass, strides and offsets are
+   * described by their GstVideoMeta. The allocation query is then forwarded
+   * so upstream knows if downstream can handle that. */
+  if (identity) {
+    GST_DEBUG_OBJECT (space, "identical layout, passthrough");
+    gst_base_transform_set_passthrough (trans, TRUE);
+    return TRUE;
+  }
+  /* the caps can be the same when only the color balance changes the
+   * pixels */
+  gst_base_transform_set_passthrough (trans, FALSE);
+
+  /* only the bytes of the pixels are reordered, do that in place in the
+   * input buffer */
+  gst_base_transform_set_in_place (trans, space->swizzle);
+  if (space->swizzle) {
+    GST_DEBUG_OBJECT (space, "swizzle %u%u%u%u in place",
+        space->swizzle_map[0], space->swizzle_map[1], space->swizzle_map[2],
+        space->swizzle_map[3]);
+    return TRUE;
+  }
+
+  space->convert = gst_video_converter_new (in_info, out_info,
+      gst_structure_copy (space->config));
+  if (space->convert == NULL)
+    goto no_convert;
+
+  GST_DEBUG ("reconfigured %d %d", GST_VIDEO_INFO_FORMAT (in_info),
+      GST_VIDEO_INFO_FORMAT (out_info));
+
+  return TRUE;
+
+  /* ERRORS */
+no_convert:
+  {
+    GST_ERROR_OBJECT (space, "could not create converter");
+    return FALSE;
+  }
+}
+
+static gboolean
+gst_video_convert_set_info (GstVideoFilter * filter,
+    GstCaps * incaps, GstVideoInfo * in_info, GstCaps * outcaps,
+    GstVideoInfo * out_info)
+{
+  GstVideoConvert *space;
+
+  space = GST_VIDEO_CONVERT_CAST (filter);
 
   /* these must match */
   if (in_info->width != out_info->width || in_info->height != out_info->height
@@ -444,34 +764,7 @@ gst_video_convert_set_info (GstVideoFilter * filter,
   if (in_info->interlace_mode != out_info->interlace_mode)
     goto format_mismatch;
 
-
-  space->convert = gst_video_converter_new (in_info, out_info,
-      gst_structure_new ("GstVideoConvertConfig",
-          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
-          space->dither,
-          GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT,
-          space->dither_quantization,
-          GST_VIDEO_CONVERTER_OPT_CHROMA_RESAMPLER_METHOD,
-          GST_TYPE_VIDEO_RESAMPLER_METHOD, space->chroma_resampler,
-          GST_VIDEO_CONVERTER_OPT_ALPHA_MODE,
-          GST_TYPE_VIDEO_ALPHA_MODE, space->alpha_mode,
-          GST_VIDEO_CONVERTER_OPT_ALPHA_VALUE,
-          G_TYPE_DOUBLE, space->alpha_value,
-          GST_VIDEO_CONVERTER_OPT_CHROMA_MODE,
-          GST_TYPE_VIDEO_CHROMA_MODE, space->chroma_mode,
-          GST_VIDEO_CONVERTER_OPT_MATRIX_MODE,
-          GST_TYPE_VIDEO_MATRIX_MODE, space->matrix_mode,
-          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE,
-          GST_TYPE_VIDEO_GAMMA_MODE, space->gamma_mode,
-          GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
-          GST_TYPE_VIDEO_PRIMARIES_MODE, space->primaries_mode, NULL));
-  if (space->convert == NULL)
-    goto no_convert;
-
-  GST_DEBUG ("reconfigured %d %d", GST_VIDEO_INFO_FORMAT (in_info),
-      GST_VIDEO_INFO_FORMAT (out_info));
-
-  return TRUE;
+  return gst_video_convert_setup (space, in_info, out_info);
 
   /* ERRORS */
 format_mismatch:
@@ -479,10 +772,25 @@ format_mismatch:
     GST_ERROR_OBJECT (space, "input and output formats do not match");
     return FALSE;
   }
-no_convert:
-  {
-    GST_ERROR_OBJECT (space, "could not create converter");
-    return FALSE;
+}
+
+/* make a new converter when the color balance changed since the last
+ * one, this also switches between passthrough and converting */
+static void
+gst_video_convert_before_transform (GstBaseTransform * trans,
+    GstBuffer * buffer)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (trans);
+  gboolean changed;
+
+  GST_OBJECT_LOCK (space);
+  changed = space->balance_changed && filter->negotiated;
+  GST_OBJECT_UNLOCK (space);
+
+  if (changed) {
+    GST_DEBUG_OBJECT (space, "color balance changed, reconfigure");
+    gst_video_convert_setup (space, &filter->in_info, &filter->out_info);
   }
 }
 
@@ -494,6 +802,11 @@ gst_video_convert_finalize (GObject * obj)
   if (space->convert) {
     gst_video_converter_free (space->convert);
   }
+  gst_video_convert_clear_crop (space);
+  if (space->config)
+    gst_structure_free (space->config);
+
+  g_list_free_full (space->channels, (GDestroyNotify) g_object_unref);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -529,13 +842,20 @@ gst_video_convert_class_init (GstVideoConvertClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_filter_meta);
   gstbasetransform_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_convert_transform_meta);
+  gstbasetransform_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_propose_allocation);
+  gstbasetransform_class->before_transform =
+      GST_DEBUG_FUNCPTR (gst_video_convert_before_transform);
 
   gstbasetransform_class->passthrough_on_same_caps = TRUE;
+  gstbasetransform_class->transform_ip_on_passthrough = FALSE;
 
   gstvideofilter_class->set_info =
       GST_DEBUG_FUNCPTR (gst_video_convert_set_info);
   gstvideofilter_class->transform_frame =
       GST_DEBUG_FUNCPTR (gst_video_convert_transform_frame);
+  gstvideofilter_class->transform_frame_ip =
+      GST_DEBUG_FUNCPTR (gst_video_convert_transform_frame_ip);
 
   g_object_class_install_property (gobject_class, PROP_DITHER,
       g_param_spec_enum ("dither", "Dither", "Apply dithering while converting",
@@ -576,6 +896,40 @@ gst_video_convert_class_init (GstVideoConvertClass * klass)
           "Primaries Conversion Mode", gst_video_primaries_mode_get_type (),
           DEFAULT_PROP_PRIMARIES_MODE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of cores)", 0,
+          G_MAXUINT, DEFAULT_PROP_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_CONTRAST,
+      g_param_spec_double ("contrast", "Contrast", "Contrast of the luma",
+          0.0, 2.0, DEFAULT_PROP_CONTRAST,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_BRIGHTNESS,
+      g_param_spec_double ("brightness", "Brightness", "Brightness of the luma",
+          -1.0, 1.0, DEFAULT_PROP_BRIGHTNESS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_HUE,
+      g_param_spec_double ("hue", "Hue", "Rotation of the chroma", -1.0, 1.0,
+          DEFAULT_PROP_HUE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_SATURATION,
+      g_param_spec_double ("saturation", "Saturation",
+          "Saturation of the chroma", 0.0, 2.0, DEFAULT_PROP_SATURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_video_convert_add_channel (GstVideoConvert * space, const gchar * label)
+{
+  GstColorBalanceChannel *channel;
+
+  channel = g_object_new (GST_TYPE_COLOR_BALANCE_CHANNEL, NULL);
+  channel->label = g_strdup (label);
+  channel->min_value = -1000;
+  channel->max_value = 1000;
+
+  space->channels = g_list_append (space->channels, channel);
 }
 
 static void
@@ -590,6 +944,133 @@ gst_video_convert_init (GstVideoConvert * space)
   space->matrix_mode = DEFAULT_PROP_MATRIX_MODE;
   space->gamma_mode = DEFAULT_PROP_GAMMA_MODE;
   space->primaries_mode = DEFAULT_PROP_PRIMARIES_MODE;
+  space->n_threads = DEFAULT_PROP_N_THREADS;
+  space->contrast = DEFAULT_PROP_CONTRAST;
+  space->brightness = DEFAULT_PROP_BRIGHTNESS;
+  space->hue = DEFAULT_PROP_HUE;
+  space->saturation = DEFAULT_PROP_SATURATION;
+
+  gst_video_convert_add_channel (space, "HUE");
+  gst_video_convert_add_channel (space, "SATURATION");
+  gst_video_convert_add_channel (space, "BRIGHTNESS");
+  gst_video_convert_add_channel (space, "CONTRAST");
+}
+
+static GstColorBalanceChannel *
+gst_video_convert_find_channel (GstVideoConvert * space, const gchar * label)
+{
+  GList *l;
+
+  for (l = space->channels; l; l = l->next) {
+    GstColorBalanceChannel *channel = l->data;
+
+    if (g_ascii_strcasecmp (channel->label, label) == 0)
+      return channel;
+  }
+  return NULL;
+}
+
+/* the balance value of @label, call with the object lock */
+static gdouble *
+gst_video_convert_balance_value (GstVideoConvert * space, const gchar * label)
+{
+  if (!g_ascii_strcasecmp (label, "HUE"))
+    return &space->hue;
+  else if (!g_ascii_strcasecmp (label, "SATURATION"))
+    return &space->saturation;
+  else if (!g_ascii_strcasecmp (label, "BRIGHTNESS"))
+    return &space->brightness;
+  else if (!g_ascii_strcasecmp (label, "CONTRAST"))
+    return &space->contrast;
+
+  return NULL;
+}
+
+/* set the balance value of @label and make a new converter for the next
+ * buffer when it changed */
+static void
+gst_video_convert_set_balance (GstVideoConvert * space, const gchar * label,
+    gdouble value)
+{
+  gdouble *v;
+  gboolean changed = FALSE;
+
+  GST_OBJECT_LOCK (space);
+  if ((v = gst_video_convert_balance_value (space, label)) && *v != value) {
+    GST_DEBUG_OBJECT (space, "changing %s from %lf to %lf", label, *v, value);
+    *v = value;
+    space->balance_changed = changed = TRUE;
+  }
+  GST_OBJECT_UNLOCK (space);
+
+  if (changed) {
+    GstColorBalance *balance = GST_COLOR_BALANCE (space);
+    GstColorBalanceChannel *channel;
+
+    channel = gst_video_convert_find_channel (space, label);
+    gst_color_balance_value_changed (balance, channel,
+        gst_color_balance_get_value (balance, channel));
+  }
+}
+
+static const GList *
+gst_video_convert_colorbalance_list_channels (GstColorBalance * balance)
+{
+  return GST_VIDEO_CONVERT_CAST (balance)->channels;
+}
+
+/* like videobalance, the channels map [-1000..1000] to the range of the
+ * properties */
+static void
+gst_video_convert_colorbalance_set_value (GstColorBalance * balance,
+    GstColorBalanceChannel * channel, gint value)
+{
+  gdouble new_val = (value + 1000.0) * 2.0 / 2000.0;
+
+  g_return_if_fail (channel->label != NULL);
+
+  if (!g_ascii_strcasecmp (channel->label, "HUE") ||
+      !g_ascii_strcasecmp (channel->label, "BRIGHTNESS"))
+    new_val -= 1.0;
+
+  gst_video_convert_set_balance (GST_VIDEO_CONVERT_CAST (balance),
+      channel->label, new_val);
+}
+
+static gint
+gst_video_convert_colorbalance_get_value (GstColorBalance * balance,
+    GstColorBalanceChannel * channel)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (balance);
+  gdouble *v, val = 0.0;
+
+  g_return_val_if_fail (channel->label != NULL, 0);
+
+  GST_OBJECT_LOCK (space);
+  if ((v = gst_video_convert_balance_value (space, channel->label)))
+    val = *v;
+  GST_OBJECT_UNLOCK (space);
+
+  if (!g_ascii_strcasecmp (channel->label, "HUE") ||
+      !g_ascii_strcasecmp (channel->label, "BRIGHTNESS"))
+    val += 1.0;
+
+  return val * 2000.0 / 2.0 - 1000.0;
+}
+
+static GstColorBalanceType
+gst_video_convert_colorbalance_get_balance_type (GstColorBalance * balance)
+{
+  return GST_COLOR_BALANCE_SOFTWARE;
+}
+
+static void
+gst_video_convert_colorbalance_init (GstColorBalanceInterface * iface)
+{
+  iface->list_channels = gst_video_convert_colorbalance_list_channels;
+  iface->set_value = gst_video_convert_colorbalance_set_value;
+  iface->get_value = gst_video_convert_colorbalance_get_value;
+  iface->get_balance_type = gst_video_convert_colorbalance_get_balance_type;
 }
 
 void
@@ -628,6 +1109,24 @@ gst_video_convert_set_property (GObject * object, guint property_id,
     case PROP_DITHER_QUANTIZATION:
       csp->dither_quantization = g_value_get_uint (value);
       break;
+    case PROP_N_THREADS:
+      csp->n_threads = g_value_get_uint (value);
+      break;
+    case PROP_CONTRAST:
+      gst_video_convert_set_balance (csp, "CONTRAST",
+          g_value_get_double (value));
+      break;
+    case PROP_BRIGHTNESS:
+      gst_video_convert_set_balance (csp, "BRIGHTNESS",
+          g_value_get_double (value));
+      break;
+    case PROP_HUE:
+      gst_video_convert_set_balance (csp, "HUE", g_value_get_double (value));
+      break;
+    case PROP_SATURATION:
+      gst_video_convert_set_balance (csp, "SATURATION",
+          g_value_get_double (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -670,6 +1169,29 @@ gst_video_convert_get_property (GObject * object, guint property_id,
     case PROP_DITHER_QUANTIZATION:
       g_value_set_uint (value, csp->dither_quantization);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, csp->n_threads);
+      break;
+    case PROP_CONTRAST:
+      GST_OBJECT_LOCK (csp);
+      g_value_set_double (value, csp->contrast);
+      GST_OBJECT_UNLOCK (csp);
+      break;
+    case PROP_BRIGHTNESS:
+      GST_OBJECT_LOCK (csp);
+      g_value_set_double (value, csp->brightness);
+      GST_OBJECT_UNLOCK (csp);
+      break;
+    case PROP_HUE:
+      GST_OBJECT_LOCK (csp);
+      g_value_set_double (value, csp->hue);
+      GST_OBJECT_UNLOCK (csp);
+      break;
+    case PROP_SATURATION:
+      GST_OBJECT_LOCK (csp);
+      g_value_set_double (value, csp->saturation);
+      GST_OBJECT_UNLOCK (csp);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -681,6 +1203,7 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
 {
   GstVideoConvert *space;
+  GstVideoCropMeta *crop;
 
   space = GST_VIDEO_CONVERT_CAST (filter);
 
@@ -689,11 +1212,68 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
       GST_VIDEO_INFO_NAME (&filter->in_info),
       GST_VIDEO_INFO_NAME (&filter->out_info));
 
+  /* read only the cropped region, see propose_allocation */
+  if (space->config &&
+      (crop = gst_buffer_get_video_crop_meta (in_frame->buffer))) {
+    GstVideoConverter *convert;
+
+    if (!(convert = gst_video_convert_get_crop_converter (space, in_frame,
+                crop)))
+      return GST_FLOW_NOT_NEGOTIATED;
+
+    gst_video_converter_frame (convert, in_frame, out_frame);
+    return GST_FLOW_OK;
+  }
+
+  /* without a converter only the strides can differ */
+  if (space->convert == NULL) {
+    if (!gst_video_frame_copy (out_frame, in_frame))
+      return GST_FLOW_ERROR;
+    return GST_FLOW_OK;
+  }
+
   gst_video_converter_frame (space->convert, in_frame, out_frame);
 
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+gst_video_convert_transform_frame_ip (GstVideoFilter * filter,
+    GstVideoFrame * frame)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (filter);
+  const guint8 *map = space->swizzle_map;
+  gint i, j, width, height, stride;
+  guint8 *line, *p, t[4];
+
+  GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter,
+      "doing in place colorspace conversion from %s -> to %s",
+      GST_VIDEO_INFO_NAME (&filter->in_info),
+      GST_VIDEO_INFO_NAME (&filter->out_info));
+
+  width = GST_VIDEO_FRAME_WIDTH (frame);
+  height = GST_VIDEO_FRAME_HEIGHT (frame);
+  stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
+  line = GST_VIDEO_FRAME_PLANE_DATA (frame, 0);
+
+  for (i = 0; i < height; i++, line += stride) {
+    for (j = 0, p = line; j < width; j++, p += 4) {
+      t[0] = p[map[0]];
+      t[1] = p[map[1]];
+      t[2] = p[map[2]];
+      t[3] = p[map[3]];
+      memcpy (p, t, 4);
+    }
+  }
+
+  /* the buffer now has the output format */
+  if (frame->meta)
+    ((GstVideoMeta *) frame->meta)->format =
+        GST_VIDEO_INFO_FORMAT (&filter->out_info);
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
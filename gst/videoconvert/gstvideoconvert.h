@@ -47,6 +47,19 @@ struct _GstVideoConvert {
   GstVideoFilter element;
 
   GstVideoConverter *convert;
+  GstStructure *config;
+
+  /* converter for the GstVideoCropMeta of the input, and the rectangle and
+   * input size it was made for */
+  GstVideoConverter *crop_convert;
+  guint crop_x, crop_y, crop_width, crop_height;
+  gint crop_in_width, crop_in_height;
+
+  /* when only the bytes of the pixels are reordered, the conversion is done
+   * in place, output byte i is input byte swizzle_map[i] */
+  gboolean swizzle;
+  guint8 swizzle_map[4];
+
   GstVideoDitherMethod dither;
   guint dither_quantization;
   GstVideoResamplerMethod chroma_resampler;
@@ -56,6 +69,16 @@ struct _GstVideoConvert {
   GstVideoGammaMode gamma_mode;
   GstVideoPrimariesMode primaries_mode;
   gdouble alpha_value;
+  guint n_threads;
+
+  /* color balance, protected by the object lock. When changed, a new
+   * converter is made for the next buffer */
+  GList *channels;
+  gdouble contrast;
+  gdouble brightness;
+  gdouble hue;
+  gdouble saturation;
+  gboolean balance_changed;
 };
 
 struct _GstVideoConvertClass
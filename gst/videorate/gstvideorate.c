@@ -91,6 +91,7 @@ enum
 #define DEFAULT_DROP_ONLY       FALSE
 #define DEFAULT_AVERAGE_PERIOD  0
 #define DEFAULT_MAX_RATE        G_MAXINT
+#define DEFAULT_SKIP_UPSTREAM   FALSE
 
 enum
 {
@@ -104,7 +105,8 @@ enum
   PROP_SKIP_TO_FIRST,
   PROP_DROP_ONLY,
   PROP_AVERAGE_PERIOD,
-  PROP_MAX_RATE
+  PROP_MAX_RATE,
+  PROP_SKIP_UPSTREAM
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -250,6 +252,21 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           1, G_MAXINT, DEFAULT_MAX_RATE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:skip-upstream:
+   *
+   * When the output framerate is lower than the input framerate, tell
+   * upstream with a frame interval event which frames are used so that a
+   * decoder can skip decoding the frames that would be dropped. Takes
+   * effect at the next caps change.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (object_class, PROP_SKIP_UPSTREAM,
+      g_param_spec_boolean ("skip-upstream", "Skip upstream",
+          "Ask upstream to skip decoding the frames that are dropped",
+          DEFAULT_SKIP_UPSTREAM, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -495,6 +512,36 @@ gst_video_rate_fixate_caps (GstBaseTransform * trans,
   return othercaps;
 }
 
+/* let upstream know how many of its frames we use */
+static void
+gst_video_rate_update_frame_interval (GstVideoRate * videorate)
+{
+  GstClockTime interval = GST_CLOCK_TIME_NONE;
+  gboolean skip_upstream;
+
+  GST_OBJECT_LOCK (videorate);
+  skip_upstream = videorate->skip_upstream;
+  GST_OBJECT_UNLOCK (videorate);
+
+  /* only when we drop frames at a regular rate */
+  if (skip_upstream && videorate->from_rate_numerator > 0
+      && videorate->to_rate_numerator > 0
+      && gst_util_fraction_compare (videorate->to_rate_numerator,
+          videorate->to_rate_denominator, videorate->from_rate_numerator,
+          videorate->from_rate_denominator) < 0)
+    interval = videorate->wanted_diff;
+
+  if (interval == videorate->frame_interval)
+    return;
+
+  GST_DEBUG_OBJECT (videorate, "frame interval %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (interval));
+  videorate->frame_interval = interval;
+
+  gst_pad_push_event (GST_BASE_TRANSFORM_SINK_PAD (videorate),
+      gst_video_event_new_frame_interval (interval));
+}
+
 static gboolean
 gst_video_rate_setcaps (GstBaseTransform * trans, GstCaps * in_caps,
     GstCaps * out_caps)
@@ -539,6 +586,8 @@ gst_video_rate_setcaps (GstBaseTransform * trans, GstCaps * in_caps,
   else
     videorate->wanted_diff = 0;
 
+  gst_video_rate_update_frame_interval (videorate);
+
 done:
   /* After a setcaps, our caps may have changed. In that case, we can't use
    * the old buffer, if there was one (it might have different dimensions) */
@@ -573,6 +622,7 @@ gst_video_rate_reset (GstVideoRate * videorate)
   videorate->discont = TRUE;
   videorate->average = 0;
   videorate->force_variable_rate = FALSE;
+  videorate->frame_interval = GST_CLOCK_TIME_NONE;
   gst_video_rate_swap_prev (videorate, NULL, 0);
 
   gst_segment_init (&videorate->segment, GST_FORMAT_TIME);
@@ -588,6 +638,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->average_period = DEFAULT_AVERAGE_PERIOD;
   videorate->average_period_set = DEFAULT_AVERAGE_PERIOD;
   videorate->max_rate = DEFAULT_MAX_RATE;
+  videorate->skip_upstream = DEFAULT_SKIP_UPSTREAM;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -597,22 +648,46 @@ gst_video_rate_init (GstVideoRate * videorate)
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (videorate), TRUE);
 }
 
-/* flush the oldest buffer */
+/* the expected timestamp of the output after the next one */
+static GstClockTime
+gst_video_rate_get_next_ts (GstVideoRate * videorate)
+{
+  GstBuffer *buf = videorate->prevbuf;
+
+  if (videorate->to_rate_numerator) {
+    /* interpolate next expected timestamp in the segment */
+    return videorate->segment.base + videorate->segment.start +
+        videorate->base_ts + gst_util_uint64_scale (videorate->out_frame_count
+        + 1, videorate->to_rate_denominator * GST_SECOND,
+        videorate->to_rate_numerator);
+  } else if (GST_CLOCK_TIME_IS_VALID (GST_BUFFER_DURATION (buf))) {
+    return GST_BUFFER_PTS (buf) + GST_BUFFER_DURATION (buf);
+  }
+  return videorate->next_ts;
+}
+
+/* flush the oldest buffer, when it is the @last output of the buffer our
+ * reference goes downstream, otherwise we push a copy that shares the
+ * memory and has its own metadata */
 static GstFlowReturn
-gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate)
+gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate,
+    gboolean last)
 {
   GstFlowReturn res;
   GstBuffer *outbuf;
-  GstClockTime push_ts;
+  GstClockTime push_ts, next_ts;
 
   if (!videorate->prevbuf)
     goto eos_before_buffers;
 
+  next_ts = gst_video_rate_get_next_ts (videorate);
+
   outbuf = gst_buffer_ref (videorate->prevbuf);
-  if (videorate->drop_only)
+  if (videorate->drop_only || last)
     gst_buffer_replace (&videorate->prevbuf, NULL);
 
-  /* make sure we can write to the metadata */
+  /* make sure we can write to the metadata, this only copies when
+   * someone else also has a reference */
   outbuf = gst_buffer_make_writable (outbuf);
 
   GST_BUFFER_OFFSET (outbuf) = videorate->out;
@@ -634,17 +709,9 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate)
 
   videorate->out++;
   videorate->out_frame_count++;
-  if (videorate->to_rate_numerator) {
-    /* interpolate next expected timestamp in the segment */
-    videorate->next_ts =
-        videorate->segment.base + videorate->segment.start +
-        videorate->base_ts + gst_util_uint64_scale (videorate->out_frame_count,
-        videorate->to_rate_denominator * GST_SECOND,
-        videorate->to_rate_numerator);
-    GST_BUFFER_DURATION (outbuf) = videorate->next_ts - push_ts;
-  } else if (GST_CLOCK_TIME_IS_VALID (GST_BUFFER_DURATION (outbuf))) {
-    videorate->next_ts = GST_BUFFER_PTS (outbuf) + GST_BUFFER_DURATION (outbuf);
-  }
+  videorate->next_ts = next_ts;
+  if (videorate->to_rate_numerator)
+    GST_BUFFER_DURATION (outbuf) = next_ts - push_ts;
 
   /* We do not need to update time in VFR (variable frame rate) mode */
   if (!videorate->drop_only) {
@@ -726,7 +793,7 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
                     && videorate->next_ts - videorate->segment.base <
                     videorate->segment.stop)
                 || count < 1)) {
-          res = gst_video_rate_flush_prev (videorate, count > 0);
+          res = gst_video_rate_flush_prev (videorate, count > 0, FALSE);
           count++;
         }
         if (count > 1) {
@@ -765,7 +832,7 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
             && ((videorate->next_ts - videorate->segment.base <
                     videorate->segment.stop)
                 || count < 1)) {
-          res = gst_video_rate_flush_prev (videorate, count > 0);
+          res = gst_video_rate_flush_prev (videorate, count > 0, FALSE);
           count++;
         }
       } else if (!videorate->drop_only && videorate->prevbuf) {
@@ -778,11 +845,11 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
           while (res == GST_FLOW_OK && count <= MAGIC_LIMIT &&
               ((videorate->next_ts - videorate->segment.base < end_ts)
                   || count < 1)) {
-            res = gst_video_rate_flush_prev (videorate, count > 0);
+            res = gst_video_rate_flush_prev (videorate, count > 0, FALSE);
             count++;
           }
         } else {
-          res = gst_video_rate_flush_prev (videorate, FALSE);
+          res = gst_video_rate_flush_prev (videorate, FALSE, FALSE);
           count = 1;
         }
       }
@@ -1157,7 +1224,8 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
         GstFlowReturn r;
 
         /* on error the _flush function posted a warning already */
-        if ((r = gst_video_rate_flush_prev (videorate, FALSE)) != GST_FLOW_OK) {
+        if ((r = gst_video_rate_flush_prev (videorate, FALSE,
+                    TRUE)) != GST_FLOW_OK) {
           res = r;
           goto done;
         }
@@ -1219,14 +1287,33 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
       /* output first one when its the best */
       if (diff1 <= diff2) {
         GstFlowReturn r;
+        gboolean last = TRUE;
+
         count++;
 
+        /* see if the first one will also be the best for the next output,
+         * if not this is its last output */
+        if (diff1 < diff2) {
+          GstClockTime next_ts = gst_video_rate_get_next_ts (videorate);
+          gint64 next1 = prevtime - next_ts;
+          gint64 next2 = intime - next_ts;
+
+          if (next1 < 0)
+            next1 = -next1;
+          if (next2 < 0)
+            next2 = -next2;
+          last = next1 > next2;
+        }
+
         /* on error the _flush function posted a warning already */
         if ((r = gst_video_rate_flush_prev (videorate,
-                    count > 1)) != GST_FLOW_OK) {
+                    count > 1, last)) != GST_FLOW_OK) {
           res = r;
           goto done;
         }
+        /* the previous buffer was handed downstream */
+        if (last)
+          break;
       }
 
       /* continue while the first one was the best, if they were equal avoid
@@ -1328,6 +1415,9 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_RATE:
       g_atomic_int_set (&videorate->max_rate, g_value_get_int (value));
       goto reconfigure;
+    case PROP_SKIP_UPSTREAM:
+      videorate->skip_upstream = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1383,6 +1473,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_RATE:
       g_value_set_int (value, g_atomic_int_get (&videorate->max_rate));
       break;
+    case PROP_SKIP_UPSTREAM:
+      g_value_set_boolean (value, videorate->skip_upstream);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -80,6 +80,8 @@ struct _GstVideoRate
   guint64 average_period_set;
 
   volatile int max_rate;
+  gboolean skip_upstream;
+  GstClockTime frame_interval;  /* last announced upstream */
 };
 
 struct _GstVideoRateClass
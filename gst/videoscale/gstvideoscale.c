@@ -77,6 +77,7 @@
 #include <gst/video/gstvideopool.h>
 
 #include "gstvideoscale.h"
+#include "gstvideoscaletee.h"
 
 #define GST_CAT_DEFAULT video_scale_debug
 GST_DEBUG_CATEGORY_STATIC (video_scale_debug);
@@ -90,6 +91,7 @@ GST_DEBUG_CATEGORY_STATIC (CAT_PERFORMANCE);
 #define DEFAULT_PROP_SUBMETHOD    1
 #define DEFAULT_PROP_ENVELOPE     2.0
 #define DEFAULT_PROP_GAMMA_DECODE FALSE
+#define DEFAULT_PROP_N_THREADS    1
 
 enum
 {
@@ -102,6 +104,7 @@ enum
   PROP_SUBMETHOD,
   PROP_ENVELOPE,
   PROP_GAMMA_DECODE,
+  PROP_N_THREADS,
 };
 
 #undef GST_VIDEO_SIZE_RANGE
@@ -188,6 +191,9 @@ static GstCaps *gst_video_scale_transform_caps (GstBaseTransform * trans,
 static GstCaps *gst_video_scale_fixate_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps, GstCaps * othercaps);
 
+static gboolean gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query);
+
 static gboolean gst_video_scale_set_info (GstVideoFilter * filter,
     GstCaps * in, GstVideoInfo * in_info, GstCaps * out,
     GstVideoInfo * out_info);
@@ -260,6 +266,12 @@ gst_video_scale_class_init (GstVideoScaleClass * klass)
           "Decode gamma before scaling", DEFAULT_PROP_GAMMA_DECODE,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of cores)", 0,
+          G_MAXUINT, DEFAULT_PROP_N_THREADS,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
 
   gst_element_class_set_static_metadata (element_class,
       "Video scaler", "Filter/Converter/Video/Scaler",
@@ -274,6 +286,8 @@ gst_video_scale_class_init (GstVideoScaleClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_scale_transform_caps);
   trans_class->fixate_caps = GST_DEBUG_FUNCPTR (gst_video_scale_fixate_caps);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_scale_src_event);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_scale_propose_allocation);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_scale_set_info);
   filter_class->transform_frame =
@@ -291,6 +305,7 @@ gst_video_scale_init (GstVideoScale * videoscale)
   videoscale->dither = DEFAULT_PROP_DITHER;
   videoscale->envelope = DEFAULT_PROP_ENVELOPE;
   videoscale->gamma_decode = DEFAULT_PROP_GAMMA_DECODE;
+  videoscale->n_threads = DEFAULT_PROP_N_THREADS;
 }
 
 static void
@@ -298,6 +313,10 @@ gst_video_scale_finalize (GstVideoScale * videoscale)
 {
   if (videoscale->convert)
     gst_video_converter_free (videoscale->convert);
+  if (videoscale->crop_convert)
+    gst_video_converter_free (videoscale->crop_convert);
+  if (videoscale->config)
+    gst_structure_free (videoscale->config);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (videoscale));
 }
@@ -350,6 +369,11 @@ gst_video_scale_set_property (GObject * object, guint prop_id,
       vscale->gamma_decode = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (vscale);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vscale);
+      vscale->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -403,6 +427,11 @@ gst_video_scale_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_boolean (value, vscale->gamma_decode);
       GST_OBJECT_UNLOCK (vscale);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vscale);
+      g_value_set_uint (value, vscale->n_threads);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -474,6 +503,15 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
   GstVideoScale *videoscale = GST_VIDEO_SCALE (filter);
   gint from_dar_n, from_dar_d, to_dar_n, to_dar_d;
 
+  if (videoscale->crop_convert) {
+    gst_video_converter_free (videoscale->crop_convert);
+    videoscale->crop_convert = NULL;
+  }
+  if (videoscale->config) {
+    gst_structure_free (videoscale->config);
+    videoscale->config = NULL;
+  }
+
   if (!gst_util_fraction_multiply (in_info->width,
           in_info->height, in_info->par_n, in_info->par_d, &from_dar_n,
           &from_dar_d)) {
@@ -606,7 +644,8 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
         GST_VIDEO_MATRIX_MODE_NONE, GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
         GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_NONE,
         GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
-        GST_VIDEO_CHROMA_MODE_NONE, NULL);
+        GST_VIDEO_CHROMA_MODE_NONE, GST_VIDEO_CONVERTER_OPT_THREADS,
+        G_TYPE_UINT, videoscale->n_threads, NULL);
 
     if (videoscale->gamma_decode) {
       gst_structure_set (options,
@@ -616,6 +655,8 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
 
     if (videoscale->convert)
       gst_video_converter_free (videoscale->convert);
+    /* also used for the converters of cropped input */
+    videoscale->config = gst_structure_copy (options);
     videoscale->convert = gst_video_converter_new (in_info, out_info, options);
   }
 
@@ -1072,16 +1113,88 @@ done:
     (gpointer)(((guint8*)(GST_VIDEO_FRAME_PLANE_DATA (frame, 0))) + \
      GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0) * (line))
 
+/* the input can be cropped while scaling, so upstream need not copy the
+ * frames of a decoder with padding */
+static gboolean
+gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  if (decide_query != NULL && !gst_query_find_allocation_meta (query,
+          GST_VIDEO_CROP_META_API_TYPE, NULL))
+    gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+
+  return TRUE;
+}
+
+/* a converter that reads the @crop rectangle of @in_frame. It's kept while
+ * the buffers have the same crop rectangle and size, and converters for
+ * rectangles seen before come from the converter cache. */
+static GstVideoConverter *
+gst_video_scale_get_crop_converter (GstVideoScale * videoscale,
+    GstVideoFrame * in_frame, GstVideoCropMeta * crop)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (videoscale);
+  GstVideoInfo in_info = in_frame->info;
+  GstStructure *config;
+
+  if (videoscale->crop_convert && videoscale->crop_x == crop->x &&
+      videoscale->crop_y == crop->y && videoscale->crop_width == crop->width &&
+      videoscale->crop_height == crop->height &&
+      videoscale->crop_in_width == in_info.width &&
+      videoscale->crop_in_height == in_info.height)
+    return videoscale->crop_convert;
+
+  if (videoscale->crop_convert)
+    gst_video_converter_free (videoscale->crop_convert);
+
+  GST_DEBUG_OBJECT (videoscale, "crop %ux%u at %u,%u of %dx%d", crop->width,
+      crop->height, crop->x, crop->y, in_info.width, in_info.height);
+
+  config = gst_structure_copy (videoscale->config);
+  gst_structure_set (config,
+      GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, (gint) crop->x,
+      GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, (gint) crop->y,
+      GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, (gint) crop->width,
+      GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, (gint) crop->height,
+      NULL);
+
+  videoscale->crop_convert = gst_video_converter_new (&in_info,
+      &filter->out_info, config);
+  if (videoscale->crop_convert) {
+    videoscale->crop_x = crop->x;
+    videoscale->crop_y = crop->y;
+    videoscale->crop_width = crop->width;
+    videoscale->crop_height = crop->height;
+    videoscale->crop_in_width = in_info.width;
+    videoscale->crop_in_height = in_info.height;
+  }
+  return videoscale->crop_convert;
+}
+
 static GstFlowReturn
 gst_video_scale_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
 {
   GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (filter);
+  GstVideoConverter *convert = videoscale->convert;
+  GstVideoCropMeta *crop;
   GstFlowReturn ret = GST_FLOW_OK;
 
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter, "doing video scaling");
 
-  gst_video_converter_frame (videoscale->convert, in_frame, out_frame);
+  /* read only the cropped region, see propose_allocation */
+  if (videoscale->config &&
+      (crop = gst_buffer_get_video_crop_meta (in_frame->buffer))) {
+    if (!(convert = gst_video_scale_get_crop_converter (videoscale, in_frame,
+                crop)))
+      return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  gst_video_converter_frame (convert, in_frame, out_frame);
 
   return ret;
 }
@@ -1131,6 +1244,9 @@ plugin_init (GstPlugin * plugin)
   if (!gst_element_register (plugin, "videoscale", GST_RANK_NONE,
           GST_TYPE_VIDEO_SCALE))
     return FALSE;
+  if (!gst_element_register (plugin, "videoscaletee", GST_RANK_NONE,
+          GST_TYPE_VIDEO_SCALE_TEE))
+    return FALSE;
 
   GST_DEBUG_CATEGORY_INIT (video_scale_debug, "videoscale", 0,
       "videoscale element");
@@ -88,8 +88,16 @@ struct _GstVideoScale {
   int submethod;
   double envelope;
   gboolean gamma_decode;
+  guint n_threads;
 
   GstVideoConverter *convert;
+  GstStructure *config;
+
+  /* converter for the GstVideoCropMeta of the input, and the rectangle and
+   * input size it was made for */
+  GstVideoConverter *crop_convert;
+  guint crop_x, crop_y, crop_width, crop_height;
+  gint crop_in_width, crop_in_height;
 
   gint borders_h;
   gint borders_w;
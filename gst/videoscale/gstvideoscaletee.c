@@ -0,0 +1,843 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-videoscaletee
+ * @see_also: videoscale, tee
+ *
+ * Scales every input frame to the sizes of all its source pads at once,
+ * like a tee with a videoscale on every branch, for example to make the
+ * renditions of an adaptive streaming ladder.
+ *
+ * Each request source pad takes the size that downstream asks for, with the
+ * format and framerate of the input. A size that downstream leaves open is
+ * picked to keep the display aspect ratio of the input. Outputs with the
+ * size of the input get the input buffers themselves.
+ *
+ * With #GstVideoScaleTee:cascade an output is made from a larger output
+ * that is at least twice its size instead of from the input, so that the
+ * small sizes don't have to read the full frame again, e.g. 1080p is
+ * scaled to 540p and 540p to 270p.
+ *
+ * <refsect2>
+ * <title>Example pipeline</title>
+ * |[
+ * gst-launch-1.0 -v videotestsrc ! video/x-raw,width=1920,height=1080 ! videoscaletee name=t \
+ *     t. ! queue ! video/x-raw,width=1280,height=720 ! fakesink \
+ *     t. ! queue ! video/x-raw,width=960,height=540 ! fakesink \
+ *     t. ! queue ! video/x-raw,width=480,height=270 ! fakesink
+ * ]| Makes three smaller versions of every frame, the 270p version is made
+ * from the 540p one.
+ * </refsect2>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/video/gstvideometa.h>
+
+#include "gstvideoscaletee.h"
+
+GST_DEBUG_CATEGORY_STATIC (video_scale_tee_debug);
+#define GST_CAT_DEFAULT video_scale_tee_debug
+
+#define DEFAULT_PROP_METHOD     GST_VIDEO_RESAMPLER_METHOD_CUBIC
+#define DEFAULT_PROP_CASCADE    TRUE
+#define DEFAULT_PROP_N_THREADS  1
+
+enum
+{
+  PROP_0,
+  PROP_METHOD,
+  PROP_CASCADE,
+  PROP_N_THREADS,
+};
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+/* the state of one source pad */
+typedef struct
+{
+  GstPad *pad;
+  /* caps were sent, with the size in info */
+  gboolean negotiated;
+  /* negotiate again before the next buffer, also when it failed before only
+   * once downstream asks for it */
+  gboolean need_negotiate;
+  GstVideoInfo info;
+
+  /* NULL when the output has the size of the input */
+  GstVideoConverter *convert;
+  /* the index of the output in outputs that this one is made from, -1 for
+   * the input */
+  gint source;
+
+  /* while processing a frame */
+  GstBuffer *buffer;
+  GstVideoFrame frame;
+} GstVideoScaleTeeOutput;
+
+#define gst_video_scale_tee_parent_class parent_class
+G_DEFINE_TYPE (GstVideoScaleTee, gst_video_scale_tee, GST_TYPE_ELEMENT);
+
+static void gst_video_scale_tee_finalize (GObject * object);
+static void gst_video_scale_tee_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_video_scale_tee_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static GstPad *gst_video_scale_tee_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
+static void gst_video_scale_tee_release_pad (GstElement * element,
+    GstPad * pad);
+static GstStateChangeReturn gst_video_scale_tee_change_state (GstElement *
+    element, GstStateChange transition);
+
+static GstFlowReturn gst_video_scale_tee_chain (GstPad * pad,
+    GstObject * parent, GstBuffer * buffer);
+static gboolean gst_video_scale_tee_sink_event (GstPad * pad,
+    GstObject * parent, GstEvent * event);
+static gboolean gst_video_scale_tee_sink_query (GstPad * pad,
+    GstObject * parent, GstQuery * query);
+static gboolean gst_video_scale_tee_src_query (GstPad * pad,
+    GstObject * parent, GstQuery * query);
+
+static void
+gst_video_scale_tee_class_init (GstVideoScaleTeeClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *element_class = (GstElementClass *) klass;
+
+  GST_DEBUG_CATEGORY_INIT (video_scale_tee_debug, "videoscaletee", 0,
+      "videoscaletee element");
+
+  gobject_class->finalize = gst_video_scale_tee_finalize;
+  gobject_class->set_property = gst_video_scale_tee_set_property;
+  gobject_class->get_property = gst_video_scale_tee_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_METHOD,
+      g_param_spec_enum ("method", "Method", "The resampler method",
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, DEFAULT_PROP_METHOD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_CASCADE,
+      g_param_spec_boolean ("cascade", "Cascade",
+          "Make outputs from larger outputs that are at least twice their size",
+          DEFAULT_PROP_CASCADE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use for each output", 0, G_MAXUINT,
+          DEFAULT_PROP_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Video scaling tee", "Filter/Converter/Video/Scaler",
+      "Resizes video to several sizes at once",
+      "Tobias Lindqvist <tobias.lindqvist@gmail.com>");
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_request_new_pad);
+  element_class->release_pad =
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_release_pad);
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_change_state);
+}
+
+static void
+gst_video_scale_tee_init (GstVideoScaleTee * tee)
+{
+  tee->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (tee->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_chain));
+  gst_pad_set_event_function (tee->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_sink_event));
+  gst_pad_set_query_function (tee->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_sink_query));
+  gst_element_add_pad (GST_ELEMENT (tee), tee->sinkpad);
+
+  tee->outputs = g_ptr_array_new ();
+  tee->flow_combiner = gst_flow_combiner_new ();
+
+  tee->method = DEFAULT_PROP_METHOD;
+  tee->cascade = DEFAULT_PROP_CASCADE;
+  tee->n_threads = DEFAULT_PROP_N_THREADS;
+}
+
+static void
+gst_video_scale_tee_finalize (GObject * object)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (object);
+
+  /* the outputs are freed when their pads are released */
+  g_ptr_array_free (tee->outputs, TRUE);
+  gst_flow_combiner_free (tee->flow_combiner);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_video_scale_tee_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (object);
+
+  switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (tee);
+      tee->method = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (tee);
+      break;
+    case PROP_CASCADE:
+      GST_OBJECT_LOCK (tee);
+      tee->cascade = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (tee);
+      break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (tee);
+      tee->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (tee);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_video_scale_tee_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (object);
+
+  switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (tee);
+      g_value_set_enum (value, tee->method);
+      GST_OBJECT_UNLOCK (tee);
+      break;
+    case PROP_CASCADE:
+      GST_OBJECT_LOCK (tee);
+      g_value_set_boolean (value, tee->cascade);
+      GST_OBJECT_UNLOCK (tee);
+      break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (tee);
+      g_value_set_uint (value, tee->n_threads);
+      GST_OBJECT_UNLOCK (tee);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* @caps with any size */
+static GstCaps *
+gst_video_scale_tee_free_size (GstCaps * caps)
+{
+  GstCaps *res;
+  guint i, n;
+
+  res = gst_caps_copy (caps);
+  n = gst_caps_get_size (res);
+  for (i = 0; i < n; i++) {
+    GstStructure *s = gst_caps_get_structure (res, i);
+
+    gst_structure_set (s, "width", GST_TYPE_INT_RANGE, 1, 32767,
+        "height", GST_TYPE_INT_RANGE, 1, 32767, NULL);
+    gst_structure_remove_field (s, "pixel-aspect-ratio");
+  }
+  return res;
+}
+
+typedef struct
+{
+  GstVideoScaleTeeOutput *out;
+  GstCaps *caps;
+  gboolean pushed_caps;
+} PushStickyData;
+
+/* send the sticky events of the sinkpad that @data->out doesn't have yet in
+ * order, with its own caps in place of the caps of the input */
+static gboolean
+push_sticky (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  PushStickyData *data = user_data;
+  GstPad *srcpad = data->out->pad;
+  GstEvent *current;
+
+  if (GST_EVENT_TYPE (*event) == GST_EVENT_CAPS) {
+    GstCaps *caps = gst_pad_get_current_caps (srcpad);
+
+    if (caps == NULL || !gst_caps_is_equal (caps, data->caps))
+      gst_pad_push_event (srcpad, gst_event_new_caps (data->caps));
+    if (caps)
+      gst_caps_unref (caps);
+    data->pushed_caps = TRUE;
+    return TRUE;
+  }
+
+  current = gst_pad_get_sticky_event (srcpad, GST_EVENT_TYPE (*event), 0);
+  if (current != *event)
+    gst_pad_push_event (srcpad, gst_event_ref (*event));
+  if (current)
+    gst_event_unref (current);
+
+  return TRUE;
+}
+
+/* pick the output size from what downstream of @out accepts and send the
+ * caps. Called with the STREAM_LOCK. */
+static gboolean
+gst_video_scale_tee_negotiate_output (GstVideoScaleTee * tee,
+    GstVideoScaleTeeOutput * out)
+{
+  GstVideoInfo *in_info = &tee->in_info;
+  GstCaps *incaps, *filter, *caps;
+  GstStructure *s;
+  PushStickyData data;
+  gint width, height;
+
+  out->negotiated = FALSE;
+  out->need_negotiate = FALSE;
+  gst_pad_check_reconfigure (out->pad);
+
+  incaps = gst_video_info_to_caps (in_info);
+  filter = gst_video_scale_tee_free_size (incaps);
+  gst_caps_unref (incaps);
+
+  caps = gst_pad_peer_query_caps (out->pad, filter);
+  gst_caps_unref (filter);
+  if (gst_caps_is_empty (caps)) {
+    gst_caps_unref (caps);
+    GST_DEBUG_OBJECT (out->pad, "downstream doesn't accept the input format");
+    return FALSE;
+  }
+
+  caps = gst_caps_truncate (caps);
+  caps = gst_caps_make_writable (caps);
+  s = gst_caps_get_structure (caps, 0);
+
+  /* sizes that downstream leaves open keep the display aspect ratio of the
+   * input, all outputs have the pixel-aspect-ratio of the input */
+  if (!gst_structure_get_int (s, "width", &width)) {
+    if (gst_structure_get_int (s, "height", &height))
+      gst_structure_fixate_field_nearest_int (s, "width",
+          gst_util_uint64_scale_int (height, in_info->width, in_info->height));
+    else
+      gst_structure_fixate_field_nearest_int (s, "width", in_info->width);
+    gst_structure_get_int (s, "width", &width);
+  }
+  if (!gst_structure_get_int (s, "height", &height))
+    gst_structure_fixate_field_nearest_int (s, "height",
+        gst_util_uint64_scale_int (width, in_info->height, in_info->width));
+
+  if (gst_structure_has_field (s, "pixel-aspect-ratio"))
+    gst_structure_fixate_field_nearest_fraction (s, "pixel-aspect-ratio",
+        in_info->par_n, in_info->par_d);
+  else
+    gst_structure_set (s, "pixel-aspect-ratio", GST_TYPE_FRACTION,
+        in_info->par_n, in_info->par_d, NULL);
+
+  caps = gst_caps_fixate (caps);
+
+  if (!gst_video_info_from_caps (&out->info, caps)) {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (out->pad, "negotiated %" GST_PTR_FORMAT, caps);
+
+  data.out = out;
+  data.caps = caps;
+  data.pushed_caps = FALSE;
+  gst_pad_sticky_events_foreach (tee->sinkpad, push_sticky, &data);
+  /* while handling the first caps event the sinkpad doesn't have them yet */
+  if (!data.pushed_caps)
+    gst_pad_push_event (out->pad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  out->negotiated = TRUE;
+
+  return TRUE;
+}
+
+static gint
+compare_output_size (gconstpointer a, gconstpointer b)
+{
+  const GstVideoScaleTeeOutput *oa = *(GstVideoScaleTeeOutput **) a;
+  const GstVideoScaleTeeOutput *ob = *(GstVideoScaleTeeOutput **) b;
+  guint64 sa, sb;
+
+  sa = oa->negotiated ? (guint64) oa->info.width * oa->info.height : 0;
+  sb = ob->negotiated ? (guint64) ob->info.width * ob->info.height : 0;
+
+  return (sa > sb) ? -1 : ((sa < sb) ? 1 : 0);
+}
+
+/* sort the outputs by size and make their converters. Called with the
+ * STREAM_LOCK. */
+static gboolean
+gst_video_scale_tee_setup (GstVideoScaleTee * tee)
+{
+  GstVideoResamplerMethod method;
+  gboolean cascade;
+  guint i, j, n_threads;
+
+  GST_OBJECT_LOCK (tee);
+  method = tee->method;
+  cascade = tee->cascade;
+  n_threads = tee->n_threads;
+  GST_OBJECT_UNLOCK (tee);
+
+  g_ptr_array_sort (tee->outputs, compare_output_size);
+
+  for (i = 0; i < tee->outputs->len; i++) {
+    GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+    GstVideoInfo *src_info = &tee->in_info;
+
+    if (out->convert) {
+      gst_video_converter_free (out->convert);
+      out->convert = NULL;
+    }
+    out->source = -1;
+
+    if (!out->negotiated)
+      continue;
+
+    if (out->info.width == tee->in_info.width &&
+        out->info.height == tee->in_info.height)
+      continue;
+
+    /* the smallest larger output that is still twice as large */
+    for (j = 0; cascade && j < i; j++) {
+      GstVideoScaleTeeOutput *prev = g_ptr_array_index (tee->outputs, j);
+
+      if (prev->convert != NULL &&
+          prev->info.width >= 2 * out->info.width &&
+          prev->info.height >= 2 * out->info.height) {
+        out->source = j;
+        src_info = &prev->info;
+      }
+    }
+
+    GST_DEBUG_OBJECT (out->pad, "scaling %dx%d from %s %dx%d",
+        out->info.width, out->info.height, out->source < 0 ? "input" :
+        GST_PAD_NAME (((GstVideoScaleTeeOutput *)
+                g_ptr_array_index (tee->outputs, out->source))->pad),
+        src_info->width, src_info->height);
+
+    out->convert = gst_video_converter_new (src_info, &out->info,
+        gst_structure_new ("GstVideoScaleTee",
+            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+            GST_TYPE_VIDEO_RESAMPLER_METHOD, method,
+            GST_VIDEO_CONVERTER_OPT_MATRIX_MODE, GST_TYPE_VIDEO_MATRIX_MODE,
+            GST_VIDEO_MATRIX_MODE_NONE, GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
+            GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_NONE,
+            GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
+            GST_VIDEO_CHROMA_MODE_NONE, GST_VIDEO_CONVERTER_OPT_THREADS,
+            G_TYPE_UINT, n_threads, NULL));
+    if (out->convert == NULL) {
+      GST_ERROR_OBJECT (out->pad, "could not create converter");
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_video_scale_tee_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (parent);
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstVideoFrame in_frame;
+  gboolean changed = FALSE;
+  guint i;
+
+  if (!tee->have_info)
+    goto not_negotiated;
+
+  /* new pads, or downstream wants another size. Outputs that downstream
+   * refused stay unnegotiated until it asks again */
+  for (i = 0; i < tee->outputs->len; i++) {
+    GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+    gboolean was_negotiated = out->negotiated;
+    GstVideoInfo old_info = out->info;
+
+    if (!out->need_negotiate && !gst_pad_check_reconfigure (out->pad))
+      continue;
+
+    gst_video_scale_tee_negotiate_output (tee, out);
+    if (out->negotiated != was_negotiated || (out->negotiated &&
+            !gst_video_info_is_equal (&out->info, &old_info)))
+      changed = TRUE;
+  }
+  if (changed && !gst_video_scale_tee_setup (tee))
+    goto not_negotiated;
+
+  if (!gst_video_frame_map (&in_frame, &tee->in_info, buffer, GST_MAP_READ))
+    goto map_failed;
+
+  /* from large to small so that the sources of cascaded outputs are done */
+  for (i = 0; i < tee->outputs->len; i++) {
+    GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+    GstVideoFrame *src;
+
+    if (!out->negotiated)
+      continue;
+
+    if (out->convert == NULL) {
+      out->buffer = gst_buffer_ref (buffer);
+      continue;
+    }
+
+    if (out->source < 0) {
+      src = &in_frame;
+    } else {
+      GstVideoScaleTeeOutput *source =
+          g_ptr_array_index (tee->outputs, out->source);
+
+      /* the converter is made for the size of the source, skip the frame
+       * when the source has none */
+      if (source->buffer == NULL) {
+        GST_WARNING_OBJECT (out->pad, "no frame from %s to scale from",
+            GST_PAD_NAME (source->pad));
+        continue;
+      }
+      src = &source->frame;
+    }
+
+    out->buffer = gst_buffer_new_allocate (NULL, out->info.size, NULL);
+    gst_buffer_copy_into (out->buffer, buffer,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+    if (!gst_video_frame_map (&out->frame, &out->info, out->buffer,
+            GST_MAP_WRITE)) {
+      GST_WARNING_OBJECT (out->pad, "could not map the output buffer");
+      gst_buffer_unref (out->buffer);
+      out->buffer = NULL;
+      continue;
+    }
+
+    gst_video_converter_frame (out->convert, src, &out->frame);
+  }
+
+  for (i = 0; i < tee->outputs->len; i++) {
+    GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+
+    if (out->buffer && out->convert)
+      gst_video_frame_unmap (&out->frame);
+  }
+  gst_video_frame_unmap (&in_frame);
+  gst_buffer_unref (buffer);
+
+  for (i = 0; i < tee->outputs->len; i++) {
+    GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+    GstFlowReturn res;
+
+    if (out->buffer == NULL)
+      continue;
+
+    res = gst_pad_push (out->pad, out->buffer);
+    out->buffer = NULL;
+    ret = gst_flow_combiner_update_pad_flow (tee->flow_combiner, out->pad,
+        res);
+  }
+
+  return ret;
+
+  /* ERRORS */
+not_negotiated:
+  {
+    GST_ELEMENT_ERROR (tee, CORE, NEGOTIATION, (NULL),
+        ("no format configured"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+map_failed:
+  {
+    GST_ELEMENT_ERROR (tee, STREAM, FAILED, (NULL),
+        ("could not map the input buffer"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+}
+
+static gboolean
+gst_video_scale_tee_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (parent);
+  gboolean res = TRUE;
+  guint i;
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+
+      gst_event_parse_caps (event, &caps);
+      if (!gst_video_info_from_caps (&tee->in_info, caps)) {
+        GST_ERROR_OBJECT (tee, "invalid caps %" GST_PTR_FORMAT, caps);
+        gst_event_unref (event);
+        return FALSE;
+      }
+      tee->have_info = TRUE;
+      gst_event_unref (event);
+
+      /* now, before the segment is forwarded */
+      for (i = 0; i < tee->outputs->len; i++)
+        gst_video_scale_tee_negotiate_output (tee,
+            g_ptr_array_index (tee->outputs, i));
+      res = gst_video_scale_tee_setup (tee);
+      break;
+    }
+    case GST_EVENT_SEGMENT:
+      /* outputs without caps get the segment after their caps, with the
+       * other sticky events when they are negotiated */
+      for (i = 0; i < tee->outputs->len; i++) {
+        GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+
+        if (out->negotiated)
+          gst_pad_push_event (out->pad, gst_event_ref (event));
+      }
+      gst_event_unref (event);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_flow_combiner_reset (tee->flow_combiner);
+      res = gst_pad_event_default (pad, parent, event);
+      break;
+    default:
+      res = gst_pad_event_default (pad, parent, event);
+      break;
+  }
+  return res;
+}
+
+static gboolean
+gst_video_scale_tee_sink_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (parent);
+  gboolean res;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps;
+      GList *pads, *l;
+
+      gst_query_parse_caps (query, &filter);
+
+      GST_OBJECT_LOCK (tee);
+      pads = g_list_copy_deep (GST_ELEMENT_CAST (tee)->srcpads,
+          (GCopyFunc) gst_object_ref, NULL);
+      GST_OBJECT_UNLOCK (tee);
+
+      /* the formats that all downstream elements accept, in any size */
+      caps = gst_pad_get_pad_template_caps (pad);
+      for (l = pads; l && !gst_caps_is_empty (caps); l = l->next) {
+        GstCaps *peercaps, *tmp;
+
+        peercaps = gst_pad_peer_query_caps (l->data, NULL);
+        tmp = gst_video_scale_tee_free_size (peercaps);
+        gst_caps_unref (peercaps);
+        peercaps = gst_caps_intersect (caps, tmp);
+        gst_caps_unref (tmp);
+        gst_caps_unref (caps);
+        caps = peercaps;
+      }
+      g_list_free_full (pads, gst_object_unref);
+
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      res = TRUE;
+      break;
+    }
+    case GST_QUERY_ALLOCATION:
+      /* the outputs are allocated here, the input only needs to be mapped */
+      gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+      res = TRUE;
+      break;
+    default:
+      res = gst_pad_query_default (pad, parent, query);
+      break;
+  }
+  return res;
+}
+
+static gboolean
+gst_video_scale_tee_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (parent);
+  gboolean res;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *peercaps, *caps;
+
+      gst_query_parse_caps (query, &filter);
+
+      /* the formats of upstream in any size */
+      peercaps = gst_pad_peer_query_caps (tee->sinkpad, NULL);
+      caps = gst_video_scale_tee_free_size (peercaps);
+      gst_caps_unref (peercaps);
+
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      res = TRUE;
+      break;
+    }
+    default:
+      res = gst_pad_query_default (pad, parent, query);
+      break;
+  }
+  return res;
+}
+
+static GstPad *
+gst_video_scale_tee_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (element);
+  GstVideoScaleTeeOutput *out;
+  GstPad *pad;
+  gchar *pad_name;
+
+  GST_PAD_STREAM_LOCK (tee->sinkpad);
+  if (name)
+    pad_name = g_strdup (name);
+  else
+    pad_name = g_strdup_printf ("src_%u", tee->next_pad++);
+
+  pad = gst_pad_new_from_template (templ, pad_name);
+  g_free (pad_name);
+  gst_pad_set_query_function (pad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_tee_src_query));
+
+  out = g_slice_new0 (GstVideoScaleTeeOutput);
+  out->pad = pad;
+  out->need_negotiate = TRUE;
+  out->source = -1;
+  gst_pad_set_element_private (pad, out);
+
+  /* the caps are negotiated with the next buffer, once the pad is linked */
+  gst_pad_set_active (pad, TRUE);
+  if (!gst_element_add_pad (element, pad)) {
+    GST_PAD_STREAM_UNLOCK (tee->sinkpad);
+    gst_pad_set_active (pad, FALSE);
+    gst_object_unref (pad);
+    g_slice_free (GstVideoScaleTeeOutput, out);
+    return NULL;
+  }
+  gst_flow_combiner_add_pad (tee->flow_combiner, pad);
+  g_ptr_array_add (tee->outputs, out);
+  GST_PAD_STREAM_UNLOCK (tee->sinkpad);
+
+  return pad;
+}
+
+static void
+gst_video_scale_tee_release_pad (GstElement * element, GstPad * pad)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (element);
+  GstVideoScaleTeeOutput *out = gst_pad_get_element_private (pad);
+
+  GST_PAD_STREAM_LOCK (tee->sinkpad);
+  g_ptr_array_remove (tee->outputs, out);
+  gst_flow_combiner_remove_pad (tee->flow_combiner, pad);
+  if (out->convert)
+    gst_video_converter_free (out->convert);
+  g_slice_free (GstVideoScaleTeeOutput, out);
+  gst_pad_set_element_private (pad, NULL);
+
+  /* the other outputs can't be made from this one anymore */
+  if (tee->have_info)
+    gst_video_scale_tee_setup (tee);
+  GST_PAD_STREAM_UNLOCK (tee->sinkpad);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (element, pad);
+}
+
+static GstStateChangeReturn
+gst_video_scale_tee_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstVideoScaleTee *tee = GST_VIDEO_SCALE_TEE (element);
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+    {
+      guint i;
+
+      GST_PAD_STREAM_LOCK (tee->sinkpad);
+      tee->have_info = FALSE;
+      for (i = 0; i < tee->outputs->len; i++) {
+        GstVideoScaleTeeOutput *out = g_ptr_array_index (tee->outputs, i);
+
+        out->negotiated = FALSE;
+        out->need_negotiate = TRUE;
+        if (out->convert) {
+          gst_video_converter_free (out->convert);
+          out->convert = NULL;
+        }
+      }
+      gst_flow_combiner_reset (tee->flow_combiner);
+      GST_PAD_STREAM_UNLOCK (tee->sinkpad);
+      break;
+    }
+    default:
+      break;
+  }
+
+  return ret;
+}
@@ -0,0 +1,75 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_SCALE_TEE_H__
+#define __GST_VIDEO_SCALE_TEE_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstflowcombiner.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_VIDEO_SCALE_TEE \
+  (gst_video_scale_tee_get_type())
+#define GST_VIDEO_SCALE_TEE(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_VIDEO_SCALE_TEE,GstVideoScaleTee))
+#define GST_VIDEO_SCALE_TEE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_VIDEO_SCALE_TEE,GstVideoScaleTeeClass))
+#define GST_IS_VIDEO_SCALE_TEE(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_VIDEO_SCALE_TEE))
+#define GST_IS_VIDEO_SCALE_TEE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_VIDEO_SCALE_TEE))
+#define GST_VIDEO_SCALE_TEE_CAST(obj)       ((GstVideoScaleTee *)(obj))
+
+typedef struct _GstVideoScaleTee GstVideoScaleTee;
+typedef struct _GstVideoScaleTeeClass GstVideoScaleTeeClass;
+
+/**
+ * GstVideoScaleTee:
+ *
+ * Opaque data structure
+ */
+struct _GstVideoScaleTee {
+  GstElement element;
+
+  GstPad *sinkpad;
+
+  /* with the STREAM_LOCK of sinkpad */
+  GstVideoInfo in_info;
+  gboolean have_info;
+  GPtrArray *outputs;           /* sorted by size, the largest first */
+  GstFlowCombiner *flow_combiner;
+  guint next_pad;
+
+  /* properties, with the OBJECT_LOCK */
+  GstVideoResamplerMethod method;
+  gboolean cascade;
+  guint n_threads;
+};
+
+struct _GstVideoScaleTeeClass {
+  GstElementClass parent_class;
+};
+
+GType gst_video_scale_tee_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_SCALE_TEE_H__ */
@@ -503,12 +503,55 @@ gst_video_test_src_set_pattern (GstVideoTestSrc * videotestsrc,
   }
 }
 
+/* patterns that look the same in every frame, we paint those once */
+static gboolean
+gst_video_test_src_is_static (GstVideoTestSrc * src)
+{
+  if (src->horizontal_speed != 0)
+    return FALSE;
+
+  switch (src->pattern_type) {
+    case GST_VIDEO_TEST_SRC_SMPTE:
+    case GST_VIDEO_TEST_SRC_SNOW:
+    case GST_VIDEO_TEST_SRC_BLINK:
+    case GST_VIDEO_TEST_SRC_BALL:
+      return FALSE;
+    case GST_VIDEO_TEST_SRC_ZONE_PLATE:
+    case GST_VIDEO_TEST_SRC_CHROMA_ZONE_PLATE:
+      return src->kt == 0 && src->kxt == 0 && src->kyt == 0 && src->kt2 == 0;
+    case GST_VIDEO_TEST_SRC_PINWHEEL:
+    case GST_VIDEO_TEST_SRC_SPOKES:
+      return src->kt == 0;
+    default:
+      return TRUE;
+  }
+}
+
+static void
+gst_video_test_src_clear_cache (GstVideoTestSrc * src)
+{
+  GstBuffer *cache;
+
+  GST_OBJECT_LOCK (src);
+  cache = src->cache;
+  src->cache = NULL;
+  GST_OBJECT_UNLOCK (src);
+
+  if (cache)
+    gst_buffer_unref (cache);
+}
+
 static void
 gst_video_test_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
   GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (object);
 
+  /* all properties except the timestamp offset and is-live change the
+   * image, this is also how the controller updates them */
+  if (prop_id != PROP_TIMESTAMP_OFFSET && prop_id != PROP_IS_LIVE)
+    gst_video_test_src_clear_cache (src);
+
   switch (prop_id) {
     case PROP_PATTERN:
       gst_video_test_src_set_pattern (src, g_value_get_enum (value));
@@ -834,6 +877,8 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
   videotestsrc->running_time = 0;
   videotestsrc->n_frames = 0;
 
+  gst_video_test_src_clear_cache (videotestsrc);
+
   return TRUE;
 
   /* ERRORS */
@@ -983,12 +1028,36 @@ gst_video_test_src_is_seekable (GstBaseSrc * psrc)
   return TRUE;
 }
 
+/* keep a copy of a static image for the next frames */
+static void
+gst_video_test_src_cache_image (GstVideoTestSrc * src, GstVideoFrame * frame)
+{
+  GstVideoFrame cframe;
+  GstBuffer *cache;
+
+  cache = gst_buffer_new_allocate (NULL, src->info.size, NULL);
+  if (!gst_video_frame_map (&cframe, &src->info, cache, GST_MAP_WRITE)) {
+    gst_buffer_unref (cache);
+    return;
+  }
+  gst_video_frame_copy (&cframe, frame);
+  gst_video_frame_unmap (&cframe);
+
+  GST_DEBUG_OBJECT (src, "caching the static image");
+
+  GST_OBJECT_LOCK (src);
+  gst_buffer_replace (&src->cache, cache);
+  GST_OBJECT_UNLOCK (src);
+  gst_buffer_unref (cache);
+}
+
 static GstFlowReturn
 gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
 {
   GstVideoTestSrc *src;
   GstClockTime next_time;
-  GstVideoFrame frame;
+  GstVideoFrame frame, cframe;
+  GstBuffer *cache;
   gconstpointer pal;
   gsize palsize;
 
@@ -1019,12 +1088,27 @@ gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
 
   gst_object_sync_values (GST_OBJECT (psrc), GST_BUFFER_PTS (buffer));
 
-  src->make_image (src, &frame);
+  GST_OBJECT_LOCK (src);
+  cache = src->cache ? gst_buffer_ref (src->cache) : NULL;
+  GST_OBJECT_UNLOCK (src);
 
-  if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
-              &palsize))) {
-    memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
+  if (cache && gst_video_frame_map (&cframe, &src->info, cache, GST_MAP_READ)) {
+    GST_LOG_OBJECT (src, "copying the cached image");
+    gst_video_frame_copy (&frame, &cframe);
+    gst_video_frame_unmap (&cframe);
+  } else {
+    src->make_image (src, &frame);
+
+    if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
+                &palsize))) {
+      memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
+    }
+
+    if (!cache && gst_video_test_src_is_static (src))
+      gst_video_test_src_cache_image (src, &frame);
   }
+  if (cache)
+    gst_buffer_unref (cache);
 
   gst_video_frame_unmap (&frame);
 
@@ -1114,6 +1198,8 @@ gst_video_test_src_stop (GstBaseSrc * basesrc)
   src->n_lines = 0;
   src->lines = NULL;
 
+  gst_video_test_src_clear_cache (src);
+
   return TRUE;
 }
 
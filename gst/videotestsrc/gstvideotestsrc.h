@@ -185,6 +185,10 @@ struct _GstVideoTestSrc {
   guint n_lines;
   gint offset;
   gpointer *lines;
+
+  /* copy of the last image of a static pattern, protected by the
+   * object lock */
+  GstBuffer *cache;
 };
 
 struct _GstVideoTestSrcClass {
@@ -0,0 +1,94 @@
+/* GStreamer
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "gst/gst-cpu-x86-private.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (GST_CPU_X86_HAVE_TARGET)
+#define HAVE_AVX2_TARGET
+
+#pragma GCC push_options
+#pragma GCC target ("avx2")
+#include <immintrin.h>
+
+static void
+volume_gain_f64_avx2 (gpointer data, gconstpointer gains, guint count)
+{
+  gdouble *d = data;
+  const gdouble *g = gains;
+  guint i;
+
+  for (i = 0; i + 4 <= count; i += 4) {
+    __m256d s = _mm256_loadu_pd (d + i);
+    _mm256_storeu_pd (d + i, _mm256_mul_pd (s, _mm256_loadu_pd (g + i)));
+  }
+  volume_gain_f64_c (d + i, g + i, count - i);
+}
+
+static void
+volume_gain_f32_avx2 (gpointer data, gconstpointer gains, guint count)
+{
+  gfloat *d = data;
+  const gfloat *g = gains;
+  guint i;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    __m256 s = _mm256_loadu_ps (d + i);
+    _mm256_storeu_ps (d + i, _mm256_mul_ps (s, _mm256_loadu_ps (g + i)));
+  }
+  volume_gain_f32_c (d + i, g + i, count - i);
+}
+
+/* 16 samples, the 32 bits products are shifted down and packed again
+ * with saturation, like the orc clamp functions */
+static void
+volume_gain_s16_avx2 (gpointer data, gconstpointer gains, guint count)
+{
+  gint16 *d = data;
+  const gint16 *g = gains;
+  guint i;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i s = _mm256_loadu_si256 ((const __m256i *) (d + i));
+    __m256i t = _mm256_loadu_si256 ((const __m256i *) (g + i));
+    __m256i lo = _mm256_mullo_epi16 (s, t);
+    __m256i hi = _mm256_mulhi_epi16 (s, t);
+    __m256i p0 = _mm256_srai_epi32 (_mm256_unpacklo_epi16 (lo, hi),
+        VOLUME_UNITY_INT16_BIT_SHIFT);
+    __m256i p1 = _mm256_srai_epi32 (_mm256_unpackhi_epi16 (lo, hi),
+        VOLUME_UNITY_INT16_BIT_SHIFT);
+    _mm256_storeu_si256 ((__m256i *) (d + i), _mm256_packs_epi32 (p0, p1));
+  }
+  volume_gain_s16_c (d + i, g + i, count - i);
+}
+
+#pragma GCC pop_options
+#endif /* HAVE_IMMINTRIN_H */
+
+static void
+volume_check_x86_cpu (void)
+{
+#if defined (HAVE_AVX2_TARGET)
+  if (gst_cpu_x86_get_flags () & GST_CPU_X86_AVX2) {
+    GST_DEBUG ("enable AVX2 optimisations");
+    volume_gain_f64 = volume_gain_f64_avx2;
+    volume_gain_f32 = volume_gain_f32_avx2;
+    volume_gain_s16 = volume_gain_s16_avx2;
+  }
+#endif
+}
@@ -34,9 +34,16 @@
  * ]| This pipeline shows that the level of audiotestsrc has been halved
  * (peak values are around -6 dB and RMS around -9 dB) compared to
  * the same pipeline without the volume element.
+ * |[
+ * gst-launch-1.0 -v audiotestsrc ! audio/x-raw,channels=2 ! volume channel-volumes="< 1.0, 0.5 >" ! autoaudiosink
+ * ]| This pipeline plays the right channel at half the volume of the left one.
  * </refsect2>
  */
 
+/* FIXME 2.0: suppress warnings for deprecated API such as GValueArray
+ * with newer GLib versions (>= 2.31.0) */
+#define GLIB_DISABLE_DEPRECATION_WARNINGS
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -78,6 +85,9 @@
 #define VOLUME_MAX_INT32             G_MAXINT32
 #define VOLUME_MIN_INT32             G_MININT32
 
+/* number of frames in the gain pattern used for per channel volumes */
+#define VOLUME_GAIN_FRAMES           64
+
 #define GST_CAT_DEFAULT gst_volume_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
@@ -95,7 +105,8 @@ enum
 {
   PROP_0,
   PROP_MUTE,
-  PROP_VOLUME
+  PROP_VOLUME,
+  PROP_CHANNEL_VOLUMES
 };
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
@@ -159,6 +170,111 @@ static void volume_process_int8_clamp (GstVolume * self, gpointer bytes,
 static void volume_process_controlled_int8_clamp (GstVolume * self,
     gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
 
+static void volume_process_gains_double (GstVolume * self, gpointer bytes,
+    guint n_bytes);
+static void volume_process_gains_float (GstVolume * self, gpointer bytes,
+    guint n_bytes);
+static void volume_process_gains_int32 (GstVolume * self, gpointer bytes,
+    guint n_bytes);
+static void volume_process_gains_int24 (GstVolume * self, gpointer bytes,
+    guint n_bytes);
+static void volume_process_gains_int16 (GstVolume * self, gpointer bytes,
+    guint n_bytes);
+static void volume_process_gains_int8 (GstVolume * self, gpointer bytes,
+    guint n_bytes);
+static void volume_process_controlled_gains_double (GstVolume * self,
+    gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
+static void volume_process_controlled_gains_float (GstVolume * self,
+    gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
+static void volume_process_controlled_gains_int32 (GstVolume * self,
+    gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
+static void volume_process_controlled_gains_int24 (GstVolume * self,
+    gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
+static void volume_process_controlled_gains_int16 (GstVolume * self,
+    gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
+static void volume_process_controlled_gains_int8 (GstVolume * self,
+    gpointer bytes, gdouble * volume, guint channels, guint n_bytes);
+
+/* multiply @count samples in @data with the gains in @gains, used for
+ * per channel volumes */
+typedef void (*VolumeGainFunc) (gpointer data, gconstpointer gains,
+    guint count);
+
+static void
+volume_gain_f64_c (gpointer data, gconstpointer gains, guint count)
+{
+  gdouble *d = data;
+  const gdouble *g = gains;
+  guint i;
+
+  for (i = 0; i < count; i++)
+    d[i] *= g[i];
+}
+
+static void
+volume_gain_f32_c (gpointer data, gconstpointer gains, guint count)
+{
+  gfloat *d = data;
+  const gfloat *g = gains;
+  guint i;
+
+  for (i = 0; i < count; i++)
+    d[i] *= g[i];
+}
+
+static void
+volume_gain_s32_c (gpointer data, gconstpointer gains, guint count)
+{
+  gint32 *d = data;
+  const gint32 *g = gains;
+  guint i;
+  gint64 val;
+
+  for (i = 0; i < count; i++) {
+    val = ((gint64) d[i] * g[i]) >> VOLUME_UNITY_INT32_BIT_SHIFT;
+    d[i] = (gint32) CLAMP (val, VOLUME_MIN_INT32, VOLUME_MAX_INT32);
+  }
+}
+
+static void
+volume_gain_s16_c (gpointer data, gconstpointer gains, guint count)
+{
+  gint16 *d = data;
+  const gint16 *g = gains;
+  guint i;
+  gint32 val;
+
+  for (i = 0; i < count; i++) {
+    val = ((gint32) d[i] * g[i]) >> VOLUME_UNITY_INT16_BIT_SHIFT;
+    d[i] = (gint16) CLAMP (val, VOLUME_MIN_INT16, VOLUME_MAX_INT16);
+  }
+}
+
+static void
+volume_gain_s8_c (gpointer data, gconstpointer gains, guint count)
+{
+  gint8 *d = data;
+  const gint16 *g = gains;
+  guint i;
+  gint32 val;
+
+  for (i = 0; i < count; i++) {
+    val = ((gint32) d[i] * g[i]) >> VOLUME_UNITY_INT8_BIT_SHIFT;
+    d[i] = (gint8) CLAMP (val, VOLUME_MIN_INT8, VOLUME_MAX_INT8);
+  }
+}
+
+static VolumeGainFunc volume_gain_f64 = volume_gain_f64_c;
+static VolumeGainFunc volume_gain_f32 = volume_gain_f32_c;
+static VolumeGainFunc volume_gain_s32 = volume_gain_s32_c;
+static VolumeGainFunc volume_gain_s16 = volume_gain_s16_c;
+static VolumeGainFunc volume_gain_s8 = volume_gain_s8_c;
+
+#if defined (__i386__) || defined (__x86_64__)
+#define CHECK_X86
+#include "gstvolume-x86.h"
+#endif
+
 
 /* helper functions */
 
@@ -175,6 +291,38 @@ volume_choose_func (GstVolume * self, const GstAudioInfo * info)
   if (format == GST_AUDIO_FORMAT_UNKNOWN)
     return FALSE;
 
+  if (self->current_channel_volumes) {
+    switch (format) {
+      case GST_AUDIO_FORMAT_S32:
+        self->process = volume_process_gains_int32;
+        self->process_controlled = volume_process_controlled_gains_int32;
+        break;
+      case GST_AUDIO_FORMAT_S24:
+        self->process = volume_process_gains_int24;
+        self->process_controlled = volume_process_controlled_gains_int24;
+        break;
+      case GST_AUDIO_FORMAT_S16:
+        self->process = volume_process_gains_int16;
+        self->process_controlled = volume_process_controlled_gains_int16;
+        break;
+      case GST_AUDIO_FORMAT_S8:
+        self->process = volume_process_gains_int8;
+        self->process_controlled = volume_process_controlled_gains_int8;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        self->process = volume_process_gains_float;
+        self->process_controlled = volume_process_controlled_gains_float;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        self->process = volume_process_gains_double;
+        self->process_controlled = volume_process_controlled_gains_double;
+        break;
+      default:
+        break;
+    }
+    return (self->process != NULL);
+  }
+
   switch (format) {
     case GST_AUDIO_FORMAT_S32:
       /* only clamp if the gain is greater than 1.0 */
@@ -227,6 +375,85 @@ volume_choose_func (GstVolume * self, const GstAudioInfo * info)
   return (self->process != NULL);
 }
 
+/* Collect the per channel gains and, when they are not all unity, fill
+ * the gain pattern with the combined gain of each sample position. For
+ * interleaved audio the pattern holds VOLUME_GAIN_FRAMES frames, for
+ * non-interleaved audio VOLUME_GAIN_FRAMES samples of each channel one
+ * after the other. */
+static void
+volume_update_gains (GstVolume * self, const GstAudioInfo * info,
+    gfloat volume, gboolean mute)
+{
+  guint i, j, channels, len;
+  gboolean planar, have_gains = FALSE;
+
+  channels = GST_AUDIO_INFO_CHANNELS (info);
+  planar = GST_AUDIO_INFO_LAYOUT (info) == GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+
+  self->current_channel_volumes = FALSE;
+  if (mute || channels == 0)
+    return;
+
+  self->current_gains = g_renew (gdouble, self->current_gains, channels);
+
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < channels; i++) {
+    if (i < self->n_channel_volumes)
+      self->current_gains[i] = self->channel_volumes[i];
+    else
+      self->current_gains[i] = 1.0;
+    if (self->current_gains[i] != 1.0)
+      have_gains = TRUE;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (!have_gains)
+    return;
+
+  GST_DEBUG_OBJECT (self, "using per channel volumes");
+
+  len = channels * VOLUME_GAIN_FRAMES;
+  self->gain_pattern = g_realloc (self->gain_pattern, len * sizeof (gdouble));
+  self->gain_pattern_len = len;
+
+  for (i = 0; i < channels; i++) {
+    /* keep the combined gain in the range of the integer patterns */
+    gdouble gain = MIN (volume * self->current_gains[i], VOLUME_MAX_DOUBLE);
+
+    for (j = 0; j < VOLUME_GAIN_FRAMES; j++) {
+      guint idx = planar ? i * VOLUME_GAIN_FRAMES + j : j * channels + i;
+
+      switch (GST_AUDIO_INFO_FORMAT (info)) {
+        case GST_AUDIO_FORMAT_S32:
+          ((gint32 *) self->gain_pattern)[idx] =
+              (gint32) (gain * (gdouble) VOLUME_UNITY_INT32);
+          break;
+        case GST_AUDIO_FORMAT_S24:
+          ((gint32 *) self->gain_pattern)[idx] =
+              (gint32) (gain * (gdouble) VOLUME_UNITY_INT24);
+          break;
+        case GST_AUDIO_FORMAT_S16:
+          ((gint16 *) self->gain_pattern)[idx] =
+              (gint16) (gain * (gdouble) VOLUME_UNITY_INT16);
+          break;
+        case GST_AUDIO_FORMAT_S8:
+          ((gint16 *) self->gain_pattern)[idx] =
+              (gint16) (gain * (gdouble) VOLUME_UNITY_INT8);
+          break;
+        case GST_AUDIO_FORMAT_F32:
+          ((gfloat *) self->gain_pattern)[idx] = gain;
+          break;
+        case GST_AUDIO_FORMAT_F64:
+          ((gdouble *) self->gain_pattern)[idx] = gain;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  self->current_channel_volumes = TRUE;
+}
+
 static gboolean
 volume_update_volume (GstVolume * self, const GstAudioInfo * info,
     gfloat volume, gboolean mute)
@@ -262,6 +489,9 @@ volume_update_volume (GstVolume * self, const GstAudioInfo * info,
     passthrough = (self->current_vol_i16 == VOLUME_UNITY_INT16);
   }
 
+  volume_update_gains (self, info, volume, mute);
+  passthrough &= !self->current_channel_volumes;
+
   /* If a controller is used, never use passthrough mode
    * because the property can change from 1.0 to something
    * else in the middle of a buffer.
@@ -291,6 +521,14 @@ gst_volume_dispose (GObject * object)
     volume->tracklist = NULL;
   }
 
+  g_free (volume->channel_volumes);
+  volume->channel_volumes = NULL;
+  volume->n_channel_volumes = 0;
+  g_free (volume->current_gains);
+  volume->current_gains = NULL;
+  g_free (volume->gain_pattern);
+  volume->gain_pattern = NULL;
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -322,6 +560,23 @@ gst_volume_class_init (GstVolumeClass * klass)
           0.0, VOLUME_MAX_DOUBLE, DEFAULT_PROP_VOLUME,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVolume:channel-volumes:
+   *
+   * Volume factor of each channel, applied on top of the volume property.
+   * Channels without an entry in the array keep unity gain. The combined
+   * gain of a channel is limited to 10.0.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CHANNEL_VOLUMES,
+      g_param_spec_value_array ("channel-volumes", "Channel Volumes",
+          "Volume factor of each channel, 1.0=100%",
+          g_param_spec_double ("channel-volume", "Channel Volume",
+              "volume factor of a channel, 1.0=100%", 0.0, VOLUME_MAX_DOUBLE,
+              DEFAULT_PROP_VOLUME, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class, "Volume",
       "Filter/Effect/Audio",
       "Set volume on audio/raw streams", "Andy Wingo <wingo@pobox.com>");
@@ -336,6 +591,10 @@ gst_volume_class_init (GstVolumeClass * klass)
   trans_class->transform_ip_on_passthrough = FALSE;
 
   filter_class->setup = GST_DEBUG_FUNCPTR (volume_setup);
+
+#ifdef CHECK_X86
+  volume_check_x86_cpu ();
+#endif
 }
 
 static void
@@ -638,6 +897,177 @@ volume_process_controlled_int8_clamp (GstVolume * self, gpointer bytes,
   }
 }
 
+static void
+volume_apply_gains (GstVolume * self, gpointer bytes, guint n_samples,
+    guint bps, VolumeGainFunc func)
+{
+  GstAudioInfo *info = GST_AUDIO_FILTER_INFO (self);
+  guint8 *data = (guint8 *) bytes;
+  const guint8 *gains = self->gain_pattern;
+  guint i, c, n, len = self->gain_pattern_len;
+
+  if (GST_AUDIO_INFO_LAYOUT (info) == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    guint channels = GST_AUDIO_INFO_CHANNELS (info);
+    guint plane = n_samples / channels;
+
+    for (c = 0; c < channels; c++) {
+      const guint8 *g = gains + c * VOLUME_GAIN_FRAMES * bps;
+
+      for (i = 0; i < plane; i += n) {
+        n = MIN (VOLUME_GAIN_FRAMES, plane - i);
+        func (data + (c * plane + i) * bps, g, n);
+      }
+    }
+  } else {
+    for (i = 0; i < n_samples; i += n) {
+      n = MIN (len, n_samples - i);
+      func (data + i * bps, gains, n);
+    }
+  }
+}
+
+static void
+volume_process_gains_double (GstVolume * self, gpointer bytes, guint n_bytes)
+{
+  volume_apply_gains (self, bytes, n_bytes / sizeof (gdouble),
+      sizeof (gdouble), volume_gain_f64);
+}
+
+static void
+volume_process_gains_float (GstVolume * self, gpointer bytes, guint n_bytes)
+{
+  volume_apply_gains (self, bytes, n_bytes / sizeof (gfloat),
+      sizeof (gfloat), volume_gain_f32);
+}
+
+static void
+volume_process_gains_int32 (GstVolume * self, gpointer bytes, guint n_bytes)
+{
+  volume_apply_gains (self, bytes, n_bytes / sizeof (gint32),
+      sizeof (gint32), volume_gain_s32);
+}
+
+static void
+volume_process_gains_int16 (GstVolume * self, gpointer bytes, guint n_bytes)
+{
+  volume_apply_gains (self, bytes, n_bytes / sizeof (gint16),
+      sizeof (gint16), volume_gain_s16);
+}
+
+static void
+volume_process_gains_int8 (GstVolume * self, gpointer bytes, guint n_bytes)
+{
+  volume_apply_gains (self, bytes, n_bytes / sizeof (gint8),
+      sizeof (gint8), volume_gain_s8);
+}
+
+/* packed 24 bits samples are done one by one, the gain of sample i of
+ * a channel is the same in the pattern for both layouts */
+static void
+volume_process_gains_int24 (GstVolume * self, gpointer bytes, guint n_bytes)
+{
+  GstAudioInfo *info = GST_AUDIO_FILTER_INFO (self);
+  gint8 *data = (gint8 *) bytes;
+  const gint32 *gains = self->gain_pattern;
+  guint i, j, channels, num_samples;
+  guint32 samp;
+  gint64 val;
+
+  channels = GST_AUDIO_INFO_CHANNELS (info);
+  num_samples = n_bytes / (sizeof (gint8) * 3 * channels);
+
+  if (GST_AUDIO_INFO_LAYOUT (info) == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    for (j = 0; j < channels; j++) {
+      gint32 gain = gains[j * VOLUME_GAIN_FRAMES];
+
+      for (i = 0; i < num_samples; i++) {
+        samp = get_unaligned_i24 (data);
+        val = ((gint64) gain * (gint32) samp) >> VOLUME_UNITY_INT24_BIT_SHIFT;
+        samp = (guint32) CLAMP (val, VOLUME_MIN_INT24, VOLUME_MAX_INT24);
+        write_unaligned_u24 (data, samp);
+      }
+    }
+  } else {
+    for (i = 0; i < num_samples; i++) {
+      for (j = 0; j < channels; j++) {
+        samp = get_unaligned_i24 (data);
+        val = ((gint64) gains[j] * (gint32) samp) >>
+            VOLUME_UNITY_INT24_BIT_SHIFT;
+        samp = (guint32) CLAMP (val, VOLUME_MIN_INT24, VOLUME_MAX_INT24);
+        write_unaligned_u24 (data, samp);
+      }
+    }
+  }
+}
+
+/* with a control source the volume changes every frame, combine it with
+ * the channel gains in double precision */
+#define DEFINE_PROCESS_CONTROLLED_GAINS(name,type,min,max)                  \
+static void                                                                 \
+volume_process_controlled_gains_##name (GstVolume * self, gpointer bytes,   \
+    gdouble * volume, guint channels, guint n_bytes)                        \
+{                                                                           \
+  type *data = (type *) bytes;                                              \
+  guint i, j, sstride, cstride;                                             \
+  guint num_samples = n_bytes / (sizeof (type) * channels);                 \
+  gdouble val;                                                              \
+                                                                            \
+  if (GST_AUDIO_INFO_LAYOUT (GST_AUDIO_FILTER_INFO (self)) ==               \
+      GST_AUDIO_LAYOUT_NON_INTERLEAVED) {                                   \
+    sstride = 1;                                                            \
+    cstride = num_samples;                                                  \
+  } else {                                                                  \
+    sstride = channels;                                                     \
+    cstride = 1;                                                            \
+  }                                                                         \
+  for (i = 0; i < num_samples; i++) {                                       \
+    for (j = 0; j < channels; j++) {                                        \
+      type *d = &data[i * sstride + j * cstride];                           \
+                                                                            \
+      val = *d * volume[i] * self->current_gains[j];                        \
+      *d = (type) CLAMP (val, min, max);                                    \
+    }                                                                       \
+  }                                                                         \
+}
+
+DEFINE_PROCESS_CONTROLLED_GAINS (double, gdouble, -G_MAXDOUBLE, G_MAXDOUBLE);
+DEFINE_PROCESS_CONTROLLED_GAINS (float, gfloat, -G_MAXFLOAT, G_MAXFLOAT);
+DEFINE_PROCESS_CONTROLLED_GAINS (int32, gint32, VOLUME_MIN_INT32,
+    VOLUME_MAX_INT32);
+DEFINE_PROCESS_CONTROLLED_GAINS (int16, gint16, VOLUME_MIN_INT16,
+    VOLUME_MAX_INT16);
+DEFINE_PROCESS_CONTROLLED_GAINS (int8, gint8, VOLUME_MIN_INT8,
+    VOLUME_MAX_INT8);
+
+static void
+volume_process_controlled_gains_int24 (GstVolume * self, gpointer bytes,
+    gdouble * volume, guint channels, guint n_bytes)
+{
+  gint8 *data = (gint8 *) bytes;        /* treat the data as a byte stream */
+  guint i, j;
+  guint num_samples = n_bytes / (sizeof (gint8) * 3 * channels);
+  gdouble val;
+
+  if (GST_AUDIO_INFO_LAYOUT (GST_AUDIO_FILTER_INFO (self)) ==
+      GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    for (j = 0; j < channels; j++) {
+      for (i = 0; i < num_samples; i++) {
+        val = get_unaligned_i24 (data) * volume[i] * self->current_gains[j];
+        val = CLAMP (val, VOLUME_MIN_INT24, VOLUME_MAX_INT24);
+        write_unaligned_u24 (data, (gint32) val);
+      }
+    }
+  } else {
+    for (i = 0; i < num_samples; i++) {
+      for (j = 0; j < channels; j++) {
+        val = get_unaligned_i24 (data) * volume[i] * self->current_gains[j];
+        val = CLAMP (val, VOLUME_MIN_INT24, VOLUME_MAX_INT24);
+        write_unaligned_u24 (data, (gint32) val);
+      }
+    }
+  }
+}
+
 /* GstBaseTransform vmethod implementations */
 
 /* get notified of caps and plug in the correct process function */
@@ -705,9 +1135,11 @@ volume_before_transform (GstBaseTransform * base, GstBuffer * buffer)
   mute = self->mute;
   GST_OBJECT_UNLOCK (self);
 
-  if ((volume != self->current_volume) || (mute != self->current_mute)) {
+  if ((volume != self->current_volume) || (mute != self->current_mute) ||
+      self->channel_volumes_changed) {
     /* the volume or mute was updated, update our internal state before
      * we continue processing. */
+    self->channel_volumes_changed = FALSE;
     volume_update_volume (self, GST_AUDIO_FILTER_INFO (self), volume, mute);
   }
 }
@@ -795,7 +1227,7 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
   if (self->current_volume == 0.0 || self->current_mute) {
     orc_memset (map.data, 0, map.size);
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
-  } else if (self->current_volume != 1.0) {
+  } else if (self->current_volume != 1.0 || self->current_channel_volumes) {
     self->process (self, map.data, map.size);
   }
 
@@ -830,6 +1262,25 @@ volume_set_property (GObject * object, guint prop_id, const GValue * value,
       self->volume = g_value_get_double (value);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_CHANNEL_VOLUMES:
+    {
+      GValueArray *array = g_value_get_boxed (value);
+      guint i;
+
+      GST_OBJECT_LOCK (self);
+      g_free (self->channel_volumes);
+      self->channel_volumes = NULL;
+      self->n_channel_volumes = 0;
+      if (array && array->n_values > 0) {
+        self->channel_volumes = g_new (gdouble, array->n_values);
+        self->n_channel_volumes = array->n_values;
+        for (i = 0; i < array->n_values; i++)
+          self->channel_volumes[i] = g_value_get_double (&array->values[i]);
+      }
+      self->channel_volumes_changed = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -853,6 +1304,26 @@ volume_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_double (value, self->volume);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_CHANNEL_VOLUMES:
+    {
+      GValueArray *array;
+      guint i;
+
+      GST_OBJECT_LOCK (self);
+      array = g_value_array_new (self->n_channel_volumes);
+      for (i = 0; i < self->n_channel_volumes; i++) {
+        GValue v = { 0, };
+
+        g_value_init (&v, G_TYPE_DOUBLE);
+        g_value_set_double (&v, self->channel_volumes[i]);
+        g_value_array_append (array, &v);
+        g_value_unset (&v);
+      }
+      GST_OBJECT_UNLOCK (self);
+
+      g_value_take_boxed (value, array);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -75,6 +75,19 @@ struct _GstVolume {
   guint mutes_count;
   gdouble *volumes;
   guint volumes_count;
+
+  /* per channel gains from the channel-volumes property */
+  gdouble *channel_volumes;
+  guint n_channel_volumes;
+  gboolean channel_volumes_changed;
+
+  /* the current gain of each channel without the global volume, and the
+   * combined gains repeated in the sample format of the stream so they
+   * can be applied to the samples with one multiply each */
+  gboolean current_channel_volumes;
+  gdouble *current_gains;
+  gpointer gain_pattern;
+  guint gain_pattern_len;
 };
 
 struct _GstVolumeClass {
@@ -118,6 +118,12 @@
 /* for XkbKeycodeToKeysym */
 #include <X11/XKBlib.h>
 
+#ifdef HAVE_X_DRI3
+#include <gst/allocators/gstdmabuf.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
 GST_DEBUG_CATEGORY_EXTERN (gst_debug_x_image_sink);
 GST_DEBUG_CATEGORY_EXTERN (CAT_PERFORMANCE);
 #define GST_CAT_DEFAULT gst_debug_x_image_sink
@@ -226,16 +232,403 @@ gst_x_image_sink_xwindow_draw_borders (GstXImageSink * ximagesink,
   }
 }
 
-/* This function puts a GstXImageBuffer on a GstXImageSink's window */
+#ifdef HAVE_X_DRI3
+/* a pixmap presented with DRI3 and the buffer it was imported from, both
+ * are kept until the X server sends an IdleNotify for the pixmap */
+typedef struct
+{
+  guint32 serial;
+  xcb_pixmap_t pixmap;
+  GstBuffer *buffer;
+} GstXImagePresent;
+
 static gboolean
-gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
+gst_x_image_sink_check_dri3 (xcb_connection_t * xcb)
+{
+  const xcb_query_extension_reply_t *ext;
+  xcb_dri3_query_version_reply_t *dri3;
+  xcb_present_query_version_reply_t *present;
+  gboolean result;
+
+  ext = xcb_get_extension_data (xcb, &xcb_dri3_id);
+  if (ext == NULL || !ext->present)
+    return FALSE;
+
+  ext = xcb_get_extension_data (xcb, &xcb_present_id);
+  if (ext == NULL || !ext->present)
+    return FALSE;
+
+  dri3 = xcb_dri3_query_version_reply (xcb,
+      xcb_dri3_query_version (xcb, XCB_DRI3_MAJOR_VERSION,
+          XCB_DRI3_MINOR_VERSION), NULL);
+  present = xcb_present_query_version_reply (xcb,
+      xcb_present_query_version (xcb, XCB_PRESENT_MAJOR_VERSION,
+          XCB_PRESENT_MINOR_VERSION), NULL);
+
+  result = dri3 != NULL && present != NULL;
+
+  free (dri3);
+  free (present);
+
+  return result;
+}
+
+/* get the stride of the first plane of @buffer and the offset of the frame
+ * in its first memory */
+static void
+gst_x_image_sink_dri3_get_layout (GstXImageSink * ximagesink,
+    GstBuffer * buffer, gsize * offset, gint * stride)
+{
+  GstVideoMeta *meta;
+
+  gst_memory_get_sizes (gst_buffer_peek_memory (buffer, 0), offset, NULL);
+
+  if ((meta = gst_buffer_get_video_meta (buffer))) {
+    *offset += meta->offset[0];
+    *stride = meta->stride[0];
+  } else {
+    *offset += GST_VIDEO_INFO_PLANE_OFFSET (&ximagesink->info, 0);
+    *stride = GST_VIDEO_INFO_PLANE_STRIDE (&ximagesink->info, 0);
+  }
+}
+
+/* check if @buffer can be shown without a copy. A DRI3 pixmap is made from a
+ * whole dmabuf, so the frame must be the only memory and start at the
+ * beginning of the dmabuf. */
+static gboolean
+gst_x_image_sink_dri3_can_import (GstXImageSink * ximagesink,
+    GstBuffer * buffer)
+{
+  gsize offset;
+  gint stride;
+
+  if (!ximagesink->xcontext->use_dri3 || gst_buffer_n_memory (buffer) != 1)
+    return FALSE;
+
+  if (!gst_is_dmabuf_memory (gst_buffer_peek_memory (buffer, 0)))
+    return FALSE;
+
+  gst_x_image_sink_dri3_get_layout (ximagesink, buffer, &offset, &stride);
+
+  return offset == 0 && stride > 0 && stride <= G_MAXUINT16 &&
+      GST_VIDEO_INFO_WIDTH (&ximagesink->info) <= G_MAXUINT16 &&
+      GST_VIDEO_INFO_HEIGHT (&ximagesink->info) <= G_MAXUINT16;
+}
+
+/* We are called with the x_lock taken */
+static void
+gst_x_image_sink_dri3_free_present (GstXImageSink * ximagesink,
+    GstXImagePresent * present)
+{
+  xcb_free_pixmap (ximagesink->xcontext->xcb, present->pixmap);
+  gst_buffer_unref (present->buffer);
+  g_slice_free (GstXImagePresent, present);
+}
+
+/* We are called with the x_lock taken */
+static void
+gst_x_image_sink_dri3_free_presents (GstXImageSink * ximagesink)
+{
+  GList *walk;
+
+  for (walk = ximagesink->presents; walk; walk = walk->next)
+    gst_x_image_sink_dri3_free_present (ximagesink, walk->data);
+
+  g_list_free (ximagesink->presents);
+  ximagesink->presents = NULL;
+}
+
+/* Release the pixmaps and buffers the X server is done with. We are called
+ * with the x_lock taken */
+static void
+gst_x_image_sink_dri3_handle_events (GstXImageSink * ximagesink)
+{
+  GstXWindow *xwindow = ximagesink->xwindow;
+  xcb_generic_event_t *ev;
+  GList *walk;
+
+  if (xwindow == NULL || xwindow->present_events == NULL)
+    return;
+
+  while ((ev = xcb_poll_for_special_event (ximagesink->xcontext->xcb,
+              xwindow->present_events))) {
+    xcb_present_generic_event_t *pev = (xcb_present_generic_event_t *) ev;
+
+    switch (pev->evtype) {
+      case XCB_PRESENT_EVENT_IDLE_NOTIFY:
+      {
+        xcb_present_idle_notify_event_t *idle =
+            (xcb_present_idle_notify_event_t *) ev;
+
+        for (walk = ximagesink->presents; walk; walk = walk->next) {
+          GstXImagePresent *present = walk->data;
+
+          if (present->serial == idle->serial) {
+            GST_LOG_OBJECT (ximagesink, "pixmap %u is idle", present->pixmap);
+            ximagesink->presents =
+                g_list_delete_link (ximagesink->presents, walk);
+            gst_x_image_sink_dri3_free_present (ximagesink, present);
+            break;
+          }
+        }
+        break;
+      }
+      case XCB_PRESENT_EVENT_COMPLETE_NOTIFY:
+      {
+        xcb_present_complete_notify_event_t *complete =
+            (xcb_present_complete_notify_event_t *) ev;
+
+        GST_LOG_OBJECT (ximagesink, "presented %u at msc %" G_GUINT64_FORMAT
+            ", ust %" G_GUINT64_FORMAT, complete->serial,
+            (guint64) complete->msc, (guint64) complete->ust);
+        break;
+      }
+      default:
+        break;
+    }
+    free (ev);
+  }
+}
+
+/* Import the dmabuf of @buffer as a pixmap and show the @src part of it in
+ * @result on the window. Whole frames are presented at the next vblank.
+ * We are called with the x_lock taken */
+static gboolean
+gst_x_image_sink_dri3_present (GstXImageSink * ximagesink, GstBuffer * buffer,
+    GstVideoRectangle * src, GstVideoRectangle * result)
+{
+  GstXContext *xcontext = ximagesink->xcontext;
+  GstXWindow *xwindow = ximagesink->xwindow;
+  GstXImagePresent *present;
+  GstMemory *mem;
+  xcb_void_cookie_t cookie;
+  xcb_generic_error_t *error;
+  xcb_pixmap_t pixmap;
+  gsize offset, size;
+  gint fd, stride;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  gst_memory_get_sizes (mem, NULL, &size);
+  gst_x_image_sink_dri3_get_layout (ximagesink, buffer, &offset, &stride);
+
+  /* xcb closes the fd once it is sent */
+  fd = dup (gst_dmabuf_memory_get_fd (mem));
+  if (fd < 0)
+    return FALSE;
+
+  /* the error check is a round trip, like the XSync of the other paths */
+  pixmap = xcb_generate_id (xcontext->xcb);
+  cookie = xcb_dri3_pixmap_from_buffer_checked (xcontext->xcb, pixmap,
+      xwindow->win, size, GST_VIDEO_INFO_WIDTH (&ximagesink->info),
+      GST_VIDEO_INFO_HEIGHT (&ximagesink->info), stride, xcontext->depth,
+      xcontext->bpp, fd);
+  if ((error = xcb_request_check (xcontext->xcb, cookie))) {
+    GST_WARNING_OBJECT (ximagesink, "could not import dmabuf (error %d), "
+        "not using DRI3 anymore", error->error_code);
+    free (error);
+    xcontext->use_dri3 = FALSE;
+    return FALSE;
+  }
+
+  /* Present shows the whole pixmap, copy the cropped part instead. The
+   * reply makes sure the server is done with the pixmap */
+  if (src->x != 0 || src->y != 0 ||
+      src->w != GST_VIDEO_INFO_WIDTH (&ximagesink->info) ||
+      src->h != GST_VIDEO_INFO_HEIGHT (&ximagesink->info)) {
+    GST_LOG_OBJECT (ximagesink, "copying %dx%d-%dx%d of %p as pixmap %u to "
+        "%d, %d", src->x, src->y, src->w, src->h, buffer, pixmap, result->x,
+        result->y);
+    xcb_copy_area (xcontext->xcb, pixmap, xwindow->win,
+        XGContextFromGC (xwindow->gc), src->x, src->y, result->x, result->y,
+        result->w, result->h);
+    xcb_free_pixmap (xcontext->xcb, pixmap);
+    free (xcb_get_input_focus_reply (xcontext->xcb,
+            xcb_get_input_focus (xcontext->xcb), NULL));
+    return TRUE;
+  }
+
+  if (xwindow->present_events == NULL) {
+    xwindow->present_eid = xcb_generate_id (xcontext->xcb);
+    xcb_present_select_input (xcontext->xcb, xwindow->present_eid,
+        xwindow->win, XCB_PRESENT_EVENT_MASK_COMPLETE_NOTIFY |
+        XCB_PRESENT_EVENT_MASK_IDLE_NOTIFY);
+    xwindow->present_events = xcb_register_for_special_xge (xcontext->xcb,
+        &xcb_present_id, xwindow->present_eid, NULL);
+  }
+
+  present = g_slice_new (GstXImagePresent);
+  present->serial = ++ximagesink->present_serial;
+  present->pixmap = pixmap;
+  present->buffer = gst_buffer_ref (buffer);
+  ximagesink->presents = g_list_prepend (ximagesink->presents, present);
+
+  GST_LOG_OBJECT (ximagesink, "presenting %p as pixmap %u at %d, %d", buffer,
+      pixmap, result->x, result->y);
+
+  /* without the async option and with a target msc of 0 the pixmap is shown
+   * at the next vblank */
+  xcb_present_pixmap (xcontext->xcb, xwindow->win, pixmap, present->serial,
+      XCB_NONE, XCB_NONE, result->x, result->y, XCB_NONE, XCB_NONE, XCB_NONE,
+      XCB_PRESENT_OPTION_NONE, 0, 0, 0, 0, NULL);
+  xcb_flush (xcontext->xcb);
+
+  return TRUE;
+}
+
+/* show the dmabuf @buffer on the window. Returns FALSE when the import
+ * failed. We are called with the flow_lock taken */
+static gboolean
+gst_x_image_sink_dri3_put (GstXImageSink * ximagesink, GstBuffer * buffer,
+    gboolean draw_border)
+{
+  GstVideoCropMeta *crop;
+  GstVideoRectangle src = { 0, };
+  GstVideoRectangle dst = { 0, };
+  GstVideoRectangle result;
+  gboolean res;
+
+  if ((crop = gst_buffer_get_video_crop_meta (buffer))) {
+    src.x = crop->x;
+    src.y = crop->y;
+    src.w = crop->width;
+    src.h = crop->height;
+    GST_LOG_OBJECT (ximagesink,
+        "crop %dx%d-%dx%d", crop->x, crop->y, crop->width, crop->height);
+  } else {
+    src.w = GST_VIDEO_INFO_WIDTH (&ximagesink->info);
+    src.h = GST_VIDEO_INFO_HEIGHT (&ximagesink->info);
+  }
+  dst.w = ximagesink->xwindow->width;
+  dst.h = ximagesink->xwindow->height;
+
+  gst_video_sink_center_rect (src, dst, &result, FALSE);
+
+  g_mutex_lock (&ximagesink->x_lock);
+
+  if (draw_border) {
+    gst_x_image_sink_xwindow_draw_borders (ximagesink, ximagesink->xwindow,
+        result);
+    ximagesink->draw_border = FALSE;
+  }
+
+  /* the borders are drawn with Xlib, flush them before the xcb requests */
+  XFlush (ximagesink->xcontext->disp);
+  gst_x_image_sink_dri3_handle_events (ximagesink);
+  res = gst_x_image_sink_dri3_present (ximagesink, buffer, &src, &result);
+
+  g_mutex_unlock (&ximagesink->x_lock);
+
+  return res;
+}
+#endif /* HAVE_X_DRI3 */
+
+/* copy @buf into a buffer from our pool. @copy is NULL when there was no
+ * buffer or the frame could not be mapped, the frame is skipped then */
+static GstFlowReturn
+gst_x_image_sink_copy_frame (GstXImageSink * ximagesink, GstBuffer * buf,
+    GstBuffer ** copy)
+{
+  GstVideoFrame src, dest;
+  GstBufferPoolAcquireParams params = { 0, };
+  GstVideoCropMeta *crop, *copy_crop;
+  GstFlowReturn res;
+
+  *copy = NULL;
+
+  /* an internal pool should have been created in setcaps */
+  if (G_UNLIKELY (ximagesink->pool == NULL))
+    goto no_pool;
+
+  if (!gst_buffer_pool_set_active (ximagesink->pool, TRUE))
+    goto activate_failed;
+
+  /* take a buffer from our pool, if there is no buffer in the pool something
+   * is seriously wrong, waiting for the pool here might deadlock when we try
+   * to go to PAUSED because we never flush the pool. */
+  params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+  res = gst_buffer_pool_acquire_buffer (ximagesink->pool, copy, &params);
+  if (res != GST_FLOW_OK)
+    goto no_buffer;
+
+  GST_CAT_LOG_OBJECT (CAT_PERFORMANCE, ximagesink,
+      "slow copy into bufferpool buffer %p", *copy);
+
+  if (!gst_video_frame_map (&src, &ximagesink->info, buf, GST_MAP_READ))
+    goto invalid_buffer;
+
+  if (!gst_video_frame_map (&dest, &ximagesink->info, *copy, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&src);
+    goto invalid_buffer;
+  }
+
+  gst_video_frame_copy (&dest, &src);
+
+  gst_video_frame_unmap (&dest);
+  gst_video_frame_unmap (&src);
+
+  if ((crop = gst_buffer_get_video_crop_meta (buf))) {
+    copy_crop = gst_buffer_add_video_crop_meta (*copy);
+    copy_crop->x = crop->x;
+    copy_crop->y = crop->y;
+    copy_crop->width = crop->width;
+    copy_crop->height = crop->height;
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_ELEMENT_ERROR (ximagesink, RESOURCE, WRITE,
+        ("Internal error: can't allocate images"),
+        ("We don't have a bufferpool negotiated"));
+    return GST_FLOW_ERROR;
+  }
+activate_failed:
+  {
+    GST_ERROR_OBJECT (ximagesink, "failed to activate bufferpool.");
+    return GST_FLOW_ERROR;
+  }
+no_buffer:
+  {
+    /* No image available. That's very bad ! */
+    GST_WARNING_OBJECT (ximagesink, "could not create image");
+    return GST_FLOW_OK;
+  }
+invalid_buffer:
+  {
+    GST_WARNING_OBJECT (ximagesink, "could not map image");
+    gst_buffer_unref (*copy);
+    *copy = NULL;
+    return GST_FLOW_OK;
+  }
+}
+
+static gboolean
+gst_x_image_sink_is_ximage_buffer (GstXImageSink * ximagesink,
+    GstBuffer * buffer)
 {
   GstXImageMemory *mem;
+
+  return gst_buffer_n_memory (buffer) == 1
+      && (mem = (GstXImageMemory *) gst_buffer_peek_memory (buffer, 0))
+      && g_strcmp0 (mem->parent.allocator->mem_type, "ximage") == 0
+      && mem->sink == ximagesink;
+}
+
+/* This function puts a GstXImageBuffer, or a dmabuf buffer that can be
+ * imported with DRI3, on a GstXImageSink's window. Other buffers are copied
+ * into a GstXImageBuffer first */
+static gboolean
+gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
+{
+  GstXImageMemory *mem = NULL;
   GstVideoCropMeta *crop;
   GstVideoRectangle src = { 0, };
   GstVideoRectangle dst = { 0, };
   GstVideoRectangle result;
   gboolean draw_border = FALSE;
+  gboolean res = TRUE;
 
   /* We take the flow_lock. If expose is in there we don't want to run
      concurrently from the data flow thread */
@@ -273,10 +666,31 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
     }
   }
 
-  mem = (GstXImageMemory *) gst_buffer_peek_memory (ximage, 0);
-  crop = gst_buffer_get_video_crop_meta (ximage);
+  if (!gst_x_image_sink_is_ximage_buffer (ximagesink, ximage)) {
+    GstBuffer *copy;
 
-  if (crop) {
+#ifdef HAVE_X_DRI3
+    if (gst_x_image_sink_dri3_can_import (ximagesink, ximage) &&
+        gst_x_image_sink_dri3_put (ximagesink, ximage, draw_border)) {
+      g_mutex_unlock (&ximagesink->flow_lock);
+      return TRUE;
+    }
+#endif /* HAVE_X_DRI3 */
+
+    /* the frame can't be imported (anymore), show a copy of it, which is
+     * also used for the next exposes */
+    GST_LOG_OBJECT (ximagesink, "copying %p into an ximage", ximage);
+    gst_x_image_sink_copy_frame (ximagesink, ximage, &copy);
+    if (copy == NULL) {
+      g_mutex_unlock (&ximagesink->flow_lock);
+      return FALSE;
+    }
+    gst_buffer_unref (ximagesink->cur_image);
+    ximagesink->cur_image = ximage = copy;
+  }
+
+  mem = (GstXImageMemory *) gst_buffer_peek_memory (ximage, 0);
+  if ((crop = gst_buffer_get_video_crop_meta (ximage))) {
     src.x = crop->x + mem->x;
     src.y = crop->y + mem->y;
     src.w = crop->width;
@@ -328,7 +742,7 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
 
   g_mutex_unlock (&ximagesink->flow_lock);
 
-  return TRUE;
+  return res;
 }
 
 static gboolean
@@ -488,6 +902,16 @@ gst_x_image_sink_xwindow_destroy (GstXImageSink * ximagesink,
 
   g_mutex_lock (&ximagesink->x_lock);
 
+#ifdef HAVE_X_DRI3
+  if (xwindow->present_events) {
+    xcb_present_select_input (ximagesink->xcontext->xcb, xwindow->present_eid,
+        xwindow->win, 0);
+    xcb_unregister_for_special_event (ximagesink->xcontext->xcb,
+        xwindow->present_events);
+  }
+  gst_x_image_sink_dri3_free_presents (ximagesink);
+#endif /* HAVE_X_DRI3 */
+
   /* If we did not create that window we just free the GC and let it live */
   if (xwindow->internal)
     XDestroyWindow (ximagesink->xcontext->disp, xwindow->win);
@@ -711,6 +1135,10 @@ gst_x_image_sink_handle_xevents (GstXImageSink * ximagesink)
     }
   }
 
+#ifdef HAVE_X_DRI3
+  gst_x_image_sink_dri3_handle_events (ximagesink);
+#endif /* HAVE_X_DRI3 */
+
   g_mutex_unlock (&ximagesink->x_lock);
   g_mutex_unlock (&ximagesink->flow_lock);
 }
@@ -919,6 +1347,19 @@ gst_x_image_sink_xcontext_get (GstXImageSink * ximagesink)
     GST_DEBUG ("ximagesink is not using XShm extension");
   }
 
+  /* Search for DRI3 and Present support to show dmabuf memory */
+#ifdef HAVE_X_DRI3
+  xcontext->xcb = XGetXCBConnection (xcontext->disp);
+  if (gst_x_image_sink_check_dri3 (xcontext->xcb)) {
+    xcontext->use_dri3 = TRUE;
+    GST_DEBUG ("ximagesink is using DRI3 and Present extensions");
+  } else
+#endif /* HAVE_X_DRI3 */
+  {
+    xcontext->use_dri3 = FALSE;
+    GST_DEBUG ("ximagesink is not using DRI3 and Present extensions");
+  }
+
   /* extrapolate alpha mask */
   if (xcontext->depth == 32) {
     alpha_mask = ~(xcontext->visual->red_mask
@@ -1333,58 +1774,31 @@ gst_x_image_sink_show_frame (GstVideoSink * vsink, GstBuffer * buf)
 {
   GstFlowReturn res;
   GstXImageSink *ximagesink;
-  GstXImageMemory *mem;
   GstBuffer *to_put = NULL;
 
   ximagesink = GST_X_IMAGE_SINK (vsink);
 
-  if (gst_buffer_n_memory (buf) == 1
-      && (mem = (GstXImageMemory *) gst_buffer_peek_memory (buf, 0))
-      && g_strcmp0 (mem->parent.allocator->mem_type, "ximage") == 0
-      && mem->sink == ximagesink) {
+  if (gst_x_image_sink_is_ximage_buffer (ximagesink, buf)) {
     /* If this buffer has been allocated using our buffer management we simply
        put the ximage which is in the PRIVATE pointer */
     GST_LOG_OBJECT (ximagesink, "buffer from our pool, writing directly");
     to_put = buf;
     res = GST_FLOW_OK;
+#ifdef HAVE_X_DRI3
+  } else if (gst_x_image_sink_dri3_can_import (ximagesink, buf)) {
+    /* when the import fails DRI3 is disabled and the frame is copied */
+    GST_LOG_OBJECT (ximagesink, "dmabuf buffer, presenting directly");
+    to_put = buf;
+    res = GST_FLOW_OK;
+#endif /* HAVE_X_DRI3 */
   } else {
-    GstVideoFrame src, dest;
-    GstBufferPoolAcquireParams params = { 0, };
-
     /* Else we have to copy the data into our private image, */
     /* if we have one... */
     GST_LOG_OBJECT (ximagesink, "buffer not from our pool, copying");
 
-    /* an internal pool should have been created in setcaps */
-    if (G_UNLIKELY (ximagesink->pool == NULL))
-      goto no_pool;
-
-    if (!gst_buffer_pool_set_active (ximagesink->pool, TRUE))
-      goto activate_failed;
-
-    /* take a buffer from our pool, if there is no buffer in the pool something
-     * is seriously wrong, waiting for the pool here might deadlock when we try
-     * to go to PAUSED because we never flush the pool. */
-    params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
-    res = gst_buffer_pool_acquire_buffer (ximagesink->pool, &to_put, &params);
-    if (res != GST_FLOW_OK)
-      goto no_buffer;
-
-    GST_CAT_LOG_OBJECT (CAT_PERFORMANCE, ximagesink,
-        "slow copy into bufferpool buffer %p", to_put);
-
-    if (!gst_video_frame_map (&src, &ximagesink->info, buf, GST_MAP_READ))
-      goto invalid_buffer;
-
-    if (!gst_video_frame_map (&dest, &ximagesink->info, to_put, GST_MAP_WRITE)) {
-      gst_video_frame_unmap (&src);
-      goto invalid_buffer;
-    }
-
-    gst_video_frame_copy (&dest, &src);
-
-    gst_video_frame_unmap (&dest);
-    gst_video_frame_unmap (&src);
+    res = gst_x_image_sink_copy_frame (ximagesink, buf, &to_put);
+    if (to_put == NULL)
+      return res;
   }
 
   if (!gst_x_image_sink_ximage_put (ximagesink, to_put))
@@ -1397,26 +1811,6 @@ done:
   return res;
 
   /* ERRORS */
-no_pool:
-  {
-    GST_ELEMENT_ERROR (ximagesink, RESOURCE, WRITE,
-        ("Internal error: can't allocate images"),
-        ("We don't have a bufferpool negotiated"));
-    return GST_FLOW_ERROR;
-  }
-no_buffer:
-  {
-    /* No image available. That's very bad ! */
-    GST_WARNING_OBJECT (ximagesink, "could not create image");
-    return GST_FLOW_OK;
-  }
-invalid_buffer:
-  {
-    /* No Window available to put our image into */
-    GST_WARNING_OBJECT (ximagesink, "could not map image");
-    res = GST_FLOW_OK;
-    goto done;
-  }
 no_window:
   {
     /* No Window available to put our image into */
@@ -1424,12 +1818,6 @@ no_window:
     res = GST_FLOW_ERROR;
     goto done;
   }
-activate_failed:
-  {
-    GST_ERROR_OBJECT (ximagesink, "failed to activate bufferpool.");
-    res = GST_FLOW_ERROR;
-    goto done;
-  }
 }
 
 static gboolean
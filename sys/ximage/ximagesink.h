@@ -35,6 +35,12 @@
 #include <X11/extensions/XShm.h>
 #endif /* HAVE_XSHM */
 
+#ifdef HAVE_X_DRI3
+#include <X11/Xlib-xcb.h>
+#include <xcb/dri3.h>
+#include <xcb/present.h>
+#endif /* HAVE_X_DRI3 */
+
 #include <string.h>
 #include <math.h>
 
@@ -81,6 +87,9 @@ typedef struct _GstXImageSinkClass GstXImageSinkClass;
  * @heightmm ratio
  * @use_xshm: used to known wether of not XShm extension is usable or not even
  * if the Extension is present
+ * @use_dri3: used to know if dmabuf memory can be shown with the DRI3 and
+ * Present extensions
+ * @xcb: the XCB connection of Display @disp
  * @caps: the #GstCaps that Display @disp can accept
  *
  * Structure used to store various informations collected/calculated for a
@@ -108,6 +117,11 @@ struct _GstXContext
 
   gboolean use_xshm;
 
+  gboolean use_dri3;
+#ifdef HAVE_X_DRI3
+  xcb_connection_t *xcb;
+#endif
+
   GstCaps *caps;
   GstCaps *last_caps;
 };
@@ -120,6 +134,8 @@ struct _GstXContext
  * @internal: used to remember if Window @win was created internally or passed
  * through the #GstVideoOverlay interface
  * @gc: the Graphical Context of Window @win
+ * @present_eid: the id of the Present event selection of Window @win
+ * @present_events: the queue of Present events of Window @win
  *
  * Structure used to store informations about a Window.
  */
@@ -129,6 +145,10 @@ struct _GstXWindow
   gint width, height;
   gboolean internal;
   GC gc;
+#ifdef HAVE_X_DRI3
+  guint32 present_eid;
+  xcb_special_event_t *present_events;
+#endif
 };
 
 /**
@@ -157,6 +177,9 @@ struct _GstXWindow
  * @keep_aspect: used to remember if reverse negotiation scaling should respect
  * aspect ratio
  * @handle_events: used to know if we should handle select XEvents or not
+ * @presents: the pixmaps presented with DRI3 that the X server is still
+ * using, with the buffers they were imported from
+ * @present_serial: the serial of the last pixmap presented
  *
  * The #GstXImageSink data structure.
  */
@@ -197,6 +220,12 @@ struct _GstXImageSink
 
   /* stream metadata */
   gchar *media_title;
+
+#ifdef HAVE_X_DRI3
+  /* with x_lock */
+  GList *presents;
+  guint32 present_serial;
+#endif
 };
 
 struct _GstXImageSinkClass
@@ -561,6 +561,71 @@ gst_xvcontext_copy (GstXvContext * context)
   return NULL;
 }
 
+#ifdef HAVE_XSHM
+/* number of freed segments that stay attached to be reused */
+#define SHM_CACHE_SIZE 16
+
+static void
+gst_xvcontext_free_shm_segment (GstXvContext * context,
+    GstXvShmSegment * segment)
+{
+  GST_DEBUG ("XServer ShmDetaching from 0x%x id 0x%lx", segment->info.shmid,
+      segment->info.shmseg);
+  XShmDetach (context->disp, &segment->info);
+  XSync (context->disp, FALSE);
+  shmdt (segment->info.shmaddr);
+  g_slice_free (GstXvShmSegment, segment);
+}
+
+/* Take a freed segment of at least @size bytes, the smallest one that does
+ * not waste more than half of it. Must be called with the context lock */
+gboolean
+gst_xvcontext_take_shm_segment (GstXvContext * context, gsize size,
+    XShmSegmentInfo * info, gsize * seg_size)
+{
+  GstXvShmSegment *segment;
+  GList *l, *best = NULL;
+
+  for (l = context->shm_cache.head; l; l = l->next) {
+    segment = l->data;
+
+    if (segment->size >= size && segment->size / 2 <= size &&
+        (!best || segment->size < ((GstXvShmSegment *) best->data)->size))
+      best = l;
+  }
+  if (!best)
+    return FALSE;
+
+  segment = best->data;
+  g_queue_delete_link (&context->shm_cache, best);
+
+  *info = segment->info;
+  *seg_size = segment->size;
+  g_slice_free (GstXvShmSegment, segment);
+
+  return TRUE;
+}
+
+/* Keep a segment that is no longer used attached so that a new image can
+ * use it, the oldest one is freed when there are too many. Must be called
+ * with the context lock */
+void
+gst_xvcontext_release_shm_segment (GstXvContext * context,
+    const XShmSegmentInfo * info, gsize size)
+{
+  GstXvShmSegment *segment;
+
+  segment = g_slice_new (GstXvShmSegment);
+  segment->info = *info;
+  segment->size = size;
+  g_queue_push_tail (&context->shm_cache, segment);
+
+  if (g_queue_get_length (&context->shm_cache) > SHM_CACHE_SIZE)
+    gst_xvcontext_free_shm_segment (context,
+        g_queue_pop_head (&context->shm_cache));
+}
+#endif /* HAVE_XSHM */
+
 static void
 gst_xvcontext_free (GstXvContext * context)
 {
@@ -609,6 +674,15 @@ gst_xvcontext_free (GstXvContext * context)
 
   GST_DEBUG ("Closing display and freeing X Context");
 
+#ifdef HAVE_XSHM
+  {
+    GstXvShmSegment *segment;
+
+    while ((segment = g_queue_pop_head (&context->shm_cache)))
+      gst_xvcontext_free_shm_segment (context, segment);
+  }
+#endif /* HAVE_XSHM */
+
   if (context->xv_port_id)
     XvUngrabPort (context->disp, context->xv_port_id, 0);
 
@@ -648,6 +722,7 @@ gst_xvcontext_new (GstXvContextConfig * config, GError ** error)
       (GstMiniObjectFreeFunction) gst_xvcontext_free);
 
   g_mutex_init (&context->lock);
+  g_queue_init (&context->shm_cache);
   context->im_format = 0;
   context->adaptor_nr = -1;
 
@@ -711,6 +786,7 @@ gst_xvcontext_new (GstXvContextConfig * config, GError ** error)
   if (XShmQueryExtension (context->disp) &&
       gst_xvcontext_check_xshm_calls (context)) {
     context->use_xshm = TRUE;
+    context->shm_completion = XShmGetEventBase (context->disp) + ShmCompletion;
     GST_DEBUG ("xvimagesink is using XShm extension");
   } else
 #endif /* HAVE_XSHM */
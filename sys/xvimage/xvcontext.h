@@ -90,6 +90,15 @@ struct _GstXvImageFormat
 #define GST_XVCONTEXT_CAST(obj) ((GstXvContext *)obj)
 #define GST_XVCONTEXT(obj)      (GST_XVCONTEXT_CAST(obj))
 
+#ifdef HAVE_XSHM
+/* a shared memory segment that is attached to the X server */
+typedef struct
+{
+  XShmSegmentInfo info;
+  gsize size;
+} GstXvShmSegment;
+#endif /* HAVE_XSHM */
+
 /*
  * GstXvContext:
  * @disp: the X11 Display of this context
@@ -145,6 +154,8 @@ struct _GstXvContext
   GValue *par;                  /* calculated pixel aspect ratio */
 
   gboolean use_xshm;
+  gint shm_completion;          /* event type of XShmCompletionEvent */
+  GQueue shm_cache;             /* GstXvShmSegment, most recently freed last */
 
   XvPortID xv_port_id;
   guint nb_adaptors;
@@ -202,6 +213,16 @@ void            gst_xvcontext_update_colorbalance       (GstXvContext * xvcontex
 void            gst_xvcontext_set_colorimetry           (GstXvContext * xvcontext,
                                                          GstVideoColorimetry *colorimetry);
 
+#ifdef HAVE_XSHM
+gboolean        gst_xvcontext_take_shm_segment          (GstXvContext * context,
+                                                         gsize size,
+                                                         XShmSegmentInfo * info,
+                                                         gsize * seg_size);
+void            gst_xvcontext_release_shm_segment       (GstXvContext * context,
+                                                         const XShmSegmentInfo * info,
+                                                         gsize size);
+#endif
+
 
 typedef struct _GstXWindow GstXWindow;
 
@@ -61,6 +61,7 @@ struct _GstXvImageMemory
 
 #ifdef HAVE_XSHM
   XShmSegmentInfo SHMInfo;
+  gsize shm_size;
 #endif                          /* HAVE_XSHM */
 };
 
@@ -161,11 +162,11 @@ gst_xvimage_allocator_free (GstAllocator * allocator, GstMemory * gmem)
 #ifdef HAVE_XSHM
   if (context->use_xshm) {
     if (mem->SHMInfo.shmaddr != ((void *) -1)) {
-      GST_DEBUG_OBJECT (allocator, "XServer ShmDetaching from 0x%x id 0x%lx",
+      /* the segment stays attached for the next images */
+      GST_DEBUG_OBJECT (allocator, "releasing segment 0x%x id 0x%lx",
           mem->SHMInfo.shmid, mem->SHMInfo.shmseg);
-      XShmDetach (context->disp, &mem->SHMInfo);
-      XSync (context->disp, FALSE);
-      shmdt (mem->SHMInfo.shmaddr);
+      gst_xvcontext_release_shm_segment (context, &mem->SHMInfo,
+          mem->shm_size);
       mem->SHMInfo.shmaddr = (void *) -1;
     }
     if (mem->xvimage)
@@ -452,8 +453,20 @@ gst_xvimage_allocator_alloc (GstXvImageAllocator * allocator, gint im_format,
       }
     }
 
-    /* get shared memory */
     align = 0;
+
+    /* reuse a segment of a freed image when possible */
+    if (gst_xvcontext_take_shm_segment (context, mem->xvimage->data_size,
+            &mem->SHMInfo, &mem->shm_size)) {
+      mem->xvimage->data = mem->SHMInfo.shmaddr;
+      GST_DEBUG_OBJECT (allocator, "reusing segment 0x%x, id 0x%lx of %"
+          G_GSIZE_FORMAT " bytes", mem->SHMInfo.shmid, mem->SHMInfo.shmseg,
+          mem->shm_size);
+      goto shm_done;
+    }
+
+    /* get shared memory */
+    mem->shm_size = mem->xvimage->data_size;
     mem->SHMInfo.shmid =
         shmget (IPC_PRIVATE, mem->xvimage->data_size, IPC_CREAT | 0777);
     if (mem->SHMInfo.shmid == -1)
@@ -480,6 +493,8 @@ gst_xvimage_allocator_alloc (GstXvImageAllocator * allocator, gint im_format,
 
     GST_DEBUG_OBJECT (allocator, "XServer ShmAttached to 0x%x, id 0x%lx",
         mem->SHMInfo.shmid, mem->SHMInfo.shmseg);
+  shm_done:
+    ;
   } else
   no_xshm:
 #endif /* HAVE_XSHM */
@@ -610,12 +625,25 @@ gst_xwindow_draw_borders (GstXWindow * window, GstVideoRectangle * rect)
   }
 }
 
-void
+#ifdef HAVE_XSHM
+ShmSeg
+gst_xvimage_memory_get_shmseg (GstXvImageMemory * mem)
+{
+  return mem->SHMInfo.shmseg;
+}
+#endif
+
+/* With @async, the server sends an XShmCompletionEvent when it is done with
+ * the image instead of waiting for it here. Returns %TRUE when such an event
+ * will be sent */
+gboolean
 gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
-    GstXWindow * window, GstVideoRectangle * dst_crop, gboolean draw_border)
+    GstXWindow * window, GstVideoRectangle * dst_crop, gboolean draw_border,
+    gboolean async)
 {
   GstXvContext *context;
   XvImage *xvimage;
+  gboolean send_event = FALSE;
 
   context = window->context;
 
@@ -631,12 +659,13 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
         src_crop->w, src_crop->h, window->render_rect.w, window->render_rect.h,
         mem);
 
+    send_event = async;
     XvShmPutImage (context->disp,
         context->xv_port_id,
         window->win,
         window->gc, xvimage,
         src_crop->x, src_crop->y, src_crop->w, src_crop->h,
-        dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h, FALSE);
+        dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h, send_event);
   } else
 #endif /* HAVE_XSHM */
   {
@@ -647,7 +676,12 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
         src_crop->x, src_crop->y, src_crop->w, src_crop->h,
         dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h);
   }
-  XSync (context->disp, FALSE);
+  if (send_event)
+    XFlush (context->disp);
+  else
+    XSync (context->disp, FALSE);
 
   g_mutex_unlock (&context->lock);
+
+  return send_event;
 }
@@ -58,11 +58,16 @@ XvImage *             gst_xvimage_memory_get_xvimage    (GstXvImageMemory *mem);
 gboolean              gst_xvimage_memory_get_crop       (GstXvImageMemory *mem,
                                                          GstVideoRectangle *crop);
 
-void                  gst_xvimage_memory_render         (GstXvImageMemory *mem,
+#ifdef HAVE_XSHM
+ShmSeg                gst_xvimage_memory_get_shmseg     (GstXvImageMemory *mem);
+#endif
+
+gboolean              gst_xvimage_memory_render         (GstXvImageMemory *mem,
                                                          GstVideoRectangle *src_crop,
                                                          GstXWindow *window,
                                                          GstVideoRectangle *dst_crop,
-                                                         gboolean draw_border);
+                                                         gboolean draw_border,
+                                                         gboolean async);
 
 G_END_DECLS
 
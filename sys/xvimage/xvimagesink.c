@@ -149,6 +149,8 @@ MotifWmHints, MwmHints;
 
 #define MWM_HINTS_DECORATIONS   (1L << 1)
 
+#define DEFAULT_MAX_IN_FLIGHT   0
+
 static gboolean gst_xv_image_sink_open (GstXvImageSink * xvimagesink);
 static void gst_xv_image_sink_close (GstXvImageSink * xvimagesink);
 static void gst_xv_image_sink_xwindow_update_geometry (GstXvImageSink *
@@ -186,7 +188,8 @@ enum
   PROP_COLORKEY,
   PROP_DRAW_BORDERS,
   PROP_WINDOW_WIDTH,
-  PROP_WINDOW_HEIGHT
+  PROP_WINDOW_HEIGHT,
+  PROP_MAX_IN_FLIGHT
 };
 
 /* ============================================================= */
@@ -222,6 +225,57 @@ G_DEFINE_TYPE_WITH_CODE (GstXvImageSink, gst_xv_image_sink, GST_TYPE_VIDEO_SINK,
 /* ============================================================= */
 
 
+/* Release the images the X server is done with. With @wait, first wait until
+ * the server handled all the requests and, when there are still more than
+ * max-in-flight images, release the oldest ones anyway like the synchronous
+ * mode does. Must be called with the flow_lock */
+static void
+gst_xv_image_sink_release_in_flight (GstXvImageSink * xvimagesink,
+    gboolean wait, guint max)
+{
+#ifdef HAVE_XSHM
+  GstXvContext *context = xvimagesink->context;
+  GQueue done = G_QUEUE_INIT;
+  GstBuffer *buffer;
+  XEvent e;
+
+  if (g_queue_is_empty (&xvimagesink->in_flight))
+    return;
+
+  g_mutex_lock (&context->lock);
+  if (wait)
+    XSync (context->disp, FALSE);
+  while (XCheckTypedEvent (context->disp, context->shm_completion, &e)) {
+    XShmCompletionEvent *ev = (XShmCompletionEvent *) & e;
+    GList *l;
+
+    for (l = xvimagesink->in_flight.head; l; l = l->next) {
+      GstXvImageMemory *mem =
+          (GstXvImageMemory *) gst_buffer_peek_memory (l->data, 0);
+
+      if (gst_xvimage_memory_get_shmseg (mem) == ev->shmseg) {
+        g_queue_push_tail (&done, l->data);
+        g_queue_delete_link (&xvimagesink->in_flight, l);
+        break;
+      }
+    }
+  }
+  g_mutex_unlock (&context->lock);
+
+  if (wait) {
+    while (g_queue_get_length (&xvimagesink->in_flight) > max)
+      g_queue_push_tail (&done, g_queue_pop_head (&xvimagesink->in_flight));
+  }
+
+  GST_LOG_OBJECT (xvimagesink, "released %u images, %u in flight",
+      done.length, xvimagesink->in_flight.length);
+
+  /* outside of the context lock, the last unref might free the image */
+  while ((buffer = g_queue_pop_head (&done)))
+    gst_buffer_unref (buffer);
+#endif /* HAVE_XSHM */
+}
+
 /* This function puts a GstXvImage on a GstXvImageSink's window. Returns FALSE
  * if no window was available  */
 static gboolean
@@ -308,7 +362,15 @@ gst_xv_image_sink_xvimage_put (GstXvImageSink * xvimagesink,
     memcpy (&result, &xwindow->render_rect, sizeof (GstVideoRectangle));
   }
 
-  gst_xvimage_memory_render (mem, &src, xwindow, &result, draw_border);
+  /* keep the image until the X server is done with it */
+  if (gst_xvimage_memory_render (mem, &src, xwindow, &result, draw_border,
+          xvimagesink->max_in_flight > 0)) {
+    guint max = xvimagesink->max_in_flight;
+
+    g_queue_push_tail (&xvimagesink->in_flight, gst_buffer_ref (xvimage));
+    gst_xv_image_sink_release_in_flight (xvimagesink,
+        g_queue_get_length (&xvimagesink->in_flight) > max, max);
+  }
 
   g_mutex_unlock (&xvimagesink->flow_lock);
 
@@ -1625,6 +1687,9 @@ gst_xv_image_sink_set_property (GObject * object, guint prop_id,
     case PROP_DRAW_BORDERS:
       xvimagesink->draw_borders = g_value_get_boolean (value);
       break;
+    case PROP_MAX_IN_FLIGHT:
+      xvimagesink->max_in_flight = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1714,6 +1779,9 @@ gst_xv_image_sink_get_property (GObject * object, guint prop_id,
       else
         g_value_set_uint64 (value, 0);
       break;
+    case PROP_MAX_IN_FLIGHT:
+      g_value_set_uint (value, xvimagesink->max_in_flight);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1787,6 +1855,8 @@ gst_xv_image_sink_close (GstXvImageSink * xvimagesink)
 
   g_mutex_lock (&xvimagesink->flow_lock);
 
+  gst_xv_image_sink_release_in_flight (xvimagesink, TRUE, 0);
+
   if (xvimagesink->pool) {
     gst_object_unref (xvimagesink->pool);
     xvimagesink->pool = NULL;
@@ -1874,6 +1944,9 @@ gst_xv_image_sink_init (GstXvImageSink * xvimagesink)
   xvimagesink->handle_expose = TRUE;
 
   xvimagesink->draw_borders = TRUE;
+
+  g_queue_init (&xvimagesink->in_flight);
+  xvimagesink->max_in_flight = DEFAULT_MAX_IN_FLIGHT;
 }
 
 static void
@@ -2007,6 +2080,23 @@ gst_xv_image_sink_class_init (GstXvImageSinkClass * klass)
           "Height of the window", 0, G_MAXUINT64, 0,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstXvImageSink:max-in-flight
+   *
+   * Maximum number of images the X server can still be reading from. With 0
+   * every image waits for a round trip to the X server. Otherwise the images
+   * are only released when the X server sends an XShmCompletionEvent for
+   * them and rendering only waits when there are more images in flight.
+   * This only works when the XShm extension is used.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_IN_FLIGHT,
+      g_param_spec_uint ("max-in-flight", "Max in flight",
+          "Maximum number of images the X server can still read from "
+          "(0 = wait for every image)", 0, 16, DEFAULT_MAX_IN_FLIGHT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_xv_image_sink_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -75,6 +75,10 @@ typedef struct _GstXvImageSinkClass GstXvImageSinkClass;
  * @cb_changed: used to store if the color balance settings where changed
  * @video_width: the width of incoming video frames in pixels
  * @video_height: the height of incoming video frames in pixels
+ * @in_flight: the images that were put and that the X server can still read
+ * from, they are released when their XShmCompletionEvent arrives
+ * @max_in_flight: the maximum length of @in_flight, 0 waits for the X server
+ * after every image
  *
  * The #GstXvImageSink data structure.
  */
@@ -118,6 +122,9 @@ struct _GstXvImageSink
 
   gboolean draw_borders;
 
+  GQueue in_flight;
+  guint max_in_flight;
+
   /* stream metadata */
   gchar *media_title;
 };
@@ -0,0 +1,261 @@
+/* GStreamer audio converter and resampler benchmark
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures GstAudioConverter for a matrix of sample formats and channel
+ * layouts and GstAudioResampler for the resampler methods, formats and
+ * rates. Run with --csv to get one line per case for regression
+ * tracking. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#include "benchmark.h"
+
+/* frames per buffer, about 20ms at 48kHz */
+#define BLOCK_SIZE 960
+
+static const GstAudioFormat convert_formats[] = {
+  GST_AUDIO_FORMAT_S16,
+  GST_AUDIO_FORMAT_S24,
+  GST_AUDIO_FORMAT_S32,
+  GST_AUDIO_FORMAT_F32,
+  GST_AUDIO_FORMAT_F64,
+};
+
+static const struct
+{
+  gint in_channels, out_channels;
+} layouts[] = {
+  {
+  2, 2}, {
+  1, 2}, {
+  6, 2}
+};
+
+static const struct
+{
+  GstAudioResamplerMethod method;
+  const gchar *name;
+} resampler_methods[] = {
+  {
+  GST_AUDIO_RESAMPLER_METHOD_NEAREST, "nearest"}, {
+  GST_AUDIO_RESAMPLER_METHOD_LINEAR, "linear"}, {
+  GST_AUDIO_RESAMPLER_METHOD_CUBIC, "cubic"}, {
+  GST_AUDIO_RESAMPLER_METHOD_BLACKMAN_NUTTALL, "blackman-nuttall"}, {
+  GST_AUDIO_RESAMPLER_METHOD_KAISER, "kaiser"}
+};
+
+/* the formats the resampler works in */
+static const GstAudioFormat resampler_formats[] = {
+  GST_AUDIO_FORMAT_S16,
+  GST_AUDIO_FORMAT_S32,
+  GST_AUDIO_FORMAT_F32,
+  GST_AUDIO_FORMAT_F64,
+};
+
+static const struct
+{
+  gint in_rate, out_rate;
+} rates[] = {
+  {
+  44100, 48000}, {
+  48000, 44100}, {
+  48000, 96000}, {
+  96000, 48000}
+};
+
+typedef struct
+{
+  GstAudioConverter *convert;
+  gpointer in, out;
+  gsize in_frames, out_frames;
+} ConvertData;
+
+typedef struct
+{
+  GstAudioResampler *resampler;
+  gpointer in[2], out[2];
+  gsize in_frames;
+  gsize max_out;
+} ResampleData;
+
+static void
+run_convert (gpointer data)
+{
+  ConvertData *d = data;
+
+  gst_audio_converter_samples (d->convert, 0, &d->in, d->in_frames,
+      &d->out, d->out_frames);
+}
+
+static void
+run_resample (gpointer data)
+{
+  ResampleData *d = data;
+  gsize out_frames;
+
+  out_frames = gst_audio_resampler_get_out_frames (d->resampler,
+      d->in_frames);
+  gst_audio_resampler_resample (d->resampler, d->in, d->in_frames, d->out,
+      MIN (out_frames, d->max_out));
+}
+
+static void
+bench_convert (const BenchmarkOptions * options, GstAudioFormat in_format,
+    GstAudioFormat out_format, gint layout)
+{
+  GstAudioInfo in_info, out_info;
+  BenchmarkResult res;
+  ConvertData d;
+  gchar in_size[32], out_size[32];
+
+  gst_audio_info_set_format (&in_info, in_format, 48000,
+      layouts[layout].in_channels, NULL);
+  gst_audio_info_set_format (&out_info, out_format, 48000,
+      layouts[layout].out_channels, NULL);
+
+  d.convert = gst_audio_converter_new (0, &in_info, &out_info, NULL);
+  if (d.convert == NULL) {
+    g_printerr ("can't convert %s to %s\n",
+        gst_audio_format_to_string (in_format),
+        gst_audio_format_to_string (out_format));
+    return;
+  }
+
+  d.in_frames = d.out_frames = BLOCK_SIZE;
+  d.in = g_malloc (BLOCK_SIZE * GST_AUDIO_INFO_BPF (&in_info));
+  d.out = g_malloc (BLOCK_SIZE * GST_AUDIO_INFO_BPF (&out_info));
+  memset (d.in, 0x5a, BLOCK_SIZE * GST_AUDIO_INFO_BPF (&in_info));
+
+  benchmark_run (options, run_convert, &d, &res);
+
+  g_snprintf (in_size, sizeof (in_size), "%dch@48000",
+      layouts[layout].in_channels);
+  g_snprintf (out_size, sizeof (out_size), "%dch@48000",
+      layouts[layout].out_channels);
+
+  benchmark_print_result (options, "audioconvert",
+      gst_audio_format_to_string (in_format),
+      gst_audio_format_to_string (out_format), in_size, out_size, "default",
+      1, "sample", (guint64) BLOCK_SIZE * layouts[layout].out_channels, &res);
+
+  gst_audio_converter_free (d.convert);
+  g_free (d.in);
+  g_free (d.out);
+}
+
+static void
+bench_resample (const BenchmarkOptions * options, GstAudioFormat format,
+    gint method, gint rate)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gint in_rate = rates[rate].in_rate, out_rate = rates[rate].out_rate;
+  GstStructure *config;
+  BenchmarkResult res;
+  ResampleData d;
+  gchar in_size[32], out_size[32];
+  gsize bpf = 2 * GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+
+  config = gst_structure_new_empty ("GstAudioResampler.config");
+  gst_audio_resampler_options_set_quality (resampler_methods[method].method,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, in_rate, out_rate, config);
+
+  /* interleaved stereo */
+  d.resampler = gst_audio_resampler_new (resampler_methods[method].method,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, 2, in_rate, out_rate, config);
+  gst_structure_free (config);
+
+  d.in_frames = BLOCK_SIZE;
+  d.max_out = gst_audio_resampler_get_out_frames (d.resampler,
+      BLOCK_SIZE) + 1;
+  d.in[0] = g_malloc (BLOCK_SIZE * bpf);
+  d.out[0] = g_malloc (d.max_out * bpf);
+  memset (d.in[0], 0x5a, BLOCK_SIZE * bpf);
+
+  benchmark_run (options, run_resample, &d, &res);
+
+  g_snprintf (in_size, sizeof (in_size), "2ch@%d", in_rate);
+  g_snprintf (out_size, sizeof (out_size), "2ch@%d", out_rate);
+
+  /* counted in input samples, that is what the caller has to push */
+  benchmark_print_result (options, "audioresample",
+      gst_audio_format_to_string (format), gst_audio_format_to_string (format),
+      in_size, out_size, resampler_methods[method].name, 1, "sample",
+      (guint64) BLOCK_SIZE * 2, &res);
+
+  gst_audio_resampler_free (d.resampler);
+  g_free (d.in[0]);
+  g_free (d.out[0]);
+}
+
+int
+main (int argc, char **argv)
+{
+  BenchmarkOptions options = { FALSE, 0.5 };
+  gboolean no_convert = FALSE, no_resample = FALSE;
+  GOptionEntry entries[] = {
+    {"csv", 0, 0, G_OPTION_ARG_NONE, &options.csv,
+        "Print comma separated values", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &options.duration,
+        "Minimum run time of every case in seconds (default 0.5)", NULL},
+    {"no-convert", 0, 0, G_OPTION_ARG_NONE, &no_convert,
+        "Skip the converter cases", NULL},
+    {"no-resample", 0, 0, G_OPTION_ARG_NONE, &no_resample,
+        "Skip the resampler cases", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  guint i, j, l;
+
+  ctx = g_option_context_new ("- benchmark the audio converter and resampler");
+  g_option_context_add_main_entries (ctx, entries, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  benchmark_print_header (&options);
+
+  if (!no_convert) {
+    for (l = 0; l < G_N_ELEMENTS (layouts); l++)
+      for (i = 0; i < G_N_ELEMENTS (convert_formats); i++)
+        for (j = 0; j < G_N_ELEMENTS (convert_formats); j++)
+          bench_convert (&options, convert_formats[i], convert_formats[j], l);
+  }
+
+  if (!no_resample) {
+    for (l = 0; l < G_N_ELEMENTS (rates); l++)
+      for (i = 0; i < G_N_ELEMENTS (resampler_formats); i++)
+        for (j = 0; j < G_N_ELEMENTS (resampler_methods); j++)
+          bench_resample (&options, resampler_formats[i], j, l);
+  }
+
+  return 0;
+}
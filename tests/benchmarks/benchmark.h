@@ -0,0 +1,112 @@
+/* GStreamer converter benchmarks
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <glib.h>
+
+#if defined (__i386__) || defined (__x86_64__)
+#include <x86intrin.h>
+#define HAVE_CYCLES
+#define read_cycles() __rdtsc ()
+#else
+#define read_cycles() G_GUINT64_CONSTANT (0)
+#endif
+
+/* run one iteration of a benchmark case */
+typedef void (*BenchmarkFunc) (gpointer data);
+
+typedef struct
+{
+  gboolean csv;
+  gdouble duration;             /* minimum seconds per case */
+} BenchmarkOptions;
+
+typedef struct
+{
+  guint iterations;
+  gdouble elapsed;              /* seconds */
+  guint64 cycles;
+} BenchmarkResult;
+
+/* runs @func until @options->duration has passed, after one untimed run to
+ * warm up the caches and lazily allocated state */
+static inline void
+benchmark_run (const BenchmarkOptions * options, BenchmarkFunc func,
+    gpointer data, BenchmarkResult * res)
+{
+  gint64 start, now;
+  guint64 cycles;
+
+  func (data);
+
+  res->iterations = 0;
+  start = g_get_monotonic_time ();
+  cycles = read_cycles ();
+  do {
+    func (data);
+    res->iterations++;
+    now = g_get_monotonic_time ();
+  } while (now - start < options->duration * G_USEC_PER_SEC);
+
+  res->cycles = read_cycles () - cycles;
+  res->elapsed = (now - start) / (gdouble) G_USEC_PER_SEC;
+}
+
+static inline void
+benchmark_print_header (const BenchmarkOptions * options)
+{
+  if (options->csv)
+    g_print ("test,in,out,in-size,out-size,variant,threads,"
+        "units-per-second,ns-per-unit,cycles-per-unit\n");
+}
+
+/* @units is the number of pixels or samples processed per iteration, @rate
+ * the number of frames or buffers per iteration */
+static inline void
+benchmark_print_result (const BenchmarkOptions * options, const gchar * test,
+    const gchar * in, const gchar * out, const gchar * in_size,
+    const gchar * out_size, const gchar * variant, guint threads,
+    const gchar * unit, guint64 units, const BenchmarkResult * res)
+{
+  gdouble total = (gdouble) units * res->iterations;
+  gdouble per_sec = res->iterations / res->elapsed;
+  gdouble ns = res->elapsed * 1e9 / total;
+
+  if (options->csv) {
+    g_print ("%s,%s,%s,%s,%s,%s,%u,%.3f,%.4f,", test, in, out, in_size,
+        out_size, variant, threads, total / res->elapsed, ns);
+#ifdef HAVE_CYCLES
+    g_print ("%.4f\n", res->cycles / total);
+#else
+    g_print ("\n");
+#endif
+  } else {
+    g_print ("%-14s %-10s -> %-10s %9s -> %-9s %-16s %2u: %10.1f/s "
+        "%8.3f ns/%s", test, in, out, in_size, out_size, variant, threads,
+        per_sec, ns, unit);
+#ifdef HAVE_CYCLES
+    g_print (" %8.3f cycles/%s", res->cycles / total, unit);
+#endif
+    g_print ("\n");
+  }
+}
+
+#endif /* __BENCHMARK_H__ */
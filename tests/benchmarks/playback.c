@@ -0,0 +1,536 @@
+/* GStreamer playback and encoding benchmark
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs scripted scenarios against playbin and encodebin and reports the
+ * latency distribution of every scenario:
+ *
+ *  encode:    encodebin throughput while making the test file from
+ *             videotestsrc and audiotestsrc
+ *  open:      from NULL to PAUSED, and until the first video frame
+ *  seek:      a storm of flushing seeks in PAUSED until ASYNC_DONE
+ *  switch:    going to READY, changing the URI and prerolling again
+ *  gapless:   from about-to-finish until the next stream starts
+ *  playback:  steady state throughput with unsynchronized sinks
+ *
+ * The sinks are fakesinks so that the results don't depend on the display
+ * or the sound card. Run with --csv to get one line per scenario. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib/gstdio.h>
+#include <gst/gst.h>
+#include <gst/pbutils/pbutils.h>
+
+typedef struct
+{
+  gboolean csv;
+  gint iterations;
+  gint seeks;
+  gint frames;
+  gchar *location;
+} Options;
+
+typedef struct
+{
+  GstElement *playbin;
+  GstBus *bus;
+
+  /* set from the streaming threads */
+  volatile gint first_frame;
+  gint64 first_frame_time;
+  volatile gint video_frames;
+  gint64 about_to_finish_time;
+  gint gapless_left;
+  gchar *uri;
+  GArray *gapless;
+} Player;
+
+static gint
+compare_double (gconstpointer a, gconstpointer b)
+{
+  gdouble da = *(const gdouble *) a, db = *(const gdouble *) b;
+
+  return da < db ? -1 : (da > db ? 1 : 0);
+}
+
+static gdouble
+percentile (GArray * values, gdouble p)
+{
+  guint idx = (guint) (p * (values->len - 1) + 0.5);
+
+  return g_array_index (values, gdouble, idx);
+}
+
+/* @values are in milliseconds, sorted in place */
+static void
+print_latencies (const Options * options, const gchar * scenario,
+    GArray * values)
+{
+  g_array_sort (values, compare_double);
+
+  if (values->len == 0) {
+    g_printerr ("%s: no results\n", scenario);
+    return;
+  }
+
+  if (options->csv)
+    g_print ("%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f\n", scenario, values->len,
+        g_array_index (values, gdouble, 0), percentile (values, 0.5),
+        percentile (values, 0.9), percentile (values, 0.99),
+        g_array_index (values, gdouble, values->len - 1));
+  else
+    g_print ("%-12s %5u runs: min %8.2f  p50 %8.2f  p90 %8.2f  p99 %8.2f  "
+        "max %8.2f ms\n", scenario, values->len,
+        g_array_index (values, gdouble, 0), percentile (values, 0.5),
+        percentile (values, 0.9), percentile (values, 0.99),
+        g_array_index (values, gdouble, values->len - 1));
+}
+
+static void
+print_rate (const Options * options, const gchar * scenario, gint frames,
+    gdouble seconds)
+{
+  if (options->csv)
+    g_print ("%s-fps,1,%.3f,%.3f,%.3f,%.3f,%.3f\n", scenario,
+        frames / seconds, frames / seconds, frames / seconds,
+        frames / seconds, frames / seconds);
+  else
+    g_print ("%-12s %5d frames in %.3f s: %.1f frames/s\n", scenario,
+        frames, seconds, frames / seconds);
+}
+
+static gdouble
+elapsed_ms (gint64 start)
+{
+  return (g_get_monotonic_time () - start) / 1000.0;
+}
+
+/* waits for @types, fails on errors */
+static gboolean
+wait_message (GstBus * bus, GstMessageType types)
+{
+  GstMessage *msg;
+  gboolean res = TRUE;
+
+  msg = gst_bus_timed_pop_filtered (bus, 30 * GST_SECOND,
+      types | GST_MESSAGE_ERROR);
+  if (msg == NULL) {
+    g_printerr ("timeout\n");
+    return FALSE;
+  }
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    GError *err = NULL;
+    gchar *dbg = NULL;
+
+    gst_message_parse_error (msg, &err, &dbg);
+    g_printerr ("error from %s: %s\n%s\n", GST_OBJECT_NAME (msg->src),
+        err->message, GST_STR_NULL (dbg));
+    g_clear_error (&err);
+    g_free (dbg);
+    res = FALSE;
+  }
+  gst_message_unref (msg);
+
+  return res;
+}
+
+static GstEncodingProfile *
+make_profile (void)
+{
+  GstEncodingContainerProfile *prof;
+  GstCaps *caps;
+
+  caps = gst_caps_new_empty_simple ("application/ogg");
+  prof = gst_encoding_container_profile_new ("benchmark", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("video/x-theora");
+  gst_encoding_container_profile_add_profile (prof, (GstEncodingProfile *)
+      gst_encoding_video_profile_new (caps, NULL, NULL, 1));
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("audio/x-vorbis");
+  gst_encoding_container_profile_add_profile (prof, (GstEncodingProfile *)
+      gst_encoding_audio_profile_new (caps, NULL, NULL, 1));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) prof;
+}
+
+static gboolean
+run_encode (const Options * options)
+{
+  GstElement *pipeline, *encodebin, *sink;
+  GstEncodingProfile *profile;
+  GError *err = NULL;
+  gchar *desc;
+  gint64 start;
+  gboolean res;
+
+  desc = g_strdup_printf ("videotestsrc num-buffers=%d pattern=ball ! "
+      "video/x-raw,width=640,height=360,framerate=30/1 ! "
+      "encodebin name=enc ! filesink name=sink "
+      "audiotestsrc num-buffers=%d samplesperbuffer=1470 ! "
+      "audio/x-raw,rate=44100 ! enc.", options->frames, options->frames);
+  pipeline = gst_parse_launch (desc, &err);
+  g_free (desc);
+  if (pipeline == NULL) {
+    g_printerr ("can't make the encoding pipeline: %s\n", err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  encodebin = gst_bin_get_by_name (GST_BIN (pipeline), "enc");
+  profile = make_profile ();
+  g_object_set (encodebin, "profile", profile, NULL);
+  gst_encoding_profile_unref (profile);
+  gst_object_unref (encodebin);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_object_set (sink, "location", options->location, NULL);
+  gst_object_unref (sink);
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  res = wait_message (GST_ELEMENT_BUS (pipeline), GST_MESSAGE_EOS);
+  if (res)
+    print_rate (options, "encode", options->frames, elapsed_ms (start) / 1000);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return res;
+}
+
+static void
+preroll_handoff (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    Player * player)
+{
+  if (g_atomic_int_compare_and_exchange (&player->first_frame, 0, 1))
+    player->first_frame_time = g_get_monotonic_time ();
+}
+
+static void
+handoff (GstElement * sink, GstBuffer * buffer, GstPad * pad, Player * player)
+{
+  g_atomic_int_inc (&player->video_frames);
+}
+
+static void
+about_to_finish (GstElement * playbin, Player * player)
+{
+  if (player->gapless_left <= 0)
+    return;
+
+  player->gapless_left--;
+  player->about_to_finish_time = g_get_monotonic_time ();
+  g_object_set (playbin, "uri", player->uri, NULL);
+}
+
+static void
+stream_start (GstBus * bus, GstMessage * msg, Player * player)
+{
+  gdouble ms;
+
+  if (player->about_to_finish_time == 0)
+    return;
+
+  ms = elapsed_ms (player->about_to_finish_time);
+  g_array_append_val (player->gapless, ms);
+  player->about_to_finish_time = 0;
+}
+
+static GstElement *
+make_sink (Player * player, gboolean video)
+{
+  GstElement *sink;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  if (video) {
+    g_object_set (sink, "signal-handoffs", TRUE, NULL);
+    g_signal_connect (sink, "preroll-handoff", G_CALLBACK (preroll_handoff),
+        player);
+    g_signal_connect (sink, "handoff", G_CALLBACK (handoff), player);
+  }
+
+  return sink;
+}
+
+static gboolean
+player_init (Player * player, const Options * options)
+{
+  gchar *path, *cwd;
+
+  memset (player, 0, sizeof (Player));
+
+  player->playbin = gst_element_factory_make ("playbin", NULL);
+  if (player->playbin == NULL) {
+    g_printerr ("no playbin\n");
+    return FALSE;
+  }
+
+  if (g_path_is_absolute (options->location)) {
+    path = g_strdup (options->location);
+  } else {
+    cwd = g_get_current_dir ();
+    path = g_build_filename (cwd, options->location, NULL);
+    g_free (cwd);
+  }
+  player->uri = gst_filename_to_uri (path, NULL);
+  g_free (path);
+
+  g_object_set (player->playbin, "uri", player->uri,
+      "video-sink", make_sink (player, TRUE),
+      "audio-sink", make_sink (player, FALSE), NULL);
+  g_signal_connect (player->playbin, "about-to-finish",
+      G_CALLBACK (about_to_finish), player);
+
+  player->bus = gst_element_get_bus (player->playbin);
+  gst_bus_enable_sync_message_emission (player->bus);
+  g_signal_connect (player->bus, "sync-message::stream-start",
+      G_CALLBACK (stream_start), player);
+
+  player->gapless = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  return TRUE;
+}
+
+static void
+player_clear (Player * player)
+{
+  gst_element_set_state (player->playbin, GST_STATE_NULL);
+  gst_bus_disable_sync_message_emission (player->bus);
+  gst_object_unref (player->bus);
+  gst_object_unref (player->playbin);
+  g_array_free (player->gapless, TRUE);
+  g_free (player->uri);
+}
+
+static gboolean
+run_open (Player * player, const Options * options)
+{
+  GArray *open, *first;
+  gboolean res = TRUE;
+  gint i;
+
+  open = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  first = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  for (i = 0; i < options->iterations && res; i++) {
+    gint64 start;
+    gdouble ms;
+
+    g_atomic_int_set (&player->first_frame, 0);
+    start = g_get_monotonic_time ();
+    gst_element_set_state (player->playbin, GST_STATE_PAUSED);
+    if ((res = wait_message (player->bus, GST_MESSAGE_ASYNC_DONE))) {
+      ms = elapsed_ms (start);
+      g_array_append_val (open, ms);
+      if (g_atomic_int_get (&player->first_frame)) {
+        ms = (player->first_frame_time - start) / 1000.0;
+        g_array_append_val (first, ms);
+      }
+    }
+    gst_element_set_state (player->playbin, GST_STATE_NULL);
+  }
+
+  print_latencies (options, "open", open);
+  print_latencies (options, "first-frame", first);
+
+  g_array_free (open, TRUE);
+  g_array_free (first, TRUE);
+
+  return res;
+}
+
+static gboolean
+run_seek (Player * player, const Options * options)
+{
+  GArray *seeks;
+  gboolean res;
+  gint64 duration = 0;
+  gint i;
+
+  gst_element_set_state (player->playbin, GST_STATE_PAUSED);
+  if (!(res = wait_message (player->bus, GST_MESSAGE_ASYNC_DONE)))
+    goto done;
+
+  if (!gst_element_query_duration (player->playbin, GST_FORMAT_TIME,
+          &duration) || duration <= 0) {
+    g_printerr ("no duration\n");
+    res = FALSE;
+    goto done;
+  }
+
+  seeks = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  /* the same sequence of positions for every run */
+  g_random_set_seed (0);
+  for (i = 0; i < options->seeks && res; i++) {
+    gint64 start, pos = g_random_int_range (0, 1000) * (duration / 1000);
+    gdouble ms;
+
+    start = g_get_monotonic_time ();
+    if (!gst_element_seek_simple (player->playbin, GST_FORMAT_TIME,
+            GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, pos)) {
+      g_printerr ("seek failed\n");
+      res = FALSE;
+      break;
+    }
+    if ((res = wait_message (player->bus, GST_MESSAGE_ASYNC_DONE))) {
+      ms = elapsed_ms (start);
+      g_array_append_val (seeks, ms);
+    }
+  }
+
+  print_latencies (options, "seek", seeks);
+  g_array_free (seeks, TRUE);
+
+done:
+  gst_element_set_state (player->playbin, GST_STATE_NULL);
+
+  return res;
+}
+
+static gboolean
+run_switch (Player * player, const Options * options)
+{
+  GArray *switches;
+  gboolean res;
+  gint i;
+
+  gst_element_set_state (player->playbin, GST_STATE_PAUSED);
+  if (!(res = wait_message (player->bus, GST_MESSAGE_ASYNC_DONE)))
+    goto done;
+
+  switches = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  for (i = 0; i < options->iterations && res; i++) {
+    gint64 start;
+    gdouble ms;
+
+    start = g_get_monotonic_time ();
+    gst_element_set_state (player->playbin, GST_STATE_READY);
+    g_object_set (player->playbin, "uri", player->uri, NULL);
+    gst_element_set_state (player->playbin, GST_STATE_PAUSED);
+    if ((res = wait_message (player->bus, GST_MESSAGE_ASYNC_DONE))) {
+      ms = elapsed_ms (start);
+      g_array_append_val (switches, ms);
+    }
+  }
+
+  print_latencies (options, "switch", switches);
+  g_array_free (switches, TRUE);
+
+done:
+  gst_element_set_state (player->playbin, GST_STATE_NULL);
+
+  return res;
+}
+
+/* plays the file options->iterations + 1 times back to back, which also
+ * gives the steady state throughput */
+static gboolean
+run_gapless (Player * player, const Options * options)
+{
+  gboolean res;
+  gint64 start;
+
+  player->gapless_left = options->iterations;
+  player->about_to_finish_time = 0;
+  g_array_set_size (player->gapless, 0);
+  g_atomic_int_set (&player->video_frames, 0);
+
+  start = g_get_monotonic_time ();
+  gst_element_set_state (player->playbin, GST_STATE_PLAYING);
+  res = wait_message (player->bus, GST_MESSAGE_EOS);
+  if (res) {
+    print_latencies (options, "gapless", player->gapless);
+    print_rate (options, "playback", g_atomic_int_get (&player->video_frames),
+        elapsed_ms (start) / 1000);
+  }
+  gst_element_set_state (player->playbin, GST_STATE_NULL);
+
+  return res;
+}
+
+int
+main (int argc, char **argv)
+{
+  Options options = { FALSE, 20, 100, 300, NULL };
+  gboolean keep = FALSE;
+  GOptionEntry entries[] = {
+    {"csv", 0, 0, G_OPTION_ARG_NONE, &options.csv,
+        "Print comma separated values: "
+          "scenario,runs,min,p50,p90,p99,max", NULL},
+    {"iterations", 'i', 0, G_OPTION_ARG_INT, &options.iterations,
+        "Runs of the open, switch and gapless scenarios (default 20)", NULL},
+    {"seeks", 's', 0, G_OPTION_ARG_INT, &options.seeks,
+        "Number of seeks in the seek storm (default 100)", NULL},
+    {"frames", 'f', 0, G_OPTION_ARG_INT, &options.frames,
+        "Number of frames in the test file (default 300)", NULL},
+    {"location", 'l', 0, G_OPTION_ARG_FILENAME, &options.location,
+        "Test file to create (default: a temporary file)", NULL},
+    {"keep", 'k', 0, G_OPTION_ARG_NONE, &keep,
+        "Don't remove the test file at the end", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  Player player;
+  gboolean res;
+
+  ctx = g_option_context_new ("- benchmark playbin and encodebin");
+  g_option_context_add_main_entries (ctx, entries, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (options.location == NULL)
+    options.location = g_build_filename (g_get_tmp_dir (),
+        "gst-playback-benchmark.ogg", NULL);
+
+  if (options.csv)
+    g_print ("scenario,runs,min-ms,p50-ms,p90-ms,p99-ms,max-ms\n");
+
+  res = run_encode (&options);
+
+  if (res && (res = player_init (&player, &options))) {
+    res = run_open (&player, &options) &&
+        run_seek (&player, &options) &&
+        run_switch (&player, &options) && run_gapless (&player, &options);
+    player_clear (&player);
+  }
+
+  if (!keep)
+    g_unlink (options.location);
+  g_free (options.location);
+
+  return res ? 0 : 1;
+}
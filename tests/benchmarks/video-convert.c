@@ -0,0 +1,299 @@
+/* GStreamer video converter and scaler benchmark
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures GstVideoConverter for a matrix of format pairs, sizes and thread
+ * counts and GstVideoScaler for the resampler methods. Run with --csv to get
+ * one line per case for regression tracking. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include "benchmark.h"
+
+static const GstVideoFormat convert_formats[] = {
+  GST_VIDEO_FORMAT_I420,
+  GST_VIDEO_FORMAT_NV12,
+  GST_VIDEO_FORMAT_YUY2,
+  GST_VIDEO_FORMAT_UYVY,
+  GST_VIDEO_FORMAT_AYUV,
+  GST_VIDEO_FORMAT_v210,
+  GST_VIDEO_FORMAT_I420_10LE,
+  GST_VIDEO_FORMAT_RGB,
+  GST_VIDEO_FORMAT_BGRx,
+  GST_VIDEO_FORMAT_ARGB,
+};
+
+/* the usual formats of sinks and encoders */
+static const GstVideoFormat target_formats[] = {
+  GST_VIDEO_FORMAT_I420,
+  GST_VIDEO_FORMAT_NV12,
+  GST_VIDEO_FORMAT_BGRx,
+};
+
+static const struct
+{
+  gint in_width, in_height;
+  gint out_width, out_height;
+} sizes[] = {
+  {
+  1920, 1080, 1920, 1080}, {
+  1920, 1080, 1280, 720}, {
+  1280, 720, 1920, 1080}, {
+  3840, 2160, 3840, 2160}
+};
+
+static const struct
+{
+  GstVideoResamplerMethod method;
+  const gchar *name;
+} scaler_methods[] = {
+  {
+  GST_VIDEO_RESAMPLER_METHOD_NEAREST, "nearest"}, {
+  GST_VIDEO_RESAMPLER_METHOD_LINEAR, "linear"}, {
+  GST_VIDEO_RESAMPLER_METHOD_CUBIC, "cubic"}, {
+  GST_VIDEO_RESAMPLER_METHOD_SINC, "sinc"}, {
+  GST_VIDEO_RESAMPLER_METHOD_LANCZOS, "lanczos"}
+};
+
+static const GstVideoFormat scaler_formats[] = {
+  GST_VIDEO_FORMAT_GRAY8,
+  GST_VIDEO_FORMAT_YUY2,
+  GST_VIDEO_FORMAT_BGRx,
+  GST_VIDEO_FORMAT_AYUV64,
+};
+
+typedef struct
+{
+  GstVideoConverter *convert;
+  GstVideoFrame src, dest;
+} ConvertData;
+
+typedef struct
+{
+  GstVideoScaler *hscale, *vscale;
+  GstVideoFormat format;
+  gpointer src, dest;
+  gint src_stride, dest_stride;
+  gint width, height;
+} ScaleData;
+
+static void
+run_convert (gpointer data)
+{
+  ConvertData *d = data;
+
+  gst_video_converter_frame (d->convert, &d->src, &d->dest);
+}
+
+static void
+run_scale (gpointer data)
+{
+  ScaleData *d = data;
+
+  gst_video_scaler_2d (d->hscale, d->vscale, d->format, d->src,
+      d->src_stride, d->dest, d->dest_stride, 0, 0, d->width, d->height);
+}
+
+static GstBuffer *
+alloc_frame (GstVideoInfo * info, GstVideoFrame * frame, GstMapFlags flags)
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+
+  buffer = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (info));
+  /* something that is not black so that no path can take a shortcut */
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  memset (map.data, 0x5a, map.size);
+  gst_buffer_unmap (buffer, &map);
+
+  gst_video_frame_map (frame, info, buffer, flags);
+
+  return buffer;
+}
+
+static void
+bench_convert (const BenchmarkOptions * options, GstVideoFormat in_format,
+    GstVideoFormat out_format, gint size, guint threads)
+{
+  GstVideoInfo in_info, out_info;
+  GstBuffer *inbuf, *outbuf;
+  BenchmarkResult res;
+  ConvertData d;
+  gchar in_size[32], out_size[32];
+
+  gst_video_info_set_format (&in_info, in_format, sizes[size].in_width,
+      sizes[size].in_height);
+  gst_video_info_set_format (&out_info, out_format, sizes[size].out_width,
+      sizes[size].out_height);
+
+  inbuf = alloc_frame (&in_info, &d.src, GST_MAP_READ);
+  outbuf = alloc_frame (&out_info, &d.dest, GST_MAP_WRITE);
+
+  d.convert = gst_video_converter_new (&in_info, &out_info,
+      gst_structure_new ("GstVideoConverter",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads, NULL));
+
+  benchmark_run (options, run_convert, &d, &res);
+
+  g_snprintf (in_size, sizeof (in_size), "%dx%d", sizes[size].in_width,
+      sizes[size].in_height);
+  g_snprintf (out_size, sizeof (out_size), "%dx%d", sizes[size].out_width,
+      sizes[size].out_height);
+
+  benchmark_print_result (options, "videoconvert",
+      gst_video_format_to_string (in_format),
+      gst_video_format_to_string (out_format), in_size, out_size, "default",
+      threads, "pixel",
+      (guint64) sizes[size].out_width * sizes[size].out_height, &res);
+
+  gst_video_converter_free (d.convert);
+  gst_video_frame_unmap (&d.src);
+  gst_video_frame_unmap (&d.dest);
+  gst_buffer_unref (inbuf);
+  gst_buffer_unref (outbuf);
+}
+
+static void
+bench_scale (const BenchmarkOptions * options, GstVideoFormat format,
+    gint method, gint size)
+{
+  const GstVideoFormatInfo *finfo = gst_video_format_get_info (format);
+  BenchmarkResult res;
+  ScaleData d;
+  gint in_width = sizes[size].in_width, in_height = sizes[size].in_height;
+  gint bpp = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, 0);
+  gchar in_size[32], out_size[32];
+
+  d.format = format;
+  d.width = sizes[size].out_width;
+  d.height = sizes[size].out_height;
+  d.src_stride = GST_ROUND_UP_4 (in_width * bpp);
+  d.dest_stride = GST_ROUND_UP_4 (d.width * bpp);
+  d.src = g_malloc (d.src_stride * in_height);
+  d.dest = g_malloc (d.dest_stride * d.height);
+  memset (d.src, 0x5a, d.src_stride * in_height);
+
+  d.hscale = gst_video_scaler_new (scaler_methods[method].method,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, in_width, d.width, NULL);
+  d.vscale = gst_video_scaler_new (scaler_methods[method].method,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, in_height, d.height, NULL);
+
+  /* packed 4:2:2 needs a combined luma and chroma scaler, like the
+   * converter makes */
+  if (GST_VIDEO_FORMAT_INFO_IS_YUV (finfo) && bpp == 2) {
+    GstVideoScaler *y_scale = d.hscale, *uv_scale;
+
+    uv_scale = gst_video_scaler_new (scaler_methods[method].method,
+        GST_VIDEO_SCALER_FLAG_NONE, gst_video_scaler_get_max_taps (y_scale),
+        in_width / 2, d.width / 2, NULL);
+    d.hscale = gst_video_scaler_combine_packed_YUV (y_scale, uv_scale,
+        format, format);
+    gst_video_scaler_free (y_scale);
+    gst_video_scaler_free (uv_scale);
+  }
+
+  benchmark_run (options, run_scale, &d, &res);
+
+  g_snprintf (in_size, sizeof (in_size), "%dx%d", in_width, in_height);
+  g_snprintf (out_size, sizeof (out_size), "%dx%d", d.width, d.height);
+
+  benchmark_print_result (options, "videoscaler",
+      gst_video_format_to_string (format), gst_video_format_to_string (format),
+      in_size, out_size, scaler_methods[method].name, 1, "pixel",
+      (guint64) d.width * d.height, &res);
+
+  gst_video_scaler_free (d.hscale);
+  gst_video_scaler_free (d.vscale);
+  g_free (d.src);
+  g_free (d.dest);
+}
+
+int
+main (int argc, char **argv)
+{
+  BenchmarkOptions options = { FALSE, 0.5 };
+  gint n_threads = 0;
+  gboolean no_convert = FALSE, no_scale = FALSE;
+  GOptionEntry entries[] = {
+    {"csv", 0, 0, G_OPTION_ARG_NONE, &options.csv,
+        "Print comma separated values", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &options.duration,
+        "Minimum run time of every case in seconds (default 0.5)", NULL},
+    {"threads", 't', 0, G_OPTION_ARG_INT, &n_threads,
+        "Maximum number of converter threads (default: number of CPUs)",
+        NULL},
+    {"no-convert", 0, 0, G_OPTION_ARG_NONE, &no_convert,
+        "Skip the converter cases", NULL},
+    {"no-scale", 0, 0, G_OPTION_ARG_NONE, &no_scale,
+        "Skip the scaler cases", NULL},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  guint i, j, s, t, max_threads;
+
+  ctx = g_option_context_new ("- benchmark the video converter and scaler");
+  g_option_context_add_main_entries (ctx, entries, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  max_threads = n_threads > 0 ? n_threads : g_get_num_processors ();
+
+  benchmark_print_header (&options);
+
+  if (!no_convert) {
+    for (s = 0; s < G_N_ELEMENTS (sizes); s++) {
+      for (i = 0; i < G_N_ELEMENTS (convert_formats); i++) {
+        for (j = 0; j < G_N_ELEMENTS (target_formats); j++) {
+          /* 1, 2, 4, ... threads and the maximum */
+          for (t = 1; t < max_threads; t *= 2)
+            bench_convert (&options, convert_formats[i], target_formats[j], s,
+                t);
+          bench_convert (&options, convert_formats[i], target_formats[j], s,
+              max_threads);
+        }
+      }
+    }
+  }
+
+  if (!no_scale) {
+    for (s = 0; s < G_N_ELEMENTS (sizes); s++) {
+      /* the scaler is only interesting when the size changes */
+      if (sizes[s].in_width == sizes[s].out_width)
+        continue;
+      for (i = 0; i < G_N_ELEMENTS (scaler_formats); i++)
+        for (j = 0; j < G_N_ELEMENTS (scaler_methods); j++)
+          bench_scale (&options, scaler_formats[i], j, s);
+    }
+  }
+
+  return 0;
+}
@@ -987,6 +987,72 @@ GST_START_TEST (test_clip)
 
 GST_END_TEST;
 
+/* check that a stalled pad doesn't block the other pads with a timeout */
+GST_START_TEST (test_timeout)
+{
+  GstSegment segment;
+  GstElement *bin, *adder, *sink;
+  GstPad *sinkpad1, *sinkpad2;
+  GstStateChangeReturn state_res;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  GstCaps *caps;
+
+  bin = gst_pipeline_new ("pipeline");
+  adder = gst_element_factory_make ("adder", "adder");
+  g_object_set (adder, "timeout", 50 * GST_MSECOND, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), adder, sink, NULL);
+  fail_unless (gst_element_link (adder, sink));
+
+  state_res = gst_element_set_state (bin, GST_STATE_PLAYING);
+  ck_assert_int_ne (state_res, GST_STATE_CHANGE_FAILURE);
+
+  sinkpad1 = gst_element_get_request_pad (adder, "sink_%u");
+  fail_if (sinkpad1 == NULL, NULL);
+  sinkpad2 = gst_element_get_request_pad (adder, "sink_%u");
+  fail_if (sinkpad2 == NULL, NULL);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+#if G_BYTE_ORDER == G_BIG_ENDIAN
+      "format", G_TYPE_STRING, "S16BE",
+#else
+      "format", G_TYPE_STRING, "S16LE",
+#endif
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 44100, "channels", G_TYPE_INT, 2, NULL);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  gst_pad_send_event (sinkpad1, gst_event_new_stream_start ("test1"));
+  gst_pad_set_caps (sinkpad1, caps);
+  gst_pad_send_event (sinkpad1, gst_event_new_segment (&segment));
+  gst_pad_send_event (sinkpad2, gst_event_new_stream_start ("test2"));
+  gst_pad_set_caps (sinkpad2, caps);
+  gst_pad_send_event (sinkpad2, gst_event_new_segment (&segment));
+  gst_caps_unref (caps);
+
+  /* sinkpad2 never gets data, this only returns after the timeout */
+  buffer = gst_buffer_new_and_alloc (44100);
+  GST_BUFFER_TIMESTAMP (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = 250 * GST_MSECOND;
+  ret = gst_pad_chain (sinkpad1, buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+  fail_unless (handoff_buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (handoff_buffer), 44100);
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  gst_element_release_request_pad (adder, sinkpad1);
+  gst_object_unref (sinkpad1);
+  gst_element_release_request_pad (adder, sinkpad2);
+  gst_object_unref (sinkpad2);
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_object_unref (bin);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_duration_is_max)
 {
   GstElement *bin, *src[3], *adder, *sink;
@@ -1273,6 +1339,7 @@ adder_suite (void)
   tcase_add_test (tc_chain, test_add_pad);
   tcase_add_test (tc_chain, test_remove_pad);
   tcase_add_test (tc_chain, test_clip);
+  tcase_add_test (tc_chain, test_timeout);
   tcase_add_test (tc_chain, test_duration_is_max);
   tcase_add_test (tc_chain, test_duration_unknown_overrides);
   tcase_add_test (tc_chain, test_loop);
@@ -348,6 +348,139 @@ GST_START_TEST (test_segment)
 
 GST_END_TEST;
 
+static gint new_sample_count;
+
+static GstFlowReturn
+count_new_sample (GstAppSink * appsink, gpointer user_data)
+{
+  new_sample_count++;
+
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_pull_samples)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstAppSinkCallbacks callbacks = { NULL };
+  GList *samples, *l;
+  guint i;
+
+  sink = setup_appsink ();
+
+  new_sample_count = 0;
+  callbacks.new_sample = count_new_sample;
+  gst_app_sink_set_callbacks (GST_APP_SINK (sink), &callbacks, NULL, NULL);
+  g_object_set (sink, "wait-for-batch", 4, NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 6; i++) {
+    buffer = gst_buffer_new_and_alloc (4);
+    GST_BUFFER_OFFSET (buffer) = i;
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* only the 4th, 5th and 6th buffer complete a batch */
+  fail_unless_equals_int (new_sample_count, 3);
+
+  samples = gst_app_sink_pull_samples (GST_APP_SINK (sink), 4,
+      GST_CLOCK_TIME_NONE);
+  fail_unless_equals_int (g_list_length (samples), 4);
+  for (l = samples, i = 0; l; l = l->next, i++) {
+    buffer = gst_sample_get_buffer (l->data);
+    fail_unless_equals_int (GST_BUFFER_OFFSET (buffer), i);
+    fail_unless (gst_sample_get_caps (l->data) != NULL);
+  }
+  g_list_free_full (samples, (GDestroyNotify) gst_sample_unref);
+
+  /* only two left, the timeout returns the incomplete batch */
+  samples = gst_app_sink_pull_samples (GST_APP_SINK (sink), 4,
+      10 * GST_MSECOND);
+  fail_unless_equals_int (g_list_length (samples), 2);
+  g_list_free_full (samples, (GDestroyNotify) gst_sample_unref);
+
+  samples = gst_app_sink_pull_samples (GST_APP_SINK (sink), 4, 0);
+  fail_unless (samples == NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+static gboolean
+watch_pull_cb (gpointer user_data)
+{
+  GstAppSink *appsink = user_data;
+  GstSample *sample;
+
+  while ((sample = gst_app_sink_try_pull_sample (appsink, 0))) {
+    new_sample_count++;
+    gst_sample_unref (sample);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+GST_START_TEST (test_try_pull_sample)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstSample *sample;
+  GMainContext *context;
+  GSource *source;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  /* nothing queued, both return after the timeout */
+  fail_unless (gst_app_sink_try_pull_preroll (GST_APP_SINK (sink), 0) == NULL);
+  fail_unless (gst_app_sink_try_pull_sample (GST_APP_SINK (sink),
+          10 * GST_MSECOND) == NULL);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  g_signal_emit_by_name (sink, "try-pull-preroll", GST_SECOND, &sample);
+  fail_unless (sample != NULL);
+  fail_unless (gst_sample_get_buffer (sample) == buffer);
+  gst_sample_unref (sample);
+
+  sample = gst_app_sink_try_pull_sample (GST_APP_SINK (sink), GST_SECOND);
+  fail_unless (sample != NULL);
+  fail_unless (gst_sample_get_buffer (sample) == buffer);
+  gst_sample_unref (sample);
+
+  /* the watch is only dispatched when there is something to pull */
+  context = g_main_context_new ();
+  source = gst_app_sink_create_watch (GST_APP_SINK (sink));
+  g_source_set_callback (source, watch_pull_cb, sink, NULL);
+  g_source_attach (source, context);
+
+  new_sample_count = 0;
+  while (g_main_context_iteration (context, FALSE));
+  fail_unless_equals_int (new_sample_count, 0);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  fail_unless (g_main_context_iteration (context, FALSE));
+  fail_unless_equals_int (new_sample_count, 2);
+
+  g_source_destroy (source);
+  g_source_unref (source);
+  g_main_context_unref (context);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsink_suite (void)
 {
@@ -362,6 +495,8 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_buffer_list_fallback);
   tcase_add_test (tc_chain, test_buffer_list_fallback_signal);
   tcase_add_test (tc_chain, test_segment);
+  tcase_add_test (tc_chain, test_pull_samples);
+  tcase_add_test (tc_chain, test_try_pull_sample);
 
   return s;
 }
@@ -121,6 +121,211 @@ GST_START_TEST (test_appsrc_non_null_caps)
 
 GST_END_TEST;
 
+/*
+ * Pushes single buffers and a buffer list in lock-free mode and checks that
+ * they all come out in order.
+ */
+GST_START_TEST (test_appsrc_lock_free_buffer_list)
+{
+  GstElement *src;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  GList *l;
+  guint i;
+
+  src = setup_appsrc ();
+  g_object_set (src, "lock-free", TRUE, "format", GST_FORMAT_TIME, NULL);
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < 2; i++) {
+    buffer = gst_buffer_new_and_alloc (4);
+    GST_BUFFER_OFFSET (buffer) = i;
+    fail_unless (gst_app_src_push_buffer (GST_APP_SRC (src),
+            buffer) == GST_FLOW_OK);
+  }
+
+  list = gst_buffer_list_new ();
+  for (i = 2; i < 5; i++) {
+    buffer = gst_buffer_new_and_alloc (4);
+    GST_BUFFER_OFFSET (buffer) = i;
+    gst_buffer_list_add (list, buffer);
+  }
+  fail_unless (gst_app_src_push_buffer_list (GST_APP_SRC (src),
+          list) == GST_FLOW_OK);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_OFFSET (buffer) = 5;
+  fail_unless (gst_app_src_push_buffer (GST_APP_SRC (src),
+          buffer) == GST_FLOW_OK);
+
+  fail_unless (gst_app_src_end_of_stream (GST_APP_SRC (src)) == GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 6)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  for (l = buffers, i = 0; l; l = l->next, i++)
+    fail_unless_equals_int (GST_BUFFER_OFFSET (l->data), i);
+  fail_unless_equals_int (gst_app_src_get_current_level_bytes (GST_APP_SRC
+          (src)), 0);
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
+static GMutex block_mutex;
+static GCond block_cond;
+static gboolean block_reached, block_released;
+
+static GstPadProbeReturn
+block_first_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  g_mutex_lock (&block_mutex);
+  if (!block_reached) {
+    block_reached = TRUE;
+    g_cond_broadcast (&block_cond);
+    while (!block_released)
+      g_cond_wait (&block_cond, &block_mutex);
+  }
+  g_mutex_unlock (&block_mutex);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/*
+ * Flushes in lock-free mode while a buffer list is being pushed out and
+ * checks that the buffers of the list that were thrown away are not
+ * accounted for anymore and that data still flows afterwards.
+ */
+GST_START_TEST (test_appsrc_lock_free_flush_buffer_list)
+{
+  GstElement *src;
+  GstBufferList *list;
+  GstBuffer *buffer;
+  GstPad *srcpad;
+  GstCaps *caps, *ccaps;
+  guint i;
+
+  src = setup_appsrc ();
+  caps = gst_caps_from_string (SAMPLE_CAPS);
+  g_object_set (src, "lock-free", TRUE, "format", GST_FORMAT_TIME,
+      "caps", caps, NULL);
+
+  block_reached = block_released = FALSE;
+  srcpad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER,
+      block_first_buffer_probe, NULL, NULL);
+  gst_object_unref (srcpad);
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 5; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (4));
+  fail_unless (gst_app_src_push_buffer_list (GST_APP_SRC (src),
+          list) == GST_FLOW_OK);
+
+  /* the first buffer of the list is out, the other 4 are pending */
+  g_mutex_lock (&block_mutex);
+  while (!block_reached)
+    g_cond_wait (&block_cond, &block_mutex);
+  g_mutex_unlock (&block_mutex);
+  fail_unless_equals_int (gst_app_src_get_current_level_bytes (GST_APP_SRC
+          (src)), 16);
+
+  fail_unless (gst_element_send_event (src, gst_event_new_flush_start ()));
+
+  g_mutex_lock (&block_mutex);
+  block_released = TRUE;
+  g_cond_broadcast (&block_cond);
+  g_mutex_unlock (&block_mutex);
+
+  fail_unless (gst_element_send_event (src, gst_event_new_flush_stop (TRUE)));
+  fail_unless_equals_int (gst_app_src_get_current_level_bytes (GST_APP_SRC
+          (src)), 0);
+
+  gst_check_drop_buffers ();
+
+  /* the retained caps go out before the new buffer */
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_app_src_push_buffer (GST_APP_SRC (src),
+          buffer) == GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 1)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  ccaps = gst_pad_get_current_caps (mysinkpad);
+  fail_unless (ccaps != NULL);
+  fail_unless (gst_caps_is_equal (ccaps, caps));
+  gst_caps_unref (ccaps);
+  fail_unless_equals_int (gst_app_src_get_current_level_bytes (GST_APP_SRC
+          (src)), 0);
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  gst_caps_unref (caps);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
+/*
+ * Sets the data of the stream and checks that every buffer shares the memory
+ * of the right range of the data.
+ */
+GST_START_TEST (test_appsrc_set_data)
+{
+  GstElement *src;
+  GBytes *bytes;
+  const guint8 *data;
+  GList *l;
+  gsize size, offset;
+  guint8 *d;
+
+  d = g_malloc (10000);
+  for (offset = 0; offset < 10000; offset++)
+    d[offset] = offset;
+  bytes = g_bytes_new_take (d, 10000);
+  data = g_bytes_get_data (bytes, &size);
+
+  src = setup_appsrc ();
+  gst_app_src_set_data (GST_APP_SRC (src), bytes);
+  g_bytes_unref (bytes);
+
+  fail_unless_equals_int (gst_app_src_get_stream_type (GST_APP_SRC (src)),
+      GST_APP_STREAM_TYPE_RANDOM_ACCESS);
+  fail_unless_equals_int64 (gst_app_src_get_size (GST_APP_SRC (src)), size);
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  /* 4096 + 4096 + 1808 bytes with the default blocksize */
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 3)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  for (l = buffers, offset = 0; l; l = l->next) {
+    GstMapInfo info;
+
+    fail_unless (gst_buffer_map (l->data, &info, GST_MAP_READ));
+    fail_unless (info.data == data + offset);
+    offset += info.size;
+    gst_buffer_unmap (l->data, &info);
+  }
+  fail_unless_equals_int (offset, size);
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
 static GstAppSinkCallbacks app_callbacks;
 
 typedef struct
@@ -427,6 +632,9 @@ appsrc_suite (void)
   tcase_add_test (tc_chain, test_appsrc_non_null_caps);
   tcase_add_test (tc_chain, test_appsrc_set_caps_twice);
   tcase_add_test (tc_chain, test_appsrc_caps_in_push_modes);
+  tcase_add_test (tc_chain, test_appsrc_lock_free_buffer_list);
+  tcase_add_test (tc_chain, test_appsrc_lock_free_flush_buffer_list);
+  tcase_add_test (tc_chain, test_appsrc_set_data);
 
   if (RUNNING_ON_VALGRIND)
     tcase_add_loop_test (tc_chain, test_appsrc_block_deadlock, 0, 5);
@@ -641,6 +641,41 @@ GST_START_TEST (test_int_conversion)
         );
   }
 
+  /* signed <-> unsigned with the other endianness, done in place */
+  {
+    guint8 in16[] = { 0x00, 0x00, 0x80, 0x00, 0x80, 0xff };
+    guint8 out16[] = { 0x80, 0x00, 0x80, 0x80, 0x7f, 0x80 };
+    guint8 in24[] = { 0x00, 0x00, 0x00, 0x01, 0x02, 0x03 };
+    guint8 out24[] = { 0x80, 0x00, 0x00, 0x83, 0x02, 0x01 };
+    guint8 in32[] = { 0x00, 0x00, 0x00, 0x80, 0x01, 0x02, 0x03, 0x04 };
+    guint8 out32[] = { 0x00, 0x00, 0x00, 0x00, 0x84, 0x03, 0x02, 0x01 };
+
+    RUN_CONVERSION ("16 signed LE to 16 unsigned BE",
+        in16, get_int_caps (1, G_LITTLE_ENDIAN, 16, 16, TRUE),
+        out16, get_int_caps (1, G_BIG_ENDIAN, 16, 16, FALSE)
+        );
+    RUN_CONVERSION_NOT_INPLACE ("16 unsigned BE to 16 signed LE",
+        out16, get_int_caps (1, G_BIG_ENDIAN, 16, 16, FALSE),
+        in16, get_int_caps (1, G_LITTLE_ENDIAN, 16, 16, TRUE)
+        );
+    RUN_CONVERSION ("24 signed LE to 24 unsigned BE",
+        in24, get_int_caps (1, G_LITTLE_ENDIAN, 24, 24, TRUE),
+        out24, get_int_caps (1, G_BIG_ENDIAN, 24, 24, FALSE)
+        );
+    RUN_CONVERSION ("24 unsigned BE to 24 signed LE",
+        out24, get_int_caps (1, G_BIG_ENDIAN, 24, 24, FALSE),
+        in24, get_int_caps (1, G_LITTLE_ENDIAN, 24, 24, TRUE)
+        );
+    RUN_CONVERSION ("32 signed LE to 32 unsigned BE",
+        in32, get_int_caps (1, G_LITTLE_ENDIAN, 32, 32, TRUE),
+        out32, get_int_caps (1, G_BIG_ENDIAN, 32, 32, FALSE)
+        );
+    RUN_CONVERSION_NOT_INPLACE ("32 unsigned BE to 32 signed LE",
+        out32, get_int_caps (1, G_BIG_ENDIAN, 32, 32, FALSE),
+        in32, get_int_caps (1, G_LITTLE_ENDIAN, 32, 32, TRUE)
+        );
+  }
+
   /* 32 bit signed -> 16 bit signed for rounding check */
   /* NOTE: if audioconvert was doing dithering we'd have a problem */
   {
@@ -1620,6 +1655,89 @@ GST_START_TEST (test_gap_buffers)
 
 GST_END_TEST;
 
+/* push a frame of 4 channels with a downmix meta of @matrix to stereo, or
+ * without one if @matrix is NULL, and return the output frame in @out */
+static void
+push_downmix_frame (const gfloat ** matrix, gfloat out[2])
+{
+  static const GstAudioChannelPosition in_pos[4] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT
+  };
+  static const GstAudioChannelPosition out_pos[2] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT
+  };
+  gfloat in[4] = { 0.1, 0.2, 0.3, 0.4 };
+  GstBuffer *inbuffer, *outbuffer;
+
+  inbuffer = gst_buffer_new_and_alloc (sizeof (in));
+  gst_buffer_fill (inbuffer, 0, in, sizeof (in));
+  if (matrix)
+    gst_buffer_add_audio_downmix_meta (inbuffer, in_pos, 4, out_pos, 2,
+        matrix);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, inbuffer), GST_FLOW_OK);
+  fail_unless (g_list_length (buffers) == 1);
+  outbuffer = buffers->data;
+  buffers = g_list_remove (buffers, outbuffer);
+
+  fail_unless_equals_int (gst_buffer_get_size (outbuffer), 2 * sizeof (gfloat));
+  fail_unless (gst_buffer_get_audio_downmix_meta (outbuffer) == NULL);
+  gst_buffer_extract (outbuffer, 0, out, 2 * sizeof (gfloat));
+  gst_buffer_unref (outbuffer);
+}
+
+GST_START_TEST (test_downmix_meta)
+{
+  static const GstAudioChannelPosition in_pos[4] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT
+  };
+  gfloat row0[4] = { 0.5, 0.0, 0.5, 0.0 };
+  gfloat row1[4] = { 0.0, 0.25, 0.0, 0.75 };
+  const gfloat *matrix[2] = { row0, row1 };
+  const gfloat *swapped[2] = { row1, row0 };
+  GstElement *audioconvert;
+  GstCaps *incaps, *outcaps;
+  gfloat out[2], def[2];
+
+  incaps = get_float_mc_caps (4, G_BYTE_ORDER, 32, in_pos);
+  outcaps = get_float_mc_caps (2, G_BYTE_ORDER, 32, NULL);
+  audioconvert = setup_audioconvert (outcaps);
+
+  fail_unless (gst_element_set_state (audioconvert,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+  gst_check_setup_events (mysrcpad, audioconvert, incaps, GST_FORMAT_TIME);
+
+  /* mixed with the channel positions */
+  push_downmix_frame (NULL, def);
+
+  /* mixed with the matrix, which can change for every buffer */
+  push_downmix_frame (matrix, out);
+  fail_unless (ABS (out[0] - 0.2) < 1e-6);
+  fail_unless (ABS (out[1] - 0.35) < 1e-6);
+  push_downmix_frame (swapped, out);
+  fail_unless (ABS (out[0] - 0.35) < 1e-6);
+  fail_unless (ABS (out[1] - 0.2) < 1e-6);
+
+  /* and back to the positions */
+  push_downmix_frame (NULL, out);
+  fail_unless (out[0] == def[0] && out[1] == def[1]);
+
+  fail_unless (gst_element_set_state (audioconvert,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+  cleanup_audioconvert (audioconvert);
+  gst_caps_unref (incaps);
+  gst_caps_unref (outcaps);
+}
+
+GST_END_TEST;
 
 static Suite *
 audioconvert_suite (void)
@@ -1639,6 +1757,7 @@ audioconvert_suite (void)
   tcase_add_test (tc_chain, test_convert_undefined_multichannel);
   tcase_add_test (tc_chain, test_preserve_width);
   tcase_add_test (tc_chain, test_gap_buffers);
+  tcase_add_test (tc_chain, test_downmix_meta);
 
   return s;
 }
@@ -141,6 +141,116 @@ GST_START_TEST (test_add_client)
 
 GST_END_TEST;
 
+GST_START_TEST (test_add_client_epoll)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  int pfd[2];
+  gchar data[4];
+
+  sink = setup_multifdsink ();
+  /* falls back to poll where epoll is not available */
+  gst_util_set_object_arg (G_OBJECT (sink), "backend", "epoll");
+
+  fail_if (pipe (pfd) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  /* add the client */
+  g_signal_emit_by_name (sink, "add", pfd[1]);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "dead", 4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  GST_DEBUG ("reading");
+  fail_if (read (pfd[0], data, 4) < 4);
+  fail_unless (strncmp (data, "dead", 4) == 0);
+  wait_bytes_served (sink, 4);
+
+  /* the client stays writable, the next buffer must not wait for an event */
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "beef", 4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  fail_if (read (pfd[0], data, 4) < 4);
+  fail_unless (strncmp (data, "beef", 4) == 0);
+  wait_bytes_served (sink, 8);
+
+  GST_DEBUG ("cleaning up multifdsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_service_threads)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  int pfd[3][2];
+  gchar data[4];
+  gint i;
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "service-threads", 2, NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  /* the clients are spread over both threads */
+  for (i = 0; i < 3; i++) {
+    fail_if (pipe (pfd[i]) == -1);
+    g_signal_emit_by_name (sink, "add", pfd[i][1]);
+  }
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "dead", 4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  for (i = 0; i < 3; i++) {
+    GST_DEBUG ("reading client %d", i);
+    fail_if (read (pfd[i][0], data, 4) < 4);
+    fail_unless (strncmp (data, "dead", 4) == 0);
+  }
+  wait_bytes_served (sink, 12);
+
+  /* removing a client from the application still works */
+  g_signal_emit_by_name (sink, "remove", pfd[1][1]);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "beef", 4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  fail_if (read (pfd[0][0], data, 4) < 4);
+  fail_unless (strncmp (data, "beef", 4) == 0);
+  fail_if (read (pfd[2][0], data, 4) < 4);
+  fail_unless (strncmp (data, "beef", 4) == 0);
+  wait_bytes_served (sink, 20);
+
+  GST_DEBUG ("cleaning up multifdsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  for (i = 0; i < 3; i++) {
+    close (pfd[i][0]);
+    close (pfd[i][1]);
+  }
+
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_add_client_in_null_state)
 {
   GstElement *sink;
@@ -797,6 +907,70 @@ GST_START_TEST (test_client_next_keyframe)
 
 GST_END_TEST;
 
+/* burst from the right keyframe after the queue was trimmed many times */
+GST_START_TEST (test_burst_client_keyframe_long_queue)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  int pfd1[2];
+  gint i;
+  guint buffers_queued;
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "bytes-min", 100, NULL);
+  g_object_set (sink, "sync-method", 4, NULL);  /* 4 = burst_keyframe */
+  g_object_set (sink, "burst-format", GST_FORMAT_BYTES, NULL);
+  g_object_set (sink, "burst-value", (guint64) 80, NULL);
+
+  fail_if (pipe (pfd1) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  /* keyframe every 8 buffers, the last one is 195 */
+  for (i = 0; i < 200; i++) {
+    GstBuffer *buffer = gst_new_buffer (i);
+
+    if (i % 8 != 3)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* 7 buffers for bytes-min, the keyframe is within those */
+  g_object_get (sink, "buffers-queued", &buffers_queued, NULL);
+  fail_unless_equals_int (buffers_queued, 7);
+
+  g_signal_emit_by_name (sink, "add", pfd1[1]);
+
+  {
+    GstBuffer *buffer = gst_new_buffer (200);
+
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* 80 bytes is 5 buffers, the first keyframe before those is 195 */
+  GST_DEBUG ("Reading from client 1");
+  fail_unless_read ("client 1", pfd1[0], 16, "deadbee000000c3");
+  fail_unless_read ("client 1", pfd1[0], 16, "deadbee000000c4");
+  fail_unless_read ("client 1", pfd1[0], 16, "deadbee000000c5");
+  fail_unless_read ("client 1", pfd1[0], 16, "deadbee000000c6");
+  fail_unless_read ("client 1", pfd1[0], 16, "deadbee000000c7");
+  fail_unless_read ("client 1", pfd1[0], 16, "deadbee000000c8");
+
+  GST_DEBUG ("cleaning up multifdsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 /* FIXME: add test simulating chained oggs where:
  * sync-method is burst-on-connect
  * (when multifdsink actually does burst-on-connect based on byte size, not
@@ -813,6 +987,8 @@ multifdsink_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_no_clients);
   tcase_add_test (tc_chain, test_add_client);
+  tcase_add_test (tc_chain, test_add_client_epoll);
+  tcase_add_test (tc_chain, test_service_threads);
   tcase_add_test (tc_chain, test_add_client_in_null_state);
   tcase_add_test (tc_chain, test_streamheader);
   tcase_add_test (tc_chain, test_change_streamheader);
@@ -820,6 +996,7 @@ multifdsink_suite (void)
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
   tcase_add_test (tc_chain, test_client_next_keyframe);
+  tcase_add_test (tc_chain, test_burst_client_keyframe_long_queue);
 
   return s;
 }
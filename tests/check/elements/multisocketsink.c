@@ -25,8 +25,10 @@
 #include <sys/filio.h>
 #endif
 
+#include <glib/gstdio.h>
 #include <gio/gio.h>
 #include <gst/check/gstcheck.h>
+#include <gst/allocators/gstfdmemory.h>
 
 static GstPad *mysrcpad;
 
@@ -236,6 +238,74 @@ GST_START_TEST (test_add_client)
 
 GST_END_TEST;
 
+GST_START_TEST (test_zero_copy)
+{
+  GstElement *sink;
+  GstAllocator *alloc;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  gchar data[9], *big, *bigdata;
+  gchar *tmpname;
+  GSocket *sinksocket, *srcsocket;
+  gint fd;
+  gsize bigsize = 64 * 1024;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "zero-copy", TRUE, NULL);
+  fail_unless (setup_handles (&sinksocket, &srcsocket));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  g_signal_emit_by_name (sink, "add", sinksocket);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+  gst_caps_unref (caps);
+
+  /* file backed memory, sent with sendfile where available */
+  fd = g_file_open_tmp (NULL, &tmpname, NULL);
+  fail_unless (fd >= 0);
+  fail_unless (write (fd, "xxdead good", 11) == 11);
+
+  alloc = gst_fd_allocator_new ();
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer,
+      gst_fd_allocator_alloc (alloc, fd, 11, GST_FD_MEMORY_FLAG_NONE));
+  gst_buffer_resize (buffer, 2, 9);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  fail_if (read_handle (srcsocket, data, 9) < 9);
+  fail_unless (strncmp (data, "dead good", 9) == 0);
+  wait_bytes_served (sink, 9);
+
+  /* a payload large enough for MSG_ZEROCOPY, unix sockets don't support it
+   * so this must fall back to a copying send */
+  big = g_malloc (bigsize);
+  memset (big, 'z', bigsize);
+  fail_unless (gst_pad_push (mysrcpad,
+          gst_buffer_new_wrapped (g_memdup (big, bigsize),
+              bigsize)) == GST_FLOW_OK);
+
+  bigdata = g_malloc (bigsize);
+  fail_unless (read_handle_n_bytes_exactly (srcsocket, bigdata, bigsize));
+  fail_unless (memcmp (big, bigdata, bigsize) == 0);
+  wait_bytes_served (sink, 9 + bigsize);
+
+  GST_DEBUG ("cleaning up multisocketsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  g_free (big);
+  g_free (bigdata);
+  gst_object_unref (alloc);
+  g_unlink (tmpname);
+  g_free (tmpname);
+  g_object_unref (srcsocket);
+  g_object_unref (sinksocket);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   GSocket *sinksocket, *srcsocket;
@@ -988,6 +1058,7 @@ multisocketsink_suite (void)
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
   tcase_add_test (tc_chain, test_client_next_keyframe);
+  tcase_add_test (tc_chain, test_zero_copy);
 
   return s;
 }
@@ -553,6 +553,254 @@ GST_START_TEST (test_source_setup)
 
 GST_END_TEST;
 
+/*** video cache ***/
+
+#define CACHE_FRAME_DURATION (GST_SECOND / 10)
+
+typedef struct
+{
+  GstElement *pipeline;
+  GstElement *playsink;
+  GstElement *videosink;
+
+  GMutex lock;
+  GCond cond;
+  guint seeks;                  /* seeks that reached the source */
+  GArray *rendered;             /* PTS of the rendered buffers */
+} VideoCacheData;
+
+static GstPadProbeReturn
+video_cache_src_probe (GstPad * pad, GstPadProbeInfo * info,
+    VideoCacheData * data)
+{
+  if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) == GST_EVENT_SEEK) {
+    g_mutex_lock (&data->lock);
+    data->seeks++;
+    g_mutex_unlock (&data->lock);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+video_cache_handoff (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    VideoCacheData * data)
+{
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+
+  g_mutex_lock (&data->lock);
+  g_array_append_val (data->rendered, pts);
+  g_cond_broadcast (&data->cond);
+  g_mutex_unlock (&data->lock);
+}
+
+/* videotestsrc ! playsink with a video cache, prerolled with at least 4
+ * frames in the cache */
+static void
+video_cache_setup (VideoCacheData * data)
+{
+  GstElement *src, *capsfilter, *cache, *queue;
+  guint level;
+  GstPad *srcpad, *sinkpad;
+  GstCaps *caps;
+
+  memset (data, 0, sizeof (VideoCacheData));
+  g_mutex_init (&data->lock);
+  g_cond_init (&data->cond);
+  data->rendered = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  data->pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("videotestsrc", NULL);
+  capsfilter = gst_element_factory_make ("capsfilter", NULL);
+  data->playsink = gst_element_factory_make ("playsink", NULL);
+  data->videosink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (src && capsfilter && data->playsink && data->videosink);
+
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, "I420",
+      "width", G_TYPE_INT, 64, "height", G_TYPE_INT, 64,
+      "framerate", GST_TYPE_FRACTION, 10, 1, NULL);
+  g_object_set (capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  g_object_set (data->videosink, "sync", FALSE, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (data->videosink, "handoff",
+      G_CALLBACK (video_cache_handoff), data);
+  g_object_set (data->playsink, "video-sink", data->videosink,
+      "video-cache-frames", 16, NULL);
+
+  gst_bin_add_many (GST_BIN (data->pipeline), src, capsfilter, data->playsink,
+      NULL);
+  fail_unless (gst_element_link (src, capsfilter));
+  srcpad = gst_element_get_static_pad (capsfilter, "src");
+  sinkpad = gst_element_get_request_pad (data->playsink, "video_sink");
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+
+  srcpad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_EVENT_UPSTREAM,
+      (GstPadProbeCallback) video_cache_src_probe, data, NULL);
+  gst_object_unref (srcpad);
+
+  fail_unless_equals_int (gst_element_set_state (data->pipeline,
+          GST_STATE_PAUSED), GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (data->pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  cache = gst_bin_get_by_name (GST_BIN (data->playsink), "vcache");
+  fail_unless (cache != NULL);
+  gst_object_unref (cache);
+
+  /* the frames are cached before they go into the queue, which fills up
+   * behind the prerolled frame */
+  queue = gst_bin_get_by_name (GST_BIN (data->playsink), "vqueue");
+  fail_unless (queue != NULL);
+  do {
+    g_object_get (queue, "current-level-buffers", &level, NULL);
+    if (level < 3)
+      g_usleep (G_USEC_PER_SEC / 100);
+  } while (level < 3);
+  gst_object_unref (queue);
+}
+
+static void
+video_cache_teardown (VideoCacheData * data)
+{
+  fail_unless_equals_int (gst_element_set_state (data->pipeline,
+          GST_STATE_NULL), GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (data->pipeline);
+  g_array_free (data->rendered, TRUE);
+  g_mutex_clear (&data->lock);
+  g_cond_clear (&data->cond);
+}
+
+static GstClockTime
+video_cache_last_pts (VideoCacheData * data)
+{
+  GstSample *sample;
+  GstClockTime pts;
+
+  g_object_get (data->videosink, "last-sample", &sample, NULL);
+  fail_unless (sample != NULL);
+  pts = GST_BUFFER_PTS (gst_sample_get_buffer (sample));
+  gst_sample_unref (sample);
+
+  return pts;
+}
+
+static void
+video_cache_seek (VideoCacheData * data, GstClockTime position)
+{
+  fail_unless (gst_element_seek_simple (data->pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, position));
+  fail_unless_equals_int (gst_element_get_state (data->pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+}
+
+GST_START_TEST (test_video_cache_hit)
+{
+  VideoCacheData data;
+  gint64 position;
+
+  video_cache_setup (&data);
+
+  /* the second frame went through the cache while prerolling */
+  video_cache_seek (&data, CACHE_FRAME_DURATION * 3 / 2);
+
+  fail_unless_equals_int (data.seeks, 0);
+  fail_unless_equals_uint64 (video_cache_last_pts (&data),
+      CACHE_FRAME_DURATION);
+
+  fail_unless (gst_element_query_position (data.pipeline, GST_FORMAT_TIME,
+          &position));
+  fail_unless_equals_uint64 (position, CACHE_FRAME_DURATION * 3 / 2);
+
+  /* and again, back to the first frame */
+  video_cache_seek (&data, 0);
+  fail_unless_equals_int (data.seeks, 0);
+  fail_unless_equals_uint64 (video_cache_last_pts (&data), 0);
+
+  video_cache_teardown (&data);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_cache_miss)
+{
+  VideoCacheData data;
+  gint64 position;
+
+  video_cache_setup (&data);
+
+  /* never decoded, goes upstream */
+  video_cache_seek (&data, 15 * CACHE_FRAME_DURATION);
+
+  fail_unless_equals_int (data.seeks, 1);
+  fail_unless_equals_uint64 (video_cache_last_pts (&data),
+      15 * CACHE_FRAME_DURATION);
+
+  /* a key unit seek is never served from the cache */
+  fail_unless (gst_element_seek_simple (data.pipeline, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT, 0));
+  fail_unless_equals_int (gst_element_get_state (data.pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+  fail_unless_equals_int (data.seeks, 2);
+
+  fail_unless (gst_element_query_position (data.pipeline, GST_FORMAT_TIME,
+          &position));
+  fail_unless_equals_uint64 (position, 0);
+
+  video_cache_teardown (&data);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_cache_play_after_scrub)
+{
+  VideoCacheData data;
+  GstClockTime prev;
+  guint i;
+
+  video_cache_setup (&data);
+
+  video_cache_seek (&data, CACHE_FRAME_DURATION * 3 / 2);
+  fail_unless_equals_int (data.seeks, 0);
+
+  /* upstream is held further on, it has to go back to the cached position
+   * before the frames after it are shown */
+  fail_unless (gst_element_set_state (data.pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  g_mutex_lock (&data.lock);
+  while (data.rendered->len == 0 ||
+      g_array_index (data.rendered, GstClockTime, data.rendered->len - 1) <
+      10 * CACHE_FRAME_DURATION)
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  fail_unless (gst_element_set_state (data.pipeline,
+          GST_STATE_PAUSED) != GST_STATE_CHANGE_FAILURE);
+
+  fail_unless_equals_int (data.seeks, 1);
+
+  /* no frame is skipped and nothing goes back */
+  g_mutex_lock (&data.lock);
+  prev = g_array_index (data.rendered, GstClockTime, 0);
+  fail_unless (prev <= 2 * CACHE_FRAME_DURATION);
+  for (i = 1; i < data.rendered->len; i++) {
+    GstClockTime pts = g_array_index (data.rendered, GstClockTime, i);
+
+    fail_unless (pts >= prev && pts - prev <= CACHE_FRAME_DURATION,
+        "frame %" GST_TIME_FORMAT " after %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (pts), GST_TIME_ARGS (prev));
+    prev = pts;
+  }
+  g_mutex_unlock (&data.lock);
+
+  video_cache_teardown (&data);
+}
+
+GST_END_TEST;
+
 /*** redvideo:// source ***/
 
 static GstURIType
@@ -849,6 +1097,9 @@ playbin_suite (void)
   tcase_add_test (tc_chain, test_missing_primary_decoder);
   tcase_add_test (tc_chain, test_refcount);
   tcase_add_test (tc_chain, test_source_setup);
+  tcase_add_test (tc_chain, test_video_cache_hit);
+  tcase_add_test (tc_chain, test_video_cache_miss);
+  tcase_add_test (tc_chain, test_video_cache_play_after_scrub);
 
 #if 0
   {
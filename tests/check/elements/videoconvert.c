@@ -27,8 +27,12 @@
 # include <valgrind/valgrind.h>
 #endif
 
+#include <string.h>
+
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
+#include <gst/video/colorbalance.h>
 
 static guint
 get_num_formats (void)
@@ -117,6 +121,230 @@ GST_START_TEST (test_template_formats)
 
 GST_END_TEST;
 
+static gchar *
+make_caps_str (const GstVideoColorimetry * cinfo)
+{
+  gchar *colorimetry, *str;
+
+  colorimetry = gst_video_colorimetry_to_string (cinfo);
+  str = g_strdup_printf ("video/x-raw, format=(string)I420, width=(int)64, "
+      "height=(int)48, framerate=(fraction)30/1, "
+      "pixel-aspect-ratio=(fraction)1/1, colorimetry=(string)%s",
+      colorimetry);
+  g_free (colorimetry);
+
+  return str;
+}
+
+GST_START_TEST (test_identity_passthrough)
+{
+  GstHarness *h;
+  GstVideoColorimetry cinfo = { GST_VIDEO_COLOR_RANGE_16_235,
+    GST_VIDEO_COLOR_MATRIX_BT601, GST_VIDEO_TRANSFER_BT709,
+    GST_VIDEO_COLOR_PRIMARIES_SMPTE170M
+  };
+  GstBuffer *inbuf, *outbuf;
+  gchar *caps_str;
+
+  h = gst_harness_new ("videoconvert");
+
+  caps_str = make_caps_str (&cinfo);
+  gst_harness_set_src_caps_str (h, caps_str);
+  g_free (caps_str);
+
+  /* the transfer function is not applied with the default gamma-mode, so
+   * the pixels don't change */
+  cinfo.transfer = GST_VIDEO_TRANSFER_SRGB;
+  caps_str = make_caps_str (&cinfo);
+  gst_harness_set_sink_caps_str (h, caps_str);
+  g_free (caps_str);
+
+  inbuf = gst_harness_create_buffer (h, 64 * 48 * 3 / 2);
+  gst_buffer_ref (inbuf);
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+
+  outbuf = gst_harness_pull (h);
+  fail_unless (outbuf == inbuf);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_crop_meta)
+{
+  GstHarness *h;
+  GstBuffer *inbuf, *outbuf, *cropped_outbuf;
+  GstVideoCropMeta *crop;
+  GstMapInfo map, cropped_map;
+  gint y;
+
+  h = gst_harness_new ("videoconvert");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=GRAY8, width=64, height=48, framerate=0/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=RGB, width=64, height=48, framerate=0/1");
+
+  /* a white frame */
+  inbuf = gst_harness_create_buffer (h, 64 * 48);
+  gst_buffer_memset (inbuf, 0, 0xff, 64 * 48);
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+
+  /* the same white frame cropped out of a larger black one */
+  inbuf = gst_buffer_new_allocate (NULL, 128 * 96, NULL);
+  gst_buffer_memset (inbuf, 0, 0x00, 128 * 96);
+  for (y = 16; y < 16 + 48; y++)
+    gst_buffer_memset (inbuf, y * 128 + 32, 0xff, 64);
+  gst_buffer_add_video_meta (inbuf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_GRAY8, 128, 96);
+  crop = gst_buffer_add_video_crop_meta (inbuf);
+  crop->x = 32;
+  crop->y = 16;
+  crop->width = 64;
+  crop->height = 48;
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+  cropped_outbuf = gst_harness_pull (h);
+
+  /* the crop is applied and not passed on */
+  fail_unless (gst_buffer_get_video_crop_meta (cropped_outbuf) == NULL);
+  fail_unless (gst_buffer_map (outbuf, &map, GST_MAP_READ));
+  fail_unless (gst_buffer_map (cropped_outbuf, &cropped_map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, cropped_map.size);
+  fail_unless (memcmp (map.data, cropped_map.data, map.size) == 0);
+  gst_buffer_unmap (outbuf, &map);
+  gst_buffer_unmap (cropped_outbuf, &cropped_map);
+
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (cropped_outbuf);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_swizzle_in_place)
+{
+  GstHarness *h;
+  GstBuffer *inbuf, *outbuf;
+  GstMapInfo map;
+  gint i;
+
+  h = gst_harness_new ("videoconvert");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=RGBA, width=16, height=8, framerate=0/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=BGRx, width=16, height=8, framerate=0/1");
+
+  inbuf = gst_buffer_new_allocate (NULL, 16 * 8 * 4, NULL);
+  fail_unless (gst_buffer_map (inbuf, &map, GST_MAP_WRITE));
+  for (i = 0; i < 16 * 8; i++) {
+    map.data[i * 4 + 0] = 1;
+    map.data[i * 4 + 1] = 2;
+    map.data[i * 4 + 2] = 3;
+    map.data[i * 4 + 3] = 4;
+  }
+  gst_buffer_unmap (inbuf, &map);
+  gst_buffer_add_video_meta (inbuf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_RGBA, 16, 8);
+
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+
+  /* the bytes are reordered and the padding byte gets the alpha */
+  fail_unless (gst_buffer_map (outbuf, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, 16 * 8 * 4);
+  for (i = 0; i < 16 * 8; i++) {
+    fail_unless_equals_int (map.data[i * 4 + 0], 3);
+    fail_unless_equals_int (map.data[i * 4 + 1], 2);
+    fail_unless_equals_int (map.data[i * 4 + 2], 1);
+    fail_unless_equals_int (map.data[i * 4 + 3], 4);
+  }
+  gst_buffer_unmap (outbuf, &map);
+  fail_unless_equals_int (gst_buffer_get_video_meta (outbuf)->format,
+      GST_VIDEO_FORMAT_BGRx);
+
+  gst_buffer_unref (outbuf);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_color_balance)
+{
+  GstHarness *h;
+  GstBuffer *inbuf, *outbuf;
+  GstColorBalance *balance;
+  GstColorBalanceChannel *contrast = NULL;
+  const GList *l;
+  GstMapInfo map;
+  gdouble d;
+  gint i;
+
+  h = gst_harness_new ("videoconvert");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=GRAY8, width=16, height=8, framerate=0/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=GRAY8, width=16, height=8, framerate=0/1");
+
+  fail_unless (GST_IS_COLOR_BALANCE (h->element));
+  balance = GST_COLOR_BALANCE (h->element);
+  for (l = gst_color_balance_list_channels (balance); l; l = l->next) {
+    GstColorBalanceChannel *channel = l->data;
+
+    if (g_str_equal (channel->label, "CONTRAST"))
+      contrast = channel;
+  }
+  fail_unless (contrast != NULL);
+
+  /* no balance, passthrough */
+  inbuf = gst_buffer_new_allocate (NULL, 16 * 8, NULL);
+  gst_buffer_memset (inbuf, 0, 0x80, 16 * 8);
+  gst_buffer_ref (inbuf);
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+  fail_unless (outbuf == inbuf);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+
+  /* no contrast makes all the pixels the same, the first value of the
+   * channel is a contrast of 0.0 */
+  gst_color_balance_set_value (balance, contrast, contrast->min_value);
+  g_object_get (h->element, "contrast", &d, NULL);
+  fail_unless_equals_float (d, 0.0);
+  fail_unless_equals_int (gst_color_balance_get_value (balance, contrast),
+      contrast->min_value);
+
+  inbuf = gst_buffer_new_allocate (NULL, 16 * 8, NULL);
+  fail_unless (gst_buffer_map (inbuf, &map, GST_MAP_WRITE));
+  for (i = 0; i < 16 * 8; i++)
+    map.data[i] = i + 64;
+  gst_buffer_unmap (inbuf, &map);
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+  fail_unless (outbuf != inbuf);
+  fail_unless (gst_buffer_map (outbuf, &map, GST_MAP_READ));
+  for (i = 1; i < 16 * 8; i++)
+    fail_unless_equals_int (map.data[i], map.data[0]);
+  gst_buffer_unmap (outbuf, &map);
+  gst_buffer_unref (outbuf);
+
+  /* back to the default, passthrough again */
+  g_object_set (h->element, "contrast", 1.0, NULL);
+  inbuf = gst_buffer_new_allocate (NULL, 16 * 8, NULL);
+  gst_buffer_ref (inbuf);
+  fail_unless_equals_int (gst_harness_push (h, inbuf), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+  fail_unless (outbuf == inbuf);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 videoconvert_suite (void)
 {
@@ -126,6 +354,10 @@ videoconvert_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_template_formats);
+  tcase_add_test (tc_chain, test_identity_passthrough);
+  tcase_add_test (tc_chain, test_crop_meta);
+  tcase_add_test (tc_chain, test_swizzle_in_place);
+  tcase_add_test (tc_chain, test_color_balance);
 
   return s;
 }
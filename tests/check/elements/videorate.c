@@ -318,6 +318,55 @@ GST_START_TEST (test_more)
 
 GST_END_TEST;
 
+/* duplicates share the memory of the input, the last output of a frame is
+ * the input buffer itself */
+GST_START_TEST (test_no_copy)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second, *third;
+  GstMemory *mem;
+  GstCaps *caps;
+  GList *l;
+
+  videorate = setup_videorate ();
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  first = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (first) = 0;
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+
+  /* output three times, at 1/25, 2/25 and 3/25 */
+  second = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (second) = GST_SECOND * 3 / 50;
+  mem = gst_buffer_peek_memory (second, 0);
+  fail_unless (gst_pad_push (mysrcpad, second) == GST_FLOW_OK);
+
+  third = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (third) = GST_SECOND * 12 / 50;
+  fail_unless (gst_pad_push (mysrcpad, third) == GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (buffers), 4);
+  l = buffers;
+  fail_unless (l->data == first);
+
+  for (l = g_list_next (l); l; l = g_list_next (l)) {
+    fail_unless (gst_buffer_n_memory (l->data) == 1);
+    fail_unless (gst_buffer_peek_memory (l->data, 0) == mem);
+  }
+  fail_unless (g_list_last (buffers)->data == second);
+
+  /* cleanup */
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 /* frames at 1, 0, 2 -> second one should be ignored */
 GST_START_TEST (test_wrong_order_from_zero)
 {
@@ -1172,6 +1221,7 @@ videorate_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_one);
   tcase_add_test (tc_chain, test_more);
+  tcase_add_test (tc_chain, test_no_copy);
   tcase_add_test (tc_chain, test_wrong_order_from_zero);
   tcase_add_test (tc_chain, test_wrong_order);
   tcase_add_test (tc_chain, test_no_framerate);
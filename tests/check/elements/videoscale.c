@@ -972,6 +972,143 @@ GST_START_TEST (test_basetransform_negotiation)
 
 GST_END_TEST;
 
+static void
+check_tee_output (GstElement * pipeline, const gchar * name, gint width,
+    gint height)
+{
+  GstElement *sink;
+  GstPad *pad;
+  GstCaps *caps;
+  GstVideoInfo info;
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+  fail_unless (sink != NULL);
+  pad = gst_element_get_static_pad (sink, "sink");
+  caps = gst_pad_get_current_caps (pad);
+  fail_unless (caps != NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&info), width);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&info), height);
+  fail_unless_equals_int (GST_VIDEO_INFO_FORMAT (&info),
+      GST_VIDEO_FORMAT_I420);
+  gst_caps_unref (caps);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+}
+
+static void
+tee_handoff (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    GList ** buffers)
+{
+  *buffers = g_list_append (*buffers, gst_buffer_ref (buffer));
+}
+
+static void
+collect_tee_output (GstElement * pipeline, const gchar * name,
+    GList ** buffers)
+{
+  GstElement *sink;
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+  fail_unless (sink != NULL);
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (tee_handoff), buffers);
+  gst_object_unref (sink);
+}
+
+static void
+run_to_eos (GstElement * pipeline)
+{
+  GstMessage *msg;
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+}
+
+static void
+compare_tee_output (GList * buffers, GList * expected)
+{
+  fail_unless_equals_int (g_list_length (buffers), g_list_length (expected));
+
+  for (; buffers; buffers = buffers->next, expected = expected->next) {
+    GstMapInfo map;
+
+    fail_unless (gst_buffer_map (expected->data, &map, GST_MAP_READ));
+    fail_unless_equals_int (gst_buffer_get_size (buffers->data), map.size);
+    fail_unless (gst_buffer_memcmp (buffers->data, 0, map.data,
+            map.size) == 0);
+    gst_buffer_unmap (expected->data, &map);
+  }
+}
+
+GST_START_TEST (test_tee)
+{
+  GstElement *pipeline, *reference;
+  GList *s1 = NULL, *s2 = NULL, *s3 = NULL;
+  GList *r1 = NULL, *r2 = NULL, *r3 = NULL;
+
+  pipeline = gst_parse_launch ("videotestsrc num-buffers=3 ! "
+      "video/x-raw,format=I420,width=320,height=240 ! "
+      "videoscaletee name=t "
+      "t. ! queue ! video/x-raw,width=160 ! fakesink name=s1 "
+      "t. ! queue ! video/x-raw,width=80,height=60 ! fakesink name=s2 "
+      "t. ! queue ! video/x-raw,width=320,height=240 ! fakesink name=s3",
+      NULL);
+  fail_unless (pipeline != NULL);
+  collect_tee_output (pipeline, "s1", &s1);
+  collect_tee_output (pipeline, "s2", &s2);
+  collect_tee_output (pipeline, "s3", &s3);
+
+  run_to_eos (pipeline);
+
+  /* the height of s1 keeps the aspect ratio, s2 is made from s1 */
+  check_tee_output (pipeline, "s1", 160, 120);
+  check_tee_output (pipeline, "s2", 80, 60);
+  check_tee_output (pipeline, "s3", 320, 240);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  /* the same scaling with videoscale, the default cubic method of the tee is
+   * the mitchell filter and the cascaded output is scaled twice */
+  reference = gst_parse_launch ("videotestsrc num-buffers=3 ! "
+      "video/x-raw,format=I420,width=320,height=240 ! tee name=t "
+      "t. ! queue ! videoscale method=mitchell ! "
+      "video/x-raw,width=160,height=120 ! fakesink name=r1 "
+      "t. ! queue ! videoscale method=mitchell ! "
+      "video/x-raw,width=160,height=120 ! videoscale method=mitchell ! "
+      "video/x-raw,width=80,height=60 ! fakesink name=r2 "
+      "t. ! queue ! fakesink name=r3", NULL);
+  fail_unless (reference != NULL);
+  collect_tee_output (reference, "r1", &r1);
+  collect_tee_output (reference, "r2", &r2);
+  collect_tee_output (reference, "r3", &r3);
+
+  run_to_eos (reference);
+
+  gst_element_set_state (reference, GST_STATE_NULL);
+  gst_object_unref (reference);
+
+  fail_unless_equals_int (g_list_length (s1), 3);
+  compare_tee_output (s1, r1);
+  compare_tee_output (s2, r2);
+  compare_tee_output (s3, r3);
+
+  g_list_free_full (s1, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (s2, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (s3, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (r1, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (r2, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (r3, (GDestroyNotify) gst_buffer_unref);
+}
+
+GST_END_TEST;
+
 static Suite *
 videoscale_suite (void)
 {
@@ -1038,6 +1175,7 @@ videoscale_suite (void)
   tcase_add_test (tc_chain, test_reverse_negotiation);
 #endif
   tcase_add_test (tc_chain, test_basetransform_negotiation);
+  tcase_add_test (tc_chain, test_tee);
 
   return s;
 }
@@ -522,6 +522,42 @@ GST_START_TEST (test_duration_query)
 
 GST_END_TEST;
 
+GST_START_TEST (test_static_pattern)
+{
+  GstElement *videotestsrc;
+  GstMapInfo map;
+  GList *l;
+
+  videotestsrc = setup_videotestsrc ();
+  g_object_set (videotestsrc, "pattern", 10 /* checkers-8 */ , NULL);
+
+  fail_unless (gst_element_set_state (videotestsrc,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 5)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  gst_element_set_state (videotestsrc, GST_STATE_READY);
+
+  /* the frames after the first one are copied from the cached image */
+  fail_unless (gst_buffer_map (GST_BUFFER (buffers->data), &map,
+          GST_MAP_READ));
+  for (l = buffers->next; l; l = l->next) {
+    GstBuffer *buf = GST_BUFFER (l->data);
+
+    fail_unless_equals_int (gst_buffer_get_size (buf), map.size);
+    fail_unless (gst_buffer_memcmp (buf, 0, map.data, map.size) == 0);
+  }
+  gst_buffer_unmap (GST_BUFFER (buffers->data), &map);
+
+  /* cleanup */
+  cleanup_videotestsrc (videotestsrc);
+}
+
+GST_END_TEST;
 
 /* FIXME: add tests for YUV formats */
 
@@ -544,6 +580,7 @@ videotestsrc_suite (void)
   tcase_add_test (tc_chain, test_rgb_formats);
   tcase_add_test (tc_chain, test_backward_playback);
   tcase_add_test (tc_chain, test_duration_query);
+  tcase_add_test (tc_chain, test_static_pattern);
 
   return s;
 }
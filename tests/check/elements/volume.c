@@ -20,6 +20,10 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* FIXME 2.0: suppress warnings for deprecated API such as GValueArray
+ * with newer GLib versions (>= 2.31.0) */
+#define GLIB_DISABLE_DEPRECATION_WARNINGS
+
 #include <unistd.h>
 
 #include <gst/base/gstbasetransform.h>
@@ -1729,6 +1733,62 @@ GST_START_TEST (test_passthrough)
 
 GST_END_TEST;
 
+GST_START_TEST (test_channel_volumes)
+{
+  GstElement *volume;
+  GstBuffer *inbuffer, *outbuffer;
+  GstCaps *caps;
+  GValueArray *array;
+  GValue v = { 0, };
+  gint16 in[8] = { 16384, 16384, -256, -256, 1000, 1000, 32767, 32767 };
+  gint16 res[8] = { 16384, 8192, -256, -128, 1000, 500, 32767, 16383 };
+  gint16 *out;
+  GstMapInfo map;
+
+  volume = setup_volume ();
+
+  array = g_value_array_new (2);
+  g_value_init (&v, G_TYPE_DOUBLE);
+  g_value_set_double (&v, 1.0);
+  g_value_array_append (array, &v);
+  g_value_set_double (&v, 0.5);
+  g_value_array_append (array, &v);
+  g_value_unset (&v);
+  g_object_set (G_OBJECT (volume), "channel-volumes", array, NULL);
+  g_value_array_free (array);
+
+  g_object_get (G_OBJECT (volume), "channel-volumes", &array, NULL);
+  fail_unless_equals_int (array->n_values, 2);
+  fail_unless (g_value_get_double (&array->values[1]) == 0.5);
+  g_value_array_free (array);
+
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (16);
+  gst_buffer_fill (inbuffer, 0, in, 16);
+  caps = gst_caps_from_string ("audio/x-raw, format = (string) " FORMATS3
+      ", channels = (int) 2, rate = (int) 44100, "
+      "layout = (string) interleaved");
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* unity volume with channel volumes must not be passthrough */
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  out = (gint16 *) map.data;
+  fail_unless (memcmp (out, res, 16) == 0);
+  gst_buffer_unmap (outbuffer, &map);
+
+  /* cleanup */
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_controller_usability)
 {
   GstControlSource *cs;
@@ -1903,6 +1963,7 @@ volume_suite (void)
   tcase_add_test (tc_chain, test_mute_f64);
   tcase_add_test (tc_chain, test_wrong_caps);
   tcase_add_test (tc_chain, test_passthrough);
+  tcase_add_test (tc_chain, test_channel_volumes);
   tcase_add_test (tc_chain, test_controller_usability);
   tcase_add_test (tc_chain, test_controller_processing);
   tcase_add_test (tc_chain, test_controller_defaults_at_ts0);
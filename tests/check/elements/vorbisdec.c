@@ -21,12 +21,20 @@
  */
 
 #include <unistd.h>
+#include <string.h>
 
 #include <gst/check/gstcheck.h>
 
 #include <vorbis/codec.h>
 #include <vorbis/vorbisenc.h>
 
+/* the SIMD versions of the stereo sample copying of the decoder, for float
+ * samples and for the fixed point samples of Tremor */
+#include "gstvorbisdeclib-simd.h"
+#define TREMOR
+#include "gstvorbisdeclib-simd.h"
+#undef TREMOR
+
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
  * get_peer, and then remove references in every test function */
@@ -298,6 +306,95 @@ GST_START_TEST (test_empty_vorbis_packet)
 
 GST_END_TEST;
 
+#define MAX_SIMD_SAMPLES 71
+
+/* the SIMD versions leave the last samples to the caller, for every number of
+ * samples the result has to be the same as the one of the C loops */
+GST_START_TEST (test_interleave_simd)
+{
+#ifdef HAVE_VORBIS_SIMD_S
+  float l[MAX_SIMD_SAMPLES], r[MAX_SIMD_SAMPLES], *in[2] = { l, r };
+  float out[2 * MAX_SIMD_SAMPLES + 1], ref[2 * MAX_SIMD_SAMPLES + 1];
+  guint samples, j, done;
+
+  for (samples = 0; samples <= MAX_SIMD_SAMPLES; samples++) {
+    for (j = 0; j < samples; j++) {
+      l[j] = g_random_double_range (-2.0, 2.0);
+      r[j] = g_random_double_range (-2.0, 2.0);
+    }
+    memset (out, 0x55, sizeof (out));
+    memset (ref, 0x55, sizeof (ref));
+
+    done = interleave_s_simd (out, in, samples);
+    fail_unless (done <= samples && samples - done < 8);
+    for (j = done; j < samples; j++) {
+      out[2 * j] = l[j];
+      out[2 * j + 1] = r[j];
+    }
+
+    for (j = 0; j < samples; j++) {
+      ref[2 * j] = l[j];
+      ref[2 * j + 1] = r[j];
+    }
+    /* also checks that nothing is written after the output */
+    fail_unless (memcmp (out, ref, sizeof (out)) == 0,
+        "wrong interleaving of %u samples", samples);
+  }
+#else
+  GST_INFO ("no SIMD version of the float interleaving");
+#endif
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_interleave_16_simd)
+{
+#ifdef HAVE_VORBIS_SIMD_16_S
+  /* Tremor samples are 24 bit fixed point, but can be beyond that range */
+  static const ogg_int32_t special[] = {
+    0, 1, -1, 511, 512, -512, -513,
+    (1 << 24) - 512, (1 << 24) - 1, 1 << 24, (1 << 24) + 1,
+    -(1 << 24) + 1, -(1 << 24), -(1 << 24) - 1, -(1 << 24) - 512,
+    G_MAXINT32, G_MININT32
+  };
+  ogg_int32_t l[MAX_SIMD_SAMPLES], r[MAX_SIMD_SAMPLES], *in[2] = { l, r };
+  gint16 out[2 * MAX_SIMD_SAMPLES + 1], ref[2 * MAX_SIMD_SAMPLES + 1];
+  guint samples, j, done;
+
+  for (samples = 0; samples <= MAX_SIMD_SAMPLES; samples++) {
+    for (j = 0; j < samples; j++) {
+      if (g_random_boolean ()) {
+        l[j] = special[g_random_int_range (0, G_N_ELEMENTS (special))];
+        r[j] = special[g_random_int_range (0, G_N_ELEMENTS (special))];
+      } else {
+        l[j] = g_random_int_range (-(1 << 25), 1 << 25);
+        r[j] = g_random_int_range (-(1 << 25), 1 << 25);
+      }
+    }
+    memset (out, 0x55, sizeof (out));
+    memset (ref, 0x55, sizeof (ref));
+
+    done = interleave_16_s_simd (out, in, samples);
+    fail_unless (done <= samples && samples - done < 8);
+    for (j = done; j < samples; j++) {
+      out[2 * j] = CLAMP (l[j] >> 9, -32768, 32767);
+      out[2 * j + 1] = CLAMP (r[j] >> 9, -32768, 32767);
+    }
+
+    for (j = 0; j < samples; j++) {
+      ref[2 * j] = CLAMP (l[j] >> 9, -32768, 32767);
+      ref[2 * j + 1] = CLAMP (r[j] >> 9, -32768, 32767);
+    }
+    fail_unless (memcmp (out, ref, sizeof (out)) == 0,
+        "wrong interleaving of %u samples", samples);
+  }
+#else
+  GST_INFO ("no SIMD version of the fixed point interleaving");
+#endif
+}
+
+GST_END_TEST;
+
 static Suite *
 vorbisdec_suite (void)
 {
@@ -307,6 +404,8 @@ vorbisdec_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_identification_header);
   tcase_add_test (tc_chain, test_empty_vorbis_packet);
+  tcase_add_test (tc_chain, test_interleave_simd);
+  tcase_add_test (tc_chain, test_interleave_16_simd);
 
   return s;
 }
@@ -0,0 +1,162 @@
+/* GStreamer
+ *
+ * unit test for ximagesink
+ *
+ * Copyright (C) <2016> Tobias Lindqvist <tobias.lindqvist@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <unistd.h>
+#include <glib/gstdio.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/allocators/gstdmabuf.h>
+#include <gst/video/video.h>
+#include <gst/video/videooverlay.h>
+
+static GstPad *mysrcpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw")
+    );
+
+/* a dmabuf of a regular file, the X server can't import it with DRI3 so the
+ * sink has to copy the frame */
+static GstBuffer *
+create_dmabuf_buffer (GstAllocator * allocator, const GstVideoInfo * info)
+{
+  GstBuffer *buffer;
+  gchar *filename;
+  gint fd;
+
+  fd = g_file_open_tmp (NULL, &filename, NULL);
+  fail_unless (fd >= 0);
+  g_unlink (filename);
+  g_free (filename);
+  fail_unless (ftruncate (fd, GST_VIDEO_INFO_SIZE (info)) == 0);
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, gst_dmabuf_allocator_alloc (allocator, fd,
+          GST_VIDEO_INFO_SIZE (info)));
+  gst_buffer_memset (buffer, 0, 0x80, GST_VIDEO_INFO_SIZE (info));
+
+  return buffer;
+}
+
+GST_START_TEST (test_dmabuf_fallback)
+{
+  GstElement *sink;
+  GstAllocator *allocator;
+  GstStructure *s;
+  GstCaps *caps;
+  GstVideoInfo info;
+  GstVideoCropMeta *crop;
+  GstBuffer *buffer;
+  GstBus *bus;
+  GstMessage *msg;
+  GstPad *sinkpad;
+  gint i;
+
+  sink = gst_check_setup_element ("ximagesink");
+  if (gst_element_set_state (sink, GST_STATE_READY) ==
+      GST_STATE_CHANGE_FAILURE) {
+    GST_INFO ("no X display, skipping test");
+    gst_element_set_state (sink, GST_STATE_NULL);
+    gst_check_teardown_element (sink);
+    return;
+  }
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (sink, bus);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  caps = gst_pad_query_caps (sinkpad, NULL);
+  gst_object_unref (sinkpad);
+  caps = gst_caps_truncate (caps);
+  caps = gst_caps_make_writable (caps);
+  s = gst_caps_get_structure (caps, 0);
+  gst_structure_fixate_field_nearest_int (s, "width", 64);
+  gst_structure_fixate_field_nearest_int (s, "height", 48);
+  gst_structure_fixate_field_nearest_fraction (s, "framerate", 25, 1);
+  caps = gst_caps_fixate (caps);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+
+  mysrcpad = gst_check_setup_src_pad (sink, &srctemplate);
+  gst_pad_set_active (mysrcpad, TRUE);
+  fail_unless (gst_element_set_state (sink, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_TIME);
+
+  allocator = gst_dmabuf_allocator_new ();
+
+  for (i = 0; i < 4; i++) {
+    buffer = create_dmabuf_buffer (allocator, &info);
+    GST_BUFFER_PTS (buffer) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (buffer) = 40 * GST_MSECOND;
+    if (i & 1) {
+      crop = gst_buffer_add_video_crop_meta (buffer);
+      crop->x = 8;
+      crop->y = 4;
+      crop->width = GST_VIDEO_INFO_WIDTH (&info) - 16;
+      crop->height = GST_VIDEO_INFO_HEIGHT (&info) - 8;
+    }
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buffer), GST_FLOW_OK);
+
+    /* the last frame has to be shown again on expose */
+    gst_video_overlay_expose (GST_VIDEO_OVERLAY (sink));
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  msg = gst_bus_poll (bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR, GST_SECOND);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  gst_object_unref (allocator);
+  gst_caps_unref (caps);
+
+  gst_element_set_state (sink, GST_STATE_NULL);
+  gst_element_set_bus (sink, NULL);
+  gst_object_unref (bus);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_check_teardown_src_pad (sink);
+  gst_check_teardown_element (sink);
+}
+
+GST_END_TEST;
+
+static Suite *
+ximagesink_suite (void)
+{
+  Suite *s = suite_create ("ximagesink");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_dmabuf_fallback);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ximagesink)
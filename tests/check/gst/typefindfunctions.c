@@ -477,6 +477,183 @@ GST_START_TEST (test_manifest_typefinding)
 
 GST_END_TEST;
 
+static void
+check_fast_path (const guint8 * data, gsize size, const gchar * expected)
+{
+  GstTypeFindProbability prob = 0;
+  GstCaps *caps;
+
+  caps = typefind_data (data, size, &prob);
+  fail_unless (caps != NULL);
+  fail_unless_equals_string (gst_structure_get_name (gst_caps_get_structure
+          (caps, 0)), expected);
+  fail_unless_equals_int (prob, GST_TYPE_FIND_MAXIMUM);
+  gst_caps_unref (caps);
+}
+
+/* the fast path must give the same result as the individual typefinders */
+GST_START_TEST (test_fast_path)
+{
+  const guint8 wav[] = { 'R', 'I', 'F', 'F', 0x24, 0x00, 0x00, 0x00,
+    'W', 'A', 'V', 'E', 'f', 'm', 't', ' '
+  };
+  const guint8 avi[] = { 'R', 'I', 'F', 'F', 0x24, 0x00, 0x00, 0x00,
+    'A', 'V', 'I', ' ', 'L', 'I', 'S', 'T'
+  };
+  const guint8 m4a[] = { 0x00, 0x00, 0x00, 0x18, 'f', 't', 'y', 'p',
+    'M', '4', 'A', ' ', 0x00, 0x00, 0x00, 0x00
+  };
+  const guint8 q3gp[] = { 0x00, 0x00, 0x00, 0x18, 'f', 't', 'y', 'p',
+    '3', 'g', 'p', '4', 0x00, 0x00, 0x00, 0x00
+  };
+  const guint8 flac[] = { 'f', 'L', 'a', 'C', 0x00, 0x00, 0x00, 0x22 };
+  const guint8 id3[] = { 'I', 'D', '3', 0x04, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00
+  };
+
+  check_fast_path (wav, sizeof (wav), "audio/x-wav");
+  check_fast_path (avi, sizeof (avi), "video/x-msvideo");
+  check_fast_path (m4a, sizeof (m4a), "audio/x-m4a");
+  check_fast_path (q3gp, sizeof (q3gp), "application/x-3gp");
+  check_fast_path (flac, sizeof (flac), "audio/x-flac");
+  check_fast_path (id3, sizeof (id3), "application/x-id3");
+}
+
+GST_END_TEST;
+
+/* junk in front of a stream, with single bytes the scanning typefinders
+ * have to look at more closely */
+static void
+make_junk (guint8 * data, guint size)
+{
+  guint i;
+
+  for (i = 0; i < size; i++)
+    data[i] = 0x80 | ((i * 13) & 0x3f);
+
+  /* the first bytes of the ADTS, LOAS, ADIF and DTS sync words */
+  if (size > 8) {
+    data[3] = 0xff;
+    data[5] = 0x56;
+    data[7] = 'A';
+  }
+  if (size > 40) {
+    data[20] = 0x4d;
+    data[25] = 0x7f;
+    data[30] = 0x1f;
+    data[35] = 0xfe;
+  }
+}
+
+static void
+make_adts_frame (guint8 * data, guint size)
+{
+  memset (data, 0, size);
+  data[0] = 0xff;
+  data[1] = 0xf1;               /* MPEG-4, no CRC */
+  data[2] = (1 << 6) | (4 << 2);        /* LC, 44.1kHz */
+  data[3] = (2 << 6) | ((size >> 11) & 0x03);   /* stereo */
+  data[4] = (size >> 3) & 0xff;
+  data[5] = ((size & 0x07) << 5) | 0x1f;
+  data[6] = 0xfc;
+}
+
+static const guint junk_sizes[] = { 1, 15, 16, 17, 31, 100, 333 };
+
+GST_START_TEST (test_adts_not_at_start)
+{
+  GstTypeFindProbability prob;
+  GstStructure *s;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstMapInfo map;
+  gint mpegversion;
+  guint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (junk_sizes); i++) {
+    buf = gst_buffer_new_and_alloc (junk_sizes[i] + 7 * 200);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    make_junk (map.data, junk_sizes[i]);
+    for (j = 0; j < 7; j++)
+      make_adts_frame (map.data + junk_sizes[i] + j * 200, 200);
+    gst_buffer_unmap (buf, &map);
+
+    caps = gst_type_find_helper_for_buffer (NULL, buf, &prob);
+    fail_unless (caps != NULL, "no caps with %u bytes of junk",
+        junk_sizes[i]);
+    GST_LOG ("%u bytes of junk: %" GST_PTR_FORMAT, junk_sizes[i], caps);
+
+    s = gst_caps_get_structure (caps, 0);
+    fail_unless_equals_string (gst_structure_get_name (s), "audio/mpeg");
+    fail_unless_equals_string (gst_structure_get_string (s, "stream-format"),
+        "adts");
+    fail_unless (gst_structure_get_int (s, "mpegversion", &mpegversion));
+    fail_unless_equals_int (mpegversion, 4);
+    fail_unless (prob >= GST_TYPE_FIND_LIKELY);
+    gst_caps_unref (caps);
+
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_END_TEST;
+
+static void
+make_dts_frame (guint8 * data, guint size)
+{
+  guint16 hdr[8] = { 0x7ffe, 0x8001, 0, 0, 0, 0, 0, 0 };
+  guint i;
+
+  /* normal frame, 15 blocks, frame size, 2 channels, 48kHz */
+  hdr[2] = 0xfc00 | (15 << 2) | (((size - 1) >> 12) & 0x03);
+  hdr[3] = ((size - 1) & 0xfff) << 4;
+  hdr[4] = (2 << 14) | (13 << 10);
+
+  memset (data, 0, size);
+  for (i = 0; i < G_N_ELEMENTS (hdr); i++)
+    GST_WRITE_UINT16_BE (data + i * 2, hdr[i]);
+}
+
+GST_START_TEST (test_dts_not_at_start)
+{
+  GstTypeFindProbability prob;
+  GstStructure *s;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstMapInfo map;
+  gint rate, channels;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (junk_sizes); i++) {
+    buf = gst_buffer_new_and_alloc (junk_sizes[i] + 3 * 1024);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    make_junk (map.data, junk_sizes[i]);
+    make_dts_frame (map.data + junk_sizes[i], 1024);
+    make_dts_frame (map.data + junk_sizes[i] + 1024, 1024);
+    make_dts_frame (map.data + junk_sizes[i] + 2048, 1024);
+    gst_buffer_unmap (buf, &map);
+
+    caps = gst_type_find_helper_for_buffer (NULL, buf, &prob);
+    fail_unless (caps != NULL, "no caps with %u bytes of junk",
+        junk_sizes[i]);
+    GST_LOG ("%u bytes of junk: %" GST_PTR_FORMAT, junk_sizes[i], caps);
+
+    s = gst_caps_get_structure (caps, 0);
+    fail_unless_equals_string (gst_structure_get_name (s), "audio/x-dts");
+    fail_unless (gst_structure_get_int (s, "rate", &rate));
+    fail_unless_equals_int (rate, 48000);
+    fail_unless (gst_structure_get_int (s, "channels", &channels));
+    fail_unless_equals_int (channels, 2);
+    /* the second frame confirms it */
+    fail_unless_equals_int (prob, GST_TYPE_FIND_MAXIMUM);
+    gst_caps_unref (caps);
+
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 typefindfunctions_suite (void)
 {
@@ -491,9 +668,12 @@ typefindfunctions_suite (void)
   tcase_add_test (tc_chain, test_mpegts);
   tcase_add_test (tc_chain, test_ac3);
   tcase_add_test (tc_chain, test_eac3);
+  tcase_add_test (tc_chain, test_adts_not_at_start);
+  tcase_add_test (tc_chain, test_dts_not_at_start);
   tcase_add_test (tc_chain, test_random_data);
   tcase_add_test (tc_chain, test_hls_m3u8);
   tcase_add_test (tc_chain, test_manifest_typefinding);
+  tcase_add_test (tc_chain, test_fast_path);
 
   return s;
 }
@@ -26,6 +26,8 @@
 #include <gst/check/gstcheck.h>
 
 #include <gst/allocators/gstdmabuf.h>
+#include <gst/allocators/gstshmallocator.h>
+#include <gst/video/video.h>
 #include <string.h>
 
 #define FILE_SIZE 4096
@@ -60,6 +62,170 @@ GST_START_TEST (test_dmabuf)
 
 GST_END_TEST;
 
+GST_START_TEST (test_dmabuf_keep_mapped)
+{
+  char tmpfilename[] = "/tmp/dmabuf-test.XXXXXX";
+  int fd;
+  GstMemory *mem;
+  GstAllocator *alloc;
+  GstMapInfo info, info2;
+
+  fd = mkstemp (tmpfilename);
+  fail_unless (fd > 0);
+  fail_unless (g_unlink (tmpfilename) == 0);
+
+  alloc = gst_dmabuf_allocator_new ();
+
+  mem = gst_dmabuf_allocator_alloc (alloc, fd, FILE_SIZE);
+
+  /* the mapping is kept and reused for the later maps, also for writing */
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data != NULL);
+  gst_memory_unmap (mem, &info);
+
+  fail_unless (gst_memory_map (mem, &info2, GST_MAP_WRITE));
+  fail_unless (info2.data == info.data);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data == info2.data);
+  gst_memory_unmap (mem, &info);
+  gst_memory_unmap (mem, &info2);
+
+  gst_memory_unref (mem);
+  g_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_shm_allocator)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstMemory *mem;
+  GstMapInfo info;
+  guint i;
+
+  alloc = gst_shm_allocator_new ();
+  fail_unless (alloc != NULL);
+
+  gst_allocation_params_init (&params);
+  params.align = 63;
+  params.prefix = 10;
+
+  mem = gst_allocator_alloc (alloc, FILE_SIZE, &params);
+  fail_unless (mem != NULL);
+  fail_unless (gst_is_fd_memory (mem));
+  fail_unless (gst_fd_memory_get_fd (mem) >= 0);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READWRITE));
+  fail_unless (info.size == FILE_SIZE);
+  fail_unless (((guintptr) info.data & 63) == 0);
+  for (i = 0; i < info.size; i++)
+    fail_unless (info.data[i] == 0);
+  memset (info.data, 0xaa, info.size);
+  gst_memory_unmap (mem, &info);
+
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_shm_allocator_reuse)
+{
+  GstAllocator *alloc;
+  GstMemory *mem;
+  GstMapInfo info;
+  gint fd;
+
+  alloc = gst_shm_allocator_new_full (GST_SHM_ALLOCATOR_FLAG_SEAL, 1);
+  fail_unless (alloc != NULL);
+
+  mem = gst_allocator_alloc (alloc, FILE_SIZE, NULL);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  memset (info.data, 0xaa, info.size);
+  gst_memory_unmap (mem, &info);
+  gst_memory_unref (mem);
+
+  /* a new allocation of the same size reuses the region of the freed one */
+  mem = gst_allocator_alloc (alloc, FILE_SIZE, NULL);
+  fd = gst_fd_memory_get_fd (mem);
+  fail_unless (fd >= 0);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.size == FILE_SIZE);
+  fail_unless (info.data[0] == 0xaa);
+  gst_memory_unmap (mem, &info);
+  gst_memory_unref (mem);
+
+  /* a different size gets a fresh, zeroed region */
+  mem = gst_allocator_alloc (alloc, 2 * FILE_SIZE, NULL);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 0);
+  gst_memory_unmap (mem, &info);
+  gst_memory_unref (mem);
+
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_shm_video_pool)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoAlignment align;
+  GstVideoInfo vinfo;
+  GstVideoMeta *vmeta;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstMapInfo info;
+  guint i;
+
+  alloc = gst_shm_allocator_new ();
+  gst_allocation_params_init (&params);
+
+  gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_I420, 319, 241);
+  caps = gst_video_info_to_caps (&vinfo);
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, vinfo.size, 0, 0);
+  gst_buffer_pool_config_set_allocator (config, alloc, &params);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_META);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
+  gst_video_alignment_reset (&align);
+  for (i = 0; i < GST_VIDEO_MAX_PLANES; i++)
+    align.stride_align[i] = 31;
+  gst_buffer_pool_config_set_video_alignment (config, &align);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buffer,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_n_memory (buffer) == 1);
+  fail_unless (gst_is_fd_memory (gst_buffer_peek_memory (buffer, 0)));
+
+  vmeta = gst_buffer_get_video_meta (buffer);
+  fail_unless (vmeta != NULL);
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READWRITE));
+  for (i = 0; i < vmeta->n_planes; i++) {
+    fail_unless ((vmeta->stride[i] & 31) == 0);
+    fail_unless ((((guintptr) info.data + vmeta->offset[i]) & 31) == 0);
+  }
+  gst_buffer_unmap (buffer, &info);
+
+  gst_buffer_unref (buffer);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -68,6 +234,10 @@ allocators_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
+  tcase_add_test (tc_chain, test_dmabuf_keep_mapped);
+  tcase_add_test (tc_chain, test_shm_allocator);
+  tcase_add_test (tc_chain, test_shm_allocator_reuse);
+  tcase_add_test (tc_chain, test_shm_video_pool);
 
   return s;
 }
@@ -578,6 +578,57 @@ GST_START_TEST (test_multichannel_reorder)
 
 GST_END_TEST;
 
+/* reorder @n_frames of @channels channels of @format with the channels in
+ * reverse order and check them */
+static void
+check_reorder_reverse (GstAudioFormat format, gint channels, gint n_frames)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  GstAudioChannelPosition from[8], to[8];
+  gint bps = finfo->width / 8;
+  gint size = bps * channels * n_frames;
+  guint8 *data, *expected;
+  gint i, c;
+
+  fail_unless (gst_audio_channel_positions_from_mask (channels,
+          gst_audio_channel_get_fallback_mask (channels), from));
+  for (c = 0; c < channels; c++)
+    to[c] = from[channels - 1 - c];
+
+  data = g_malloc (size);
+  expected = g_malloc (size);
+  for (i = 0; i < size; i++)
+    data[i] = i;
+  for (i = 0; i < n_frames; i++)
+    for (c = 0; c < channels; c++)
+      memcpy (expected + (i * channels + c) * bps,
+          data + (i * channels + channels - 1 - c) * bps, bps);
+
+  fail_unless (gst_audio_reorder_channels (data, size, format, channels, from,
+          to));
+  fail_unless (memcmp (data, expected, size) == 0);
+
+  g_free (data);
+  g_free (expected);
+}
+
+GST_START_TEST (test_multichannel_reorder_blocks)
+{
+  gint n;
+
+  /* enough frames for the whole blocks of the vectorized version and some
+   * frames left */
+  for (n = 1; n < 12; n++) {
+    check_reorder_reverse (GST_AUDIO_FORMAT_S16, 6, n);
+    check_reorder_reverse (GST_AUDIO_FORMAT_S16, 8, n);
+    check_reorder_reverse (GST_AUDIO_FORMAT_S32, 6, n);
+    check_reorder_reverse (GST_AUDIO_FORMAT_S32, 8, n);
+    check_reorder_reverse (GST_AUDIO_FORMAT_F64, 8, n);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_audio_info)
 {
   GstAudioFormat fmt;
@@ -591,6 +642,39 @@ GST_START_TEST (test_audio_info)
 
 GST_END_TEST;
 
+GST_START_TEST (test_audio_info_from_caps)
+{
+  GstAudioInfo info, info2;
+  GstAudioFormat f;
+  GstCaps *caps;
+
+  for (f = GST_AUDIO_FORMAT_S8; f <= GST_AUDIO_FORMAT_F64BE; f++) {
+    fail_unless_equals_int (gst_audio_format_from_string
+        (gst_audio_format_to_string (f)), f);
+
+    gst_audio_info_set_format (&info, f, 44100, 2, NULL);
+    caps = gst_audio_info_to_caps (&info);
+    fail_unless (gst_audio_info_from_caps (&info2, caps));
+    fail_unless (gst_audio_info_is_equal (&info, &info2));
+    gst_caps_unref (caps);
+  }
+
+  fail_unless_equals_int (gst_audio_format_from_string ("S8 "),
+      GST_AUDIO_FORMAT_UNKNOWN);
+
+  caps = gst_caps_from_string ("audio/x-raw, format=(string)S17, "
+      "layout=(string)interleaved, rate=(int)44100, channels=(int)1");
+  fail_if (gst_audio_info_from_caps (&info, caps));
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("audio/x-raw, format=(string)S16LE, "
+      "layout=(string)interleaved, rate=(string)44100, channels=(int)1");
+  fail_if (gst_audio_info_from_caps (&info, caps));
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_fill_silence)
 {
   GstAudioInfo info;
@@ -612,6 +696,950 @@ GST_START_TEST (test_fill_silence)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pack_unpack_24)
+{
+  static const GstAudioFormat formats[] = {
+    GST_AUDIO_FORMAT_S24LE, GST_AUDIO_FORMAT_S24BE, GST_AUDIO_FORMAT_U24LE,
+    GST_AUDIO_FORMAT_U24BE, GST_AUDIO_FORMAT_S20LE, GST_AUDIO_FORMAT_U20BE,
+    GST_AUDIO_FORMAT_S18LE, GST_AUDIO_FORMAT_U18BE
+  };
+  guint8 data[3 * 67], packed[3 * 67];
+  guint32 unpacked[67], unpacked2[67];
+  guint f;
+  gint i, length;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+    gint scale = 32 - GST_AUDIO_FORMAT_INFO_DEPTH (finfo);
+    guint32 sign = GST_AUDIO_FORMAT_INFO_IS_SIGNED (finfo) ? 0 : 1U << 31;
+    gboolean be = GST_AUDIO_FORMAT_INFO_ENDIANNESS (finfo) == G_BIG_ENDIAN;
+
+    /* all lengths around the block sizes of the SIMD functions */
+    for (length = 1; length <= G_N_ELEMENTS (unpacked); length++) {
+      for (i = 0; i < 3 * length; i++)
+        data[i] = g_random_int ();
+
+      finfo->unpack_func (finfo, 0, unpacked, data, length);
+      for (i = 0; i < length; i++) {
+        const guint8 *p = data + 3 * i;
+        guint32 v = be ? GST_READ_UINT24_BE (p) : GST_READ_UINT24_LE (p);
+
+        fail_unless_equals_int (unpacked[i], (v << scale) ^ sign);
+      }
+
+      finfo->pack_func (finfo, 0, unpacked, packed, length);
+      finfo->unpack_func (finfo, 0, unpacked2, packed, length);
+      fail_unless (memcmp (unpacked, unpacked2, length * 4) == 0);
+    }
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_iec61937_payload_buffer)
+{
+  GstAudioRingBufferSpec spec = { 0, };
+  GstBuffer *buf, *out;
+  guint8 frame[1001], *expected, *result;
+  guint frame_size, i;
+  gint e;
+
+  spec.type = GST_AUDIO_RING_BUFFER_FORMAT_TYPE_AC3;
+  spec.caps = gst_caps_new_empty_simple ("audio/x-ac3");
+  frame_size = gst_audio_iec61937_frame_size (&spec);
+  fail_unless (frame_size > sizeof (frame));
+
+  for (i = 0; i < sizeof (frame); i++)
+    frame[i] = g_random_int ();
+  expected = g_malloc (frame_size);
+  result = g_malloc (frame_size);
+
+  for (e = 0; e < 2; e++) {
+    gint endianness = e ? G_BIG_ENDIAN : G_LITTLE_ENDIAN;
+
+    /* both odd and even sized frames */
+    for (i = sizeof (frame) - 1; i <= sizeof (frame); i++) {
+      fail_unless (gst_audio_iec61937_payload (frame, i, expected, frame_size,
+              &spec, endianness));
+
+      buf = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, frame,
+          sizeof (frame), 0, i, NULL, NULL);
+      GST_BUFFER_PTS (buf) = 10 * GST_SECOND;
+      out = gst_audio_iec61937_payload_buffer (buf, &spec, endianness);
+      fail_unless (out != NULL);
+      fail_unless_equals_int (gst_buffer_get_size (out), frame_size);
+      fail_unless_equals_uint64 (GST_BUFFER_PTS (out), 10 * GST_SECOND);
+      /* header, frame and padding */
+      fail_unless (gst_buffer_n_memory (out) >= 3);
+      if (endianness == G_BYTE_ORDER)
+        fail_unless (gst_buffer_peek_memory (out, 1) ==
+            gst_buffer_peek_memory (buf, 0));
+
+      gst_buffer_extract (out, 0, result, frame_size);
+      fail_unless (memcmp (expected, result, frame_size) == 0);
+
+      gst_buffer_unref (out);
+      gst_buffer_unref (buf);
+    }
+  }
+
+  g_free (expected);
+  g_free (result);
+  gst_caps_unref (spec.caps);
+}
+
+GST_END_TEST;
+
+static void
+resample_saw (GstAudioResampler * resampler, gfloat * out, gsize out_frames)
+{
+  gfloat in[4410];
+  gpointer inp[1] = { in }, outp[1] = {
+  out};
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++)
+    in[i] = ((i * 37) % 200 - 100) / 100.0;
+
+  fail_unless_equals_int (gst_audio_resampler_get_out_frames (resampler,
+          G_N_ELEMENTS (in)), out_frames);
+  gst_audio_resampler_resample (resampler, inp, G_N_ELEMENTS (in), outp,
+      out_frames);
+}
+
+GST_START_TEST (test_resampler_shared_taps)
+{
+  GstAudioResampler *r1, *r2, *r3;
+  GstAudioResamplerFilterMode modes[] = {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+    GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED
+  };
+  gfloat out1[4800], out2[4800], out3[4800];
+  gsize out_frames;
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (modes); i++) {
+    GstStructure *options;
+
+    options = gst_structure_new_empty ("options");
+    gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 44100, 48000, options);
+    gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+        GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, modes[i], NULL);
+
+    r1 = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+        GST_AUDIO_FORMAT_F32, 1, 44100, 48000, options);
+    r2 = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+        GST_AUDIO_FORMAT_F32, 1, 44100, 48000, options);
+
+    out_frames = gst_audio_resampler_get_out_frames (r1, 4410);
+    fail_unless (out_frames <= G_N_ELEMENTS (out1));
+
+    /* the second resampler uses the tables of the first one, it must
+     * produce the same output */
+    resample_saw (r1, out1, out_frames);
+    resample_saw (r2, out2, out_frames);
+    fail_unless (memcmp (out1, out2, out_frames * sizeof (gfloat)) == 0);
+
+    /* the tables stay around as long as one resampler uses them */
+    gst_audio_resampler_free (r1);
+    r3 = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+        GST_AUDIO_FORMAT_F32, 1, 44100, 48000, options);
+    resample_saw (r3, out3, out_frames);
+    fail_unless (memcmp (out1, out3, out_frames * sizeof (gfloat)) == 0);
+
+    gst_audio_resampler_free (r2);
+    gst_audio_resampler_free (r3);
+    gst_structure_free (options);
+  }
+}
+
+GST_END_TEST;
+
+static GstAudioResampler *
+make_latency_resampler (GstAudioResamplerFilterMode mode, gint latency)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+
+  options = gst_structure_new_empty ("options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 44100, 48000, options);
+  gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, mode,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_LATENCY, G_TYPE_INT, latency, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+      GST_AUDIO_FORMAT_F32, 1, 44100, 48000, options);
+  gst_structure_free (options);
+
+  return resampler;
+}
+
+GST_START_TEST (test_resampler_filter_latency)
+{
+  GstAudioResamplerFilterMode modes[] = {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+    GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED
+  };
+  gfloat in[4410], out[4800];
+  gpointer inp[1] = { in }, outp[1] = { out };
+  gsize j;
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++)
+    in[i] = 0.5;
+
+  for (i = 0; i < G_N_ELEMENTS (modes); i++) {
+    GstAudioResampler *linear, *low;
+    gsize linear_frames, low_frames;
+
+    linear = make_latency_resampler (modes[i], -1);
+    low = make_latency_resampler (modes[i], 8);
+
+    fail_unless (gst_audio_resampler_get_max_latency (linear) > 8);
+    fail_unless_equals_int (gst_audio_resampler_get_max_latency (low), 8);
+
+    /* with less lookahead, more output is available for the same input */
+    linear_frames = gst_audio_resampler_get_out_frames (linear, 4410);
+    low_frames = gst_audio_resampler_get_out_frames (low, 4410);
+    fail_unless (low_frames > linear_frames);
+    fail_unless (low_frames <= G_N_ELEMENTS (out));
+
+    /* the low-delay filter has the same unity gain, a constant input gives
+     * the same constant output once the zero filled history is gone */
+    gst_audio_resampler_resample (low, inp, G_N_ELEMENTS (in), outp,
+        low_frames);
+    for (j = low_frames / 2; j < low_frames; j++)
+      fail_unless (ABS (out[j] - 0.5) < 0.01, "sample %" G_GSIZE_FORMAT
+          ": %f", j, out[j]);
+
+    gst_audio_resampler_free (linear);
+    gst_audio_resampler_free (low);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_resampler_batch_streams)
+{
+  GstAudioResampler *batch, *single[4];
+  gint16 in[4][160], out[4][320], ref[320];
+  gpointer inp[4], outp[4];
+  gsize out_frames;
+  gint i, j, k;
+
+  batch = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN |
+      GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT, GST_AUDIO_FORMAT_S16,
+      4, 8000, 16000, NULL);
+  for (i = 0; i < 4; i++) {
+    single[i] = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+        GST_AUDIO_FORMAT_S16, 1, 8000, 16000, NULL);
+    inp[i] = in[i];
+    outp[i] = out[i];
+  }
+
+  /* each stream of the batch gives the same samples as its own resampler */
+  for (k = 0; k < 5; k++) {
+    for (i = 0; i < 4; i++)
+      for (j = 0; j < 160; j++)
+        in[i][j] = ((k * 160 + j) * (i + 1) * 311) % 20000 - 10000;
+
+    out_frames = gst_audio_resampler_get_out_frames (batch, 160);
+    fail_unless (out_frames <= 320);
+    gst_audio_resampler_resample (batch, inp, 160, outp, out_frames);
+
+    for (i = 0; i < 4; i++) {
+      gpointer sinp[1] = { in[i] }, soutp[1] = { ref };
+
+      fail_unless_equals_int (gst_audio_resampler_get_out_frames (single[i],
+              160), out_frames);
+      gst_audio_resampler_resample (single[i], sinp, 160, soutp, out_frames);
+      fail_unless (memcmp (out[i], ref, out_frames * sizeof (gint16)) == 0);
+    }
+  }
+
+  gst_audio_resampler_free (batch);
+  for (i = 0; i < 4; i++)
+    gst_audio_resampler_free (single[i]);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GstAudioFormat format;
+  gint channels;
+  GstAudioResamplerFilterMode mode;
+  GstAudioResamplerFilterInterpolation interpolation;
+} ResamplerSimdConfig;
+
+/* the formats and filters that have SIMD inner products */
+static const ResamplerSimdConfig simd_configs[] = {
+  {GST_AUDIO_FORMAT_S16, 1, GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+  {GST_AUDIO_FORMAT_S16, 1, GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+  {GST_AUDIO_FORMAT_F32, 1, GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+  {GST_AUDIO_FORMAT_F64, 1, GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+  {GST_AUDIO_FORMAT_F64, 2, GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+  {GST_AUDIO_FORMAT_F64, 1, GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+};
+
+#define SIMD_IN_FRAMES 4410
+
+/* resample a fixed signal, returns the output samples. With @c_reference
+ * the resampler uses its C functions */
+static gpointer
+resample_simd_config (const ResamplerSimdConfig * config,
+    gboolean c_reference, gsize * size)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  GstAudioInfo info;
+  gdouble *samples;
+  gpointer in, out;
+  gsize out_frames;
+  gint i;
+
+  options = gst_structure_new_empty ("options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 44100, 48000, options);
+  gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, config->mode,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, config->interpolation,
+      "GstAudioResampler.c-reference", G_TYPE_BOOLEAN, c_reference, NULL);
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+      config->format, config->channels, 44100, 48000, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  gst_audio_info_set_format (&info, config->format, 44100, config->channels,
+      NULL);
+
+  /* a saw and noise at full scale, to also hit the clamping */
+  samples = g_new (gdouble, SIMD_IN_FRAMES * config->channels);
+  for (i = 0; i < SIMD_IN_FRAMES * config->channels; i++) {
+    if (i % 2)
+      samples[i] = ((i * 37) % 200 - 100) / 100.0;
+    else
+      samples[i] = ((i * i) % 2001 - 1000) / 1000.0;
+  }
+
+  in = g_malloc (SIMD_IN_FRAMES * GST_AUDIO_INFO_BPF (&info));
+  for (i = 0; i < SIMD_IN_FRAMES * config->channels; i++) {
+    if (config->format == GST_AUDIO_FORMAT_S16)
+      ((gint16 *) in)[i] = CLAMP (samples[i] * 32768.0, -32768, 32767);
+    else if (config->format == GST_AUDIO_FORMAT_F32)
+      ((gfloat *) in)[i] = samples[i];
+    else
+      ((gdouble *) in)[i] = samples[i];
+  }
+  g_free (samples);
+
+  out_frames = gst_audio_resampler_get_out_frames (resampler, SIMD_IN_FRAMES);
+  *size = out_frames * GST_AUDIO_INFO_BPF (&info);
+  out = g_malloc (*size);
+  gst_audio_resampler_resample (resampler, &in, SIMD_IN_FRAMES, &out,
+      out_frames);
+
+  g_free (in);
+  gst_audio_resampler_free (resampler);
+
+  return out;
+}
+
+GST_START_TEST (test_resampler_simd)
+{
+  guint i;
+
+  /* the integer kernels can round the partial sums differently and be 1
+   * off, the float kernels add up in another order and use fused
+   * multiply-adds */
+  for (i = 0; i < G_N_ELEMENTS (simd_configs); i++) {
+    const ResamplerSimdConfig *config = &simd_configs[i];
+    gpointer out, ref;
+    gsize size, ref_size, j;
+
+    GST_INFO ("format %s, %d channels, mode %d, interpolation %d",
+        gst_audio_format_to_string (config->format), config->channels,
+        config->mode, config->interpolation);
+
+    ref = resample_simd_config (config, TRUE, &ref_size);
+    out = resample_simd_config (config, FALSE, &size);
+    fail_unless_equals_int (size, ref_size);
+
+    if (config->format == GST_AUDIO_FORMAT_S16) {
+      const gint16 *o = out, *r = ref;
+
+      for (j = 0; j < size / sizeof (gint16); j++)
+        fail_unless (ABS (o[j] - r[j]) <= 1, "sample %" G_GSIZE_FORMAT
+            ": %d != %d", j, o[j], r[j]);
+    } else if (config->format == GST_AUDIO_FORMAT_F32) {
+      const gfloat *o = out, *r = ref;
+
+      for (j = 0; j < size / sizeof (gfloat); j++)
+        fail_unless (ABS (o[j] - r[j]) < 1e-5, "sample %" G_GSIZE_FORMAT
+            ": %f != %f", j, o[j], r[j]);
+    } else {
+      const gdouble *o = out, *r = ref;
+
+      for (j = 0; j < size / sizeof (gdouble); j++)
+        fail_unless (ABS (o[j] - r[j]) < 1e-10, "sample %" G_GSIZE_FORMAT
+            ": %f != %f", j, o[j], r[j]);
+    }
+    g_free (ref);
+    g_free (out);
+  }
+}
+
+GST_END_TEST;
+#undef SIMD_IN_FRAMES
+
+GST_START_TEST (test_channel_mixer_mono_stereo)
+{
+  GstAudioChannelPosition mono[] = { GST_AUDIO_CHANNEL_POSITION_MONO };
+  GstAudioChannelPosition stereo[] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT
+  };
+  GstAudioChannelMixer *mix;
+  gint16 in[8] = { 0, 1, -1, 1000, -1000, 32767, -32768, 77 };
+  gint16 out[16], out2[8];
+  gpointer inp[1], outp[1];
+  gint i;
+
+  /* mono to stereo copies the samples */
+  mix = gst_audio_channel_mixer_new (0, GST_AUDIO_FORMAT_S16, 1, mono, 2,
+      stereo);
+  inp[0] = in;
+  outp[0] = out;
+  gst_audio_channel_mixer_samples (mix, inp, outp, 8);
+  gst_audio_channel_mixer_free (mix);
+
+  for (i = 0; i < 8; i++) {
+    fail_unless_equals_int (out[2 * i], in[i]);
+    fail_unless_equals_int (out[2 * i + 1], in[i]);
+  }
+
+  /* and back to mono averages them */
+  mix = gst_audio_channel_mixer_new (0, GST_AUDIO_FORMAT_S16, 2, stereo, 1,
+      mono);
+  inp[0] = out;
+  outp[0] = out2;
+  gst_audio_channel_mixer_samples (mix, inp, outp, 8);
+  gst_audio_channel_mixer_free (mix);
+
+  for (i = 0; i < 8; i++)
+    fail_unless_equals_int (out2[i], in[i]);
+}
+
+GST_END_TEST;
+
+#define QUANTIZE_FRAMES 500
+#define QUANTIZE_CHANNELS 6
+
+static void
+quantize_run (GstAudioQuantize * quant, const gint32 * in, gint32 * out)
+{
+  gpointer inp[1], outp[1];
+
+  inp[0] = (gpointer) in;
+  outp[0] = out;
+  gst_audio_quantize_samples (quant, inp, outp, QUANTIZE_FRAMES);
+}
+
+GST_START_TEST (test_quantize_reproducible)
+{
+  GstAudioDitherMethod dither[] = {
+    GST_AUDIO_DITHER_RPDF, GST_AUDIO_DITHER_TPDF, GST_AUDIO_DITHER_TPDF_HF
+  };
+  GstAudioNoiseShapingMethod ns[] = {
+    GST_AUDIO_NOISE_SHAPING_NONE, GST_AUDIO_NOISE_SHAPING_ERROR_FEEDBACK,
+    GST_AUDIO_NOISE_SHAPING_HIGH
+  };
+  gint32 *in, *out1, *out2;
+  gint i, j, k, len = QUANTIZE_FRAMES * QUANTIZE_CHANNELS;
+
+  in = g_new (gint32, len);
+  out1 = g_new (gint32, len);
+  out2 = g_new (gint32, len);
+  for (i = 0; i < len; i++)
+    in[i] = (gint32) ((guint32) i * 7919 * 65536) ^ (i << 3);
+
+  for (i = 0; i < G_N_ELEMENTS (dither); i++) {
+    for (j = 0; j < G_N_ELEMENTS (ns); j++) {
+      GstAudioQuantize *q1, *q2;
+
+      q1 = gst_audio_quantize_new (dither[i], ns[j], 0, GST_AUDIO_FORMAT_S32,
+          QUANTIZE_CHANNELS, 1 << 16);
+      q2 = gst_audio_quantize_new (dither[i], ns[j], 0, GST_AUDIO_FORMAT_S32,
+          QUANTIZE_CHANNELS, 1 << 16);
+
+      /* two quantizers with the same setup give the same output */
+      quantize_run (q1, in, out1);
+      quantize_run (q2, in, out2);
+      fail_unless (memcmp (out1, out2, len * sizeof (gint32)) == 0);
+      for (k = 0; k < len; k++)
+        fail_unless ((out1[k] & 0xffff) == 0);
+
+      /* and after a reset we get the first output again */
+      quantize_run (q1, in, out2);
+      gst_audio_quantize_reset (q1);
+      quantize_run (q1, in, out2);
+      fail_unless (memcmp (out1, out2, len * sizeof (gint32)) == 0);
+
+      gst_audio_quantize_free (q1);
+      gst_audio_quantize_free (q2);
+    }
+  }
+  g_free (in);
+  g_free (out1);
+  g_free (out2);
+}
+
+GST_END_TEST;
+
+#define MIX_FRAMES 600
+
+/* downmix 5.1 to stereo, once interleaved and once non-interleaved, the
+ * results must be the same */
+GST_START_TEST (test_converter_non_interleaved)
+{
+  GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_F32 };
+  gint i, c, n;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstAudioInfo in_info, out_info;
+    GstAudioConverter *convert;
+    const GstAudioFormatInfo *finfo;
+    guint8 *in, *out, *in_planes, *out_planes;
+    gpointer inp[6], outp[2];
+    gint bps;
+
+    finfo = gst_audio_format_get_info (formats[i]);
+    bps = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+
+    in = g_malloc (MIX_FRAMES * 6 * bps);
+    out = g_malloc (MIX_FRAMES * 2 * bps);
+    in_planes = g_malloc (MIX_FRAMES * 6 * bps);
+    out_planes = g_malloc (MIX_FRAMES * 2 * bps);
+
+    for (n = 0; n < MIX_FRAMES; n++) {
+      for (c = 0; c < 6; c++) {
+        gint v = ((n * 37 + c * 1031) % 2001) - 1000;
+
+        if (formats[i] == GST_AUDIO_FORMAT_S16) {
+          ((gint16 *) in)[n * 6 + c] = v * 30;
+          ((gint16 *) in_planes)[c * MIX_FRAMES + n] = v * 30;
+        } else {
+          ((gfloat *) in)[n * 6 + c] = v / 1000.0;
+          ((gfloat *) in_planes)[c * MIX_FRAMES + n] = v / 1000.0;
+        }
+      }
+    }
+
+    gst_audio_info_set_format (&in_info, formats[i], 48000, 6, NULL);
+    gst_audio_info_set_format (&out_info, formats[i], 48000, 2, NULL);
+
+    convert = gst_audio_converter_new (0, &in_info, &out_info, NULL);
+    fail_unless (convert != NULL);
+    inp[0] = in;
+    outp[0] = out;
+    fail_unless (gst_audio_converter_samples (convert, 0, inp, MIX_FRAMES,
+            outp, MIX_FRAMES));
+    gst_audio_converter_free (convert);
+
+    in_info.layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+    out_info.layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+
+    convert = gst_audio_converter_new (0, &in_info, &out_info, NULL);
+    fail_unless (convert != NULL);
+    for (c = 0; c < 6; c++)
+      inp[c] = in_planes + c * MIX_FRAMES * bps;
+    for (c = 0; c < 2; c++)
+      outp[c] = out_planes + c * MIX_FRAMES * bps;
+    fail_unless (gst_audio_converter_samples (convert, 0, inp, MIX_FRAMES,
+            outp, MIX_FRAMES));
+    gst_audio_converter_free (convert);
+
+    for (n = 0; n < MIX_FRAMES; n++) {
+      for (c = 0; c < 2; c++) {
+        fail_unless (memcmp (out + (n * 2 + c) * bps,
+                out_planes + (c * MIX_FRAMES + n) * bps, bps) == 0);
+      }
+    }
+
+    g_free (in);
+    g_free (out);
+    g_free (in_planes);
+    g_free (out_planes);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_converter_stats)
+{
+  static const gchar *stages[] = {
+    "unpack-time", "convert-in-time", "mix-time", "resample-time",
+    "convert-out-time", "quantize-time", "pack-time"
+  };
+  GstAudioInfo in_info, out_info;
+  GstAudioConverter *convert;
+  GstStructure *stats;
+  gint16 in[960 * 2], out[960];
+  gpointer inp[1] = { in }, outp[1] = { out };
+  guint64 frames, time, stage, sum;
+  gsize out_frames;
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++)
+    in[i] = (i * 311) % 20000 - 10000;
+
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 48000, 2, NULL);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_S16, 44100, 1, NULL);
+
+  convert = gst_audio_converter_new (0, &in_info, &out_info,
+      gst_structure_new ("options", GST_AUDIO_CONVERTER_OPT_STATS,
+          G_TYPE_BOOLEAN, TRUE, NULL));
+  fail_unless (convert != NULL);
+
+  out_frames = gst_audio_converter_get_out_frames (convert, 960);
+  fail_unless (out_frames <= G_N_ELEMENTS (out));
+  fail_unless (gst_audio_converter_samples (convert, 0, inp, 960, outp,
+          out_frames));
+
+  stats = gst_audio_converter_get_stats (convert);
+  fail_unless (gst_structure_get_uint64 (stats, "frames", &frames));
+  fail_unless_equals_uint64 (frames, 960);
+  fail_unless (gst_structure_get_uint64 (stats, "time", &time));
+
+  /* the stages are measured inside the total time */
+  for (i = 0, sum = 0; i < G_N_ELEMENTS (stages); i++) {
+    fail_unless (gst_structure_get_uint64 (stats, stages[i], &stage));
+    sum += stage;
+  }
+  fail_unless (sum <= time);
+  gst_structure_free (stats);
+
+  gst_audio_converter_free (convert);
+}
+
+GST_END_TEST;
+
+/* a ringbuffer without a device, the test plays the device thread */
+typedef struct
+{
+  GstAudioRingBuffer parent;
+} GstTestRingBuffer;
+
+typedef struct
+{
+  GstAudioRingBufferClass parent_class;
+} GstTestRingBufferClass;
+
+static GType gst_test_ring_buffer_get_type (void);
+G_DEFINE_TYPE (GstTestRingBuffer, gst_test_ring_buffer,
+    GST_TYPE_AUDIO_RING_BUFFER);
+
+static gboolean
+gst_test_ring_buffer_open_device (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static gboolean
+gst_test_ring_buffer_acquire (GstAudioRingBuffer * buf,
+    GstAudioRingBufferSpec * spec)
+{
+  buf->size = spec->segtotal * spec->segsize;
+  buf->memory = g_malloc0 (buf->size);
+  return TRUE;
+}
+
+static gboolean
+gst_test_ring_buffer_release (GstAudioRingBuffer * buf)
+{
+  g_free (buf->memory);
+  buf->memory = NULL;
+  return TRUE;
+}
+
+static gboolean
+gst_test_ring_buffer_state (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static void
+gst_test_ring_buffer_class_init (GstTestRingBufferClass * klass)
+{
+  GstAudioRingBufferClass *rclass = (GstAudioRingBufferClass *) klass;
+
+  rclass->open_device = gst_test_ring_buffer_open_device;
+  rclass->close_device = gst_test_ring_buffer_open_device;
+  rclass->acquire = gst_test_ring_buffer_acquire;
+  rclass->release = gst_test_ring_buffer_release;
+  rclass->start = gst_test_ring_buffer_state;
+  rclass->pause = gst_test_ring_buffer_state;
+  rclass->resume = gst_test_ring_buffer_state;
+  rclass->stop = gst_test_ring_buffer_state;
+}
+
+static void
+gst_test_ring_buffer_init (GstTestRingBuffer * buf)
+{
+}
+
+/* 4 segments of 10ms S16 stereo */
+#define RING_SEGSAMPLES 441
+#define RING_SEGTOTAL 4
+
+static GstAudioRingBuffer *
+setup_test_ring_buffer (void)
+{
+  GstAudioRingBuffer *buf;
+  GstCaps *caps;
+
+  buf = g_object_new (gst_test_ring_buffer_get_type (), NULL);
+  fail_unless (gst_audio_ring_buffer_open_device (buf));
+
+  caps = gst_caps_from_string ("audio/x-raw, format=(string)S16LE, "
+      "layout=(string)interleaved, rate=(int)44100, channels=(int)2");
+  fail_unless (gst_audio_ring_buffer_parse_caps (&buf->spec, caps));
+  gst_caps_unref (caps);
+  buf->spec.segsize = RING_SEGSAMPLES * 4;
+  buf->spec.segtotal = RING_SEGTOTAL;
+
+  fail_unless (gst_audio_ring_buffer_acquire (buf, &buf->spec));
+  gst_audio_ring_buffer_may_start (buf, TRUE);
+
+  return buf;
+}
+
+static void
+teardown_test_ring_buffer (GstAudioRingBuffer * buf)
+{
+  fail_unless (gst_audio_ring_buffer_stop (buf));
+  fail_unless (gst_audio_ring_buffer_release (buf));
+  fail_unless (gst_audio_ring_buffer_close_device (buf));
+  gst_object_unref (buf);
+}
+
+static gboolean ring_device_running;
+
+/* reads a segment every 5ms, like the thread of a sink would */
+static gpointer
+ring_device_thread (gpointer user_data)
+{
+  GstAudioRingBuffer *buf = user_data;
+  guint8 *ptr;
+  gint seg, len;
+
+  while (g_atomic_int_get (&ring_device_running)) {
+    if (gst_audio_ring_buffer_prepare_read (buf, &seg, &ptr, &len)) {
+      gst_audio_ring_buffer_clear (buf, seg);
+      gst_audio_ring_buffer_advance (buf, 1);
+    }
+    g_usleep (5000);
+  }
+
+  return NULL;
+}
+
+/* the writer has to wait for the device thread for most segments, it is
+ * woken up by every advance */
+GST_START_TEST (test_ring_buffer_wakeups)
+{
+  GstAudioRingBuffer *buf;
+  GThread *thread;
+  GstStructure *stats;
+  gint16 data[RING_SEGSAMPLES * 2] = { 0, };
+  guint64 sample = 0, wakeups, last, max, average;
+  guint missed;
+  gint accum = 0, i;
+
+  buf = setup_test_ring_buffer ();
+
+  stats = gst_audio_ring_buffer_get_stats (buf);
+  fail_unless (gst_structure_get_uint64 (stats, "wakeups", &wakeups));
+  fail_unless_equals_uint64 (wakeups, 0);
+  gst_structure_free (stats);
+
+  g_atomic_int_set (&ring_device_running, TRUE);
+  thread = g_thread_new ("device", ring_device_thread, buf);
+
+  for (i = 0; i < 6 * RING_SEGTOTAL; i++) {
+    fail_unless_equals_int (gst_audio_ring_buffer_commit (buf, &sample,
+            (guint8 *) data, RING_SEGSAMPLES, RING_SEGSAMPLES, &accum),
+        RING_SEGSAMPLES);
+  }
+
+  g_atomic_int_set (&ring_device_running, FALSE);
+  g_thread_join (thread);
+
+  stats = gst_audio_ring_buffer_get_stats (buf);
+  fail_unless (gst_structure_get_uint64 (stats, "wakeups", &wakeups));
+  fail_unless (gst_structure_get_uint64 (stats, "last-wake-latency", &last));
+  fail_unless (gst_structure_get_uint64 (stats, "max-wake-latency", &max));
+  fail_unless (gst_structure_get_uint64 (stats, "average-wake-latency",
+          &average));
+  fail_unless (gst_structure_get_uint (stats, "missed-segments", &missed));
+  gst_structure_free (stats);
+
+  GST_INFO ("%" G_GUINT64_FORMAT " wakeups, max latency %" GST_TIME_FORMAT
+      ", %u missed segments", wakeups, GST_TIME_ARGS (max), missed);
+  fail_unless (wakeups > 0);
+  fail_unless (wakeups <= 6 * RING_SEGTOTAL);
+  fail_unless (last <= max);
+  fail_unless (average <= max);
+
+  /* acquiring resets the statistics */
+  fail_unless (gst_audio_ring_buffer_stop (buf));
+  fail_unless (gst_audio_ring_buffer_release (buf));
+  fail_unless (gst_audio_ring_buffer_acquire (buf, &buf->spec));
+  stats = gst_audio_ring_buffer_get_stats (buf);
+  fail_unless (gst_structure_get_uint64 (stats, "wakeups", &wakeups));
+  fail_unless_equals_uint64 (wakeups, 0);
+  fail_unless (gst_structure_get_uint (stats, "missed-segments", &missed));
+  fail_unless_equals_int (missed, 0);
+  gst_structure_free (stats);
+
+  teardown_test_ring_buffer (buf);
+}
+
+GST_END_TEST;
+
+static gpointer
+ring_commit_thread (gpointer user_data)
+{
+  GstAudioRingBuffer *buf = user_data;
+  gint16 data[RING_SEGSAMPLES * 2] = { 0, };
+  guint64 sample = 0;
+  gint accum = 0;
+  guint written;
+
+  /* until it fails, nobody reads */
+  written = gst_audio_ring_buffer_commit (buf, &sample, (guint8 *) data,
+      RING_SEGSAMPLES, RING_SEGSAMPLES, &accum);
+  while (written == RING_SEGSAMPLES)
+    written = gst_audio_ring_buffer_commit (buf, &sample, (guint8 *) data,
+        RING_SEGSAMPLES, RING_SEGSAMPLES, &accum);
+
+  return GUINT_TO_POINTER (sample);
+}
+
+/* a subclass that only signals the GCond when it stops its device must still
+ * get the waiting writer going, with futexes by the timeout of the wait */
+GST_START_TEST (test_ring_buffer_wait_timeout)
+{
+  GstAudioRingBuffer *buf;
+  GThread *thread;
+  gint64 start, elapsed;
+  guint64 sample;
+
+  buf = setup_test_ring_buffer ();
+
+  thread = g_thread_new ("writer", ring_commit_thread, buf);
+
+  /* wait until the writer filled everything and blocks */
+  while (g_atomic_int_get (&buf->waiting) == 0)
+    g_usleep (1000);
+  g_usleep (10000);
+
+  start = g_get_monotonic_time ();
+  GST_OBJECT_LOCK (buf);
+  buf->flushing = TRUE;
+  GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  GST_OBJECT_UNLOCK (buf);
+
+  sample = GPOINTER_TO_UINT (g_thread_join (thread));
+  elapsed = g_get_monotonic_time () - start;
+
+  GST_INFO ("writer stopped after %" G_GINT64_FORMAT "us", elapsed);
+  fail_unless_equals_uint64 (sample, RING_SEGTOTAL * RING_SEGSAMPLES);
+  /* the futex wait times out after 100ms, leave room for slow machines */
+  fail_unless (elapsed < G_USEC_PER_SEC);
+
+  gst_audio_ring_buffer_set_flushing (buf, FALSE);
+  teardown_test_ring_buffer (buf);
+}
+
+GST_END_TEST;
+
+static gpointer
+resampler_thread_func (gpointer data)
+{
+  GstStructure *options = data;
+  GstAudioResampler *resampler;
+  gfloat *out;
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+      GST_AUDIO_FORMAT_F32, 1, 44100, 48000, options);
+  out = g_new (gfloat, 4800);
+  resample_saw (resampler, out,
+      gst_audio_resampler_get_out_frames (resampler, 4410));
+  gst_audio_resampler_free (resampler);
+
+  return out;
+}
+
+/* resamplers that make the same tables at the same time all end up with
+ * the same output */
+GST_START_TEST (test_resampler_shared_taps_threads)
+{
+  GstAudioResamplerFilterMode modes[] = {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+    GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED
+  };
+  GThread *threads[4];
+  GstAudioResampler *resampler;
+  gfloat ref[4800], *out;
+  gsize out_frames;
+  gint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (modes); i++) {
+    GstStructure *options;
+
+    options = gst_structure_new_empty ("options");
+    gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 44100, 48000, options);
+    gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+        GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, modes[i], NULL);
+
+    for (j = 0; j < G_N_ELEMENTS (threads); j++)
+      threads[j] = g_thread_new ("resampler", resampler_thread_func, options);
+
+    resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+        GST_AUDIO_FORMAT_F32, 1, 44100, 48000, options);
+    out_frames = gst_audio_resampler_get_out_frames (resampler, 4410);
+    resample_saw (resampler, ref, out_frames);
+
+    for (j = 0; j < G_N_ELEMENTS (threads); j++) {
+      out = g_thread_join (threads[j]);
+      fail_unless (memcmp (ref, out, out_frames * sizeof (gfloat)) == 0);
+      g_free (out);
+    }
+    gst_audio_resampler_free (resampler);
+    gst_structure_free (options);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -621,11 +1649,26 @@ audio_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_audio_info);
+  tcase_add_test (tc_chain, test_audio_info_from_caps);
   tcase_add_test (tc_chain, test_buffer_clipping_time);
   tcase_add_test (tc_chain, test_buffer_clipping_samples);
   tcase_add_test (tc_chain, test_multichannel_checks);
   tcase_add_test (tc_chain, test_multichannel_reorder);
+  tcase_add_test (tc_chain, test_multichannel_reorder_blocks);
   tcase_add_test (tc_chain, test_fill_silence);
+  tcase_add_test (tc_chain, test_pack_unpack_24);
+  tcase_add_test (tc_chain, test_iec61937_payload_buffer);
+  tcase_add_test (tc_chain, test_resampler_shared_taps);
+  tcase_add_test (tc_chain, test_resampler_shared_taps_threads);
+  tcase_add_test (tc_chain, test_resampler_filter_latency);
+  tcase_add_test (tc_chain, test_resampler_batch_streams);
+  tcase_add_test (tc_chain, test_resampler_simd);
+  tcase_add_test (tc_chain, test_converter_non_interleaved);
+  tcase_add_test (tc_chain, test_converter_stats);
+  tcase_add_test (tc_chain, test_channel_mixer_mono_stereo);
+  tcase_add_test (tc_chain, test_quantize_reproducible);
+  tcase_add_test (tc_chain, test_ring_buffer_wakeups);
+  tcase_add_test (tc_chain, test_ring_buffer_wait_timeout);
 
   return s;
 }
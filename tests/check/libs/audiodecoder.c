@@ -73,6 +73,9 @@ struct _GstAudioDecoderTester
 
   gboolean setoutputformat_on_decoding;
   gboolean output_too_many_frames;
+
+  /* the memory of the last input buffer, only to compare with */
+  GstMemory *last_input_memory;
 };
 
 struct _GstAudioDecoderTesterClass
@@ -131,6 +134,8 @@ gst_audio_decoder_tester_handle_frame (GstAudioDecoder * dec,
   if (buffer == NULL)
     return GST_FLOW_OK;
 
+  tester->last_input_memory = gst_buffer_peek_memory (buffer, 0);
+
   if (tester->setoutputformat_on_decoding) {
     GstCaps *caps;
     GstAudioInfo info;
@@ -279,6 +284,156 @@ GST_START_TEST (audiodecoder_playback)
 
 GST_END_TEST;
 
+GST_START_TEST (audiodecoder_playback_no_copy)
+{
+  GstAudioDecoderTester *tester;
+  GstBuffer *buffer;
+  GstMemory *mem;
+  guint64 i;
+
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+
+  tester = (GstAudioDecoderTester *) h->element;
+
+  /* without parse, the subclass gets the memory of every input buffer */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+    mem = gst_buffer_peek_memory (buffer, 0);
+
+    fail_unless (gst_harness_push (h, buffer) == GST_FLOW_OK);
+    fail_unless (tester->last_input_memory == mem);
+
+    gst_buffer_unref (gst_harness_pull (h));
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* answers the latency query of the decoder as a live or non-live source */
+static gboolean upstream_live;
+static GstPadQueryFunction harness_src_query;
+
+static gboolean
+upstream_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_LATENCY) {
+    gst_query_set_latency (query, upstream_live, 0, GST_CLOCK_TIME_NONE);
+    return TRUE;
+  }
+
+  return harness_src_query (pad, parent, query);
+}
+
+static void
+set_upstream_live (GstHarness * h, gboolean live)
+{
+  upstream_live = live;
+  harness_src_query = GST_PAD_QUERYFUNC (h->srcpad);
+  gst_pad_set_query_function (h->srcpad, upstream_query);
+}
+
+GST_START_TEST (audiodecoder_output_list)
+{
+  GstBuffer *buffer;
+  guint64 i;
+
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+
+  set_upstream_live (h, FALSE);
+
+  /* collect output until 3.5 buffers worth of data */
+  g_object_set (h->element, "output-list-duration",
+      gst_util_uint64_scale (7, GST_SECOND, 2 * TEST_MSECS_PER_SAMPLE), NULL);
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+
+    /* every 4th buffer completes a list */
+    fail_unless_equals_int (((i + 1) / 4) * 4,
+        gst_harness_buffers_in_queue (h));
+  }
+
+  /* EOS pushes out the remainder before itself */
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (NUM_BUFFERS, gst_harness_buffers_in_queue (h));
+
+  /* buffers keep their timestamps and flags */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = gst_harness_pull (h);
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+    num = *(guint64 *) map.data;
+    fail_unless_equals_uint64 (i, num);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i, GST_SECOND, TEST_MSECS_PER_SAMPLE));
+    fail_unless_equals_int (i == 0,
+        ! !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DISCONT));
+
+    gst_buffer_unmap (buffer, &map);
+
+    gst_buffer_unref (buffer);
+  }
+
+  fail_unless_equals_int (0, gst_harness_buffers_in_queue (h));
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_output_list_live)
+{
+  guint64 i;
+
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+
+  set_upstream_live (h, TRUE);
+  g_object_set (h->element, "output-list-duration", GST_SECOND, NULL);
+
+  /* a live source can stop at any time, nothing is held back */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+    fail_unless_equals_int (i + 1, gst_harness_buffers_in_queue (h));
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_output_list_max_hold)
+{
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+
+  set_upstream_live (h, FALSE);
+  g_object_set (h->element, "output-list-duration", 20 * GST_MSECOND, NULL);
+
+  /* far less than 20ms of data, but it was held back for 20ms */
+  fail_unless (gst_harness_push (h, create_test_buffer (0)) == GST_FLOW_OK);
+  fail_unless_equals_int (0, gst_harness_buffers_in_queue (h));
+  g_usleep (20 * G_USEC_PER_SEC / 1000);
+  fail_unless (gst_harness_push (h, create_test_buffer (1)) == GST_FLOW_OK);
+  fail_unless_equals_int (2, gst_harness_buffers_in_queue (h));
+
+  /* a gap pushes out what was collected before it */
+  fail_unless (gst_harness_push (h, create_test_buffer (2)) == GST_FLOW_OK);
+  fail_unless_equals_int (2, gst_harness_buffers_in_queue (h));
+  fail_unless (gst_harness_push_event (h,
+          gst_event_new_gap (gst_util_uint64_scale_round (3, GST_SECOND,
+                  TEST_MSECS_PER_SAMPLE), GST_MSECOND)));
+  fail_unless_equals_int (3, gst_harness_buffers_in_queue (h));
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 
 static void
 check_audiodecoder_negotiation (GstHarness * h)
@@ -1018,6 +1173,10 @@ gst_audiodecoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, audiodecoder_playback);
+  tcase_add_test (tc, audiodecoder_playback_no_copy);
+  tcase_add_test (tc, audiodecoder_output_list);
+  tcase_add_test (tc, audiodecoder_output_list_live);
+  tcase_add_test (tc, audiodecoder_output_list_max_hold);
   tcase_add_test (tc, audiodecoder_negotiation_with_buffer);
 
   tcase_add_test (tc, audiodecoder_negotiation_with_gap_event);
@@ -36,6 +36,10 @@ typedef struct _GstTestScopeClass GstTestScopeClass;
 struct _GstTestScope
 {
   GstAudioVisualizer parent;
+
+  /* draw a pattern into the first frame */
+  gboolean draw_pattern;
+  guint frames;
 };
 
 struct _GstTestScopeClass
@@ -65,10 +69,30 @@ static GType gst_test_scope_get_type (void);
 
 G_DEFINE_TYPE (GstTestScope, gst_test_scope, GST_TYPE_AUDIO_VISUALIZER);
 
+static gboolean
+gst_test_scope_render (GstAudioVisualizer * base, GstBuffer * audio,
+    GstVideoFrame * video)
+{
+  GstTestScope *scope = GST_TEST_SCOPE (base);
+  guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (video, 0);
+  gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (video, 0);
+  gint i, j;
+
+  if (scope->draw_pattern && scope->frames == 0) {
+    for (j = 0; j < GST_VIDEO_FRAME_HEIGHT (video); j++)
+      for (i = 0; i < stride; i++)
+        data[j * stride + i] = i * 7 + j * 13;
+  }
+  scope->frames++;
+
+  return TRUE;
+}
+
 static void
 gst_test_scope_class_init (GstTestScopeClass * g_class)
 {
   GstElementClass *element_class = GST_ELEMENT_CLASS (g_class);
+  GstAudioVisualizerClass *scope_class = GST_AUDIO_VISUALIZER_CLASS (g_class);
 
   gst_element_class_set_static_metadata (element_class, "test scope",
       "Visualization",
@@ -78,6 +102,8 @@ gst_test_scope_class_init (GstTestScopeClass * g_class)
       &gst_test_scope_src_template);
   gst_element_class_add_static_pad_template (element_class,
       &gst_test_scope_sink_template);
+
+  scope_class->render = GST_DEBUG_FUNCPTR (gst_test_scope_render);
 }
 
 static void
@@ -154,6 +180,73 @@ GST_START_TEST (count_in_out)
 
 GST_END_TEST;
 
+GST_START_TEST (shader_fade)
+{
+  GstElement *elem;
+  GstPad *srcpad, *sinkpad;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstMapInfo map0, map1;
+  guint32 shade = 0x00102030;
+  guint i, k;
+
+  /* setup up */
+  elem = gst_check_setup_element ("testscope");
+  GST_TEST_SCOPE (elem)->draw_pattern = TRUE;
+  g_object_set (elem, "shader", GST_AUDIO_VISUALIZER_SHADER_FADE,
+      "shade-amount", shade, NULL);
+  srcpad = gst_check_setup_src_pad (elem, &srctemplate);
+  sinkpad = gst_check_setup_sink_pad (elem, &sinktemplate);
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (elem,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (CAPS);
+  gst_check_setup_events (srcpad, elem, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* 2 video-frames */
+  buffer = gst_buffer_new_and_alloc (2 * 1470 * 2 * sizeof (gint16));
+  fail_unless (gst_pad_push (srcpad, buffer) == GST_FLOW_OK);
+  fail_unless (g_list_length (buffers) >= 2);
+
+  /* the second frame is the shaded first frame, the shader works on native
+   * endian words and clears the top byte */
+  gst_buffer_map (buffers->data, &map0, GST_MAP_READ);
+  gst_buffer_map (buffers->next->data, &map1, GST_MAP_READ);
+  fail_unless_equals_int (map0.size, map1.size);
+  for (i = 0; i < map0.size / 4; i++) {
+    guint32 in = ((guint32 *) map0.data)[i];
+    guint32 out = ((guint32 *) map1.data)[i];
+    guint32 expected = 0;
+
+    for (k = 0; k < 24; k += 8) {
+      gint c = ((in >> k) & 0xff) - ((shade >> k) & 0xff);
+
+      expected |= MAX (c, 0) << k;
+    }
+    fail_unless_equals_int (out, expected);
+  }
+  gst_buffer_unmap (buffers->data, &map0);
+  gst_buffer_unmap (buffers->next->data, &map1);
+
+  /* clean up */
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_check_teardown_src_pad (elem);
+  gst_check_teardown_sink_pad (elem);
+  gst_check_teardown_element (elem);
+}
+
+GST_END_TEST;
+
 static void
 baseaudiovisualizer_init (void)
 {
@@ -170,6 +263,7 @@ baseaudiovisualizer_suite (void)
   tcase_add_checked_fixture (tc_chain, baseaudiovisualizer_init, NULL);
 
   tcase_add_test (tc_chain, count_in_out);
+  tcase_add_test (tc_chain, shader_fade);
 
   return s;
 }
@@ -231,6 +231,168 @@ GST_START_TEST (test_disco_missing_plugins)
 
 GST_END_TEST;
 
+GST_START_TEST (test_disco_cache)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info, *cached;
+  GList *streams, *cached_streams;
+  gchar *uri, *path;
+
+  dc = gst_discoverer_new (10 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "use-cache", TRUE, NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  g_clear_error (&err);
+
+  /* only successful results end up in the cache */
+  if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK) {
+    cached = gst_discoverer_discover_uri (dc, uri, &err);
+    fail_unless (cached != NULL);
+    fail_unless (err == NULL);
+    fail_unless_equals_int (gst_discoverer_info_get_result (cached),
+        GST_DISCOVERER_OK);
+    fail_unless_equals_string (gst_discoverer_info_get_uri (cached), uri);
+    fail_unless_equals_uint64 (gst_discoverer_info_get_duration (cached),
+        gst_discoverer_info_get_duration (info));
+
+    streams = gst_discoverer_info_get_stream_list (info);
+    cached_streams = gst_discoverer_info_get_stream_list (cached);
+    fail_unless_equals_int (g_list_length (cached_streams),
+        g_list_length (streams));
+    gst_discoverer_stream_info_list_free (streams);
+    gst_discoverer_stream_info_list_free (cached_streams);
+
+    gst_discoverer_info_unref (cached);
+  }
+
+  gst_discoverer_info_unref (info);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_disco_parse_only)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info;
+  GList *streams, *l;
+  gchar *uri, *path;
+
+  dc = gst_discoverer_new (10 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "parse-only", TRUE, NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  g_clear_error (&err);
+
+  /* nothing was decoded */
+  if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK) {
+    streams = gst_discoverer_info_get_stream_list (info);
+    fail_unless (streams != NULL);
+    for (l = streams; l; l = l->next) {
+      GstCaps *caps = gst_discoverer_stream_info_get_caps (l->data);
+      const gchar *name;
+
+      name = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+      fail_if (g_str_has_suffix (name, "/x-raw"), "decoded stream %s", name);
+      gst_caps_unref (caps);
+    }
+    gst_discoverer_stream_info_list_free (streams);
+  }
+
+  gst_discoverer_info_unref (info);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GMainLoop *loop;
+  guint starting;
+  guint discovered;
+} AsyncData;
+
+static void
+_disco_starting (GstDiscoverer * dc, AsyncData * data)
+{
+  data->starting++;
+}
+
+static void
+_disco_discovered (GstDiscoverer * dc, GstDiscovererInfo * info,
+    GError * err, AsyncData * data)
+{
+  GST_INFO ("discovered %s: %d", gst_discoverer_info_get_uri (info),
+      gst_discoverer_info_get_result (info));
+  data->discovered++;
+}
+
+static void
+_disco_finished (GstDiscoverer * dc, AsyncData * data)
+{
+  g_main_loop_quit (data->loop);
+}
+
+GST_START_TEST (test_disco_async_parallel)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  AsyncData data = { NULL, 0, 0 };
+  gchar *uri, *path;
+  int i;
+
+  dc = gst_discoverer_new (10 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "max-parallel", 2, NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect (dc, "starting", G_CALLBACK (_disco_starting), &data);
+  g_signal_connect (dc, "discovered", G_CALLBACK (_disco_discovered), &data);
+  g_signal_connect (dc, "finished", G_CALLBACK (_disco_finished), &data);
+
+  gst_discoverer_start (dc);
+  for (i = 0; i < 5; ++i)
+    fail_unless (gst_discoverer_discover_uri_async (dc, uri));
+  g_main_loop_run (data.loop);
+  gst_discoverer_stop (dc);
+
+  /* one batch, every uri reported once */
+  fail_unless_equals_int (data.starting, 1);
+  fail_unless_equals_int (data.discovered, 5);
+
+  g_main_loop_unref (data.loop);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
 static Suite *
 discoverer_suite (void)
 {
@@ -245,6 +407,9 @@ discoverer_suite (void)
   tcase_add_test (tc_chain, test_disco_sync_reuse_timeout);
   tcase_add_test (tc_chain, test_disco_missing_plugins);
   tcase_add_test (tc_chain, test_disco_serializing);
+  tcase_add_test (tc_chain, test_disco_async_parallel);
+  tcase_add_test (tc_chain, test_disco_cache);
+  tcase_add_test (tc_chain, test_disco_parse_only);
   return s;
 }
 
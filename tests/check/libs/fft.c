@@ -26,6 +26,8 @@
 
 #include <gst/check/gstcheck.h>
 
+#include <string.h>
+
 #include <gst/fft/gstfft.h>
 #include <gst/fft/gstffts16.h>
 #include <gst/fft/gstffts32.h>
@@ -401,6 +403,43 @@ GST_START_TEST (test_f32_22050hz)
 
 GST_END_TEST;
 
+GST_START_TEST (test_f32_fft_many)
+{
+  gint i, n;
+  gfloat *in, *frame;
+  GstFFTF32Complex *out, *ref;
+  GstFFTF32 *ctx;
+
+  in = g_new (gfloat, 1024 + 3 * 256);
+  frame = g_new (gfloat, 1024);
+  out = g_new (GstFFTF32Complex, 4 * 513);
+  ref = g_new (GstFFTF32Complex, 513);
+  ctx = gst_fft_f32_new (1024, FALSE);
+
+  for (i = 0; i < 1024 + 3 * 256; i++)
+    in[i] = sin (i * 0.1) + 0.5 * sin (i * 0.77);
+
+  gst_fft_f32_fft_many (ctx, in, 256, 4, GST_FFT_WINDOW_HANN, out);
+
+  /* must be the same as windowing and transforming each frame */
+  for (n = 0; n < 4; n++) {
+    memcpy (frame, in + n * 256, 1024 * sizeof (gfloat));
+    gst_fft_f32_window (ctx, frame, GST_FFT_WINDOW_HANN);
+    gst_fft_f32_fft (ctx, frame, ref);
+
+    fail_unless (memcmp (out + n * 513, ref,
+            513 * sizeof (GstFFTF32Complex)) == 0);
+  }
+
+  gst_fft_f32_free (ctx);
+  g_free (in);
+  g_free (frame);
+  g_free (out);
+  g_free (ref);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_f64_0hz)
 {
   gint i;
@@ -538,6 +577,7 @@ fft_suite (void)
   tcase_add_test (tc_chain, test_f32_0hz);
   tcase_add_test (tc_chain, test_f32_11025hz);
   tcase_add_test (tc_chain, test_f32_22050hz);
+  tcase_add_test (tc_chain, test_f32_fft_many);
   tcase_add_test (tc_chain, test_f64_0hz);
   tcase_add_test (tc_chain, test_f64_11025hz);
   tcase_add_test (tc_chain, test_f64_22050hz);
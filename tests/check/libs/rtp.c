@@ -201,6 +201,125 @@ GST_START_TEST (test_rtp_buffer_validate_padding)
 
 GST_END_TEST;
 
+/* a packet in one memory is parsed from the first map only, it must give the
+ * same result as the same packet spread over several memories */
+GST_START_TEST (test_rtp_buffer_map_single_memory)
+{
+  guint8 packet[] = {
+    0xb0, 0x60, 0x6c, 0x49, 0x58, 0xab, 0xaa, 0x65, 0x65, 0x2e, 0xaf, 0xce,
+    0xbe, 0xde, 0x00, 0x01, 0x10, 0x42, 0x00, 0x00,
+    0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x00, 0x04
+  };
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *single, *multi;
+  gpointer ext_data;
+  guint16 bits;
+  guint wordlen;
+
+  single = gst_buffer_new_and_alloc (sizeof (packet));
+  gst_buffer_fill (single, 0, packet, sizeof (packet));
+  fail_unless_equals_int (gst_buffer_n_memory (single), 1);
+
+  multi = gst_buffer_new ();
+  gst_buffer_append_memory (multi,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, packet, 12, 0, 12,
+          NULL, NULL));
+  gst_buffer_append_memory (multi,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, packet + 12, 8, 0, 8,
+          NULL, NULL));
+  gst_buffer_append_memory (multi,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, packet + 20, 8, 0, 8,
+          NULL, NULL));
+
+  fail_unless (gst_rtp_buffer_map (single, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 4);
+  fail_unless_equals_int (gst_rtp_buffer_get_packet_len (&rtp),
+      sizeof (packet));
+  fail_unless (gst_rtp_buffer_get_extension_data (&rtp, &bits, &ext_data,
+          &wordlen));
+  fail_unless_equals_int (bits, 0xbede);
+  fail_unless_equals_int (wordlen, 1);
+  fail_unless_equals_int (((guint8 *) ext_data)[1], 0x42);
+  fail_unless_equals_int (((guint8 *)
+          gst_rtp_buffer_get_payload (&rtp))[3], 0x04);
+  gst_rtp_buffer_unmap (&rtp);
+
+  fail_unless (gst_rtp_buffer_map (multi, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 4);
+  fail_unless (gst_rtp_buffer_get_extension_data (&rtp, &bits, &ext_data,
+          &wordlen));
+  fail_unless_equals_int (bits, 0xbede);
+  fail_unless_equals_int (wordlen, 1);
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* an extension length past the end of the packet */
+  gst_buffer_memset (single, 15, 0x10, 1);
+  fail_if (gst_rtp_buffer_map (single, GST_MAP_READ, &rtp));
+
+  gst_buffer_unref (single);
+  gst_buffer_unref (multi);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtp_buffer_new_with_payload)
+{
+  GstBuffer *payload, *buf;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstMapInfo pmap;
+  guint8 *data;
+  guint i;
+
+  payload = gst_buffer_new_and_alloc (100);
+  gst_buffer_map (payload, &pmap, GST_MAP_WRITE);
+  for (i = 0; i < 100; i++)
+    pmap.data[i] = i;
+  gst_buffer_unmap (payload, &pmap);
+
+  buf = gst_rtp_buffer_new_with_payload (payload, 10, 50, 4, 2);
+  fail_unless (buf != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buf),
+      gst_rtp_buffer_calc_header_len (2) + 50 + 4);
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_version (&rtp), 2);
+  fail_unless (gst_rtp_buffer_get_padding (&rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_csrc_count (&rtp), 2);
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 50);
+  data = gst_rtp_buffer_get_payload (&rtp);
+  for (i = 0; i < 50; i++)
+    fail_unless_equals_int (data[i], 10 + i);
+
+  /* the payload memory is shared, not copied */
+  gst_buffer_map (payload, &pmap, GST_MAP_READ);
+  fail_unless (data == pmap.data + 10);
+  gst_buffer_unmap (payload, &pmap);
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* header extensions go in their own memory */
+  buf = gst_buffer_make_writable (buf);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp));
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp, 5,
+          "abcd", 4));
+  gst_rtp_buffer_unmap (&rtp);
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 50);
+  data = gst_rtp_buffer_get_payload (&rtp);
+  fail_unless_equals_int (data[0], 10);
+  gst_rtp_buffer_unmap (&rtp);
+
+  gst_buffer_map (payload, &pmap, GST_MAP_READ);
+  fail_unless_equals_int (pmap.data[0], 0);
+  fail_unless_equals_int (pmap.data[10], 10);
+  gst_buffer_unmap (payload, &pmap);
+
+  gst_buffer_unref (buf);
+  gst_buffer_unref (payload);
+}
+
+GST_END_TEST;
+
 #if 0
 GST_START_TEST (test_rtp_buffer_list)
 {
@@ -793,6 +912,62 @@ GST_START_TEST (test_rtcp_buffer)
 
 GST_END_TEST;
 
+/* packets are added after the ones that were in the buffer when it was
+ * mapped */
+GST_START_TEST (test_rtcp_buffer_add_packet_append)
+{
+  GstBuffer *buf;
+  GstRTCPPacket packet;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  guint i;
+
+  buf = gst_rtcp_buffer_new (1400);
+
+  gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+  fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RR, &packet));
+  gst_rtcp_packet_rr_set_ssrc (&packet, 0x11111111);
+  fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_SDES,
+          &packet));
+  fail_unless (gst_rtcp_packet_sdes_add_item (&packet, 0x11111111));
+  fail_unless (gst_rtcp_packet_sdes_add_entry (&packet, GST_RTCP_SDES_CNAME,
+          5, (const guint8 *) "cname"));
+  gst_rtcp_buffer_unmap (&rtcp);
+  fail_unless_equals_int (gst_buffer_get_size (buf), 8 + 16);
+
+  gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+  for (i = 0; i < 10; i++) {
+    fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB,
+            &packet));
+    fail_unless_equals_int (packet.offset, 8 + 16 + i * 12);
+    gst_rtcp_packet_fb_set_type (&packet, GST_RTCP_RTPFB_TYPE_NACK);
+    gst_rtcp_packet_fb_set_media_ssrc (&packet, i);
+  }
+  gst_rtcp_buffer_unmap (&rtcp);
+
+  fail_unless (gst_rtcp_buffer_validate (buf));
+
+  gst_rtcp_buffer_map (buf, GST_MAP_READ, &rtcp);
+  fail_unless_equals_int (gst_rtcp_buffer_get_packet_count (&rtcp), 12);
+  fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &packet));
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packet),
+      GST_RTCP_TYPE_RR);
+  fail_unless (gst_rtcp_packet_move_to_next (&packet));
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packet),
+      GST_RTCP_TYPE_SDES);
+  for (i = 0; i < 10; i++) {
+    fail_unless (gst_rtcp_packet_move_to_next (&packet));
+    fail_unless_equals_int (gst_rtcp_packet_get_type (&packet),
+        GST_RTCP_TYPE_RTPFB);
+    fail_unless_equals_int (gst_rtcp_packet_fb_get_media_ssrc (&packet), i);
+  }
+  fail_if (gst_rtcp_packet_move_to_next (&packet));
+  gst_rtcp_buffer_unmap (&rtcp);
+
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtcp_reduced_buffer)
 {
   GstBuffer *buf;
@@ -1280,6 +1455,95 @@ GST_START_TEST (test_rtp_buffer_get_extension_bytes)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtp_buffer_extension_iter)
+{
+  GstBuffer *buf;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstRTPBufferExtensionIter iter;
+  guint8 misc_data[5] = { 1, 2, 3, 4, 5 };
+  GstRTPBufferExtension exts[3] = {
+    {1, misc_data, 2},
+    {7, misc_data, 5},
+    {1, misc_data + 1, 1}
+  };
+  guint8 id, appbits;
+  gpointer data;
+  guint size;
+
+  /* without extension header */
+  buf = gst_rtp_buffer_new_allocate (4, 0, 0);
+  gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp);
+  fail_if (gst_rtp_buffer_extension_iter_init (&rtp, &iter, &appbits));
+
+  /* one byte headers added at once, 11 bytes padded to 3 words */
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_headers (&rtp, exts, 3));
+  fail_unless (gst_rtp_buffer_get_extension_data (&rtp, NULL, &data, &size));
+  fail_unless_equals_int (size, 3);
+  fail_unless_equals_int (((guint8 *) data)[11], 0);
+
+  fail_unless (gst_rtp_buffer_extension_iter_init (&rtp, &iter, &appbits));
+  fail_unless_equals_int (appbits, 0);
+  fail_unless (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+  fail_unless_equals_int (id, 1);
+  fail_unless_equals_int (size, 2);
+  fail_unless (memcmp (data, misc_data, 2) == 0);
+  fail_unless (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+  fail_unless_equals_int (id, 7);
+  fail_unless_equals_int (size, 5);
+  fail_unless (memcmp (data, misc_data, 5) == 0);
+  fail_unless (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+  fail_unless_equals_int (id, 1);
+  fail_unless_equals_int (size, 1);
+  fail_unless_equals_int (*(guint8 *) data, 2);
+  fail_if (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+  fail_if (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+
+  /* the lookups by id find the same */
+  fail_unless (gst_rtp_buffer_get_extension_onebyte_header (&rtp, 1, 1, &data,
+          &size));
+  fail_unless_equals_int (size, 1);
+  fail_unless_equals_int (*(guint8 *) data, 2);
+  fail_if (gst_rtp_buffer_get_extension_twobytes_header (&rtp, NULL, 1, 0,
+          &data, &size));
+
+  /* appending one more after the padding */
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_headers (&rtp, exts, 1));
+  fail_unless (gst_rtp_buffer_get_extension_onebyte_header (&rtp, 1, 2, &data,
+          &size));
+  fail_unless_equals_int (size, 2);
+
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+
+  /* two bytes headers */
+  buf = gst_rtp_buffer_new_allocate (4, 0, 0);
+  gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp);
+  fail_unless (gst_rtp_buffer_add_extension_twobytes_headers (&rtp, 5, exts,
+          2));
+
+  fail_unless (gst_rtp_buffer_extension_iter_init (&rtp, &iter, &appbits));
+  fail_unless_equals_int (appbits, 5);
+  fail_unless (gst_rtp_buffer_extension_iter_next (&iter, &id, NULL, &size));
+  fail_unless_equals_int (id, 1);
+  fail_unless_equals_int (size, 2);
+  fail_unless (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+  fail_unless_equals_int (id, 7);
+  fail_unless_equals_int (size, 5);
+  fail_unless (memcmp (data, misc_data, 5) == 0);
+  fail_if (gst_rtp_buffer_extension_iter_next (&iter, &id, &data, &size));
+
+  appbits = 0;
+  fail_unless (gst_rtp_buffer_get_extension_twobytes_header (&rtp, &appbits, 7,
+          0, &data, &size));
+  fail_unless_equals_int (appbits, 5);
+  fail_unless_equals_int (size, 5);
+
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtp_buffer_get_payload_bytes)
 {
   guint8 rtppacket[] = {
@@ -1363,11 +1627,14 @@ rtp_suite (void)
   tcase_add_test (tc_chain, test_rtp_buffer);
   tcase_add_test (tc_chain, test_rtp_buffer_validate_corrupt);
   tcase_add_test (tc_chain, test_rtp_buffer_validate_padding);
+  tcase_add_test (tc_chain, test_rtp_buffer_map_single_memory);
+  tcase_add_test (tc_chain, test_rtp_buffer_new_with_payload);
   tcase_add_test (tc_chain, test_rtp_buffer_set_extension_data);
   //tcase_add_test (tc_chain, test_rtp_buffer_list_set_extension);
   tcase_add_test (tc_chain, test_rtp_seqnum_compare);
 
   tcase_add_test (tc_chain, test_rtcp_buffer);
+  tcase_add_test (tc_chain, test_rtcp_buffer_add_packet_append);
   tcase_add_test (tc_chain, test_rtcp_reduced_buffer);
   tcase_add_test (tc_chain, test_rtcp_validate_with_padding);
   tcase_add_test (tc_chain, test_rtcp_validate_with_padding_wrong_padlength);
@@ -1385,6 +1652,7 @@ rtp_suite (void)
 
   tcase_add_test (tc_chain, test_rtp_buffer_get_payload_bytes);
   tcase_add_test (tc_chain, test_rtp_buffer_get_extension_bytes);
+  tcase_add_test (tc_chain, test_rtp_buffer_extension_iter);
   tcase_add_test (tc_chain, test_rtp_buffer_empty_payload);
 
   //tcase_add_test (tc_chain, test_rtp_buffer_list);
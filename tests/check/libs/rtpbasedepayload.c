@@ -148,6 +148,36 @@ gst_rtp_dummy_depay_process (GstRTPBaseDepayload * depayload, GstBuffer * buf)
   return outbuf;
 }
 
+/* concatenates the payloads of all packets into one buffer, the discont flag
+ * of the packets is carried over */
+static GstBufferList *
+gst_rtp_dummy_depay_process_list (GstRTPBaseDepayload * depayload,
+    GstRTPBuffer * packets, guint n_packets)
+{
+  GstBufferList *list;
+  GstBuffer *outbuf = NULL;
+  guint i;
+
+  GST_LOG ("depayloading list of %u packets", n_packets);
+
+  for (i = 0; i < n_packets; i++) {
+    GstBuffer *payload = gst_rtp_buffer_get_payload_buffer (&packets[i]);
+
+    if (GST_BUFFER_IS_DISCONT (packets[i].buffer))
+      GST_BUFFER_FLAG_SET (payload, GST_BUFFER_FLAG_DISCONT);
+
+    if (outbuf)
+      outbuf = gst_buffer_append (outbuf, payload);
+    else
+      outbuf = payload;
+  }
+
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, outbuf);
+
+  return list;
+}
+
 static gboolean
 gst_rtp_dummy_depay_set_caps (GstRTPBaseDepayload * filter, GstCaps * caps)
 {
@@ -419,6 +449,20 @@ push_buffer_full (State * state, GstFlowReturn expected,
   fail_unless_equals_int (gst_pad_push (state->srcpad, buf), expected);
 }
 
+static GstBuffer *
+create_rtp_buffer (GstClockTime pts, guint seq, guint payload_len)
+{
+  GstBuffer *buf = gst_rtp_buffer_new_allocate (payload_len, 0, 0);
+  GstRTPBuffer rtp = { NULL };
+
+  GST_BUFFER_PTS (buf) = pts;
+  gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp);
+  gst_rtp_buffer_set_seq (&rtp, seq);
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buf;
+}
+
 static void
 validate_buffers_received (guint received)
 {
@@ -1228,6 +1272,64 @@ GST_START_TEST (rtp_base_depayload_clock_base_test)
   destroy_depayloader (state);
 }
 
+GST_END_TEST
+/* when the subclass implements process_list, a list of packets is depayloaded
+ * in one go. the duplicate packet in the first list is dropped before the
+ * subclass sees it, the gap before the second list marks its output as
+ * DISCONT. the output gets the timestamp of the first packet of each list.
+ */
+GST_START_TEST (rtp_base_depayload_process_list_test)
+{
+  GstRTPBaseDepayloadClass *klass;
+  GstBufferList *list;
+  State *state;
+
+  state = create_depayloader ("application/x-rtp", NULL);
+
+  klass = GST_RTP_BASE_DEPAYLOAD_GET_CLASS (state->element);
+  klass->process_list = gst_rtp_dummy_depay_process_list;
+
+  set_state (state, GST_STATE_PLAYING);
+
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, create_rtp_buffer (0 * GST_SECOND, 0x4242, 10));
+  gst_buffer_list_add (list, create_rtp_buffer (1 * GST_SECOND, 0x4243, 10));
+  gst_buffer_list_add (list, create_rtp_buffer (1 * GST_SECOND, 0x4243, 10));
+  gst_buffer_list_add (list, create_rtp_buffer (2 * GST_SECOND, 0x4244, 10));
+  fail_unless_equals_int (gst_pad_push_list (state->srcpad, list),
+      GST_FLOW_OK);
+
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, create_rtp_buffer (4 * GST_SECOND, 0x4246, 10));
+  gst_buffer_list_add (list, create_rtp_buffer (5 * GST_SECOND, 0x4247, 10));
+  fail_unless_equals_int (gst_pad_push_list (state->srcpad, list),
+      GST_FLOW_OK);
+
+  set_state (state, GST_STATE_NULL);
+
+  klass->process_list = NULL;
+
+  validate_buffers_received (2);
+
+  validate_buffer (0, "pts", 0 * GST_SECOND, "discont", FALSE, NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffers->data), 30);
+
+  validate_buffer (1, "pts", 4 * GST_SECOND, "discont", TRUE, NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffers->next->data), 20);
+
+  validate_events_received (3);
+
+  validate_event (0, "stream-start", NULL);
+
+  validate_event (1, "caps", "media-type", "application/x-rtp", NULL);
+
+  validate_event (2, "segment",
+      "time", G_GUINT64_CONSTANT (0),
+      "start", G_GUINT64_CONSTANT (0), "stop", G_MAXUINT64, NULL);
+
+  destroy_depayloader (state);
+}
+
 GST_END_TEST static Suite *
 rtp_basepayloading_suite (void)
 {
@@ -1256,6 +1358,8 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_depayload_play_speed_test);
   tcase_add_test (tc_chain, rtp_base_depayload_clock_base_test);
 
+  tcase_add_test (tc_chain, rtp_base_depayload_process_list_test);
+
   return s;
 }
 
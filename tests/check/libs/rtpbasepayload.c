@@ -753,6 +753,67 @@ GST_START_TEST (rtp_base_payload_buffer_list_test)
 
 GST_END_TEST;
 
+static guint lists_received;
+
+static GstFlowReturn
+chain_list_func (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  guint i;
+
+  lists_received++;
+  for (i = 0; i < gst_buffer_list_length (list); i++)
+    buffers = g_list_append (buffers,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+/* with buffer-list enabled the packets of every input buffer, whether the
+ * subclass pushes them one by one or in a list, arrive in one buffer list
+ * with the same rtptime and seqnum increments as separate packets.
+ */
+GST_START_TEST (rtp_base_payload_property_buffer_list_test)
+{
+  State *state;
+  guint32 rtptime;
+  guint16 seq;
+  guint i;
+
+  state = create_payloader ("application/x-rtp", &sinktmpl,
+      "buffer-list", TRUE, NULL);
+  gst_pad_set_chain_list_function (state->sinkpad, chain_list_func);
+  lists_received = 0;
+
+  set_state (state, GST_STATE_PLAYING);
+
+  for (i = 0; i < BUFFER_BEFORE_LIST + 1; i++) {
+    push_buffer (state, "pts", i * GST_SECOND, NULL);
+  }
+
+  set_state (state, GST_STATE_NULL);
+
+  fail_unless_equals_int (lists_received, BUFFER_BEFORE_LIST + 1);
+  validate_buffers_received (BUFFER_BEFORE_LIST + 1);
+
+  validate_buffer (0, "pts", 0 * GST_SECOND, NULL);
+  get_buffer_field (0, "rtptime", &rtptime, "seq", &seq, NULL);
+
+  for (i = 1; i < BUFFER_BEFORE_LIST + 1; i++) {
+    validate_buffer (i,
+        "pts", i * GST_SECOND,
+        "rtptime", rtptime + i * DEFAULT_CLOCK_RATE, "seq", seq + i, NULL);
+  }
+
+  validate_events_received (3);
+
+  validate_normal_start_events (0);
+
+  destroy_payloader (state);
+}
+
+GST_END_TEST;
+
 /* push two buffers. because the payloader is using non-perfect rtptime the
  * second buffer will be timestamped with the default clock and ignore any
  * offset set on the buffers being payloaded.
@@ -1875,6 +1936,7 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_payload_property_perfect_rtptime_test);
   tcase_add_test (tc_chain, rtp_base_payload_property_ptime_multiple_test);
   tcase_add_test (tc_chain, rtp_base_payload_property_stats_test);
+  tcase_add_test (tc_chain, rtp_base_payload_property_buffer_list_test);
 
   tcase_add_test (tc_chain, rtp_base_payload_framerate_attribute);
   tcase_add_test (tc_chain, rtp_base_payload_max_framerate_attribute);
@@ -648,6 +648,45 @@ GST_START_TEST (test_rtsp_message)
 
   res = gst_rtsp_message_free (msg);
   fail_unless_equals_int (res, GST_RTSP_OK);
+
+  /* === */
+
+  res = gst_rtsp_message_new_request (&msg, GST_RTSP_SETUP,
+      "rtsp://foo.bar:8554/test");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+
+  fail_unless_equals_int (gst_rtsp_find_header_field ("tRaNsPoRt"),
+      GST_RTSP_HDR_TRANSPORT);
+  fail_unless_equals_int (gst_rtsp_find_header_field ("Custom"),
+      GST_RTSP_HDR_INVALID);
+
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SESSION, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_ENOTIMPL);
+
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_SESSION, "a");
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_SESSION, "b");
+
+  /* removing one of the two keeps the other findable */
+  res = gst_rtsp_message_remove_header (msg, GST_RTSP_HDR_SESSION, 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SESSION, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_string (val, "b");
+
+  res = gst_rtsp_message_remove_header_by_name (msg, "session", 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SESSION, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_ENOTIMPL);
+  res = gst_rtsp_message_remove_header (msg, GST_RTSP_HDR_SESSION, -1);
+  fail_unless_equals_int (res, GST_RTSP_ENOTIMPL);
+
+  gst_rtsp_message_add_header_by_name (msg, "Session", "c");
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SESSION, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_string (val, "c");
+
+  res = gst_rtsp_message_free (msg);
+  fail_unless_equals_int (res, GST_RTSP_OK);
 }
 
 GST_END_TEST;
@@ -520,6 +520,161 @@ GST_START_TEST (test_rtspconnection_tunnel_setup_post_first)
 
 GST_END_TEST;
 
+/* sends random base64 of all lengths, with padding, whitespace and characters
+ * that are not in the alphabet, over a tunnel and checks that it is decoded
+ * like g_base64_decode() does. The runs of the alphabet are decoded with SIMD
+ * where it is available, everything else by GLib */
+GST_START_TEST (test_rtspconnection_tunnel_base64)
+{
+  static const gchar junk[] = " \r\n\t*-.\x80\xff";
+  GstRTSPConnection *rtsp_conn1 = NULL;
+  GstRTSPConnection *rtsp_conn2 = NULL;
+  GstRTSPWatch *watch1;
+  GstRTSPWatch *watch2;
+  GstRTSPResult res;
+  GSocketConnection *client_get = NULL;
+  GSocketConnection *server_get = NULL;
+  GSocketConnection *client_post = NULL;
+  GSocketConnection *server_post = NULL;
+  GSocket *server_sock;
+  GOutputStream *ostream_get;
+  GInputStream *istream_get;
+  GOutputStream *ostream_post;
+  GRand *rand;
+  gsize size = 0;
+  guint8 buffer[1024];
+  guint i, j, chunk;
+
+  create_connection (&client_get, &server_get);
+  server_sock = g_socket_connection_get_socket (server_get);
+  fail_unless (server_sock != NULL);
+
+  res = gst_rtsp_connection_create_from_socket (server_sock, "127.0.0.1", 4444,
+      NULL, &rtsp_conn1);
+  fail_unless (res == GST_RTSP_OK);
+  fail_unless (rtsp_conn1 != NULL);
+
+  watch1 = gst_rtsp_watch_new (rtsp_conn1, &watch_funcs, NULL, NULL);
+  fail_unless (watch1 != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch1, NULL) > 0);
+  g_source_unref ((GSource *) watch1);
+
+  ostream_get = g_io_stream_get_output_stream (G_IO_STREAM (client_get));
+  fail_unless (ostream_get != NULL);
+
+  istream_get = g_io_stream_get_input_stream (G_IO_STREAM (client_get));
+  fail_unless (istream_get != NULL);
+
+  fail_unless (g_output_stream_write_all (ostream_get, get_msg,
+          strlen (get_msg), &size, NULL, NULL));
+  fail_unless (size == strlen (get_msg));
+
+  while (!g_main_context_iteration (NULL, TRUE));
+  fail_unless (tunnel_get_count == 1);
+
+  size = g_input_stream_read (istream_get, buffer, sizeof (buffer) - 1, NULL,
+      NULL);
+  fail_unless (size > 0);
+  buffer[size] = 0;
+  fail_unless (g_strrstr ((gchar *) buffer, "HTTP/1.0 200 OK") != NULL);
+
+  create_connection (&client_post, &server_post);
+  server_sock = g_socket_connection_get_socket (server_post);
+  fail_unless (server_sock != NULL);
+
+  res = gst_rtsp_connection_create_from_socket (server_sock, "127.0.0.1", 4444,
+      NULL, &rtsp_conn2);
+  fail_unless (res == GST_RTSP_OK);
+  fail_unless (rtsp_conn2 != NULL);
+
+  watch2 = gst_rtsp_watch_new (rtsp_conn2, &watch_funcs, NULL, NULL);
+  fail_unless (watch2 != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch2, NULL) > 0);
+  g_source_unref ((GSource *) watch2);
+
+  ostream_post = g_io_stream_get_output_stream (G_IO_STREAM (client_post));
+  fail_unless (ostream_post != NULL);
+
+  fail_unless (g_output_stream_write_all (ostream_post, post_msg,
+          strlen (post_msg), &size, NULL, NULL));
+  fail_unless (size == strlen (post_msg));
+
+  while (!g_main_context_iteration (NULL, TRUE));
+  fail_unless (tunnel_post_count == 1);
+
+  fail_unless (gst_rtsp_connection_do_tunnel (rtsp_conn1, rtsp_conn2) ==
+      GST_RTSP_OK);
+  /* we read from the tunnel ourselves */
+  g_source_destroy ((GSource *) watch1);
+  g_source_destroy ((GSource *) watch2);
+  gst_rtsp_connection_free (rtsp_conn2);
+  rtsp_conn2 = NULL;
+
+  rand = g_rand_new_with_seed (0x62617365);
+
+  /* every length twice, once as it comes out of the encoder and once with
+   * junk in random places, the SIMD versions need 16 or 64 characters */
+  for (i = 0; i < 2 * 300; i++) {
+    guint len = i / 2;
+    guint8 data[300];
+    guint8 *expected;
+    gsize expected_len;
+    gchar *encoded;
+    GString *piece;
+    GTimeVal timeout = { 5, 0 };
+
+    for (j = 0; j < len; j++)
+      data[j] = g_rand_int_range (rand, 0, 256);
+
+    encoded = g_base64_encode (data, len);
+    piece = g_string_new (encoded);
+    g_free (encoded);
+
+    if (i & 1) {
+      guint n_junk = g_rand_int_range (rand, 1, 8);
+
+      for (j = 0; j < n_junk; j++)
+        g_string_insert_c (piece, g_rand_int_range (rand, 0,
+                piece->len + 1), junk[g_rand_int_range (rand, 0,
+                    sizeof (junk) - 1)]);
+    }
+
+    expected = g_base64_decode (piece->str, &expected_len);
+    fail_unless_equals_int (expected_len, len);
+    fail_unless (memcmp (expected, data, len) == 0);
+
+    /* in pieces, so that the decoder also has to continue in the middle of
+     * groups of 4 characters */
+    for (j = 0; j < piece->len; j += chunk) {
+      chunk = MIN (g_rand_int_range (rand, 1, 100), piece->len - j);
+      fail_unless (g_output_stream_write_all (ostream_post, piece->str + j,
+              chunk, &size, NULL, NULL));
+    }
+
+    if (len > 0) {
+      fail_unless_equals_int (gst_rtsp_connection_read (rtsp_conn1, buffer,
+              len, &timeout), GST_RTSP_OK);
+      fail_unless (memcmp (buffer, expected, len) == 0,
+          "wrong decoding of %s", piece->str);
+    }
+
+    g_free (expected);
+    g_string_free (piece, TRUE);
+  }
+
+  g_rand_free (rand);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_conn1) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_conn1) == GST_RTSP_OK);
+
+  g_object_unref (client_post);
+  g_object_unref (server_post);
+  g_object_unref (client_get);
+  g_object_unref (server_get);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtspconnection_send_receive)
 {
   GSocketConnection *input_conn = NULL;
@@ -603,6 +758,94 @@ GST_START_TEST (test_rtspconnection_send_receive)
 
 GST_END_TEST;
 
+/* several messages arriving in one read are all received, the ones that
+ * were read ahead are reported as readable by poll */
+GST_START_TEST (test_rtspconnection_receive_read_ahead)
+{
+  GSocketConnection *conn1 = NULL;
+  GSocketConnection *conn2 = NULL;
+  GSocket *sock;
+  GstRTSPConnection *rtsp_conn;
+  GOutputStream *ostream;
+  GstRTSPMessage *msg;
+  GstRTSPEvent event;
+  guint8 *recv_body;
+  guint recv_body_len;
+  guint8 channel;
+  gchar *header_val;
+  gsize size;
+  GTimeVal tv;
+  const gchar data[] =
+      "$\001\000\004abcd"
+      "$\002\000\002ef"
+      "RTSP/1.0 200 OK\r\n" "CSeq: 3\r\n" "\r\n";
+
+  create_connection (&conn1, &conn2);
+  sock = g_socket_connection_get_socket (conn1);
+  fail_unless (sock != NULL);
+
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (conn2));
+  fail_unless (ostream != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          4444, NULL, &rtsp_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_conn != NULL);
+
+  fail_unless (g_output_stream_write_all (ostream, data, sizeof (data) - 1,
+          &size, NULL, NULL));
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+  fail_unless (gst_rtsp_message_parse_data (msg, &channel) == GST_RTSP_OK);
+  fail_unless_equals_int (channel, 1);
+  fail_unless (gst_rtsp_message_get_body (msg, &recv_body,
+          &recv_body_len) == GST_RTSP_OK);
+  fail_unless_equals_int (recv_body_len, 4 + 1);
+  fail_unless (memcmp (recv_body, "abcd", 4) == 0);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  /* the rest was read already */
+  fail_unless (gst_rtsp_connection_poll (rtsp_conn, GST_RTSP_EV_READ, &event,
+          NULL) == GST_RTSP_OK);
+  fail_unless (event & GST_RTSP_EV_READ);
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+  fail_unless (gst_rtsp_message_parse_data (msg, &channel) == GST_RTSP_OK);
+  fail_unless_equals_int (channel, 2);
+  fail_unless (gst_rtsp_message_get_body (msg, &recv_body,
+          &recv_body_len) == GST_RTSP_OK);
+  fail_unless_equals_int (recv_body_len, 2 + 1);
+  fail_unless (memcmp (recv_body, "ef", 2) == 0);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_RESPONSE);
+  fail_unless (gst_rtsp_message_get_header (msg, GST_RTSP_HDR_CSEQ,
+          &header_val, 0) == GST_RTSP_OK);
+  fail_unless_equals_string (header_val, "3");
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  /* everything was read now */
+  tv.tv_sec = 0;
+  tv.tv_usec = 100 * 1000;
+  fail_unless (gst_rtsp_connection_poll (rtsp_conn, GST_RTSP_EV_READ, &event,
+          &tv) == GST_RTSP_ETIMEOUT);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_conn) == GST_RTSP_OK);
+  g_object_unref (conn1);
+  g_object_unref (conn2);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtspconnection_send_receive_check_headers)
 {
   GSocketConnection *input_conn = NULL;
@@ -763,6 +1006,89 @@ GST_START_TEST (test_rtspconnection_poll)
 
 GST_END_TEST;
 
+static gpointer
+flush_thread_func (gpointer user_data)
+{
+  GstRTSPConnection *rtsp_conn = user_data;
+
+  g_usleep (100000);
+  gst_rtsp_connection_flush (rtsp_conn, TRUE);
+
+  return NULL;
+}
+
+/* the timeout and readiness of the single socket fast path and of the main
+ * context that is used when waiting for both reading and writing */
+GST_START_TEST (test_rtspconnection_poll_timeout)
+{
+  GSocketConnection *conn1 = NULL;
+  GSocketConnection *conn2 = NULL;
+  GSocket *sock;
+  GstRTSPConnection *rtsp_conn;
+  GstRTSPEvent event;
+  GOutputStream *ostream;
+  GThread *thread;
+  gint64 start, elapsed;
+  gsize size;
+  GTimeVal tv;
+
+  create_connection (&conn1, &conn2);
+  sock = g_socket_connection_get_socket (conn1);
+  fail_unless (sock != NULL);
+
+  ostream = g_io_stream_get_output_stream (G_IO_STREAM (conn2));
+  fail_unless (ostream != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          4444, NULL, &rtsp_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_conn != NULL);
+
+  /* the timeout is waited for, but not much longer */
+  tv.tv_sec = 0;
+  tv.tv_usec = 200000;
+  start = g_get_monotonic_time ();
+  fail_unless (gst_rtsp_connection_poll (rtsp_conn, GST_RTSP_EV_READ, &event,
+          &tv) == GST_RTSP_ETIMEOUT);
+  elapsed = g_get_monotonic_time () - start;
+  fail_unless_equals_int (event, 0);
+  fail_unless (elapsed >= 190000, "returned after %" G_GINT64_FORMAT "us",
+      elapsed);
+  fail_unless (elapsed < 5 * G_USEC_PER_SEC);
+
+  /* with both events, writing is possible right away */
+  event = 0;
+  fail_unless (gst_rtsp_connection_poll (rtsp_conn,
+          GST_RTSP_EV_READ | GST_RTSP_EV_WRITE, &event, &tv) == GST_RTSP_OK);
+  fail_unless_equals_int (event, GST_RTSP_EV_WRITE);
+
+  /* flushing stops the wait without a timeout */
+  thread = g_thread_new ("flush", flush_thread_func, rtsp_conn);
+  fail_if (gst_rtsp_connection_poll (rtsp_conn, GST_RTSP_EV_READ, &event,
+          NULL) == GST_RTSP_OK);
+  fail_unless_equals_int (event, 0);
+  g_thread_join (thread);
+  fail_unless (gst_rtsp_connection_flush (rtsp_conn, FALSE) == GST_RTSP_OK);
+
+  /* and once there is something to read, both are reported */
+  fail_unless (g_output_stream_write_all (ostream, "data", 5, &size, NULL,
+          NULL));
+  tv.tv_sec = 5;
+  tv.tv_usec = 0;
+  fail_unless (gst_rtsp_connection_poll (rtsp_conn, GST_RTSP_EV_READ, &event,
+          &tv) == GST_RTSP_OK);
+  fail_unless_equals_int (event, GST_RTSP_EV_READ);
+  fail_unless (gst_rtsp_connection_poll (rtsp_conn,
+          GST_RTSP_EV_READ | GST_RTSP_EV_WRITE, &event, &tv) == GST_RTSP_OK);
+  fail_unless_equals_int (event, GST_RTSP_EV_READ | GST_RTSP_EV_WRITE);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_conn) == GST_RTSP_OK);
+  g_object_unref (conn1);
+  g_object_unref (conn2);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtspconnection_backlog)
 {
   GSocketConnection *conn1 = NULL;
@@ -777,6 +1103,8 @@ GST_START_TEST (test_rtspconnection_backlog)
   GstRTSPResult res = GST_RTSP_OK;
   guint num_queued;
   guint num_sent;
+  gsize level_bytes;
+  guint level_messages;
 
   create_connection (&conn1, &conn2);
   sock = g_socket_connection_get_socket (conn1);
@@ -812,6 +1140,10 @@ GST_START_TEST (test_rtspconnection_backlog)
   fail_unless (res == GST_RTSP_ENOMEM);
   fail_unless (num_queued > 0);
 
+  gst_rtsp_watch_get_send_backlog_level (watch, &level_bytes, &level_messages);
+  fail_unless (level_bytes >= 1024);
+  fail_unless (level_messages >= 1);
+
   istream = g_io_stream_get_input_stream (G_IO_STREAM (conn2));
   fail_unless (istream != NULL);
 
@@ -842,6 +1174,91 @@ GST_START_TEST (test_rtspconnection_backlog)
 
 GST_END_TEST;
 
+/* many small queued messages are sent together, in order, and all of them
+ * are reported as sent */
+GST_START_TEST (test_rtspconnection_backlog_small_messages)
+{
+  GSocketConnection *conn1 = NULL;
+  GSocketConnection *conn2 = NULL;
+  GSocket *sock;
+  GstRTSPConnection *rtsp_conn = NULL;
+  GstRTSPWatch *watch;
+  GInputStream *istream;
+  GstRTSPResult res = GST_RTSP_OK;
+  guint8 *buffer;
+  guint8 recv[1000];
+  gssize received;
+  gsize total, i;
+  gsize level_bytes;
+  guint level_messages;
+  guint num_queued, num_sent;
+
+  create_connection (&conn1, &conn2);
+  sock = g_socket_connection_get_socket (conn1);
+  fail_unless (sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          4444, NULL, &rtsp_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_conn != NULL);
+
+  watch = gst_rtsp_watch_new (rtsp_conn, &watch_funcs, NULL, NULL);
+  fail_unless (watch != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch, NULL) > 0);
+  g_source_unref ((GSource *) watch);
+
+  gst_rtsp_watch_set_send_backlog (watch, 64 * 1024, 0);
+
+  /* fill the tcp window and then the backlog with messages of 100 bytes, all
+   * bytes of a message have its number */
+  num_queued = 0;
+  num_sent = 0;
+  while (res == GST_RTSP_OK) {
+    guint id = 0;
+    buffer = g_malloc (100);
+    memset (buffer, num_sent & 0xff, 100);
+    res = gst_rtsp_watch_write_data (watch, buffer, 100, &id);
+    if (id > 0)
+      num_queued++;
+    if (res == GST_RTSP_OK)
+      num_sent++;
+  }
+  fail_unless (res == GST_RTSP_ENOMEM);
+  fail_unless (num_queued > 1);
+
+  gst_rtsp_watch_get_send_backlog_level (watch, &level_bytes, &level_messages);
+  fail_unless (level_bytes >= 64 * 1024);
+  fail_unless (level_messages > 1);
+
+  istream = g_io_stream_get_input_stream (G_IO_STREAM (conn2));
+  fail_unless (istream != NULL);
+
+  message_sent_count = 0;
+  total = 0;
+  while (total < num_sent * 100) {
+    while (g_main_context_iteration (NULL, FALSE));
+
+    received = g_input_stream_read (istream, recv, sizeof (recv), NULL, NULL);
+    fail_unless (received > 0);
+    for (i = 0; i < received; i++)
+      fail_unless_equals_int (recv[i], ((total + i) / 100) & 0xff);
+    total += received;
+  }
+  while (g_main_context_iteration (NULL, FALSE));
+
+  fail_unless_equals_int (message_sent_count, num_queued);
+  gst_rtsp_watch_get_send_backlog_level (watch, &level_bytes, &level_messages);
+  fail_unless_equals_int (level_bytes, 0);
+  fail_unless_equals_int (level_messages, 0);
+
+  g_source_destroy ((GSource *) watch);
+  fail_unless (gst_rtsp_connection_close (rtsp_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_conn) == GST_RTSP_OK);
+  g_object_unref (conn1);
+  g_object_unref (conn2);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtspconnection_ip)
 {
   GstRTSPConnection *conn = NULL;
@@ -871,11 +1288,15 @@ rtspconnection_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_rtspconnection_tunnel_setup);
   tcase_add_test (tc_chain, test_rtspconnection_tunnel_setup_post_first);
+  tcase_add_test (tc_chain, test_rtspconnection_tunnel_base64);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive_check_headers);
+  tcase_add_test (tc_chain, test_rtspconnection_receive_read_ahead);
   tcase_add_test (tc_chain, test_rtspconnection_connect);
   tcase_add_test (tc_chain, test_rtspconnection_poll);
+  tcase_add_test (tc_chain, test_rtspconnection_poll_timeout);
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
+  tcase_add_test (tc_chain, test_rtspconnection_backlog_small_messages);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
 
   return s;
@@ -248,6 +248,36 @@ GST_START_TEST (caps_from_media)
   gst_sdp_message_free (message);
 }
 
+GST_END_TEST
+GST_START_TEST (caps_from_media_repeated)
+{
+  GstSDPMessage *message;
+  const GstSDPMedia *media;
+  GstCaps *caps, *result;
+  guint i;
+
+  gst_sdp_message_new (&message);
+  gst_sdp_message_parse_buffer ((guint8 *) sdp, -1, message);
+
+  media = gst_sdp_message_get_media (message, 0);
+  fail_unless (media != NULL);
+
+  result = gst_caps_from_string (caps_video_string1);
+
+  /* the conversion must leave the attributes of the media alone */
+  for (i = 0; i < 3; i++) {
+    caps = gst_sdp_media_get_caps_from_media (media, 96);
+    fail_unless (caps != NULL);
+    fail_unless (gst_caps_is_strictly_equal (caps, result));
+    gst_caps_unref (caps);
+  }
+  fail_unless_equals_string (gst_sdp_media_get_attribute_val (media,
+          "rtpmap"), "96 MP4V-ES/90000");
+
+  gst_caps_unref (result);
+  gst_sdp_message_free (message);
+}
+
 GST_END_TEST
 GST_START_TEST (media_from_caps)
 {
@@ -296,6 +326,55 @@ GST_START_TEST (media_from_caps)
   gst_sdp_message_free (message);
 }
 
+GST_END_TEST
+GST_START_TEST (large_round_trip)
+{
+  GstSDPMessage *message;
+  GString *text;
+  gchar *message_str;
+  gint64 start, parse_time = 0, text_time = 0;
+  guint i;
+
+  text = g_string_new ("v=0\r\n"
+      "o=- 123456 0 IN IP4 127.0.0.1\r\n"
+      "s=TestLargeSession\r\n"
+      "c=IN IP4 127.0.0.1\r\n" "t=0 0\r\n" "a=tool:check\r\n");
+  for (i = 0; i < 500; i++) {
+    g_string_append_printf (text, "m=audio %u RTP/AVP %u\r\n"
+        "a=rtpmap:%u opus/48000/2\r\n"
+        "a=fmtp:%u minptime=10;useinbandfec=1\r\n"
+        "a=mid:%u\r\n" "a=sendrecv\r\n", 5000 + 2 * i, 96 + (i % 32),
+        96 + (i % 32), 96 + (i % 32), i);
+  }
+
+  for (i = 0; i < 10; i++) {
+    gst_sdp_message_new (&message);
+
+    start = g_get_monotonic_time ();
+    fail_unless_equals_int (gst_sdp_message_parse_buffer ((guint8 *)
+            text->str, text->len, message), GST_SDP_OK);
+    parse_time += g_get_monotonic_time () - start;
+
+    fail_unless_equals_int (gst_sdp_message_medias_len (message), 500);
+    fail_unless_equals_string (gst_sdp_media_get_attribute_val
+        (gst_sdp_message_get_media (message, 499), "mid"), "499");
+
+    start = g_get_monotonic_time ();
+    message_str = gst_sdp_message_as_text (message);
+    text_time += g_get_monotonic_time () - start;
+
+    fail_unless_equals_string (message_str, text->str);
+    g_free (message_str);
+    gst_sdp_message_free (message);
+  }
+
+  GST_INFO ("%" G_GSIZE_FORMAT " bytes: parse %" G_GINT64_FORMAT
+      " us, as_text %" G_GINT64_FORMAT " us", text->len, parse_time / 10,
+      text_time / 10);
+
+  g_string_free (text, TRUE);
+}
+
 GST_END_TEST
 /*
  * End of test cases
@@ -311,7 +390,9 @@ sdp_suite (void)
   tcase_add_test (tc_chain, boxed);
   tcase_add_test (tc_chain, modify);
   tcase_add_test (tc_chain, caps_from_media);
+  tcase_add_test (tc_chain, caps_from_media_repeated);
   tcase_add_test (tc_chain, media_from_caps);
+  tcase_add_test (tc_chain, large_round_trip);
 
   return s;
 }
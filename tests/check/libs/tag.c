@@ -745,6 +745,65 @@ GST_START_TEST (test_id3v2_priv_tag)
 }
 
 GST_END_TEST
+GST_START_TEST (test_filtered_tags)
+{
+  const gchar *wanted[] = { GST_TAG_TITLE, NULL };
+  const guint8 vorbis_comments[] = {
+    0x03, 0x00, 0x00, 0x00, 'f', 'o', 'o', 0x03, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 'A', 'R', 'T', 'I', 'S', 'T', '=', 'a',
+    0x07, 0x00, 0x00, 0x00, 'T', 'I', 'T', 'L', 'E', '=', 'b',
+    0x1b, 0x00, 0x00, 0x00, 'M', 'E', 'T', 'A', 'D', 'A', 'T', 'A', '_',
+    'B', 'L', 'O', 'C', 'K', '_', 'P', 'I', 'C', 'T', 'U', 'R', 'E', '=',
+    'x', 'x', 'x', 'x'
+  };
+  /* the PRIV frame from test_id3v2_priv_tag */
+  const guint8 id3v2[] = {
+    0x49, 0x44, 0x33, 0x04, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x3f, 0x50, 0x52, 0x49, 0x56, 0x00, 0x00,
+    0x00, 0x35, 0x00, 0x00, 0x63, 0x6f, 0x6d, 0x2e,
+    0x61, 0x70, 0x70, 0x6c, 0x65, 0x2e, 0x73, 0x74,
+    0x72, 0x65, 0x61, 0x6d, 0x69, 0x6e, 0x67, 0x2e,
+    0x74, 0x72, 0x61, 0x6e, 0x73, 0x70, 0x6f, 0x72,
+    0x74, 0x53, 0x74, 0x72, 0x65, 0x61, 0x6d, 0x54,
+    0x69, 0x6d, 0x65, 0x73, 0x74, 0x61, 0x6d, 0x70,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0xbb,
+    0xa0
+  };
+  GstTagList *tags;
+  GstBuffer *buf;
+  gchar *title = NULL;
+
+  tags = gst_tag_list_from_vorbiscomment_filtered (vorbis_comments,
+      sizeof (vorbis_comments), NULL, 0, NULL, wanted);
+  fail_unless (tags != NULL);
+  fail_unless_equals_int (gst_tag_list_n_tags (tags), 1);
+  fail_unless (gst_tag_list_get_string (tags, GST_TAG_TITLE, &title));
+  fail_unless_equals_string (title, "b");
+  g_free (title);
+  gst_tag_list_unref (tags);
+
+  /* without a filter we get the artist too */
+  tags = gst_tag_list_from_vorbiscomment_filtered (vorbis_comments,
+      sizeof (vorbis_comments), NULL, 0, NULL, NULL);
+  fail_unless (tags != NULL);
+  fail_unless_equals_int (gst_tag_list_n_tags (tags), 2);
+  gst_tag_list_unref (tags);
+
+  buf = gst_buffer_new_allocate (NULL, sizeof (id3v2), NULL);
+  gst_buffer_fill (buf, 0, id3v2, sizeof (id3v2));
+
+  fail_unless (gst_tag_list_from_id3v2_tag_filtered (buf, wanted) == NULL);
+
+  tags = gst_tag_list_from_id3v2_tag_filtered (buf, NULL);
+  fail_unless (tags != NULL);
+  fail_unless (gst_tag_list_get_tag_size (tags, GST_TAG_PRIVATE_DATA) == 1);
+  gst_tag_list_unref (tags);
+
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST
+
 GST_START_TEST (test_language_utils)
 {
   gchar **lang_codes, **c;
@@ -1859,6 +1918,7 @@ tag_suite (void)
   tcase_add_test (tc_chain, test_id3_tags);
   tcase_add_test (tc_chain, test_id3v1_utf8_tag);
   tcase_add_test (tc_chain, test_id3v2_priv_tag);
+  tcase_add_test (tc_chain, test_filtered_tags);
   tcase_add_test (tc_chain, test_language_utils);
   tcase_add_test (tc_chain, test_license_utils);
   tcase_add_test (tc_chain, test_xmp_formatting);
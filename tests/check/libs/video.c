@@ -37,6 +37,7 @@
 #include <gst/video/gstvideometa.h>
 #include <gst/video/video-overlay-composition.h>
 #include <string.h>
+#include <math.h>
 
 /* These are from the current/old videotestsrc; we check our new public API
  * in libgstvideo against the old one to make sure the sizes and offsets
@@ -477,10 +478,157 @@ GST_START_TEST (test_video_formats_pack_unpack)
   }
 }
 
+GST_END_TEST;
+
+GST_START_TEST (test_video_formats_pack_unpack_rect)
+{
+  guint n, num_formats;
+
+  num_formats = get_num_formats ();
+
+  for (n = GST_VIDEO_FORMAT_ENCODED + 1; n < num_formats; ++n) {
+    const GstVideoFormatInfo *vfinfo, *unpackinfo;
+    GstVideoFormat fmt = n;
+    GstVideoInfo vinfo;
+    gpointer data[GST_VIDEO_MAX_PLANES], data2[GST_VIDEO_MAX_PLANES];
+    gint stride[GST_VIDEO_MAX_PLANES];
+    guint8 *vdata, *vdata2, *unpack_data, *unpack_data2;
+    gsize vsize, unpack_size;
+    gint ustride, i;
+    guint p;
+
+    GST_INFO ("testing %s", gst_video_format_to_string (fmt));
+
+    vfinfo = gst_video_format_get_info (fmt);
+    unpackinfo = gst_video_format_get_info (vfinfo->unpack_format);
+
+    gst_video_info_init (&vinfo);
+    gst_video_info_set_format (&vinfo, fmt, WIDTH, HEIGHT);
+    vsize = GST_VIDEO_INFO_SIZE (&vinfo);
+    vdata = g_malloc (vsize);
+    vdata2 = g_malloc (vsize);
+    for (i = 0; i < (gint) vsize; i++)
+      vdata[i] = g_random_int ();
+
+    ustride = GST_VIDEO_FORMAT_INFO_BITS (unpackinfo) *
+        GST_VIDEO_FORMAT_INFO_N_COMPONENTS (unpackinfo) *
+        GST_ROUND_UP_16 (WIDTH) / 8;
+    unpack_size = ustride * HEIGHT;
+    unpack_data = g_malloc0 (unpack_size);
+    unpack_data2 = g_malloc0 (unpack_size);
+
+    for (p = 0; p < GST_VIDEO_INFO_N_PLANES (&vinfo); ++p) {
+      data[p] = vdata + GST_VIDEO_INFO_PLANE_OFFSET (&vinfo, p);
+      data2[p] = vdata2 + GST_VIDEO_INFO_PLANE_OFFSET (&vinfo, p);
+      stride[p] = GST_VIDEO_INFO_PLANE_STRIDE (&vinfo, p);
+    }
+
+    /* the rect functions must give the same result as the line functions */
+    for (i = 0; i < HEIGHT; i++)
+      vfinfo->unpack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE,
+          unpack_data + i * ustride, data, stride, 0, i, WIDTH);
+    gst_video_format_info_unpack_rect (vfinfo, GST_VIDEO_PACK_FLAG_NONE,
+        unpack_data2, ustride, data, stride, 0, 0, WIDTH, HEIGHT);
+    fail_unless (memcmp (unpack_data, unpack_data2, unpack_size) == 0);
+
+    memset (vdata, 0, vsize);
+    memset (vdata2, 0, vsize);
+    for (i = 0; i < HEIGHT; i += vfinfo->pack_lines)
+      vfinfo->pack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE,
+          unpack_data + i * ustride, ustride, data, stride,
+          GST_VIDEO_CHROMA_SITE_UNKNOWN, i, WIDTH);
+    gst_video_format_info_pack_rect (vfinfo, GST_VIDEO_PACK_FLAG_NONE,
+        unpack_data, ustride, data2, stride, GST_VIDEO_CHROMA_SITE_UNKNOWN, 0,
+        WIDTH, HEIGHT);
+    fail_unless (memcmp (vdata, vdata2, vsize) == 0);
+
+    g_free (unpack_data);
+    g_free (unpack_data2);
+    g_free (vdata);
+    g_free (vdata2);
+  }
+}
+
 GST_END_TEST;
 #undef WIDTH
 #undef HEIGHT
 
+/* widths around the block sizes of the SIMD pack and unpack functions */
+static const gint simd_widths[] = { 1, 2, 5, 6, 7, 8, 9, 12, 15, 16, 17, 18,
+  23, 24, 25, 31, 32, 33, 77, 1922
+};
+
+GST_START_TEST (test_video_formats_pack_unpack_simd)
+{
+  static const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_v210,
+    GST_VIDEO_FORMAT_RGB, GST_VIDEO_FORMAT_BGR, GST_VIDEO_FORMAT_I420_10LE,
+    GST_VIDEO_FORMAT_P010_10LE
+  };
+  guint f, w;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstVideoFormatInfo *vfinfo = gst_video_format_get_info (formats[f]);
+    const GstVideoFormatInfo *unpackinfo =
+        gst_video_format_get_info (vfinfo->unpack_format);
+
+    for (w = 0; w < G_N_ELEMENTS (simd_widths); w++) {
+      gint width = simd_widths[w], i, line;
+      GstVideoInfo vinfo;
+      gpointer data[GST_VIDEO_MAX_PLANES];
+      gint stride[GST_VIDEO_MAX_PLANES];
+      guint8 *vdata, *unpack_data, *unpack_data2;
+      gsize vsize, unpack_size;
+      guint p;
+
+      GST_INFO ("testing %s width %d", gst_video_format_to_string (formats[f]),
+          width);
+
+      gst_video_info_init (&vinfo);
+      gst_video_info_set_format (&vinfo, formats[f], width, 2);
+      vsize = GST_VIDEO_INFO_SIZE (&vinfo);
+      vdata = g_malloc (vsize);
+      for (i = 0; i < (gint) vsize; i++)
+        vdata[i] = g_random_int ();
+
+      for (p = 0; p < GST_VIDEO_INFO_N_PLANES (&vinfo); ++p) {
+        data[p] = vdata + GST_VIDEO_INFO_PLANE_OFFSET (&vinfo, p);
+        stride[p] = GST_VIDEO_INFO_PLANE_STRIDE (&vinfo, p);
+      }
+
+      unpack_size = GST_VIDEO_FORMAT_INFO_BITS (unpackinfo) *
+          GST_VIDEO_FORMAT_INFO_N_COMPONENTS (unpackinfo) * width / 8;
+      unpack_data = g_malloc0 (unpack_size);
+      unpack_data2 = g_malloc0 (unpack_size);
+
+      /* the first pack drops the bits the format can't store, after that
+       * pack and unpack must give back the same pixels, also in the part
+       * that is not done by the SIMD functions */
+      for (line = 0; line < 2; line++) {
+        vfinfo->unpack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE, unpack_data,
+            data, stride, 0, line, width);
+        vfinfo->pack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE, unpack_data,
+            unpack_size, data, stride, GST_VIDEO_CHROMA_SITE_UNKNOWN, line,
+            width);
+        vfinfo->unpack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE, unpack_data,
+            data, stride, 0, line, width);
+        vfinfo->pack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE, unpack_data,
+            unpack_size, data, stride, GST_VIDEO_CHROMA_SITE_UNKNOWN, line,
+            width);
+        vfinfo->unpack_func (vfinfo, GST_VIDEO_PACK_FLAG_NONE, unpack_data2,
+            data, stride, 0, line, width);
+        fail_unless (memcmp (unpack_data, unpack_data2, unpack_size) == 0);
+      }
+
+      g_free (unpack_data);
+      g_free (unpack_data2);
+      g_free (vdata);
+    }
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_formats)
 {
   guint i;
@@ -847,6 +995,87 @@ GST_START_TEST (test_parse_caps_multiview)
 
 GST_END_TEST;
 
+static void
+check_multiview_view (GstVideoMultiviewMode mode, GstVideoMultiviewFlags flags)
+{
+  GstVideoInfo info, vinfo;
+  GstVideoFrame frame, vframe;
+  GstBuffer *buffer, *vbuffer;
+  gint i, x, y, v;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 16, 8);
+  GST_VIDEO_INFO_MULTIVIEW_MODE (&info) = mode;
+  GST_VIDEO_INFO_MULTIVIEW_FLAGS (&info) = flags;
+  vinfo = info;
+  gst_video_multiview_video_info_change_mode (&vinfo,
+      GST_VIDEO_MULTIVIEW_MODE_SEPARATED, GST_VIDEO_MULTIVIEW_FLAGS_NONE);
+
+  buffer = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  fail_unless (gst_video_frame_map (&frame, &info, buffer, GST_MAP_WRITE));
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (&frame); i++) {
+    guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (&frame, i);
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&frame, i); y++)
+      for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (&frame, i); x++)
+        data[y * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, i) + x] =
+            i * 100 + y * 16 + x;
+  }
+  gst_video_frame_unmap (&frame);
+
+  for (v = 0; v < 2; v++) {
+    gint pos = (flags & GST_VIDEO_MULTIVIEW_FLAGS_RIGHT_VIEW_FIRST) ? !v : v;
+
+    vbuffer = gst_video_multiview_buffer_get_view (&info, buffer, v);
+    fail_unless (vbuffer != NULL);
+    fail_unless (gst_buffer_peek_memory (vbuffer, 0) ==
+        gst_buffer_peek_memory (buffer, 0));
+    fail_unless (gst_video_frame_map (&vframe, &vinfo, vbuffer, GST_MAP_READ));
+
+    for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (&vframe); i++) {
+      guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (&vframe, i);
+      gint w = GST_VIDEO_FRAME_COMP_WIDTH (&vframe, i);
+      gint h = GST_VIDEO_FRAME_COMP_HEIGHT (&vframe, i);
+
+      for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+          gint px = x, py = y;
+
+          if (mode == GST_VIDEO_MULTIVIEW_MODE_SIDE_BY_SIDE)
+            px += pos * w;
+          else
+            py += pos * h;
+
+          fail_unless_equals_int (data[y * GST_VIDEO_FRAME_PLANE_STRIDE
+                  (&vframe, i) + x], i * 100 + py * 16 + px);
+        }
+      }
+    }
+    gst_video_frame_unmap (&vframe);
+    gst_buffer_unref (vbuffer);
+  }
+
+  /* I420 chroma lines are shared by the views */
+  GST_VIDEO_INFO_MULTIVIEW_MODE (&info) =
+      GST_VIDEO_MULTIVIEW_MODE_ROW_INTERLEAVED;
+  fail_unless (gst_video_multiview_buffer_get_view (&info, buffer, 0) == NULL);
+
+  gst_buffer_unref (buffer);
+}
+
+GST_START_TEST (test_multiview_buffer_get_view)
+{
+  check_multiview_view (GST_VIDEO_MULTIVIEW_MODE_SIDE_BY_SIDE,
+      GST_VIDEO_MULTIVIEW_FLAGS_NONE);
+  check_multiview_view (GST_VIDEO_MULTIVIEW_MODE_SIDE_BY_SIDE,
+      GST_VIDEO_MULTIVIEW_FLAGS_RIGHT_VIEW_FIRST);
+  check_multiview_view (GST_VIDEO_MULTIVIEW_MODE_TOP_BOTTOM,
+      GST_VIDEO_MULTIVIEW_FLAGS_NONE);
+  check_multiview_view (GST_VIDEO_MULTIVIEW_MODE_TOP_BOTTOM,
+      GST_VIDEO_MULTIVIEW_FLAGS_RIGHT_VIEW_FIRST);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_events)
 {
   GstEvent *e;
@@ -941,6 +1170,83 @@ GST_START_TEST (test_convert_frame)
 
 GST_END_TEST;
 
+GST_START_TEST (test_convert_frame_direct)
+{
+  GstVideoInfo vinfo;
+  GstCaps *from_caps, *to_caps;
+  GstBuffer *from_buffer;
+  GstSample *from_sample, *to_sample, *to_sample2;
+  GstMapInfo map, map2;
+  GError *error = NULL;
+  gint i, par_n, par_d;
+  GstStructure *s;
+
+  from_buffer = gst_buffer_new_and_alloc (640 * 480 * 4);
+
+  gst_buffer_map (from_buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < 640 * 480; i++) {
+    map.data[4 * i + 0] = 0;    /* x */
+    map.data[4 * i + 1] = 255;  /* R */
+    map.data[4 * i + 2] = 0;    /* G */
+    map.data[4 * i + 3] = 0;    /* B */
+  }
+  gst_buffer_unmap (from_buffer, &map);
+
+  gst_video_info_init (&vinfo);
+  gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_xRGB, 640, 480);
+  vinfo.fps_n = 25;
+  vinfo.fps_d = 1;
+  from_caps = gst_video_info_to_caps (&vinfo);
+  from_sample = gst_sample_new (from_buffer, from_caps, NULL, NULL);
+
+  /* same DAR, no borders needed */
+  to_caps = gst_caps_from_string ("video/x-raw, format=(string)I420, "
+      "width=(int)320, height=(int)240");
+
+  to_sample =
+      gst_video_convert_sample (from_sample, to_caps,
+      GST_CLOCK_TIME_NONE, &error);
+  fail_unless (to_sample != NULL);
+  fail_unless (error == NULL);
+
+  s = gst_caps_get_structure (gst_sample_get_caps (to_sample), 0);
+  fail_unless (gst_structure_get_fraction (s, "pixel-aspect-ratio", &par_n,
+          &par_d));
+  fail_unless_equals_int (par_n, 1);
+  fail_unless_equals_int (par_d, 1);
+  fail_unless (gst_video_info_from_caps (&vinfo, gst_sample_get_caps
+          (to_sample)));
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&vinfo), 320);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&vinfo), 240);
+  fail_unless (gst_buffer_get_size (gst_sample_get_buffer (to_sample)) ==
+      GST_VIDEO_INFO_SIZE (&vinfo));
+
+  /* converting again gives the same result */
+  to_sample2 =
+      gst_video_convert_sample (from_sample, to_caps,
+      GST_CLOCK_TIME_NONE, &error);
+  fail_unless (to_sample2 != NULL);
+  fail_unless (error == NULL);
+  fail_unless (gst_caps_is_equal (gst_sample_get_caps (to_sample),
+          gst_sample_get_caps (to_sample2)));
+
+  gst_buffer_map (gst_sample_get_buffer (to_sample), &map, GST_MAP_READ);
+  gst_buffer_map (gst_sample_get_buffer (to_sample2), &map2, GST_MAP_READ);
+  fail_unless (map.size == map2.size);
+  fail_unless (memcmp (map.data, map2.data, map.size) == 0);
+  gst_buffer_unmap (gst_sample_get_buffer (to_sample2), &map2);
+  gst_buffer_unmap (gst_sample_get_buffer (to_sample), &map);
+
+  gst_sample_unref (to_sample2);
+  gst_sample_unref (to_sample);
+  gst_caps_unref (to_caps);
+  gst_buffer_unref (from_buffer);
+  gst_caps_unref (from_caps);
+  gst_sample_unref (from_sample);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   GMainLoop *loop;
@@ -1378,6 +1684,68 @@ GST_START_TEST (test_overlay_composition_premultiplied_alpha)
 
 GST_END_TEST;
 
+GST_START_TEST (test_overlay_rectangle_cache_copies)
+{
+  GstVideoOverlayRectangle *rect1, *rect2;
+  GstBuffer *pix, *pix1, *pix2;
+  GstMapInfo map;
+  gint i, a_off;
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  a_off = 3;
+#else
+  a_off = 0;
+#endif
+
+  pix = gst_buffer_new_and_alloc (200 * sizeof (guint32) * 50);
+  gst_buffer_memset (pix, 0, 0x80, gst_buffer_get_size (pix));
+  gst_buffer_add_video_meta (pix, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, 200, 50);
+  rect1 = gst_video_overlay_rectangle_new_raw (pix,
+      0, 0, 300, 50, GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  gst_buffer_unref (pix);
+
+  pix1 = gst_video_overlay_rectangle_get_pixels_raw (rect1,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+
+  /* the copy shares the scaled variant, fading it must not change the
+   * pixels of the original */
+  rect2 = gst_video_overlay_rectangle_copy (rect1);
+  gst_video_overlay_rectangle_set_global_alpha (rect2, 0.5);
+  pix2 = gst_video_overlay_rectangle_get_pixels_raw (rect2,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  fail_unless (pix1 != pix2);
+  fail_unless_equals_int (gst_buffer_get_size (pix1),
+      gst_buffer_get_size (pix2));
+
+  gst_buffer_map (pix2, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.data[a_off], 0x40);
+  gst_buffer_unmap (pix2, &map);
+  gst_buffer_map (pix1, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.data[a_off], 0x80);
+  gst_buffer_unmap (pix1, &map);
+
+  /* render at many sizes, older variants get evicted but the ones we
+   * asked for last stay cached */
+  for (i = 0; i < 20; i++) {
+    gst_video_overlay_rectangle_set_render_rectangle (rect2, 0, 0, 100 + i,
+        50);
+    pix2 = gst_video_overlay_rectangle_get_pixels_raw (rect2,
+        GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA);
+    fail_unless (pix2 != NULL);
+    gst_buffer_map (pix2, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.data[a_off], 0x80);
+    gst_buffer_unmap (pix2, &map);
+  }
+  fail_unless (pix2 == gst_video_overlay_rectangle_get_pixels_raw (rect2,
+          GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA));
+
+  gst_video_overlay_rectangle_unref (rect2);
+  gst_video_overlay_rectangle_unref (rect1);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_overlay_composition_global_alpha)
 {
   GstVideoOverlayRectangle *rect1;
@@ -1896,6 +2264,84 @@ GST_START_TEST (test_video_pack_unpack2)
   gint num_formats, i;
   GArray *packarray, *unpackarray;
 
+GST_START_TEST (test_video_convert_gamma_lut)
+{
+  GstVideoInfo info1, info2;
+  GstVideoFrame frame1, frame2, frame3;
+  GstBuffer *buffer1, *buffer2, *buffer3;
+  GstVideoConverter *convert;
+  GstStructure *options;
+  GstMapInfo map1, map3;
+  gint i, x, y;
+
+  gst_video_info_set_format (&info1, GST_VIDEO_FORMAT_ARGB, 64, 64);
+  info1.colorimetry.range = GST_VIDEO_COLOR_RANGE_0_255;
+  info1.colorimetry.matrix = GST_VIDEO_COLOR_MATRIX_RGB;
+  info1.colorimetry.transfer = GST_VIDEO_TRANSFER_BT709;
+  info1.colorimetry.primaries = GST_VIDEO_COLOR_PRIMARIES_BT709;
+  gst_video_info_set_format (&info2, GST_VIDEO_FORMAT_ARGB64, 64, 64);
+  info2.colorimetry = info1.colorimetry;
+  info2.colorimetry.primaries = GST_VIDEO_COLOR_PRIMARIES_BT2020;
+
+  buffer1 = gst_buffer_new_and_alloc (info1.size);
+  gst_video_frame_map (&frame1, &info1, buffer1, GST_MAP_WRITE);
+  for (y = 0; y < 64; y++) {
+    guint8 *p = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame1, 0) +
+        y * GST_VIDEO_FRAME_PLANE_STRIDE (&frame1, 0);
+
+    for (x = 0; x < 64; x++) {
+      p[x * 4 + 0] = 255;
+      p[x * 4 + 1] = x * 4;
+      p[x * 4 + 2] = y * 4;
+      p[x * 4 + 3] = 255 - x * 2 - y * 2;
+    }
+  }
+  gst_video_frame_unmap (&frame1);
+  gst_video_frame_map (&frame1, &info1, buffer1, GST_MAP_READ);
+
+  buffer2 = gst_buffer_new_and_alloc (info2.size);
+  buffer3 = gst_buffer_new_and_alloc (info1.size);
+  gst_video_frame_map (&frame2, &info2, buffer2, GST_MAP_WRITE);
+  gst_video_frame_map (&frame3, &info1, buffer3, GST_MAP_WRITE);
+
+  options = gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+      GST_VIDEO_GAMMA_MODE_REMAP,
+      GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE, GST_TYPE_VIDEO_PRIMARIES_MODE,
+      GST_VIDEO_PRIMARIES_MODE_FAST, NULL);
+
+  /* no scaling, both conversions go through the gamma LUT */
+  convert = gst_video_converter_new (&info1, &info2,
+      gst_structure_copy (options));
+  gst_video_converter_frame (convert, &frame1, &frame2);
+  gst_video_converter_free (convert);
+  gst_video_frame_unmap (&frame2);
+
+  gst_video_frame_map (&frame2, &info2, buffer2, GST_MAP_READ);
+  convert = gst_video_converter_new (&info2, &info1, options);
+  gst_video_converter_frame (convert, &frame2, &frame3);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&frame1);
+  gst_video_frame_unmap (&frame2);
+  gst_video_frame_unmap (&frame3);
+
+  /* BT709 fits in BT2020, the round trip gives back the input */
+  gst_buffer_map (buffer1, &map1, GST_MAP_READ);
+  gst_buffer_map (buffer3, &map3, GST_MAP_READ);
+  for (i = 0; i < map1.size; i++)
+    fail_unless (ABS (map1.data[i] - map3.data[i]) <= 2,
+        "byte %d differs, %d != %d", i, map1.data[i], map3.data[i]);
+  gst_buffer_unmap (buffer1, &map1);
+  gst_buffer_unmap (buffer3, &map3);
+
+  gst_buffer_unref (buffer1);
+  gst_buffer_unref (buffer2);
+  gst_buffer_unref (buffer3);
+}
+
+GST_END_TEST;
+
 #define WIDTH 320
 #define HEIGHT 240
 /* set to something larger to do benchmarks */
@@ -2122,6 +2568,314 @@ GST_END_TEST;
 #undef HEIGHT
 #undef TIME
 
+/* reference versions of the 2x horizontal chroma filters, on one chroma
+ * component */
+static void
+chroma_h2_reference (gint * c, gint width, gboolean cosited, gboolean up)
+{
+  gint i, c0, c1;
+
+  if (up && !cosited) {
+    c1 = c[0];
+    for (i = 1; i < width - 1; i += 2) {
+      c0 = c1, c1 = c[i + 1];
+      c[i] = (3 * c0 + c1 + 2) >> 2;
+      c[i + 1] = (c0 + 3 * c1 + 2) >> 2;
+    }
+  } else if (up) {
+    for (i = 1; i < width - 1; i += 2)
+      c[i] = (c[i - 1] + c[i + 1] + 1) >> 1;
+  } else if (!cosited) {
+    for (i = 0; i < width - 1; i += 2)
+      c[i] = (c[i] + c[i + 1] + 1) >> 1;
+  } else if (width >= 2) {
+    c[0] = (3 * c[0] + c[1] + 2) >> 2;
+    for (i = 2; i < width - 2; i += 2)
+      c[i] = (c[i - 1] + 2 * c[i] + c[i + 1] + 2) >> 2;
+    if (i < width)
+      c[i] = (c[i - 1] + 3 * c[i] + 2) >> 2;
+  }
+}
+
+#define MAX_WIDTH 67
+GST_START_TEST (test_video_chroma_h2)
+{
+  GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_AYUV,
+    GST_VIDEO_FORMAT_AYUV64,
+  };
+  GstVideoChromaSite sites[] = {
+    GST_VIDEO_CHROMA_SITE_NONE,
+    GST_VIDEO_CHROMA_SITE_H_COSITED,
+  };
+  gint f, s, up, width, i, k;
+  guint8 line8[MAX_WIDTH * 4];
+  guint16 line16[MAX_WIDTH * 4];
+  gint ref[4][MAX_WIDTH];
+  gpointer lines[1];
+
+  /* the SIMD versions of the filters must give exactly the same result as
+   * the C reference for all widths and values, including the largest
+   * ones */
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (s = 0; s < G_N_ELEMENTS (sites); s++) {
+      for (up = 0; up < 2; up++) {
+        GstVideoChromaResample *resample;
+        guint n_lines;
+        gint offset;
+
+        resample =
+            gst_video_chroma_resample_new (GST_VIDEO_CHROMA_METHOD_LINEAR,
+            sites[s], GST_VIDEO_CHROMA_FLAG_NONE, formats[f], up ? 1 : -1, 0);
+        fail_unless (resample != NULL);
+        gst_video_chroma_resample_get_info (resample, &n_lines, &offset);
+        fail_unless (n_lines == 1);
+        fail_unless (offset == 0);
+
+        for (width = 1; width <= MAX_WIDTH; width++) {
+          for (i = 0; i < width * 4; i++) {
+            gint v = g_random_int ();
+
+            /* mix in some extreme values */
+            if (i % 5 == 0)
+              v = -1;
+            else if (i % 7 == 0)
+              v = 0;
+
+            if (f == 0)
+              ref[i % 4][i / 4] = line8[i] = v;
+            else
+              ref[i % 4][i / 4] = line16[i] = v;
+          }
+          chroma_h2_reference (ref[2], width, s == 1, up);
+          chroma_h2_reference (ref[3], width, s == 1, up);
+
+          lines[0] = f == 0 ? (gpointer) line8 : (gpointer) line16;
+          gst_video_chroma_resample (resample, lines, width);
+
+          for (i = 0; i < width; i++) {
+            for (k = 0; k < 4; k++) {
+              gint v = f == 0 ? line8[i * 4 + k] : line16[i * 4 + k];
+
+              fail_unless_equals_int (v, ref[k][i]);
+            }
+          }
+        }
+        gst_video_chroma_resample_free (resample);
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+#undef MAX_WIDTH
+
+/* the SIMD filters are made from averages with a correction of the lowest
+ * bit, check all pairs of 8 bits values. The patterns put a and b on the
+ * positions that each filter combines */
+#define WIDTH 35
+GST_START_TEST (test_video_chroma_h2_all_values)
+{
+  GstVideoChromaResample *resample[2][2];
+  GstVideoChromaSite sites[] = {
+    GST_VIDEO_CHROMA_SITE_NONE,
+    GST_VIDEO_CHROMA_SITE_H_COSITED,
+  };
+  guint8 line[WIDTH * 4];
+  gint ref[4][WIDTH];
+  gpointer lines[1] = { line };
+  gint a, b, pattern, s, up, i, k;
+
+  for (s = 0; s < 2; s++)
+    for (up = 0; up < 2; up++)
+      resample[s][up] =
+          gst_video_chroma_resample_new (GST_VIDEO_CHROMA_METHOD_LINEAR,
+          sites[s], GST_VIDEO_CHROMA_FLAG_NONE, GST_VIDEO_FORMAT_AYUV,
+          up ? 1 : -1, 0);
+
+  for (a = 0; a < 256; a++) {
+    for (b = 0; b < 256; b++) {
+      for (pattern = 0; pattern < 2; pattern++) {
+        for (s = 0; s < 2; s++) {
+          for (up = 0; up < 2; up++) {
+            for (i = 0; i < WIDTH; i++) {
+              /* a a b b ... or a b a b ..., and swapped for V */
+              gboolean first = pattern ? (i & 1) == 0 : (i & 2) == 0;
+
+              ref[0][i] = line[i * 4 + 0] = i;
+              ref[1][i] = line[i * 4 + 1] = 255 - i;
+              ref[2][i] = line[i * 4 + 2] = first ? a : b;
+              ref[3][i] = line[i * 4 + 3] = first ? b : a;
+            }
+            chroma_h2_reference (ref[2], WIDTH, s == 1, up);
+            chroma_h2_reference (ref[3], WIDTH, s == 1, up);
+
+            gst_video_chroma_resample (resample[s][up], lines, WIDTH);
+
+            for (i = 0; i < WIDTH; i++)
+              for (k = 0; k < 4; k++)
+                if (line[i * 4 + k] != ref[k][i])
+                  fail ("a %d, b %d, pattern %d, site %d, up %d, pixel %d, "
+                      "component %d: %d != %d", a, b, pattern, s, up, i, k,
+                      line[i * 4 + k], ref[k][i]);
+          }
+        }
+      }
+    }
+  }
+
+  for (s = 0; s < 2; s++)
+    for (up = 0; up < 2; up++)
+      gst_video_chroma_resample_free (resample[s][up]);
+}
+
+GST_END_TEST;
+#undef WIDTH
+
+/* copies of the C error diffusion loops of video-dither.c, without the
+ * SIMD parts */
+static void
+dither_reference (GstVideoDitherMethod method, gboolean u16, gpointer pixels,
+    guint16 * e, const guint16 * m, gint width)
+{
+  gint i, end = width * 4;
+  guint16 mp;
+
+  if (method == GST_VIDEO_DITHER_VERTERR) {
+    guint16 *p = pixels;
+    guint32 v;
+
+    for (i = 0; i < end; i++) {
+      mp = m[i & 3];
+      v = p[i] + e[i];
+      e[i] = v & mp;
+      p[i] = MIN (v & ~mp, 65535);
+    }
+  } else if (method == GST_VIDEO_DITHER_FLOYD_STEINBERG && !u16) {
+    guint8 *p = pixels;
+    guint16 v;
+
+    for (i = 0; i < end; i++)
+      e[i] = e[i] + 5 * e[i + 4] + 3 * e[i + 8];
+    for (i = 0; i < end; i++) {
+      mp = m[i & 3];
+      v = p[i] + ((7 * e[i] + e[i + 4]) >> 4);
+      e[i + 4] = v & mp;
+      v &= ~mp;
+      p[i] = MIN (v, 255);
+    }
+  } else if (method == GST_VIDEO_DITHER_FLOYD_STEINBERG) {
+    guint16 *p = pixels;
+    guint32 v;
+
+    for (i = 0; i < end; i++) {
+      mp = m[i & 3];
+      v = p[i] + ((7 * e[i] + e[i + 4] + 5 * e[i + 8] + 3 * e[i + 12]) >> 4);
+      e[i + 4] = v & mp;
+      p[i] = MIN (v & ~mp, 65535);
+    }
+  } else if (!u16) {
+    guint8 *p = pixels;
+    guint16 v;
+
+    for (i = 0; i < end; i++) {
+      mp = m[i & 3];
+      v = p[i] + ((2 * e[i] + e[i + 8] + e[i + 12]) >> 2);
+      e[i + 4] = v & mp;
+      v &= ~mp;
+      p[i] = MIN (v, 255);
+    }
+  } else {
+    guint16 *p = pixels;
+    guint32 v;
+
+    for (i = 0; i < end; i++) {
+      mp = m[i & 3];
+      v = p[i] + ((2 * e[i] + e[i + 8] + e[i + 12]) >> 2);
+      e[i + 4] = v & mp;
+      p[i] = MIN (v & ~mp, 65535);
+    }
+  }
+}
+
+#define MAX_WIDTH 67
+#define LINES 4
+GST_START_TEST (test_video_dither_error_diffusion)
+{
+  static const struct
+  {
+    GstVideoDitherMethod method;
+    GstVideoFormat format;
+  } tests[] = {
+    {GST_VIDEO_DITHER_VERTERR, GST_VIDEO_FORMAT_AYUV64},
+    {GST_VIDEO_DITHER_FLOYD_STEINBERG, GST_VIDEO_FORMAT_AYUV},
+    {GST_VIDEO_DITHER_FLOYD_STEINBERG, GST_VIDEO_FORMAT_AYUV64},
+    {GST_VIDEO_DITHER_SIERRA_LITE, GST_VIDEO_FORMAT_AYUV},
+    {GST_VIDEO_DITHER_SIERRA_LITE, GST_VIDEO_FORMAT_AYUV64},
+  };
+  guint quant8[GST_VIDEO_MAX_COMPONENTS] = { 4, 8, 16, 2 };
+  guint quant16[GST_VIDEO_MAX_COMPONENTS] = { 256, 1024, 64, 16 };
+  guint16 line[MAX_WIDTH * 4], ref[MAX_WIDTH * 4];
+  guint16 errors[(MAX_WIDTH + 8) * 4], mask[4];
+  gint t, width, y, i;
+
+  /* the SIMD versions of the loops must give exactly the same pixels as
+   * the C loops, over several lines so that the errors of the previous line
+   * are used */
+  for (t = 0; t < G_N_ELEMENTS (tests); t++) {
+    gboolean u16 = tests[t].format == GST_VIDEO_FORMAT_AYUV64;
+    guint *quant = u16 ? quant16 : quant8;
+
+    for (i = 0; i < 4; i++) {
+      guint q = quant[(i + 3) & 3], shift = 0;
+
+      while (q > 1) {
+        shift++;
+        q >>= 1;
+      }
+      mask[i] = (1 << shift) - 1;
+    }
+
+    for (width = 1; width <= MAX_WIDTH; width++) {
+      GstVideoDither *dither;
+
+      dither = gst_video_dither_new (tests[t].method,
+          GST_VIDEO_DITHER_FLAG_NONE, tests[t].format, quant, width);
+      fail_unless (dither != NULL);
+      memset (errors, 0, sizeof (errors));
+
+      for (y = 0; y < LINES; y++) {
+        for (i = 0; i < width * 4; i++) {
+          guint16 v = g_random_int ();
+
+          /* mix in values that overflow once the error is added */
+          if (i % 5 == 0)
+            v = 0xffff;
+          else if (i % 7 == 0)
+            v = 0;
+
+          if (u16)
+            line[i] = ref[i] = v;
+          else
+            ((guint8 *) line)[i] = ((guint8 *) ref)[i] = v;
+        }
+
+        gst_video_dither_line (dither, line, 0, y, width);
+        dither_reference (tests[t].method, u16, ref, errors, mask, width);
+
+        fail_unless (memcmp (line, ref, width * 4 * (u16 ? 2 : 1)) == 0,
+            "method %d, format %s, width %d, line %d", tests[t].method,
+            gst_video_format_to_string (tests[t].format), width, y);
+      }
+      gst_video_dither_free (dither);
+    }
+  }
+}
+
+GST_END_TEST;
+#undef MAX_WIDTH
+#undef LINES
+
 GST_START_TEST (test_video_scaler)
 {
   GstVideoScaler *scale;
@@ -2137,27 +2891,179 @@ GST_START_TEST (test_video_scaler)
 
 GST_END_TEST;
 
-#define WIDTH 320
-#define HEIGHT 240
-#define TIME 0.01
+#define WIDTH_IN 16384
+#define HEIGHT_IN 48
+#define WIDTH_OUT 8192
+#define HEIGHT_OUT 24
 
-GST_START_TEST (test_video_color_convert)
+static void
+check_scaler_2d_tiled (GstVideoFormat format, gint pstride)
 {
-  GstVideoFormat infmt, outfmt;
-  GTimer *timer;
-  gint num_formats, i;
-  GArray *array;
+  GstVideoScaler *hscale, *vscale;
+  guint8 *src, *tmp, *dest1, *dest2;
+  gpointer lines[16];
+  gint i, j, src_stride, tmp_stride, dest_stride;
+  guint v_taps;
+
+  hscale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, WIDTH_IN, WIDTH_OUT, NULL);
+  vscale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, HEIGHT_IN, HEIGHT_OUT, NULL);
+  v_taps = gst_video_scaler_get_max_taps (vscale);
+  fail_unless (v_taps <= G_N_ELEMENTS (lines));
+
+  src_stride = WIDTH_IN * pstride;
+  tmp_stride = WIDTH_IN * pstride;
+  dest_stride = WIDTH_OUT * pstride;
+
+  src = g_malloc (src_stride * HEIGHT_IN);
+  for (i = 0; i < src_stride * HEIGHT_IN; i++)
+    src[i] = (i * 37) ^ (i >> 9);
+  tmp = g_malloc (tmp_stride * HEIGHT_OUT);
+  dest1 = g_malloc (dest_stride * HEIGHT_OUT);
+  dest2 = g_malloc (dest_stride * HEIGHT_OUT);
+
+  /* reference, line by line */
+  for (i = 0; i < HEIGHT_OUT; i++) {
+    guint in;
+
+    gst_video_scaler_get_coeff (vscale, i, &in, NULL);
+    for (j = 0; j < v_taps; j++)
+      lines[j] = src + (in + j) * src_stride;
+    gst_video_scaler_vertical (vscale, format, lines, tmp + i * tmp_stride, i,
+        WIDTH_IN);
+    gst_video_scaler_horizontal (hscale, format, tmp + i * tmp_stride,
+        dest1 + i * dest_stride, 0, WIDTH_OUT);
+  }
 
-  array = g_array_new (FALSE, FALSE, sizeof (ConvertResult));
+  /* the lines are too big for the cache and get scaled in column strips */
+  gst_video_scaler_2d (NULL, vscale, format, src, src_stride, dest2,
+      tmp_stride, 0, 0, WIDTH_IN, HEIGHT_OUT);
+  fail_unless (memcmp (tmp, dest2, tmp_stride * HEIGHT_OUT) == 0);
+
+  gst_video_scaler_2d (hscale, vscale, format, src, src_stride, dest2,
+      dest_stride, 0, 0, WIDTH_OUT, HEIGHT_OUT);
+  fail_unless (memcmp (dest1, dest2, dest_stride * HEIGHT_OUT) == 0);
+
+  g_free (src);
+  g_free (tmp);
+  g_free (dest1);
+  g_free (dest2);
+  gst_video_scaler_free (hscale);
+  gst_video_scaler_free (vscale);
+}
 
-  timer = g_timer_new ();
+GST_START_TEST (test_video_scaler_2d_tiled)
+{
+  check_scaler_2d_tiled (GST_VIDEO_FORMAT_AYUV, 4);
+  check_scaler_2d_tiled (GST_VIDEO_FORMAT_GRAY16_LE, 2);
+}
 
-  num_formats = get_num_formats ();
+GST_END_TEST;
+#undef WIDTH_IN
+#undef HEIGHT_IN
+#undef WIDTH_OUT
+#undef HEIGHT_OUT
+
+/* the SIMD versions of the 4 and 8 taps loops do blocks of 16 (8 bits) or
+ * 8 (16 bits) pixels and leave the rest of the line to the C loops. Scaling
+ * the rows horizontally must give the same pixels as scaling the transposed
+ * image vertically. With @width or @out_size below the block size, one of
+ * the two only goes through the C loops. */
+static void
+check_scaler_transposed (GstVideoFormat format, gsize pstride, guint n_taps,
+    guint in_size, guint out_size, guint width)
+{
+  GstVideoScaler *scale;
+  guint8 *src, *src_t, *hout, *vout;
+  gpointer lines[8];
+  guint i, j;
+
+  GST_INFO ("%s, %u taps, %u -> %u, %u wide",
+      gst_video_format_to_string (format), n_taps, in_size, out_size, width);
+
+  scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, n_taps, in_size, out_size, NULL);
+  fail_unless_equals_int (gst_video_scaler_get_max_taps (scale), n_taps);
+
+  src = g_malloc (width * in_size * pstride);
+  src_t = g_malloc (width * in_size * pstride);
+  for (i = 0; i < width * in_size * pstride; i++)
+    src[i] = g_random_int ();
+  for (i = 0; i < width; i++)
+    for (j = 0; j < in_size; j++)
+      memcpy (src_t + (j * width + i) * pstride,
+          src + (i * in_size + j) * pstride, pstride);
+
+  hout = g_malloc (width * out_size * pstride);
+  vout = g_malloc (width * out_size * pstride);
+
+  for (i = 0; i < width; i++)
+    gst_video_scaler_horizontal (scale, format, src + i * in_size * pstride,
+        hout + i * out_size * pstride, 0, out_size);
+
+  for (j = 0; j < out_size; j++) {
+    guint in, k;
+
+    gst_video_scaler_get_coeff (scale, j, &in, NULL);
+    for (k = 0; k < n_taps; k++)
+      lines[k] = src_t + (in + k) * width * pstride;
+    gst_video_scaler_vertical (scale, format, lines,
+        vout + j * width * pstride, j, width);
+  }
 
-  for (infmt = GST_VIDEO_FORMAT_I420; infmt < num_formats; infmt++) {
-    GstVideoInfo ininfo;
-    GstVideoFrame inframe;
-    GstBuffer *inbuffer;
+  for (i = 0; i < width; i++)
+    for (j = 0; j < out_size; j++)
+      fail_unless (memcmp (hout + (i * out_size + j) * pstride,
+              vout + (j * width + i) * pstride, pstride) == 0);
+
+  g_free (src);
+  g_free (src_t);
+  g_free (hout);
+  g_free (vout);
+  gst_video_scaler_free (scale);
+}
+
+GST_START_TEST (test_video_scaler_simd)
+{
+  static const guint taps[] = { 4, 8 };
+  guint t;
+
+  for (t = 0; t < G_N_ELEMENTS (taps); t++) {
+    /* wide lines for the vertical SIMD loops */
+    check_scaler_transposed (GST_VIDEO_FORMAT_GRAY8, 1, taps[t], 12, 5, 37);
+    check_scaler_transposed (GST_VIDEO_FORMAT_GRAY16_LE, 2, taps[t], 12, 5,
+        37);
+    /* wide output for the horizontal SIMD loops */
+    check_scaler_transposed (GST_VIDEO_FORMAT_GRAY8, 1, taps[t], 23, 37, 3);
+    check_scaler_transposed (GST_VIDEO_FORMAT_GRAY16_LE, 2, taps[t], 23, 37,
+        3);
+  }
+}
+
+GST_END_TEST;
+
+#define WIDTH 320
+#define HEIGHT 240
+#define TIME 0.01
+
+GST_START_TEST (test_video_color_convert)
+{
+  GstVideoFormat infmt, outfmt;
+  GTimer *timer;
+  gint num_formats, i;
+  GArray *array;
+
+  array = g_array_new (FALSE, FALSE, sizeof (ConvertResult));
+
+  timer = g_timer_new ();
+
+  num_formats = get_num_formats ();
+
+  for (infmt = GST_VIDEO_FORMAT_I420; infmt < num_formats; infmt++) {
+    GstVideoInfo ininfo;
+    GstVideoFrame inframe;
+    GstBuffer *inbuffer;
 
     gst_video_info_set_format (&ininfo, infmt, WIDTH, HEIGHT);
     inbuffer = gst_buffer_new_and_alloc (ininfo.size);
@@ -2387,6 +3293,753 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_convert_threads)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe1, outframe2;
+  GstBuffer *inbuffer, *outbuffer1, *outbuffer2;
+  GstVideoConverter *convert;
+  GstMapInfo map1, map2;
+  guint8 *data;
+  gint i;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 320, 240);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map1, GST_MAP_WRITE);
+  data = map1.data;
+  for (i = 0; i < map1.size; i++)
+    data[i] = (i * 7) & 0xff;
+  gst_buffer_unmap (inbuffer, &map1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_BGRx, 400, 301);
+  outbuffer1 = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe1, &outinfo, outbuffer1, GST_MAP_WRITE);
+  outbuffer2 = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe2, &outinfo, outbuffer2, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 1, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe1);
+  gst_video_converter_free (convert);
+
+  /* the bands must produce exactly the same pixels, also when the frame
+   * is converted more than once */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe2);
+  gst_video_converter_frame (convert, &inframe, &outframe2);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe1);
+  gst_video_frame_unmap (&outframe2);
+
+  gst_buffer_map (outbuffer1, &map1, GST_MAP_READ);
+  gst_buffer_map (outbuffer2, &map2, GST_MAP_READ);
+  fail_unless_equals_int (map1.size, map2.size);
+  fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+  gst_buffer_unmap (outbuffer1, &map1);
+  gst_buffer_unmap (outbuffer2, &map2);
+
+  gst_buffer_unref (outbuffer1);
+  gst_buffer_unref (outbuffer2);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+convert_dithered (GstVideoFrame * inframe, GstVideoInfo * outinfo,
+    GstVideoDitherMethod method, guint threads)
+{
+  GstVideoConverter *convert;
+  GstVideoFrame outframe;
+  GstBuffer *outbuffer;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  gst_video_frame_map (&outframe, outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&inframe->info, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          method, GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads,
+          NULL));
+  gst_video_converter_frame (convert, inframe, &outframe);
+  /* a later config reaches all bands */
+  gst_video_converter_set_config (convert,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          method, NULL));
+  gst_video_converter_frame (convert, inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+
+  return outbuffer;
+}
+
+GST_START_TEST (test_video_convert_threads_dither)
+{
+  static const GstVideoDitherMethod methods[] = {
+    GST_VIDEO_DITHER_NONE, GST_VIDEO_DITHER_VERTERR,
+    GST_VIDEO_DITHER_FLOYD_STEINBERG, GST_VIDEO_DITHER_SIERRA_LITE,
+    GST_VIDEO_DITHER_BAYER
+  };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe;
+  GstBuffer *inbuffer, *outbuffer1, *outbuffer2;
+  GstMapInfo map;
+  guint8 *data;
+  gint i;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 320, 240);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  data = map.data;
+  for (i = 0; i < map.size; i++)
+    data[i] = (i * 7) & 0xff;
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  /* RGB16 has fewer bits than the unpack format, the lines are dithered */
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_RGB16, 400, 301);
+
+  for (i = 0; i < G_N_ELEMENTS (methods); i++) {
+    GST_DEBUG ("dither method %d", methods[i]);
+    outbuffer1 = convert_dithered (&inframe, &outinfo, methods[i], 1);
+    outbuffer2 = convert_dithered (&inframe, &outinfo, methods[i], 4);
+    gst_buffer_map (outbuffer1, &map, GST_MAP_READ);
+    fail_unless (gst_buffer_memcmp (outbuffer2, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (outbuffer1, &map);
+    gst_buffer_unref (outbuffer1);
+    gst_buffer_unref (outbuffer2);
+  }
+
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+/* the thread and band layout follows a dither set after construction */
+GST_START_TEST (test_video_convert_threads_set_dither)
+{
+  GstVideoConverter *convert;
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer1, *outbuffer2;
+  GstMapInfo map;
+  guint8 *data;
+  gint i;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 320, 240);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  data = map.data;
+  for (i = 0; i < map.size; i++)
+    data[i] = (i * 7) & 0xff;
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_RGB16, 400, 301);
+
+  outbuffer1 = convert_dithered (&inframe, &outinfo,
+      GST_VIDEO_DITHER_FLOYD_STEINBERG, 1);
+
+  /* split in bands for the ordered dither, error diffusion can't be */
+  outbuffer2 = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer2, GST_MAP_WRITE);
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_BAYER, GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
+          4, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  fail_unless (gst_video_converter_set_config (convert,
+          gst_structure_new ("options",
+              GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
+              GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_FLOYD_STEINBERG,
+              NULL)));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_frame_unmap (&outframe);
+
+  gst_buffer_map (outbuffer1, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (outbuffer2, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (outbuffer1, &map);
+
+  /* and back to bands, going through the threads option as well */
+  gst_buffer_unref (outbuffer1);
+  outbuffer1 = convert_dithered (&inframe, &outinfo,
+      GST_VIDEO_DITHER_BAYER, 1);
+
+  gst_video_frame_map (&outframe, &outinfo, outbuffer2, GST_MAP_WRITE);
+  fail_unless (gst_video_converter_set_config (convert,
+          gst_structure_new ("options",
+              GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
+              GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_BAYER,
+              GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 3, NULL)));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_frame_unmap (&outframe);
+  gst_video_converter_free (convert);
+
+  gst_buffer_map (outbuffer1, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (outbuffer2, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (outbuffer1, &map);
+
+  gst_buffer_unref (outbuffer1);
+  gst_buffer_unref (outbuffer2);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_orientation)
+{
+  static const struct
+  {
+    GstVideoOrientationMethod method;
+    gboolean transpose;
+    /* the source pixel of x, y is (x_x * x + x_y * y + x_0,
+     * y_x * x + y_y * y + y_0) */
+    gint x_x, x_y, x_0, y_x, y_y, y_0;
+  } methods[] = {
+    {GST_VIDEO_ORIENTATION_IDENTITY, FALSE, 1, 0, 0, 0, 1, 0},
+    {GST_VIDEO_ORIENTATION_90R, TRUE, 0, 1, 0, -1, 0, 8},
+    {GST_VIDEO_ORIENTATION_180, FALSE, -1, 0, 4, 0, -1, 8},
+    {GST_VIDEO_ORIENTATION_90L, TRUE, 0, -1, 4, 1, 0, 0},
+    {GST_VIDEO_ORIENTATION_HORIZ, FALSE, -1, 0, 4, 0, 1, 0},
+    {GST_VIDEO_ORIENTATION_VERT, FALSE, 1, 0, 0, 0, -1, 8},
+    {GST_VIDEO_ORIENTATION_UL_LR, TRUE, 0, 1, 0, 1, 0, 0},
+    {GST_VIDEO_ORIENTATION_UR_LL, TRUE, 0, -1, 4, -1, 0, 8},
+  };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  guint8 *data;
+  gint i, x, y, threads;
+
+  /* every pixel has its coordinates in the R and G components */
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 5, 9);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+  for (y = 0; y < 9; y++) {
+    data = GST_VIDEO_FRAME_PLANE_DATA (&inframe, 0);
+    data += y * GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, 0);
+    for (x = 0; x < 5; x++) {
+      data[4 * x + 0] = 0xff;
+      data[4 * x + 1] = x;
+      data[4 * x + 2] = y;
+      data[4 * x + 3] = 0;
+    }
+  }
+  gst_video_frame_unmap (&inframe);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  /* with 2 threads the 9 lines are done in 2 bands */
+  for (threads = 1; threads <= 2; threads++) {
+    for (i = 0; i < G_N_ELEMENTS (methods); i++) {
+      gint width = methods[i].transpose ? 9 : 5;
+      gint height = methods[i].transpose ? 5 : 9;
+
+      gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_ARGB, width,
+          height);
+      outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+      gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+      convert = gst_video_converter_new (&ininfo, &outinfo,
+          gst_structure_new ("options",
+              GST_VIDEO_CONVERTER_OPT_ORIENTATION_METHOD,
+              GST_TYPE_VIDEO_ORIENTATION_METHOD, methods[i].method,
+              GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads, NULL));
+      fail_unless (convert != NULL);
+      gst_video_converter_frame (convert, &inframe, &outframe);
+      gst_video_converter_free (convert);
+
+      for (y = 0; y < height; y++) {
+        data = GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0);
+        data += y * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, 0);
+        for (x = 0; x < width; x++) {
+          fail_unless_equals_int (data[4 * x + 1],
+              methods[i].x_x * x + methods[i].x_y * y + methods[i].x_0);
+          fail_unless_equals_int (data[4 * x + 2],
+              methods[i].y_x * x + methods[i].y_y * y + methods[i].y_0);
+        }
+      }
+      gst_video_frame_unmap (&outframe);
+      gst_buffer_unref (outbuffer);
+    }
+  }
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_cache)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoConverter *convert, *cached;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoFrame inframe, outframe;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 320, 240);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_I420, 400, 300);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+          NULL));
+  fail_unless (convert != NULL);
+  gst_video_converter_free (convert);
+
+  /* the same configuration gives back the freed converter */
+  cached = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+          NULL));
+  fail_unless (cached == convert);
+
+  /* and it still converts */
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x80, ininfo.size);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_converter_frame (cached, &inframe, &outframe);
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (outbuffer);
+
+  /* a different configuration gets a new converter */
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  fail_unless (convert != NULL);
+  fail_unless (convert != cached);
+
+  gst_video_converter_free (convert);
+  gst_video_converter_free (cached);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_stats)
+{
+  static const gchar *stages[] = {
+    "unpack-time", "upsample-time", "to-rgb-time", "hscale-time",
+    "vscale-time", "convert-time", "alpha-time", "to-yuv-time",
+    "downsample-time", "dither-time", "pack-time"
+  };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoConverter *convert;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoFrame inframe, outframe;
+  GstStructure *stats;
+  guint64 frames, time, stage, sum;
+  gint i;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 320, 240);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_I420, 400, 300);
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x80, ininfo.size);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  /* nothing is measured by default */
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  stats = gst_video_converter_get_stats (convert);
+  fail_unless (gst_structure_get_uint64 (stats, "frames", &frames));
+  fail_unless_equals_uint64 (frames, 0);
+  gst_structure_free (stats);
+  gst_video_converter_free (convert);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_STATS,
+          G_TYPE_BOOLEAN, TRUE, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  stats = gst_video_converter_get_stats (convert);
+  fail_unless (gst_structure_get_uint64 (stats, "frames", &frames));
+  fail_unless_equals_uint64 (frames, 2);
+  fail_unless (gst_structure_get_uint64 (stats, "time", &time));
+
+  /* the stages are measured inside the total time */
+  for (i = 0, sum = 0; i < G_N_ELEMENTS (stages); i++) {
+    fail_unless (gst_structure_get_uint64 (stats, stages[i], &stage));
+    sum += stage;
+  }
+  fail_unless (sum <= time);
+  gst_structure_free (stats);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (outbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_balance)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoConverter *convert;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoFrame inframe, outframe;
+  gdouble contrast = 0.5, brightness = 0.1, hue = 0.5, saturation = 1.5;
+  guint8 *in, *out;
+  gint x;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_AYUV, 16, 1);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_AYUV, 16, 1);
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  in = GST_VIDEO_FRAME_PLANE_DATA (&inframe, 0);
+  for (x = 0; x < 16; x++) {
+    in[4 * x + 0] = 0xff;
+    in[4 * x + 1] = 16 + x * 14;
+    in[4 * x + 2] = 128 + (x - 8) * 8;
+    in[4 * x + 3] = 128 - (x - 8) * 6;
+  }
+
+  /* the same format, the balance is done with the matrix */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_CONTRAST, G_TYPE_DOUBLE, contrast,
+          GST_VIDEO_CONVERTER_OPT_BRIGHTNESS, G_TYPE_DOUBLE, brightness,
+          GST_VIDEO_CONVERTER_OPT_HUE, G_TYPE_DOUBLE, hue,
+          GST_VIDEO_CONVERTER_OPT_SATURATION, G_TYPE_DOUBLE, saturation,
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE, NULL));
+  fail_unless (convert != NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  out = GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0);
+  for (x = 0; x < 16; x++) {
+    gdouble y = (in[4 * x + 1] - 16) / 219.0;
+    gdouble u = (in[4 * x + 2] - 128) / 224.0;
+    gdouble v = (in[4 * x + 3] - 128) / 224.0;
+    gdouble hc = saturation * cos (G_PI * hue);
+    gdouble hs = saturation * sin (G_PI * hue);
+    gint ey, eu, ev;
+
+    ey = CLAMP (rint ((y * contrast + brightness) * 219.0 + 16), 0, 255);
+    eu = CLAMP (rint ((u * hc + v * hs) * 224.0 + 128), 0, 255);
+    ev = CLAMP (rint ((v * hc - u * hs) * 224.0 + 128), 0, 255);
+
+    GST_DEBUG ("%d: %d %d %d -> %d %d %d, expected %d %d %d", x,
+        in[4 * x + 1], in[4 * x + 2], in[4 * x + 3], out[4 * x + 1],
+        out[4 * x + 2], out[4 * x + 3], ey, eu, ev);
+    fail_unless_equals_int (out[4 * x + 0], 0xff);
+    fail_unless (ABS (out[4 * x + 1] - ey) <= 1);
+    fail_unless (ABS (out[4 * x + 2] - eu) <= 1);
+    fail_unless (ABS (out[4 * x + 3] - ev) <= 1);
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  /* without saturation, RGB becomes gray */
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB, 16, 1);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_ARGB, 16, 1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_SATURATION, G_TYPE_DOUBLE, 0.0, NULL));
+  fail_unless (convert != NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  out = GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0);
+  for (x = 0; x < 16; x++) {
+    fail_unless (ABS (out[4 * x + 1] - out[4 * x + 2]) <= 1);
+    fail_unless (ABS (out[4 * x + 1] - out[4 * x + 3]) <= 1);
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (outbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_matrix_native)
+{
+  static const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_Y42B
+  };
+  gint i, k;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstVideoFrame inframe, outframe1, outframe2;
+    GstBuffer *inbuffer, *outbuffer1, *outbuffer2;
+    GstVideoConverter *convert;
+    GstMapInfo map1, map2;
+
+    gst_video_info_set_format (&ininfo, formats[i], 320, 240);
+    gst_video_colorimetry_from_string (&ininfo.colorimetry, "bt601");
+    outinfo = ininfo;
+    gst_video_colorimetry_from_string (&outinfo.colorimetry, "bt709");
+
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+    for (k = 0; k < GST_VIDEO_FRAME_N_COMPONENTS (&inframe); k++) {
+      gint y, x, val = k == 0 ? 100 : (k == 1 ? 60 : 200);
+
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&inframe, k); y++) {
+        guint8 *p = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&inframe, k) +
+            y * GST_VIDEO_FRAME_COMP_STRIDE (&inframe, k);
+
+        for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (&inframe, k); x++)
+          p[x * GST_VIDEO_FRAME_COMP_PSTRIDE (&inframe, k)] = val;
+      }
+    }
+    gst_video_frame_unmap (&inframe);
+    gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+    outbuffer1 = gst_buffer_new_and_alloc (outinfo.size);
+    outbuffer2 = gst_buffer_new_and_alloc (outinfo.size);
+    gst_buffer_memset (outbuffer1, 0, 0, -1);
+    gst_buffer_memset (outbuffer2, 0, 0, -1);
+    gst_video_frame_map (&outframe1, &outinfo, outbuffer1, GST_MAP_WRITE);
+    gst_video_frame_map (&outframe2, &outinfo, outbuffer2, GST_MAP_WRITE);
+
+    /* a quantization other than 1 forces the generic path */
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT, 2,
+            NULL));
+    gst_video_converter_frame (convert, &inframe, &outframe1);
+    gst_video_converter_free (convert);
+
+    convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+    gst_video_converter_frame (convert, &inframe, &outframe2);
+    gst_video_converter_free (convert);
+
+    gst_video_frame_unmap (&outframe1);
+    gst_video_frame_unmap (&outframe2);
+    gst_video_frame_unmap (&inframe);
+
+    /* on flat content both paths agree up to rounding */
+    gst_buffer_map (outbuffer1, &map1, GST_MAP_READ);
+    gst_buffer_map (outbuffer2, &map2, GST_MAP_READ);
+    for (k = 0; k < map1.size; k++)
+      fail_unless (ABS (map1.data[k] - map2.data[k]) <= 1,
+          "%s: byte %d differs, %d != %d", gst_video_format_to_string
+          (formats[i]), k, map1.data[k], map2.data[k]);
+    gst_buffer_unmap (outbuffer1, &map1);
+    gst_buffer_unmap (outbuffer2, &map2);
+
+    gst_buffer_unref (inbuffer);
+    gst_buffer_unref (outbuffer1);
+    gst_buffer_unref (outbuffer2);
+  }
+}
+
+GST_END_TEST;
+
+#define WIDTH 320
+#define HEIGHT 240
+#define TIME 0.01
+
+static GstStructure *
+make_10bit_options (guint quantization)
+{
+  return gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      GST_VIDEO_DITHER_NONE,
+      GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT, quantization,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
+      GST_VIDEO_CHROMA_MODE_NONE,
+      GST_VIDEO_CONVERTER_OPT_MATRIX_MODE, GST_TYPE_VIDEO_MATRIX_MODE,
+      GST_VIDEO_MATRIX_MODE_NONE, NULL);
+}
+
+GST_START_TEST (test_video_convert_10bit)
+{
+  static const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12,
+    GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_P010_10LE
+  };
+  GTimer *timer;
+  gint i, j, k;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstVideoInfo ininfo;
+    GstVideoFrame inframe;
+    GstBuffer *inbuffer;
+    GstMapInfo map;
+
+    gst_video_info_set_format (&ininfo, formats[i], WIDTH, HEIGHT);
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+    for (k = 0; k < map.size; k++)
+      map.data[k] = k * 13;
+    gst_buffer_unmap (inbuffer, &map);
+    gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+    for (j = 0; j < G_N_ELEMENTS (formats); j++) {
+      GstVideoInfo outinfo;
+      GstVideoFrame outframe1, outframe2;
+      GstBuffer *outbuffer1, *outbuffer2;
+      GstVideoConverter *convert;
+      GstMapInfo map1, map2;
+      gdouble elapsed;
+      gint count;
+
+      /* only the pairs with a 10 bits format */
+      if (i == j || (i < 2 && j < 2))
+        continue;
+
+      gst_video_info_set_format (&outinfo, formats[j], WIDTH, HEIGHT);
+      outbuffer1 = gst_buffer_new_and_alloc (outinfo.size);
+      gst_buffer_memset (outbuffer1, 0, 0, -1);
+      outbuffer2 = gst_buffer_new_and_alloc (outinfo.size);
+      gst_buffer_memset (outbuffer2, 0, 0, -1);
+      gst_video_frame_map (&outframe1, &outinfo, outbuffer1, GST_MAP_WRITE);
+      gst_video_frame_map (&outframe2, &outinfo, outbuffer2, GST_MAP_WRITE);
+
+      /* a quantization other than 1 forces the generic path */
+      convert = gst_video_converter_new (&ininfo, &outinfo,
+          make_10bit_options (2));
+      gst_video_converter_frame (convert, &inframe, &outframe1);
+      gst_video_converter_free (convert);
+
+      convert = gst_video_converter_new (&ininfo, &outinfo,
+          make_10bit_options (1));
+      gst_video_converter_frame (convert, &inframe, &outframe2);
+
+      count = 0;
+      g_timer_start (timer);
+      while (TRUE) {
+        gst_video_converter_frame (convert, &inframe, &outframe2);
+
+        count++;
+        elapsed = g_timer_elapsed (timer, NULL);
+        if (elapsed >= TIME)
+          break;
+      }
+      GST_DEBUG ("%f conversions/sec %s->%s",
+          count / elapsed, gst_video_format_to_string (formats[i]),
+          gst_video_format_to_string (formats[j]));
+
+      gst_video_converter_free (convert);
+      gst_video_frame_unmap (&outframe1);
+      gst_video_frame_unmap (&outframe2);
+
+      /* the fastpath gives the same result as the generic path */
+      gst_buffer_map (outbuffer1, &map1, GST_MAP_READ);
+      gst_buffer_map (outbuffer2, &map2, GST_MAP_READ);
+      fail_unless (map1.size == map2.size);
+      fail_unless (memcmp (map1.data, map2.data, map1.size) == 0,
+          "%s->%s differs", gst_video_format_to_string (formats[i]),
+          gst_video_format_to_string (formats[j]));
+      gst_buffer_unmap (outbuffer1, &map1);
+      gst_buffer_unmap (outbuffer2, &map2);
+
+      gst_buffer_unref (outbuffer1);
+      gst_buffer_unref (outbuffer2);
+    }
+    gst_video_frame_unmap (&inframe);
+    gst_buffer_unref (inbuffer);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+#undef WIDTH
+#undef HEIGHT
+#undef TIME
+
+/* not a multiple of the 64x32 tiles */
+#define WIDTH 200
+#define HEIGHT 100
+GST_START_TEST (test_video_convert_detile)
+{
+  static const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_YV12
+  };
+  GstVideoInfo ininfo;
+  GstVideoFrame inframe;
+  GstBuffer *inbuffer;
+  GstMapInfo map;
+  gint i, k;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_NV12_64Z32, WIDTH,
+      HEIGHT);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  for (k = 0; k < map.size; k++)
+    map.data[k] = k * 13;
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstVideoInfo outinfo;
+    GstVideoFrame outframe1, outframe2;
+    GstBuffer *outbuffer1, *outbuffer2;
+    GstVideoConverter *convert;
+    GstMapInfo map1, map2;
+
+    gst_video_info_set_format (&outinfo, formats[i], WIDTH, HEIGHT);
+    outbuffer1 = gst_buffer_new_and_alloc (outinfo.size);
+    gst_buffer_memset (outbuffer1, 0, 0, -1);
+    outbuffer2 = gst_buffer_new_and_alloc (outinfo.size);
+    gst_buffer_memset (outbuffer2, 0, 0, -1);
+    gst_video_frame_map (&outframe1, &outinfo, outbuffer1, GST_MAP_WRITE);
+    gst_video_frame_map (&outframe2, &outinfo, outbuffer2, GST_MAP_WRITE);
+
+    /* a quantization other than 1 forces the generic path */
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        make_10bit_options (2));
+    gst_video_converter_frame (convert, &inframe, &outframe1);
+    gst_video_converter_free (convert);
+
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        make_10bit_options (1));
+    gst_video_converter_frame (convert, &inframe, &outframe2);
+    gst_video_converter_free (convert);
+
+    gst_video_frame_unmap (&outframe1);
+    gst_video_frame_unmap (&outframe2);
+
+    gst_buffer_map (outbuffer1, &map1, GST_MAP_READ);
+    gst_buffer_map (outbuffer2, &map2, GST_MAP_READ);
+    fail_unless (memcmp (map1.data, map2.data, map1.size) == 0,
+        "NV12_64Z32->%s differs", gst_video_format_to_string (formats[i]));
+    gst_buffer_unmap (outbuffer1, &map1);
+    gst_buffer_unmap (outbuffer2, &map2);
+
+    gst_buffer_unref (outbuffer1);
+    gst_buffer_unref (outbuffer2);
+  }
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+#undef WIDTH
+#undef HEIGHT
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -2413,6 +4066,188 @@ GST_START_TEST (test_video_transfer)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_frame_map_meta)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstVideoMeta *meta;
+  GstBuffer *buffer;
+  GstMapInfo map;
+  gsize offset[GST_VIDEO_MAX_PLANES] = { 16, 16 + 64 * 8, 16 + 64 * 8 + 32 * 4 };
+  gint stride[GST_VIDEO_MAX_PLANES] = { 64, 32, 32 };
+  gint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 16, 8);
+
+  /* a single memory with a meta, all planes are in the same mapping */
+  buffer = gst_buffer_new_and_alloc (offset[2] + 32 * 4);
+  meta = gst_buffer_add_video_meta_full (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, 16, 8, 3, offset, stride);
+
+  fail_unless (gst_video_frame_map (&frame, &info, buffer, GST_MAP_READWRITE));
+  fail_unless (frame.meta == meta);
+  for (i = 0; i < 3; i++) {
+    fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, i) ==
+        (guint8 *) frame.map[0].data + offset[i]);
+    fail_unless_equals_int (GST_VIDEO_FRAME_PLANE_STRIDE (&frame, i),
+        stride[i]);
+    fail_unless_equals_int (GST_VIDEO_FRAME_PLANE_OFFSET (&frame, i),
+        offset[i]);
+  }
+  memset (GST_VIDEO_FRAME_PLANE_DATA (&frame, 2), 0x42, 32 * 4);
+  gst_video_frame_unmap (&frame);
+
+  /* the memory is unmapped again */
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_WRITE));
+  fail_unless_equals_int (map.data[offset[2]], 0x42);
+  gst_buffer_unmap (buffer, &map);
+
+  /* planes outside of the memory */
+  gst_buffer_set_size (buffer, offset[2]);
+  fail_if (gst_video_frame_map (&frame, &info, buffer, GST_MAP_READ));
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_pool_huge_pages)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoInfo vinfo;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstMapInfo map;
+
+  gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_NV12, 1920, 1080);
+  caps = gst_video_info_to_caps (&vinfo);
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, vinfo.size, 0, 0);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_FIRST_TOUCH);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buffer,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READWRITE));
+  fail_unless_equals_int (map.size, vinfo.size);
+  /* the memory is usable, whether or not huge pages were available */
+  map.data[0] = map.data[map.size - 1] = 0xff;
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_unref (buffer);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+static gpointer
+acquire_buffer_thread (GstBufferPool * pool)
+{
+  GstBuffer *buffer = NULL;
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buffer,
+          NULL) == GST_FLOW_OK);
+
+  return buffer;
+}
+
+static void
+check_pool_stats (GstBufferPool * pool, guint hits, guint misses, guint waits)
+{
+  GstStructure *stats;
+  guint val;
+
+  stats = gst_video_buffer_pool_get_stats (GST_VIDEO_BUFFER_POOL (pool));
+  fail_unless (gst_structure_get_uint (stats, "hits", &val));
+  fail_unless_equals_int (val, hits);
+  fail_unless (gst_structure_get_uint (stats, "misses", &val));
+  fail_unless_equals_int (val, misses);
+  fail_unless (gst_structure_get_uint (stats, "waits", &val));
+  fail_unless_equals_int (val, waits);
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (test_video_pool_stats)
+{
+  GstBufferPool *pool;
+  GstStructure *config, *stats;
+  GstBufferPoolAcquireParams params = { 0, };
+  GstVideoInfo vinfo;
+  GstBuffer *buf1, *buf2, *buf3;
+  GstClockTime wait_time;
+  GThread *thread;
+  GstCaps *caps;
+
+  gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_I420, 320, 240);
+  caps = gst_video_info_to_caps (&vinfo);
+
+  /* everything comes from the prefilled buffers */
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, vinfo.size, 1, 2);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFILL);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf1,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf2,
+          NULL) == GST_FLOW_OK);
+  check_pool_stats (pool, 2, 0, 0);
+
+  /* not waiting is not counted */
+  params.flags = GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT;
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf3,
+          &params) == GST_FLOW_EOS);
+  check_pool_stats (pool, 2, 0, 0);
+
+  thread = g_thread_new ("acquire", (GThreadFunc) acquire_buffer_thread, pool);
+  g_usleep (G_USEC_PER_SEC / 50);
+  gst_buffer_unref (buf1);
+  buf3 = g_thread_join (thread);
+  check_pool_stats (pool, 3, 0, 1);
+
+  stats = gst_video_buffer_pool_get_stats (GST_VIDEO_BUFFER_POOL (pool));
+  fail_unless (gst_structure_get_uint64 (stats, "wait-time", &wait_time));
+  fail_unless (wait_time > 0);
+  gst_structure_free (stats);
+
+  gst_buffer_unref (buf2);
+  gst_buffer_unref (buf3);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+
+  /* without preallocation, the first buffer is a miss */
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, vinfo.size, 0, 0);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf1,
+          NULL) == GST_FLOW_OK);
+  gst_buffer_unref (buf1);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf1,
+          NULL) == GST_FLOW_OK);
+  gst_buffer_unref (buf1);
+  check_pool_stats (pool, 1, 1, 0);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_center_rect)
 {
   GstVideoRectangle src, dest, result, expected;
@@ -2635,6 +4470,80 @@ GST_START_TEST (test_overlay_blend)
 
 GST_END_TEST;
 
+GST_START_TEST (test_overlay_blend_yuv)
+{
+  static const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV21
+  };
+  GstVideoInfo sinfo, dinfo;
+  GstVideoFrame sframe, dframe;
+  GstBuffer *sbuf, *dbuf;
+  gint i, j, k, sx = 1023, sy = 601, x = -3, y = 5, alpha = 178;
+
+  /* big enough to be split over threads */
+  gst_video_info_set_format (&sinfo, GST_VIDEO_FORMAT_AYUV, sx, sy);
+  sbuf = gst_buffer_new_and_alloc (sinfo.size);
+  gst_video_frame_map (&sframe, &sinfo, sbuf, GST_MAP_READWRITE);
+  for (i = 0; i < sy; i++) {
+    guint8 *s = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&sframe, 0) +
+        i * GST_VIDEO_FRAME_PLANE_STRIDE (&sframe, 0);
+
+    for (j = 0; j < sx * 4; j++)
+      s[j] = g_random_int_range (0, 256);
+  }
+
+  for (k = 0; k < G_N_ELEMENTS (formats); k++) {
+    guint8 *orig;
+
+    gst_video_info_set_format (&dinfo, formats[k], 1280, 720);
+    dbuf = gst_buffer_new_and_alloc (dinfo.size);
+    gst_video_frame_map (&dframe, &dinfo, dbuf, GST_MAP_READWRITE);
+    for (i = 0; i < dinfo.size; i++)
+      ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&dframe, 0))[i] = i * 7;
+    orig = g_memdup (GST_VIDEO_FRAME_PLANE_DATA (&dframe, 0), dinfo.size);
+
+    fail_unless (gst_video_blend (&dframe, &sframe, x, y, alpha / 255.0));
+
+    /* compare against the OVER operation of the generic code, chroma is
+     * blended with the top-left pixel of each block */
+    for (i = 0; i < 720; i++) {
+      for (j = 0; j < 1280; j++) {
+        gint c, n_comp = ((i | j) & 1) ? 1 : 3;
+
+        for (c = 0; c < n_comp; c++) {
+          gint a, exp, cx = c ? j >> 1 : j, cy = c ? i >> 1 : i;
+          guint8 *base = GST_VIDEO_FRAME_PLANE_DATA (&dframe, 0), *d;
+          const guint8 *s;
+          gsize off;
+
+          d = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&dframe, c) +
+              cy * GST_VIDEO_FRAME_COMP_STRIDE (&dframe, c) +
+              cx * GST_VIDEO_FRAME_COMP_PSTRIDE (&dframe, c);
+          off = d - base;
+
+          if (j < x || j >= x + sx || i < y || i >= y + sy) {
+            exp = orig[off];
+          } else {
+            s = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&sframe, 0) +
+                (i - y) * GST_VIDEO_FRAME_PLANE_STRIDE (&sframe, 0) +
+                (j - x) * 4;
+            a = s[0] * alpha / 255;
+            exp = (s[c + 1] * a + orig[off] * (255 - a)) / 255;
+          }
+          fail_unless_equals_int (*d, exp);
+        }
+      }
+    }
+    g_free (orig);
+    gst_video_frame_unmap (&dframe);
+    gst_buffer_unref (dbuf);
+  }
+  gst_video_frame_unmap (&sframe);
+  gst_buffer_unref (sbuf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_overlay_composition_over_transparency)
 {
   GstVideoOverlayComposition *comp1;
@@ -2703,26 +4612,51 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_formats_rgba_large_dimension);
   tcase_add_test (tc_chain, test_video_formats_all);
   tcase_add_test (tc_chain, test_video_formats_pack_unpack);
+  tcase_add_test (tc_chain, test_video_formats_pack_unpack_rect);
+  tcase_add_test (tc_chain, test_video_formats_pack_unpack_simd);
   tcase_add_test (tc_chain, test_dar_calc);
   tcase_add_test (tc_chain, test_parse_caps_rgb);
   tcase_add_test (tc_chain, test_parse_caps_multiview);
+  tcase_add_test (tc_chain, test_multiview_buffer_get_view);
   tcase_add_test (tc_chain, test_events);
   tcase_add_test (tc_chain, test_convert_frame);
+  tcase_add_test (tc_chain, test_convert_frame_direct);
   tcase_add_test (tc_chain, test_convert_frame_async);
   tcase_add_test (tc_chain, test_video_size_from_caps);
   tcase_add_test (tc_chain, test_overlay_composition);
   tcase_add_test (tc_chain, test_overlay_composition_premultiplied_alpha);
   tcase_add_test (tc_chain, test_overlay_composition_global_alpha);
+  tcase_add_test (tc_chain, test_overlay_rectangle_cache_copies);
   tcase_add_test (tc_chain, test_video_pack_unpack2);
   tcase_add_test (tc_chain, test_video_chroma);
+  tcase_add_test (tc_chain, test_video_chroma_h2);
+  tcase_add_test (tc_chain, test_video_chroma_h2_all_values);
+  tcase_add_test (tc_chain, test_video_dither_error_diffusion);
   tcase_add_test (tc_chain, test_video_scaler);
+  tcase_add_test (tc_chain, test_video_scaler_2d_tiled);
+  tcase_add_test (tc_chain, test_video_scaler_simd);
   tcase_add_test (tc_chain, test_video_color_convert);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_threads);
+  tcase_add_test (tc_chain, test_video_convert_threads_dither);
+  tcase_add_test (tc_chain, test_video_convert_threads_set_dither);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
+  tcase_add_test (tc_chain, test_overlay_blend_yuv);
   tcase_add_test (tc_chain, test_video_center_rect);
   tcase_add_test (tc_chain, test_overlay_composition_over_transparency);
+  tcase_add_test (tc_chain, test_video_frame_map_meta);
+  tcase_add_test (tc_chain, test_video_pool_huge_pages);
+  tcase_add_test (tc_chain, test_video_pool_stats);
+  tcase_add_test (tc_chain, test_video_convert_orientation);
+  tcase_add_test (tc_chain, test_video_convert_cache);
+  tcase_add_test (tc_chain, test_video_convert_stats);
+  tcase_add_test (tc_chain, test_video_convert_10bit);
+  tcase_add_test (tc_chain, test_video_convert_detile);
+  tcase_add_test (tc_chain, test_video_convert_matrix_native);
+  tcase_add_test (tc_chain, test_video_convert_balance);
+  tcase_add_test (tc_chain, test_video_convert_gamma_lut);
 
   return s;
 }
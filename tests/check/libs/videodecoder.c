@@ -62,6 +62,8 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
 static GstPad *mysrcpad, *mysinkpad;
 static GstElement *dec;
 static GList *events = NULL;
+/* number of buffers that were output when the last GAP and EOS arrived */
+static guint buffers_at_gap, buffers_at_eos;
 
 #define TEST_VIDEO_WIDTH 640
 #define TEST_VIDEO_HEIGHT 480
@@ -80,6 +82,11 @@ struct _GstVideoDecoderTester
 
   guint64 last_buf_num;
   guint64 last_kf_num;
+
+  /* number of frames to keep pending before finishing the oldest */
+  guint hold_frames;
+  /* drop the frames that can't be decoded in time */
+  gboolean skip_late;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -139,6 +146,14 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   gint size;
   GstMapInfo map;
 
+  /* make frames finish out of order */
+  if (gst_video_decoder_get_frame_threads (dec) > 1)
+    g_usleep (g_random_int_range (0, 1000));
+
+  if (dectester->skip_late
+      && gst_video_decoder_get_max_decode_time (dec, frame) < 0)
+    return gst_video_decoder_drop_frame (dec, frame);
+
   gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
 
   input_num = *((guint64 *) map.data);
@@ -165,12 +180,46 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
 
   gst_buffer_unmap (frame->input_buffer, &map);
 
+  if (dectester->hold_frames > 0 && frame->output_buffer) {
+    guint32 oldest_num;
+
+    /* keep a deep queue of pending frames and look the oldest one up by
+     * number, like a decoder with a large reorder window would */
+    if (frame->system_frame_number < dectester->hold_frames) {
+      gst_video_codec_frame_unref (frame);
+      return GST_FLOW_OK;
+    }
+    oldest_num = frame->system_frame_number - dectester->hold_frames;
+    gst_video_codec_frame_unref (frame);
+
+    frame = gst_video_decoder_get_frame (dec, oldest_num);
+    fail_unless (frame != NULL);
+    return gst_video_decoder_finish_frame (dec, frame);
+  }
+
   if (frame->output_buffer)
     return gst_video_decoder_finish_frame (dec, frame);
   gst_video_codec_frame_unref (frame);
   return GST_FLOW_OK;
 }
 
+/* only used when not packetized. The input is a stream of 64 bit numbers,
+ * a frame is only complete when the start of the next one was seen, so the
+ * last frame is parsed when draining */
+static GstFlowReturn
+gst_video_decoder_tester_parse (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame, GstAdapter * adapter, gboolean at_eos)
+{
+  gsize available = gst_adapter_available (adapter);
+
+  if (available < 2 * sizeof (guint64)
+      && !(at_eos && available >= sizeof (guint64)))
+    return GST_VIDEO_DECODER_FLOW_NEED_DATA;
+
+  gst_video_decoder_add_to_frame (dec, sizeof (guint64));
+  return gst_video_decoder_have_frame (dec);
+}
+
 static void
 gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
 {
@@ -195,6 +244,7 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
   audiosink_class->stop = gst_video_decoder_tester_stop;
   audiosink_class->flush = gst_video_decoder_tester_flush;
   audiosink_class->handle_frame = gst_video_decoder_tester_handle_frame;
+  audiosink_class->parse = gst_video_decoder_tester_parse;
   audiosink_class->set_format = gst_video_decoder_tester_set_format;
 }
 
@@ -206,6 +256,11 @@ gst_video_decoder_tester_init (GstVideoDecoderTester * tester)
 static gboolean
 _mysinkpad_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
+  if (GST_EVENT_TYPE (event) == GST_EVENT_GAP)
+    buffers_at_gap = g_list_length (buffers);
+  else if (GST_EVENT_TYPE (event) == GST_EVENT_EOS)
+    buffers_at_eos = g_list_length (buffers);
+
   events = g_list_append (events, event);
   return TRUE;
 }
@@ -338,6 +393,196 @@ GST_START_TEST (videodecoder_playback)
 GST_END_TEST;
 
 
+GST_START_TEST (videodecoder_playback_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_frame_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* push buffers, the data is actually a number so we can track them */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* frames are decoded in parallel but must come out in order */
+  fail_unless (g_list_length (buffers) == NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+    num = *(guint64 *) map.data;
+    fail_unless (i == num);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+
+/* the last frame of an unpacketized stream is only parsed when draining and
+ * all frames must be out before the event that drained them */
+GST_START_TEST (videodecoder_drain_frame_threads_unpacketized)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  gst_video_decoder_set_packetized (GST_VIDEO_DECODER (dec), FALSE);
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  buffers_at_gap = buffers_at_eos = 0;
+
+  for (i = 0; i < NUM_BUFFERS / 2; i++) {
+    buffer = create_test_buffer (i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* a gap drains, without finishing the stream */
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_gap (gst_util_uint64_scale_round (NUM_BUFFERS / 2,
+                  GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N),
+              GST_CLOCK_TIME_NONE)));
+  fail_unless_equals_int (buffers_at_gap, NUM_BUFFERS / 2);
+
+  for (; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (buffers_at_eos, NUM_BUFFERS);
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless (i == *(guint64 *) map.data);
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+
+#define DEEP_QUEUE_DEPTH 64
+GST_START_TEST (videodecoder_deep_frame_queue)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  gint64 start, end;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  ((GstVideoDecoderTester *) dec)->hold_frames = DEEP_QUEUE_DEPTH;
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+  end = g_get_monotonic_time ();
+  GST_INFO ("pushed %d buffers with %d pending frames in %" G_GINT64_FORMAT
+      " us", NUM_BUFFERS, DEEP_QUEUE_DEPTH, end - start);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* the last frames are still pending when EOS arrives */
+  fail_unless_equals_int (g_list_length (buffers),
+      NUM_BUFFERS - DEEP_QUEUE_DEPTH);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+    num = *(guint64 *) map.data;
+    fail_unless (i == num);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+
 GST_START_TEST (videodecoder_playback_with_events)
 {
   GstSegment segment;
@@ -1073,6 +1318,182 @@ GST_START_TEST (videodecoder_query_caps_with_custom_getcaps)
 
 GST_END_TEST;
 
+#define GOP_SIZE 10
+GST_START_TEST (videodecoder_trickmode_key_units)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.flags |= GST_SEGMENT_FLAG_TRICKMODE_KEY_UNITS;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+    if (i % GOP_SIZE)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* only the keyframes were decoded */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS / GOP_SIZE);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    num = *(guint64 *) map.data;
+    fail_unless (i == num);
+    gst_buffer_unmap (buffer, &map);
+
+    i += GOP_SIZE;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_frame_interval)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  ((GstVideoDecoderTester *) dec)->skip_late = TRUE;
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* downstream uses 10 of the 30 frames per second */
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_video_event_new_frame_interval (GST_SECOND / 10)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* only the frame at the start of every interval was decoded */
+  fail_unless_equals_int (g_list_length (buffers), (NUM_BUFFERS + 2) / 3);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    num = *(guint64 *) map.data;
+    fail_unless (i == num);
+    gst_buffer_unmap (buffer, &map);
+
+    i += 3;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_stats)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  GstStructure *stats;
+  const GValue *histogram;
+  guint64 i, max, avg;
+  guint val, total;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+
+  g_object_get (dec, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+
+  fail_unless (gst_structure_get_uint (stats, "frames-in", &val));
+  fail_unless_equals_int (val, NUM_BUFFERS);
+  fail_unless (gst_structure_get_uint (stats, "frames-out", &val));
+  fail_unless_equals_int (val, NUM_BUFFERS);
+  fail_unless (gst_structure_get_uint (stats, "frames-dropped", &val));
+  fail_unless_equals_int (val, 0);
+  fail_unless (gst_structure_get_uint (stats, "queue-depth", &val));
+  fail_unless_equals_int (val, 0);
+  fail_unless (gst_structure_get_uint (stats, "max-queue-depth", &val));
+  fail_unless (val >= 1);
+
+  fail_unless (gst_structure_get_uint64 (stats, "latency-average", &avg));
+  fail_unless (gst_structure_get_uint64 (stats, "latency-max", &max));
+  fail_unless (avg <= max);
+  fail_unless (gst_structure_get_uint64 (stats, "handle-frame-average", &avg));
+  fail_unless (gst_structure_get_uint64 (stats, "handle-frame-max", &max));
+  fail_unless (avg <= max);
+
+  /* every released frame is in one of the buckets */
+  histogram = gst_structure_get_value (stats, "latency-histogram");
+  fail_unless (histogram != NULL);
+  total = 0;
+  for (i = 0; i < gst_value_array_get_size (histogram); i++)
+    total += g_value_get_uint (gst_value_array_get_value (histogram, i));
+  fail_unless_equals_int (total, NUM_BUFFERS);
+
+  gst_structure_free (stats);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
 
 static Suite *
 gst_videodecoder_suite (void)
@@ -1087,6 +1508,9 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_query_caps_with_custom_getcaps);
 
   tcase_add_test (tc, videodecoder_playback);
+  tcase_add_test (tc, videodecoder_playback_frame_threads);
+  tcase_add_test (tc, videodecoder_drain_frame_threads_unpacketized);
+  tcase_add_test (tc, videodecoder_deep_frame_queue);
   tcase_add_test (tc, videodecoder_playback_with_events);
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);
@@ -1095,6 +1519,9 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_backwards_playback);
   tcase_add_test (tc, videodecoder_backwards_buffer_after_segment);
   tcase_add_test (tc, videodecoder_flush_events);
+  tcase_add_test (tc, videodecoder_trickmode_key_units);
+  tcase_add_test (tc, videodecoder_frame_interval);
+  tcase_add_test (tc, videodecoder_stats);
 
   return s;
 }
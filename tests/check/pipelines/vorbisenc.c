@@ -23,6 +23,11 @@
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstbufferstraw.h>
 
+#include <string.h>
+
+/* the SIMD version of the stereo deinterleaving of the encoder */
+#include "gstvorbisenc-simd.h"
+
 #ifndef GST_DISABLE_PARSE
 
 #define TIMESTAMP_OFFSET G_GINT64_CONSTANT(3249870963)
@@ -377,6 +382,50 @@ GST_END_TEST;
 
 #endif /* #ifndef GST_DISABLE_PARSE */
 
+#define MAX_SIMD_SAMPLES 71
+
+/* the SIMD version leaves the last samples to the caller, for every number of
+ * samples the result has to be the same as the one of the C loop */
+GST_START_TEST (test_deinterleave_simd)
+{
+#ifdef HAVE_VORBIS_ENC_SIMD_S
+  float in[2 * MAX_SIMD_SAMPLES];
+  float l[MAX_SIMD_SAMPLES + 1], r[MAX_SIMD_SAMPLES + 1], *out[2] = { l, r };
+  float ref_l[MAX_SIMD_SAMPLES + 1], ref_r[MAX_SIMD_SAMPLES + 1];
+  gulong samples, j, done;
+
+  for (samples = 0; samples <= MAX_SIMD_SAMPLES; samples++) {
+    for (j = 0; j < 2 * samples; j++)
+      in[j] = g_random_double_range (-2.0, 2.0);
+    memset (l, 0x55, sizeof (l));
+    memset (r, 0x55, sizeof (r));
+    memset (ref_l, 0x55, sizeof (ref_l));
+    memset (ref_r, 0x55, sizeof (ref_r));
+
+    done = deinterleave_s_simd (out, in, samples);
+    fail_unless (done <= samples && samples - done < 4);
+    for (j = done; j < samples; j++) {
+      l[j] = in[2 * j];
+      r[j] = in[2 * j + 1];
+    }
+
+    for (j = 0; j < samples; j++) {
+      ref_l[j] = in[2 * j];
+      ref_r[j] = in[2 * j + 1];
+    }
+    /* also checks that nothing is written after the output */
+    fail_unless (memcmp (l, ref_l, sizeof (l)) == 0,
+        "wrong left channel of %lu samples", samples);
+    fail_unless (memcmp (r, ref_r, sizeof (r)) == 0,
+        "wrong right channel of %lu samples", samples);
+  }
+#else
+  GST_INFO ("no SIMD version of the deinterleaving");
+#endif
+}
+
+GST_END_TEST;
+
 static Suite *
 vorbisenc_suite (void)
 {
@@ -389,6 +438,7 @@ vorbisenc_suite (void)
   tcase_add_test (tc_chain, test_timestamps);
   tcase_add_test (tc_chain, test_discontinuity);
 #endif
+  tcase_add_test (tc_chain, test_deinterleave_simd);
 
   return s;
 }
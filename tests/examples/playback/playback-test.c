@@ -65,6 +65,8 @@ typedef enum
   GST_PLAY_FLAG_DEINTERLACE = (1 << 9),
   GST_PLAY_FLAG_SOFT_COLORBALANCE = (1 << 10),
   GST_PLAY_FLAG_FORCE_FILTERS = (1 << 11),
+  GST_PLAY_FLAG_FAST_START = (1 << 12),
+  GST_PLAY_FLAG_REUSE_DECODERS = (1 << 13),
 } GstPlayFlags;
 
 /* configuration */
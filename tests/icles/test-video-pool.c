@@ -0,0 +1,128 @@
+/* GStreamer video buffer pool allocation benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures video converter throughput with frames from a GstVideoBufferPool
+ * with and without the huge pages and first-touch pool options. Run it
+ * pinned to one NUMA node, e.g. with numactl --cpunodebind=0, to see the
+ * effect of first-touch placement. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define N_BUFFERS 4
+
+static GstBufferPool *
+make_pool (GstVideoInfo * info, gboolean huge_pages, gboolean first_touch)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstCaps *caps;
+
+  caps = gst_video_info_to_caps (info);
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info->size, N_BUFFERS,
+      N_BUFFERS);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_META);
+  if (huge_pages)
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  if (first_touch)
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_FIRST_TOUCH);
+  if (!gst_buffer_pool_set_config (pool, config))
+    g_error ("could not configure pool");
+  if (!gst_buffer_pool_set_active (pool, TRUE))
+    g_error ("could not activate pool");
+  gst_caps_unref (caps);
+
+  return pool;
+}
+
+static void
+run (GstVideoInfo * in_info, GstVideoInfo * out_info, gint iterations,
+    gboolean huge_pages, gboolean first_touch)
+{
+  GstBufferPool *in_pool, *out_pool;
+  GstVideoConverter *convert;
+  GstClockTime start, elapsed;
+  gint i;
+
+  in_pool = make_pool (in_info, huge_pages, first_touch);
+  out_pool = make_pool (out_info, huge_pages, first_touch);
+  convert = gst_video_converter_new (in_info, out_info, NULL);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    GstBuffer *inbuf, *outbuf;
+    GstVideoFrame in_frame, out_frame;
+
+    gst_buffer_pool_acquire_buffer (in_pool, &inbuf, NULL);
+    gst_buffer_pool_acquire_buffer (out_pool, &outbuf, NULL);
+
+    gst_video_frame_map (&in_frame, in_info, inbuf, GST_MAP_READ);
+    gst_video_frame_map (&out_frame, out_info, outbuf, GST_MAP_WRITE);
+    gst_video_converter_frame (convert, &in_frame, &out_frame);
+    gst_video_frame_unmap (&out_frame);
+    gst_video_frame_unmap (&in_frame);
+
+    gst_buffer_unref (outbuf);
+    gst_buffer_unref (inbuf);
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  g_print ("huge-pages %-3s first-touch %-3s: %8.2f frames/s\n",
+      huge_pages ? "yes" : "no", first_touch ? "yes" : "no",
+      (gdouble) iterations * GST_SECOND / elapsed);
+
+  gst_video_converter_free (convert);
+  gst_buffer_pool_set_active (in_pool, FALSE);
+  gst_buffer_pool_set_active (out_pool, FALSE);
+  gst_object_unref (in_pool);
+  gst_object_unref (out_pool);
+}
+
+int
+main (int argc, char **argv)
+{
+  GstVideoInfo in_info, out_info;
+  gint iterations = 200;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    iterations = atoi (argv[1]);
+
+  gst_video_info_set_format (&in_info, GST_VIDEO_FORMAT_NV12, 3840, 2160);
+  gst_video_info_set_format (&out_info, GST_VIDEO_FORMAT_I420, 3840, 2160);
+
+  g_print ("converting %d NV12 -> I420 3840x2160 frames\n", iterations);
+  run (&in_info, &out_info, iterations, FALSE, FALSE);
+  run (&in_info, &out_info, iterations, TRUE, FALSE);
+  run (&in_info, &out_info, iterations, FALSE, TRUE);
+  run (&in_info, &out_info, iterations, TRUE, TRUE);
+
+  return 0;
+}
@@ -537,11 +537,14 @@ main (int argc, char **argv)
   GError *err = NULL;
   GstDiscoverer *dc;
   gint timeout = 10;
+  gint jobs = 1;
   GOptionEntry options[] = {
     {"async", 'a', 0, G_OPTION_ARG_NONE, &async,
         "Run asynchronously", NULL},
     {"timeout", 't', 0, G_OPTION_ARG_INT, &timeout,
         "Specify timeout (in seconds, default 10)", "T"},
+    {"jobs", 'j', 0, G_OPTION_ARG_INT, &jobs,
+        "Number of files to discover in parallel (implies --async)", "N"},
     /* {"elem", 'e', 0, G_OPTION_ARG_NONE, &elem_seek, */
     /*     "Seek on elements instead of pads", NULL}, */
     {"toc", 'c', 0, G_OPTION_ARG_NONE, &show_toc,
@@ -581,6 +584,11 @@ main (int argc, char **argv)
     exit (1);
   }
 
+  if (jobs > 1) {
+    g_object_set (dc, "max-parallel", jobs, NULL);
+    async = TRUE;
+  }
+
   if (!async) {
     gint i;
     for (i = 1; i < argc; i++)
@@ -83,6 +83,8 @@ GType gst_video_gamma_mode_get_type (void);
 #define GST_TYPE_VIDEO_GAMMA_MODE (gst_video_gamma_mode_get_type())
 GType gst_video_primaries_mode_get_type (void);
 #define GST_TYPE_VIDEO_PRIMARIES_MODE (gst_video_primaries_mode_get_type())
+GType gst_video_orientation_method_get_type (void);
+#define GST_TYPE_VIDEO_ORIENTATION_METHOD (gst_video_orientation_method_get_type())
 
 /* enumerations from "video-resampler.h" */
 GType gst_video_resampler_method_get_type (void);